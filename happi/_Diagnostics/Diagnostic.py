@@ -155,6 +155,25 @@ class Diagnostic(object):
 
 		return data
 
+	# Method to get the data without reading it
+	def getDask(self):
+		"""Obtains the data from the diagnostic as a dask array, without reading it.
+
+		Returns:
+		--------
+		A dask array whose first dimension corresponds to the selected timesteps.
+		The data at each timestep is only read when the corresponding chunk is computed.
+		Requires the dask package.
+		"""
+		import dask, dask.array
+		self._prepare1() # prepare the vfactor
+		# The first timestep gives the shape and type of the arrays
+		first = self._np.asarray( self._dataAtTime(self._timesteps[0]) )
+		return dask.array.stack([
+			dask.array.from_delayed( dask.delayed(self._dataAtTime)(t), first.shape, first.dtype )
+			for t in self._timesteps
+		])
+
 	def getTimesteps(self):
 		"""Obtains the list of timesteps selected in this diagnostic"""
 		return self._timesteps
@@ -27,7 +27,7 @@ class Field(Diagnostic):
 		self.diagName = info["diagName"]
 		self._fields = info["fields"]
 		
-		# Open the file(s) and load the data
+		# Open the file(s) and list the iterations (their groups are opened only when accessed)
 		self._h5items = {}
 		for path in self._results_path:
 			file = path+self._os.sep+'Fields'+str(self.diagNumber)+'.h5'
@@ -35,13 +35,13 @@ class Field(Diagnostic):
 				f = self._h5py.File(file, 'r')
 			except Exception as e:
 				continue
-			self._h5items.update( dict(f["data"]) )
+			iterations = self.simulation._indexed(file, "iterations", lambda: [k for k in f["data"].keys() if k != "tmp"])
+			self._h5items.update( {int(k):(f["data"],k) for k in iterations} )
+		self.simulation._writeIndex()
 		if not self._h5items:
 			raise Exception("Diagnostic not loaded: Could not open any file Fields%d.h5"%self.diagNumber)
-		# Remove "tmp" dataset
-		if "tmp" in self._h5items: del self._h5items["tmp"]
 		# Converted to ordered list
-		self._h5items = sorted(self._h5items.values(), key=lambda x:int(x.name[6:]))
+		self._h5items = H5GroupList( sorted(self._h5items.items()) )
 		
 		# Case of a cylindrical geometry
 		if self.simulation.cylindrical:
@@ -298,8 +298,7 @@ class Field(Diagnostic):
 	
 	# get all available timesteps
 	def getAvailableTimesteps(self):
-		try:    times = [float(a.name[6:]) for a in self._h5items]
-		except Exception as e: times = []
+		times = self._h5items.iterations
 		return self._np.double(times)
 	
 	def _getCenters(self, axis_index, timestep, h5item = None):
@@ -507,13 +507,21 @@ class ParticleBinning(Diagnostic):
 				print("Timestep "+str(t)+" not found in this diagnostic")
 				return []
 			# get data
-			B = self._np.empty(self._finalShape)
-			try:
-				self._h5items[d][index].read_direct(B, source_sel=self._selection) # get array
-			except Exception as e:
-				B = self._np.squeeze(B)
-				self._h5items[d][index].read_direct(B, source_sel=self._selection) # get array
-				B = self._np.reshape(B, self._finalShape)
+			item = self._h5items[d][index]
+			if isinstance(item, self._h5py.Group):
+				# sparse storage: indices of the non-empty bins in the flattened array, and their values
+				B = self._np.zeros(item.attrs["shape"])
+				if "indices" in item:
+					B.flat[item["indices"][()]] = item["values"][()]
+				B = self._np.reshape(B[self._selection], self._finalShape)
+			else:
+				B = self._np.empty(self._finalShape)
+				try:
+					item.read_direct(B, source_sel=self._selection) # get array
+				except Exception as e:
+					B = self._np.squeeze(B)
+					item.read_direct(B, source_sel=self._selection) # get array
+					B = self._np.reshape(B, self._finalShape)
 			B[self._np.isnan(B)] = 0.
 			# Divide by the bins size
 			B *= self._bsize
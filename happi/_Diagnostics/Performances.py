@@ -179,10 +179,14 @@ class Performances(Diagnostic):
 		self._data_transform = data_transform
 		self._cumulative = cumulative
 		
-		# In case of "vecto" quantity, get the species
+		# Patch quantities of each species
+		self._speciesQuantities = ["vecto"] + ["timer_"+op for op in ["interpolator", "pusher", "projector",
+			"cell_keys", "ionization", "radiation", "multiphoton_Breit_Wheeler"]]
+		
+		# In case of a species quantity, get the species
 		if species is not None:
-			if self.operation != "vecto":
-				raise Exception("Argument `species` only valid with quantity 'vecto'")
+			if self.operation not in self._speciesQuantities:
+				raise Exception("Argument `species` only valid with quantities "+", ".join(self._speciesQuantities))
 			self._species = str(species)
 		
 		# 2 - Manage timesteps
@@ -279,7 +283,7 @@ class Performances(Diagnostic):
 				B = self._np.empty((self._nprocs,), dtype=dtype)
 				h5item.read_direct( B, source_sel=self._np.s_[index_in_file,:] )
 				# If not cumulative, make the difference with the previous time
-				if not self._cumulative and quantity.startswith("timer") and index > 0:
+				if not self._cumulative and quantity.startswith(("timer", "counter")) and index > 0:
 					prevh5item = self._h5items[index-1]["quantities_"+dtype]
 					prevB = self._np.empty((self._nprocs,), dtype=dtype)
 					prevh5item.read_direct( prevB, source_sel=self._np.s_[index_in_file,:] )
@@ -288,21 +292,24 @@ class Performances(Diagnostic):
 		
 		# Calculate the operation
 		# First patch performance information
-		if  self.operation in ["vecto", "mpi_rank"]:
+		if  self.operation in self._speciesQuantities + ["mpi_rank"]:
 			if self._mode != "raw":
-				print("With quantities `vecto` or `mpi_rank`, only mode `raw` is supported")
+				print("With patch quantities, only mode `raw` is supported")
 				return []
 			
 			if "patches" not in self._h5items[index].keys():
 				print("No patches group in timestep {}".format(str(t)))
 				return []
 
-			if self.operation=="vecto":
+			if self.operation in self._speciesQuantities:
 
 				if self._species not in self._h5items[index]["patches"].keys():
 					print("Requested species {} does not have a group".format(self._species))
 					return []
-				patches_buffer = self._np.array(self._h5items[index]["patches"][self._species]["vecto"])
+				if self.operation not in self._h5items[index]["patches"][self._species].keys():
+					print("Requested {} does not have a dataset".format(self.operation))
+					return []
+				patches_buffer = self._np.array(self._h5items[index]["patches"][self._species][self.operation])
 
 			elif self.operation=="mpi_rank":
 
@@ -325,7 +332,7 @@ class Performances(Diagnostic):
 			)
 			
 			# Matrix of patches reconstituted
-			A = self._np.empty_like(i_patch)
+			A = self._np.empty(i_patch.shape, dtype=patches_buffer.dtype)
 			A[i_patch] = patches_buffer
 			A = self._np.squeeze(A.reshape([x_patches.max()+1, y_patches.max()+1, z_patches.max()+1]))
 
@@ -25,7 +25,7 @@ class TrackParticles(ParticleList):
 	
 	_diagType = "TrackParticles"
 	
-	def _init(self, species=None, select="", axes=[], timesteps=None, sort=True, sorted_as="", length=None, chunksize=20000000, **kwargs):
+	def _init(self, species=None, select="", axes=[], timesteps=None, sort=True, sorted_as="", length=None, chunksize=20000000, parallel=False, **kwargs):
 		
 		timestep_indices = kwargs.pop("timestep_indices", None)
 		
@@ -46,6 +46,7 @@ class TrackParticles(ParticleList):
 		if not sort and select!="":
 			raise Exception("Cannot select particles if not sorted")
 		self._sort = sort
+		self._chunksize = chunksize
 		
 		
 		# Get info from the hdf5 files + verifications
@@ -66,9 +67,19 @@ class TrackParticles(ParticleList):
 						self._XmovedForTime[int(t)] = x_moved
 		extra_properties = {"moving_x"} if self._XmovedForTime else set()
 		
+		# Find out if the particles were already ordered during the simulation (`sorted_output`)
+		sortedOutput = False
+		for file in disorderedfiles:
+			with self._h5py.File(file, "r") as f:
+				sortedOutput = sortedOutput or "sorted_output" in f.attrs
+		if sortedOutput and sort is not True:
+			raise Exception("The particles were ordered during the simulation: argument `sort` must be True")
+		
 		# If sorting allowed, find out if ordering needed
 		needsOrdering = False
-		if sort:
+		if sortedOutput:
+			orderedfile = self._results_path[0]+self._os.sep+"TrackParticles_"+species+".h5"
+		elif sort:
 			if type(sort) is str:
 				# The sorted file gets a name from `sorted_as`
 				if type(sorted_as) is not str or self._re.search(r"[^a-zA-Z0-9_]","_"+sorted_as):
@@ -116,7 +127,7 @@ class TrackParticles(ParticleList):
 		if sort:
 			# If the first path does not contain the ordered file (or it is incomplete), we must create it
 			if needsOrdering:
-				self._orderFiles(orderedfile, chunksize, sort)
+				self._orderFiles(orderedfile, chunksize, sort, parallel)
 				if self._needsOrdering(orderedfile):
 					raise Exception("Ordering not succesful")
 			# Create arrays to store h5 items
@@ -381,15 +392,25 @@ class TrackParticles(ParticleList):
 		return self._alltimesteps
 
 	# Make the particles ordered by Id in the file, in case they are not
-	def _orderFiles( self, fileOrdered, chunksize, sort ):
-		if self._verbose:
+	# With `parallel`, the timesteps are shared between the MPI processes, which all write in the same file
+	def _orderFiles( self, fileOrdered, chunksize, sort, parallel=False ):
+		rank, nprocs = 0, 1
+		if parallel:
+			from mpi4py import MPI
+			if not self._h5py.get_config().mpi:
+				raise Exception("Argument `parallel` requires h5py built with MPI support")
+			rank, nprocs = MPI.COMM_WORLD.Get_rank(), MPI.COMM_WORLD.Get_size()
+		if self._verbose and rank == 0:
 			print("Ordering particles ... (this could take a while)")
 			if type(sort) is str:
 				print("    Selecting particles according to "+sort)
 		try:
 			# If ordered file already exists, find out which timestep was done last
 			latestOrdered = -1
-			if self._os.path.isfile(fileOrdered):
+			if parallel:
+				# The processes do not progress together: no partial ordering is kept
+				f0 = self._h5py.File(fileOrdered, "w", driver="mpio", comm=MPI.COMM_WORLD)
+			elif self._os.path.isfile(fileOrdered):
 				f0 = self._h5py.File(fileOrdered, "r+")
 				try:    latestOrdered = f0.attrs["latestOrdered"]
 				except: pass
@@ -422,8 +443,8 @@ class TrackParticles(ParticleList):
 			# Loop times and fill arrays
 			for it, t in enumerate(self._timesteps):
 				
-				# Skip previously-ordered times
-				if it<=latestOrdered: continue
+				# Skip previously-ordered times, and those of other processes
+				if it<=latestOrdered or it % nprocs != rank: continue
 				
 				if self._verbose: print("    Ordering @ timestep = "+str(t))
 				f, _ = self._locationForTime[t]
@@ -486,9 +507,10 @@ class TrackParticles(ParticleList):
 							f0[name][it, first_o:last_o] = data[k][:npart_o]
 						
 				# Indicate that this iteration was succesfully ordered
-				f0.attrs["latestOrdered"] = it
-				f0.flush()
-			if self._verbose: print("    Finalizing the ordering process")
+				if not parallel:
+					f0.attrs["latestOrdered"] = it
+					f0.flush()
+			if self._verbose and rank == 0: print("    Finalizing the ordering process")
 			# Create the "Times" dataset
 			f0.create_dataset("Times", data=self._timesteps)
 			# Create the "unique_Ids" dataset
@@ -514,7 +536,7 @@ class TrackParticles(ParticleList):
 			# Close disordered files
 			for t in self._locationForTime:
 				self._locationForTime[t][0].close()
-		if self._verbose: print("Ordering succeeded")
+		if self._verbose and rank == 0: print("Ordering succeeded")
 
 	# Method to generate the raw data (only done once)
 	def _generateRawData(self, times=None):
@@ -624,6 +646,44 @@ class TrackParticles(ParticleList):
 					data[t][axis] = self._rawData[t][axis] * factor
 		return data
 
+	# Get the sorted data as dask arrays, read by chunks only when computed
+	def getDask(self):
+		"""Obtains the sorted particle data as dask arrays, without reading it.
+
+		Returns:
+		--------
+		A dictionary containing one dask array (times x particles) for each axis,
+		and the entry "times". Requires the dask package and sorted particles.
+		"""
+		if not self._sort:
+			raise Exception("getDask() requires sorted particles")
+		import dask.array
+		self._prepare1() # prepare the vfactor
+
+		first_time = self._locationForTime[self._timesteps[0]]
+		last_time  = self._locationForTime[self._timesteps[-1]] + 1
+		def lazy(prop):
+			a = dask.array.from_array(self._h5items[prop], chunks=(1, self._chunksize))[first_time:last_time]
+			if type(self.selectedParticles) is not slice:
+				a = a[:, self.selectedParticles]
+			return a
+		ID = lazy("Id")
+		deadParticles = ID==0
+
+		data = { "times":self._timesteps }
+		for axis, factor in zip(self.axes, self._factors):
+			if axis == "Id":
+				d = ID
+			elif axis == "moving_x":
+				x_moved = self._np.array([self._XmovedForTime[t] for t in self._timesteps])
+				d = lazy("x") - x_moved[:,None]
+			else:
+				d = lazy(axis)
+			if axis != "Id":
+				d = dask.array.where(deadParticles, self._np.nan if d.dtype == float else 9999, d)
+			data[axis] = d * factor
+		return data
+
 	# Iterator on UNSORTED particles for a given timestep
 	def iterParticles(self, timestep, chunksize=1):
 		self._prepare1() # prepare the vfactor
@@ -30,12 +30,12 @@ class SmileiSimulation(object):
 
 	"""
 
-	def __init__(self, results_path=".", reference_angular_frequency_SI=None, show=True, verbose=True, scan=True, pint=True):
+	def __init__(self, results_path=".", reference_angular_frequency_SI=None, show=True, verbose=True, scan=True, pint=True, index=True):
 		self.valid = False
 		# Import packages
 		import h5py
 		import numpy as np
-		import os, glob, re
+		import os, glob, re, json
 		setMatplotLibBackend(show=show)
 		updateMatplotLibColormaps()
 		import matplotlib.pyplot
@@ -48,12 +48,14 @@ class SmileiSimulation(object):
 		self._os = os
 		self._glob = glob.glob
 		self._re = re
+		self._json = json
 		self._plt = matplotlib.pyplot
 		self._mtime = 0
 		self._verbose = verbose
 		self._reference_angular_frequency_SI = reference_angular_frequency_SI
 		self._scan = scan
 		self._ureg = None
+		self._index = {} if index else None
 		
 		# Load the simulation (verify the path, get the namelist)
 		self.reload()
@@ -239,6 +241,52 @@ class SmileiSimulation(object):
 		self._mtime = lastmodif
 		self.valid = True
 	
+	def _indexed(self, file, key, compute):
+		""" Metadata `key` of an output file, taken from the index `happi_index.json` of its
+		directory if the file did not change (same size and modification time) since it was
+		indexed, otherwise obtained from `compute()` and added to the index """
+		if self._index is None:
+			return compute()
+		directory, filename = self._os.path.split(self._os.path.abspath(file))
+		if directory not in self._index:
+			self._index[directory] = {"files":{}, "modified":False}
+			try:
+				with open(directory+self._os.sep+"happi_index.json") as f:
+					content = self._json.load(f)
+				if content["version"] == 1:
+					self._index[directory]["files"] = content["files"]
+			except Exception as e:
+				pass
+		index = self._index[directory]
+		try:
+			stat = self._os.stat(file)
+		except Exception as e:
+			return compute()
+		entry = index["files"].get(filename)
+		if entry is None or entry["size"] != stat.st_size or entry["mtime"] != stat.st_mtime:
+			entry = index["files"][filename] = {"size":stat.st_size, "mtime":stat.st_mtime}
+		if key not in entry:
+			entry[key] = compute()
+			index["modified"] = True
+		return entry[key]
+	
+	def _writeIndex(self):
+		""" Saves the modified indexes (silently skipped in read-only directories) """
+		if self._index is None:
+			return
+		for directory, index in self._index.items():
+			if not index["modified"]:
+				continue
+			file = directory+self._os.sep+"happi_index.json"
+			try:
+				# Written in a temporary file first, so that concurrent readers never see a partial index
+				with open(file+".tmp", "w") as f:
+					self._json.dump({"version":1, "files":index["files"]}, f)
+				self._os.replace(file+".tmp", file)
+			except Exception as e:
+				pass
+			index["modified"] = False
+	
 	def getDiags(self, diagType):
 		if self._diag_numbers[diagType] is None:
 			self._diag_numbers[diagType], self._diag_names[diagType] = self.scanDiags(diagType)
@@ -253,11 +301,14 @@ class SmileiSimulation(object):
 				# get number
 				number = int(self._re.findall(diagType+"([0-9]+).h5$",file)[0])
 				# get name
-				with self._h5py.File(file, 'r') as f:
-					name = f.attrs["name"].decode() if "name" in f.attrs else ""
+				def readName():
+					with self._h5py.File(file, 'r') as f:
+						return f.attrs["name"].decode() if "name" in f.attrs else ""
+				name = self._indexed(file, "name", readName)
 				these_diags += [(number, name)]
 			# Update diags with those of previous paths
 			diags = list(set(diags+these_diags)) # unique diags
+		self._writeIndex()
 		if diags == []:
 			return [], []
 		else:
@@ -349,16 +400,18 @@ class SmileiSimulation(object):
 		raw_fields = set()
 		for path in self._results_path:
 			file = path+self._os.sep+'Fields'+str(diagNumber)+'.h5'
+			def readFields():
+				with self._h5py.File(file, 'r') as f:
+					values = f["data"].values()
+					return sorted(next(iter(values)).keys()) if len(values)>0 else []
 			try:
-				f = self._h5py.File(file, 'r')
+				these_fields = set(self._indexed(file, "fields", readFields))
 			except Exception as e:
 				continue
-			values = f["data"].values()
-			if len(values)==0:
+			if len(these_fields)==0:
 				continue
-			these_fields =  set(next(iter(values)).keys())
 			raw_fields = (raw_fields & these_fields) or these_fields
-			f.close()
+		self._writeIndex()
 		
 		# Case of a cylindrical geometry
 		if self.cylindrical:
@@ -3,6 +3,7 @@ __all__ = [
 	"setMatplotLibBackend",
 	"updateMatplotLibColormaps",
 	"ChunkedRange",
+	"H5GroupList",
 	"openNamelist",
 	"Options",
 	"Units",
@@ -86,6 +87,21 @@ class ChunkedRange:
 	def next(self): # for python 2
 		return self.__next__()
 
+class H5GroupList:
+	"""Ordered list of HDF5 groups, opened only when accessed
+	items: list of (iteration, (parent group, name of the group))"""
+	def __init__(self, items):
+		self.iterations = [it[0] for it in items]
+		self._items = [it[1] for it in items]
+	def __len__(self):
+		return len(self._items)
+	def __getitem__(self, i):
+		parent, name = self._items[i]
+		return parent[name]
+	def __iter__(self):
+		for i in range(len(self._items)):
+			yield self[i]
+
 
 def openNamelist(namelist):
 	"""
@@ -26,6 +26,12 @@ def Open(*args, **kwargs):
 	scan : bool (default True)
 		If False, the HDF5 output files are not initially scanned.
 
+	pint : bool (default True)
+		If False, the *Pint* package is not used for managing units.
+
+	index : bool (default True)
+		If False, the index `happi_index.json` of the output files is neither read nor written.
+
 	Returns:
 	--------
 	A SmileiSimulation object, i.e. a container that holds information about a simulation.
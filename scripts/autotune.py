@@ -0,0 +1,149 @@
+#!/usr/bin/env python
+"""
+Autotuning of the parallel parameters of a Smilei simulation
+
+Runs short trials of a namelist (50 iterations by default) for combinations of
+  - MPI processes x OpenMP threads        (--partitions 4x8,8x4)
+  - Main.number_of_patches                (--patches 32x32,64x32)
+  - Main.cluster_width                    (--cluster_widths 1,4)
+  - OpenMP schedule of the patch loops    (--schedules dynamic,guided)
+  - Vectorization.mode                    (--vectorization off,on,adaptive)
+and times each of them with the time loop timer printed by Smilei.
+
+The best configuration is written as a namelist (autotune_best.py by default),
+to be appended to the original namelist in a later run:
+    OMP_NUM_THREADS=8 OMP_SCHEDULE=dynamic mpirun -n 4 ./smilei namelist.py autotune_best.py
+
+Example:
+    python scripts/autotune.py namelist.py --smilei ./smilei --partitions 4x8,8x4 \\
+        --patches 32x32,64x64 --schedules dynamic,guided --vectorization off,adaptive
+"""
+
+import argparse, itertools, os, re, shlex, subprocess, sys, time
+
+
+def parse_list(text, convert=str):
+    return [convert(v) for v in text.split(",") if v]
+
+def parse_patches(text):
+    return [[int(n) for n in v.split("x")] for v in text.split(",") if v]
+
+def parse_partitions(text):
+    return [tuple(int(n) for n in v.split("x")) for v in text.split(",") if v]
+
+def namelist_overrides(config, steps):
+    lines = [
+        "Main.simulation_time = %d * Main.timestep" % steps,
+        "Main.print_every = %d" % steps,
+    ]
+    if config["patches"] is not None:
+        lines += ["Main.number_of_patches = %s" % config["patches"]]
+    if config["cluster_width"] is not None:
+        lines += ["Main.cluster_width = %d" % config["cluster_width"]]
+    if config["vectorization"] is not None:
+        lines += [
+            "Vectorization.mode = %r" % config["vectorization"],
+            "if len(Vectorization._list) == 0: Vectorization()",
+        ]
+    return lines
+
+def describe(config):
+    text = "%d MPI x %d OMP" % config["partition"]
+    if config["patches"] is not None:
+        text += ", patches %s" % "x".join(str(n) for n in config["patches"])
+    if config["cluster_width"] is not None:
+        text += ", cluster_width %d" % config["cluster_width"]
+    if config["schedule"] is not None:
+        text += ", schedule %s" % config["schedule"]
+    if config["vectorization"] is not None:
+        text += ", vectorization %s" % config["vectorization"]
+    return text
+
+def run_trial(args, config, directory):
+    nmpi, nomp = config["partition"]
+    os.makedirs(directory)
+    overrides = os.path.join(directory, "autotune_trial.py")
+    with open(overrides, "w") as f:
+        f.write("\n".join(namelist_overrides(config, args.steps)) + "\n")
+
+    env = dict(os.environ)
+    env["OMP_NUM_THREADS"] = str(nomp)
+    if config["schedule"] is not None:
+        env["OMP_SCHEDULE"] = config["schedule"]
+
+    command = shlex.split(args.mpirun.format(mpi=nmpi, omp=nomp)) \
+        + [os.path.abspath(args.smilei), os.path.abspath(args.namelist), os.path.abspath(overrides)]
+    with open(os.path.join(directory, "smilei.log"), "w") as log:
+        try:
+            process = subprocess.run(command, cwd=directory, env=env, stdout=subprocess.PIPE,
+                                     stderr=subprocess.STDOUT, universal_newlines=True, timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            log.write("Timeout after %g s\n" % args.timeout)
+            return None
+        log.write(process.stdout)
+
+    if process.returncode != 0:
+        return None
+    match = re.search(r"Time_in_time_loop\s+([0-9.eE+-]+)", process.stdout)
+    if not match:
+        return None
+    return float(match.group(1))
+
+def write_best(args, config, loop_time):
+    nmpi, nomp = config["partition"]
+    with open(args.output, "w") as f:
+        f.write("# Best configuration found by scripts/autotune.py for %s\n" % args.namelist)
+        f.write("# Time loop of %d iterations: %g s\n" % (args.steps, loop_time))
+        launch = "OMP_NUM_THREADS=%d " % nomp
+        if config["schedule"] is not None:
+            launch += "OMP_SCHEDULE=%s " % config["schedule"]
+        launch += "%s smilei %s %s" % (args.mpirun.format(mpi=nmpi, omp=nomp), args.namelist, args.output)
+        f.write("# Run with: %s\n" % launch)
+        for line in namelist_overrides(config, args.steps)[2:]:
+            f.write(line + "\n")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Tune the MPI, OpenMP and patch parameters of a Smilei namelist with short trials")
+    parser.add_argument("namelist", help="Smilei namelist")
+    parser.add_argument("--smilei", default="./smilei", help="Smilei executable (default ./smilei)")
+    parser.add_argument("--mpirun", default="mpirun -n {mpi}", help="MPI launcher, {mpi} and {omp} are replaced (default 'mpirun -n {mpi}')")
+    parser.add_argument("--partitions", type=parse_partitions, default=[(1, 1)], help="MPIxOMP pairs, e.g. 4x8,8x4")
+    parser.add_argument("--patches", type=parse_patches, default=[None], help="number_of_patches, e.g. 32x32,64x32")
+    parser.add_argument("--cluster_widths", type=lambda t: parse_list(t, int), default=[None], help="cluster_width values, e.g. 1,4")
+    parser.add_argument("--schedules", type=parse_list, default=[None], help="OpenMP schedules, e.g. dynamic,guided")
+    parser.add_argument("--vectorization", type=parse_list, default=[None], help="Vectorization modes, e.g. off,on,adaptive")
+    parser.add_argument("--steps", type=int, default=50, help="number of iterations of each trial (default 50)")
+    parser.add_argument("--timeout", type=float, default=None, help="maximum duration of a trial in seconds")
+    parser.add_argument("--directory", default="autotune", help="directory of the trials (default autotune)")
+    parser.add_argument("--output", default="autotune_best.py", help="namelist of the best configuration (default autotune_best.py)")
+    args = parser.parse_args()
+
+    configs = [
+        dict(partition=p, patches=n, cluster_width=c, schedule=s, vectorization=v)
+        for p, n, c, s, v in itertools.product(args.partitions, args.patches, args.cluster_widths, args.schedules, args.vectorization)
+    ]
+    if os.path.exists(args.directory):
+        sys.exit("Directory %s already exists" % args.directory)
+
+    results = []
+    for itrial, config in enumerate(configs):
+        directory = os.path.join(args.directory, "trial_%03d" % itrial)
+        start = time.time()
+        loop_time = run_trial(args, config, directory)
+        if loop_time is None:
+            print("[%3d/%d] %s: failed (see %s)" % (itrial+1, len(configs), describe(config), os.path.join(directory, "smilei.log")))
+        else:
+            print("[%3d/%d] %s: %g s in the time loop (%g s in total)" % (itrial+1, len(configs), describe(config), loop_time, time.time()-start))
+            results.append((loop_time, config))
+        sys.stdout.flush()
+
+    if not results:
+        sys.exit("No trial succeeded")
+
+    results.sort(key=lambda r: r[0])
+    print("\nBest configurations:")
+    for loop_time, config in results[:5]:
+        print("  %g s: %s" % (loop_time, describe(config)))
+    write_best(args, results[0][1], results[0][0])
+    print("\nBest configuration written in %s" % args.output)
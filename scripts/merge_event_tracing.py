@@ -0,0 +1,33 @@
+# This script merges the files event_tracing_rank_X.json of the Particle Event
+# Tracing diagnostic into a single timeline, event_tracing.json, that can be
+# opened in Perfetto (https://ui.perfetto.dev) or in chrome://tracing.
+#
+# Each MPI process is a process of the timeline, and each of its OpenMP threads
+# a track. The tracks contain the particle events, the MPI waits of the
+# synchronizations and the phases of the main timers (Particles, Maxwell, ...).
+#
+# Use of the script: run it in the simulation directory. Optionally, give the
+# first and last iterations to keep, e.g. `python merge_event_tracing.py 1000 1500`.
+
+import os,sys
+import json
+
+first_iteration = int(sys.argv[1]) if len(sys.argv)>1 else 0
+last_iteration  = int(sys.argv[2]) if len(sys.argv)>2 else float("inf")
+
+events = []
+for file in sorted(os.listdir(os.getcwd())):
+	if not (file.startswith("event_tracing_rank_") and file.endswith(".json")):
+		continue
+	with open(file) as f:
+		text = f.read().rstrip()
+	# the array of events is not closed if the simulation was interrupted
+	if not text.endswith("]"):
+		text += "]"
+	for event in json.loads(text):
+		if event["ph"] == "M" or first_iteration <= event["args"]["iteration"] <= last_iteration:
+			events.append(event)
+
+with open("event_tracing.json", "w") as f:
+	json.dump(events, f, separators=(",",":"))
+print("Wrote", len(events), "events in event_tracing.json")
@@ -2,7 +2,7 @@ import numpy as np
 import matplotlib.pyplot as plt
 from matplotlib.collections import PolyCollection
 import os,sys
-import re
+import json
 import math
 
 # This script parses the Particle Event Tracing diagnostic, that can be 
@@ -10,6 +10,8 @@ import math
 #
 # This diagnostic stores the time when a particle event starts and ends, as well
 # as the information on which MPI rank and OpenMP thread performed this event.
+# The files event_tracing_rank_X.json also contain the phases of the main timers
+# and the MPI waits: they can be viewed in Perfetto after merge_event_tracing.py.
 #
 # For the purpose of this diagnostic, particle events are e.g. the PIC operators
 # acting on a group of particles corresponding to given ibin-ispec-ipatch 
@@ -38,122 +40,60 @@ Plot = True
 ###########
 
 # Hypothesis underlying these functions:
-# the tracing file name has a structure particle_event_tracing_rank_X_thread_Y.txt
-
-def get_rank_from_filename(filename):
-	filename_components = filename.split("_")
-	if len(filename_components)>3:
-		return int(filename_components[3])
-	else:	
-		return -1
-
-def get_thread_from_filename(filename):
-	filename_components = filename.replace('.', '_').split("_")
-	return int(filename_components[5])
-
-def search_for(string_found,string_to_search,line):
-        # this function tells if you should keep parsing for a certain parameter
-    if string_found == True: # parameter already found, no need to parse it again
-        return False
-    else: # look for the parameter if present in the string
-        return str(line).find(string_to_search)>0
+# the tracing file name has a structure event_tracing_rank_X.json, written in the
+# Chrome trace format (see also merge_event_tracing.py to view all ranks in Perfetto)
+
+def read_events(filename):
+	# the array of events is not closed if the simulation was interrupted
+	with open(filename) as f:
+		text = f.read().rstrip()
+	if not text.endswith("]"):
+		text += "]"
+	return json.loads(text)
+
+# Particle events (the phases of the main timers and the MPI waits are not plotted)
+#  Interp, Push, BC, Proj, DensityReduction, Ionization, Radiation, MultiphotonBW,
+#  IonizReduction, RadReduction, MBWReduction, VectoKeys (computation of keys and count for vectorization)
 
 ###########
-    
-# Reads an event from two given lines about the same event
-
-# Important hypothesis if OpenMP tasks are used:
-# OpenMP tasks are tied (i.e. thread X starts an event, thread X ends this event)
-
-# The event lines structures is RelativeTime Start/End EventName(1word)
-    
-dict_event_name = {0:'Interp', 1:'Push', 2:'BC', 3: 'Proj',4: 'DensityReduction',
-                   5: 'Ionization',6: 'Radiation',7: 'MultiphotonBW',
-                   8: 'IonizReduction',9: 'RadReduction',10: 'MBWReduction',11: 'VectoKeys'}    
-    
-def read_thread_event(line_start_event,line_end_event):
-	words_line_start_event = line_start_event.split(" ")
-	words_line_end_event   = line_end_event.split(" ")
-	time_start_event = float(words_line_start_event[0])
-	time_end_event = float(words_line_end_event[0])
-	event_name = dict_event_name[int(words_line_start_event[2])]  # name of event
-	# 0: Interp
-	# 1: Push
-	# 2: BC
-	# 3: Proj
-	# 4: Density Reduction
-	# 5: Ionization
-	# 6: Radiation
-	# 7: Multiphoton Breit Wheeler
-	# 8: Ionization Reduction
-	# 9: Radiation Reduction
-	#10: Multiphoton Breit Wheeler Reduction
-	#11: Computation of keys and count for vectorization
-	return time_start_event,time_end_event,event_name
 
 # ------- Read data
 start_path = os.getcwd()
 
-# Find number of MPI
-N_MPI = 1
-MPI_found = False
-with open("smilei.log") as f:
-	lines = f.readlines()
-	for iline,line in enumerate(lines):
-		if search_for(MPI_found,"Number of MPI process",line):
-			N_MPI = int(re.search(r'\d+', str(line)).group())
-			MPI_found = True
-			break
+tracing_files = [file for file in os.listdir(start_path) if file.startswith("event_tracing_rank_") and file.endswith(".json")]
+N_MPI = len(tracing_files)
 print("Number of MPI = ",N_MPI)
 
+colormapping = {'Interp' : "r", 'Push' : "yellow", 'BC' : "g", 'Proj' : "cyan", 'DensityReduction' : "b",'EnergyLost' : "purple",
+            'Ionization' : "orange", 'Radiation' : "darkgreen", 'MultiphotonBW' : "blueviolet", 
+            'IonizReduction' : "gold", 'RadReduction' : "forestgreen",'MBWReduction' : "fuchsia",'VectoKeys': "darkcyan"}
+vert_shift = {'Interp' : 0., 'Push' : 0.1, 'BC' : 0.2, 'Proj' : 0.3, 'DensityReduction' : 0.5, 
+          'Ionization' : 0.6, 'Radiation' : 0.7, 'MultiphotonBW' : 0.8,
+          'IonizReduction' : 0.6, 'RadReduction' : 0.7, 'MBWReduction' : 0.8, 'VectoKeys':0.5}
+
 if Plot==True:
 	plt.ion()
 # For each rank, read and plot the tracing data
 for rank_to_analyze in range(0,N_MPI):
 	print("Reading tracing for rank ",rank_to_analyze)
-	tracing_files = []
-	# read only files for the desired MPI rank
-	for file in os.listdir(start_path):
-		if (file.startswith("particle_event_tracing_") and (get_rank_from_filename(file)==rank_to_analyze)):
-			tracing_files.append(file)
-
-	tracing_files = sorted(tracing_files)
-
-	# for each file to read (one per thread, read the events in the desired iteration)
-	threads = []
+	events = read_events(os.path.join(start_path,"event_tracing_rank_"+str(rank_to_analyze)+".json"))
 
+	# keep the particle events of the desired iteration (times in s)
 	Events_to_plot = []
-	ref_time = 0.
-	for tracing_file in tracing_files:
-		event_lines_to_read = []
-		thread_number = get_thread_from_filename(tracing_file)
-		threads.append(thread_number)
-		Iteration_Found = False
-		with open(os.path.join(start_path,tracing_file)) as f: # read file corresponding to rank and thread
-			lines = f.readlines()
-			keepCurrentLine = False
-			# Isolate the lines for the desired iteration
-			for line in lines:
-				if line == "Start Iteration "+str(iteration_to_analyze)+"\n":
-					keepCurrentLine = True
-					Iteration_Found = True
-				if keepCurrentLine:
-					event_lines_to_read.append(line)
-				if line == "End Iteration "+str(iteration_to_analyze)+"\n":
-					keepCurrentLine = False
-			event_lines_to_read = [line[:-1] for line in event_lines_to_read]
-			event_lines_to_read = event_lines_to_read[1:-1]
-			if Iteration_Found == False:
-				print("Error, iteration not found")
-			if thread_number == 0:
-				ref_time = float(event_lines_to_read[0].split(" ")[0])
-		# Start extracting data from the desired iteration	
-		Nevents = int(len(event_lines_to_read)/2)
-		for i_event in range(0,Nevents):
-			line_start_event = event_lines_to_read[2*i_event]
-			line_end_event = event_lines_to_read[2*i_event+1]
-			time_start_event,time_end_event,event_name = read_thread_event(line_start_event,line_end_event) 
-			Events_to_plot.append([thread_number, time_start_event-ref_time,time_end_event-ref_time,event_name])	
+	for event in events:
+		if event["ph"] == "X" and event["args"]["iteration"] == iteration_to_analyze and event["name"] in colormapping:
+			time_start_event = event["ts"]*1.e-6
+			time_end_event = (event["ts"]+event["dur"])*1.e-6
+			Events_to_plot.append([event["tid"], time_start_event, time_end_event, event["name"]])
+	if len(Events_to_plot) == 0:
+		print("Error, iteration not found")
+		continue
+	threads = sorted(set([event[0] for event in Events_to_plot]))
+	# the reference is the first event of thread 0
+	ref_time = min([event[1] for event in Events_to_plot if event[0] == threads[0]])
+	for event in Events_to_plot:
+		event[1] -= ref_time
+		event[2] -= ref_time
 
 	# for event in Events_to_plot:		 
 	# 	print(event)	
@@ -165,13 +105,6 @@ for rank_to_analyze in range(0,N_MPI):
 	print("Plotting tracing for rank ",rank_to_analyze)
 
 
-	colormapping = {'Interp' : "r", 'Push' : "yellow", 'BC' : "g", 'Proj' : "cyan", 'DensityReduction' : "b",'EnergyLost' : "purple",
-                'Ionization' : "orange", 'Radiation' : "darkgreen", 'MultiphotonBW' : "blueviolet", 
-                'IonizReduction' : "gold", 'RadReduction' : "forestgreen",'MBWReduction' : "fuchsia",'VectoKeys': "darkcyan"}
-	vert_shift = {'Interp' : 0., 'Push' : 0.1, 'BC' : 0.2, 'Proj' : 0.3, 'DensityReduction' : 0.5, 
-              'Ionization' : 0.6, 'Radiation' : 0.7, 'MultiphotonBW' : 0.8,
-              'IonizReduction' : 0.6, 'RadReduction' : 0.7, 'MBWReduction' : 0.8, 'VectoKeys':0.5}
-
 	### Plot all events
 
 	fig, gnt = plt.subplots()
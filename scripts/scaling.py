@@ -0,0 +1,202 @@
+#!/usr/bin/env python
+"""
+Weak or strong scaling study of a Smilei simulation
+
+Runs short simulations of a namelist (50 iterations by default) for several numbers of
+MPI processes x OpenMP threads (--partitions 1x8,2x8,4x8,8x8). The first partition is the
+reference.
+  - strong scaling: the same simulation on more resources
+  - weak scaling:   the box (Main.grid_length, Main.number_of_cells and Main.number_of_patches)
+                    is extended proportionally to the resources, along the dimensions given by
+                    --directions (all of them by default), so that the load per core is constant.
+                    The plasma and laser profiles of the namelist must follow the box.
+The time loop and the main timers printed by Smilei give the parallel efficiency of each run,
+globally and for the synchronizations of fields and particles, the particles, Maxwell and the
+diagnostics:
+  - strong scaling: efficiency = T_ref * cores_ref / ( T * cores )
+  - weak scaling:   efficiency = T_ref / T
+The report is printed and written in a JSON file (scaling.json by default).
+
+Example:
+    python scripts/scaling.py namelist.py --mode weak --smilei ./smilei --partitions 1x8,2x8,4x8,8x8
+"""
+
+import argparse, json, os, re, shlex, subprocess, sys, time
+
+# Timers of the report, with the names printed by Smilei
+TIMERS = [
+    ("syncField",  "Sync Fields"),
+    ("syncPart",   "Sync Particles"),
+    ("particles",  "Particles"),
+    ("maxwell",    "Maxwell"),
+    ("diags",      "Diagnostics"),
+]
+
+
+def parse_partitions(text):
+    return [tuple(int(n) for n in v.split("x")) for v in text.split(",") if v]
+
+def prime_factors(n):
+    factors, p = [], 2
+    while n > 1:
+        while n % p == 0:
+            factors.append(p)
+            n //= p
+        p += 1
+    return factors
+
+def weak_factors(ratio, directions, ndim):
+    # Distributes the prime factors of the ratio of resources over the scaled dimensions,
+    # the largest factors first, each on the dimension extended the least so far
+    factors = [1] * ndim
+    for p in sorted(prime_factors(ratio), reverse=True):
+        d = min(directions, key=lambda d: (factors[d], d))
+        factors[d] *= p
+    return factors
+
+def namelist_overrides(args, scale):
+    lines = [
+        "Main.simulation_time = %d * Main.timestep" % args.steps,
+        "Main.print_every = %d" % args.steps,
+        "Checkpoints.dump_step = 0",
+        "Checkpoints.dump_minutes = 0.",
+    ]
+    if scale is not None:
+        lines += [
+            "_scaling = %r" % scale,
+            "Main.grid_length = [l*f for l,f in zip(Main.grid_length, _scaling)]",
+            "Main.number_of_cells = [n*f for n,f in zip(Main.number_of_cells, _scaling)]",
+            "Main.number_of_patches = [n*f for n,f in zip(Main.number_of_patches, _scaling)]",
+        ]
+    return lines
+
+def parse_timers(stdout):
+    # Time loop and breakdown of the main timers, as printed by Timers::profile
+    match = re.search(r"Time_in_time_loop\s+([0-9.eE+-]+)", stdout)
+    if not match:
+        return None, None
+    timers = {}
+    for line in stdout[match.end():].splitlines():
+        fields = [f.strip() for f in line.split("\t") if f.strip()]
+        if len(fields) >= 3 and re.match(r"^[0-9.eE+-]+$", fields[1]):
+            timers.setdefault(fields[0], float(fields[1]))
+    return float(match.group(1)), timers
+
+def run(args, partition, scale, directory):
+    nmpi, nomp = partition
+    os.makedirs(directory)
+    overrides = os.path.join(directory, "scaling_run.py")
+    with open(overrides, "w") as f:
+        f.write("\n".join(namelist_overrides(args, scale)) + "\n")
+
+    env = dict(os.environ)
+    env["OMP_NUM_THREADS"] = str(nomp)
+    command = shlex.split(args.mpirun.format(mpi=nmpi, omp=nomp)) \
+        + [os.path.abspath(args.smilei), os.path.abspath(args.namelist), os.path.abspath(overrides)]
+    with open(os.path.join(directory, "smilei.log"), "w") as log:
+        try:
+            process = subprocess.run(command, cwd=directory, env=env, stdout=subprocess.PIPE,
+                                     stderr=subprocess.STDOUT, universal_newlines=True, timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            log.write("Timeout after %g s\n" % args.timeout)
+            return None, None
+        log.write(process.stdout)
+
+    if process.returncode != 0:
+        return None, None
+    return parse_timers(process.stdout)
+
+def efficiency(args, t, t_ref, cores, cores_ref):
+    if t <= 0.:
+        return None
+    if args.mode == "strong":
+        return t_ref * cores_ref / ( t * cores )
+    else:
+        return t_ref / t
+
+def report(args, results):
+    ref = results[0]
+    columns = [("Time loop", None)] + TIMERS
+    print("\n%s scaling of %s (%d iterations), efficiency relative to %d MPI x %d OMP" % (
+        args.mode.capitalize(), args.namelist, args.steps, ref["mpi"], ref["omp"]))
+    print("%-14s" % "MPI x OMP" + "".join("%14s" % name for name, _ in columns))
+    for result in results:
+        result["efficiency"] = {}
+        line = "%-14s" % ("%d x %d" % (result["mpi"], result["omp"]))
+        for name, printed in columns:
+            if printed is None:
+                t, t_ref = result["time_loop"], ref["time_loop"]
+            else:
+                t, t_ref = result["timers"].get(printed, 0.), ref["timers"].get(printed, 0.)
+            e = efficiency(args, t, t_ref, result["cores"], ref["cores"])
+            result["efficiency"][name] = e
+            line += "%14s" % ("-" if e is None else "%.1f%%" % (100.*e))
+        print(line)
+    print("\nTimes (s):")
+    print("%-14s" % "MPI x OMP" + "".join("%14s" % name for name, _ in columns))
+    for result in results:
+        line = "%-14s" % ("%d x %d" % (result["mpi"], result["omp"]))
+        line += "%14.4g" % result["time_loop"]
+        line += "".join("%14.4g" % result["timers"].get(printed, 0.) for _, printed in TIMERS)
+        print(line)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Weak or strong scaling study of a Smilei namelist with short runs")
+    parser.add_argument("namelist", help="Smilei namelist")
+    parser.add_argument("--mode", choices=["weak", "strong"], default="strong", help="weak or strong scaling (default strong)")
+    parser.add_argument("--smilei", default="./smilei", help="Smilei executable (default ./smilei)")
+    parser.add_argument("--mpirun", default="mpirun -n {mpi}", help="MPI launcher, {mpi} and {omp} are replaced (default 'mpirun -n {mpi}')")
+    parser.add_argument("--partitions", type=parse_partitions, required=True, help="MPIxOMP pairs, the first one is the reference, e.g. 1x8,2x8,4x8")
+    parser.add_argument("--directions", default=None, help="dimensions extended in weak scaling, e.g. 0,1 (default all)")
+    parser.add_argument("--dimensions", type=int, default=None, help="number of dimensions of the box (default from the name of the geometry)")
+    parser.add_argument("--steps", type=int, default=50, help="number of iterations of each run (default 50)")
+    parser.add_argument("--timeout", type=float, default=None, help="maximum duration of a run in seconds")
+    parser.add_argument("--directory", default="scaling", help="directory of the runs (default scaling)")
+    parser.add_argument("--output", default="scaling.json", help="JSON file of the report (default scaling.json)")
+    args = parser.parse_args()
+
+    if os.path.exists(args.directory):
+        sys.exit("Directory %s already exists" % args.directory)
+
+    # Dimensions of the box, needed to extend it in weak scaling
+    ndim = args.dimensions
+    if args.mode == "weak" and ndim is None:
+        with open(args.namelist) as f:
+            geometry = re.search(r"geometry\s*=\s*[\"']([^\"']+)[\"']", f.read())
+        if not geometry:
+            sys.exit("Geometry not found in the namelist, use --dimensions")
+        ndim = {"1Dcartesian": 1, "2Dcartesian": 2, "3Dcartesian": 3, "AMcylindrical": 2}.get(geometry.group(1))
+        if ndim is None:
+            sys.exit("Unknown geometry %s, use --dimensions" % geometry.group(1))
+    if args.mode == "weak":
+        directions = list(range(ndim)) if args.directions is None else [int(d) for d in args.directions.split(",")]
+
+    cores_ref = args.partitions[0][0] * args.partitions[0][1]
+    results = []
+    for irun, partition in enumerate(args.partitions):
+        cores = partition[0] * partition[1]
+        scale = None
+        if args.mode == "weak":
+            if cores % cores_ref != 0:
+                sys.exit("In weak scaling, the numbers of cores must be multiples of the reference (%d)" % cores_ref)
+            scale = weak_factors(cores // cores_ref, directions, ndim)
+        directory = os.path.join(args.directory, "run_%dx%d" % partition)
+        start = time.time()
+        time_loop, timers = run(args, partition, scale, directory)
+        description = "%d MPI x %d OMP" % partition
+        if scale is not None:
+            description += ", box x%s" % "x".join(str(f) for f in scale)
+        if time_loop is None:
+            print("[%d/%d] %s: failed (see %s)" % (irun+1, len(args.partitions), description, os.path.join(directory, "smilei.log")))
+            if irun == 0:
+                sys.exit("The reference run failed")
+        else:
+            print("[%d/%d] %s: %g s in the time loop (%g s in total)" % (irun+1, len(args.partitions), description, time_loop, time.time()-start))
+            results.append(dict(mpi=partition[0], omp=partition[1], cores=cores, scale=scale, time_loop=time_loop, timers=timers))
+        sys.stdout.flush()
+
+    report(args, results)
+    with open(args.output, "w") as f:
+        json.dump(dict(namelist=args.namelist, mode=args.mode, steps=args.steps, runs=results), f, indent=4)
+    print("\nReport written in %s" % args.output)
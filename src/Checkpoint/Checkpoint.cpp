@@ -9,6 +9,9 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 
 #include <mpi.h>
 
@@ -32,9 +35,11 @@
 #include "DiagnosticProbes.h"
 #include "DiagnosticScreen.h"
 #include "DiagnosticTrack.h"
+#include "DiagnosticFields.h"
 #include "LaserEnvelope.h"
 #include "BinaryProcesses.h"
 #include "CollisionalNuclearReaction.h"
+#include "Hilbert_functions.h"
 
 using namespace std;
 
@@ -52,7 +57,25 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
     keep_n_dumps( 2 ),
     keep_n_dumps_max( 10000 ),
     dump_deflate( 0 ),
-    file_grouping( 0 )
+    compression_filter_( H5Z_FILTER_NONE ),
+    file_grouping( 0 ),
+    restart_from_index_( false ),
+    restart_num_dump_( 0 ),
+    restart_file_grouping_( 0 ),
+    restart_in_memory_( false ),
+    incremental_dumps_( 0 ),
+    dumps_since_full_( 0 ),
+    incremental_( false ),
+    full_dump_number_( 0 ),
+    asynchronous_( false ),
+    index_pending_( false ),
+    index_itime_( 0 ),
+    local_dumps_( 0 ),
+    dumps_since_global_( 0 ),
+    local_level_( false ),
+    partner_( -1 ),
+    number_of_patches_( params.number_of_patches ),
+    repatch_( false )
 {
 
     if( PyTools::nComponents( "Checkpoints" ) > 0 ) {
@@ -72,6 +95,19 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
             keep_n_dumps=1;
         }
 
+        // The full dump must not be overwritten while its incremental dumps are the latest ones
+        PyTools::extract( "incremental_dumps", incremental_dumps_, "Checkpoints"  );
+        if( incremental_dumps_ > 0 ) {
+            if( incremental_dumps_+2 > keep_n_dumps_max ) {
+                ERROR( "incremental_dumps must be smaller than " << keep_n_dumps_max-1 );
+            }
+            if( keep_n_dumps < incremental_dumps_+2 ) {
+                WARNING( "keep_n_dumps raised to " << incremental_dumps_+2 << " to keep the full dump of the incremental dumps" );
+                keep_n_dumps = incremental_dumps_+2;
+            }
+            MESSAGE( 1, "Code will make " << incremental_dumps_ << " incremental dumps after each full dump" );
+        }
+
         if( keep_n_dumps > keep_n_dumps_max ) {
             WARNING( "Smilei supports a maximum of keep_n_dumps of "<< keep_n_dumps_max );
             keep_n_dumps = keep_n_dumps_max;
@@ -79,8 +115,56 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
 
         PyTools::extract( "exit_after_dump", exit_after_dump, "Checkpoints"  );
 
+        PyTools::extract( "asynchronous", asynchronous_, "Checkpoints"  );
+        if( asynchronous_ ) {
+            MESSAGE( 1, "Code will write the checkpoint files asynchronously" );
+        }
+
+        PyTools::extractOrNone( "local_dir", local_dir_, "Checkpoints"  );
+        PyTools::extract( "local_dumps", local_dumps_, "Checkpoints"  );
+        if( local_dir_.empty() ) {
+            local_dumps_ = 0;
+        }
+        if( local_dumps_ > 0 ) {
+            if( incremental_dumps_ > 0 ) {
+                ERROR( "incremental_dumps not available with local_dumps" );
+            }
+            char *path = realpath( ".", NULL );
+            run_dir_ = path ? path : "";
+            free( path );
+            findPartners( smpi );
+            MESSAGE( 1, "Code will make " << local_dumps_ << " dumps in " << local_dir_ << " between two dumps in the checkpoints directory" );
+        }
+
         PyTools::extract( "dump_deflate", dump_deflate, "Checkpoints"  );
 
+        // Lossless compression of the arrays, and arrays stored in single precision (for approximate restarts)
+        string compression = "";
+        PyTools::extract( "compression", compression, "Checkpoints"  );
+        if( ! compression.empty() ) {
+            if( compression == "zfp" || compression == "sz" || compression == "sz3" ) {
+                ERROR( "Checkpoints: the compression must be lossless (`deflate`, `zstd`, `blosc` or `lz4`)" );
+            }
+            compression_filter_ = H5::compressionFilter( compression );
+            PyTools::extractV( "compression_parameters", compression_parameters_, "Checkpoints"  );
+        } else if( dump_deflate > 0 ) {
+            compression_filter_ = H5Z_FILTER_DEFLATE;
+            compression_parameters_.resize( 1, dump_deflate );
+        }
+        if( compression_filter_ != H5Z_FILTER_NONE ) {
+            MESSAGE( 1, "Code will compress the checkpoint files" );
+        }
+        PyTools::extractV( "single_precision", single_precision_, "Checkpoints"  );
+        for( unsigned int i=0; i<single_precision_.size(); i++ ) {
+            if( single_precision_[i] != "fields" && single_precision_[i] != "Position"
+                && single_precision_[i] != "Momentum" && single_precision_[i] != "Weight" ) {
+                ERROR( "Checkpoints: `single_precision` accepts `fields`, `Position`, `Momentum` and `Weight`" );
+            }
+        }
+        if( ! single_precision_.empty() ) {
+            WARNING( "Checkpoints in single precision: the restarts will not be exact" );
+        }
+
         PyTools::extract( "file_grouping", file_grouping, "Checkpoints"  );
         if( file_grouping > 0 ) {
             if( file_grouping > ( unsigned int )( smpi->getSize() ) ) {
@@ -89,9 +173,100 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
             MESSAGE( 1, "Code will group checkpoint files by "<< file_grouping );
         }
 
+        PyTools::extract( "restart_in_memory", restart_in_memory_, "Checkpoints"  );
+
         smpi->barrier();
 
-        if( params.restart ) {
+        PyTools::extract( "restart_from_index", restart_from_index_, "Checkpoints"  );
+
+        // Latest dump in the node-local directories, if any
+        unsigned int local_step = 0;
+        if( params.restart && local_dumps_ > 0 ) {
+            local_step = restoreLocal( smpi );
+        }
+
+        if( params.restart && restart_from_index_ ) {
+            std::vector<std::string> restart_files;
+            if( ! PyTools::extractV( "restart_files", restart_files, "Checkpoints" ) ) {
+                ERROR( "Internal parameter `restart_files` not understood. This should not happen" );
+            }
+            PyTools::extract( "restart_dir", restart_dir_, "Checkpoints"  );
+
+            // Only the master reads the indexes, and picks the last complete dump
+            unsigned int info[5] = { 0, 0, 0, 0, 0 };
+            vector<int> patch_count;
+            restart_number_of_patches_ = params.number_of_patches;
+            if( smpi->isMaster() ) {
+                for( unsigned int i=0; i<restart_files.size(); i++ ) {
+                    H5Read f( restart_files[i], NULL, false );
+                    if( f.valid() ) {
+                        unsigned int dump_step = 0;
+                        f.attr( "dump_step", dump_step );
+                        if( dump_step > info[0] ) {
+                            info[0] = dump_step;
+                            f.attr( "dump_number", info[1] );
+                            f.attr( "num_dump", info[2] );
+                            f.attr( "number_of_files", info[3] );
+                            f.attr( "file_grouping", info[4] );
+                            f.vect( "patch_count", patch_count, true );
+                            if( f.vectSize( "number_of_patches" ) == ( int ) params.nDim_field ) {
+                                f.vect( "number_of_patches", restart_number_of_patches_ );
+                            }
+                        }
+                    }
+                }
+            }
+            MPI_Bcast( info, 5, MPI_UNSIGNED, 0, smpi->world() );
+            if( info[3] == 0 && local_step == 0 ) {
+                ERROR( "Cannot find a valid restart index in " << restart_dir_ );
+            }
+            if( params.multiple_decomposition && info[3] != ( unsigned int ) smpi->getSize() ) {
+                ERROR( "Restart with a different number of processes not available with multiple decomposition" );
+            }
+            MPI_Bcast( restart_number_of_patches_.data(), params.nDim_field, MPI_UNSIGNED, 0, smpi->world() );
+            repatch_ = restart_number_of_patches_ != params.number_of_patches;
+            if( repatch_ ) {
+                if( params.multiple_decomposition ) {
+                    ERROR( "Restart with a different number_of_patches not available with multiple decomposition" );
+                }
+                if( params.patch_arrangement != "hilbertian" ) {
+                    ERROR( "Restart with a different number_of_patches requires the hilbertian patch_arrangement" );
+                }
+                if( params.Laser_Envelope_model ) {
+                    ERROR( "Restart with a different number_of_patches not available with the laser envelope model" );
+                }
+                if( params.Friedman_filter ) {
+                    ERROR( "Restart with a different number_of_patches not available with the Friedman filter" );
+                }
+                for( unsigned int i=0; i<params.EM_BCs.size(); i++ ) {
+                    for( unsigned int j=0; j<params.EM_BCs[i].size(); j++ ) {
+                        if( params.EM_BCs[i][j] == "PML" ) {
+                            ERROR( "Restart with a different number_of_patches not available with PML boundaries" );
+                        }
+                    }
+                }
+                ostringstream old_patches( "" );
+                for( unsigned int i=0; i<params.nDim_field; i++ ) {
+                    old_patches << ( i>0 ? " x " : "" ) << restart_number_of_patches_[i];
+                }
+                MESSAGE( 2, "Patches of the dump (" << old_patches.str() << ") re-split or merged into the new patches" );
+            }
+            this_run_start_step = info[0];
+            dump_number = info[1];
+            restart_num_dump_ = info[2];
+            restart_file_grouping_ = info[4];
+            restart_patch_count_ = patch_count;
+            restart_patch_count_.resize( info[3] );
+            MPI_Bcast( restart_patch_count_.data(), info[3], MPI_INT, 0, smpi->world() );
+            restart_refHindexes_.resize( info[3], 0 );
+            for( unsigned int rk=1; rk<info[3]; rk++ ) {
+                restart_refHindexes_[rk] = restart_refHindexes_[rk-1] + restart_patch_count_[rk-1];
+            }
+
+            MESSAGE( 2, "Restarting fields and particles at step: " << this_run_start_step );
+            MESSAGE( 2, "                 dumped by " << info[3] << " processes in: " << restart_dir_ );
+
+        } else if( params.restart ) {
             std::vector<std::string> restart_files;
             if( ! PyTools::extractV( "restart_files", restart_files, "Checkpoints" ) ) {
                 ERROR( "Internal parameter `restart_files` not understood. This should not happen" );
@@ -114,7 +289,7 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
                 }
             }
 
-            if( restart_file == "" ) {
+            if( restart_file == "" && local_step == 0 ) {
                 ERROR( "Cannot find a valid restart file for rank "<<smpi->getRank() );
             }
 
@@ -150,6 +325,17 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
 #endif
 
         }
+
+        // A more recent local dump replaces the dump of the checkpoints directory
+        if( local_step > this_run_start_step ) {
+            restart_from_index_ = false;
+            restart_file = localFileName( "dump", smpi->getRank() );
+            this_run_start_step = local_step;
+            H5Read f( restart_file );
+            f.attr( "dump_number", dump_number );
+            MESSAGE( 2, "Restarting fields and particles at step: " << this_run_start_step );
+            MESSAGE( 2, "                  from the local dumps in: " << local_dir_ );
+        }
     }
 
     if( dump_step>0 || dump_minutes>0. ) {
@@ -180,7 +366,12 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
     nDim_particle=params.nDim_particle;
 }
 
-Checkpoint::~Checkpoint() {}
+Checkpoint::~Checkpoint()
+{
+    if( writer_.joinable() ) {
+        writer_.join();
+    }
+}
 
 void Checkpoint::dump( VectorPatch &vecPatches, Region &region, unsigned int itime, SmileiMPI *smpi, SimWindow *simWindow, Params &params )
 {
@@ -200,8 +391,36 @@ void Checkpoint::dump( VectorPatch &vecPatches, Region &region, unsigned int iti
     dump_now = dump_now || ( dump_step != 0 && ( ( itime-this_run_start_step ) % dump_step == 0 ) );
     
     if( signal_received != 0 || dump_now ) {
-        dumpAll( vecPatches, region, itime,  smpi, simWindow, params );
-        if( exit_after_dump || ( ( signal_received!=0 ) && ( signal_received != SIGUSR2 ) ) ) {
+        // Patches are dumped with their particles
+        simWindow->createPendingParticles( vecPatches, params );
+        // The HDF5 library must not be used by asynchronous fields diags during the dump
+        DiagnosticFields::waitAsynchronousWrites();
+        // The buffered track iterations would be lost at restart
+        for( unsigned int idiag=0 ; idiag<vecPatches.localDiags.size() ; idiag++ ) {
+            if( DiagnosticTrack *track = dynamic_cast<DiagnosticTrack *>( vecPatches.localDiags[idiag] ) ) {
+                track->writeBuffered( smpi, true );
+            }
+        }
+        // The previous asynchronous dump must be complete
+        waitDump( smpi );
+        bool exiting = exit_after_dump || ( ( signal_received!=0 ) && ( signal_received != SIGUSR2 ) );
+        // Frequent dumps go to the node-local directories, except the last one
+        local_level_ = local_dumps_ > 0 && ! exiting && dumps_since_global_ < local_dumps_;
+        if( local_level_ ) {
+            dumps_since_global_++;
+            dumpAll( vecPatches, region, itime,  smpi, simWindow, params );
+            dumpLocal( smpi );
+        } else {
+            dumps_since_global_ = 0;
+            dumpAll( vecPatches, region, itime,  smpi, simWindow, params );
+            if( asynchronous_ ) {
+                index_pending_ = true;
+                index_itime_ = itime;
+            } else {
+                writeIndex( smpi, itime );
+            }
+        }
+        if( exiting ) {
             exit_asap = true;
         }
         signal_received = 0;
@@ -213,24 +432,51 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
 {
     unsigned int num_dump=dump_number % keep_n_dumps;
 
-    ostringstream nameDumpTmp( "" );
-    nameDumpTmp << "checkpoints" << PATH_SEPARATOR;
-    if( file_grouping>0 ) {
-        nameDumpTmp << setfill( '0' ) << setw( int( 1+log10( smpi->getSize()/file_grouping+1 ) ) ) << smpi->getRank()/file_grouping << PATH_SEPARATOR;
+    std::string dumpName = local_level_ ? localFileName( "dump", smpi->getRank() )
+                           : dumpFileName( "checkpoints", num_dump, smpi->getRank(), smpi->getSize(), file_grouping );
+
+    // The dump of the checkpoints directory goes to a temporary file: the previous dump
+    // of the slot stays valid until all the files of the new one are complete (writeIndex)
+    if( ! local_level_ ) {
+        dump_file_name_ = dumpName;
+        dump_number++;
     }
+    std::string fileName = local_level_ ? dumpName : dumpName + ".tmp";
+
+    H5Write f( fileName, NULL, true, MPI_INFO_NULL, 0, asynchronous_ || local_level_ );
 
-    nameDumpTmp << "dump-" << setfill( '0' ) << setw( 5 ) << num_dump << "-" << setfill( '0' ) << setw( 10 ) << smpi->getRank() << ".h5" ;
-    std::string dumpName=nameDumpTmp.str();
+    if( compression_filter_ != H5Z_FILTER_NONE ) {
+        f.setCompression( compression_filter_, compression_parameters_ );
+    }
 
+    // A local dump is only valid for the restart of this run, with the same number of processes
+    if( local_level_ ) {
+        f.attr( "run_dir", run_dir_ );
+        f.attr( "number_of_processes", ( unsigned int ) smpi->getSize() );
+    }
 
-    H5Write f( dumpName );
-    dump_number++;
+    // An incremental dump links the arrays unchanged since the last full dump of this run
+    incremental_ = incremental_dumps_ > 0 && dumps_since_full_ < incremental_dumps_ && ! full_dump_file_.empty();
+    if( incremental_ ) {
+        dumps_since_full_++;
+        f.attr( "full_dump", full_dump_file_ );
+        f.attr( "full_dump_number", full_dump_number_ );
+    } else if( incremental_dumps_ > 0 ) {
+        dumps_since_full_ = 0;
+        full_dump_file_ = dumpName.substr( dumpName.rfind( PATH_SEPARATOR ) + 1 );
+        full_dump_number_ = dump_number;
+        full_dump_arrays_.clear();
+    }
 
 #ifdef  __DEBUG
     //MESSAGEALL( "Step " << itime << " : DUMP fields and particles " << dumpName );
-    MESSAGEALL( " Checkpoint #" << dumpName << " at iteration " << itime << " dumped" );
+    MESSAGEALL( " Checkpoint #" << dumpName << " at iteration " << itime << " dumped" << ( incremental_ ? " (incremental)" : "" ) );
 #else
-    MESSAGE( " Checkpoint #" << num_dump << " at iteration " << itime << " dumped" );
+    if( local_level_ ) {
+        MESSAGE( " Local checkpoint #" << dumps_since_global_ << " at iteration " << itime << " dumped" );
+    } else {
+        MESSAGE( " Checkpoint #" << num_dump << " at iteration " << itime << " dumped" << ( incremental_ ? " (incremental)" : "" ) );
+    }
 #endif
 
 #if defined( SMILEI_ACCELERATOR_GPU_OMP ) || defined( SMILEI_ACCELERATOR_GPU_OACC )
@@ -255,6 +501,7 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
 
     // Write diags scalar data
     DiagnosticScalar *scalars = static_cast<DiagnosticScalar *>( vecPatches.globalDiags[0] );
+    smpi->finalizeGlobalDiags( scalars );
     f.attr( "latest_timestep",   scalars->latest_timestep );
     // Scalars only by master
     if( smpi->isMaster() ) {
@@ -284,7 +531,17 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
             if( DiagnosticScreen *screen = dynamic_cast<DiagnosticScreen *>( vecPatches.globalDiags[idiag] ) ) {
                 ostringstream diagName( "" );
                 diagName << "DiagScreen" << iscreen;
-                f.vect( diagName.str(), *(screen->getData()) );
+                if( screen->sparse() ) {
+                    vector<unsigned int> indices;
+                    vector<double> values;
+                    screen->getSparseData( indices, values );
+                    if( ! indices.empty() ) {
+                        f.vect( diagName.str()+"_indices", indices );
+                        f.vect( diagName.str()+"_values", values );
+                    }
+                } else {
+                    f.vect( diagName.str(), *(screen->getData()) );
+                }
                 iscreen++;
             }
         }
@@ -329,6 +586,287 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
         dumpMovingWindow( f, simWin );
     }
 
+    // The file only exists in memory: it is written locally, or while the simulation continues
+    if( local_level_ ) {
+        f.image( dump_image_ );
+    } else if( asynchronous_ ) {
+        f.image( dump_image_ );
+        dump_image_name_ = fileName;
+        writer_ = thread( &Checkpoint::writeImage, this );
+    }
+
+}
+
+void Checkpoint::writeImage()
+{
+    FILE *file = fopen( dump_image_name_.c_str(), "wb" );
+    if( ! file || fwrite( dump_image_.data(), 1, dump_image_.size(), file ) != dump_image_.size() ) {
+        ERROR( "Cannot write the checkpoint file " << dump_image_name_ );
+    }
+    fclose( file );
+    vector<char>().swap( dump_image_ );
+}
+
+string Checkpoint::localFileName( string prefix, int rank )
+{
+    ostringstream name( "" );
+    name << local_dir_ << PATH_SEPARATOR << prefix << "-" << setfill( '0' ) << setw( 10 ) << rank << ".h5";
+    return name.str();
+}
+
+void Checkpoint::findPartners( SmileiMPI *smpi )
+{
+    // Each node is identified by the lowest rank it holds
+    int location[2] = { smpi->getRank(), 0 };
+    MPI_Comm node_comm;
+    MPI_Comm_split_type( smpi->world(), MPI_COMM_TYPE_SHARED, smpi->getRank(), MPI_INFO_NULL, &node_comm );
+    MPI_Bcast( &location[0], 1, MPI_INT, 0, node_comm );
+    MPI_Comm_rank( node_comm, &location[1] );
+    MPI_Comm_free( &node_comm );
+    int size = smpi->getSize();
+    vector<int> locations( 2*size );
+    MPI_Allgather( location, 2, MPI_INT, &locations[0], 2, MPI_INT, smpi->world() );
+
+    map<int, int> node_size;
+    map<pair<int, int>, int> rank_at;
+    for( int rk=0; rk<size; rk++ ) {
+        node_size[locations[2*rk]]++;
+        rank_at[make_pair( locations[2*rk], locations[2*rk+1] )] = rk;
+    }
+    // The partner of a process is on the next node, with the same rank in the node (modulo the size of the node)
+    partner_senders_.resize( 0 );
+    for( int rk=0; rk<size; rk++ ) {
+        map<int, int>::iterator next = node_size.upper_bound( locations[2*rk] );
+        if( next == node_size.end() ) {
+            next = node_size.begin();
+        }
+        int partner = rank_at[make_pair( next->first, locations[2*rk+1] % next->second )];
+        if( rk == smpi->getRank() ) {
+            partner_ = partner;
+        }
+        if( partner == smpi->getRank() ) {
+            partner_senders_.push_back( rk );
+        }
+    }
+    if( node_size.size() == 1 ) {
+        WARNING( "All the processes are on the same node: the local dumps do not survive a node failure" );
+    }
+}
+
+void Checkpoint::dumpLocal( SmileiMPI *smpi )
+{
+    writeFile( localFileName( "dump", smpi->getRank() ), dump_image_ );
+
+    // Copy to the partner, and copies of the processes whose partner is this one
+    vector<int> dests( 1, partner_ );
+    vector<vector<char> *> sends( 1, &dump_image_ );
+    vector<vector<char> > copies;
+    exchangeBuffers( smpi->world(), dests, sends, partner_senders_, copies );
+    for( unsigned int i=0; i<partner_senders_.size(); i++ ) {
+        writeFile( localFileName( "partner", partner_senders_[i] ), copies[i] );
+    }
+    vector<char>().swap( dump_image_ );
+}
+
+unsigned int Checkpoint::restoreLocal( SmileiMPI *smpi )
+{
+    PyTools::extractOrNone( "restart_dir", restart_dir_, "Checkpoints"  );
+    string restart_dir = restart_dir_;
+    char *path = realpath( restart_dir_.c_str(), NULL );
+    if( path ) {
+        restart_dir = path;
+        free( path );
+    }
+
+    // Step of a local file, if it was dumped by the run being restarted with the same number of processes
+    auto localStep = [&]( string name ) {
+        unsigned int step = 0, n_processes = 0;
+        H5Read f( name, NULL, false );
+        if( f.valid() && f.hasAttr( "run_dir" ) ) {
+            string run_dir;
+            f.attr( "run_dir", run_dir );
+            f.attr( "number_of_processes", n_processes );
+            if( run_dir == restart_dir && n_processes == ( unsigned int ) smpi->getSize() ) {
+                f.attr( "dump_step", step );
+            }
+        }
+        return step;
+    };
+
+    // Each process gets the step of the copy kept by its partner
+    unsigned int own_step = localStep( localFileName( "dump", smpi->getRank() ) );
+    unsigned int partner_step = 0;
+    vector<unsigned int> kept_steps( partner_senders_.size() );
+    vector<MPI_Request> requests( partner_senders_.size()+1 );
+    for( unsigned int i=0; i<partner_senders_.size(); i++ ) {
+        kept_steps[i] = localStep( localFileName( "partner", partner_senders_[i] ) );
+        MPI_Isend( &kept_steps[i], 1, MPI_UNSIGNED, partner_senders_[i], 0, smpi->world(), &requests[i] );
+    }
+    MPI_Irecv( &partner_step, 1, MPI_UNSIGNED, partner_, 0, smpi->world(), &requests.back() );
+    MPI_Waitall( requests.size(), requests.data(), MPI_STATUSES_IGNORE );
+
+    // The latest step that all the processes have, either in their own file or at their partner
+    unsigned int step, available = max( own_step, partner_step );
+    MPI_Allreduce( &available, &step, 1, MPI_UNSIGNED, MPI_MIN, smpi->world() );
+    int ok = step > 0 && ( own_step == step || partner_step == step ), all_ok;
+    MPI_Allreduce( &ok, &all_ok, 1, MPI_INT, MPI_LAND, smpi->world() );
+    if( ! all_ok ) {
+        return 0;
+    }
+
+    // The missing files are copied back from the partners
+    int need = own_step != step;
+    vector<int> needs( partner_senders_.size() );
+    for( unsigned int i=0; i<partner_senders_.size(); i++ ) {
+        MPI_Irecv( &needs[i], 1, MPI_INT, partner_senders_[i], 1, smpi->world(), &requests[i] );
+    }
+    MPI_Isend( &need, 1, MPI_INT, partner_, 1, smpi->world(), &requests.back() );
+    MPI_Waitall( requests.size(), requests.data(), MPI_STATUSES_IGNORE );
+    vector<int> dests, sources;
+    vector<vector<char> > files, received;
+    for( unsigned int i=0; i<partner_senders_.size(); i++ ) {
+        if( needs[i] ) {
+            dests.push_back( partner_senders_[i] );
+            files.push_back( vector<char>() );
+            readFile( localFileName( "partner", partner_senders_[i] ), files.back() );
+        }
+    }
+    vector<vector<char> *> sends( files.size() );
+    for( unsigned int i=0; i<files.size(); i++ ) {
+        sends[i] = &files[i];
+    }
+    if( need ) {
+        sources.push_back( partner_ );
+    }
+    exchangeBuffers( smpi->world(), dests, sends, sources, received );
+    if( need ) {
+        writeFile( localFileName( "dump", smpi->getRank() ), received[0] );
+    }
+    return step;
+}
+
+void Checkpoint::exchangeBuffers( MPI_Comm comm, vector<int> &dests, vector<vector<char> *> &sends,
+                                  vector<int> &sources, vector<vector<char> > &recvs )
+{
+    // Sizes first, then the data by chunks of 1 GB (MPI counts are int)
+    const uint64_t chunk = 1073741824;
+    vector<uint64_t> send_sizes( dests.size() ), recv_sizes( sources.size() );
+    vector<MPI_Request> requests( dests.size() + sources.size() );
+    for( unsigned int i=0; i<dests.size(); i++ ) {
+        send_sizes[i] = sends[i]->size();
+        MPI_Isend( &send_sizes[i], 1, MPI_UINT64_T, dests[i], 2, comm, &requests[i] );
+    }
+    for( unsigned int i=0; i<sources.size(); i++ ) {
+        MPI_Irecv( &recv_sizes[i], 1, MPI_UINT64_T, sources[i], 2, comm, &requests[dests.size()+i] );
+    }
+    MPI_Waitall( requests.size(), requests.data(), MPI_STATUSES_IGNORE );
+
+    requests.resize( 0 );
+    recvs.resize( sources.size() );
+    for( unsigned int i=0; i<dests.size(); i++ ) {
+        for( uint64_t start=0; start<send_sizes[i]; start+=chunk ) {
+            requests.push_back( MPI_REQUEST_NULL );
+            MPI_Isend( sends[i]->data()+start, min( chunk, send_sizes[i]-start ), MPI_CHAR, dests[i], 3, comm, &requests.back() );
+        }
+    }
+    for( unsigned int i=0; i<sources.size(); i++ ) {
+        recvs[i].resize( recv_sizes[i] );
+        for( uint64_t start=0; start<recv_sizes[i]; start+=chunk ) {
+            requests.push_back( MPI_REQUEST_NULL );
+            MPI_Irecv( recvs[i].data()+start, min( chunk, recv_sizes[i]-start ), MPI_CHAR, sources[i], 3, comm, &requests.back() );
+        }
+    }
+    MPI_Waitall( requests.size(), requests.data(), MPI_STATUSES_IGNORE );
+}
+
+void Checkpoint::writeFile( string name, vector<char> &buffer )
+{
+    string temporary = name + ".tmp";
+    FILE *file = fopen( temporary.c_str(), "wb" );
+    if( ! file || fwrite( buffer.data(), 1, buffer.size(), file ) != buffer.size() ) {
+        ERROR( "Cannot write the file " << temporary );
+    }
+    fclose( file );
+    if( rename( temporary.c_str(), name.c_str() ) != 0 ) {
+        ERROR( "Cannot rename the file " << temporary );
+    }
+}
+
+bool Checkpoint::readFile( string name, vector<char> &buffer )
+{
+    FILE *file = fopen( name.c_str(), "rb" );
+    if( ! file ) {
+        return false;
+    }
+    fseek( file, 0, SEEK_END );
+    buffer.resize( ftell( file ) );
+    fseek( file, 0, SEEK_SET );
+    bool ok = fread( buffer.data(), 1, buffer.size(), file ) == buffer.size();
+    fclose( file );
+    return ok;
+}
+
+void Checkpoint::waitDump( SmileiMPI *smpi )
+{
+    if( writer_.joinable() ) {
+        writer_.join();
+    }
+    if( index_pending_ ) {
+        writeIndex( smpi, index_itime_ );
+        index_pending_ = false;
+    }
+}
+
+
+string Checkpoint::dumpFileName( string dir, unsigned int num_dump, unsigned int rank, unsigned int n_ranks, unsigned int grouping )
+{
+    ostringstream name( "" );
+    name << dir << PATH_SEPARATOR;
+    if( grouping>0 ) {
+        name << setfill( '0' ) << setw( int( 1+log10( n_ranks/grouping+1 ) ) ) << rank/grouping << PATH_SEPARATOR;
+    }
+    name << "dump-" << setfill( '0' ) << setw( 5 ) << num_dump << "-" << setfill( '0' ) << setw( 10 ) << rank << ".h5" ;
+    return name.str();
+}
+
+string Checkpoint::indexFileName( string dir, unsigned int num_dump )
+{
+    ostringstream name( "" );
+    name << dir << PATH_SEPARATOR << "index-" << setfill( '0' ) << setw( 5 ) << num_dump << ".h5" ;
+    return name.str();
+}
+
+void Checkpoint::writeIndex( SmileiMPI *smpi, unsigned int itime )
+{
+    unsigned int num_dump = ( dump_number-1 ) % keep_n_dumps;
+
+    // All the files of the dump must be complete
+    smpi->barrier();
+    // Only then the previous dump of the slot is invalidated, and its files replaced
+    if( smpi->isMaster() ) {
+        remove( indexFileName( "checkpoints", num_dump ).c_str() );
+    }
+    smpi->barrier();
+    if( rename( ( dump_file_name_ + ".tmp" ).c_str(), dump_file_name_.c_str() ) != 0 ) {
+        ERROR( "Cannot rename the checkpoint file " << dump_file_name_ << ".tmp" );
+    }
+    smpi->barrier();
+    if( smpi->isMaster() ) {
+        H5Write f( indexFileName( "checkpoints", num_dump ) );
+        f.attr( "dump_step", itime );
+        f.attr( "dump_number", dump_number );
+        f.attr( "num_dump", num_dump );
+        f.attr( "number_of_files", ( unsigned int ) smpi->getSize() );
+        f.attr( "file_grouping", file_grouping );
+        f.vect( "patch_count", smpi->patch_count );
+        f.vect( "number_of_patches", number_of_patches_ );
+    }
+}
+
+unsigned int Checkpoint::restartOwner( unsigned int hindex )
+{
+    unsigned int rank = upper_bound( restart_refHindexes_.begin(), restart_refHindexes_.end(), ( int ) hindex ) - restart_refHindexes_.begin();
+    return rank > 0 ? rank-1 : 0;
 }
 
 
@@ -452,6 +990,17 @@ void Checkpoint::dumpPatch( Patch *patch, Params &params, H5Write &g )
         }
     }
 
+    // Averaged fields and currents of the sub-cycled species, between two pushes
+    if( EMfields->averaged_fields_.size() > 0 ) {
+        H5Write sub = g.group( "SubcycledFields" );
+        for( Field *field: EMfields->averaged_fields_ ) {
+            dumpFieldsPerProc( sub, field );
+        }
+        for( Field *field: EMfields->subcycled_currents_ ) {
+            dumpFieldsPerProc( sub, field );
+        }
+    }
+
     // Fields required for DiagProbes with time integral
     for( unsigned int iprobe=0; iprobe<patch->probes.size(); iprobe++ ) {
         unsigned int nFields = patch->probes[iprobe]->integrated_data.size();
@@ -588,6 +1137,34 @@ void Checkpoint::dumpPatch( Patch *patch, Params &params, H5Write &g )
 
 void Checkpoint::readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin )
 {
+    // From an index, the patches are distributed evenly if the number of processes changed,
+    // and each process starts with the file holding its first patch
+    if( restart_from_index_ ) {
+        if( restart_patch_count_.size() == ( size_t ) smpi->getSize() && ! repatch_ ) {
+            smpi->patch_count = restart_patch_count_;
+        } else {
+            int n_patches = 1;
+            for( unsigned int i=0; i<number_of_patches_.size(); i++ ) {
+                n_patches *= number_of_patches_[i];
+            }
+            smpi->patch_count.resize( smpi->getSize() );
+            for( int rk=0 ; rk<smpi->getSize() ; rk++ ) {
+                smpi->patch_count[rk] = n_patches / smpi->getSize() + ( rk < n_patches % smpi->getSize() ? 1 : 0 );
+            }
+            MESSAGE( 1, "Patches of " << restart_patch_count_.size() << " processes redistributed to " << smpi->getSize() << " processes" );
+        }
+        smpi->patch_refHindexes.resize( smpi->patch_count.size(), 0 );
+        for( int rk=1 ; rk<smpi->smilei_sz ; rk++ ) {
+            smpi->patch_refHindexes[rk] = smpi->patch_refHindexes[rk-1] + smpi->patch_count[rk-1];
+        }
+        // With new patches, the hilbert indices differ from the dump: any file of the previous run gives the global data
+        unsigned int owner = repatch_ ? smpi->getRank() % restart_patch_count_.size() : restartOwner( smpi->patch_refHindexes[smpi->getRank()] );
+        restart_file = dumpFileName( restart_dir_ + PATH_SEPARATOR + "checkpoints", restart_num_dump_, owner, restart_patch_count_.size(), restart_file_grouping_ );
+        H5Read f( restart_file );
+        restartMovingWindow( f, simWin );
+        return;
+    }
+
     H5Read f( restart_file );
 
     // Read basic attributes
@@ -618,7 +1195,8 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
 {
     MESSAGE( 1, "READING fields and particles for restart" );
 
-    H5Read f( restart_file );
+    H5Read f( restart_file, NULL, true, restart_in_memory_ );
+    checkFullDump( f, restart_file );
 
     // Write diags scalar data
     DiagnosticScalar *scalars = static_cast<DiagnosticScalar *>( vecPatches.globalDiags[0] );
@@ -628,16 +1206,24 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
         f.attr( "Energy_time_zero",  scalars->Energy_time_zero );
         f.attr( "EnergyUsedForNorm", scalars->EnergyUsedForNorm );
     }
-    // Poynting scalars
-    unsigned int k=0;
-    for( unsigned int j=0; j<2; j++ ) { //directions (xmin/xmax, ymin/ymax, zmin/zmax)
-        for( unsigned int i=0; i<params.nDim_field; i++ ) { //axis 0=x, 1=y, 2=z
-            string poy_name = Tools::merge( "Poy", Tools::xyz[i], j==0?"min":"max" );
-            if( f.hasAttr( poy_name ) ) {
-                f.attr( poy_name, vecPatches( 0 )->EMfields->poynting[j][i] );
+    // Poynting scalars (of each previous process, read by the process getting its first patch)
+    unsigned int first_owner = smpi->getRank();
+    if( repatch_ ) {
+        // New patches: the fluxes of the previous processes are shared among the current ones
+        first_owner = smpi->getRank() % restart_patch_count_.size();
+        for( unsigned int rk = smpi->getRank(); rk < restart_patch_count_.size(); rk += smpi->getSize() ) {
+            if( rk == first_owner ) {
+                restartPoynting( f, vecPatches, params );
+            } else {
+                H5Read other( dumpFileName( restart_dir_ + PATH_SEPARATOR + "checkpoints", restart_num_dump_, rk, restart_patch_count_.size(), restart_file_grouping_ ) );
+                restartPoynting( other, vecPatches, params );
             }
-            k++;
         }
+    } else if( restart_from_index_ ) {
+        first_owner = restartOwner( vecPatches( 0 )->Hindex() );
+    }
+    if( ! repatch_ && ( ! restart_from_index_ || ( int ) vecPatches( 0 )->Hindex() == restart_refHindexes_[first_owner] ) ) {
+        restartPoynting( f, vecPatches, params );
     }
 
     // Read the diags screen data
@@ -647,6 +1233,17 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
             if( DiagnosticScreen *screen = dynamic_cast<DiagnosticScreen *>( vecPatches.globalDiags[idiag] ) ) {
                 ostringstream diagName( "" );
                 diagName << "DiagScreen" << iscreen;
+                if( screen->sparse() ) {
+                    if( f.has( diagName.str()+"_indices" ) ) {
+                        vector<unsigned int> indices;
+                        vector<double> values;
+                        f.vect( diagName.str()+"_indices", indices, true );
+                        f.vect( diagName.str()+"_values", values, true );
+                        screen->setSparseData( indices, values );
+                    }
+                    iscreen++;
+                    continue;
+                }
                 int target_size = screen->getData()->size();
                 int vect_size = f.vectSize( diagName.str() );
                 if( vect_size == target_size ) {
@@ -659,13 +1256,45 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
         }
     }
 
-    // Read all the patch data
-    for( unsigned int ipatch=0 ; ipatch<vecPatches.size(); ipatch++ ) {
+    // Assemble the new patches from the old ones
+    if( repatch_ ) {
+        map<unsigned int, H5Read *> files;
+        for( unsigned int ipatch=0 ; ipatch<vecPatches.size(); ipatch++ ) {
+            restartRepatched( vecPatches( ipatch ), params, files );
+        }
+        for( auto &file: files ) {
+            delete file.second;
+        }
+        for( unsigned int idiag=0; idiag<vecPatches.localDiags.size(); idiag++ ) {
+            DiagnosticProbes *probe = dynamic_cast<DiagnosticProbes *>( vecPatches.localDiags[idiag] );
+            if( probe && probe->time_integral ) {
+                WARNING( "The time integrals of the probes restart from zero with new patches" );
+                break;
+            }
+        }
+    }
+    
+    // Read all the patch data, from the files of several previous processes if restarting from an index
+    H5Read *file = &f, *other_file = nullptr;
+    unsigned int owner = first_owner;
+    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() && ! repatch_; ipatch++ ) {
+
+        if( restart_from_index_ && restartOwner( vecPatches( ipatch )->Hindex() ) != owner ) {
+            owner = restartOwner( vecPatches( ipatch )->Hindex() );
+            delete other_file;
+            string other_name = dumpFileName( restart_dir_ + PATH_SEPARATOR + "checkpoints", restart_num_dump_, owner, restart_patch_count_.size(), restart_file_grouping_ );
+            other_file = new H5Read( other_name, NULL, true, restart_in_memory_ );
+            checkFullDump( *other_file, other_name );
+            file = other_file;
+            if( ( int ) vecPatches( ipatch )->Hindex() == restart_refHindexes_[owner] ) {
+                restartPoynting( *file, vecPatches, params );
+            }
+        }
 
         ostringstream patch_name( "" );
         patch_name << setfill( '0' ) << setw( 6 ) << vecPatches( ipatch )->Hindex();
         string patchName = Tools::merge( "patch-", patch_name.str() );
-        H5Read g = f.group( patchName );
+        H5Read g = file->group( patchName );
 
         restartPatch( vecPatches( ipatch ), params, g );
 
@@ -673,6 +1302,7 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
         g.attr( "xorshift32_state", vecPatches( ipatch )->rand_->xorshift32_state );
 
     }
+    delete other_file;
 
     if (params.multiple_decomposition) {
         ostringstream patch_name( "" );
@@ -682,22 +1312,305 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
         restartPatch( region.patch_, params, g );
     }
 
-    // Read the latest Id that the MPI processes have given to each species
+    // Read the latest Id that the MPI processes have given to each species.
+    // If the number of processes changed, each one continues the IDs of the previous process of same rank, if any.
+    H5Read *id_file = &f, *own_file = nullptr;
+    if( restart_from_index_ && first_owner != ( unsigned int ) smpi->getRank() ) {
+        id_file = nullptr;
+        if( ( size_t ) smpi->getRank() < restart_patch_count_.size() ) {
+            own_file = new H5Read( dumpFileName( restart_dir_ + PATH_SEPARATOR + "checkpoints", restart_num_dump_, smpi->getRank(), restart_patch_count_.size(), restart_file_grouping_ ) );
+            id_file = own_file;
+        }
+    }
     for( unsigned int idiag=0; idiag<vecPatches.localDiags.size(); idiag++ ) {
         if( DiagnosticTrack *track = dynamic_cast<DiagnosticTrack *>( vecPatches.localDiags[idiag] ) ) {
             ostringstream n( "" );
             n<< "latest_ID_" << track->species_name_;
-            if( f.hasAttr( n.str() ) ) {
-                f.attr( n.str(), track->latest_Id, H5T_NATIVE_UINT64 );
+            if( ! id_file ) {
+                track->latest_Id = smpi->getRank() * 4294967296; // 2^32
+            } else if( id_file->hasAttr( n.str() ) ) {
+                id_file->attr( n.str(), track->latest_Id, H5T_NATIVE_UINT64 );
             } else {
                 track->IDs_done=false;
             }
         }
     }
+    delete own_file;
 
 }
 
 
+void Checkpoint::restartRepatched( Patch *patch, Params &params, map<unsigned int, H5Read *> &files )
+{
+    ElectroMagn * EMfields = patch->EMfields;
+    const unsigned int ndim = params.nDim_field;
+
+    if( ( EMfields->extFields.size()>0 ) && ( params.save_magnectic_fields_for_SM ) ) {
+        ERROR( "Restart with a different number_of_patches not available with the stored fields of the silver-muller boundaries" );
+    }
+    for( unsigned int ii = 0; ii < 2; ii++ ) {
+        if( ! EMfields->emBoundCond[ii] ) continue;
+        for( Laser * las: EMfields->emBoundCond[ii]->vecLaser ) {
+            for( LaserProfile * prof: las->profiles ) {
+                if( dynamic_cast<LaserProfileFile *>( prof ) ) {
+                    ERROR( "Restart with a different number_of_patches not available with LaserOffset" );
+                }
+            }
+        }
+    }
+
+    // Fields of the patch (complex fields are read as pairs of doubles), and their group in the dump
+    struct RepatchedField {
+        Field *field;
+        unsigned int ncomp;
+        string group;
+    };
+    vector<RepatchedField> fields;
+    if ( params.geometry != "AMcylindrical" ) {
+        for( Field *field: { EMfields->Ex_, EMfields->Ey_, EMfields->Ez_, EMfields->Bx_, EMfields->By_, EMfields->Bz_, EMfields->Bx_m, EMfields->By_m, EMfields->Bz_m } ) {
+            fields.push_back( { field, 1, "" } );
+        }
+        if( params.use_BTIS3 ) {
+            fields.push_back( { EMfields->By_mBTIS3, 1, "" } );
+            fields.push_back( { EMfields->Bz_mBTIS3, 1, "" } );
+        }
+    } else {
+        ElectroMagnAM *emAM = static_cast<ElectroMagnAM *>( EMfields );
+        for ( unsigned int imode = 0 ; imode < params.nmodes ; imode++ ) {
+            for( Field *field: { emAM->El_[imode], emAM->Er_[imode], emAM->Et_[imode], emAM->Bl_[imode], emAM->Br_[imode], emAM->Bt_[imode], emAM->Bl_m[imode], emAM->Br_m[imode], emAM->Bt_m[imode] } ) {
+                fields.push_back( { field, 2, "" } );
+            }
+            if( params.use_BTIS3 ) {
+                fields.push_back( { emAM->Br_mBTIS3[imode], 2, "" } );
+                fields.push_back( { emAM->Bt_mBTIS3[imode], 2, "" } );
+            }
+            if( params.is_pxr ) {
+                fields.push_back( { emAM->rho_old_AM_[imode], 2, "" } );
+            }
+        }
+    }
+    for( unsigned int idiag=0; idiag<EMfields->allFields_avg.size(); idiag++ ) {
+        ostringstream group_name( "" );
+        group_name << "FieldsForDiag" << idiag;
+        for( Field *field: EMfields->allFields_avg[idiag] ) {
+            fields.push_back( { field, 1, group_name.str() } );
+        }
+    }
+    for( Field *field: EMfields->averaged_fields_ ) {
+        fields.push_back( { field, 1, "SubcycledFields" } );
+    }
+    for( Field *field: EMfields->subcycled_currents_ ) {
+        fields.push_back( { field, 1, "SubcycledFields" } );
+    }
+
+    // Cells of the new patch, and range of the old patches covering it with its ghost cells
+    vector<int> old_size( 3, 1 ), new_start( 3, 0 ), new_size( 3, 1 ), oversize( 3, 0 ), first( 3, 0 ), last( 3, 0 );
+    vector<unsigned int> mi( 3, 0 );
+    for( unsigned int i=0; i<ndim; i++ ) {
+        mi[i] = ( unsigned int ) round( log2( ( double ) restart_number_of_patches_[i] ) );
+        old_size [i] = params.global_size_[i] / restart_number_of_patches_[i];
+        new_size [i] = params.patch_size_[i];
+        new_start[i] = patch->Pcoordinates[i] * new_size[i];
+        oversize [i] = params.oversize[i];
+        first[i] = max( new_start[i] - oversize[i], 0 ) / old_size[i];
+        last [i] = min( ( new_start[i] + new_size[i] + oversize[i] ) / old_size[i], ( int ) restart_number_of_patches_[i] - 1 );
+    }
+
+    // The scalars of the patch are the sums of the old patches whose first cell it contains
+    EMfields->nrj_mw_inj = 0.;
+    EMfields->nrj_mw_out = 0.;
+    for( Species *spec: patch->vecSpecies ) {
+        spec->nrj_bc_lost = 0.;
+        spec->nrj_mw_inj = 0.;
+        spec->nrj_mw_out = 0.;
+        spec->nrj_new_part_ = 0.;
+        spec->nrj_radiated_ = 0.;
+        spec->particles->initialize( 0, nDim_particle, params.keep_position_old );
+        fill( spec->particles->first_index.begin(), spec->particles->first_index.end(), 0 );
+        fill( spec->particles->last_index .begin(), spec->particles->last_index .end(), 0 );
+    }
+
+    vector<double> buffer;
+    for( int o0 = first[0]; o0 <= last[0]; o0++ ) {
+    for( int o1 = first[1]; o1 <= last[1]; o1++ ) {
+    for( int o2 = first[2]; o2 <= last[2]; o2++ ) {
+        int o[3] = { o0, o1, o2 };
+
+        // Old patch: hilbert index, file, and whether it holds particles or the scalars of the new patch
+        unsigned int hindex;
+        if( ndim == 1 ) {
+            hindex = generalhilbertindex( mi[0], 0, o0, 0 );
+        } else if( ndim == 2 ) {
+            hindex = generalhilbertindex( mi[0], mi[1], o0, o1 );
+        } else {
+            hindex = generalhilbertindex( mi[0], mi[1], mi[2], o0, o1, o2 );
+        }
+        unsigned int owner = restartOwner( hindex );
+        if( files.find( owner ) == files.end() ) {
+            string name = dumpFileName( restart_dir_ + PATH_SEPARATOR + "checkpoints", restart_num_dump_, owner, restart_patch_count_.size(), restart_file_grouping_ );
+            files[owner] = new H5Read( name, NULL, true, restart_in_memory_ );
+            checkFullDump( *files[owner], name );
+        }
+        ostringstream patch_name( "" );
+        patch_name << "patch-" << setfill( '0' ) << setw( 6 ) << hindex;
+        H5Read g = files[owner]->group( patch_name.str() );
+        bool interior = true, origin = true;
+        for( unsigned int i=0; i<ndim; i++ ) {
+            int old_start = o[i] * old_size[i];
+            interior = interior && old_start < new_start[i] + new_size[i] && old_start + old_size[i] > new_start[i];
+            origin   = origin   && old_start >= new_start[i] && old_start < new_start[i] + new_size[i];
+        }
+
+        // Fields: the values of the old patch, with its ghost cells only at the box boundaries, where they overlap the new patch
+        for( RepatchedField &rf: fields ) {
+            if( rf.group.empty() ) {
+                g.vect( rf.field->name, buffer, true );
+            } else if( g.has( rf.group ) ) {
+                H5Read d = g.group( rf.group );
+                d.vect( rf.field->name, buffer, true );
+            } else {
+                continue;
+            }
+            vector<int> new_dims( 3, 1 ), old_dims( 3, 1 ), lo( 3, 0 ), hi( 3, 1 ), shift( 3, 0 );
+            size_t old_points = 1;
+            for( unsigned int i=0; i<ndim; i++ ) {
+                new_dims[i] = rf.field->dims_[i];
+                old_dims[i] = new_dims[i] - new_size[i] + old_size[i];
+                old_points *= old_dims[i];
+                shift[i] = o[i] * old_size[i] - new_start[i];
+                lo[i] = max( o[i] == 0 ? 0 : oversize[i], -shift[i] );
+                hi[i] = min( o[i] == ( int ) restart_number_of_patches_[i]-1 ? old_dims[i] : old_dims[i] - oversize[i], new_dims[i] - shift[i] );
+            }
+            if( buffer.size() != old_points * rf.ncomp ) {
+                ERROR( "Restart: " << rf.field->name << " of " << patch_name.str() << " has " << buffer.size() << " values instead of " << old_points * rf.ncomp );
+            }
+            double *data = rf.ncomp == 1 ? rf.field->data_ : ( double * ) static_cast<cField *>( rf.field )->cdata_;
+            for( int i0 = lo[0]; i0 < hi[0]; i0++ ) {
+                for( int i1 = lo[1]; i1 < hi[1]; i1++ ) {
+                    if( lo[2] >= hi[2] ) {
+                        continue;
+                    }
+                    size_t old_index = ( ( size_t ) i0 * old_dims[1] + i1 ) * old_dims[2] + lo[2];
+                    size_t new_index = ( ( size_t )( i0 + shift[0] ) * new_dims[1] + i1 + shift[1] ) * new_dims[2] + lo[2] + shift[2];
+                    memcpy( &data[new_index * rf.ncomp], &buffer[old_index * rf.ncomp], ( hi[2] - lo[2] ) * rf.ncomp * sizeof( double ) );
+                }
+            }
+        }
+
+        if( origin ) {
+            double nrj;
+            g.attr( "nrj_mw_inj", nrj );
+            EMfields->nrj_mw_inj += nrj;
+            g.attr( "nrj_mw_out", nrj );
+            EMfields->nrj_mw_out += nrj;
+            if( g.vectSize( "nuclear_reaction_multiplier" ) > 0 ) {
+                std::vector<double> rate_multiplier;
+                g.vect( "nuclear_reaction_multiplier", rate_multiplier, true );
+                for( unsigned int icoll = 0; icoll<rate_multiplier.size(); icoll++ ) {
+                    for( unsigned int iBP = 0; iBP < patch->vecBPs[icoll]->processes_.size(); iBP++ ) {
+                        if( CollisionalNuclearReaction * NR = dynamic_cast<CollisionalNuclearReaction*>(patch->vecBPs[icoll]->processes_[iBP]) ) {
+                            NR->rate_multiplier_ = rate_multiplier[icoll];
+                        }
+                    }
+                }
+            }
+        }
+        if( ! interior && ! origin ) {
+            continue;
+        }
+
+        unsigned int vecSpeciesSize=0;
+        g.attr( "species", vecSpeciesSize );
+        if( vecSpeciesSize != patch->vecSpecies.size() ) {
+            ERROR_NAMELIST( "Number of species differs between dump (" << vecSpeciesSize << ") and namelist ("<<patch->vecSpecies.size()<<")",
+            "https://smileipic.github.io/Smilei/namelist.html#checkpoints");
+        }
+        for( unsigned int ispec=0 ; ispec<patch->vecSpecies.size() ; ispec++ ) {
+            Species * spec = patch->vecSpecies[ispec];
+            ostringstream name( "" );
+            name << setfill( '0' ) << setw( 2 ) << ispec;
+            H5Read s = g.group( Tools::merge( "species-", name.str(), "-", spec->name_ ) );
+
+            if( origin ) {
+                double nrj;
+                s.attr( "nrj_bc_lost", nrj );
+                spec->nrj_bc_lost += nrj;
+                s.attr( "nrj_mw_inj", nrj );
+                spec->nrj_mw_inj += nrj;
+                s.attr( "nrj_mw_out", nrj );
+                spec->nrj_mw_out += nrj;
+                s.attr( "nrj_new_part", nrj );
+                spec->nrj_new_part_ += nrj;
+                s.attr( "radiatedEnergy", nrj );
+                spec->nrj_radiated_ += nrj;
+                if( spec->birth_records_ && s.has( "birth_records" ) ) {
+                    H5Read b = s.group( "birth_records" );
+                    vector<double> birth_time;
+                    b.vect( "birth_time", birth_time, true );
+                    Particles records;
+                    records.initialize( birth_time.size(), *spec->particles );
+                    restartParticles( b, records );
+                    for( unsigned int ipart=0; ipart<records.size(); ipart++ ) {
+                        records.copyParticle( ipart, spec->birth_records_->p_ );
+                    }
+                    spec->birth_records_->birth_time_.insert( spec->birth_records_->birth_time_.end(), birth_time.begin(), birth_time.end() );
+                }
+            }
+
+            // Particles of the old patch located in the new patch, inserted in their bins
+            unsigned int partSize=0;
+            s.attr( "partSize", partSize );
+            if( ! interior || partSize == 0 ) {
+                continue;
+            }
+            Particles old_particles, new_particles;
+            old_particles.initialize( partSize, *spec->particles );
+            restartParticles( s, old_particles );
+            new_particles.initialize( 0, *spec->particles );
+            const int nbin = spec->particles->first_index.size();
+            vector<int> bin_keys;
+            for( unsigned int ipart=0; ipart<partSize; ipart++ ) {
+                bool inside = true;
+                for( unsigned int i=0; i<ndim; i++ ) {
+                    double x = old_particles.position( i, ipart );
+                    if( params.geometry == "AMcylindrical" && i == 1 ) {
+                        x = sqrt( x * x + old_particles.position( 2, ipart ) * old_particles.position( 2, ipart ) );
+                    }
+                    inside = inside && x >= patch->getDomainLocalMin( i ) && x < patch->getDomainLocalMax( i );
+                }
+                if( inside ) {
+                    int key = ( int )( old_particles.position( 0, ipart ) / params.cell_length[0] ) - ( patch->getCellStartingGlobalIndex( 0 ) + params.oversize[0] );
+                    bin_keys.push_back( min( max( key / ( int ) params.cluster_width_, 0 ), nbin - 1 ) );
+                    old_particles.copyParticle( ipart, new_particles );
+                }
+            }
+            new_particles.copyParticlesToBins( bin_keys, *spec->particles );
+        }
+    }
+    }
+    }
+
+    for( Species *spec: patch->vecSpecies ) {
+        spec->particles->resizeCellKeys( spec->particles->size() );
+    }
+}
+
+
+void Checkpoint::restartPoynting( H5Read &f, VectorPatch &vecPatches, Params &params )
+{
+    for( unsigned int j=0; j<2; j++ ) { //directions (xmin/xmax, ymin/ymax, zmin/zmax)
+        for( unsigned int i=0; i<params.nDim_field; i++ ) { //axis 0=x, 1=y, 2=z
+            string poy_name = Tools::merge( "Poy", Tools::xyz[i], j==0?"min":"max" );
+            if( f.hasAttr( poy_name ) ) {
+                double poy_val = 0.;
+                f.attr( poy_name, poy_val );
+                vecPatches( 0 )->EMfields->poynting[j][i] += poy_val;
+            }
+        }
+    }
+}
+
+
 void Checkpoint::readRegionDistribution( Region &region )
 {
     int read_hindex( -1 );
@@ -860,6 +1773,24 @@ void Checkpoint::restartPatch( Patch *patch, Params &params, H5Read &g )
         }
     }
 
+    // Averaged fields and currents of the sub-cycled species, between two pushes
+    if( EMfields->averaged_fields_.size() > 0 ) {
+        if( g.has( "SubcycledFields" ) ) {
+            H5Read d = g.group( "SubcycledFields" );
+            for( Field *field: EMfields->averaged_fields_ ) {
+                restartFieldsPerProc( d, field );
+            }
+            for( Field *field: EMfields->subcycled_currents_ ) {
+                if( d.has( field->name ) ) {
+                    restartFieldsPerProc( d, field );
+                }
+            }
+        } else {
+            // The species were not sub-cycled before the restart: their first averages are incomplete
+            WARNING( "New sub-cycled species may be pushed with wrong fields at their first push after restart" );
+        }
+    }
+
     // Fields required for DiagProbes with time integral
     for( unsigned int iprobe=0; iprobe<patch->probes.size(); iprobe++ ) {
         ostringstream group_name( "" );
@@ -1018,15 +1949,89 @@ void Checkpoint::restartPatch( Patch *patch, Params &params, H5Read &g )
     }
 }
 
+uint64_t Checkpoint::arrayHash( const void *data, size_t n_bytes )
+{
+    // FNV-1a over 8-byte words, with a final avalanche (splitmix64)
+    const unsigned char *bytes = static_cast<const unsigned char *>( data );
+    uint64_t h = 0xcbf29ce484222325ULL ^ n_bytes;
+    size_t i = 0;
+    for( ; i+8<=n_bytes; i+=8 ) {
+        uint64_t word;
+        memcpy( &word, bytes+i, 8 );
+        h = ( h ^ word ) * 0x100000001b3ULL;
+    }
+    for( ; i<n_bytes; i++ ) {
+        h = ( h ^ bytes[i] ) * 0x100000001b3ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+template<class T>
+void Checkpoint::dumpArray( H5Write &g, std::string name, T &v, unsigned int size, hid_t type, hid_t file_type )
+{
+    bool hashed = incremental_dumps_ > 0 && size > 0;
+    uint64_t hash = 0;
+    if( hashed ) {
+        hash = arrayHash( &v, size * sizeof( T ) );
+        if( incremental_ ) {
+            std::map<uint64_t, std::string>::iterator it = full_dump_arrays_.find( hash );
+            if( it != full_dump_arrays_.end() ) {
+                g.externalLink( name, full_dump_file_, it->second );
+                return;
+            }
+        }
+    }
+    if( size > 0 && ( compression_filter_ != H5Z_FILTER_NONE || file_type != type ) ) {
+        g.compressedVect( name, v, size, type, file_type );
+    } else {
+        g.vect( name, v, size, type );
+    }
+    if( hashed && ! incremental_ && full_dump_arrays_.find( hash ) == full_dump_arrays_.end() ) {
+        full_dump_arrays_[hash] = g.path() + "/" + name;
+    }
+}
+
+hid_t Checkpoint::fileType( std::string kind )
+{
+    if( find( single_precision_.begin(), single_precision_.end(), kind ) != single_precision_.end() ) {
+        return H5T_NATIVE_FLOAT;
+    }
+    return H5T_NATIVE_DOUBLE;
+}
+
+void Checkpoint::checkFullDump( H5Read &f, std::string file_name )
+{
+    if( ! f.hasAttr( "full_dump" ) ) {
+        return;
+    }
+    string full_dump;
+    unsigned int full_dump_number = 0, number = 0;
+    f.attr( "full_dump", full_dump );
+    f.attr( "full_dump_number", full_dump_number );
+    full_dump = file_name.substr( 0, file_name.rfind( PATH_SEPARATOR ) + 1 ) + full_dump;
+    H5Read full( full_dump, NULL, false );
+    if( full.valid() ) {
+        full.attr( "dump_number", number );
+    }
+    if( number != full_dump_number ) {
+        ERROR( "The incremental dump " << file_name << " requires the full dump " << full_dump << " which was overwritten or removed" );
+    }
+}
+
 void Checkpoint::dumpFieldsPerProc( H5Write &g, Field *field )
 {
-    g.vect( field->name, *field->data_, field->number_of_points_, H5T_NATIVE_DOUBLE );
+    dumpArray( g, field->name, *field->data_, field->number_of_points_, H5T_NATIVE_DOUBLE, fileType( "fields" ) );
 }
 
 void Checkpoint::dump_cFieldsPerProc( H5Write &g, Field *field )
 {
     cField *cfield = static_cast<cField *>( field );
-    g.vect( field->name, *cfield->cdata_, 2*field->number_of_points_, H5T_NATIVE_DOUBLE );
+    dumpArray( g, field->name, *( double * )cfield->cdata_, 2*field->number_of_points_, H5T_NATIVE_DOUBLE, fileType( "fields" ) );
 }
 
 void Checkpoint::restartFieldsPerProc( H5Read &g, Field *field )
@@ -1045,25 +2050,31 @@ void Checkpoint::dumpParticles( H5Write& s, Particles &p )
     for( unsigned int i=0; i<p.Position.size(); i++ ) {
         ostringstream my_name( "" );
         my_name << "Position-" << i;
-        s.vect( my_name.str(), p.Position[i] );//, dump_deflate );
+        dumpArray( s, my_name.str(), p.Position[i][0], p.Position[i].size(), H5T_NATIVE_DOUBLE, fileType( "Position" ) );
     }
     
     for( unsigned int i=0; i<p.Momentum.size(); i++ ) {
         ostringstream my_name( "" );
         my_name << "Momentum-" << i;
-        s.vect( my_name.str(),p.Momentum[i] );//, dump_deflate );
+        dumpArray( s, my_name.str(), p.Momentum[i][0], p.Momentum[i].size(), H5T_NATIVE_DOUBLE, fileType( "Momentum" ) );
     }
     
-    s.vect( "Weight", p.Weight );//, dump_deflate );
-    s.vect( "Charge", p.Charge );//, dump_deflate );
+    dumpArray( s, "Weight", p.Weight[0], p.Weight.size(), H5T_NATIVE_DOUBLE, fileType( "Weight" ) );
+    // A uniform charge (no ionization) is stored as a single attribute
+    short uniform_charge;
+    if( p.hasUniformCharge( uniform_charge ) ) {
+        s.attr( "uniform_charge", ( int )uniform_charge );
+    } else {
+        dumpArray( s, "Charge", p.Charge[0], p.Charge.size(), H5T_NATIVE_SHORT, H5T_NATIVE_SHORT );
+    }
     
     if( p.tracked ) {
-        s.vect( "Id", p.Id, H5T_NATIVE_UINT64 );//, dump_deflate );
+        dumpArray( s, "Id", p.Id[0], p.Id.size(), H5T_NATIVE_UINT64, H5T_NATIVE_UINT64 );
     }
     
     // Monte-Carlo process
     if( p.has_Monte_Carlo_process ) {
-        s.vect( "Tau", p.Tau );//, dump_deflate );
+        dumpArray( s, "Tau", p.Tau[0], p.Tau.size(), H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE );
     }
     
     // Copy interpolated fields that must be accumulated over time
@@ -1095,7 +2106,13 @@ void Checkpoint::restartParticles( H5Read& s, Particles &p )
     }
     
     s.vect( "Weight", p.Weight );
-    s.vect( "Charge", p.Charge );
+    if( s.hasAttr( "uniform_charge" ) ) {
+        int uniform_charge;
+        s.attr( "uniform_charge", uniform_charge );
+        std::fill( p.Charge.begin(), p.Charge.end(), ( short )uniform_charge );
+    } else {
+        s.vect( "Charge", p.Charge );
+    }
     
     if( p.tracked ) {
         s.vect( "Id", p.Id, H5T_NATIVE_UINT64 );
@@ -9,6 +9,9 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <cstdint>
+#include <thread>
 
 #include <hdf5.h>
 #include <Tools.h>
@@ -50,6 +53,9 @@ public:
     void readRegionDistribution( Region &region );
     void restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI *smpi, Params &params );
     void restartPatch( Patch *patch, Params &params, H5Read &g );
+    //! Assembles the data of a patch from the dumped patches of another layout which cover it
+    //! (files: the dump files opened so far, indexed by the process of the previous run)
+    void restartRepatched( Patch *patch, Params &params, std::map<unsigned int, H5Read *> &files );
     
     //! test before writing everything to file per processor
     //bool dump(unsigned int itime, double time, Params &params);
@@ -60,7 +66,8 @@ public:
     void dumpAll( VectorPatch &vecPatches, Region &region, unsigned int itime,  SmileiMPI *smpi, SimWindow *simWin, Params &params );
     void dumpPatch( Patch *patch, Params &params, H5Write &g );
     
-    //! incremental number of times we've done a dump
+    //! incremental number of times we've done a dump in the checkpoints directory
+    //! (the local dumps are counted by dumps_since_global_)
     unsigned int dump_number;
     
     //! this static variable is defined (in the .cpp) as false but becomes true when
@@ -93,6 +100,9 @@ public:
     //! exit once dump done
     bool exit_after_dump;
     
+    //! Waits for the end of the asynchronous dump, if any, and writes its index (collective)
+    void waitDump( SmileiMPI *smpi );
+    
 private:
 
     //! initialize the time zero of the simulation
@@ -127,12 +137,142 @@ private:
     //! int deflate dump value
     int dump_deflate;
     
+    //! HDF5 filter compressing the arrays, and its parameters
+    H5Z_filter_t compression_filter_;
+    std::vector<unsigned int> compression_parameters_;
+    
+    //! Kinds of arrays stored in single precision ("fields", "Position", "Momentum", "Weight")
+    std::vector<std::string> single_precision_;
+    
+    //! Type in the file of a kind of arrays
+    hid_t fileType( std::string kind );
+    
     //! group checkpoint files in subdirs of file_grouping files
     unsigned int file_grouping;
     
     //! restart file
     std::string restart_file;
     
+    //! Name of the file dumped by a process in a directory
+    static std::string dumpFileName( std::string dir, unsigned int num_dump, unsigned int rank, unsigned int n_ranks, unsigned int grouping );
+    
+    //! Name of the index of a dump, which lists the files and patches of all the processes
+    static std::string indexFileName( std::string dir, unsigned int num_dump );
+    
+    //! Writes the index of the dump that just completed (collective)
+    void writeIndex( SmileiMPI *smpi, unsigned int itime );
+    
+    //! True if restarting from an index: no search of the files, and the number of processes may change
+    bool restart_from_index_;
+    
+    //! Directory, number, grouping of the files, and patch distribution of the dump of the previous run
+    std::string restart_dir_;
+    unsigned int restart_num_dump_, restart_file_grouping_;
+    std::vector<int> restart_patch_count_, restart_refHindexes_;
+    
+    //! Process of the previous run that dumped a patch
+    unsigned int restartOwner( unsigned int hindex );
+    
+    //! Number of patches in each direction of this run, and of the dump of the previous run
+    std::vector<unsigned int> number_of_patches_, restart_number_of_patches_;
+    
+    //! True if the patches of the previous run were different: each patch is assembled from the old ones
+    bool repatch_;
+    
+    //! Adds the Poynting fluxes of a dump file to the first patch
+    void restartPoynting( H5Read &f, VectorPatch &vecPatches, Params &params );
+    
+    //! Load each restart file in memory by a single large read
+    bool restart_in_memory_;
+    
+    //! Number of incremental dumps between two full dumps (0 if all dumps are full)
+    unsigned int incremental_dumps_;
+    
+    //! Number of incremental dumps since the last full dump of this run
+    unsigned int dumps_since_full_;
+    
+    //! True while an incremental dump is written
+    bool incremental_;
+    
+    //! File name (without directory) and number of the last full dump of this process
+    std::string full_dump_file_;
+    unsigned int full_dump_number_;
+    
+    //! Path of the arrays of the last full dump, by their hash, to link the unchanged arrays of incremental dumps
+    std::map<uint64_t, std::string> full_dump_arrays_;
+    
+    //! Hash of the bytes of an array
+    static uint64_t arrayHash( const void *data, size_t n_bytes );
+    
+    //! Writes an array (converted to file_type), or links it to the identical array of the last full dump in an incremental dump
+    template<class T>
+    void dumpArray( H5Write &g, std::string name, T &v, unsigned int size, hid_t type, hid_t file_type );
+    
+    //! Errors if the restart file is an incremental dump whose full dump was overwritten
+    void checkFullDump( H5Read &f, std::string file_name );
+    
+    //! True if each process dumps into memory, then writes the file in a separate thread while the simulation continues
+    bool asynchronous_;
+    
+    //! Image of the file being written asynchronously, and its name
+    std::vector<char> dump_image_;
+    std::string dump_image_name_;
+    
+    //! File of the dump in the checkpoints directory being written: it is written as file_name_.tmp,
+    //! and renamed when all the files of the dump are complete
+    std::string dump_file_name_;
+    
+    //! Thread writing the image
+    std::thread writer_;
+    
+    //! Writes the image in its file (body of the writer thread)
+    void writeImage();
+    
+    //! True if the index of the asynchronous dump remains to be written, after the iteration index_itime_
+    bool index_pending_;
+    unsigned int index_itime_;
+    
+    //! Node-local directory of the frequent dumps (empty if all the dumps go to the checkpoints directory)
+    std::string local_dir_;
+    
+    //! Number of dumps in local_dir_ between two dumps in the checkpoints directory
+    unsigned int local_dumps_;
+    
+    //! Number of local dumps since the last dump in the checkpoints directory
+    unsigned int dumps_since_global_;
+    
+    //! True while a local dump is written
+    bool local_level_;
+    
+    //! Working directory of this run, to recognize its local dumps at restart
+    std::string run_dir_;
+    
+    //! Process (on another node) keeping a copy of the local dumps of this process,
+    //! and processes whose copies are kept by this process
+    int partner_;
+    std::vector<int> partner_senders_;
+    
+    //! Name of the local dump of a process ("dump") or of a copy kept for another process ("partner")
+    std::string localFileName( std::string prefix, int rank );
+    
+    //! Finds the partner of each process, on the next node (collective)
+    void findPartners( SmileiMPI *smpi );
+    
+    //! Writes the image of the local dump, and sends its copy to the partner (collective)
+    void dumpLocal( SmileiMPI *smpi );
+    
+    //! Step of the latest local dump that all the processes can restore, each missing file being
+    //! copied back from the partner. 0 if none (collective)
+    unsigned int restoreLocal( SmileiMPI *smpi );
+    
+    //! Sends buffers to some processes and receives buffers from others
+    static void exchangeBuffers( MPI_Comm comm, std::vector<int> &dests, std::vector<std::vector<char> *> &sends,
+                                 std::vector<int> &sources, std::vector<std::vector<char> > &recvs );
+    
+    //! Writes a whole file (through a temporary file, renamed once complete), or reads it
+    static void writeFile( std::string name, std::vector<char> &buffer );
+    static bool readFile( std::string name, std::vector<char> &buffer );
+    
     //! dump PML in the checkpoint file 
     template <typename Tpml>
     void  dump_PML(Tpml embc, H5Write &g );
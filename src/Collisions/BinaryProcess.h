@@ -16,6 +16,7 @@ public:
     virtual ~BinaryProcess() {};
     
     virtual void prepare() = 0;
+    //! Applies the process to the D.n pairs of particles in D
     virtual void apply( Random *random, BinaryProcessData &D ) = 0;
     virtual void finish( Params &, Patch *, std::vector<Diagnostic *> &, bool intra, std::vector<unsigned int> sg1, std::vector<unsigned int> sg2, int itime ) = 0;
     virtual std::string name() = 0;
@@ -3,48 +3,59 @@
 
 #include "Particles.h"
 
-//! Contains the relativistic kinematic quantities associated to the collision of two particles noted 1 and 2
+//! Maximum number of pairs of particles treated together by the binary processes
+#define SMILEI_BINARYPROCESS_BUFFERSIZE 32
+
+//! Contains the relativistic kinematic quantities associated to the collisions of a buffer of pairs of particles noted 1 and 2.
+//! Each array holds one value per pair (structure of arrays, for vectorization).
+//! The pairs of a buffer never share a particle, so that they may be processed in any order.
 struct BinaryProcessData
 {
+    //! Number of pairs in the buffer
+    unsigned int n;
+    
     //! Particles objects for both macro-particles
-    Particles *p1, *p2;
+    Particles *p1[SMILEI_BINARYPROCESS_BUFFERSIZE], *p2[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Indices of both particles
-    unsigned int i1, i2;
+    unsigned int i1[SMILEI_BINARYPROCESS_BUFFERSIZE], i2[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Masses
-    double m1, m2, m12;
+    double m1[SMILEI_BINARYPROCESS_BUFFERSIZE], m2[SMILEI_BINARYPROCESS_BUFFERSIZE], m12[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Minimum / maximum weight
-    double minW, maxW;
+    double minW[SMILEI_BINARYPROCESS_BUFFERSIZE], maxW[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Whether the first species is electron
     bool electronFirst;
     
     //! Correction to apply to the cross-sections due to the difference in weight
-    double dt_correction;
+    double dt_correction[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Velocity of the Center-Of-Mass, expressed in the lab frame
-    double COM_vx, COM_vy, COM_vz;
+    double COM_vx[SMILEI_BINARYPROCESS_BUFFERSIZE], COM_vy[SMILEI_BINARYPROCESS_BUFFERSIZE], COM_vz[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Lorentz factor of the COM, expressed in the lab frame
-    double COM_gamma;
+    double COM_gamma[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Momentum of the particles expressed in the COM frame
-    double px_COM, py_COM, pz_COM, p_COM;
+    double px_COM[SMILEI_BINARYPROCESS_BUFFERSIZE], py_COM[SMILEI_BINARYPROCESS_BUFFERSIZE], pz_COM[SMILEI_BINARYPROCESS_BUFFERSIZE], p_COM[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Lorentz factors
-    double gamma1, gamma2;
+    double gamma1[SMILEI_BINARYPROCESS_BUFFERSIZE], gamma2[SMILEI_BINARYPROCESS_BUFFERSIZE];
     //! Lorentz factors expressed in the COM frame
-    double gamma1_COM, gamma2_COM;
+    double gamma1_COM[SMILEI_BINARYPROCESS_BUFFERSIZE], gamma2_COM[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
     //! Relative velocity
-    double vrel, vrel_corr;
+    double vrel[SMILEI_BINARYPROCESS_BUFFERSIZE], vrel_corr[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
-    //! Debye length squared
+    //! Debye length squared (same for the whole bin)
     double debye2;
     
-    double term1, term3, term5, n123, n223;
+    double term1[SMILEI_BINARYPROCESS_BUFFERSIZE], term3[SMILEI_BINARYPROCESS_BUFFERSIZE], term5[SMILEI_BINARYPROCESS_BUFFERSIZE];
+    
+    //! Densities to the power 2/3 (same for the whole bin)
+    double n123, n223;
 };
 
 #endif
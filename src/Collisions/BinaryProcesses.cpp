@@ -15,6 +15,10 @@
 #include "Patch.h"
 #include "VectorPatch.h"
 #include "RandomShuffle.h"
+#if defined( SMILEI_ACCELERATOR_GPU )
+    #include "gpu.h"
+    #include "gpuRandom.h"
+#endif
 
 using namespace std;
 
@@ -29,7 +33,10 @@ BinaryProcesses::BinaryProcesses(
     int every,
     int debug_every,
     double time_frozen,
-    string filename
+    string filename,
+    int adaptive_every,
+    double adaptive_s,
+    int bin_tasks
 ) :
     processes_( processes ),
     species_group1_( species_group1 ),
@@ -37,7 +44,10 @@ BinaryProcesses::BinaryProcesses(
     intra_( intra ),
     every_( every ),
     debug_every_( debug_every ),
-    filename_( filename )
+    filename_( filename ),
+    adaptive_every_( adaptive_every ),
+    adaptive_s_( adaptive_s ),
+    bin_tasks_( bin_tasks )
 {
     timesteps_frozen_ = time_frozen / params.timestep;
     // Open the HDF5 file
@@ -60,23 +70,56 @@ BinaryProcesses::BinaryProcesses( BinaryProcesses *BPs )
     timesteps_frozen_   = BPs->timesteps_frozen_  ;
     filename_           = BPs->filename_          ;
     debug_file_         = BPs->debug_file_        ;
+    adaptive_every_     = BPs->adaptive_every_    ;
+    adaptive_s_         = BPs->adaptive_s_        ;
+    bin_tasks_          = BPs->bin_tasks_         ;
 
     processes_.clear();
     for( unsigned int i=0; i<BPs->processes_.size(); i++ ) {
-        if( Collisions * coll = dynamic_cast<Collisions*>( BPs->processes_[i] ) ) {
-            processes_.push_back( new Collisions( coll ) );
-        } else if( CollisionalIonization * CI = dynamic_cast<CollisionalIonization*>( BPs->processes_[i] ) ) {
-            processes_.push_back( new CollisionalIonization( CI ) );
-        } else if( CollisionalFusionDD * DD = dynamic_cast<CollisionalFusionDD*>( BPs->processes_[i] ) ) {
-            processes_.push_back( new CollisionalFusionDD( DD ) );
-        } else {
-            ERROR( "Undefined binary process" );
-        }
+        processes_.push_back( cloneProcess( BPs->processes_[i] ) );
     }
 
 }
 
 
+// Copy of a binary process
+BinaryProcess * BinaryProcesses::cloneProcess( BinaryProcess *BP )
+{
+    if( Collisions * coll = dynamic_cast<Collisions*>( BP ) ) {
+        return new Collisions( coll );
+    } else if( CollisionalIonization * CI = dynamic_cast<CollisionalIonization*>( BP ) ) {
+        return new CollisionalIonization( CI );
+    } else if( CollisionalFusionDD * DD = dynamic_cast<CollisionalFusionDD*>( BP ) ) {
+        return new CollisionalFusionDD( DD );
+    }
+    ERROR( "Undefined binary process" );
+    return NULL;
+}
+
+
+// Add the statistics and the new particles of a copy to the original process
+void BinaryProcesses::mergeProcess( BinaryProcess *BP, BinaryProcess *copy )
+{
+    if( Collisions * coll = dynamic_cast<Collisions*>( BP ) ) {
+        Collisions * coll_copy = static_cast<Collisions*>( copy );
+        coll->npairs_tot_ += coll_copy->npairs_tot_;
+        coll->smean_      += coll_copy->smean_;
+        coll->logLmean_   += coll_copy->logLmean_;
+    } else if( CollisionalIonization * CI = dynamic_cast<CollisionalIonization*>( BP ) ) {
+        Particles &new_electrons = static_cast<CollisionalIonization*>( copy )->new_electrons;
+        new_electrons.copyParticles( 0, new_electrons.numberOfParticles(), CI->new_electrons, CI->new_electrons.numberOfParticles() );
+    } else if( CollisionalNuclearReaction * NR = dynamic_cast<CollisionalNuclearReaction*>( BP ) ) {
+        CollisionalNuclearReaction * NR_copy = static_cast<CollisionalNuclearReaction*>( copy );
+        NR->tot_probability_ += NR_copy->tot_probability_;
+        NR->npairs_tot_      += NR_copy->npairs_tot_;
+        for( unsigned int i=0; i<NR->product_particles_.size(); i++ ) {
+            Particles *products = NR_copy->product_particles_[i];
+            products->copyParticles( 0, products->numberOfParticles(), *NR->product_particles_[i], NR->product_particles_[i]->numberOfParticles() );
+        }
+    }
+}
+
+
 BinaryProcesses::~BinaryProcesses()
 {
     for( unsigned int i=0; i<processes_.size(); i++ ) {
@@ -87,11 +130,13 @@ BinaryProcesses::~BinaryProcesses()
 
 // Declare other static variables here
 bool BinaryProcesses::debye_length_required_;
+int BinaryProcesses::debye_length_every_ = 1;
+double BinaryProcesses::debye_length_tolerance_ = 0.;
 
 
 // Calculates the debye length squared in each bin
 // The formula for the inverse debye length squared is sumOverSpecies(density*charge^2/temperature)
-void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch )
+void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch, int itime )
 {
     Species   *s;
     Particles *p;
@@ -103,16 +148,41 @@ void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch )
     }
     unsigned int nbin = patch->vecSpecies[0]->particles->first_index.size();
 
-    patch->debye_length_squared.resize( nbin );
+    // All bins are calculated every debye_length_every_ timesteps (or if the bins changed)
+    bool all_bins = patch->debye_length_squared.size() != nbin || itime - patch->debye_length_itime >= debye_length_every_;
+    if( all_bins ) {
+        patch->debye_length_squared.resize( nbin );
+        patch->debye_length_density.resize( nbin );
+        patch->debye_length_itime = itime;
+    } else if( debye_length_tolerance_ <= 0. ) {
+        return;
+    }
 
 #ifdef  __DEBUG
     double mean_debye_length = 0.;
 #endif
 
     for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
+        
+        // In between, only the bins where the density changed too much
+        if( ! all_bins ) {
+            double total_weight = 0.;
+            for( unsigned int ispec=0 ; ispec<nspec ; ispec++ ) {
+                p = patch->vecSpecies[ispec]->particles;
+                for( int iPart=p->first_index[ibin]; iPart<p->last_index[ibin] ; iPart++ ) {
+                    total_weight += p->weight( iPart );
+                }
+            }
+            double previous_weight = patch->debye_length_density[ibin];
+            if( fabs( total_weight - previous_weight ) <= debye_length_tolerance_ * previous_weight ) {
+                continue;
+            }
+        }
+        
         double density_max = 0.;
         double inv_D2 = 0.;
         double inv_cell_volume = 0.;
+        double total_weight = 0.;
 
         for( unsigned int ispec=0 ; ispec<nspec ; ispec++ ) { // loop all species
             s  = patch->vecSpecies[ispec];
@@ -140,6 +210,7 @@ void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch )
                 charge      += p->weight( iPart ) * p->charge( iPart );
                 temperature += p->weight( iPart ) * p2/sqrt( 1.+p2 );
             }
+            total_weight += density;
             if( density > 0. ) {
                 charge /= density; // average charge
                 temperature *= s->mass_ / ( 3.*density ); // Te in units of me*c^2
@@ -169,6 +240,7 @@ void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch )
         } else {
             patch->debye_length_squared[ibin] = 0.;
         }
+        patch->debye_length_density[ibin] = total_weight;
 #ifdef  __DEBUG
         mean_debye_length += sqrt( patch->debye_length_squared[ibin] );
 #endif
@@ -183,6 +255,212 @@ void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch )
 }
 
 
+// Make the pairing and launch the processes in one bin
+void BinaryProcesses::applyToBin( Params &params, Patch *patch, unsigned int ibin, int itime, Random *random, vector<BinaryProcess*> &processes,
+                                  vector<Particles*> &pg1, vector<Particles*> &pg2, vector<double> &mass1, vector<double> &mass2 )
+{
+    BinaryProcessData D;
+    
+    // numbers of species in each group
+    size_t nspec1 = pg1.size();
+    size_t nspec2 = pg2.size();
+    // numbers of macro-particles in each species, in each group
+    vector<size_t> np1( nspec1 ), np2( nspec2 );
+    
+    // Info for ionization
+    D.electronFirst = patch->vecSpecies[species_group1_[0]]->atomic_number_==0 ? true : false;
+    
+    // In the adaptive mode, the collision parameter of each bin is measured by the collisions
+    Collisions *collisions = NULL;
+    if( adaptive_every_ > 0 ) {
+        for( unsigned int i=0; i<processes.size(); i++ ) {
+            if( Collisions *coll = dynamic_cast<Collisions*>( processes[i] ) ) {
+                collisions = coll;
+            }
+        }
+    }
+    
+    // In the adaptive mode, skip the bin if it was processed recently enough
+    int elapsed = every_;
+    if( collisions ) {
+        if( bin_last_[ibin] >= 0 ) {
+            elapsed = itime - bin_last_[ibin];
+            if( elapsed < ( int )( bin_every_[ibin] * every_ ) ) {
+                return;
+            }
+        }
+        bin_last_[ibin] = itime;
+    }
+    
+    // get number of particles for all necessary species
+    size_t npart1 = 0;
+    for( size_t ispec1=0 ; ispec1<nspec1 ; ispec1++ ) {
+        np1[ispec1] = pg1[ispec1]->last_index[ibin] - pg1[ispec1]->first_index[ibin];
+        npart1 += np1[ispec1];
+    }
+    size_t npart2 = 0;
+    for( size_t ispec2=0 ; ispec2<nspec2 ; ispec2++ ) {
+        np2[ispec2] = pg2[ispec2]->last_index[ibin] - pg2[ispec2]->first_index[ibin];
+        npart2 += np2[ispec2];
+    }
+    // We need to shuffle the group that has most particles
+    bool shuffle1 = npart1 > npart2;
+    size_t npartmin = npart1;
+    size_t npartmax = npart2;
+    if( shuffle1 ) {
+        swap( npartmin, npartmax );
+    }
+    
+    // skip the bin if not enough pairs
+    if( npartmin == 0 || ( intra_ && npartmin < 2 ) ) {
+        return;
+    }
+    
+    size_t npairs, npairs_not_repeated;
+    double weight_correction_1, weight_correction_2;
+    if( intra_ ) { // In the case of pairing within one species
+        npairs = ( npartmax + 1 ) / 2; // half as many pairs as macro-particles
+        npairs_not_repeated = npartmax - npairs;
+        weight_correction_1 = 1.;
+        weight_correction_2 = 0.5;
+    } else { // In the case of pairing between two species
+        npairs = npartmax; // as many pairs as macro-particles in group with more particles
+        npairs_not_repeated = npartmin;
+        weight_correction_1 = 1. / (double)( npairs / npairs_not_repeated );
+        weight_correction_2 = 1. / (double)( npairs / npairs_not_repeated + 1 );
+    }
+    
+    RandomShuffle shuffler( *random, npartmax );
+    
+    // Calculate the densities
+    double n1  = 0., n2 = 0.;
+    for( size_t ispec1=0 ; ispec1<nspec1 ; ispec1++ ) {
+        for( int i = pg1[ispec1]->first_index[ibin]; i < pg1[ispec1]->last_index[ibin]; i++ ) {
+            n1 += pg1[ispec1]->weight( i );
+        }
+    }
+    for( size_t ispec2=0 ; ispec2<nspec2 ; ispec2++ ) {
+        for( int i = pg2[ispec2]->first_index[ibin]; i < pg2[ispec2]->last_index[ibin]; i++ ) {
+            n2 += pg2[ispec2]->weight( i );
+        }
+    }
+    
+    // Get cell volume
+    double inv_cell_volume = 0.;
+    for( size_t ispec1 = 0; ispec1 < nspec1; ispec1++ ) {
+        if( pg1[ispec1]->first_index[ibin] < pg1[ispec1]->last_index[ibin] ) {
+            inv_cell_volume = 1./patch->getPrimalCellVolume( pg1[ispec1], pg1[ispec1]->first_index[ibin], params );
+            break;
+        }
+    }
+    
+    // Set the debye length
+    if( BinaryProcesses::debye_length_required_ ) {
+        D.debye2 = patch->debye_length_squared[ibin];
+    }
+    
+    // Pre-calculate some numbers before the big loop
+    unsigned int ncorr = intra_ ? 2*npairs-1 : npairs;
+    double dt_corr = elapsed * params.timestep * ((double)ncorr) * inv_cell_volume;
+    n1  *= inv_cell_volume;
+    n2  *= inv_cell_volume;
+    D.n123 = cbrt(n1*n1);
+    D.n223 = cbrt(n2*n2);
+    
+    // Pairs are buffered and the processes are applied to the whole buffer, which must not contain a particle twice.
+    // In the case of two species, the group with less particles repeats every npartmin pairs.
+    // The shuffler may repeat a particle at the end of its cycle: the last pair is processed alone.
+    unsigned int buffer_size = SMILEI_BINARYPROCESS_BUFFERSIZE;
+    if( ! intra_ && npartmin < buffer_size ) {
+        buffer_size = npartmin;
+    }
+    D.n = 0;
+    
+    unsigned int npairs_before = collisions ? collisions->npairs_tot_ : 0;
+    double smean_before = collisions ? collisions->smean_ : 0.;
+    
+    // Now start the real loop on pairs of particles
+    // See equations in http://dx.doi.org/10.1063/1.4742167
+    // ----------------------------------------------------
+    for( unsigned int i = 0; i<npairs; i++ ) {
+        
+        // Determine the shuffled indices in the whole groups of species
+        size_t i1, i2;
+        if( intra_ ) {
+            i1 = shuffler.next();
+            i2 = shuffler.next();
+        } else {
+            if( shuffle1 ) {
+                i1 = shuffler.next();
+                i2 = i % npart2;
+            } else {
+                i1 = i % npart1;
+                i2 = shuffler.next();
+            }
+        }
+        
+        // find species and indices of particles
+        size_t ispec1, ispec2;
+        for( ispec1=0 ; i1>=np1[ispec1]; ispec1++ ) {
+            i1 -= np1[ispec1];
+        }
+        for( ispec2=0 ; i2>=np2[ispec2]; ispec2++ ) {
+            i2 -= np2[ispec2];
+        }
+        // p1 and p2 are the pointers to Particles
+        Particles *p1 = pg1[ispec1];
+        Particles *p2 = pg2[ispec2];
+        // i1 and i2 are particle indices in this bin
+        i1 += p1->first_index[ibin];
+        i2 += p2->first_index[ibin];
+        
+        // Get Weights
+        double minW = p1->weight( i1 );
+        double maxW = p2->weight( i2 );
+        if( minW > maxW ) {
+            swap( minW, maxW );
+        }
+        // If one weight is zero, then skip. Can happen after nuclear reaction
+        if( minW > 0. ) {
+            
+            unsigned int k = D.n++;
+            D.p1[k] = p1;
+            D.p2[k] = p2;
+            D.i1[k] = i1;
+            D.i2[k] = i2;
+            D.minW[k] = minW;
+            D.maxW[k] = maxW;
+            
+            // Get masses
+            D.m1[k] = mass1[ispec1];
+            D.m2[k] = mass2[ispec2];
+            D.m12[k] = D.m1[k] / D.m2[k];
+            
+            // Calculate the timestep correction
+            D.dt_correction[k] = maxW * dt_corr;
+            if( i % npairs_not_repeated < npairs % npairs_not_repeated ) {
+                D.dt_correction[k] *= weight_correction_2 ;
+            } else {
+                D.dt_correction[k] *= weight_correction_1;
+            }
+        }
+        
+        // Apply the processes when the buffer is full, or before a particle may be picked again
+        if( ( i+1 ) % buffer_size == 0 || i+2 >= npairs ) {
+            applyToBuffer( random, processes, D );
+        }
+        
+    } // end loop on pairs of particles
+    
+    // In the adaptive mode, choose the next interval so that s stays close to the target
+    if( collisions && collisions->npairs_tot_ > npairs_before ) {
+        double s_per_every = ( collisions->smean_ - smean_before ) / ( collisions->npairs_tot_ - npairs_before ) * every_ / elapsed;
+        double n_every = s_per_every > 0. ? adaptive_s_ / s_per_every : adaptive_every_;
+        bin_every_[ibin] = ( unsigned int ) max( 1., min( ( double ) adaptive_every_, floor( n_every ) ) );
+    }
+}
+
+
 // Make the pairing and launch the processes
 void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
 {
@@ -190,7 +468,13 @@ void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Dia
         return;
     }
     
-    BinaryProcessData D;
+#if defined( SMILEI_ACCELERATOR_GPU )
+    if( params.gpu_computing ) {
+        applyOnDevice( params, patch );
+        processes_[0]->finish( params, patch, localDiags, intra_, species_group1_, species_group2_, itime );
+        return;
+    }
+#endif
     
     // numbers of species in each group
     size_t nspec1 = species_group1_.size();
@@ -206,47 +490,173 @@ void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Dia
         pg2[i] = patch->vecSpecies[species_group2_[i]]->particles;
         mass2[i] = patch->vecSpecies[species_group2_[i]]->mass_;
     }
-    // numbers of macro-particles in each species, in each group
-    vector<size_t> np1( nspec1 ), np2( nspec2 );
     
     for( unsigned int i=0; i<processes_.size(); i++ ) {
         processes_[i]->prepare();
     }
     
-    // Info for ionization
-    D.electronFirst = patch->vecSpecies[species_group1_[0]]->atomic_number_==0 ? true : false;
-    
     // Loop bins of particles
     unsigned int nbin = patch->vecSpecies[0]->particles->first_index.size();
-    for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
+    
+    if( adaptive_every_ > 0 && bin_every_.size() != nbin ) {
+        bin_every_.assign( nbin, 1 );
+        bin_last_.assign( nbin, -1 );
+    }
+    
+    if( bin_tasks_ > 0 && nbin > 1 ) {
         
-        // get number of particles for all necessary species
-        size_t npart1 = 0;
-        for( size_t ispec1=0 ; ispec1<nspec1 ; ispec1++ ) {
-            np1[ispec1] = pg1[ispec1]->last_index[ibin] - pg1[ispec1]->first_index[ibin];
-            npart1 += np1[ispec1];
+        // Each bin has its own random stream, seeded from the patch stream:
+        // the results do not depend on the number of threads
+        vector<uint32_t> seeds( nbin );
+        for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
+            seeds[ibin] = patch->rand_->integer();
         }
-        size_t npart2 = 0;
-        for( size_t ispec2=0 ; ispec2<nspec2 ; ispec2++ ) {
-            np2[ispec2] = pg2[ispec2]->last_index[ibin] - pg2[ispec2]->first_index[ibin];
-            npart2 += np2[ispec2];
+        
+        // Each task processes a contiguous group of bins, with its own copy of the processes
+        unsigned int ntasks = min( bin_tasks_, nbin );
+        vector<vector<BinaryProcess*> > task_processes( ntasks );
+        for( unsigned int itask = 0; itask < ntasks; itask++ ) {
+            for( unsigned int i=0; i<processes_.size(); i++ ) {
+                task_processes[itask].push_back( cloneProcess( processes_[i] ) );
+                task_processes[itask][i]->prepare();
+            }
         }
-        // We need to shuffle the group that has most particles
-        bool shuffle1 = npart1 > npart2;
-        size_t npartmin = npart1;
-        size_t npartmax = npart2;
-        if( shuffle1 ) {
-            swap( npartmin, npartmax );
+        
+        #pragma omp taskgroup
+        {
+            for( unsigned int itask = 0; itask < ntasks; itask++ ) {
+                #pragma omp task default(shared) firstprivate(itask)
+                {
+                    for( unsigned int ibin = itask*nbin/ntasks ; ibin < (itask+1)*nbin/ntasks ; ibin++ ) {
+                        Random random( seeds[ibin] );
+                        applyToBin( params, patch, ibin, itime, &random, task_processes[itask], pg1, pg2, mass1, mass2 );
+                    }
+                }
+            }
         }
         
-        // skip to next bin if not enough pairs
-        if( npartmin == 0 || ( intra_ && npartmin < 2 ) ) {
+        // Gather the results of the copies in the order of the bins
+        for( unsigned int itask = 0; itask < ntasks; itask++ ) {
+            for( unsigned int i=0; i<processes_.size(); i++ ) {
+                mergeProcess( processes_[i], task_processes[itask][i] );
+                delete task_processes[itask][i];
+            }
+        }
+        
+    } else {
+        
+        for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
+            applyToBin( params, patch, ibin, itime, patch->rand_, processes_, pg1, pg2, mass1, mass2 );
+        }
+        
+    }
+    
+    for( unsigned int i=0; i<processes_.size(); i++ ) {
+        processes_[i]->finish( params, patch, localDiags, intra_, species_group1_, species_group2_, itime );
+    }
+}
+
+
+#if defined( SMILEI_ACCELERATOR_GPU )
+// Collisions of particles on the device: each GPU bin (cluster of cells) is processed by one thread.
+// This is the pair-by-pair algorithm of the host, with one species in each group and only the collisions
+// (ionization and nuclear reactions are not available on the device).
+void BinaryProcesses::applyOnDevice( Params &params, Patch *patch )
+{
+    Collisions *coll = static_cast<Collisions*>( processes_[0] );
+    coll->prepare();
+    
+    Species *s1 = patch->vecSpecies[species_group1_[0]];
+    Species *s2 = patch->vecSpecies[species_group2_[0]];
+    Particles *p1 = s1->particles;
+    Particles *p2 = s2->particles;
+    
+    // On the device, last_index holds the end of each bin
+    const int nbin = p1->last_index.size();
+    const int *const bin_end1 = smilei::tools::gpu::HostDeviceMemoryManagement::GetDevicePointer( p1->last_index.data() );
+    const int *const bin_end2 = smilei::tools::gpu::HostDeviceMemoryManagement::GetDevicePointer( p2->last_index.data() );
+    
+    double *const px1 = p1->getPtrMomentum( 0 );
+    double *const py1 = p1->getPtrMomentum( 1 );
+    double *const pz1 = p1->getPtrMomentum( 2 );
+    const double *const w1 = p1->getPtrWeight();
+    const short *const q1 = p1->getPtrCharge();
+    double *const px2 = p2->getPtrMomentum( 0 );
+    double *const py2 = p2->getPtrMomentum( 1 );
+    double *const pz2 = p2->getPtrMomentum( 2 );
+    const double *const w2 = p2->getPtrWeight();
+    const short *const q2 = p2->getPtrCharge();
+    
+    // All species contribute to the Debye length
+    const int nspec = patch->vecSpecies.size();
+    std::vector<const int *> all_bin_end( nspec );
+    std::vector<const double *> all_px( nspec ), all_py( nspec ), all_pz( nspec ), all_w( nspec );
+    std::vector<const short *> all_q( nspec );
+    std::vector<double> all_mass( nspec );
+    for( int ispec = 0; ispec < nspec; ispec++ ) {
+        Particles *p = patch->vecSpecies[ispec]->particles;
+        all_bin_end[ispec] = smilei::tools::gpu::HostDeviceMemoryManagement::GetDevicePointer( p->last_index.data() );
+        all_px[ispec] = p->getPtrMomentum( 0 );
+        all_py[ispec] = p->getPtrMomentum( 1 );
+        all_pz[ispec] = p->getPtrMomentum( 2 );
+        all_w [ispec] = p->getPtrWeight();
+        all_q [ispec] = p->getPtrCharge();
+        all_mass[ispec] = patch->vecSpecies[ispec]->mass_;
+    }
+    const int *const *const bin_end = all_bin_end.data();
+    const double *const *const px = all_px.data();
+    const double *const *const py = all_py.data();
+    const double *const *const pz = all_pz.data();
+    const double *const *const w = all_w.data();
+    const short *const *const q = all_q.data();
+    const double *const mass = all_mass.data();
+    
+    const bool intra = intra_;
+    const double m1 = s1->mass_;
+    const double m2 = s2->mass_;
+    const double m12 = m1 / m2;
+    const double inv_cell_volume = 1. / params.cell_volume;
+    const double dt_every = every_ * params.timestep;
+    const double coulomb_log = coll->coulomb_log_;
+    const double coeff1 = coll->coeff1_, coeff3 = coll->coeff3_, coeff4 = coll->coeff4_;
+    const double debye_coeff = 299792458./( 3.*params.reference_angular_frequency_SI*2.8179403267e-15 ); // c / (3 omega re)
+    const double twoPi = coll->twoPi;
+    
+    // Each bin has its own random stream, seeded from the patch stream
+    const unsigned long long seed = patch->rand_->integer();
+    
+    double npairs_tot = 0., smean = 0., logLmean = 0.;
+    
+#if defined( SMILEI_ACCELERATOR_GPU_OMP )
+    #pragma omp target is_device_ptr( bin_end1, bin_end2, px1, py1, pz1, w1, q1, px2, py2, pz2, w2, q2 ) \
+        map( to: bin_end[0:nspec], px[0:nspec], py[0:nspec], pz[0:nspec], w[0:nspec], q[0:nspec], mass[0:nspec] ) \
+        map( tofrom: npairs_tot, smean, logLmean )
+    #pragma omp teams distribute parallel for reduction( +:npairs_tot, smean, logLmean )
+#elif defined( SMILEI_ACCELERATOR_GPU_OACC )
+    #pragma acc parallel loop gang vector deviceptr( bin_end1, bin_end2, px1, py1, pz1, w1, q1, px2, py2, pz2, w2, q2 ) \
+        copyin( bin_end[0:nspec], px[0:nspec], py[0:nspec], pz[0:nspec], w[0:nspec], q[0:nspec], mass[0:nspec] ) \
+        reduction( +:npairs_tot, smean, logLmean )
+#endif
+    for( int ibin = 0; ibin < nbin; ibin++ ) {
+        
+        const int first1 = ibin == 0 ? 0 : bin_end1[ibin-1];
+        const int first2 = ibin == 0 ? 0 : bin_end2[ibin-1];
+        const size_t npart1 = bin_end1[ibin] - first1;
+        const size_t npart2 = bin_end2[ibin] - first2;
+        
+        // We need to shuffle the group that has most particles
+        const bool shuffle1 = npart1 > npart2;
+        const size_t npartmin = shuffle1 ? npart2 : npart1;
+        const size_t npartmax = shuffle1 ? npart1 : npart2;
+        
+        // skip the bin if not enough pairs
+        if( npartmin == 0 || ( intra && npartmin < 2 ) ) {
             continue;
         }
         
         size_t npairs, npairs_not_repeated;
         double weight_correction_1, weight_correction_2;
-        if( intra_ ) { // In the case of pairing within one species
+        if( intra ) { // In the case of pairing within one species
             npairs = ( npartmax + 1 ) / 2; // half as many pairs as macro-particles
             npairs_not_repeated = npartmax - npairs;
             weight_correction_1 = 1.;
@@ -258,154 +668,248 @@ void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Dia
             weight_correction_2 = 1. / (double)( npairs / npairs_not_repeated + 1 );
         }
         
-        RandomShuffle shuffler( *patch->rand_, npartmax );
+        smilei::tools::gpu::Random random;
+        random.init( seed + ibin, ibin, 0 );
+        RandomShuffle shuffler( random, npartmax );
         
-        // Calculate the densities
-        double n1  = 0., n2 = 0.;
-        for( size_t ispec1=0 ; ispec1<nspec1 ; ispec1++ ) {
-            for( int i = pg1[ispec1]->first_index[ibin]; i < pg1[ispec1]->last_index[ibin]; i++ ) {
-                n1 += pg1[ispec1]->weight( i );
-            }
+        // Calculate the densities and, if needed, the Debye length
+        double n1 = 0., n2 = 0.;
+        for( int i = first1; i < bin_end1[ibin]; i++ ) {
+            n1 += w1[i];
         }
-        for( size_t ispec2=0 ; ispec2<nspec2 ; ispec2++ ) {
-            for( int i = pg2[ispec2]->first_index[ibin]; i < pg2[ispec2]->last_index[ibin]; i++ ) {
-                n2 += pg2[ispec2]->weight( i );
-            }
+        for( int i = first2; i < bin_end2[ibin]; i++ ) {
+            n2 += w2[i];
         }
-        
-        // Get cell volume
-        double inv_cell_volume = 0.;
-        for( size_t ispec1 = 0; ispec1 < nspec1; ispec1++ ) {
-            if( pg1[ispec1]->first_index[ibin] < pg1[ispec1]->last_index[ibin] ) {
-                inv_cell_volume = 1./patch->getPrimalCellVolume( pg1[ispec1], pg1[ispec1]->first_index[ibin], params );
-                break;
+        double debye2 = 0.;
+        if( coulomb_log <= 0. ) {
+            double density_max = 0., inv_D2 = 0.;
+            for( int ispec = 0; ispec < nspec; ispec++ ) {
+                double density = 0., charge = 0., temperature = 0.;
+                for( int i = ibin == 0 ? 0 : bin_end[ispec][ibin-1]; i < bin_end[ispec][ibin]; i++ ) {
+                    double p2 = px[ispec][i]*px[ispec][i] + py[ispec][i]*py[ispec][i] + pz[ispec][i]*pz[ispec][i];
+                    density     += w[ispec][i];
+                    charge      += w[ispec][i] * q[ispec][i];
+                    temperature += w[ispec][i] * p2/sqrt( 1.+p2 );
+                }
+                if( density > 0. ) {
+                    charge /= density;
+                    temperature *= mass[ispec] / ( 3.*density );
+                    density *= inv_cell_volume;
+                    inv_D2 += temperature == 0. ? 1e100 : density*charge*charge/temperature;
+                    density_max = density > density_max ? density : density_max;
+                }
+            }
+            if( inv_D2 > 0. ) {
+                double rmin2 = 1.0 / cbrt( debye_coeff*density_max * debye_coeff*density_max );
+                debye2 = 1./inv_D2 > rmin2 ? 1./inv_D2 : rmin2;
             }
-        }
-        
-        // Set the debye length
-        if( BinaryProcesses::debye_length_required_ ) {
-            D.debye2 = patch->debye_length_squared[ibin];
         }
         
         // Pre-calculate some numbers before the big loop
-        unsigned int ncorr = intra_ ? 2*npairs-1 : npairs;
-        double dt_corr = every_ * params.timestep * ((double)ncorr) * inv_cell_volume;
-        n1  *= inv_cell_volume;
-        n2  *= inv_cell_volume;
-        D.n123 = cbrt(n1*n1);
-        D.n223 = cbrt(n2*n2);
+        const size_t ncorr = intra ? 2*npairs-1 : npairs;
+        const double dt_corr = dt_every * ((double)ncorr) * inv_cell_volume;
+        n1 *= inv_cell_volume;
+        n2 *= inv_cell_volume;
+        const double n123 = cbrt( n1*n1 );
+        const double n223 = cbrt( n2*n2 );
         
-        // Now start the real loop on pairs of particles
-        // See equations in http://dx.doi.org/10.1063/1.4742167
-        // ----------------------------------------------------
-        for( unsigned int i = 0; i<npairs; i++ ) {
+        for( size_t ipair = 0; ipair < npairs; ipair++ ) {
             
-            // Determine the shuffled indices in the whole groups of species
-            if( intra_ ) {
-                D.i1 = shuffler.next();
-                D.i2 = shuffler.next();
+            // Determine the shuffled indices
+            int i1, i2;
+            if( intra ) {
+                i1 = first1 + shuffler.next();
+                i2 = first1 + shuffler.next();
+            } else if( shuffle1 ) {
+                i1 = first1 + shuffler.next();
+                i2 = first2 + ipair % npart2;
             } else {
-                if( shuffle1 ) {
-                    D.i1 = shuffler.next();
-                    D.i2 = i % npart2;
-                } else {
-                    D.i1 = i % npart1;
-                    D.i2 = shuffler.next();
-                }
+                i1 = first1 + ipair % npart1;
+                i2 = first2 + shuffler.next();
             }
             
-            // find species and indices of particles
-            size_t ispec1, ispec2;
-            for( ispec1=0 ; D.i1>=np1[ispec1]; ispec1++ ) {
-                D.i1 -= np1[ispec1];
-            }
-            for( ispec2=0 ; D.i2>=np2[ispec2]; ispec2++ ) {
-                D.i2 -= np2[ispec2];
+            // If one weight is zero, then skip
+            const double maxW = w1[i1] > w2[i2] ? w1[i1] : w2[i2];
+            if( w1[i1] <= 0. || w2[i2] <= 0. ) {
+                continue;
             }
-            // p1 and p2 are the pointers to Particles
-            D.p1 = pg1[ispec1];
-            D.p2 = pg2[ispec2];
-            // i1 and i2 are particle indices in this bin
-            D.i1 += D.p1->first_index[ibin];
-            D.i2 += D.p2->first_index[ibin];
             
-            // Get Weights
-            D.minW = D.p1->weight(D.i1);
-            D.maxW = D.p2->weight(D.i2);
-            if( D.minW > D.maxW ) {
-                swap( D.minW, D.maxW );
+            // Calculate the timestep correction
+            const double dt_correction = maxW * dt_corr
+                * ( ipair % npairs_not_repeated < npairs % npairs_not_repeated ? weight_correction_2 : weight_correction_1 );
+            
+            // Calculate the center-of-mass (COM) frame
+            const double gamma1 = sqrt( 1. + px1[i1]*px1[i1] + py1[i1]*py1[i1] + pz1[i1]*pz1[i1] );
+            const double gamma2 = sqrt( 1. + px2[i2]*px2[i2] + py2[i2]*py2[i2] + pz2[i2]*pz2[i2] );
+            const double gamma12_inv = 1./( m12 * gamma1 + gamma2 );
+            const double COM_vx = ( m12 * px1[i1] + px2[i2] ) * gamma12_inv;
+            const double COM_vy = ( m12 * py1[i1] + py2[i2] ) * gamma12_inv;
+            const double COM_vz = ( m12 * pz1[i1] + pz2[i2] ) * gamma12_inv;
+            const double COM_vsquare = COM_vx*COM_vx + COM_vy*COM_vy + COM_vz*COM_vz;
+            double COM_gamma, term1;
+            if( COM_vsquare < 1e-6 ) {
+                COM_gamma = 1. +0.5 * COM_vsquare;
+                term1 = 0.5;
+            } else {
+                COM_gamma = 1./sqrt( 1.-COM_vsquare );
+                term1 = ( COM_gamma - 1. ) / COM_vsquare;
             }
-            // If one weight is zero, then skip. Can happen after nuclear reaction
-            if( D.minW <= 0. ) continue;
+            const double vcv1g1 = COM_vx*px1[i1] + COM_vy*py1[i1] + COM_vz*pz1[i1];
+            const double vcv2g2 = COM_vx*px2[i2] + COM_vy*py2[i2] + COM_vz*pz2[i2];
+            const double gamma1_COM = ( gamma1-vcv1g1 )*COM_gamma;
+            const double gamma2_COM = ( gamma2-vcv2g2 )*COM_gamma;
+            const double term2 = term1*vcv1g1 - COM_gamma * gamma1;
+            const double px_COM = px1[i1] + term2*COM_vx;
+            const double py_COM = py1[i1] + term2*COM_vy;
+            const double pz_COM = pz1[i1] + term2*COM_vz;
+            const double p2_COM = px_COM*px_COM + py_COM*py_COM + pz_COM*pz_COM;
+            const double p_COM = sqrt( p2_COM );
+            const double term3 = COM_gamma * gamma12_inv;
+            const double term4 = gamma1_COM * gamma2_COM;
+            const double term5 = term4/p2_COM + m12;
+            const double vrel = p_COM / ( term3 * term4 );
             
-            // Get masses
-            D.m1 = mass1[ispec1];
-            D.m2 = mass2[ispec2];
-            D.m12 = D.m1 / D.m2;
+            // Calculate the collision parameter s12
+            const double qqm = q1[i1] * q2[i2] / m1;
+            double logL = coulomb_log;
+            if( logL <= 0. ) {
+                double bmin = coeff1 * fmax( 1./(m1*p_COM), fabs( 0.00232282*qqm*term3*term5 ) );
+                logL = fmax( 0.5*log( 1. + debye2/( bmin*bmin ) ), 2. );
+            }
+            double s = coeff3 * logL * qqm * qqm * term3 * p_COM * term5*term5 / ( gamma1*gamma2 );
+            const double smax = coeff4 * ( m12+1. ) * vrel / fmax( m12*n123, n223 );
+            s = fmin( s, smax ) * dt_correction;
             
-            // Calculate the timestep correction
-            D.dt_correction = D.maxW * dt_corr;
-            if( i % npairs_not_repeated < npairs % npairs_not_repeated ) {
-                D.dt_correction *= weight_correction_2 ;
+            // Pick the deflection angles in the center-of-mass frame
+            double cosX, sinX;
+            const double U1 = random.uniform();
+            if( s < 4. ) {
+                const double s2 = s*s;
+                const double alpha = 0.37*s - 0.005*s2 - 0.0064*s2*s;
+                const double sin2X2 = alpha * U1 / sqrt( (1.-U1) + alpha*alpha*U1 );
+                cosX = 1. - 2.*sin2X2;
+                sinX = 2.*sqrt( sin2X2 *(1.-sin2X2) );
             } else {
-                D.dt_correction *= weight_correction_1;
+                cosX = 2.*U1 - 1.;
+                sinX = sqrt( 1. - cosX*cosX );
             }
+            const double phi = twoPi * random.uniform();
+            const double sinXcosPhi = sinX*cos( phi );
+            const double sinXsinPhi = sinX*sin( phi );
             
-            // Calculate gammas
-            D.gamma1 = D.p1->LorentzFactor( D.i1 );
-            D.gamma2 = D.p2->LorentzFactor( D.i2 );
-            double gamma12 = D.m12 * D.gamma1 + D.gamma2;
-            double gamma12_inv = 1./gamma12;
-
-            // Calculate the center-of-mass (COM) frame
-            // Quantities starting with "COM" are those of the COM itself, expressed in the lab frame.
-            // They are NOT quantities relative to the COM.
-            D.COM_vx = ( D.m12 * ( D.p1->momentum( 0, D.i1 ) ) + D.p2->momentum( 0, D.i2 ) ) * gamma12_inv;
-            D.COM_vy = ( D.m12 * ( D.p1->momentum( 1, D.i1 ) ) + D.p2->momentum( 1, D.i2 ) ) * gamma12_inv;
-            D.COM_vz = ( D.m12 * ( D.p1->momentum( 2, D.i1 ) ) + D.p2->momentum( 2, D.i2 ) ) * gamma12_inv;
-            double COM_vsquare = D.COM_vx*D.COM_vx + D.COM_vy*D.COM_vy + D.COM_vz*D.COM_vz;
-
-            // Change the momentum to the COM frame (we work only on particle 1)
-            // Quantities ending with "COM" are quantities of the particle expressed in the COM frame.
-            if( COM_vsquare < 1e-6 ) {
-                D.COM_gamma = 1. +0.5 * COM_vsquare;
-                D.term1 = 0.5;
+            // Apply the deflection
+            const double p_perp = sqrt( px_COM*px_COM + py_COM*py_COM );
+            double newpx_COM, newpy_COM, newpz_COM;
+            if( p_perp > 1.e-10*p_COM ) {
+                const double inv_p_perp = 1./p_perp;
+                newpx_COM = ( px_COM * pz_COM * sinXcosPhi - py_COM * p_COM * sinXsinPhi ) * inv_p_perp + px_COM * cosX;
+                newpy_COM = ( py_COM * pz_COM * sinXcosPhi + px_COM * p_COM * sinXsinPhi ) * inv_p_perp + py_COM * cosX;
+                newpz_COM = -p_perp * sinXcosPhi + pz_COM * cosX;
             } else {
-                D.COM_gamma = 1./sqrt( 1.-COM_vsquare );
-                D.term1 = ( D.COM_gamma - 1. ) / COM_vsquare;
+                newpx_COM = p_COM * sinXcosPhi;
+                newpy_COM = p_COM * sinXsinPhi;
+                newpz_COM = p_COM * cosX;
             }
-
-            double vcv1g1  = D.COM_vx*( D.p1->momentum( 0, D.i1 ) ) + D.COM_vy*( D.p1->momentum( 1, D.i1 ) ) + D.COM_vz*( D.p1->momentum( 2, D.i1 ) );
-            double vcv2g2  = D.COM_vx*( D.p2->momentum( 0, D.i2 ) ) + D.COM_vy*( D.p2->momentum( 1, D.i2 ) ) + D.COM_vz*( D.p2->momentum( 2, D.i2 ) );
-            D.gamma1_COM = ( D.gamma1-vcv1g1 )*D.COM_gamma;
-            D.gamma2_COM = ( D.gamma2-vcv2g2 )*D.COM_gamma;
-            double term2 = D.term1*vcv1g1 - D.COM_gamma * D.gamma1;
-            D.px_COM = D.p1->momentum( 0, D.i1 ) + term2*D.COM_vx;
-            D.py_COM = D.p1->momentum( 1, D.i1 ) + term2*D.COM_vy;
-            D.pz_COM = D.p1->momentum( 2, D.i1 ) + term2*D.COM_vz;
-            double p2_COM = D.px_COM*D.px_COM + D.py_COM*D.py_COM + D.pz_COM*D.pz_COM;
-            D.p_COM  = sqrt( p2_COM );
-
-            // Calculate some intermediate quantities
-            D.term3 = D.COM_gamma * gamma12_inv;
-            double term4 = D.gamma1_COM * D.gamma2_COM;
-            D.term5 = term4/p2_COM + D.m12;
-            D.vrel = D.p_COM / ( D.term3 * term4 ); // | v2_COM - v1_COM |
-            D.vrel_corr = D.p_COM / ( D.term3 * D.gamma1 * D.gamma2 );
-
-            for( unsigned int i=0; i<processes_.size(); i++ ) {
-                processes_[i]->apply( patch->rand_, D );
+            
+            // Go back to the lab frame and store the results in the particle array
+            const double vcp = COM_vx * newpx_COM + COM_vy * newpy_COM + COM_vz * newpz_COM;
+            const double U2 = random.uniform();
+            if( U2 * w1[i1] < w2[i2] ) {
+                const double term6 = term1*vcp + gamma1_COM * COM_gamma;
+                px1[i1] = newpx_COM + COM_vx * term6;
+                py1[i1] = newpy_COM + COM_vy * term6;
+                pz1[i1] = newpz_COM + COM_vz * term6;
             }
-
-        } // end loop on pairs of particles
-
-    } // end loop on bins
-
-    for( unsigned int i=0; i<processes_.size(); i++ ) {
-        processes_[i]->finish( params, patch, localDiags, intra_, species_group1_, species_group2_, itime );
+            if( U2 * w2[i2] < w1[i1] ) {
+                const double term6 = -m12 * term1*vcp + gamma2_COM * COM_gamma;
+                px2[i2] = -m12 * newpx_COM + COM_vx * term6;
+                py2[i2] = -m12 * newpy_COM + COM_vy * term6;
+                pz2[i2] = -m12 * newpz_COM + COM_vz * term6;
+            }
+            
+            npairs_tot += 1.;
+            smean      += s;
+            logLmean   += logL;
+        }
     }
+    
+    coll->npairs_tot_ = npairs_tot;
+    coll->smean_      = smean;
+    coll->logLmean_   = logLmean;
 }
+#endif
 
+// Calculate the kinematics of the buffered pairs, then apply the processes
+void BinaryProcesses::applyToBuffer( Random *random, vector<BinaryProcess*> &processes, BinaryProcessData &D )
+{
+    const unsigned int n = D.n;
+    if( n == 0 ) {
+        return;
+    }
+    
+    // Gather the momenta of the pairs
+    double px1[SMILEI_BINARYPROCESS_BUFFERSIZE], py1[SMILEI_BINARYPROCESS_BUFFERSIZE], pz1[SMILEI_BINARYPROCESS_BUFFERSIZE];
+    double px2[SMILEI_BINARYPROCESS_BUFFERSIZE], py2[SMILEI_BINARYPROCESS_BUFFERSIZE], pz2[SMILEI_BINARYPROCESS_BUFFERSIZE];
+    for( unsigned int k = 0; k < n; k++ ) {
+        px1[k] = D.p1[k]->momentum( 0, D.i1[k] );
+        py1[k] = D.p1[k]->momentum( 1, D.i1[k] );
+        pz1[k] = D.p1[k]->momentum( 2, D.i1[k] );
+        px2[k] = D.p2[k]->momentum( 0, D.i2[k] );
+        py2[k] = D.p2[k]->momentum( 1, D.i2[k] );
+        pz2[k] = D.p2[k]->momentum( 2, D.i2[k] );
+    }
+    
+    #pragma omp simd
+    for( unsigned int k = 0; k < n; k++ ) {
+        
+        // Calculate gammas
+        D.gamma1[k] = sqrt( 1. + px1[k]*px1[k] + py1[k]*py1[k] + pz1[k]*pz1[k] );
+        D.gamma2[k] = sqrt( 1. + px2[k]*px2[k] + py2[k]*py2[k] + pz2[k]*pz2[k] );
+        double gamma12 = D.m12[k] * D.gamma1[k] + D.gamma2[k];
+        double gamma12_inv = 1./gamma12;
+        
+        // Calculate the center-of-mass (COM) frame
+        // Quantities starting with "COM" are those of the COM itself, expressed in the lab frame.
+        // They are NOT quantities relative to the COM.
+        D.COM_vx[k] = ( D.m12[k] * px1[k] + px2[k] ) * gamma12_inv;
+        D.COM_vy[k] = ( D.m12[k] * py1[k] + py2[k] ) * gamma12_inv;
+        D.COM_vz[k] = ( D.m12[k] * pz1[k] + pz2[k] ) * gamma12_inv;
+        double COM_vsquare = D.COM_vx[k]*D.COM_vx[k] + D.COM_vy[k]*D.COM_vy[k] + D.COM_vz[k]*D.COM_vz[k];
+        
+        // Change the momentum to the COM frame (we work only on particle 1)
+        // Quantities ending with "COM" are quantities of the particle expressed in the COM frame.
+        // (both branches are calculated, so that the loop can be vectorized)
+        bool small_v = COM_vsquare < 1e-6;
+        double COM_gamma = 1./sqrt( 1.-COM_vsquare );
+        double term1 = ( COM_gamma - 1. ) / COM_vsquare;
+        D.COM_gamma[k] = small_v ? 1. +0.5 * COM_vsquare : COM_gamma;
+        D.term1[k] = small_v ? 0.5 : term1;
+        
+        double vcv1g1  = D.COM_vx[k]*px1[k] + D.COM_vy[k]*py1[k] + D.COM_vz[k]*pz1[k];
+        double vcv2g2  = D.COM_vx[k]*px2[k] + D.COM_vy[k]*py2[k] + D.COM_vz[k]*pz2[k];
+        D.gamma1_COM[k] = ( D.gamma1[k]-vcv1g1 )*D.COM_gamma[k];
+        D.gamma2_COM[k] = ( D.gamma2[k]-vcv2g2 )*D.COM_gamma[k];
+        double term2 = D.term1[k]*vcv1g1 - D.COM_gamma[k] * D.gamma1[k];
+        D.px_COM[k] = px1[k] + term2*D.COM_vx[k];
+        D.py_COM[k] = py1[k] + term2*D.COM_vy[k];
+        D.pz_COM[k] = pz1[k] + term2*D.COM_vz[k];
+        double p2_COM = D.px_COM[k]*D.px_COM[k] + D.py_COM[k]*D.py_COM[k] + D.pz_COM[k]*D.pz_COM[k];
+        D.p_COM[k] = sqrt( p2_COM );
+        
+        // Calculate some intermediate quantities
+        D.term3[k] = D.COM_gamma[k] * gamma12_inv;
+        double term4 = D.gamma1_COM[k] * D.gamma2_COM[k];
+        D.term5[k] = term4/p2_COM + D.m12[k];
+        D.vrel[k] = D.p_COM[k] / ( D.term3[k] * term4 ); // | v2_COM - v1_COM |
+        D.vrel_corr[k] = D.p_COM[k] / ( D.term3[k] * D.gamma1[k] * D.gamma2[k] );
+    }
+    
+    for( unsigned int i=0; i<processes.size(); i++ ) {
+        processes[i]->apply( random, D );
+    }
+    
+    D.n = 0;
+}
 
 void BinaryProcesses::debug( Params &params, int itime, unsigned int icoll, VectorPatch &vecPatches )
 {
@@ -19,7 +19,10 @@ public:
         int every,
         int debug_every,
         double time_frozen,
-        std::string filename
+        std::string filename,
+        int adaptive_every = 0,
+        double adaptive_s = 0.1,
+        int bin_tasks = 0
     );
     
     BinaryProcesses( BinaryProcesses *BPs );
@@ -27,11 +30,17 @@ public:
     ~BinaryProcesses();
     
     //! Method to calculate the Debye length in each bin
-    static void calculate_debye_length( Params &, Patch * );
+    static void calculate_debye_length( Params &, Patch *, int itime );
     
     //! True if any of the BinaryProcesses objects need automatically-computed coulomb log
     static bool debye_length_required_;
     
+    //! Number of timesteps between two calculations of the Debye length in all bins
+    static int debye_length_every_;
+    
+    //! Relative change of the density of a bin above which its Debye length is calculated again (0 for never)
+    static double debye_length_tolerance_;
+    
     //! Apply processes at each timestep
     void apply( Params &, Patch *, int, std::vector<Diagnostic *> & );
     
@@ -66,6 +75,39 @@ private:
     //! Debugging file name
     std::string filename_;
     
+    //! Maximum number of `every` periods between two processings of a bin (0 if not adaptive)
+    unsigned int adaptive_every_;
+    
+    //! Collision parameter s targeted in each bin at each processing, in the adaptive mode
+    double adaptive_s_;
+    
+    //! Number of `every` periods between two processings of each bin, in the adaptive mode
+    std::vector<unsigned int> bin_every_;
+    
+    //! Last iteration when each bin was processed, in the adaptive mode (-1 if never)
+    std::vector<int> bin_last_;
+    
+    //! Number of tasks sharing the bins of a patch (0 for no tasks)
+    unsigned int bin_tasks_;
+    
+    //! Makes the pairs of one bin and applies the processes to them
+    void applyToBin( Params &, Patch *, unsigned int ibin, int itime, Random *random, std::vector<BinaryProcess*> &processes,
+                     std::vector<Particles*> &pg1, std::vector<Particles*> &pg2, std::vector<double> &mass1, std::vector<double> &mass2 );
+    
+    //! Calculates the kinematics of the buffered pairs and applies the processes to them
+    void applyToBuffer( Random *random, std::vector<BinaryProcess*> &processes, BinaryProcessData &D );
+    
+#if defined( SMILEI_ACCELERATOR_GPU )
+    //! Applies the collisions to the particles on the device, in each GPU bin
+    void applyOnDevice( Params &, Patch * );
+#endif
+    
+    //! Copy of a binary process
+    static BinaryProcess * cloneProcess( BinaryProcess * );
+    
+    //! Adds the statistics and the new particles of a copy to the original process
+    static void mergeProcess( BinaryProcess *, BinaryProcess *copy );
+    
 };
 
 #endif
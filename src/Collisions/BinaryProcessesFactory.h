@@ -63,6 +63,30 @@ public:
         double time_frozen = 0.; // default
         PyTools::extract( "time_frozen", time_frozen, "Collisions", n_binary_processes );
         
+        // Maximum number of `every` periods between two processings of a bin (if 0, not adaptive)
+        int adaptive_every = 0; // default
+        PyTools::extract( "adaptive_every", adaptive_every, "Collisions", n_binary_processes );
+        if( adaptive_every < 0 ) {
+            ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": adaptive_every must be positive or zero",
+                LINK_NAMELIST + std::string("#collisions-reactions") );
+        }
+        
+        // Collision parameter targeted in each bin in the adaptive mode
+        double adaptive_s = 0.1; // default
+        PyTools::extract( "adaptive_s", adaptive_s, "Collisions", n_binary_processes );
+        if( adaptive_every > 0 && adaptive_s <= 0. ) {
+            ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": adaptive_s must be strictly positive",
+                LINK_NAMELIST + std::string("#collisions-reactions") );
+        }
+        
+        // Number of tasks sharing the bins of each patch between threads
+        int bin_tasks = 0; // default
+        PyTools::extract( "bin_tasks", bin_tasks, "Collisions", n_binary_processes );
+        if( bin_tasks < 0 ) {
+            ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": bin_tasks must be positive or zero",
+                LINK_NAMELIST + std::string("#collisions-reactions") );
+        }
+        
         // Now make all the binary processes
         std::vector<BinaryProcess*> processes;
         
@@ -109,6 +133,14 @@ public:
             double rate_multiplier = 0.;
             PyTools::extract( "nuclear_reaction_multiplier", rate_multiplier, "Collisions", n_binary_processes );
             
+            // Minimum weight of the products
+            double min_weight = 0.;
+            PyTools::extract( "nuclear_reaction_min_weight", min_weight, "Collisions", n_binary_processes );
+            if( min_weight < 0. ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": nuclear_reaction_min_weight must be positive or zero",
+                    LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+            
             // Find products
             std::vector<unsigned int> products = params.FindSpecies( vecSpecies, nuclear_reaction );
             
@@ -124,7 +156,7 @@ public:
                 std::vector<std::string> name = {"helium3", "neutron"};
                 findProducts( vecSpecies, products, Z, A, name, product_species, n_binary_processes );
                 
-                processes.push_back( new CollisionalFusionDD( params, product_species, rate_multiplier ) );
+                processes.push_back( new CollisionalFusionDD( params, product_species, rate_multiplier, min_weight ) );
                 
                 nuclear_reaction_name = "D-D fusion";
                 
@@ -272,6 +304,45 @@ public:
             MESSAGE( 2, (iBP+1)<<". "<<processes[iBP]->name() );
         }
         
+        // On GPU, only collisions between two single species. Ionization and nuclear reactions
+        // create particles during the pairing, which requires buffers of products on the device
+        if( params.gpu_computing ) {
+            for( unsigned int iBP=0; iBP<processes.size(); iBP++ ) {
+                if( dynamic_cast<CollisionalIonization *>( processes[iBP] ) ) {
+                    ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": collisional ionization (`ionizing`) is not available on GPU",
+                        LINK_NAMELIST + std::string("#collisions-reactions") );
+                }
+                if( dynamic_cast<CollisionalNuclearReaction *>( processes[iBP] ) ) {
+                    ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": nuclear reactions (`nuclear_reaction`) are not available on GPU",
+                        LINK_NAMELIST + std::string("#collisions-reactions") );
+                }
+            }
+            if( clog < 0. ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": on GPU, `coulomb_log` must be set, only the collisions are available",
+                    LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+            if( sgroup[0].size() != 1 || sgroup[1].size() != 1 ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": on GPU, species1 and species2 must contain one species each",
+                    LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+            if( adaptive_every > 0 || bin_tasks > 0 || params.geometry == "AMcylindrical" ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": adaptive_every, bin_tasks and AMcylindrical geometry are not available on GPU",
+                    LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+        }
+        
+        if( adaptive_every > 0 ) {
+            if( clog < 0. ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": adaptive_every requires collisions (coulomb_log >= 0)",
+                    LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+            MESSAGE( 2, "Adaptive: each bin every " << every << " to " << adaptive_every*every << " timesteps (s ~ " << adaptive_s << ")" );
+        }
+        
+        if( bin_tasks>0 ) {
+            MESSAGE( 2, "Bins of each patch shared among " << bin_tasks << " tasks" );
+        }
+        
         if( debug_every>0 ) {
             MESSAGE( 2, "Debug every " << debug_every << " timesteps" );
         }
@@ -317,7 +388,10 @@ public:
             every,
             debug_every,
             time_frozen,
-            filename
+            filename,
+            adaptive_every,
+            adaptive_s,
+            bin_tasks
         );
     }
     
@@ -345,6 +419,39 @@ public:
         // pass the variable "debye_length_required" into the Collision class
         BinaryProcesses::debye_length_required_ = debye_length_required;
         
+        // The Debye length is shared by all collisions: it is recalculated as often as the most demanding block requires
+        BinaryProcesses::debye_length_every_ = 0;
+        BinaryProcesses::debye_length_tolerance_ = 0.;
+        for( unsigned int n_binary_processes = 0; n_binary_processes < numcollisions; n_binary_processes++ ) {
+            double clog = -1.;
+            PyTools::extract( "coulomb_log", clog, "Collisions", n_binary_processes );
+            if( clog != 0. ) {
+                continue;
+            }
+            int debye_length_every = 1;
+            PyTools::extract( "debye_length_every", debye_length_every, "Collisions", n_binary_processes );
+            if( debye_length_every < 1 ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": debye_length_every must be at least 1",
+                    LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+            double debye_length_tolerance = 0.;
+            PyTools::extract( "debye_length_tolerance", debye_length_tolerance, "Collisions", n_binary_processes );
+            if( debye_length_tolerance < 0. ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": debye_length_tolerance must be positive or zero",
+                    LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+            if( BinaryProcesses::debye_length_every_ == 0 || debye_length_every < BinaryProcesses::debye_length_every_ ) {
+                BinaryProcesses::debye_length_every_ = debye_length_every;
+            }
+            if( debye_length_tolerance > 0. && ( BinaryProcesses::debye_length_tolerance_ == 0. || debye_length_tolerance < BinaryProcesses::debye_length_tolerance_ ) ) {
+                BinaryProcesses::debye_length_tolerance_ = debye_length_tolerance;
+            }
+        }
+        if( BinaryProcesses::debye_length_every_ > 1 ) {
+            MESSAGE( 1, "Debye length calculated every " << BinaryProcesses::debye_length_every_ << " timesteps"
+                << ( BinaryProcesses::debye_length_tolerance_ > 0. ? " or when the density of a bin changes" : "" ) );
+        }
+        
         return vecBPs;
     }
     
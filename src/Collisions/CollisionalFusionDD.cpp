@@ -29,9 +29,10 @@ const double CollisionalFusionDD::DB_log_crossSection[50] = {
 CollisionalFusionDD::CollisionalFusionDD(
     Params &params,
     vector<Species *> &product_species,
-    double rate_multiplier
+    double rate_multiplier,
+    double min_weight
 )
-: CollisionalNuclearReaction(params, product_species, rate_multiplier)
+: CollisionalNuclearReaction(params, product_species, rate_multiplier, min_weight)
 {
     // Find which product is helium / neutron
     index_He_ = product_species.size();
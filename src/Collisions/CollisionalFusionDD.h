@@ -11,7 +11,7 @@ class CollisionalFusionDD : public CollisionalNuclearReaction
 
 public:
     //! Constructor
-    CollisionalFusionDD( Params&, std::vector<Species*>&, double );
+    CollisionalFusionDD( Params&, std::vector<Species*>&, double, double );
     //! Cloning Constructor
     CollisionalFusionDD( CollisionalNuclearReaction * );
     //! Destructor
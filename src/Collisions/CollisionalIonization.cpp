@@ -134,21 +134,23 @@ unsigned int CollisionalIonization::createDatabase( double reference_angular_fre
 // Method to apply the ionization
 void CollisionalIonization::apply( Random *random, BinaryProcessData &D )
 {
-    D.gamma1 = D.p1->LorentzFactor( D.i1 );
-    D.gamma2 = D.p2->LorentzFactor( D.i2 );
-    // Calculate lorentz factor in the frame of ion
-    double gamma_s = D.gamma1*D.gamma2
-        - D.p1->momentum( 0, D.i1 )*D.p2->momentum( 0, D.i2 )
-        - D.p1->momentum( 1, D.i1 )*D.p2->momentum( 1, D.i2 )
-        - D.p1->momentum( 2, D.i1 )*D.p2->momentum( 2, D.i2 );
-    // Random numbers
-    double U1 = random->uniform();
-    double U2 = random->uniform();
-    // Calculate the rest of the stuff
-    if( D.electronFirst ) {
-        calculate( gamma_s, D.gamma1, D.gamma2, D.p1, D.i1, D.p2, D.i2, U1, U2, D.dt_correction );
-    } else {
-        calculate( gamma_s, D.gamma2, D.gamma1, D.p2, D.i2, D.p1, D.i1, U1, U2, D.dt_correction );
+    for( unsigned int i = 0; i < D.n; i++ ) {
+        D.gamma1[i] = D.p1[i]->LorentzFactor( D.i1[i] );
+        D.gamma2[i] = D.p2[i]->LorentzFactor( D.i2[i] );
+        // Calculate lorentz factor in the frame of ion
+        double gamma_s = D.gamma1[i]*D.gamma2[i]
+            - D.p1[i]->momentum( 0, D.i1[i] )*D.p2[i]->momentum( 0, D.i2[i] )
+            - D.p1[i]->momentum( 1, D.i1[i] )*D.p2[i]->momentum( 1, D.i2[i] )
+            - D.p1[i]->momentum( 2, D.i1[i] )*D.p2[i]->momentum( 2, D.i2[i] );
+        // Random numbers
+        double U1 = random->uniform();
+        double U2 = random->uniform();
+        // Calculate the rest of the stuff
+        if( D.electronFirst ) {
+            calculate( gamma_s, D.gamma1[i], D.gamma2[i], D.p1[i], D.i1[i], D.p2[i], D.i2[i], U1, U2, D.dt_correction[i] );
+        } else {
+            calculate( gamma_s, D.gamma2[i], D.gamma1[i], D.p2[i], D.i2[i], D.p1[i], D.i1[i], U1, U2, D.dt_correction[i] );
+        }
     }
 }
 
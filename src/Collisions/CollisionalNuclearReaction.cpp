@@ -14,8 +14,10 @@ using namespace std;
 CollisionalNuclearReaction::CollisionalNuclearReaction(
     Params &params,
     vector<Species *> &product_species,
-    double rate_multiplier
-    )
+    double rate_multiplier,
+    double min_weight
+    ) :
+    min_weight_( min_weight )
 {
     if( rate_multiplier == 0. ) {
         auto_multiplier_ = true;
@@ -44,6 +46,7 @@ CollisionalNuclearReaction::CollisionalNuclearReaction( CollisionalNuclearReacti
     product_ispecies_ = CNR->product_ispecies_;
     rate_multiplier_ = CNR->rate_multiplier_;
     auto_multiplier_ = CNR->auto_multiplier_;
+    min_weight_ = CNR->min_weight_;
     product_particles_.resize( CNR->product_particles_.size(), NULL );
     for( unsigned int i=0; i<CNR->product_particles_.size(); i++ ) {
         product_particles_[i] = new Particles();
@@ -63,85 +66,95 @@ CollisionalNuclearReaction::~CollisionalNuclearReaction()
 
 void CollisionalNuclearReaction::apply( Random *random, BinaryProcessData &D )
 {
-    double ekin = D.m1 * (D.gamma1_COM-1.) + D.m2 * (D.gamma2_COM-1.);
-    double log_ekin = log( ekin );
-    
-    // Interpolate the total cross-section at some value of ekin = m1(g1-1) + m2(g2-1)
-    double cs = crossSection( log_ekin );
-    
-    // Calculate probability for reaction
-    double prob = coeff2_ * D.vrel_corr * D.dt_correction * cs * rate_multiplier_;
-    tot_probability_ += prob;
-    npairs_tot_ ++;
-    if( random->uniform() > exp( -prob ) ) {
+    for( unsigned int i = 0; i < D.n; i++ ) {
+        double ekin = D.m1[i] * (D.gamma1_COM[i]-1.) + D.m2[i] * (D.gamma2_COM[i]-1.);
+        double log_ekin = log( ekin );
         
-        // Reaction occurs
+        // Interpolate the total cross-section at some value of ekin = m1(g1-1) + m2(g2-1)
+        double cs = crossSection( log_ekin );
         
-        double W = D.minW / rate_multiplier_;
+        // Calculate probability for reaction
+        double prob = coeff2_ * D.vrel_corr[i] * D.dt_correction[i] * cs * rate_multiplier_;
+        tot_probability_ += prob;
+        npairs_tot_ ++;
+        if( random->uniform() > exp( -prob ) ) {
         
-        // Reduce the weight of both reactants
-        // If becomes zero, then the particle will be discarded later
-        D.p1->weight( D.i1 ) -= W;
-        D.p2->weight( D.i2 ) -= W;
-        D.minW -= 0.;
-        D.maxW -= 0.;
+            // Reaction occurs
         
-        // Get the magnitude and the angle of the outgoing products in the COM frame
-        NuclearReactionProducts products;
-        double tot_charge = D.p1->charge( D.i1 ) + D.p2->charge( D.i2 );
-        makeProducts( random, ekin, log_ekin, tot_charge, products );
+            double W = D.minW[i] / rate_multiplier_;
         
-        // Calculate new weights
-        double newW1, newW2;
-        if( tot_charge != 0. ) {
-            double weight_factor = W / tot_charge;
-            newW1 = D.p1->charge( D.i1 ) * weight_factor;
-            newW2 = D.p2->charge( D.i2 ) * weight_factor;
-        } else {
-            newW1 = W;
-            newW2 = 0.;
-        }
+            // Reduce the weight of both reactants
+            // If becomes zero, then the particle will be discarded later
+            D.p1[i]->weight( D.i1[i] ) -= W;
+            D.p2[i]->weight( D.i2[i] ) -= W;
+            D.minW[i] -= 0.;
+            D.maxW[i] -= 0.;
         
-        // For each product
-        double p_perp = sqrt( D.px_COM*D.px_COM + D.py_COM*D.py_COM );
-        double newpx_COM=0, newpy_COM=0, newpz_COM=0;
-        for( unsigned int iproduct=0; iproduct<products.particles.size(); iproduct++ ){
-            // Calculate the deflection in the COM frame
-            if( iproduct < products.cosPhi.size() ) { // do not recalculate if all products have same axis
-                if( p_perp > 1.e-10*D.p_COM ) { // make sure p_perp is not too small
-                    double inv_p_perp = 1./p_perp;
-                    newpx_COM = ( D.px_COM * D.pz_COM * products.cosPhi[iproduct] - D.py_COM * D.p_COM * products.sinPhi[iproduct] ) * inv_p_perp;
-                    newpy_COM = ( D.py_COM * D.pz_COM * products.cosPhi[iproduct] + D.px_COM * D.p_COM * products.sinPhi[iproduct] ) * inv_p_perp;
-                    newpz_COM = -p_perp * products.cosPhi[iproduct];
-                } else { // if p_perp is too small, we use the limit px->0, py=0
-                    newpx_COM = D.p_COM * products.cosPhi[iproduct];
-                    newpy_COM = D.p_COM * products.sinPhi[iproduct];
-                    newpz_COM = 0.;
-                }
-                // Calculate the deflection in the COM frame
-                newpx_COM = newpx_COM * products.sinX[iproduct] + D.px_COM *products.cosX[iproduct];
-                newpy_COM = newpy_COM * products.sinX[iproduct] + D.py_COM *products.cosX[iproduct];
-                newpz_COM = newpz_COM * products.sinX[iproduct] + D.pz_COM *products.cosX[iproduct];
+            // Get the magnitude and the angle of the outgoing products in the COM frame
+            NuclearReactionProducts products;
+            double tot_charge = D.p1[i]->charge( D.i1[i] ) + D.p2[i]->charge( D.i2[i] );
+            makeProducts( random, ekin, log_ekin, tot_charge, products );
+        
+            // Calculate new weights
+            double newW1, newW2;
+            if( tot_charge != 0. ) {
+                double weight_factor = W / tot_charge;
+                newW1 = D.p1[i]->charge( D.i1[i] ) * weight_factor;
+                newW2 = D.p2[i]->charge( D.i2[i] ) * weight_factor;
+            } else {
+                newW1 = W;
+                newW2 = 0.;
             }
-            // Go back to the lab frame and store the results in the particle array
-            double vcp = D.COM_vx * newpx_COM + D.COM_vy * newpy_COM + D.COM_vz * newpz_COM;
-            double momentum_ratio = products.new_p_COM[iproduct] / D.p_COM;
-            double term6 = momentum_ratio*D.term1*vcp + sqrt( products.new_p_COM[iproduct]*products.new_p_COM[iproduct] + 1. ) * D.COM_gamma;
-            double newpx = momentum_ratio * newpx_COM + D.COM_vx * term6;
-            double newpy = momentum_ratio * newpy_COM + D.COM_vy * term6;
-            double newpz = momentum_ratio * newpz_COM + D.COM_vz * term6;
-            // Make new particle at position of particle 1
-            if( newW1 > 0. ) {
-                products.particles[iproduct]->makeParticleAt( *D.p1, D.i1, newW1, products.q[iproduct], newpx, newpy, newpz );
+            
+            // Russian roulette of the light products: kept with the minimum weight and a probability
+            // newW / min_weight_, so that the mean weight is unchanged
+            if( newW1 > 0. && newW1 < min_weight_ ) {
+                newW1 = random->uniform() * min_weight_ < newW1 ? min_weight_ : 0.;
             }
-            // Make new particle at position of particle 2
-            if( newW2 > 0. ) {
-                products.particles[iproduct]->makeParticleAt( *D.p2, D.i2, newW2, products.q[iproduct], newpx, newpy, newpz );
+            if( newW2 > 0. && newW2 < min_weight_ ) {
+                newW2 = random->uniform() * min_weight_ < newW2 ? min_weight_ : 0.;
             }
-        }
         
-    } // end nuclear reaction
-
+            // For each product
+            double p_perp = sqrt( D.px_COM[i]*D.px_COM[i] + D.py_COM[i]*D.py_COM[i] );
+            double newpx_COM=0, newpy_COM=0, newpz_COM=0;
+            for( unsigned int iproduct=0; iproduct<products.particles.size(); iproduct++ ){
+                // Calculate the deflection in the COM frame
+                if( iproduct < products.cosPhi.size() ) { // do not recalculate if all products have same axis
+                    if( p_perp > 1.e-10*D.p_COM[i] ) { // make sure p_perp is not too small
+                        double inv_p_perp = 1./p_perp;
+                        newpx_COM = ( D.px_COM[i] * D.pz_COM[i] * products.cosPhi[iproduct] - D.py_COM[i] * D.p_COM[i] * products.sinPhi[iproduct] ) * inv_p_perp;
+                        newpy_COM = ( D.py_COM[i] * D.pz_COM[i] * products.cosPhi[iproduct] + D.px_COM[i] * D.p_COM[i] * products.sinPhi[iproduct] ) * inv_p_perp;
+                        newpz_COM = -p_perp * products.cosPhi[iproduct];
+                    } else { // if p_perp is too small, we use the limit px->0, py=0
+                        newpx_COM = D.p_COM[i] * products.cosPhi[iproduct];
+                        newpy_COM = D.p_COM[i] * products.sinPhi[iproduct];
+                        newpz_COM = 0.;
+                    }
+                    // Calculate the deflection in the COM frame
+                    newpx_COM = newpx_COM * products.sinX[iproduct] + D.px_COM[i] *products.cosX[iproduct];
+                    newpy_COM = newpy_COM * products.sinX[iproduct] + D.py_COM[i] *products.cosX[iproduct];
+                    newpz_COM = newpz_COM * products.sinX[iproduct] + D.pz_COM[i] *products.cosX[iproduct];
+                }
+                // Go back to the lab frame and store the results in the particle array
+                double vcp = D.COM_vx[i] * newpx_COM + D.COM_vy[i] * newpy_COM + D.COM_vz[i] * newpz_COM;
+                double momentum_ratio = products.new_p_COM[iproduct] / D.p_COM[i];
+                double term6 = momentum_ratio*D.term1[i]*vcp + sqrt( products.new_p_COM[iproduct]*products.new_p_COM[iproduct] + 1. ) * D.COM_gamma[i];
+                double newpx = momentum_ratio * newpx_COM + D.COM_vx[i] * term6;
+                double newpy = momentum_ratio * newpy_COM + D.COM_vy[i] * term6;
+                double newpz = momentum_ratio * newpz_COM + D.COM_vz[i] * term6;
+                // Make new particle at position of particle 1
+                if( newW1 > 0. ) {
+                    products.particles[iproduct]->makeParticleAt( *D.p1[i], D.i1[i], newW1, products.q[iproduct], newpx, newpy, newpz );
+                }
+                // Make new particle at position of particle 2
+                if( newW2 > 0. ) {
+                    products.particles[iproduct]->makeParticleAt( *D.p2[i], D.i2[i], newW2, products.q[iproduct], newpx, newpy, newpz );
+                }
+            }
+        
+        } // end nuclear reaction
+    }
 }
 
 
@@ -150,8 +163,12 @@ void CollisionalNuclearReaction::finish(
     Params &params, Patch *patch, std::vector<Diagnostic *> &localDiags,
     bool intra_collisions, vector<unsigned int> sg1, vector<unsigned int> sg2, int itime
 ) {
-    // Move new particles in place
+    // Move new particles in place, all at once in each product species
+    // (the species are left untouched without products, e.g. their cached frozen charge)
     for( unsigned int i=0; i<product_particles_.size(); i++ ) {
+        if( product_particles_[i]->size() == 0 ) {
+            continue;
+        }
         patch->vecSpecies[product_ispecies_[i]]->importParticles( params, patch, *product_particles_[i], localDiags, ( itime + 0.5 ) * params.timestep );
     }
     
@@ -17,7 +17,7 @@ class CollisionalNuclearReaction : public BinaryProcess
 
 public:
     //! Constructor
-    CollisionalNuclearReaction( Params &, std::vector<Species *>&, double );
+    CollisionalNuclearReaction( Params &, std::vector<Species *>&, double, double );
     //! Cloning Constructor
     CollisionalNuclearReaction( CollisionalNuclearReaction * );
     //! Destructor
@@ -46,6 +46,9 @@ public:
     //! True if rate multiplier isn't automatically adjusted
     double auto_multiplier_;
     
+    //! Minimum weight of the products: lighter products are kept with a probability proportional to their weight
+    double min_weight_;
+    
     //! sum of probabilities in this patch
     double tot_probability_;
     
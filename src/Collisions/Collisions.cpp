@@ -51,86 +51,111 @@ void Collisions::prepare()
 
 void Collisions::apply( Random *random, BinaryProcessData &D )
 {
-    double qqm  = D.p1->charge( D.i1 ) * D.p2->charge( D.i2 ) / D.m1;
-    double qqm2 = qqm * qqm;
+    const unsigned int n = D.n;
+    double qqm[SMILEI_BINARYPROCESS_BUFFERSIZE], U1[SMILEI_BINARYPROCESS_BUFFERSIZE], phi[SMILEI_BINARYPROCESS_BUFFERSIZE], U2[SMILEI_BINARYPROCESS_BUFFERSIZE];
+    double newpx1[SMILEI_BINARYPROCESS_BUFFERSIZE], newpy1[SMILEI_BINARYPROCESS_BUFFERSIZE], newpz1[SMILEI_BINARYPROCESS_BUFFERSIZE];
+    double newpx2[SMILEI_BINARYPROCESS_BUFFERSIZE], newpy2[SMILEI_BINARYPROCESS_BUFFERSIZE], newpz2[SMILEI_BINARYPROCESS_BUFFERSIZE];
     
-    // Calculate coulomb log if necessary
-    double logL = coulomb_log_;
-    if( logL <= 0. ) { // if auto-calculation requested
-        // Note : 0.00232282 is coeff2 / coeff1
-        double bmin = coeff1_ * std::max( 1./(D.m1*D.p_COM), std::abs( 0.00232282*qqm*D.term3*D.term5 ) ); // min impact parameter
-        logL = 0.5*log( 1. + D.debye2/( bmin*bmin ) );
-        if( logL < 2. ) {
-            logL = 2.;
-        }
-    }
-    
-    // Calculate the collision parameter s12 (similar to number of real collisions)
-    double s = coeff3_ * logL * qqm2 * D.term3 * D.p_COM * D.term5*D.term5 / ( D.gamma1*D.gamma2 );
-    
-    // Low-temperature correction
-    double smax = coeff4_ * ( D.m12+1. ) * D.vrel / std::max( D.m12*D.n123, D.n223 );
-    if( s>smax ) {
-        s = smax;
+    // Gather the charges and draw the random numbers, in the same order as pair by pair
+    for( unsigned int k = 0; k < n; k++ ) {
+        qqm[k] = D.p1[k]->charge( D.i1[k] ) * D.p2[k]->charge( D.i2[k] ) / D.m1[k];
+        U1 [k] = random->uniform();
+        phi[k] = random->uniform_2pi();
+        U2 [k] = random->uniform();
     }
     
-    s *= D.dt_correction;
-    
-    // Pick the deflection angles in the center-of-mass frame.
-    // Instead of Nanbu http://dx.doi.org/10.1103/PhysRevE.55.4642
-    // and Perez http://dx.doi.org/10.1063/1.4742167
-    // we made a new fit (faster and more accurate)
-    double cosX, sinX;
-    double U1 = random->uniform();
-    if( s < 4. ) {
+    // Calculate the deflections of all pairs (both branches of each condition are evaluated, for vectorization)
+    double smean = 0., logLmean = 0.;
+    const bool auto_logL = coulomb_log_ <= 0.;
+    #pragma omp simd reduction(+:smean,logLmean)
+    for( unsigned int k = 0; k < n; k++ ) {
+        double qqm2 = qqm[k] * qqm[k];
+        
+        // Calculate coulomb log if necessary
+        double logL = coulomb_log_;
+        if( auto_logL ) { // if auto-calculation requested
+            // Note : 0.00232282 is coeff2 / coeff1
+            double bmin = coeff1_ * std::max( 1./(D.m1[k]*D.p_COM[k]), std::abs( 0.00232282*qqm[k]*D.term3[k]*D.term5[k] ) ); // min impact parameter
+            logL = std::max( 0.5*log( 1. + D.debye2/( bmin*bmin ) ), 2. );
+        }
+        
+        // Calculate the collision parameter s12 (similar to number of real collisions)
+        double s = coeff3_ * logL * qqm2 * D.term3[k] * D.p_COM[k] * D.term5[k]*D.term5[k] / ( D.gamma1[k]*D.gamma2[k] );
+        
+        // Low-temperature correction
+        double smax = coeff4_ * ( D.m12[k]+1. ) * D.vrel[k] / std::max( D.m12[k]*D.n123, D.n223 );
+        s = std::min( s, smax );
+        
+        s *= D.dt_correction[k];
+        
+        // Pick the deflection angles in the center-of-mass frame.
+        // Instead of Nanbu http://dx.doi.org/10.1103/PhysRevE.55.4642
+        // and Perez http://dx.doi.org/10.1063/1.4742167
+        // we made a new fit (faster and more accurate)
         double s2 = s*s;
         double alpha = 0.37*s - 0.005*s2 - 0.0064*s2*s;
-        double sin2X2 = alpha * U1 / sqrt( (1.-U1) + alpha*alpha*U1 );
-        cosX = 1. - 2.*sin2X2;
-        sinX = 2.*sqrt( sin2X2 *(1.-sin2X2) );
-    } else {
-        cosX = 2.*U1 - 1.;
-        sinX = sqrt( 1. - cosX*cosX );
+        double sin2X2 = alpha * U1[k] / sqrt( (1.-U1[k]) + alpha*alpha*U1[k] );
+        double sinX_fit = 2.*sqrt( std::abs( sin2X2 *(1.-sin2X2) ) );
+        double cosX_iso = 2.*U1[k] - 1.;
+        double sinX_iso = sqrt( 1. - cosX_iso*cosX_iso );
+        bool small_s = s < 4.;
+        double cosX = small_s ? 1. - 2.*sin2X2 : cosX_iso;
+        double sinX = small_s ? sinX_fit : sinX_iso;
+        
+        // Calculate combination of angles
+        double sinXcosPhi = sinX*cos( phi[k] );
+        double sinXsinPhi = sinX*sin( phi[k] );
+        
+        // Apply the deflection
+        double p_perp = sqrt( D.px_COM[k]*D.px_COM[k] + D.py_COM[k]*D.py_COM[k] );
+        bool large_p_perp = p_perp > 1.e-10*D.p_COM[k]; // make sure p_perp is not too small
+        double inv_p_perp = 1./( large_p_perp ? p_perp : 1. );
+        // if p_perp is too small, we use the limit px->0, py=0
+        double newpx_COM = large_p_perp ?
+            ( D.px_COM[k] * D.pz_COM[k] * sinXcosPhi - D.py_COM[k] * D.p_COM[k] * sinXsinPhi ) * inv_p_perp + D.px_COM[k] * cosX
+            : D.p_COM[k] * sinXcosPhi;
+        double newpy_COM = large_p_perp ?
+            ( D.py_COM[k] * D.pz_COM[k] * sinXcosPhi + D.px_COM[k] * D.p_COM[k] * sinXsinPhi ) * inv_p_perp + D.py_COM[k] * cosX
+            : D.p_COM[k] * sinXsinPhi;
+        double newpz_COM = large_p_perp ?
+            -p_perp * sinXcosPhi + D.pz_COM[k] * cosX
+            : D.p_COM[k] * cosX;
+        
+        // Go back to the lab frame
+        double vcp = D.COM_vx[k] * newpx_COM + D.COM_vy[k] * newpy_COM + D.COM_vz[k] * newpz_COM;
+        double term6 = D.term1[k]*vcp + D.gamma1_COM[k] * D.COM_gamma[k];
+        newpx1[k] = newpx_COM + D.COM_vx[k] * term6;
+        newpy1[k] = newpy_COM + D.COM_vy[k] * term6;
+        newpz1[k] = newpz_COM + D.COM_vz[k] * term6;
+        term6 = -D.m12[k] * D.term1[k]*vcp + D.gamma2_COM[k] * D.COM_gamma[k];
+        newpx2[k] = -D.m12[k] * newpx_COM + D.COM_vx[k] * term6;
+        newpy2[k] = -D.m12[k] * newpy_COM + D.COM_vy[k] * term6;
+        newpz2[k] = -D.m12[k] * newpz_COM + D.COM_vz[k] * term6;
+        
+        smean    += s;
+        logLmean += logL;
     }
     
-    // Calculate combination of angles
-    double phi = random->uniform_2pi();
-    double sinXcosPhi = sinX*cos( phi );
-    double sinXsinPhi = sinX*sin( phi );
-    
-    // Apply the deflection
-    double p_perp = sqrt( D.px_COM*D.px_COM + D.py_COM*D.py_COM );
-    double newpx_COM, newpy_COM, newpz_COM;
-    if( p_perp > 1.e-10*D.p_COM ) { // make sure p_perp is not too small
-        double inv_p_perp = 1./p_perp;
-        newpx_COM = ( D.px_COM * D.pz_COM * sinXcosPhi - D.py_COM * D.p_COM * sinXsinPhi ) * inv_p_perp + D.px_COM * cosX;
-        newpy_COM = ( D.py_COM * D.pz_COM * sinXcosPhi + D.px_COM * D.p_COM * sinXsinPhi ) * inv_p_perp + D.py_COM * cosX;
-        newpz_COM = -p_perp * sinXcosPhi + D.pz_COM * cosX;
-    } else { // if p_perp is too small, we use the limit px->0, py=0
-        newpx_COM = D.p_COM * sinXcosPhi;
-        newpy_COM = D.p_COM * sinXsinPhi;
-        newpz_COM = D.p_COM * cosX;
-    }
-    
-    // Go back to the lab frame and store the results in the particle array
-    double vcp = D.COM_vx * newpx_COM + D.COM_vy * newpy_COM + D.COM_vz * newpz_COM;
-    double U2 = random->uniform();
-    if( U2 * D.p1->weight( D.i1 ) < D.p2->weight( D.i2 ) ) { // deflect particle 1 only with some probability
-        double term6 = D.term1*vcp + D.gamma1_COM * D.COM_gamma;
-        D.p1->momentum( 0, D.i1 ) = newpx_COM + D.COM_vx * term6;
-        D.p1->momentum( 1, D.i1 ) = newpy_COM + D.COM_vy * term6;
-        D.p1->momentum( 2, D.i1 ) = newpz_COM + D.COM_vz * term6;
-    }
-    if( U2 * D.p2->weight( D.i2 ) < D.p1->weight( D.i1 ) ) { // deflect particle 2 only with some probability
-        double term6 = -D.m12 * D.term1*vcp + D.gamma2_COM * D.COM_gamma;
-        D.p2->momentum( 0, D.i2 ) = -D.m12 * newpx_COM + D.COM_vx * term6;
-        D.p2->momentum( 1, D.i2 ) = -D.m12 * newpy_COM + D.COM_vy * term6;
-        D.p2->momentum( 2, D.i2 ) = -D.m12 * newpz_COM + D.COM_vz * term6;
+    // Store the results in the particle arrays
+    for( unsigned int k = 0; k < n; k++ ) {
+        Particles *p1 = D.p1[k], *p2 = D.p2[k];
+        unsigned int i1 = D.i1[k], i2 = D.i2[k];
+        double w1 = p1->weight( i1 ), w2 = p2->weight( i2 );
+        if( U2[k] * w1 < w2 ) { // deflect particle 1 only with some probability
+            p1->momentum( 0, i1 ) = newpx1[k];
+            p1->momentum( 1, i1 ) = newpy1[k];
+            p1->momentum( 2, i1 ) = newpz1[k];
+        }
+        if( U2[k] * w2 < w1 ) { // deflect particle 2 only with some probability
+            p2->momentum( 0, i2 ) = newpx2[k];
+            p2->momentum( 1, i2 ) = newpy2[k];
+            p2->momentum( 2, i2 ) = newpz2[k];
+        }
     }
     
-    npairs_tot_ ++;
-    smean_    += s;
-    logLmean_ += logL;
+    npairs_tot_ += n;
+    smean_    += smean;
+    logLmean_ += logLmean;
 }
 
 void Collisions::finish( Params &, Patch *, std::vector<Diagnostic *> &, bool, std::vector<unsigned int>, std::vector<unsigned int>, int )
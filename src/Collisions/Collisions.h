@@ -50,6 +50,9 @@ public:
     
 protected:
     
+    //! The device kernel of the collisions is in BinaryProcesses
+    friend class BinaryProcesses;
+    
     //! Coulomb logarithm (zero or negative means automatic)
     double coulomb_log_;
     
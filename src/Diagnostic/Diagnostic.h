@@ -52,6 +52,12 @@ public :
         return false;
     };
     
+    //! Tells whether the outputs may be delayed to the common I/O phases (see DiagnosticFactory::setWindow)
+    virtual bool delayable()
+    {
+        return true;
+    };
+    
     //! Time selection for writing the diagnostic
     TimeSelection *timeSelection;
     
@@ -86,6 +92,30 @@ protected :
     
     //! Label of the diagnostic (for post-processing)
     std::string diag_name_;
+    
+    //! HDF5 filter compressing the datasets (H5Z_FILTER_NONE if no compression), and its parameters
+    H5Z_filter_t compression_filter_ = H5Z_FILTER_NONE;
+    std::vector<unsigned int> compression_parameters_;
+    
+    //! Extracts the arguments `compression`, `compression_parameters` and `compression_accuracy`
+    void extractCompression( std::string diag_type, int idiag )
+    {
+        std::string compression = "";
+        PyTools::extract( "compression", compression, diag_type, idiag );
+        if( compression.empty() ) {
+            return;
+        }
+        compression_filter_ = H5::compressionFilter( compression );
+        PyTools::extractV( "compression_parameters", compression_parameters_, diag_type, idiag );
+        double accuracy = 0.;
+        PyTools::extract( "compression_accuracy", accuracy, diag_type, idiag );
+        if( accuracy > 0. ) {
+            if( compression != "zfp" ) {
+                ERROR( diag_type << " #" << idiag << ": `compression_accuracy` requires the `zfp` compression" );
+            }
+            compression_parameters_ = H5::zfpAccuracyParameters( accuracy );
+        }
+    };
 };
 
 #endif
@@ -11,6 +11,7 @@
 #include "DiagnosticTrack.h"
 #include "DiagnosticNewParticles.h"
 #include "DiagnosticPerformances.h"
+#include "DiagnosticInSitu.h"
 
 #include "DiagnosticFields1D.h"
 #include "DiagnosticFields2D.h"
@@ -48,6 +49,27 @@ class DiagnosticFactory
 {
 public:
 
+    //! Delays the outputs of the diagnostics to common I/O phases, every `diagnostics_window` iterations.
+    //! Only for the diagnostics without time average, and with at most one output per phase.
+    static void setWindow( std::vector<Diagnostic *> &vecDiagnostics, Params &params )
+    {
+        if( params.diagnostics_window <= 1 ) {
+            return;
+        }
+        for( unsigned int idiag = 0; idiag < vecDiagnostics.size(); idiag++ ) {
+            Diagnostic *diag = vecDiagnostics[idiag];
+            if( ! diag->delayable() ) {
+                continue;
+            }
+            if( ! diag->timeSelection->isEmpty() && diag->timeSelection->smallestInterval() >= params.diagnostics_window ) {
+                diag->timeSelection->setWindow( params.diagnostics_window, params.n_time );
+            }
+            if( ! diag->flush_timeSelection->isEmpty() && diag->flush_timeSelection->smallestInterval() >= params.diagnostics_window ) {
+                diag->flush_timeSelection->setWindow( params.diagnostics_window, params.n_time );
+            }
+        }
+    }
+
     static std::vector<Diagnostic *> createGlobalDiagnostics( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches, RadiationTables * radiation_tables_ )
     {
         std::vector<Diagnostic *> vecDiagnostics;
@@ -65,6 +87,8 @@ public:
             vecDiagnostics.push_back( new DiagnosticRadiationSpectrum(params, smpi, vecPatches(0), radiation_tables_ , i) );
         }
         
+        setWindow( vecDiagnostics, params );
+        
         return vecDiagnostics;
         
     } // END createGlobalDiagnostics
@@ -92,9 +116,15 @@ public:
         }
         
         if( PyTools::nComponents( "DiagPerformances" ) > 0 ) {
-            vecDiagnostics.push_back( new DiagnosticPerformances( params, smpi ) );
+            vecDiagnostics.push_back( new DiagnosticPerformances( params, smpi, vecPatches ) );
+        }
+        
+        for( unsigned int i = 0, n = PyTools::nComponents( "DiagInSitu" ); i < n; i++ ) {
+            vecDiagnostics.push_back( new DiagnosticInSitu( params, smpi, vecPatches, i ) );
         }
         
+        setWindow( vecDiagnostics, params );
+        
         return vecDiagnostics;
         
     } // END createLocalDiagnostics
@@ -3,9 +3,15 @@
 
 #include "DiagnosticFields.h"
 #include "VectorPatch.h"
+#include "Field1D.h"
+#include "Field2D.h"
+#include "Field3D.h"
 
 using namespace std;
 
+vector<DiagnosticFields *> DiagnosticFields::asynchronous_diags_;
+bool DiagnosticFields::hdf5_threadsafe_ = false;
+
 DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches, int ndiag, OpenPMDparams &oPMD ):
     Diagnostic( &oPMD, "DiagFields", ndiag )
 {
@@ -143,6 +149,75 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
         }
     }
     
+    // Extract the subgrid reduction (subgrid_average is the same as subgrid_reduction = "mean")
+    bool subgrid_average = false;
+    PyTools::extract( "subgrid_average", subgrid_average, "DiagFields", ndiag );
+    string subgrid_reduction = "";
+    PyTools::extract( "subgrid_reduction", subgrid_reduction, "DiagFields", ndiag );
+    if( subgrid_reduction == "" ) {
+        subgrid_reduction = subgrid_average ? "mean" : "sample";
+    } else if( subgrid_average && subgrid_reduction != "mean" ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `subgrid_average` is incompatible with `subgrid_reduction` = `"<<subgrid_reduction<<"`" );
+    }
+    if( subgrid_reduction == "sample" ) {
+        subgrid_reduction_ = subgrid_sample;
+    } else if( subgrid_reduction == "mean" ) {
+        subgrid_reduction_ = subgrid_mean;
+    } else if( subgrid_reduction == "max_abs" ) {
+        subgrid_reduction_ = subgrid_max_abs;
+    } else if( subgrid_reduction == "rms" ) {
+        subgrid_reduction_ = subgrid_rms;
+    } else {
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `subgrid_reduction` must be `sample`, `mean`, `max_abs` or `rms`" );
+    }
+    if( subgrid_reduction_ != subgrid_sample && params.geometry == "AMcylindrical" ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `subgrid_reduction` and `subgrid_average` are not available in AMcylindrical geometry" );
+    }
+    
+    // Extract the accumulation of the time average on the subgrid points only
+    subgrid_accumulation_ = false;
+    PyTools::extract( "subgrid_accumulation", subgrid_accumulation_, "DiagFields", ndiag );
+    if( subgrid_accumulation_ && params.geometry == "AMcylindrical" ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `subgrid_accumulation` is not available in AMcylindrical geometry" );
+    }
+    // With a moving window, the subgrid points must stay at the same place in the patches
+    if( subgrid_accumulation_ && params.hasWindow && params.patch_size_[0] % subgrid_step_[0] != 0 ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `subgrid_accumulation` with a moving window requires a patch size along x multiple of the subgrid step" );
+    }
+    subgrid_accumulation_ = subgrid_accumulation_ && time_average > 1;
+    
+    // Extract the frequencies of the running Fourier transforms
+    // Each field is replaced by the real and imaginary parts of its transform at each frequency
+    vector<double> frequencies( 0 );
+    PyTools::extractV( "frequencies", frequencies, "DiagFields", ndiag );
+    timestep_ = params.timestep;
+    if( frequencies.size() > 0 ) {
+        if( time_average < 2 ) {
+            ERROR( "Diagnostic Fields #"<<ndiag<<": `frequencies` requires a `time_average` larger than 1" );
+        }
+        if( params.geometry == "AMcylindrical" ) {
+            ERROR( "Diagnostic Fields #"<<ndiag<<": `frequencies` is not available in AMcylindrical geometry" );
+        }
+        vector<unsigned int> dft_indexes( 0 );
+        vector<string> dft_names( 0 );
+        ss.str( "" );
+        for( unsigned int ifield=0; ifield<fields_names.size(); ifield++ ) {
+            for( unsigned int ifreq=0; ifreq<frequencies.size(); ifreq++ ) {
+                for( unsigned int imag=0; imag<2; imag++ ) {
+                    ostringstream name( "" );
+                    name << fields_names[ifield] << "_dft" << ifreq << ( imag ? "_im" : "_re" );
+                    ss << name.str() << " ";
+                    dft_indexes.push_back( fields_indexes[ifield] );
+                    dft_names.push_back( name.str() );
+                    dft_frequency_.push_back( frequencies[ifreq] );
+                    dft_imaginary_.push_back( imag==1 );
+                }
+            }
+        }
+        fields_indexes = dft_indexes;
+        fields_names = dft_names;
+    }
+    
     // Some output
     ostringstream p( "" );
     p << "(time average = " << time_average << ")";
@@ -155,9 +230,11 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
             vecPatches( ipatch )->EMfields->allFields_avg.resize( diag_n+1 );
             if( time_average > 1 ) {
                 for( unsigned int ifield=0; ifield<fields_names.size(); ifield++ ) {
-                    vecPatches( ipatch )->EMfields->allFields_avg[diag_n].push_back(
-                        vecPatches( ipatch )->EMfields->createField( fields_names[ifield], params )
-                    );
+                    Field *field = vecPatches( ipatch )->EMfields->createField( fields_names[ifield], params );
+                    if( subgrid_accumulation_ ) {
+                        field = subgridField( field );
+                    }
+                    vecPatches( ipatch )->EMfields->allFields_avg[diag_n].push_back( field );
                 }
             }
         }
@@ -185,6 +262,76 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
         ERROR( "Diagnostic Fields #"<<ndiag<<" has an unknown datatype `"<<datatype<<"`" );
     }
     
+    // Extract the compression
+    extractCompression( "DiagFields", ndiag );
+    
+    // Extract the MPI-IO aggregation and striping
+    aggregators_per_node_ = 0;
+    striping_factor_ = 0;
+    striping_unit_ = 0;
+    PyTools::extract( "aggregators_per_node", aggregators_per_node_, "DiagFields", ndiag );
+    PyTools::extract( "striping_factor", striping_factor_, "DiagFields", ndiag );
+    PyTools::extract( "striping_unit", striping_unit_, "DiagFields", ndiag );
+    if( aggregators_per_node_ < 0 || striping_factor_ < 0 || striping_unit_ < 0 ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `aggregators_per_node`, `striping_factor` and `striping_unit` must be positive" );
+    }
+    
+    // Extract the asynchronous flag
+    asynchronous_ = false;
+    PyTools::extract( "asynchronous", asynchronous_, "DiagFields", ndiag );
+    if( asynchronous_ ) {
+#ifdef _NO_MPI_TM
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `asynchronous` requires MPI_THREAD_MULTIPLE (Smilei compiled with -D_NO_MPI_TM)" );
+#endif
+        hbool_t threadsafe = 0;
+        H5is_library_threadsafe( &threadsafe );
+        hdf5_threadsafe_ = threadsafe;
+        staged_data_.resize( fields_names.size() );
+        asynchronous_diags_.push_back( this );
+        MESSAGE( 2, "written asynchronously" );
+    }
+    
+    // Extract the output backend
+    string backend = "hdf5";
+    PyTools::extract( "backend", backend, "DiagFields", ndiag );
+    if( backend != "hdf5" && backend != "adios2" ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<" has an unknown backend `"<<backend<<"`" );
+    }
+    adios2_ = ( backend == "adios2" );
+#ifdef SMILEI_ADIOS2
+    adios_ = NULL;
+#endif
+    if( adios2_ ) {
+#ifndef SMILEI_ADIOS2
+        ERROR( "Diagnostic Fields #"<<ndiag<<": `backend = \"adios2\"` requires Smilei compiled with `make config=adios2`" );
+#endif
+        if( params.geometry == "AMcylindrical" ) {
+            ERROR( "Diagnostic Fields #"<<ndiag<<": `backend = \"adios2\"` is not available in AMcylindrical geometry" );
+        }
+        if( asynchronous_ || compression_filter_ != H5Z_FILTER_NONE || datatype != "double" ) {
+            ERROR( "Diagnostic Fields #"<<ndiag<<": with `backend = \"adios2\"`, `asynchronous`, `compression` and `datatype` are set by `adios2_parameters`" );
+        }
+        PyTools::extract( "adios2_engine", adios2_engine_name_, "DiagFields", ndiag );
+        PyObject *py_parameters = PyTools::extract_py( "adios2_parameters", "DiagFields", ndiag );
+        if( ! PyDict_Check( py_parameters ) ) {
+            ERROR( "Diagnostic Fields #"<<ndiag<<": `adios2_parameters` must be a dict" );
+        }
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while( PyDict_Next( py_parameters, &pos, &key, &value ) ) {
+            string key_string, value_string;
+            PyObject *value_str = PyObject_Str( value );
+            if( ! PyTools::py2scalar( key, key_string ) || ! PyTools::py2scalar( value_str, value_string ) ) {
+                ERROR( "Diagnostic Fields #"<<ndiag<<": `adios2_parameters` must contain strings" );
+            }
+            Py_DECREF( value_str );
+            adios2_parameters_[key_string] = value_string;
+        }
+        Py_DECREF( py_parameters );
+        filename = filename.substr( 0, filename.size()-3 ) + ".bp";
+        MESSAGE( 2, "written by the ADIOS2 engine " << adios2_engine_name_ );
+    }
+    
     // Copy the total number of patches
     tot_number_of_patches = params.tot_number_of_patches;
     
@@ -204,12 +351,26 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
             ERROR( " impossible field name " );
         }
     }
+    
+    // Staggering of each field
+    stagger_.resize( fields_names.size() );
+    stagger_t_.resize( fields_names.size() );
+    for( unsigned int ifield=0; ifield<fields_names.size(); ifield++ ) {
+        Field *f = vecPatches( 0 )->EMfields->allFields[fields_indexes[ifield]];
+        stagger_[ifield].resize( f->dims().size() );
+        for( unsigned int i = 0; i < stagger_[ifield].size(); i++ ) {
+            stagger_[ifield][i] = 0.5 * (double) f->isDual(i);
+        }
+        bool ends_with_m = 0 == f->name.compare( f->name.length()-2, 2, "_m" );
+        stagger_t_[ifield] = ends_with_m ? vecPatches( 0 )->EMfields->timestep*0.5 : 0.;
+    }
 }
 
 
 DiagnosticFields::~DiagnosticFields()
 {
     closeFile();
+    asynchronous_diags_.erase( remove( asynchronous_diags_.begin(), asynchronous_diags_.end(), this ), asynchronous_diags_.end() );
     if( filespace ) {
         delete filespace;
     }
@@ -222,12 +383,37 @@ DiagnosticFields::~DiagnosticFields()
 
 void DiagnosticFields::openFile( Params &, SmileiMPI *smpi )
 {
+#ifdef SMILEI_ADIOS2
+    if( adios2_ ) {
+        if( adios_ ) {
+            return;
+        }
+        adios_ = new adios2::ADIOS( smpi->world() );
+        adios_io_ = adios_->DeclareIO( filename );
+        adios_io_.SetEngine( adios2_engine_name_ );
+        adios_io_.SetParameters( adios2_parameters_ );
+        adios_engine_ = adios_io_.Open( filename, adios2::Mode::Write );
+        
+        ADIOS2Write root( &adios_io_, &adios_engine_ );
+        root.attr( "name", diag_name_ );
+        openPMD_->writeRootAttributes( root, "", "no_particles" );
+        return;
+    }
+#endif
+    
     if( file_ ) {
         return;
     }
     
-    // Create file
-    file_ = new H5Write( filename, &smpi->world() );
+    // Create file, with the requested MPI-IO hints
+    MPI_Info info = H5::mpiioHints( aggregators_per_node_, striping_factor_, striping_unit_ );
+    file_ = new H5Write( filename, &smpi->world(), true, info, striping_unit_ );
+    if( info != MPI_INFO_NULL ) {
+        MPI_Info_free( &info );
+    }
+    if( compression_filter_ != H5Z_FILTER_NONE ) {
+        file_->setCompression( compression_filter_, compression_parameters_ );
+    }
     
     file_->attr( "name", diag_name_ );
     
@@ -242,6 +428,14 @@ void DiagnosticFields::openFile( Params &, SmileiMPI *smpi )
 
 void DiagnosticFields::closeFile()
 {
+    waitWrite();
+#ifdef SMILEI_ADIOS2
+    if( adios_ ) {
+        adios_engine_.Close();
+        delete adios_;
+        adios_ = NULL;
+    }
+#endif
     if( data_group_ ) {
         delete data_group_;
         data_group_ = NULL;
@@ -274,15 +468,32 @@ bool DiagnosticFields::prepare( int itime )
 
 void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime, SimWindow *simWindow, Timers & )
 {
+    // Patches which do not intersect the subgrid are skipped, unless a moving window
+    // may bring them (with their time average) into the subgrid
+    bool skip_outside = ! ( simWindow && simWindow->isActive() );
+    
     // If time-averaging, increment the average
     if( time_average>1 ) {
         #pragma omp for schedule(static)
         for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+            if( skip_outside && ! intersectsSubgrid( vecPatches( ipatch ) ) ) {
+                continue;
+            }
             for( unsigned int ifield=0; ifield<fields_names.size(); ifield++ ) {
-                vecPatches( ipatch )->EMfields->incrementAvgField(
-                    vecPatches( ipatch )->EMfields->allFields[fields_indexes[ifield]], // instantaneous field
-                    vecPatches( ipatch )->EMfields->allFields_avg[diag_n][ifield]    // averaged field
-                );
+                if( subgrid_accumulation_ ) {
+                    incrementSubgridAvgField(
+                        vecPatches( ipatch ),
+                        vecPatches( ipatch )->EMfields->allFields[fields_indexes[ifield]], // instantaneous field
+                        vecPatches( ipatch )->EMfields->allFields_avg[diag_n][ifield],   // averaged field
+                        dftWeight( ifield, itime )
+                    );
+                } else {
+                    vecPatches( ipatch )->EMfields->incrementAvgField(
+                        vecPatches( ipatch )->EMfields->allFields[fields_indexes[ifield]], // instantaneous field
+                        vecPatches( ipatch )->EMfields->allFields_avg[diag_n][ifield],   // averaged field
+                        dftWeight( ifield, itime )
+                    );
+                }
             }
         }
     }
@@ -292,8 +503,18 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         return;
     }
     
+#ifdef SMILEI_ADIOS2
+    if( adios2_ ) {
+        runADIOS2( vecPatches, itime, simWindow );
+        return;
+    }
+#endif
+    
     #pragma omp master
     {
+        // The previous asynchronous output must be written before the buffers and the file are used again
+        waitWrite();
+        
         // Calculate the structure of the file depending on 1D, 2D, ...
         refHindex = ( unsigned int )( vecPatches.refHindex_ );
         setFileSplitting( smpi, vecPatches );
@@ -326,43 +547,291 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         #pragma omp barrier
         #pragma omp for schedule(static)
         for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
+            // Nothing to copy outside of the subgrid (but the time average is reset with a moving window)
+            if( ( skip_outside || time_average<=1 ) && ! intersectsSubgrid( vecPatches( ipatch ) ) ) {
+                continue;
+            }
             getField( vecPatches( ipatch ), ifield );
         }
         
         #pragma omp master
         {
-            // Write
-            H5Write dset = writeField( iteration_group_, fields_names[ifield] );
-            // Attributes for openPMD
-            Field *f = vecPatches( 0 )->EMfields->allFields[fields_indexes[ifield]];
-            vector<double> stagger( f->dims().size() );
-            for( unsigned int i = 0; i < stagger.size(); i++ ) {
-                stagger[i] = 0.5 * (double) f->isDual(i);
+            if( asynchronous_ ) {
+                staged_data_[ifield] = data;
+            } else {
+                writeFieldAndAttributes( ifield );
             }
-            bool ends_with_m = 0 == fields_names[ifield].compare( fields_names[ifield].length()-2, 2, "_m" );
-            double stagger_t = ends_with_m ? vecPatches( 0 )->EMfields->timestep*0.5 : 0.;
-            openPMD_->writeFieldAttributes( dset, subgrid_start_, subgrid_step_ );
-            openPMD_->writeRecordAttributes( dset, field_type[ifield], stagger_t );
-            openPMD_->writeFieldRecordAttributes( dset, stagger );
-            openPMD_->writeComponentAttributes( dset, field_type[ifield] );
         }
         #pragma omp barrier 
     }
     
     #pragma omp master
     {
-        
-        // write x_moved
         double x_moved = simWindow ? simWindow->getXmoved() : 0.;
-        iteration_group_->attr( "x_moved", x_moved );
-        delete iteration_group_;
-        if( flush_timeSelection->theTimeIsNow( itime ) ) {
-            file_->flush();
+        bool flush = flush_timeSelection->theTimeIsNow( itime );
+        if( asynchronous_ ) {
+            // The simulation continues while the staged buffers are written
+            writer_ = thread( &DiagnosticFields::writeStaged, this, x_moved, flush );
+        } else {
+            closeIterationGroup( x_moved, flush );
         }
     }
     #pragma omp barrier
 }
 
+double DiagnosticFields::dftWeight( unsigned int ifield, int itime )
+{
+    if( dft_frequency_.empty() ) {
+        return 1.;
+    }
+    // Real and imaginary parts of exp( -i omega t )
+    double phase = dft_frequency_[ifield] * itime * timestep_;
+    return dft_imaginary_[ifield] ? -sin( phase ) : cos( phase );
+}
+
+double DiagnosticFields::subgridReduce( Field *field, unsigned int ix, unsigned int iy, unsigned int iz )
+{
+    // Box of one subgrid step centered on the point, within the patch and its ghost cells
+    unsigned int point[3] = { ix, iy, iz }, begin[3], end[3], dims[3] = { 1, 1, 1 };
+    for( unsigned int i=0; i<3; i++ ) {
+        if( i < field->dims_.size() ) {
+            dims[i] = field->dims_[i];
+            unsigned int half = ( subgrid_step_[i]-1 ) / 2;
+            begin[i] = point[i] > half ? point[i] - half : 0;
+            end[i] = min( begin[i] + subgrid_step_[i], dims[i] );
+        } else {
+            begin[i] = 0;
+            end[i] = 1;
+        }
+    }
+    double sum = 0.;
+    for( unsigned int jx = begin[0]; jx < end[0]; jx++ ) {
+        for( unsigned int jy = begin[1]; jy < end[1]; jy++ ) {
+            const double *const __restrict__ row = &field->data_[( jx*dims[1] + jy )*dims[2]];
+            if( subgrid_reduction_ == subgrid_mean ) {
+                for( unsigned int jz = begin[2]; jz < end[2]; jz++ ) {
+                    sum += row[jz];
+                }
+            } else if( subgrid_reduction_ == subgrid_rms ) {
+                for( unsigned int jz = begin[2]; jz < end[2]; jz++ ) {
+                    sum += row[jz] * row[jz];
+                }
+            } else {
+                for( unsigned int jz = begin[2]; jz < end[2]; jz++ ) {
+                    sum = max( sum, fabs( row[jz] ) );
+                }
+            }
+        }
+    }
+    if( subgrid_reduction_ == subgrid_max_abs ) {
+        return sum;
+    }
+    sum /= ( end[0]-begin[0] ) * ( end[1]-begin[1] ) * ( end[2]-begin[2] );
+    return subgrid_reduction_ == subgrid_rms ? sqrt( sum ) : sum;
+}
+
+Field * DiagnosticFields::subgridField( Field *field )
+{
+    // One point per subgrid step: point ix of the patch is at ix / step
+    vector<unsigned int> dims = field->dims_;
+    for( unsigned int i=0; i<dims.size(); i++ ) {
+        dims[i] = ( dims[i] - 1 ) / subgrid_step_[i] + 1;
+    }
+    Field *subgrid_field;
+    if( dims.size() == 1 ) {
+        subgrid_field = new Field1D( dims, field->name );
+    } else if( dims.size() == 2 ) {
+        subgrid_field = new Field2D( dims, field->name );
+    } else {
+        subgrid_field = new Field3D( dims, field->name );
+    }
+    delete field;
+    return subgrid_field;
+}
+
+void DiagnosticFields::incrementSubgridAvgField( Patch *patch, Field *field, Field *field_avg, double weight )
+{
+    // Indices of the subgrid points in the patch are ix = first + k * step (see getField)
+    unsigned int first[3] = { 0, 0, 0 }, step[3] = { 1, 1, 1 }, dims[3] = { 1, 1, 1 }, dims_avg[3] = { 1, 1, 1 };
+    for( unsigned int i=0; i<field->dims_.size(); i++ ) {
+        int s = subgrid_step_[i];
+        int f = ( int )subgrid_start_[i] - ( int )( patch->Pcoordinates[i] * patch_size_[i] ) + ( int )patch_offset_in_grid[i] - 1;
+        first[i] = ( ( f % s ) + s ) % s;
+        step[i] = s;
+        dims[i] = field->dims_[i];
+        dims_avg[i] = field_avg->dims_[i];
+    }
+    for( unsigned int ix = first[0]; ix < dims[0]; ix += step[0] ) {
+        for( unsigned int iy = first[1]; iy < dims[1]; iy += step[1] ) {
+            for( unsigned int iz = first[2]; iz < dims[2]; iz += step[2] ) {
+                double value = subgrid_reduction_ != subgrid_sample ? subgridReduce( field, ix, iy, iz ) : field->data_[( ix*dims[1] + iy )*dims[2] + iz];
+                field_avg->data_[( ( ix/step[0] )*dims_avg[1] + iy/step[1] )*dims_avg[2] + iz/step[2]] += weight * value;
+            }
+        }
+    }
+}
+
+void DiagnosticFields::writeFieldAndAttributes( unsigned int ifield )
+{
+    // Write
+    H5Write dset = writeField( iteration_group_, fields_names[ifield] );
+    // Attributes for openPMD
+    openPMD_->writeFieldAttributes( dset, subgrid_start_, subgrid_step_ );
+    openPMD_->writeRecordAttributes( dset, field_type[ifield], stagger_t_[ifield] );
+    openPMD_->writeFieldRecordAttributes( dset, stagger_[ifield] );
+    openPMD_->writeComponentAttributes( dset, field_type[ifield] );
+}
+
+void DiagnosticFields::closeIterationGroup( double x_moved, bool flush )
+{
+    // write x_moved
+    iteration_group_->attr( "x_moved", x_moved );
+    delete iteration_group_;
+    if( flush ) {
+        file_->flush();
+    }
+}
+
+void DiagnosticFields::writeStaged( double x_moved, bool flush )
+{
+    for( unsigned int ifield=0; ifield < fields_indexes.size(); ifield++ ) {
+        data.swap( staged_data_[ifield] );
+        writeFieldAndAttributes( ifield );
+        data.swap( staged_data_[ifield] );
+    }
+    closeIterationGroup( x_moved, flush );
+}
+
+void DiagnosticFields::waitWrite()
+{
+    if( writer_.joinable() ) {
+        writer_.join();
+    }
+}
+
+void DiagnosticFields::waitAsynchronousWrites()
+{
+    for( unsigned int idiag=0; idiag<asynchronous_diags_.size(); idiag++ ) {
+        asynchronous_diags_[idiag]->waitWrite();
+    }
+}
+
+#ifdef SMILEI_ADIOS2
+void DiagnosticFields::runADIOS2( VectorPatch &vecPatches, int itime, SimWindow *simWindow )
+{
+    unsigned int nPatches( vecPatches.size() );
+    
+    ostringstream name_t;
+    name_t << setfill( '0' ) << setw( 10 ) << itime;
+    ADIOS2Write iteration_group = ADIOS2Write( &adios_io_, &adios_engine_ ).group( "data" ).group( name_t.str() );
+    vector<size_t> shape( filespace->dims_.begin(), filespace->dims_.end() );
+    
+    #pragma omp master
+    {
+        patch_blocks_.resize( nPatches );
+        patch_starts_.resize( nPatches );
+        patch_counts_.resize( nPatches );
+        adios_engine_.BeginStep();
+        // Add openPMD attributes ( "basePath" and "meshesPath" )
+        openPMD_->writeBasePathAttributes( iteration_group, itime );
+        openPMD_->writeMeshesAttributes( iteration_group );
+    }
+    #pragma omp barrier
+    
+    // For each field, each patch puts its block
+    for( unsigned int ifield=0; ifield < fields_indexes.size(); ifield++ ) {
+        #pragma omp for schedule(static)
+        for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
+            getPatchBlock( vecPatches( ipatch ), ifield, ipatch );
+        }
+        
+        #pragma omp master
+        {
+            ADIOS2Write dset = iteration_group.array( fields_names[ifield], shape, patch_blocks_, patch_starts_, patch_counts_ );
+            openPMD_->writeFieldAttributes( dset, subgrid_start_, subgrid_step_ );
+            openPMD_->writeRecordAttributes( dset, field_type[ifield], stagger_t_[ifield] );
+            openPMD_->writeFieldRecordAttributes( dset, stagger_[ifield] );
+            openPMD_->writeComponentAttributes( dset, field_type[ifield] );
+        }
+        #pragma omp barrier
+    }
+    
+    #pragma omp master
+    {
+        iteration_group.attr( "x_moved", simWindow ? simWindow->getXmoved() : 0. );
+        adios_engine_.EndStep();
+    }
+    #pragma omp barrier
+}
+
+void DiagnosticFields::getPatchBlock( Patch *patch, unsigned int ifield, unsigned int ipatch )
+{
+    Field *field;
+    if( time_average>1 ) {
+        field = patch->EMfields->allFields_avg[diag_n][ifield];
+    } else {
+        field = patch->EMfields->allFields[fields_indexes[ifield]];
+    }
+    
+    // Find the intersection between this patch and the subgrid (missing dimensions have 1 point)
+    unsigned int ndim = patch_offset_in_grid.size();
+    hsize_t patch_begin[3] = { 0, 0, 0 }, patch_npoints[3] = { 1, 1, 1 }, start_in_patch[3] = { 0, 0, 0 };
+    unsigned int step[3] = { 1, 1, 1 };
+    patch_starts_[ipatch].resize( ndim );
+    patch_counts_[ipatch].resize( ndim );
+    size_t block_size = 1;
+    for( unsigned int i=0; i<ndim; i++ ) {
+        patch_begin  [i] = patch->Pcoordinates[i] * patch_size_[i] + ( ( patch->Pcoordinates[i]==0 )?0:1 );
+        patch_npoints[i] = patch_size_[i] + ( ( patch->Pcoordinates[i]==0 )?1:0 );
+        findSubgridIntersection1( i, patch_begin[i], patch_npoints[i], start_in_patch[i] );
+        start_in_patch[i] += patch_offset_in_grid[i] - ( ( patch->Pcoordinates[i]==0 )?1:0 );
+        step[i] = subgrid_step_[i];
+        patch_starts_[ipatch][i] = patch_begin[i];
+        patch_counts_[ipatch][i] = patch_npoints[i];
+        block_size *= patch_npoints[i];
+    }
+    
+    // Copy field to the block
+    vector<double> &block = patch_blocks_[ipatch];
+    block.resize( block_size );
+    unsigned int ix_max = start_in_patch[0] + step[0]*patch_npoints[0];
+    unsigned int iy_max = start_in_patch[1] + step[1]*patch_npoints[1];
+    unsigned int iz_max = start_in_patch[2] + step[2]*patch_npoints[2];
+    size_t iout = 0;
+    for( unsigned int ix = start_in_patch[0]; ix < ix_max; ix += step[0] ) {
+        for( unsigned int iy = start_in_patch[1]; iy < iy_max; iy += step[1] ) {
+            for( unsigned int iz = start_in_patch[2]; iz < iz_max; iz += step[2] ) {
+                block[iout++] = subgridValue( field, ix, iy, iz ) * time_average_inv;
+            }
+        }
+    }
+    
+    if( time_average>1 ) {
+        field->put_to( 0.0 );
+    }
+}
+#endif
+
+vector<hsize_t> DiagnosticFields::compressedChunks( vector<hsize_t> final_array_size )
+{
+    vector<hsize_t> chunk( final_array_size.size() );
+    hsize_t chunk_points = 1;
+    for( unsigned int i=0; i<chunk.size(); i++ ) {
+        if( final_array_size[i] == 0 ) {
+            return {};
+        }
+        hsize_t n = i < patch_size_.size() ? patch_size_[i] / subgrid_step_[i] : 1;
+        chunk[i] = min( final_array_size[i], max( n, ( hsize_t ) 1 ) );
+        chunk_points *= chunk[i];
+    }
+    // Small chunks compress poorly
+    const hsize_t min_chunk_points = 65536;
+    if( chunk_points < min_chunk_points ) {
+        chunk[0] = min( final_array_size[0], chunk[0] * ( ( min_chunk_points + chunk_points - 1 ) / chunk_points ) );
+    }
+    return chunk;
+}
+
 bool DiagnosticFields::needsRhoJs( int itime )
 {
     
@@ -439,6 +908,20 @@ void DiagnosticFields::findSubgridIntersection(
     }
 }
 
+bool DiagnosticFields::intersectsSubgrid( Patch *patch )
+{
+    for( unsigned int i=0; i<patch_size_.size(); i++ ) {
+        hsize_t patch_begin   = patch->Pcoordinates[i] * patch_size_[i] + ( ( patch->Pcoordinates[i]==0 )?0:1 );
+        hsize_t patch_npoints = patch_size_[i] + ( ( patch->Pcoordinates[i]==0 )?1:0 );
+        hsize_t start_in_patch;
+        findSubgridIntersection1( i, patch_begin, patch_npoints, start_in_patch );
+        if( patch_npoints == 0 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void DiagnosticFields::findSubgridIntersection1(
     hsize_t idim,
     hsize_t &zone_offset,  // input = start of zone in full array / output = start of zone in the subgrid
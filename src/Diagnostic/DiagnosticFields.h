@@ -1,7 +1,11 @@
 #ifndef DIAGNOSTICFIELDS_H
 #define DIAGNOSTICFIELDS_H
 
+#include <thread>
+#include <map>
+
 #include "Diagnostic.h"
+#include "ADIOS2.h"
 
 class DiagnosticFields  : public Diagnostic
 {
@@ -25,8 +29,35 @@ public :
     
     virtual H5Write writeField( H5Write*, std::string ) = 0;
     
+    //! Waits for the completion of the asynchronous write of the previous output, if any
+    void waitWrite();
+    
+    //! Waits for the asynchronous writes of all the fields diagnostics
+    static void waitAsynchronousWrites();
+    
+    //! True if this diagnostic is written asynchronously
+    bool asynchronous()
+    {
+        return asynchronous_;
+    };
+    
+    //! True if at least one fields diagnostic is written asynchronously
+    static bool anyAsynchronous()
+    {
+        return ! asynchronous_diags_.empty();
+    };
+    
+    //! True if the HDF5 library tolerates calls from several threads
+    static bool hdf5_threadsafe_;
+    
     virtual bool needsRhoJs( int itime ) override;
     
+    //! Time averages and Fourier transforms are accumulated over the exact iterations
+    bool delayable() override
+    {
+        return time_average <= 1 && dft_frequency_.empty();
+    };
+    
     void findSubgridIntersection( unsigned int subgrid_start,
                                   unsigned int subgrid_stop,
                                   unsigned int subgrid_step,
@@ -39,6 +70,9 @@ public :
                                    hsize_t &zone_begin,
                                    hsize_t &zone_npoints,
                                    hsize_t &start_in_zone );
+    
+    //! True if the patch holds at least one point of the subgrid
+    bool intersectsSubgrid( Patch *patch );
                                   
     //! Get memory footprint of current diagnostic
     int getMemFootPrint() override
@@ -68,6 +102,49 @@ protected :
     //! Subgrid requested
     std::vector<unsigned int> subgrid_start_, subgrid_stop_, subgrid_step_;
     
+    //! Reduction of the field over the subgrid step around each subgrid point, instead of a sample
+    enum SubgridReduction { subgrid_sample, subgrid_mean, subgrid_max_abs, subgrid_rms };
+    SubgridReduction subgrid_reduction_;
+    
+    //! Reduction of a field over the subgrid step around a point (clamped to the patch and its ghost cells)
+    double subgridReduce( Field *field, unsigned int ix, unsigned int iy=0, unsigned int iz=0 );
+    
+    //! True if the time average is only accumulated at the subgrid points (smaller buffers)
+    bool subgrid_accumulation_;
+    
+    //! Field holding one point per subgrid step of a patch field (which is deleted)
+    Field * subgridField( Field *field );
+    
+    //! Adds the weighted field at the subgrid points of the patch to its average accumulated on the subgrid
+    void incrementSubgridAvgField( Patch *patch, Field *field, Field *field_avg, double weight );
+    
+    //! Value of a field at a subgrid point of the patch: sampled, reduced over the subgrid step,
+    //! or read in the time average accumulated on the subgrid
+    inline double subgridValue( Field *field, unsigned int ix, unsigned int iy=0, unsigned int iz=0 )
+    {
+        unsigned int ndim = field->dims_.size();
+        unsigned int ny = ndim > 1 ? field->dims_[1] : 1;
+        unsigned int nz = ndim > 2 ? field->dims_[2] : 1;
+        if( subgrid_accumulation_ ) {
+            ix /= subgrid_step_[0];
+            iy /= ndim > 1 ? subgrid_step_[1] : 1;
+            iz /= ndim > 2 ? subgrid_step_[2] : 1;
+        } else if( subgrid_reduction_ != subgrid_sample ) {
+            return subgridReduce( field, ix, iy, iz );
+        }
+        return field->data_[( ix*ny + iy )*nz + iz];
+    };
+    
+    //! Angular frequency of the running Fourier transform of each output (empty without transforms)
+    std::vector<double> dft_frequency_;
+    //! True if the output is the imaginary part of the Fourier transform
+    std::vector<bool> dft_imaginary_;
+    //! Timestep, to get the time of each iteration in the Fourier transforms
+    double timestep_;
+    
+    //! Weight of the current iteration in the running average (or Fourier transform) of the output ifield
+    double dftWeight( unsigned int ifield, int itime );
+    
     //! Number of cells to skip in each direction
     std::vector<unsigned int> patch_offset_in_grid;
     //! Number of cells in each direction
@@ -101,6 +178,60 @@ protected :
     
     //! Datatype for writing to HDF5 file
     hid_t file_datatype_;
+    
+    //! MPI-IO aggregation and striping of the file (0 for the defaults of the MPI library)
+    int aggregators_per_node_, striping_factor_, striping_unit_;
+    
+    //! Chunks of the compressed datasets: about one patch, extended along the first axis if too small
+    std::vector<hsize_t> compressedChunks( std::vector<hsize_t> final_array_size );
+    
+    //! Staggering of each field, in space and in time (for openPMD)
+    std::vector<std::vector<double> > stagger_;
+    std::vector<double> stagger_t_;
+    
+    //! Writes the content of "data" as the field ifield, with its openPMD attributes
+    void writeFieldAndAttributes( unsigned int ifield );
+    
+    //! Completes the output of the current iteration group
+    void closeIterationGroup( double x_moved, bool flush );
+    
+    //! True if the output is written by a separate thread while the simulation continues
+    bool asynchronous_;
+    
+    //! Copies of the field buffers being written asynchronously
+    std::vector<std::vector<double> > staged_data_;
+    
+    //! Thread writing the staged buffers
+    std::thread writer_;
+    
+    //! Writes the staged buffers (body of the writer thread)
+    void writeStaged( double x_moved, bool flush );
+    
+    //! All the asynchronous fields diagnostics
+    static std::vector<DiagnosticFields *> asynchronous_diags_;
+    
+    //! True if the output goes to an ADIOS2 engine instead of an HDF5 file
+    bool adios2_;
+    
+    //! ADIOS2 engine ("BP5", "SST", ...) and its parameters
+    std::string adios2_engine_name_;
+    std::map<std::string, std::string> adios2_parameters_;
+    
+#ifdef SMILEI_ADIOS2
+    adios2::ADIOS *adios_;
+    adios2::IO adios_io_;
+    adios2::Engine adios_engine_;
+    
+    //! Block of each patch, and its position in the global array
+    std::vector<std::vector<double> > patch_blocks_;
+    std::vector<std::vector<size_t> > patch_starts_, patch_counts_;
+    
+    //! Copies the intersection of a patch with the subgrid into its block
+    void getPatchBlock( Patch *patch, unsigned int ifield, unsigned int ipatch );
+    
+    //! Writes all the fields of this iteration in a new step of the ADIOS2 engine
+    void runADIOS2( VectorPatch &vecPatches, int itime, SimWindow *simWindow );
+#endif
 };
 
 #endif
@@ -17,6 +17,7 @@ DiagnosticFields1D::DiagnosticFields1D( Params &params, SmileiMPI *smpi, VectorP
     
     // Calculate the patch size
     total_patch_size = params.patch_size_[0];
+    patch_size_ = { params.patch_size_[0] };
     
     // define space in file and in memory
     // All patch write patch_size_ elements except, patch 0 which write patch_size_+1
@@ -62,8 +63,14 @@ void DiagnosticFields1D::setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatc
     
     data.resize( nsteps );
     
+    // Compressed datasets are chunked
+    hsize_t chunk = 0;
+    if( compression_filter_ != H5Z_FILTER_NONE && total_dataset_size > 0 ) {
+        chunk = compressedChunks( { total_dataset_size } )[0];
+    }
+    
     delete filespace;
-    filespace = new H5Space( total_dataset_size, MPI_start_in_file, nsteps );
+    filespace = new H5Space( total_dataset_size, MPI_start_in_file, nsteps, chunk );
     delete memspace;
     memspace = new H5Space( total_dataset_size, 0, nsteps );
 }
@@ -101,7 +108,7 @@ void DiagnosticFields1D::getField( Patch *patch, unsigned int ifield )
     
     // Copy this patch field into buffer
     while( ix < ix_max ) {
-        data[iout] = ( *field )( ix ) * time_average_inv;
+        data[iout] = subgridValue( field, ix ) * time_average_inv;
         ix += subgrid_step_[0];
         iout++;
     }
@@ -47,6 +47,11 @@ DiagnosticFields2D::DiagnosticFields2D( Params &params, SmileiMPI *smpi, VectorP
         }
     }
     
+    // Compressed datasets are chunked by patches
+    if( compression_filter_ != H5Z_FILTER_NONE ) {
+        chunk_size = compressedChunks( final_array_size );
+    }
+    
     filespace = new H5Space( final_array_size, {}, {}, chunk_size );
     memspace = new H5Space( 1 );
     
@@ -113,7 +118,9 @@ void DiagnosticFields2D::setFileSplitting( SmileiMPI *, VectorPatch &vecPatches
             findSubgridIntersection1( 1, offset[1], npoints[1], start_in_patch[1] );
             
             // Add this patch to the filespace
-            H5Sselect_hyperslab( filespace->sid_, H5S_SELECT_OR, &offset[0], NULL, &count[0], &npoints[0] );
+            if( npoints[0] > 0 && npoints[1] > 0 ) {
+                H5Sselect_hyperslab( filespace->sid_, H5S_SELECT_OR, &offset[0], NULL, &count[0], &npoints[0] );
+            }
             
             // Calculate the initial skip when writing this patch to the buffer
             buffer_skip_y[ipatch] = current_y_skip + npoints_y;
@@ -169,7 +176,7 @@ void DiagnosticFields2D::getField( Patch *patch, unsigned int ifield )
     unsigned int step_out = buffer_skip_x[patch->Hindex()-refHindex];
     for( unsigned int ix = start_in_patch[0]; ix < ix_max; ix += subgrid_step_[0] ) {
         for( unsigned int iy = start_in_patch[1]; iy < iy_max; iy += subgrid_step_[1] ) {
-            data[iout] = ( *field )( ix, iy ) * time_average_inv;
+            data[iout] = subgridValue( field, ix, iy ) * time_average_inv;
             iout++;
         }
         iout += step_out;
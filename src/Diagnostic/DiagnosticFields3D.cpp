@@ -48,6 +48,11 @@ DiagnosticFields3D::DiagnosticFields3D( Params &params, SmileiMPI *smpi, VectorP
         }
     }
     
+    // Compressed datasets are chunked by patches
+    if( compression_filter_ != H5Z_FILTER_NONE ) {
+        chunk_size = compressedChunks( final_array_size );
+    }
+    
     filespace = new H5Space( final_array_size, {}, {}, chunk_size );
     memspace = new H5Space( 1 );
     
@@ -130,7 +135,9 @@ void DiagnosticFields3D::setFileSplitting( SmileiMPI *, VectorPatch &vecPatches
                 findSubgridIntersection1( 2, offset[2], npoints[2], start_in_patch[2] );
                 
                 // Add this patch to the filespace
-                H5Sselect_hyperslab( filespace->sid_, H5S_SELECT_OR, &offset[0], NULL, &count[0], &npoints[0] );
+                if( npoints[0] > 0 && npoints[1] > 0 && npoints[2] > 0 ) {
+                    H5Sselect_hyperslab( filespace->sid_, H5S_SELECT_OR, &offset[0], NULL, &count[0], &npoints[0] );
+                }
                 
                 // Calculate the initial skip when writing this patch to the buffer
                 buffer_skip_z[ipatch] = current_z_skip + npoints_yz + npoints_z;
@@ -201,7 +208,7 @@ void DiagnosticFields3D::getField( Patch *patch, unsigned int ifield )
     for( unsigned int ix = start_in_patch[0]; ix < ix_max; ix += subgrid_step_[0] ) {
         for( unsigned int iy = start_in_patch[1]; iy < iy_max; iy += subgrid_step_[1] ) {
             for( unsigned int iz = start_in_patch[2]; iz < iz_max; iz += subgrid_step_[2] ) {
-                data[iout] = ( *field )( ix, iy, iz ) * time_average_inv;
+                data[iout] = subgridValue( field, ix, iy, iz ) * time_average_inv;
                 iout++;
             }
             iout += stepy_out;
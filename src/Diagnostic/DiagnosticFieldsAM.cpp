@@ -71,6 +71,14 @@ DiagnosticFieldsAM::DiagnosticFieldsAM( Params &params, SmileiMPI *smpi, VectorP
         }
     }
     
+    // Compressed datasets are chunked by patches
+    if( compression_filter_ != H5Z_FILTER_NONE ) {
+        chunk_size = compressedChunks( final_array_size );
+        if( is_complex_ && ! chunk_size.empty() ) {
+            chunk_size[1] = min( final_array_size[1], 2*chunk_size[1] );
+        }
+    }
+    
     filespace = new H5Space( final_array_size, {}, {}, chunk_size );
     memspace = new H5Space( 1 );
     
@@ -150,7 +158,9 @@ void DiagnosticFieldsAM::setFileSplitting( SmileiMPI *, VectorPatch &vecPatches
                 offset[1] *= 2;
                 npoints[1] *= 2;
             }
-            H5Sselect_hyperslab( filespace->sid_, H5S_SELECT_OR, &offset[0], NULL, &count[0], &npoints[0] );
+            if( npoints[0] > 0 && npoints[1] > 0 ) {
+                H5Sselect_hyperslab( filespace->sid_, H5S_SELECT_OR, &offset[0], NULL, &count[0], &npoints[0] );
+            }
             
             i++;
         }
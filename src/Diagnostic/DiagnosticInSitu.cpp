@@ -0,0 +1,172 @@
+#include "PyTools.h"
+
+#include <string>
+#include <sstream>
+
+#include "ParticleData.h"
+#include "DiagnosticInSitu.h"
+#include "SimWindow.h"
+
+using namespace std;
+
+DiagnosticInSitu::DiagnosticInSitu( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches, unsigned int idiag )
+{
+    ostringstream name( "" );
+    name << "DiagInSitu #" << idiag;
+    string errorPrefix = name.str();
+    
+#ifndef SMILEI_USE_NUMPY
+    ERROR( errorPrefix << " requires the numpy package" );
+#endif
+    if( params.geometry == "AMcylindrical" ) {
+        ERROR( errorPrefix << " not available in AMcylindrical geometry" );
+    }
+    
+    // get parameter "every" which describes a timestep selection
+    timeSelection = new TimeSelection( PyTools::extract_py( "every", "DiagInSitu", idiag ), name.str() );
+    flush_timeSelection = new TimeSelection();
+    
+    // get parameter "callback", the python function that receives each patch
+    callback_ = PyTools::extract_py( "callback", "DiagInSitu", idiag );
+    if( ! PyCallable_Check( callback_ ) ) {
+        ERROR( errorPrefix << ": `callback` must be a python function" );
+    }
+    int n_arg = PyTools::function_nargs( callback_ );
+    if( n_arg >= 0 && n_arg != 1 ) {
+        ERROR( errorPrefix << ": `callback` has " << n_arg << " arguments while requiring 1" );
+    }
+    
+    // get parameter "fields", the list of fields exposed to the callback
+    vector<string> fields;
+    PyTools::extractV( "fields", fields, "DiagInSitu", idiag );
+    hasRhoJs_ = false;
+    vector<Field *> &allFields = vecPatches.emfields( 0 )->allFields;
+    for( unsigned int j=0; j<fields.size(); j++ ) {
+        bool found = false;
+        for( unsigned int i=0; i<allFields.size(); i++ ) {
+            if( fields[j] == allFields[i]->name ) {
+                fields_indexes_.push_back( i );
+                fields_names_  .push_back( fields[j] );
+                if( fields[j].at( 0 )=='J' || fields[j].at( 0 )=='R' ) {
+                    hasRhoJs_ = true;
+                }
+                found = true;
+                break;
+            }
+        }
+        if( ! found ) {
+            ERROR( errorPrefix << ": field `" << fields[j] << "` not found" );
+        }
+    }
+    
+    // get parameter "species", the list of species exposed to the callback
+    PyTools::extractV( "species", species_names_, "DiagInSitu", idiag );
+    if( ! species_names_.empty() ) {
+        species_indices_ = Params::FindSpecies( vecPatches( 0 )->vecSpecies, species_names_ );
+    }
+    
+    timestep_ = params.timestep;
+    cell_length_ = params.cell_length;
+    oversize_ = params.oversize;
+    
+    if( smpi->isMaster() ) {
+        MESSAGE( 1, "Created in-situ diagnostic #" << idiag << " with " << fields_names_.size() << " fields and " << species_names_.size() << " species" );
+    }
+}
+
+DiagnosticInSitu::~DiagnosticInSitu()
+{
+    delete timeSelection;
+    delete flush_timeSelection;
+    Py_XDECREF( callback_ );
+}
+
+bool DiagnosticInSitu::prepare( int itime )
+{
+    return timeSelection->theTimeIsNow( itime );
+}
+
+bool DiagnosticInSitu::needsRhoJs( int itime )
+{
+    return hasRhoJs_ && timeSelection->theTimeIsNow( itime );
+}
+
+#ifdef SMILEI_USE_NUMPY
+// The python function is called by the master thread (which holds the GIL), patch by patch.
+// The numpy arrays point to the data of the fields and particles and must not be kept after the call.
+void DiagnosticInSitu::run( SmileiMPI *, VectorPatch &vecPatches, int itime, SimWindow *simWindow, Timers & )
+{
+    #pragma omp master
+    {
+        unsigned int ndim = cell_length_.size();
+        for( unsigned int ipatch=0; ipatch<vecPatches.size(); ipatch++ ) {
+            Patch *patch = vecPatches( ipatch );
+            
+            PyObject *data = PyDict_New();
+            PyObject *origin = PyList_New( ndim ), *cell_length = PyList_New( ndim ), *ghost_cells = PyList_New( ndim );
+            for( unsigned int idim=0; idim<ndim; idim++ ) {
+                PyList_SET_ITEM( origin     , idim, PyFloat_FromDouble( patch->getDomainLocalMin( idim ) ) );
+                PyList_SET_ITEM( cell_length, idim, PyFloat_FromDouble( cell_length_[idim] ) );
+                PyList_SET_ITEM( ghost_cells, idim, PyLong_FromLong( oversize_[idim] ) );
+            }
+            PyObject *items[7] = {
+                PyLong_FromLong( itime ),
+                PyFloat_FromDouble( itime * timestep_ ),
+                PyLong_FromLong( patch->hindex ),
+                origin, cell_length, ghost_cells,
+                PyFloat_FromDouble( simWindow ? simWindow->getXmoved() : 0. )
+            };
+            const char *keys[7] = { "iteration", "time", "hindex", "origin", "cell_length", "ghost_cells", "x_moved" };
+            for( unsigned int i=0; i<7; i++ ) {
+                PyDict_SetItemString( data, keys[i], items[i] );
+                Py_DECREF( items[i] );
+            }
+            
+            // Read-only views of the fields, including the ghost cells
+            PyObject *fields = PyDict_New();
+            for( unsigned int ifield=0; ifield<fields_indexes_.size(); ifield++ ) {
+                Field *field = patch->EMfields->allFields[fields_indexes_[ifield]];
+                if( ! field || ! field->data_ ) {
+                    continue;
+                }
+                npy_intp dims[3];
+                for( unsigned int idim=0; idim<field->dims_.size(); idim++ ) {
+                    dims[idim] = field->dims_[idim];
+                }
+                PyArrayObject *array = ( PyArrayObject * ) PyArray_SimpleNewFromData( field->dims_.size(), dims, NPY_DOUBLE, field->data_ );
+                PyArray_CLEARFLAGS( array, NPY_ARRAY_WRITEABLE );
+                PyDict_SetItemString( fields, fields_names_[ifield].c_str(), ( PyObject * ) array );
+                Py_DECREF( array );
+            }
+            PyDict_SetItemString( data, "fields", fields );
+            Py_DECREF( fields );
+            
+            // Read-only views of the particles
+            PyObject *species = PyDict_New();
+            vector<ParticleData *> particle_data( species_indices_.size() );
+            for( unsigned int ispec=0; ispec<species_indices_.size(); ispec++ ) {
+                Particles *particles = patch->vecSpecies[species_indices_[ispec]]->particles;
+                particle_data[ispec] = new ParticleData( particles->numberOfParticles() );
+                particle_data[ispec]->set( particles );
+                particle_data[ispec]->readOnly();
+                PyDict_SetItemString( species, species_names_[ispec].c_str(), particle_data[ispec]->get() );
+            }
+            PyDict_SetItemString( data, "species", species );
+            Py_DECREF( species );
+            
+            PyObject *ret = PyObject_CallFunctionObjArgs( callback_, data, NULL );
+            PyTools::checkPyError();
+            Py_XDECREF( ret );
+            Py_DECREF( data );
+            for( unsigned int ispec=0; ispec<particle_data.size(); ispec++ ) {
+                delete particle_data[ispec];
+            }
+        }
+    }
+    #pragma omp barrier
+}
+#else
+void DiagnosticInSitu::run( SmileiMPI *, VectorPatch &, int, SimWindow *, Timers & )
+{
+}
+#endif
@@ -0,0 +1,62 @@
+#ifndef DIAGNOSTICINSITU_H
+#define DIAGNOSTICINSITU_H
+
+#include "Diagnostic.h"
+#include "VectorPatch.h"
+
+//! Hands the fields and particles of each patch to a python function, without copies,
+//! for in-situ analysis or coupling (ParaView Catalyst, Ascent, openPMD streams, ...)
+class DiagnosticInSitu : public Diagnostic
+{
+public :
+
+    //! Default constructor
+    DiagnosticInSitu( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches, unsigned int idiag );
+    //! Default destructor
+    ~DiagnosticInSitu() override;
+    
+    //! No file: the python function does the output, if any
+    void openFile( Params &, SmileiMPI * ) override {};
+    
+    void closeFile() override {};
+    
+    bool prepare( int itime ) override;
+    
+    void run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime, SimWindow *simWindow, Timers &timers ) override;
+    
+    bool needsRhoJs( int itime ) override;
+    
+    //! No file output to group with the others
+    bool delayable() override
+    {
+        return false;
+    };
+    
+    //! Get memory footprint of current diagnostic
+    int getMemFootPrint() override
+    {
+        return 0;
+    };
+    
+private :
+
+    //! Python function called for each patch
+    PyObject *callback_;
+    
+    //! Indexes and names of the fields exposed to the python function
+    std::vector<unsigned int> fields_indexes_;
+    std::vector<std::string> fields_names_;
+    
+    //! Indexes and names of the species exposed to the python function
+    std::vector<unsigned int> species_indices_;
+    std::vector<std::string> species_names_;
+    
+    //! True if one of the fields is a current or a density
+    bool hasRhoJs_;
+    
+    double timestep_;
+    std::vector<double> cell_length_;
+    std::vector<unsigned int> oversize_;
+};
+
+#endif
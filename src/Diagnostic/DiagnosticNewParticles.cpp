@@ -16,10 +16,29 @@ DiagnosticNewParticles::DiagnosticNewParticles( Params &params, SmileiMPI *smpi,
 {
     write_id_ = vecPatches.species( 0, species_index_ )->particles->tracked;
     
+    ostringstream name( "" );
+    name << "DiagNewParticles #" << iDiagnosticNewParticles;
+    
+    // Get parameter "record_every" which keeps only a fraction of the new particles
+    int record_every = 1;
+    PyTools::extract( "record_every", record_every, "DiagNewParticles", iDiagnosticNewParticles );
+    if( record_every < 1 ) {
+        ERROR( name.str() << ": `record_every` must be a positive integer" );
+    }
+    
+    // Get parameter "buffer_size" which triggers an output when the records of one process are too many
+    int buffer_size = 0;
+    PyTools::extract( "buffer_size", buffer_size, "DiagNewParticles", iDiagnosticNewParticles );
+    if( buffer_size < 0 ) {
+        ERROR( name.str() << ": `buffer_size` must be positive or zero" );
+    }
+    buffer_size_ = buffer_size;
+    world_ = smpi->world();
+    
     // Inform each patch about this diag
     for( unsigned int ipatch=0; ipatch<vecPatches.size(); ipatch++ ) {
         Species * s = vecPatches.species( ipatch, species_index_ );
-        s->birth_records_ = new BirthRecords( *s->particles );
+        s->birth_records_ = new BirthRecords( *s->particles, record_every, buffer_size_ > 0 ? &nrecords_ : nullptr );
         // Find out the other species that may create this one by ionization
         for( auto s: vecPatches( ipatch )->vecSpecies ) {
             if( s->Ionize && s->electron_species_index == species_index_ ) {
@@ -164,6 +183,22 @@ void DiagnosticNewParticles::init( Params &params, SmileiMPI *smpi, VectorPatch
 }
 
 
+bool DiagnosticNewParticles::prepare( int itime )
+{
+    // Evaluated once per iteration, as the reduction is collective
+    if( itime != prepared_time_ ) {
+        prepared_time_ = itime;
+        int full = 0;
+        if( buffer_size_ > 0 ) {
+            int local_full = nrecords_ >= buffer_size_;
+            MPI_Allreduce( &local_full, &full, 1, MPI_INT, MPI_LOR, world_ );
+        }
+        prepared_ = full || timeSelection->theTimeIsNow( itime );
+    }
+    return prepared_;
+}
+
+
 H5Space * DiagnosticNewParticles::prepareH5( SimWindow *, SmileiMPI *smpi, int itime, uint32_t nParticles_local, uint64_t nParticles_global, uint64_t offset )
 {
     // Resize datasets
@@ -243,6 +278,8 @@ void DiagnosticNewParticles::writeOther( VectorPatch &vecPatches, size_t iprop,
     for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
         vecPatches.species( ipatch, species_index_ )->birth_records_->clear();
     }
+    #pragma omp master
+    nrecords_ = 0;
 }
 
 
@@ -22,6 +22,9 @@ public :
     
     void init( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches ) override;
     
+    //! True at the output iterations, or when the records of one process exceed buffer_size_ (collective)
+    bool prepare( int itime ) override;
+    
     //! Get disk footprint of current diagnostic
     uint64_t getDiskFootPrint( int istart, int istop, Patch *patch ) override;
     
@@ -59,6 +62,18 @@ private :
     
     //! Storage for the number of particles at each output iteration
     H5Write * iteration_npart_ = nullptr;
+    
+    //! Number of records of one process that triggers an output (0 for none)
+    uint64_t buffer_size_;
+    
+    //! Number of particles recorded in the patches of this process since the last output
+    uint64_t nrecords_ = 0;
+    
+    //! Result of prepare() for the iteration prepared_time_
+    int prepared_time_ = -1;
+    bool prepared_ = false;
+    
+    MPI_Comm world_;
 };
 
 #endif
@@ -1,5 +1,6 @@
 #include "PyTools.h"
 #include <iomanip>
+#include <omp.h>
 
 #include "DiagnosticParticleBinningBase.h"
 #include "HistogramFactory.h"
@@ -114,6 +115,44 @@ DiagnosticParticleBinningBase::DiagnosticParticleBinningBase(
     }
     output_size = ( unsigned int ) total_size;
     
+    // get parameter "reduction" that determines how the threads sum their contributions
+#ifdef _OPENMP
+    unsigned int max_threads = omp_get_max_threads();
+#else
+    unsigned int max_threads = 1;
+#endif
+    string reduction = "atomic";
+    PyTools::extract( "reduction", reduction, pyDiag, idiag );
+    if( reduction == "atomic" ) {
+        reduction_ = REDUCTION_ATOMIC;
+    } else if( reduction == "private" ) {
+        reduction_ = REDUCTION_PRIVATE;
+        thread_data_.resize( max_threads );
+    } else if( reduction == "sparse" ) {
+        reduction_ = REDUCTION_SPARSE;
+        thread_sparse_data_.resize( max_threads );
+    } else if( reduction == "exact" ) {
+        reduction_ = REDUCTION_EXACT;
+    } else {
+        ERROR( errorPrefix << ": `reduction` must be \"atomic\", \"private\", \"sparse\" or \"exact\"" );
+    }
+    
+    // get parameter "storage" that determines whether empty bins are stored
+    string storage = "dense";
+    PyTools::extract( "storage", storage, pyDiag, idiag );
+    if( storage != "dense" && storage != "sparse" ) {
+        ERROR( errorPrefix << ": `storage` must be \"dense\" or \"sparse\"" );
+    }
+    sparse_storage_ = ( storage == "sparse" );
+    if( sparse_storage_ ) {
+        if( reduction_ == REDUCTION_PRIVATE || reduction_ == REDUCTION_EXACT ) {
+            ERROR( errorPrefix << ": `storage = \"sparse\"` requires `reduction = \"sparse\"`" );
+        }
+        // The threads also store the bins sparsely
+        reduction_ = REDUCTION_SPARSE;
+        thread_sparse_data_.resize( max_threads );
+    }
+    
     // Output info on diagnostics
     if( smpi->isMaster() ) {
         ostringstream mystream( "" );
@@ -225,6 +264,14 @@ bool DiagnosticParticleBinningBase::prepare( int itime )
         return false;
     }
     
+    // Sparse histograms only store the bins that are filled
+    if( sparse_storage_ ) {
+        if( itime == previousTime_ ) {
+            sparse_sum_.clear();
+        }
+        return true;
+    }
+    
     // Allocate memory for the output array (already done if time-averaging)
     data_sum.resize( output_size );
     
@@ -233,6 +280,16 @@ bool DiagnosticParticleBinningBase::prepare( int itime )
         fill( data_sum.begin(), data_sum.end(), 0. );
     }
     
+    // Exact sums (the master keeps them between the outputs when accumulating in time)
+    if( reduction_ == REDUCTION_EXACT ) {
+        exact_sum_.resize( output_size );
+        if( itime == previousTime_ ) {
+            for( unsigned int i=0; i<output_size; i++ ) {
+                exact_sum_[i].reset();
+            }
+        }
+    }
+    
     return true;
     
 } // END prepare
@@ -321,10 +378,70 @@ void DiagnosticParticleBinningBase::run( Patch *patch, int, SimWindow *simWindow
     
     histogram->digitize( species, double_buffer, int_buffer, simWindow );
     histogram->valuate( species, double_buffer, int_buffer );
-    histogram->distribute( double_buffer, int_buffer, data_sum );
+    distribute( double_buffer, int_buffer );
     
 } // END run
 
+void DiagnosticParticleBinningBase::distribute( vector<double> &double_buffer, vector<int> &int_buffer )
+{
+    if( reduction_ == REDUCTION_PRIVATE ) {
+        histogram->distributePrivate( double_buffer, int_buffer, threadHistogram() );
+    } else if( reduction_ == REDUCTION_SPARSE ) {
+        histogram->distributeSparse( double_buffer, int_buffer, thread_sparse_data_[Tools::getOMPThreadNum()] );
+    } else if( reduction_ == REDUCTION_EXACT ) {
+        histogram->distributeExact( double_buffer, int_buffer, exact_sum_ );
+    } else {
+        histogram->distribute( double_buffer, int_buffer, data_sum );
+    }
+}
+
+void DiagnosticParticleBinningBase::reduceThreads()
+{
+    if( reduction_ == REDUCTION_PRIVATE ) {
+        // Each thread sums a range of bins over all the private arrays
+        #pragma omp for schedule(static)
+        for( unsigned int i=0; i<output_size; i++ ) {
+            for( unsigned int ithread=0; ithread<thread_data_.size(); ithread++ ) {
+                if( ! thread_data_[ithread].empty() ) {
+                    data_sum[i] += thread_data_[ithread][i];
+                    thread_data_[ithread][i] = 0.;
+                }
+            }
+        }
+    } else if( reduction_ == REDUCTION_SPARSE ) {
+        #pragma omp single
+        for( unsigned int ithread=0; ithread<thread_sparse_data_.size(); ithread++ ) {
+            for( auto &bin : thread_sparse_data_[ithread] ) {
+                if( sparse_storage_ ) {
+                    sparse_sum_[bin.first] += bin.second;
+                } else {
+                    data_sum[bin.first] += bin.second;
+                }
+            }
+            thread_sparse_data_[ithread].clear();
+        }
+    } else if( reduction_ == REDUCTION_EXACT ) {
+        // Carry the digits at each iteration, so that up to 2^31 particles per process may fall in a bin at each iteration
+        #pragma omp for schedule(static)
+        for( unsigned int i=0; i<output_size; i++ ) {
+            exact_sum_[i].normalize();
+        }
+    }
+}
+
+void DiagnosticParticleBinningBase::sortSparseBins()
+{
+    vector<pair<int, double> > bins( sparse_sum_.begin(), sparse_sum_.end() );
+    sort( bins.begin(), bins.end() );
+    sparse_indices_.resize( bins.size() );
+    sparse_values_.resize( bins.size() );
+    for( size_t i=0; i<bins.size(); i++ ) {
+        sparse_indices_[i] = bins[i].first;
+        sparse_values_[i] = bins[i].second;
+    }
+    sparse_sum_.clear();
+}
+
 bool DiagnosticParticleBinningBase::writeNow( int itime ) {
     return itime - timeSelection->previousTime() == time_average-1;
 }
@@ -340,8 +457,14 @@ void DiagnosticParticleBinningBase::write( int itime, SmileiMPI *smpi )
     // if time_average, then we need to divide by the number of timesteps
     if( !time_accumulate && time_average > 1 ) {
         double coeff = 1./( ( double )time_average );
-        for( unsigned int i=0; i<output_size; i++ ) {
-            data_sum[i] *= coeff;
+        if( sparse_storage_ ) {
+            for( unsigned int i=0; i<sparse_values_.size(); i++ ) {
+                sparse_values_[i] *= coeff;
+            }
+        } else {
+            for( unsigned int i=0; i<output_size; i++ ) {
+                data_sum[i] *= coeff;
+            }
         }
     }
     
@@ -354,7 +477,18 @@ void DiagnosticParticleBinningBase::write( int itime, SmileiMPI *smpi )
     // write the array if it does not exist already
     if( ! file_->has( dataname ) ) {
         H5Space d( dims );
-        H5Write dataset = file_->array( dataname, data_sum[0], &d, &d );
+        H5Write dataset = sparse_storage_ ? file_->group( dataname ) : file_->array( dataname, data_sum[0], &d, &d );
+        
+        // Sparse layout: a group with the shape of the histogram, the indices of the
+        // non-empty bins in the flattened array, sorted, and their values
+        if( sparse_storage_ ) {
+            vector<unsigned int> shape( dims.begin(), dims.end() );
+            dataset.attr( "shape", shape );
+            if( ! sparse_indices_.empty() ) {
+                dataset.vect( "indices", sparse_indices_ );
+                dataset.vect( "values", sparse_values_ );
+            }
+        }
         
         // When auto limits, write the limits
         for( unsigned int iaxis=0 ; iaxis < histogram->axes.size() ; iaxis++ ) {
@@ -376,6 +510,11 @@ void DiagnosticParticleBinningBase::write( int itime, SmileiMPI *smpi )
         // Clear the array
         clear();
         data_sum.resize( 0 );
+    } else if( sparse_storage_ ) {
+        // The accumulation continues from the reduced bins
+        for( unsigned int i=0; i<sparse_indices_.size(); i++ ) {
+            sparse_sum_[sparse_indices_[i]] += sparse_values_[i];
+        }
     }
 } // END write
 
@@ -385,6 +524,12 @@ void DiagnosticParticleBinningBase::clear()
 {
     data_sum.resize( 0 );
     vector<double>().swap( data_sum );
+    for( unsigned int i=0; i<exact_sum_.size(); i++ ) {
+        exact_sum_[i].reset();
+    }
+    sparse_sum_.clear();
+    sparse_indices_.clear();
+    sparse_values_.clear();
 }
 
 
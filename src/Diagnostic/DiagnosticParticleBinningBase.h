@@ -45,10 +45,44 @@ public :
     //! Clear the array
     virtual void clear();
     
+    //! Add the contribution of each particle of a patch, in the array of the current thread if `reduction` requires it
+    void distribute( std::vector<double> &double_buffer, std::vector<int> &int_buffer );
+    
+    //! Add a contribution to one bin, in the array of the current thread if `reduction` requires it
+    inline void deposit( int ind, double value )
+    {
+        if( reduction_ == REDUCTION_PRIVATE ) {
+            threadHistogram()[ind] += value;
+        } else if( reduction_ == REDUCTION_SPARSE ) {
+            thread_sparse_data_[Tools::getOMPThreadNum()][ind] += value;
+        } else if( reduction_ == REDUCTION_EXACT ) {
+            exact_sum_[ind].addAtomic( value );
+        } else {
+            #pragma omp atomic
+            data_sum[ind] += value;
+        }
+    };
+    
+    //! Sum the arrays of all threads in data_sum (called by all threads once all patches have run)
+    void reduceThreads();
+    
+    //! Move the bins of sparse_sum_ to the lists sparse_indices_ and sparse_values_, sorted by index
+    void sortSparseBins();
+    
+    //! Time averages are accumulated over the exact iterations
+    bool delayable() override
+    {
+        return time_average <= 1;
+    };
+    
     //! Get memory footprint of current diagnostic
     int getMemFootPrint() override
     {
-        int size = output_size*sizeof( double );
+        int size = sparse_storage_ ? 0 : output_size*sizeof( double );
+        for( unsigned int ithread=0; ithread<thread_data_.size(); ithread++ ) {
+            size += thread_data_[ithread].size()*sizeof( double );
+        }
+        size += sparse_sum_.size()*( sizeof( int )+sizeof( double ) );
         // + data_array + index_array +  axis_array
         // + nparts_max * (sizeof(double)+sizeof(int)+sizeof(double))
         return size;
@@ -76,6 +110,43 @@ protected:
     //! Histogram object
     Histogram *histogram;
     
+    //! How the threads sum their contributions: atomic adds in data_sum, dense or sparse arrays private to each thread,
+    //! or exact sums (independent of the numbers of threads and processes)
+    enum { REDUCTION_ATOMIC, REDUCTION_PRIVATE, REDUCTION_SPARSE, REDUCTION_EXACT } reduction_;
+    
+    //! Exact sums of the bins of this process (copied to data_sum by the master after the MPI reduction)
+    std::vector<ExactSum> exact_sum_;
+    inline void exactSumsToData()
+    {
+        for( unsigned int i=0; i<output_size; i++ ) {
+            data_sum[i] = exact_sum_[i].value();
+        }
+    };
+    
+    //! Arrays private to each thread, reduced in data_sum once all patches have run
+    std::vector<std::vector<double> > thread_data_;
+    std::vector<std::unordered_map<int, double> > thread_sparse_data_;
+    
+    //! True if the histogram is stored, reduced and written as a list of its non-empty bins
+    bool sparse_storage_;
+    
+    //! Non-empty bins of this MPI process, when the storage is sparse
+    std::unordered_map<int, double> sparse_sum_;
+    
+    //! Indices and values of the non-empty bins sorted by index, for the MPI reduction and the output
+    std::vector<unsigned int> sparse_indices_;
+    std::vector<double> sparse_values_;
+    
+    //! Private array of the current thread, allocated at its first use
+    inline std::vector<double> &threadHistogram()
+    {
+        std::vector<double> &array = thread_data_[Tools::getOMPThreadNum()];
+        if( array.empty() ) {
+            array.resize( output_size, 0. );
+        }
+        return array;
+    };
+    
     unsigned int output_size;
     
     int total_axes;
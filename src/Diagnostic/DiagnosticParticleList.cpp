@@ -4,6 +4,7 @@
 #include <sstream>
 
 #include "ParticleData.h"
+#include "ParticleExpression.h"
 #include "PeekAtSpecies.h"
 #include "DiagnosticParticleList.h"
 #include "VectorPatch.h"
@@ -13,7 +14,8 @@ using namespace std;
 
 DiagnosticParticleList::DiagnosticParticleList( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches, string diag_type, string file_prefix, unsigned int idiag_of_this_type, OpenPMDparams &oPMD ) :
     Diagnostic( &oPMD, diag_type, idiag_of_this_type ),
-    nDim_particle( params.nDim_particle )
+    nDim_particle( params.nDim_particle ),
+    filter_expression_( NULL )
 {
     
     // Extract the species
@@ -37,10 +39,15 @@ DiagnosticParticleList::DiagnosticParticleList( Params &params, SmileiMPI *smpi,
     // Get parameter "flush_every" which decides the file flushing time selection
     flush_timeSelection = new TimeSelection( PyTools::extract_py( "flush_every", diag_type, idiag_of_this_type ), name.str() );
     
-    // Get parameter "filter" which gives a python function to select particles
+    // Get parameter "filter" which gives a python function, or an expression, to select particles
     filter = PyTools::extract_py( "filter", diag_type, idiag_of_this_type );
     has_filter = ( filter != Py_None );
-    if( has_filter ) {
+    string filter_string;
+    if( has_filter && PyTools::py2scalar( filter, filter_string ) ) {
+        name << " filter";
+        filter_expression_ = new ParticleExpression( filter_string, nDim_particle, name.str() );
+        filter_expression_->check( vecPatches( 0 )->vecSpecies[species_index_]->particles, name.str() );
+    } else if( has_filter ) {
 #ifdef SMILEI_USE_NUMPY
         // Test the filter with temporary, "fake" particles
         name << " filter:";
@@ -153,6 +160,7 @@ DiagnosticParticleList::~DiagnosticParticleList()
 {
     delete timeSelection;
     delete flush_timeSelection;
+    delete filter_expression_;
     Py_DECREF( filter );
 }
 
@@ -168,13 +176,32 @@ void DiagnosticParticleList::run( SmileiMPI *smpi, VectorPatch &vecPatches, int
     string xyz = "xyz";
     
     H5Space *file_space=NULL, *mem_space=NULL;
+    
+    // A compiled filter is evaluated by all threads, without the python interpreter
+    if( filter_expression_ ) {
+        #pragma omp master
+        patch_selection.resize( vecPatches.size() );
+        #pragma omp barrier
+        #pragma omp for schedule(runtime)
+        for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+            filter_expression_->select( getParticles( vecPatches( ipatch ) ), patch_selection[ipatch] );
+        }
+    }
+    
     #pragma omp master
     {
         // Obtain the particle partition of all the patches in this MPI
         nParticles_local = 0;
         patch_start.resize( vecPatches.size() );
         
-        if( has_filter ) {
+        if( filter_expression_ ) {
+            for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+                // Apply changes to filtered particles (in the order of the patches, as for the python filter)
+                modifyFiltered( vecPatches, ipatch );
+                patch_start[ipatch] = nParticles_local;
+                nParticles_local += patch_selection[ipatch].size();
+            }
+        } else if( has_filter ) {
 #ifdef SMILEI_USE_NUMPY
             patch_selection.resize( vecPatches.size() );
             PyArrayObject *ret;
@@ -219,12 +246,14 @@ void DiagnosticParticleList::run( SmileiMPI *smpi, VectorPatch &vecPatches, int
         // Specify the memory dataspace (the size of the local buffer)
         mem_space = new H5Space( (hsize_t)nParticles_local );
         
-        // Get the number of offset for this MPI rank
-        uint64_t np_local = nParticles_local, offset;
-        MPI_Scan( &np_local, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD );
-        nParticles_global = offset;
-        offset -= np_local;
-        MPI_Bcast( &nParticles_global, 1, MPI_UNSIGNED_LONG_LONG, smpi->getSize()-1, MPI_COMM_WORLD );
+        // Get the number of offset for this MPI rank (later, for all buffered iterations at once)
+        uint64_t np_local = nParticles_local, offset = 0;
+        if( ! buffered() ) {
+            MPI_Scan( &np_local, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, smpi->world() );
+            nParticles_global = offset;
+            offset -= np_local;
+            MPI_Bcast( &nParticles_global, 1, MPI_UNSIGNED_LONG_LONG, smpi->getSize()-1, smpi->world() );
+        }
         
         // Prepare all HDF5 groups and datasets
         file_space = prepareH5( simWindow, smpi, itime, nParticles_local, nParticles_global, offset );
@@ -442,7 +471,9 @@ void DiagnosticParticleList::run( SmileiMPI *smpi, VectorPatch &vecPatches, int
         delete mem_space;
         deleteH5();
         
-        if( flush_timeSelection->theTimeIsNow( itime ) ) {
+        if( buffered() ) {
+            writeBuffered( smpi, false );
+        } else if( flush_timeSelection->theTimeIsNow( itime ) ) {
             file_->flush();
         }
     }
@@ -5,6 +5,7 @@
 #include "Diagnostic.h"
 
 class Patch;
+class ParticleExpression;
 class Params;
 class SmileiMPI;
 
@@ -46,6 +47,15 @@ public :
     //! Close HDF5 groups, datasets and spaces
     virtual void deleteH5() {};
     
+    //! True if the iterations are kept in memory and written several at once
+    virtual bool buffered()
+    {
+        return false;
+    };
+    
+    //! Writes the iterations kept in memory, if needed or if forced (collective)
+    virtual void writeBuffered( SmileiMPI *, bool ) {};
+    
     //! Modify the filtered particles
     virtual void modifyFiltered( VectorPatch &, unsigned int ) {};
     
@@ -111,6 +121,9 @@ protected:
     //! Tells whether this diag includes a particle filter
     PyObject *filter;
     
+    //! Filter given as a compiled expression instead of a python function (NULL otherwise)
+    ParticleExpression *filter_expression_;
+    
     //! Selection of the filtered particles in each patch
     std::vector<std::vector<unsigned int> > patch_selection;
     
@@ -6,22 +6,33 @@
 
 using namespace std;
 
-const unsigned int n_quantities_double = 19;
+const unsigned int n_quantities_double = 33;
 const unsigned int n_quantities_uint   = 4;
 
+// Names of the particle operators sampled in each patch (fine timer ids of Patch.h)
+const string sampled_operator_names[Patch::sampled_operators_count] = {
+    "interpolator", "pusher", "projector", "cell_keys", "ionization", "radiation", "multiphoton_Breit_Wheeler"
+};
+
 // Constructor
-DiagnosticPerformances::DiagnosticPerformances( Params &params, SmileiMPI *smpi )
+DiagnosticPerformances::DiagnosticPerformances( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches )
 : mpi_size_( smpi->getSize() ),
   mpi_rank_( smpi->getRank() ),
-  filespace_double( {n_quantities_double, mpi_size_}, {0, mpi_rank_}, {n_quantities_double, 1} ),
+  n_double_( n_quantities_double + 2 * vecPatches( 0 )->vecSpecies.size() + params.hardware_counters.size() * Timers::counted_timers_count ),
+  filespace_double( {n_double_, mpi_size_}, {0, mpi_rank_}, {n_double_, 1} ),
   filespace_uint  ( {n_quantities_uint  , mpi_size_}, {0, mpi_rank_}, {n_quantities_uint  , 1} ),
-  memspace_double( { n_quantities_double, 1 }, {}, {} ),
+  memspace_double( { n_double_, 1 }, {}, {} ),
   memspace_uint  ( { n_quantities_uint  , 1 }, {}, {} )
 {
     timestep = params.timestep;
     cell_load = params.cell_load;
     frozen_particle_load = params.frozen_particle_load;
     tot_number_of_patches = params.tot_number_of_patches;
+    hardware_counters_ = params.hardware_counters;
+    for( unsigned int ispec = 0; ispec < vecPatches( 0 )->vecSpecies.size(); ispec++ ) {
+        species_names_.push_back( vecPatches( 0 )->vecSpecies[ispec]->name_ );
+    }
+    memory_warned_ = false;
     
     ostringstream name( "" );
     name << "Diagnostic performances";
@@ -41,6 +52,10 @@ DiagnosticPerformances::DiagnosticPerformances( Params &params, SmileiMPI *smpi
     
     // Get patch information flag
     PyTools::extract( "patch_information", patch_information, "DiagPerformances"  );
+    operator_sampling = params.operator_sampling_every > 0;
+    
+    // Get the memory warning threshold
+    PyTools::extract( "memory_warning", memory_warning_, "DiagPerformances"  );
     
     // Output info on diagnostics
     if( smpi->isMaster() ) {
@@ -87,7 +102,7 @@ void DiagnosticPerformances::openFile( Params &params, SmileiMPI *smpi )
     quantities_uint[3] = "number_of_frozen_particles";
     file_->attr( "quantities_uint", quantities_uint );
     
-    vector<string> quantities_double( n_quantities_double );
+    vector<string> quantities_double( n_double_ );
     quantities_double[ 0] = "total_load"      ;
     quantities_double[ 1] = "timer_global"    ;
     quantities_double[ 2] = "timer_particles" ;
@@ -107,6 +122,32 @@ void DiagnosticPerformances::openFile( Params &params, SmileiMPI *smpi )
     quantities_double[16] = "timer_envelope"     ;
     quantities_double[17] = "timer_syncSusceptibility"     ;
     quantities_double[18] = "timer_partMerging"     ;
+    quantities_double[19] = "memory_particles"     ;
+    quantities_double[20] = "memory_particles_peak"     ;
+    quantities_double[21] = "sort_moved_fraction"     ;
+    quantities_double[22] = "forecast_overshoot"     ;
+    quantities_double[23] = "forecast_undershoot"     ;
+    quantities_double[24] = "load_imbalance"     ;
+    quantities_double[25] = "load_balancing_skipped"     ;
+    quantities_double[26] = "memory_fields"     ;
+    quantities_double[27] = "memory_pml"     ;
+    quantities_double[28] = "memory_diagnostics"     ;
+    quantities_double[29] = "memory_thread_buffers"     ;
+    quantities_double[30] = "memory_mpi_buffers"     ;
+    quantities_double[31] = "memory_mpi_buffers_peak"     ;
+    quantities_double[32] = "memory_node_available"     ;
+    // Memory of the particles of each species, for instance memory_particles_electron
+    unsigned int iq = n_quantities_double;
+    for( unsigned int ispec = 0; ispec < species_names_.size(); ispec++ ) {
+        quantities_double[iq++] = "memory_particles_" + species_names_[ispec];
+        quantities_double[iq++] = "memory_particles_" + species_names_[ispec] + "_peak";
+    }
+    // Hardware events of each counted timer, for instance counter_particles_instructions
+    for( unsigned int itimer = 0; itimer < Timers::counted_timers_count && ! hardware_counters_.empty(); itimer++ ) {
+        for( unsigned int ievent = 0; ievent < hardware_counters_.size(); ievent++ ) {
+            quantities_double[iq++] = "counter_" + Timers::counted_timer_names[itimer] + "_" + HardwareCounters::name( hardware_counters_[ievent] );
+        }
+    }
     file_->attr( "quantities_double", quantities_double );
     
     file_->flush();
@@ -140,7 +181,7 @@ bool DiagnosticPerformances::prepare( int itime )
 } // END prepare
 
 
-void DiagnosticPerformances::run( SmileiMPI *, VectorPatch &vecPatches, int itime, SimWindow *, Timers &timers )
+void DiagnosticPerformances::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime, SimWindow *, Timers &timers )
 {
     
     #pragma omp master
@@ -194,7 +235,7 @@ void DiagnosticPerformances::run( SmileiMPI *, VectorPatch &vecPatches, int itim
         iteration_group.array( "quantities_uint", quantities_uint[0], &filespace_uint, &memspace_uint );
         
         // Fill the vector for double quantities
-        vector<double> quantities_double( n_quantities_double );
+        vector<double> quantities_double( n_double_ );
         quantities_double[ 0] = total_load                 ;
         quantities_double[ 1] = timers.global    .getTime();
         quantities_double[ 2] = timers.particles .getTime();
@@ -223,10 +264,52 @@ void DiagnosticPerformances::run( SmileiMPI *, VectorPatch &vecPatches, int itim
         quantities_double[16] = timers.envelope         .getTime();
         quantities_double[17] = timers.susceptibility   .getTime();
         quantities_double[18] = timers.particleMerging  .getTime();
+        // Memory allocated for the particles arrays, in GB
+        vecPatches.updateParticlesMemoryPeaks();
+        quantities_double[19] = ( double )vecPatches.getParticlesMemory() / 1073741824.;
+        quantities_double[20] = ( double )vecPatches.particles_memory_peak_ / 1073741824.;
+        quantities_double[21] = vecPatches.getSortMovedFraction();
+        vecPatches.getForecastErrors( quantities_double[22], quantities_double[23] );
+        quantities_double[24] = vecPatches.load_imbalance_;
+        quantities_double[25] = vecPatches.load_balancing_skipped_;
+        // Memory of the other subsystems, in GB
+        const std::size_t mpi_buffers_memory = vecPatches.getMPIBuffersMemory();
+        vecPatches.mpi_buffers_memory_peak_ = std::max( vecPatches.mpi_buffers_memory_peak_, mpi_buffers_memory );
+        quantities_double[26] = ( double )vecPatches.getFieldsMemory() / 1073741824.;
+        quantities_double[27] = ( double )vecPatches.getPMLMemory() / 1073741824.;
+        quantities_double[28] = ( double )vecPatches.getDiagnosticsMemory() / 1073741824.;
+        quantities_double[29] = ( double )smpi->getDynamicsBuffersMemory() / 1073741824.;
+        quantities_double[30] = ( double )mpi_buffers_memory / 1073741824.;
+        quantities_double[31] = ( double )vecPatches.mpi_buffers_memory_peak_ / 1073741824.;
+        quantities_double[32] = Tools::getNodeMemory( 1 );
+        unsigned int iq = n_quantities_double;
+        for( unsigned int ispec = 0; ispec < species_names_.size(); ispec++ ) {
+            quantities_double[iq++] = ( double )vecPatches.getParticlesMemory( ispec ) / 1073741824.;
+            quantities_double[iq++] = ( double )vecPatches.species_memory_peak_[ispec] / 1073741824.;
+        }
+        for( unsigned int itimer = 0; itimer < timers.counted_timers_.size(); itimer++ ) {
+            vector<double> counts = timers.counted_timers_[itimer]->getCounts();
+            for( unsigned int ievent = 0; ievent < counts.size(); ievent++ ) {
+                quantities_double[iq++] = counts[ievent];
+            }
+        }
         
         // Write doubles to file
         iteration_group.array( "quantities_double", quantities_double[0], &filespace_double, &memspace_double );
         
+        // Warn when the memory of a node is almost exhausted (fraction in use, and rank of the fullest node)
+        const double node_memory = Tools::getNodeMemory( 0 );
+        struct {
+            double value;
+            int rank;
+        } used_local = { node_memory > 0. ? 1. - quantities_double[32] / node_memory : 0., smpi->getRank() }, used = { 0., 0 };
+        MPI_Reduce( &used_local, &used, 1, MPI_DOUBLE_INT, MPI_MAXLOC, 0, smpi->world() );
+        if( memory_warning_ > 0. && used.value > memory_warning_ && ! memory_warned_ ) {
+            WARNING( "DiagPerformances: " << setprecision( 3 ) << 100.*used.value << "% of the memory of the node of process "
+                     << used.rank << " is in use at iteration " << itime << ": the simulation may run out of memory" );
+            memory_warned_ = true;
+        }
+        
         // Patch information
         if( patch_information ) {
         
@@ -284,6 +367,27 @@ void DiagnosticPerformances::run( SmileiMPI *, VectorPatch &vecPatches, int itim
                     // Write patch vectorization status  to file
                     species_group.vect( "vecto", buffer[0], size, H5T_NATIVE_UINT, offset, npoints );
                 }
+                
+                // Wall time of each sampled operator, averaged over the sampled iterations since the last output
+                if( operator_sampling ) {
+                    vector<double> times( number_of_patches );
+                    for( unsigned int iop = 0; iop < Patch::sampled_operators_count; iop++ ) {
+                        for( unsigned int ipatch=0; ipatch < number_of_patches; ipatch++ ) {
+                            Patch *patch = vecPatches( ipatch );
+                            times[ipatch] = patch->operator_samples_ > 0 ?
+                                patch->sampled_operator_times_[ispecies * Patch::sampled_operators_count + iop] / patch->operator_samples_ : 0.;
+                        }
+                        species_group.vect( "timer_" + sampled_operator_names[iop], times[0], size, H5T_NATIVE_DOUBLE, offset, npoints );
+                    }
+                }
+            }
+            
+            // The samples restart after each output
+            if( operator_sampling ) {
+                for( unsigned int ipatch=0; ipatch < number_of_patches; ipatch++ ) {
+                    fill( vecPatches( ipatch )->sampled_operator_times_.begin(), vecPatches( ipatch )->sampled_operator_times_.end(), 0. );
+                    vecPatches( ipatch )->operator_samples_ = 0;
+                }
             }
             
             // Write MPI process the owns the patch
@@ -323,7 +427,7 @@ uint64_t DiagnosticPerformances::getDiskFootPrint( int istart, int istop, Patch
     footprint += ndumps * 2 * 600;
     
     // Add size of each dump
-    footprint += ndumps * ( uint64_t )( mpi_size_ ) * ( uint64_t )( n_quantities_double * sizeof( double ) + n_quantities_uint * sizeof( unsigned int ) );
+    footprint += ndumps * ( uint64_t )( mpi_size_ ) * ( uint64_t )( n_double_ * sizeof( double ) + n_quantities_uint * sizeof( unsigned int ) );
     
     return footprint;
 }
@@ -11,7 +11,7 @@ class DiagnosticPerformances : public Diagnostic
 public :
 
     //! Default constructor
-    DiagnosticPerformances( Params &params, SmileiMPI *smpi );
+    DiagnosticPerformances( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches );
     //! Default destructor
     ~DiagnosticPerformances() override;
     
@@ -45,6 +45,21 @@ private :
     //! MPI rank
     hsize_t mpi_rank_;
     
+    //! Number of double quantities, including the memory of each species and the hardware counters of each counted timer
+    hsize_t n_double_;
+    
+    //! Names of the species, for their memory quantities
+    std::vector<std::string> species_names_;
+    
+    //! Fraction of the memory of the node in use above which a warning is printed (DiagPerformances.memory_warning)
+    double memory_warning_;
+    
+    //! True once the warning has been printed
+    bool memory_warned_;
+    
+    //! Hardware events counted in the timers
+    std::vector<std::string> hardware_counters_;
+    
     //! HDF5 link to the group corresponding to one iteration
     bool has_group;
     std::string group_name;
@@ -65,6 +80,9 @@ private :
     //! Whether to output patch information
     bool patch_information;
     
+    //! Whether the wall time of the particle operators is sampled in each patch (operator_sampling_every)
+    bool operator_sampling;
+    
     //! Number of cells per patch
     unsigned int ncells_per_patch;
     
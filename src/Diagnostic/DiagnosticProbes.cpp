@@ -573,6 +573,7 @@ void DiagnosticProbes::createPoints( SmileiMPI *smpi, VectorPatch &vecPatches, d
         // Initialize the list of "fake" particles (points) just as actual macro-particles
         Particles *particles = &( vecPatches( ipatch )->probes[probe_n]->particles );
         particles->initialize( ntot, nDim_particle, false );
+        vecPatches( ipatch )->probes[probe_n]->stencils.clear();
         // In AM, redefine patchmin as rmin and not -rmax anymore
         if( geometry == "AMcylindrical" ) {
             patchMin[1] = patchMax[1] - patch_length[1];
@@ -631,11 +632,11 @@ void DiagnosticProbes::createPoints( SmileiMPI *smpi, VectorPatch &vecPatches, d
 
     // Calculate the offset of each MPI in the final file
     unsigned int global_offset;
-    MPI_Scan( &nPart_MPI, &global_offset, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD );
+    MPI_Scan( &nPart_MPI, &global_offset, 1, MPI_UNSIGNED, MPI_SUM, smpi->world() );
 
     // Broadcast the global number of points
     nPart_total_actual = global_offset;
-    MPI_Bcast( &nPart_total_actual, 1, MPI_UNSIGNED, smpi->getSize()-1, MPI_COMM_WORLD );
+    MPI_Bcast( &nPart_total_actual, 1, MPI_UNSIGNED, smpi->getSize()-1, smpi->world() );
 
     // For each patch, calculate its global offset
     for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
@@ -740,43 +741,58 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         // Interpolate all usual fields on probe ("fake") particles of current patch
         unsigned int iPart_MPI = offset_in_MPI[ipatch];
         unsigned int maxPart_MPI = offset_in_MPI[ipatch] + npart;
+        
+        // All points at once with the stencils cached since the points were created, when available
+        bool interpolated = false;
+        if( npart > 0 && ! smpi->use_BTIS3 ) {
+            double *loc[10];
+            for( unsigned int k=0; k<10; k++ ) {
+                loc[k] = &( ( *probesArray )( fieldlocation[k], iPart_MPI ) );
+            }
+            interpolated = patch->probesInterp->fieldsAndCurrentsAtPoints(
+                patch->EMfields, patch->probes[probe_n]->particles, patch->probes[probe_n]->stencils, loc
+            );
+        }
+        
+        if( ! interpolated ) {
 #if defined( SMILEI_ACCELERATOR_GPU )
-        smpi->resizeDeviceBuffers( ithread,
-                                   nDim_particle,
-                                   npart );
+            smpi->resizeDeviceBuffers( ithread,
+                                       nDim_particle,
+                                       npart );
 #else
-        smpi->resizeBuffers( ithread, nDim_particle, npart, false );
+            smpi->resizeBuffers( ithread, nDim_particle, npart, false );
 #endif
-
-        for( unsigned int ipart=0; ipart<npart; ipart++ ) {
-            int iparticle( ipart ); // Compatibility
-            int false_idx( 0 );   // Use in classical interp for now, not for probes
-            patch->probesInterp->fieldsAndCurrents(
-                patch->EMfields,
-                patch->probes[probe_n]->particles, smpi,
-                &iparticle, &false_idx, ithread,
-                &Jloc_fields, &Rloc_fields
-            );
-            //! here we fill the probe data!!!
-            ( *probesArray )( fieldlocation[0], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+0*npart];
-            ( *probesArray )( fieldlocation[1], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+1*npart];
-            ( *probesArray )( fieldlocation[2], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+2*npart];
-            ( *probesArray )( fieldlocation[3], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+0*npart];
-            ( *probesArray )( fieldlocation[4], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+1*npart];
-            ( *probesArray )( fieldlocation[5], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+2*npart];
-            if (smpi->use_BTIS3){
-                if (fieldlocation[17] < nFields){
-                    ( *probesArray )( fieldlocation[17], iPart_MPI )=smpi->dynamics_Bpart_yBTIS3[ithread][ipart+0*npart];
-                }
-                if (fieldlocation[18] < nFields){
-                    ( *probesArray )( fieldlocation[18], iPart_MPI )=smpi->dynamics_Bpart_zBTIS3[ithread][ipart+0*npart];
+            
+            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                int iparticle( ipart ); // Compatibility
+                int false_idx( 0 );   // Use in classical interp for now, not for probes
+                patch->probesInterp->fieldsAndCurrents(
+                    patch->EMfields,
+                    patch->probes[probe_n]->particles, smpi,
+                    &iparticle, &false_idx, ithread,
+                    &Jloc_fields, &Rloc_fields
+                );
+                //! here we fill the probe data!!!
+                ( *probesArray )( fieldlocation[0], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+0*npart];
+                ( *probesArray )( fieldlocation[1], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+1*npart];
+                ( *probesArray )( fieldlocation[2], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+2*npart];
+                ( *probesArray )( fieldlocation[3], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+0*npart];
+                ( *probesArray )( fieldlocation[4], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+1*npart];
+                ( *probesArray )( fieldlocation[5], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+2*npart];
+                if (smpi->use_BTIS3){
+                    if (fieldlocation[17] < nFields){
+                        ( *probesArray )( fieldlocation[17], iPart_MPI )=smpi->dynamics_Bpart_yBTIS3[ithread][ipart+0*npart];
+                    }
+                    if (fieldlocation[18] < nFields){
+                        ( *probesArray )( fieldlocation[18], iPart_MPI )=smpi->dynamics_Bpart_zBTIS3[ithread][ipart+0*npart];
+                    }
                 }
+                ( *probesArray )( fieldlocation[6], iPart_MPI )=Jloc_fields.x;
+                ( *probesArray )( fieldlocation[7], iPart_MPI )=Jloc_fields.y;
+                ( *probesArray )( fieldlocation[8], iPart_MPI )=Jloc_fields.z;
+                ( *probesArray )( fieldlocation[9], iPart_MPI )=Rloc_fields;
+                iPart_MPI++;
             }
-            ( *probesArray )( fieldlocation[6], iPart_MPI )=Jloc_fields.x;
-            ( *probesArray )( fieldlocation[7], iPart_MPI )=Jloc_fields.y;
-            ( *probesArray )( fieldlocation[8], iPart_MPI )=Jloc_fields.z;
-            ( *probesArray )( fieldlocation[9], iPart_MPI )=Rloc_fields;
-            iPart_MPI++;
         }
         
         // Calculate Poynting flux on each point if needed
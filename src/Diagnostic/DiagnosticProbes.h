@@ -4,6 +4,7 @@
 #include "Diagnostic.h"
 
 #include "Field2D.h"
+#include "Interpolator.h"
 
 
 class DiagnosticProbes : public Diagnostic
@@ -154,6 +155,8 @@ public :
     Particles particles;
     int offset_in_file;
     std::vector<std::vector<double> > integrated_data;
+    //! Interpolation stencils of the points, reset when the points are created
+    InterpolationStencils stencils;
 };
 
 
@@ -3,7 +3,6 @@
 
 #include "DiagnosticRadiationSpectrum.h"
 #include "HistogramFactory.h"
-#include "RadiationTools.h"
 #include "RadiationTables.h"
 
 
@@ -75,6 +74,29 @@ DiagnosticRadiationSpectrum::DiagnosticRadiationSpectrum(
         delta_energies[i] *= factor;
     }
     
+    // Tabulate f1 and f2 on a logarithmic axis of nu (the last point is slightly
+    // above nu = 10 so that the interpolation never reads beyond the tables)
+    unsigned int table_size = 1024;
+    vector<double> f1( table_size ), f2( table_size );
+    double log10_nu_max = log10( 10. ) + 1e-6;
+    for( unsigned int i=0; i<table_size; i++ ) {
+        double nu = min( pow( 10., -1. + i*( log10_nu_max + 1. )/( table_size-1 ) ), 10. );
+        f1[i] = RadiationTools::computeBesselPartsRadiatedPower( nu, 0. );
+        f2[i] = RadiationTools::computeBesselPartsRadiatedPower( nu, 1. ) - f1[i];
+    }
+    Table *tables[2] = { &f1_table_, &f2_table_ };
+    vector<double> *values[2] = { &f1, &f2 };
+    for( unsigned int itable=0; itable<2; itable++ ) {
+        tables[itable]->name_ = itable==0 ? "f1" : "f2";
+        tables[itable]->set_size( &table_size );
+        tables[itable]->min_ = 0.1;
+        tables[itable]->max_ = pow( 10., log10_nu_max );
+        tables[itable]->compute_parameters();
+        tables[itable]->allocate();
+        tables[itable]->set( *values[itable] );
+        tables[itable]->compact();
+    }
+    
     // Calculate the size of the output array
     uint64_t total_size = (uint64_t)output_size * photon_axis->nbins;
     if( total_size > 2147483648 ) { // 2^31
@@ -182,9 +204,8 @@ void DiagnosticRadiationSpectrum::run( Patch* patch, int, SimWindow* simWindow )
                 zeta = xi / (1.-xi); // xi<1 is ensured above
                 nu   = two_third_ov_chi * zeta;
                 cst  = xi * zeta;
-                increment = increment0 * delta_energies[i] * xi * RadiationTools::computeBesselPartsRadiatedPower(nu,cst);
-                #pragma omp atomic
-                data_sum[ind+i] += increment;
+                increment = increment0 * delta_energies[i] * xi * radiatedPower( nu, cst );
+                deposit( ind+i, increment );
             }
         }
         
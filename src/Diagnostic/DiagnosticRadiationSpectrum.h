@@ -2,6 +2,8 @@
 #define DIAGNOSTICRADIATIONSPECTRUM_H
 
 #include "DiagnosticParticleBinningBase.h"
+#include "RadiationTools.h"
+#include "Table.h"
 
 class DiagnosticRadiationSpectrum : public DiagnosticParticleBinningBase
 {
@@ -46,6 +48,23 @@ private :
     
     //! axis containing the values of the delta on the binned photon_energies
     std::vector<double> delta_energies;
+    
+    //! f1(nu) and f2(nu) of RadiationTools::computeBesselPartsRadiatedPower tabulated
+    //! for 0.1 <= nu < 10, where their fits cost a logarithm and two exponentials
+    Table f1_table_, f2_table_;
+    
+    //! f1(nu) + cst * f2(nu), interpolated in the tables when possible
+    inline double radiatedPower( double nu, double cst )
+    {
+        if( nu < 0.1 || nu >= 10. ) {
+            return RadiationTools::computeBesselPartsRadiatedPower( nu, cst );
+        }
+        double d = ( f1_table_.logarithm( nu ) - f1_table_.log10_min_ )*f1_table_.inv_delta_;
+        int index = int( d );
+        d -= index;
+        return f1_table_.value( index )*( 1.-d ) + f1_table_.value( index+1 )*d
+               + cst*( f2_table_.value( index )*( 1.-d ) + f2_table_.value( index+1 )*d );
+    };
 
 };
 
@@ -11,9 +11,60 @@
 
 using namespace std;
 
+#if !defined( SMILEI_ACCELERATOR_GPU )
+//! Extrema of a field and their cells
+struct FieldExtrema {
+    double min, max;
+    unsigned int cmin[3], cmax[3];
+};
+
+//! Single sweep of the cells [start, end) of a field, contiguous along the last dimension:
+//! sum of the squares (if nrj is not null, in the same order as Field::norm2) and extrema.
+//! Among equal values, an extremum keeps the first cell in the order (k, j, i).
+static void sweepField( Field *field, vector<unsigned int> &start, vector<unsigned int> &end, vector<unsigned int> &size,
+                        double *nrj, FieldExtrema &e )
+{
+    const double *data = field->data();
+    e.min = e.max = data[start[2] + ( start[1] + start[0]*size[1] ) *size[2]];
+    for( unsigned int d=0; d<3; d++ ) {
+        e.cmin[d] = e.cmax[d] = start[d];
+    }
+    double sum = 0.;
+    for( unsigned int i=start[0]; i<end[0]; i++ ) {
+        for( unsigned int j=start[1]; j<end[1]; j++ ) {
+            const double *line = &data[( j + i*size[1] ) *size[2]];
+            for( unsigned int k=start[2]; k<end[2]; k++ ) {
+                const double fieldval = line[k];
+                sum += fieldval * fieldval;
+                if( fieldval < e.min || ( fieldval == e.min
+                    && ( k < e.cmin[2] || ( k == e.cmin[2] && ( j < e.cmin[1] || ( j == e.cmin[1] && i < e.cmin[0] ) ) ) ) ) ) {
+                    e.min = fieldval;
+                    e.cmin[0] = i;
+                    e.cmin[1] = j;
+                    e.cmin[2] = k;
+                }
+                if( fieldval > e.max || ( fieldval == e.max
+                    && ( k < e.cmax[2] || ( k == e.cmax[2] && ( j < e.cmax[1] || ( j == e.cmax[1] && i < e.cmax[0] ) ) ) ) ) ) {
+                    e.max = fieldval;
+                    e.cmax[0] = i;
+                    e.cmax[1] = j;
+                    e.cmax[2] = k;
+                }
+            }
+        }
+    }
+    if( nrj ) {
+        *nrj = sum;
+    }
+}
+#endif
+
 
 DiagnosticScalar::DiagnosticScalar( Params &params, SmileiMPI *, Patch * = NULL ):
-    latest_timestep( -1 )
+    latest_timestep( -1 ),
+    asynchronous_( false ),
+    exact_reduction_( false ),
+    pending_timestep_( -1 )
 {
     
     if( PyTools::nComponents( "DiagScalar" ) > 1 ) {
@@ -31,6 +82,18 @@ DiagnosticScalar::DiagnosticScalar( Params &params, SmileiMPI *, Patch * = NULL
         precision = 10;
         PyTools::extract( "precision", precision, "DiagScalar"  );
         PyTools::extractV( "vars", vars, "DiagScalar" );
+        PyTools::extract( "asynchronous", asynchronous_, "DiagScalar"  );
+#if MPI_VERSION < 3
+        if( asynchronous_ ) {
+            ERROR( "DiagScalar.asynchronous requires an MPI-3 library" );
+        }
+#endif
+        string reduction = "atomic";
+        PyTools::extract( "reduction", reduction, "DiagScalar"  );
+        if( reduction != "atomic" && reduction != "exact" ) {
+            ERROR( "DiagScalar.reduction must be \"atomic\" or \"exact\"" );
+        }
+        exact_reduction_ = ( reduction == "exact" );
         
         // copy from params remaining stuff
         res_time       = params.res_time;
@@ -91,8 +154,11 @@ Scalar_value *DiagnosticScalar::newScalar_SUM( string name )
 {
     bool allow = allowedKey( name );
     unsigned int width = calculateWidth( name );
-    Scalar_value *scalar = new Scalar_value( name, width, allow, &values_SUM );
+    Scalar_value *scalar = new Scalar_value( name, width, allow, &values_SUM, exact_reduction_ ? &exact_SUM_ : nullptr );
     values_SUM.push_back( 0. );
+    if( exact_reduction_ ) {
+        exact_SUM_.push_back( ExactSum() );
+    }
     allScalars.push_back( scalar );
     return scalar;
 }
@@ -193,6 +259,8 @@ void DiagnosticScalar::init( Params &params, SmileiMPI *, VectorPatch &vecPatche
                                        || allowedKey( Tools::merge( "Zavg_", species_name ) )
                                        || allowedKey( Tools::merge( "Ukin_", species_name ) )
                                        || allowedKey( Tools::merge( "Urad_", species_name ) )
+                                       || allowedKey( Tools::merge( "Nmrg_", species_name ) )
+                                       || allowedKey( Tools::merge( "Nspl_", species_name ) )
                                        || allowedKey( "UmBWpairs" );
         }
     }
@@ -268,6 +336,8 @@ void DiagnosticScalar::init( Params &params, SmileiMPI *, VectorPatch &vecPatche
     sZavg.resize( nspec, NULL );
     sUkin.resize( nspec, NULL );
     sUrad.resize( nspec, NULL );
+    sNmrg.resize( nspec, NULL );
+    sNspl.resize( nspec, NULL );
     for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
         if( ! vecPatches( 0 )->vecSpecies[ispec]->particles->is_test ) {
             species_name = vecPatches( 0 )->vecSpecies[ispec]->name_;
@@ -276,6 +346,12 @@ void DiagnosticScalar::init( Params &params, SmileiMPI *, VectorPatch &vecPatche
             sZavg[ispec] = newScalar_SUM( Tools::merge( "Zavg_", species_name ) );
             sUkin[ispec] = newScalar_SUM( Tools::merge( "Ukin_", species_name ) );
             sUrad[ispec] = newScalar_SUM( Tools::merge( "Urad_", species_name ) );
+            if( vecPatches( 0 )->vecSpecies[ispec]->has_merging_ ) {
+                sNmrg[ispec] = newScalar_SUM( Tools::merge( "Nmrg_", species_name ) );
+            }
+            if( vecPatches( 0 )->vecSpecies[ispec]->has_splitting_ ) {
+                sNspl[ispec] = newScalar_SUM( Tools::merge( "Nspl_", species_name ) );
+            }
         }
     }
     
@@ -348,6 +424,11 @@ void DiagnosticScalar::run( Patch *patch, int itime, SimWindow * )
 
 void DiagnosticScalar::write( int itime, SmileiMPI *smpi )
 {
+    // Written when the asynchronous reductions complete (SmileiMPI::finalizeGlobalDiags)
+    if( pending_timestep_ >= 0 ) {
+        return;
+    }
+    
     if( smpi->isMaster() ) {
     
         if( timeSelection->theTimeIsNow( itime ) && itime>latest_timestep ) {
@@ -446,52 +527,27 @@ void DiagnosticScalar::compute( Patch *patch, int )
 
             if( vecSpecies[ispec]->mass_ > 0 ) {
 
-// GPU mode
+// GPU mode: a single pass for the 3 sums
 #ifdef SMILEI_ACCELERATOR_GPU
 
 #if defined( SMILEI_ACCELERATOR_GPU_OMP )
     #pragma omp target teams distribute parallel for \
-		      map(tofrom: density)  \
-		      is_device_ptr(weight_ptr) \
-		      reduction(+:density) 
-#elif defined( SMILEI_ACCELERATOR_GPU_OACC )
-    #pragma acc parallel deviceptr(weight_ptr)
-    #pragma acc loop gang worker vector reduction(+:density) 
-#endif
-                for( unsigned int iPart=0 ; iPart<nPart; iPart++ ) {
-                    density  += weight_ptr[iPart];
-                }
-
-#if defined( SMILEI_ACCELERATOR_GPU_OMP )
-    #pragma omp target \
-                      teams distribute parallel for \
-		      map(tofrom: charge)  \
-		      is_device_ptr( charge_ptr, weight_ptr) \
-                      reduction(+:charge)  
-#elif defined( SMILEI_ACCELERATOR_GPU_OACC )
-    #pragma acc parallel deviceptr(weight_ptr, charge_ptr)
-    #pragma acc loop gang worker vector reduction(+:charge)
-#endif
-                for( unsigned int iPart=0 ; iPart<nPart; iPart++ ) {
-                    charge   += weight_ptr[iPart] * charge_ptr[iPart];
-                }
-
-#if defined( SMILEI_ACCELERATOR_GPU_OMP )
-    #pragma omp target teams distribute parallel for \
-		      map(tofrom: ener_tot)  \
-		      is_device_ptr(weight_ptr, \
+		      map(tofrom: density, charge, ener_tot)  \
+		      is_device_ptr(weight_ptr, charge_ptr, \
                       momentum_x /* [istart:particle_number] */,             \
                       momentum_y /* [istart:particle_number] */,             \
                       momentum_z /* [istart:particle_number] */)             \
-                      reduction(+:ener_tot) 
+                      reduction(+:density, charge, ener_tot) 
 #elif defined(SMILEI_ACCELERATOR_GPU_OACC)
-    #pragma acc parallel deviceptr(weight_ptr, \
+    #pragma acc parallel deviceptr(weight_ptr, charge_ptr, \
                   momentum_x,                                           \
                   momentum_y,                                           \
                   momentum_z)
-    #pragma acc loop gang worker vector reduction(+:ener_tot)
+    #pragma acc loop gang worker vector reduction(+:density, charge, ener_tot)
 #endif
                 for( unsigned int iPart=0 ; iPart<nPart; iPart++ ) {
+                    density  += weight_ptr[iPart];
+                    charge   += weight_ptr[iPart] * charge_ptr[iPart];
                     const double gamma = std::sqrt(1 + momentum_x[iPart]*momentum_x[iPart] 
                                                      + momentum_y[iPart]*momentum_y[iPart]
                                                      + momentum_z[iPart]*momentum_z[iPart]);
@@ -524,38 +580,26 @@ void DiagnosticScalar::compute( Patch *patch, int )
 	        //          << " " << charge << std::endl;
             } else if( vecSpecies[ispec]->mass_ == 0 ) {
 
-// GPU mode
+// GPU mode: a single pass for the 2 sums
 #ifdef SMILEI_ACCELERATOR_GPU
 
 #if defined( SMILEI_ACCELERATOR_GPU_OMP )
     #pragma omp target teams distribute parallel for \
-		      map(tofrom: density)  \
-		      is_device_ptr(weight_ptr) \
-		      reduction(+:density) 
-#elif defined( SMILEI_ACCELERATOR_GPU_OACC )
-    #pragma acc parallel deviceptr(weight_ptr)
-    #pragma acc loop gang worker vector reduction(+:density) 
-#endif
-                for( unsigned int iPart=0 ; iPart<nPart; iPart++ ) {
-                    density  += weight_ptr[iPart];
-                }
-
-#if defined( SMILEI_ACCELERATOR_GPU_OMP )
-    #pragma omp target teams distribute parallel for \
-		      map(tofrom: ener_tot)  \
+		      map(tofrom: density, ener_tot)  \
 		      is_device_ptr(weight_ptr, \
                       momentum_x /* [istart:particle_number] */,             \
                       momentum_y /* [istart:particle_number] */,             \
                       momentum_z /* [istart:particle_number] */)             \
-                      reduction(+:ener_tot) 
+                      reduction(+:density, ener_tot) 
 #elif defined(SMILEI_ACCELERATOR_GPU_OACC)
     #pragma acc parallel deviceptr(weight_ptr, \
                   momentum_x,                                           \
                   momentum_y,                                           \
                   momentum_z)
-    #pragma acc loop gang worker vector reduction(+:ener_tot)
+    #pragma acc loop gang worker vector reduction(+:density, ener_tot)
 #endif
                 for( unsigned int iPart=0 ; iPart<nPart; iPart++ ) {
+                    density  += weight_ptr[iPart];
                     const double gamma = std::sqrt( momentum_x[iPart]*momentum_x[iPart]  
                                                     + momentum_y[iPart]*momentum_y[iPart]
                                                     + momentum_z[iPart]*momentum_z[iPart]);
@@ -569,10 +613,10 @@ void DiagnosticScalar::compute( Patch *patch, int )
                 #pragma omp simd reduction(+:density) \
                                 reduction(+:ener_tot)
                 for( unsigned int iPart=0 ; iPart<nPart; iPart++ ) {
-                
                     density  += weight_ptr[iPart];
-                    ener_tot += vecSpecies[ispec]->particles->weight( iPart )
-                                * ( vecSpecies[ispec]->particles->momentumNorm( iPart ) );
+                    ener_tot += weight_ptr[iPart] * std::sqrt( momentum_x[iPart]*momentum_x[iPart]
+                                                             + momentum_y[iPart]*momentum_y[iPart]
+                                                             + momentum_z[iPart]*momentum_z[iPart] );
                 }
 #endif
 
@@ -591,6 +635,16 @@ void DiagnosticScalar::compute( Patch *patch, int )
                 *sUrad[ispec] += vecSpecies[ispec]->nrj_radiated_;
                 Urad_         += vecSpecies[ispec]->nrj_radiated_;
             }
+
+            // If merging activated
+            if( vecSpecies[ispec]->has_merging_ ) {
+                *sNmrg[ispec] += ( double )vecSpecies[ispec]->merged_particles_;
+            }
+
+            // If splitting activated
+            if( vecSpecies[ispec]->has_splitting_ ) {
+                *sNspl[ispec] += ( double )vecSpecies[ispec]->split_particles_;
+            }
             
             // If multiphoton Breit-Wheeler activated for photons
             // increment the total pair energy from this process
@@ -657,6 +711,25 @@ void DiagnosticScalar::compute( Patch *patch, int )
     
     double Uelm_ = 0.0; // total electromagnetic energy in the fields
 
+    // Cells of a field where the scalars are calculated
+    vector<unsigned int> iFieldStart( 3 ), iFieldEnd( 3 ), iFieldGlobalSize( 3 );
+    auto fieldCells = [&]( Field *field ) {
+        for( unsigned int i=0 ; i<3 ; i++ ) {
+            iFieldStart[i] = 0;
+            iFieldEnd[i] = 1;
+            iFieldGlobalSize[i] = 1;
+        }
+        for( unsigned int i=0 ; i<field->isDual_.size() ; i++ ) {
+            iFieldStart[i] = EMfields->istart[i][field->isDual( i )];
+            iFieldEnd [i] = iFieldStart[i] + EMfields->bufsize[i][field->isDual( i )];
+            iFieldGlobalSize [i] = field->dims_[i];
+        }
+    };
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    // Extrema of the fields found in the same sweep as their energy
+    vector<FieldExtrema> extrema( fields.size() );
+    vector<bool> has_extrema( fields.size(), false );
+#endif
 
     // loop on all electromagnetic fields
     unsigned int nfield = fields.size();
@@ -670,7 +743,13 @@ void DiagnosticScalar::compute( Patch *patch, int )
 #if defined( SMILEI_ACCELERATOR_GPU )
                 Uem = field->norm2OnDevice( EMfields->istart, EMfields->bufsize );
 #else
-                Uem = field->norm2( EMfields->istart, EMfields->bufsize );
+                if( necessary_fieldMinMax[ifield] ) {
+                    fieldCells( field );
+                    sweepField( field, iFieldStart, iFieldEnd, iFieldGlobalSize, &Uem, extrema[ifield] );
+                    has_extrema[ifield] = true;
+                } else {
+                    Uem = field->norm2( EMfields->istart, EMfields->bufsize );
+                }
 #endif
             } else {
                 Uem = 0.5 * AMfields->dr * dynamic_cast<cField2D*>( field )->norm2_cylindrical( AMfields->istart, AMfields->bufsize, AMfields->j_glob_ );
@@ -723,6 +802,10 @@ void DiagnosticScalar::compute( Patch *patch, int )
     val_index minloc, maxloc;
     
     nfield = fields.size();
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    extrema.resize( nfield );
+    has_extrema.resize( nfield, false );
+#endif
 
     // if AM, scalar on fields not managed
     if( AM ){
@@ -735,12 +818,7 @@ void DiagnosticScalar::compute( Patch *patch, int )
         
             Field *field = fields[ifield];
             
-            vector<unsigned int> iFieldStart( 3, 0 ), iFieldEnd( 3, 1 ), iFieldGlobalSize( 3, 1 );
-            for( unsigned int i=0 ; i<field->isDual_.size() ; i++ ) {
-                iFieldStart[i] = EMfields->istart[i][field->isDual( i )];
-                iFieldEnd [i] = iFieldStart[i] + EMfields->bufsize[i][field->isDual( i )];
-                iFieldGlobalSize [i] = field->dims_[i];
-            }
+            fieldCells( field );
             
             unsigned int iifield= iFieldStart[2] + iFieldStart[1]*iFieldGlobalSize[2] +iFieldStart[0]*iFieldGlobalSize[1]*iFieldGlobalSize[2];
             minloc.val = maxloc.val = ( *field )( iifield );
@@ -772,7 +850,7 @@ void DiagnosticScalar::compute( Patch *patch, int )
 	    //std::atomic<double> minval_a = {minval};
 #if defined( SMILEI_ACCELERATOR_GPU_OMP )
     #pragma omp target \
-                teams distribute parallel for collpase(3) \
+                teams distribute parallel for collapse(3) \
 		        map(tofrom: minval, maxval, i_min, i_max, j_min, j_max, k_min, k_max)  \
                 map(to: ny, nz, ixstart, ixend, iystart, iyend, izstart, izend) 
 	        //reduction(min:minval)
@@ -814,26 +892,17 @@ void DiagnosticScalar::compute( Patch *patch, int )
 	    maxloc.val = maxval;
 // CPU version
 #else
-            for( unsigned int k=iFieldStart[2]; k<iFieldEnd[2]; k++ ) {
-                for( unsigned int j=iFieldStart[1]; j<iFieldEnd[1]; j++ ) {
-                    for( unsigned int i=iFieldStart[0]; i<iFieldEnd[0]; i++ ) {
-                        const unsigned int ii = k+ ( j + i*iFieldGlobalSize[1] ) *iFieldGlobalSize[2];
-                        const double fieldval = ( *field )( ii );
-                        if( minloc.val > fieldval ) {
-                            minloc.val = fieldval;
-                            i_min=i;
-                            j_min=j;
-                            k_min=k;
-                        }
-                        if( maxloc.val < fieldval ) {
-                            maxloc.val = fieldval;
-                            i_max=i;
-                            j_max=j;
-                            k_max=k;
-                        }
-                    }
-                }
+            if( ! has_extrema[ifield] ) {
+                sweepField( field, iFieldStart, iFieldEnd, iFieldGlobalSize, NULL, extrema[ifield] );
             }
+            minloc.val = extrema[ifield].min;
+            maxloc.val = extrema[ifield].max;
+            i_min = extrema[ifield].cmin[0];
+            j_min = extrema[ifield].cmin[1];
+            k_min = extrema[ifield].cmin[2];
+            i_max = extrema[ifield].cmax[0];
+            j_max = extrema[ifield].cmax[1];
+            k_max = extrema[ifield].cmax[2];
 
 #endif    
 
@@ -849,12 +918,15 @@ void DiagnosticScalar::compute( Patch *patch, int )
             k_max += Pcoordinates[2]*patch_size_[2] - iFieldStart[2];
             maxloc.index = ( int )( i_max*global_size_[1]*global_size_[2] + j_max*global_size_[2] + k_max );
             
+            // Among equal values, the smallest location is kept whatever the order of the patches
             #pragma omp critical
             {
-                if( minloc.val < ( double )*fieldMin[ifield] ) {
+                if( minloc.val < ( double )*fieldMin[ifield]
+                    || ( minloc.val == ( double )*fieldMin[ifield] && minloc.index < ( int )*fieldMin[ifield] ) ) {
                     *fieldMin[ifield] = minloc;
                 }
-                if( maxloc.val > ( double )*fieldMax[ifield] ) {
+                if( maxloc.val > ( double )*fieldMax[ifield]
+                    || ( maxloc.val == ( double )*fieldMax[ifield] && maxloc.index < ( int )*fieldMax[ifield] ) ) {
                     *fieldMax[ifield] = maxloc;
                 }
             }
@@ -951,6 +1023,12 @@ uint64_t DiagnosticScalar::getDiskFootPrint( int istart, int istop, Patch *patch
             scalars.push_back( Tools::merge( "Zavg_", species_name ) );
             scalars.push_back( Tools::merge( "Ukin_", species_name ) );
             scalars.push_back( Tools::merge( "Urad_", species_name ) );
+            if( patch->vecSpecies[ispec]->has_merging_ ) {
+                scalars.push_back( Tools::merge( "Nmrg_", species_name ) );
+            }
+            if( patch->vecSpecies[ispec]->has_splitting_ ) {
+                scalars.push_back( Tools::merge( "Nspl_", species_name ) );
+            }
         }
     }
     // 3 - Field scalars
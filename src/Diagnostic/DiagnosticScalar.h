@@ -4,6 +4,7 @@
 #include <fstream>
 
 #include "Diagnostic.h"
+#include "ExactSum.h"
 
 class Patch;
 class Params;
@@ -41,8 +42,8 @@ public:
 class Scalar_value : public Scalar
 {
 public:
-    Scalar_value( std::string name, unsigned int width, bool allowed, std::vector<double> *values ):
-        Scalar( name, "", width, allowed ), values_( values ), index( values->size() )
+    Scalar_value( std::string name, unsigned int width, bool allowed, std::vector<double> *values, std::vector<ExactSum> *exact = nullptr ):
+        Scalar( name, "", width, allowed ), values_( values ), exact_( exact ), index( values->size() )
     {};
     ~Scalar_value() {};
     inline Scalar_value &operator= ( double v )
@@ -52,8 +53,12 @@ public:
     };
     inline Scalar_value &operator+= ( double v )
     {
-        #pragma omp atomic
-        ( *values_ )[index]+=v;
+        if( exact_ ) {
+            ( *exact_ )[index].addAtomic( v );
+        } else {
+            #pragma omp atomic
+            ( *values_ )[index]+=v;
+        }
         return *this;
     };
     inline operator double() const override
@@ -63,8 +68,13 @@ public:
     inline void reset() override
     {
         ( *values_ )[index]=0.;
+        if( exact_ ) {
+            ( *exact_ )[index].reset();
+        }
     };
     std::vector<double> *values_;
+    //! Exact sums of the contributions, when the reduction is exact (copied to values_ after the MPI reduction)
+    std::vector<ExactSum> *exact_;
     unsigned int index;
 };
 
@@ -140,6 +150,21 @@ public :
     //! Latest timestep dumped
     int latest_timestep;
     
+    //! Reductions posted by MPI_Ireduce and completed at the next iteration (DiagScalar.asynchronous)
+    bool asynchronous_;
+    
+    //! Sums independent of the order of the contributions, hence of the numbers of threads and processes (DiagScalar.reduction = "exact")
+    bool exact_reduction_;
+    
+    //! Timestep of the reductions in flight (-1 if none)
+    int pending_timestep_;
+    
+    //! Scalars are cheap and often needed at the exact iterations
+    bool delayable() override
+    {
+        return false;
+    };
+    
     //! Get memory footprint of current diagnostic
     int getMemFootPrint() override
     {
@@ -179,6 +204,16 @@ private :
     //! List of scalar values to be MAXLOCed by MPI
     std::vector<val_index> values_MAXLOC;
     
+    //! Exact sums of the values_SUM, when the reduction is exact (empty otherwise)
+    std::vector<ExactSum> exact_SUM_;
+    
+    //! Copies of the values reduced asynchronously, and the requests of their reductions
+    std::vector<double> pending_SUM_;
+    std::vector<ExactSum> pending_exact_SUM_;
+    std::vector<val_index> pending_MINLOC_;
+    std::vector<val_index> pending_MAXLOC_;
+    MPI_Request pending_requests_[3];
+    
     //! Volume of a cell (copied from params)
     double cell_volume;
     
@@ -209,6 +244,10 @@ private :
     std::vector<Scalar_value *> sDens, sNtot, sZavg, sUkin, fieldUelm;
     // For the radiated energy per species
     std::vector<Scalar_value *> sUrad;
+    // For the number of macro-particles removed by the last merging per species
+    std::vector<Scalar_value *> sNmrg;
+    // For the number of macro-particles created by the last splitting per species
+    std::vector<Scalar_value *> sNspl;
     std::vector<Scalar_value_location *> fieldMin, fieldMax;
     std::vector<Scalar_value *> poy, poyInst;
     
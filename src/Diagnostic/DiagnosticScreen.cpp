@@ -1,5 +1,6 @@
 #include "PyTools.h"
 #include <iomanip>
+#include <omp.h>
 
 #include "DiagnosticScreen.h"
 #include "HistogramFactory.h"
@@ -104,6 +105,11 @@ DiagnosticScreen::DiagnosticScreen(
         ERROR( errorPrefix << ": parameter `direction` not understood" );
     }
     
+    // The screens keep their sums between the outputs, in the checkpoints
+    if( reduction_ == REDUCTION_EXACT ) {
+        ERROR( errorPrefix << ": `reduction = \"exact\"` is not available for screens" );
+    }
+    
     // If axes are "a", "b", "theta" or "phi", they need some coefficients
     unsigned int idim;
     for( unsigned int i=0; i<histogram->axes.size(); i++ ) {
@@ -150,7 +156,18 @@ DiagnosticScreen::DiagnosticScreen(
         }
     }
     
-    data_sum.resize( output_size, 0. );
+    if( ! sparse_storage_ ) {
+        data_sum.resize( output_size, 0. );
+    }
+    
+#ifdef _OPENMP
+    unsigned int max_threads = omp_get_max_threads();
+#else
+    unsigned int max_threads = 1;
+#endif
+    thread_int_buffer_   .resize( max_threads );
+    thread_double_buffer_.resize( max_threads );
+    thread_opposite_     .resize( max_threads );
     
 } // END DiagnosticScreen::DiagnosticScreen
 
@@ -217,12 +234,22 @@ void DiagnosticScreen::run( Patch *patch, int, SimWindow *simWindow )
         species.push_back( s );
         npart_total += s->getNbrOfParticles();
     }
-    vector<int> int_buffer( npart_total, 0 );
-    vector<double> double_buffer( npart_total );
-    bool opposite[npart_total]; // cannot use vector<bool>
-    for( unsigned int i=0; i<npart_total; i++ ) {
-        opposite[i] = false;
+    // The buffers of each thread are reused between patches and iterations
+    int ithread = Tools::getOMPThreadNum();
+    vector<int> &int_buffer = thread_int_buffer_[ithread];
+    vector<double> &double_buffer = thread_double_buffer_[ithread];
+    vector<char> &opposite = thread_opposite_[ithread]; // cannot use vector<bool>
+    int_buffer.assign( npart_total, -1 );
+    double_buffer.resize( npart_total );
+    opposite.assign( npart_total, 0 );
+    
+    // Copy the screen parameters for the vectorized loops
+    double point[3] = { 0., 0., 0. }, unitvector[3] = { 0., 0., 0. };
+    for( unsigned int idim=0; idim<ndim; idim++ ) {
+        point[idim] = screen_point[idim];
+        unitvector[idim] = screen_unitvector[idim];
     }
+    double r2 = screen_vectornorm * screen_vectornorm;
     
     // loop species & find crossing particles
     unsigned int nuseful = 0;
@@ -230,78 +257,88 @@ void DiagnosticScreen::run( Patch *patch, int, SimWindow *simWindow )
     for( unsigned int ispec=0 ; ispec < species_indices.size() ; ispec++ ) {
     
         Species *s = patch->vecSpecies[species_indices[ispec]];
+        Particles *particles = s->particles;
         unsigned int npart = s->getNbrOfParticles();
         int *index = &int_buffer[istart];
-        bool *opp = &opposite[istart];
-       
-        // Fill the int_buffer with -1 (not crossing screen) and 0 (crossing screen)
-        if( screen_type == 0 ) { // plane
-            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
-                double side = 0.;
-                double side_old = 0.;
-                double dtg = dt / s->particles->LorentzFactor( ipart );
-                for( unsigned int idim=0; idim<ndim; idim++ ) {
-                    side += ( s->particles->Position[idim][ipart] - screen_point[idim] ) * screen_unitvector[idim];
-                    side_old += ( s->particles->Position[idim][ipart] - dtg*( s->particles->Momentum[idim][ipart] ) - screen_point[idim] ) * screen_unitvector[idim];
-                }
-                if( side*side_old < 0. ) {
-                    index[ipart] = 0;
-                    nuseful++;
-                    if( side < 0. ) {
-                        opp[ipart] = true;
-                    }
-                } else {
-                    index[ipart] = -1;
-                }
+        char *opp = &opposite[istart];
+        const double *position[3];
+        for( unsigned int idim=0; idim<ndim; idim++ ) {
+            position[idim] = particles->Position[idim].data();
+        }
+        const double *px = particles->Momentum[0].data();
+        const double *py = particles->Momentum[1].data();
+        const double *pz = particles->Momentum[2].data();
+        
+        // Only test the bins whose particles may have reached the screen
+        unsigned int nbins = max( particles->numberOfBins(), 1u );
+        for( unsigned int ibin=0; ibin<nbins; ibin++ ) {
+            int first = particles->numberOfBins() > 0 ? particles->first_index[ibin] : 0;
+            int last  = particles->numberOfBins() > 0 ? particles->last_index [ibin] : npart;
+            if( last <= first || ! binMayCross( particles, first, last ) ) {
+                continue;
             }
-        } else if( screen_type == 1 ) { // sphere
-            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
-                double side = 0.;
-                double side_old = 0.;
-                double dtg = dt / s->particles->LorentzFactor( ipart );
-                for( unsigned int idim=0; idim<ndim; idim++ ) {
-                    side += ( s->particles->Position[idim][ipart] - screen_point[idim] ) * ( s->particles->Position[idim][ipart] - screen_point[idim] );
-                    side_old += ( s->particles->Position[idim][ipart] - dtg*( s->particles->Momentum[idim][ipart] ) - screen_point[idim] ) * 
-                                ( s->particles->Position[idim][ipart] - dtg*( s->particles->Momentum[idim][ipart] ) - screen_point[idim] ) ;
-                }
-                side     = screen_vectornorm-sqrt( side );
-                side_old = screen_vectornorm-sqrt( side_old );
-                if( side*side_old < 0. ) {
-                    index[ipart] = 0;
-                    nuseful++;
-                    if( side > 0. ) {
-                        opp[ipart] = true;
+            
+            // Set index to 0 (crossing screen) or -1 (not crossing screen)
+            if( screen_type == 0 ) { // plane
+                #pragma omp simd reduction(+:nuseful)
+                for( int ipart=first; ipart<last; ipart++ ) {
+                    double dtg = dt / sqrt( 1. + px[ipart]*px[ipart] + py[ipart]*py[ipart] + pz[ipart]*pz[ipart] );
+                    double p[3] = { px[ipart], py[ipart], pz[ipart] };
+                    double side = 0.;
+                    double side_old = 0.;
+                    for( unsigned int idim=0; idim<ndim; idim++ ) {
+                        side += ( position[idim][ipart] - point[idim] ) * unitvector[idim];
+                        side_old += ( position[idim][ipart] - dtg*p[idim] - point[idim] ) * unitvector[idim];
                     }
-                } else {
-                    index[ipart] = -1;
+                    bool crossing = side*side_old < 0.;
+                    index[ipart] = crossing ? 0 : -1;
+                    opp[ipart] = crossing && side < 0.;
+                    nuseful += crossing;
                 }
-            }
-        } else { // cylinder
-            double r2 = screen_vectornorm * screen_vectornorm;
-            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
-                double side = 0.;
-                double side_old = 0.;
-                double dtg = dt / s->particles->LorentzFactor( ipart );
-                for( unsigned int idim=0; idim<ndim; idim++ ) {
-                    double u1 = s->particles->Position[(idim+1)%ndim][ipart] - screen_point[(idim+1)%ndim];
-                    double u2 = s->particles->Position[(idim+2)%ndim][ipart] - screen_point[(idim+2)%ndim];
-                    side += ( u1 * screen_unitvector[(idim+2)%ndim] - u2 * screen_unitvector[(idim+1)%ndim] ) * 
-                            ( u1 * screen_unitvector[(idim+2)%ndim] - u2 * screen_unitvector[(idim+1)%ndim] );
-                    u1 -= dtg * s->particles->Momentum[(idim+1)%ndim][ipart];
-                    u2 -= dtg * s->particles->Momentum[(idim+1)%ndim][ipart];
-                    side_old += ( u1 * screen_unitvector[(idim+2)%ndim] - u2 * screen_unitvector[(idim+1)%ndim] ) *
-                                ( u1 * screen_unitvector[(idim+2)%ndim] - u2 * screen_unitvector[(idim+1)%ndim] );
+            } else if( screen_type == 1 ) { // sphere
+                #pragma omp simd reduction(+:nuseful)
+                for( int ipart=first; ipart<last; ipart++ ) {
+                    double dtg = dt / sqrt( 1. + px[ipart]*px[ipart] + py[ipart]*py[ipart] + pz[ipart]*pz[ipart] );
+                    double p[3] = { px[ipart], py[ipart], pz[ipart] };
+                    double side = 0.;
+                    double side_old = 0.;
+                    for( unsigned int idim=0; idim<ndim; idim++ ) {
+                        double u = position[idim][ipart] - point[idim];
+                        side += u * u;
+                        u -= dtg * p[idim];
+                        side_old += u * u;
+                    }
+                    side     = r2 - side;
+                    side_old = r2 - side_old;
+                    bool crossing = side*side_old < 0.;
+                    index[ipart] = crossing ? 0 : -1;
+                    opp[ipart] = crossing && side > 0.;
+                    nuseful += crossing;
                 }
-                side     = r2 - side;
-                side_old = r2 - side_old;
-                if( side*side_old < 0. ) {
-                    index[ipart] = 0;
-                    nuseful++;
-                    if( side > 0. ) {
-                        opp[ipart] = true;
+            } else { // cylinder
+                #pragma omp simd reduction(+:nuseful)
+                for( int ipart=first; ipart<last; ipart++ ) {
+                    double dtg = dt / sqrt( 1. + px[ipart]*px[ipart] + py[ipart]*py[ipart] + pz[ipart]*pz[ipart] );
+                    double p[3] = { px[ipart], py[ipart], pz[ipart] };
+                    double side = 0.;
+                    double side_old = 0.;
+                    for( unsigned int idim=0; idim<ndim; idim++ ) {
+                        unsigned int i1 = ( idim+1 )%ndim, i2 = ( idim+2 )%ndim;
+                        double u1 = position[i1][ipart] - point[i1];
+                        double u2 = position[i2][ipart] - point[i2];
+                        double c = u1 * unitvector[i2] - u2 * unitvector[i1];
+                        side += c * c;
+                        u1 -= dtg * p[i1];
+                        u2 -= dtg * p[i2];
+                        c = u1 * unitvector[i2] - u2 * unitvector[i1];
+                        side_old += c * c;
                     }
-                } else {
-                    index[ipart] = -1;
+                    side     = r2 - side;
+                    side_old = r2 - side_old;
+                    bool crossing = side*side_old < 0.;
+                    index[ipart] = crossing ? 0 : -1;
+                    opp[ipart] = crossing && side > 0.;
+                    nuseful += crossing;
                 }
             }
         }
@@ -336,16 +373,86 @@ void DiagnosticScreen::run( Patch *patch, int, SimWindow *simWindow )
         }
     }
     
-    histogram->distribute( double_buffer, int_buffer, data_sum );
+    distribute( double_buffer, int_buffer );
     
 } // END run
 
+// True if the particles first to last may have crossed the screen during the last timestep:
+// their bounding box, extended by the largest displacement dt (c=1), must intersect the screen
+bool DiagnosticScreen::binMayCross( Particles *particles, int first, int last )
+{
+    unsigned int ndim = screen_point.size();
+    double center[3], half[3];
+    for( unsigned int idim=0; idim<ndim; idim++ ) {
+        const double *x = particles->Position[idim].data();
+        double xmin = x[first], xmax = x[first];
+        #pragma omp simd reduction(min:xmin) reduction(max:xmax)
+        for( int ipart=first+1; ipart<last; ipart++ ) {
+            xmin = min( xmin, x[ipart] );
+            xmax = max( xmax, x[ipart] );
+        }
+        center[idim] = 0.5*( xmin + xmax ) - screen_point[idim];
+        half  [idim] = 0.5*( xmax - xmin ) + dt;
+    }
+    
+    if( screen_type == 0 ) { // plane
+        double distance_to_plane = 0., extent = 0.;
+        for( unsigned int idim=0; idim<ndim; idim++ ) {
+            distance_to_plane += center[idim] * screen_unitvector[idim];
+            extent += half[idim] * abs( screen_unitvector[idim] );
+        }
+        return abs( distance_to_plane ) <= extent;
+    } else if( screen_type == 1 ) { // sphere
+        double dmin2 = 0., dmax2 = 0.;
+        for( unsigned int idim=0; idim<ndim; idim++ ) {
+            double dmin = max( abs( center[idim] ) - half[idim], 0. );
+            double dmax = abs( center[idim] ) + half[idim];
+            dmin2 += dmin * dmin;
+            dmax2 += dmax * dmax;
+        }
+        double r2 = screen_vectornorm * screen_vectornorm;
+        return dmin2 <= r2 && r2 <= dmax2;
+    } else { // cylinder: sphere enclosing the box
+        double distance_to_axis = 0., radius = 0.;
+        for( unsigned int idim=0; idim<ndim; idim++ ) {
+            double c = center[( idim+1 )%ndim] * screen_unitvector[( idim+2 )%ndim]
+                     - center[( idim+2 )%ndim] * screen_unitvector[( idim+1 )%ndim];
+            distance_to_axis += c * c;
+            radius += half[idim] * half[idim];
+        }
+        return abs( screen_vectornorm - sqrt( distance_to_axis ) ) <= sqrt( radius );
+    }
+}
+
 bool DiagnosticScreen::writeNow( int itime ) {
     return timeSelection->theTimeIsNow( itime );
 }
 
+void DiagnosticScreen::getSparseData( vector<unsigned int> &indices, vector<double> &values )
+{
+    vector<pair<int, double> > bins( sparse_sum_.begin(), sparse_sum_.end() );
+    sort( bins.begin(), bins.end() );
+    indices.resize( bins.size() );
+    values.resize( bins.size() );
+    for( size_t i=0; i<bins.size(); i++ ) {
+        indices[i] = bins[i].first;
+        values[i] = bins[i].second;
+    }
+}
+
+void DiagnosticScreen::setSparseData( vector<unsigned int> &indices, vector<double> &values )
+{
+    sparse_sum_.clear();
+    for( size_t i=0; i<indices.size(); i++ ) {
+        sparse_sum_[indices[i]] = values[i];
+    }
+}
+
 //! Zero the array
 void DiagnosticScreen::clear()
 {
     fill( data_sum.begin(), data_sum.end(), 0. );
+    sparse_sum_.clear();
+    sparse_indices_.clear();
+    sparse_values_.clear();
 }
@@ -45,6 +45,17 @@ public :
         return &data_sum;
     }
     
+    //! True if only the non-empty bins are stored
+    bool sparse() {
+        return sparse_storage_;
+    }
+    
+    //! Copy of the non-empty bins sorted by index, for the checkpoints of sparse screens
+    void getSparseData( std::vector<unsigned int> &indices, std::vector<double> &values );
+    
+    //! Restore the non-empty bins from a checkpoint
+    void setSparseData( std::vector<unsigned int> &indices, std::vector<double> &values );
+    
 private :
 
     std::string screen_shape;
@@ -68,6 +79,14 @@ private :
     
     //! Copy of the timestep
     double dt;
+    
+    //! True if the particles first to last of a bin may have crossed the screen during the last timestep
+    bool binMayCross( Particles *particles, int first, int last );
+    
+    //! Buffers of each thread (bin index, value and direction of each particle), reused between patches
+    std::vector<std::vector<int> > thread_int_buffer_;
+    std::vector<std::vector<double> > thread_double_buffer_;
+    std::vector<std::vector<char> > thread_opposite_;
 };
 
 #endif
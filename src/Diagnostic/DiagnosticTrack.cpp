@@ -2,6 +2,10 @@
 
 #include <string>
 #include <sstream>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include <limits>
 
 #include "ParticleData.h"
 #include "PeekAtSpecies.h"
@@ -17,6 +21,39 @@ DiagnosticTrack::DiagnosticTrack( Params &params, SmileiMPI *smpi, VectorPatch &
 {
     write_id_ = true;
     
+    // Extract the compression
+    extractCompression( "DiagTrackParticles", iDiagTrackParticles );
+    
+    // Extract the buffering of several iterations in memory
+    int buffer_iterations = 1;
+    PyTools::extract( "buffer_iterations", buffer_iterations, "DiagTrackParticles", iDiagTrackParticles );
+    PyTools::extract( "buffer_memory", buffer_memory_, "DiagTrackParticles", iDiagTrackParticles );
+    if( buffer_iterations < 0 ) {
+        ERROR( "DiagTrackParticles #" << iDiagTrackParticles << ": `buffer_iterations` must be positive or 0" );
+    }
+    if( buffer_memory_ < 0. ) {
+        ERROR( "DiagTrackParticles #" << iDiagTrackParticles << ": `buffer_memory` must be positive or 0" );
+    }
+    if( buffer_iterations == 0 && buffer_memory_ == 0. ) {
+        ERROR( "DiagTrackParticles #" << iDiagTrackParticles << ": `buffer_iterations = 0` requires a `buffer_memory`" );
+    }
+    buffer_iterations_ = buffer_iterations;
+    buffer_memory_ *= 1048576.; // MB to bytes
+    
+    // Extract the ordering of the particles by ID during the simulation
+    sorted_ = false;
+    PyTools::extract( "sorted_output", sorted_, "DiagTrackParticles", iDiagTrackParticles );
+    if( sorted_ && buffer_iterations_ != 1 ) {
+        ERROR( "DiagTrackParticles #" << iDiagTrackParticles << ": `sorted_output` is not compatible with `buffer_iterations`" );
+    }
+    if( sorted_ && params.restart ) {
+        ERROR( "DiagTrackParticles #" << iDiagTrackParticles << ": `sorted_output` is not available when restarting a simulation" );
+    }
+    sorted_file_ = nullptr;
+    sorted_columns_ = 0;
+    sorted_rows_ = 0;
+    sorted_chunk_ = 0;
+    
     // Inform each patch about this diag
     for( unsigned int ipatch=0; ipatch<vecPatches.size(); ipatch++ ) {
         vecPatches( ipatch )->vecSpecies[species_index_]->tracking_diagnostic = idiag;
@@ -40,6 +77,9 @@ void DiagnosticTrack::openFile( Params &, SmileiMPI *smpi )
 {
     // Create HDF5 file
     file_ = new H5Write( filename, &smpi->world() );
+    if( compression_filter_ != H5Z_FILTER_NONE ) {
+        file_->setCompression( compression_filter_, compression_parameters_ );
+    }
     file_->attr( "name", diag_name_ );
     
     // Attributes for openPMD
@@ -47,6 +87,20 @@ void DiagnosticTrack::openFile( Params &, SmileiMPI *smpi )
     
     data_group_ = new H5Write( file_, "data" );
     
+    // The ordered file has the name and layout of the one made by happi, which then does not reorder the particles
+    if( sorted_ ) {
+        file_->attr( "sorted_output", 1u );
+        sorted_file_ = new H5Write( "TrackParticles_" + species_name_ + ".h5", &smpi->world() );
+        if( compression_filter_ != H5Z_FILTER_NONE ) {
+            sorted_file_->setCompression( compression_filter_, compression_parameters_ );
+        }
+        sorted_file_->attr( "finished_ordering", 1u );
+        ids_with_column_.resize( smpi->getSize(), 0 );
+        block_first_id_.resize( smpi->getSize() );
+        block_first_column_.resize( smpi->getSize() );
+        sorted_file_->flush();
+    }
+    
     file_->flush();
 }
 
@@ -57,6 +111,10 @@ void DiagnosticTrack::closeFile()
         delete file_;
         file_ = NULL;
     }
+    if( sorted_file_ ) {
+        delete sorted_file_;
+        sorted_file_ = nullptr;
+    }
 }
 
 void DiagnosticTrack::init( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches )
@@ -78,6 +136,36 @@ void DiagnosticTrack::init( Params &params, SmileiMPI *smpi, VectorPatch &vecPat
 
 
 H5Space * DiagnosticTrack::prepareH5( SimWindow *simWindow, SmileiMPI *smpi, int itime, uint32_t nParticles_local, uint64_t nParticles_global, uint64_t offset )
+{
+    double x_moved = simWindow ? simWindow->getXmoved() : 0.;
+    
+    // When buffering, only keep the iteration in memory: the datasets are copied by writeArray
+    if( buffered() ) {
+        BufferedIteration iteration;
+        iteration.itime = itime;
+        iteration.x_moved = x_moved;
+        iteration.latest_IDs = latest_Id;
+        iteration.nParticles_local = nParticles_local;
+        buffer_.push_back( iteration );
+        return NULL;
+    }
+    
+    // When ordered, only the iteration is recorded in the main file: the particles go to the ordered file
+    if( sorted_ ) {
+        ostringstream t( "" );
+        t << setfill( '0' ) << setw( 10 ) << itime;
+        H5Write iteration_group = data_group_->group( t.str() );
+        iteration_group.attr( "x_moved", x_moved );
+        iteration_group.vect( "latest_IDs", latest_Id, smpi->getSize(), H5T_NATIVE_UINT64, smpi->getRank(), 1 );
+        addSortedRow( smpi, itime );
+        // The points of this file space are selected when writing the IDs
+        return new H5Space( { sorted_rows_, sorted_columns_ }, {}, {}, { 1, sorted_chunk_ }, { true, true } );
+    }
+    
+    return createIteration( smpi, itime, x_moved, latest_Id, nParticles_local, nParticles_global, offset );
+}
+
+H5Space * DiagnosticTrack::createIteration( SmileiMPI *smpi, int itime, double x_moved, uint64_t latest_IDs, uint32_t nParticles_local, uint64_t nParticles_global, uint64_t offset )
 {
     // Make a new group for this iteration
     ostringstream t( "" );
@@ -129,11 +217,11 @@ H5Space * DiagnosticTrack::prepareH5( SimWindow *simWindow, SmileiMPI *smpi, int
     openPMD_->writeSpeciesAttributes( *species_group );
     
     // Write x_moved
-    iteration_group.attr( "x_moved", simWindow ? simWindow->getXmoved() : 0. );
+    iteration_group.attr( "x_moved", x_moved );
 
     // Create the "latest_IDs" dataset
     // Create file space and select one element for each proc
-    iteration_group.vect( "latest_IDs", latest_Id, smpi->getSize(), H5T_NATIVE_UINT64, smpi->getRank(), 1 );
+    iteration_group.vect( "latest_IDs", latest_IDs, smpi->getSize(), H5T_NATIVE_UINT64, smpi->getRank(), 1 );
     
     // Filespace and chunks
     hsize_t chunk = 0;
@@ -154,6 +242,12 @@ H5Space * DiagnosticTrack::prepareH5( SimWindow *simWindow, SmileiMPI *smpi, int
             chunk = chunk_size;
         }
     }
+    // Compressed datasets must be chunked: about one chunk per MPI process
+    if( compression_filter_ != H5Z_FILTER_NONE && nParticles_global > 0 ) {
+        hsize_t chunk_per_process = 1 + ( nParticles_global - 1 ) / smpi->getSize();
+        chunk = min( ( hsize_t ) nParticles_global, max( chunk_per_process, ( hsize_t ) 65536 ) );
+        chunk = min( chunk, ( hsize_t ) 100000000 );
+    }
     return new H5Space( nParticles_global, offset, nParticles_local, chunk );
 }
 
@@ -165,6 +259,142 @@ void DiagnosticTrack::deleteH5()
     delete loc_B_[0];
     delete loc_W_[0];
     delete loc_id_;
+    fill( loc_position_.begin(), loc_position_.end(), nullptr );
+    fill( loc_momentum_.begin(), loc_momentum_.end(), nullptr );
+    fill( loc_E_.begin(), loc_E_.end(), nullptr );
+    fill( loc_B_.begin(), loc_B_.end(), nullptr );
+    fill( loc_W_.begin(), loc_W_.end(), nullptr );
+    loc_id_ = nullptr;
+    loc_charge_ = nullptr;
+    loc_weight_ = nullptr;
+    loc_chi_ = nullptr;
+    // Complete rows only are seen by happi during the simulation
+    if( sorted_file_ ) {
+        sorted_file_->flush();
+    }
+}
+
+void DiagnosticTrack::addSortedRow( SmileiMPI *smpi, int itime )
+{
+    // Number of IDs given by each MPI process so far
+    uint64_t n_ids = latest_Id & 4294967295;
+    vector<uint64_t> all_n_ids( smpi->getSize() );
+    MPI_Allgather( &n_ids, 1, MPI_UNSIGNED_LONG_LONG, &all_n_ids[0], 1, MPI_UNSIGNED_LONG_LONG, smpi->world() );
+    
+    // The new IDs of each process get a block of columns after the existing ones
+    hsize_t previous_columns = sorted_columns_;
+    vector<uint64_t> unique_ids;
+    for( unsigned int rank=0; rank<all_n_ids.size(); rank++ ) {
+        if( all_n_ids[rank] > ids_with_column_[rank] ) {
+            block_first_id_[rank].push_back( ids_with_column_[rank] + 1 );
+            block_first_column_[rank].push_back( sorted_columns_ );
+            sorted_columns_ += all_n_ids[rank] - ids_with_column_[rank];
+            if( smpi->isMaster() ) {
+                for( uint64_t id = ids_with_column_[rank] + 1; id <= all_n_ids[rank]; id++ ) {
+                    unique_ids.push_back( ( ( uint64_t ) rank << 32 ) + id );
+                }
+            }
+            ids_with_column_[rank] = all_n_ids[rank];
+        }
+    }
+    if( sorted_rows_ == 0 ) {
+        sorted_chunk_ = min( max( sorted_columns_, ( hsize_t ) 1024 ), ( hsize_t ) 1048576 );
+    }
+    sorted_rows_++;
+    
+    // The master writes the iteration of the new row, and the IDs of the new columns
+    hsize_t n_master = smpi->isMaster() ? 1 : 0;
+    H5Space times_space( sorted_rows_, sorted_rows_ - 1, n_master, 1024, true );
+    H5Space times_mem( n_master );
+    H5Write times = sorted_file_->dataset( "Times", H5T_NATIVE_INT, &times_space );
+    times.extend( sorted_rows_ );
+    times.write( itime, H5T_NATIVE_INT, &times_space, &times_mem );
+    
+    H5Space ids_space( sorted_columns_, previous_columns, unique_ids.size(), sorted_chunk_, true );
+    H5Space ids_mem( ( hsize_t ) unique_ids.size() );
+    H5Write ids = sorted_file_->dataset( "unique_Ids", H5T_NATIVE_UINT64, &ids_space );
+    ids.extend( sorted_columns_ );
+    unique_ids.resize( max( unique_ids.size(), ( size_t ) 1 ) );
+    ids.write( unique_ids[0], H5T_NATIVE_UINT64, &ids_space, &ids_mem );
+}
+
+uint64_t DiagnosticTrack::sortedColumn( uint64_t id )
+{
+    uint64_t rank = ( id >> 32 ) & 16777215;
+    uint64_t n = id & 4294967295;
+    vector<uint64_t> &first_id = block_first_id_[rank];
+    size_t iblock = upper_bound( first_id.begin(), first_id.end(), n ) - first_id.begin() - 1;
+    return block_first_column_[rank][iblock] + n - first_id[iblock];
+}
+
+uint64_t DiagnosticTrack::bufferSize()
+{
+    uint64_t size = 0;
+    for( auto &iteration : buffer_ ) {
+        for( auto &dataset : iteration.datasets ) {
+            size += dataset.data.size();
+        }
+    }
+    return size;
+}
+
+void DiagnosticTrack::writeBuffered( SmileiMPI *smpi, bool force )
+{
+    // The number of buffered iterations is the same in all processes
+    unsigned int n_iterations = buffer_.size();
+    if( n_iterations == 0 ) {
+        return;
+    }
+    
+    // Write when any process exceeds the memory budget
+    bool full = force || ( buffer_iterations_ > 0 && n_iterations >= buffer_iterations_ );
+    if( ! full && buffer_memory_ > 0. ) {
+        full = ( double ) bufferSize() >= buffer_memory_;
+        MPI_Allreduce( MPI_IN_PLACE, &full, 1, MPI_CXX_BOOL, MPI_LOR, smpi->world() );
+    }
+    if( ! full ) {
+        return;
+    }
+    
+    // Offsets of all the buffered iterations in a single scan
+    vector<uint64_t> np_local( n_iterations ), np_global( n_iterations ), offset( n_iterations );
+    for( unsigned int i=0; i<n_iterations; i++ ) {
+        np_local[i] = buffer_[i].nParticles_local;
+    }
+    MPI_Scan( &np_local[0], &offset[0], n_iterations, MPI_UNSIGNED_LONG_LONG, MPI_SUM, smpi->world() );
+    np_global = offset;
+    MPI_Bcast( &np_global[0], n_iterations, MPI_UNSIGNED_LONG_LONG, smpi->getSize()-1, smpi->world() );
+    
+    for( unsigned int i=0; i<n_iterations; i++ ) {
+        BufferedIteration &iteration = buffer_[i];
+        H5Space *file_space = createIteration( smpi, iteration.itime, iteration.x_moved, iteration.latest_IDs,
+                                               iteration.nParticles_local, np_global[i], offset[i] - np_local[i] );
+        H5Space mem_space( ( hsize_t ) iteration.nParticles_local );
+        for( auto &dataset : iteration.datasets ) {
+            // Scalars are in the species group, components in the group of their record
+            H5Write *location = loc_id_;
+            if( ! dataset.scalar ) {
+                if( dataset.unit_type == SMILEI_UNIT_POSITION ) {
+                    location = loc_position_[0];
+                } else if( dataset.unit_type == SMILEI_UNIT_MOMENTUM ) {
+                    location = loc_momentum_[0];
+                } else if( dataset.unit_type == SMILEI_UNIT_EFIELD ) {
+                    location = loc_E_[0];
+                } else if( dataset.unit_type == SMILEI_UNIT_BFIELD ) {
+                    location = loc_B_[0];
+                } else {
+                    location = loc_W_[0];
+                }
+            }
+            dataset.data.resize( max( dataset.data.size(), ( size_t ) 1 ) );
+            writeArray( location, dataset.name, dataset.data[0], dataset.type, file_space, &mem_space, dataset.unit_type, dataset.scalar );
+        }
+        delete file_space;
+        deleteH5();
+    }
+    buffer_.clear();
+    
+    file_->flush();
 }
 
 void DiagnosticTrack::modifyFiltered( VectorPatch &vecPatches, unsigned int ipatch )
@@ -210,39 +440,118 @@ void DiagnosticTrack::setIDs( Particles &particles )
 }
 
 
-void DiagnosticTrack::write_scalar_uint64( H5Write * location, string name, uint64_t &buffer, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
+template<typename T>
+void DiagnosticTrack::writeArray( H5Write * location, string name, T &buffer, hid_t type, H5Space *file_space, H5Space *mem_space, unsigned int unit_type, bool scalar )
 {
-    H5Write a = location->array( name, buffer, H5T_NATIVE_UINT64, file_space, mem_space );
-    openPMD_->writeRecordAttributes( a, unit_type );
+    // Buffering: copy the data in the current iteration
+    if( ! file_space ) {
+        BufferedDataset dataset;
+        dataset.name = name;
+        dataset.type = type;
+        dataset.unit_type = unit_type;
+        dataset.scalar = scalar;
+        size_t size = buffer_.back().nParticles_local * H5Tget_size( type );
+        dataset.data.resize( size );
+        if( size > 0 ) {
+            memcpy( &dataset.data[0], &buffer, size );
+        }
+        buffer_.back().datasets.push_back( move( dataset ) );
+        return;
+    }
+    
+    if( sorted_ ) {
+        writeSorted( name, buffer, type, file_space, mem_space, unit_type, scalar );
+        return;
+    }
+    
+    H5Write a = location->array( name, buffer, type, file_space, mem_space );
+    if( scalar ) {
+        openPMD_->writeRecordAttributes( a, unit_type );
+    }
     openPMD_->writeComponentAttributes( a, unit_type );
 }
+
+template<typename T>
+void DiagnosticTrack::writeSorted( string name, T &buffer, hid_t type, H5Space *file_space, H5Space *mem_space, unsigned int unit_type, bool scalar )
+{
+    // The IDs, always written first, give the columns of the particles in this row
+    if( name == "id" ) {
+        uint64_t *ids = ( uint64_t * ) &buffer;
+        vector<uint64_t> columns( nParticles_local );
+        for( unsigned int ip=0; ip<nParticles_local; ip++ ) {
+            columns[ip] = sortedColumn( ids[ip] );
+        }
+        // Writing in the order of the columns makes contiguous accesses to the file
+        sorted_order_.resize( nParticles_local );
+        iota( sorted_order_.begin(), sorted_order_.end(), 0 );
+        sort( sorted_order_.begin(), sorted_order_.end(), [&columns]( size_t i, size_t j ) {
+            return columns[i] < columns[j];
+        } );
+        vector<hsize_t> coordinates( 2 * nParticles_local );
+        for( unsigned int ip=0; ip<nParticles_local; ip++ ) {
+            coordinates[2*ip  ] = sorted_rows_ - 1;
+            coordinates[2*ip+1] = columns[sorted_order_[ip]];
+        }
+        file_space->selectPoints( coordinates );
+    }
+    
+    T *data = &buffer;
+    vector<T> ordered( max( nParticles_local, ( uint32_t ) 1 ) );
+    for( unsigned int ip=0; ip<nParticles_local; ip++ ) {
+        ordered[ip] = data[sorted_order_[ip]];
+    }
+    
+    // Names and fill values of happi
+    string short_name = name;
+    if( scalar ) {
+        if( name == "id" ) {
+            short_name = "Id";
+        } else if( name == "charge" ) {
+            short_name = "q";
+        } else if( name == "weight" ) {
+            short_name = "w";
+        }
+    } else if( unit_type == SMILEI_UNIT_MOMENTUM ) {
+        short_name = "p" + name;
+    } else if( unit_type == SMILEI_UNIT_EFIELD ) {
+        short_name = "E" + name;
+    } else if( unit_type == SMILEI_UNIT_BFIELD ) {
+        short_name = "B" + name;
+    } else if( unit_type == SMILEI_UNIT_ENERGY ) {
+        short_name = "W" + name;
+    }
+    T fill_value = numeric_limits<T>::has_quiet_NaN ? numeric_limits<T>::quiet_NaN() : ( T )( name == "charge" ? 9999 : 0 );
+    sorted_file_->fillValue( fill_value, type );
+    
+    H5Write dataset = sorted_file_->dataset( short_name, type, file_space );
+    dataset.extend( { sorted_rows_, sorted_columns_ } );
+    dataset.write( ordered[0], type, file_space, mem_space );
+}
+
+void DiagnosticTrack::write_scalar_uint64( H5Write * location, string name, uint64_t &buffer, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
+{
+    writeArray( location, name, buffer, H5T_NATIVE_UINT64, file_space, mem_space, unit_type, true );
+}
 void DiagnosticTrack::write_scalar_short( H5Write * location, string name, short &buffer, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, H5T_NATIVE_SHORT, file_space, mem_space );
-    openPMD_->writeRecordAttributes( a, unit_type );
-    openPMD_->writeComponentAttributes( a, unit_type );
+    writeArray( location, name, buffer, H5T_NATIVE_SHORT, file_space, mem_space, unit_type, true );
 }
 void DiagnosticTrack::write_scalar_double( H5Write * location, string name, double &buffer, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, H5T_NATIVE_DOUBLE, file_space, mem_space );
-    openPMD_->writeRecordAttributes( a, unit_type );
-    openPMD_->writeComponentAttributes( a, unit_type );
+    writeArray( location, name, buffer, H5T_NATIVE_DOUBLE, file_space, mem_space, unit_type, true );
 }
 
 void DiagnosticTrack::write_component_uint64( H5Write * location, string name, uint64_t &buffer, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, H5T_NATIVE_UINT64, file_space, mem_space );
-    openPMD_->writeComponentAttributes( a, unit_type );
+    writeArray( location, name, buffer, H5T_NATIVE_UINT64, file_space, mem_space, unit_type, false );
 }
 void DiagnosticTrack::write_component_short( H5Write * location, string name, short &buffer, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, H5T_NATIVE_SHORT, file_space, mem_space );
-    openPMD_->writeComponentAttributes( a, unit_type );
+    writeArray( location, name, buffer, H5T_NATIVE_SHORT, file_space, mem_space, unit_type, false );
 }
 void DiagnosticTrack::write_component_double( H5Write * location, string name, double &buffer, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, H5T_NATIVE_DOUBLE, file_space, mem_space );
-    openPMD_->writeComponentAttributes( a, unit_type );
+    writeArray( location, name, buffer, H5T_NATIVE_DOUBLE, file_space, mem_space, unit_type, false );
 }
 
 
@@ -34,6 +34,21 @@ public :
     //! Close HDF5 groups, datasets and spaces
     void deleteH5() override;
     
+    //! True if the iterations are kept in memory and written several at once
+    bool buffered() override
+    {
+        return buffer_iterations_ != 1;
+    };
+    
+    //! Writes the iterations kept in memory when the buffer is full, or if forced (collective)
+    void writeBuffered( SmileiMPI *smpi, bool force ) override;
+    
+    //! Get memory footprint of current diagnostic
+    int getMemFootPrint() override
+    {
+        return ( int ) bufferSize();
+    }
+    
     //! Modify the filtered particles (apply new ID)
     void modifyFiltered( VectorPatch &, unsigned int ) override;
     
@@ -60,6 +75,69 @@ public :
 private :
     
     H5Write * data_group_;
+    
+    //! Creates the groups and attributes of an iteration, and returns the file space of its datasets
+    H5Space * createIteration( SmileiMPI *smpi, int itime, double x_moved, uint64_t latest_IDs, uint32_t nParticles_local, uint64_t nParticles_global, uint64_t offset );
+    
+    //! Writes a dataset, or copies it in the buffer of the current iteration if file_space is NULL
+    template<typename T>
+    void writeArray( H5Write * location, std::string name, T &buffer, hid_t type, H5Space *file_space, H5Space *mem_space, unsigned int unit_type, bool scalar );
+    
+    //! Maximum number of iterations kept in memory (0 for no limit)
+    unsigned int buffer_iterations_;
+    //! Maximum size of the buffer in bytes (0 for no limit)
+    double buffer_memory_;
+    
+    //! Dataset of a buffered iteration
+    struct BufferedDataset {
+        std::string name;
+        hid_t type;
+        unsigned int unit_type;
+        bool scalar;
+        std::vector<char> data;
+    };
+    
+    //! Iteration kept in memory
+    struct BufferedIteration {
+        int itime;
+        double x_moved;
+        uint64_t latest_IDs;
+        uint32_t nParticles_local;
+        std::vector<BufferedDataset> datasets;
+    };
+    
+    //! Iterations kept in memory
+    std::vector<BufferedIteration> buffer_;
+    
+    //! Size of the buffered data in bytes
+    uint64_t bufferSize();
+    
+    //! True if the particles are written at the positions given by their IDs, in a file ordered like happi does
+    bool sorted_;
+    
+    //! File ordered by IDs: one dataset per property with one row per iteration and one column per ID
+    H5Write * sorted_file_;
+    
+    //! Number of columns and of rows of the ordered datasets, and their chunk along the columns
+    hsize_t sorted_columns_, sorted_rows_, sorted_chunk_;
+    
+    //! For each MPI rank, the number of its IDs having a column, and the blocks of consecutive columns
+    //! given to its new IDs at each output (first ID number and first column of each block)
+    std::vector<uint64_t> ids_with_column_;
+    std::vector<std::vector<uint64_t> > block_first_id_, block_first_column_;
+    
+    //! Local particles ordered by column, for the current iteration
+    std::vector<size_t> sorted_order_;
+    
+    //! Gives columns to the IDs created since the last output, and adds a row for this iteration (collective)
+    void addSortedRow( SmileiMPI *smpi, int itime );
+    
+    //! Column of a particle in the ordered datasets
+    uint64_t sortedColumn( uint64_t id );
+    
+    //! Writes a property of the local particles at their columns in the ordered dataset
+    template<typename T>
+    void writeSorted( std::string name, T &buffer, hid_t type, H5Space *file_space, H5Space *mem_space, unsigned int unit_type, bool scalar );
 };
 
 #endif
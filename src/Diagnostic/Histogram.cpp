@@ -45,47 +45,37 @@ void Histogram::digitize( vector<Species *> species,
         // The indexes are "reshaped" in one dimension.
         // For instance, in 3d, the index has the form  i = i3 + n3*( i2 + n2*i1 )
         // Here we do the multiplication by n3 or n2 (etc.)
+        int nbins = axis->nbins;
+        int *index = int_buffer.data();
+        double *location = double_buffer.data();
         if( iaxis>0 ) {
+            #pragma omp simd
             for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
-                int_buffer[ipart] *= axis->nbins;
+                index[ipart] *= nbins;
             }
         }
         
         // loop again on the particles and calculate the index
         // This is separated in two cases: edge_inclusive and edge_exclusive
+        // The bin is clamped before its conversion to int (NaN included) so that the loops vectorize without branches
         if( !axis->edge_inclusive ) { // if the particles out of the "box" must be excluded
         
+            #pragma omp simd
             for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
-                // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
                 // calculate index
-                int ind = floor( ( double_buffer[ipart]-actual_min ) * coeff );
-                // index valid only if in the "box"
-                if( ind >= 0  &&  ind < axis->nbins ) {
-                    int_buffer[ipart] += ind;
-                } else {
-                    int_buffer[ipart] = -1;    // discard particle
-                }
+                int ind = ( int ) std::min( ( double ) nbins, std::max( -1., floor( ( location[ipart]-actual_min ) * coeff ) ) );
+                // index valid only if in the "box", and discarded particles stay discarded
+                index[ipart] = ( index[ipart] >= 0 && ind >= 0 && ind < nbins ) ? index[ipart] + ind : -1;
             }
             
         } else { // if the particles out of the "box" must be included
 
+            #pragma omp simd
             for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
+                // calculate index, and move out-of-range indexes back into range
+                int ind = ( int ) std::min( ( double ) ( nbins-1 ), std::max( 0., floor( ( location[ipart]-actual_min ) * coeff ) ) );
                 // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                // calculate index
-                int ind = floor( ( double_buffer[ipart]-actual_min ) * coeff );
-                // move out-of-range indexes back into range
-                if( ind < 0 ) {
-                    ind = 0;
-                } else if( ind >= axis->nbins ) {
-                    ind = axis->nbins-1;
-                }
-                int_buffer[ipart] += ind;
+                index[ipart] = index[ipart] >= 0 ? index[ipart] + ind : index[ipart];
             }
 
         }
@@ -115,6 +105,60 @@ void Histogram::distribute(
     
 }
 
+void Histogram::distributePrivate(
+    std::vector<double> &double_buffer,
+    std::vector<int>    &int_buffer,
+    std::vector<double> &output_array )
+{
+
+    unsigned int npart=double_buffer.size();
+    
+    for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
+        int ind = int_buffer[ipart];
+        if( ind<0 ) {
+            continue;    // skip discarded particles
+        }
+        output_array[ind] += double_buffer[ipart];
+    }
+    
+}
+
+void Histogram::distributeSparse(
+    std::vector<double> &double_buffer,
+    std::vector<int>    &int_buffer,
+    std::unordered_map<int, double> &output_map )
+{
+
+    unsigned int npart=double_buffer.size();
+    
+    for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
+        int ind = int_buffer[ipart];
+        if( ind<0 ) {
+            continue;    // skip discarded particles
+        }
+        output_map[ind] += double_buffer[ipart];
+    }
+    
+}
+
+void Histogram::distributeExact(
+    std::vector<double> &double_buffer,
+    std::vector<int>    &int_buffer,
+    std::vector<ExactSum> &output_array )
+{
+
+    unsigned int npart=double_buffer.size();
+    
+    for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
+        int ind = int_buffer[ipart];
+        if( ind<0 ) {
+            continue;    // skip discarded particles
+        }
+        output_array[ind].addAtomic( double_buffer[ipart] );
+    }
+    
+}
+
 
 
 void HistogramAxis::init( string type_, double min_, double max_, int nbins_, bool logscale_, bool edge_inclusive_, vector<double> coefficients_ )
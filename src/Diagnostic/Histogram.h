@@ -6,7 +6,10 @@
 #include "ParticleData.h"
 #include "Patch.h"
 #include "SimWindow.h"
+#include "ParticleExpression.h"
+#include "ExactSum.h"
 #include <algorithm>
+#include <unordered_map>
 
 // Class for each axis of the particle diags
 class HistogramAxis
@@ -95,6 +98,12 @@ public:
     };
     //! Add the contribution of each particle in the histogram
     void distribute( std::vector<double> &, std::vector<int> &, std::vector<double> & );
+    //! Same as `distribute` in a histogram private to the current thread (no atomics)
+    void distributePrivate( std::vector<double> &, std::vector<int> &, std::vector<double> & );
+    //! Same as `distribute` in a sparse histogram private to the current thread
+    void distributeSparse( std::vector<double> &, std::vector<int> &, std::unordered_map<int, double> & );
+    //! Same as `distribute` in exact sums (independent of the order of the particles)
+    void distributeExact( std::vector<double> &, std::vector<int> &, std::vector<ExactSum> & );
 
     std::string deposited_quantity;
 
@@ -561,6 +570,27 @@ class HistogramAxis_chi : public HistogramAxis
         }
     };
 };
+//! Axis given by a compiled expression of the particle attributes (no python, see ParticleExpression)
+class HistogramAxis_expression : public HistogramAxis
+{
+public:
+    HistogramAxis_expression( ParticleExpression *expression ) :
+        HistogramAxis(),
+        expression_( expression )
+    {};
+    ~HistogramAxis_expression()
+    {
+        delete expression_;
+    };
+private:
+    void calculate_locations( Species *s, double *array, int *, unsigned int npart, SimWindow * )
+    {
+        // The particles already excluded by the other axes are also evaluated, but ignored afterwards
+        expression_->evaluate( s->particles, 0, npart, array );
+    };
+
+    ParticleExpression *expression_;
+};
 #ifdef SMILEI_USE_NUMPY
 class HistogramAxis_user_function : public HistogramAxis
 {
@@ -1149,6 +1179,26 @@ class Histogram_ekin_vx : public Histogram
         }
     };
 };
+//! Deposited quantity given by a compiled expression of the particle attributes (no python, see ParticleExpression)
+class Histogram_expression : public Histogram
+{
+public:
+    Histogram_expression( ParticleExpression *expression ) :
+        Histogram(),
+        expression_( expression )
+    {};
+    ~Histogram_expression()
+    {
+        delete expression_;
+    };
+private:
+    void valuate( Species *s, double *array, int * )
+    {
+        expression_->evaluate( s->particles, 0, s->getNbrOfParticles(), array );
+    };
+
+    ParticleExpression *expression_;
+};
 
 #ifdef SMILEI_USE_NUMPY
 class Histogram_user_function : public Histogram
@@ -76,7 +76,11 @@ public:
             } else if( deposited_quantity == "" ) {
                 histogram = new Histogram();
             } else {
-                ERROR( deposited_quantityPrefix << " not understood" );
+                // Any other string is compiled as an expression of the particle attributes
+                ParticleExpression *expression = new ParticleExpression( deposited_quantity, params.nDim_particle, deposited_quantityPrefix );
+                checkExpression( expression, species, patch, deposited_quantityPrefix );
+                histogram = new Histogram_expression( expression );
+                deposited_quantity = "user_function";
             }
             histogram->deposited_quantity = deposited_quantity;
             Py_DECREF( deposited_quantity_object );
@@ -299,7 +303,12 @@ public:
             }
 #endif
             else {
-                ERROR( errorPrefix << type << " unknown" );
+                // Any other string is compiled as an expression of the particle attributes,
+                // and named like the user functions
+                ParticleExpression *expression = new ParticleExpression( type, params.nDim_particle, errorPrefix + "type" );
+                checkExpression( expression, species, patch, errorPrefix );
+                axis = new HistogramAxis_expression( expression );
+                type = "user_function";
             }
             
         } else { // hasType = false
@@ -311,6 +320,14 @@ public:
         return axis;
     }
 
+    //! Error if one of the species does not have the attributes used by an expression
+    static void checkExpression( ParticleExpression *expression, std::vector<unsigned int> &species, Patch *patch, std::string errorPrefix )
+    {
+        for( unsigned int ispec=0 ; ispec < species.size() ; ispec++ ) {
+            expression->check( patch->vecSpecies[species[ispec]]->particles, errorPrefix );
+        }
+    }
+
 };
 
 #endif
@@ -0,0 +1,410 @@
+#include "ParticleExpression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+#include "Particles.h"
+#include "Tools.h"
+
+using namespace std;
+
+// Number of particles evaluated at once by each instruction
+static const unsigned int block_size = 256;
+
+ParticleExpression::ParticleExpression( string expression, unsigned int nDim_particle, string errorPrefix ) :
+    expression_( expression ),
+    stack_size_( 0 ),
+    depth_( 0 ),
+    nDim_particle_( nDim_particle ),
+    errorPrefix_( errorPrefix ),
+    position_( 0 )
+{
+    nextToken();
+    if( token_.empty() ) {
+        ERROR( errorPrefix_ << ": empty expression" );
+    }
+    parseOr();
+    if( !token_.empty() ) {
+        ERROR( errorPrefix_ << ": unexpected `" << token_ << "` in expression `" << expression_ << "`" );
+    }
+}
+
+void ParticleExpression::check( Particles *particles, string errorPrefix ) const
+{
+    for( auto &instruction : code_ ) {
+        if( instruction.op != op_variable ) {
+            continue;
+        }
+        if( instruction.variable == var_chi && !particles->has_quantum_parameter ) {
+            ERROR( errorPrefix << ": `chi` requires a radiating species" );
+        }
+        if( instruction.variable == var_tau && !particles->has_Monte_Carlo_process ) {
+            ERROR( errorPrefix << ": `tau` requires a species with a Monte-Carlo process" );
+        }
+    }
+}
+
+void ParticleExpression::evaluate( Particles *particles, unsigned int istart, unsigned int npart, double *result ) const
+{
+    vector<double> stack( stack_size_ * block_size );
+    for( unsigned int iblock = 0; iblock < npart; iblock += block_size ) {
+        const unsigned int n = min( block_size, npart - iblock );
+        const unsigned int ipart0 = istart + iblock;
+        unsigned int depth = 0;
+        for( auto &instruction : code_ ) {
+            // b: top of the stack (last operand), a: the one below (first operand of binary operators)
+            double *a = depth > 1 ? &stack[( depth - 2 ) * block_size] : nullptr;
+            double *b = depth > 0 ? &stack[( depth - 1 ) * block_size] : nullptr;
+            switch( instruction.op ) {
+                case op_constant:
+                    b = &stack[( depth++ ) * block_size];
+                    fill( b, b + n, instruction.constant );
+                    break;
+                case op_variable:
+                    b = &stack[( depth++ ) * block_size];
+                    switch( instruction.variable ) {
+                        case var_x: case var_y: case var_z: {
+                            const double *const v = &particles->Position[instruction.variable - var_x][ipart0];
+                            copy( v, v + n, b );
+                            break;
+                        }
+                        case var_px: case var_py: case var_pz: {
+                            const double *const v = &particles->Momentum[instruction.variable - var_px][ipart0];
+                            copy( v, v + n, b );
+                            break;
+                        }
+                        case var_weight:
+                            copy( &particles->Weight[ipart0], &particles->Weight[ipart0] + n, b );
+                            break;
+                        case var_charge:
+                            for( unsigned int i = 0; i < n; i++ ) {
+                                b[i] = ( double )particles->Charge[ipart0 + i];
+                            }
+                            break;
+                        case var_id:
+                            for( unsigned int i = 0; i < n; i++ ) {
+                                b[i] = ( double )particles->Id[ipart0 + i];
+                            }
+                            break;
+                        case var_chi:
+                            copy( &particles->Chi[ipart0], &particles->Chi[ipart0] + n, b );
+                            break;
+                        case var_tau:
+                            copy( &particles->Tau[ipart0], &particles->Tau[ipart0] + n, b );
+                            break;
+                    }
+                    break;
+                // Binary operators: the result replaces the first operand
+                case op_add:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] + b[i]; }
+                    depth--;
+                    break;
+                case op_sub:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] - b[i]; }
+                    depth--;
+                    break;
+                case op_mul:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] * b[i]; }
+                    depth--;
+                    break;
+                case op_div:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] / b[i]; }
+                    depth--;
+                    break;
+                case op_pow:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = pow( a[i], b[i] ); }
+                    depth--;
+                    break;
+                case op_lt:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] < b[i]; }
+                    depth--;
+                    break;
+                case op_le:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] <= b[i]; }
+                    depth--;
+                    break;
+                case op_gt:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] > b[i]; }
+                    depth--;
+                    break;
+                case op_ge:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] >= b[i]; }
+                    depth--;
+                    break;
+                case op_eq:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] == b[i]; }
+                    depth--;
+                    break;
+                case op_ne:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = a[i] != b[i]; }
+                    depth--;
+                    break;
+                case op_and:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = ( a[i] != 0. ) && ( b[i] != 0. ); }
+                    depth--;
+                    break;
+                case op_or:
+                    for( unsigned int i = 0; i < n; i++ ) { a[i] = ( a[i] != 0. ) || ( b[i] != 0. ); }
+                    depth--;
+                    break;
+                // Unary operators and functions: in place
+                case op_neg:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = -b[i]; }
+                    break;
+                case op_not:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = b[i] == 0.; }
+                    break;
+                case op_sqrt:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = sqrt( b[i] ); }
+                    break;
+                case op_abs:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = fabs( b[i] ); }
+                    break;
+                case op_exp:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = exp( b[i] ); }
+                    break;
+                case op_log:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = log( b[i] ); }
+                    break;
+                case op_sin:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = sin( b[i] ); }
+                    break;
+                case op_cos:
+                    for( unsigned int i = 0; i < n; i++ ) { b[i] = cos( b[i] ); }
+                    break;
+            }
+        }
+        copy( stack.data(), stack.data() + n, result + iblock );
+    }
+}
+
+void ParticleExpression::select( Particles *particles, vector<unsigned int> &selection ) const
+{
+    const unsigned int npart = particles->numberOfParticles();
+    double result[block_size];
+    selection.resize( 0 );
+    for( unsigned int istart = 0; istart < npart; istart += block_size ) {
+        const unsigned int n = min( block_size, npart - istart );
+        evaluate( particles, istart, n, result );
+        for( unsigned int i = 0; i < n; i++ ) {
+            if( result[i] != 0. ) {
+                selection.push_back( istart + i );
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Parser: one function per level of precedence, from the lowest (or) to the highest (atoms)
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ParticleExpression::parseOr()
+{
+    parseAnd();
+    while( token_ == "or" || token_ == "|" ) {
+        nextToken();
+        parseAnd();
+        append( op_or );
+    }
+}
+
+void ParticleExpression::parseAnd()
+{
+    parseNot();
+    while( token_ == "and" || token_ == "&" ) {
+        nextToken();
+        parseNot();
+        append( op_and );
+    }
+}
+
+void ParticleExpression::parseNot()
+{
+    if( token_ == "not" || token_ == "~" ) {
+        nextToken();
+        parseNot();
+        append( op_not );
+    } else {
+        parseComparison();
+    }
+}
+
+void ParticleExpression::parseComparison()
+{
+    parseSum();
+    const vector<string> operators = { "<", "<=", ">", ">=", "==", "!=" };
+    const vector<Opcode> opcodes = { op_lt, op_le, op_gt, op_ge, op_eq, op_ne };
+    for( unsigned int i = 0; i < operators.size(); i++ ) {
+        if( token_ == operators[i] ) {
+            nextToken();
+            parseSum();
+            append( opcodes[i] );
+            break;
+        }
+    }
+}
+
+void ParticleExpression::parseSum()
+{
+    parseProduct();
+    while( token_ == "+" || token_ == "-" ) {
+        Opcode op = token_ == "+" ? op_add : op_sub;
+        nextToken();
+        parseProduct();
+        append( op );
+    }
+}
+
+void ParticleExpression::parseProduct()
+{
+    parseUnary();
+    while( token_ == "*" || token_ == "/" ) {
+        Opcode op = token_ == "*" ? op_mul : op_div;
+        nextToken();
+        parseUnary();
+        append( op );
+    }
+}
+
+void ParticleExpression::parseUnary()
+{
+    if( token_ == "-" ) {
+        nextToken();
+        parseUnary();
+        append( op_neg );
+    } else if( token_ == "+" ) {
+        nextToken();
+        parseUnary();
+    } else {
+        parsePower();
+    }
+}
+
+void ParticleExpression::parsePower()
+{
+    parseAtom();
+    // Right-associative, and of higher precedence than the unary minus on its left, as in python
+    if( token_ == "**" ) {
+        nextToken();
+        parseUnary();
+        append( op_pow );
+    }
+}
+
+void ParticleExpression::parseAtom()
+{
+    if( token_.empty() ) {
+        ERROR( errorPrefix_ << ": incomplete expression `" << expression_ << "`" );
+    }
+
+    // Parentheses
+    if( token_ == "(" ) {
+        nextToken();
+        parseOr();
+        if( token_ != ")" ) {
+            ERROR( errorPrefix_ << ": missing `)` in expression `" << expression_ << "`" );
+        }
+        nextToken();
+        return;
+    }
+
+    // Number
+    if( isdigit( token_[0] ) || token_[0] == '.' ) {
+        char *end;
+        double value = strtod( token_.c_str(), &end );
+        if( *end != '\0' ) {
+            ERROR( errorPrefix_ << ": invalid number `" << token_ << "` in expression `" << expression_ << "`" );
+        }
+        append( op_constant, value );
+        nextToken();
+        return;
+    }
+
+    // Function
+    const vector<string> functions = { "sqrt", "abs", "exp", "log", "sin", "cos" };
+    const vector<Opcode> function_opcodes = { op_sqrt, op_abs, op_exp, op_log, op_sin, op_cos };
+    for( unsigned int i = 0; i < functions.size(); i++ ) {
+        if( token_ == functions[i] ) {
+            nextToken();
+            if( token_ != "(" ) {
+                ERROR( errorPrefix_ << ": missing `(` after `" << functions[i] << "` in expression `" << expression_ << "`" );
+            }
+            parseAtom();
+            append( function_opcodes[i] );
+            return;
+        }
+    }
+
+    // Variable
+    const vector<string> variables = { "x", "y", "z", "px", "py", "pz", "weight", "charge", "id", "chi", "tau" };
+    for( unsigned int i = 0; i < variables.size(); i++ ) {
+        if( token_ == variables[i] ) {
+            if( i < 3 && i >= nDim_particle_ ) {
+                ERROR( errorPrefix_ << ": `" << token_ << "` does not exist in " << nDim_particle_ << "D" );
+            }
+            append( op_variable, 0., ( Variable )i );
+            nextToken();
+            return;
+        }
+    }
+
+    ERROR( errorPrefix_ << ": unknown `" << token_ << "` in expression `" << expression_ << "`" );
+}
+
+void ParticleExpression::nextToken()
+{
+    const string &e = expression_;
+    while( position_ < e.size() && isspace( e[position_] ) ) {
+        position_++;
+    }
+    token_ = "";
+    if( position_ >= e.size() ) {
+        return;
+    }
+    const size_t start = position_;
+    if( isalpha( e[position_] ) || e[position_] == '_' ) {
+        // Name
+        while( position_ < e.size() && ( isalnum( e[position_] ) || e[position_] == '_' ) ) {
+            position_++;
+        }
+    } else if( isdigit( e[position_] ) || e[position_] == '.' ) {
+        // Number, with an optional exponent
+        while( position_ < e.size() && ( isdigit( e[position_] ) || e[position_] == '.' ) ) {
+            position_++;
+        }
+        if( position_ < e.size() && ( e[position_] == 'e' || e[position_] == 'E' ) ) {
+            position_++;
+            if( position_ < e.size() && ( e[position_] == '+' || e[position_] == '-' ) ) {
+                position_++;
+            }
+            while( position_ < e.size() && isdigit( e[position_] ) ) {
+                position_++;
+            }
+        }
+    } else {
+        // Operator of 2 characters, or of 1
+        const string two = e.substr( position_, 2 );
+        if( two == "**" || two == "<=" || two == ">=" || two == "==" || two == "!=" ) {
+            position_ += 2;
+        } else if( string( "+-*/<>()&|~" ).find( e[position_] ) != string::npos ) {
+            position_++;
+        } else {
+            ERROR( errorPrefix_ << ": unexpected character `" << e[position_] << "` in expression `" << expression_ << "`" );
+        }
+    }
+    token_ = e.substr( start, position_ - start );
+}
+
+void ParticleExpression::append( Opcode op, double constant, Variable variable )
+{
+    code_.push_back( { op, constant, variable } );
+    // Depth of the stack after this instruction
+    if( op == op_constant || op == op_variable ) {
+        depth_++;
+    } else if( ( op >= op_add && op <= op_pow ) || ( op >= op_lt && op <= op_or ) ) {
+        depth_--;
+    }
+    stack_size_ = max( stack_size_, depth_ );
+}
@@ -0,0 +1,79 @@
+#ifndef PARTICLEEXPRESSION_H
+#define PARTICLEEXPRESSION_H
+
+#include <string>
+#include <vector>
+
+class Particles;
+
+//! Compiled arithmetic and logical expression of the particle attributes, e.g. "px > 10 and x < 50",
+//! used instead of python functions to filter or bin particles in the diagnostics.
+//! It is evaluated by blocks of particles in C++, without the python interpreter, so that all threads may run it concurrently.
+//!
+//! Variables: x, y, z, px, py, pz, weight, charge, id, chi, tau
+//! Operators: + - * / ** < <= > >= == != and or not (also & | ~), parentheses
+//! Functions: sqrt, abs, exp, log, sin, cos
+//! Booleans are 1 (true) or 0 (false).
+class ParticleExpression
+{
+public:
+    //! Compiles the expression (error if it is not valid)
+    ParticleExpression( std::string expression, unsigned int nDim_particle, std::string errorPrefix );
+    ~ParticleExpression() {};
+
+    //! Error if the particles do not have all the attributes used by the expression
+    void check( Particles *particles, std::string errorPrefix ) const;
+
+    //! Value of the expression for the particles istart to istart+npart-1
+    void evaluate( Particles *particles, unsigned int istart, unsigned int npart, double *result ) const;
+
+    //! Indices of the particles for which the expression is true (non zero)
+    void select( Particles *particles, std::vector<unsigned int> &selection ) const;
+
+    //! Original text of the expression
+    std::string expression_;
+
+private:
+    enum Opcode {
+        op_constant, op_variable,
+        op_add, op_sub, op_mul, op_div, op_pow, op_neg,
+        op_lt, op_le, op_gt, op_ge, op_eq, op_ne, op_and, op_or, op_not,
+        op_sqrt, op_abs, op_exp, op_log, op_sin, op_cos
+    };
+    enum Variable {
+        var_x, var_y, var_z, var_px, var_py, var_pz, var_weight, var_charge, var_id, var_chi, var_tau
+    };
+    struct Instruction {
+        Opcode op;
+        double constant;
+        Variable variable;
+    };
+
+    //! Instructions in reverse polish notation
+    std::vector<Instruction> code_;
+
+    //! Maximum depth of the stack during the evaluation, and depth after the last instruction
+    unsigned int stack_size_, depth_;
+
+    //! Recursive descent parser, appending the instructions to code_
+    void parseOr();
+    void parseAnd();
+    void parseNot();
+    void parseComparison();
+    void parseSum();
+    void parseProduct();
+    void parseUnary();
+    void parsePower();
+    void parseAtom();
+
+    //! Reads the next token (name, number or operator) in token_
+    void nextToken();
+    void append( Opcode op, double constant = 0., Variable variable = var_x );
+
+    unsigned int nDim_particle_;
+    std::string errorPrefix_;
+    std::string token_;
+    size_t position_;
+};
+
+#endif
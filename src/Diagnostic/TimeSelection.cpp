@@ -3,6 +3,7 @@
 #include <math.h>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 using namespace std;
 
@@ -16,6 +17,8 @@ TimeSelection::TimeSelection( PyObject *timeSelection, string name )
     period  = 1.;
     repeat  = 1;
     spacing = 1.;
+    window_ = 0;
+    last_iteration_ = 0;
     
     // If the selection is an int
     if( PyNumber_Check( timeSelection ) ) {
@@ -147,6 +150,8 @@ TimeSelection::TimeSelection()
     TheTimeIsNow = false;
     NextTime     = std::numeric_limits<int>::max();
     PreviousTime = std::numeric_limits<int>::max();
+    window_      = 0;
+    last_iteration_ = 0;
 }
 
 // Basic time selection
@@ -161,6 +166,8 @@ TimeSelection::TimeSelection( int copy_period )
     TheTimeIsNow  = false;
     NextTime      = std::numeric_limits<int>::max();
     PreviousTime  = 0;
+    window_       = 0;
+    last_iteration_ = 0;
 }
 
 // Cloning Constructor
@@ -175,6 +182,8 @@ TimeSelection::TimeSelection( TimeSelection *timeSelection )
     TheTimeIsNow = timeSelection->TheTimeIsNow;
     NextTime     = timeSelection->NextTime    ;
     PreviousTime = timeSelection->PreviousTime;
+    window_      = timeSelection->window_     ;
+    last_iteration_ = timeSelection->last_iteration_;
 }
 
 
@@ -182,6 +191,24 @@ TimeSelection::TimeSelection( TimeSelection *timeSelection )
 bool TimeSelection::theTimeIsNow( int itime )
 {
     TheTimeIsNow = false;
+    if( window_ > 1 ) {
+        // Delayed to the next I/O phase: a multiple of the window, or the last iteration
+        if( itime % window_ == 0 || itime == last_iteration_ ) {
+            int first = itime > 0 ? ( ( itime-1 ) / window_ ) * window_ + 1 : 0;
+            for( int t = first; t <= itime && ! TheTimeIsNow; t++ ) {
+                TheTimeIsNow = isSelected( t );
+            }
+        }
+    } else {
+        TheTimeIsNow = isSelected( itime );
+    }
+    return TheTimeIsNow;
+}
+
+
+// Tell whether the timestep is within the selection, regardless of the I/O phases
+bool TimeSelection::isSelected( int itime )
+{
     // In selection if inside the start/end bounds
     if( itime>=round( start ) && itime<=round( end ) ) {
         // Calculate the number of timesteps since the start
@@ -194,10 +221,18 @@ bool TimeSelection::theTimeIsNow( int itime )
         }
         // The time is now if closest repeat it within 0.5
         if( t < 1. ) {
-            TheTimeIsNow = true;
+            return true;
         }
     }
-    return TheTimeIsNow;
+    return false;
+}
+
+
+// Delay the selected timesteps to the next I/O phase
+void TimeSelection::setWindow( int window, int last_iteration )
+{
+    window_ = window;
+    last_iteration_ = last_iteration;
 }
 
 
@@ -234,11 +269,26 @@ int TimeSelection::nextTime( int itime )
 // Tell what is the previous timestep within the selection
 // Returns the same timestep if already within the selection
 int TimeSelection::previousTime( int itime )
+{
+    PreviousTime = previousSelected( itime );
+    if( window_ > 1 ) {
+        // The previous selected timestep may be delayed after itime: take the one before
+        if( delayed( PreviousTime ) > itime ) {
+            PreviousTime = previousSelected( PreviousTime - 1 );
+        }
+        PreviousTime = delayed( PreviousTime );
+    }
+    return PreviousTime;
+}
+
+
+// Previous timestep within the selection, regardless of the I/O phases
+int TimeSelection::previousSelected( int itime )
 {
     if( itime<round( start ) ) {
-        PreviousTime = std::numeric_limits<int>::min() >> 1;
+        return std::numeric_limits<int>::min() >> 1;
     } else if( itime>=round( end ) ) {
-        PreviousTime = end;
+        return end;
     } else {
         double t = ( double )( itime )-start + 0.4999; // number of timesteps since the start
         double p = floor( t/period )*period; // previous period
@@ -246,13 +296,23 @@ int TimeSelection::previousTime( int itime )
         
         // If within group
         if( T < groupWidth ) {
-            PreviousTime = ( int ) round( start + p + floor( T/spacing )*spacing ); // return previous good timestep
+            return ( int ) round( start + p + floor( T/spacing )*spacing ); // return previous good timestep
             // If after group, return end of that group
         } else {
-            PreviousTime = ( int ) round( start + p + groupWidth - 1 );
+            return ( int ) round( start + p + groupWidth - 1 );
         }
     }
-    return PreviousTime;
+}
+
+
+// I/O phase of a timestep: the next multiple of the window, or the last iteration
+int TimeSelection::delayed( int itime )
+{
+    if( itime <= 0 ) {
+        return itime;
+    }
+    int phase = ( ( itime-1 ) / window_ + 1 ) * window_;
+    return itime <= last_iteration_ ? std::min( phase, last_iteration_ ) : phase;
 }
 
 
@@ -82,6 +82,9 @@ public:
     //! Set the parameters of the time selection
     void set( double start, double end, double period );
     
+    //! Delay the selected timesteps to the next I/O phase: the next multiple of window, or the last iteration
+    void setWindow( int window, int last_iteration );
+    
     //! Obtain some information about the time selection
     std::string info();
     
@@ -109,6 +112,19 @@ private:
     //! Last answer of previousTime(int itime)
     int PreviousTime;
     
+    //! Number of timesteps between the I/O phases (no delay if <= 1), and last timestep of the simulation
+    int window_;
+    int last_iteration_;
+    
+    //! Tell whether the timestep is within the selection, regardless of the I/O phases
+    bool isSelected( int itime );
+    
+    //! Previous timestep within the selection, regardless of the I/O phases
+    int previousSelected( int itime );
+    
+    //! I/O phase of a timestep
+    int delayed( int itime );
+    
 };
 
 #endif
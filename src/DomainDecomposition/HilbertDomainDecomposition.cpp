@@ -40,9 +40,25 @@ std::vector<unsigned int> HilbertDomainDecomposition1D::getDomainCoordinates( un
 }
 
 
+// The Hilbert indices of all the patches are tabulated once, as each patch creation
+// (initialization, load balancing, moving window) needs its coordinates and those of its neighbors
 HilbertDomainDecomposition2D::HilbertDomainDecomposition2D( Params &params )
     : HilbertDomainDecomposition( params )
 {
+    unsigned int npatches = ndomain_[0] * ndomain_[1];
+    if( npatches > max_patches_in_tables_ ) {
+        return;
+    }
+    coordinates_.resize( 2*npatches );
+    index_.resize( npatches );
+    #pragma omp parallel for schedule(static)
+    for( unsigned int h=0 ; h<npatches ; h++ ) {
+        unsigned int x, y;
+        generalhilbertindexinv( mi_[0], mi_[1], &x, &y, h );
+        coordinates_[2*h  ] = x;
+        coordinates_[2*h+1] = y;
+        index_[x*ndomain_[1]+y] = h;
+    }
 }
 
 
@@ -54,6 +70,12 @@ HilbertDomainDecomposition2D::~HilbertDomainDecomposition2D( )
 // generalhilbertindex
 unsigned int HilbertDomainDecomposition2D::getDomainId( std::vector<int> Coordinates )
 {
+    if( ! index_.empty() ) {
+        if( Coordinates[0] < 0 || Coordinates[0] >= ( int )ndomain_[0] || Coordinates[1] < 0 || Coordinates[1] >= ( int )ndomain_[1] ) {
+            return MPI_PROC_NULL;
+        }
+        return index_[Coordinates[0]*ndomain_[1]+Coordinates[1]];
+    }
     return generalhilbertindex( mi_[0], mi_[1], Coordinates[0], Coordinates[1] );
     
 }
@@ -62,6 +84,9 @@ unsigned int HilbertDomainDecomposition2D::getDomainId( std::vector<int> Coordin
 // generalhilbertindexinv
 std::vector<unsigned int> HilbertDomainDecomposition2D::getDomainCoordinates( unsigned int Id )
 {
+    if( ! coordinates_.empty() ) {
+        return std::vector<unsigned int>( &coordinates_[2*Id], &coordinates_[2*Id+2] );
+    }
     std::vector<unsigned int> coords( 2, 0 );
     generalhilbertindexinv( mi_[0], mi_[1], &coords[0], &coords[1], Id );
     return coords;
@@ -72,6 +97,21 @@ std::vector<unsigned int> HilbertDomainDecomposition2D::getDomainCoordinates( un
 HilbertDomainDecomposition3D::HilbertDomainDecomposition3D( Params &params )
     : HilbertDomainDecomposition( params )
 {
+    unsigned int npatches = ndomain_[0] * ndomain_[1] * ndomain_[2];
+    if( npatches > max_patches_in_tables_ ) {
+        return;
+    }
+    coordinates_.resize( 3*npatches );
+    index_.resize( npatches );
+    #pragma omp parallel for schedule(static)
+    for( unsigned int h=0 ; h<npatches ; h++ ) {
+        unsigned int x, y, z;
+        generalhilbertindexinv( mi_[0], mi_[1], mi_[2], &x, &y, &z, h );
+        coordinates_[3*h  ] = x;
+        coordinates_[3*h+1] = y;
+        coordinates_[3*h+2] = z;
+        index_[( x*ndomain_[1]+y )*ndomain_[2]+z] = h;
+    }
 }
 
 
@@ -83,6 +123,13 @@ HilbertDomainDecomposition3D::~HilbertDomainDecomposition3D( )
 // generalhilbertindex
 unsigned int HilbertDomainDecomposition3D::getDomainId( std::vector<int> Coordinates )
 {
+    if( ! index_.empty() ) {
+        if( Coordinates[0] < 0 || Coordinates[0] >= ( int )ndomain_[0] || Coordinates[1] < 0 || Coordinates[1] >= ( int )ndomain_[1]
+            || Coordinates[2] < 0 || Coordinates[2] >= ( int )ndomain_[2] ) {
+            return MPI_PROC_NULL;
+        }
+        return index_[( Coordinates[0]*ndomain_[1]+Coordinates[1] )*ndomain_[2]+Coordinates[2]];
+    }
     return generalhilbertindex( mi_[0], mi_[1], mi_[2], Coordinates[0], Coordinates[1], Coordinates[2] );
     
 }
@@ -91,6 +138,9 @@ unsigned int HilbertDomainDecomposition3D::getDomainId( std::vector<int> Coordin
 // generalhilbertindexinv
 std::vector<unsigned int> HilbertDomainDecomposition3D::getDomainCoordinates( unsigned int Id )
 {
+    if( ! coordinates_.empty() ) {
+        return std::vector<unsigned int>( &coordinates_[3*Id], &coordinates_[3*Id+3] );
+    }
     std::vector<unsigned int> coords( 3, 0 );
     generalhilbertindexinv( mi_[0], mi_[1], mi_[2], &coords[0], &coords[1], &coords[2], Id );
     return coords;
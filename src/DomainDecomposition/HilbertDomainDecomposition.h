@@ -16,6 +16,14 @@ public:
 protected:
     std::vector<unsigned int> mi_;
     
+    //! Tables of the coordinates of each Hilbert index (ndim values per index), and of the Hilbert index
+    //! of each patch in lexicographic order (empty beyond max_patches_in_tables_ patches)
+    std::vector<unsigned int> coordinates_;
+    std::vector<unsigned int> index_;
+    
+    //! Largest number of patches for which the tables are built (16 bytes per patch in 3D)
+    static const unsigned int max_patches_in_tables_ = 1<<22;
+    
 };
 
 
@@ -2,6 +2,8 @@
 
 #include <limits>
 #include <iostream>
+#include <utility>
+#include <algorithm>
 
 #include "Params.h"
 #include "Species.h"
@@ -15,6 +17,7 @@
 #include "SolverFactory.h"
 #include "DomainDecompositionFactory.h"
 #include "LaserEnvelope.h"
+#include "PoissonMultigrid.h"
 
 #include "PatchAM.h"
 
@@ -110,6 +113,8 @@ void ElectroMagn::initElectroMagnQuantities()
     Bx_m=NULL;
     By_m=NULL;
     Bz_m=NULL;
+    subcycling_period_ = 1;
+    vacuum_ = false;
     By_mBTIS3=NULL;
     Bz_mBTIS3=NULL;
     Jx_=NULL;
@@ -120,6 +125,9 @@ void ElectroMagn::initElectroMagnQuantities()
     Env_Chi_  =NULL;
     Env_E_abs_=NULL;
     Env_Ex_abs_=NULL;
+    z_=NULL;
+    poisson_mg_=NULL;
+    phi_previous_=NULL;
     
     
     // Species charge currents and density
@@ -197,6 +205,7 @@ void ElectroMagn::finishInitialization( int nspecies, Patch * )
 ElectroMagn::~ElectroMagn()
 {
 
+    delete phi_previous_;
     if( Ex_ != NULL ) {
         delete Ex_;
     }
@@ -256,7 +265,14 @@ ElectroMagn::~ElectroMagn()
         for( unsigned int ifield=0; ifield<allFields_avg[idiag].size(); ifield++ ) {
             delete allFields_avg[idiag][ifield];
         }
-        
+
+    for( unsigned int ifield=0; ifield<averaged_fields_.size(); ifield++ ) {
+        delete averaged_fields_[ifield];
+    }
+    for( unsigned int ifield=0; ifield<subcycled_currents_.size(); ifield++ ) {
+        delete subcycled_currents_[ifield];
+    }
+
     for( unsigned int ispec=0; ispec<n_species; ispec++ ) {
         if( Jx_s [ispec] ) {
             delete Jx_s [ispec];
@@ -308,6 +324,11 @@ ElectroMagn::~ElectroMagn()
         }
     }
 
+    for( auto &pf: prescribedFields ) {
+        delete pf.cachedField;
+        pf.cachedField = nullptr;
+    }
+
 //     for ( unsigned int iExt = 0 ; iExt < prescribedFields.size() ; iExt++ ) {
 //     	delete prescribedFields[iExt].savedField;
 //     	#pragma omp single
@@ -394,6 +415,143 @@ void ElectroMagn::boundaryConditions( double time_dual, Patch *patch, SimWindow
 }
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Multigrid preconditioner of the Poisson solvers: block-Jacobi on the nodes owned by each patch
+// (index_min_p_ to index_max_p_, as the scalar products), each block being approximated by a multigrid V-cycle
+// ---------------------------------------------------------------------------------------------------------------------
+void ElectroMagn::initPoissonPreconditioner( double gamma_mean )
+{
+    unsigned int n[3] = { 1, 1, 1 };
+    double c[3] = { 0., 0., 0. };
+    for( unsigned int i=0 ; i<nDim_field ; i++ ) {
+        n[i] = index_max_p_[i] - index_min_p_[i] + 1;
+        c[i] = 1. / ( cell_length[i]*cell_length[i] );
+    }
+    c[0] /= gamma_mean*gamma_mean;
+    poisson_mg_ = new PoissonMultigrid( n, c );
+    z_ = r_->clone();
+    z_->put_to( 0. );
+}
+
+void ElectroMagn::deletePoissonPreconditioner()
+{
+    delete poisson_mg_;
+    delete z_;
+    poisson_mg_ = NULL;
+    z_ = NULL;
+}
+
+// Offsets of the owned nodes of the Poisson fields, as a 3D box
+static void poissonBox( Field *f, const std::vector<unsigned int> &index_min, const std::vector<unsigned int> &index_max,
+                        unsigned int start[3], unsigned int n[3], unsigned int stride[3] )
+{
+    for( unsigned int i=0 ; i<3 ; i++ ) {
+        start[i] = 0;
+        n[i] = 1;
+        stride[i] = 0;
+    }
+    unsigned int s = 1;
+    for( int i=f->dims_.size()-1 ; i>=0 ; i-- ) {
+        start[i]  = index_min[i];
+        n[i]      = index_max[i] - index_min[i] + 1;
+        stride[i] = s;
+        s *= f->dims_[i];
+    }
+}
+
+void ElectroMagn::compute_z()
+{
+    unsigned int start[3], n[3], stride[3];
+    poissonBox( r_, index_min_p_, index_max_p_, start, n, stride );
+
+    std::vector<double> rbox( n[0]*n[1]*n[2] ), zbox( n[0]*n[1]*n[2] );
+    for( unsigned int i=0 ; i<n[0] ; i++ ) {
+        for( unsigned int j=0 ; j<n[1] ; j++ ) {
+            for( unsigned int k=0 ; k<n[2] ; k++ ) {
+                rbox[( i*n[1]+j )*n[2]+k] = r_->data_[( start[0]+i )*stride[0] + ( start[1]+j )*stride[1] + ( start[2]+k )*stride[2]];
+            }
+        }
+    }
+    poisson_mg_->solve( &rbox[0], &zbox[0] );
+    // The nodes of the neighbours are set by the synchronization of z
+    z_->put_to( 0. );
+    for( unsigned int i=0 ; i<n[0] ; i++ ) {
+        for( unsigned int j=0 ; j<n[1] ; j++ ) {
+            for( unsigned int k=0 ; k<n[2] ; k++ ) {
+                z_->data_[( start[0]+i )*stride[0] + ( start[1]+j )*stride[1] + ( start[2]+k )*stride[2]] = zbox[( i*n[1]+j )*n[2]+k];
+            }
+        }
+    }
+}
+
+double ElectroMagn::compute_rz()
+{
+    return dotPoisson( r_, z_ );
+}
+
+bool ElectroMagn::isVacuum()
+{
+    // The currents are checked first, as the patches with particles are not in vacuum
+    Field *fields[12] = { Jx_, Jy_, Jz_, Ex_, Ey_, Ez_, Bx_, By_, Bz_, Bx_m, By_m, Bz_m };
+    for( unsigned int i=0 ; i<12 ; i++ ) {
+        if( !fields[i]->isZero() ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double ElectroMagn::dotPoisson( Field *a, Field *b )
+{
+    unsigned int start[3], n[3], stride[3];
+    poissonBox( a, index_min_p_, index_max_p_, start, n, stride );
+
+    double a_dot_b_local = 0.;
+    for( unsigned int i=0 ; i<n[0] ; i++ ) {
+        for( unsigned int j=0 ; j<n[1] ; j++ ) {
+            for( unsigned int k=0 ; k<n[2] ; k++ ) {
+                const unsigned int ijk = ( start[0]+i )*stride[0] + ( start[1]+j )*stride[1] + ( start[2]+k )*stride[2];
+                a_dot_b_local += a->data_[ijk] * b->data_[ijk];
+            }
+        }
+    }
+    return a_dot_b_local;
+}
+
+void ElectroMagn::update_p_preconditioned( double beta_k )
+{
+    for( unsigned int i=0 ; i<p_->number_of_points_ ; i++ ) {
+        p_->data_[i] = z_->data_[i] + beta_k * p_->data_[i];
+    }
+}
+
+void ElectroMagn::savePoissonSolution()
+{
+    delete phi_previous_;
+    phi_previous_ = phi_->clone();
+}
+
+void ElectroMagn::deletePoissonSolution()
+{
+    delete phi_previous_;
+    phi_previous_ = NULL;
+}
+
+void ElectroMagn::initPoissonGuess()
+{
+    p_->copyFrom( phi_previous_ );
+}
+
+void ElectroMagn::applyPoissonGuess( double s )
+{
+    for( unsigned int i=0 ; i<p_->number_of_points_ ; i++ ) {
+        phi_->data_[i] = s * p_->data_[i];
+        r_->data_[i] -= s * Ap_->data_[i];
+        p_->data_[i] = r_->data_[i];
+    }
+}
+
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Reinitialize the total charge densities and currents
 // - save current density as old density (charge conserving scheme)
@@ -407,6 +565,125 @@ void ElectroMagn::restartRhoJ()
     rho_->put_to( 0. );
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Time-averaged fields and currents of the sub-cycled species
+// - the fields of every iteration are summed between two pushes
+// - at the push, the sums are divided by the period and exchanged with the fields
+// - the current deposited at the push, divided by the period, is added at every iteration until the next push
+// They are allocated with the patch, so that the checkpoints and the patch exchanges find them
+// ---------------------------------------------------------------------------------------------------------------------
+void ElectroMagn::allocateSubcycledFields( std::vector<Species *> &vecSpecies )
+{
+    for( unsigned int ispec=0 ; ispec<vecSpecies.size() ; ispec++ ) {
+        if( vecSpecies[ispec]->push_every_ == 1 ) {
+            continue;
+        }
+        subcycling_period_ = vecSpecies[ispec]->push_every_;
+        subcycled_species_.push_back( ispec );
+        for( Field *J: { Jx_, Jy_, Jz_ } ) {
+            Field *field = J->clone();
+            field->name = J->name + "_" + vecSpecies[ispec]->name_ + "_subcycled";
+            field->put_to( 0. );
+            subcycled_currents_.push_back( field );
+        }
+    }
+
+    if( subcycling_period_ > 1 ) {
+        for( Field *F: { Ex_, Ey_, Ez_, Bx_m, By_m, Bz_m } ) {
+            Field *field = F->clone();
+            field->name = F->name + "_subcycled";
+            field->put_to( 0. );
+            averaged_fields_.push_back( field );
+        }
+    }
+}
+
+void ElectroMagn::accumulateAveragedFields( bool normalize )
+{
+    Field *fields[6] = { Ex_, Ey_, Ez_, Bx_m, By_m, Bz_m };
+
+    // A push follows subcycling_period_ accumulations, also across a restart which dumps the sums
+    const double norm = normalize ? 1./subcycling_period_ : 1.;
+    for( unsigned int ifield=0 ; ifield<6 ; ifield++ ) {
+        const double *const __restrict__ f = fields[ifield]->data();
+        double *const __restrict__ avg     = averaged_fields_[ifield]->data();
+        const unsigned int size            = fields[ifield]->size();
+        #pragma omp simd
+        for( unsigned int i=0 ; i<size ; i++ ) {
+            avg[i] = ( avg[i] + f[i] ) * norm;
+        }
+    }
+}
+
+void ElectroMagn::swapAveragedFields()
+{
+    std::swap( Ex_,  averaged_fields_[0] );
+    std::swap( Ey_,  averaged_fields_[1] );
+    std::swap( Ez_,  averaged_fields_[2] );
+    std::swap( Bx_m, averaged_fields_[3] );
+    std::swap( By_m, averaged_fields_[4] );
+    std::swap( Bz_m, averaged_fields_[5] );
+}
+
+void ElectroMagn::resetAveragedFields()
+{
+    for( unsigned int ifield=0 ; ifield<averaged_fields_.size() ; ifield++ ) {
+        averaged_fields_[ifield]->put_to( 0. );
+    }
+}
+
+void ElectroMagn::resetSubcycledCurrents()
+{
+    for( unsigned int ifield=0 ; ifield<subcycled_currents_.size() ; ifield++ ) {
+        subcycled_currents_[ifield]->put_to( 0. );
+    }
+}
+
+void ElectroMagn::swapSubcycledCurrents( unsigned int ispec, bool diag_flag )
+{
+    const unsigned int isub = find( subcycled_species_.begin(), subcycled_species_.end(), ispec ) - subcycled_species_.begin();
+    // Same currents as the projectors: those of the species at the iterations of the diagnostics, if allocated
+    std::swap( ( diag_flag && Jx_s[ispec] ) ? Jx_s[ispec] : Jx_, subcycled_currents_[3*isub  ] );
+    std::swap( ( diag_flag && Jy_s[ispec] ) ? Jy_s[ispec] : Jy_, subcycled_currents_[3*isub+1] );
+    std::swap( ( diag_flag && Jz_s[ispec] ) ? Jz_s[ispec] : Jz_, subcycled_currents_[3*isub+2] );
+}
+
+void ElectroMagn::addSubcycledCurrents( bool diag_flag )
+{
+    for( unsigned int isub=0 ; isub<subcycled_species_.size() ; isub++ ) {
+        const unsigned int ispec = subcycled_species_[isub];
+        Field *currents[3] = {
+            ( diag_flag && Jx_s[ispec] ) ? Jx_s[ispec] : Jx_,
+            ( diag_flag && Jy_s[ispec] ) ? Jy_s[ispec] : Jy_,
+            ( diag_flag && Jz_s[ispec] ) ? Jz_s[ispec] : Jz_
+        };
+        for( unsigned int icomp=0 ; icomp<3 ; icomp++ ) {
+            const double *const __restrict__ sub = subcycled_currents_[3*isub+icomp]->data();
+            double *const __restrict__ J         = currents[icomp]->data();
+            const unsigned int size              = currents[icomp]->size();
+            #pragma omp simd
+            for( unsigned int i=0 ; i<size ; i++ ) {
+                J[i] += sub[i];
+            }
+        }
+    }
+}
+
+// The current deposited at the push spans subcycling_period_ iterations
+void ElectroMagn::scaleSubcycledCurrents( unsigned int ispec )
+{
+    const unsigned int isub = find( subcycled_species_.begin(), subcycled_species_.end(), ispec ) - subcycled_species_.begin();
+    const double norm = 1./subcycling_period_;
+    for( unsigned int icomp=0 ; icomp<3 ; icomp++ ) {
+        double *const __restrict__ sub = subcycled_currents_[3*isub+icomp]->data();
+        const unsigned int size        = subcycled_currents_[3*isub+icomp]->size();
+        #pragma omp simd
+        for( unsigned int i=0 ; i<size ; i++ ) {
+            sub[i] *= norm;
+        }
+    }
+}
+
 void ElectroMagn::restartEnvChi()
 {
     Env_Chi_->put_to( 0. );
@@ -431,6 +708,58 @@ void ElectroMagn::restartRhoJs()
     restartRhoJ();
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// The currents and densities of species exist only if a diagnostic requested them (see VectorPatch::allocateField)
+// Their data is only allocated on the iterations when a diagnostic needs them
+// ---------------------------------------------------------------------------------------------------------------------
+void ElectroMagn::allocateRhoJs( bool is_pxr )
+{
+    for( unsigned int ispec=0 ; ispec < n_species ; ispec++ ) {
+        if( Jx_s [ispec] && Jx_s [ispec]->data_ == NULL ) {
+            if( is_pxr ) {
+                Jx_s [ispec]->allocateDims();
+            } else {
+                Jx_s [ispec]->allocateDims( 0, false );
+            }
+        }
+        if( Jy_s [ispec] && Jy_s [ispec]->data_ == NULL ) {
+            if( is_pxr ) {
+                Jy_s [ispec]->allocateDims();
+            } else {
+                Jy_s [ispec]->allocateDims( 1, false );
+            }
+        }
+        if( Jz_s [ispec] && Jz_s [ispec]->data_ == NULL ) {
+            if( is_pxr ) {
+                Jz_s [ispec]->allocateDims();
+            } else {
+                Jz_s [ispec]->allocateDims( 2, false );
+            }
+        }
+        if( rho_s[ispec] && rho_s[ispec]->data_ == NULL ) {
+            rho_s[ispec]->allocateDims();
+        }
+    }
+}
+
+void ElectroMagn::deallocateRhoJs()
+{
+    for( unsigned int ispec=0 ; ispec < n_species ; ispec++ ) {
+        if( Jx_s [ispec] ) {
+            Jx_s [ispec]->deallocateData();
+        }
+        if( Jy_s [ispec] ) {
+            Jy_s [ispec]->deallocateData();
+        }
+        if( Jz_s [ispec] ) {
+            Jz_s [ispec]->deallocateData();
+        }
+        if( rho_s[ispec] ) {
+            rho_s[ispec]->deallocateData();
+        }
+    }
+}
+
 void ElectroMagn::restartEnvChis()
 {
     for( unsigned int ispec=0 ; ispec < n_species ; ispec++ ) {
@@ -444,10 +773,10 @@ void ElectroMagn::restartEnvChis()
 // ---------------------------------------------------------------------------------------------------------------------
 // Increment an averaged field
 // ---------------------------------------------------------------------------------------------------------------------
-void ElectroMagn::incrementAvgField( Field *field, Field *field_avg )
+void ElectroMagn::incrementAvgField( Field *field, Field *field_avg, double weight )
 {
     for( unsigned int i=0; i<field->number_of_points_; i++ ) {
-        ( *field_avg )( i ) += ( *field )( i );
+        ( *field_avg )( i ) += weight * ( *field )( i );
     }
 }//END incrementAvgField
 
@@ -518,7 +847,25 @@ void ElectroMagn::applyPrescribedFields( Patch *patch, double time )
     for( vector<PrescribedField>::iterator pf=prescribedFields.begin(); pf!=prescribedFields.end(); pf++ ) {
         if( pf->index < allFields.size() ) {
             pf->savedField->copyFrom(allFields[pf->index]);
-            applyPrescribedField( allFields[pf->index], pf->profile, patch, time );
+            if( pf->cached ) {
+                // The spatial part is evaluated once on this patch (the critical protects the file reads)
+                if( ! pf->cachedField ) {
+                    pf->cachedField = pf->savedField->clone();
+                    pf->cachedField->put_to( 0. );
+                    #pragma omp critical( prescribed_field_cache )
+                    applyExternalField( pf->cachedField, pf->space_profile ? pf->space_profile : pf->profile, patch );
+                }
+                const double factor = pf->time_profile ? pf->time_profile->valueAt( time ) : 1.;
+                double *const __restrict__ field = allFields[pf->index]->data();
+                const double *const __restrict__ space = pf->cachedField->data();
+                const unsigned int size = allFields[pf->index]->number_of_points_;
+                #pragma omp simd
+                for( unsigned int i=0; i<size; i++ ) {
+                    field[i] += factor * space[i];
+                }
+            } else {
+                applyPrescribedField( allFields[pf->index], pf->profile, patch, time );
+            }
         }
     }
 }
@@ -21,6 +21,7 @@ class Patch;
 class Solver;
 class DomainDecomposition;
 class LaserEnvelope;
+class PoissonMultigrid;
 
 
 inline std::string LowerCase( std::string in )
@@ -49,6 +50,16 @@ struct PrescribedField {
 
     Profile *profile;
 
+    //! Space and time profiles, if the field is given as separable
+    Profile *space_profile;
+    Profile *time_profile;
+
+    //! True if the spatial part is evaluated once per patch (separable, or static profile from a file)
+    bool cached;
+
+    //! Spatial part on the patch, scaled by the time profile at each step (computed at the first application)
+    Field *cachedField;
+
     Field *savedField;
 
     unsigned int index;
@@ -272,6 +283,20 @@ public:
     //! all Fields averages required in diagnostic Fields
     std::vector<std::vector<Field *> > allFields_avg;
 
+    //! Period of the push of the sub-cycled species (Species.push_every), 1 without sub-cycling
+    unsigned int subcycling_period_;
+
+    //! Sums, then averages, of Ex, Ey, Ez, Bx_m, By_m, Bz_m since the last push of the
+    //! sub-cycled species (Species.push_every > 1)
+    std::vector<Field *> averaged_fields_;
+
+    //! Jx, Jy, Jz of each sub-cycled species, deposited at its push and divided by subcycling_period_:
+    //! they are added to the currents at each iteration until the next push
+    std::vector<Field *> subcycled_currents_;
+
+    //! Species of each triplet of subcycled_currents_
+    std::vector<unsigned int> subcycled_species_;
+
     //! Vector of charge density and currents for each species
     const unsigned int n_species;
     std::vector<Field *> Jx_s;
@@ -315,6 +340,35 @@ public:
     virtual void restartRhoJ();
     //! Method used to initialize the total charge currents and densities of species
     virtual void restartRhoJs();
+    //! Allocate the currents and densities of species requested by the diagnostics
+    void allocateRhoJs( bool is_pxr );
+    //! Free the currents and densities of species between the iterations of the diagnostics
+    void deallocateRhoJs();
+
+    //! Allocate the averaged fields and the currents of the sub-cycled species
+    void allocateSubcycledFields( std::vector<Species *> &vecSpecies );
+
+    //! Add the current fields to the averages of the sub-cycled species,
+    //! and turn the sums into averages if `normalize` (iteration of their push)
+    void accumulateAveragedFields( bool normalize );
+
+    //! Exchange the fields and their averages, so that the interpolators read the averages
+    void swapAveragedFields();
+
+    //! Restart the averages after the push of the sub-cycled species
+    void resetAveragedFields();
+
+    //! Restart the currents of the sub-cycled species before their push
+    void resetSubcycledCurrents();
+
+    //! Exchange the currents where the species ispec projects and its own currents, around its push
+    void swapSubcycledCurrents( unsigned int ispec, bool diag_flag );
+
+    //! Divide the currents deposited at the push of the sub-cycled species ispec by the period
+    void scaleSubcycledCurrents( unsigned int ispec );
+
+    //! Add the currents of the sub-cycled species, averaged over their period, to the currents of the iteration
+    void addSubcycledCurrents( bool diag_flag );
 
     //! Method used to initialize the total susceptibility
     virtual void restartEnvChi();
@@ -344,6 +398,22 @@ public:
     virtual void update_p( double rnew_dot_rnew, double r_dot_r ) = 0;
     virtual void initE( Patch *patch ) = 0;
     virtual void initE_relativistic_Poisson( Patch *patch, double gamma_mean ) = 0;
+    //! Multigrid preconditioner of the Poisson solvers (poisson_solver = "multigrid"), on the nodes owned by the patch
+    //! gamma_mean scales the x derivative as in compute_Ap_relativistic_Poisson
+    void initPoissonPreconditioner( double gamma_mean );
+    void deletePoissonPreconditioner();
+    //! Preconditioned residual z = M^-1 r
+    void compute_z();
+    double compute_rz();
+    void update_p_preconditioned( double beta_k );
+    //! Scalar product of two fields of the Poisson solvers on the nodes owned by the patch
+    double dotPoisson( Field *a, Field *b );
+    //! Warm start of the relativistic Poisson solver from the potential of the previous species initialized at the
+    //! same iteration: initPoissonGuess puts it in p_ (to compute A p), applyPoissonGuess( s ) starts from phi = s p
+    void savePoissonSolution();
+    void deletePoissonSolution();
+    void initPoissonGuess();
+    void applyPoissonGuess( double s );
     virtual void initB_relativistic_Poisson( double gamma_mean ) = 0;
     virtual void center_fields_from_relativistic_Poisson() = 0; // centers in Yee cells the fields
     virtual void sum_rel_fields_to_em_fields() = 0;
@@ -373,6 +443,9 @@ public:
     Field *r_;
     Field *p_;
     Field *Ap_;
+    Field *z_;
+    PoissonMultigrid *poisson_mg_;
+    Field *phi_previous_;
 
     cField *phi_AM_;
     cField *r_AM_;
@@ -385,6 +458,11 @@ public:
     Solver *MaxwellFaradaySolver_;
     virtual void saveMagneticFields( bool ) = 0;
     virtual void centerMagneticFields() = 0;
+    //! True if E, B, B_m and J are zero on all the points of the patch (ghost cells included): the Maxwell solvers
+    //! would not change the fields (Main.maxwell_skip_vacuum, cartesian geometries)
+    bool isVacuum();
+    //! isVacuum() before the Maxwell solvers of the iteration, reused from Maxwell-Ampere to Maxwell-Faraday
+    bool vacuum_;
     virtual void binomialCurrentFilter(unsigned int ipass, std::vector<unsigned int> passes ) = 0;
     virtual void customFIRCurrentFilter(unsigned int ipass, std::vector<unsigned int> passes, std::vector<double> filtering_coeff) = 0;
 
@@ -392,7 +470,7 @@ public:
 
     void laserDisabled();
 
-    void incrementAvgField( Field *field, Field *field_avg );
+    void incrementAvgField( Field *field, Field *field_avg, double weight = 1. );
 
     //! compute Poynting on borders
     virtual void computePoynting( unsigned int axis, unsigned int side ) = 0;
@@ -505,15 +583,20 @@ public:
             }
         }
 
-        for( unsigned int idiag = 0 ; idiag < allFields_avg.size() ; idiag++ ) {
-            emSize += allFields_avg[idiag].size() ;
-        }
+        emSize += averaged_fields_.size() + subcycled_currents_.size();
 
 
         for( size_t i=0 ; i<nDim_field ; i++ ) {
             emSize *= dimPrim[i];
         }
 
+        // Time averages may be accumulated on a subgrid, smaller than the patch
+        for( unsigned int idiag = 0 ; idiag < allFields_avg.size() ; idiag++ ) {
+            for( unsigned int ifield = 0 ; ifield < allFields_avg[idiag].size() ; ifield++ ) {
+                emSize += allFields_avg[idiag][ifield]->number_of_points_;
+            }
+        }
+
         emSize *= sizeof( double );
         return emSize;
     }
@@ -235,7 +235,7 @@ void ElectroMagn1D::initPoisson( Patch *patch )
     phi_ = new Field1D( dimPrim );  // scalar potential
     r_   = new Field1D( dimPrim );  // residual vector
     p_   = new Field1D( dimPrim );  // direction vector
-    Ap_  = new Field1D( dimPrim );  // A*p vector
+    Ap_  = new Field1D( dimPrim, "Ap" );  // A*p vector
 
     // double       dx_sq          = dx*dx;
 
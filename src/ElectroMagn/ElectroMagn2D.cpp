@@ -246,7 +246,7 @@ void ElectroMagn2D::initPoisson( Patch *patch )
     phi_ = new Field2D( dimPrim );  // scalar potential
     r_   = new Field2D( dimPrim );  // residual vector
     p_   = new Field2D( dimPrim );  // direction vector
-    Ap_  = new Field2D( dimPrim );  // A*p vector
+    Ap_  = new Field2D( dimPrim, "Ap" );  // A*p vector
     
     
     for( unsigned int i=0; i<dimPrim[0]; i++ ) {
@@ -281,7 +281,7 @@ void ElectroMagn3D::initPoisson( Patch *patch )
     phi_ = new Field3D( dimPrim );  // scalar potential
     r_   = new Field3D( dimPrim );  // residual vector
     p_   = new Field3D( dimPrim );  // direction vector
-    Ap_  = new Field3D( dimPrim );  // A*p vector
+    Ap_  = new Field3D( dimPrim, "Ap" );  // A*p vector
 
 
     for( unsigned int i=0; i<dimPrim[0]; i++ ) {
@@ -1357,163 +1357,108 @@ void ElectroMagn3D::centerMagneticFields()
 // ---------------------------------------------------------------------------------------------------------------------
 // Apply a single pass binomial filter on currents
 // ---------------------------------------------------------------------------------------------------------------------
-void ElectroMagn3D::binomialCurrentFilter(unsigned int ipass, std::vector<unsigned int> passes)
+// Single pass of the binomial filter on a current, along the directions where filter_x, filter_y or filter_z.
+// Along each direction, the forward and backward sweeps of the 2-point average result in the kernel (1/4, 1/2, 1/4),
+// with a 2-point average on the first point and the last point unchanged. The field is swept once, plane by plane
+// along x: the plane i is filtered along x from the planes i-1 (kept before it is overwritten), i and i+1,
+// then along y and z inside the plane (only for the planes and lines not in the outermost ghost cells).
+static void binomialFilterPass( Field3D *J, bool filter_x, bool filter_y, bool filter_z, std::vector<double> &buffer )
 {
-    const unsigned int nx_p = dimPrim[0];
-    const unsigned int ny_p = dimPrim[1];
-    const unsigned int nz_p = dimPrim[2];
-    const unsigned int nx_d = dimDual[0];
-    const unsigned int ny_d = dimDual[1];
-    const unsigned int nz_d = dimDual[2];
-    // Static-cast of the currents
-    Field3D *Jx3D = static_cast<Field3D *>( Jx_ );
-    Field3D *Jy3D = static_cast<Field3D *>( Jy_ );
-    Field3D *Jz3D = static_cast<Field3D *>( Jz_ );
-
-    // applying a single pass of the binomial filter along X
-    if (ipass < passes[0]){
-        // on Jx^(d,p) -- external points are treated by exchange. Boundary points not concerned by exchange are treated with a lower order filter.
-        for( unsigned int i=0; i<nx_d-1; i++ ) {
-            for( unsigned int j=0; j<ny_p; j++ ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jx3D )( i, j, k ) = ( ( *Jx3D )( i, j, k ) + ( *Jx3D )( i+1, j, k ) )*0.5;
+    if( !filter_x && !filter_y && !filter_z ) {
+        return;
+    }
+    const unsigned int nx = J->dims_[0];
+    const unsigned int ny = J->dims_[1];
+    const unsigned int nz = J->dims_[2];
+    const unsigned int nyz = ny*nz;
+    buffer.resize( 3*nyz );
+    double *const __restrict__ previous = &buffer[0];     // plane i-1 before filtering
+    double *const __restrict__ filtered = &buffer[nyz];   // plane i filtered along x
+    double *const __restrict__ filtered_y = &buffer[2*nyz]; // plane i filtered along x and y
+    double *const __restrict__ J3D = J->data();
+
+    for( unsigned int i=0; i<nx; i++ ) {
+        double *const __restrict__ plane = J3D + i*nyz;
+
+        // Along x
+        if( filter_x && i < nx-1 ) {
+            const double *const __restrict__ next = plane + nyz;
+            if( i == 0 ) {
+                #pragma omp simd
+                for( unsigned int jk=0; jk<nyz; jk++ ) {
+                    filtered[jk] = ( plane[jk] + next[jk] )*0.5;
                 }
-            }
-        }
-        for( unsigned int i=nx_d-2; i>0; i-- ) {
-            for( unsigned int j=0; j<ny_p; j++ ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jx3D )( i, j, k ) = ( ( *Jx3D )( i, j, k ) + ( *Jx3D )( i-1, j, k ) )*0.5;
+            } else {
+                #pragma omp simd
+                for( unsigned int jk=0; jk<nyz; jk++ ) {
+                    filtered[jk] = ( ( plane[jk] + next[jk] )*0.5 + ( previous[jk] + plane[jk] )*0.5 )*0.5;
                 }
             }
-        }
-        // Jy
-        for( unsigned int i=0; i<nx_p-1; i++ ) {
-            for( unsigned int j=0; j<ny_d; j++ ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jy3D )( i, j, k ) = ( ( *Jy3D )( i, j, k ) + ( *Jy3D )( i+1, j, k ) )*0.5;
-                }
-            }
-        }
-        for( unsigned int i=nx_p-2; i>0; i-- ) {
-            for( unsigned int j=0; j<ny_d; j++ ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jy3D )( i, j, k ) = ( ( *Jy3D )( i, j, k ) + ( *Jy3D )( i-1, j, k ) )*0.5;
-                }
+            #pragma omp simd
+            for( unsigned int jk=0; jk<nyz; jk++ ) {
+                previous[jk] = plane[jk];
             }
-        }
-        // Jz
-        for( unsigned int i=0; i<nx_p-1; i++ ) {
-            for( unsigned int j=0; j<ny_p; j++ ) {
-                for( unsigned int k=0; k<nz_d; k++ ) {
-                    ( *Jz3D )( i, j, k ) = ( ( *Jz3D )( i, j, k ) + ( *Jz3D )( i+1, j, k ) )*0.5;
+        } else {
+            #pragma omp simd
+            for( unsigned int jk=0; jk<nyz; jk++ ) {
+                filtered[jk] = plane[jk];
+            }
+        }
+        const bool inner_plane = i > 0 && i < nx-1;
+
+        // Along y
+        const double *const __restrict__ result_y = filter_y && inner_plane ? filtered_y : filtered;
+        if( filter_y && inner_plane ) {
+            for( unsigned int j=0; j<ny-1; j++ ) {
+                const double *const __restrict__ row  = filtered + j*nz;
+                const double *const __restrict__ next = row + nz;
+                double *const __restrict__ out        = filtered_y + j*nz;
+                if( j == 0 ) {
+                    #pragma omp simd
+                    for( unsigned int k=0; k<nz; k++ ) {
+                        out[k] = ( row[k] + next[k] )*0.5;
+                    }
+                } else {
+                    const double *const __restrict__ prev = row - nz;
+                    #pragma omp simd
+                    for( unsigned int k=0; k<nz; k++ ) {
+                        out[k] = ( ( row[k] + next[k] )*0.5 + ( prev[k] + row[k] )*0.5 )*0.5;
+                    }
                 }
             }
-        }
-        for( unsigned int i=nx_p-2; i>0; i-- ) {
-            for( unsigned int j=0; j<ny_p; j++ ) {
-                for( unsigned int k=0; k<nz_d; k++ ) {
-                    ( *Jz3D )( i, j, k ) = ( ( *Jz3D )( i, j, k ) + ( *Jz3D )( i-1, j, k ) )*0.5;
-                }
+            #pragma omp simd
+            for( unsigned int k=0; k<nz; k++ ) {
+                filtered_y[( ny-1 )*nz+k] = filtered[( ny-1 )*nz+k];
             }
         }
-    }
 
-    // applying a single pass of the binomial filter along Y
-    if (ipass < passes[1]){
-        //Jx
-        for( unsigned int i=1; i<nx_d-1; i++ ) {
-            for( unsigned int j=0; j<ny_p-1; j++ ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jx3D )( i, j, k ) = ( ( *Jx3D )( i, j, k ) + ( *Jx3D )( i, j+1, k ) )*0.5;
-                }
-            }
-        }
-        for( unsigned int i=1; i<nx_d-1; i++ ) {
-            for( unsigned int j=ny_p-2; j>0; j-- ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jx3D )( i, j, k ) = ( ( *Jx3D )( i, j, k ) + ( *Jx3D )( i, j-1, k ) )*0.5;
-                }
-            }
-        }
-        //Jy
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=0; j<ny_d-1; j++ ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jy3D )( i, j, k ) = ( ( *Jy3D )( i, j, k ) + ( *Jy3D )( i, j+1, k ) )*0.5;
-                }
-            }
-        }
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=ny_d-2; j>0; j-- ) {
-                for( unsigned int k=0; k<nz_p; k++ ) {
-                    ( *Jy3D )( i, j, k ) = ( ( *Jy3D )( i, j, k ) + ( *Jy3D )( i, j-1, k ) )*0.5;
+        // Along z, and back to the current
+        for( unsigned int j=0; j<ny; j++ ) {
+            const double *const __restrict__ row = result_y + j*nz;
+            double *const __restrict__ out       = plane + j*nz;
+            if( filter_z && inner_plane && j > 0 && j < ny-1 ) {
+                out[0] = ( row[0] + row[1] )*0.5;
+                #pragma omp simd
+                for( unsigned int k=1; k<nz-1; k++ ) {
+                    out[k] = ( ( row[k] + row[k+1] )*0.5 + ( row[k-1] + row[k] )*0.5 )*0.5;
                 }
-            }
-        }
-        //Jz
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=0; j<ny_p-1; j++ ) {
-                for( unsigned int k=0; k<nz_d; k++ ) {
-                    ( *Jz3D )( i, j, k ) = ( ( *Jz3D )( i, j, k ) + ( *Jz3D )( i, j+1, k ) )*0.5;
-                }
-            }
-        }
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=ny_p-2; j>0; j-- ) {
-                for( unsigned int k=0; k<nz_d; k++ ) {
-                    ( *Jz3D )( i, j, k ) = ( ( *Jz3D )( i, j, k ) + ( *Jz3D )( i, j-1, k ) )*0.5;
+                out[nz-1] = row[nz-1];
+            } else {
+                #pragma omp simd
+                for( unsigned int k=0; k<nz; k++ ) {
+                    out[k] = row[k];
                 }
             }
         }
     }
-    // applying a single pass of the binomial filter along Z
-    if (ipass < passes[2]){
-        //Jx
-        for( unsigned int i=1; i<nx_d-1; i++ ) {
-            for( unsigned int j=1; j<ny_p-1; j++ ) {
-                for( unsigned int k=0; k<nz_p-1; k++ ) {
-                    ( *Jx3D )( i, j, k ) = ( ( *Jx3D )( i, j, k ) + ( *Jx3D )( i, j, k+1 ) )*0.5;
-                }
-            }
-        }
-        for( unsigned int i=1; i<nx_d-1; i++ ) {
-            for( unsigned int j=1; j<ny_p-1; j++ ) {
-                for( unsigned int k=nz_p-2; k>0; k-- ) {
-                    ( *Jx3D )( i, j, k ) = ( ( *Jx3D )( i, j, k ) + ( *Jx3D )( i, j, k-1 ) )*0.5;
-                }
-            }
-        }
-        //Jy
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=1; j<ny_d-1; j++ ) {
-                for( unsigned int k=0; k<nz_p-1; k++ ) {
-                    ( *Jy3D )( i, j, k ) = ( ( *Jy3D )( i, j, k ) + ( *Jy3D )( i, j, k+1 ) )*0.5;
-                }
-            }
-        }
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=1; j<ny_d-1; j++ ) {
-                for( unsigned int k=nz_p-2; k>0; k-- ) {
-                    ( *Jy3D )( i, j, k ) = ( ( *Jy3D )( i, j, k ) + ( *Jy3D )( i, j, k-1 ) )*0.5;
-                }
-            }
-        }
-        //Jz
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=1; j<ny_p-1; j++ ) {
-                for( unsigned int k=0; k<nz_d-1; k++ ) {
-                    ( *Jz3D )( i, j, k ) = ( ( *Jz3D )( i, j, k ) + ( *Jz3D )( i, j, k+1 ) )*0.5;
-                }
-            }
-        }
-        for( unsigned int i=1; i<nx_p-1; i++ ) {
-            for( unsigned int j=1; j<ny_p-1; j++ ) {
-                for( unsigned int k=nz_d-2; k>0; k-- ) {
-                    ( *Jz3D )( i, j, k ) = ( ( *Jz3D )( i, j, k ) + ( *Jz3D )( i, j, k-1 ) )*0.5;
-                }
-            }
-        }
+}
+
+void ElectroMagn3D::binomialCurrentFilter(unsigned int ipass, std::vector<unsigned int> passes)
+{
+    // external points are treated by exchange. Boundary points not concerned by exchange are treated with a lower order filter.
+    std::vector<double> buffer;
+    for( Field *J : { Jx_, Jy_, Jz_ } ) {
+        binomialFilterPass( static_cast<Field3D *>( J ), ipass < passes[0], ipass < passes[1], ipass < passes[2], buffer );
     }
 }
 
@@ -42,6 +42,10 @@ public:
         
         EMfields->finishInitialization( vecSpecies.size(), patch );
 
+        if( ! dynamic_cast<RegionDomainDecomposition*>( domain_decomposition ) ) {
+            EMfields->allocateSubcycledFields( vecSpecies );
+        }
+
         bool first_creation = patch->isMaster() && ! dynamic_cast<RegionDomainDecomposition*>( domain_decomposition );
         
         // -----------------
@@ -109,16 +113,43 @@ public:
         }
         for( unsigned int n_extfield = 0; n_extfield < PyTools::nComponents( "PrescribedField" ); n_extfield++ ) {
             PrescribedField extField;
-            PyObject *profile;
+            PyObject *profile, *space_profile, *time_profile;
             std::string fieldName("");
             PyTools::extract( "field", fieldName, "PrescribedField", n_extfield );
-            // Now import the profile
+            // Now import the profile, or the space and time profiles
+            bool has_profile = PyTools::extract_pyProfile( "profile", profile, "PrescribedField", n_extfield );
+            bool has_space = PyTools::extract_pyProfile( "space_profile", space_profile, "PrescribedField", n_extfield );
+            bool has_time = PyTools::extract_pyProfile( "time_profile", time_profile, "PrescribedField", n_extfield );
+            extField.profile = NULL;
+            extField.space_profile = NULL;
+            extField.time_profile = NULL;
+            extField.cachedField = NULL;
             std::ostringstream name( "" );
-            name << "PrescribedField[" << n_extfield <<"].profile";
-            if( !PyTools::extract_pyProfile( "profile", profile, "PrescribedField", n_extfield ) ) {
-                ERROR( "PrescribedField #"<<n_extfield<<": parameter 'profile' not understood" );
+            if( has_profile ) {
+                if( has_space || has_time ) {
+                    ERROR( "PrescribedField #"<<n_extfield<<": `profile` not compatible with `space_profile` or `time_profile`" );
+                }
+                name << "PrescribedField[" << n_extfield <<"].profile";
+                extField.profile = new Profile( profile, params.nDim_field+1, name.str(), params, true, true, true );
+                // A profile from a file does not depend on time
+                extField.cached = extField.profile->usesFile() && params.geometry != "AMcylindrical";
+            } else {
+                if( ! has_space ) {
+                    ERROR( "PrescribedField #"<<n_extfield<<": parameter 'profile' or 'space_profile' not understood" );
+                }
+                if( ! has_time ) {
+                    ERROR( "PrescribedField #"<<n_extfield<<": parameter 'time_profile' not understood" );
+                }
+                if( params.geometry == "AMcylindrical" ) {
+                    ERROR( "PrescribedField #"<<n_extfield<<": `space_profile` and `time_profile` not available in AM geometry" );
+                }
+                name << "PrescribedField[" << n_extfield <<"].space_profile";
+                extField.space_profile = new Profile( space_profile, params.nDim_field, name.str(), params, true, true );
+                name.str( "" );
+                name << "PrescribedField[" << n_extfield <<"].time_profile";
+                extField.time_profile = new Profile( time_profile, 1, name.str(), params );
+                extField.cached = true;
             }
-            extField.profile = new Profile( profile, params.nDim_field+1, name.str(), params, true, true, true );
             // Find which index the field is in the allFields vector
             extField.index = 1000;
             for( unsigned int ifield=0; ifield<EMfields->allFields.size(); ifield++ ) {
@@ -134,7 +165,12 @@ public:
             }
             
             if( first_creation ) {
-                MESSAGE(1, "Prescribed field " << fieldName << ": " << extField.profile->getInfo());
+                if( extField.profile ) {
+                    MESSAGE(1, "Prescribed field " << fieldName << ": " << extField.profile->getInfo());
+                } else {
+                    MESSAGE(1, "Prescribed field " << fieldName << ": space " << extField.space_profile->getInfo()
+                            << ", time " << extField.time_profile->getInfo());
+                }
             }
             EMfields->prescribedFields.push_back( extField );
         }
@@ -241,15 +277,24 @@ public:
         
         newEMfields->finishInitialization( vecSpecies.size(), patch );
 
+        newEMfields->allocateSubcycledFields( vecSpecies );
+
         // -----------------
         // Clone time-average fields
         // -----------------
         newEMfields->allFields_avg.resize( EMfields->allFields_avg.size() );
         for( unsigned int idiag=0; idiag<EMfields->allFields_avg.size(); idiag++ ) {
-            for( unsigned int ifield=0; ifield<EMfields->allFields_avg[idiag].size(); ifield++ )
-                newEMfields->allFields_avg[idiag].push_back(
-                                                            newEMfields->createField( EMfields->allFields_avg[idiag][ifield]->name, params )
-                );
+            for( unsigned int ifield=0; ifield<EMfields->allFields_avg[idiag].size(); ifield++ ) {
+                Field *field_avg = EMfields->allFields_avg[idiag][ifield];
+                Field *field = newEMfields->createField( field_avg->name, params );
+                // Averages accumulated on the subgrid of the diagnostic are smaller than the patch
+                if( field->number_of_points_ != field_avg->number_of_points_ ) {
+                    delete field;
+                    field = field_avg->clone();
+                    field->put_to( 0. );
+                }
+                newEMfields->allFields_avg[idiag].push_back( field );
+            }
         }
         
         // -----------------
@@ -294,6 +339,10 @@ public:
         for( unsigned int n_extfield = 0; n_extfield < EMfields->prescribedFields.size(); n_extfield++ ) {
             PrescribedField newpf;
             newpf.profile = EMfields->prescribedFields[n_extfield].profile;
+            newpf.space_profile = EMfields->prescribedFields[n_extfield].space_profile;
+            newpf.time_profile  = EMfields->prescribedFields[n_extfield].time_profile;
+            newpf.cached  = EMfields->prescribedFields[n_extfield].cached;
+            newpf.cachedField = NULL;
             newpf.index   = EMfields->prescribedFields[n_extfield].index;
             newpf.savedField = EMfields->prescribedFields[n_extfield].savedField->clone();
             newEMfields->prescribedFields.push_back( newpf );
@@ -105,7 +105,7 @@ Laser::Laser( Params &params, int ilaser, Patch *patch, bool verbose )
             name.str( "" );
             name << "Laser[" << ilaser <<"].space_time_profile["<< 2*imode << "]";
             if( spacetime[2*imode] ) {
-                Profile *p = new Profile( space_time_profile[2*imode], params.nDim_field, name.str(), params );
+                Profile *p = new Profile( space_time_profile[2*imode], params.nDim_field, name.str(), params, !has_space_time_AM, false, true );
                 profiles.push_back( new LaserProfileNonSeparable( p ) );
                 info << "\t\t\tfirst  component : " << p->getInfo();
                 if (has_space_time_AM) info << " mode " << imode ;
@@ -120,7 +120,7 @@ Laser::Laser( Params &params, int ilaser, Patch *patch, bool verbose )
             name.str( "" );
             name << "Laser[" << ilaser <<"].space_time_profile[" << 2*imode+1 << "]";
             if( spacetime[2*imode+1] ) {
-                Profile *p = new Profile( space_time_profile[2*imode+1], params.nDim_field, name.str(), params );
+                Profile *p = new Profile( space_time_profile[2*imode+1], params.nDim_field, name.str(), params, !has_space_time_AM, false, true );
                 profiles.push_back( new LaserProfileNonSeparable( p ) );
                 info << "\t\t\tsecond component : " << p->getInfo() ;
                 if (has_space_time_AM) info << " mode " << imode ;
@@ -295,7 +295,12 @@ LaserProfileSeparable::LaserProfileSeparable(
     spaceProfile_( spaceProfile ),
     phaseProfile_( phaseProfile ),
     delay_phase_( delay_phase ),
-    axis_( axis )
+    axis_( axis ),
+    cached_time_( 0. ),
+    cached_( false ),
+    omega_t_( omega ),
+    uniform_phase_( false ),
+    time_envelope_( 0. )
 {
     space_envelope = NULL;
     phase = NULL;
@@ -309,7 +314,12 @@ LaserProfileSeparable::LaserProfileSeparable( LaserProfileSeparable *lp ) :
     spaceProfile_( new Profile( lp->spaceProfile_ ) ),
     phaseProfile_( new Profile( lp->phaseProfile_ ) ),
     delay_phase_( lp->delay_phase_ ),
-    axis_( lp->axis_ )
+    axis_( lp->axis_ ),
+    cached_time_( 0. ),
+    cached_( false ),
+    omega_t_( lp->omega_ ),
+    uniform_phase_( false ),
+    time_envelope_( 0. )
 {
     space_envelope = NULL;
     phase = NULL;
@@ -447,15 +457,42 @@ void LaserProfileSeparable::initFields( Params &params, Patch *patch, ElectroMag
             pos[0] += d1;
         }
     }
+    cached_ = false;
+}
+
+// Evaluate the time profiles, which do not depend on the position, once per time
+void LaserProfileSeparable::updateTimeFactors( double t )
+{
+    if( cached_ && t == cached_time_ ) {
+        return;
+    }
+    if( !cached_ ) {
+        // First call after initFields, or after the phase was received with the patch:
+        // check whether the time profile depends on the position through the phase
+        uniform_phase_ = true;
+        for( unsigned int i=1 ; i<phase->number_of_points_ ; i++ ) {
+            if( phase->data_[i] != phase->data_[0] ) {
+                uniform_phase_ = false;
+                break;
+            }
+        }
+    }
+    omega_t_ = omega_ * chirpProfile_->valueAt( t );
+    if( uniform_phase_ ) {
+        time_envelope_ = timeProfile_->valueAt( t-( phase->data_[0]+delay_phase_ )/omega_t_ );
+    }
+    cached_time_ = t;
+    cached_ = true;
 }
 
 // Amplitude of a separable laser profile
 double LaserProfileSeparable::getAmplitude( std::vector<double>, double t, int j, int k )
 {
     double amp;
-    double omega = omega_ * chirpProfile_->valueAt( t );
+    updateTimeFactors( t );
     double phi = ( *phase )( j, k );
-    amp = timeProfile_->valueAt( t-( phi+delay_phase_ )/omega ) * ( *space_envelope )( j, k ) * sin( omega*t - phi );
+    double time_envelope = uniform_phase_ ? time_envelope_ : timeProfile_->valueAt( t-( phi+delay_phase_ )/omega_t_ );
+    amp = time_envelope * ( *space_envelope )( j, k ) * sin( omega_t_*t - phi );
     return amp;
 }
 
@@ -29,6 +29,17 @@ public:
     {
         return 0.;
     };
+    //! Gets the amplitudes at several points pos[idim][ipoint], of indices j[ipoint], k[ipoint]
+    virtual void getAmplitudes( std::vector<std::vector<double>> &pos, double t, std::vector<int> &j, std::vector<int> &k, std::vector<double> &amp )
+    {
+        std::vector<double> p( pos.size() );
+        for( unsigned int i=0; i<amp.size(); i++ ) {
+            for( unsigned int idim=0; idim<pos.size(); idim++ ) {
+                p[idim] = pos[idim][i];
+            }
+            amp[i] = getAmplitude( p, t, j[i], k[i] );
+        }
+    };
 
     virtual std::string getInfo()
     {
@@ -66,6 +77,17 @@ public:
         return profiles[1]->getAmplitude( pos, t, j, k );
     }
 
+    //! Gets the amplitudes at all the points of a boundary (By)
+    inline void getAmplitudes0( std::vector<std::vector<double>> &pos, double t, std::vector<int> &j, std::vector<int> &k, std::vector<double> &amp )
+    {
+        profiles[0]->getAmplitudes( pos, t, j, k, amp );
+    }
+    //! Gets the amplitudes at all the points of a boundary (Bz)
+    inline void getAmplitudes1( std::vector<std::vector<double>> &pos, double t, std::vector<int> &j, std::vector<int> &k, std::vector<double> &amp )
+    {
+        profiles[1]->getAmplitudes( pos, t, j, k, amp );
+    }
+
     inline std::complex<double> getAmplitudecomplexN( std::vector<double> pos, double t, int j, int k, int imode )
     {
         return profiles[imode]->getAmplitudecomplex( pos, t, j, k );
@@ -124,6 +146,16 @@ private:
     Profile *timeProfile_, *chirpProfile_, *spaceProfile_, *phaseProfile_;
     double delay_phase_;
     unsigned int axis_;
+    //! The time factors are evaluated once per time (they are shared by all the points of the boundary)
+    void updateTimeFactors( double t );
+    double cached_time_;
+    bool cached_;
+    //! Chirped frequency at cached_time_
+    double omega_t_;
+    //! The phase is the same on the whole patch boundary: the time profile is then also cached
+    //! (checked at the first call after initFields, or after a patch exchange)
+    bool uniform_phase_;
+    double time_envelope_;
 };
 
 // Laser profile for non-separable space and time
@@ -143,6 +175,12 @@ public:
         return amp;
     }
 
+    //! A single evaluation of the profile for all the points
+    inline void getAmplitudes( std::vector<std::vector<double>> &pos, double t, std::vector<int> &, std::vector<int> &, std::vector<double> &amp ) override
+    {
+        spaceAndTimeProfile_->valuesAt( pos, t, amp );
+    }
+
     inline std::complex<double> getAmplitudecomplex( std::vector<double> pos, double t, int, int ) override
     {
         std::complex<double> amp;
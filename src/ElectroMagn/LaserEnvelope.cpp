@@ -235,3 +235,15 @@ void LaserEnvelope::boundaryConditions( double time_dual, Patch *patch, SimWindo
     }
     
 } // end LaserEnvelope::boundaryConditions
+
+
+void LaserEnvelope::computePhiAndGradPhi( ElectroMagn *EMfields )
+{
+    // Compute ponderomotive potential Phi=|A|^2/2, |A| and |E| from the envelope
+    computePhiEnvAEnvE( EMfields );
+    // Compute gradients of Phi
+    computeGradientPhi( EMfields );
+    // Computes Phi and GradPhi at time n+1/2 using their values at timestep n+1 and n (the latter already in Phi_m and GradPhi_m)
+    centerPhiAndGradPhi();
+    
+} // end LaserEnvelope::computePhiAndGradPhi
@@ -29,6 +29,9 @@ public:
     void boundaryConditions( double time_dual, Patch *patch, SimWindow *simWindow, ElectroMagn *EMfields );
     virtual void savePhiAndGradPhi() = 0;
     virtual void centerPhiAndGradPhi() = 0;
+    //! Phi, |A|, |E|, |Ex| and GradPhi from the new envelope, then Phi and GradPhi centered at n+1/2
+    //! (computePhiEnvAEnvE, computeGradientPhi and centerPhiAndGradPhi, fused in a single pass where possible)
+    virtual void computePhiAndGradPhi( ElectroMagn *EMfields );
     
     Profile *profile_;
     const std::vector<double> cell_length;
@@ -130,6 +133,14 @@ public:
     void computeGradientPhi( ElectroMagn *EMfields ) override final;
     void savePhiAndGradPhi() override final;
     void centerPhiAndGradPhi() override final;
+    void computePhiAndGradPhi( ElectroMagn *EMfields ) override final;
+
+private:
+    //! Explicit solvers on CPU, in a single pass along x with the complex arithmetic split in real and imaginary parts
+    template<bool reduced_dispersion> void advanceEnvelope( Patch *patch );
+
+    //! Ring of planes along x where advanceEnvelope keeps the new envelope until A^n is not needed there anymore
+    std::vector<std::complex<double>> A_new_planes_;
 };
 
 // Class for envelope with cylindrical symmetry
@@ -146,6 +157,14 @@ public:
     void computeGradientPhi( ElectroMagn *EMfields ) override final;
     void savePhiAndGradPhi() override final;
     void centerPhiAndGradPhi() override final;
+    void computePhiAndGradPhi( ElectroMagn *EMfields ) override final;
+
+private:
+    //! Explicit solvers on CPU, in a single pass along x with the complex arithmetic split in real and imaginary parts
+    template<bool reduced_dispersion> void advanceEnvelope( Patch *patch );
+
+    //! Ring of planes along x where advanceEnvelope keeps the new envelope until A^n is not needed there anymore
+    std::vector<std::complex<double>> A_new_planes_;
 };
 
 
@@ -206,104 +206,159 @@ LaserEnvelope3D::~LaserEnvelope3D()
 {
 }
 
-void LaserEnvelope3D::updateEnvelope( Patch *patch )
+// Extrapolates the susceptibility near the transverse boundaries of the simulation domain:
+// the cells [j0, j1[ x [k0, k1[ take the value at the index jsrc along y (or ksrc along z) when it is >= 0
+static void extrapolateEnvChi( double *const __restrict__ Env_Chi3D, const int nx, const int ny, const int nz,
+                               const int j0, const int j1, const int k0, const int k1, const int jsrc, const int ksrc )
 {
-    //// solves envelope equation in lab frame (see doc):
-    // full_laplacian(A)+2ik0*(dA/dz+(1/c)*dA/dt)-d^2A/dt^2*(1/c^2)=Chi*A
-    // where Chi is the plasma susceptibility [= sum(q^2*rho/mass/gamma_ponderomotive) for all species]
-    // gamma_ponderomotive=sqrt(1+p^2+|A|^2/2) in normalized units
-    
-    // the following explicit finite difference scheme is obtained through centered finite difference derivatives
-    // e.g. (dA/dx) @ time n and indices ijk = (A^n    _{i+1,j,k} - A^n    _{i-1,j,k}) /2/dx
-    //      (dA/dt) @ time n and indices ijk = (A^{n+1}_{i  ,j,k} - A^{n-1}_{i  ,j,k}) /2/dt
-    // A0 is A^{n-1}
-    //      (d^2A/dx^2) @ time n and indices ijk = (A^{n}_{i+1,j,k}-2*A^{n}_{i,j,k}+A^{n}_{i-1,j,k})/dx^2
-    
-    cField3D *A3D          = static_cast<cField3D *>( A_ );               // the envelope at timestep n
-    cField3D *A03D         = static_cast<cField3D *>( A0_ );              // the envelope at timestep n-1
-    Field3D *Env_Chi3D     = static_cast<Field3D *>( patch->EMfields->Env_Chi_ ); // source term of envelope equation
-
-    bool isYmin = patch->isBoundary( 1, 0 );
-    bool isYmax = patch->isBoundary( 1, 1 );
-    bool isZmin = patch->isBoundary( 2, 0 );
-    bool isZmax = patch->isBoundary( 2, 1 );
- 
-    // temporary variable for updated envelope
-    cField3D *A3Dnew;
-    A3Dnew  = new cField3D( A_->dims_ );
-
-    if (isYmin){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=1 ; j < 4 ; j++ ) {
-                for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, 4, k );
-                }
+    for( int i=1 ; i<nx-1 ; i++ ) {
+        for( int j=j0 ; j<j1 ; j++ ) {
+            for( int k=k0 ; k<k1 ; k++ ) {
+                Env_Chi3D[( i*ny+j )*nz+k] = Env_Chi3D[( i*ny+( jsrc>=0 ? jsrc : j ) )*nz+( ksrc>=0 ? ksrc : k )];
             }
         }
     }
+}
 
-    if (isYmax){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=A_->dims_[1]-4 ; j < A_->dims_[1]-1 ; j++ ) {
-                for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, A_->dims_[1]-5,k );
-                }
-            }
-        }
+static void extrapolateEnvChiAtBoundaries( Patch *patch, Field *Env_Chi )
+{
+    const int nx = Env_Chi->dims_[0];
+    const int ny = Env_Chi->dims_[1];
+    const int nz = Env_Chi->dims_[2];
+    double *const __restrict__ Env_Chi3D = Env_Chi->data();
+
+    if( patch->isBoundary( 1, 0 ) ) { // Ymin
+        extrapolateEnvChi( Env_Chi3D, nx, ny, nz, 1, 4, 1, nz-1, 4, -1 );
     }
+    if( patch->isBoundary( 1, 1 ) ) { // Ymax
+        extrapolateEnvChi( Env_Chi3D, nx, ny, nz, ny-4, ny-1, 1, nz-1, ny-5, -1 );
+    }
+    if( patch->isBoundary( 2, 0 ) ) { // Zmin
+        extrapolateEnvChi( Env_Chi3D, nx, ny, nz, 1, ny-1, 1, 4, -1, 4 );
+    }
+    if( patch->isBoundary( 2, 1 ) ) { // Zmax
+        extrapolateEnvChi( Env_Chi3D, nx, ny, nz, 1, ny-1, nz-4, nz-1, -1, nz-5 );
+    }
+}
 
-    if (isZmin){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) {
-                for( unsigned int k=1 ; k < 4 ; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, j, 4);
-                }
-            }
+// Explicit solvers on CPU (see updateEnvelope and updateEnvelopeReducedDispersion for the scheme).
+// The complex arithmetic is split in real and imaginary parts, so that the loops along z are vectorized.
+// The planes along x are advanced in order, and the new envelope is kept in a ring of planes until
+// the stencil does not need A^n there anymore: A and A0 are then swapped in the same pass.
+template<bool reduced_dispersion>
+void LaserEnvelope3D::advanceEnvelope( Patch *patch )
+{
+    double *const __restrict__ A3D              = reinterpret_cast<double *>( static_cast<cField3D *>( A_ )->cdata_ );  // the envelope at timestep n
+    double *const __restrict__ A03D             = reinterpret_cast<double *>( static_cast<cField3D *>( A0_ )->cdata_ ); // the envelope at timestep n-1
+    const double *const __restrict__ Env_Chi3D  = patch->EMfields->Env_Chi_->data(); // source term of envelope equation
+
+    const int nx = A_->dims_[0];
+    const int ny = A_->dims_[1];
+    const int nz = A_->dims_[2];
+    const int nyz = ny*nz;
+
+    // Half width of the stencil along x
+    const int width = reduced_dispersion ? 2 : 1;
+    A_new_planes_.resize( ( width+1 )*nyz );
+    double *const __restrict__ A_new3D = reinterpret_cast<double *>( A_new_planes_.data() );
+
+    // Coefficients of the derivatives along x, with the optimized form of the reduced dispersion scheme
+    const double dxx1 = reduced_dispersion ? ( 1.+delta )*one_ov_dx_sq : one_ov_dx_sq;
+    const double dxx2 = -delta*one_ov_dx_sq*0.25;
+    const double dx1  = reduced_dispersion ? 1.+delta : 1.;
+    const double dx2  = -delta*0.5;
+    const double one_ov_dy_sq = this->one_ov_dy_sq;
+    const double one_ov_dz_sq = this->one_ov_dz_sq;
+    const double dt_sq        = this->dt_sq;
+    const double c1_re = std::real( i1_2k0_over_2dx ), c1_im = std::imag( i1_2k0_over_2dx );
+    const double c2_re = std::real( one_plus_ik0dt ), c2_im = std::imag( one_plus_ik0dt );
+    const double c3_re = std::real( one_plus_ik0dt_ov_one_plus_k0sq_dtsq ), c3_im = std::imag( one_plus_ik0dt_ov_one_plus_k0sq_dtsq );
+
+    extrapolateEnvChiAtBoundaries( patch, patch->EMfields->Env_Chi_ );
+
+    const int ibegin = width;
+    const int iend   = nx-width;
+    for( int i=ibegin ; i<iend+width ; i++ ) { // x loop
+
+        // New envelope in the plane i
+        if( i < iend ) {
+            double *const __restrict__ A_new = A_new3D + 2*( i%( width+1 ) )*nyz;
+            for( int j=1 ; j<ny-1 ; j++ ) { // y loop
+                const int row = i*nyz+j*nz;
+                const double *const __restrict__ A    = A3D+2*row;
+                const double *const __restrict__ Axm  = A-2*nyz;
+                const double *const __restrict__ Axp  = A+2*nyz;
+                const double *const __restrict__ Axm2 = reduced_dispersion ? A-4*nyz : A;
+                const double *const __restrict__ Axp2 = reduced_dispersion ? A+4*nyz : A;
+                const double *const __restrict__ Aym  = A-2*nz;
+                const double *const __restrict__ Ayp  = A+2*nz;
+                const double *const __restrict__ A0   = A03D+2*row;
+                const double *const __restrict__ Chi  = Env_Chi3D+row;
+                double *const __restrict__ A_new_row  = A_new+2*j*nz;
+                #pragma omp simd
+                for( int k=1 ; k<nz-1 ; k++ ) { // z loop
+                    const int re = 2*k, im = 2*k+1;
+                    // laplacian - source term Chi*A
+                    double lap_re = -Chi[k]*A[re]
+                                    + ( Axm[re]-2.*A[re]+Axp[re] )*dxx1
+                                    + ( Aym[re]-2.*A[re]+Ayp[re] )*one_ov_dy_sq
+                                    + ( A[re-2]-2.*A[re]+A[re+2] )*one_ov_dz_sq;
+                    double lap_im = -Chi[k]*A[im]
+                                    + ( Axm[im]-2.*A[im]+Axp[im] )*dxx1
+                                    + ( Aym[im]-2.*A[im]+Ayp[im] )*one_ov_dy_sq
+                                    + ( A[im-2]-2.*A[im]+A[im+2] )*one_ov_dz_sq;
+                    // dA/dx times 2dx
+                    double dA_re = ( Axp[re]-Axm[re] )*dx1;
+                    double dA_im = ( Axp[im]-Axm[im] )*dx1;
+                    if( reduced_dispersion ) {
+                        lap_re += ( Axm2[re]-2.*A[re]+Axp2[re] )*dxx2;
+                        lap_im += ( Axm2[im]-2.*A[im]+Axp2[im] )*dxx2;
+                        dA_re  += ( Axp2[re]-Axm2[re] )*dx2;
+                        dA_im  += ( Axp2[im]-Axm2[im] )*dx2;
+                    }
+                    // (laplacian - Chi*A + 2ik0*dA/dx)*dt^2 + 2A - (1+ik0cdt)A0
+                    const double A_new_re = ( lap_re + c1_re*dA_re - c1_im*dA_im )*dt_sq + 2.*A[re] - ( c2_re*A0[re] - c2_im*A0[im] );
+                    const double A_new_im = ( lap_im + c1_re*dA_im + c1_im*dA_re )*dt_sq + 2.*A[im] - ( c2_re*A0[im] + c2_im*A0[re] );
+                    // times (1+ik0dct)/(1+k0^2c^2dt^2)
+                    A_new_row[re] = c3_re*A_new_re - c3_im*A_new_im;
+                    A_new_row[im] = c3_re*A_new_im + c3_im*A_new_re;
+                } // end z loop
+            } // end y loop
         }
-    }
 
-    if (isZmax){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) {
-                for ( unsigned int k=A_->dims_[2]-4 ; k < A_->dims_[2]-1 ; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, j, A_->dims_[2]-5 );
+        // A^n is not needed anymore in the plane i-width: it goes to A0 and the new envelope to A
+        const int iold = i-width;
+        if( iold >= ibegin ) {
+            const double *const __restrict__ A_new = A_new3D + 2*( iold%( width+1 ) )*nyz;
+            for( int j=1 ; j<ny-1 ; j++ ) { // y loop
+                const int row = j*nz;
+                double *const __restrict__ A  = A3D+2*( iold*nyz+row );
+                double *const __restrict__ A0 = A03D+2*( iold*nyz+row );
+                #pragma omp simd
+                for( int k=2 ; k<2*nz-2 ; k++ ) { // z loop, real and imaginary parts
+                    A0[k] = A[k];
+                    A[k]  = A_new[2*row+k];
                 }
             }
         }
-    }
-    
-    //// explicit solver
-    for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) { // y loop
-            for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) { // z loop
-                ( *A3Dnew )( i, j, k ) -= ( *Env_Chi3D )( i, j, k )*( *A3D )( i, j, k ); // subtract here source term Chi*A from plasma
-                // A3Dnew = laplacian - source term
-                ( *A3Dnew )( i, j, k ) += ( ( *A3D )( i-1, j, k )-2.*( *A3D )( i, j, k )+( *A3D )( i+1, j, k ) )*one_ov_dx_sq; // x part
-                ( *A3Dnew )( i, j, k ) += ( ( *A3D )( i, j-1, k )-2.*( *A3D )( i, j, k )+( *A3D )( i, j+1, k ) )*one_ov_dy_sq; // y part
-                ( *A3Dnew )( i, j, k ) += ( ( *A3D )( i, j, k-1 )-2.*( *A3D )( i, j, k )+( *A3D )( i, j, k+1 ) )*one_ov_dz_sq; // z part
-                // A3Dnew = A3Dnew+2ik0*dA/dx
-                ( *A3Dnew )( i, j, k ) += i1_2k0_over_2dx*( ( *A3D )( i+1, j, k )-( *A3D )( i-1, j, k ) );
-                // A3Dnew = A3Dnew*dt^2
-                ( *A3Dnew )( i, j, k )  = ( *A3Dnew )( i, j, k )*dt_sq;
-                // A3Dnew = A3Dnew + 2/c^2 A3D - (1+ik0cdt)A03D/c^2
-                ( *A3Dnew )( i, j, k ) += 2.*( *A3D )( i, j, k )-one_plus_ik0dt*( *A03D )( i, j, k );
-                // A3Dnew = A3Dnew * (1+ik0dct)/(1+k0^2c^2dt^2)
-                ( *A3Dnew )( i, j, k )  = ( *A3Dnew )( i, j, k )*one_plus_ik0dt_ov_one_plus_k0sq_dtsq;
-            } // end z loop
-        } // end y loop
     } // end x loop
+
+} // end LaserEnvelope3D::advanceEnvelope
+
+void LaserEnvelope3D::updateEnvelope( Patch *patch )
+{
+    //// solves envelope equation in lab frame (see doc):
+    // full_laplacian(A)+2ik0*(dA/dz+(1/c)*dA/dt)-d^2A/dt^2*(1/c^2)=Chi*A
+    // where Chi is the plasma susceptibility [= sum(q^2*rho/mass/gamma_ponderomotive) for all species]
+    // gamma_ponderomotive=sqrt(1+p^2+|A|^2/2) in normalized units
     
-    for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) { // y loop
-            for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) { // z loop
-                // final back-substitution
-                ( *A03D )( i, j, k )       = ( *A3D )( i, j, k );
-                ( *A3D )( i, j, k )        = ( *A3Dnew )( i, j, k );
-            } // end z loop
-        } // end y loop
-    } // end x loop
+    // the following explicit finite difference scheme is obtained through centered finite difference derivatives
+    // e.g. (dA/dx) @ time n and indices ijk = (A^n    _{i+1,j,k} - A^n    _{i-1,j,k}) /2/dx
+    //      (dA/dt) @ time n and indices ijk = (A^{n+1}_{i  ,j,k} - A^{n-1}_{i  ,j,k}) /2/dt
+    // A0 is A^{n-1}
+    //      (d^2A/dx^2) @ time n and indices ijk = (A^{n}_{i+1,j,k}-2*A^{n}_{i,j,k}+A^{n}_{i-1,j,k})/dx^2
     
-    delete A3Dnew;
+    advanceEnvelope<false>( patch );
 } // end LaserEnvelope3D::updateEnvelope
 
 void LaserEnvelope3D::updateEnvelopeReducedDispersion( Patch *patch )
@@ -326,95 +381,7 @@ void LaserEnvelope3D::updateEnvelopeReducedDispersion( Patch *patch )
     // (dA/dx)_opt = (1+delta)*(dA/dx) - delta*(A_{i+2,j,k}-A_{i-2,j,k})/4/dx
     // (d^2A/dx^2)_opt = (1+delta)*(d^2A/dx^2) - delta*(A_{i+2,j,k}-2*A_{i,j,k}+A_{i-2,j,k})/(4dx^2)
     
-    cField3D *A3D          = static_cast<cField3D *>( A_ );               // the envelope at timestep n
-    cField3D *A03D         = static_cast<cField3D *>( A0_ );              // the envelope at timestep n-1
-    Field3D *Env_Chi3D     = static_cast<Field3D *>( patch->EMfields->Env_Chi_ ); // source term of envelope equation
-
-    bool isYmin = patch->isBoundary( 1, 0 );
-    bool isYmax = patch->isBoundary( 1, 1 );
-    bool isZmin = patch->isBoundary( 2, 0 );
-    bool isZmax = patch->isBoundary( 2, 1 );
- 
-    
-    // temporary variable for updated envelope
-    cField3D *A3Dnew;
-    A3Dnew  = new cField3D( A_->dims_ );
-
-    if (isYmin){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=1 ; j < 4 ; j++ ) {
-                for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, 4, k );
-                }
-            }
-        }
-    }
-
-    if (isYmax){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=A_->dims_[1]-4 ; j < A_->dims_[1]-1 ; j++ ) {
-                for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, A_->dims_[1]-5,k );
-                }
-            }
-        }
-    }
-
-    if (isZmin){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) {
-                for( unsigned int k=1 ; k < 4 ; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, j, 4);
-                }
-            }
-        }
-    }
-
-    if (isZmax){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) {
-                for ( unsigned int k=A_->dims_[2]-4 ; k < A_->dims_[2]-1 ; k++ ) {
-                    ( *Env_Chi3D )( i, j, k ) = 1.*( *Env_Chi3D )( i, j, A_->dims_[2]-5 );
-                }
-            }
-        }
-    }
-
-    
-    //// explicit solver
-    for( unsigned int i=2 ; i <A_->dims_[0]-2; i++ ) { // x loop
-        for( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) { // y loop
-            for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) { // z loop
-                ( *A3Dnew )( i, j, k ) -= ( *Env_Chi3D )( i, j, k )*( *A3D )( i, j, k ); // subtract here source term Chi*A from plasma
-                // A3Dnew = laplacian - source term
-                ( *A3Dnew )( i, j, k ) += (1.+delta)*    ( ( *A3D )( i-1, j, k )-2.*( *A3D )( i, j, k )+( *A3D )( i+1, j, k ) )*one_ov_dx_sq; // x part with optimized derivative
-                ( *A3Dnew )( i, j, k ) -= delta*         ( ( *A3D )( i-2, j, k )-2.*( *A3D )( i, j, k )+( *A3D )( i+2, j, k ) )*one_ov_dx_sq*0.25;
-                ( *A3Dnew )( i, j, k ) +=                ( ( *A3D )( i, j-1, k )-2.*( *A3D )( i, j, k )+( *A3D )( i, j+1, k ) )*one_ov_dy_sq; // y part
-                ( *A3Dnew )( i, j, k ) +=                ( ( *A3D )( i, j, k-1 )-2.*( *A3D )( i, j, k )+( *A3D )( i, j, k+1 ) )*one_ov_dz_sq; // z part
-                // A3Dnew = A3Dnew+2ik0*dA/dx, where dA/dx uses the optimized form
-                ( *A3Dnew )( i, j, k ) += i1_2k0_over_2dx*(1.+delta)*( ( *A3D )( i+1, j, k )-( *A3D )( i-1, j, k ) );
-                ( *A3Dnew )( i, j, k ) -= i1_2k0_over_2dx*delta*0.5 *( ( *A3D )( i+2, j, k )-( *A3D )( i-2, j, k ) );
-                // A3Dnew = A3Dnew*dt^2
-                ( *A3Dnew )( i, j, k )  = ( *A3Dnew )( i, j, k )*dt_sq;
-                // A3Dnew = A3Dnew + 2/c^2 A3D - (1+ik0cdt)A03D/c^2
-                ( *A3Dnew )( i, j, k ) += 2.*( *A3D )( i, j, k )-one_plus_ik0dt*( *A03D )( i, j, k );
-                // A3Dnew = A3Dnew * (1+ik0dct)/(1+k0^2c^2dt^2)
-                ( *A3Dnew )( i, j, k )  = ( *A3Dnew )( i, j, k )*one_plus_ik0dt_ov_one_plus_k0sq_dtsq;
-            } // end z loop
-        } // end y loop
-    } // end x loop
-    
-    for( unsigned int i=2 ; i <A_->dims_[0]-2; i++ ) { // x loop
-        for( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) { // y loop
-            for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) { // z loop
-                // final back-substitution
-                ( *A03D )( i, j, k )       = ( *A3D )( i, j, k );
-                ( *A3D )( i, j, k )        = ( *A3Dnew )( i, j, k );
-            } // end z loop
-        } // end y loop
-    } // end x loop
-    
-    delete A3Dnew;
+    advanceEnvelope<true>( patch );
 } // end LaserEnvelope3D::updateEnvelopeReducedDispersion
 
 
@@ -423,29 +390,34 @@ void LaserEnvelope3D::computePhiEnvAEnvE( ElectroMagn *EMfields )
 
     // computes Phi=|A|^2/2 (the ponderomotive potential), new values immediately after the envelope update
     
-    cField3D *A3D          = static_cast<cField3D *>( A_ );                   // the envelope at timestep n
+    const std::complex<double> *const __restrict__ A3D  = static_cast<cField3D *>( A_ )->cdata_;  // the envelope at timestep n
+    const std::complex<double> *const __restrict__ A03D = static_cast<cField3D *>( A0_ )->cdata_; // the envelope at timestep n-1
+    double *const __restrict__ Phi3D       = Phi_->data();                    //Phi=|A|^2/2 is the ponderomotive potential
+    double *const __restrict__ Env_Aabs3D  = EMfields->Env_A_abs_->data();    // field for diagnostic and ionization
+    double *const __restrict__ Env_Eabs3D  = EMfields->Env_E_abs_->data();    // field for diagnostic and ionization
+    double *const __restrict__ Env_Exabs3D = EMfields->Env_Ex_abs_->data();   // field for diagnostic and ionization
 
-    cField3D *A03D         = static_cast<cField3D *>( A0_ );                  // the envelope at timestep n-1
-    
-    Field3D *Phi3D         = static_cast<Field3D *>( Phi_ );                  //Phi=|A|^2/2 is the ponderomotive potential
+    const int nx = A_->dims_[0];
+    const int ny = A_->dims_[1];
+    const int nz = A_->dims_[2];
 
-    Field3D *Env_Aabs3D    = static_cast<Field3D *>( EMfields->Env_A_abs_ );  // field for diagnostic and ionization
-     
-    Field3D *Env_Eabs3D    = static_cast<Field3D *>( EMfields->Env_E_abs_ );  // field for diagnostic and ionization
- 
-    Field3D *Env_Exabs3D   = static_cast<Field3D *>( EMfields->Env_Ex_abs_ ); // field for diagnostic and ionization
-    
+    const double ellipticity_factor = this->ellipticity_factor;
+    const double one_ov_2dy         = this->one_ov_2dy;
+    const double timestep           = this->timestep;
+    const std::complex<double> i1_omega = i1*omega;
     
     // Compute ponderomotive potential Phi=|A|^2/2, at timesteps n+1, including ghost cells
-    for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=1 ; j < A_->dims_[1]-1; j++ ) { // y loop
-            for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) { // z loop
-                ( *Phi3D )( i, j, k )      = ellipticity_factor*std::abs( ( *A3D )( i, j, k ) ) * std::abs( ( *A3D )( i, j, k ) ) * 0.5;
-                ( *Env_Aabs3D )( i, j, k ) = std::abs( ( *A3D )( i, j, k ) );
+    for( int i=1 ; i<nx-1 ; i++ ) { // x loop
+        for( int j=1 ; j<ny-1 ; j++ ) { // y loop
+            for( int k=1 ; k<nz-1 ; k++ ) { // z loop
+                const int idx = ( i*ny+j )*nz+k;
+                const double A_abs = std::abs( A3D[idx] );
+                Phi3D[idx]      = ellipticity_factor*A_abs*A_abs*0.5;
+                Env_Aabs3D[idx] = A_abs;
                 // |E envelope| = |-(dA/dt-ik0cA)|, forward finite differences for the time derivative
-                ( *Env_Eabs3D )( i, j, k ) = std::abs( ( ( *A3D )( i, j, k )-( *A03D )( i, j, k ) )/timestep - i1*omega*( *A3D )( i, j, k ) );
+                Env_Eabs3D[idx] = std::abs( ( A3D[idx]-A03D[idx] )/timestep - i1_omega*A3D[idx] );
                 // |Ex envelope| = |-(dA/dy|, central finite difference for the space derivative
-                ( *Env_Exabs3D )( i, j,k ) = std::abs( ( ( *A3D )( i, j+1,k)-( *A3D  )( i, j-1,k) )*one_ov_2dy );
+                Env_Exabs3D[idx] = std::abs( ( A3D[idx+nz]-A3D[idx-nz] )*one_ov_2dy );
             } // end z loop
         } // end y loop
     } // end x loop
@@ -457,23 +429,31 @@ void LaserEnvelope3D::computeGradientPhi( ElectroMagn * )
 {
 
     // computes gradient of Phi=|A|^2/2 (the ponderomotive potential), new values immediately after the envelope update
-    Field3D *GradPhix3D    = static_cast<Field3D *>( GradPhix_ );
-    Field3D *GradPhiy3D    = static_cast<Field3D *>( GradPhiy_ );
-    Field3D *GradPhiz3D    = static_cast<Field3D *>( GradPhiz_ );
-    Field3D *Phi3D         = static_cast<Field3D *>( Phi_ );      //Phi=|A|^2/2 is the ponderomotive potential
-    
+    double *const __restrict__ GradPhix3D = GradPhix_->data();
+    double *const __restrict__ GradPhiy3D = GradPhiy_->data();
+    double *const __restrict__ GradPhiz3D = GradPhiz_->data();
+    const double *const __restrict__ Phi3D = Phi_->data(); //Phi=|A|^2/2 is the ponderomotive potential
+
+    const int nx = A_->dims_[0];
+    const int ny = A_->dims_[1];
+    const int nz = A_->dims_[2];
+    const int nyz = ny*nz;
+
+    const double one_ov_2dx = this->one_ov_2dx;
+    const double one_ov_2dy = this->one_ov_2dy;
+    const double one_ov_2dz = this->one_ov_2dz;
     
     // Compute gradients of Phi, at timesteps n
-    for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=1 ; j < A_->dims_[1]-1 ; j++ ) { // y loop
-            for( unsigned int k=1 ; k < A_->dims_[2]-1; k++ ) { // z loop
-            
+    for( int i=1 ; i<nx-1 ; i++ ) { // x loop
+        for( int j=1 ; j<ny-1 ; j++ ) { // y loop
+            for( int k=1 ; k<nz-1 ; k++ ) { // z loop
+                const int idx = i*nyz+j*nz+k;
                 // gradient in x direction
-                ( *GradPhix3D )( i, j, k ) = ( ( *Phi3D )( i+1, j, k )-( *Phi3D )( i-1, j, k ) ) * one_ov_2dx;
+                GradPhix3D[idx] = ( Phi3D[idx+nyz]-Phi3D[idx-nyz] ) * one_ov_2dx;
                 // gradient in y direction
-                ( *GradPhiy3D )( i, j, k ) = ( ( *Phi3D )( i, j+1, k )-( *Phi3D )( i, j-1, k ) ) * one_ov_2dy;
+                GradPhiy3D[idx] = ( Phi3D[idx+nz]-Phi3D[idx-nz] ) * one_ov_2dy;
                 // gradient in z direction
-                ( *GradPhiz3D )( i, j, k ) = ( ( *Phi3D )( i, j, k+1 )-( *Phi3D )( i, j, k-1 ) ) * one_ov_2dz;
+                GradPhiz3D[idx] = ( Phi3D[idx+1]-Phi3D[idx-1] ) * one_ov_2dz;
             } // end z loop
         } // end y loop
     } // end x loop
@@ -483,31 +463,31 @@ void LaserEnvelope3D::computeGradientPhi( ElectroMagn * )
 
 void LaserEnvelope3D::savePhiAndGradPhi()
 {
-    // Static cast of the fields
-    Field3D *Phi3D         = static_cast<Field3D *>( Phi_ );
-    Field3D *Phi_m3D       = static_cast<Field3D *>( Phi_m );
-    
-    Field3D *GradPhix3D    = static_cast<Field3D *>( GradPhix_ );
-    Field3D *GradPhix_m3D = static_cast<Field3D *>( GradPhix_m );
-    
-    Field3D *GradPhiy3D    = static_cast<Field3D *>( GradPhiy_ );
-    Field3D *GradPhiy_m3D  = static_cast<Field3D *>( GradPhiy_m );
-    
-    Field3D *GradPhiz3D    = static_cast<Field3D *>( GradPhiz_ );
-    Field3D *GradPhiz_m3D  = static_cast<Field3D *>( GradPhiz_m );
-    
-    
-    for( unsigned int i=0 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=0 ; j < A_->dims_[1]-1 ; j++ ) { // y loop
-            for( unsigned int k=0 ; k < A_->dims_[2]-1; k++ ) { // z loop
+    const double *const __restrict__ Phi3D      = Phi_->data();
+    const double *const __restrict__ GradPhix3D = GradPhix_->data();
+    const double *const __restrict__ GradPhiy3D = GradPhiy_->data();
+    const double *const __restrict__ GradPhiz3D = GradPhiz_->data();
+    double *const __restrict__ Phi_m3D          = Phi_m->data();
+    double *const __restrict__ GradPhix_m3D     = GradPhix_m->data();
+    double *const __restrict__ GradPhiy_m3D     = GradPhiy_m->data();
+    double *const __restrict__ GradPhiz_m3D     = GradPhiz_m->data();
+
+    const int nx = A_->dims_[0];
+    const int ny = A_->dims_[1];
+    const int nz = A_->dims_[2];
+    
+    for( int i=0 ; i<nx-1 ; i++ ) { // x loop
+        for( int j=0 ; j<ny-1 ; j++ ) { // y loop
+            for( int k=0 ; k<nz-1 ; k++ ) { // z loop
+                const int idx = ( i*ny+j )*nz+k;
             
                 // ponderomotive potential Phi=|A|^2/2
-                ( *Phi_m3D )( i, j, k )       = ( *Phi3D )( i, j, k );
+                Phi_m3D[idx]      = Phi3D[idx];
                 
                 // gradient of ponderomotive potential
-                ( *GradPhix_m3D )( i, j, k )  = ( *GradPhix3D )( i, j, k );
-                ( *GradPhiy_m3D )( i, j, k )  = ( *GradPhiy3D )( i, j, k );
-                ( *GradPhiz_m3D )( i, j, k )  = ( *GradPhiz3D )( i, j, k );
+                GradPhix_m3D[idx] = GradPhix3D[idx];
+                GradPhiy_m3D[idx] = GradPhiy3D[idx];
+                GradPhiz_m3D[idx] = GradPhiz3D[idx];
                 
             } // end z loop
         } // end y loop
@@ -519,32 +499,33 @@ void LaserEnvelope3D::savePhiAndGradPhi()
 
 void LaserEnvelope3D::centerPhiAndGradPhi()
 {
-    // Static cast of the fields
-    Field3D *Phi3D         = static_cast<Field3D *>( Phi_ );
-    Field3D *Phi_m3D       = static_cast<Field3D *>( Phi_m );
-    
-    Field3D *GradPhix3D    = static_cast<Field3D *>( GradPhix_ );
-    Field3D *GradPhix_m3D  = static_cast<Field3D *>( GradPhix_m );
-    
-    Field3D *GradPhiy3D    = static_cast<Field3D *>( GradPhiy_ );
-    Field3D *GradPhiy_m3D  = static_cast<Field3D *>( GradPhiy_m );
-    
-    Field3D *GradPhiz3D    = static_cast<Field3D *>( GradPhiz_ );
-    Field3D *GradPhiz_m3D  = static_cast<Field3D *>( GradPhiz_m );
+    const double *const __restrict__ Phi3D      = Phi_->data();
+    const double *const __restrict__ GradPhix3D = GradPhix_->data();
+    const double *const __restrict__ GradPhiy3D = GradPhiy_->data();
+    const double *const __restrict__ GradPhiz3D = GradPhiz_->data();
+    double *const __restrict__ Phi_m3D          = Phi_m->data();
+    double *const __restrict__ GradPhix_m3D     = GradPhix_m->data();
+    double *const __restrict__ GradPhiy_m3D     = GradPhiy_m->data();
+    double *const __restrict__ GradPhiz_m3D     = GradPhiz_m->data();
+
+    const int nx = A_->dims_[0];
+    const int ny = A_->dims_[1];
+    const int nz = A_->dims_[2];
     
     // Phi_m and GradPhi_m quantities now contain values at timestep n
     
-    for( unsigned int i=0 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=0 ; j < A_->dims_[1]-1 ; j++ ) { // y loop
-            for( unsigned int k=0 ; k < A_->dims_[2]-1; k++ ) { // z loop
+    for( int i=0 ; i<nx-1 ; i++ ) { // x loop
+        for( int j=0 ; j<ny-1 ; j++ ) { // y loop
+            for( int k=0 ; k<nz-1 ; k++ ) { // z loop
+                const int idx = ( i*ny+j )*nz+k;
             
                 // ponderomotive potential Phi=|A|^2/2
-                ( *Phi_m3D )( i, j, k )       = 0.5*( ( *Phi_m3D )( i, j, k )+( *Phi3D )( i, j, k ) );
+                Phi_m3D[idx]      = 0.5*( Phi_m3D[idx]+Phi3D[idx] );
                 
                 // gradient of ponderomotive potential
-                ( *GradPhix_m3D )( i, j, k )  = 0.5*( ( *GradPhix_m3D )( i, j, k )+( *GradPhix3D )( i, j, k ) );
-                ( *GradPhiy_m3D )( i, j, k )  = 0.5*( ( *GradPhiy_m3D )( i, j, k )+( *GradPhiy3D )( i, j, k ) );
-                ( *GradPhiz_m3D )( i, j, k )  = 0.5*( ( *GradPhiz_m3D )( i, j, k )+( *GradPhiz3D )( i, j, k ) );
+                GradPhix_m3D[idx] = 0.5*( GradPhix_m3D[idx]+GradPhix3D[idx] );
+                GradPhiy_m3D[idx] = 0.5*( GradPhiy_m3D[idx]+GradPhiy3D[idx] );
+                GradPhiz_m3D[idx] = 0.5*( GradPhiz_m3D[idx]+GradPhiz3D[idx] );
                 
             } // end z loop
         } // end y loop
@@ -557,3 +538,78 @@ void LaserEnvelope3D::centerPhiAndGradPhi()
 }//END centerPhiAndGradPhi
 
 
+void LaserEnvelope3D::computePhiAndGradPhi( ElectroMagn *EMfields )
+{
+    // Same as computePhiEnvAEnvE, computeGradientPhi and centerPhiAndGradPhi in a single pass along x:
+    // Phi, |A|, |E| and |Ex| are computed in the plane i, then the gradient of Phi in the plane i-1,
+    // whose stencil is complete, and both are centered at once at timestep n+1/2
+
+    const double *const __restrict__ A3D  = reinterpret_cast<const double *>( static_cast<cField3D *>( A_ )->cdata_ );  // the envelope at timestep n
+    const double *const __restrict__ A03D = reinterpret_cast<const double *>( static_cast<cField3D *>( A0_ )->cdata_ ); // the envelope at timestep n-1
+    double *const __restrict__ Phi3D        = Phi_->data();
+    double *const __restrict__ GradPhix3D   = GradPhix_->data();
+    double *const __restrict__ GradPhiy3D   = GradPhiy_->data();
+    double *const __restrict__ GradPhiz3D   = GradPhiz_->data();
+    double *const __restrict__ Phi_m3D      = Phi_m->data();
+    double *const __restrict__ GradPhix_m3D = GradPhix_m->data();
+    double *const __restrict__ GradPhiy_m3D = GradPhiy_m->data();
+    double *const __restrict__ GradPhiz_m3D = GradPhiz_m->data();
+    double *const __restrict__ Env_Aabs3D   = EMfields->Env_A_abs_->data();
+    double *const __restrict__ Env_Eabs3D   = EMfields->Env_E_abs_->data();
+    double *const __restrict__ Env_Exabs3D  = EMfields->Env_Ex_abs_->data();
+
+    const int nx = A_->dims_[0];
+    const int ny = A_->dims_[1];
+    const int nz = A_->dims_[2];
+    const int nyz = ny*nz;
+
+    for( int i=1 ; i<nx ; i++ ) { // x loop
+
+        // Ponderomotive potential Phi=|A|^2/2, |A|, |E| and |Ex| in the plane i
+        if( i < nx-1 ) {
+            for( int j=1 ; j<ny-1 ; j++ ) { // y loop
+                const int row = i*nyz+j*nz;
+                const double *const __restrict__ A   = A3D+2*row;
+                const double *const __restrict__ A0  = A03D+2*row;
+                const double *const __restrict__ Aym = A-2*nz;
+                const double *const __restrict__ Ayp = A+2*nz;
+                #pragma omp simd
+                for( int k=1 ; k<nz-1 ; k++ ) { // z loop
+                    const int re = 2*k, im = 2*k+1;
+                    const double A_abs_sq = A[re]*A[re]+A[im]*A[im];
+                    Phi3D[row+k]      = ellipticity_factor*A_abs_sq*0.5;
+                    Env_Aabs3D[row+k] = std::sqrt( A_abs_sq );
+                    // |E envelope| = |-(dA/dt-ik0cA)|, forward finite differences for the time derivative
+                    const double E_re = ( A[re]-A0[re] )/timestep + omega*A[im];
+                    const double E_im = ( A[im]-A0[im] )/timestep - omega*A[re];
+                    Env_Eabs3D[row+k] = std::sqrt( E_re*E_re+E_im*E_im );
+                    // |Ex envelope| = |-(dA/dy|, central finite difference for the space derivative
+                    const double Ex_re = ( Ayp[re]-Aym[re] )*one_ov_2dy;
+                    const double Ex_im = ( Ayp[im]-Aym[im] )*one_ov_2dy;
+                    Env_Exabs3D[row+k] = std::sqrt( Ex_re*Ex_re+Ex_im*Ex_im );
+                } // end z loop
+            } // end y loop
+        }
+
+        // Gradient of Phi in the plane i-1, and centering at timestep n+1/2
+        if( i >= 2 ) {
+            for( int j=1 ; j<ny-1 ; j++ ) { // y loop
+                const int row = ( i-1 )*nyz+j*nz;
+                #pragma omp simd
+                for( int k=1 ; k<nz-1 ; k++ ) { // z loop
+                    const int idx = row+k;
+                    GradPhix3D[idx] = ( Phi3D[idx+nyz]-Phi3D[idx-nyz] ) * one_ov_2dx;
+                    GradPhiy3D[idx] = ( Phi3D[idx+nz]-Phi3D[idx-nz] ) * one_ov_2dy;
+                    GradPhiz3D[idx] = ( Phi3D[idx+1]-Phi3D[idx-1] ) * one_ov_2dz;
+                    Phi_m3D[idx]      = 0.5*( Phi_m3D[idx]+Phi3D[idx] );
+                    GradPhix_m3D[idx] = 0.5*( GradPhix_m3D[idx]+GradPhix3D[idx] );
+                    GradPhiy_m3D[idx] = 0.5*( GradPhiy_m3D[idx]+GradPhiy3D[idx] );
+                    GradPhiz_m3D[idx] = 0.5*( GradPhiz_m3D[idx]+GradPhiz3D[idx] );
+                } // end z loop
+            } // end y loop
+        }
+    } // end x loop
+    // Outside of the planes and lines computed here, Phi and GradPhi are unchanged since savePhiAndGradPhi:
+    // their centered values are already in Phi_m and GradPhi_m
+
+} // end LaserEnvelope3D::computePhiAndGradPhi
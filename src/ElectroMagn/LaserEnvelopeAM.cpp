@@ -179,6 +179,143 @@ LaserEnvelopeAM::~LaserEnvelopeAM()
 {
 }
 
+// Extrapolates the susceptibility near the rmax boundary of the simulation domain,
+// in the cells [ibegin, iend[ along l
+static void extrapolateEnvChiAtRmax( double *const __restrict__ Env_Chi2Dcyl, const int nr, const int ibegin, const int iend )
+{
+    for( int i=ibegin ; i<iend ; i++ ) {
+        for( int j=nr-4 ; j<nr-1 ; j++ ) {
+            Env_Chi2Dcyl[i*nr+j] = Env_Chi2Dcyl[i*nr+nr-5];
+        }
+    }
+}
+
+// Explicit solvers on CPU (see updateEnvelope and updateEnvelopeReducedDispersion for the scheme).
+// The complex arithmetic is split in real and imaginary parts, so that the loops along r are vectorized.
+// The lines along l are advanced in order, and the new envelope is kept in a ring of lines until
+// the stencil does not need A^n there anymore: A and A0 are then swapped in the same pass.
+template<bool reduced_dispersion>
+void LaserEnvelopeAM::advanceEnvelope( Patch *patch )
+{
+    double *const __restrict__ A2Dcyl   = reinterpret_cast<double *>( static_cast<cField2D *>( A_ )->cdata_ );  // the envelope at timestep n
+    double *const __restrict__ A02Dcyl  = reinterpret_cast<double *>( static_cast<cField2D *>( A0_ )->cdata_ ); // the envelope at timestep n-1
+    double *const __restrict__ Env_Chi2Dcyl = patch->EMfields->Env_Chi_->data(); // source term of envelope equation
+
+    const int  j_glob = ( static_cast<ElectroMagnAM *>( patch->EMfields ) )->j_glob_;
+    const bool isYmin = patch->isBoundary( 1, 0 );
+    const bool isYmax = patch->isBoundary( 1, 1 );
+
+    const int nl = A_->dims_[0];
+    const int nr = A_->dims_[1];
+
+    // Half width of the stencil along l
+    const int width = reduced_dispersion ? 2 : 1;
+    A_new_planes_.resize( ( width+1 )*nr );
+    double *const __restrict__ A_new2Dcyl = reinterpret_cast<double *>( A_new_planes_.data() );
+
+    // Coefficients of the derivatives along l, with the optimized form of the reduced dispersion scheme
+    const double dll1 = reduced_dispersion ? ( 1.+delta )*one_ov_dl_sq : one_ov_dl_sq;
+    const double dll2 = -delta*one_ov_dl_sq*0.25;
+    const double dl1  = reduced_dispersion ? 1.+delta : 1.;
+    const double dl2  = -delta*0.5;
+    const double one_ov_dr_sq = this->one_ov_dr_sq;
+    const double one_ov_2dr   = this->one_ov_2dr;
+    const double dr           = this->dr;
+    const double dt_sq        = this->dt_sq;
+    const double c1_re = std::real( i1_2k0_over_2dl ), c1_im = std::imag( i1_2k0_over_2dl );
+    const double c2_re = std::real( one_plus_ik0dt ), c2_im = std::imag( one_plus_ik0dt );
+    const double c3_re = std::real( one_plus_ik0dt_ov_one_plus_k0sq_dtsq ), c3_im = std::imag( one_plus_ik0dt_ov_one_plus_k0sq_dtsq );
+
+    const int ibegin = width;
+    const int iend   = nl-width;
+    if( isYmax ) {
+        extrapolateEnvChiAtRmax( Env_Chi2Dcyl, nr, ibegin, iend );
+    }
+
+    // The ghost cells j=0 of the patches off axis are not solved: the envelope is set to 0 there,
+    // and the cell j=2 is on axis (r=0) for the patches at rmin
+    const int jbegin = isYmin ? 2 : 0;
+    const int jsimd  = isYmin ? 3 : 1;
+
+    for( int i=ibegin ; i<iend+width ; i++ ) { // l loop
+
+        // New envelope in the line i
+        if( i < iend ) {
+            const double *const __restrict__ A    = A2Dcyl+2*i*nr;
+            const double *const __restrict__ Alm  = A-2*nr;
+            const double *const __restrict__ Alp  = A+2*nr;
+            const double *const __restrict__ Alm2 = reduced_dispersion ? A-4*nr : A;
+            const double *const __restrict__ Alp2 = reduced_dispersion ? A+4*nr : A;
+            const double *const __restrict__ A0   = A02Dcyl+2*i*nr;
+            const double *const __restrict__ Chi  = Env_Chi2Dcyl+i*nr;
+            double *const __restrict__ A_new      = A_new2Dcyl + 2*( i%( width+1 ) )*nr;
+            if( isYmin ) { // axis BC, j_p = 2 corresponds to r=0: 4*(A_{j+1}-A_j)/dr^2 as radial part
+                const int re = 4, im = 5;
+                double lap_re = -Chi[2]*A[re] + ( Alm[re]-2.*A[re]+Alp[re] )*dll1 + 4.*( A[re+2]-A[re] )*one_ov_dr_sq;
+                double lap_im = -Chi[2]*A[im] + ( Alm[im]-2.*A[im]+Alp[im] )*dll1 + 4.*( A[im+2]-A[im] )*one_ov_dr_sq;
+                double dA_re = ( Alp[re]-Alm[re] )*dl1;
+                double dA_im = ( Alp[im]-Alm[im] )*dl1;
+                if( reduced_dispersion ) {
+                    lap_re += ( Alm2[re]-2.*A[re]+Alp2[re] )*dll2;
+                    lap_im += ( Alm2[im]-2.*A[im]+Alp2[im] )*dll2;
+                    dA_re  += ( Alp2[re]-Alm2[re] )*dl2;
+                    dA_im  += ( Alp2[im]-Alm2[im] )*dl2;
+                }
+                const double A_new_re = ( lap_re + c1_re*dA_re - c1_im*dA_im )*dt_sq + 2.*A[re] - ( c2_re*A0[re] - c2_im*A0[im] );
+                const double A_new_im = ( lap_im + c1_re*dA_im + c1_im*dA_re )*dt_sq + 2.*A[im] - ( c2_re*A0[im] + c2_im*A0[re] );
+                A_new[re] = c3_re*A_new_re - c3_im*A_new_im;
+                A_new[im] = c3_re*A_new_im + c3_im*A_new_re;
+            } else {
+                A_new[0] = 0.;
+                A_new[1] = 0.;
+            }
+            #pragma omp simd
+            for( int j=jsimd ; j<nr-1 ; j++ ) { // r loop
+                const int re = 2*j, im = 2*j+1;
+                const double one_ov_2rdr = one_ov_2dr / ( ( double )( j_glob+j )*dr );
+                // laplacian - source term Chi*A
+                double lap_re = -Chi[j]*A[re]
+                                + ( Alm[re]-2.*A[re]+Alp[re] )*dll1
+                                + ( A[re-2]-2.*A[re]+A[re+2] )*one_ov_dr_sq
+                                + ( A[re+2]-A[re-2] )*one_ov_2rdr;
+                double lap_im = -Chi[j]*A[im]
+                                + ( Alm[im]-2.*A[im]+Alp[im] )*dll1
+                                + ( A[im-2]-2.*A[im]+A[im+2] )*one_ov_dr_sq
+                                + ( A[im+2]-A[im-2] )*one_ov_2rdr;
+                // dA/dl times 2dl
+                double dA_re = ( Alp[re]-Alm[re] )*dl1;
+                double dA_im = ( Alp[im]-Alm[im] )*dl1;
+                if( reduced_dispersion ) {
+                    lap_re += ( Alm2[re]-2.*A[re]+Alp2[re] )*dll2;
+                    lap_im += ( Alm2[im]-2.*A[im]+Alp2[im] )*dll2;
+                    dA_re  += ( Alp2[re]-Alm2[re] )*dl2;
+                    dA_im  += ( Alp2[im]-Alm2[im] )*dl2;
+                }
+                // (laplacian - Chi*A + 2ik0*dA/dl)*dt^2 + 2A - (1+ik0cdt)A0
+                const double A_new_re = ( lap_re + c1_re*dA_re - c1_im*dA_im )*dt_sq + 2.*A[re] - ( c2_re*A0[re] - c2_im*A0[im] );
+                const double A_new_im = ( lap_im + c1_re*dA_im + c1_im*dA_re )*dt_sq + 2.*A[im] - ( c2_re*A0[im] + c2_im*A0[re] );
+                // times (1+ik0dct)/(1+k0^2c^2dt^2)
+                A_new[re] = c3_re*A_new_re - c3_im*A_new_im;
+                A_new[im] = c3_re*A_new_im + c3_im*A_new_re;
+            } // end r loop
+        }
+
+        // A^n is not needed anymore in the line i-width: it goes to A0 and the new envelope to A
+        const int iold = i-width;
+        if( iold >= ibegin ) {
+            const double *const __restrict__ A_new = A_new2Dcyl + 2*( iold%( width+1 ) )*nr;
+            double *const __restrict__ A  = A2Dcyl+2*iold*nr;
+            double *const __restrict__ A0 = A02Dcyl+2*iold*nr;
+            #pragma omp simd
+            for( int j=2*jbegin ; j<2*nr-2 ; j++ ) { // r loop, real and imaginary parts
+                A0[j] = A[j];
+                A[j]  = A_new[j];
+            }
+        }
+    } // end l loop
+
+} // end LaserEnvelopeAM::advanceEnvelope
+
 void LaserEnvelopeAM::updateEnvelope( Patch *patch )
 {
     //// solves envelope equation in lab frame (see doc):
@@ -192,77 +329,7 @@ void LaserEnvelopeAM::updateEnvelope( Patch *patch )
     // A0 is A^{n-1}
     //      (d^2A/dl^2) @ time n and indices ij = (A^{n}_{i+1,j}-2*A^{n}_{i,j}+A^{n}_{i-1,j})/dl^2
     
-   
-    cField2D *A2Dcyl       = static_cast<cField2D *>( A_ );               // the envelope at timestep n
-    cField2D *A02Dcyl      = static_cast<cField2D *>( A0_ );              // the envelope at timestep n-1
-    Field2D *Env_Chi2Dcyl  = static_cast<Field2D *>( patch->EMfields->Env_Chi_ ); // source term of envelope equation
-  
-    int  j_glob = ( static_cast<ElectroMagnAM *>( patch->EMfields ) )->j_glob_;
-    bool isYmin = patch->isBoundary( 1, 0 );
-    bool isYmax = patch->isBoundary( 1, 1 );
-
-    // temporary variable for updated envelope
-    cField2D *A2Dcylnew;
-    A2Dcylnew  = new cField2D( A_->dims_ );
-
-    if (isYmax){
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) {
-            for ( unsigned int j=A_->dims_[1]-4 ; j < A_->dims_[1]-1 ; j++ ) {
-                ( *Env_Chi2Dcyl )( i, j ) = 1.*( *Env_Chi2Dcyl )( i, A_->dims_[1]-5 );
-            }
-        }
-    }
- 
-    //// explicit solver
-    for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // l loop
-        for( unsigned int j=std::max(3*isYmin,1) ; j < A_->dims_[1]-1 ; j++ ) { // r loop
-            ( *A2Dcylnew )( i, j ) -= ( *Env_Chi2Dcyl )( i, j )*( *A2Dcyl )( i, j ); // subtract here source term Chi*A from plasma
-            // A2Dcylnew = laplacian - source term
-            ( *A2Dcylnew )( i, j ) += ( ( *A2Dcyl )( i-1, j )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i+1, j ) )*one_ov_dl_sq; // l part
-            ( *A2Dcylnew )( i, j ) += ( ( *A2Dcyl )( i, j-1 )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i, j+1 ) )*one_ov_dr_sq; // r part
-            ( *A2Dcylnew )( i, j ) += ( ( *A2Dcyl )( i, j+1 )-( *A2Dcyl )( i, j-1 ) ) * one_ov_2dr / ( ( double )( j_glob+j )*dr ); // r part         
-
-            // A2Dcylnew = A2Dcylnew+2ik0*dA/dl
-            ( *A2Dcylnew )( i, j ) += i1_2k0_over_2dl*( ( *A2Dcyl )( i+1, j )-( *A2Dcyl )( i-1, j ) );
-            // A2Dcylnew = A2Dcylnew*dt^2
-            ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*dt_sq;
-            // A2Dcylnew = A2Dcylnew + 2/c^2 A2Dcyl - (1+ik0cdt)A02Dcyl/c^2
-            ( *A2Dcylnew )( i, j ) += 2.*( *A2Dcyl )( i, j )-one_plus_ik0dt*( *A02Dcyl )( i, j );
-            // A2Dcylnew = A2Dcylnew * (1+ik0dct)/(1+k0^2c^2dt^2)
-            ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*one_plus_ik0dt_ov_one_plus_k0sq_dtsq;
-        } // end r loop
-    } // end l loop
-
-    if (isYmin){ // axis BC
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // l loop
-           unsigned int j = 2; // j_p = 2 corresponds to r=0
-
-           ( *A2Dcylnew )( i, j ) -= ( *Env_Chi2Dcyl )( i, j )*( *A2Dcyl )( i, j ); // subtract here source term Chi*A from plasma
-           ( *A2Dcylnew )( i, j ) += ( ( *A2Dcyl )( i-1, j )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i+1, j ) )*one_ov_dl_sq; // l part
-           ( *A2Dcylnew )( i, j ) += 4. * ( ( *A2Dcyl )( i, j+1 )-( *A2Dcyl )( i, j ) ) * one_ov_dr_sq; // r part
-
-           // A2Dcylnew = A2Dcylnew+2ik0*dA/dl
-           ( *A2Dcylnew )( i, j ) += i1_2k0_over_2dl*( ( *A2Dcyl )( i+1, j )-( *A2Dcyl )( i-1, j ) );
-           // A2Dcylnew = A2Dcylnew*dt^2
-           ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*dt_sq;
-           // A2Dcylnew = A2Dcylnew + 2/c^2 A2Dcyl - (1+ik0cdt)A02Dcyl/c^2
-           ( *A2Dcylnew )( i, j ) += 2.*( *A2Dcyl )( i, j )-one_plus_ik0dt*( *A02Dcyl )( i, j );
-           // A2Dcylnew = A2Dcylnew * (1+ik0dct)/(1+k0^2c^2dt^2)
-           ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*one_plus_ik0dt_ov_one_plus_k0sq_dtsq;
-           
-        } 
-    }    
-
-    for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=isYmin*2 ; j < A_->dims_[1]-1 ; j++ ) { // r loop
-            // final back-substitution
-            ( *A02Dcyl )( i, j )       = ( *A2Dcyl )( i, j );
-            ( *A2Dcyl )( i, j )        = ( *A2Dcylnew )( i, j );
-        } // end r loop
-    } // end l loop
-
-
-    delete A2Dcylnew;
+    advanceEnvelope<false>( patch );
 } // end LaserEnvelopeAM::updateEnvelope
 
 void LaserEnvelopeAM::updateEnvelopeReducedDispersion( Patch *patch )
@@ -285,81 +352,7 @@ void LaserEnvelopeAM::updateEnvelopeReducedDispersion( Patch *patch )
     // (dA/dl)_opt = (1+delta)*(dA/dl) - delta*(A_{i+2,j,k}-A_{i-2,j,k})/4/dl
     // (d^2A/dl^2)_opt = (1+delta)*(d^2A/dl^2) - delta*(A_{i+2,j,k}-2*A_{i,j,k}+A_{i-2,j,k})/(4dl^2)
   
-   
-    cField2D *A2Dcyl       = static_cast<cField2D *>( A_ );                  // the envelope at timestep n
-    cField2D *A02Dcyl      = static_cast<cField2D *>( A0_ );                 // the envelope at timestep n-1
-    Field2D *Env_Chi2Dcyl  = static_cast<Field2D *>( patch->EMfields->Env_Chi_ );   // source term of envelope equation
-  
-    int  j_glob = ( static_cast<ElectroMagnAM *>( patch->EMfields ) )->j_glob_;
-    bool isYmin = patch->isBoundary( 1, 0 );//( static_cast<ElectroMagn2D *>( EMfields ) )->isYmin;
-    bool isYmax = patch->isBoundary( 1, 1 );//( static_cast<ElectroMagn2D *>( EMfields ) )->isYmax;
-
-    // temporary variable for updated envelope
-    cField2D *A2Dcylnew;
-    A2Dcylnew  = new cField2D( A_->dims_ );
-
-    if (isYmax){
-        for( unsigned int i=2 ; i <A_->dims_[0]-2; i++ ) {
-            for ( unsigned int j=A_->dims_[1]-4 ; j < A_->dims_[1]-1 ; j++ ) {
-                ( *Env_Chi2Dcyl )( i, j ) = 1.*( *Env_Chi2Dcyl )( i, A_->dims_[1]-5 );
-            }
-        }
-    }
-
-    //// explicit solver
-    for( unsigned int i=2 ; i <A_->dims_[0]-2; i++ ) { // l loop
-        for( unsigned int j=std::max(3*isYmin,1) ; j < A_->dims_[1]-1 ; j++ ) { // r loop
-            ( *A2Dcylnew )( i, j ) -= ( *Env_Chi2Dcyl )( i, j )*( *A2Dcyl )( i, j ); // subtract here source term Chi*A from plasma
-            // A2Dcylnew = laplacian - source term
-            ( *A2Dcylnew )( i, j ) += (1.+delta)*( ( *A2Dcyl )( i-1, j )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i+1, j ) )*one_ov_dl_sq; // l part with optimized derivative
-            ( *A2Dcylnew )( i, j ) -= delta*     ( ( *A2Dcyl )( i-2, j )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i+2, j ) )*one_ov_dl_sq*0.25;
-            ( *A2Dcylnew )( i, j ) +=            ( ( *A2Dcyl )( i, j-1 )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i, j+1 ) )*one_ov_dr_sq; // r part
-            ( *A2Dcylnew )( i, j ) +=            ( ( *A2Dcyl )( i, j+1 )-   ( *A2Dcyl )( i, j-1 ) ) * one_ov_2dr / ( ( double )( j_glob+j )*dr ); // r part         
-
-            // A2Dcylnew = A2Dcylnew+2ik0*dA/dl, where dA/dl uses the optimized form
-            ( *A2Dcylnew )( i, j ) += i1_2k0_over_2dl*(1.+delta)*( ( *A2Dcyl )( i+1, j )-( *A2Dcyl )( i-1, j ) );
-            ( *A2Dcylnew )( i, j ) -= i1_2k0_over_2dl*delta*0.5 *( ( *A2Dcyl )( i+2, j )-( *A2Dcyl )( i-2, j ) );
-            // A2Dcylnew = A2Dcylnew*dt^2
-            ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*dt_sq;
-            // A2Dcylnew = A2Dcylnew + 2/c^2 A2Dcyl - (1+ik0cdt)A02Dcyl/c^2
-            ( *A2Dcylnew )( i, j ) += 2.*( *A2Dcyl )( i, j )-one_plus_ik0dt*( *A02Dcyl )( i, j );
-            // A2Dcylnew = A2Dcylnew * (1+ik0dct)/(1+k0^2c^2dt^2)
-            ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*one_plus_ik0dt_ov_one_plus_k0sq_dtsq;
-        } // end r loop
-    } // end l loop
-
-    if (isYmin){ // axis BC
-        for( unsigned int i=2 ; i <A_->dims_[0]-2; i++ ) { // l loop
-           unsigned int j = 2; // j_p = 2 corresponds to r=0
-
-           ( *A2Dcylnew )( i, j ) -= ( *Env_Chi2Dcyl )( i, j )*( *A2Dcyl )( i, j ); // subtract here source term Chi*A from plasma
-           ( *A2Dcylnew )( i, j ) += (1.+delta)*( ( *A2Dcyl )( i-1, j )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i+1, j ) )*one_ov_dl_sq; // l part with optimized derivative
-           ( *A2Dcylnew )( i, j ) -= delta*     ( ( *A2Dcyl )( i-2, j )-2.*( *A2Dcyl )( i, j )+( *A2Dcyl )( i+2, j ) )*one_ov_dl_sq*0.25;
-           ( *A2Dcylnew )( i, j ) += 4. *       ( ( *A2Dcyl )( i, j+1 )   -( *A2Dcyl )( i, j ) ) * one_ov_dr_sq; // r part
-
-           // A2Dcylnew = A2Dcylnew+2ik0*dA/dl, where dA/dl uses the optimized form
-           ( *A2Dcylnew )( i, j ) += i1_2k0_over_2dl*(1.+delta)*( ( *A2Dcyl )( i+1, j )-( *A2Dcyl )( i-1, j ) );
-           ( *A2Dcylnew )( i, j ) -= i1_2k0_over_2dl*delta*0.5 *( ( *A2Dcyl )( i+2, j )-( *A2Dcyl )( i-2, j ) );
-           // A2Dcylnew = A2Dcylnew*dt^2
-           ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*dt_sq;
-           // A2Dcylnew = A2Dcylnew + 2/c^2 A2Dcyl - (1+ik0cdt)A02Dcyl/c^2
-           ( *A2Dcylnew )( i, j ) += 2.*( *A2Dcyl )( i, j )-one_plus_ik0dt*( *A02Dcyl )( i, j );
-           // A2Dcylnew = A2Dcylnew * (1+ik0dct)/(1+k0^2c^2dt^2)
-           ( *A2Dcylnew )( i, j )  = ( *A2Dcylnew )( i, j )*one_plus_ik0dt_ov_one_plus_k0sq_dtsq;
-           
-        } 
-    }    
-
-    for( unsigned int i=2 ; i <A_->dims_[0]-2; i++ ) { // x loop
-        for( unsigned int j=isYmin*2 ; j < A_->dims_[1]-1 ; j++ ) { // r loop
-            // final back-substitution
-            ( *A02Dcyl )( i, j )       = ( *A2Dcyl )( i, j );
-            ( *A2Dcyl )( i, j )        = ( *A2Dcylnew )( i, j );            
-        } // end r loop
-    } // end l loop
-
-
-    delete A2Dcylnew;
+    advanceEnvelope<true>( patch );
 } // end LaserEnvelopeAM::updateEnvelopeReducedDispersion
 
 
@@ -368,54 +361,55 @@ void LaserEnvelopeAM::computePhiEnvAEnvE( ElectroMagn *EMfields )
 
     // computes Phi=|A|^2/2 (the ponderomotive potential), new values immediately after the envelope update
     
-    cField2D *A2Dcyl          = static_cast<cField2D *>( A_ );               // the envelope at timestep n
+    const std::complex<double> *const __restrict__ A2Dcyl  = static_cast<cField2D *>( A_ )->cdata_;  // the envelope at timestep n
+    const std::complex<double> *const __restrict__ A02Dcyl = static_cast<cField2D *>( A0_ )->cdata_; // the envelope at timestep n-1
+    double *const __restrict__ Phi2Dcyl       = Phi_->data();                  //Phi=|A|^2/2 is the ponderomotive potential
+    double *const __restrict__ Env_Aabs2Dcyl  = EMfields->Env_A_abs_->data();  // field for diagnostic and ionization
+    double *const __restrict__ Env_Eabs2Dcyl  = EMfields->Env_E_abs_->data();  // field for diagnostic and ionization
+    double *const __restrict__ Env_Exabs2Dcyl = EMfields->Env_Ex_abs_->data(); // field for diagnostic and ionization
 
-    cField2D *A02Dcyl      = static_cast<cField2D *>( A0_ );                 // the envelope at timestep n-1
-    
-    Field2D *Phi2Dcyl         = static_cast<Field2D *>( Phi_ );              //Phi=|A|^2/2 is the ponderomotive potential
-    
-    Field2D *Env_Aabs2Dcyl = static_cast<Field2D *>( EMfields->Env_A_abs_ ); // field for diagnostic and ionization
+    const bool isYmin = ( static_cast<ElectroMagnAM *>( EMfields ) )->isYmin;
 
-    Field2D *Env_Eabs2Dcyl = static_cast<Field2D *>( EMfields->Env_E_abs_ ); // field for diagnostic and ionization
+    const int nl = A_->dims_[0];
+    const int nr = A_->dims_[1];
 
-    Field2D *Env_Exabs2Dcyl = static_cast<Field2D *>( EMfields->Env_Ex_abs_ ); // field for diagnostic and ionization
+    const double ellipticity_factor = this->ellipticity_factor;
+    const double one_ov_2dr         = this->one_ov_2dr;
+    const double timestep           = this->timestep;
+    const std::complex<double> i1_omega = i1*omega;
 
-    bool isYmin = ( static_cast<ElectroMagnAM *>( EMfields ) )->isYmin;
-
-    //int  j_glob = ( static_cast<ElectroMagnAM *>( EMfields ) )->j_glob_;
-    
     
     // Compute ponderomotive potential Phi=|A|^2/2, at timesteps n+1, including ghost cells
-    for( unsigned int i=0 ; i <A_->dims_[0]-1; i++ ) { // x loop
-        for( unsigned int j=std::max(3*isYmin,1) ; j < A_->dims_[1]-1; j++ ) { // r loop
-            ( *Phi2Dcyl )( i, j )       = ellipticity_factor*std::abs( ( *A2Dcyl )( i, j ) ) * std::abs( ( *A2Dcyl )( i, j ) ) * 0.5;
-            ( *Env_Aabs2Dcyl )( i, j )  = std::abs( ( *A2Dcyl )( i, j ) );
+    for( int i=0 ; i<nl-1 ; i++ ) { // l loop
+        for( int j=isYmin ? 3 : 1 ; j<nr-1 ; j++ ) { // r loop
+            const int idx = i*nr+j;
+            const double A_abs = std::abs( A2Dcyl[idx] );
+            Phi2Dcyl[idx]       = ellipticity_factor*A_abs*A_abs*0.5;
+            Env_Aabs2Dcyl[idx]  = A_abs;
             // |E envelope| = |-(dA/dt-ik0cA)|, forward finite difference for the time derivative
-            ( *Env_Eabs2Dcyl )( i, j )  = std::abs( ( ( *A2Dcyl )( i, j )-( *A02Dcyl )( i, j ) )/timestep - i1*omega*( *A2Dcyl )( i, j ) );
+            Env_Eabs2Dcyl[idx]  = std::abs( ( A2Dcyl[idx]-A02Dcyl[idx] )/timestep - i1_omega*A2Dcyl[idx] );
             // |Ex envelope| = |-dA/dr|, central finite difference for the space derivative
-            ( *Env_Exabs2Dcyl )( i, j ) =  std::abs( (( *A2Dcyl )( i, j+1)-( *A2Dcyl )( i, j-1) )*one_ov_2dr );
+            Env_Exabs2Dcyl[idx] = std::abs( ( A2Dcyl[idx+1]-A2Dcyl[idx-1] )*one_ov_2dr );
         } // end r loop
     } // end l loop
 
-    // 
-    if (isYmin){ // axis BC
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // l loop
-            unsigned int j = 2;  // j_p=2 corresponds to r=0    
-            ( *Phi2Dcyl )      ( i, j )   = ellipticity_factor*std::abs( ( *A2Dcyl )( i, j ) ) * std::abs( ( *A2Dcyl )( i, j ) ) * 0.5;  
-            ( *Env_Aabs2Dcyl ) ( i, j )   = std::abs( ( *A2Dcyl )( i, j ) );
-            ( *Env_Eabs2Dcyl ) ( i, j )   = std::abs( ( ( *A2Dcyl )( i, j )-( *A02Dcyl )( i, j ) )/timestep - i1*omega*( *A2Dcyl )( i, j ) );
-            ( *Env_Exabs2Dcyl )( i, j )   = 0.;
+    if( isYmin ) { // axis BC
+        for( int i=1 ; i<nl-1 ; i++ ) { // l loop
+            const int idx = i*nr+2; // j_p=2 corresponds to r=0
+            const double A_abs = std::abs( A2Dcyl[idx] );
+            Phi2Dcyl[idx]         = ellipticity_factor*A_abs*A_abs*0.5;
+            Env_Aabs2Dcyl[idx]    = A_abs;
+            Env_Eabs2Dcyl[idx]    = std::abs( ( A2Dcyl[idx]-A02Dcyl[idx] )/timestep - i1_omega*A2Dcyl[idx] );
+            Env_Exabs2Dcyl[idx]   = 0.;
             // Axis BC on |A|
-            ( *Env_Aabs2Dcyl )( i, j-1 )  = ( *Env_Aabs2Dcyl )( i, j+1 );
-            ( *Env_Aabs2Dcyl )( i, j-2 )  = ( *Env_Aabs2Dcyl )( i, j+2 );
+            Env_Aabs2Dcyl[idx-1]  = Env_Aabs2Dcyl[idx+1];
+            Env_Aabs2Dcyl[idx-2]  = Env_Aabs2Dcyl[idx+2];
             // Axis BC on |E|
-            ( *Env_Eabs2Dcyl )( i, j-1 )  = ( *Env_Eabs2Dcyl )( i, j+1 );
-            ( *Env_Eabs2Dcyl )( i, j-2 )  = ( *Env_Eabs2Dcyl )( i, j+2 );
+            Env_Eabs2Dcyl[idx-1]  = Env_Eabs2Dcyl[idx+1];
+            Env_Eabs2Dcyl[idx-2]  = Env_Eabs2Dcyl[idx+2];
             // Axis BC on |Ex|
-            ( *Env_Exabs2Dcyl)( i, j-1 )  = ( *Env_Exabs2Dcyl)( i, j+1 );
-            ( *Env_Exabs2Dcyl)( i, j-2 )  = ( *Env_Exabs2Dcyl)( i, j+2 );
-            
-                  
+            Env_Exabs2Dcyl[idx-1] = Env_Exabs2Dcyl[idx+1];
+            Env_Exabs2Dcyl[idx-2] = Env_Exabs2Dcyl[idx+2];
         } // end l loop
     }
     
@@ -426,41 +420,41 @@ void LaserEnvelopeAM::computeGradientPhi( ElectroMagn *EMfields )
 {
 
     // computes gradient of Phi=|A|^2/2 (the ponderomotive potential), new values immediately after the envelope update
-    Field2D *GradPhil2Dcyl    = static_cast<Field2D *>( GradPhil_ );
-    Field2D *GradPhir2Dcyl    = static_cast<Field2D *>( GradPhir_ );
-    Field2D *Phi2Dcyl         = static_cast<Field2D *>( Phi_ );      //Phi=|A|^2/2 is the ponderomotive potential
-    bool isYmin = ( static_cast<ElectroMagnAM *>( EMfields ) )->isYmin;
-    
+    double *const __restrict__ GradPhil2Dcyl = GradPhil_->data();
+    double *const __restrict__ GradPhir2Dcyl = GradPhir_->data();
+    const double *const __restrict__ Phi2Dcyl = Phi_->data(); //Phi=|A|^2/2 is the ponderomotive potential
+    const bool isYmin = ( static_cast<ElectroMagnAM *>( EMfields ) )->isYmin;
+
+    const int nl = A_->dims_[0];
+    const int nr = A_->dims_[1];
+
+    const double one_ov_2dl = this->one_ov_2dl;
+    const double one_ov_2dr = this->one_ov_2dr;
+
     
     // Compute gradients of Phi, at timesteps n
-    for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // l loop
-        for( unsigned int j=std::max(3*isYmin,1) ; j < A_->dims_[1]-1 ; j++ ) { // r loop
-        
+    for( int i=1 ; i<nl-1 ; i++ ) { // l loop
+        for( int j=isYmin ? 3 : 1 ; j<nr-1 ; j++ ) { // r loop
             // gradient in l direction
-            ( *GradPhil2Dcyl )( i, j ) = ( ( *Phi2Dcyl )( i+1, j )-( *Phi2Dcyl )( i-1, j ) ) * one_ov_2dl;
+            GradPhil2Dcyl[i*nr+j] = ( Phi2Dcyl[( i+1 )*nr+j]-Phi2Dcyl[( i-1 )*nr+j] ) * one_ov_2dl;
             // gradient in r direction
-            ( *GradPhir2Dcyl )( i, j ) = ( ( *Phi2Dcyl )( i, j+1 )-( *Phi2Dcyl )( i, j-1 ) ) * one_ov_2dr;
-            
+            GradPhir2Dcyl[i*nr+j] = ( Phi2Dcyl[i*nr+j+1]-Phi2Dcyl[i*nr+j-1] ) * one_ov_2dr;
         } // end r loop
     } // end l loop
 
-    
-    if (isYmin){ // axis BC
-        for( unsigned int i=1 ; i <A_->dims_[0]-1; i++ ) { // l loop
-            unsigned int j = 2;  // j_p=2 corresponds to r=0      
-      
+    if( isYmin ) { // axis BC
+        for( int i=1 ; i<nl-1 ; i++ ) { // l loop
+            const int idx = i*nr+2; // j_p=2 corresponds to r=0
             // gradient in x direction
-            ( *GradPhil2Dcyl )( i, j ) = ( ( *Phi2Dcyl )( i+1, j )-( *Phi2Dcyl )( i-1, j ) ) * one_ov_2dl;
+            GradPhil2Dcyl[idx] = ( Phi2Dcyl[idx+nr]-Phi2Dcyl[idx-nr] ) * one_ov_2dl;
             // gradient in r direction, identically zero on r = 0
-            ( *GradPhir2Dcyl )( i, j ) = 0. ; // ( ( *Phi2Dcyl )( i, j+1 )-( *Phi2Dcyl )( i, j-1 ) ) * one_ov_2dr;
-
+            GradPhir2Dcyl[idx] = 0.;
             // Axis BC on gradient in x direction
-            ( *GradPhil2Dcyl )( i, j-1 ) = ( *GradPhil2Dcyl )( i, j+1 );
-            ( *GradPhil2Dcyl )( i, j-2 ) = ( *GradPhil2Dcyl )( i, j+2 );
+            GradPhil2Dcyl[idx-1] = GradPhil2Dcyl[idx+1];
+            GradPhil2Dcyl[idx-2] = GradPhil2Dcyl[idx+2];
             // Axis BC on gradient in r direction
-            ( *GradPhir2Dcyl )( i, j-1 ) = ( *GradPhir2Dcyl )( i, j+1 );
-            ( *GradPhir2Dcyl )( i, j-2 ) = ( *GradPhir2Dcyl )( i, j+2 );
-                            
+            GradPhir2Dcyl[idx-1] = GradPhir2Dcyl[idx+1];
+            GradPhir2Dcyl[idx-2] = GradPhir2Dcyl[idx+2];
         } // end l loop
     }
 
@@ -469,25 +463,25 @@ void LaserEnvelopeAM::computeGradientPhi( ElectroMagn *EMfields )
 
 void LaserEnvelopeAM::savePhiAndGradPhi()
 {
-    // Static cast of the fields
-    Field2D *Phi2Dcyl         = static_cast<Field2D *>( Phi_ );
-    Field2D *Phi_m2Dcyl       = static_cast<Field2D *>( Phi_m );
-    
-    Field2D *GradPhil2Dcyl    = static_cast<Field2D *>( GradPhil_ );
-    Field2D *GradPhil_m2Dcyl  = static_cast<Field2D *>( GradPhil_m );
-    
-    Field2D *GradPhir2Dcyl    = static_cast<Field2D *>( GradPhir_ );
-    Field2D *GradPhir_m2Dcyl  = static_cast<Field2D *>( GradPhir_m );
-    
-    for( unsigned int i=0 ; i <A_->dims_[0]-1; i++ ) { // l loop
-        for( unsigned int j=0 ; j < A_->dims_[1]-1 ; j++ ) { // r loop
+    const double *const __restrict__ Phi2Dcyl      = Phi_->data();
+    const double *const __restrict__ GradPhil2Dcyl = GradPhil_->data();
+    const double *const __restrict__ GradPhir2Dcyl = GradPhir_->data();
+    double *const __restrict__ Phi_m2Dcyl          = Phi_m->data();
+    double *const __restrict__ GradPhil_m2Dcyl     = GradPhil_m->data();
+    double *const __restrict__ GradPhir_m2Dcyl     = GradPhir_m->data();
+
+    const int nl = A_->dims_[0];
+    const int nr = A_->dims_[1];
+    
+    for( int i=0 ; i<nl-1 ; i++ ) { // l loop
+        for( int j=0 ; j<nr-1 ; j++ ) { // r loop
         
             // ponderomotive potential Phi=|A|^2/2
-            ( *Phi_m2Dcyl )( i, j )       = ( *Phi2Dcyl )( i, j );
+            Phi_m2Dcyl[i*nr+j]      = Phi2Dcyl[i*nr+j];
             
             // gradient of ponderomotive potential
-            ( *GradPhil_m2Dcyl )( i, j )  = ( *GradPhil2Dcyl )( i, j );
-            ( *GradPhir_m2Dcyl )( i, j )  = ( *GradPhir2Dcyl )( i, j );
+            GradPhil_m2Dcyl[i*nr+j] = GradPhil2Dcyl[i*nr+j];
+            GradPhir_m2Dcyl[i*nr+j] = GradPhir2Dcyl[i*nr+j];
             
         } // end r loop
     } // end l loop
@@ -498,27 +492,27 @@ void LaserEnvelopeAM::savePhiAndGradPhi()
 
 void LaserEnvelopeAM::centerPhiAndGradPhi()
 {
-    // Static cast of the fields
-    Field2D *Phi2Dcyl         = static_cast<Field2D *>( Phi_ );
-    Field2D *Phi_m2Dcyl       = static_cast<Field2D *>( Phi_m );
-    
-    Field2D *GradPhil2Dcyl    = static_cast<Field2D *>( GradPhil_ );
-    Field2D *GradPhil_m2Dcyl  = static_cast<Field2D *>( GradPhil_m );
-    
-    Field2D *GradPhir2Dcyl    = static_cast<Field2D *>( GradPhir_ );
-    Field2D *GradPhir_m2Dcyl  = static_cast<Field2D *>( GradPhir_m );
+    const double *const __restrict__ Phi2Dcyl      = Phi_->data();
+    const double *const __restrict__ GradPhil2Dcyl = GradPhil_->data();
+    const double *const __restrict__ GradPhir2Dcyl = GradPhir_->data();
+    double *const __restrict__ Phi_m2Dcyl          = Phi_m->data();
+    double *const __restrict__ GradPhil_m2Dcyl     = GradPhil_m->data();
+    double *const __restrict__ GradPhir_m2Dcyl     = GradPhir_m->data();
+
+    const int nl = A_->dims_[0];
+    const int nr = A_->dims_[1];
     
     // Phi_m and GradPhi_m quantities now contain values at timestep n
     
-    for( unsigned int i=0 ; i <A_->dims_[0]-1; i++ ) { // l loop
-        for( unsigned int j=0 ; j < A_->dims_[1]-1 ; j++ ) { // r loop
+    for( int i=0 ; i<nl-1 ; i++ ) { // l loop
+        for( int j=0 ; j<nr-1 ; j++ ) { // r loop
         
             // ponderomotive potential Phi=|A|^2/2
-            ( *Phi_m2Dcyl )( i, j )       = 0.5*( ( *Phi_m2Dcyl )( i, j )+( *Phi2Dcyl )( i, j ) );
+            Phi_m2Dcyl[i*nr+j]      = 0.5*( Phi_m2Dcyl[i*nr+j]+Phi2Dcyl[i*nr+j] );
             
             // gradient of ponderomotive potential
-            ( *GradPhil_m2Dcyl )( i, j )  = 0.5*( ( *GradPhil_m2Dcyl )( i, j )+( *GradPhil2Dcyl )( i, j ) );
-            ( *GradPhir_m2Dcyl )( i, j )  = 0.5*( ( *GradPhir_m2Dcyl )( i, j )+( *GradPhir2Dcyl )( i, j ) );
+            GradPhil_m2Dcyl[i*nr+j] = 0.5*( GradPhil_m2Dcyl[i*nr+j]+GradPhil2Dcyl[i*nr+j] );
+            GradPhir_m2Dcyl[i*nr+j] = 0.5*( GradPhir_m2Dcyl[i*nr+j]+GradPhir2Dcyl[i*nr+j] );
             
         } // end r loop
     } // end l loop
@@ -530,3 +524,108 @@ void LaserEnvelopeAM::centerPhiAndGradPhi()
 }//END centerPhiAndGradPhi
 
 
+void LaserEnvelopeAM::computePhiAndGradPhi( ElectroMagn *EMfields )
+{
+    // Same as computePhiEnvAEnvE, computeGradientPhi and centerPhiAndGradPhi in a single pass along l:
+    // Phi, |A|, |E| and |Ex| are computed in the line i, then the gradient of Phi in the line i-1,
+    // whose stencil is complete, and both are centered at once at timestep n+1/2
+
+    const double *const __restrict__ A2Dcyl  = reinterpret_cast<const double *>( static_cast<cField2D *>( A_ )->cdata_ );  // the envelope at timestep n
+    const double *const __restrict__ A02Dcyl = reinterpret_cast<const double *>( static_cast<cField2D *>( A0_ )->cdata_ ); // the envelope at timestep n-1
+    double *const __restrict__ Phi2Dcyl        = Phi_->data();
+    double *const __restrict__ GradPhil2Dcyl   = GradPhil_->data();
+    double *const __restrict__ GradPhir2Dcyl   = GradPhir_->data();
+    double *const __restrict__ Phi_m2Dcyl      = Phi_m->data();
+    double *const __restrict__ GradPhil_m2Dcyl = GradPhil_m->data();
+    double *const __restrict__ GradPhir_m2Dcyl = GradPhir_m->data();
+    double *const __restrict__ Env_Aabs2Dcyl   = EMfields->Env_A_abs_->data();
+    double *const __restrict__ Env_Eabs2Dcyl   = EMfields->Env_E_abs_->data();
+    double *const __restrict__ Env_Exabs2Dcyl  = EMfields->Env_Ex_abs_->data();
+
+    const bool isYmin = ( static_cast<ElectroMagnAM *>( EMfields ) )->isYmin;
+
+    const int nl = A_->dims_[0];
+    const int nr = A_->dims_[1];
+
+    // j_p=2 corresponds to r=0 for the patches at rmin, treated apart
+    const int jbegin = isYmin ? 3 : 1;
+
+    for( int i=0 ; i<nl ; i++ ) { // l loop
+
+        // Ponderomotive potential Phi=|A|^2/2, |A|, |E| and |Ex| in the line i
+        if( i < nl-1 ) {
+            const double *const __restrict__ A  = A2Dcyl+2*i*nr;
+            const double *const __restrict__ A0 = A02Dcyl+2*i*nr;
+            double *const __restrict__ Phi      = Phi2Dcyl+i*nr;
+            double *const __restrict__ Aabs     = Env_Aabs2Dcyl+i*nr;
+            double *const __restrict__ Eabs     = Env_Eabs2Dcyl+i*nr;
+            double *const __restrict__ Exabs    = Env_Exabs2Dcyl+i*nr;
+            #pragma omp simd
+            for( int j=jbegin ; j<nr-1 ; j++ ) { // r loop
+                const int re = 2*j, im = 2*j+1;
+                const double A_abs_sq = A[re]*A[re]+A[im]*A[im];
+                Phi[j]  = ellipticity_factor*A_abs_sq*0.5;
+                Aabs[j] = std::sqrt( A_abs_sq );
+                // |E envelope| = |-(dA/dt-ik0cA)|, forward finite difference for the time derivative
+                const double E_re = ( A[re]-A0[re] )/timestep + omega*A[im];
+                const double E_im = ( A[im]-A0[im] )/timestep - omega*A[re];
+                Eabs[j] = std::sqrt( E_re*E_re+E_im*E_im );
+                // |Ex envelope| = |-dA/dr|, central finite difference for the space derivative
+                const double Ex_re = ( A[re+2]-A[re-2] )*one_ov_2dr;
+                const double Ex_im = ( A[im+2]-A[im-2] )*one_ov_2dr;
+                Exabs[j] = std::sqrt( Ex_re*Ex_re+Ex_im*Ex_im );
+            } // end r loop
+
+            if( isYmin && i >= 1 ) { // axis BC
+                const double A_abs_sq = A[4]*A[4]+A[5]*A[5];
+                Phi[2]  = ellipticity_factor*A_abs_sq*0.5;
+                Aabs[2] = std::sqrt( A_abs_sq );
+                const double E_re = ( A[4]-A0[4] )/timestep + omega*A[5];
+                const double E_im = ( A[5]-A0[5] )/timestep - omega*A[4];
+                Eabs[2]  = std::sqrt( E_re*E_re+E_im*E_im );
+                Exabs[2] = 0.;
+                Aabs[1]  = Aabs[3];
+                Aabs[0]  = Aabs[4];
+                Eabs[1]  = Eabs[3];
+                Eabs[0]  = Eabs[4];
+                Exabs[1] = Exabs[3];
+                Exabs[0] = Exabs[4];
+            }
+        }
+
+        if( i == 0 ) {
+            continue;
+        }
+
+        // Gradient of Phi in the line i-1, and centering at timestep n+1/2
+        const int ig = i-1;
+        const double *const __restrict__ Phi = Phi2Dcyl+ig*nr;
+        double *const __restrict__ GradPhil  = GradPhil2Dcyl+ig*nr;
+        double *const __restrict__ GradPhir  = GradPhir2Dcyl+ig*nr;
+        if( ig >= 1 ) {
+            #pragma omp simd
+            for( int j=jbegin ; j<nr-1 ; j++ ) { // r loop
+                GradPhil[j] = ( Phi[j+nr]-Phi[j-nr] ) * one_ov_2dl;
+                GradPhir[j] = ( Phi[j+1]-Phi[j-1] ) * one_ov_2dr;
+            } // end r loop
+            if( isYmin ) { // axis BC, the gradient in r direction is identically zero on r = 0
+                GradPhil[2] = ( Phi[2+nr]-Phi[2-nr] ) * one_ov_2dl;
+                GradPhir[2] = 0.;
+                GradPhil[1] = GradPhil[3];
+                GradPhil[0] = GradPhil[4];
+                GradPhir[1] = GradPhir[3];
+                GradPhir[0] = GradPhir[4];
+            }
+        }
+        double *const __restrict__ Phi_m      = Phi_m2Dcyl+ig*nr;
+        double *const __restrict__ GradPhil_m = GradPhil_m2Dcyl+ig*nr;
+        double *const __restrict__ GradPhir_m = GradPhir_m2Dcyl+ig*nr;
+        #pragma omp simd
+        for( int j=0 ; j<nr-1 ; j++ ) { // r loop
+            Phi_m[j]      = 0.5*( Phi_m[j]+Phi[j] );
+            GradPhil_m[j] = 0.5*( GradPhil_m[j]+GradPhil[j] );
+            GradPhir_m[j] = 0.5*( GradPhir_m[j]+GradPhir[j] );
+        } // end r loop
+    } // end l loop
+
+} // end LaserEnvelopeAM::computePhiAndGradPhi
@@ -10,6 +10,9 @@
 #include <string>
 #include <complex>
 #include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 
 using namespace std;
 
@@ -64,6 +67,30 @@ vector<unsigned int> partial_reverse_argsort( vector<double> x, unsigned int nma
 }
 
 
+// FNV-1a hash of a block of bytes, continuing the hash h
+uint64_t fnv1a( uint64_t h, const void *data, size_t size )
+{
+    const unsigned char *bytes = ( const unsigned char * ) data;
+    for( size_t i=0; i<size; i++ ) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Copy a file, returns false if it failed
+bool copy_file( string source, string destination )
+{
+    ifstream in( source, ios::binary );
+    ofstream out( destination, ios::binary );
+    if( in.fail() || out.fail() ) {
+        return false;
+    }
+    out << in.rdbuf();
+    return ! out.fail();
+}
+
+
 // Call a python function
 PyObject *PyCall( PyObject *callable, PyObject *args, PyObject *kwargs )
 {
@@ -76,7 +103,8 @@ PyObject *PyCall( PyObject *callable, PyObject *args, PyObject *kwargs )
 }
 
 
-LaserPropagator::LaserPropagator( Params *params, unsigned int side, double fft_time_window, double fft_time_step, MPI_Comm &comm )
+LaserPropagator::LaserPropagator( Params *params, unsigned int side, double fft_time_window, double fft_time_step, string cache_directory, MPI_Comm &comm ) :
+    cache_directory_( cache_directory )
 {
 
 #ifdef SMILEI_USE_NUMPY
@@ -210,6 +238,61 @@ void LaserPropagator::operator()( vector<PyObject *> profiles, vector<int> profi
     MESSAGE( 3, "Finished applying profiles ... " << MPI_Wtime() - timer << " s" );
     timer = MPI_Wtime();
     
+    // Key of the propagated result: hash of the grid, of the laser parameters and of the sampled profiles.
+    // If the file (or a file in the cache directory) was written with the same key, it is re-used.
+    uint64_t local_key = 14695981039346656037ULL;
+    for( unsigned int i=0; i<nprofiles; i++ ) {
+        PyObject *a = PyArray_FROM_OTF( arrays[i], NPY_DOUBLE, NPY_ARRAY_C_CONTIGUOUS );
+        local_key = fnv1a( local_key, PyArray_DATA( ( PyArrayObject * ) a ), PyArray_NBYTES( ( PyArrayObject * ) a ) );
+        Py_DECREF( a );
+    }
+    vector<uint64_t> keys( MPI_size );
+    MPI_Allgather( &local_key, 1, MPI_UINT64_T, &keys[0], 1, MPI_UINT64_T, comm_ );
+    uint64_t key = fnv1a( 14695981039346656037ULL, &keys[0], MPI_size*sizeof( uint64_t ) );
+    key = fnv1a( key, &N[0], N.size()*sizeof( unsigned int ) );
+    key = fnv1a( key, &L[0], L.size()*sizeof( double ) );
+    key = fnv1a( key, &o[0], o.size()*sizeof( double ) );
+    key = fnv1a( key, &ox, sizeof( double ) );
+    key = fnv1a( key, &offset, sizeof( double ) );
+    key = fnv1a( key, &angle_z, sizeof( double ) );
+    key = fnv1a( key, &keep_n_strongest_modes, sizeof( int ) );
+    key = fnv1a( key, &profiles_n[0], nprofiles*sizeof( int ) );
+    ostringstream key_hex( "" );
+    key_hex << hex << setw( 16 ) << setfill( '0' ) << key;
+    string cache_key = key_hex.str();
+    string cache_file = cache_directory_.empty() ? "" : cache_directory_ + "/LaserOffset_" + cache_key + ".h5";
+    
+    int reused = 0;
+    if( MPI_rank == 0 ) {
+        for( string candidate: { file, cache_file } ) {
+            if( candidate.empty() || ! Tools::fileExists( candidate ) ) {
+                continue;
+            }
+            string candidate_key = "";
+            {
+                H5Read f( candidate, NULL, false );
+                if( f.valid() && f.hasAttr( "cache_key" ) ) {
+                    f.attr( "cache_key", candidate_key );
+                }
+            }
+            if( candidate_key == cache_key && ( candidate == file || copy_file( candidate, file ) ) ) {
+                MESSAGE( 2, "Re-using the propagated laser of " << candidate );
+                reused = 1;
+                break;
+            }
+        }
+    }
+    MPI_Bcast( &reused, 1, MPI_INT, 0, comm_ );
+    if( reused ) {
+        for( unsigned int i=0; i<nprofiles; i++ ) {
+            Py_DECREF( arrays[i] );
+        }
+        Py_DECREF( fft );
+        Py_DECREF( ifft );
+        Py_DECREF( fft2 );
+        return;
+    }
+    
     // 2- Fourier transform of the fields at destination
     // --------------------------------
 
@@ -579,27 +662,30 @@ void LaserPropagator::operator()( vector<PyObject *> profiles, vector<int> profi
         count[2] = n_omega  ;
     }
     
-    // Create File with parallel access
-    H5Write f( file, &comm_ );
+    // Create File with parallel access (closed at the end of the block)
+    {
+        H5Write f( file, &comm_ );
+        f.attr( "cache_key", cache_key );
     
-    // Store "omega" dataset
-    hsize_t npoints = (!_2D && MPI_rank!=0) ? 0 : n_omega_local; // Only rank 0 writes in 3D
-    H5Space filespace1( n_omega, start[ndim-1], npoints );
-    H5Space memspace1( n_omega_local, 0, npoints );
-    f.array( "omega", omega[0], &filespace1, &memspace1 );
+        // Store "omega" dataset
+        hsize_t npoints = (!_2D && MPI_rank!=0) ? 0 : n_omega_local; // Only rank 0 writes in 3D
+        H5Space filespace1( n_omega, start[ndim-1], npoints );
+        H5Space memspace1( n_omega_local, 0, npoints );
+        f.array( "omega", omega[0], &filespace1, &memspace1 );
     
-    // Store the magnitude and the phase
-    H5Space filespace2( dims, start, count );
-    H5Space memspace2( count );
-    for( unsigned int i=0; i<nprofiles; i++ ) {
-        // Magnitude
-        ostringstream name( "" );
-        name << "magnitude" << profiles_n[i];
-        f.array( name.str(), magnitude[i][0], &filespace2, &memspace2 );
-        // Phase
-        name.str( "" );
-        name << "phase" << profiles_n[i];
-        f.array( name.str(), phase[i][0], &filespace2, &memspace2 );
+        // Store the magnitude and the phase
+        H5Space filespace2( dims, start, count );
+        H5Space memspace2( count );
+        for( unsigned int i=0; i<nprofiles; i++ ) {
+            // Magnitude
+            ostringstream name( "" );
+            name << "magnitude" << profiles_n[i];
+            f.array( name.str(), magnitude[i][0], &filespace2, &memspace2 );
+            // Phase
+            name.str( "" );
+            name << "phase" << profiles_n[i];
+            f.array( name.str(), phase[i][0], &filespace2, &memspace2 );
+        }
     }
     
     Py_DECREF( fft );
@@ -609,5 +695,12 @@ void LaserPropagator::operator()( vector<PyObject *> profiles, vector<int> profi
     MESSAGE( 3, "Finished writing file ... " << MPI_Wtime() - timer << " s" );
     timer = MPI_Wtime();
     
+    // Keep a copy in the cache directory for the next runs
+    if( ! cache_file.empty() ) {
+        if( MPI_rank == 0 && ! copy_file( file, cache_file ) ) {
+            WARNING( "Could not copy " << file << " to the cache " << cache_file );
+        }
+    }
+    
 #endif
 }
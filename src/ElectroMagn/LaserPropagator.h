@@ -37,12 +37,13 @@ inline std::complex<double> complex_interpolate( std::complex<double> *z, unsign
 class LaserPropagator
 {
 public:
-    LaserPropagator( Params *params, unsigned int side, double fft_time_window, double fft_time_step, MPI_Comm &comm );
+    LaserPropagator( Params *params, unsigned int side, double fft_time_window, double fft_time_step, std::string cache_directory, MPI_Comm &comm );
     ~LaserPropagator() {
         MPI_Comm_free( &comm_ );
     };
     
-    // Propagates the fields profiles with some offset, and writes result to file
+    // Propagates the fields profiles with some offset, and writes result to file.
+    // Skipped if the file, or a file of the cache directory, holds the result of the same parameters.
     void operator()( std::vector<PyObject *>, std::vector<int>, double, std::string, int, double );
     
 protected:
@@ -73,6 +74,9 @@ private:
     
     //! True if 2D geometry, False if 3D
     bool _2D;
+    
+    //! Directory where the results are kept for the next runs (none if empty)
+    std::string cache_directory_;
 };
 
 
@@ -0,0 +1,223 @@
+#include "PoissonMultigrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Construction of the hierarchy: each direction of at least 3 nodes is coarsened by 2 (vertex-centered, the coarse
+// node I is the fine node 2I+1), until no direction can be coarsened
+// ---------------------------------------------------------------------------------------------------------------------
+PoissonMultigrid::PoissonMultigrid( const unsigned int n[3], const double c[3] )
+{
+    Level l;
+    for( unsigned int d=0 ; d<3 ; d++ ) {
+        l.n[d] = n[d];
+        l.c[d] = ( n[d] > 1 ) ? c[d] : 0.;
+    }
+    while( true ) {
+        const unsigned int size = l.n[0]*l.n[1]*l.n[2];
+        l.u  .assign( size, 0.f );
+        l.f  .assign( size, 0.f );
+        l.res.assign( size, 0.f );
+        bool coarsen = false;
+        for( unsigned int d=0 ; d<3 ; d++ ) {
+            l.coarsened[d] = ( l.n[d] >= 3 );
+            coarsen = coarsen || l.coarsened[d];
+        }
+        if( !coarsen ) {
+            levels_.push_back( l );
+            break;
+        }
+        Level coarse;
+        for( unsigned int d=0 ; d<3 ; d++ ) {
+            coarse.n[d] = l.coarsened[d] ? ( l.n[d]-1 )/2 : l.n[d];
+            coarse.c[d] = l.coarsened[d] ? l.c[d]/4. : l.c[d];
+            l.weights[d].resize( l.n[d] );
+            for( unsigned int i=0 ; i<l.n[d] ; i++ ) {
+                Weights &w = l.weights[d][i];
+                w.n = 0;
+                if( !l.coarsened[d] ) {
+                    w.index[0] = i;
+                    w.w[0] = 1.;
+                    w.n = 1;
+                } else if( i%2 == 1 && ( i-1 )/2 < coarse.n[d] ) {
+                    w.index[0] = ( i-1 )/2;
+                    w.w[0] = 1.;
+                    w.n = 1;
+                } else if( i%2 == 1 ) {
+                    // Even number of nodes: the last node is next to the boundary
+                    w.index[0] = coarse.n[d]-1;
+                    w.w[0] = 0.5;
+                    w.n = 1;
+                } else {
+                    // Between two coarse nodes, or a coarse node and a boundary
+                    if( i > 0 ) {
+                        w.index[w.n] = i/2 - 1;
+                        w.w[w.n] = 0.5;
+                        w.n++;
+                    }
+                    if( i/2 < coarse.n[d] ) {
+                        w.index[w.n] = i/2;
+                        w.w[w.n] = 0.5;
+                        w.n++;
+                    }
+                }
+            }
+        }
+        levels_.push_back( l );
+        l = coarse;
+    }
+}
+
+void PoissonMultigrid::smooth( Level &l, unsigned int color )
+{
+    const unsigned int nx = l.n[0], ny = l.n[1], nz = l.n[2];
+    const float cx = l.c[0], cy = l.c[1], cz = l.c[2];
+    const float one_ov_diag = 1. / ( 2.*( l.c[0]+l.c[1]+l.c[2] ) );
+    float *const __restrict__ u = &l.u[0];
+    const float *const __restrict__ f = &l.f[0];
+    for( unsigned int i=0 ; i<nx ; i++ ) {
+        for( unsigned int j=0 ; j<ny ; j++ ) {
+            const unsigned int k0 = ( i+j+color )%2;
+            for( unsigned int k=k0 ; k<nz ; k+=2 ) {
+                const unsigned int ijk = ( i*ny+j )*nz+k;
+                float s = -f[ijk];
+                if( i > 0 )    s += cx * u[ijk-ny*nz];
+                if( i < nx-1 ) s += cx * u[ijk+ny*nz];
+                if( j > 0 )    s += cy * u[ijk-nz];
+                if( j < ny-1 ) s += cy * u[ijk+nz];
+                if( k > 0 )    s += cz * u[ijk-1];
+                if( k < nz-1 ) s += cz * u[ijk+1];
+                u[ijk] = s * one_ov_diag;
+            }
+        }
+    }
+}
+
+void PoissonMultigrid::residual( Level &l )
+{
+    const unsigned int nx = l.n[0], ny = l.n[1], nz = l.n[2];
+    const float cx = l.c[0], cy = l.c[1], cz = l.c[2];
+    const float diag = 2.*( l.c[0]+l.c[1]+l.c[2] );
+    const float *const __restrict__ u = &l.u[0];
+    const float *const __restrict__ f = &l.f[0];
+    float *const __restrict__ res = &l.res[0];
+    for( unsigned int i=0 ; i<nx ; i++ ) {
+        for( unsigned int j=0 ; j<ny ; j++ ) {
+            for( unsigned int k=0 ; k<nz ; k++ ) {
+                const unsigned int ijk = ( i*ny+j )*nz+k;
+                float Lu = -diag * u[ijk];
+                if( i > 0 )    Lu += cx * u[ijk-ny*nz];
+                if( i < nx-1 ) Lu += cx * u[ijk+ny*nz];
+                if( j > 0 )    Lu += cy * u[ijk-nz];
+                if( j < ny-1 ) Lu += cy * u[ijk+nz];
+                if( k > 0 )    Lu += cz * u[ijk-1];
+                if( k < nz-1 ) Lu += cz * u[ijk+1];
+                res[ijk] = f[ijk] - Lu;
+            }
+        }
+    }
+}
+
+void PoissonMultigrid::vcycle( unsigned int ilevel )
+{
+    Level &l = levels_[ilevel];
+
+    if( ilevel == levels_.size()-1 ) {
+        for( unsigned int is=0 ; is<nsmooth_coarsest_ ; is++ ) {
+            smooth( l, 0 );
+            smooth( l, 1 );
+        }
+        for( unsigned int is=0 ; is<nsmooth_coarsest_ ; is++ ) {
+            smooth( l, 1 );
+            smooth( l, 0 );
+        }
+        return;
+    }
+
+    for( unsigned int is=0 ; is<nsmooth_ ; is++ ) {
+        smooth( l, 0 );
+        smooth( l, 1 );
+    }
+
+    // Restriction of the residual, proportional to the transpose of the interpolation
+    residual( l );
+    Level &coarse = levels_[ilevel+1];
+    float scale = 1.f;
+    for( unsigned int d=0 ; d<3 ; d++ ) {
+        if( l.coarsened[d] ) {
+            scale *= 0.5f;
+        }
+    }
+    coarse.f.assign( coarse.f.size(), 0.f );
+    coarse.u.assign( coarse.u.size(), 0.f );
+    for( unsigned int i=0 ; i<l.n[0] ; i++ ) {
+        const Weights &wx = l.weights[0][i];
+        for( unsigned int j=0 ; j<l.n[1] ; j++ ) {
+            const Weights &wy = l.weights[1][j];
+            for( unsigned int k=0 ; k<l.n[2] ; k++ ) {
+                const Weights &wz = l.weights[2][k];
+                const float r = scale * l.res[( i*l.n[1]+j )*l.n[2]+k];
+                for( unsigned int a=0 ; a<wx.n ; a++ ) {
+                    for( unsigned int b=0 ; b<wy.n ; b++ ) {
+                        for( unsigned int e=0 ; e<wz.n ; e++ ) {
+                            coarse.f[( wx.index[a]*coarse.n[1]+wy.index[b] )*coarse.n[2]+wz.index[e]] += wx.w[a]*wy.w[b]*wz.w[e] * r;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    vcycle( ilevel+1 );
+
+    // Interpolation of the coarse correction
+    for( unsigned int i=0 ; i<l.n[0] ; i++ ) {
+        const Weights &wx = l.weights[0][i];
+        for( unsigned int j=0 ; j<l.n[1] ; j++ ) {
+            const Weights &wy = l.weights[1][j];
+            for( unsigned int k=0 ; k<l.n[2] ; k++ ) {
+                const Weights &wz = l.weights[2][k];
+                float du = 0.f;
+                for( unsigned int a=0 ; a<wx.n ; a++ ) {
+                    for( unsigned int b=0 ; b<wy.n ; b++ ) {
+                        for( unsigned int e=0 ; e<wz.n ; e++ ) {
+                            du += wx.w[a]*wy.w[b]*wz.w[e] * coarse.u[( wx.index[a]*coarse.n[1]+wy.index[b] )*coarse.n[2]+wz.index[e]];
+                        }
+                    }
+                }
+                l.u[( i*l.n[1]+j )*l.n[2]+k] += du;
+            }
+        }
+    }
+
+    for( unsigned int is=0 ; is<nsmooth_ ; is++ ) {
+        smooth( l, 1 );
+        smooth( l, 0 );
+    }
+}
+
+void PoissonMultigrid::solve( const double *f, double *u )
+{
+    Level &l = levels_[0];
+    const unsigned int size = l.u.size();
+    // The V-cycle is linear: f is scaled to a maximum of 1 to stay in the range of the single precision
+    double fmax = 0.;
+    for( unsigned int i=0 ; i<size ; i++ ) {
+        fmax = std::max( fmax, std::fabs( f[i] ) );
+    }
+    if( fmax == 0. ) {
+        for( unsigned int i=0 ; i<size ; i++ ) {
+            u[i] = 0.;
+        }
+        return;
+    }
+    for( unsigned int i=0 ; i<size ; i++ ) {
+        l.f[i] = f[i] / fmax;
+        l.u[i] = 0.f;
+    }
+    vcycle( 0 );
+    for( unsigned int i=0 ; i<size ; i++ ) {
+        u[i] = fmax * l.u[i];
+    }
+}
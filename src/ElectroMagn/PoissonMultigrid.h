@@ -0,0 +1,60 @@
+#ifndef POISSONMULTIGRID_H
+#define POISSONMULTIGRID_H
+
+#include <vector>
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class PoissonMultigrid
+//
+//! Geometric multigrid V-cycle for the discrete Laplacian of the Poisson solvers, on a box of nodes with homogeneous
+//! Dirichlet conditions outside the box: L u = sum_d c_d ( u_{i-1} - 2 u_i + u_{i+1} ) along each direction d.
+//! It is the preconditioner of the conjugate gradient, applied to the nodes owned by each patch (block-Jacobi).
+//! The V-cycle is symmetric (red-black Gauss-Seidel in reverse order after the coarse correction, restriction
+//! proportional to the transpose of the interpolation), as required by the preconditioned conjugate gradient.
+//! The directions of 1 node (unused dimensions in 1D and 2D) have c_d = 0 and are never coarsened.
+//! The V-cycle runs in single precision on the right-hand side scaled to 1 (the conjugate gradient, in double
+//! precision, uses a flexible coefficient that tolerates its rounding errors).
+//  --------------------------------------------------------------------------------------------------------------------
+class PoissonMultigrid
+{
+
+public:
+    //! n: number of nodes of the box in each direction, c: coefficient of the Laplacian in each direction
+    PoissonMultigrid( const unsigned int n[3], const double c[3] );
+    ~PoissonMultigrid() {};
+
+    //! One V-cycle from u = 0: u approximates the solution of L u = f (f and u are given on the box)
+    void solve( const double *f, double *u );
+
+private:
+
+    //! Interpolation weights from the coarse nodes to one fine node along one direction
+    struct Weights {
+        unsigned int n;
+        unsigned int index[2];
+        float w[2];
+    };
+
+    struct Level {
+        unsigned int n[3];
+        double c[3];
+        bool coarsened[3];
+        std::vector<float> u, f, res;
+        //! Weights of the interpolation from the next level, per fine node and direction
+        std::vector<Weights> weights[3];
+    };
+
+    //! Red-black Gauss-Seidel sweep on the nodes of parity `color`
+    void smooth( Level &l, unsigned int color );
+    //! Residual f - L u
+    void residual( Level &l );
+    void vcycle( unsigned int ilevel );
+
+    std::vector<Level> levels_;
+
+    //! Number of pre and post smoothing sweeps (of both colors), and on the coarsest level
+    static const unsigned int nsmooth_ = 2;
+    static const unsigned int nsmooth_coarsest_ = 16;
+};
+
+#endif
@@ -27,6 +27,12 @@ public:
     virtual void save_fields( Field *, Patch * ) {};
     virtual void disableExternalFields() {};
     
+    //! Memory of the fields held by the boundary condition (bytes), for instance in the PML
+    virtual std::size_t getMemFootPrint()
+    {
+        return 0;
+    }
+    
     //! Vector for the various lasers
     std::vector<Laser *> vecLaser;
 
@@ -26,6 +26,7 @@ public:
     
     void save_fields( Field *, Patch *patch ) override;
     void disableExternalFields() override;
+    std::size_t getMemFootPrint() override;
 
     Field2D* Ex_ = NULL;
     Field2D* Ey_ = NULL;
@@ -169,13 +169,23 @@ void ElectroMagnBC2D_SM::apply( ElectroMagn *EMfields, double time_dual, Patch *
 
         const int b1_size = n1p ;
         const int b2_size = n1d ;
-        std::vector<double> pos( 1 );
 
         if( ! vecLaser.empty() ) {
-            for( unsigned int j=isBoundary1min ; j<n1p-isBoundary1max ; j++ ) {
-                pos[0] = patch->getDomainLocalMin( axis1_ ) + ( ( int )j - ( int )EMfields->oversize[axis1_] )*d[axis1_];
-                for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
-                    db1[j] += vecLaser[ilaser]->getAmplitude0( pos, time_dual, j, 0 );
+            const unsigned int npoints = n1p - isBoundary1max - isBoundary1min;
+            laser_pos_.resize( 1 );
+            laser_pos_[0].resize( npoints );
+            laser_j_.resize( npoints );
+            laser_k_.assign( npoints, 0 );
+            laser_amp_.resize( npoints );
+            for( unsigned int ip=0; ip<npoints; ip++ ) {
+                const unsigned int j = isBoundary1min + ip;
+                laser_pos_[0][ip] = patch->getDomainLocalMin( axis1_ ) + ( ( int )j - ( int )EMfields->oversize[axis1_] )*d[axis1_];
+                laser_j_[ip] = j;
+            }
+            for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
+                vecLaser[ilaser]->getAmplitudes0( laser_pos_, time_dual, laser_j_, laser_k_, laser_amp_ );
+                for( unsigned int ip=0; ip<npoints; ip++ ) {
+                    db1[isBoundary1min + ip] += laser_amp_[ip];
                 }
             }
         }
@@ -223,10 +233,21 @@ void ElectroMagnBC2D_SM::apply( ElectroMagn *EMfields, double time_dual, Patch *
         double *const __restrict__ db2 = b2.data();
 
         if( ! vecLaser.empty() ) {
-            for( unsigned int j=isBoundary1min; j<n1d-isBoundary1max ; j++ ) {
-                pos[0] = patch->getDomainLocalMin( axis1_ ) + ( ( int )j - 0.5 - ( int )EMfields->oversize[axis1_] )*d[axis1_];
-                for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
-                    db2[j] += vecLaser[ilaser]->getAmplitude1( pos, time_dual, j, 0 );
+            const unsigned int npoints = n1d - isBoundary1max - isBoundary1min;
+            laser_pos_.resize( 1 );
+            laser_pos_[0].resize( npoints );
+            laser_j_.resize( npoints );
+            laser_k_.assign( npoints, 0 );
+            laser_amp_.resize( npoints );
+            for( unsigned int ip=0; ip<npoints; ip++ ) {
+                const unsigned int j = isBoundary1min + ip;
+                laser_pos_[0][ip] = patch->getDomainLocalMin( axis1_ ) + ( ( int )j - 0.5 - ( int )EMfields->oversize[axis1_] )*d[axis1_];
+                laser_j_[ip] = j;
+            }
+            for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
+                vecLaser[ilaser]->getAmplitudes1( laser_pos_, time_dual, laser_j_, laser_k_, laser_amp_ );
+                for( unsigned int ip=0; ip<npoints; ip++ ) {
+                    db2[isBoundary1min + ip] += laser_amp_[ip];
                 }
             }
         }
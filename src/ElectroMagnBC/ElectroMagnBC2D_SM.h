@@ -38,6 +38,12 @@ private:
     unsigned int axis0_, axis1_;
     int sign_;
     std::vector<unsigned int> iB_;
+    
+    //! Points of the boundary where the lasers are evaluated in a single call (buffers reused at each step):
+    //! positions laser_pos_[idim][ipoint], indices laser_j_ and laser_k_, and amplitudes laser_amp_
+    std::vector<std::vector<double> > laser_pos_;
+    std::vector<int> laser_j_, laser_k_;
+    std::vector<double> laser_amp_;
 };
 
 #endif
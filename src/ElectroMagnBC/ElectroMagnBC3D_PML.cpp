@@ -276,6 +276,18 @@ void ElectroMagnBC3D_PML::disableExternalFields()
 {
 }
 
+std::size_t ElectroMagnBC3D_PML::getMemFootPrint()
+{
+    Field *fields[12] = { Ex_, Ey_, Ez_, Bx_, By_, Bz_, Dx_, Dy_, Dz_, Hx_, Hy_, Hz_ };
+    std::size_t mem = 0;
+    for( unsigned int i=0 ; i<12 ; i++ ) {
+        if( fields[i] ) {
+            mem += fields[i]->number_of_points_ * sizeof( double );
+        }
+    }
+    return mem;
+}
+
 
 // ---------------------------------------------------------------------------------------------------------------------
 // Apply Boundary Conditions
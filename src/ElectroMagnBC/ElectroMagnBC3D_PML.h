@@ -24,6 +24,7 @@ public:
 
     void save_fields( Field *, Patch *patch ) override;
     void disableExternalFields() override;
+    std::size_t getMemFootPrint() override;
 
     Field3D* Ex_ = NULL;
     Field3D* Ey_ = NULL;
@@ -1,7 +1,9 @@
 #include "ElectroMagnBC3D_SM.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <string>
 #include "ElectroMagn.h"
 #include "Field3D.h"
@@ -48,7 +50,14 @@ ElectroMagnBC3D_SM::ElectroMagnBC3D_SM( Params &params, Patch *patch, unsigned i
         B_val[0]->put_to( 0. );
         B_val[1]->put_to( 0. );
         B_val[2]->put_to( 0. );
+        
+        b1_.resize( n_p[axis1_] * n_d[axis2_], 0. );
+        b2_.resize( n_d[axis1_] * n_p[axis2_], 0. );
+        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceAllocateAndCopyHostToDevice( b1_.data(), b1_.size() );
+        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceAllocateAndCopyHostToDevice( b2_.data(), b2_.size() );
     }
+    laser_origin_[0] = std::numeric_limits<double>::quiet_NaN();
+    laser_origin_[1] = std::numeric_limits<double>::quiet_NaN();
     
     // -----------------------------------------------------
     // Parameters for the Silver-Mueller boundary conditions
@@ -85,6 +94,10 @@ ElectroMagnBC3D_SM::~ElectroMagnBC3D_SM()
         smilei::tools::gpu::HostDeviceMemoryManagement::DeviceFree( B_val[2]->data_, B_val[2]->number_of_points_ );
         delete B_val[2];
     }
+    if( ! b1_.empty() ) {
+        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceFree( b1_.data(), b1_.size() );
+        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceFree( b2_.data(), b2_.size() );
+    }
 }
 
 
@@ -135,6 +148,42 @@ void ElectroMagnBC3D_SM::disableExternalFields()
 }
 
 
+void ElectroMagnBC3D_SM::setLaserPoints( ElectroMagn *EMfields, Patch *patch )
+{
+    if( patch->getDomainLocalMin( axis1_ ) == laser_origin_[0] && patch->getDomainLocalMin( axis2_ ) == laser_origin_[1] ) {
+        return;
+    }
+    laser_origin_[0] = patch->getDomainLocalMin( axis1_ );
+    laser_origin_[1] = patch->getDomainLocalMin( axis2_ );
+    
+    const unsigned int isBoundary1min = patch->isBoundary( axis1_, 0 );
+    const unsigned int isBoundary1max = patch->isBoundary( axis1_, 1 );
+    const unsigned int isBoundary2min = patch->isBoundary( axis2_, 0 );
+    const unsigned int isBoundary2max = patch->isBoundary( axis2_, 1 );
+    
+    // Component along axis 1 is primal along axis 1 and dual along axis 2, and conversely for axis 2
+    for( unsigned int icomp=0; icomp<2; icomp++ ) {
+        const unsigned int n1 = ( icomp==0 ? n_p[axis1_] : n_d[axis1_] ) - isBoundary1max - isBoundary1min;
+        const unsigned int n2 = ( icomp==0 ? n_d[axis2_] : n_p[axis2_] ) - isBoundary2max - isBoundary2min;
+        const double shift1 = icomp==0 ? 0. : 0.5;
+        const double shift2 = icomp==0 ? 0.5 : 0.;
+        laser_pos_[icomp].resize( 2 );
+        laser_pos_[icomp][0].resize( n1*n2 );
+        laser_pos_[icomp][1].resize( n1*n2 );
+        laser_j_[icomp].resize( n1*n2 );
+        laser_k_[icomp].resize( n1*n2 );
+        for( unsigned int ip=0; ip<n1*n2; ip++ ) {
+            const unsigned int j = isBoundary1min + ip / n2;
+            const unsigned int k = isBoundary2min + ip % n2;
+            laser_pos_[icomp][0][ip] = laser_origin_[0] + ( ( int )j - shift1 - ( int )EMfields->oversize[axis1_] )*d[axis1_];
+            laser_pos_[icomp][1][ip] = laser_origin_[1] + ( ( int )k - shift2 - ( int )EMfields->oversize[axis2_] )*d[axis2_];
+            laser_j_[icomp][ip] = j;
+            laser_k_[icomp][ip] = k;
+        }
+    }
+}
+
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Apply Boundary Conditions
 // ---------------------------------------------------------------------------------------------------------------------
@@ -174,12 +223,8 @@ void ElectroMagnBC3D_SM::apply( ElectroMagn *EMfields, double time_dual, Patch *
         const int b1_size = n1p * n2d;
         const int b2_size = n1d * n2p;
 
-        std::vector<double> b1( b1_size, 0. );
-        std::vector<double> b2( b2_size, 0. );
-        std::vector<double> pos( 2 );
-
-        double *const __restrict__ db1 = b1.data();
-        double *const __restrict__ db2 = b2.data();
+        double *const __restrict__ db1 = b1_.data();
+        double *const __restrict__ db2 = b2_.data();
 
         const int isBoundary1min = patch->isBoundary( axis1_, 0 );
         const int isBoundary1max = patch->isBoundary( axis1_, 1 );
@@ -200,21 +245,20 @@ void ElectroMagnBC3D_SM::apply( ElectroMagn *EMfields, double time_dual, Patch *
 #endif
 
         // Component along axis 1
-        // Lasers
+        // Lasers (without lasers, b1_ and b2_ remain zero on the device)
         if( !vecLaser.empty() ) {
-            for( unsigned int j=isBoundary1min; j<n1p-isBoundary1max ; j++ ) {
-                pos[0] = patch->getDomainLocalMin( axis1_ ) + ( ( int )j - ( int )EMfields->oversize[axis1_] )*d[axis1_];
-                for( unsigned int k=isBoundary2min; k<n2d-isBoundary2max; k++ ) {
-                    pos[1] = patch->getDomainLocalMin( axis2_ ) + ( ( int )k -0.5 - ( int )EMfields->oversize[axis2_] )*d[axis2_];
-                    for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
-                        db1[ j*n2d+k ] += vecLaser[ilaser]->getAmplitude0( pos, time_dual, j, k );
-                    }
+            setLaserPoints( EMfields, patch );
+            std::fill( b1_.begin(), b1_.end(), 0. );
+            laser_amp_.resize( laser_j_[0].size() );
+            for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
+                vecLaser[ilaser]->getAmplitudes0( laser_pos_[0], time_dual, laser_j_[0], laser_k_[0], laser_amp_ );
+                for( unsigned int ip=0; ip<laser_amp_.size(); ip++ ) {
+                    db1[ laser_j_[0][ip]*n2d + laser_k_[0][ip] ] += laser_amp_[ip];
                 }
             }
+            smilei::tools::gpu::HostDeviceMemoryManagement::CopyHostToDevice( db1, b1_size );
         }
 
-        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceAllocateAndCopyHostToDevice( db1, b1_size );
-
         // B1
         if( axis0_ == 0 ) {
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -283,25 +327,22 @@ void ElectroMagnBC3D_SM::apply( ElectroMagn *EMfields, double time_dual, Patch *
                 }
             }
         }
-        
-        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceFree( db1, b1_size );
+
 
         // Component along axis 2
         // Lasers
         if( !vecLaser.empty() ) {
-            for( unsigned int j=isBoundary1min; j<n1d-isBoundary1max; j++ ) {
-                pos[0] = patch->getDomainLocalMin( axis1_ ) + ( ( int )j - 0.5 - ( int )EMfields->oversize[axis1_] )*d[axis1_];
-                for( unsigned int k=isBoundary2min; k<n2p-isBoundary2max; k++ ) {
-                    pos[1] = patch->getDomainLocalMin( axis2_ ) + ( ( int )k - ( int )EMfields->oversize[axis2_] )*d[axis2_];
-                    for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
-                        db2[ j*n2p+k ] += vecLaser[ilaser]->getAmplitude1( pos, time_dual, j, k );
-                    }
+            std::fill( b2_.begin(), b2_.end(), 0. );
+            laser_amp_.resize( laser_j_[1].size() );
+            for( unsigned int ilaser=0; ilaser< vecLaser.size(); ilaser++ ) {
+                vecLaser[ilaser]->getAmplitudes1( laser_pos_[1], time_dual, laser_j_[1], laser_k_[1], laser_amp_ );
+                for( unsigned int ip=0; ip<laser_amp_.size(); ip++ ) {
+                    db2[ laser_j_[1][ip]*n2p + laser_k_[1][ip] ] += laser_amp_[ip];
                 }
             }
+            smilei::tools::gpu::HostDeviceMemoryManagement::CopyHostToDevice( db2, b2_size );
         }
 
-        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceAllocateAndCopyHostToDevice( db2, b2_size );
-
         // B2
         if( axis0_ == 0 ) {
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -370,7 +411,5 @@ void ElectroMagnBC3D_SM::apply( ElectroMagn *EMfields, double time_dual, Patch *
                 }
             }
         }
-
-        smilei::tools::gpu::HostDeviceMemoryManagement::DeviceFree( db2, b2_size );
     }
 }
@@ -35,6 +35,23 @@ public:
     unsigned int axis0_, axis1_, axis2_;
     int sign_;
     std::vector<unsigned int> iB_;
+    
+    //! Points of the boundary where the lasers are evaluated in a single call, for the components along axis 1 and 2:
+    //! positions laser_pos_[icomp][idim][ipoint] and indices laser_j_ and laser_k_, computed again only when the
+    //! patch has moved (origin laser_origin_ of the boundary), and amplitudes laser_amp_
+    std::vector<std::vector<double> > laser_pos_[2];
+    std::vector<int> laser_j_[2], laser_k_[2];
+    std::vector<double> laser_amp_;
+    double laser_origin_[2];
+    
+    //! Laser contributions to the components along axis 1 and 2, allocated once on the device
+    //! (only updated from the host when there are lasers)
+    std::vector<double> b1_, b2_;
+    
+private:
+    
+    //! Sets the points of the boundary where the lasers are evaluated, if the patch has moved
+    void setLaserPoints( ElectroMagn *EMfields, Patch *patch );
 };
 
 #endif
@@ -214,6 +214,20 @@ void ElectroMagnBCAM_PML::disableExternalFields()
 {
 }
 
+std::size_t ElectroMagnBCAM_PML::getMemFootPrint()
+{
+    std::vector<cField2D *> *fields[12] = { &El_, &Er_, &Et_, &Bl_, &Br_, &Bt_, &Dl_, &Dr_, &Dt_, &Hl_, &Hr_, &Ht_ };
+    std::size_t mem = 0;
+    for( unsigned int i=0 ; i<12 ; i++ ) {
+        for( unsigned int imode=0 ; imode<fields[i]->size() ; imode++ ) {
+            if( ( *fields[i] )[imode] ) {
+                mem += ( *fields[i] )[imode]->number_of_points_ * sizeof( std::complex<double> );
+            }
+        }
+    }
+    return mem;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Apply Boundary Conditions
 // ---------------------------------------------------------------------------------------------------------------------
@@ -26,6 +26,7 @@ public:
 
     void save_fields( Field *, Patch *patch ) override;
     void disableExternalFields() override;
+    std::size_t getMemFootPrint() override;
 
     std::vector<cField2D *> El_ ;//= NULL;
     std::vector<cField2D *> Er_ ;//= NULL;
@@ -0,0 +1,101 @@
+#include "MA_MF_Solver3D_Yee.h"
+
+#include "ElectroMagn.h"
+#include "Field3D.h"
+
+MA_MF_Solver3D_Yee::MA_MF_Solver3D_Yee( Params &params )
+    : Solver3D( params )
+{
+    // EMPTY
+}
+
+MA_MF_Solver3D_Yee::~MA_MF_Solver3D_Yee()
+{
+    // EMPTY
+}
+
+void MA_MF_Solver3D_Yee::operator()( ElectroMagn *fields )
+{
+    double *const __restrict__ Ex3D       = fields->Ex_->data();
+    double *const __restrict__ Ey3D       = fields->Ey_->data();
+    double *const __restrict__ Ez3D       = fields->Ez_->data();
+    double *const __restrict__ Bx3D       = fields->Bx_->data();
+    double *const __restrict__ By3D       = fields->By_->data();
+    double *const __restrict__ Bz3D       = fields->Bz_->data();
+    const double *const __restrict__ Jx3D = fields->Jx_->data();
+    const double *const __restrict__ Jy3D = fields->Jy_->data();
+    const double *const __restrict__ Jz3D = fields->Jz_->data();
+
+    const unsigned int nx_p = fields->dimPrim[0];
+    const unsigned int nx_d = fields->dimDual[0];
+    const unsigned int ny_p = fields->dimPrim[1];
+    const unsigned int ny_d = fields->dimDual[1];
+    const unsigned int nz_p = fields->dimPrim[2];
+    const unsigned int nz_d = fields->dimDual[2];
+
+    for( unsigned int i=0 ; i<nx_d ; i++ ) {
+
+        // ---------------------------------------------------------
+        // Maxwell-Ampere on the plane i (B of the planes i and i+1)
+        // ---------------------------------------------------------
+
+        // Electric field Ex^(d,p,p)
+        for( unsigned int j=0 ; j<ny_p ; j++ ) {
+            for( unsigned int k=0 ; k<nz_p ; k++ ) {
+                Ex3D[ i*(ny_p*nz_p) + j*(nz_p) + k ] += -dt*Jx3D[ i*(ny_p*nz_p) + j*(nz_p) + k ]
+                    +                 dt_ov_dy * ( Bz3D[ i*(ny_d*nz_p) + (j+1)*(nz_p) + k   ] - Bz3D[ i*(ny_d*nz_p) + j*(nz_p) + k ] )
+                    -                 dt_ov_dz * ( By3D[ i*(ny_p*nz_d) +  j   *(nz_d) + k+1 ] - By3D[ i*(ny_p*nz_d) + j*(nz_d) + k ] );
+            }
+        }
+
+        if( i<nx_p ) {
+            // Electric field Ey^(p,d,p)
+            for( unsigned int j=0 ; j<ny_d ; j++ ) {
+                for( unsigned int k=0 ; k<nz_p ; k++ ) {
+                    Ey3D[ i*(ny_d*nz_p) + j*(nz_p) + k ] += -dt*Jy3D[ i*(ny_d*nz_p) + j*(nz_p) + k ]
+                        -                  dt_ov_dx * ( Bz3D[ (i+1)*(ny_d*nz_p) + j*(nz_p) + k   ] - Bz3D[ i*(ny_d*nz_p) + j*(nz_p) + k ] )
+                        +                  dt_ov_dz * ( Bx3D[  i   *(ny_d*nz_d) + j*(nz_d) + k+1 ] - Bx3D[ i*(ny_d*nz_d) + j*(nz_d) + k ] );
+                }
+            }
+
+            // Electric field Ez^(p,p,d)
+            for( unsigned int j=0 ; j<ny_p ; j++ ) {
+                for( unsigned int k=0 ; k<nz_d ; k++ ) {
+                    Ez3D[ i*(ny_p*nz_d) + j*(nz_d) + k ] += -dt*Jz3D[ i*(ny_p*nz_d) + j*(nz_d) + k ]
+                        +                  dt_ov_dx * ( By3D[ (i+1)*(ny_p*nz_d) +  j   *(nz_d) + k ] - By3D[ i*(ny_p*nz_d) + j*(nz_d) + k ] )
+                        -                  dt_ov_dy * ( Bx3D[  i   *(ny_d*nz_d) + (j+1)*(nz_d) + k ] - Bx3D[ i*(ny_d*nz_d) + j*(nz_d) + k ] );
+                }
+            }
+
+            // ------------------------------------------------------------
+            // Maxwell-Faraday on the plane i (E of the planes i-1 and i)
+            // ------------------------------------------------------------
+
+            // Magnetic field Bx^(p,d,d)
+            for( unsigned int j=1 ; j<ny_d-1 ; j++ ) {
+                for( unsigned int k=1 ; k<nz_d-1 ; k++ ) {
+                    Bx3D[ i*(ny_d*nz_d) + j*(nz_d) + k ] += -dt_ov_dy * ( Ez3D[ i*(ny_p*nz_d) + j*(nz_d) + k ] - Ez3D[ i*(ny_p*nz_d) + (j-1)*(nz_d) + k   ] )
+                                                         +   dt_ov_dz * ( Ey3D[ i*(ny_d*nz_p) + j*(nz_p) + k ] - Ey3D[ i*(ny_d*nz_p) +  j   *(nz_p) + k-1 ] );
+                }
+            }
+        }
+
+        if( i>=1 && i<nx_d-1 ) {
+            // Magnetic field By^(d,p,d)
+            for( unsigned int j=0 ; j<ny_p ; j++ ) {
+                for( unsigned int k=1 ; k<nz_d-1 ; k++ ) {
+                    By3D[ i*(ny_p*nz_d) + j*(nz_d) + k ] += -dt_ov_dz * ( Ex3D[ i*(ny_p*nz_p) + j*(nz_p) + k ] - Ex3D[  i   *(ny_p*nz_p) + j*(nz_p) + k-1 ] )
+                                                         +   dt_ov_dx * ( Ez3D[ i*(ny_p*nz_d) + j*(nz_d) + k ] - Ez3D[ (i-1)*(ny_p*nz_d) + j*(nz_d) + k   ] );
+                }
+            }
+
+            // Magnetic field Bz^(d,d,p)
+            for( unsigned int j=1 ; j<ny_d-1 ; j++ ) {
+                for( unsigned int k=0 ; k<nz_p ; k++ ) {
+                    Bz3D[ i*(ny_d*nz_p) + j*(nz_p) + k ] += -dt_ov_dx * ( Ey3D[ i*(ny_d*nz_p) + j*(nz_p) + k ] - Ey3D[ (i-1)*(ny_d*nz_p) +  j   *(nz_p) + k ] )
+                                                         +   dt_ov_dy * ( Ex3D[ i*(ny_p*nz_p) + j*(nz_p) + k ] - Ex3D[  i   *(ny_p*nz_p) + (j-1)*(nz_p) + k ] );
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef MA_MF_SOLVER3D_YEE_H
+#define MA_MF_SOLVER3D_YEE_H
+
+#include "Solver3D.h"
+class ElectroMagn;
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class MA_MF_Solver3D_Yee
+//
+//! Maxwell-Ampere and Maxwell-Faraday (Yee) solvers fused in a single sweep of the x planes of the patch.
+//! E of the plane i only needs B on the planes i and i+1, not updated yet, and B of the plane i only needs E on the
+//! planes i-1 and i, just updated: each plane of E is used by Faraday while it is still in cache.
+//! The results are identical to MA_Solver3D_norm followed by MF_Solver3D_Yee, which is then a NullSolver.
+//  --------------------------------------------------------------------------------------------------------------------
+class MA_MF_Solver3D_Yee : public Solver3D
+{
+
+public:
+    MA_MF_Solver3D_Yee( Params &params );
+    virtual ~MA_MF_Solver3D_Yee();
+
+    //! Overloading of () operator
+    virtual void operator()( ElectroMagn *fields );
+
+protected:
+
+};//END class
+
+#endif
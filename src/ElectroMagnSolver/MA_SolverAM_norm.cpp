@@ -20,6 +20,94 @@ void MA_SolverAM_norm::operator()( ElectroMagn *fields )
     const unsigned int nl_d = fields->dimDual[0];
     const unsigned int nr_p = fields->dimPrim[1];
     const unsigned int nr_d = fields->dimDual[1];
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    // All the modes are updated line by line along l, so that the radial coefficients stay in cache.
+    // The complex arithmetic is split in real and imaginary parts for the vectorization along r.
+    ElectroMagnAM *emAM = static_cast<ElectroMagnAM *>( fields );
+    const int  j_glob = emAM->j_glob_;
+    const bool isYmin = emAM->isYmin;
+    tabulateInvR( j_glob, nr_p, nr_d );
+    const double *const __restrict__ invR  = invR_.data();
+    const double *const __restrict__ invRd = invRd_.data();
+    const int jmin = isYmin*3;
+
+    for( unsigned int i=0 ; i<nl_d ; i++ ) {
+        for( unsigned int imode=0 ; imode<Nmode ; imode++ ) {
+            const double dt_mode = dt*( double )imode;
+
+            // Electric field El^(d,p)
+            double *const __restrict__ El       = reinterpret_cast<double *>( emAM->El_[imode]->cdata_+i*nr_p );
+            const double *const __restrict__ Jl = reinterpret_cast<double *>( emAM->Jl_[imode]->cdata_+i*nr_p );
+            const double *const __restrict__ Br = reinterpret_cast<double *>( emAM->Br_[imode]->cdata_+i*nr_p );
+            const double *const __restrict__ Bt = reinterpret_cast<double *>( emAM->Bt_[imode]->cdata_+i*nr_d );
+            #pragma omp simd
+            for( int j=jmin ; j<( int )nr_p ; j++ ) {
+                const int re = 2*j, im = 2*j+1;
+                const double r = ( double )( j_glob+j );
+                El[re] += -dt*Jl[re] + dt*invR[j]*( ( r+0.5 )*Bt[re+2] - ( r-0.5 )*Bt[re] ) - dt_mode*invR[j]*Br[im];
+                El[im] += -dt*Jl[im] + dt*invR[j]*( ( r+0.5 )*Bt[im+2] - ( r-0.5 )*Bt[im] ) + dt_mode*invR[j]*Br[re];
+            }
+
+            if( i<nl_p ) {
+                // Electric field Er^(p,d)
+                double *const __restrict__ Er        = reinterpret_cast<double *>( emAM->Er_[imode]->cdata_+i*nr_d );
+                const double *const __restrict__ Jr  = reinterpret_cast<double *>( emAM->Jr_[imode]->cdata_+i*nr_d );
+                const double *const __restrict__ Bl  = reinterpret_cast<double *>( emAM->Bl_[imode]->cdata_+i*nr_d );
+                const double *const __restrict__ Btp = Bt+2*nr_d;
+                #pragma omp simd
+                for( int j=jmin ; j<( int )nr_d ; j++ ) {
+                    const int re = 2*j, im = 2*j+1;
+                    Er[re] += -dt*Jr[re] - dt_ov_dl*( Btp[re]-Bt[re] ) + dt_mode*invRd[j]*Bl[im];
+                    Er[im] += -dt*Jr[im] - dt_ov_dl*( Btp[im]-Bt[im] ) - dt_mode*invRd[j]*Bl[re];
+                }
+
+                // Electric field Et^(p,p)
+                double *const __restrict__ Et        = reinterpret_cast<double *>( emAM->Et_[imode]->cdata_+i*nr_p );
+                const double *const __restrict__ Jt  = reinterpret_cast<double *>( emAM->Jt_[imode]->cdata_+i*nr_p );
+                const double *const __restrict__ Brp = Br+2*nr_p;
+                #pragma omp simd
+                for( int j=jmin ; j<( int )nr_p ; j++ ) {
+                    const int re = 2*j, im = 2*j+1;
+                    Et[re] += -dt*Jt[re] + dt_ov_dl*( Brp[re]-Br[re] ) - dt_ov_dr*( Bl[re+2]-Bl[re] );
+                    Et[im] += -dt*Jt[im] + dt_ov_dl*( Brp[im]-Br[im] ) - dt_ov_dr*( Bl[im+2]-Bl[im] );
+                }
+            }
+
+            if( isYmin ) {
+                // Conditions on axis
+                std::complex<double> *const El2D = emAM->El_[imode]->cdata_+i*nr_p;
+                std::complex<double> *const Er2D = emAM->Er_[imode]->cdata_+i*nr_d;
+                std::complex<double> *const Et2D = emAM->Et_[imode]->cdata_+i*nr_p;
+                const unsigned int j=2;
+                if( imode==0 ) {
+                    if( i<nl_p ) {
+                        Et2D[j] = 0;
+                        Et2D[j-1] = -Et2D[j+1];
+                        Er2D[j] = -Er2D[j+1];
+                    }
+                    El2D[j] += 4.*dt_ov_dr*emAM->Bt_[imode]->cdata_[i*nr_d+j+1]-dt*emAM->Jl_[imode]->cdata_[i*nr_p+j];
+                    El2D[j-1] = El2D[j+1];
+                } else if( imode==1 ) {
+                    El2D[j] = 0;
+                    El2D[j-1] = -El2D[j+1];
+                    if( i<nl_p ) {
+                        Et2D[j] = -Icpx/8.*( 9.*Er2D[j+1]-Er2D[j+2] );// div( E mode 1) = 0 on axis.
+                        Et2D[j-1] = Et2D[j+1];
+                        Er2D[j] = Er2D[j+1];
+                    }
+                } else { // mode > 1
+                    El2D[j] = 0;
+                    El2D[j-1] = -El2D[j+1];
+                    if( i<nl_p ) {
+                        Er2D[j] = -Er2D[j+1];
+                        Et2D[j] = 0;
+                        Et2D[j-1] = -Et2D[j+1];
+                    }
+                }
+            }
+        }
+    }
+#else
     for( unsigned int imode=0 ; imode<Nmode ; imode++ ) {
     
         // Static-cast of the fields_SolverAM_norm.cpp
@@ -100,5 +188,6 @@ void MA_SolverAM_norm::operator()( ElectroMagn *fields )
             }
         }
     }
+#endif
 }
 
@@ -23,6 +23,98 @@ void MF_SolverAM_Yee::operator()( ElectroMagn *fields )
     const unsigned int nl_d = fields->dimDual[0];
     const unsigned int nr_p = fields->dimPrim[1];
     const unsigned int nr_d = fields->dimDual[1];
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    // All the modes are updated line by line along l, so that the radial coefficients stay in cache.
+    // The complex arithmetic is split in real and imaginary parts for the vectorization along r.
+    ElectroMagnAM *emAM = static_cast<ElectroMagnAM *>( fields );
+    const int  j_glob = emAM->j_glob_;
+    const bool isYmin = emAM->isYmin;
+    tabulateInvR( j_glob, nr_p, nr_d );
+    const double *const __restrict__ invR  = invR_.data();
+    const double *const __restrict__ invRd = invRd_.data();
+
+    for( unsigned int i=0 ; i<nl_d ; i++ ) {
+        for( unsigned int imode=0 ; imode<Nmode ; imode++ ) {
+            const double mode = ( double )imode;
+
+            cField2D *El = isEFilterApplied ? static_cast<cField2D *>( fields->filter_->El_[imode][0] ) : emAM->El_[imode];
+            cField2D *Er = isEFilterApplied ? static_cast<cField2D *>( fields->filter_->Er_[imode][0] ) : emAM->Er_[imode];
+            cField2D *Et = isEFilterApplied ? static_cast<cField2D *>( fields->filter_->Et_[imode][0] ) : emAM->Et_[imode];
+
+            // Magnetic field Bl^(p,d)
+            if( i<nl_p ) {
+                double *const __restrict__ Bl       = reinterpret_cast<double *>( emAM->Bl_[imode]->cdata_+i*nr_d );
+                const double *const __restrict__ Er2D = reinterpret_cast<double *>( Er->cdata_+i*nr_d );
+                const double *const __restrict__ Et2D = reinterpret_cast<double *>( Et->cdata_+i*nr_p );
+                #pragma omp simd
+                for( int j=1+isYmin*2 ; j<( int )nr_d-1 ; j++ ) {
+                    const int re = 2*j, im = 2*j+1;
+                    const double r = ( double )( j_glob+j );
+                    Bl[re] += -dt*invRd[j]*( r*Et2D[re] - ( r-1. )*Et2D[re-2] - mode*Er2D[im] );
+                    Bl[im] += -dt*invRd[j]*( r*Et2D[im] - ( r-1. )*Et2D[im-2] + mode*Er2D[re] );
+                }
+            }
+
+            if( i>0 && i<nl_d-1 ) {
+                // Magnetic field Br^(d,p)
+                double *const __restrict__ Br          = reinterpret_cast<double *>( emAM->Br_[imode]->cdata_+i*nr_p );
+                const double *const __restrict__ El2D  = reinterpret_cast<double *>( El->cdata_+i*nr_p );
+                const double *const __restrict__ Et2D  = reinterpret_cast<double *>( Et->cdata_+i*nr_p );
+                const double *const __restrict__ Et2Dm = Et2D-2*nr_p;
+                #pragma omp simd
+                for( int j=isYmin*3 ; j<( int )nr_p ; j++ ) { //Specific condition on axis
+                    const int re = 2*j, im = 2*j+1;
+                    Br[re] += dt_ov_dl*( Et2D[re]-Et2Dm[re] ) - dt*mode*invR[j]*El2D[im];
+                    Br[im] += dt_ov_dl*( Et2D[im]-Et2Dm[im] ) + dt*mode*invR[j]*El2D[re];
+                }
+
+                // Magnetic field Bt^(d,d)
+                double *const __restrict__ Bt          = reinterpret_cast<double *>( emAM->Bt_[imode]->cdata_+i*nr_d );
+                const double *const __restrict__ Er2D  = reinterpret_cast<double *>( Er->cdata_+i*nr_d );
+                const double *const __restrict__ Er2Dm = Er2D-2*nr_d;
+                #pragma omp simd
+                for( int j=1+isYmin*2 ; j<( int )nr_d-1 ; j++ ) {
+                    const int re = 2*j, im = 2*j+1;
+                    Bt[re] += dt_ov_dr*( El2D[re]-El2D[re-2] ) - dt_ov_dl*( Er2D[re]-Er2Dm[re] );
+                    Bt[im] += dt_ov_dr*( El2D[im]-El2D[im-2] ) - dt_ov_dl*( Er2D[im]-Er2Dm[im] );
+                }
+            }
+
+            if( isYmin ) {
+                // On axis conditions
+                std::complex<double> *const Bl2D = emAM->Bl_[imode]->cdata_+i*nr_d;
+                std::complex<double> *const Br2D = emAM->Br_[imode]->cdata_+i*nr_p;
+                std::complex<double> *const Bt2D = emAM->Bt_[imode]->cdata_+i*nr_d;
+                const unsigned int j=2;
+                if( imode==0 ) {
+                    Br2D[j] = 0;
+                    Br2D[1] = -Br2D[3];
+                    Bt2D[j] = -Bt2D[j+1];
+                    if( i<nl_p ) {
+                        Bl2D[j] = Bl2D[j+1];
+                    }
+                } else if( imode==1 ) {
+                    if( i<nl_p ) {
+                        Bl2D[j] = -Bl2D[j+1]; // Zero Bl mode 1 on axis.
+                    }
+                    if( i>0 && i<nl_d-1 ) {
+                        Br2D[j] +=  Icpx*dt_ov_dr*El->cdata_[i*nr_p+j+1]
+                                    + dt_ov_dl*( Et->cdata_[i*nr_p+j]-Et->cdata_[( i-1 )*nr_p+j] );
+                        Br2D[1] = Br2D[3];
+                    }
+                    Bt2D[j] = Bt2D[j+1]; // Non zero Bt mode 1 on axis.
+                } else { // modes > 1
+                    if( i<nl_p ) {
+                        Bl2D[j] = -Bl2D[j+1];
+                    }
+                    Br2D[j] = 0;
+                    Br2D[1] = -Br2D[3];
+                    Bt2D[j] = -Bt2D[j+1];
+                }
+            }
+        }
+    }
+#else
     for( unsigned int imode=0 ; imode<Nmode ; imode++ ) {
 
         // Static-cast of the fields
@@ -114,4 +206,5 @@ void MF_SolverAM_Yee::operator()( ElectroMagn *fields )
             }
         }
     }
+#endif
 }
@@ -537,6 +537,32 @@ void PML_Solver3D_Yee::setDomainSizeAndCoefficients( int iDim, int min_or_max, s
     } // End Z
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Loops of the PML solver: the whole PML domain in the transverse directions, [solvermin, solvermax[ along iDim
+// The fields are addressed by rows along z, so that the innermost loop is contiguous and vectorized
+// ---------------------------------------------------------------------------------------------------------------------
+static inline void pmlBounds( unsigned int *lo, unsigned int *hi,
+                              unsigned int lox, unsigned int hix,
+                              unsigned int loy, unsigned int hiy,
+                              unsigned int loz, unsigned int hiz,
+                              int iDim, unsigned int solvermin, unsigned int solvermax )
+{
+    lo[0] = lox;
+    hi[0] = hix;
+    lo[1] = loy;
+    hi[1] = hiy;
+    lo[2] = loz;
+    hi[2] = hiz;
+    lo[iDim] = solvermin;
+    hi[iDim] = solvermax;
+}
+
+//! Index of the first point of the row (i,j) of a 3D field
+static inline unsigned int pmlRow( Field3D *field, unsigned int i, unsigned int j )
+{
+    return ( i*field->dims_[1] + j )*field->dims_[2];
+}
+
 void PML_Solver3D_Yee::compute_E_from_D( ElectroMagn *fields, int iDim, int min_or_max, std::vector<unsigned int> dimPrim, unsigned int solvermin, unsigned int solvermax )
 {
     const unsigned int nx_p = dimPrim[0];
@@ -545,210 +571,117 @@ void PML_Solver3D_Yee::compute_E_from_D( ElectroMagn *fields, int iDim, int min_
     const unsigned int ny_d = dimPrim[1] + 1;
     const unsigned int nz_p = dimPrim[2];
     const unsigned int nz_d = dimPrim[2] + 1;
-    
+
     ElectroMagnBC3D_PML* pml_fields = static_cast<ElectroMagnBC3D_PML*>( fields->emBoundCond[iDim*2+min_or_max] );
-    Field3D* Ex_pml = NULL;
-    Field3D* Ey_pml = NULL;
-    Field3D* Ez_pml = NULL;
-    Field3D* Hx_pml = NULL;
-    Field3D* Hy_pml = NULL;
-    Field3D* Hz_pml = NULL;
-    Field3D* Dx_pml = NULL;
-    Field3D* Dy_pml = NULL;
-    Field3D* Dz_pml = NULL;
-
-    Ex_pml = pml_fields->Ex_;
-    Ey_pml = pml_fields->Ey_;
-    Ez_pml = pml_fields->Ez_;
-    Hx_pml = pml_fields->Hx_;
-    Hy_pml = pml_fields->Hy_;
-    Hz_pml = pml_fields->Hz_;
-    Dx_pml = pml_fields->Dx_;
-    Dy_pml = pml_fields->Dy_;
-    Dz_pml = pml_fields->Dz_;
+    Field3D* Ex_pml = pml_fields->Ex_;
+    Field3D* Ey_pml = pml_fields->Ey_;
+    Field3D* Ez_pml = pml_fields->Ez_;
+    Field3D* Hx_pml = pml_fields->Hx_;
+    Field3D* Hy_pml = pml_fields->Hy_;
+    Field3D* Hz_pml = pml_fields->Hz_;
+    Field3D* Dx_pml = pml_fields->Dx_;
+    Field3D* Dy_pml = pml_fields->Dy_;
+    Field3D* Dz_pml = pml_fields->Dz_;
 
-    if (min_or_max==0){
-        isMin=true;
-        isMax=false;
-    }
-    else if (min_or_max==1){
-        isMin=false;
-        isMax=true;
-    }
+    isMin = ( min_or_max==0 );
+    isMax = ( min_or_max==1 );
 
-    if (iDim == 0) {
-        //Electric field Ex^(d,p,p) Remind that in PML, there no current
-        for( unsigned int i=solvermin ; i<(unsigned int)solvermax ; i++ ) {
-            for( unsigned int j=0 ; j<ny_p ; j++ ) {
-                for( unsigned int k=0 ; k<nz_p ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ex_pml )( i, j, k ) = + 1. * ( *Ex_pml )( i, j, k )
-                    //                          + dt/dy * ( ( *Hz_pml )( i, j+1, k ) - ( *Hz_pml )( i, j, k ) )
-                    //                          - dt/dz * ( ( *Hy_pml )( i, j, k+1 ) - ( *Hy_pml )( i, j, k ) );
-                    // ( *Dx_pml )( i, j, k ) = 1*( *Ex_pml )( i, j, k );
-                    // PML FDTD
-                    Dx_pml_old = 1*( *Dx_pml )( i, j, k ) ;
-                    ( *Dx_pml )( i, j, k ) = + c1_p_xfield[j] * ( *Dx_pml )( i, j, k )
-                                             + c2_p_xfield[j]/dy * ( ( *Hz_pml )( i, j+1, k ) - ( *Hz_pml )( i, j, k ) )
-                                             - c2_p_xfield[j]/dz * ( ( *Hy_pml )( i, j, k+1 ) - ( *Hy_pml )( i, j, k ) ) ;
-                    ( *Ex_pml )( i, j, k ) = + c3_p_xfield[k] * ( *Ex_pml )( i, j, k )
-                                             + c4_p_xfield[k] * ( c5_d_xfield[i]*( *Dx_pml )( i, j, k ) - c6_d_xfield[i]*Dx_pml_old ) ;
-                }
-            }
-        }
-        //Electric field Ey^(p,d,p) Remind that in PML, there no current
-        for( unsigned int i=solvermin ; i<(unsigned int)solvermax ; i++ ) {
-            for( unsigned int j=0 ; j<ny_d ; j++ ) {
-                for( unsigned int k=0 ; k<nz_p ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ey_pml )( i, j , k) = + 1. * ( *Ey_pml )( i, j, k )
-                    //                       - dt/dx * ( ( *Hz_pml )( i+1, j, k ) - ( *Hz_pml )( i, j, k ) )
-                    //                       + dt/dz * ( ( *Hx_pml )( i, j, k+1 ) - ( *Hx_pml )( i, j, k ) );
-                    // ( *Dy_pml )( i, j, k ) = 1*( *Ey_pml )( i, j, k );
-                    // PML FDTD
-                    Dy_pml_old = 1*( *Dy_pml )( i, j, k ) ;
-                    ( *Dy_pml )( i, j, k ) = + c1_p_yfield[k] * ( *Dy_pml )( i, j, k )
-                                             - c2_p_yfield[k]/dx * ( ( *Hz_pml )( i+1, j, k ) - ( *Hz_pml )( i, j, k ) )
-                                             + c2_p_yfield[k]/dz * ( ( *Hx_pml )( i, j, k+1 ) - ( *Hx_pml )( i, j, k ) ) ;
-                    ( *Ey_pml )( i, j, k ) = + c3_p_yfield[i] * ( *Ey_pml )( i, j, k )
-                                             + c4_p_yfield[i] * (c5_d_yfield[j]*( *Dy_pml )( i, j,k ) - c6_d_yfield[j]*Dy_pml_old ) ;
-                }
-            }
-        }
-        //Electric field Ez^(p,p,d) Remind that in PML, there no current
-        for( unsigned int i=solvermin ; i<(unsigned int)solvermax ; i++ ) {
-            for( unsigned int j=0 ; j<ny_p ; j++ ) {
-                for( unsigned int k=0 ; k<nz_d ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ez_pml )( i, j, k ) = + 1. * ( *Ez_pml )( i, j, k )
-                    //                       - dt/dy * ( ( *Hx_pml )( i, j+1, k ) - ( *Hx_pml )( i, j, k ) )
-                    //                       + dt/dx * ( ( *Hy_pml )( i+1, j, k ) - ( *Hy_pml )( i, j, k ) );
-                    // ( *Dz_pml )( i, j, k ) = 1*( *Ez_pml )( i, j, k );
-                    // PML FDTD
-                    Dz_pml_old = 1*( *Dz_pml )( i, j, k ) ;
-                    ( *Dz_pml )( i, j, k ) = + c1_p_zfield[i] * ( *Dz_pml )( i, j, k )
-                                             - c2_p_zfield[i]/dy * ( ( *Hx_pml )( i, j+1, k ) - ( *Hx_pml )( i, j, k ) )
-                                             + c2_p_zfield[i]/dx * ( ( *Hy_pml )( i+1, j, k ) - ( *Hy_pml )( i, j, k ) );
-                    ( *Ez_pml )( i, j, k ) = + c3_p_zfield[j] * ( *Ez_pml )( i, j, k )
-                                             + c4_p_zfield[j] * (c5_d_zfield[k]*( *Dz_pml )( i, j, k ) - c6_d_zfield[k]*Dz_pml_old );
+    double *const __restrict__ Ex = Ex_pml->data_;
+    double *const __restrict__ Ey = Ey_pml->data_;
+    double *const __restrict__ Ez = Ez_pml->data_;
+    double *const __restrict__ Dx = Dx_pml->data_;
+    double *const __restrict__ Dy = Dy_pml->data_;
+    double *const __restrict__ Dz = Dz_pml->data_;
+    const double *const __restrict__ Hx = Hx_pml->data_;
+    const double *const __restrict__ Hy = Hy_pml->data_;
+    const double *const __restrict__ Hz = Hz_pml->data_;
+
+    unsigned int lo[3], hi[3];
+
+    // Standard FDTD: E = E + dt * curl H ; PML FDTD: D is advanced with curl H, then E with D
+    //Electric field Ex^(d,p,p) Remind that in PML, there no current
+    pmlBounds( lo, hi, 0, nx_d, 0, ny_p, 0, nz_p, iDim, solvermin, solvermax );
+    {
+        const double *const __restrict__ c3 = &c3_p_xfield[0];
+        const double *const __restrict__ c4 = &c4_p_xfield[0];
+        for( unsigned int i=lo[0] ; i<hi[0] ; i++ ) {
+            for( unsigned int j=lo[1] ; j<hi[1] ; j++ ) {
+                const double c1  = c1_p_xfield[j];
+                const double c2y = c2_p_xfield[j]/dy;
+                const double c2z = c2_p_xfield[j]/dz;
+                const double c5  = c5_d_xfield[i];
+                const double c6  = c6_d_xfield[i];
+                const unsigned int ix  = pmlRow( Ex_pml, i, j );
+                const unsigned int iz0 = pmlRow( Hz_pml, i, j );
+                const unsigned int iz1 = pmlRow( Hz_pml, i, j+1 );
+                const unsigned int iy  = pmlRow( Hy_pml, i, j );
+                #pragma omp simd
+                for( unsigned int k=lo[2] ; k<hi[2] ; k++ ) {
+                    const double D_old = Dx[ix+k];
+                    const double D_new = + c1 * D_old
+                                         + c2y * ( Hz[iz1+k] - Hz[iz0+k] )
+                                         - c2z * ( Hy[iy+k+1] - Hy[iy+k] );
+                    Dx[ix+k] = D_new;
+                    Ex[ix+k] = + c3[k] * Ex[ix+k]
+                               + c4[k] * ( c5*D_new - c6*D_old );
                 }
             }
         }
     }
-    else if (iDim == 1) {
-        //Electric field Ex^(d,p,p) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_d ; i++ ) {
-            for( unsigned int j=solvermin ; j<(unsigned int)solvermax ; j++ ) {
-                for( unsigned int k=0 ; k<nz_p ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ex_pml )( i, j, k ) = + 1. * ( *Ex_pml )( i, j, k )
-                    //                          + dt/dy * ( ( *Hz_pml )( i, j+1, k ) - ( *Hz_pml )( i, j, k ) )
-                    //                          - dt/dz * ( ( *Hy_pml )( i, j, k+1 ) - ( *Hy_pml )( i, j, k ) );
-                    // ( *Dx_pml )( i, j, k ) = 1*( *Ex_pml )( i, j, k );
-                    // PML FDTD
-                    Dx_pml_old = 1*( *Dx_pml )( i, j, k ) ;
-                    ( *Dx_pml )( i, j, k ) = + c1_p_xfield[j] * ( *Dx_pml )( i, j, k )
-                                             + c2_p_xfield[j]/dy * ( ( *Hz_pml )( i, j+1, k ) - ( *Hz_pml )( i, j, k ) )
-                                             - c2_p_xfield[j]/dz * ( ( *Hy_pml )( i, j, k+1 ) - ( *Hy_pml )( i, j, k ) ) ;
-                    ( *Ex_pml )( i, j, k ) = + c3_p_xfield[k] * ( *Ex_pml )( i, j, k )
-                                             + c4_p_xfield[k] * ( c5_d_xfield[i]*( *Dx_pml )( i, j, k ) - c6_d_xfield[i]*Dx_pml_old ) ;
-                }
-            }
-        }
-        //Electric field Ey^(p,d,p) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_p ; i++ ) {
-            for( unsigned int j=solvermin ; j<(unsigned int)solvermax ; j++ ) {
-                for( unsigned int k=0 ; k<nz_p ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ey_pml )( i, j , k) = + 1. * ( *Ey_pml )( i, j, k )
-                    //                       - dt/dx * ( ( *Hz_pml )( i+1, j, k ) - ( *Hz_pml )( i, j, k ) )
-                    //                       + dt/dz * ( ( *Hx_pml )( i, j, k+1 ) - ( *Hx_pml )( i, j, k ) );
-                    // ( *Dy_pml )( i, j, k ) = 1*( *Ey_pml )( i, j, k );
-                    // PML FDTD
-                    Dy_pml_old = 1*( *Dy_pml )( i, j, k ) ;
-                    ( *Dy_pml )( i, j, k ) = + c1_p_yfield[k] * ( *Dy_pml )( i, j, k )
-                                             - c2_p_yfield[k]/dx * ( ( *Hz_pml )( i+1, j, k ) - ( *Hz_pml )( i, j, k ) )
-                                             + c2_p_yfield[k]/dz * ( ( *Hx_pml )( i, j, k+1 ) - ( *Hx_pml )( i, j, k ) ) ;
-                    ( *Ey_pml )( i, j, k ) = + c3_p_yfield[i] * ( *Ey_pml )( i, j, k )
-                                             + c4_p_yfield[i] * (c5_d_yfield[j]*( *Dy_pml )( i, j,k ) - c6_d_yfield[j]*Dy_pml_old ) ;
-                }
-            }
-        }
-        //Electric field Ez^(p,p,d) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_p ; i++ ) {
-            for( unsigned int j=solvermin ; j<(unsigned int)solvermax ; j++ ) {
-                for( unsigned int k=0 ; k<nz_d ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ez_pml )( i, j, k ) = + 1. * ( *Ez_pml )( i, j, k )
-                    //                       - dt/dy * ( ( *Hx_pml )( i, j+1, k ) - ( *Hx_pml )( i, j, k ) )
-                    //                       + dt/dx * ( ( *Hy_pml )( i+1, j, k ) - ( *Hy_pml )( i, j, k ) );
-                    // ( *Dz_pml )( i, j, k ) = 1*( *Ez_pml )( i, j, k );
-                    // PML FDTD
-                    Dz_pml_old = 1*( *Dz_pml )( i, j, k ) ;
-                    ( *Dz_pml )( i, j, k ) = + c1_p_zfield[i] * ( *Dz_pml )( i, j, k )
-                                             - c2_p_zfield[i]/dy * ( ( *Hx_pml )( i, j+1, k ) - ( *Hx_pml )( i, j, k ) )
-                                             + c2_p_zfield[i]/dx * ( ( *Hy_pml )( i+1, j, k ) - ( *Hy_pml )( i, j, k ) );
-                    ( *Ez_pml )( i, j, k ) = + c3_p_zfield[j] * ( *Ez_pml )( i, j, k )
-                                             + c4_p_zfield[j] * (c5_d_zfield[k]*( *Dz_pml )( i, j, k ) - c6_d_zfield[k]*Dz_pml_old );
+    //Electric field Ey^(p,d,p) Remind that in PML, there no current
+    pmlBounds( lo, hi, 0, nx_p, 0, ny_d, 0, nz_p, iDim, solvermin, solvermax );
+    {
+        const double *const __restrict__ c1 = &c1_p_yfield[0];
+        const double *const __restrict__ c2 = &c2_p_yfield[0];
+        for( unsigned int i=lo[0] ; i<hi[0] ; i++ ) {
+            for( unsigned int j=lo[1] ; j<hi[1] ; j++ ) {
+                const double c3 = c3_p_yfield[i];
+                const double c4 = c4_p_yfield[i];
+                const double c5 = c5_d_yfield[j];
+                const double c6 = c6_d_yfield[j];
+                const unsigned int iy  = pmlRow( Ey_pml, i, j );
+                const unsigned int iz0 = pmlRow( Hz_pml, i, j );
+                const unsigned int iz1 = pmlRow( Hz_pml, i+1, j );
+                const unsigned int ix  = pmlRow( Hx_pml, i, j );
+                #pragma omp simd
+                for( unsigned int k=lo[2] ; k<hi[2] ; k++ ) {
+                    const double D_old = Dy[iy+k];
+                    const double D_new = + c1[k] * D_old
+                                         - c2[k]/dx * ( Hz[iz1+k] - Hz[iz0+k] )
+                                         + c2[k]/dz * ( Hx[ix+k+1] - Hx[ix+k] );
+                    Dy[iy+k] = D_new;
+                    Ey[iy+k] = + c3 * Ey[iy+k]
+                               + c4 * ( c5*D_new - c6*D_old );
                 }
             }
         }
     }
-    else if (iDim == 2) {
-        //Electric field Ex^(d,p,p) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_d ; i++ ) {
-            for( unsigned int j=0 ; j<ny_p ; j++ ) {
-                for( unsigned int k=solvermin ; k<(unsigned int)solvermax ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ex_pml )( i, j, k ) = + 1. * ( *Ex_pml )( i, j, k )
-                    //                          + dt/dy * ( ( *Hz_pml )( i, j+1, k ) - ( *Hz_pml )( i, j, k ) )
-                    //                          - dt/dz * ( ( *Hy_pml )( i, j, k+1 ) - ( *Hy_pml )( i, j, k ) );
-                    // ( *Dx_pml )( i, j, k ) = 1*( *Ex_pml )( i, j, k );
-                    // PML FDTD
-                    Dx_pml_old = 1*( *Dx_pml )( i, j, k ) ;
-                    ( *Dx_pml )( i, j, k ) = + c1_p_xfield[j] * ( *Dx_pml )( i, j, k )
-                                             + c2_p_xfield[j]/dy * ( ( *Hz_pml )( i, j+1, k ) - ( *Hz_pml )( i, j, k ) )
-                                             - c2_p_xfield[j]/dz * ( ( *Hy_pml )( i, j, k+1 ) - ( *Hy_pml )( i, j, k ) ) ;
-                    ( *Ex_pml )( i, j, k ) = + c3_p_xfield[k] * ( *Ex_pml )( i, j, k )
-                                             + c4_p_xfield[k] * ( c5_d_xfield[i]*( *Dx_pml )( i, j, k ) - c6_d_xfield[i]*Dx_pml_old ) ;
-                }
-            }
-        }
-        //Electric field Ey^(p,d,p) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_p ; i++ ) {
-            for( unsigned int j=0 ; j<ny_d ; j++ ) {
-                for( unsigned int k=solvermin ; k<(unsigned int)solvermax ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ey_pml )( i, j , k) = + 1. * ( *Ey_pml )( i, j, k )
-                    //                       - dt/dx * ( ( *Hz_pml )( i+1, j, k ) - ( *Hz_pml )( i, j, k ) )
-                    //                       + dt/dz * ( ( *Hx_pml )( i, j, k+1 ) - ( *Hx_pml )( i, j, k ) );
-                    // ( *Dy_pml )( i, j, k ) = 1*( *Ey_pml )( i, j, k );
-                    // PML FDTD
-                    Dy_pml_old = 1*( *Dy_pml )( i, j, k ) ;
-                    ( *Dy_pml )( i, j, k ) = + c1_p_yfield[k] * ( *Dy_pml )( i, j, k )
-                                             - c2_p_yfield[k]/dx * ( ( *Hz_pml )( i+1, j, k ) - ( *Hz_pml )( i, j, k ) )
-                                             + c2_p_yfield[k]/dz * ( ( *Hx_pml )( i, j, k+1 ) - ( *Hx_pml )( i, j, k ) ) ;
-                    ( *Ey_pml )( i, j, k ) = + c3_p_yfield[i] * ( *Ey_pml )( i, j, k )
-                                             + c4_p_yfield[i] * (c5_d_yfield[j]*( *Dy_pml )( i, j,k ) - c6_d_yfield[j]*Dy_pml_old ) ;
-                }
-            }
-        }
-        //Electric field Ez^(p,p,d) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_p ; i++ ) {
-            for( unsigned int j=0 ; j<ny_p ; j++ ) {
-                for( unsigned int k=solvermin ; k<(unsigned int)solvermax ; k++ ) {
-                    // Standard FDTD
-                    // ( *Ez_pml )( i, j, k ) = + 1. * ( *Ez_pml )( i, j, k )
-                    //                       - dt/dy * ( ( *Hx_pml )( i, j+1, k ) - ( *Hx_pml )( i, j, k ) )
-                    //                       + dt/dx * ( ( *Hy_pml )( i+1, j, k ) - ( *Hy_pml )( i, j, k ) );
-                    // ( *Dz_pml )( i, j, k ) = 1*( *Ez_pml )( i, j, k );
-                    // PML FDTD
-                    Dz_pml_old = 1*( *Dz_pml )( i, j, k ) ;
-                    ( *Dz_pml )( i, j, k ) = + c1_p_zfield[i] * ( *Dz_pml )( i, j, k )
-                                             - c2_p_zfield[i]/dy * ( ( *Hx_pml )( i, j+1, k ) - ( *Hx_pml )( i, j, k ) )
-                                             + c2_p_zfield[i]/dx * ( ( *Hy_pml )( i+1, j, k ) - ( *Hy_pml )( i, j, k ) );
-                    ( *Ez_pml )( i, j, k ) = + c3_p_zfield[j] * ( *Ez_pml )( i, j, k )
-                                             + c4_p_zfield[j] * (c5_d_zfield[k]*( *Dz_pml )( i, j, k ) - c6_d_zfield[k]*Dz_pml_old );
+    //Electric field Ez^(p,p,d) Remind that in PML, there no current
+    pmlBounds( lo, hi, 0, nx_p, 0, ny_p, 0, nz_d, iDim, solvermin, solvermax );
+    {
+        const double *const __restrict__ c5 = &c5_d_zfield[0];
+        const double *const __restrict__ c6 = &c6_d_zfield[0];
+        for( unsigned int i=lo[0] ; i<hi[0] ; i++ ) {
+            const double c1  = c1_p_zfield[i];
+            const double c2y = c2_p_zfield[i]/dy;
+            const double c2x = c2_p_zfield[i]/dx;
+            for( unsigned int j=lo[1] ; j<hi[1] ; j++ ) {
+                const double c3 = c3_p_zfield[j];
+                const double c4 = c4_p_zfield[j];
+                const unsigned int iz  = pmlRow( Ez_pml, i, j );
+                const unsigned int ix0 = pmlRow( Hx_pml, i, j );
+                const unsigned int ix1 = pmlRow( Hx_pml, i, j+1 );
+                const unsigned int iy0 = pmlRow( Hy_pml, i, j );
+                const unsigned int iy1 = pmlRow( Hy_pml, i+1, j );
+                #pragma omp simd
+                for( unsigned int k=lo[2] ; k<hi[2] ; k++ ) {
+                    const double D_old = Dz[iz+k];
+                    const double D_new = + c1 * D_old
+                                         - c2y * ( Hx[ix1+k] - Hx[ix0+k] )
+                                         + c2x * ( Hy[iy1+k] - Hy[iy0+k] );
+                    Dz[iz+k] = D_new;
+                    Ez[iz+k] = + c3 * Ez[iz+k]
+                               + c4 * ( c5[k]*D_new - c6[k]*D_old );
                 }
             }
         }
@@ -763,210 +696,117 @@ void PML_Solver3D_Yee::compute_H_from_B( ElectroMagn *fields, int iDim, int min_
     const unsigned int ny_d = dimPrim[1] + 1;
     const unsigned int nz_p = dimPrim[2];
     const unsigned int nz_d = dimPrim[2] + 1;
-    
+
     ElectroMagnBC3D_PML* pml_fields = static_cast<ElectroMagnBC3D_PML*>( fields->emBoundCond[iDim*2+min_or_max] );
-    Field3D* Ex_pml = NULL;
-    Field3D* Ey_pml = NULL;
-    Field3D* Ez_pml = NULL;
-    Field3D* Hx_pml = NULL;
-    Field3D* Hy_pml = NULL;
-    Field3D* Hz_pml = NULL;
-    Field3D* Bx_pml = NULL;
-    Field3D* By_pml = NULL;
-    Field3D* Bz_pml = NULL;
-
-    Ex_pml = pml_fields->Ex_;
-    Ey_pml = pml_fields->Ey_;
-    Ez_pml = pml_fields->Ez_;
-    Hx_pml = pml_fields->Hx_;
-    Hy_pml = pml_fields->Hy_;
-    Hz_pml = pml_fields->Hz_;
-    Bx_pml = pml_fields->Bx_;
-    By_pml = pml_fields->By_;
-    Bz_pml = pml_fields->Bz_;
+    Field3D* Ex_pml = pml_fields->Ex_;
+    Field3D* Ey_pml = pml_fields->Ey_;
+    Field3D* Ez_pml = pml_fields->Ez_;
+    Field3D* Hx_pml = pml_fields->Hx_;
+    Field3D* Hy_pml = pml_fields->Hy_;
+    Field3D* Hz_pml = pml_fields->Hz_;
+    Field3D* Bx_pml = pml_fields->Bx_;
+    Field3D* By_pml = pml_fields->By_;
+    Field3D* Bz_pml = pml_fields->Bz_;
 
-    if (min_or_max==0){
-        isMin=true;
-        isMax=false;
-    }
-    else if (min_or_max==1){
-        isMin=false;
-        isMax=true;
-    }
+    isMin = ( min_or_max==0 );
+    isMax = ( min_or_max==1 );
 
-    if (iDim==0){
-        //Magnetic field Bx^(p,d,d) Remind that in PML, there no current
-        for( unsigned int i=solvermin ; i<(unsigned int)solvermax ; i++ ) {
-            for( unsigned int j=1 ; j<ny_d-1 ; j++ ) {
-                for( unsigned int k=1 ; k<nz_d-1 ; k++ ) {
-                    // Standard FDTD
-                    // ( *Bx_pml )( i, j, k ) = + 1 * ( *Bx_pml )( i, j, k )
-                    //                          - dt/dy * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i, j-1, k ) )
-                    //                          + dt/dz * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i, j, k-1 ) ) ;
-                    // ( *Hx_pml )( i, j, k ) = + 1 * ( *Bx_pml )( i, j, k );
-                    // PML FDTD
-                    Bx_pml_old = 1*( *Bx_pml )( i, j, k ) ;
-                    ( *Bx_pml )( i, j, k ) = + c1_d_xfield[j] * ( *Bx_pml )( i, j, k )
-                                             - c2_d_xfield[j]/dy * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i, j-1, k ) )
-                                             + c2_d_xfield[j]/dz * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i, j, k-1 ) );
-                    ( *Hx_pml )( i, j, k ) = + c3_d_xfield[k] * ( *Hx_pml )( i, j, k )
-                                             + c4_d_xfield[k] * (c5_p_xfield[i]*( *Bx_pml )( i, j, k ) - c6_p_xfield[i]*Bx_pml_old ) ;
-                }
-            }
-        }
-        //Magnetic field By^(d,p,d) Remind that in PML, there no current
-        for( unsigned int i=solvermin ; i<(unsigned int)solvermax ; i++ ) {
-            for( unsigned int j=0 ; j<ny_p ; j++ ) {
-                for( unsigned int k=1 ; k<nz_d-1 ; k++ ) {
-                    // Standard FDTD
-                    // ( *By_pml )( i, j, k ) = + 1 * ( *By_pml )( i, j, k )
-                    //                          + dt/dx * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i-1, j, k ) )
-                    //                          - dt/dz * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j, k-1 ) );
-                    // ( *Hy_pml )( i, j, k ) = + 1 * ( *By_pml )( i, j, k );
-                    // PML FDTD
-                    By_pml_old = 1*( *By_pml )( i, j, k ) ;
-                    ( *By_pml )( i, j, k ) = + c1_d_yfield[k] * ( *By_pml )( i, j, k )
-                                             + c2_d_yfield[k]/dx * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i-1, j, k ) )
-                                             - c2_d_yfield[k]/dz * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j, k-1 ) );
-                    ( *Hy_pml )( i, j, k ) = + c3_d_yfield[i] * ( *Hy_pml )( i, j, k )
-                                             + c4_d_yfield[i] * (c5_p_yfield[j]*( *By_pml )( i, j, k ) - c6_p_yfield[j]*By_pml_old ) ;
-                }
-            }
-        }
-        //Magnetic field Bz^(d,d,p) Remind that in PML, there no current
-        for( unsigned int i=solvermin ; i<(unsigned int)solvermax ; i++ ) {
-            for( unsigned int j=1 ; j<ny_d-1 ; j++ ) {
-                for( unsigned int k=0 ; k<nz_p ; k++ ) {
-                    // Standard FDTD
-                    // ( *Bz_pml )( i, j, k ) = + 1 * ( *Bz_pml )( i, j, k )
-                    //                          + dt/dy * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j-1, k ) )
-                    //                          - dt/dx * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i-1, j, k ) );
-                    // ( *Hz_pml )( i, j, k ) = + 1 * ( *Bz_pml )( i, j, k );
-                    // PML FDTD
-                    Bz_pml_old = 1*( *Bz_pml )( i, j, k ) ;
-                    ( *Bz_pml )( i, j, k ) = + c1_d_zfield[i] * ( *Bz_pml )( i, j, k )
-                                             + c2_d_zfield[i]/dy * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j-1, k ) )
-                                             - c2_d_zfield[i]/dx * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i-1, j, k ) );
-                    ( *Hz_pml )( i, j, k ) = + c3_d_zfield[j] * ( *Hz_pml )( i, j, k )
-                                             + c4_d_zfield[j] * (c5_p_zfield[k]*( *Bz_pml )( i, j, k ) - c6_p_zfield[k]*Bz_pml_old );
+    const double *const __restrict__ Ex = Ex_pml->data_;
+    const double *const __restrict__ Ey = Ey_pml->data_;
+    const double *const __restrict__ Ez = Ez_pml->data_;
+    double *const __restrict__ Hx = Hx_pml->data_;
+    double *const __restrict__ Hy = Hy_pml->data_;
+    double *const __restrict__ Hz = Hz_pml->data_;
+    double *const __restrict__ Bx = Bx_pml->data_;
+    double *const __restrict__ By = By_pml->data_;
+    double *const __restrict__ Bz = Bz_pml->data_;
+
+    unsigned int lo[3], hi[3];
+
+    // Standard FDTD: B = B - dt * curl E ; PML FDTD: B is advanced with curl E, then H with B
+    //Magnetic field Bx^(p,d,d) Remind that in PML, there no current
+    pmlBounds( lo, hi, 0, nx_p, 1, ny_d-1, 1, nz_d-1, iDim, solvermin, solvermax );
+    {
+        const double *const __restrict__ c3 = &c3_d_xfield[0];
+        const double *const __restrict__ c4 = &c4_d_xfield[0];
+        for( unsigned int i=lo[0] ; i<hi[0] ; i++ ) {
+            for( unsigned int j=lo[1] ; j<hi[1] ; j++ ) {
+                const double c1  = c1_d_xfield[j];
+                const double c2y = c2_d_xfield[j]/dy;
+                const double c2z = c2_d_xfield[j]/dz;
+                const double c5  = c5_p_xfield[i];
+                const double c6  = c6_p_xfield[i];
+                const unsigned int ix  = pmlRow( Bx_pml, i, j );
+                const unsigned int iz0 = pmlRow( Ez_pml, i, j-1 );
+                const unsigned int iz1 = pmlRow( Ez_pml, i, j );
+                const unsigned int iy  = pmlRow( Ey_pml, i, j );
+                #pragma omp simd
+                for( unsigned int k=lo[2] ; k<hi[2] ; k++ ) {
+                    const double B_old = Bx[ix+k];
+                    const double B_new = + c1 * B_old
+                                         - c2y * ( Ez[iz1+k] - Ez[iz0+k] )
+                                         + c2z * ( Ey[iy+k] - Ey[iy+k-1] );
+                    Bx[ix+k] = B_new;
+                    Hx[ix+k] = + c3[k] * Hx[ix+k]
+                               + c4[k] * ( c5*B_new - c6*B_old );
                 }
             }
         }
     }
-    else if (iDim==1) {
-        //Magnetic field Bx^(p,d,d) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_p ; i++ ) {
-            for( unsigned int j=solvermin ; j<(unsigned int)solvermax ; j++ ) {
-                for( unsigned int k=1 ; k<nz_d-1 ; k++ ) {
-                    // Standard FDTD
-                    // ( *Bx_pml )( i, j, k ) = + 1 * ( *Bx_pml )( i, j, k )
-                    //                          - dt/dy * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i, j-1, k ) )
-                    //                          + dt/dz * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i, j, k-1 ) ) ;
-                    // ( *Hx_pml )( i, j, k ) = + 1 * ( *Bx_pml )( i, j, k );
-                    // PML FDTD
-                    Bx_pml_old = 1*( *Bx_pml )( i, j, k ) ;
-                    ( *Bx_pml )( i, j, k ) = + c1_d_xfield[j] * ( *Bx_pml )( i, j, k )
-                                             - c2_d_xfield[j]/dy * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i, j-1, k ) )
-                                             + c2_d_xfield[j]/dz * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i, j, k-1 ) );
-                    ( *Hx_pml )( i, j, k ) = + c3_d_xfield[k] * ( *Hx_pml )( i, j, k )
-                                             + c4_d_xfield[k] * (c5_p_xfield[i]*( *Bx_pml )( i, j, k ) - c6_p_xfield[i]*Bx_pml_old ) ;
-                }
-            }
-        }
-        //Magnetic field By^(d,p,d) Remind that in PML, there no current
-        for( unsigned int i=1 ; i<nx_d-1 ; i++ ) {
-            for( unsigned int j=solvermin ; j<(unsigned int)solvermax ; j++ ) {
-                for( unsigned int k=1 ; k<nz_d-1 ; k++ ) {
-                    // Standard FDTD
-                    // ( *By_pml )( i, j, k ) = + 1 * ( *By_pml )( i, j, k )
-                    //                          + dt/dx * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i-1, j, k ) )
-                    //                          - dt/dz * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j, k-1 ) );
-                    // ( *Hy_pml )( i, j, k ) = + 1 * ( *By_pml )( i, j, k );
-                    // PML FDTD
-                    By_pml_old = 1*( *By_pml )( i, j, k ) ;
-                    ( *By_pml )( i, j, k ) = + c1_d_yfield[k] * ( *By_pml )( i, j, k )
-                                             + c2_d_yfield[k]/dx * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i-1, j, k ) )
-                                             - c2_d_yfield[k]/dz * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j, k-1 ) );
-                    ( *Hy_pml )( i, j, k ) = + c3_d_yfield[i] * ( *Hy_pml )( i, j, k )
-                                             + c4_d_yfield[i] * (c5_p_yfield[j]*( *By_pml )( i, j, k ) - c6_p_yfield[j]*By_pml_old ) ;
-                }
-            }
-        }
-        //Magnetic field Bz^(d,d,p) Remind that in PML, there no current
-        for( unsigned int i=1 ; i<nx_d-1 ; i++ ) {
-            for( unsigned int j=solvermin ; j<(unsigned int)solvermax ; j++ ) {
-                for( unsigned int k=0 ; k<nz_p ; k++ ) {
-                    // Standard FDTD
-                    // ( *Bz_pml )( i, j, k ) = + 1 * ( *Bz_pml )( i, j, k )
-                    //                          + dt/dy * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j-1, k ) )
-                    //                          - dt/dx * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i-1, j, k ) );
-                    // ( *Hz_pml )( i, j, k ) = + 1 * ( *Bz_pml )( i, j, k );
-                    // PML FDTD
-                    Bz_pml_old = 1*( *Bz_pml )( i, j, k ) ;
-                    ( *Bz_pml )( i, j, k ) = + c1_d_zfield[i] * ( *Bz_pml )( i, j, k )
-                                             + c2_d_zfield[i]/dy * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j-1, k ) )
-                                             - c2_d_zfield[i]/dx * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i-1, j, k ) );
-                    ( *Hz_pml )( i, j, k ) = + c3_d_zfield[j] * ( *Hz_pml )( i, j, k )
-                                             + c4_d_zfield[j] * (c5_p_zfield[k]*( *Bz_pml )( i, j, k ) - c6_p_zfield[k]*Bz_pml_old );
+    //Magnetic field By^(d,p,d) Remind that in PML, there no current
+    pmlBounds( lo, hi, 1, nx_d-1, 0, ny_p, 1, nz_d-1, iDim, solvermin, solvermax );
+    {
+        const double *const __restrict__ c1 = &c1_d_yfield[0];
+        const double *const __restrict__ c2 = &c2_d_yfield[0];
+        for( unsigned int i=lo[0] ; i<hi[0] ; i++ ) {
+            for( unsigned int j=lo[1] ; j<hi[1] ; j++ ) {
+                const double c3 = c3_d_yfield[i];
+                const double c4 = c4_d_yfield[i];
+                const double c5 = c5_p_yfield[j];
+                const double c6 = c6_p_yfield[j];
+                const unsigned int iy  = pmlRow( By_pml, i, j );
+                const unsigned int iz0 = pmlRow( Ez_pml, i-1, j );
+                const unsigned int iz1 = pmlRow( Ez_pml, i, j );
+                const unsigned int ix  = pmlRow( Ex_pml, i, j );
+                #pragma omp simd
+                for( unsigned int k=lo[2] ; k<hi[2] ; k++ ) {
+                    const double B_old = By[iy+k];
+                    const double B_new = + c1[k] * B_old
+                                         + c2[k]/dx * ( Ez[iz1+k] - Ez[iz0+k] )
+                                         - c2[k]/dz * ( Ex[ix+k] - Ex[ix+k-1] );
+                    By[iy+k] = B_new;
+                    Hy[iy+k] = + c3 * Hy[iy+k]
+                               + c4 * ( c5*B_new - c6*B_old );
                 }
             }
         }
     }
-    else if (iDim==2) {
-        //Magnetic field Bx^(p,d,d) Remind that in PML, there no current
-        for( unsigned int i=0 ; i<nx_p ; i++ ) {
-            for( unsigned int j=1 ; j<ny_d-1 ; j++ ) {
-                for( unsigned int k=solvermin ; k<(unsigned int)solvermax ; k++ ) {
-                    // Standard FDTD
-                    // ( *Bx_pml )( i, j, k ) = + 1 * ( *Bx_pml )( i, j, k )
-                    //                          - dt/dy * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i, j-1, k ) )
-                    //                          + dt/dz * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i, j, k-1 ) ) ;
-                    // ( *Hx_pml )( i, j, k ) = + 1 * ( *Bx_pml )( i, j, k );
-                    // PML FDTD
-                    Bx_pml_old = 1*( *Bx_pml )( i, j, k ) ;
-                    ( *Bx_pml )( i, j, k ) = + c1_d_xfield[j] * ( *Bx_pml )( i, j, k )
-                                             - c2_d_xfield[j]/dy * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i, j-1, k ) )
-                                             + c2_d_xfield[j]/dz * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i, j, k-1 ) );
-                    ( *Hx_pml )( i, j, k ) = + c3_d_xfield[k] * ( *Hx_pml )( i, j, k )
-                                             + c4_d_xfield[k] * (c5_p_xfield[i]*( *Bx_pml )( i, j, k ) - c6_p_xfield[i]*Bx_pml_old ) ;
-                }
-            }
-        }
-        //Magnetic field By^(d,p,d) Remind that in PML, there no current
-        for( unsigned int i=1 ; i<nx_d-1 ; i++ ) {
-            for( unsigned int j=0 ; j<ny_p ; j++ ) {
-                for( unsigned int k=solvermin ; k<(unsigned int)solvermax ; k++ ) {
-                    // Standard FDTD
-                    // ( *By_pml )( i, j, k ) = + 1 * ( *By_pml )( i, j, k )
-                    //                          + dt/dx * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i-1, j, k ) )
-                    //                          - dt/dz * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j, k-1 ) );
-                    // ( *Hy_pml )( i, j, k ) = + 1 * ( *By_pml )( i, j, k );
-                    // PML FDTD
-                    By_pml_old = 1*( *By_pml )( i, j, k ) ;
-                    ( *By_pml )( i, j, k ) = + c1_d_yfield[k] * ( *By_pml )( i, j, k )
-                                             + c2_d_yfield[k]/dx * ( ( *Ez_pml )( i, j, k ) - ( *Ez_pml )( i-1, j, k ) )
-                                             - c2_d_yfield[k]/dz * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j, k-1 ) );
-                    ( *Hy_pml )( i, j, k ) = + c3_d_yfield[i] * ( *Hy_pml )( i, j, k )
-                                             + c4_d_yfield[i] * (c5_p_yfield[j]*( *By_pml )( i, j, k ) - c6_p_yfield[j]*By_pml_old ) ;
-                }
-            }
-        }
-        //Magnetic field Bz^(d,d,p) Remind that in PML, there no current
-        for( unsigned int i=1 ; i<nx_d-1 ; i++ ) {
-            for( unsigned int j=1 ; j<ny_d-1 ; j++ ) {
-                for( unsigned int k=solvermin ; k<(unsigned int)solvermax ; k++ ) {
-                    // Standard FDTD
-                    // ( *Bz_pml )( i, j, k ) = + 1 * ( *Bz_pml )( i, j, k )
-                    //                          + dt/dy * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j-1, k ) )
-                    //                          - dt/dx * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i-1, j, k ) );
-                    // ( *Hz_pml )( i, j, k ) = + 1 * ( *Bz_pml )( i, j, k );
-                    // PML FDTD
-                    Bz_pml_old = 1*( *Bz_pml )( i, j, k ) ;
-                    ( *Bz_pml )( i, j, k ) = + c1_d_zfield[i] * ( *Bz_pml )( i, j, k )
-                                             + c2_d_zfield[i]/dy * ( ( *Ex_pml )( i, j, k ) - ( *Ex_pml )( i, j-1, k ) )
-                                             - c2_d_zfield[i]/dx * ( ( *Ey_pml )( i, j, k ) - ( *Ey_pml )( i-1, j, k ) );
-                    ( *Hz_pml )( i, j, k ) = + c3_d_zfield[j] * ( *Hz_pml )( i, j, k )
-                                             + c4_d_zfield[j] * (c5_p_zfield[k]*( *Bz_pml )( i, j, k ) - c6_p_zfield[k]*Bz_pml_old );
+    //Magnetic field Bz^(d,d,p) Remind that in PML, there no current
+    pmlBounds( lo, hi, 1, nx_d-1, 1, ny_d-1, 0, nz_p, iDim, solvermin, solvermax );
+    {
+        const double *const __restrict__ c5 = &c5_p_zfield[0];
+        const double *const __restrict__ c6 = &c6_p_zfield[0];
+        for( unsigned int i=lo[0] ; i<hi[0] ; i++ ) {
+            const double c1  = c1_d_zfield[i];
+            const double c2y = c2_d_zfield[i]/dy;
+            const double c2x = c2_d_zfield[i]/dx;
+            for( unsigned int j=lo[1] ; j<hi[1] ; j++ ) {
+                const double c3 = c3_d_zfield[j];
+                const double c4 = c4_d_zfield[j];
+                const unsigned int iz  = pmlRow( Bz_pml, i, j );
+                const unsigned int ix0 = pmlRow( Ex_pml, i, j-1 );
+                const unsigned int ix1 = pmlRow( Ex_pml, i, j );
+                const unsigned int iy0 = pmlRow( Ey_pml, i-1, j );
+                const unsigned int iy1 = pmlRow( Ey_pml, i, j );
+                #pragma omp simd
+                for( unsigned int k=lo[2] ; k<hi[2] ; k++ ) {
+                    const double B_old = Bz[iz+k];
+                    const double B_new = + c1 * B_old
+                                         + c2y * ( Ex[ix1+k] - Ex[ix0+k] )
+                                         - c2x * ( Ey[iy1+k] - Ey[iy0+k] );
+                    Bz[iz+k] = B_new;
+                    Hz[iz+k] = + c3 * Hz[iz+k]
+                               + c4 * ( c5[k]*B_new - c6[k]*B_old );
                 }
             }
         }
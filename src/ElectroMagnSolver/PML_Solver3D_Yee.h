@@ -103,12 +103,6 @@ protected:
 
     bool isMin ;
     bool isMax ;
-    double Dx_pml_old ;
-    double Dy_pml_old ;
-    double Dz_pml_old ;
-    double Bx_pml_old ;
-    double By_pml_old ;
-    double Bz_pml_old ;
     
 };//END class
 
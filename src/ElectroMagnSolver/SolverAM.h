@@ -1,6 +1,8 @@
 #ifndef SOLVERAM_H
 #define SOLVERAM_H
 
+#include <vector>
+
 #include "Solver.h"
 
 //  --------------------------------------------------------------------------------------------------------------------
@@ -19,6 +21,7 @@ public:
         dr = params.cell_length[1];
         dt_ov_dl = params.timestep / params.cell_length[0];
         dt_ov_dr = params.timestep / params.cell_length[1];
+        invR_j_glob_ = 0;
         
     };
     virtual ~SolverAM() {};
@@ -34,6 +37,27 @@ protected:
     double dt_ov_dl;
     double dt_ov_dr;
     
+    //! 1/r on the primal (invR_) and dual (invRd_) radial grids of the patch whose first cell is j_glob,
+    //! tabulated once for the solvers updating all the modes line by line
+    std::vector<double> invR_, invRd_;
+    int invR_j_glob_;
+    void tabulateInvR( int j_glob, unsigned int nr_p, unsigned int nr_d )
+    {
+        if( invR_.size() == nr_p && invRd_.size() == nr_d && invR_j_glob_ == j_glob ) {
+            return;
+        }
+        invR_j_glob_ = j_glob;
+        invR_.resize( nr_p );
+        invRd_.resize( nr_d );
+        for( unsigned int j=0 ; j<nr_p ; j++ ) {
+            // r=0 is not used, the conditions on axis being applied apart
+            invR_[j] = j_glob+( int )j != 0 ? 1./( ( double )( j_glob+( int )j )*dr ) : 0.;
+        }
+        for( unsigned int j=0 ; j<nr_d ; j++ ) {
+            invRd_[j] = 1./( ( ( double )( j_glob+( int )j )-0.5 )*dr );
+        }
+    }
+    
 };//END class
 
 #endif
@@ -7,6 +7,7 @@
 #include "MA_Solver2D_Friedman.h"
 #include "MA_Solver3D_norm.h"
 #include "MA_Solver3D_Friedman.h"
+#include "MA_MF_Solver3D_Yee.h"
 #include "MA_SolverAM_norm.h"
 #include "MA_SolverAM_Friedman.h"
 #include "MF_Solver1D_Yee.h"
@@ -49,6 +50,14 @@ class SolverFactory
 {
 public:
 
+    // Maxwell-Ampere and Maxwell-Faraday fused in a single solver (3D Yee on CPU)
+    // ---------------------------------------------------------------------------
+    static bool fusedYee3D( Params &params )
+    {
+        return params.geometry == "3Dcartesian" && params.maxwell_sol == "Yee"
+               && !params.is_pxr && !params.is_spectral && !params.Friedman_filter && !params.gpu_computing;
+    }
+
     // create Maxwell-Ampere solver
     // -----------------------------
     static Solver *createMA( Params &params )
@@ -92,6 +101,8 @@ public:
                     if( params.Friedman_filter ) {
                       if (params.maxwell_sol != "Yee") ERROR( "Only Yee Maxwell solver is compatible with Friedman filter in 3Dcartesian geometry" );
                       solver = new MA_Solver3D_Friedman( params );
+                    } else if( fusedYee3D( params ) ) {
+                      solver = new MA_MF_Solver3D_Yee( params );
                     } else {
                       solver = new MA_Solver3D_norm( params );
                     }
@@ -160,7 +171,10 @@ public:
 
         } else if( params.geometry == "3Dcartesian" ) {
 
-            if( params.maxwell_sol == "Yee" ) {
+            if( fusedYee3D( params ) ) {
+                // Faraday is done by MA_MF_Solver3D_Yee
+                solver = new NullSolver();
+            } else if( params.maxwell_sol == "Yee" ) {
                 solver = new MF_Solver3D_Yee( params );
             } else if( params.maxwell_sol == "Lehe" ) {
                 solver = new MF_Solver3D_Lehe( params );
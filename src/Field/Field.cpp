@@ -1,6 +1,48 @@
 #include "Field.h"
 #include "gpu.h"
 
+bool Field::recycling_ = false;
+std::multimap<unsigned int, double *> Field::recycled_data_;
+
+double *Field::newData( unsigned int size )
+{
+    double *data = NULL;
+    if( recycling_ ) {
+        #pragma omp critical( recycled_field_data )
+        {
+            auto it = recycled_data_.find( size );
+            if( it != recycled_data_.end() ) {
+                data = it->second;
+                recycled_data_.erase( it );
+            }
+        }
+    }
+    if( data == NULL ) {
+        data = new double[size];
+    }
+    return data;
+}
+
+void Field::recycleData( double *data, unsigned int size )
+{
+    if( data == NULL ) {
+        return;
+    }
+    #pragma omp critical( recycled_field_data )
+    recycled_data_.insert( std::make_pair( size, data ) );
+}
+
+void Field::clearRecycledData()
+{
+    #pragma omp critical( recycled_field_data )
+    {
+        for( auto &it : recycled_data_ ) {
+            delete [] it.second;
+        }
+        recycled_data_.clear();
+    }
+}
+
 void Field::put_to( double val )
 {
     SMILEI_ASSERT( data_ != nullptr );
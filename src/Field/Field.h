@@ -3,6 +3,7 @@
 
 #include <cmath>
 
+#include <map>
 #include <vector>
 #include <cstdlib>
 #include <string>
@@ -82,6 +83,31 @@ public:
     //! Virtual method to deallocate Field
     virtual void deallocateDataAndSetTo( Field* f ) = 0;
 
+    //! Free the data, back to the dimensions before allocateDims, so that it can be allocated again
+    virtual void deallocateData()
+    {
+        ERROR( "Field " << name << " cannot be deallocated" );
+    }
+
+    //! Copy the data in a new array, allocated and first touched by the calling thread,
+    //! so that its memory is placed on the NUMA domain of this thread
+    virtual void relocateData()
+    {
+        if( data_ == NULL ) {
+            return;
+        }
+        Field *relocated = clone();
+        deallocateDataAndSetTo( relocated );
+        relocated->data_ = NULL;
+        delete relocated;
+    }
+
+    //! Copy the data in buffer (number_of_points_ values), which then holds it (Main.fields_arena)
+    virtual void moveDataTo( double * )
+    {
+        ERROR( "Field " << name << " cannot be moved to the arena of the fields" );
+    }
+
     //! Virtual method to shift field in space
     virtual void shift_x( unsigned int delta ) = 0;
 
@@ -111,6 +137,36 @@ public:
     unsigned int number_of_points_;
     //! pointer to the linearized array
     double *data_;
+    //! True if data_ is held by the arena of the fields of the patches (Main.fields_arena), not by this field
+    bool arena_data_ = false;
+
+    //! True if data_ goes to the pool of recycled arrays when freed (MovingWindow.recycle_patches)
+    bool recycle_data_ = false;
+
+    //! Free data_, unless it is held by the arena
+    inline void freeData()
+    {
+        if( recycle_data_ && ! arena_data_ ) {
+            recycleData( data_, number_of_points_ );
+        } else if( ! arena_data_ ) {
+            delete [] data_;
+        }
+        data_ = NULL;
+        arena_data_ = false;
+        recycle_data_ = false;
+    }
+
+    //! Allocate an array of size values, taken from the pool of recycled arrays if it holds one of this size
+    static double *newData( unsigned int size );
+
+    //! Give an array of size values to the pool of recycled arrays
+    static void recycleData( double *data, unsigned int size );
+
+    //! Free the arrays left in the pool of recycled arrays
+    static void clearRecycledData();
+
+    //! True if the fields are allocated from the pool of recycled arrays (MovingWindow.recycle_patches)
+    static bool recycling_;
 
     //! Return the size of the linearized array
     inline unsigned int __attribute__((always_inline)) size() {
@@ -225,6 +281,17 @@ public:
         return sum;
     }
 
+    //! True if all the values are zero (stops at the first non zero value)
+    inline bool isZero()
+    {
+        for( unsigned int i=0; i<number_of_points_; i++ ) {
+            if( data_[i] != 0. ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     inline long double __attribute__((always_inline)) norm()
     {
         long double sum( 0. );
@@ -304,6 +371,8 @@ public:
 protected:
 
 private:
+    //! Arrays of the fields of the patches left by the moving window, by size, reused by the new patches
+    static std::multimap<unsigned int, double *> recycled_data_;
 
 };
 
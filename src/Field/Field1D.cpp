@@ -78,7 +78,7 @@ Field1D::~Field1D()
         }
     }
     if( data_!=NULL ) {
-        delete [] data_;
+        freeData();
     }
 }
 
@@ -95,7 +95,7 @@ void Field1D::allocateDims()
     
     isDual_.resize( dims_.size(), 0 );
     
-    data_ = new double[ dims_[0] ];
+    data_ = newData( dims_[0] );
     //! \todo{change to memset (JD)}
     for( unsigned int i=0; i<dims_[0]; i++ ) {
         data_[i]=0.0;
@@ -107,10 +107,35 @@ void Field1D::allocateDims()
 
 void Field1D::deallocateDataAndSetTo( Field* f )
 {
-    delete [] data_;
+    freeData();
     data_=NULL;
 
     data_ = f->data_;
+    arena_data_ = f->arena_data_;
+}
+
+
+void Field1D::moveDataTo( double *buffer )
+{
+    memcpy( buffer, data_, number_of_points_*sizeof( double ) );
+    freeData();
+    data_ = buffer;
+    arena_data_ = true;
+}
+
+void Field1D::deallocateData()
+{
+    if( data_ == NULL ) {
+        return;
+    }
+    freeData();
+    data_ = NULL;
+
+    for( unsigned int j=0 ; j<isDual_.size() ; j++ ) {
+        dims_[j] -= isDual_[j];
+    }
+    isDual_.clear();
+    number_of_points_ = dims_[0];
 }
 
 
@@ -147,7 +172,7 @@ void Field1D::allocateDims( unsigned int mainDim, bool isPrimal )
         dims_[j] += isDual_[j];
     }
     
-    data_ = new double[ dims_[0] ];
+    data_ = newData( dims_[0] );
     //! \todo{change to memset (JD)}
     for( unsigned int i=0; i<dims_[0]; i++ ) {
         data_[i]=0.0;
@@ -90,7 +90,7 @@ Field2D::~Field2D()
         }
     }
     if( data_!=NULL ) {
-        delete [] data_;
+        freeData();
         delete [] data_2D;
     }
 }
@@ -105,12 +105,12 @@ void Field2D::allocateDims()
         ERROR( "Alloc error must be 2 : " << dims_.size() );
     }
     if( data_!=NULL ) {
-        delete [] data_;
+        freeData();
     }
     
     isDual_.resize( dims_.size(), 0 );
     
-    data_ = new double[dims_[0]*dims_[1]];
+    data_ = newData( dims_[0]*dims_[1] );
     //! \todo{check row major order!!! (JD)}
     
     data_2D = new double *[dims_[0]];
@@ -127,16 +127,45 @@ void Field2D::allocateDims()
 
 void Field2D::deallocateDataAndSetTo( Field* f )
 {
-    delete [] data_;
+    freeData();
     data_ = NULL;
     delete [] data_2D;
     data_2D = NULL;
 
     data_   = f->data_;
+    arena_data_ = f->arena_data_;
     data_2D = (static_cast<Field2D *>(f))->data_2D;
     
 }
 
+void Field2D::moveDataTo( double *buffer )
+{
+    memcpy( buffer, data_, number_of_points_*sizeof( double ) );
+    freeData();
+    data_ = buffer;
+    arena_data_ = true;
+    for( unsigned int i = 0; i < dims_[0]; i++ ) {
+        data_2D[i] = data_ + i * dims_[1];
+    }
+}
+
+void Field2D::deallocateData()
+{
+    if( data_ == NULL ) {
+        return;
+    }
+    freeData();
+    data_ = NULL;
+    delete [] data_2D;
+    data_2D = NULL;
+
+    for( unsigned int j=0 ; j<isDual_.size() ; j++ ) {
+        dims_[j] -= isDual_[j];
+    }
+    isDual_.clear();
+    number_of_points_ = dims_[0]*dims_[1];
+}
+
 void Field2D::allocateDims( unsigned int dims1, unsigned int dims2 )
 {
     std::vector<unsigned int> dims( 2 );
@@ -154,7 +183,7 @@ void Field2D::allocateDims( unsigned int mainDim, bool isPrimal )
         ERROR( "Alloc error must be 2 : " << dims_.size() );
     }
     if( data_ ) {
-        delete [] data_;
+        freeData();
     }
     
     // isPrimal define if mainDim is Primal or Dual
@@ -171,7 +200,7 @@ void Field2D::allocateDims( unsigned int mainDim, bool isPrimal )
         dims_[j] += isDual_[j];
     }
     
-    data_ = new double[dims_[0]*dims_[1]];
+    data_ = newData( dims_[0]*dims_[1] );
     //! \todo{check row major order!!! (JD)}
 
     data_2D = new double *[dims_[0]];
@@ -269,17 +298,19 @@ void Field2D::put( Field *outField, Params &params, Patch *thisPatch, Patch *out
 {
     Field2D *out2D = static_cast<Field2D *>( outField );
     
-    std::vector<unsigned int> dual =  this->isDual_;
+    const std::vector<unsigned int> &dual =  this->isDual_;
     
     int iout = thisPatch->Pcoordinates[0]*params.patch_size_[0] - ( outPatch->getCellStartingGlobalIndex(0) + params.region_oversize[0] ) ;
     int jout = thisPatch->Pcoordinates[1]*params.patch_size_[1] - ( outPatch->getCellStartingGlobalIndex(1) + params.region_oversize[1] ) ;
     
-    //for ( unsigned int i = params.oversize[0] ; i < this->dims_[0]-params.oversize[0] ; i++ ) {
-    //    for ( unsigned int j = params.oversize[1] ; j < this->dims_[1]-params.oversize[1] ; j++ ) {
-    for( unsigned int i = 0 ; i < params.patch_size_[0]+1+dual[0]+2*params.oversize[0] ; i++ ) {
-        for( unsigned int j = 0 ; j < params.patch_size_[1]+1+dual[1]+2*params.oversize[1] ; j++ ) {
-            ( *out2D )( iout+i+params.region_oversize[0]-params.oversize[0], jout+j+params.region_oversize[1]-params.oversize[1] ) = ( *this )( i, j );
-        }
+    const unsigned int ni = params.patch_size_[0]+1+dual[0]+2*params.oversize[0];
+    const unsigned int nj = params.patch_size_[1]+1+dual[1]+2*params.oversize[1];
+    iout += params.region_oversize[0]-params.oversize[0];
+    jout += params.region_oversize[1]-params.oversize[1];
+    
+    // Rows are contiguous in both the patch and the region
+    for( unsigned int i = 0 ; i < ni ; i++ ) {
+        memcpy( &( out2D->data_2D[iout+i][jout] ), data_2D[i], nj*sizeof( double ) );
     }
     
 }
@@ -289,16 +320,22 @@ void Field2D::add( Field *outField, Params &params, Patch *thisPatch, Patch *out
 {
     Field2D *out2D = static_cast<Field2D *>( outField );
     
-    std::vector<unsigned int> dual =  this->isDual_;
+    const std::vector<unsigned int> &dual =  this->isDual_;
     
     int iout = thisPatch->Pcoordinates[0]*params.patch_size_[0] - ( outPatch->getCellStartingGlobalIndex(0) + params.region_oversize[0] ) ;
     int jout = thisPatch->Pcoordinates[1]*params.patch_size_[1] - ( outPatch->getCellStartingGlobalIndex(1) + params.region_oversize[1] ) ;
     
-    //for ( unsigned int i = params.oversize[0] ; i < this->dims_[0]-params.oversize[0] ; i++ ) {
-    //    for ( unsigned int j = params.oversize[1] ; j < this->dims_[1]-params.oversize[1] ; j++ ) {
-    for( unsigned int i = 0 ; i < params.patch_size_[0]+1+dual[0]+2*params.oversize[0] ; i++ ) {
-        for( unsigned int j = 0 ; j < params.patch_size_[1]+1+dual[1]+2*params.oversize[1] ; j++ ) {
-            ( *out2D )( iout+i+params.region_oversize[0]-params.oversize[0], jout+j+params.region_oversize[1]-params.oversize[1] ) += ( *this )( i, j );
+    const unsigned int ni = params.patch_size_[0]+1+dual[0]+2*params.oversize[0];
+    const unsigned int nj = params.patch_size_[1]+1+dual[1]+2*params.oversize[1];
+    iout += params.region_oversize[0]-params.oversize[0];
+    jout += params.region_oversize[1]-params.oversize[1];
+    
+    for( unsigned int i = 0 ; i < ni ; i++ ) {
+        double *__restrict__ out_row = &( out2D->data_2D[iout+i][jout] );
+        const double *__restrict__ in_row = data_2D[i];
+        #pragma omp simd
+        for( unsigned int j = 0 ; j < nj ; j++ ) {
+            out_row[j] += in_row[j];
         }
     }
     
@@ -308,18 +345,18 @@ void Field2D::get( Field *inField, Params &params, Patch *inPatch, Patch *thisPa
 {
     Field2D *in2D  = static_cast<Field2D *>( inField );
     
-    std::vector<unsigned int> dual =  in2D->isDual_;
+    const std::vector<unsigned int> &dual =  in2D->isDual_;
     
     int iin = thisPatch->Pcoordinates[0]*params.patch_size_[0] - ( inPatch->getCellStartingGlobalIndex(0) + params.region_oversize[0] );
     int jin = thisPatch->Pcoordinates[1]*params.patch_size_[1] - ( inPatch->getCellStartingGlobalIndex(1) + params.region_oversize[1] );
     
-    //for ( unsigned int i = params.oversize[0] ; i < out2D->dims_[0]-params.oversize[0] ; i++ ) {
-    //    for ( unsigned int j = params.oversize[1] ; j < out2D->dims_[1]-params.oversize[1] ; j++ ) {
-    for( unsigned int i = 0 ; i < params.patch_size_[0]+1+dual[0]+2*params.oversize[0] ; i++ ) {
-        for( unsigned int j = 0 ; j < params.patch_size_[1]+1+dual[1]+2*params.oversize[1] ; j++ ) {
-            ( *this )( i, j ) = ( *in2D )( iin+i+params.region_oversize[0]-params.oversize[0], jin+j+params.region_oversize[1]-params.oversize[1] );
-            //( *out2D )( i, j ) = in2D->hindex;
-        }
+    const unsigned int ni = params.patch_size_[0]+1+dual[0]+2*params.oversize[0];
+    const unsigned int nj = params.patch_size_[1]+1+dual[1]+2*params.oversize[1];
+    iin += params.region_oversize[0]-params.oversize[0];
+    jin += params.region_oversize[1]-params.oversize[1];
+    
+    for( unsigned int i = 0 ; i < ni ; i++ ) {
+        memcpy( data_2D[i], &( in2D->data_2D[iin+i][jin] ), nj*sizeof( double ) );
     }
     
 }
@@ -38,6 +38,8 @@ public:
     //! Method used to allocate a Field2D
     void allocateDims() override;
     void deallocateDataAndSetTo( Field* f ) override;
+    void deallocateData() override;
+    void moveDataTo( double *buffer ) override;
     //! a Field2D can also be initialized win two unsigned int
     void allocateDims( unsigned int dims1, unsigned int dims2 );
     //! allocate dimensions for field2D isPrimal define if mainDim is Primal or Dual
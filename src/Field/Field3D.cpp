@@ -105,7 +105,7 @@ Field3D::~Field3D()
 #if defined(SMILEI_ACCELERATOR_GPU_OACC)
         #pragma acc exit data delete (data_[0:number_of_points_]) if (acc_deviceptr(data_) != NULL)
 #endif
-        delete [] data_;
+        freeData();
         for( unsigned int i=0; i<dims_[0]; i++ ) {
             delete [] this->data_3D[i];
         }
@@ -123,12 +123,12 @@ void Field3D::allocateDims()
         ERROR( "Alloc error must be 3 : " << dims_.size() );
     }
     if( data_ ) {
-        delete [] data_;
+        freeData();
     }
     
     isDual_.resize( dims_.size(), 0 );
     
-    data_ = new double[dims_[0]*dims_[1]*dims_[2]];
+    data_ = newData( dims_[0]*dims_[1]*dims_[2] );
     //! \todo{check row major order!!!}
     data_3D= new double **[dims_[0]];
     for( unsigned int i=0; i<dims_[0]; i++ ) {
@@ -147,7 +147,7 @@ void Field3D::allocateDims()
 
 void Field3D::deallocateDataAndSetTo( Field* f )
 {
-    delete [] data_;
+    freeData();
     data_ = NULL;
     for( unsigned int i=0; i<dims_[0]; i++ ) {
         delete [] data_3D[i];
@@ -156,11 +156,46 @@ void Field3D::deallocateDataAndSetTo( Field* f )
     data_3D = NULL;
 
     data_   = f->data_;
+    arena_data_ = f->arena_data_;
     data_3D = (static_cast<Field3D *>(f))->data_3D;
     
 }
 
 
+void Field3D::moveDataTo( double *buffer )
+{
+    memcpy( buffer, data_, number_of_points_*sizeof( double ) );
+    freeData();
+    data_ = buffer;
+    arena_data_ = true;
+    for( unsigned int i=0; i<dims_[0]; i++ ) {
+        for( unsigned int j=0; j<dims_[1]; j++ ) {
+            data_3D[i][j] = data_ + i*dims_[1]*dims_[2] + j*dims_[2];
+        }
+    }
+}
+
+void Field3D::deallocateData()
+{
+    if( data_ == NULL ) {
+        return;
+    }
+    freeData();
+    data_ = NULL;
+    for( unsigned int i=0; i<dims_[0]; i++ ) {
+        delete [] data_3D[i];
+    }
+    delete [] data_3D;
+    data_3D = NULL;
+
+    for( unsigned int j=0 ; j<isDual_.size() ; j++ ) {
+        dims_[j] -= isDual_[j];
+    }
+    isDual_.clear();
+    number_of_points_ = dims_[0]*dims_[1]*dims_[2];
+}
+
+
 void Field3D::allocateDims( unsigned int dims1, unsigned int dims2, unsigned int dims3 )
 {
     vector<unsigned int> dims( 3 );
@@ -180,7 +215,7 @@ void Field3D::allocateDims( unsigned int mainDim, bool isPrimal )
         ERROR( "Alloc error must be 3 : " << dims_.size() );
     }
     if( data_ ) {
-        delete [] data_;
+        freeData();
     }
     
     // isPrimal define if mainDim is Primal or Dual
@@ -197,7 +232,7 @@ void Field3D::allocateDims( unsigned int mainDim, bool isPrimal )
         dims_[j] += isDual_[j];
     }
     
-    data_ = new double[dims_[0]*dims_[1]*dims_[2]];
+    data_ = newData( dims_[0]*dims_[1]*dims_[2] );
     //! \todo{check row major order!!!}
     data_3D= new double **[dims_[0]*dims_[1]];
     for( unsigned int i=0; i<dims_[0]; i++ ) {
@@ -341,17 +376,23 @@ void Field3D::put( Field *outField, Params &params, Patch *thisPatch, Patch *out
 {
     Field3D *out3D = static_cast<Field3D *>( outField );
     
-    std::vector<unsigned int> dual =  this->isDual_;
+    const std::vector<unsigned int> &dual =  this->isDual_;
     
     int iout = thisPatch->Pcoordinates[0]*params.patch_size_[0] - ( outPatch->getCellStartingGlobalIndex(0) + params.region_oversize[0] ) ;
     int jout = thisPatch->Pcoordinates[1]*params.patch_size_[1] - ( outPatch->getCellStartingGlobalIndex(1) + params.region_oversize[1] ) ;
     int kout = thisPatch->Pcoordinates[2]*params.patch_size_[2] - ( outPatch->getCellStartingGlobalIndex(2) + params.region_oversize[2] ) ;    
     
-    for( unsigned int i = 0 ; i < params.patch_size_[0]+1+dual[0]+2*params.oversize[0] ; i++ ) {
-        for( unsigned int j = 0 ; j < params.patch_size_[1]+1+dual[1]+2*params.oversize[1] ; j++ ) {
-            for( unsigned int k = 0 ; k < params.patch_size_[2]+1+dual[2]+2*params.oversize[2] ; k++ ) {
-                ( *out3D )( iout+i+params.region_oversize[0]-params.oversize[0], jout+j+params.region_oversize[1]-params.oversize[1], kout+k+params.region_oversize[2]-params.oversize[2] ) = ( *this )( i, j, k );
-            }
+    const unsigned int ni = params.patch_size_[0]+1+dual[0]+2*params.oversize[0];
+    const unsigned int nj = params.patch_size_[1]+1+dual[1]+2*params.oversize[1];
+    const unsigned int nk = params.patch_size_[2]+1+dual[2]+2*params.oversize[2];
+    iout += params.region_oversize[0]-params.oversize[0];
+    jout += params.region_oversize[1]-params.oversize[1];
+    kout += params.region_oversize[2]-params.oversize[2];
+    
+    // Lines along z are contiguous in both the patch and the region
+    for( unsigned int i = 0 ; i < ni ; i++ ) {
+        for( unsigned int j = 0 ; j < nj ; j++ ) {
+            memcpy( &( out3D->data_3D[iout+i][jout+j][kout] ), data_3D[i][j], nk*sizeof( double ) );
         }
     }
     
@@ -362,16 +403,26 @@ void Field3D::add( Field *outField, Params &params, Patch *thisPatch, Patch *out
 {
     Field3D *out3D = static_cast<Field3D *>( outField );
     
-    std::vector<unsigned int> dual =  this->isDual_;
+    const std::vector<unsigned int> &dual =  this->isDual_;
     
     int iout = thisPatch->Pcoordinates[0]*params.patch_size_[0] - ( outPatch->getCellStartingGlobalIndex(0) + params.region_oversize[0] ) ;
     int jout = thisPatch->Pcoordinates[1]*params.patch_size_[1] - ( outPatch->getCellStartingGlobalIndex(1) + params.region_oversize[1] ) ;
     int kout = thisPatch->Pcoordinates[2]*params.patch_size_[2] - ( outPatch->getCellStartingGlobalIndex(2) + params.region_oversize[2] ) ;
     
-    for( unsigned int i = 0 ; i < params.patch_size_[0]+1+dual[0]+2*params.oversize[0] ; i++ ) {
-        for( unsigned int j = 0 ; j < params.patch_size_[1]+1+dual[1]+2*params.oversize[1] ; j++ ) {
-            for( unsigned int k = 0 ; k < params.patch_size_[2]+1+dual[2]+2*params.oversize[2] ; k++ ) {
-                ( *out3D )( iout+i+params.region_oversize[0]-params.oversize[0], jout+j+params.region_oversize[1]-params.oversize[1], kout+k+params.region_oversize[2]-params.oversize[2] ) += ( *this )( i, j, k );
+    const unsigned int ni = params.patch_size_[0]+1+dual[0]+2*params.oversize[0];
+    const unsigned int nj = params.patch_size_[1]+1+dual[1]+2*params.oversize[1];
+    const unsigned int nk = params.patch_size_[2]+1+dual[2]+2*params.oversize[2];
+    iout += params.region_oversize[0]-params.oversize[0];
+    jout += params.region_oversize[1]-params.oversize[1];
+    kout += params.region_oversize[2]-params.oversize[2];
+    
+    for( unsigned int i = 0 ; i < ni ; i++ ) {
+        for( unsigned int j = 0 ; j < nj ; j++ ) {
+            double *__restrict__ out_line = &( out3D->data_3D[iout+i][jout+j][kout] );
+            const double *__restrict__ in_line = data_3D[i][j];
+            #pragma omp simd
+            for( unsigned int k = 0 ; k < nk ; k++ ) {
+                out_line[k] += in_line[k];
             }
         }
     }
@@ -382,17 +433,22 @@ void Field3D::get( Field *inField, Params &params, Patch *inPatch, Patch *thisPa
 {
     Field3D *in3D  = static_cast<Field3D *>( inField );
     
-    std::vector<unsigned int> dual =  in3D->isDual_;
+    const std::vector<unsigned int> &dual =  in3D->isDual_;
     
     int iin = thisPatch->Pcoordinates[0]*params.patch_size_[0] - ( inPatch->getCellStartingGlobalIndex(0) + params.region_oversize[0] );
     int jin = thisPatch->Pcoordinates[1]*params.patch_size_[1] - ( inPatch->getCellStartingGlobalIndex(1) + params.region_oversize[1] );
     int kin = thisPatch->Pcoordinates[2]*params.patch_size_[2] - ( inPatch->getCellStartingGlobalIndex(2) + params.region_oversize[2] );
     
-    for( unsigned int i = 0 ; i < params.patch_size_[0]+1+dual[0]+2*params.oversize[0] ; i++ ) {
-        for( unsigned int j = 0 ; j < params.patch_size_[1]+1+dual[1]+2*params.oversize[1] ; j++ ) {
-            for( unsigned int k = 0 ; k < params.patch_size_[2]+1+dual[2]+2*params.oversize[2] ; k++ ) {
-                ( *this )( i, j, k ) = ( *in3D )( iin+i+params.region_oversize[0]-params.oversize[0], jin+j+params.region_oversize[1]-params.oversize[1], kin+k+params.region_oversize[2]-params.oversize[2] );
-            }
+    const unsigned int ni = params.patch_size_[0]+1+dual[0]+2*params.oversize[0];
+    const unsigned int nj = params.patch_size_[1]+1+dual[1]+2*params.oversize[1];
+    const unsigned int nk = params.patch_size_[2]+1+dual[2]+2*params.oversize[2];
+    iin += params.region_oversize[0]-params.oversize[0];
+    jin += params.region_oversize[1]-params.oversize[1];
+    kin += params.region_oversize[2]-params.oversize[2];
+    
+    for( unsigned int i = 0 ; i < ni ; i++ ) {
+        for( unsigned int j = 0 ; j < nj ; j++ ) {
+            memcpy( data_3D[i][j], &( in3D->data_3D[iin+i][jin+j][kin] ), nk*sizeof( double ) );
         }
     }
     
@@ -98,6 +98,18 @@ public:
     
     std::complex<double> *cdata_;
 
+    //! Copy the data in a new array, allocated and first touched by the calling thread
+    void relocateData() override
+    {
+        if( cdata_ == NULL ) {
+            return;
+        }
+        cField *relocated = static_cast<cField *>( clone() );
+        deallocateDataAndSetTo( relocated );
+        relocated->cdata_ = NULL;
+        delete relocated;
+    }
+
     void copyFrom( Field *from_field ) override
     {
         DEBUGEXEC( if( number_of_points_!=from_field->number_of_points_ ) ERROR( "Field size do not match "<< name << " " << from_field->name ) );
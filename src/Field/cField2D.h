@@ -35,6 +35,12 @@ public:
     //! Method used to allocate a cField2D
     void allocateDims() override;
     void deallocateDataAndSetTo( Field* f ) override;
+    //! The relocated data is owned by this field, unlike after deallocateDataAndSetTo
+    void relocateData() override
+    {
+        cField::relocateData();
+        cleaned_ = false;
+    }
     //! a cField2D can also be initialized win two unsigned int
     void allocateDims( unsigned int dims1, unsigned int dims2 );
     //! allocate dimensions for field2D isPrimal define if mainDim is Primal or Dual
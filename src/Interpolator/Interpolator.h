@@ -10,6 +10,29 @@ class ElectroMagn;
 class Particles;
 
 
+//  --------------------------------------------------------------------------------------------------------------------
+//! Interpolation stencils of fixed points (probes), computed once and reused at each output.
+//! For each dimension, the central node on the primal and dual grids, and the coefficients of the nodes around it.
+//  --------------------------------------------------------------------------------------------------------------------
+struct InterpolationStencils
+{
+    //! Number of points of the stencils (0 if they must be computed)
+    unsigned int npoints = 0;
+    //! Central nodes: idx[idim*npoints+ipoint]
+    std::vector<int> idx_p, idx_d;
+    //! Coefficients: coeff[(idim*number_of_nodes+inode)*npoints+ipoint]
+    std::vector<double> coeff_p, coeff_d;
+    
+    void clear()
+    {
+        npoints = 0;
+        idx_p.clear();
+        idx_d.clear();
+        coeff_p.clear();
+        coeff_d.clear();
+    }
+};
+
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class Interpolator
 //  --------------------------------------------------------------------------------------------------------------------
@@ -24,6 +47,13 @@ public:
     virtual void fieldsSelection( ElectroMagn *EMfields, Particles &particles, double *buffer, int offset, std::vector<unsigned int> *selection ) = 0;
     virtual void oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *l1=NULL, double *l2=NULL, double *l3=NULL ) =0;
     
+    //! Interpolation of Ex, Ey, Ez, Bx, By, Bz, Jx, Jy, Jz and Rho at fixed points, in the 10 arrays `loc`,
+    //! with stencils cached in `stencils`. Returns false if not available (the points are then interpolated one by one)
+    virtual bool fieldsAndCurrentsAtPoints( ElectroMagn *, Particles &, InterpolationStencils &, double ** )
+    {
+        return false;
+    };
+    
     virtual void fieldsAndEnvelope( ElectroMagn *, Particles &, SmileiMPI *, int *, int *, int , int = 0 )
     {
         ERROR( "Envelope not implemented with this geometry and this order" );
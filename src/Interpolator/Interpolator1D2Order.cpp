@@ -144,6 +144,50 @@ void Interpolator1D2Order::fieldsAndCurrents( ElectroMagn *EMfields, Particles &
     }
 }
 
+// Interpolation of all fields and currents at fixed points, with stencils computed once
+bool Interpolator1D2Order::fieldsAndCurrentsAtPoints( ElectroMagn *EMfields, Particles &particles, InterpolationStencils &stencils, double **loc )
+{
+    const int npoints = particles.numberOfParticles();
+    
+    // Stencils computed at the first call after the points are created
+    if( stencils.npoints != ( unsigned int ) npoints ) {
+        stencils.npoints = npoints;
+        stencils.idx_p.resize( npoints );
+        stencils.idx_d.resize( npoints );
+        stencils.coeff_p.resize( 3*npoints );
+        stencils.coeff_d.resize( 3*npoints );
+        int idx_p[1], idx_d[1];
+        double delta_p[1];
+        double coeffxp[3], coeffxd[3];
+        for( int ip=0; ip<npoints; ip++ ) {
+            coeffs( particles.position( 0, ip )*dx_inv_, idx_p, idx_d, coeffxp, coeffxd, delta_p );
+            stencils.idx_p[ip] = idx_p[0];
+            stencils.idx_d[ip] = idx_d[0];
+            for( int i=0; i<3; i++ ) {
+                stencils.coeff_p[i*npoints+ip] = coeffxp[i];
+                stencils.coeff_d[i*npoints+ip] = coeffxd[i];
+            }
+        }
+    }
+    
+    // Primal (p) or dual (d) grid of Ex, Ey, Ez, Bx, By, Bz, Jx, Jy, Jz, Rho
+    Field *fields[10] = { EMfields->Ex_, EMfields->Ey_, EMfields->Ez_, EMfields->Bx_m, EMfields->By_m, EMfields->Bz_m,
+                          EMfields->Jx_, EMfields->Jy_, EMfields->Jz_, EMfields->rho_ };
+    const bool dual[10] = { true, false, false, false, true, true, true, false, false, false };
+    
+    for( int ifield=0; ifield<10; ifield++ ) {
+        const double *__restrict__ f = fields[ifield]->data();
+        const int *__restrict__ idx = dual[ifield] ? &stencils.idx_d[0] : &stencils.idx_p[0];
+        const double *__restrict__ c = dual[ifield] ? &stencils.coeff_d[0] : &stencils.coeff_p[0];
+        double *__restrict__ out = loc[ifield];
+        #pragma omp simd
+        for( int ip=0; ip<npoints; ip++ ) {
+            out[ip] = c[ip] * f[idx[ip]-1] + c[npoints+ip] * f[idx[ip]] + c[2*npoints+ip] * f[idx[ip]+1];
+        }
+    }
+    return true;
+}
+
 // Interpolator on another field than the basic ones
 void Interpolator1D2Order::oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *, double *, double * )
 {
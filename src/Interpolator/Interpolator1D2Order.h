@@ -23,6 +23,7 @@ public:
     void fieldsWrapper( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, unsigned int scell = 0, int ipart_ref = 0 ) override final;
     void fieldsSelection( ElectroMagn *EMfields, Particles &particles, double *buffer, int offset, std::vector<unsigned int> *selection ) override final;
     void oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *l1=NULL, double *l2=NULL, double *l3=NULL ) override final;
+    bool fieldsAndCurrentsAtPoints( ElectroMagn *EMfields, Particles &particles, InterpolationStencils &stencils, double **loc ) override final;
 
     inline double __attribute__((always_inline)) 
     compute( double *coeff, Field1D *f, int idx )
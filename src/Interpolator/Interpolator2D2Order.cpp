@@ -131,6 +131,65 @@ void Interpolator2D2Order::fieldsAndCurrents( ElectroMagn *EMfields, Particles &
     }
 }
 
+//! Interpolation of all fields and currents at fixed points, with stencils computed once
+bool Interpolator2D2Order::fieldsAndCurrentsAtPoints( ElectroMagn *EMfields, Particles &particles, InterpolationStencils &stencils, double **loc )
+{
+    const int npoints = particles.numberOfParticles();
+    
+    // Stencils computed at the first call after the points are created
+    if( stencils.npoints != ( unsigned int ) npoints ) {
+        stencils.npoints = npoints;
+        stencils.idx_p.resize( 2*npoints );
+        stencils.idx_d.resize( 2*npoints );
+        stencils.coeff_p.resize( 6*npoints );
+        stencils.coeff_d.resize( 6*npoints );
+        int idx_p[2], idx_d[2];
+        double delta_p[2];
+        double coeffxp[3], coeffyp[3];
+        double coeffxd[3], coeffyd[3];
+        for( int ip=0; ip<npoints; ip++ ) {
+            coeffs( particles.position( 0, ip )*d_inv_[0], particles.position( 1, ip )*d_inv_[1],
+                    idx_p, idx_d, coeffxp, coeffyp, coeffxd, coeffyd, delta_p );
+            for( int idim=0; idim<2; idim++ ) {
+                stencils.idx_p[idim*npoints+ip] = idx_p[idim];
+                stencils.idx_d[idim*npoints+ip] = idx_d[idim];
+            }
+            for( int i=0; i<3; i++ ) {
+                stencils.coeff_p[i*npoints+ip]     = coeffxp[i];
+                stencils.coeff_p[( 3+i )*npoints+ip] = coeffyp[i];
+                stencils.coeff_d[i*npoints+ip]     = coeffxd[i];
+                stencils.coeff_d[( 3+i )*npoints+ip] = coeffyd[i];
+            }
+        }
+    }
+    
+    // Primal (p) or dual (d) grid of Ex, Ey, Ez, Bx, By, Bz, Jx, Jy, Jz, Rho along x and y
+    Field *fields[10] = { EMfields->Ex_, EMfields->Ey_, EMfields->Ez_, EMfields->Bx_m, EMfields->By_m, EMfields->Bz_m,
+                          EMfields->Jx_, EMfields->Jy_, EMfields->Jz_, EMfields->rho_ };
+    const bool dual[10][2] = { {true, false}, {false, true}, {false, false}, {false, true}, {true, false}, {true, true},
+                               {true, false}, {false, true}, {false, false}, {false, false} };
+    
+    for( int ifield=0; ifield<10; ifield++ ) {
+        const double *__restrict__ f = fields[ifield]->data();
+        const int ny = fields[ifield]->dims_[1];
+        const int *__restrict__ idx = dual[ifield][0] ? &stencils.idx_d[0] : &stencils.idx_p[0];
+        const int *__restrict__ idy = dual[ifield][1] ? &stencils.idx_d[npoints] : &stencils.idx_p[npoints];
+        const double *__restrict__ cx = dual[ifield][0] ? &stencils.coeff_d[0] : &stencils.coeff_p[0];
+        const double *__restrict__ cy = dual[ifield][1] ? &stencils.coeff_d[3*npoints] : &stencils.coeff_p[3*npoints];
+        double *__restrict__ out = loc[ifield];
+        #pragma omp simd
+        for( int ip=0; ip<npoints; ip++ ) {
+            double interp_res = 0.;
+            for( int iloc=0; iloc<3; iloc++ ) {
+                const double *column = &f[( idx[ip]+iloc-1 )*ny + idy[ip]-1];
+                interp_res += cx[iloc*npoints+ip] * ( cy[ip] * column[0] + cy[npoints+ip] * column[1] + cy[2*npoints+ip] * column[2] );
+            }
+            out[ip] = interp_res;
+        }
+    }
+    return true;
+}
+
 //! Interpolator on another field than the basic ones
 void Interpolator2D2Order::oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *, double *, double * )
 {
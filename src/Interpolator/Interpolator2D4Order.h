@@ -4,6 +4,7 @@
 
 #include "Interpolator2D.h"
 #include "Field2D.h"
+#include "ShapeFunctions.h"
 
 
 //  --------------------------------------------------------------------------------------------------------------------
@@ -33,13 +34,7 @@ public:
     //! Computation of a field from provided coefficients
     inline double __attribute__((always_inline)) compute( double *coeffx, double *coeffy, Field2D *f, int idx, int idy )
     {
-        double interp_res( 0. );
-        for( int iloc=-2 ; iloc<3 ; iloc++ ) {
-            for( int jloc=-2 ; jloc<3 ; jloc++ ) {
-                interp_res += *( coeffx+iloc ) * *( coeffy+jloc ) * ( *f )( idx+iloc, idy+jloc );
-            }
-        }
-        return interp_res;
+        return interpolate<4>( coeffx, coeffy, f, idx, idy );
     };
 
     //! Interpolator specific to the envelope model
@@ -63,47 +58,19 @@ private:
         idx_d[1] = round( ypn+0.5 );
         
         // Declaration and calculation of the coefficient for interpolation
-        double delta_x, delta_y, delta2, delta3, delta4;
+        double delta_x, delta_y;
         
         delta_x     = xpn - ( double )idx_d[0] + 0.5;
-        delta2     = delta_x*delta_x;
-        delta3     = delta2*delta_x;
-        delta4     = delta3*delta_x;
-        coeffxd[0] = dble_1_ov_384   - dble_1_ov_48  * delta_x  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-        coeffxd[1] = dble_19_ov_96   - dble_11_ov_24 * delta_x  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffxd[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-        coeffxd[3] = dble_19_ov_96   + dble_11_ov_24 * delta_x  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffxd[4] = dble_1_ov_384   + dble_1_ov_48  * delta_x  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        ShapeFunction<4>::coefficients( delta_x, coeffxd );
         
         delta_p[0] = xpn - ( double )idx_p[0];
-        delta2     = delta_p[0]*delta_p[0];
-        delta3     = delta2*delta_p[0];
-        delta4     = delta3*delta_p[0];
-        coeffxp[0] = dble_1_ov_384   - dble_1_ov_48  * delta_p[0]  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-        coeffxp[1] = dble_19_ov_96   - dble_11_ov_24 * delta_p[0]  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffxp[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-        coeffxp[3] = dble_19_ov_96   + dble_11_ov_24 * delta_p[0]  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffxp[4] = dble_1_ov_384   + dble_1_ov_48  * delta_p[0]  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        ShapeFunction<4>::coefficients( delta_p[0], coeffxp );
         
         delta_y     = ypn - ( double )idx_d[1] + 0.5;
-        delta2     = delta_y*delta_y;
-        delta3     = delta2*delta_y;
-        delta4     = delta3*delta_y;
-        coeffyd[0] = dble_1_ov_384   - dble_1_ov_48  * delta_y  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-        coeffyd[1] = dble_19_ov_96   - dble_11_ov_24 * delta_y  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffyd[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-        coeffyd[3] = dble_19_ov_96   + dble_11_ov_24 * delta_y  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffyd[4] = dble_1_ov_384   + dble_1_ov_48  * delta_y  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        ShapeFunction<4>::coefficients( delta_y, coeffyd );
         
         delta_p[1] = ypn - ( double )idx_p[1];
-        delta2     = delta_p[1]*delta_p[1];
-        delta3     = delta2*delta_p[1];
-        delta4     = delta3*delta_p[1];
-        coeffyp[0] = dble_1_ov_384   - dble_1_ov_48  * delta_p[1]  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-        coeffyp[1] = dble_19_ov_96   - dble_11_ov_24 * delta_p[1]  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffyp[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-        coeffyp[3] = dble_19_ov_96   + dble_11_ov_24 * delta_p[1]  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffyp[4] = dble_1_ov_384   + dble_1_ov_48  * delta_p[1]  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        ShapeFunction<4>::coefficients( delta_p[1], coeffyp );
         
         // First index for summation
         idx_p[0]   = idx_p[0] - i_domain_begin;
@@ -113,17 +80,6 @@ private:
 
     }
 
-    double dble_1_ov_384 ;
-    double dble_1_ov_48 ;
-    double dble_1_ov_16 ;
-    double dble_1_ov_12 ;
-    double dble_1_ov_24 ;
-    double dble_19_ov_96 ;
-    double dble_11_ov_24 ;
-    double dble_1_ov_4 ;
-    double dble_1_ov_6 ;
-    double dble_115_ov_192 ;
-    double dble_5_ov_8 ;
 
 };//END class
 
@@ -19,18 +19,6 @@ Interpolator2D4OrderV::Interpolator2D4OrderV( Params &params, Patch *patch ) : I
     d_inv_[0] = 1.0/params.cell_length[0];
     d_inv_[1] = 1.0/params.cell_length[1];
 
-    //double defined for use in coefficients
-    dble_1_ov_384 = 1.0/384.0;
-    dble_1_ov_48 = 1.0/48.0;
-    dble_1_ov_16 = 1.0/16.0;
-    dble_1_ov_12 = 1.0/12.0;
-    dble_1_ov_24 = 1.0/24.0;
-    dble_19_ov_96 = 19.0/96.0;
-    dble_11_ov_24 = 11.0/24.0;
-    dble_1_ov_4 = 1.0/4.0;
-    dble_1_ov_6 = 1.0/6.0;
-    dble_115_ov_192 = 115.0/192.0;
-    dble_5_ov_8 = 5.0/8.0;
 }
 
 
@@ -122,163 +110,11 @@ void Interpolator2D4OrderV::fieldsWrapper(  ElectroMagn *EMfields,
 
         #pragma omp simd
         for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-
-            // Declaration and calculation of the coefficient for interpolation
-            double delta0, delta, delta2, delta3, delta4;
-
-            // i = 0
-
-            delta0 = position_x[ipart+ivect+istart[0]] *d_inv_[0];
-            dual [0][ipart] = ( delta0 - ( double )idx[0] >=0. );
-
-            // coefficient x primal grid (i=0, j=0)
-
-            delta   = delta0 - ( double )idx[0] ;
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[0][0][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[0][0][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][0][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[0][0][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][0][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            deltaO[0][ipart-ipart_ref+ivect+istart[0]] = delta;
-
-            // std::cerr << "ipart: " << ipart +ivect+istart[0]
-            //           << " x: " << particles.position( 0, ipart+ivect+istart[0] )
-            //           << " y: " << particles.position( 1, ipart+ivect+istart[0] )
-            //           << std::endl;
-            //
-            // std::cerr << " delta: " << delta
-            //           << " coeffxp: " << coeff[0][0][0][ipart]
-            //           << " " << coeff[0][0][1][ipart]
-            //           << " " << coeff[0][0][2][ipart]
-            //           << " " << coeff[0][0][3][ipart]
-            //           << " " << coeff[0][0][4][ipart]
-            //           << std::endl;
-
-            // j = 1
-
-            // deltax   = delta0 - ( double )idx[0] + 0.5;
-            // delta2  = deltax*deltax;
-            // delta3  = delta2*deltax;
-            // delta4  = delta3*deltax;
-            // coeffxd_[0] = dble_1_ov_384   - dble_1_ov_48  * deltax  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            // coeffxd_[1] = dble_19_ov_96   - dble_11_ov_24 * deltax  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            // coeffxd_[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            // coeffxd_[3] = dble_19_ov_96   + dble_11_ov_24 * deltax  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            // coeffxd_[4] = dble_1_ov_384   + dble_1_ov_48  * deltax  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-
-            // coefficient x dual grid (i=0, j=1)
-
-            delta   = delta0 - ( double )idx[0] + ( 0.5-dual[0][ipart] );
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[0][1][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[0][1][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][1][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[0][1][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][1][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            // std::cerr
-            //           << " delta: " << delta
-            //           << " coeffxd: " << coeff[0][1][0][ipart]
-            //           << " " << coeff[0][1][1][ipart]
-            //           << " " << coeff[0][1][2][ipart]
-            //           << " " << coeff[0][1][3][ipart]
-            //           << " " << coeff[0][1][4][ipart]
-            //           << std::endl;
-
-
-            // i = 1
-
-            delta0 = position_y[ipart+ivect+istart[0]] *d_inv_[1];
-            dual [1][ipart] = ( delta0 - ( double )idx[1] >=0. );
-
-            // j = 0
-
-            // deltay   = ypn - ( double )jp_;
-            // delta2  = deltay*deltay;
-            // delta3  = delta2*deltay;
-            // delta4  = delta3*deltay;
-            // coeffyp_[0] = dble_1_ov_384   - dble_1_ov_48  * deltay  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            // coeffyp_[1] = dble_19_ov_96   - dble_11_ov_24 * deltay  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            // coeffyp_[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            // coeffyp_[3] = dble_19_ov_96   + dble_11_ov_24 * deltay  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            // coeffyp_[4] = dble_1_ov_384   + dble_1_ov_48  * deltay  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            delta   = delta0 - ( double )idx[1] ;
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[1][0][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[1][0][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][0][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[1][0][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][0][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            deltaO[1][ipart-ipart_ref+ivect+istart[0]] = delta;
-
-            // std::cerr
-            //           << " delta: " << delta
-            //           << " coeffyp: " << coeff[1][0][0][ipart]
-            //           << " " << coeff[1][0][1][ipart]
-            //           << " " << coeff[1][0][2][ipart]
-            //           << " " << coeff[1][0][3][ipart]
-            //           << " " << coeff[1][0][4][ipart]
-            //           << std::endl;
-
-            // j = 1
-
-            // deltay   = ypn - ( double )jd_ + 0.5;
-            // delta2  = deltay*deltay;
-            // delta3  = delta2*deltay;
-            // delta4  = delta3*deltay;
-            // coeffyd_[0] = dble_1_ov_384   - dble_1_ov_48  * deltay  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            // coeffyd_[1] = dble_19_ov_96   - dble_11_ov_24 * deltay  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            // coeffyd_[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            // coeffyd_[3] = dble_19_ov_96   + dble_11_ov_24 * deltay  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            // coeffyd_[4] = dble_1_ov_384   + dble_1_ov_48  * deltay  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-
-            delta   = delta0 - ( double )idx[1] + ( 0.5-dual[1][ipart] );
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[1][1][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[1][1][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][1][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[1][1][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][1][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            // std::cerr
-            //           << " delta: " << delta
-            //           << " coeffyd: " << coeff[1][1][0][ipart]
-            //           << " " << coeff[1][1][1][ipart]
-            //           << " " << coeff[1][1][2][ipart]
-            //           << " " << coeff[1][1][3][ipart]
-            //           << " " << coeff[1][1][4][ipart]
-            //           << std::endl;
-            //
-            // std::cerr << " xpn: " << particles.position( 0, *istart ) * d_inv_[0]
-            //           << " ypn: " << particles.position( 1, *istart ) * d_inv_[1]
-            //           << " idx0[0]: " << idxO[0]
-            //           << " idx0[1]: " << idxO[1] << std::endl;
-
-            //!\todo CHECK if this is correct for both primal & dual grids !!!
-            // First index for summation
-            // ip_ = ip_ - i_domain_begin;
-            // id_ = id_ - i_domain_begin;
-            // jp_ = jp_ - j_domain_begin;
-            // jd_ = jd_ - j_domain_begin;
-
+            const int ipart_buffer = ipart-ipart_ref+ivect+istart[0];
+            deltaO[0][ipart_buffer] = primalDualCoefficients<4>( position_x[ipart+ivect+istart[0]]*d_inv_[0], idx[0],
+                                      &coeff[0][0][0][ipart], &coeff[0][1][0][ipart], 32, dual[0][ipart] );
+            deltaO[1][ipart_buffer] = primalDualCoefficients<4>( position_y[ipart+ivect+istart[0]]*d_inv_[1], idx[1],
+                                      &coeff[1][0][0][ipart], &coeff[1][1][0][ipart], 32, dual[1][ipart] );
         }
 
         double * __restrict__ coeffxp2 = &( coeff[0][0][2][0] );
@@ -43,20 +43,6 @@ public:
     //! Interpolator specific to the envelope model
     void envelopeAndSusceptibility( ElectroMagn *EMfields, Particles &particles, int ipart, double *Env_A_abs_Loc, double *Env_Chi_Loc, double *Env_E_abs_Loc, double *Env_Ex_abs_Loc ) override final;
 
-private:
-
-    double dble_1_ov_384 ;
-    double dble_1_ov_48 ;
-    double dble_1_ov_16 ;
-    double dble_1_ov_12 ;
-    double dble_1_ov_24 ;
-    double dble_19_ov_96 ;
-    double dble_11_ov_24 ;
-    double dble_1_ov_4 ;
-    double dble_1_ov_6 ;
-    double dble_115_ov_192 ;
-    double dble_5_ov_8 ;
-
 };//END class
 
 #endif
@@ -19,6 +19,9 @@ Interpolator3D2Order::Interpolator3D2Order( Params &params, Patch *patch ) : Int
     d_inv_[1] = 1.0/params.cell_length[1];
     d_inv_[2] = 1.0/params.cell_length[2];
 
+    cache_envelope_coefficients_ = params.envelope_reuse_coefficients;
+    envelope_cache_nparts_ = -1;
+
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -136,6 +139,74 @@ void Interpolator3D2Order::fieldsAndCurrents( ElectroMagn *EMfields, Particles &
 
 }
 
+// Interpolation of all fields and currents at fixed points, with stencils computed once
+bool Interpolator3D2Order::fieldsAndCurrentsAtPoints( ElectroMagn *EMfields, Particles &particles, InterpolationStencils &stencils, double **loc )
+{
+    const int npoints = particles.numberOfParticles();
+    
+    // Stencils computed at the first call after the points are created
+    if( stencils.npoints != ( unsigned int ) npoints ) {
+        stencils.npoints = npoints;
+        stencils.idx_p.resize( 3*npoints );
+        stencils.idx_d.resize( 3*npoints );
+        stencils.coeff_p.resize( 9*npoints );
+        stencils.coeff_d.resize( 9*npoints );
+        int idx_p[3], idx_d[3];
+        double delta_p[3];
+        double coeffxp[3], coeffyp[3], coeffzp[3];
+        double coeffxd[3], coeffyd[3], coeffzd[3];
+        for( int ip=0; ip<npoints; ip++ ) {
+            coeffs( particles.position( 0, ip )*d_inv_[0], particles.position( 1, ip )*d_inv_[1], particles.position( 2, ip )*d_inv_[2],
+                    idx_p, idx_d, coeffxp, coeffyp, coeffzp, coeffxd, coeffyd, coeffzd, delta_p );
+            for( int idim=0; idim<3; idim++ ) {
+                stencils.idx_p[idim*npoints+ip] = idx_p[idim];
+                stencils.idx_d[idim*npoints+ip] = idx_d[idim];
+            }
+            for( int i=0; i<3; i++ ) {
+                stencils.coeff_p[i*npoints+ip]     = coeffxp[i];
+                stencils.coeff_p[( 3+i )*npoints+ip] = coeffyp[i];
+                stencils.coeff_p[( 6+i )*npoints+ip] = coeffzp[i];
+                stencils.coeff_d[i*npoints+ip]     = coeffxd[i];
+                stencils.coeff_d[( 3+i )*npoints+ip] = coeffyd[i];
+                stencils.coeff_d[( 6+i )*npoints+ip] = coeffzd[i];
+            }
+        }
+    }
+    
+    // Primal (p) or dual (d) grid of Ex, Ey, Ez, Bx, By, Bz, Jx, Jy, Jz, Rho along x, y and z
+    Field *fields[10] = { EMfields->Ex_, EMfields->Ey_, EMfields->Ez_, EMfields->Bx_m, EMfields->By_m, EMfields->Bz_m,
+                          EMfields->Jx_, EMfields->Jy_, EMfields->Jz_, EMfields->rho_ };
+    const bool dual[10][3] = { {true, false, false}, {false, true, false}, {false, false, true},
+                               {false, true, true}, {true, false, true}, {true, true, false},
+                               {true, false, false}, {false, true, false}, {false, false, true}, {false, false, false} };
+    
+    for( int ifield=0; ifield<10; ifield++ ) {
+        const double *__restrict__ f = fields[ifield]->data();
+        const int ny = fields[ifield]->dims_[1];
+        const int nz = fields[ifield]->dims_[2];
+        const int *__restrict__ idx = dual[ifield][0] ? &stencils.idx_d[0] : &stencils.idx_p[0];
+        const int *__restrict__ idy = dual[ifield][1] ? &stencils.idx_d[npoints] : &stencils.idx_p[npoints];
+        const int *__restrict__ idz = dual[ifield][2] ? &stencils.idx_d[2*npoints] : &stencils.idx_p[2*npoints];
+        const double *__restrict__ cx = dual[ifield][0] ? &stencils.coeff_d[0] : &stencils.coeff_p[0];
+        const double *__restrict__ cy = dual[ifield][1] ? &stencils.coeff_d[3*npoints] : &stencils.coeff_p[3*npoints];
+        const double *__restrict__ cz = dual[ifield][2] ? &stencils.coeff_d[6*npoints] : &stencils.coeff_p[6*npoints];
+        double *__restrict__ out = loc[ifield];
+        #pragma omp simd
+        for( int ip=0; ip<npoints; ip++ ) {
+            double interp_res = 0.;
+            for( int iloc=0; iloc<3; iloc++ ) {
+                for( int jloc=0; jloc<3; jloc++ ) {
+                    const double *column = &f[( ( idx[ip]+iloc-1 )*ny + idy[ip]+jloc-1 )*nz + idz[ip]-1];
+                    interp_res += cx[iloc*npoints+ip] * cy[jloc*npoints+ip]
+                                  * ( cz[ip] * column[0] + cz[npoints+ip] * column[1] + cz[2*npoints+ip] * column[2] );
+                }
+            }
+            out[ip] = interp_res;
+        }
+    }
+    return true;
+}
+
 // Interpolator on another field than the basic ones
 void Interpolator3D2Order::oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *, double *, double * )
 {
@@ -428,6 +499,14 @@ void Interpolator3D2Order::fieldsAndEnvelope( ElectroMagn *EMfields, Particles &
 
     //Loop on bin particles
     int nparts( particles.numberOfParticles() );
+
+    // The coefficients are kept for timeCenteredEnvelope, the positions do not change in between
+    if( cache_envelope_coefficients_ && envelope_cache_nparts_ != nparts ) {
+        envelope_coeffs_.resize( 12*nparts );
+        envelope_idx_.resize( 3*nparts );
+        envelope_cache_nparts_ = nparts;
+    }
+
     if (!smpi->use_BTIS3){ // without B-TIS3 interpolation
       
         for( int ipart=*istart ; ipart<*iend; ipart++ ) {
@@ -442,6 +521,9 @@ void Interpolator3D2Order::fieldsAndEnvelope( ElectroMagn *EMfields, Particles &
             double ypn = particles.position( 1, ipart )*d_inv_[1];
             double zpn = particles.position( 2, ipart )*d_inv_[2];
             coeffs( xpn, ypn, zpn, idx_p, idx_d, coeffxp, coeffyp, coeffzp, coeffxd, coeffyd, coeffzd, delta_p );
+            if( cache_envelope_coefficients_ ) {
+                cacheCoefficients( ipart, nparts, idx_p, coeffxp, coeffyp, coeffzp, delta_p );
+            }
 
             // Interpolation of Ex^(d,p,p)
             ( *Epart )[ipart+0*nparts] = compute( &coeffxd[1], &coeffyp[1], &coeffzp[1], Ex3D, idx_d[0], idx_p[1], idx_p[2], nx_d, ny_p, nz_p );
@@ -515,6 +597,9 @@ void Interpolator3D2Order::fieldsAndEnvelope( ElectroMagn *EMfields, Particles &
             double zpn = particles.position( 2, ipart )*d_inv_[2];
 
             coeffs( xpn, ypn, zpn, idx_p, idx_d, coeffxp, coeffyp, coeffzp, coeffxd, coeffyd, coeffzd, delta_p );
+            if( cache_envelope_coefficients_ ) {
+                cacheCoefficients( ipart, nparts, idx_p, coeffxp, coeffyp, coeffzp, delta_p );
+            }
 
             // Interpolation of Ex^(d,p,p)
             ( *Epart )[ipart+0*nparts] = compute( &coeffxd[1], &coeffyp[1], &coeffzp[1], Ex3D, idx_d[0], idx_p[1], idx_p[2], nx_d, ny_p, nz_p );
@@ -596,17 +681,25 @@ void Interpolator3D2Order::timeCenteredEnvelope( ElectroMagn *EMfields, Particle
 
     //Loop on bin particles
     int nparts( particles.numberOfParticles());
-    for( int ipart=*istart ; ipart<*iend; ipart++ ) {
 
-        // Normalized particle position
-        double xpn = particles.position( 0, ipart )*d_inv_[0];
-        double ypn = particles.position( 1, ipart )*d_inv_[1];
-        double zpn = particles.position( 2, ipart )*d_inv_[2];
+    // Coefficients computed by fieldsAndEnvelope at the same positions
+    const bool use_cache = cache_envelope_coefficients_ && envelope_cache_nparts_ == nparts;
+
+    for( int ipart=*istart ; ipart<*iend; ipart++ ) {
 
         int idx_p[3];
         double delta_p[3];
         double coeffxp[3], coeffyp[3], coeffzp[3];
-        coeffs( xpn, ypn, zpn, idx_p, NULL, coeffxp, coeffyp, coeffzp, NULL, NULL, NULL, delta_p );
+        if( use_cache ) {
+            cachedCoefficients( ipart, nparts, idx_p, coeffxp, coeffyp, coeffzp, delta_p );
+        } else {
+            // Normalized particle position
+            double xpn = particles.position( 0, ipart )*d_inv_[0];
+            double ypn = particles.position( 1, ipart )*d_inv_[1];
+            double zpn = particles.position( 2, ipart )*d_inv_[2];
+
+            coeffs( xpn, ypn, zpn, idx_p, NULL, coeffxp, coeffyp, coeffzp, NULL, NULL, NULL, delta_p );
+        }
 
         // -------------------------
         // Interpolation of Phi_m^(p,p,p)
@@ -34,6 +34,9 @@ public:
     //! Interpolator on another field than the basic ones
     void oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *l1=NULL, double *l2=NULL, double *l3=NULL ) override ;
 
+    //! Interpolation of all fields and currents at fixed points, with stencils computed once
+    bool fieldsAndCurrentsAtPoints( ElectroMagn *EMfields, Particles &particles, InterpolationStencils &stencils, double **loc ) override;
+
     //! Computation of a field from provided coefficients
     inline double __attribute__((always_inline)) compute( double *coeffx, double *coeffy, double *coeffz, const Field3D *const f, int idx, int idy, int idz )
     {
@@ -90,6 +93,44 @@ public:
 
 private:
 
+    //! Cache the primal coefficients of fieldsAndEnvelope for timeCenteredEnvelope (LaserEnvelope.reuse_interpolation_coefficients)
+    bool cache_envelope_coefficients_;
+
+    //! Number of particles when the cache was filled (-1 if empty)
+    int envelope_cache_nparts_;
+
+    //! Cached coefficients, one row of envelope_cache_nparts_ for each of coeffxp[3], coeffyp[3], coeffzp[3], delta_p[3]
+    std::vector<double> envelope_coeffs_;
+
+    //! Cached primal indices, one row of envelope_cache_nparts_ per dimension
+    std::vector<int> envelope_idx_;
+
+    //! Store the primal coefficients of particle ipart in the cache
+    inline void __attribute__((always_inline)) cacheCoefficients( int ipart, int nparts, const int *idx_p,
+            const double *coeffxp, const double *coeffyp, const double *coeffzp, const double *delta_p )
+    {
+        for( int i=0 ; i<3 ; i++ ) {
+            envelope_coeffs_[( 0+i )*nparts+ipart] = coeffxp[i];
+            envelope_coeffs_[( 3+i )*nparts+ipart] = coeffyp[i];
+            envelope_coeffs_[( 6+i )*nparts+ipart] = coeffzp[i];
+            envelope_coeffs_[( 9+i )*nparts+ipart] = delta_p[i];
+            envelope_idx_[i*nparts+ipart] = idx_p[i];
+        }
+    }
+
+    //! Read the primal coefficients of particle ipart from the cache
+    inline void __attribute__((always_inline)) cachedCoefficients( int ipart, int nparts, int *idx_p,
+            double *coeffxp, double *coeffyp, double *coeffzp, double *delta_p ) const
+    {
+        for( int i=0 ; i<3 ; i++ ) {
+            coeffxp[i] = envelope_coeffs_[( 0+i )*nparts+ipart];
+            coeffyp[i] = envelope_coeffs_[( 3+i )*nparts+ipart];
+            coeffzp[i] = envelope_coeffs_[( 6+i )*nparts+ipart];
+            delta_p[i] = envelope_coeffs_[( 9+i )*nparts+ipart];
+            idx_p[i]   = envelope_idx_[i*nparts+ipart];
+        }
+    }
+
     SMILEI_ACCELERATOR_DECLARE_ROUTINE
     //! Compuation of coefficients for interpolation using particle normalized positions xpn, ypn, zpn
     inline void __attribute__((always_inline)) coeffs( double xpn, double ypn, double zpn, int* idx_p, int* idx_d,
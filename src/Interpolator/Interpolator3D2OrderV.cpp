@@ -44,10 +44,10 @@ void Interpolator3D2OrderV::fieldsWrapper( ElectroMagn * __restrict__ EMfields,
     double idx[3];
     //Primal indices are the same for all particles
     idx[0]  = round( particles.position( 0, *istart ) * d_inv_[0] );
-    idxO[0] = ( int )idx[0] - i_domain_begin ;
     idx[1]  = round( particles.position( 1, *istart ) * d_inv_[1] );
-    idxO[1] = ( int )idx[1] - j_domain_begin ;
     idx[2]  = round( particles.position( 2, *istart ) * d_inv_[2] );
+    idxO[0] = ( int )idx[0] - i_domain_begin ;
+    idxO[1] = ( int )idx[1] - j_domain_begin ;
     idxO[2] = ( int )idx[2] - k_domain_begin ;
 
     const Field3D *const __restrict__ Ex3D = static_cast<Field3D *>( EMfields->Ex_ );
@@ -74,7 +74,7 @@ void Interpolator3D2OrderV::fieldsWrapper( ElectroMagn * __restrict__ EMfields,
     // double * __restrict__ Bz = &Bz3D->data_[0];
 
     double coeff[3][2][3][32];
-    int dual[3][32]; // Size ndim. Boolean indicating if the part has a dual indice equal to the primal one (dual=0, delta_primal < 0) or if it is +1 (dual=1, delta_primal>=0).
+    double dual[3][32]; // Size ndim. Boolean indicating if the part has a dual indice equal to the primal one (dual=0, delta_primal < 0) or if it is +1 (dual=1, delta_primal>=0).
 
     // vector size for vector block division
     const int vecSize = 32;
@@ -82,6 +82,26 @@ void Interpolator3D2OrderV::fieldsWrapper( ElectroMagn * __restrict__ EMfields,
     // number of paticles per cell
     const int cell_nparts( ( int )iend[0]-( int )istart[0] );
 
+    // Local field tiles of the cell (ghost nodes included), loaded once for all the particles of the cell
+    // so that the gather only reads a small contiguous buffer instead of the global fields.
+    // Field buffers are also required for vectorization on A64FX.
+    // Order: Ex(d,p,p), Ey(p,d,p), Ez(p,p,d), Bx(p,d,d), By(d,p,d), Bz(d,d,p)
+    alignas( 64 ) double field_tile[6][4][4][4];
+    const Field3D *const __restrict__ fields3D[6] = { Ex3D, Ey3D, Ez3D, Bx3D, By3D, Bz3D };
+    for( int ifield=0 ; ifield<6 ; ifield++ ) {
+        // Dual directions need one more node
+        const int iend_loc = ( ifield==0 || ifield>=4 ) ? 3 : 2;
+        const int jend_loc = ( ifield==1 || ifield==3 || ifield==5 ) ? 3 : 2;
+        const int kend_loc = ( ifield==2 || ifield==3 || ifield==4 ) ? 3 : 2;
+        for( int iloc=-1 ; iloc<iend_loc ; iloc++ ) {
+            for( int jloc=-1 ; jloc<jend_loc ; jloc++ ) {
+                for( int kloc=-1 ; kloc<kend_loc ; kloc++ ) {
+                    field_tile[ifield][iloc+1][jloc+1][kloc+1] = ( *fields3D[ifield] )( idxO[0]+iloc, idxO[1]+jloc, idxO[2]+kloc );
+                }
+            }
+        }
+    }
+
     for( int ivect=0 ; ivect < cell_nparts; ivect += vecSize ) {
 
         int np_computed( min( cell_nparts-ivect, vecSize ) );
@@ -96,311 +116,122 @@ void Interpolator3D2OrderV::fieldsWrapper( ElectroMagn * __restrict__ EMfields,
             Bpart[k]= &( smpi->dynamics_Bpart[ithread][k*nparts-ipart_ref+ivect+istart[0]] );
         }
 
-        double delta2, delta;
-
-        #pragma omp simd private(delta2, delta)
-        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+        // Offset of the block in the position arrays
+        const int iblock = ivect + istart[0];
 
+        // Coefficient pointer on primal and dual nodes
+        double * __restrict__ coeffxd = &( coeff[0][1][1][0] );
+        double * __restrict__ coeffxp = &( coeff[0][0][1][0] );
+        double * __restrict__ coeffyp = &( coeff[1][0][1][0] );
+        double * __restrict__ coeffyd = &( coeff[1][1][1][0] );
+        double * __restrict__ coeffzp = &( coeff[2][0][1][0] );
+        double * __restrict__ coeffzd = &( coeff[2][1][1][0] );
 
-            // #if defined(__clang__)
-            //     #pragma clang loop unroll(full)
-            // #elif defined (__FUJITSU)
-            //     #pragma loop fullunroll_pre_simd 3
-            // #elif defined(__GNUC__)
-            //     #pragma GCC unroll (3)
-            // #endif
-            // for( int i=0; i<3; i++ ) { // for X/Y/Z
-            //     //delta primal = distance to primal node
-            //     delta   = particles.position( i, ipart+ivect+istart[0] )*d_inv_[i] - idx[i];
-            //     delta2  = delta*delta;
-            //     coeff[i][0][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            //     coeff[i][0][1][ipart]    = ( 0.75 - delta2 );
-            //     coeff[i][0][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
-            //     //store delta primal in global array
-            //     //deltaO[i][ipart-ipart_ref+ivect+istart[0]] = delta;
-            //     deltaO[i][ipart] = delta;
-            //     dual [i][ipart] = ( delta >= 0. );
-            //
-            //     //delta dual = distance to dual node
-            //     delta   = delta - dual[i][ipart] + 0.5 ;
-            //     delta2  = delta*delta;
-            //
-            //     coeff[i][1][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            //     coeff[i][1][1][ipart]    = ( 0.75 - delta2 );
-            //     coeff[i][1][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
-            // }
+#ifdef SMILEI_EXPLICIT_SIMD
+        // Explicit SIMD backend: the lanes after np_computed read zeroed positions
+        // and their results are not stored
+        const int width = SimdDouble::width;
+        static_assert( 32 % SimdDouble::width == 0, "the SIMD width must divide the block size" );
 
-            // X direction
+        for( int ipart=0 ; ipart<np_computed; ipart += width ) {
+            const int n      = np_computed - ipart;
+            const int ipart2 = ipart+iblock;
+            SimdDouble delta;
 
+            //delta primal = distance to primal node
+            delta = SimdDouble::loadPartial( position_x+ipart2, n )*d_inv_[0] - idx[0];
+            delta.storePartial( deltaO[0]+ipart, n );
+            simdStore( dual[0]+ipart, coefficients( delta, &coeff[0][0][0][0], &coeff[0][1][0][0], ipart ) );
 
-            int ipart2 = ipart+ivect+istart[0];
+            delta = SimdDouble::loadPartial( position_y+ipart2, n )*d_inv_[1] - idx[1];
+            delta.storePartial( deltaO[1]+ipart, n );
+            simdStore( dual[1]+ipart, coefficients( delta, &coeff[1][0][0][0], &coeff[1][1][0][0], ipart ) );
 
-            //delta primal = distance to primal node
-            delta   = position_x[ipart2]*d_inv_[0] - idx[0];
-            delta2  = delta*delta;
-            coeff[0][0][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            coeff[0][0][1][ipart]    = ( 0.75 - delta2 );
-            coeff[0][0][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
-            //store delta primal in global array
-            //deltaO[i][ipart-ipart_ref+ivect+istart[0]] = delta;
-            deltaO[0][ipart] = delta;
-            dual [0][ipart] = ( delta >= 0. );
+            delta = SimdDouble::loadPartial( position_z+ipart2, n )*d_inv_[2] - idx[2];
+            delta.storePartial( deltaO[2]+ipart, n );
+            simdStore( dual[2]+ipart, coefficients( delta, &coeff[2][0][0][0], &coeff[2][1][0][0], ipart ) );
+        }
 
-            //delta dual = distance to dual node
-            delta   = delta - dual[0][ipart] + 0.5 ;
-            delta2  = delta*delta;
+        for( int ipart=0 ; ipart<np_computed; ipart += width ) {
+            const int n = np_computed - ipart;
+            const SimdDouble dx = SimdDouble::load( dual[0]+ipart );
+            const SimdDouble dy = SimdDouble::load( dual[1]+ipart );
+            const SimdDouble dz = SimdDouble::load( dual[2]+ipart );
 
-            coeff[0][1][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            coeff[0][1][1][ipart]    = ( 0.75 - delta2 );
-            coeff[0][1][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
+            //Ex(dual, primal, primal)
+            gatherTile<SimdDouble, true, false, false>( coeffxd, coeffyp, coeffzp, field_tile[0], dx, dy, dz, ipart ).storePartial( Epart[0]+ipart, n );
+            //Ey(primal, dual, primal)
+            gatherTile<SimdDouble, false, true, false>( coeffxp, coeffyd, coeffzp, field_tile[1], dx, dy, dz, ipart ).storePartial( Epart[1]+ipart, n );
+            //Ez(primal, primal, dual)
+            gatherTile<SimdDouble, false, false, true>( coeffxp, coeffyp, coeffzd, field_tile[2], dx, dy, dz, ipart ).storePartial( Epart[2]+ipart, n );
+            //Bx(primal, dual , dual )
+            gatherTile<SimdDouble, false, true, true>( coeffxp, coeffyd, coeffzd, field_tile[3], dx, dy, dz, ipart ).storePartial( Bpart[0]+ipart, n );
+            //By(dual, primal, dual )
+            gatherTile<SimdDouble, true, false, true>( coeffxd, coeffyp, coeffzd, field_tile[4], dx, dy, dz, ipart ).storePartial( Bpart[1]+ipart, n );
+            //Bz(dual, dual, prim )
+            gatherTile<SimdDouble, true, true, false>( coeffxd, coeffyd, coeffzp, field_tile[5], dx, dy, dz, ipart ).storePartial( Bpart[2]+ipart, n );
+        }
+#else
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
 
-            // Y direction
+            const int ipart2 = ipart+iblock;
+            double delta;
 
+            // X direction
             //delta primal = distance to primal node
-            delta   = position_y[ipart2]*d_inv_[1] - idx[1];
-            delta2  = delta*delta;
-            coeff[1][0][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            coeff[1][0][1][ipart]    = ( 0.75 - delta2 );
-            coeff[1][0][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
+            delta = position_x[ipart2]*d_inv_[0] - idx[0];
             //store delta primal in global array
-            //deltaO[1][ipart-ipart_ref+ivect+istart[0]] = delta;
-            deltaO[1][ipart] = delta;
-            dual [1][ipart] = ( delta >= 0. );
-
-            //delta dual = distance to dual node
-            delta   = delta - dual[1][ipart] + 0.5 ;
-            delta2  = delta*delta;
+            deltaO[0][ipart] = delta;
+            dual[0][ipart] = coefficients( delta, &coeff[0][0][0][0], &coeff[0][1][0][0], ipart );
 
-            coeff[1][1][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            coeff[1][1][1][ipart]    = ( 0.75 - delta2 );
-            coeff[1][1][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
+            // Y direction
+            delta = position_y[ipart2]*d_inv_[1] - idx[1];
+            deltaO[1][ipart] = delta;
+            dual[1][ipart] = coefficients( delta, &coeff[1][0][0][0], &coeff[1][1][0][0], ipart );
 
             // Z direction
-
-            //delta primal = distance to primal node
-            delta   = position_z[ipart2]*d_inv_[2] - idx[2];
-            delta2  = delta*delta;
-            coeff[2][0][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            coeff[2][0][1][ipart]    = ( 0.75 - delta2 );
-            coeff[2][0][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
-            //store delta primal in global array
-            //deltaO[2][ipart-ipart_ref+ivect+istart[0]] = delta;
+            delta = position_z[ipart2]*d_inv_[2] - idx[2];
             deltaO[2][ipart] = delta;
-            dual [2][ipart] = ( delta >= 0. );
-
-            //delta dual = distance to dual node
-            delta   = delta - dual[2][ipart] + 0.5 ;
-            delta2  = delta*delta;
-
-            coeff[2][1][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
-            coeff[2][1][1][ipart]    = ( 0.75 - delta2 );
-            coeff[2][1][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
-
+            dual[2][ipart] = coefficients( delta, &coeff[2][0][0][0], &coeff[2][1][0][0], ipart );
         }
 
-        double interp_res = 0.;
-
-        // Coefficient pointer on primal and dual nodes
-        double * __restrict__ coeffxd = &( coeff[0][1][1][0] );
-        double * __restrict__ coeffxp = &( coeff[0][0][1][0] );
-        double * __restrict__ coeffyp = &( coeff[1][0][1][0] );
-        double * __restrict__ coeffyd = &( coeff[1][1][1][0] );
-        double * __restrict__ coeffzp = &( coeff[2][0][1][0] );
-        double * __restrict__ coeffzd = &( coeff[2][1][1][0] );
-
-        // Field buffers for vectorization (required on A64FX)
-        double field_buffer[4][4][4];
-
         //Ex(dual, primal, primal)
-
-        for( int iloc=-1 ; iloc<3 ; iloc++ ) {
-            for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                for( int kloc=-1 ; kloc<2 ; kloc++ ) {
-                    field_buffer[iloc+1][jloc+1][kloc+1] = (*Ex3D)(idxO[0]+iloc,idxO[1]+jloc,idxO[2]+kloc);
-                }
-            }
-        }
-
-        #pragma omp simd private(interp_res)
+        #pragma omp simd
         for ( int ipart=0 ; ipart<np_computed; ipart++ ) {
-
-            interp_res = 0.;
-            UNROLL_S(3)
-            for( int iloc=0 ; iloc<3 ; iloc++ ) {
-                UNROLL_S(3)
-                for( int jloc=0 ; jloc<3 ; jloc++ ) {
-                    UNROLL_S(3)
-                    for( int kloc=0 ; kloc<3 ; kloc++ ) {
-                         interp_res += coeffxd[ipart+(iloc-1)*32] * coeffyp[ipart+(jloc-1)*32]  * coeffzp[ipart + (kloc-1)*32] *
-                                       ( ( 1-dual[0][ipart] )*field_buffer[iloc][jloc][kloc] +
-                                       dual[0][ipart]*field_buffer[iloc+1][jloc][kloc] );
-
-                    }
-                }
-            }
-            Epart[0][ipart] = interp_res;
+            Epart[0][ipart] = gatherTile<double, true, false, false>( coeffxd, coeffyp, coeffzp, field_tile[0], dual[0][ipart], 0., 0., ipart );
         }
 
-        // ---------------------------------------------------------------------
         //Ey(primal, dual, primal)
-
-        for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-            for( int jloc=-1 ; jloc<3 ; jloc++ ) {
-                for( int kloc=-1 ; kloc<2 ; kloc++ ) {
-                    field_buffer[iloc+1][jloc+1][kloc+1] = (*Ey3D)(idxO[0]+iloc,idxO[1]+jloc,idxO[2]+kloc);
-                }
-            }
-        }
-
-        #pragma omp simd private(interp_res)
+        #pragma omp simd
         for ( int ipart=0 ; ipart<np_computed; ipart++ ) {
-
-            interp_res = 0.;
-            UNROLL_S(3)
-            for( int iloc=0 ; iloc<3 ; iloc++ ) {
-                UNROLL_S(3)
-                for( int jloc=0 ; jloc<3 ; jloc++ ) {
-                    UNROLL_S(3)
-                    for( int kloc=0 ; kloc<3 ; kloc++ ) {
-                        interp_res += coeffxp[ipart+(iloc-1)*32] * coeffyd[ipart+(jloc-1)*32] * coeffzp[ipart + (kloc-1)*32] *
-                                    ( ( 1-dual[1][ipart] )*field_buffer[iloc][jloc][kloc] +
-                                    dual[1][ipart]*field_buffer[iloc][jloc+1][kloc] );
-                    }
-                }
-            }
-            Epart[1][ipart] = interp_res;
+            Epart[1][ipart] = gatherTile<double, false, true, false>( coeffxp, coeffyd, coeffzp, field_tile[1], 0., dual[1][ipart], 0., ipart );
         }
 
-        // ---------------------------------------------------------------------
         //Ez(primal, primal, dual)
-
-        for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-            for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                for( int kloc=-1 ; kloc<3 ; kloc++ ) {
-                    field_buffer[iloc+1][jloc+1][kloc+1] = (*Ez3D)(idxO[0]+iloc,idxO[1]+jloc,idxO[2]+kloc);
-                }
-            }
-        }
-
-        #pragma omp simd private(interp_res)
+        #pragma omp simd
         for ( int ipart=0 ; ipart<np_computed; ipart++ ) {
-
-            interp_res = 0.;
-            UNROLL_S(3)
-            for( int iloc=0 ; iloc<3 ; iloc++ ) {
-                UNROLL_S(3)
-                for( int jloc=0 ; jloc<3 ; jloc++ ) {
-                    UNROLL_S(3)
-                    for( int kloc=0 ; kloc<3 ; kloc++ ) {
-                        interp_res += coeffxp[ipart+(iloc-1)*32] * coeffyp[ipart+(jloc-1)*32] * coeffzd[ipart + (kloc-1)*32] *
-                                    ( ( 1-dual[2][ipart] )*field_buffer[iloc][jloc][kloc] +
-                                    dual[2][ipart]*field_buffer[iloc][jloc][kloc+1] );
-
-                    }
-                }
-            }
-
-            Epart[2][ipart] = interp_res;
-
+            Epart[2][ipart] = gatherTile<double, false, false, true>( coeffxp, coeffyp, coeffzd, field_tile[2], 0., 0., dual[2][ipart], ipart );
         }
 
-        // ---------------------------------------------------------------------
         //Bx(primal, dual , dual )
-
-        for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-            for( int jloc=-1 ; jloc<3 ; jloc++ ) {
-                for( int kloc=-1 ; kloc<3 ; kloc++ ) {
-                    field_buffer[iloc+1][jloc+1][kloc+1] = (*Bx3D)(idxO[0]+iloc,idxO[1]+jloc,idxO[2]+kloc);
-                }
-            }
-        }
-
-        #pragma omp simd private(interp_res)
+        #pragma omp simd
         for ( int ipart=0 ; ipart<np_computed; ipart++ ) {
-
-            interp_res = 0.;
-            UNROLL_S(3)
-            for( int iloc=0 ; iloc<3 ; iloc++ ) {
-                UNROLL_S(3)
-                for( int jloc=0 ; jloc<3 ; jloc++ ) {
-                    UNROLL_S(3)
-                    for( int kloc=0 ; kloc<3 ; kloc++ ) {
-                        interp_res += coeffxp[ipart+(iloc-1)*32] * coeffyd[ipart+(jloc-1)*32] * coeffzd[ipart + (kloc-1)*32] *
-                                    ( ( 1-dual[2][ipart] )* ( (1-dual[1][ipart])*field_buffer[iloc][jloc][kloc] + dual[1][ipart]*field_buffer[iloc][jloc+1][kloc] )  +
-                                    dual[2][ipart]        * ( (1-dual[1][ipart])*field_buffer[iloc][jloc][kloc+1]  + dual[1][ipart]*field_buffer[iloc][jloc+1][kloc+1] )  );
-                    }
-                }
-            }
-
-            Bpart[0][ipart] = interp_res;
-
+            Bpart[0][ipart] = gatherTile<double, false, true, true>( coeffxp, coeffyd, coeffzd, field_tile[3], 0., dual[1][ipart], dual[2][ipart], ipart );
         }
 
-        // ---------------------------------------------------------------------
         //By(dual, primal, dual )
-
-        for( int iloc=-1 ; iloc<3 ; iloc++ ) {
-            for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                for( int kloc=-1 ; kloc<3 ; kloc++ ) {
-                    field_buffer[iloc+1][jloc+1][kloc+1] = (*By3D)(idxO[0]+iloc,idxO[1]+jloc,idxO[2]+kloc);
-                }
-            }
-        }
-
-        #pragma omp simd private(interp_res)
+        #pragma omp simd
         for ( int ipart=0 ; ipart<np_computed; ipart++ ) {
-
-            interp_res = 0.;
-            UNROLL_S(3)
-            for( int iloc=0 ; iloc<3 ; iloc++ ) {
-                UNROLL_S(3)
-                for( int jloc=0 ; jloc<3 ; jloc++ ) {
-                    UNROLL_S(3)
-                    for( int kloc=0 ; kloc<3 ; kloc++ ) {
-                        interp_res += coeffxd[ipart+(iloc-1)*32] * coeffyp[ipart+(jloc-1)*32] * coeffzd[ipart + (kloc-1)*32] *
-                                    ( ( 1-dual[2][ipart] )*( (1-dual[0][ipart])*field_buffer[iloc][jloc][kloc] + dual[0][ipart]*field_buffer[iloc+1][jloc][kloc] )  +
-                                    dual[2][ipart]        *( (1-dual[0][ipart])*field_buffer[iloc][jloc][kloc+1] + dual[0][ipart]*field_buffer[iloc+1][jloc][kloc+1] )  );
-
-                    }
-                }
-            }
-
-            Bpart[1][ipart] = interp_res;
-
+            Bpart[1][ipart] = gatherTile<double, true, false, true>( coeffxd, coeffyp, coeffzd, field_tile[4], dual[0][ipart], 0., dual[2][ipart], ipart );
         }
 
-        // ---------------------------------------------------------------------
         //Bz(dual, dual, prim )
-
-        for( int iloc=-1 ; iloc<3 ; iloc++ ) {
-            for( int jloc=-1 ; jloc<3 ; jloc++ ) {
-                for( int kloc=-1 ; kloc<2 ; kloc++ ) {
-                    field_buffer[iloc+1][jloc+1][kloc+1] = (*Bz3D)(idxO[0]+iloc,idxO[1]+jloc,idxO[2]+kloc);
-                }
-            }
-        }
-
-        #pragma omp simd private(interp_res)
+        #pragma omp simd
         for ( int ipart=0 ; ipart<np_computed; ipart++ ) {
-
-            interp_res = 0.;
-            UNROLL_S(3)
-            for( int iloc=0 ; iloc<3 ; iloc++ ) {
-                UNROLL_S(3)
-                for( int jloc=0 ; jloc<3 ; jloc++ ) {
-                    UNROLL_S(3)
-                    for( int kloc=0; kloc<3 ; kloc++ ) {
-                        interp_res += coeffxd[ipart+(iloc-1)*32] * coeffyd[ipart+(jloc-1)*32] * coeffzp[ipart + (kloc-1)*32] *
-                                    ( ( 1-dual[1][ipart] )*( (1-dual[0][ipart])*field_buffer[iloc][jloc][kloc] + dual[0][ipart]*field_buffer[iloc+1][jloc][kloc] )  +
-                                    dual[1][ipart]        *( (1-dual[0][ipart])*field_buffer[iloc][jloc+1][kloc] + dual[0][ipart]*field_buffer[iloc+1][jloc+1][kloc] )  );
-
-                    }
-                }
-            }
-
-            Bpart[2][ipart] = interp_res;
-
+            Bpart[2][ipart] = gatherTile<double, true, true, false>( coeffxd, coeffyd, coeffzp, field_tile[5], dual[0][ipart], dual[1][ipart], 0., ipart );
         }
+#endif
 
     }
 } // END Interpolator3D2OrderV
@@ -5,6 +5,7 @@
 #include "Interpolator3D2Order.h"
 #include "Field3D.h"
 #include "Pragma.h"
+#include "Simd.h"
 
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class for vectorized 2nd order interpolator for 3d3v simulations
@@ -59,6 +60,65 @@ public:
 
 private:
 
+    //! 2nd order coefficients of one direction on the 3 primal nodes (coeffp) and dual nodes (coeffd)
+    //! around a particle at `delta` from its primal node, for the lanes `ipart` of a block of 32 particles.
+    //! Returns 1 if the dual node of index idx+1 is the left node of the dual stencil, 0 otherwise.
+    template<typename T>
+    static inline T __attribute__((always_inline)) coefficients( T delta, double *coeffp, double *coeffd, int ipart )
+    {
+        T delta2 = delta*delta;
+        simdStore( coeffp+ipart,    0.5 * ( delta2-delta+0.25 ) );
+        simdStore( coeffp+32+ipart, ( 0.75 - delta2 ) );
+        simdStore( coeffp+64+ipart, 0.5 * ( delta2+delta+0.25 ) );
+
+        //delta dual = distance to dual node
+        const T dual = simdHeaviside( delta );
+        delta  = delta - dual + 0.5;
+        delta2 = delta*delta;
+        simdStore( coeffd+ipart,    0.5 * ( delta2-delta+0.25 ) );
+        simdStore( coeffd+32+ipart, ( 0.75 - delta2 ) );
+        simdStore( coeffd+64+ipart, 0.5 * ( delta2+delta+0.25 ) );
+        return dual;
+    }
+
+    //! Value of a field tile at node (i,j,k), shifted by one node in each dual direction where `dual` is 1
+    template<typename T, bool dual_x, bool dual_y, bool dual_z>
+    static inline T __attribute__((always_inline)) tileValue( const double ( *tile )[4][4], int i, int j, int k, T dx, T dy, T dz )
+    {
+        if( dual_z ) {
+            return ( 1.-dz )*tileValue<T, dual_x, dual_y, false>( tile, i, j, k, dx, dy, dz )
+                   + dz*tileValue<T, dual_x, dual_y, false>( tile, i, j, k+1, dx, dy, dz );
+        }
+        if( dual_y ) {
+            return ( 1.-dy )*tileValue<T, dual_x, false, false>( tile, i, j, k, dx, dy, dz )
+                   + dy*tileValue<T, dual_x, false, false>( tile, i, j+1, k, dx, dy, dz );
+        }
+        if( dual_x ) {
+            return ( 1.-dx )*T( tile[i][j][k] ) + dx*T( tile[i+1][j][k] );
+        }
+        return T( tile[i][j][k] );
+    }
+
+    //! Interpolation of a field tile for the lanes `ipart` of a block of 32 particles
+    //! The coefficients point to the central node of their stencil
+    template<typename T, bool dual_x, bool dual_y, bool dual_z>
+    static inline T __attribute__((always_inline)) gatherTile( const double *coeffx, const double *coeffy, const double *coeffz,
+                                                               const double ( *tile )[4][4], T dx, T dy, T dz, int ipart )
+    {
+        T interp_res = 0.;
+        UNROLL_S(3)
+        for( int iloc=0 ; iloc<3 ; iloc++ ) {
+            UNROLL_S(3)
+            for( int jloc=0 ; jloc<3 ; jloc++ ) {
+                UNROLL_S(3)
+                for( int kloc=0 ; kloc<3 ; kloc++ ) {
+                    interp_res += simdLoad<T>( coeffx+ipart+( iloc-1 )*32 ) * simdLoad<T>( coeffy+ipart+( jloc-1 )*32 ) * simdLoad<T>( coeffz+ipart+( kloc-1 )*32 ) *
+                                  tileValue<T, dual_x, dual_y, dual_z>( tile, iloc, jloc, kloc, dx, dy, dz );
+                }
+            }
+        }
+        return interp_res;
+    }
 
 };//END class
 
@@ -4,6 +4,7 @@
 
 #include "Interpolator3D.h"
 #include "Field3D.h"
+#include "ShapeFunctions.h"
 
 
 //  --------------------------------------------------------------------------------------------------------------------
@@ -39,16 +40,7 @@ public:
     //! Computation of a field from provided coefficients
     inline double __attribute__((always_inline)) compute( double *coeffx, double *coeffy, double *coeffz, Field3D *f, int idx, int idy, int idz )
     {
-        double interp_res( 0. );
-        //unroll ?
-        for( int iloc=-2 ; iloc<3 ; iloc++ ) {
-            for( int jloc=-2 ; jloc<3 ; jloc++ ) {
-                for( int kloc=-2 ; kloc<3 ; kloc++ ) {
-                    interp_res += *( coeffx+iloc ) * *( coeffy+jloc ) * *( coeffz+kloc ) * ( *f )( idx+iloc, idy+jloc, idz+kloc );
-                }
-            }
-        }
-        return interp_res;
+        return interpolate<4>( coeffx, coeffy, coeffz, f, idx, idy, idz );
     };
 
 private:
@@ -63,37 +55,16 @@ private:
         idx_p[2] = round( zpn );
         
         // Declaration and calculation of the coefficient for interpolation
-        double delta, delta2, delta3, delta4;
+        double delta;
         
         delta_p[0] = xpn - ( double )idx_p[0];
-        delta2     = delta_p[0]*delta_p[0];
-        delta3     = delta2*delta_p[0];
-        delta4     = delta3*delta_p[0];
-        coeffxp[0] = dble_1_ov_384   - dble_1_ov_48  * delta_p[0]  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-        coeffxp[1] = dble_19_ov_96   - dble_11_ov_24 * delta_p[0]  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffxp[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-        coeffxp[3] = dble_19_ov_96   + dble_11_ov_24 * delta_p[0]  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffxp[4] = dble_1_ov_384   + dble_1_ov_48  * delta_p[0]  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        ShapeFunction<4>::coefficients( delta_p[0], coeffxp );
         
         delta_p[1] = ypn - ( double )idx_p[1];
-        delta2     = delta_p[1]*delta_p[1];
-        delta3     = delta2*delta_p[1];
-        delta4     = delta3*delta_p[1];
-        coeffyp[0] = dble_1_ov_384   - dble_1_ov_48  * delta_p[1]  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-        coeffyp[1] = dble_19_ov_96   - dble_11_ov_24 * delta_p[1]  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffyp[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-        coeffyp[3] = dble_19_ov_96   + dble_11_ov_24 * delta_p[1]  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffyp[4] = dble_1_ov_384   + dble_1_ov_48  * delta_p[1]  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        ShapeFunction<4>::coefficients( delta_p[1], coeffyp );
         
         delta_p[2] = zpn - ( double )idx_p[2];
-        delta2     = delta_p[2]*delta_p[2];
-        delta3     = delta2*delta_p[2];
-        delta4     = delta3*delta_p[2];
-        coeffzp[0] = dble_1_ov_384   - dble_1_ov_48  * delta_p[2]  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-        coeffzp[1] = dble_19_ov_96   - dble_11_ov_24 * delta_p[2]  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffzp[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-        coeffzp[3] = dble_19_ov_96   + dble_11_ov_24 * delta_p[2]  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-        coeffzp[4] = dble_1_ov_384   + dble_1_ov_48  * delta_p[2]  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        ShapeFunction<4>::coefficients( delta_p[2], coeffzp );
         
         // First index for summation
         idx_p[0]   = idx_p[0] - i_domain_begin;
@@ -107,34 +78,16 @@ private:
 
 
             delta    = xpn - ( double )idx_d[0] + 0.5;
-            delta2     = delta*delta;
-            delta3     = delta2*delta;
-            delta4     = delta3*delta;
-            coeffxd[0] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeffxd[1] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeffxd[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeffxd[3] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeffxd[4] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+            // coefficients for the 4th order interpolation on 5 nodes
+            ShapeFunction<4>::coefficients( delta, coeffxd );
 
             delta    = ypn - ( double )idx_d[1] + 0.5;
-            delta2     = delta*delta;
-            delta3     = delta2*delta;
-            delta4     = delta3*delta;
-            coeffyd[0] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeffyd[1] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeffyd[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeffyd[3] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeffyd[4] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+            // coefficients for the 4th order interpolation on 5 nodes
+            ShapeFunction<4>::coefficients( delta, coeffyd );
 
             delta    = zpn - ( double )idx_d[2] + 0.5;
-            delta2     = delta*delta;
-            delta3     = delta2*delta;
-            delta4     = delta3*delta;
-            coeffzd[0] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeffzd[1] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeffzd[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeffzd[3] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeffzd[4] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+            // coefficients for the 4th order interpolation on 5 nodes
+            ShapeFunction<4>::coefficients( delta, coeffzd );
 
             idx_d[0]   = idx_d[0] - i_domain_begin;
             idx_d[1]   = idx_d[1] - j_domain_begin;
@@ -143,17 +96,6 @@ private:
 
     }
     
-    double dble_1_ov_384 ;
-    double dble_1_ov_48 ;
-    double dble_1_ov_16 ;
-    double dble_1_ov_12 ;
-    double dble_1_ov_24 ;
-    double dble_19_ov_96 ;
-    double dble_11_ov_24 ;
-    double dble_1_ov_4 ;
-    double dble_1_ov_6 ;
-    double dble_115_ov_192 ;
-    double dble_5_ov_8 ;
 
 };//END class
 
@@ -19,18 +19,6 @@ Interpolator3D4OrderV::Interpolator3D4OrderV( Params &params, Patch *patch ) : I
     d_inv_[1] = 1.0/params.cell_length[1];
     d_inv_[2] = 1.0/params.cell_length[2];
 
-    //double defined for use in coefficients
-    dble_1_ov_384 = 1.0/384.0;
-    dble_1_ov_48 = 1.0/48.0;
-    dble_1_ov_16 = 1.0/16.0;
-    dble_1_ov_12 = 1.0/12.0;
-    dble_1_ov_24 = 1.0/24.0;
-    dble_19_ov_96 = 19.0/96.0;
-    dble_11_ov_24 = 11.0/24.0;
-    dble_1_ov_4 = 1.0/4.0;
-    dble_1_ov_6 = 1.0/6.0;
-    dble_115_ov_192 = 115.0/192.0;
-    dble_5_ov_8 = 5.0/8.0;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -56,6 +44,9 @@ void Interpolator3D4OrderV::fieldsWrapper( ElectroMagn *EMfields, Particles &par
     deltaO[1] = &( smpi->dynamics_deltaold[ithread][nparts] );
     deltaO[2] = &( smpi->dynamics_deltaold[ithread][2*nparts] );
 
+    // Shape coefficients of the old position reused by the projector (Vectorization.reuse_shape_coefficients)
+    double *shapeO = smpi->dynamics_shapeold.empty() ? nullptr : smpi->dynamics_shapeold[ithread].data();
+
     for( unsigned int k=0; k<3; k++ ) {
         Epart[k]= &( smpi->dynamics_Epart[ithread][k*nparts] );
         Bpart[k]= &( smpi->dynamics_Bpart[ithread][k*nparts] );
@@ -106,134 +97,26 @@ void Interpolator3D4OrderV::fieldsWrapper( ElectroMagn *EMfields, Particles &par
 
         #pragma omp simd
         for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            const int ipart_buffer = ipart-ipart_ref+ivect+istart[0];
+            deltaO[0][ipart_buffer] = primalDualCoefficients<4>( position_x[ipart+ivect+istart[0]]*d_inv_[0], idx[0],
+                                      &coeff[0][0][0][ipart], &coeff[0][1][0][ipart], 32, dual[0][ipart] );
+            deltaO[1][ipart_buffer] = primalDualCoefficients<4>( position_y[ipart+ivect+istart[0]]*d_inv_[1], idx[1],
+                                      &coeff[1][0][0][ipart], &coeff[1][1][0][ipart], 32, dual[1][ipart] );
+            deltaO[2][ipart_buffer] = primalDualCoefficients<4>( position_z[ipart+ivect+istart[0]]*d_inv_[2], idx[2],
+                                      &coeff[2][0][0][ipart], &coeff[2][1][0][ipart], 32, dual[2][ipart] );
+        }
 
-            double delta0, delta;
-            double delta2, delta3, delta4;
-
-            // i = 0
-
-            delta0 = position_x[ipart+ivect+istart[0]] *d_inv_[0];
-            dual [0][ipart] = ( delta0 - ( double )idx[0] >=0. );
-
-            // j = 0
-
-            delta   = delta0 - ( double )idx[0] ;
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[0][0][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[0][0][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][0][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[0][0][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][0][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            deltaO[0][ipart-ipart_ref+ivect+istart[0]] = delta;
-
-            // j = 1
-
-            delta   = delta0 - ( double )idx[0] + ( 0.5-dual[0][ipart] );
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[0][1][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[0][1][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][1][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[0][1][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[0][1][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            // i = 1
-
-            delta0 = position_y[ipart+ivect+istart[0]] *d_inv_[1];
-            dual [1][ipart] = ( delta0 - ( double )idx[1] >=0. );
-
-            // j = 0
-
-            delta   = delta0 - ( double )idx[1];
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[1][0][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[1][0][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][0][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[1][0][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][0][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            deltaO[1][ipart-ipart_ref+ivect+istart[0]] = delta;
-
-            // j = 1
-
-            delta   = delta0 - ( double )idx[1] + ( 0.5-dual[1][ipart] );
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[1][1][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[1][1][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][1][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[1][1][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[1][1][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            // i = 2
-
-            delta0 = position_z[ipart+ivect+istart[0]] *d_inv_[2];
-            dual [2][ipart] = ( delta0 - ( double )idx[2] >=0. );
-
-            // j = 0
-
-            delta   = delta0 - ( double )idx[2];
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[2][0][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[2][0][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[2][0][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[2][0][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[2][0][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            deltaO[2][ipart-ipart_ref+ivect+istart[0]] = delta;
-
-            // j = 1
-
-            delta   = delta0 - ( double )idx[2] + 1*( 0.5-dual[2][ipart] );
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[2][1][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[2][1][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[2][1][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[2][1][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[2][1][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-            // --------------------------------------
-            // The code above is the hand-unrollling of this loop
-            //
-            // for( int i=0; i<3; i++ ) { // for X/Y
-            //     delta0 = particles.position( i, ipart+ivect+istart[0] )*d_inv_[i];
-            //     dual [i][ipart] = ( delta0 - ( double )idx[i] >=0. );
-            //
-            //     for( int j=0; j<2; j++ ) { // for dual
-            //
-            //         delta   = delta0 - ( double )idx[i] + ( double )j*( 0.5-dual[i][ipart] );
-            //         delta2  = delta*delta;
-            //         delta3  = delta2*delta;
-            //         delta4  = delta3*delta;
-            //
-            //         coeff[i][j][0][ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            //         coeff[i][j][1][ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            //         coeff[i][j][2][ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            //         coeff[i][j][3][ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            //         coeff[i][j][4][ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            //
-            //         if( j==0 ) {
-            //             deltaO[i][ipart-ipart_ref+ivect+istart[0]] = delta;
-            //         }
-            //     }
-            // }
+        // Export the primal coefficients of the old position for the projector
+        if( shapeO ) {
+            for( int i=0; i<3; i++ ) {
+                for( int inode=0; inode<5; inode++ ) {
+                    double * __restrict__ row = &shapeO[( i*5+inode )*nparts + ivect+istart[0]-ipart_ref];
+                    #pragma omp simd
+                    for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                        row[ipart] = coeff[i][0][inode][ipart];
+                    }
+                }
+            }
         }
 
         double interp_res = 0;
@@ -603,27 +486,8 @@ void Interpolator3D4OrderV::fieldsAndCurrents( ElectroMagn *EMfields, Particles
     double coeff[3][2][5];
     int dual[3]; // Size ndim. Boolean indicating if the part has a dual indice equal to the primal one (dual=0) or if it is +1 (dual=1).
 
-    double delta0, delta;
-    double delta2, delta3, delta4;
-
     for( int i=0; i<3; i++ ) { // for X/Y
-        delta0 = particles.position( i, ipart )*d_inv_[i];
-        dual [i] = ( delta0 - ( double )idx[i] >=0. );
-
-        for( int j=0; j<2; j++ ) { // for dual
-
-            delta   = delta0 - ( double )idx[i] + ( double )j*( 0.5-dual[i] );
-            delta2  = delta*delta;
-            delta3  = delta2*delta;
-            delta4  = delta3*delta;
-
-            coeff[i][j][0] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            coeff[i][j][1] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[i][j][2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
-            coeff[i][j][3] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            coeff[i][j][4] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-
-        }
+        primalDualCoefficients<4>( particles.position( i, ipart )*d_inv_[i], idx[i], &coeff[i][0][0], &coeff[i][1][0], 1, dual[i] );
     }
 
     double *coeffyp = &( coeff[1][0][2] );
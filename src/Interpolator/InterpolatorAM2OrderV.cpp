@@ -13,6 +13,8 @@
 
 using namespace std;
 
+const int InterpolatorAM2OrderV::vecSize;
+
 
 // ---------------------------------------------------------------------------------------------------------------------
 // Creator for InterpolatorAM2OrderV
@@ -56,14 +58,24 @@ void InterpolatorAM2OrderV::fieldsWrapper( ElectroMagn *EMfields, Particles &par
 
     double coeff[2][2][3][32];
     double dual[2][32]; // Size ndim. Boolean converted into double indicating if the part has a dual indice equal to the primal one (dual=0) or if it is +1 (dual=1).
-    
-    int vecSize = 32;
-    double delta, delta2; 
+
+    // Weights of the nodes along l and r, independent of the mode: primal on 3 nodes,
+    // dual on 4 nodes (the dual shift of each particle is included)
+    double wlp[3*vecSize], wrp[3*vecSize];
+    double wld[4*vecSize], wrd[4*vecSize];
+
+    double delta, delta2;
 
    
     int cell_nparts( ( int )iend[0]-( int )istart[0] );
 
-    std::vector<complex<double>> exp_m_theta_( vecSize), exp_mm_theta( vecSize) ;                                                          //exp(-i theta), exp(-i m theta)
+    // exp(-i theta) and exp(-i m theta) for all the modes, real and imaginary parts apart
+    double exp_m_theta_re[vecSize], exp_m_theta_im[vecSize];
+    std::vector<double> exp_mm_theta( 2*nmodes_*vecSize );
+    double * __restrict__ exp_mm_theta_re = exp_mm_theta.data();
+    double * __restrict__ exp_mm_theta_im = exp_mm_theta.data() + nmodes_*vecSize;
+
+    ElectroMagnAM *emAM = static_cast<ElectroMagnAM *>( EMfields );
 
     //Loop on groups of vecSize particles
     for( int ivect=0 ; ivect < cell_nparts; ivect += vecSize ) {
@@ -79,9 +91,11 @@ void InterpolatorAM2OrderV::fieldsWrapper( ElectroMagn *EMfields, Particles &par
         
             int ipart2 = ipart+ivect+istart[0];
             double r = sqrt( position_y[ipart2]*position_y[ipart2] + position_z[ipart2]*position_z[ipart2] );
-            exp_m_theta_[ipart] = ( position_y[ipart2] - Icpx * position_z[ipart2] ) / r ;
-            exp_mm_theta[ipart] = 1. ;
-            eitheta_old[ipart] =  2.*std::real(exp_m_theta_[ipart]) - exp_m_theta_[ipart] ;  //exp(i theta)
+            exp_m_theta_re[ipart] =  position_y[ipart2] / r ;
+            exp_m_theta_im[ipart] = -position_z[ipart2] / r ;
+            eitheta_old[ipart] = std::complex<double>( exp_m_theta_re[ipart], -exp_m_theta_im[ipart] ) ;  //exp(i theta)
+            exp_mm_theta_re[ipart] = 1. ;
+            exp_mm_theta_im[ipart] = 0. ;
 
             // i= 0 ==> X
             //             j=0 primal
@@ -118,13 +132,35 @@ void InterpolatorAM2OrderV::fieldsWrapper( ElectroMagn *EMfields, Particles &par
             coeff[1][1][0][ipart]    =  0.5 * ( delta2-delta+0.25 );
             coeff[1][1][1][ipart]    = ( 0.75 - delta2 );
             coeff[1][1][2][ipart]    =  0.5 * ( delta2+delta+0.25 );
+
+            // Weights of the stencils, shared by all the modes
+            UNROLL_S(3)
+            for( int k=0 ; k<3 ; k++ ) {
+                wlp[k*vecSize+ipart] = coeff[0][0][k][ipart];
+                wrp[k*vecSize+ipart] = coeff[1][0][k][ipart];
+            }
+            wld[          ipart] = ( 1.-dual[0][ipart] )*coeff[0][1][0][ipart];
+            wld[  vecSize+ipart] = ( 1.-dual[0][ipart] )*coeff[0][1][1][ipart] + dual[0][ipart]*coeff[0][1][0][ipart];
+            wld[2*vecSize+ipart] = ( 1.-dual[0][ipart] )*coeff[0][1][2][ipart] + dual[0][ipart]*coeff[0][1][1][ipart];
+            wld[3*vecSize+ipart] =                                               dual[0][ipart]*coeff[0][1][2][ipart];
+            wrd[          ipart] = ( 1.-dual[1][ipart] )*coeff[1][1][0][ipart];
+            wrd[  vecSize+ipart] = ( 1.-dual[1][ipart] )*coeff[1][1][1][ipart] + dual[1][ipart]*coeff[1][1][0][ipart];
+            wrd[2*vecSize+ipart] = ( 1.-dual[1][ipart] )*coeff[1][1][2][ipart] + dual[1][ipart]*coeff[1][1][1][ipart];
+            wrd[3*vecSize+ipart] =                                               dual[1][ipart]*coeff[1][1][2][ipart];
         }
 
-        double interp_res;
-        double * __restrict__ coeffld = &( coeff[0][1][1][0] );
-        double * __restrict__ coefflp = &( coeff[0][0][1][0] );
-        double * __restrict__ coeffrp = &( coeff[1][0][1][0] );
-        double * __restrict__ coeffrd = &( coeff[1][1][1][0] );
+        // exp(-i m theta) by recurrence on the modes
+        for( unsigned int imode = 1; imode < nmodes_ ; imode++ ) {
+            const double * __restrict__ prev_re = &exp_mm_theta_re[( imode-1 )*vecSize];
+            const double * __restrict__ prev_im = &exp_mm_theta_im[( imode-1 )*vecSize];
+            double * __restrict__ e_re = &exp_mm_theta_re[imode*vecSize];
+            double * __restrict__ e_im = &exp_mm_theta_im[imode*vecSize];
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                e_re[ipart] = prev_re[ipart] * exp_m_theta_re[ipart] - prev_im[ipart] * exp_m_theta_im[ipart];
+                e_im[ipart] = prev_re[ipart] * exp_m_theta_im[ipart] + prev_im[ipart] * exp_m_theta_re[ipart];
+            }
+        }
 
         for( unsigned int k=0; k<3; k++ ) {
             Epart[k]= &( smpi->dynamics_Epart[ithread][k*nparts-ipart_ref+ivect+istart[0]] );
@@ -136,174 +172,35 @@ void InterpolatorAM2OrderV::fieldsWrapper( ElectroMagn *EMfields, Particles &par
             }
         }
 
-        // Local buffer to store the field components
-        std::complex<double> field_buffer[4][4];
-
         for( unsigned int imode = 0; imode < nmodes_ ; imode++ ) {
-            // Static cast of the electromagnetic fields
-            cField2D * __restrict__ El = ( static_cast<ElectroMagnAM *>( EMfields ) )->El_[imode];
-            cField2D * __restrict__ Er = ( static_cast<ElectroMagnAM *>( EMfields ) )->Er_[imode];
-            cField2D * __restrict__ Et = ( static_cast<ElectroMagnAM *>( EMfields ) )->Et_[imode];
-            cField2D * __restrict__ Bl = ( static_cast<ElectroMagnAM *>( EMfields ) )->Bl_m[imode];
-            cField2D * __restrict__ Br = ( static_cast<ElectroMagnAM *>( EMfields ) )->Br_m[imode];
-            cField2D * __restrict__ Bt = ( static_cast<ElectroMagnAM *>( EMfields ) )->Bt_m[imode];
-
-
-
-            // Field buffers for vectorization (required on A64FX)
-            for( int iloc=-1 ; iloc<3 ; iloc++ ) {
-                for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                    field_buffer[iloc+1][jloc+1] = ( *El )( idxO[0]+1+iloc, idxO[1]+1+jloc );
-                }
-            }
-
-            #pragma omp simd private(interp_res)
-            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-            
-                
-                //El(dual, primal)
-                interp_res = 0.;
-                UNROLL_S(3) 
-                for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-                    UNROLL_S(3) 
-                    for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                        interp_res += std::real( coeffld[ipart + iloc*32] * coeffrp[ipart + jloc*32] *
-                                      ( ( 1.-dual[0][ipart] )*field_buffer[1+iloc][1+jloc] 
-                                           + dual[0][ipart]  *field_buffer[2+iloc][1+jloc] ) 
-                                            * exp_mm_theta[ipart]) ; 
-                    }
-                }
-                Epart[0][ipart] += interp_res;
-           }
-
-           for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-               for( int jloc=-1 ; jloc<3 ; jloc++ ) {
-                   field_buffer[iloc+1][jloc+1] = ( *Er )( idxO[0]+1+iloc, idxO[1]+1+jloc );
-               }
-           }
-                
-           #pragma omp simd private(interp_res)
-           for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-               //Er(primal, dual)
-               interp_res = 0.;
-               UNROLL_S(3) 
-               for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-                   UNROLL_S(3) 
-                   for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                       interp_res +=  std::real (*( coefflp+ipart+iloc*32 ) * *( coeffrd+ipart+jloc*32 ) *
-                                     ( ( 1-dual[1][ipart] )*field_buffer[1+iloc][1+jloc] 
-                                         + dual[1][ipart]  *field_buffer[1+iloc][2+jloc] )
-                                           * exp_mm_theta[ipart]);
-                   }
-               }
-               Epart[1][ipart] += interp_res;
-           }
-                
-           for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-               for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                   field_buffer[iloc+1][jloc+1] = ( *Et )( idxO[0]+1+iloc, idxO[1]+1+jloc );
-               }
-           }
-                
-           #pragma omp simd private(interp_res)
-           for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-                //Et(primal, primal)
-                interp_res = 0.;
-                UNROLL_S(3) 
-                for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-                    UNROLL_S(3) 
-                    for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                        interp_res +=  std::real(  *( coefflp+ipart+iloc*32 ) * *( coeffrp+ipart+jloc*32 ) * 
-                                                    field_buffer[1+iloc][1+jloc]  
-                                                      * exp_mm_theta[ipart]);
-                    }
-                }
-                Epart[2][ipart] += interp_res;
-           }
-                
-           for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-               for( int jloc=-1 ; jloc<3 ; jloc++ ) {
-                   field_buffer[iloc+1][jloc+1] = ( *Bl )( idxO[0]+1+iloc, idxO[1]+1+jloc );
-               }
-           }
-
-           #pragma omp simd private(interp_res)
-           for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-                //Bl(primal, dual)
-                interp_res = 0.;
-                UNROLL_S(3) 
-                for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-                    UNROLL_S(3) 
-                    for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                        interp_res +=  std::real(  *( coefflp+ipart+iloc*32 ) * *( coeffrd+ipart+jloc*32 ) *
-                                      ( ( ( 1-dual[1][ipart] ) * field_buffer[1+iloc][1+jloc] 
-                                            + dual[1][ipart]   * field_buffer[1+iloc][2+jloc] )
-                                                )  * exp_mm_theta[ipart] );
-                    }
-                }
-                Bpart[0][ipart] += interp_res;
-           }
-                
-           for( int iloc=-1 ; iloc<3 ; iloc++ ) {
-               for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                   field_buffer[iloc+1][jloc+1] = ( *Br )( idxO[0]+1+iloc, idxO[1]+1+jloc );
-               }
-           }
-           #pragma omp simd private(interp_res)
-           for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-                //Br(dual, primal )
-                interp_res = 0.;
-                UNROLL_S(3) 
-                for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-                    UNROLL_S(3) 
-                    for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                        interp_res +=  std::real(  *( coeffld+ipart+iloc*32 ) * *( coeffrp+ipart+jloc*32 ) *
-                                      ( ( ( 1-dual[0][ipart] )* field_buffer[ 1+iloc][1+jloc ] 
-                                            + dual[0][ipart]  * field_buffer[ 2+iloc][1+jloc ] )
-                                                )  * exp_mm_theta[ipart]);
-                    }
-                }
-                Bpart[1][ipart] += interp_res;
-           }
-                
-           for( int iloc=-1 ; iloc<3 ; iloc++ ) {
-               for( int jloc=-1 ; jloc<3 ; jloc++ ) {
-                   field_buffer[iloc+1][jloc+1] = ( *Bt )( idxO[0]+1+iloc, idxO[1]+1+jloc );
-               }
-           }
-           #pragma omp simd private(interp_res)
-           for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-                //Bt(dual, dual)
-                interp_res = 0.;
-                UNROLL_S(3) 
-                for( int iloc=-1 ; iloc<2 ; iloc++ ) {
-                    UNROLL_S(3) 
-                    for( int jloc=-1 ; jloc<2 ; jloc++ ) {
-                        interp_res +=  std::real(  *( coeffld+ipart+iloc*32 ) * *( coeffrd+ipart+jloc*32 ) *
-                                      ( ( 1-dual[1][ipart] ) * ( ( 1-dual[0][ipart] )*field_buffer[1+iloc][1+jloc] 
-                                                                     + dual[0][ipart]*field_buffer[2+iloc][1+jloc] )
-                                        +    dual[1][ipart]  * ( ( 1-dual[0][ipart] )*field_buffer[1+iloc][2+jloc] 
-                                                                     + dual[0][ipart]*field_buffer[2+iloc][2+jloc] )
-                                                ) * exp_mm_theta[ipart] );
-                    }
-                }
-                Bpart[2][ipart] += interp_res;
-                exp_mm_theta[ipart] *= exp_m_theta_[ipart]; //prepare for next mode
-           }
-       } //end loop on modes
+            const double * __restrict__ e_re = &exp_mm_theta_re[imode*vecSize];
+            const double * __restrict__ e_im = &exp_mm_theta_im[imode*vecSize];
+
+            //El(dual, primal)
+            addMode<4,3>( emAM->El_[imode],  idxO[0], idxO[1], wld, wrp, e_re, e_im, Epart[0], np_computed );
+            //Er(primal, dual)
+            addMode<3,4>( emAM->Er_[imode],  idxO[0], idxO[1], wlp, wrd, e_re, e_im, Epart[1], np_computed );
+            //Et(primal, primal)
+            addMode<3,3>( emAM->Et_[imode],  idxO[0], idxO[1], wlp, wrp, e_re, e_im, Epart[2], np_computed );
+            //Bl(primal, dual)
+            addMode<3,4>( emAM->Bl_m[imode], idxO[0], idxO[1], wlp, wrd, e_re, e_im, Bpart[0], np_computed );
+            //Br(dual, primal )
+            addMode<4,3>( emAM->Br_m[imode], idxO[0], idxO[1], wld, wrp, e_re, e_im, Bpart[1], np_computed );
+            //Bt(dual, dual)
+            addMode<4,4>( emAM->Bt_m[imode], idxO[0], idxO[1], wld, wrd, e_re, e_im, Bpart[2], np_computed );
+        } //end loop on modes
 
         #pragma omp simd
         for( int ipart=0 ; ipart<np_computed; ipart++ ) {
             //Translate field into the cartesian y,z coordinates
-            double delta2 = std::real( exp_m_theta_[ipart] ) * Epart[1][ipart] + std::imag( exp_m_theta_[ipart] ) * Epart[2][ipart];
-            Epart[2][ipart] = -std::imag( exp_m_theta_[ipart] ) * Epart[1][ipart] + std::real( exp_m_theta_[ipart] ) * Epart[2][ipart];
+            double delta2 = exp_m_theta_re[ipart] * Epart[1][ipart] + exp_m_theta_im[ipart] * Epart[2][ipart];
+            Epart[2][ipart] = -exp_m_theta_im[ipart] * Epart[1][ipart] + exp_m_theta_re[ipart] * Epart[2][ipart];
             Epart[1][ipart] = delta2 ;
-            delta2 = std::real( exp_m_theta_[ipart] ) * Bpart[1][ipart] + std::imag( exp_m_theta_[ipart] ) * Bpart[2][ipart];
-            Bpart[2][ipart] = -std::imag( exp_m_theta_[ipart] ) * Bpart[1][ipart] + std::real( exp_m_theta_[ipart] ) * Bpart[2][ipart];
+            delta2 = exp_m_theta_re[ipart] * Bpart[1][ipart] + exp_m_theta_im[ipart] * Bpart[2][ipart];
+            Bpart[2][ipart] = -exp_m_theta_im[ipart] * Bpart[1][ipart] + exp_m_theta_re[ipart] * Bpart[2][ipart];
             Bpart[1][ipart] = delta2 ;
         }
 
 
     } //end loop on ivec
 }
-
@@ -34,6 +34,50 @@ private:
     //! Number of modes;
     unsigned int nmodes_;
     
+    //! Size of the groups of particles
+    static const int vecSize = 32;
+    
+    // ---------------------------------------------------------------------------------------------------------------------
+    //! Add the contribution of one mode of the field f to the particles of a group.
+    //! The stencil of nl x nr nodes starts at (i0, j0), it is common to all the particles of the cell.
+    //! The weights wl, wr (one row of vecSize per node) do not depend on the mode:
+    //! out += Re( exp(-i m theta) * sum wl*wr*f )
+    // ---------------------------------------------------------------------------------------------------------------------
+    template<int nl, int nr>
+    static inline void __attribute__((always_inline)) addMode( const cField2D *f, int i0, int j0,
+            const double * __restrict__ wl, const double * __restrict__ wr,
+            const double * __restrict__ e_re, const double * __restrict__ e_im,
+            double * __restrict__ out, int np_computed )
+    {
+        // Real and imaginary parts of the stencil, broadcast to all the particles
+        double f_re[nl][nr], f_im[nl][nr];
+        for( int a=0 ; a<nl ; a++ ) {
+            for( int b=0 ; b<nr ; b++ ) {
+                const std::complex<double> v = ( *f )( i0+a, j0+b );
+                f_re[a][b] = std::real( v );
+                f_im[a][b] = std::imag( v );
+            }
+        }
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            double s_re = 0.;
+            double s_im = 0.;
+            UNROLL_S(4)
+            for( int a=0 ; a<nl ; a++ ) {
+                double t_re = 0.;
+                double t_im = 0.;
+                UNROLL_S(4)
+                for( int b=0 ; b<nr ; b++ ) {
+                    t_re += wr[b*vecSize+ipart] * f_re[a][b];
+                    t_im += wr[b*vecSize+ipart] * f_im[a][b];
+                }
+                s_re += wl[a*vecSize+ipart] * t_re;
+                s_im += wl[a*vecSize+ipart] * t_im;
+            }
+            out[ipart] += e_re[ipart] * s_re - e_im[ipart] * s_im;
+        }
+    }
     
 };//END class
 
@@ -10,6 +10,9 @@
 #include "Particles.h"
 #include "Projector.h"
 
+//! Number of particles whose ionization rates are computed together (vectorized)
+#define SMILEI_IONIZATION_BUFFERSIZE 32
+
 
 //! Class Ionization: generic class allowing to define Ionization physics
 class Ionization
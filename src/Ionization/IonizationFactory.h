@@ -4,6 +4,7 @@
 #include "Ionization.h"
 #include "IonizationTunnel.h"
 #include "IonizationFromRate.h"
+#include "IonizationTabulated.h"
 #include "IonizationTunnelEnvelopeAveraged.h"
 
 #include "Params.h"
@@ -55,6 +56,15 @@ public:
             
             Ionize = new IonizationFromRate( params, species );
             
+        } else if( model == "tabulated" ) {
+            
+            unsigned int max_charge = species->ionization_rate_table_.empty() ? species->atomic_number_ : species->maximum_charge_state_;
+            if( species->max_charge_ > ( int )max_charge ) {
+                ERROR( "Charge > number of tabulated charge states for species " << species->name_ );
+            }
+            
+            Ionize = new IonizationTabulated( params, species );
+            
         }
         
         return Ionize;
@@ -0,0 +1,60 @@
+#include "IonizationTabulated.h"
+
+#include <cmath>
+#include <map>
+
+#include "Species.h"
+
+using namespace std;
+
+// Tables of each species of the MPI process (logarithm of the rates)
+static map<string, vector<double> > &tables()
+{
+    static map<string, vector<double> > tables;
+    return tables;
+}
+
+IonizationTabulated::IonizationTabulated( Params &params, Species *species ) : IonizationTunnel( params, species )
+{
+    DEBUG( "Creating the Tabulated Ionizaton class" );
+    
+    const vector<vector<double> > &user_table = species->ionization_rate_table_;
+    
+    // Without user table, the number of charge states is the atomic number
+    if( ! user_table.empty() ) {
+        atomic_number_ = user_table.size();
+        Potential.resize( atomic_number_, 0. );
+    }
+    
+    // Logarithmic axis of the field, converted to atomic units
+    rate_table_size_ = user_table.empty() ? species->ionization_table_size_ : user_table[0].size();
+    double log_min = log( species->ionization_table_field_range_[0] * EC_to_au );
+    double log_max = log( species->ionization_table_field_range_[1] * EC_to_au );
+    rate_table_log_min_ = log_min;
+    rate_table_inv_delta_ = ( rate_table_size_ - 1 ) / ( log_max - log_min );
+    
+    #pragma omp critical (ionization_rate_tables)
+    {
+        vector<double> &table = tables()[species->name_];
+        if( table.empty() ) {
+            table.resize( atomic_number_ * rate_table_size_ );
+            for( unsigned int Z=0; Z<atomic_number_; Z++ ) {
+                for( unsigned int i=0; i<rate_table_size_; i++ ) {
+                    double rate;
+                    if( user_table.empty() ) {
+                        double invE = exp( -log_min - i / rate_table_inv_delta_ );
+                        double delta = gamma_tunnel[Z]*invE;
+                        rate = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
+                    } else {
+                        rate = user_table[Z][i];
+                    }
+                    // Null rates are floored so that their logarithm remains finite
+                    table[Z*rate_table_size_ + i] = log( fmax( rate, 1e-300 ) );
+                }
+            }
+        }
+        rate_table_ = &table[0];
+    }
+    
+    DEBUG( "Finished Creating the Tabulated Ionizaton class" );
+}
@@ -0,0 +1,21 @@
+#ifndef IONIZATIONTABULATED_H
+#define IONIZATIONTABULATED_H
+
+#include <vector>
+
+#include "IonizationTunnel.h"
+
+//! Field ionization with rates tabulated versus the field magnitude, for each charge state.
+//! The tables are either computed from the ADK formula or provided by the user,
+//! and shared by all the patches of the MPI process.
+class IonizationTabulated : public IonizationTunnel
+{
+
+public:
+    //! Constructor for IonizationTabulated
+    IonizationTabulated( Params &params, Species *species );
+    
+};
+
+
+#endif
@@ -10,7 +10,11 @@ using namespace std;
 
 
 
-IonizationTunnel::IonizationTunnel( Params &params, Species *species ) : Ionization( params, species )
+IonizationTunnel::IonizationTunnel( Params &params, Species *species ) : Ionization( params, species ),
+    rate_table_( nullptr ),
+    rate_table_size_( 0 ),
+    rate_table_log_min_( 0. ),
+    rate_table_inv_delta_( 0. )
 {
     DEBUG( "Creating the Tunnel Ionizaton class" );
     
@@ -48,136 +52,183 @@ IonizationTunnel::IonizationTunnel( Params &params, Species *species ) : Ionizat
 
 
 
-void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min, unsigned int ipart_max, vector<double> *Epart, Patch *patch, Projector *Proj, int ipart_ref )
+void IonizationTunnel::ionizationEvents( Particles *particles, unsigned int ipart_start, unsigned int n, double *Ex, double *Ey, double *Ez, int ipart_ref, Random *rand,
+                                         double *IonizRate_tunnel, double *Dnom_tunnel, double *invE, unsigned int *k_times, double *TotalIonizPot )
 {
-
-    unsigned int Z, Zp1, newZ, k_times;
-    double TotalIonizPot, E, invE, factorJion, delta, ran_p, Mult, D_sum, P_sum, Pint_tunnel;
-    vector<double> IonizRate_tunnel( atomic_number_ ), Dnom_tunnel( atomic_number_ , 0.);
-    LocalFields Jion;
-    double factorJion_0 = au_to_mec2 * EC_to_au*EC_to_au * invdt;
+    unsigned int Z[SMILEI_IONIZATION_BUFFERSIZE];
+    bool active[SMILEI_IONIZATION_BUFFERSIZE];
+    double ran_p[SMILEI_IONIZATION_BUFFERSIZE], rate[SMILEI_IONIZATION_BUFFERSIZE];
     
-    int nparts = Epart->size()/3;
-    double *Ex = &( ( *Epart )[0*nparts] );
-    double *Ey = &( ( *Epart )[1*nparts] );
-    double *Ez = &( ( *Epart )[2*nparts] );
+    // Current charge state and absolute value of the electric field normalized in atomic units
+    // Fully-ionized ions and particles in a negligible field are skipped
+    #pragma omp simd
+    for( unsigned int i=0; i<n; i++ ) {
+        unsigned int ipart = ipart_start + i;
+        Z[i] = ( unsigned int )( particles->charge( ipart ) );
+        double E = EC_to_au * sqrt( Ex[ipart-ipart_ref] * Ex[ipart-ipart_ref]
+                                  + Ey[ipart-ipart_ref] * Ey[ipart-ipart_ref]
+                                  + Ez[ipart-ipart_ref] * Ez[ipart-ipart_ref] );
+        active[i] = Z[i] < atomic_number_ && E >= 1e-10;
+        invE[i] = 1. / fmax( E, 1e-10 );
+        k_times[i] = 0;
+        TotalIonizPot[i] = 0.;
+    }
     
-    for( unsigned int ipart=ipart_min ; ipart<ipart_max; ipart++ ) {
+    // Random numbers, drawn in the order of the particles
+    for( unsigned int i=0; i<n; i++ ) {
+        ran_p[i] = active[i] ? rand->uniform() : 0.;
+    }
     
-        // Current charge state of the ion
-        Z = ( unsigned int )( particles->charge( ipart ) );
-        
-        // If ion already fully ionized then skip
-        if( Z==atomic_number_ ) {
-            continue;
-        }
-        
-        // Absolute value of the electric field normalized in atomic units
-        E = EC_to_au * sqrt( (*( Ex+ipart-ipart_ref )) * (*( Ex+ipart-ipart_ref ))
-                             + (*( Ey+ipart-ipart_ref )) * (*( Ey+ipart-ipart_ref ))
-                             + (*( Ez+ipart-ipart_ref )) * (*( Ez+ipart-ipart_ref )) );
-        if( E<1e-10 ) {
+    // Ionization rate of the current charge state
+    #pragma omp simd
+    for( unsigned int i=0; i<n; i++ ) {
+        unsigned int z = active[i] ? Z[i] : 0;
+        rate[i] = ionizationRate( z, invE[i] );
+    }
+    
+    // --------------------------------
+    // Monte-Carlo routine
+    // --------------------------------
+    for( unsigned int i=0; i<n; i++ ) {
+        if( ! active[i] ) {
             continue;
         }
         
-        // --------------------------------
-        // Start of the Monte-Carlo routine
-        // --------------------------------
-        
-        invE = 1./E;
-        factorJion = factorJion_0 * invE*invE;
-        delta      = gamma_tunnel[Z]*invE;
-        ran_p = patch->rand_->uniform();
-        IonizRate_tunnel[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
-        
-        // Total ionization potential (used to compute the ionization current)
-        TotalIonizPot = 0.0;
-        
-        // k_times will give the nb of ionization events
-        k_times = 0;
-        Zp1=Z+1;
+        unsigned int Zi = Z[i], Zp1 = Zi+1;
+        double Pint_tunnel = exp( -rate[i]*dt ); // cummulative prob.
         
         if( Zp1 == atomic_number_ ) {
             // if ionization of the last electron: single ionization
             // -----------------------------------------------------
-            if( ran_p < 1.0 -exp( -IonizRate_tunnel[Z]*dt ) ) {
-                TotalIonizPot += Potential[Z];
-                k_times        = 1;
+            if( ran_p[i] < 1.0 - Pint_tunnel ) {
+                TotalIonizPot[i] = Potential[Zi];
+                k_times[i]       = 1;
             }
             
-        } else {
+        } else if( Pint_tunnel < ran_p[i] ) {
             // else : multiple ionization can occur in one time-step
             //        partial & final ionization are decoupled (see Nuter Phys. Plasmas)
             // -------------------------------------------------------------------------
             
             // initialization
-            Mult = 1.0;
-            Dnom_tunnel[0]=1.0;
-            Pint_tunnel = exp( -IonizRate_tunnel[Z]*dt ); // cummulative prob.
+            unsigned int k = 0;
+            double Mult = 1.0;
+            IonizRate_tunnel[Zi] = rate[i];
+            Dnom_tunnel[0] = 1.0;
+            for( unsigned int j=1; j<atomic_number_-Zi; j++ ) {
+                Dnom_tunnel[j] = 0.;
+            }
             
             //multiple ionization loop while Pint_tunnel < ran_p and still partial ionization
-            while( ( Pint_tunnel < ran_p ) and ( k_times < atomic_number_-Zp1 ) ) {
-                newZ = Zp1+k_times;
-                delta = gamma_tunnel[newZ]*invE;
-                IonizRate_tunnel[newZ] = beta_tunnel[newZ]
-                                         *                        exp( -delta*one_third+alpha_tunnel[newZ]*log( delta ) );
-                D_sum = 0.0;
-                P_sum = 0.0;
-                Mult  *= IonizRate_tunnel[Z+k_times];
-                for( unsigned int i=0; i<k_times+1; i++ ) {
-                    Dnom_tunnel[i]=Dnom_tunnel[i]/( IonizRate_tunnel[newZ]-IonizRate_tunnel[Z+i] );
-                    D_sum += Dnom_tunnel[i];
-                    P_sum += exp( -IonizRate_tunnel[Z+i]*dt )*Dnom_tunnel[i];
+            while( ( Pint_tunnel < ran_p[i] ) and ( k < atomic_number_-Zp1 ) ) {
+                unsigned int newZ = Zp1+k;
+                IonizRate_tunnel[newZ] = ionizationRate( newZ, invE[i] );
+                double D_sum = 0.0;
+                double P_sum = 0.0;
+                Mult *= IonizRate_tunnel[Zi+k];
+                for( unsigned int j=0; j<k+1; j++ ) {
+                    Dnom_tunnel[j] = Dnom_tunnel[j]/( IonizRate_tunnel[newZ]-IonizRate_tunnel[Zi+j] );
+                    D_sum += Dnom_tunnel[j];
+                    P_sum += exp( -IonizRate_tunnel[Zi+j]*dt )*Dnom_tunnel[j];
                 }
-                Dnom_tunnel[k_times+1] -= D_sum;
-                P_sum                   = P_sum + Dnom_tunnel[k_times+1]*exp( -IonizRate_tunnel[newZ]*dt );
-                Pint_tunnel             = Pint_tunnel + P_sum*Mult;
+                Dnom_tunnel[k+1] -= D_sum;
+                P_sum       = P_sum + Dnom_tunnel[k+1]*exp( -IonizRate_tunnel[newZ]*dt );
+                Pint_tunnel = Pint_tunnel + P_sum*Mult;
                 
-                TotalIonizPot += Potential[Z+k_times];
-                k_times++;
+                TotalIonizPot[i] += Potential[Zi+k];
+                k++;
             }//END while
             
             // final ionization (of last electron)
-            if( ( ( 1.0-Pint_tunnel )>ran_p ) && ( k_times==atomic_number_-Zp1 ) ) {
-                TotalIonizPot += Potential[atomic_number_-1];
-                k_times++;
+            if( ( ( 1.0-Pint_tunnel )>ran_p[i] ) && ( k==atomic_number_-Zp1 ) ) {
+                TotalIonizPot[i] += Potential[atomic_number_-1];
+                k++;
             }
+            k_times[i] = k;
         }//END Multiple ionization routine
+    }
+}
+
+
+void IonizationTunnel::createElectrons( Particles *particles, unsigned int ipart_start, unsigned int n, unsigned int *k_times, Particles &electrons, vector<short> &ion_charge )
+{
+    unsigned int n_new = 0;
+    for( unsigned int i=0; i<n; i++ ) {
+        n_new += k_times[i] != 0;
+    }
+    if( n_new == 0 ) {
+        return;
+    }
+    
+    // Creation of the new electrons
+    // (variable weights are used)
+    // -----------------------------
+    unsigned int idNew = electrons.size();
+    electrons.createParticles( n_new );
+    if( save_ion_charge_ ) {
+        ion_charge.resize( idNew + n_new );
+    }
+    for( unsigned int i=0; i<n; i++ ) {
+        if( k_times[i] == 0 ) {
+            continue;
+        }
+        unsigned int ipart = ipart_start + i;
+        for( unsigned int j=0; j<electrons.dimension(); j++ ) {
+            electrons.position( j, idNew ) = particles->position( j, ipart );
+        }
+        for( unsigned int j=0; j<3; j++ ) {
+            electrons.momentum( j, idNew ) = particles->momentum( j, ipart )*ionized_species_invmass;
+        }
+        electrons.weight( idNew ) = double( k_times[i] )*particles->weight( ipart );
+        electrons.charge( idNew ) = -1;
         
-        // Compute ionization current
-        if (patch->EMfields->Jx_ != NULL){  // For the moment ionization current is not accounted for in AM geometry
-            factorJion *= TotalIonizPot;
-            Jion.x = factorJion * *( Ex+ipart );
-            Jion.y = factorJion * *( Ey+ipart );
-            Jion.z = factorJion * *( Ez+ipart );
-            
-            Proj->ionizationCurrents( patch->EMfields->Jx_, patch->EMfields->Jy_, patch->EMfields->Jz_, *particles, ipart, Jion );
+        if( save_ion_charge_ ) {
+            ion_charge[idNew] = particles->charge( ipart );
         }
         
-        // Creation of the new electrons
-        // (variable weights are used)
-        // -----------------------------
+        // Increase the charge of the particle
+        particles->charge( ipart ) += k_times[i];
+        idNew++;
+    }
+}
 
-        if( k_times !=0 ) {
-            new_electrons.createParticle();
-            int idNew = new_electrons.size() - 1;
-            for( unsigned int i=0; i<new_electrons.dimension(); i++ ) {
-                new_electrons.position( i, idNew )=particles->position( i, ipart );
-            }
-            for( unsigned int i=0; i<3; i++ ) {
-                new_electrons.momentum( i, idNew ) = particles->momentum( i, ipart )*ionized_species_invmass;
-            }
-            new_electrons.weight( idNew )=double( k_times )*particles->weight( ipart );
-            new_electrons.charge( idNew )=-1;
-            
-            if( save_ion_charge_ ) {
-                ion_charge_.push_back( particles->charge( ipart ) );
+
+void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min, unsigned int ipart_max, vector<double> *Epart, Patch *patch, Projector *Proj, int ipart_ref )
+{
+    unsigned int k_times[SMILEI_IONIZATION_BUFFERSIZE];
+    double invE[SMILEI_IONIZATION_BUFFERSIZE], TotalIonizPot[SMILEI_IONIZATION_BUFFERSIZE];
+    vector<double> IonizRate_tunnel( atomic_number_ ), Dnom_tunnel( atomic_number_ );
+    LocalFields Jion;
+    double factorJion_0 = au_to_mec2 * EC_to_au*EC_to_au * invdt;
+    
+    int nparts = Epart->size()/3;
+    double *Ex = &( ( *Epart )[0*nparts] );
+    double *Ey = &( ( *Epart )[1*nparts] );
+    double *Ez = &( ( *Epart )[2*nparts] );
+    
+    for( unsigned int ipart_start=ipart_min ; ipart_start<ipart_max; ipart_start += SMILEI_IONIZATION_BUFFERSIZE ) {
+        unsigned int n = min( ipart_max - ipart_start, ( unsigned int ) SMILEI_IONIZATION_BUFFERSIZE );
+        
+        ionizationEvents( particles, ipart_start, n, Ex, Ey, Ez, ipart_ref, patch->rand_, &IonizRate_tunnel[0], &Dnom_tunnel[0], invE, k_times, TotalIonizPot );
+        
+        // Compute ionization current
+        if( patch->EMfields->Jx_ != NULL ) { // For the moment ionization current is not accounted for in AM geometry
+            for( unsigned int i=0; i<n; i++ ) {
+                if( k_times[i] == 0 ) {
+                    continue;
+                }
+                unsigned int ipart = ipart_start + i;
+                double factorJion = factorJion_0 * invE[i]*invE[i] * TotalIonizPot[i];
+                Jion.x = factorJion * *( Ex+ipart );
+                Jion.y = factorJion * *( Ey+ipart );
+                Jion.z = factorJion * *( Ez+ipart );
+                
+                Proj->ionizationCurrents( patch->EMfields->Jx_, patch->EMfields->Jy_, patch->EMfields->Jz_, *particles, ipart, Jion );
             }
-            
-            // Increase the charge of the particle
-            particles->charge( ipart ) += k_times;
         }
         
+        createElectrons( particles, ipart_start, n, k_times, new_electrons, ion_charge_ );
+        
     } // Loop on particles
 }
 
@@ -185,9 +236,8 @@ void IonizationTunnel::ionizationTunnelWithTasks( Particles *particles, unsigned
                                                   vector<double> *Epart, Patch *patch, Projector *Proj, int ibin, int bin_shift, 
                                                   double *b_Jx, double *b_Jy, double *b_Jz, int ipart_ref )
 {
-
-    unsigned int Z, Zp1, newZ, k_times;
-    double TotalIonizPot, E, invE, factorJion, delta, ran_p, Mult, D_sum, P_sum, Pint_tunnel;
+    unsigned int k_times[SMILEI_IONIZATION_BUFFERSIZE];
+    double invE[SMILEI_IONIZATION_BUFFERSIZE], TotalIonizPot[SMILEI_IONIZATION_BUFFERSIZE];
     vector<double> IonizRate_tunnel( atomic_number_ ), Dnom_tunnel( atomic_number_ );
     LocalFields Jion;
     double factorJion_0 = au_to_mec2 * EC_to_au*EC_to_au * invdt;
@@ -197,120 +247,28 @@ void IonizationTunnel::ionizationTunnelWithTasks( Particles *particles, unsigned
     double *Ey = &( ( *Epart )[1*nparts] );
     double *Ez = &( ( *Epart )[2*nparts] );
     
-    for( unsigned int ipart=ipart_min ; ipart<ipart_max; ipart++ ) {
-    
-        // Current charge state of the ion
-        Z = ( unsigned int )( particles->charge( ipart ) );
+    for( unsigned int ipart_start=ipart_min ; ipart_start<ipart_max; ipart_start += SMILEI_IONIZATION_BUFFERSIZE ) {
+        unsigned int n = min( ipart_max - ipart_start, ( unsigned int ) SMILEI_IONIZATION_BUFFERSIZE );
         
-        // If ion already fully ionized then skip
-        if( Z==atomic_number_ ) {
-            continue;
-        }
-        
-        // Absolute value of the electric field normalized in atomic units
-        E = EC_to_au * sqrt( (*( Ex+ipart-ipart_ref )) * (*( Ex+ipart-ipart_ref ))
-                             + (*( Ey+ipart-ipart_ref )) * (*( Ey+ipart-ipart_ref ))
-                             + (*( Ez+ipart-ipart_ref )) * (*( Ez+ipart-ipart_ref )) );
-        if( E<1e-10 ) {
-            continue;
-        }
-        
-        // --------------------------------
-        // Start of the Monte-Carlo routine
-        // --------------------------------
-        
-        invE = 1./E;
-        factorJion = factorJion_0 * invE*invE;
-        delta      = gamma_tunnel[Z]*invE;
-        ran_p = patch->rand_->uniform();
-        IonizRate_tunnel[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
+        ionizationEvents( particles, ipart_start, n, Ex, Ey, Ez, ipart_ref, patch->rand_, &IonizRate_tunnel[0], &Dnom_tunnel[0], invE, k_times, TotalIonizPot );
         
-        // Total ionization potential (used to compute the ionization current)
-        TotalIonizPot = 0.0;
-        
-        // k_times will give the nb of ionization events
-        k_times = 0;
-        Zp1=Z+1;
-        
-        if( Zp1 == atomic_number_ ) {
-            // if ionization of the last electron: single ionization
-            // -----------------------------------------------------
-            if( ran_p < 1.0 -exp( -IonizRate_tunnel[Z]*dt ) ) {
-                TotalIonizPot += Potential[Z];
-                k_times        = 1;
-            }
-        
-        } else {
-            // else : multiple ionization can occur in one time-step
-            //        partial & final ionization are decoupled (see Nuter Phys. Plasmas)
-            // -------------------------------------------------------------------------
-        
-            // initialization
-            Mult = 1.0;
-            Dnom_tunnel[0]=1.0;
-            Pint_tunnel = exp( -IonizRate_tunnel[Z]*dt ); // cummulative prob.
-        
-            //multiple ionization loop while Pint_tunnel < ran_p and still partial ionization
-            while( ( Pint_tunnel < ran_p ) and ( k_times < atomic_number_-Zp1 ) ) {
-                newZ = Zp1+k_times;
-                delta = gamma_tunnel[newZ]*invE;
-                IonizRate_tunnel[newZ] = beta_tunnel[newZ]
-                                         *                        exp( -delta*one_third+alpha_tunnel[newZ]*log( delta ) );
-                D_sum = 0.0;
-                P_sum = 0.0;
-                Mult  *= IonizRate_tunnel[Z+k_times];
-                for( unsigned int i=0; i<k_times+1; i++ ) {
-                    Dnom_tunnel[i]=Dnom_tunnel[i]/( IonizRate_tunnel[newZ]-IonizRate_tunnel[Z+i] );
-                    D_sum += Dnom_tunnel[i];
-                    P_sum += exp( -IonizRate_tunnel[Z+i]*dt )*Dnom_tunnel[i];
+        // Compute ionization current
+        if( b_Jx != NULL ) { // For the moment ionization current is not accounted for in AM geometry
+            for( unsigned int i=0; i<n; i++ ) {
+                if( k_times[i] == 0 ) {
+                    continue;
                 }
-                Dnom_tunnel[k_times+1] -= D_sum;
-                P_sum                   = P_sum + Dnom_tunnel[k_times+1]*exp( -IonizRate_tunnel[newZ]*dt );
-                Pint_tunnel             = Pint_tunnel + P_sum*Mult;
-        
-                TotalIonizPot += Potential[Z+k_times];
-                k_times++;
-            }//END while
-        
-            // final ionization (of last electron)
-            if( ( ( 1.0-Pint_tunnel )>ran_p ) && ( k_times==atomic_number_-Zp1 ) ) {
-                TotalIonizPot += Potential[atomic_number_-1];
-                k_times++;
+                unsigned int ipart = ipart_start + i;
+                double factorJion = factorJion_0 * invE[i]*invE[i] * TotalIonizPot[i];
+                Jion.x = factorJion * *( Ex+ipart );
+                Jion.y = factorJion * *( Ey+ipart );
+                Jion.z = factorJion * *( Ez+ipart );
+                
+                Proj->ionizationCurrentsForTasks( b_Jx, b_Jy, b_Jz, *particles, ipart, Jion, bin_shift );
             }
-        }//END Multiple ionization routine
-        
-        // Compute ionization current
-        if (b_Jx != NULL){  // For the moment ionization current is not accounted for in AM geometry
-            factorJion *= TotalIonizPot;
-            Jion.x = factorJion * *( Ex+ipart );
-            Jion.y = factorJion * *( Ey+ipart );
-            Jion.z = factorJion * *( Ez+ipart );
-        
-            Proj->ionizationCurrentsForTasks( b_Jx, b_Jy, b_Jz, *particles, ipart, Jion, bin_shift );
         }
         
-        // Creation of the new electrons
-        // (variable weights are used)
-        // -----------------------------
-        if( k_times !=0 ) {
-            new_electrons_per_bin[ibin].createParticle();
-            int idNew = new_electrons_per_bin[ibin].size() - 1;//cout<<"ibin "<<ibin<<"size "<<new_electrons_per_bin[ibin].size()<<"capacity "<<new_electrons_per_bin[ibin].capacity()<<"\n"<<endl;
-            for( unsigned int i=0; i<new_electrons_per_bin[ibin].dimension(); i++ ) {
-                new_electrons_per_bin[ibin].position( i, idNew )=particles->position( i, ipart );
-            }
-            for( unsigned int i=0; i<3; i++ ) {
-                new_electrons_per_bin[ibin].momentum( i, idNew ) = particles->momentum( i, ipart )*ionized_species_invmass;
-            }
-            new_electrons_per_bin[ibin].weight( idNew )=double( k_times )*particles->weight( ipart );
-            new_electrons_per_bin[ibin].charge( idNew )=-1;
-            
-            if( save_ion_charge_ ) {
-                ion_charge_per_bin_[ibin].push_back( particles->charge( ipart ) );
-            }
-            
-            // // Increase the charge of the particle
-            particles->charge( ipart ) += k_times;
-        }
+        createElectrons( particles, ipart_start, n, k_times, new_electrons_per_bin[ibin], ion_charge_per_bin_[ibin] );
         
     } // Loop on particles
 }
@@ -23,7 +23,41 @@ public:
     //! method for tunnel ionization with tasks
     void ionizationTunnelWithTasks( Particles *, unsigned int, unsigned int, std::vector<double> *, Patch *, Projector *, int, int, double *b_Jx, double *b_Jy, double *b_Jz, int ipart_ref = 0 ) override;
     
+protected:
+    //! Ionization rate of the charge state Z in a field of inverse magnitude invE (atomic units):
+    //! ADK formula, or interpolation of the tabulated logarithm of the rate
+    inline double ionizationRate( unsigned int Z, double invE )
+    {
+        if( ! rate_table_ ) {
+            double delta = gamma_tunnel[Z]*invE;
+            return beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
+        }
+        double x = ( -log( invE ) - rate_table_log_min_ ) * rate_table_inv_delta_;
+        x = fmin( fmax( x, 0. ), ( double )( rate_table_size_ - 1 ) );
+        unsigned int i = std::min( ( unsigned int ) x, rate_table_size_ - 2 );
+        double w = x - ( double ) i;
+        const double *t = &rate_table_[Z*rate_table_size_ + i];
+        return exp( t[0] + w * ( t[1] - t[0] ) );
+    };
+    
+    //! Logarithm of the rates tabulated for each charge state over log(|E|) (null for the ADK formula)
+    const double *rate_table_;
+    //! Number of points of the table for each charge state
+    unsigned int rate_table_size_;
+    //! log(|E|) of the first point of the table (atomic units) and inverse step
+    double rate_table_log_min_, rate_table_inv_delta_;
+    
 private:
+    //! Computes the number of ionizations k_times and the total ionization potential of the particles
+    //! ipart_start to ipart_start+n (n <= SMILEI_IONIZATION_BUFFERSIZE).
+    //! The rates of the current charge states are vectorized; the rare multiple ionizations are then treated one by one.
+    void ionizationEvents( Particles *, unsigned int ipart_start, unsigned int n, double *Ex, double *Ey, double *Ez, int ipart_ref, Random *,
+                           double *IonizRate_tunnel, double *Dnom_tunnel, double *invE, unsigned int *k_times, double *TotalIonizPot );
+    
+    //! Creates the electrons of the ionized particles of a buffer, all at once, at the end of new_electrons
+    void createElectrons( Particles *, unsigned int ipart_start, unsigned int n, unsigned int *k_times, Particles &electrons, std::vector<short> &ion_charge );
+    
+protected:
     unsigned int atomic_number_;
     std::vector<double> Potential;
     std::vector<double> Azimuthal_quantum_number;
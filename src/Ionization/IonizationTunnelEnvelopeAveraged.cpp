@@ -2,15 +2,26 @@
 #include "IonizationTables.h"
 
 #include <cmath>
+#include <map>
 
 #include "Particles.h"
 #include "Species.h"
 
 using namespace std;
 
+// Tables of the averaged rates of each species of the MPI process (logarithm of the rates)
+static map<string, vector<double> > &averagedRateTables()
+{
+    static map<string, vector<double> > tables;
+    return tables;
+}
 
 
-IonizationTunnelEnvelopeAveraged::IonizationTunnelEnvelopeAveraged( Params &params, Species *species ) : Ionization( params, species )
+IonizationTunnelEnvelopeAveraged::IonizationTunnelEnvelopeAveraged( Params &params, Species *species ) : Ionization( params, species ),
+    rate_table_( nullptr ),
+    rate_table_size_( 0 ),
+    rate_table_log_min_( 0. ),
+    rate_table_inv_delta_( 0. )
 {
     DEBUG( "Creating the Tunnel Envelope Ionizaton Averaged class" );
     
@@ -49,282 +60,253 @@ IonizationTunnelEnvelopeAveraged::IonizationTunnelEnvelopeAveraged( Params &para
     cos_phi             = cos(params.envelope_polarization_phi);
     sin_phi             = sin(params.envelope_polarization_phi);
     
+    // Averaged rates tabulated over a logarithmic axis of the field, converted to atomic units
+    if( ! species->ionization_table_field_range_.empty() ) {
+        rate_table_size_ = species->ionization_table_size_;
+        double log_min = log( species->ionization_table_field_range_[0] * EC_to_au );
+        double log_max = log( species->ionization_table_field_range_[1] * EC_to_au );
+        rate_table_log_min_ = log_min;
+        rate_table_inv_delta_ = ( rate_table_size_ - 1 ) / ( log_max - log_min );
+        
+        #pragma omp critical (ionization_rate_tables)
+        {
+            vector<double> &table = averagedRateTables()[species->name_];
+            if( table.empty() ) {
+                table.resize( atomic_number_ * rate_table_size_ );
+                for( unsigned int Z=0; Z<atomic_number_; Z++ ) {
+                    for( unsigned int i=0; i<rate_table_size_; i++ ) {
+                        double rate = averagedIonizationRate( Z, exp( -log_min - i / rate_table_inv_delta_ ) );
+                        // Null rates are floored so that their logarithm remains finite
+                        table[Z*rate_table_size_ + i] = log( fmax( rate, 1e-300 ) );
+                    }
+                }
+            }
+            rate_table_ = &table[0];
+        }
+    }
+    
     DEBUG( "Finished Creating the Tunnel Envelope Ionizaton Averaged class" );
     
 }
 
-void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles, unsigned int ipart_min, unsigned int ipart_max, std::vector<double> *Epart, std::vector<double> *EnvEabs_part, std::vector<double> *EnvExabs_part, std::vector<double> *Phipart, Patch *patch, Projector *, int ibin, int ipart_ref )
+void IonizationTunnelEnvelopeAveraged::ionizationEvents( Particles *particles, unsigned int ipart_start, unsigned int n, double *Ex, double *Ey, double *Ez,
+                                                         double *E_env, double *Ex_env, int ipart_ref, Random *rand,
+                                                         double *IonizRate_tunnel_envelope, double *Dnom_tunnel, double *E, unsigned int *k_times )
 {
-    unsigned int Z, Zp1, newZ, k_times;
-    double E, E_sq, EnvE_sq, Aabs, invE, delta, ran_p, Mult, D_sum, P_sum, Pint_tunnel;
-    double coeff_ellipticity_in_ionization_rate = 1.;
-    double p_perp; 
-    vector<double> IonizRate_tunnel_envelope( atomic_number_ ), Dnom_tunnel( atomic_number_ );
-    
+    unsigned int Z[SMILEI_IONIZATION_BUFFERSIZE];
+    bool active[SMILEI_IONIZATION_BUFFERSIZE];
+    double ran_p[SMILEI_IONIZATION_BUFFERSIZE], invE[SMILEI_IONIZATION_BUFFERSIZE], rate[SMILEI_IONIZATION_BUFFERSIZE];
     
-    int nparts = Epart->size()/3;
-    double *Ex      = &( ( *Epart )[0*nparts] );
-    double *Ey      = &( ( *Epart )[1*nparts] );
-    double *Ez      = &( ( *Epart )[2*nparts] );
-    double *E_env   = &( ( *EnvEabs_part )[0*nparts] );
-    double *Ex_env  = &( ( *EnvExabs_part )[0*nparts] );
-    double *Phi_env = &( ( *Phipart )[0*nparts] );
-    
-    for( unsigned int ipart=ipart_min ; ipart<ipart_max; ipart++ ) {
-    
-        // Current charge state of the ion
-        Z = ( unsigned int )( particles->charge( ipart ) );
-    
-        // If ion already fully ionized then skip
-        if( Z==atomic_number_ ) {
-            continue;
-        }
+    // Current charge state and effective electric field for ionization, normalized in atomic units:
+    // |E| = sqrt(|E_plasma|^2+|E_envelope|^2), with |E_envelope|^2 = |Env_E|^2 + |Env_Ex|^2
+    // Fully-ionized ions and particles in a negligible field are skipped
+    #pragma omp simd
+    for( unsigned int i=0; i<n; i++ ) {
+        unsigned int ipart = ipart_start + i;
+        Z[i] = ( unsigned int )( particles->charge( ipart ) );
+        double E_sq    = (EC_to_au * EC_to_au) * ( Ex[ipart-ipart_ref] * Ex[ipart-ipart_ref]
+                                                 + Ey[ipart-ipart_ref] * Ey[ipart-ipart_ref]
+                                                 + Ez[ipart-ipart_ref] * Ez[ipart-ipart_ref] );
+        double EnvE_sq = (EC_to_au * EC_to_au) * E_env[ipart-ipart_ref] * E_env[ipart-ipart_ref]
+                       + (EC_to_au * EC_to_au) * Ex_env[ipart-ipart_ref] * Ex_env[ipart-ipart_ref];
+        E[i] = sqrt( E_sq + EnvE_sq );
+        active[i] = Z[i] < atomic_number_ && E[i] >= 1e-10;
+        invE[i] = 1. / fmax( E[i], 1e-10 );
+        k_times[i] = 0;
+    }
     
+    // Random numbers, drawn in the order of the particles
+    for( unsigned int i=0; i<n; i++ ) {
+        ran_p[i] = active[i] ? rand->uniform() : 0.;
+    }
     
-        // Absolute value of the electric field |E_plasma| (from the plasma) normalized in atomic units
-        E_sq    = (EC_to_au * EC_to_au) * ( ( *( Ex+ipart-ipart_ref ) ) * ( *( Ex+ipart-ipart_ref ) )
-                                    + ( *( Ey+ipart-ipart_ref ) ) * ( *( Ey+ipart-ipart_ref ) )
-                                    + ( *( Ez+ipart-ipart_ref ) ) * ( *( Ez+ipart-ipart_ref ) ) );
-        // Laser envelope electric field normalized in atomic units, using both transverse and longitudinal components:
-        // |E_envelope|^2 = |Env_E|^2 + |Env_Ex|^2
-
-        EnvE_sq = (EC_to_au * EC_to_au) * ( *( E_env+ipart-ipart_ref )) * ( *( E_env+ipart-ipart_ref ) ) + (EC_to_au * EC_to_au) * 
-                   ( *( Ex_env+ipart-ipart_ref ) ) * ( *( Ex_env+ipart-ipart_ref ) );
-
-        // Effective electric field for ionization:
-        // |E| = sqrt(|E_plasma|^2+|E_envelope|^2)
-        E = sqrt(E_sq+EnvE_sq);
+    // Averaged ionization rate of the current charge state
+    #pragma omp simd
+    for( unsigned int i=0; i<n; i++ ) {
+        unsigned int z = active[i] ? Z[i] : 0;
+        rate[i] = averagedIonizationRate( z, invE[i] );
+    }
     
-        if( E<1e-10 ) {
+    // --------------------------------
+    // Monte-Carlo routine
+    // --------------------------------
+    for( unsigned int i=0; i<n; i++ ) {
+        if( ! active[i] ) {
             continue;
         }
-    
-        // --------------------------------
-        // Start of the Monte-Carlo routine
-        // --------------------------------
-    
-        invE = 1./E;
-        delta      = gamma_tunnel[Z]*invE; // 2*(2I_p)^{3/2}/E
-        ran_p = patch->rand_->uniform();
-        IonizRate_tunnel_envelope[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
-    
-        // Corrections on averaged ionization rate given by the polarization ellipticity  
-        if( ellipticity==0. ){ // linear polarization
-            coeff_ellipticity_in_ionization_rate = sqrt((3./M_PI)/delta*2.);
-        } else if( ellipticity==1. ){ // circular polarization
-            coeff_ellipticity_in_ionization_rate = 1.; // for circular polarization, the ionization rate is unchanged
-        }
-
-        IonizRate_tunnel_envelope[Z] = coeff_ellipticity_in_ionization_rate * IonizRate_tunnel_envelope[Z];
-    
-        // k_times will give the nb of ionization events
-        k_times = 0;
-        Zp1=Z+1;
-
+        
+        unsigned int Zi = Z[i], Zp1 = Zi+1;
+        double Pint_tunnel = exp( -rate[i]*dt ); // cummulative prob.
+        
         if( Zp1 == atomic_number_ ) {
             // if ionization of the last electron: single ionization
             // -----------------------------------------------------
-            if( ran_p < 1.0 -exp( -IonizRate_tunnel_envelope[Z]*dt ) ) {
-                k_times        = 1;
-                //Ip_times2_power_minus3ov4 = Ip_times2_to_minus3ov4[Z];
+            if( ran_p[i] < 1.0 - Pint_tunnel ) {
+                k_times[i] = 1;
             }
-    
-        } else {
+            
+        } else if( Pint_tunnel < ran_p[i] ) {
             // else : multiple ionization can occur in one time-step
             //        partial & final ionization are decoupled (see Nuter Phys. Plasmas)
             // -------------------------------------------------------------------------
-    
+            
             // initialization
-            Mult = 1.0;
-            Dnom_tunnel[0]=1.0;
-            Pint_tunnel = exp( -IonizRate_tunnel_envelope[Z]*dt ); // cummulative prob.
-    
+            unsigned int k = 0;
+            double Mult = 1.0;
+            IonizRate_tunnel_envelope[Zi] = rate[i];
+            Dnom_tunnel[0] = 1.0;
+            for( unsigned int j=1; j<atomic_number_-Zi; j++ ) {
+                Dnom_tunnel[j] = 0.;
+            }
+            
             //multiple ionization loop while Pint_tunnel < ran_p and still partial ionization
-            while( ( Pint_tunnel < ran_p ) and ( k_times < atomic_number_-Zp1 ) ) {
-                newZ = Zp1+k_times;
-                delta = gamma_tunnel[newZ]*invE;
-
-                // Corrections on averaged ionization rate given by the polarization ellipticity  
-                if( ellipticity==0. ){ // linear polarization
-                    //coeff_ellipticity_in_ionization_rate = sqrt((3./M_PI)/(gamma_tunnel[newZ-1]*invE)*2.);
-                    coeff_ellipticity_in_ionization_rate = sqrt((3./M_PI)/delta*2.);
-                } else if( ellipticity==1. ){ // circular polarization
-                    coeff_ellipticity_in_ionization_rate = 1.; // for circular polarization, the ionization rate is unchanged
-                }
-
-                IonizRate_tunnel_envelope[newZ] = coeff_ellipticity_in_ionization_rate * beta_tunnel[newZ]
-                                                  * exp( -delta*one_third+alpha_tunnel[newZ]*log( delta ) );
-
-                D_sum = 0.0;
-                P_sum = 0.0;
-                Mult  *= IonizRate_tunnel_envelope[Z+k_times];
-                for( unsigned int i=0; i<k_times+1; i++ ) {
-                    Dnom_tunnel[i]=Dnom_tunnel[i]/( IonizRate_tunnel_envelope[newZ]-IonizRate_tunnel_envelope[Z+i] );
-                    D_sum += Dnom_tunnel[i];
-                    P_sum += exp( -IonizRate_tunnel_envelope[Z+i]*dt )*Dnom_tunnel[i];
+            while( ( Pint_tunnel < ran_p[i] ) and ( k < atomic_number_-Zp1 ) ) {
+                unsigned int newZ = Zp1+k;
+                IonizRate_tunnel_envelope[newZ] = averagedIonizationRate( newZ, invE[i] );
+                double D_sum = 0.0;
+                double P_sum = 0.0;
+                Mult *= IonizRate_tunnel_envelope[Zi+k];
+                for( unsigned int j=0; j<k+1; j++ ) {
+                    Dnom_tunnel[j] = Dnom_tunnel[j]/( IonizRate_tunnel_envelope[newZ]-IonizRate_tunnel_envelope[Zi+j] );
+                    D_sum += Dnom_tunnel[j];
+                    P_sum += exp( -IonizRate_tunnel_envelope[Zi+j]*dt )*Dnom_tunnel[j];
                 }
-                Dnom_tunnel[k_times+1] -= D_sum;
-                P_sum                   = P_sum + Dnom_tunnel[k_times+1]*exp( -IonizRate_tunnel_envelope[newZ]*dt );
-                Pint_tunnel             = Pint_tunnel + P_sum*Mult;
-    
-                k_times++;
-           
-                //Ip_times2_power_minus3ov4 += Ip_times2_to_minus3ov4[newZ-1];
+                Dnom_tunnel[k+1] -= D_sum;
+                P_sum       = P_sum + Dnom_tunnel[k+1]*exp( -IonizRate_tunnel_envelope[newZ]*dt );
+                Pint_tunnel = Pint_tunnel + P_sum*Mult;
+                
+                k++;
             }//END while
-    
+            
             // final ionization (of last electron)
-            if( ( ( 1.0-Pint_tunnel )>ran_p ) && ( k_times==atomic_number_-Zp1 ) ) {
-                k_times++;
-                //Ip_times2_power_minus3ov4 += Ip_times2_to_minus3ov4[atomic_number_-1];
+            if( ( ( 1.0-Pint_tunnel )>ran_p[i] ) && ( k==atomic_number_-Zp1 ) ) {
+                k++;
             }
+            k_times[i] = k;
         }//END Multiple ionization routine
+    }
+}
+
+
+void IonizationTunnelEnvelopeAveraged::createElectrons( Particles *particles, unsigned int ipart_start, unsigned int n, unsigned int *k_times, double *E,
+                                                        double *Phi_env, int ipart_ref, Random *rand, Particles &electrons, vector<short> &ion_charge )
+{
+    // Each ionized level creates an electron
+    unsigned int n_new = 0;
+    for( unsigned int i=0; i<n; i++ ) {
+        n_new += k_times[i];
+    }
+    if( n_new == 0 ) {
+        return;
+    }
     
-        // ---- Ionization ion current cannot be computed with the envelope ionization model
-      
-        // ---- Creation of the new electrons
+    unsigned int idNew = electrons.size();
+    electrons.createParticles( n_new );
+    if( save_ion_charge_ ) {
+        ion_charge.resize( idNew + n_new );
+    }
+    for( unsigned int i=0; i<n; i++ ) {
+        if( k_times[i] == 0 ) {
+            continue;
+        }
+        unsigned int ipart = ipart_start + i;
+        unsigned int Z = ( unsigned int )( particles->charge( ipart ) );
         
-        if( k_times !=0 ) {
-            // loop on all the ionization levels that have been ionized for this ion:
-            // each level creates an electron
-            for( unsigned int ionized_level = 0; ionized_level < k_times ; ionized_level++){
-#ifndef _OMPTASKS
-                // Creation of electrons without tasks
-                SMILEI_UNUSED( ibin );
+        // envelope of the laser vector potential component along the polarization direction
+        double Aabs = sqrt( 2. * Phi_env[ipart-ipart_ref] );
+        
+        for( unsigned int ionized_level = 0; ionized_level < k_times[i]; ionized_level++ ) {
+            
+            // The new electron is in the same position of the atom where it originated from
+            for( unsigned int j=0; j<electrons.dimension(); j++ ) {
+                electrons.position( j, idNew ) = particles->position( j, ipart );
+            }
+            for( unsigned int j=0; j<3; j++ ) {
+                electrons.momentum( j, idNew ) = particles->momentum( j, ipart )*ionized_species_invmass;
+            }
+            
+            // ----  Initialise the momentum of the new electron
+            
+            if( ellipticity==0. ) { // linear polarization
                 
-                new_electrons.createParticle();
-                //new_electrons.initialize( new_electrons.size()+1, new_electrons.dimension() );
-                int idNew = new_electrons.size() - 1;
-
-                // The new electron is in the same position of the atom where it originated from
-                for( unsigned int i=0; i<new_electrons.dimension(); i++ ) {
-                    new_electrons.position( i, idNew )=particles->position( i, ipart );
-                }
-                for( unsigned int i=0; i<3; i++ ) {
-                    new_electrons.momentum( i, idNew ) = particles->momentum( i, ipart )*ionized_species_invmass;
-                }
-
-           
-                // ----  Initialise the momentum, weight and charge of the new electron
-
-                if (ellipticity==0.){ // linear polarization
-
-                    double rand_gaussian  = patch->rand_->normal();
-
-                    Aabs    = sqrt(2. * (*(Phi_env+ipart-ipart_ref))  ); // envelope of the laser vector potential component along the polarization direction
+                // recreate gaussian distribution with rms momentum spread for linear polarization, estimated by C.B. Schroeder
+                // C. B. Schroeder et al., Phys. Rev. ST Accel. Beams 17, 2014, first part of Eqs. 7,10
+                double p_perp = rand->normal() * Aabs * sqrt( 1.5*E[i] ) * Ip_times2_to_minus3ov4[Z+ionized_level];
                 
-                    // recreate gaussian distribution with rms momentum spread for linear polarization, estimated by C.B. Schroeder
-                    // C. B. Schroeder et al., Phys. Rev. ST Accel. Beams 17, 2014, first part of Eqs. 7,10
-                    double Ip_times2_power_minus3ov4 = Ip_times2_to_minus3ov4[Z+ionized_level];
-                    p_perp = rand_gaussian * Aabs * sqrt(1.5*E) * Ip_times2_power_minus3ov4;
-
-                    // add the transverse momentum p_perp to obtain a gaussian distribution
-                    // in the momentum in the polarization direction p_perp, following Schroeder's result
-                    new_electrons.momentum( 1, idNew ) += p_perp*cos_phi;
-                    new_electrons.momentum( 2, idNew ) += p_perp*sin_phi;
-
-                    // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 relation
-                    // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
-                    new_electrons.momentum( 0, idNew ) += Aabs*Aabs/4. + p_perp*p_perp/2.;
-
-                } else if (ellipticity==1.){ // circular polarization
-
-                    // extract a random angle between 0 and 2pi, and assign p_perp = eA
-                    double rand_times_2pi = patch->rand_->uniform_2pi(); // from uniform distribution between [0,2pi]
+                // add the transverse momentum p_perp to obtain a gaussian distribution
+                // in the momentum in the polarization direction p_perp, following Schroeder's result
+                electrons.momentum( 1, idNew ) += p_perp*cos_phi;
+                electrons.momentum( 2, idNew ) += p_perp*sin_phi;
                 
-                    Aabs    = sqrt(2. * (*(Phi_env+ipart-ipart_ref))  );
-
-                    p_perp = Aabs;   // in circular polarization it corresponds to a0/sqrt(2)
-                    new_electrons.momentum( 1, idNew ) += p_perp*cos(rand_times_2pi)/sqrt(2);
-                    new_electrons.momentum( 2, idNew ) += p_perp*sin(rand_times_2pi)/sqrt(2);
-     
-                    // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 result
-                    // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
-                    new_electrons.momentum( 0, idNew ) += Aabs*Aabs/2.;
-            
-                }
-
-                if( save_ion_charge_ ) {
-                    ion_charge_.push_back( particles->charge( ipart ) );
-                }
+                // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 relation
+                // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
+                electrons.momentum( 0, idNew ) += Aabs*Aabs/4. + p_perp*p_perp/2.;
                 
-                // weight and charge of the new electron
-                new_electrons.weight( idNew )= particles->weight( ipart );
-                new_electrons.charge( idNew )= -1;
-
-# else
-
-                // Creation of electrons with tasks
-
-                new_electrons_per_bin[ibin].createParticle();
-                //new_electrons.initialize( new_electrons.size()+1, new_electrons.dimension() );
-                int idNew = new_electrons_per_bin[ibin].size() - 1;
-
-                // The new electron is in the same position of the atom where it originated from
-                for( unsigned int i=0; i<new_electrons.dimension(); i++ ) {
-                    new_electrons_per_bin[ibin].position( i, idNew )=particles->position( i, ipart );
-                }
-                for( unsigned int i=0; i<3; i++ ) {
-                    new_electrons_per_bin[ibin].momentum( i, idNew ) = particles->momentum( i, ipart )*ionized_species_invmass;
-                }
-
-           
-                // ----  Initialise the momentum, weight and charge of the new electron
-
-                if (ellipticity==0.){ // linear polarization
-
-                    double rand_gaussian  = patch->rand_->normal();
-
-                    Aabs    = sqrt(2. * (*(Phi_env+ipart-ipart_ref))  ); // envelope of the laser vector potential component along the polarization direction
+            } else if( ellipticity==1. ) { // circular polarization
                 
-                    // recreate gaussian distribution with rms momentum spread for linear polarization, estimated by C.B. Schroeder
-                    // C. B. Schroeder et al., Phys. Rev. ST Accel. Beams 17, 2014, first part of Eqs. 7,10
-                    double Ip_times2_power_minus3ov4 = Ip_times2_to_minus3ov4[Z+ionized_level];
-                    p_perp = rand_gaussian * Aabs * sqrt(1.5*E) * Ip_times2_power_minus3ov4;
-
-                    // add the transverse momentum p_perp to obtain a gaussian distribution
-                    // in the momentum in the polarization direction p_perp, following Schroeder's result
-                    new_electrons_per_bin[ibin].momentum( 1, idNew ) += p_perp*cos_phi;
-                    new_electrons_per_bin[ibin].momentum( 2, idNew ) += p_perp*sin_phi;
-
-                    // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 relation
-                    // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
-                    new_electrons_per_bin[ibin].momentum( 0, idNew ) += Aabs*Aabs/4. + p_perp*p_perp/2.;
-
-                } else if (ellipticity==1.){ // circular polarization
-
-                    // extract a random angle between 0 and 2pi, and assign p_perp = eA
-                    double rand_times_2pi = patch->rand_->uniform_2pi(); // from uniform distribution between [0,2pi]
+                // extract a random angle between 0 and 2pi, and assign p_perp = eA
+                double rand_times_2pi = rand->uniform_2pi(); // from uniform distribution between [0,2pi]
                 
-                    Aabs    = sqrt(2. * (*(Phi_env+ipart-ipart_ref))  );
-
-                    p_perp = Aabs;   // in circular polarization it corresponds to a0/sqrt(2)
-                    new_electrons_per_bin[ibin].momentum( 1, idNew ) += p_perp*cos(rand_times_2pi)/sqrt(2);
-                    new_electrons_per_bin[ibin].momentum( 2, idNew ) += p_perp*sin(rand_times_2pi)/sqrt(2);
-     
-                    // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 result
-                    // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
-                    new_electrons_per_bin[ibin].momentum( 0, idNew ) += Aabs*Aabs/2.;
-            
-                }
-
-                if( save_ion_charge_ ) {
-                    ion_charge_per_bin_[ibin].push_back( particles->charge( ipart ) );
-                }
+                double p_perp = Aabs;   // in circular polarization it corresponds to a0/sqrt(2)
+                electrons.momentum( 1, idNew ) += p_perp*cos( rand_times_2pi )/sqrt( 2 );
+                electrons.momentum( 2, idNew ) += p_perp*sin( rand_times_2pi )/sqrt( 2 );
                 
-                // weight and charge of the new electron
-                new_electrons_per_bin[ibin].weight( idNew )=particles->weight( ipart );
-                new_electrons_per_bin[ibin].charge( idNew )=-1;
-
-#endif
+                // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 result
+                // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
+                electrons.momentum( 0, idNew ) += Aabs*Aabs/2.;
+                
+            }
+            
+            // weight and charge of the new electron
+            electrons.weight( idNew ) = particles->weight( ipart );
+            electrons.charge( idNew ) = -1;
+            
+            if( save_ion_charge_ ) {
+                ion_charge[idNew] = particles->charge( ipart );
+            }
+            idNew++;
+        }
+        
+        // Increase the charge of the ion particle
+        particles->charge( ipart ) += k_times[i];
+    }
+}
 
-            } // end loop on electrons to create
 
-            // Increase the charge of the ion particle
-            particles->charge( ipart ) += k_times;
-        } // end if electrons are created
+void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles, unsigned int ipart_min, unsigned int ipart_max, std::vector<double> *Epart, std::vector<double> *EnvEabs_part, std::vector<double> *EnvExabs_part, std::vector<double> *Phipart, Patch *patch, Projector *, int ibin, int ipart_ref )
+{
+    unsigned int k_times[SMILEI_IONIZATION_BUFFERSIZE];
+    double E[SMILEI_IONIZATION_BUFFERSIZE];
+    vector<double> IonizRate_tunnel_envelope( atomic_number_ ), Dnom_tunnel( atomic_number_ );
+    
+    int nparts = Epart->size()/3;
+    double *Ex      = &( ( *Epart )[0*nparts] );
+    double *Ey      = &( ( *Epart )[1*nparts] );
+    double *Ez      = &( ( *Epart )[2*nparts] );
+    double *E_env   = &( ( *EnvEabs_part )[0*nparts] );
+    double *Ex_env  = &( ( *EnvExabs_part )[0*nparts] );
+    double *Phi_env = &( ( *Phipart )[0*nparts] );
     
+#ifndef _OMPTASKS
+    // Creation of electrons without tasks
+    SMILEI_UNUSED( ibin );
+    Particles &electrons = new_electrons;
+    vector<short> &ion_charge = ion_charge_;
+#else
+    // Creation of electrons with tasks
+    Particles &electrons = new_electrons_per_bin[ibin];
+    vector<short> &ion_charge = ion_charge_per_bin_[ibin];
+#endif
     
+    for( unsigned int ipart_start=ipart_min ; ipart_start<ipart_max; ipart_start += SMILEI_IONIZATION_BUFFERSIZE ) {
+        unsigned int n = min( ipart_max - ipart_start, ( unsigned int ) SMILEI_IONIZATION_BUFFERSIZE );
+        
+        ionizationEvents( particles, ipart_start, n, Ex, Ey, Ez, E_env, Ex_env, ipart_ref, patch->rand_, &IonizRate_tunnel_envelope[0], &Dnom_tunnel[0], E, k_times );
+        
+        // ---- Ionization ion current cannot be computed with the envelope ionization model
+        
+        createElectrons( particles, ipart_start, n, k_times, E, Phi_env, ipart_ref, patch->rand_, electrons, ion_charge );
+        
     } // Loop on particles
-
+    
 }
-
@@ -25,6 +25,42 @@ public:
     double ellipticity,cos_phi,sin_phi;
 
 private:
+    //! Ionization rate of the charge state Z averaged over the laser period, in a field of inverse magnitude invE (atomic units):
+    //! ADK formula corrected by the polarization, or interpolation of the tabulated logarithm of the rate
+    inline double averagedIonizationRate( unsigned int Z, double invE )
+    {
+        if( ! rate_table_ ) {
+            double delta = gamma_tunnel[Z]*invE;
+            // Corrections on averaged ionization rate given by the polarization ellipticity (unchanged for circular polarization)
+            double coeff_ellipticity_in_ionization_rate = ellipticity==0. ? sqrt( ( 3./M_PI )/delta*2. ) : 1.;
+            return coeff_ellipticity_in_ionization_rate * ( beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) ) );
+        }
+        double x = ( -log( invE ) - rate_table_log_min_ ) * rate_table_inv_delta_;
+        x = fmin( fmax( x, 0. ), ( double )( rate_table_size_ - 1 ) );
+        unsigned int i = std::min( ( unsigned int ) x, rate_table_size_ - 2 );
+        double w = x - ( double ) i;
+        const double *t = &rate_table_[Z*rate_table_size_ + i];
+        return exp( t[0] + w * ( t[1] - t[0] ) );
+    };
+    
+    //! Computes the number of ionizations k_times of the particles ipart_start to ipart_start+n (n <= SMILEI_IONIZATION_BUFFERSIZE)
+    //! and their effective field E (atomic units). The rates of the current charge states are vectorized;
+    //! the rare multiple ionizations are then treated one by one.
+    void ionizationEvents( Particles *, unsigned int ipart_start, unsigned int n, double *Ex, double *Ey, double *Ez, double *E_env, double *Ex_env,
+                           int ipart_ref, Random *, double *IonizRate_tunnel, double *Dnom_tunnel, double *E, unsigned int *k_times );
+    
+    //! Creates the electrons of the ionized particles of a buffer (one per ionization level), all at once at the end of electrons,
+    //! with the drift momentum and the momentum spread given by the envelope
+    void createElectrons( Particles *, unsigned int ipart_start, unsigned int n, unsigned int *k_times, double *E, double *Phi_env, int ipart_ref,
+                          Random *, Particles &electrons, std::vector<short> &ion_charge );
+    
+    //! Logarithm of the averaged rates tabulated for each charge state over log(|E|) (null for the ADK formula)
+    const double *rate_table_;
+    //! Number of points of the table for each charge state
+    unsigned int rate_table_size_;
+    //! log(|E|) of the first point of the table (atomic units) and inverse step
+    double rate_table_log_min_, rate_table_inv_delta_;
+    
     unsigned int atomic_number_;
     std::vector<double> Potential;
     std::vector<double> Azimuthal_quantum_number;
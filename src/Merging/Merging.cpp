@@ -10,6 +10,9 @@
 
 #include "Merging.h"
 
+#include <algorithm>
+#include <cmath>
+
 // -----------------------------------------------------------------------------
 //! Constructor for Merging
 // input: simulation parameters & Species index
@@ -32,3 +35,35 @@ Merging::Merging( Species *species, Random * rand )
 Merging::~Merging()
 {
 }
+
+// -----------------------------------------------------------------------------
+//! Coarsening of the momentum discretization for the budget-driven merging.
+//! A packet of max_packet_size particles becomes 2 particles: the packets are
+//! enlarged to reach the requested reduction, and the number of momentum cells
+//! is reduced so that they contain on average at least one packet.
+//! \param number_of_particles number of particles of the cell
+//! \param target target number of particles of the cell
+//! \param dim momentum discretization in each direction
+//! \param max_packet_size maximum number of particles per packet
+// -----------------------------------------------------------------------------
+void Merging::applyTarget( unsigned int number_of_particles, unsigned int target,
+                           unsigned int dim[3], unsigned int &max_packet_size )
+{
+    if( target == 0 || number_of_particles <= target ) {
+        return;
+    }
+
+    // Packet size that gives the reduction number_of_particles -> target
+    max_packet_size = std::max( max_packet_size, ( 2*number_of_particles + target - 1 ) / target );
+    max_packet_size = std::min( max_packet_size, number_of_particles );
+
+    // Momentum cells with at least one packet on average
+    const double momentum_cells = ( double )dim[0] * dim[1] * dim[2];
+    const double max_momentum_cells = ( double )number_of_particles / max_packet_size;
+    if( momentum_cells > max_momentum_cells ) {
+        const double factor = std::cbrt( max_momentum_cells / momentum_cells );
+        for( unsigned int i = 0 ; i < 3 ; i++ ) {
+            dim[i] = std::max( 1u, ( unsigned int )( dim[i] * factor ) );
+        }
+    }
+}
@@ -34,17 +34,33 @@ public:
     //! \param smpi        MPI properties
     //! \param istart      Index of the first particle
     //! \param iend        Index of the last particle
+    //! \param rand        Random generator of this call (cells may be merged by different threads)
+    //! \param target      Target number of particles of the cell (0 if none)
     virtual void operator()(
         double mass,
         Particles &particles,
         std::vector <int> &mask,
         int istart,
         int iend,
-        int & count) = 0;
+        int & count,
+        Random * rand,
+        unsigned int target ) = 0;
+
+    //! Seed for the random generator of one call, drawn from the local generator
+    inline unsigned int seed()
+    {
+        return rand_->integer();
+    }
 
     // parameters _______________________________________________
 
 protected:
+
+    //! Coarsening of the momentum discretization and increase of the packet size
+    //! so that number_of_particles particles are reduced to about target particles
+    //! (no change if target is 0 or above number_of_particles)
+    void applyTarget( unsigned int number_of_particles, unsigned int target,
+                      unsigned int dim[3], unsigned int &max_packet_size );
     
     // Local rand generator
     Random * rand_;
@@ -62,6 +62,8 @@ MergingVranicCartesian::~MergingVranicCartesian()
 //! \param istart      Index of the first particle
 //! \param iend        Index of the last particle
 //! \param count       Final number of particles
+//! \param rand        Random generator of this call
+//! \param target      Target number of particles of the cell (0 if none)
 // ---------------------------------------------------------------------
 void MergingVranicCartesian::operator() (
         double mass,
@@ -69,7 +71,9 @@ void MergingVranicCartesian::operator() (
         std::vector <int> &mask,
         int istart,
         int iend,
-        int & count)
+        int & count,
+        Random * rand,
+        unsigned int target )
         //unsigned int &remaining_particles,
         //unsigned int &merged_particles)
 {
@@ -77,8 +81,8 @@ void MergingVranicCartesian::operator() (
     unsigned int number_of_particles = (unsigned int)(iend - istart);
 
     // First of all, we check that there is enought particles per cell
-    // to process the merging.
-    if (number_of_particles > min_particles_per_cell_) {
+    // to process the merging (and more than the target of the budget-driven merging).
+    if (number_of_particles > std::max(min_particles_per_cell_, target)) {
 
         // Momentum discretization
         unsigned int dim[3];
@@ -86,6 +90,10 @@ void MergingVranicCartesian::operator() (
             dim[i] = dimensions_[i];
         }
 
+        // Maximum packet size and discretization of the budget-driven merging
+        unsigned int max_packet_size = max_packet_size_;
+        applyTarget( number_of_particles, target, dim, max_packet_size );
+
         // Minima
         double momentum_min[3];
 
@@ -198,31 +206,35 @@ void MergingVranicCartesian::operator() (
         }
 
         // Computation of the maxima and minima for each direction
-        momentum_min[0] = momentum_x[istart];
-        momentum_max[0] = momentum_x[istart];
-
-        momentum_min[1] = momentum_y[istart];
-        momentum_max[1] = momentum_y[istart];
+        // (scalar reductions, so that the loop is vectorized by all compilers)
+        double mx_min = momentum_x[istart];
+        double mx_max = momentum_x[istart];
+        double my_min = momentum_y[istart];
+        double my_max = momentum_y[istart];
+        double mz_min = momentum_z[istart];
+        double mz_max = momentum_z[istart];
 
-        momentum_min[2] = momentum_z[istart];
-        momentum_max[2] = momentum_z[istart];
-
-#if __INTEL_COMPILER > 18000
         #pragma omp simd \
-        reduction(min:momentum_min)  \
-        reduction(max:momentum_max)
-#endif
+        reduction(min:mx_min) reduction(min:my_min) reduction(min:mz_min) \
+        reduction(max:mx_max) reduction(max:my_max) reduction(max:mz_max)
         for (ip=(unsigned int) (istart) ; ip < (unsigned int) (iend); ip++ ) {
-            momentum_min[0] = std::min(momentum_min[0],momentum_x[ip]);
-            momentum_max[0] = std::max(momentum_max[0],momentum_x[ip]);
+            mx_min = std::min(mx_min,momentum_x[ip]);
+            mx_max = std::max(mx_max,momentum_x[ip]);
 
-            momentum_min[1] = std::min(momentum_min[1],momentum_y[ip]);
-            momentum_max[1] = std::max(momentum_max[1],momentum_y[ip]);
+            my_min = std::min(my_min,momentum_y[ip]);
+            my_max = std::max(my_max,momentum_y[ip]);
 
-            momentum_min[2] = std::min(momentum_min[2],momentum_z[ip]);
-            momentum_max[2] = std::max(momentum_max[2],momentum_z[ip]);
+            mz_min = std::min(mz_min,momentum_z[ip]);
+            mz_max = std::max(mz_max,momentum_z[ip]);
         }
 
+        momentum_min[0] = mx_min;
+        momentum_max[0] = mx_max;
+        momentum_min[1] = my_min;
+        momentum_max[1] = my_max;
+        momentum_min[2] = mz_min;
+        momentum_max[2] = mz_max;
+
         // ---------------------------------------------------------------------
         // debugging
         // std::cerr << " momentum_min[0]: " << momentum_min[0]
@@ -275,7 +287,7 @@ void MergingVranicCartesian::operator() (
                     if (accumulation_correction_) {
                         momentum_delta[ip] = (momentum_max[ip] - momentum_min[ip]) / (dim[ip]-1);
                         //momentum_min[ip] -= 0.99*momentum_delta[ip]*Rand::uniform();
-                        momentum_min[ip] -= 0.99*momentum_delta[ip]*rand_->uniform();
+                        momentum_min[ip] -= 0.99*momentum_delta[ip]*rand->uniform();
                     } else {
                         momentum_delta[ip] = (momentum_max[ip] - momentum_min[ip]) / (dim[ip]);
                     }
@@ -285,7 +297,7 @@ void MergingVranicCartesian::operator() (
                 } else {
                     if (accumulation_correction_) {
                         //dim[ip] = int(dim[ip]*(1+Rand::uniform()));
-                        dim[ip] = int(dim[ip]*(1+rand_->uniform()));
+                        dim[ip] = int(dim[ip]*(1+rand->uniform()));
                     }
 
                     // if (ip == 1) {
@@ -536,10 +548,10 @@ void MergingVranicCartesian::operator() (
                     if (particles_per_momentum_cells[ic] >= min_packet_size_ ) {
 
                         // Computation of the number of particle packets to merge
-                        npack = particles_per_momentum_cells[ic]/max_packet_size_;
+                        npack = particles_per_momentum_cells[ic]/max_packet_size;
 
                         // Check if the rest is sufficient to add an additional smaller packet
-                        if (particles_per_momentum_cells[ic]%max_packet_size_ >= min_packet_size_) {
+                        if (particles_per_momentum_cells[ic]%max_packet_size >= min_packet_size_) {
                             npack += 1;
                         }
 
@@ -553,9 +565,9 @@ void MergingVranicCartesian::operator() (
                             total_energy = 0;
 
                             // First index of the packet
-                            ipr_min = ipack*max_packet_size_;
+                            ipr_min = ipack*max_packet_size;
                             // last index of the packet
-                            ipr_max = std::min((ipack+1)*max_packet_size_,particles_per_momentum_cells[ic]);
+                            ipr_max = std::min((ipack+1)*max_packet_size,particles_per_momentum_cells[ic]);
 
                             // _______________________________________________________________
 
@@ -59,6 +59,8 @@ MergingVranicSpherical::~MergingVranicSpherical()
 //! \param istart      Index of the first particle
 //! \param iend        Index of the last particle
 //! \param count       Final number of particles
+//! \param rand        Random generator of this call
+//! \param target      Target number of particles of the cell (0 if none)
 // ---------------------------------------------------------------------
 void MergingVranicSpherical::operator() (
         double mass,
@@ -66,7 +68,9 @@ void MergingVranicSpherical::operator() (
         std::vector <int> &mask,
         int istart,
         int iend,
-        int & count)
+        int & count,
+        Random * rand,
+        unsigned int target )
         //unsigned int &remaining_particles,
         //unsigned int &merged_particles)
 {
@@ -74,8 +78,8 @@ void MergingVranicSpherical::operator() (
     unsigned int number_of_particles = (unsigned int)(iend - istart);
 
     // First of all, we check that there is enought particles per cell
-    // to process the merging.
-    if (number_of_particles > min_particles_per_cell_) {
+    // to process the merging (and more than the target of the budget-driven merging).
+    if (number_of_particles > std::max(min_particles_per_cell_, target)) {
 
         // Momentum discretization
         // unsigned int dim[3];
@@ -83,10 +87,15 @@ void MergingVranicSpherical::operator() (
         //     dim[i] = dimensions_[i];
         // }
 
-        unsigned int mr_dim = dimensions_[0];
-        unsigned int theta_dim_ref = dimensions_[1];
+        // Maximum packet size and discretization of the budget-driven merging
+        unsigned int dim[3] = { dimensions_[0], dimensions_[1], dimensions_[2] };
+        unsigned int max_packet_size = max_packet_size_;
+        applyTarget( number_of_particles, target, dim, max_packet_size );
+
+        unsigned int mr_dim = dim[0];
+        unsigned int theta_dim_ref = dim[1];
         unsigned int theta_dim_min = 1;
-        unsigned int phi_dim = dimensions_[2];
+        unsigned int phi_dim = dim[2];
 //        std::vector <unsigned int> theta_dim(phi_dim,0);
         // unsigned int  * theta_dim = (unsigned int*) aligned_alloc(64, phi_dim*sizeof(unsigned int));
         unsigned int  * theta_dim = new unsigned int [phi_dim];
@@ -275,7 +284,7 @@ void MergingVranicSpherical::operator() (
                         mr_delta = (mr_interval) / (mr_dim-1);
                         // A bit of chaos to kill the accumulation effect
                         // mr_min -= 0.99*mr_delta*Rand::uniform();
-                        mr_min -= 0.99*mr_delta*rand_->uniform();
+                        mr_min -= 0.99*mr_delta*rand->uniform();
                         inv_mr_delta = 1./mr_delta;
                     } else {
                         mr_max += (mr_interval)*0.01;
@@ -303,7 +312,7 @@ void MergingVranicSpherical::operator() (
                     phi_delta = (phi_interval) / (phi_dim-1);
                     // A bit of chaos to kill the accumulation effect
                     // phi_min -= 0.99*phi_delta*Rand::uniform();
-                    phi_min -= 0.99*phi_delta*rand_->uniform();
+                    phi_min -= 0.99*phi_delta*rand->uniform();
                     inv_phi_delta = 1./phi_delta;
                 } else {
                     phi_max += (phi_interval)*0.01;
@@ -370,7 +379,7 @@ void MergingVranicSpherical::operator() (
                     theta_dim[phi_i]   = std::max((unsigned int)(round(theta_interval / theta_delta[phi_i])), theta_dim_min);
                     if (accumulation_correction_) {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]-1);
-                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand_->uniform();
+                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand->uniform();
                         theta_max[phi_i]   = theta_delta[phi_i]*theta_dim[phi_i] + theta_min[phi_i];
                     } else {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]);
@@ -383,7 +392,7 @@ void MergingVranicSpherical::operator() (
                     theta_dim[phi_i]   = theta_dim_min;
                     if (accumulation_correction_) {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]-1);
-                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand_->uniform();
+                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand->uniform();
                         theta_max[phi_i]   = theta_delta[phi_i]*theta_dim[phi_i] + theta_min[phi_i];
                     } else {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]);
@@ -664,10 +673,10 @@ void MergingVranicSpherical::operator() (
                     if (particles_per_momentum_cells[ic] >= min_packet_size_ ) {
 
                         // Computation of the number of particle packets to merge
-                        npack = particles_per_momentum_cells[ic]/max_packet_size_;
+                        npack = particles_per_momentum_cells[ic]/max_packet_size;
 
                         // Check if the rest is sufficient to add an additional smaller packet
-                        if (particles_per_momentum_cells[ic]%max_packet_size_ >= min_packet_size_) {
+                        if (particles_per_momentum_cells[ic]%max_packet_size >= min_packet_size_) {
                             npack += 1;
                         }
 
@@ -688,9 +697,9 @@ void MergingVranicSpherical::operator() (
                             //     phi = 0;
                             //
                             //     // First index of the packet
-                            //     ipr_min = ipack*max_packet_size_;
+                            //     ipr_min = ipack*max_packet_size;
                             //     // last index of the packet
-                            //     ipr_max = std::min((ipack+1)*max_packet_size_,particles_per_momentum_cells[ic]);
+                            //     ipr_max = std::min((ipack+1)*max_packet_size,particles_per_momentum_cells[ic]);
                             //
                             //     // Compute total weight, total momentum and total energy
                             //     // for photons
@@ -778,10 +787,10 @@ void MergingVranicSpherical::operator() (
                             double total_momentum_norm = 0;
 
                             // // First index of the packet
-                            ipr_min = ipack*max_packet_size_;
+                            ipr_min = ipack*max_packet_size;
                             // // last index of the packet
 
-                            ipr_max = std::min((ipack+1)*max_packet_size_,particles_per_momentum_cells[ic]);
+                            ipr_max = std::min((ipack+1)*max_packet_size,particles_per_momentum_cells[ic]);
 
                             // Compute total weight, total momentum and total energy
                             // for photons
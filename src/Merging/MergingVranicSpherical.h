@@ -42,6 +42,7 @@ public:
     //! \param istart      Index of the first particle
     //! \param iend        Index of the last particle
     //! \param count       Final number of particles
+    //! \param rand        Random generator of this call
     // ---------------------------------------------------------------------
     void operator()(
         double mass,
@@ -49,7 +50,9 @@ public:
         std::vector <int> &mask,
         int istart,
         int iend,
-        int & count) override;
+        int & count,
+        Random * rand,
+        unsigned int target ) override;
         //unsigned int &remaining_particles,
         //unsigned int &merged_particles);
 
@@ -13,6 +13,7 @@
 #include "Region.h"
 #include "DiagnosticProbes.h"
 #include "DiagnosticTrack.h"
+#include "DiagnosticFields.h"
 #include "Hilbert_functions.h"
 #include "PatchesFactory.h"
 #include <iostream>
@@ -38,6 +39,8 @@ SimWindow::SimWindow( Params &params )
     velocity_x = 1.;
     number_of_additional_shifts = 0;
     additional_shifts_time = 0.;
+    lazy_particle_creation_ = false;
+    recycle_patches_ = false;
     
 #ifdef _OPENMP
     max_threads = omp_get_max_threads();
@@ -58,6 +61,18 @@ SimWindow::SimWindow( Params &params )
         PyTools::extract( "velocity_x", velocity_x, "MovingWindow"  );
         PyTools::extract( "number_of_additional_shifts", number_of_additional_shifts, "MovingWindow"  );
         PyTools::extract( "additional_shifts_time", additional_shifts_time, "MovingWindow"  );
+        PyTools::extract( "lazy_particle_creation", lazy_particle_creation_, "MovingWindow"  );
+        PyTools::extract( "recycle_patches", recycle_patches_, "MovingWindow"  );
+        
+        if( lazy_particle_creation_ && ( params.gpu_computing || params.omptasks ) ) {
+            ERROR_NAMELIST( "MovingWindow.lazy_particle_creation is not compatible with GPU computing or OpenMP tasks",
+                            LINK_NAMELIST + std::string("#moving-window") );
+        }
+        if( recycle_patches_ && ( params.gpu_computing || params.is_spectral || params.geometry == "AMcylindrical" ) ) {
+            ERROR_NAMELIST( "MovingWindow.recycle_patches is not compatible with GPU computing, spectral solvers or AM geometry",
+                            LINK_NAMELIST + std::string("#moving-window") );
+        }
+        Field::recycling_ = recycle_patches_;
     }
     
     cell_length_x_   = params.cell_length[0];
@@ -79,6 +94,12 @@ SimWindow::SimWindow( Params &params )
             MESSAGE( 2, "number_of_additional_shifts : " << number_of_additional_shifts );
             MESSAGE( 2, "additional_shifts_time : " << additional_shifts_time );
         }
+        if( lazy_particle_creation_ ) {
+            MESSAGE( 2, "lazy particle creation in new patches" );
+        }
+        if( recycle_patches_ ) {
+            MESSAGE( 2, "patches leaving the window recycled as new patches" );
+        }
         params.hasWindow = true;
     } else {
         params.hasWindow = false;
@@ -88,6 +109,10 @@ SimWindow::SimWindow( Params &params )
 
 SimWindow::~SimWindow()
 {
+    for( unsigned int i=0 ; i<recycled_patches_.size() ; i++ ) {
+        delete recycled_patches_[i];
+    }
+    recycled_patches_.clear();
 }
 
 bool SimWindow::isMoving( double time_dual )
@@ -95,12 +120,130 @@ bool SimWindow::isMoving( double time_dual )
     return active && ( ( time_dual - time_start )*velocity_x > x_moved - number_of_additional_shifts*cell_length_x_*n_space_x_*(time_dual>additional_shifts_time) );
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Create the particles of a patch brought by the moving window, when their creation was deferred
+// The random generator of the patch is seeded with its Hilbert index: the result does not depend
+// on the thread which creates the particles
+// ---------------------------------------------------------------------------------------------------------------------
+void SimWindow::createPatchParticles( Patch *mypatch, Params &params )
+{
+    for( unsigned int ispec=0 ; ispec<mypatch->vecSpecies.size() ; ispec++ ) {
+        Species *spec = mypatch->vecSpecies[ispec];
+        
+        ParticleCreator particle_creator;
+        particle_creator.associate( spec );
+        
+        // Aera for particle creation
+        struct SubSpace init_space;
+        init_space.cell_index_[0] = 0;
+        init_space.cell_index_[1] = 0;
+        init_space.cell_index_[2] = 0;
+        init_space.box_size_[0]   = params.patch_size_[0];
+        init_space.box_size_[1]   = params.patch_size_[1];
+        init_space.box_size_[2]   = params.patch_size_[2];
+        
+        particle_creator.create( init_space, params, mypatch, 0 );
+        
+        // Sort and operators, as done by the shift for the other new patches
+        if( params.vectorization_mode == "on" ) {
+            spec->computeParticleCellKeys( params );
+            spec->sortParticles( params );
+        } else if( params.vectorization_mode == "adaptive_mixed_sort" ) {
+            spec->configuration( params, mypatch );
+        } else if( params.vectorization_mode == "adaptive" ) {
+            spec->computeParticleCellKeys( params );
+            spec->configuration( params, mypatch );
+            spec->sortParticles( params );
+        }
+        
+        // Energy injected by the window, summed over the patches by the scalar diagnostics
+        if( mypatch->isXmax() ) {
+            spec->nrj_mw_inj += spec->computeEnergy();
+        }
+    }
+    
+    mypatch->particles_pending_ = false;
+}
+
+void SimWindow::createPendingParticles( VectorPatch &vecPatches, Params &params )
+{
+    if( !lazy_particle_creation_ ) {
+        return;
+    }
+    for( unsigned int ipatch = 0 ; ipatch < vecPatches.size() ; ipatch++ ) {
+        if( vecPatches( ipatch )->particles_pending_ ) {
+            createPatchParticles( vecPatches( ipatch ), params );
+        }
+    }
+}
+
+void SimWindow::createPendingParticlesInParallel( VectorPatch &vecPatches, Params &params )
+{
+    if( !lazy_particle_creation_ ) {
+        return;
+    }
+    // The profiles of the particles are evaluated in python by all the threads: the master thread releases the GIL
+    SMILEI_PY_SAVE_MASTER_THREAD
+    #pragma omp for schedule(runtime)
+    for( unsigned int ipatch = 0 ; ipatch < vecPatches.size() ; ipatch++ ) {
+        if( vecPatches( ipatch )->particles_pending_ ) {
+            createPatchParticles( vecPatches( ipatch ), params );
+        }
+    }
+    SMILEI_PY_RESTORE_MASTER_THREAD
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// The fields of a recycled patch are deleted, but their arrays go to the pool of recycled arrays,
+// from which the fields of the next new patch are allocated
+// ---------------------------------------------------------------------------------------------------------------------
+void SimWindow::recycleFields( Patch *recycled )
+{
+    ElectroMagn *EMfields = recycled->EMfields;
+    std::vector<Field *> fields = EMfields->allFields;
+    fields.insert( fields.end(), EMfields->averaged_fields_.begin(), EMfields->averaged_fields_.end() );
+    fields.insert( fields.end(), EMfields->subcycled_currents_.begin(), EMfields->subcycled_currents_.end() );
+    for( unsigned int idiag=0 ; idiag<EMfields->allFields_avg.size() ; idiag++ ) {
+        fields.insert( fields.end(), EMfields->allFields_avg[idiag].begin(), EMfields->allFields_avg[idiag].end() );
+    }
+    for( unsigned int ifield=0 ; ifield<fields.size() ; ifield++ ) {
+        if( fields[ifield] && fields[ifield]->data_ ) {
+            fields[ifield]->recycle_data_ = true;
+        }
+    }
+    delete EMfields;
+    recycled->EMfields = NULL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// The new patch takes the particles of the recycled patch, emptied: their memory is already allocated
+// ---------------------------------------------------------------------------------------------------------------------
+void SimWindow::recycleParticles( Patch *recycled, Patch *mypatch )
+{
+    for( unsigned int ispec=0 ; ispec<mypatch->vecSpecies.size() ; ispec++ ) {
+        Species *spec = mypatch->vecSpecies[ispec];
+        std::swap( spec->particles, recycled->vecSpecies[ispec]->particles );
+        spec->particles->initialize( 0, *recycled->vecSpecies[ispec]->particles );
+        for( unsigned int ibin=0 ; ibin<spec->particles->first_index.size() ; ibin++ ) {
+            spec->particles->first_index[ibin] = 0;
+            spec->particles->last_index[ibin] = 0;
+        }
+    }
+}
+
 void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params, unsigned int itime, double time_dual, Region& region )
 {
     if( ! isMoving( time_dual ) && itime != additional_shifts_iteration ) {
         return;
     }
  
+    // New patches may read profiles from HDF5 files: without a thread-safe HDF5 library,
+    // the asynchronous writes of the fields diags must complete first
+    if( DiagnosticFields::anyAsynchronous() && ! DiagnosticFields::hdf5_threadsafe_ ) {
+        #pragma omp single
+        DiagnosticFields::waitAsynchronousWrites();
+    }
+    
     unsigned int h0;
     Patch *mypatch;
     
@@ -114,6 +257,27 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
     
     // Get thread number, put to 0 if no OpenMP
     const int my_thread = Tools::getOMPThreadNum();
+    
+    // With the lazy creation, the particles of the new patches are created in parallel at the beginning of the next iteration.
+    // The track diagnostics need the IDs of the new particles now: the creation is not deferred.
+    bool lazy = lazy_particle_creation_;
+    for( unsigned int idiag=0; idiag<vecPatches.localDiags.size(); idiag++ ) {
+        if( dynamic_cast<DiagnosticTrack *>( vecPatches.localDiags[idiag] ) ) {
+            lazy = false;
+        }
+    }
+    
+    // Patches left pending by a previous shift of the same iteration are completed before moving again
+    if( lazy_particle_creation_ ) {
+#ifndef _NO_MPI_TM
+        #pragma omp for schedule(runtime)
+#endif
+        for( unsigned int ipatch = 0 ; ipatch < nPatches ; ipatch++ ) {
+            if( vecPatches( ipatch )->particles_pending_ ) {
+                createPatchParticles( vecPatches( ipatch ), params );
+            }
+        }
+    }
 
 #ifdef _NO_MPI_TM
     #pragma omp master
@@ -215,9 +379,22 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
 #endif
         for( unsigned int thread = 0; thread < patch_to_be_created.size();  thread++ ) {
             for( unsigned int j = 0; j < patch_to_be_created[thread].size();  j++ ) {
+                // A patch left by the window at the last shift gives its fields to the new patch
+                Patch *recycled = NULL;
+                if( ! recycled_patches_.empty() ) {
+                    recycled = recycled_patches_.back();
+                    recycled_patches_.pop_back();
+                    recycleFields( recycled );
+                }
+                
                 //create patch without particle.
                 mypatch = PatchesFactory::clone( vecPatches( 0 ), params, smpi, vecPatches.domain_decomposition_, h0 + patch_to_be_created[thread][j], n_moved, false );
                 
+                if( recycled ) {
+                    recycleParticles( recycled, mypatch );
+                    delete recycled;
+                }
+                
                 // Do not receive Xmin condition
                 if( mypatch->isXmin() && mypatch->EMfields->emBoundCond[0] ) {
                     mypatch->EMfields->emBoundCond[0]->disableExternalFields();
@@ -260,6 +437,15 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
             }
         }
         
+        // Recycled patches and arrays not reused by this shift are freed
+        if( recycle_patches_ ) {
+            for( unsigned int i=0 ; i<recycled_patches_.size() ; i++ ) {
+                delete recycled_patches_[i];
+            }
+            recycled_patches_.clear();
+            Field::clearRecycledData();
+        }
+        
         //Wait for sends to be completed
         
 #ifndef _NO_MPI_TM
@@ -365,23 +551,28 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
                     
                     // If new particles are required
                     if( patch_particle_created[ithread][j] ) {
-                        vector<int> nbr_new_particles( nSpecies, 0 );
-                        for( unsigned int ispec=0 ; ispec<nSpecies ; ispec++ ) {
-                            ParticleCreator particle_creator;
-                            particle_creator.associate(mypatch->vecSpecies[ispec]);
-                            
-                            // Aera for particle creation
-                            struct SubSpace init_space;
-                            init_space.cell_index_[0] = 0;
-                            init_space.cell_index_[1] = 0;
-                            init_space.cell_index_[2] = 0;
-                            init_space.box_size_[0]   = params.patch_size_[0];
-                            init_space.box_size_[1]   = params.patch_size_[1];
-                            init_space.box_size_[2]   = params.patch_size_[2];
-                            
-			                nbr_new_particles[ispec] = particle_creator.create( init_space, params, mypatch, 0 );
-
-                        } // end loop nSpecies
+                        if( lazy ) {
+                            // Created in parallel at the beginning of the next iteration
+                            mypatch->particles_pending_ = true;
+                        } else {
+                            vector<int> nbr_new_particles( nSpecies, 0 );
+                            for( unsigned int ispec=0 ; ispec<nSpecies ; ispec++ ) {
+                                ParticleCreator particle_creator;
+                                particle_creator.associate(mypatch->vecSpecies[ispec]);
+                                
+                                // Aera for particle creation
+                                struct SubSpace init_space;
+                                init_space.cell_index_[0] = 0;
+                                init_space.cell_index_[1] = 0;
+                                init_space.cell_index_[2] = 0;
+                                init_space.box_size_[0]   = params.patch_size_[0];
+                                init_space.box_size_[1]   = params.patch_size_[1];
+                                init_space.box_size_[2]   = params.patch_size_[2];
+                                
+                                nbr_new_particles[ispec] = particle_creator.create( init_space, params, mypatch, 0 );
+                                
+                            } // end loop nSpecies
+                        }
 
 #if defined ( SMILEI_ACCELERATOR_GPU )
                         if( params.gpu_computing ) {
@@ -440,6 +631,11 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
                     // Current newly created patch
                     mypatch = vecPatches.patches_[patch_to_be_created[ithread][j]];
                     
+                    // Pending patches are sorted after the creation of their particles
+                    if( mypatch->particles_pending_ ) {
+                        continue;
+                    }
+                    
                     // If new particles are required
                         for( unsigned int ispec=0 ; ispec<nSpecies ; ispec++ ) {
                             mypatch->vecSpecies[ispec]->computeParticleCellKeys( params );
@@ -462,7 +658,9 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
                     mypatch = vecPatches.patches_[patch_to_be_created[ithread][j]];
                     
                     // If new particles are required
-                    if( patch_particle_created[ithread][j] ) {
+                    if( mypatch->particles_pending_ ) {
+                        // Configured after the creation of their particles
+                    } else if( patch_particle_created[ithread][j] ) {
                         for( unsigned int ispec=0 ; ispec<nSpecies ; ispec++ ) {
                             mypatch->vecSpecies[ispec]->configuration( params, mypatch );
                         }
@@ -496,7 +694,9 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
                     mypatch = vecPatches.patches_[patch_to_be_created[ithread][j]];
                     
                     // If new particles are required
-                    if( patch_particle_created[ithread][j] ) {
+                    if( mypatch->particles_pending_ ) {
+                        // Configured after the creation of their particles
+                    } else if( patch_particle_created[ithread][j] ) {
                         for( unsigned int ispec=0 ; ispec<nSpecies ; ispec++ ) {
                             mypatch->vecSpecies[ispec]->computeParticleCellKeys( params );
                             mypatch->vecSpecies[ispec]->configuration( params, mypatch );
@@ -584,7 +784,14 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
                 }
             }
             
-            delete  mypatch;
+            if( recycle_patches_ ) {
+#ifndef _NO_MPI_TM
+                #pragma omp critical
+#endif
+                recycled_patches_.push_back( mypatch );
+            } else {
+                delete  mypatch;
+            }
         }
         
         // Also account for new patches in scalars
@@ -626,17 +833,36 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
 #endif
 
     #pragma omp barrier
-    #pragma omp master
-    {
-        // for( unsigned int i=0; i<vecPatches.size(); i++ ){
-        //     MESSAGE(vecPatches(i)->vecSpecies[0]->getNrjOutMW());
-        // }
-        if (params.multiple_decomposition) {
-            if ( params.geometry != "AMcylindrical" )
-                operate(region, vecPatches, smpi, params, time_dual);
-            else {
-                operate(region, vecPatches, smpi, params, time_dual, params.nmodes);
+
+    // The fields of the region are shifted by all threads, while the master exchanges with the neighbouring
+    // regions the cells leaving and entering the region (all fields in one message)
+    if (params.multiple_decomposition) {
+        #pragma omp master
+        {
+            region_fields_.clear();
+            if ( params.geometry != "AMcylindrical" ) {
+                regionFields( region, params, region_fields_ );
+            } else {
+                regionFields( region, params, region_fields_, params.nmodes );
             }
+            region.patch_->initShiftFields_movewin( region_fields_, params.patch_size_[0] );
+        }
+        #pragma omp barrier
+
+        #pragma omp for schedule(dynamic)
+        for( unsigned int ifield = 0; ifield < region_fields_.size(); ifield++ ) {
+            region_fields_[ifield]->shift_x( params.patch_size_[0] );
+        }
+
+        #pragma omp master
+        {
+            region.patch_->finalizeShiftFields_movewin( region_fields_, params.patch_size_[0] );
+
+            //DoubleGrids::syncFieldsOnRegion( vecPatches, region, params, smpi );
+
+            region.patch_->EMfields->laserDisabled();
+            region.patch_->EMfields->emBoundCond[0]->apply(region.patch_->EMfields, time_dual, region.patch_);
+            region.patch_->EMfields->emBoundCond[1]->apply(region.patch_->EMfields, time_dual, region.patch_);
         }
     }
     #pragma omp barrier
@@ -652,145 +878,105 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
         }
         else {
             for (unsigned int imode = 0 ; imode < params.nmodes ; imode++  ) {
-                SyncVectorPatch::exchangeE( params, region.vecPatch_, imode, smpi );
-                SyncVectorPatch::exchangeB( params, region.vecPatch_, imode, smpi );
+                SyncVectorPatch::exchangeEB( params, region.vecPatch_, imode, smpi );
             }
         }
     }
 
 }
 
-void SimWindow::operate(Region& region,  VectorPatch&, SmileiMPI*, Params& params, double time_dual)
+void SimWindow::regionFields( Region& region, Params& params, std::vector<Field *> &fields )
 {
-    region.patch_->exchangeField_movewin( region.patch_->EMfields->Ex_, params.patch_size_[0] );
-    region.patch_->exchangeField_movewin( region.patch_->EMfields->Ey_, params.patch_size_[0] );
-    region.patch_->exchangeField_movewin( region.patch_->EMfields->Ez_, params.patch_size_[0] );
-    
-    if (region.patch_->EMfields->Bx_->data_!= region.patch_->EMfields->Bx_m->data_) {
-        region.patch_->exchangeField_movewin( region.patch_->EMfields->Bx_, params.patch_size_[0] );
-        region.patch_->exchangeField_movewin( region.patch_->EMfields->By_, params.patch_size_[0] );
-        region.patch_->exchangeField_movewin( region.patch_->EMfields->Bz_, params.patch_size_[0] );
+    ElectroMagn * region_fields = region.patch_->EMfields;
+
+    fields.push_back( region_fields->Ex_ );
+    fields.push_back( region_fields->Ey_ );
+    fields.push_back( region_fields->Ez_ );
+
+    if (region_fields->Bx_->data_!= region_fields->Bx_m->data_) {
+        fields.push_back( region_fields->Bx_ );
+        fields.push_back( region_fields->By_ );
+        fields.push_back( region_fields->Bz_ );
     }
-    
-    region.patch_->exchangeField_movewin( region.patch_->EMfields->Bx_m, params.patch_size_[0] );
-    region.patch_->exchangeField_movewin( region.patch_->EMfields->By_m, params.patch_size_[0] );
-    region.patch_->exchangeField_movewin( region.patch_->EMfields->Bz_m, params.patch_size_[0] );
+
+    fields.push_back( region_fields->Bx_m );
+    fields.push_back( region_fields->By_m );
+    fields.push_back( region_fields->Bz_m );
 
     if (params.is_spectral) {
-        region.patch_->exchangeField_movewin( region.patch_->EMfields->rho_, params.patch_size_[0] );
-        region.patch_->exchangeField_movewin( region.patch_->EMfields->rhoold_, params.patch_size_[0] );
+        fields.push_back( region_fields->rho_ );
+        fields.push_back( region_fields->rhoold_ );
     }
 
     for( unsigned int bcId=2; bcId<2*params.nDim_field; bcId++ ){
-        if( (dynamic_cast<ElectroMagnBC2D_PML *>( region.patch_->EMfields->emBoundCond[bcId] ) || dynamic_cast<ElectroMagnBC3D_PML *>( region.patch_->EMfields->emBoundCond[bcId] )) ){
-            if( dynamic_cast<ElectroMagnBC2D_PML *>( region.patch_->EMfields->emBoundCond[bcId] )){
-                ElectroMagnBC2D_PML *embc = static_cast<ElectroMagnBC2D_PML *>( region.patch_->EMfields->emBoundCond[bcId] );
-                exchangePML_movewin( region, embc, params.patch_size_[0] );
-            } else {
-                ElectroMagnBC3D_PML *embc = static_cast<ElectroMagnBC3D_PML *>( region.patch_->EMfields->emBoundCond[bcId] );
-                exchangePML_movewin( region, embc, params.patch_size_[0] );
-            }
+        if( dynamic_cast<ElectroMagnBC2D_PML *>( region_fields->emBoundCond[bcId] ) ) {
+            regionPMLFields( static_cast<ElectroMagnBC2D_PML *>( region_fields->emBoundCond[bcId] ), fields );
+        } else if( dynamic_cast<ElectroMagnBC3D_PML *>( region_fields->emBoundCond[bcId] ) ) {
+            regionPMLFields( static_cast<ElectroMagnBC3D_PML *>( region_fields->emBoundCond[bcId] ), fields );
         }
     }
-
-    //DoubleGrids::syncFieldsOnRegion( vecPatches, region, params, smpi );
-
-    region.patch_->EMfields->laserDisabled();
-    region.patch_->EMfields->emBoundCond[0]->apply(region.patch_->EMfields, time_dual, region.patch_);
-    region.patch_->EMfields->emBoundCond[1]->apply(region.patch_->EMfields, time_dual, region.patch_);
-    // External fields
-
-    //mypatch->EMfields->emBoundCond[1]->disableExternalFields();
-
-    // Deadlock if moving window & load balancing enabled
-    //     Recompute patch distribution does not change
-    //if (params.multiple_decomposition) {
-    //    region.reset_mapping();
-    //    region.identify_additional_patches( smpi, vecPatches, params );
-    //    region.identify_missing_patches( smpi, vecPatches, params );
-    //}
-
-
 }
 
 
-void SimWindow::operate(Region& region,  VectorPatch&, SmileiMPI*, Params& params, double time_dual, unsigned int nmodes)
+void SimWindow::regionFields( Region& region, Params& params, std::vector<Field *> &fields, unsigned int nmodes )
 {
     ElectroMagnAM * region_fields = static_cast<ElectroMagnAM *>( region.patch_->EMfields );
-   
+
     for (unsigned int imode = 0; imode < nmodes; imode++){
-        region.patch_->exchangeField_movewin( region_fields->El_[imode], params.patch_size_[0] );
-        region.patch_->exchangeField_movewin( region_fields->Er_[imode], params.patch_size_[0] );
-        region.patch_->exchangeField_movewin( region_fields->Et_[imode], params.patch_size_[0] );
-        
+        fields.push_back( region_fields->El_[imode] );
+        fields.push_back( region_fields->Er_[imode] );
+        fields.push_back( region_fields->Et_[imode] );
+
         if (region_fields->Bl_[imode]->cdata_!= region_fields->Bl_m[imode]->cdata_) {
-            region.patch_->exchangeField_movewin( region_fields->Bl_[imode], params.patch_size_[0] );
-            region.patch_->exchangeField_movewin( region_fields->Br_[imode], params.patch_size_[0] );
-            region.patch_->exchangeField_movewin( region_fields->Bt_[imode], params.patch_size_[0] );
+            fields.push_back( region_fields->Bl_[imode] );
+            fields.push_back( region_fields->Br_[imode] );
+            fields.push_back( region_fields->Bt_[imode] );
         }
 
-        region.patch_->exchangeField_movewin( region_fields->Bl_m[imode], params.patch_size_[0] );
-        region.patch_->exchangeField_movewin( region_fields->Br_m[imode], params.patch_size_[0] );
-        region.patch_->exchangeField_movewin( region_fields->Bt_m[imode], params.patch_size_[0] );
+        fields.push_back( region_fields->Bl_m[imode] );
+        fields.push_back( region_fields->Br_m[imode] );
+        fields.push_back( region_fields->Bt_m[imode] );
 
         if (params.is_spectral) {
-            region.patch_->exchangeField_movewin( region_fields->rho_AM_[imode], params.patch_size_[0] );
-            region.patch_->exchangeField_movewin( region_fields->rho_old_AM_[imode], params.patch_size_[0] );
+            fields.push_back( region_fields->rho_AM_[imode] );
+            fields.push_back( region_fields->rho_old_AM_[imode] );
         }
 
-        if( dynamic_cast<ElectroMagnBCAM_PML *>( region.patch_->EMfields->emBoundCond[3] )){
+        if( dynamic_cast<ElectroMagnBCAM_PML *>( region_fields->emBoundCond[3] )){
             ElectroMagnBCAM_PML *embc = static_cast<ElectroMagnBCAM_PML *>( region_fields->emBoundCond[3] );
             if (embc->Hl_[imode]) {
-                region.patch_->exchangeField_movewin( embc->Hl_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Hr_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Ht_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Bl_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Br_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Bt_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->El_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Er_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Et_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Dl_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Dr_[imode], params.patch_size_[0] );
-                region.patch_->exchangeField_movewin( embc->Dt_[imode], params.patch_size_[0] );
+                fields.push_back( embc->Hl_[imode] );
+                fields.push_back( embc->Hr_[imode] );
+                fields.push_back( embc->Ht_[imode] );
+                fields.push_back( embc->Bl_[imode] );
+                fields.push_back( embc->Br_[imode] );
+                fields.push_back( embc->Bt_[imode] );
+                fields.push_back( embc->El_[imode] );
+                fields.push_back( embc->Er_[imode] );
+                fields.push_back( embc->Et_[imode] );
+                fields.push_back( embc->Dl_[imode] );
+                fields.push_back( embc->Dr_[imode] );
+                fields.push_back( embc->Dt_[imode] );
             }
-
         }
     }
-
-    //DoubleGrids::syncFieldsOnRegion( vecPatches, region, params, smpi );
-
-    region_fields->laserDisabled();
-    region.patch_->EMfields->emBoundCond[0]->apply(region.patch_->EMfields, time_dual, region.patch_);
-    region.patch_->EMfields->emBoundCond[1]->apply(region.patch_->EMfields, time_dual, region.patch_);
-    // External fields
-
-    //mypatch->EMfields->emBoundCond[1]->disableExternalFields();
-
-    // Deadlock if moving window & load balancing enabled
-    //     Recompute patch distribution does not change
-    //if (params.multiple_decomposition) {
-    //    region.reset_mapping();
-    //    region.identify_additional_patches( smpi, vecPatches, params );
-    //    region.identify_missing_patches( smpi, vecPatches, params );
-    //}
 }
 
 template <typename Tpml>
-void  SimWindow::exchangePML_movewin( Region& region, Tpml embc, int clrw ) {
-                if (embc->Hx_) {
-                    region.patch_->exchangeField_movewin( embc->Hx_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Hy_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Hz_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Bx_, clrw );
-                    region.patch_->exchangeField_movewin( embc->By_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Bz_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Ex_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Ey_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Ez_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Dx_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Dy_, clrw );
-                    region.patch_->exchangeField_movewin( embc->Dz_, clrw );
-                }
+void  SimWindow::regionPMLFields( Tpml embc, std::vector<Field *> &fields ) {
+    if (embc->Hx_) {
+        fields.push_back( embc->Hx_ );
+        fields.push_back( embc->Hy_ );
+        fields.push_back( embc->Hz_ );
+        fields.push_back( embc->Bx_ );
+        fields.push_back( embc->By_ );
+        fields.push_back( embc->Bz_ );
+        fields.push_back( embc->Ex_ );
+        fields.push_back( embc->Ey_ );
+        fields.push_back( embc->Ez_ );
+        fields.push_back( embc->Dx_ );
+        fields.push_back( embc->Dy_ );
+        fields.push_back( embc->Dz_ );
+    }
 }
 
@@ -28,10 +28,27 @@ public:
 
     void shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &param, unsigned int itime, double time_dual, Region& region );
     
-    void operate( Region& region,  VectorPatch& vecPatches, SmileiMPI* smpi, Params& param, double time_dual );
-    void operate( Region& region,  VectorPatch& vecPatches, SmileiMPI* smpi, Params& param, double time_dual, unsigned int nmodes );
+    //! Fields of the region shifted by the moving window (cartesian geometries)
+    void regionFields( Region& region, Params& params, std::vector<Field *> &fields );
+    //! Fields of the region shifted by the moving window (AM geometry)
+    void regionFields( Region& region, Params& params, std::vector<Field *> &fields, unsigned int nmodes );
     template <typename Tpml>
-    void  exchangePML_movewin( Region& region, Tpml embc, int clrw );
+    void  regionPMLFields( Tpml embc, std::vector<Field *> &fields );
+
+    //! Create the particles of a new patch (all species), with the random generator of the patch
+    void createPatchParticles( Patch *mypatch, Params &params );
+
+    //! Create the particles of all the patches still pending (to be called by a single thread)
+    void createPendingParticles( VectorPatch &vecPatches, Params &params );
+
+    //! Create the particles of all the patches still pending, shared by the threads (to be called by all threads)
+    void createPendingParticlesInParallel( VectorPatch &vecPatches, Params &params );
+
+    //! Give the field arrays of a patch left by the window to the pool of recycled arrays
+    void recycleFields( Patch *recycled );
+
+    //! Give the particle memory of a patch left by the window to a new patch
+    void recycleParticles( Patch *recycled, Patch *mypatch );
 
     //! Tells whether there is a moving window or not
     inline bool isActive()
@@ -116,6 +133,14 @@ private:
     unsigned int additional_shifts_iteration;
     //! Number of additional moving window shifts
     unsigned int number_of_additional_shifts;
+    //! Defer the creation of the particles of new patches to the beginning of the next iteration
+    bool lazy_particle_creation_;
+    //! Reuse the patches left by the window for the new patches of the next shift
+    bool recycle_patches_;
+    //! Patches left by the window at the last shift, to be reused
+    std::vector<Patch *> recycled_patches_;
+    //! Fields of the region shifted at the current move
+    std::vector<Field *> region_fields_;
     
     
 };
@@ -206,47 +206,44 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
     // Photon id
     // uint64_t * id = &( particles.id(0));
 
-    // Reserve pair particles (else, pointer could become obsolete)
-    // double np = new_pair[0]->size();
-    // new_pair[0]->reserve( np + mBW_pair_creation_sampling_[0] * (iend - istart) );
-    // new_pair[1]->reserve( np + mBW_pair_creation_sampling_[1] * (iend - istart) );
+    // On CPU, the pair particles are reserved by buffers of photons (else, pointers could become obsolete), see below
 
     // Pair shortcut
-    double *const __restrict__ pair0_position_x = new_pair[0]->getPtrPosition( 0 );
-    double *const __restrict__ pair0_position_y = (n_dimensions_ > 1 ? new_pair[0]->getPtrPosition( 1 ) : nullptr) ;
-    double *const __restrict__ pair0_position_z = (n_dimensions_ > 2 ? new_pair[0]->getPtrPosition( 2 ) : nullptr) ;
+    double * __restrict__ pair0_position_x = new_pair[0]->getPtrPosition( 0 );
+    double * __restrict__ pair0_position_y = (n_dimensions_ > 1 ? new_pair[0]->getPtrPosition( 1 ) : nullptr) ;
+    double * __restrict__ pair0_position_z = (n_dimensions_ > 2 ? new_pair[0]->getPtrPosition( 2 ) : nullptr) ;
 
-    double *const __restrict__ pair0_position_old_x = particles.keepOldPositions() ? new_pair[0]->getPtrPositionOld( 0 ) : nullptr;
-    double *const __restrict__ pair0_position_old_y = (particles.Position_old.size() > 1 ? new_pair[0]->getPtrPositionOld( 1 ) : nullptr) ;
-    double *const __restrict__ pair0_position_old_z = (particles.Position_old.size() > 2 ? new_pair[0]->getPtrPositionOld( 2 ) : nullptr) ;
+    double * __restrict__ pair0_position_old_x = particles.keepOldPositions() ? new_pair[0]->getPtrPositionOld( 0 ) : nullptr;
+    double * __restrict__ pair0_position_old_y = (particles.Position_old.size() > 1 ? new_pair[0]->getPtrPositionOld( 1 ) : nullptr) ;
+    double * __restrict__ pair0_position_old_z = (particles.Position_old.size() > 2 ? new_pair[0]->getPtrPositionOld( 2 ) : nullptr) ;
 
-    double *const __restrict__ pair0_momentum_x = new_pair[0]->getPtrMomentum( 0 );
-    double *const __restrict__ pair0_momentum_y = new_pair[0]->getPtrMomentum( 1 );
-    double *const __restrict__ pair0_momentum_z = new_pair[0]->getPtrMomentum( 2 );
+    double * __restrict__ pair0_momentum_x = new_pair[0]->getPtrMomentum( 0 );
+    double * __restrict__ pair0_momentum_y = new_pair[0]->getPtrMomentum( 1 );
+    double * __restrict__ pair0_momentum_z = new_pair[0]->getPtrMomentum( 2 );
 
-    double *const __restrict__ pair0_weight = new_pair[0]->getPtrWeight();
-    short *const __restrict__ pair0_charge = new_pair[0]->getPtrCharge();
+    double * __restrict__ pair0_weight = new_pair[0]->getPtrWeight();
+    short * __restrict__ pair0_charge = new_pair[0]->getPtrCharge();
 
-    double *const __restrict__ pair0_chi = new_pair[0]->has_quantum_parameter ? new_pair[0]->getPtrChi() : nullptr;
-    double *const __restrict__ pair0_tau = new_pair[0]->has_Monte_Carlo_process ? new_pair[0]->getPtrTau() : nullptr;
+    double * __restrict__ pair0_chi = new_pair[0]->has_quantum_parameter ? new_pair[0]->getPtrChi() : nullptr;
+    double * __restrict__ pair0_tau = new_pair[0]->has_Monte_Carlo_process ? new_pair[0]->getPtrTau() : nullptr;
 
-    double *const __restrict__ pair1_position_x = new_pair[1]->getPtrPosition( 0 );
-    double *const __restrict__ pair1_position_y = (n_dimensions_ > 1 ? new_pair[1]->getPtrPosition( 1 ) : nullptr);
-    double *const __restrict__ pair1_position_z = (n_dimensions_ > 2 ? new_pair[1]->getPtrPosition( 2 ) : nullptr);
+    double * __restrict__ pair1_position_x = new_pair[1]->getPtrPosition( 0 );
+    double * __restrict__ pair1_position_y = (n_dimensions_ > 1 ? new_pair[1]->getPtrPosition( 1 ) : nullptr);
+    double * __restrict__ pair1_position_z = (n_dimensions_ > 2 ? new_pair[1]->getPtrPosition( 2 ) : nullptr);
 
-    double *const __restrict__ pair1_position_old_x = particles.keepOldPositions() ? new_pair[1]->getPtrPositionOld( 0 ) : nullptr;
-    double *const __restrict__ pair1_position_old_y = (particles.Position_old.size() > 1 ? new_pair[1]->getPtrPositionOld( 1 ) : nullptr) ;
-    double *const __restrict__ pair1_position_old_z = (particles.Position_old.size() > 2 ? new_pair[1]->getPtrPositionOld( 2 ) : nullptr) ;
+    double * __restrict__ pair1_position_old_x = particles.keepOldPositions() ? new_pair[1]->getPtrPositionOld( 0 ) : nullptr;
+    double * __restrict__ pair1_position_old_y = (particles.Position_old.size() > 1 ? new_pair[1]->getPtrPositionOld( 1 ) : nullptr) ;
+    double * __restrict__ pair1_position_old_z = (particles.Position_old.size() > 2 ? new_pair[1]->getPtrPositionOld( 2 ) : nullptr) ;
 
-    double *const __restrict__ pair1_momentum_x = new_pair[1]->getPtrMomentum( 0 );
-    double *const __restrict__ pair1_momentum_y = new_pair[1]->getPtrMomentum( 1 );
-    double *const __restrict__ pair1_momentum_z = new_pair[1]->getPtrMomentum( 2 );
+    double * __restrict__ pair1_momentum_x = new_pair[1]->getPtrMomentum( 0 );
+    double * __restrict__ pair1_momentum_y = new_pair[1]->getPtrMomentum( 1 );
+    double * __restrict__ pair1_momentum_z = new_pair[1]->getPtrMomentum( 2 );
 
-    double *const __restrict__ pair1_weight = new_pair[1]->getPtrWeight();
-    short *const __restrict__ pair1_charge = new_pair[1]->getPtrCharge();
+    double * __restrict__ pair1_weight = new_pair[1]->getPtrWeight();
+    short * __restrict__ pair1_charge = new_pair[1]->getPtrCharge();
 
-    double *const __restrict__ pair1_chi = new_pair[1]->has_quantum_parameter ? new_pair[1]->getPtrChi() : nullptr;
-    double *const __restrict__ pair1_tau = new_pair[1]->has_Monte_Carlo_process ? new_pair[1]->getPtrTau() : nullptr;
+    double * __restrict__ pair1_chi = new_pair[1]->has_quantum_parameter ? new_pair[1]->getPtrChi() : nullptr;
+    double * __restrict__ pair1_tau = new_pair[1]->has_Monte_Carlo_process ? new_pair[1]->getPtrTau() : nullptr;
 
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
     // Parameters for random generator
@@ -329,9 +326,92 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
                                 
     }
 
-    // 2. Monte-Carlo process
+    // Photons that need the scalar Monte-Carlo treatment in each buffer
+    bool scalar_mbw[SMILEI_MBW_BUFFERSIZE];
+
+    // Pair production rate of each photon of the buffer
+    double rate[SMILEI_MBW_BUFFERSIZE];
+
+    // Local copies of the parameters, so that the vectorized loop has no conditional loads
+    const double chiph_threshold = chiph_threshold_;
+    const double dt = dt_;
+
+    for( int ibuffer=istart ; ibuffer<iend; ibuffer+=SMILEI_MBW_BUFFERSIZE ) {
+
+    const int ibuffer_end = std::min( ibuffer + SMILEI_MBW_BUFFERSIZE, iend );
+
+    // 2. Pair production rates
+    //    Vectorized
+    #pragma omp simd
+    for( int ipart=ibuffer ; ipart<ibuffer_end; ipart++ ) {
+        rate[ipart-ibuffer] = mBW_tables.computeBreitWheelerPairProductionRateVectorized( photon_chi[ipart], photon_gamma[ipart] );
+    }
+
+    // 3. Update of the optical depth of the decays in progress that do not complete during this timestep
+    //    Vectorized. The others (new or completed decays) are handled afterwards, one by one,
+    //    so that the random numbers are drawn in the same order as before
+    #pragma omp simd
+    for( int ipart=ibuffer ; ipart<ibuffer_end; ipart++ ) {
+
+        // Masks combined with bitwise operators, which keeps the loop free of branches
+        const bool decaying = ( photon_gamma[ipart] > 2. ) & ( photon_chi[ipart] > chiph_threshold );
+        const bool in_progress = tau[ipart] > epsilon_tau_;
+
+        const double tau_end = tau[ipart] - rate[ipart-ibuffer]*std::min( tau[ipart]/rate[ipart-ibuffer], dt );
+        const bool progress_only = decaying & in_progress & ( tau_end > epsilon_tau_ );
+        tau[ipart] = progress_only ? tau_end : tau[ipart];
+
+        scalar_mbw[ipart-ibuffer] = decaying & !progress_only;
+    }
+
+#ifndef _OMPTASKS
+    // Pair quota of the buffer: the maximum number of pairs of its remaining photons
+    // The pair buffers are kept from one call to the next and only grow geometrically
+    unsigned int n_scalar = 0;
+    for( int i=0 ; i<ibuffer_end-ibuffer; i++ ) {
+        n_scalar += scalar_mbw[i];
+    }
+    for( int k=0 ; k < 2 ; k++ ) {
+        const unsigned int quota = new_pair[k]->size() + n_scalar * mBW_pair_creation_sampling_[k];
+        if( quota > new_pair[k]->capacity() ) {
+            new_pair[k]->reserve( std::max( quota, 2*new_pair[k]->capacity() ) );
+        }
+    }
+    pair0_position_x = new_pair[0]->getPtrPosition( 0 );
+    pair0_position_y = n_dimensions_ > 1 ? new_pair[0]->getPtrPosition( 1 ) : nullptr;
+    pair0_position_z = n_dimensions_ > 2 ? new_pair[0]->getPtrPosition( 2 ) : nullptr;
+    pair0_position_old_x = particles.keepOldPositions() ? new_pair[0]->getPtrPositionOld( 0 ) : nullptr;
+    pair0_position_old_y = particles.Position_old.size() > 1 ? new_pair[0]->getPtrPositionOld( 1 ) : nullptr;
+    pair0_position_old_z = particles.Position_old.size() > 2 ? new_pair[0]->getPtrPositionOld( 2 ) : nullptr;
+    pair0_momentum_x = new_pair[0]->getPtrMomentum( 0 );
+    pair0_momentum_y = new_pair[0]->getPtrMomentum( 1 );
+    pair0_momentum_z = new_pair[0]->getPtrMomentum( 2 );
+    pair0_weight = new_pair[0]->getPtrWeight();
+    pair0_charge = new_pair[0]->getPtrCharge();
+    pair0_chi = new_pair[0]->has_quantum_parameter ? new_pair[0]->getPtrChi() : nullptr;
+    pair0_tau = new_pair[0]->has_Monte_Carlo_process ? new_pair[0]->getPtrTau() : nullptr;
+    pair1_position_x = new_pair[1]->getPtrPosition( 0 );
+    pair1_position_y = n_dimensions_ > 1 ? new_pair[1]->getPtrPosition( 1 ) : nullptr;
+    pair1_position_z = n_dimensions_ > 2 ? new_pair[1]->getPtrPosition( 2 ) : nullptr;
+    pair1_position_old_x = particles.keepOldPositions() ? new_pair[1]->getPtrPositionOld( 0 ) : nullptr;
+    pair1_position_old_y = particles.Position_old.size() > 1 ? new_pair[1]->getPtrPositionOld( 1 ) : nullptr;
+    pair1_position_old_z = particles.Position_old.size() > 2 ? new_pair[1]->getPtrPositionOld( 2 ) : nullptr;
+    pair1_momentum_x = new_pair[1]->getPtrMomentum( 0 );
+    pair1_momentum_y = new_pair[1]->getPtrMomentum( 1 );
+    pair1_momentum_z = new_pair[1]->getPtrMomentum( 2 );
+    pair1_weight = new_pair[1]->getPtrWeight();
+    pair1_charge = new_pair[1]->getPtrCharge();
+    pair1_chi = new_pair[1]->has_quantum_parameter ? new_pair[1]->getPtrChi() : nullptr;
+    pair1_tau = new_pair[1]->has_Monte_Carlo_process ? new_pair[1]->getPtrTau() : nullptr;
+#endif
+
+    // 4. Monte-Carlo process of the remaining photons
     //    No vectorized
-    for( int ipart=istart ; ipart<iend; ipart++ ) {
+    for( int ipart=ibuffer ; ipart<ibuffer_end; ipart++ ) {
+
+        if( ! scalar_mbw[ipart-ibuffer] ) {
+            continue;
+        }
 
 #endif
 
@@ -628,6 +708,10 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
             }
         }
     } // end ipart loop
+
+#ifndef SMILEI_ACCELERATOR_GPU_OACC
+    } // end for buffers
+#endif
     
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
     }
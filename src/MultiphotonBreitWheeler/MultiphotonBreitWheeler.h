@@ -19,6 +19,9 @@
 #include "Params.h"
 #include "Random.h"
 
+//! Number of photons treated together by the vectorized part of the Monte-Carlo pair creation
+#define SMILEI_MBW_BUFFERSIZE 32
+
 //  ----------------------------------------------------------------------------
 //! Class Radiation
 //  ----------------------------------------------------------------------------
@@ -13,6 +13,7 @@
  
 #include "MultiphotonBreitWheelerTables.h"
 #include "MultiphotonBreitWheelerTablesDefault.h"
+#include "QEDTablesComputation.h"
 #include "H5.h"
 
 // -----------------------------------------------------------------------------
@@ -24,6 +25,11 @@
 // -----------------------------------------------------------------------------
 MultiphotonBreitWheelerTables::MultiphotonBreitWheelerTables()
 {
+    compact_tables_ = false;
+    compact_tables_validation_ = false;
+    compute_table_ = false;
+    table_size_ = { 256, 256 };
+    table_chi_range_ = { 1e-2, 1e2 };
 }
 
 // -----------------------------------------------------------------------------
@@ -58,6 +64,23 @@ void MultiphotonBreitWheelerTables::initialization( Params &params, SmileiMPI *s
     if( PyTools::nComponents( "MultiphotonBreitWheeler" ) ) {
         // Path to the databases
         PyTools::extract( "table_path", table_path_, "MultiphotonBreitWheeler"  );
+        // Compact tables and their validation
+        PyTools::extract( "compact_tables", compact_tables_, "MultiphotonBreitWheeler"  );
+        PyTools::extract( "compact_tables_validation", compact_tables_validation_, "MultiphotonBreitWheeler"  );
+        // Computation of the tables at initialization
+        PyTools::extract( "compute_tables", compute_table_, "MultiphotonBreitWheeler"  );
+        if( compute_table_ ) {
+            PyTools::extractV( "table_size", table_size_, "MultiphotonBreitWheeler" );
+            PyTools::extractV( "table_chi_range", table_chi_range_, "MultiphotonBreitWheeler" );
+            if( table_size_.size() != 2 || table_size_[0] < 2 || table_size_[1] < 2 ) {
+                ERROR_NAMELIST( "The parameter `table_size` must be a list of 2 sizes above 1",
+                                LINK_NAMELIST + std::string("#multiphoton-breit-wheeler") );
+            }
+            if( table_chi_range_.size() != 2 || table_chi_range_[0] <= 0. || table_chi_range_[1] <= table_chi_range_[0] ) {
+                ERROR_NAMELIST( "The parameter `table_chi_range` must be a list of 2 increasing positive values",
+                                LINK_NAMELIST + std::string("#multiphoton-breit-wheeler") );
+            }
+        }
     }
 
     // Computation of some parameters
@@ -71,8 +94,11 @@ void MultiphotonBreitWheelerTables::initialization( Params &params, SmileiMPI *s
 
     // Messages and checks
     if( params.has_multiphoton_Breit_Wheeler_ ) {
-        if (table_path_.size() > 0) {
+        if( compute_table_ ) {
+            computeTables( params, smpi );
+        } else if (table_path_.size() > 0) {
             MESSAGE( 1,"Reading of the external database, path: " << table_path_ );
+            table_file_ = table_path_ + "/multiphoton_Breit_Wheeler_tables.h5";
             readTables( params, smpi );
         } else {
             MESSAGE(1,"Default tables (stored in the code) are used:");
@@ -95,8 +121,64 @@ void MultiphotonBreitWheelerTables::initialization( Params &params, SmileiMPI *s
         MESSAGE( 2,"Minimum photon chi: " << xi_.min_ );
         MESSAGE( 2,"Maximum photon chi: " << xi_.max_ );
 
+        if( compact_tables_ ) {
+            compactTables();
+        }
+    }
+
+}
+
+// -----------------------------------------------------------------------------
+//! Switch the tables to their compact format (single precision data
+//! and fast logarithm). With the validation, the lookups are compared
+//! to the double precision ones on a sample of each table.
+// -----------------------------------------------------------------------------
+void MultiphotonBreitWheelerTables::compactTables()
+{
+#ifdef SMILEI_ACCELERATOR_GPU_OACC
+    ERROR_NAMELIST( "The parameter `compact_tables` is not available on GPU",
+                    LINK_NAMELIST + std::string("#multiphoton-breit-wheeler") );
+#endif
+
+    MESSAGE( "" );
+    MESSAGE( 1,"Compact tables are used (single precision, fast logarithm)" );
+
+    T_.compact();
+    xi_.compact();
+
+    if( ! compact_tables_validation_ ) {
+        return;
+    }
+
+    // Relative difference with the double precision lookup
+    auto difference = []( double reference, double value ) {
+        return reference != 0. ? std::fabs( value/reference - 1. ) : std::fabs( value );
+    };
+
+    const unsigned int n = 1000;
+    double max_rate = 0., max_pair_chi = 0.;
+    for( unsigned int i=0; i<n; i++ ) {
+        const double chi = T_.min_ * std::pow( T_.max_/T_.min_, ( i+0.5 )/n );
+        T_.compact_ = false;
+        const double reference = computeBreitWheelerPairProductionRate( chi, 1. );
+        T_.compact_ = true;
+        max_rate = std::max( max_rate, difference( reference, computeBreitWheelerPairProductionRate( chi, 1. ) ) );
+
+        const double xi_chi = xi_.min_ * std::pow( xi_.max_/xi_.min_, ( i+0.5 )/n );
+        for( unsigned int j=1; j<10; j++ ) {
+            double reference_chi[2], pair_chi[2];
+            xi_.compact_ = false;
+            computePairQuantumParameter( xi_chi, &reference_chi[0], 0.1*j );
+            xi_.compact_ = true;
+            computePairQuantumParameter( xi_chi, &pair_chi[0], 0.1*j );
+            max_pair_chi = std::max( max_pair_chi, difference( reference_chi[0], pair_chi[0] ) );
+            max_pair_chi = std::max( max_pair_chi, difference( reference_chi[1], pair_chi[1] ) );
+        }
     }
 
+    MESSAGE( 1,"Validation of the compact tables (maximum relative differences):" );
+    MESSAGE( 2,"- pair production rate: " << max_rate );
+    MESSAGE( 2,"- pair quantum parameters: " << max_pair_chi );
 }
 
 
@@ -116,7 +198,7 @@ void MultiphotonBreitWheelerTables::computePairQuantumParameter( const double ph
     // -----------------------------------------------------------
 
     int ichiph;
-    const double logchiph = std::log10( photon_chi );
+    const double logchiph = xi_.logarithm( photon_chi );
 
     // Lower boundary of the table
     if( photon_chi < xi_.min_ ) {
@@ -147,20 +229,19 @@ void MultiphotonBreitWheelerTables::computePairQuantumParameter( const double ph
 
     // check boundaries
     // Lower bound
-    if( xipp < xi_.data_[ichiph*xi_.dim_size_[1]] ) {
+    if( xipp < xi_.value( ichiph*xi_.dim_size_[1] ) ) {
         ichipa = 0;
     }
     // Upper bound
-    else if( xipp >= xi_.data_[( ichiph+1 )*xi_.dim_size_[1]-1] ) {
+    else if( xipp >= xi_.value( ( ichiph+1 )*xi_.dim_size_[1]-1 ) ) {
         ichipa = xi_.dim_size_[1]-2;
     } else {
         // Search for the corresponding index ichipa for xip
-        ichipa = userFunctions::searchValuesInMonotonicArray(
-                     &xi_.data_[ichiph*xi_.dim_size_[1]], xipp, xi_.dim_size_[1] );
+        ichipa = xi_.search( ichiph*xi_.dim_size_[1], xipp, xi_.dim_size_[1] );
     }
 
     // Delta for the particle_chi dimension
-    const double delta_chipa = ( std::log10( 0.5*photon_chi )-xi_.axis1_min_[ichiph] )
+    const double delta_chipa = ( xi_.logarithm( 0.5*photon_chi )-xi_.axis1_min_[ichiph] )
                   * xi_.inv_dim_size_minus_one_[1];
 
     const int ixip = ichiph*xi_.dim_size_[1]+ ichipa;
@@ -168,7 +249,7 @@ void MultiphotonBreitWheelerTables::computePairQuantumParameter( const double ph
     const double log10_chipam = ichipa*delta_chipa + xi_.axis1_min_[ichiph];
     const double log10_chipap = log10_chipam + delta_chipa;
 
-    const double d = ( xipp - xi_.data_[ixip] ) / ( xi_.data_[ixip+1] - xi_.data_[ixip] );
+    const double d = ( xipp - xi_.value( ixip ) ) / ( xi_.value( ixip+1 ) - xi_.value( ixip ) );
 
     // If xip > 0.5, the electron will bring more energy than the positron
     if( xip > 0.5 ) {
@@ -202,7 +283,7 @@ double MultiphotonBreitWheelerTables::computeBreitWheelerPairProductionRate(
     double dNBWdt;
 
     // Log of the photon quantum parameter particle_chi
-    const double logchiph = std::log10( photon_chi );
+    const double logchiph = T_.logarithm( photon_chi );
 
     // Lower index for interpolation in the table integfochi
     int ichiph = int( std::floor( ( logchiph-T_.log10_min_ )
@@ -226,8 +307,8 @@ double MultiphotonBreitWheelerTables::computeBreitWheelerPairProductionRate(
         const double logchiphp = logchiphm + T_.delta_;
 
         // Interpolation
-        dNBWdt = ( T_.data_[ichiph+1]*std::fabs( logchiph-logchiphm ) +
-                   T_.data_[ichiph]*std::fabs( logchiphp - logchiph ) )*T_.inv_delta_;
+        dNBWdt = ( T_.value( ichiph+1 )*std::fabs( logchiph-logchiphm ) +
+                   T_.value( ichiph )*std::fabs( logchiphp - logchiph ) )*T_.inv_delta_;
     }
     return factor_dNBW_dt_*dNBWdt/(photon_chi*photon_gamma);
 }
@@ -244,7 +325,7 @@ double MultiphotonBreitWheelerTables::computeBreitWheelerPairProductionRate(
 // -----------------------------------------------------------------------------
 void MultiphotonBreitWheelerTables::readTableT( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/multiphoton_Breit_Wheeler_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
 
         if( smpi->isMaster() ) {
@@ -276,8 +357,8 @@ void MultiphotonBreitWheelerTables::readTableT( SmileiMPI *smpi )
     }
     else
     {
-        ERROR("The table T for the nonlinear Breit-Wheeler pair process could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.")
+        ERROR("The table T for the nonlinear Breit-Wheeler pair process could not be read from the file: `"
+              << table_file_<<"`. Please check that the path is correct.")
     }
 
     // Bcast the table to all MPI ranks
@@ -293,7 +374,7 @@ void MultiphotonBreitWheelerTables::readTableT( SmileiMPI *smpi )
 // -----------------------------------------------------------------------------
 void MultiphotonBreitWheelerTables::readTableXi( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/multiphoton_Breit_Wheeler_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
 
         if( smpi->isMaster() ) {
@@ -327,8 +408,8 @@ void MultiphotonBreitWheelerTables::readTableXi( SmileiMPI *smpi )
     else
     {
         ERROR("The tables chipamin and xip for the nonlinear Breit-Wheeler pair"
-              << " process could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.")
+              << " process could not be read from the file: `"
+              << table_file_<<"`. Please check that the path is correct.")
     }
 
     // Bcast the table to all MPI ranks
@@ -352,6 +433,37 @@ void MultiphotonBreitWheelerTables::readTables( Params &params, SmileiMPI *smpi
     }
 }
 
+// -----------------------------------------------------------------------------
+//! Compute the tables with the requested resolution, in parallel. They are
+//! stored in a cache file named after their parameters, that is read instead
+//! when the same tables are requested again.
+//
+//! \param params list of simulation parameters
+//! \param smpi MPI parameters
+// -----------------------------------------------------------------------------
+void MultiphotonBreitWheelerTables::computeTables( Params &params, SmileiMPI *smpi )
+{
+    table_file_ = QEDTablesComputation::cacheFile( table_path_, "multiphoton_Breit_Wheeler_tables",
+                  table_size_, table_chi_range_[0], table_chi_range_[1] );
+
+    // The master decides for all ranks whether the cache exists
+    int cached = smpi->isMaster() && Tools::fileExists( table_file_ ) ? 1 : 0;
+    MPI_Bcast( &cached, 1, MPI_INT, 0, smpi->world() );
+
+    if( cached ) {
+        MESSAGE( 1,"Reading of the tables computed previously: " << table_file_ );
+        readTables( params, smpi );
+        return;
+    }
+
+    MESSAGE( 1,"Computation of the tables (stored in " << table_file_ << ")" );
+    QEDTablesComputation::computeMultiphotonBreitWheelerTables( T_, xi_, table_size_,
+                                                                table_chi_range_[0], table_chi_range_[1], smpi );
+    if( smpi->isMaster() ) {
+        QEDTablesComputation::writeMultiphotonBreitWheelerTables( table_file_, T_, xi_ );
+    }
+}
+
 // -----------------------------------------------------------------------------
 // TABLE COMMUNICATIONS
 // -----------------------------------------------------------------------------
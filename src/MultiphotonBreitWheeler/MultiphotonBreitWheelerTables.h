@@ -78,6 +78,37 @@ public:
         const double photon_chi, 
         const double photon_gamma);
 
+    //! Same as computeBreitWheelerPairProductionRate, without branches
+    //! so that it can be used in a vectorized loop
+    //! \param photon_chi photon quantum parameter
+    //! \param photon_gamma photon normalized energy
+    inline double __attribute__((always_inline)) computeBreitWheelerPairProductionRateVectorized( const double photon_chi,
+                                                                                                   const double photon_gamma )
+    {
+        const double logchiph = std::log10( photon_chi );
+
+        // Lower index for interpolation in the table T
+        // (the bounds are tested and the index clamped as doubles, before a single conversion)
+        const double x = ( logchiph-T_.log10_min_ )*T_.inv_delta_;
+        const bool below = x < 0.;
+        const bool above = x >= ( double )T_.size_-1.;
+        const int i = int( std::fmin( std::fmax( x, 0. ), ( double )T_.size_-2. ) );
+
+        // Interpolation in the table, or asymptotic approximations outside
+        const double logchiphm = i*T_.delta_ + T_.log10_min_;
+        const double logchiphp = logchiphm + T_.delta_;
+        const double dNBWdt_table = ( T_.data_[i+1]*std::fabs( logchiph-logchiphm ) +
+                                      T_.data_[i]*std::fabs( logchiphp - logchiph ) )*T_.inv_delta_;
+        const double dNBWdt_low = 1.2493450020845291*std::exp( -8.0/( 3.0*photon_chi ) ) * photon_chi*photon_chi;
+        const double dNBWdt_high = 2.067731275227008 * std::cbrt( photon_chi*photon_chi*photon_chi*photon_chi*photon_chi );
+        // Selected by products, so that the function calls are not moved into branches
+        const double w_low = below ? 1. : 0.;
+        const double w_high = above ? 1. : 0.;
+        const double dNBWdt = w_low*dNBWdt_low + w_high*dNBWdt_high + ( 1.-w_low-w_high )*dNBWdt_table;
+
+        return factor_dNBW_dt_*dNBWdt/( photon_chi*photon_gamma );
+    };
+
     // ---------------------------------------------------------------------
     // TABLE READING
     // ---------------------------------------------------------------------
@@ -94,6 +125,15 @@ public:
     //! \param smpi Object of class SmileiMPI containing MPI properties
     void readTables( Params &params, SmileiMPI *smpi );
 
+    //! Compute the tables with the requested resolution, or read them
+    //! from the cache if they were already computed with the same parameters
+    //! \param smpi Object of class SmileiMPI containing MPI properties
+    void computeTables( Params &params, SmileiMPI *smpi );
+
+    //! Switch the tables to their compact format and, if requested,
+    //! report the differences with the double precision lookups
+    void compactTables();
+
     // ---------------------------------------------
     // Structure for Table T used for the
     // pair creation Monte-Carlo process
@@ -121,6 +161,24 @@ private:
     //! Path to the tables
     std::string table_path_;
 
+    //! File of the tables that are read
+    std::string table_file_;
+
+    //! Flag that activate the table computation
+    bool compute_table_;
+
+    //! Sizes of the photon and particle chi axes of the computed tables
+    std::vector<unsigned int> table_size_;
+
+    //! Boundaries of the photon chi axis of the computed tables
+    std::vector<double> table_chi_range_;
+
+    //! True if the lookups use the compact tables (single precision, fast logarithm)
+    bool compact_tables_;
+
+    //! True if the compact tables are compared to the double precision ones at initialization
+    bool compact_tables_validation_;
+
     // ---------------------------------------------
     // Factors
     // ---------------------------------------------
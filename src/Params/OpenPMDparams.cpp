@@ -123,7 +123,8 @@ OpenPMDparams::OpenPMDparams( Params &p ):
     }
 }
 
-void OpenPMDparams::writeRootAttributes( H5Write &location, string meshesPath, string particlesPath )
+template<class Location>
+void OpenPMDparams::writeRootAttributes( Location &location, string meshesPath, string particlesPath )
 {
     location.attr( "openPMDextension", extension, H5T_NATIVE_UINT32 );
     location.attr( "openPMD", version );
@@ -137,18 +138,21 @@ void OpenPMDparams::writeRootAttributes( H5Write &location, string meshesPath, s
     location.attr( "particlesPath", particlesPath );
 }
 
-void OpenPMDparams::writeBasePathAttributes( H5Write &location, unsigned int itime )
+template<class Location>
+void OpenPMDparams::writeBasePathAttributes( Location &location, unsigned int itime )
 {
     location.attr( "time", ( double )( itime * params->timestep ) );
     location.attr( "dt", ( double )params->timestep );
     location.attr( "timeUnitSI", unitSI[SMILEI_UNIT_TIME] );
 }
 
-void OpenPMDparams::writeParticlesAttributes( H5Write & )
+template<class Location>
+void OpenPMDparams::writeParticlesAttributes( Location & )
 {
 }
 
-void OpenPMDparams::writeMeshesAttributes( H5Write &location )
+template<class Location>
+void OpenPMDparams::writeMeshesAttributes( Location &location )
 {
     location.attr( "patchSize", patchSize ); // this one is not openPMD
     location.attr( "fieldSolver", fieldSolver );
@@ -165,7 +169,8 @@ void OpenPMDparams::writeMeshesAttributes( H5Write &location )
     location.attr( "fieldSmoothingParameters", "" );
 }
 
-void OpenPMDparams::writeFieldAttributes( H5Write &location, vector<unsigned int> subgrid_start, vector<unsigned int> subgrid_step )
+template<class Location>
+void OpenPMDparams::writeFieldAttributes( Location &location, vector<unsigned int> subgrid_start, vector<unsigned int> subgrid_step )
 {
     location.attr( "geometry", "cartesian" );
     location.attr( "dataOrder", "C" );
@@ -188,27 +193,46 @@ void OpenPMDparams::writeFieldAttributes( H5Write &location, vector<unsigned int
     location.attr( "gridUnitSI", unitSI[SMILEI_UNIT_POSITION] );
 }
 
-void OpenPMDparams::writeSpeciesAttributes( H5Write & )
+template<class Location>
+void OpenPMDparams::writeSpeciesAttributes( Location & )
 {
 }
 
-void OpenPMDparams::writeRecordAttributes( H5Write &location, unsigned int unit_type, double timeOffset )
+template<class Location>
+void OpenPMDparams::writeRecordAttributes( Location &location, unsigned int unit_type, double timeOffset )
 {
     location.attr( "unitDimension", unitDimension[unit_type] );
     location.attr( "timeOffset", timeOffset );
 }
 
-void OpenPMDparams::writeFieldRecordAttributes( H5Write &location, vector<double> &stagger )
+template<class Location>
+void OpenPMDparams::writeFieldRecordAttributes( Location &location, vector<double> &stagger )
 {
     location.attr( "position", stagger );
 }
 
-void OpenPMDparams::writeComponentAttributes( H5Write &location, unsigned int unit_type )
+template<class Location>
+void OpenPMDparams::writeComponentAttributes( Location &location, unsigned int unit_type )
 {
     location.attr( "unitSI", unitSI[unit_type] );
 }
 
 
+#define INSTANTIATE_OPENPMD_ATTRIBUTES( Location ) \
+    template void OpenPMDparams::writeRootAttributes( Location &, string, string ); \
+    template void OpenPMDparams::writeBasePathAttributes( Location &, unsigned int ); \
+    template void OpenPMDparams::writeMeshesAttributes( Location & ); \
+    template void OpenPMDparams::writeParticlesAttributes( Location & ); \
+    template void OpenPMDparams::writeFieldAttributes( Location &, vector<unsigned int>, vector<unsigned int> ); \
+    template void OpenPMDparams::writeSpeciesAttributes( Location & ); \
+    template void OpenPMDparams::writeRecordAttributes( Location &, unsigned int, double ); \
+    template void OpenPMDparams::writeFieldRecordAttributes( Location &, vector<double> & ); \
+    template void OpenPMDparams::writeComponentAttributes( Location &, unsigned int );
+
+INSTANTIATE_OPENPMD_ATTRIBUTES( H5Write )
+#ifdef SMILEI_ADIOS2
+INSTANTIATE_OPENPMD_ATTRIBUTES( ADIOS2Write )
+#endif
 
 // WARNING: do not change the format. It is required for OpenPMD compatibility.
 string OpenPMDparams::getLocalTime()
@@ -3,6 +3,7 @@
 
 #include "Params.h"
 #include "H5.h"
+#include "ADIOS2.h"
 
 #define SMILEI_NUNITS 11
 #define SMILEI_UNIT_NONE     0
@@ -54,32 +55,43 @@ public:
     //! Returns a time string in the openPMD format
     std::string getLocalTime();
     
+    // The attributes are written in a location of HDF5 (H5Write) or ADIOS2 (ADIOS2Write) outputs
+    
     //! Write the attributes for the root of the HDF5 file
-    void writeRootAttributes( H5Write&, std::string, std::string );
+    template<class Location>
+    void writeRootAttributes( Location&, std::string, std::string );
     
     //! Write the attributes for the basePath
-    void writeBasePathAttributes( H5Write&, unsigned int );
+    template<class Location>
+    void writeBasePathAttributes( Location&, unsigned int );
     
     //! Write the attributes for the meshesPath
-    void writeMeshesAttributes( H5Write& );
+    template<class Location>
+    void writeMeshesAttributes( Location& );
     
     //! Write the attributes for the particlesPath
-    void writeParticlesAttributes( H5Write& );
+    template<class Location>
+    void writeParticlesAttributes( Location& );
     
     //! Write the attributes for a field in the meshesPath
-    void writeFieldAttributes( H5Write&, std::vector<unsigned int> subgrid_start= {}, std::vector<unsigned int> subgrid_step= {} );
+    template<class Location>
+    void writeFieldAttributes( Location&, std::vector<unsigned int> subgrid_start= {}, std::vector<unsigned int> subgrid_step= {} );
     
     //! Write the attributes for the particlesPath
-    void writeSpeciesAttributes( H5Write& );
+    template<class Location>
+    void writeSpeciesAttributes( Location& );
     
     //! Write the attributes for a record
-    void writeRecordAttributes( H5Write&, unsigned int, double timeOffset = 0 );
+    template<class Location>
+    void writeRecordAttributes( Location&, unsigned int, double timeOffset = 0 );
     
     //! Write the attributes for a field record
-    void writeFieldRecordAttributes( H5Write&, std::vector<double> &stagger );
+    template<class Location>
+    void writeFieldRecordAttributes( Location&, std::vector<double> &stagger );
     
     //! Write the attributes for a component
-    void writeComponentAttributes( H5Write&, unsigned int );
+    template<class Location>
+    void writeComponentAttributes( Location&, unsigned int );
     
     
 private:
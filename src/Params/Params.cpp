@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <ctime>
 #include <iomanip>
 
@@ -135,6 +136,14 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     // we add the rank, in case some script needs it
     PyModule_AddIntConstant( Py_main, "smilei_mpi_rank", smpi->getRank() );
 
+    // we add whether this executable is compiled for GPU, so that a job mixing CPU and GPU executables
+    // can set Main.gpu_computing = smilei_gpu_build
+#if( defined( SMILEI_ACCELERATOR_GPU_OACC ) && defined( _OPENACC ) ) || defined( SMILEI_ACCELERATOR_GPU_OMP )
+    PyModule_AddIntConstant( Py_main, "smilei_gpu_build", 1 );
+#else
+    PyModule_AddIntConstant( Py_main, "smilei_gpu_build", 0 );
+#endif
+
     // we add the MPI size, in case some script needs it
     PyModule_AddIntConstant( Py_main, "smilei_mpi_size", smpi->getSize() );
     namelist += string( "smilei_mpi_size = " ) + to_string( smpi->getSize() ) + "\n";
@@ -156,11 +165,12 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     namelist += "BEGINNING OF THE USER NAMELIST\n";
     namelist += "\"\"\"\n\n";
 
-    // Running the namelists
-    for( vector<string>::iterator it=namelistsFiles.begin(); it!=namelistsFiles.end(); it++ ) {
-        string strNamelist="";
+    // Reading the namelists on the master
+    vector<string> strNamelists( namelistsFiles.size(), "" );
+    for( unsigned int i=0; i<namelistsFiles.size(); i++ ) {
+        string &strNamelist = strNamelists[i];
         if( smpi->isMaster() ) {
-            ifstream istr( it->c_str() );
+            ifstream istr( namelistsFiles[i].c_str() );
             // If file
             if( istr.is_open() ) {
                 std::stringstream buffer;
@@ -168,7 +178,7 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
                 strNamelist+=buffer.str();
                 // If command
             } else {
-                command = *it;
+                command = namelistsFiles[i];
                 // Remove quotes
                 unsigned int s = command.size();
                 if( s>1 && command.substr( 0, 1 )=="\"" && command.substr( s-1, 1 )=="\"" ) {
@@ -179,8 +189,42 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
             }
             strNamelist +="\n";
         }
-        smpi->bcast( strNamelist );
-        runScript( strNamelist, ( *it ), globals );
+    }
+
+    // With the environment variable SMILEI_NAMELIST_BROADCAST, only the master runs the namelists,
+    // and broadcasts the resulting python objects to the other processes (see pyinit.py).
+    // This avoids that thousands of processes execute the namelists and their imports at the same time.
+    int broadcast_namelist = 0;
+    if( smpi->isMaster() ) {
+        const char *env = getenv( "SMILEI_NAMELIST_BROADCAST" );
+        broadcast_namelist = env && string( env ) != "0" && smpi->getSize() > 1;
+    }
+    smpi->bcast( broadcast_namelist );
+    string namelist_data( "" );
+    if( broadcast_namelist ) {
+        if( smpi->isMaster() ) {
+            PyTools::runPyFunction( "_smilei_snapshot_namelist" );
+            for( unsigned int i=0; i<namelistsFiles.size(); i++ ) {
+                runScript( strNamelists[i], namelistsFiles[i], globals );
+            }
+            PyTools::runPyFunction( "_smilei_serialize_namelist" );
+            PyTools::getAttr( Py_main, "_smilei_namelist_data", namelist_data );
+            MESSAGE( 1, "Broadcasting the namelist (" << namelist_data.size() << " bytes)" );
+        }
+        smpi->bcast( namelist_data );
+    }
+
+    // Running the namelists (on all processes, or on the other processes if the master could not serialize them)
+    if( namelist_data.empty() ) {
+        for( unsigned int i=0; i<namelistsFiles.size(); i++ ) {
+            smpi->bcast( strNamelists[i] );
+            if( !broadcast_namelist || !smpi->isMaster() ) {
+                runScript( strNamelists[i], namelistsFiles[i], globals );
+            }
+        }
+    } else if( !smpi->isMaster() ) {
+        PyModule_AddStringConstant( Py_main, "_smilei_namelist_data", namelist_data.c_str() );
+        PyTools::runPyFunction( "_smilei_deserialize_namelist" );
     }
 
     // Running pycontrol.py
@@ -222,6 +266,7 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         // Init of the seed for the C++ random generator
         Rand::gen = std::mt19937( random_seed );
     }
+    PyTools::extract( "counter_based_random", counter_based_random, "Main" );
 
     // communication pattern initialized as partial B exchange
     full_B_exchange = false;
@@ -271,6 +316,7 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     } else if( maxwell_sol == "picsar" ) {
         is_pxr = true;
     }
+    PyTools::extract( "maxwell_skip_vacuum", maxwell_skip_vacuum, "Main"   );
 
 #ifndef _PICSAR
     if (is_pxr) {
@@ -317,6 +363,38 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     exchange_particles_each = 1;
 
     PyTools::extract( "every_clean_particles_overhead", every_clean_particles_overhead, "Main"   );
+    PyTools::extract( "particles_capacity_margin", particles_capacity_margin, "Main"   );
+    if( particles_capacity_margin < 0. ) {
+        ERROR_NAMELIST( "particles_capacity_margin must be positive", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    PyTools::extract( "particles_forecast_length", particles_forecast_length, "Main"   );
+    PyTools::extract( "pack_exchanged_particles", pack_exchanged_particles, "Main"   );
+    PyTools::extract( "neighborhood_collectives", neighborhood_collectives, "Main"   );
+    PyTools::extract( "shared_memory_halos", shared_memory_halos, "Main"   );
+    PyTools::extract( "overlap_current_sums", overlap_current_sums, "Main"   );
+    PyTools::extract( "sparse_current_sums", sparse_current_sums, "Main"   );
+    PyTools::extract( "topology_aware_placement", topology_aware_placement, "Main"   );
+#if MPI_VERSION < 3
+    if( neighborhood_collectives || shared_memory_halos ) {
+        ERROR_NAMELIST( "Main.neighborhood_collectives and Main.shared_memory_halos require an MPI-3 library", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    if( topology_aware_placement ) {
+        ERROR_NAMELIST( "Main.topology_aware_placement requires an MPI-3 library", LINK_NAMELIST + std::string("#main-variables") );
+    }
+#endif
+    if( neighborhood_collectives && shared_memory_halos ) {
+        ERROR_NAMELIST( "Main.neighborhood_collectives and Main.shared_memory_halos cannot be used together", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    PyTools::extract( "adaptive_sorting", adaptive_sorting, "Main"   );
+    PyTools::extract( "dynamics_scheduling", dynamics_scheduling, "Main"   );
+    if( dynamics_scheduling != "runtime" && dynamics_scheduling != "largest_first" && dynamics_scheduling != "numa_affinity" ) {
+        ERROR_NAMELIST( "dynamics_scheduling `" << dynamics_scheduling << "` should be `runtime`, `largest_first` or `numa_affinity`",
+            LINK_NAMELIST + std::string("#main-variables") );
+    }
+    PyTools::extract( "numa_domains", numa_domains, "Main"   );
+    if( numa_domains < 1 ) {
+        ERROR_NAMELIST( "numa_domains must be at least 1", LINK_NAMELIST + std::string("#main-variables") );
+    }
 
     // TIME & SPACE RESOLUTION/TIME-STEPS
 
@@ -457,6 +535,8 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         PyTools::extractVV( "Env_pml_sigma_parameters", envelope_pml_sigma_parameters, "LaserEnvelope" );
         PyTools::extractVV( "Env_pml_kappa_parameters", envelope_pml_kappa_parameters, "LaserEnvelope" );
         PyTools::extractVV( "Env_pml_alpha_parameters", envelope_pml_alpha_parameters, "LaserEnvelope" );
+
+        PyTools::extract( "reuse_interpolation_coefficients", envelope_reuse_coefficients, "LaserEnvelope" );
     }
 
     open_boundaries.resize( nDim_field );
@@ -544,6 +624,15 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     PyTools::extract( "solve_poisson", solve_poisson, "Main"   );
     PyTools::extract( "poisson_max_iteration", poisson_max_iteration, "Main"   );
     PyTools::extract( "poisson_max_error", poisson_max_error, "Main"   );
+    std::string poisson_solver;
+    PyTools::extract( "poisson_solver", poisson_solver, "Main"   );
+    if( poisson_solver != "CG" && poisson_solver != "multigrid" ) {
+        ERROR_NAMELIST( "Main.poisson_solver `" << poisson_solver << "` should be `CG` or `multigrid`", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    poisson_multigrid = ( poisson_solver == "multigrid" );
+    if( poisson_multigrid && geometry == "AMcylindrical" ) {
+        ERROR_NAMELIST( "Main.poisson_solver `multigrid` is not available in AMcylindrical geometry", LINK_NAMELIST + std::string("#main-variables") );
+    }
     // Relativistic Poisson Solver
     PyTools::extract( "solve_relativistic_poisson", solve_relativistic_poisson, "Main"   );
     PyTools::extract( "relativistic_poisson_max_iteration", relativistic_poisson_max_iteration, "Main"   );
@@ -736,13 +825,39 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         );
         PyTools::extract( "cell_load", cell_load, "LoadBalancing"   );
         PyTools::extract( "frozen_particle_load", frozen_particle_load, "LoadBalancing"   );
+        vacuum_cell_load = cell_load;
+        PyTools::extractOrNone( "vacuum_cell_load", vacuum_cell_load, "LoadBalancing"   );
         PyTools::extract( "initial_balance", initial_balance, "LoadBalancing"   );
+        PyTools::extract( "batched_exchange", batched_exchange, "LoadBalancing"   );
+        PyTools::extract( "measured_load_steps", measured_load_steps, "LoadBalancing"   );
+        PyTools::extract( "imbalance_threshold", imbalance_threshold, "LoadBalancing"   );
+        PyTools::extract( "memory_cap", memory_cap, "LoadBalancing"   );
+        PyTools::extract( "gpu_rank_capability", gpu_rank_capability, "LoadBalancing"   );
+        if( gpu_rank_capability <= 0. ) {
+            ERROR_NAMELIST( "LoadBalancing.gpu_rank_capability must be strictly positive", LINK_NAMELIST + std::string("#load-balancing") );
+        }
     } else {
         load_balancing_time_selection = new TimeSelection();
+        batched_exchange = false;
+        measured_load_steps = 0;
+        imbalance_threshold = 0.;
+        memory_cap = 0.;
+        gpu_rank_capability = 1.;
     }
 
     has_load_balancing = ( smpi->getSize()>1 )  && ( ! load_balancing_time_selection->isEmpty() );
 
+    operator_sampling_every = 0;
+    if( PyTools::nComponents( "DiagPerformances" )>0 ) {
+        PyTools::extract( "operator_sampling_every", operator_sampling_every, "DiagPerformances" );
+        PyTools::extractV( "hardware_counters", hardware_counters, "DiagPerformances" );
+        bool patch_information;
+        PyTools::extract( "patch_information", patch_information, "DiagPerformances" );
+        if( operator_sampling_every > 0 && !patch_information ) {
+            ERROR_NAMELIST( "DiagPerformances.operator_sampling_every requires patch_information = True", LINK_NAMELIST + std::string("#performances-diagnostics") );
+        }
+    }
+
     if( has_load_balancing && patch_arrangement != "hilbertian" ) {
         ERROR_NAMELIST( "Dynamic load balancing is only available for Hilbert decomposition",  LINK_NAMELIST + std::string("#main-variables") );
     }
@@ -776,9 +891,23 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     has_adaptive_vectorization = false;
     adaptive_vecto_time_selection = nullptr;
 
+    cell_ordering = "lexicographic";
+    colored_deposition = false;
+    reuse_shape_coefficients = false;
+    float_accumulation = false;
+    float_accumulation_check = false;
+    adaptive_granularity = "patch";
+    adaptive_cost_model = "fit";
+    adaptive_calibration_period = 0;
+
     if( PyTools::nComponents( "Vectorization" )>0 ) {
         // Extraction of the vectorization mode
         PyTools::extract( "mode", vectorization_mode, "Vectorization"   );
+        PyTools::extract( "cell_ordering", cell_ordering, "Vectorization"   );
+        PyTools::extract( "colored_deposition", colored_deposition, "Vectorization"   );
+        PyTools::extract( "reuse_shape_coefficients", reuse_shape_coefficients, "Vectorization"   );
+        PyTools::extract( "float_accumulation", float_accumulation, "Vectorization"   );
+        PyTools::extract( "float_accumulation_check", float_accumulation_check, "Vectorization"   );
         if( !( vectorization_mode == "off" ||
                 vectorization_mode == "on" ||
                 vectorization_mode == "adaptive" ||
@@ -831,6 +960,21 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
             ERROR_NAMELIST( "In block `Vectorization`, parameter `initial_mode` must be `off` or `on`",  LINK_NAMELIST + std::string("#vectorization") );
         }
 
+        // Granularity of the operator choice for the adaptive mode
+        PyTools::extract( "granularity", adaptive_granularity, "Vectorization"   );
+        if( !( adaptive_granularity == "patch" ||
+                adaptive_granularity == "cell" ) ) {
+            ERROR_NAMELIST( "In block `Vectorization`, parameter `granularity` must be `patch` or `cell`",  LINK_NAMELIST + std::string("#vectorization") );
+        }
+
+        // Cost model of the adaptive mode
+        PyTools::extract( "cost_model", adaptive_cost_model, "Vectorization"   );
+        if( !( adaptive_cost_model == "fit" ||
+                adaptive_cost_model == "calibrated" ) ) {
+            ERROR_NAMELIST( "In block `Vectorization`, parameter `cost_model` must be `fit` or `calibrated`",  LINK_NAMELIST + std::string("#vectorization") );
+        }
+        PyTools::extract( "calibration_period", adaptive_calibration_period, "Vectorization"   );
+
         // get parameter "every" which describes a timestep selection
         if( ! adaptive_vecto_time_selection )
             adaptive_vecto_time_selection = new TimeSelection(
@@ -856,6 +1000,25 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         MESSAGE( 1, "Smilei will run on CPU devices" );
 #endif
     }
+    if( gpu_computing && dynamics_scheduling == "numa_affinity" ) {
+        ERROR_NAMELIST( "dynamics_scheduling `numa_affinity` is not available on GPU", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    if( gpu_computing && geometry == "AMcylindrical" ) {
+        ERROR_NAMELIST( "AMcylindrical geometry is not available on GPU", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    if( gpu_computing && Laser_Envelope_model ) {
+        ERROR_NAMELIST( "The envelope model is not available on GPU",
+                        LINK_NAMELIST + std::string("#laser-envelope-model") );
+    }
+    PyTools::extract( "fields_arena", fields_arena, "Main"   );
+    if( fields_arena && ( gpu_computing || is_spectral || geometry == "AMcylindrical" ) ) {
+        ERROR_NAMELIST( "Main.fields_arena is not available on GPU, with spectral solvers or in AMcylindrical geometry",
+            LINK_NAMELIST + std::string("#main-variables") );
+    }
+    if( fields_arena && dynamics_scheduling == "numa_affinity" ) {
+        ERROR_NAMELIST( "Main.fields_arena and dynamics_scheduling = `numa_affinity` cannot be used together",
+            LINK_NAMELIST + std::string("#main-variables") );
+    }
 
     // In case of collisions, ensure particle sort per cell
     if( PyTools::nComponents( "Collisions" ) > 0 ) {
@@ -884,9 +1047,18 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         print_every = 1;
     }
 
+    // Read the "telemetry_every" parameter
+    PyTools::extract( "telemetry_every", telemetry_every, "Main" );
+
     // Read the "print_expected_disk_usage" parameter
     PyTools::extract( "print_expected_disk_usage", print_expected_disk_usage, "Main"   );
 
+    // Read the "diagnostics_window" parameter
+    PyTools::extract( "diagnostics_window", diagnostics_window, "Main"   );
+    if( diagnostics_window < 0 ) {
+        ERROR( "`diagnostics_window` must be positive or 0" );
+    }
+
     // Decide when necessary to keep position_old
     keep_position_old = false;
     DEBUGEXEC( keep_position_old = true );
@@ -899,6 +1071,8 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
 
     double mass, mass2=0;
     std::string merging_method;
+    unsigned int split_max_particles_per_cell;
+    species_push_every = 1;
 
     for( unsigned int ispec = 0; ispec < tot_species_number; ispec++ ) {
         PyTools::extract( "mass", mass, "Species", ispec );
@@ -922,6 +1096,36 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
             cell_sorting_ = true;
 
         }
+        // Same for the splitting
+        split_max_particles_per_cell = 0;
+        PyTools::extract( "split_max_particles_per_cell", split_max_particles_per_cell, "Species", ispec );
+        if( split_max_particles_per_cell > 0 ) {
+
+            if( defined_cell_sort && !cell_sorting_ ) {
+                ERROR_NAMELIST( " Cell sorting or vectorization must be allowed in order to use particle splitting.", LINK_NAMELIST + std::string("#particle-splitting") );
+            }
+
+            cell_sorting_ = true;
+
+        }
+        // Sub-cycled species share the same period, so that the averaged fields are common
+        int push_every;
+        PyTools::extract( "push_every", push_every, "Species", ispec );
+        if( push_every < 1 ) {
+            ERROR_NAMELIST( "For species #" << ispec << ", push_every must be a positive integer",  LINK_NAMELIST + std::string("#push_every") );
+        }
+        if( push_every > 1 ) {
+            if( species_push_every > 1 && ( unsigned int )push_every != species_push_every ) {
+                ERROR_NAMELIST( "All the species with push_every > 1 must have the same push_every",  LINK_NAMELIST + std::string("#push_every") );
+            }
+            species_push_every = push_every;
+        }
+    }
+    if( species_push_every > 1 ) {
+        if( geometry == "AMcylindrical" || is_spectral || use_BTIS3 || omptasks || gpu_computing || Laser_Envelope_model ) {
+            ERROR_NAMELIST( "push_every > 1 requires a cartesian geometry with the FDTD solvers on CPU, without OpenMP tasks, B-TIS3 nor envelope",
+                LINK_NAMELIST + std::string("#push_every") );
+        }
     }
 
     // Force adaptive vectorization in scalar mode if cell_sorting requested
@@ -937,6 +1141,75 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         }
     }
 
+    // Ordering of the cells of the vectorized species
+    if( cell_ordering != "lexicographic" ) {
+        if( cell_ordering != "hilbert" && cell_ordering != "morton" ) {
+            ERROR_NAMELIST( "In block `Vectorization`, parameter `cell_ordering` must be `lexicographic`, `hilbert` or `morton`",
+                LINK_NAMELIST + std::string("#vectorization") );
+        }
+        if( vectorization_mode != "on" || geometry == "AMcylindrical" || geometry == "1Dcartesian" || omptasks || gpu_computing || Laser_Envelope_model ) {
+            ERROR_NAMELIST( "In block `Vectorization`, `cell_ordering` requires `mode = 'on'` in 2D or 3D cartesian geometry on CPU, without OpenMP tasks nor envelope",
+                LINK_NAMELIST + std::string("#vectorization") );
+        }
+    }
+
+    // Projection of the cells by colors of independent blocks
+    if( colored_deposition ) {
+        if( vectorization_mode == "off" || geometry == "AMcylindrical" || geometry == "1Dcartesian" || omptasks || gpu_computing || Laser_Envelope_model ) {
+            ERROR_NAMELIST( "In block `Vectorization`, `colored_deposition` requires a vectorized mode in 2D or 3D cartesian geometry on CPU, without OpenMP tasks nor envelope",
+                LINK_NAMELIST + std::string("#vectorization") );
+        }
+    }
+
+    // Interpolation coefficients shared by the two passes of the ponderomotive species
+    if( envelope_reuse_coefficients ) {
+        if( geometry != "3Dcartesian" || interpolation_order != 2 || interpolator_ != "momentum-conserving" || omptasks ) {
+            ERROR_NAMELIST( "In block `LaserEnvelope`, `reuse_interpolation_coefficients` requires a 3D cartesian geometry with the momentum-conserving interpolator at order 2, without OpenMP tasks",
+                LINK_NAMELIST + std::string("#laser-envelope-model") );
+        }
+    }
+
+    // Shape coefficients of the old position shared by the interpolator and the projector
+    if( reuse_shape_coefficients ) {
+        if( vectorization_mode == "off" || geometry != "3Dcartesian" || interpolation_order != 4 || interpolator_ != "momentum-conserving" || gpu_computing || Laser_Envelope_model ) {
+            ERROR_NAMELIST( "In block `Vectorization`, `reuse_shape_coefficients` requires a vectorized mode in 3D cartesian geometry on CPU, with the momentum-conserving interpolator at order 4 and without envelope",
+                LINK_NAMELIST + std::string("#vectorization") );
+        }
+    }
+
+    // Single-precision accumulation of the currents in the projector
+    if( float_accumulation ) {
+        if( vectorization_mode == "off" || geometry != "3Dcartesian" || interpolation_order != 2 || gpu_computing ) {
+            ERROR_NAMELIST( "In block `Vectorization`, `float_accumulation` requires a vectorized mode in 3D cartesian geometry on CPU, at order 2",
+                LINK_NAMELIST + std::string("#vectorization") );
+        }
+#ifdef __FAST_MATH__
+        WARNING( "`Vectorization.float_accumulation`: compiled with fast-math, the compensation of the summation may be optimized out" );
+#endif
+    } else if( float_accumulation_check ) {
+        WARNING( "`Vectorization.float_accumulation_check` has no effect without `float_accumulation`" );
+    }
+
+    // Cost model measured on the fly
+    if( adaptive_cost_model == "calibrated" && vectorization_mode != "adaptive" ) {
+        ERROR_NAMELIST( "In block `Vectorization`, `cost_model = 'calibrated'` requires `mode = 'adaptive'`",
+            LINK_NAMELIST + std::string("#vectorization") );
+    }
+
+    // Choice of the operators per cell in adaptive mode
+    if( adaptive_granularity == "cell" ) {
+        if( vectorization_mode != "adaptive" || geometry == "AMcylindrical" || omptasks || gpu_computing || Laser_Envelope_model ) {
+            ERROR_NAMELIST( "In block `Vectorization`, `granularity = 'cell'` requires `mode = 'adaptive'` in cartesian geometry on CPU, without OpenMP tasks nor envelope",
+                LINK_NAMELIST + std::string("#vectorization") );
+        }
+    }
+
+    // Adaptive sorting by cell inside the bins of the scalar species
+    if( adaptive_sorting && ( vectorization_mode != "off" || gpu_computing || geometry == "AMcylindrical" ) ) {
+        ERROR_NAMELIST( "`adaptive_sorting` requires a cartesian geometry on CPU, without vectorization nor cell sorting",
+            LINK_NAMELIST + std::string("#main-variables") );
+    }
+
     // -------------------------------------------------------
     // Parameters for the synchrotron-like radiation losses
     // -------------------------------------------------------
@@ -1056,6 +1329,10 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
             string file( "" );
             PyTools::extract( "file", file, "Laser", i_laser );
 
+            // Extract the directory of the cached propagations
+            string cache_directory( "" );
+            PyTools::extract( "_cache_directory", cache_directory, "Laser", i_laser );
+
             // Extract the list of profiles and verify their content
             PyObject *p = PyTools::extract_py( "_profiles", "Laser", i_laser );
             vector<PyObject *> profiles;
@@ -1120,7 +1397,7 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
                 }
                 // Prepare propagator
                 MESSAGE( 1, "LaserOffset #"<< n_laser_offset );
-                LaserPropagator propagateX( this, normal_axis, fft_time_window, fft_time_step, comm );
+                LaserPropagator propagateX( this, normal_axis, fft_time_window, fft_time_step, cache_directory, comm );
 
                 // Make the propagation happen and write out the file
                 if( ! smpi->test_mode ) {
@@ -1188,6 +1465,37 @@ void Params::compute()
 
     multiple_decomposition = PyTools::nComponents( "MultipleDecomposition" )>0;
 
+    if( overlap_current_sums ) {
+#ifdef _NO_MPI_TM
+        ERROR_NAMELIST( "Main.overlap_current_sums requires MPI_THREAD_MULTIPLE", LINK_NAMELIST + std::string("#main-variables") );
+#endif
+        if( geometry == "AMcylindrical" || gpu_computing || Laser_Envelope_model || multiple_decomposition ) {
+            ERROR_NAMELIST( "Main.overlap_current_sums is not available in AM geometry, on GPU, with the envelope model or with MultipleDecomposition",
+                LINK_NAMELIST + std::string("#main-variables") );
+        }
+    }
+    if( sparse_current_sums && ( geometry == "AMcylindrical" || gpu_computing ) ) {
+        ERROR_NAMELIST( "Main.sparse_current_sums is not available in AM geometry or on GPU", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    if( maxwell_skip_vacuum && ( geometry == "AMcylindrical" || is_pxr || Friedman_filter || gpu_computing ) ) {
+        ERROR_NAMELIST( "Main.maxwell_skip_vacuum is not available in AM geometry, with the spectral solvers, the Friedman filter or on GPU", LINK_NAMELIST + std::string("#main-variables") );
+    }
+    if( batched_exchange && gpu_computing ) {
+        ERROR_NAMELIST( "LoadBalancing.batched_exchange is not available on GPU", LINK_NAMELIST + std::string("#load-balancing") );
+    }
+    if( measured_load_steps > 0 && ( gpu_computing || omptasks ) ) {
+        ERROR_NAMELIST( "LoadBalancing.measured_load_steps is not available on GPU or with tasks", LINK_NAMELIST + std::string("#load-balancing") );
+    }
+    if( operator_sampling_every > 0 && ( gpu_computing || omptasks ) ) {
+        ERROR_NAMELIST( "DiagPerformances.operator_sampling_every is not available on GPU or with tasks", LINK_NAMELIST + std::string("#performances-diagnostics") );
+    }
+    if( !hardware_counters.empty() && omptasks ) {
+        ERROR_NAMELIST( "DiagPerformances.hardware_counters is not available with tasks", LINK_NAMELIST + std::string("#performances-diagnostics") );
+    }
+    if( topology_aware_placement && multiple_decomposition ) {
+        ERROR_NAMELIST( "Main.topology_aware_placement is not available with MultipleDecomposition", LINK_NAMELIST + std::string("#main-variables") );
+    }
+
     // compute number of cells & normalized lengths
     for( unsigned int i=0; i<nDim_field; i++ ) {
         patch_size_[i] = round( grid_length[i]/cell_length[i] );
@@ -1462,12 +1770,15 @@ void Params::print_init()
         MESSAGE( 1, "Happens: " << load_balancing_time_selection->info() );
         MESSAGE( 1, "Cell load coefficient = " << cell_load );
         MESSAGE( 1, "Frozen particle load coefficient = " << frozen_particle_load );
+        MESSAGE( 1, "Vacuum cell load coefficient = " << vacuum_cell_load );
     }
 
     TITLE( "Vectorization: " );
     MESSAGE( 1, "Mode: " << vectorization_mode );
     if( vectorization_mode == "adaptive_mixed_sort" || vectorization_mode == "adaptive" ) {
         MESSAGE( 1, "Default mode: " << adaptive_default_mode );
+        MESSAGE( 1, "Granularity: " << adaptive_granularity );
+        MESSAGE( 1, "Cost model: " << adaptive_cost_model );
         MESSAGE( 1, "Time selection: " << adaptive_vecto_time_selection->info() );
     }
 
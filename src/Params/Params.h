@@ -153,6 +153,8 @@ public:
     double envelope_polarization_phi = 0.; // used only for envelope ionization; in radians, angle with the xy plane
     // define the solver for the envelope equation
     std::string envelope_solver;
+    //! Reuse the interpolation coefficients of the susceptibility pass in the position pass of the ponderomotive species
+    bool envelope_reuse_coefficients = false;
     
     //Poisson solver
     //! Do we solve poisson
@@ -161,6 +163,8 @@ public:
     unsigned int poisson_max_iteration;
     //! Maxium poisson error tolerated
     double poisson_max_error;
+    //! Conjugate gradient of the Poisson solvers preconditioned by multigrid (poisson_solver = "multigrid")
+    bool poisson_multigrid;
 
     //"Relativistic" Poisson solver
     //! Do we solve "relativistic poisson problem" for relativistic species
@@ -177,6 +181,8 @@ public:
     
     //! Maxwell Solver (default='Yee')
     std::string maxwell_sol;
+    //! Skip the Maxwell solvers on the patches where the fields and currents are zero
+    bool maxwell_skip_vacuum;
 
     //! Current spatial filter: number of binomial passes
     std::vector<unsigned int> currentFilter_passes;
@@ -266,6 +272,42 @@ public:
     
     //! frequency to apply shrinkToFit on particles structure
     int every_clean_particles_overhead;
+    
+    //! Extra capacity (relative to the number of particles) kept when cleaning the particles overhead
+    double particles_capacity_margin;
+    
+    //! Number of cleanings of the particles overhead used to forecast the imported particles (0 = no forecast)
+    unsigned int particles_forecast_length;
+    
+    //! Pack particles in contiguous buffers for MPI exchanges instead of creating MPI datatypes
+    bool pack_exchanged_particles;
+
+    //! Exchange the field halos with the neighbor MPI processes by MPI-3 neighborhood collectives
+    bool neighborhood_collectives;
+
+    //! Exchange the field halos with the MPI processes of the same node through a shared memory window
+    bool shared_memory_halos;
+
+    //! Send the sums of the currents of the patches along X as soon as their dynamics is done
+    bool overlap_current_sums;
+
+    //! Send only the extent of the current boundaries touched by the projection in the MPI messages of their sums
+    bool sparse_current_sums;
+
+    //! Number the MPI processes node by node (and socket by socket) along the Hilbert curve of the patches
+    bool topology_aware_placement;
+
+    //! Sort the particles of each bin by cell when their disorder slows down the scalar dynamics
+    bool adaptive_sorting;
+    
+    //! Order of the patches in the dynamics: "runtime" (OpenMP runtime schedule), "largest_first" or "numa_affinity"
+    std::string dynamics_scheduling;
+
+    //! Number of NUMA domains spanned by the OpenMP threads of each MPI process (dynamics_scheduling = "numa_affinity")
+    unsigned int numa_domains;
+
+    //! Hold the data of the fields of all the patches in a single array, in the order of the patches
+    bool fields_arena;
 
     //! Total number of patches
     unsigned int tot_number_of_patches;
@@ -287,15 +329,57 @@ public:
     double cell_load;
     //! Load coefficient applied to a frozen particle (default = 0.1)
     double frozen_particle_load;
+    //! Load coefficient applied to a cell of a patch without particles (default = cell_load)
+    double vacuum_cell_load;
     //! Return if number of patch = number of MPI process, to tune IO //ism
     bool one_patch_per_MPI;
     //! Compute an initially balanced patch distribution right from the start
     bool initial_balance;
+    //! Exchange the patches of the load balancing with one message per neighbor MPI process and round
+    bool batched_exchange;
+    //! Number of iterations of the exponential average of the measured wall time of each patch, used as its load
+    //! (0: load estimated from the particles and cells)
+    unsigned int measured_load_steps;
+    //! Number of iterations between two samples of the wall time of the particle operators of each patch and species
+    //! (DiagPerformances.operator_sampling_every, 0: no sampling)
+    unsigned int operator_sampling_every;
+    //! Hardware events counted in the main timers for DiagPerformances (empty: no counters)
+    std::vector<std::string> hardware_counters;
+    //! Imbalance (max/mean of the computation times of the MPI processes) above which the load is balanced
+    //! (0: the load is balanced at each iteration selected by "every")
+    double imbalance_threshold;
+    //! Memory of the patches (particles and fields) allowed per MPI process by the load balancing, in GB (0: no limit)
+    double memory_cap;
+    //! Throughput of an MPI process computing on GPU relative to a CPU process, in a job mixing both
+    double gpu_rank_capability;
 
     //! String containing the vectorization mode: off, on, adaptive, adaptive_mixed_sort
     std::string vectorization_mode;
     //! Initial state of the patches in adaptive mode
     std::string adaptive_default_mode;
+    //! Granularity of the operator choice in adaptive mode: "patch" or "cell"
+    std::string adaptive_granularity;
+    //! Cost model of the adaptive mode: "fit" (hard-coded fits) or "calibrated" (measured on the fly)
+    std::string adaptive_cost_model;
+    //! Number of reconfigurations between two calibrations of the cost model (0: only at start)
+    unsigned int adaptive_calibration_period;
+
+    //! Order of the cells of a patch for the vectorized species: "lexicographic", "hilbert" or "morton"
+    std::string cell_ordering;
+
+    //! Project the currents of the vectorized species by colors of non-overlapping blocks of cells,
+    //! the blocks of a color being distributed to the threads as OpenMP tasks
+    bool colored_deposition;
+
+    //! The vectorized interpolator exports the shape coefficients of the old position,
+    //! reused by the vectorized projector instead of computing them again
+    bool reuse_shape_coefficients;
+
+    //! The 3D 2nd-order vectorized projector accumulates the currents of each cell
+    //! in single precision with a compensated (Kahan) summation
+    bool float_accumulation;
+    //! The single-precision currents are compared to a double precision deposition (costly)
+    bool float_accumulation_check;
 
     //! Tells whether there is a moving window
     bool hasWindow;
@@ -316,6 +400,9 @@ public:
     //! Tells whether position_old is used
     bool keep_position_old;
 
+    //! Number of iterations between two pushes of the sub-cycled species (1 if none)
+    unsigned int species_push_every;
+
     //! Log2 of the number of patch in the whole simulation box in every direction.
     //! The number of patch in a given direction MUST be a power of 2 and is 2^(mi[i]).
     std::vector<unsigned int> mi;
@@ -333,6 +420,9 @@ public:
 
     //! every for the standard pic timeloop output
     unsigned int print_every;
+
+    //! every for the telemetry output (telemetry.jsonl), 0 if disabled
+    unsigned int telemetry_every;
     
     // Double grids parameters (particles and fields)
     void multiple_decompose();
@@ -349,9 +439,15 @@ public:
 
     //! Boolean for printing the expected disk usage or not
     bool print_expected_disk_usage;
+    
+    //! Number of iterations between the common I/O phases of the diagnostics (0 or 1 for none)
+    int diagnostics_window;
 
     //! Random seed
     unsigned int random_seed;
+
+    //! Reseed the random generators of the patches at each timestep with a counter-based generator
+    bool counter_based_random;
     
     //! True if python is needed during the PIC loop
     bool keep_python_running_;
@@ -0,0 +1,205 @@
+#include "PartCompTimeCalibrated.h"
+
+#include <map>
+#include <algorithm>
+
+#include "Particles.h"
+
+// Measurements of each species of the MPI process
+static std::map<unsigned int, PartCompTimeCalibrated::Table> &tables()
+{
+    static std::map<unsigned int, PartCompTimeCalibrated::Table> tables;
+    return tables;
+}
+
+PartCompTimeCalibrated::PartCompTimeCalibrated( PartCompTime *fit ) :
+    PartCompTime(),
+    fit_( fit ),
+    table_( NULL )
+{
+    // Time per particle of the fit, at the middle of each bucket
+    std::vector<int> cell_count( 1 );
+    for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+        cell_count[0] = ( ib == 0 ) ? 1 : ( ib == nbuckets-1 ) ? 256 : ( 3 << ib ) / 2;
+        float vecto_time = 0.;
+        float scalar_time = 0.;
+        ( *fit_ )( cell_count, vecto_time, scalar_time );
+        fit_cost_[1][ib] = vecto_time / cell_count[0];
+        fit_cost_[0][ib] = scalar_time / cell_count[0];
+        cost_[1][ib] = fit_cost_[1][ib];
+        cost_[0][ib] = fit_cost_[0][ib];
+    }
+}
+
+PartCompTimeCalibrated::~PartCompTimeCalibrated()
+{
+    delete fit_;
+}
+
+// -----------------------------------------------------------------------------
+//! Bind the model to the measurements of the species, shared by its patches
+// -----------------------------------------------------------------------------
+void PartCompTimeCalibrated::attach( unsigned int species_number )
+{
+    #pragma omp critical (part_comp_time_tables)
+    table_ = &tables()[species_number];
+}
+
+unsigned int PartCompTimeCalibrated::bucket( int count )
+{
+    unsigned int ib = 0;
+    while( ( count >> ( ib+1 ) ) > 0 && ib < nbuckets-1 ) {
+        ib++;
+    }
+    return ib;
+}
+
+// -----------------------------------------------------------------------------
+//! Record the measured time of the dynamics of all the bins of `particles`
+//! The normal equations are updated by all the threads of the process
+// -----------------------------------------------------------------------------
+void PartCompTimeCalibrated::record( const Particles &particles, bool vectorized, double time )
+{
+    if( !table_ ) {
+        return;
+    }
+
+    // Number of particles in each bucket of cells
+    double npart[nbuckets] = { 0. };
+    double npart_tot = 0.;
+    double fit_time = 0.;
+    for( unsigned int ibin=0 ; ibin<particles.first_index.size() ; ibin++ ) {
+        const int n = particles.last_index[ibin] - particles.first_index[ibin];
+        if( n > 0 ) {
+            npart[bucket( n )] += n;
+        }
+    }
+    for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+        npart_tot += npart[ib];
+        fit_time  += npart[ib] * fit_cost_[vectorized][ib];
+    }
+    if( npart_tot == 0. ) {
+        return;
+    }
+
+    for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+        if( npart[ib] == 0. ) {
+            continue;
+        }
+        for( unsigned int jb=0 ; jb<nbuckets ; jb++ ) {
+            if( npart[jb] > 0. ) {
+                #pragma omp atomic
+                table_->normal_matrix[vectorized][ib][jb] += npart[ib] * npart[jb];
+            }
+        }
+        #pragma omp atomic
+        table_->normal_rhs[vectorized][ib] += npart[ib] * time;
+    }
+    #pragma omp atomic
+    table_->measured_time[vectorized] += time;
+    #pragma omp atomic
+    table_->fit_time[vectorized] += fit_time;
+    #pragma omp atomic
+    table_->particles[vectorized] += npart_tot;
+}
+
+// -----------------------------------------------------------------------------
+//! Least squares costs of each mode, regularized towards the scaled fit:
+//! minimize |N c - T|^2 + lambda |c - s c_fit|^2, where s converts the fit into
+//! measured times. Buckets that were never measured keep the scaled fit.
+// -----------------------------------------------------------------------------
+void PartCompTimeCalibrated::updateCosts()
+{
+    if( !table_ ) {
+        return;
+    }
+
+    // Scale of the fit, common to both modes so that their comparison is preserved
+    const double fit_time = table_->fit_time[0] + table_->fit_time[1];
+    if( fit_time <= 0. ) {
+        return;
+    }
+    const double scale = ( table_->measured_time[0] + table_->measured_time[1] ) / fit_time;
+
+    for( unsigned int imode=0 ; imode<2 ; imode++ ) {
+        double a[nbuckets][nbuckets+1];
+        double trace = 0.;
+        for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+            trace += table_->normal_matrix[imode][ib][ib];
+        }
+        const double lambda = 1.e-3 * trace / nbuckets + 1.;
+        for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+            for( unsigned int jb=0 ; jb<nbuckets ; jb++ ) {
+                a[ib][jb] = table_->normal_matrix[imode][ib][jb];
+            }
+            a[ib][ib] += lambda;
+            a[ib][nbuckets] = table_->normal_rhs[imode][ib] + lambda * scale * fit_cost_[imode][ib];
+        }
+
+        // Gaussian elimination (the matrix is symmetric positive definite)
+        for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+            for( unsigned int jb=ib+1 ; jb<nbuckets ; jb++ ) {
+                const double f = a[jb][ib] / a[ib][ib];
+                for( unsigned int kb=ib ; kb<=nbuckets ; kb++ ) {
+                    a[jb][kb] -= f * a[ib][kb];
+                }
+            }
+        }
+        for( int ib=nbuckets-1 ; ib>=0 ; ib-- ) {
+            double c = a[ib][nbuckets];
+            for( unsigned int jb=ib+1 ; jb<nbuckets ; jb++ ) {
+                c -= a[ib][jb] * cost_[imode][jb];
+            }
+            cost_[imode][ib] = c / a[ib][ib];
+        }
+        for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+            cost_[imode][ib] = std::max( cost_[imode][ib], 0. );
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Evaluate the time to compute all particles in the current patch
+//! @param count the numer of particles per cell
+//! @aram vecto_time time in vector mode
+//! @aram scalar_time time in scalar mode
+// -----------------------------------------------------------------------------
+void PartCompTimeCalibrated::operator()( const std::vector<int> &count,
+        float &vecto_time,
+        float &scalar_time )
+{
+    updateCosts();
+
+    double npart[nbuckets] = { 0. };
+    for( unsigned int ic=0; ic < count.size(); ic++ ) {
+        if( count[ic] > 0 ) {
+            npart[bucket( count[ic] )] += count[ic];
+        }
+    }
+    double vecto_time_loc = 0.;
+    double scalar_time_loc = 0.;
+    for( unsigned int ib=0 ; ib<nbuckets ; ib++ ) {
+        vecto_time_loc  += npart[ib] * cost_[1][ib];
+        scalar_time_loc += npart[ib] * cost_[0][ib];
+    }
+    vecto_time  = vecto_time_loc;
+    scalar_time = scalar_time_loc;
+}
+
+// -----------------------------------------------------------------------------
+//! Calibrated time per particle in a cell of `count` particles
+//! (uses the costs of the last call to operator())
+// -----------------------------------------------------------------------------
+double PartCompTimeCalibrated::particleTime( int count, bool vectorized )
+{
+    return cost_[vectorized][bucket( count )];
+}
+
+double PartCompTimeCalibrated::meanParticleTime() const
+{
+    if( !table_ ) {
+        return 0.;
+    }
+    const double npart = table_->particles[0] + table_->particles[1];
+    return npart > 0. ? ( table_->measured_time[0] + table_->measured_time[1] ) / npart : 0.;
+}
@@ -0,0 +1,87 @@
+#ifndef PARTCOMPTIMECALIBRATED_H
+#define PARTCOMPTIMECALIBRATED_H
+
+#include "PartCompTime.h"
+
+class Particles;
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class PartCompTimeCalibrated
+//
+//! Cost model of the adaptive vectorization calibrated on the current hardware.
+//! The measured times of the dynamics of whole patches are fitted, by least squares,
+//! with a cost per particle for each bucket of particles per cell and each mode
+//! (scalar or vectorized). The hard-coded fit is used as a prior, scaled to the
+//! measured times, so that the buckets without measurements keep a sensible cost.
+//! The measurements are shared by all the patches of a species in the MPI process.
+//  --------------------------------------------------------------------------------------------------------------------
+class PartCompTimeCalibrated final : public PartCompTime
+{
+public:
+    //! Number of buckets of particles per cell: [1], [2,3], [4,7], ..., [256,inf[
+    static const unsigned int nbuckets = 9;
+
+    //! Measurements of a species, accumulated as the normal equations of the least squares fit
+    struct Table {
+        double normal_matrix[2][nbuckets][nbuckets];
+        double normal_rhs[2][nbuckets];
+        double measured_time[2];
+        double fit_time[2];
+        double particles[2];
+    };
+
+    //! The fit `fit` (owned) is used as a prior
+    PartCompTimeCalibrated( PartCompTime *fit );
+    ~PartCompTimeCalibrated() override final;
+
+    // -------------------------------------------------------------------------
+    //! Evaluate the time to compute all particles of the current patch
+    //! in both modes from the calibrated costs
+    //! @param count the numer of particles per cell
+    //! @aram vecto_time time in vector mode
+    //! @aram scalar_time time in scalar mode
+    // -------------------------------------------------------------------------
+    void operator() ( const std::vector<int> &count,
+                      float &vecto_time,
+                      float &scalar_time ) override final;
+
+    //! Bind the model to the measurements shared by all the patches of the species
+    void attach( unsigned int species_number );
+
+    //! True once the model is bound to the measurements of its species
+    inline bool attached() const
+    {
+        return table_ != NULL;
+    }
+
+    //! Record the measured time of one dynamics of the bins of `particles` in one mode
+    void record( const Particles &particles, bool vectorized, double time );
+
+    //! Calibrated time per particle in a cell of `count` particles (costs of the last evaluation)
+    double particleTime( int count, bool vectorized );
+
+    //! Mean measured time per particle, or 0 without measurement
+    double meanParticleTime() const;
+
+private:
+
+    //! Bucket of a number of particles per cell
+    static unsigned int bucket( int count );
+
+    //! Solve the least squares problem of each mode into cost_
+    void updateCosts();
+
+    //! Fit of the hardware used as a prior
+    PartCompTime *fit_;
+
+    //! Measurements of the species (shared, owned by tables())
+    Table *table_;
+
+    //! Time per particle given by the fit in each mode and bucket
+    double fit_cost_[2][nbuckets];
+
+    //! Calibrated time per particle in each mode and bucket
+    double cost_[2][nbuckets];
+};
+
+#endif
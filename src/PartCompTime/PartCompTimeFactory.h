@@ -8,6 +8,7 @@
 #include "PartCompTime3D2Order.h"
 #include "PartCompTime3D4Order.h"
 #include "PartCompTimeAM2Order.h"
+#include "PartCompTimeCalibrated.h"
 
 #include "Params.h"
 #include "Tools.h"
@@ -74,6 +75,11 @@ public:
              << params.geometry << ", Order : " << params.interpolation_order,
             LINK_NAMELIST + std::string("#main-variables"));
         }
+
+        // The fit becomes the prior of the model calibrated on the current hardware
+        if( part_comp_time && params.adaptive_cost_model == "calibrated" ) {
+            part_comp_time = new PartCompTimeCalibrated( part_comp_time );
+        }
         
         return part_comp_time;
     } // end PartCompTime::create
@@ -495,8 +495,221 @@ void stop_particle_AM( Species *species, int imin, int imax, int /*direction*/,
     
 }
 
+namespace
+{
+    //! Inverse cumulative distribution of the momenta along the thermalizing boundaries (in units of the thermal momentum):
+    //! erfinv(u), tabulated once for u in [0, tail] (interpolation error below 1e-4), and computed exactly above
+    struct ThermalTangentTable {
+        static constexpr int size = 2048;
+        static constexpr double tail = 0.99;
+        double values[size+2];
+
+        ThermalTangentTable()
+        {
+            for( int i = 0; i <= size+1; i++ ) {
+                values[i] = userFunctions::erfinv_dp( std::min( i * tail / size, 1. - 1e-11 ) );
+            }
+        }
+    };
+
+    const ThermalTangentTable &thermalTangentTable()
+    {
+        static const ThermalTangentTable table;
+        return table;
+    }
+
+    //! Number of particles thermalized together
+    constexpr int thermal_buffer_size = 32;
+
+    //! Thermalizing boundary of a species along a direction (on the host).
+    //! The particles crossing the boundary are gathered in buffers. For each buffer, the random numbers are drawn first,
+    //! in the same order as the particle-by-particle algorithm, then the new momenta are computed in vectorized loops.
+    class ThermalBoundary
+    {
+    public:
+        ThermalBoundary( Species *species, int direction ) :
+            table_( thermalTangentTable() ),
+            nDim_( species->nDim_particle )
+        {
+            position_   = species->particles->getPtrPosition( direction );
+            momentum_   = species->particles->getPtrMomentum( direction );
+            momentum1_  = species->particles->getPtrMomentum( ( direction+1 )%nDim_ );
+            momentum2_  = species->particles->getPtrMomentum( ( direction+2 )%nDim_ );
+            momentum_x_ = species->particles->getPtrMomentum( 0 );
+            momentum_y_ = species->particles->getPtrMomentum( 1 );
+            momentum_z_ = species->particles->getPtrMomentum( 2 );
+            weight_     = species->particles->getPtrWeight();
+            thermal_momentum_  = species->thermal_momentum_[direction];
+            thermal_momentum1_ = nDim_ > 1 ? species->thermal_momentum_[( direction+1 )%nDim_] : 0.;
+            thermal_momentum2_ = nDim_ > 2 ? species->thermal_momentum_[( direction+2 )%nDim_] : 0.;
+            v0_ = species->thermal_velocity_[0];
+            // mean-velocity
+            vx_ = -species->thermal_boundary_velocity_[0];
+            vy_ = -species->thermal_boundary_velocity_[1];
+            vz_ = -species->thermal_boundary_velocity_[2];
+            v2_ = vx_*vx_ + vy_*vy_ + vz_*vz_;
+            if( v2_ > 0. ) {
+                g_ = 1.0/sqrt( 1.0-v2_ );
+                double gm1 = g_ - 1.0;
+                // compute the different component of the Matrix block of the Lorentz transformation
+                Lxx_ = 1.0 + gm1 * vx_*vx_/v2_;
+                Lyy_ = 1.0 + gm1 * vy_*vy_/v2_;
+                Lzz_ = 1.0 + gm1 * vz_*vz_/v2_;
+                Lxy_ = gm1 * vx_*vy_/v2_;
+                Lxz_ = gm1 * vx_*vz_/v2_;
+                Lyz_ = gm1 * vy_*vz_/v2_;
+            }
+        }
+
+        //! Position along the direction of the boundary
+        inline double *position() const
+        {
+            return position_;
+        }
+
+        //! Thermalizes or reflects the n particles of index[] (n <= thermal_buffer_size) with respect to the plane at limit.
+        //! Returns the energy lost.
+        double apply( const int *const index, int n, double limit, Random *rand ) const
+        {
+            double initial_energy[thermal_buffer_size];
+            int thermalize[thermal_buffer_size];
+            double u[thermal_buffer_size], u1[thermal_buffer_size], u2[thermal_buffer_size];
+            double perp1[thermal_buffer_size], perp2[thermal_buffer_size];
+
+            // Particles faster than 3 times the thermal velocity are thermalized, the others are reflected
+            #pragma omp simd
+            for( int k = 0; k < n; k++ ) {
+                const int ipart = index[k];
+                const double p2 = momentum_x_[ipart] * momentum_x_[ipart] + momentum_y_[ipart] * momentum_y_[ipart] + momentum_z_[ipart] * momentum_z_[ipart];
+                const double LorentzFactor = sqrt( 1.+p2 );
+                initial_energy[k] = LorentzFactor - 1.0;
+                thermalize[k] = sqrt( p2 )/LorentzFactor > 3.0 * v0_;
+            }
+
+            // Random numbers
+            for( int k = 0; k < n; k++ ) {
+                if( thermalize[k] ) {
+                    u[k] = rand->uniform1();
+                    if( nDim_ > 1 ) {
+                        u1[k] = rand->uniform1();
+                        perp1[k] = rand->cointoss() ? -1. : 1.;
+                        if( nDim_ > 2 ) {
+                            u2[k] = rand->uniform1();
+                            perp2[k] = rand->cointoss() ? -1. : 1.;
+                        }
+                    }
+                } else {
+                    u[k] = 0.;
+                    u1[k] = 0.;
+                    u2[k] = 0.;
+                    perp1[k] = 0.;
+                    perp2[k] = 0.;
+                }
+            }
+
+            // Momenta along the boundary from the tabulated inverse cumulative distribution
+            if( nDim_ > 1 ) {
+                tangentMomentum( u1, perp1, n );
+                if( nDim_ > 2 ) {
+                    tangentMomentum( u2, perp2, n );
+                }
+            }
+
+            double change_in_energy = 0.;
+            #pragma omp simd reduction(+ : change_in_energy)
+            for( int k = 0; k < n; k++ ) {
+                const int ipart = index[k];
+                if( thermalize[k] ) {
+                    // change of velocity in the direction normal to the reflection plane
+                    double sign_vel = -momentum_[ ipart ]/std::abs( momentum_[ ipart ] );
+                    momentum_[ ipart ] = sign_vel * thermal_momentum_ * std::sqrt( -std::log( 1.0 - u[k] ) );
+                    // change of momentum in the direction(s) along the reflection plane
+                    if( nDim_ > 1 ) {
+                        momentum1_[ ipart ] = thermal_momentum1_ * perp1[k];
+                        if( nDim_ > 2 ) {
+                            momentum2_[ ipart ] = thermal_momentum2_ * perp2[k];
+                        }
+                    }
+                    // Adding the mean velocity (using relativistic composition)
+                    if( v2_ > 0. ) {
+                        const double gp = sqrt( 1.0 + momentum_x_[ipart] * momentum_x_[ipart] + momentum_y_[ipart] * momentum_y_[ipart] + momentum_z_[ipart] * momentum_z_[ipart] );
+                        const double px = -gp*g_*vx_ + Lxx_ * momentum_x_[ ipart ] + Lxy_ * momentum_y_[ ipart ] + Lxz_ * momentum_z_[ ipart ];
+                        const double py = -gp*g_*vy_ + Lxy_ * momentum_x_[ ipart ] + Lyy_ * momentum_y_[ ipart ] + Lyz_ * momentum_z_[ ipart ];
+                        const double pz = -gp*g_*vz_ + Lxz_ * momentum_x_[ ipart ] + Lyz_ * momentum_y_[ ipart ] + Lzz_ * momentum_z_[ ipart ];
+                        momentum_x_[ ipart ] = px;
+                        momentum_y_[ ipart ] = py;
+                        momentum_z_[ ipart ] = pz;
+                    }
+                } else {
+                    momentum_[ ipart ] = -momentum_[ ipart ];
+                }
+
+                // position of the particle after reflection
+                position_[ ipart ] = 2.*limit - position_[ ipart ];
+
+                // energy lost during thermalization
+                const double LorentzFactor = sqrt( 1. + momentum_x_[ipart] * momentum_x_[ipart] + momentum_y_[ipart] * momentum_y_[ipart] + momentum_z_[ipart] * momentum_z_[ipart] );
+                change_in_energy += weight_[ ipart ] * ( initial_energy[k] - LorentzFactor + 1.0 );
+            }
+            return change_in_energy;
+        }
+
+    private:
+        //! Multiplies the signs perp[] by the inverse cumulative distribution at u[]
+        inline void tangentMomentum( const double *const u, double *const perp, int n ) const
+        {
+            constexpr double scale = ThermalTangentTable::size / ThermalTangentTable::tail;
+            #pragma omp simd
+            for( int k = 0; k < n; k++ ) {
+                const double x = std::min( u[k] * scale, ( double )ThermalTangentTable::size );
+                const int i = ( int )x;
+                perp[k] *= table_.values[i] + ( x - i ) * ( table_.values[i+1] - table_.values[i] );
+            }
+            for( int k = 0; k < n; k++ ) {
+                if( u[k] > ThermalTangentTable::tail ) {
+                    perp[k] = std::copysign( userFunctions::erfinv_dp( u[k] ), perp[k] );
+                }
+            }
+        }
+
+        const ThermalTangentTable &table_;
+        int nDim_;
+        double *position_, *momentum_, *momentum1_, *momentum2_, *momentum_x_, *momentum_y_, *momentum_z_, *weight_;
+        double thermal_momentum_, thermal_momentum1_, thermal_momentum2_, v0_;
+        double vx_, vy_, vz_, v2_, g_, Lxx_, Lyy_, Lzz_, Lxy_, Lxz_, Lyz_;
+    };
+
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    //! Thermalizes the particles imin to imax-1 beyond limit (inf) or above limit (sup)
+    double thermalize_particles( Species *species, int imin, int imax, int direction, double limit, bool inf, Random *rand )
+    {
+        const ThermalBoundary boundary( species, direction );
+        const double *const position = boundary.position();
+        int index[thermal_buffer_size];
+        int n = 0;
+        double change_in_energy = 0.;
+        for( int ipart = imin; ipart < imax; ipart++ ) {
+            if( inf ? position[ipart] < limit : position[ipart] >= limit ) {
+                index[n++] = ipart;
+                if( n == thermal_buffer_size ) {
+                    change_in_energy += boundary.apply( index, n, limit, rand );
+                    n = 0;
+                }
+            }
+        }
+        if( n > 0 ) {
+            change_in_energy += boundary.apply( index, n, limit, rand );
+        }
+        return change_in_energy;
+    }
+#endif
+}
+
 void thermalize_particle_inf( Species *species, int imin, int imax, int direction, double limit_inf, double /*dt*/, std::vector<double> &/*invgf*/, Random * rand, double &energy_change )
 {
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    energy_change = thermalize_particles( species, imin, imax, direction, limit_inf, true, rand );
+#else
     int nDim = species->nDim_particle;
     double* position = species->particles->getPtrPosition(direction);
     double* momentum = species->particles->getPtrMomentum(direction);
@@ -658,10 +871,14 @@ void thermalize_particle_inf( Species *species, int imin, int imax, int directio
     xorshift32_state += 32;
     rand->xorshift32_state = xorshift32_state;
 #endif
+#endif
 }
 
 void thermalize_particle_sup( Species *species, int imin, int imax, int direction, double limit_sup, double /*dt*/, std::vector<double> &/*invgf*/, Random * rand, double &energy_change )
 {
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    energy_change = thermalize_particles( species, imin, imax, direction, limit_sup, false, rand );
+#else
     int nDim = species->nDim_particle;
     double* position = species->particles->getPtrPosition(direction);
     double* momentum = species->particles->getPtrMomentum(direction);
@@ -825,110 +1042,31 @@ void thermalize_particle_sup( Species *species, int imin, int imax, int directio
     xorshift32_state += 32;
     rand->xorshift32_state = xorshift32_state;
 #endif
+#endif
 }
 
 
 void thermalize_particle_wall( Species *species, int imin, int imax, int direction, double wall_position, double dt, std::vector<double> &invgf, Random * rand, double &energy_change )
 {
-    int nDim = species->nDim_particle;
-    double* position = species->particles->getPtrPosition(direction);
-    double* momentum = species->particles->getPtrMomentum(direction);
-    double* momentumRefl_2D = species->particles->getPtrMomentum((direction+1)%nDim);
-    double* momentumRefl_3D = species->particles->getPtrMomentum((direction+2)%nDim);
-    double* momentum_x = species->particles->getPtrMomentum(0);
-    double* momentum_y = species->particles->getPtrMomentum(1);
-    double* momentum_z = species->particles->getPtrMomentum(2);
-    double* weight     = species->particles->getPtrWeight();
+    const ThermalBoundary boundary( species, direction );
+    const double *const position = boundary.position();
+    const double *const momentum = species->particles->getPtrMomentum( direction );
+    int index[thermal_buffer_size];
+    int n = 0;
 
     energy_change = 0;
     for (int ipart=imin ; ipart<imax ; ipart++ ) {
         double particle_position     = position[ipart];
-        double particle_position_old = particle_position - dt*invgf[ipart]*species->particles->Momentum[direction][ipart];
+        double particle_position_old = particle_position - dt*invgf[ipart]*momentum[ipart];
         if ( ( wall_position-particle_position_old )*( wall_position-particle_position )<0 ) {
-            // checking the particle's velocity compared to the thermal one
-            double p2 = momentum_x[ipart] * momentum_x[ipart] + momentum_y[ipart] * momentum_y[ipart] + momentum_z[ipart] * momentum_z[ipart];
-            double LorentzFactor = sqrt( 1.+p2 );
-            double v = sqrt( p2 )/LorentzFactor;
-
-            // energy before thermalization
-            double initial_energy = LorentzFactor-1.0;
-
-            // Apply bcs depending on the particle velocity
-            // --------------------------------------------
-            if( v>3.0*species->thermal_velocity_[0] ) {     //IF VELOCITY > 3*THERMAL VELOCITY THEN THERMALIZE IT
-
-                // velocity of the particle after thermalization/reflection
-                //for (int i=0; i<species->nDim_fields; i++) {
-
-                // change of velocity in the direction normal to the reflection plane
-                double sign_vel = -momentum[ ipart ]/std::abs( momentum[ ipart ] );
-                momentum[ ipart ] = sign_vel * species->thermal_momentum_[direction]
-                    *                             std::sqrt( -std::log( 1.0-rand->uniform1() ) );
-
-                // change of momentum in the direction(s) along the reflection plane
-                if (nDim>1) {
-                    momentumRefl_2D[ ipart ] = species->thermal_momentum_[(direction+1)%nDim] * perp_rand( rand );
-                    if (nDim>2) {
-                        momentumRefl_3D[ ipart ] = species->thermal_momentum_[(direction+2)%nDim] * perp_rand( rand );
-                    }
-                }
-
-                // Adding the mean velocity (using relativistic composition)
-                double vx, vy, vz, v2, g, gm1, Lxx, Lyy, Lzz, Lxy, Lxz, Lyz, gp, px, py, pz;
-                // mean-velocity
-                vx  = -species->thermal_boundary_velocity_[0];
-                vy  = -species->thermal_boundary_velocity_[1];
-                vz  = -species->thermal_boundary_velocity_[2];
-                v2  = vx*vx + vy*vy + vz*vz;
-                if( v2>0. ) {
-
-                    g   = 1.0/sqrt( 1.0-v2 );
-                    gm1 = g - 1.0;
-
-                    // compute the different component of the Matrix block of the Lorentz transformation
-                    Lxx = 1.0 + gm1 * vx*vx/v2;
-                    Lyy = 1.0 + gm1 * vy*vy/v2;
-                    Lzz = 1.0 + gm1 * vz*vz/v2;
-                    Lxy = gm1 * vx*vy/v2;
-                    Lxz = gm1 * vx*vz/v2;
-                    Lyz = gm1 * vy*vz/v2;
-
-                    // Lorentz transformation of the momentum
-                    gp = sqrt( 1.0 + momentum_x[ipart] * momentum_x[ipart] + momentum_y[ipart] * momentum_y[ipart] + momentum_z[ipart] * momentum_z[ipart] );
-                    px = -gp*g*vx + Lxx * momentum_x[ ipart ] + Lxy * momentum_y[ ipart ] + Lxz * momentum_z[ ipart ];
-                    py = -gp*g*vy + Lxy * momentum_x[ ipart ] + Lyy * momentum_y[ ipart ] + Lyz * momentum_z[ ipart ];
-                    pz = -gp*g*vz + Lxz * momentum_x[ ipart ] + Lyz * momentum_y[ ipart ] + Lzz * momentum_z[ ipart ];
-                    momentum_x[ ipart ] = px;
-                    momentum_y[ ipart ] = py;
-                    momentum_z[ ipart ] = pz;
-
-                }//ENDif vel != 0
-
-            } else {                                    // IF VELOCITY < 3*THERMAL SIMPLY REFLECT IT
-                momentum[ ipart ] = -momentum[ ipart ];
-
-            }// endif on v vs. thermal_velocity_
-
-            // position of the particle after reflection
-            position[ ipart ] = 2.*wall_position - position[ ipart ];
-
-            // energy lost during thermalization
-            LorentzFactor = sqrt( 1. + momentum_x[ipart] * momentum_x[ipart] + momentum_y[ipart] * momentum_y[ipart] + momentum_z[ipart] * momentum_z[ipart] );
-            energy_change += weight[ ipart ]*( initial_energy - LorentzFactor+1.0 );
-
-
-            /* HERE IS AN ATTEMPT TO INTRODUCE A SPACE DEPENDENCE ON THE BCs
-            // double val_min(params.dens_profile.vacuum_length[1]), val_max(params.dens_profile.vacuum_length[1]+params.dens_profile.length_params_y[0]);
-
-            if ( ( species->particles->position(1,ipart) >= val_min ) && ( species->particles->position(1,ipart) <= val_max ) ) {
-            // nrj computed during diagnostics
-            species->particles->position(direction, ipart) = limit_pos - species->particles->position(direction, ipart);
-            species->particles->momentum(direction, ipart) = sqrt(params.thermal_velocity_[direction]) * tabFcts.erfinv( rand->uniform() );
+            index[n++] = ipart;
+            if( n == thermal_buffer_size ) {
+                energy_change += boundary.apply( index, n, wall_position, rand );
+                n = 0;
             }
-            else {
-            stop_particle( species->particles, ipart, direction, limit_pos, params, energy_change );
-            }
-            */
         }
     }
+    if( n > 0 ) {
+        energy_change += boundary.apply( index, n, wall_position, rand );
+    }
 }
@@ -37,6 +37,7 @@ public:
     //! Conditions along X are applied first, then Y, then Z.
     inline void apply( Species *species, int imin, int imax, std::vector<double> &invgf, Random *rand, double &energy_tot )
     {
+#if defined( SMILEI_ACCELERATOR_GPU )
         if( parameters_->isGPUParticleBinningAvailable() ) {
             // EMPTY because we need the keys NOT to be cleared for the gpu particle clustering/binning.
             // We use the cellkeys to know if which particle left it's bin
@@ -73,6 +74,65 @@ public:
                 energy_tot += energy_change;
             }
         }
+#else
+        if( imin >= imax ) {
+            return;
+        }
+
+        // All conditions only act on the particles beyond their limit.
+        // The keys are reset and the extent of the particles is computed in a single vectorized pass,
+        // so that the conditions are called only for the bins with particles beyond a limit
+        // (a few bins at the edges of the patch), and the other bins are not read again.
+        // A condition only modifies the positions along its own direction, so the extents remain valid.
+        int *const cell_keys = species->particles->getPtrCellKeys();
+        if( ! parameters_->isGPUParticleBinningAvailable() ) {
+            #pragma omp simd
+            for( int ipart = imin; ipart < imax; ipart++ ) {
+                cell_keys[ipart] = 0;
+            }
+        }
+        double lower[3], upper[3];
+        extent( species->particles->getPtrPosition( 0 ), imin, imax, lower[0], upper[0] );
+        if( isAM ) {
+            radialExtent( species->particles->getPtrPosition( 1 ), species->particles->getPtrPosition( 2 ), imin, imax, lower[1], upper[1] );
+        } else if( nDim_particle >= 2 ) {
+            extent( species->particles->getPtrPosition( 1 ), imin, imax, lower[1], upper[1] );
+            if( nDim_particle == 3 ) {
+                extent( species->particles->getPtrPosition( 2 ), imin, imax, lower[2], upper[2] );
+            }
+        }
+
+        double energy_change = 0.;
+        if( lower[0] < x_min ) {
+            ( *bc_xmin )( species, imin, imax, 0, x_min, dt_, invgf, rand, energy_change );
+            energy_tot += energy_change;
+        }
+        if( upper[0] >= x_max ) {
+            ( *bc_xmax )( species, imin, imax, 0, x_max, dt_, invgf, rand, energy_change );
+            energy_tot += energy_change;
+        }
+        if( nDim_particle >= 2 ) {
+            // In AM, the radial limits are compared to the squared distance to the axis
+            if( isAM ? lower[1] < y_min*y_min : lower[1] < y_min ) {
+                ( *bc_ymin )( species, imin, imax, 1, y_min, dt_, invgf, rand, energy_change );
+                energy_tot += energy_change;
+            }
+            if( isAM ? upper[1] >= y_max*y_max : upper[1] >= y_max ) {
+                ( *bc_ymax )( species, imin, imax, 1, y_max, dt_, invgf, rand, energy_change );
+                energy_tot += energy_change;
+            }
+            if( ( nDim_particle == 3 ) && (!isAM) ) {
+                if( lower[2] < z_min ) {
+                    ( *bc_zmin )( species, imin, imax, 2, z_min, dt_, invgf, rand, energy_change );
+                    energy_tot += energy_change;
+                }
+                if( upper[2] >= z_max ) {
+                    ( *bc_zmax )( species, imin, imax, 2, z_max, dt_, invgf, rand, energy_change );
+                    energy_tot += energy_change;
+                }
+            }
+        }
+#endif
     }
 
     ////! Set the condition window if restart (patch position not read)
@@ -101,6 +161,33 @@ private:
 
     double dt_;
     const Params *parameters_;
+
+    //! Minimum and maximum of the positions of the particles imin to imax-1
+    static inline void extent( const double *const position, int imin, int imax, double &lower, double &upper )
+    {
+        double lo = position[imin], up = position[imin];
+        #pragma omp simd reduction(min:lo) reduction(max:up)
+        for( int ipart = imin; ipart < imax; ipart++ ) {
+            lo = std::min( lo, position[ipart] );
+            up = std::max( up, position[ipart] );
+        }
+        lower = lo;
+        upper = up;
+    }
+
+    //! Minimum and maximum of the squared distance to the axis of the particles imin to imax-1 (AM)
+    static inline void radialExtent( const double *const y, const double *const z, int imin, int imax, double &lower, double &upper )
+    {
+        double lo = y[imin]*y[imin] + z[imin]*z[imin], up = lo;
+        #pragma omp simd reduction(min:lo) reduction(max:up)
+        for( int ipart = imin; ipart < imax; ipart++ ) {
+            const double r2 = y[ipart]*y[ipart] + z[ipart]*z[ipart];
+            lo = std::min( lo, r2 );
+            up = std::max( up, r2 );
+        }
+        lower = lo;
+        upper = up;
+    }
 };
 
 #endif
@@ -81,6 +81,23 @@ public:
     //! Pointer toward regular number of particles array
     std::vector<int> regular_number_array_;
 
+    //! Values of the profiles in the injection cells of the patch, computed at the first injection
+    //! and re-used as long as the patch does not move (the profiles only depend on space,
+    //! the time profile is applied afterwards)
+    struct ProfileCache {
+        ProfileCache() : valid_( false ) {};
+        bool valid_;
+        //! Origin of the patch and injection cells of the cached values
+        double patch_min_[3];
+        unsigned int cell_index_[3], box_size_[3];
+        //! Temperature, velocity and charge in each cell
+        std::vector<double> temperature_[3], velocity_[3], charge_;
+        //! Number of particles and density (without the time profile) in each cell
+        std::vector<double> n_part_in_cell_, density_;
+        double max_charge_;
+        unsigned int n_new_particles_;
+    } profile_cache_;
+
     // -----------------------------------------------------------------------------
     //  3. Methods
 
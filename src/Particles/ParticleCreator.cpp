@@ -19,6 +19,7 @@ ParticleCreator::ParticleCreator()
     disable_position_initialization_    = false;
     initialized_in_species_ = true;
     time_profile_ = NULL;
+    particle_injector_ = NULL;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -54,6 +55,8 @@ void ParticleCreator::associate( ParticleInjector * particle_injector, Particles
 
     particles_ = particles;
 
+    particle_injector_ = particle_injector;
+
     // If we do not use the particles object associated to the species
     if (&particles_ != &species->particles)
     {
@@ -90,6 +93,8 @@ void ParticleCreator::associate( Species * species)
 
     particles_ = species->particles;
 
+    particle_injector_ = NULL;
+
     position_initialization_ = species->position_initialization_;
     position_initialization_on_species_ = species->position_initialization_on_species_;
     disable_position_initialization_    = species->position_initialization_on_species_;
@@ -124,15 +129,37 @@ int ParticleCreator::create( struct SubSpace sub_space,
     std::vector<double> cell_position( 3, 0 );
     std::vector<double> cell_index( 3, 0 );
     std::vector<double> global_origin( 3, 0. );
-    std::vector<Field *> xyz( species_->nDim_field );
+    std::vector<Field *> xyz( species_->nDim_field, NULL );
     for( unsigned int idim=0 ; idim<species_->nDim_field ; idim++ ) {
         cell_position[idim] = patch->getDomainLocalMin( idim );
         cell_index   [idim] = ( double ) patch->getCellStartingGlobalIndex( idim );
-        xyz[idim] = new Field3D( n_space_to_create );
     }
+
+    // The profiles of an injector only depend on space: their values in the injection cells
+    // are kept from the first injection, and re-used while the patch does not move
+    ParticleInjector::ProfileCache *cache = NULL;
+    bool cached = false;
+    if( particle_injector_
+     && species_->momentum_initialization_array_ == NULL && species_->file_momentum_npart_ == 0
+     && species_->position_initialization_array_ == NULL && species_->file_position_npart_ == 0 ) {
+        cache = &particle_injector_->profile_cache_;
+        cached = cache->valid_;
+        for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+            cached = cached
+                     && cache->patch_min_[idim] == cell_position[idim]
+                     && cache->cell_index_[idim] == sub_space.cell_index_[idim]
+                     && cache->box_size_[idim] == sub_space.box_size_[idim];
+        }
+    }
+
     // Create the x,y,z maps where profiles will be evaluated
+    if( ! cached ) {
+        for( unsigned int idim=0 ; idim<species_->nDim_field ; idim++ ) {
+            xyz[idim] = new Field3D( n_space_to_create );
+        }
+    }
     std::vector<double> ijk( 3 );
-    for( ijk[0]=0; ijk[0]<sub_space.box_size_[0]; ijk[0]++ ) {
+    for( ijk[0]=0; ijk[0]<( cached ? 0 : sub_space.box_size_[0] ); ijk[0]++ ) {
         for( ijk[1]=0; ijk[1]<sub_space.box_size_[1]; ijk[1]++ ) {
             for( ijk[2]=0; ijk[2]<sub_space.box_size_[2]; ijk[2]++ ) {
                 for( unsigned int idim=0 ; idim<species_->nDim_field ; idim++ ) {
@@ -156,14 +183,18 @@ int ParticleCreator::create( struct SubSpace sub_space,
         // Get velocity and temperature profiles
         for( unsigned int m=0; m<3; m++ ) {
             temperature[m].allocateDims( n_space_to_create );
-            if( temperature_profile_[m] ) {
+            if( cached ) {
+                std::copy( cache->temperature_[m].begin(), cache->temperature_[m].end(), temperature[m].data_ );
+            } else if( temperature_profile_[m] ) {
                 temperature_profile_[m]->valuesAt( xyz, global_origin, temperature[m] );
             } else {
                 temperature[m].put_to( 0.0000000001 ); // default value
             }
 
             velocity[m].allocateDims( n_space_to_create );
-            if( velocity_profile_[m] ) {
+            if( cached ) {
+                std::copy( cache->velocity_[m].begin(), cache->velocity_[m].end(), velocity[m].data_ );
+            } else if( velocity_profile_[m] ) {
                 velocity_profile_[m]->valuesAt( xyz, global_origin, velocity[m] );
             } else {
                 velocity[m].put_to( 0.0 ); //default value
@@ -176,7 +207,10 @@ int ParticleCreator::create( struct SubSpace sub_space,
     species_->max_charge_ = -1;
 
     charge.allocateDims( n_space_to_create );
-    if( species_->mass_ > 0 ) {
+    if( cached ) {
+        std::copy( cache->charge_.begin(), cache->charge_.end(), charge.data_ );
+        species_->max_charge_ = cache->max_charge_;
+    } else if( species_->mass_ > 0 ) {
         // Initialize charge profile
         species_->charge_profile_->valuesAt( xyz, global_origin, charge );
         // Find max charge
@@ -201,16 +235,22 @@ int ParticleCreator::create( struct SubSpace sub_space,
         // Get density and ppc profiles
         density.allocateDims( n_space_to_create );
         n_part_in_cell.allocateDims( n_space_to_create );
-        density_profile_->valuesAt( xyz, global_origin, density );
-        particles_per_cell_profile_->valuesAt( xyz, global_origin, n_part_in_cell );
         // Take into account the time profile
         double time_amplitude = 1.;
         if( time_profile_ ) {
             time_amplitude = time_profile_->valueAt( itime*params.timestep );
         }
+        if( cached ) {
+            std::copy( cache->density_.begin(), cache->density_.end(), density.data_ );
+            std::copy( cache->n_part_in_cell_.begin(), cache->n_part_in_cell_.end(), n_part_in_cell.data_ );
+            n_new_particles = cache->n_new_particles_;
+        } else {
+            density_profile_->valuesAt( xyz, global_origin, density );
+            particles_per_cell_profile_->valuesAt( xyz, global_origin, n_part_in_cell );
+        }
         // Loop cells
         double remainder, nppc;
-        for( unsigned int i=0; i< sub_space.box_size_[0]; i++ ) {
+        for( unsigned int i=0; i< ( cached ? 0 : sub_space.box_size_[0] ); i++ ) {
             for( unsigned int j=0; j< sub_space.box_size_[1]; j++ ) {
                 for( unsigned int k=0; k< sub_space.box_size_[2]; k++ ) {
 
@@ -235,9 +275,6 @@ int ParticleCreator::create( struct SubSpace sub_space,
                         density( i, j, k ) = 0.;
                     }
 
-                    // Time amplitude (for injector)
-                    density( i, j, k ) *= time_amplitude;
-
                     // If zero or less, zero particles
                     if( n_part_in_cell( i, j, k )<=0. || density( i, j, k )==0. ) {
                         n_part_in_cell( i, j, k ) = 0.;
@@ -265,6 +302,34 @@ int ParticleCreator::create( struct SubSpace sub_space,
                 }//k
             }//j
         }//i end the loop on all cells
+
+        if( cache && ! cached ) {
+            cache->valid_ = true;
+            for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+                cache->patch_min_[idim]  = cell_position[idim];
+                cache->cell_index_[idim] = sub_space.cell_index_[idim];
+                cache->box_size_[idim]   = sub_space.box_size_[idim];
+            }
+            for( unsigned int m=0; m<3; m++ ) {
+                cache->temperature_[m].assign( temperature[m].data_, temperature[m].data_ + temperature[m].number_of_points_ );
+                cache->velocity_[m].assign( velocity[m].data_, velocity[m].data_ + velocity[m].number_of_points_ );
+            }
+            cache->charge_.assign( charge.data_, charge.data_ + charge.number_of_points_ );
+            cache->max_charge_ = species_->max_charge_;
+            cache->density_.assign( density.data_, density.data_ + density.number_of_points_ );
+            cache->n_part_in_cell_.assign( n_part_in_cell.data_, n_part_in_cell.data_ + n_part_in_cell.number_of_points_ );
+            cache->n_new_particles_ = n_new_particles;
+        }
+
+        // Time amplitude (for injector)
+        if( time_amplitude == 0. ) {
+            density.put_to( 0. );
+            n_new_particles = 0;
+        } else if( time_amplitude != 1. ) {
+            for( unsigned int i=0; i<density.number_of_points_; i++ ) {
+                density.data_[i] *= std::abs( time_amplitude );
+            }
+        }
     }
 
     // Initialization of the particles properties
@@ -298,6 +363,7 @@ int ParticleCreator::create( struct SubSpace sub_space,
         // Loop cells
         unsigned int iPart = n_existing_particles;
         double *indexes = new double[species_->nDim_particle];
+        std::vector<double> random_buffer;
         for( unsigned int i=0; i< sub_space.box_size_[0]; i++ ) {
             if(( !n_existing_particles )&&( i%species_->cluster_width_ == 0 )&&( initialized_in_species_ )) {
                 species_->particles->first_index[(sub_space.cell_index_[0]+i)/species_->cluster_width_] = iPart;
@@ -325,9 +391,9 @@ int ParticleCreator::create( struct SubSpace sub_space,
                         temp[2] = temperature[2]( i, j, k );
 
                         if( ! disable_position_initialization_ ) {
-                            ParticleCreator::createPosition( position_initialization_, regular_number_array_,  particles_, species_, nPart, iPart, indexes, params, patch->rand_ );
+                            ParticleCreator::createPosition( position_initialization_, regular_number_array_,  particles_, species_, nPart, iPart, indexes, params, patch->rand_, random_buffer );
                         }
-                        ParticleCreator::createMomentum( momentum_initialization_, particles_, species_,  nPart, iPart, &temp[0], &vel[0], patch->rand_ );
+                        ParticleCreator::createMomentum( momentum_initialization_, particles_, species_,  nPart, iPart, &temp[0], &vel[0], patch->rand_, random_buffer );
                         ParticleCreator::createWeight( particles_, nPart, iPart, density( i, j, k ), params, regular_weight );
                         ParticleCreator::createCharge( particles_, species_, nPart, iPart, charge( i, j, k ) );
 
@@ -448,6 +514,7 @@ int ParticleCreator::create( struct SubSpace sub_space,
         n_new_particles = my_particles_indices.size();
         particles_->initialize( n_existing_particles + n_new_particles, species_->nDim_particle, params.keep_position_old );
         if( n_new_particles > 0 ) {
+            std::vector<double> random_buffer;
             // Prepare sorting
             int nbins = species_->particles->first_index.size();
             int indices[nbins];
@@ -517,7 +584,7 @@ int ParticleCreator::create( struct SubSpace sub_space,
                     temp[0] = temperature[0]( int_ijk[0], int_ijk[1], int_ijk[2] );
                     temp[1] = temperature[1]( int_ijk[0], int_ijk[1], int_ijk[2] );
                     temp[2] = temperature[2]( int_ijk[0], int_ijk[1], int_ijk[2] );
-                    ParticleCreator::createMomentum( momentum_initialization_, particles_, species_, 1, ip, temp, vel, patch->rand_ );
+                    ParticleCreator::createMomentum( momentum_initialization_, particles_, species_, 1, ip, temp, vel, patch->rand_, random_buffer );
                 }
                 // Assign weight
                 particles_->weight( ip ) = weight[ippy];
@@ -612,15 +679,16 @@ void ParticleCreator::createChargeProfile( struct SubSpace sub_space,
 // ---------------------------------------------------------------------------------------------------------------------
 //! Creation of the position for all particles (nPart)
 // ---------------------------------------------------------------------------------------------------------------------
-void ParticleCreator::createPosition( std::string position_initialization,
-                                      std::vector<int> regular_number_array,
+void ParticleCreator::createPosition( const std::string &position_initialization,
+                                      const std::vector<int> &regular_number_array,
                                     Particles * particles,
                                     Species * species,
                                     unsigned int nPart,
                                     unsigned int iPart,
                                     double *indexes,
                                     Params &params,
-                                    Random * rand )
+                                    Random * rand,
+                                    std::vector<double> &random_buffer )
 {
     if( position_initialization == "regular" ) {
 
@@ -731,9 +799,21 @@ void ParticleCreator::createPosition( std::string position_initialization,
                 particles->position( 1, p ) = particles_r*cos( particles_theta );
             }
         } else {
-            for( unsigned int p= iPart; p<iPart+nPart; p++ ) {
-                for( unsigned int i=0; i<species->nDim_particle ; i++ ) {
-                    particles->position( i, p ) = indexes[i] + rand->uniform()*species->cell_length[i];
+            // The random numbers are drawn in the same order as particle by particle,
+            // then the positions of each dimension are filled in a vectorized loop
+            const unsigned int ndim = species->nDim_particle;
+            random_buffer.resize( nPart*ndim );
+            double *const __restrict__ U = random_buffer.data();
+            for( unsigned int n=0; n<nPart*ndim; n++ ) {
+                U[n] = rand->uniform();
+            }
+            for( unsigned int i=0; i<ndim ; i++ ) {
+                double *const __restrict__ position = particles->getPtrPosition( i ) + iPart;
+                const double origin = indexes[i];
+                const double length = species->cell_length[i];
+                #pragma omp simd
+                for( unsigned int p=0; p<nPart; p++ ) {
+                    position[p] = origin + U[p*ndim+i]*length;
                 }
             }
         }
@@ -810,14 +890,15 @@ void boostParticles( double vx, double vy, double vz, double v2, double g, Parti
 //!   - at zero (init_momentum_type = cold)
 //!   - using random distribution (init_momentum_type = maxwell-juettner)
 // ---------------------------------------------------------------------------------------------------------------------
-void ParticleCreator::createMomentum( std::string momentum_initialization,
+void ParticleCreator::createMomentum( const std::string &momentum_initialization,
                                     Particles * particles,
                                     Species * species,
                                     unsigned int nPart,
                                     unsigned int iPart,
                                     double * temp,
                                     double * vel,
-                                    Random * rand )
+                                    Random * rand,
+                                    std::vector<double> &random_buffer )
 {
     // -------------------------------------------------------------------------
     // Particles
@@ -837,17 +918,29 @@ void ParticleCreator::createMomentum( std::string momentum_initialization,
         } else if( momentum_initialization == "maxwell-juettner" ) {
 
             // Sample the energies in the MJ distribution
-            std::vector<double> energies = maxwellJuttner( species, nPart, temp[0]/species->mass_, rand );
-
-            // Sample angles randomly and calculate the momentum
-            for( unsigned int p=iPart; p<iPart+nPart; p++ ) {
-                double phi   = acos( -rand->uniform2() );
-                double theta = rand->uniform_2pi();
-                double psm = sqrt( ( 1.0 + energies[p-iPart]) * ( 1.0 + energies[p-iPart]) - 1.0 );
-
-                particles->momentum( 0, p ) = psm*cos( theta )*sin( phi );
-                particles->momentum( 1, p ) = psm*sin( theta )*sin( phi );
-                particles->momentum( 2, p ) = psm*cos( phi );
+            random_buffer.resize( 3*nPart );
+            double *const __restrict__ energies = random_buffer.data();
+            maxwellJuttner( species, nPart, temp[0]/species->mass_, rand, energies );
+
+            // Sample angles randomly (in the order of the particles),
+            // then calculate the momentum in a vectorized loop
+            double *const __restrict__ angles = energies + nPart;
+            for( unsigned int p=0; p<nPart; p++ ) {
+                angles[2*p]   = -rand->uniform2();
+                angles[2*p+1] = rand->uniform_2pi();
+            }
+            double *const __restrict__ px = particles->getPtrMomentum( 0 ) + iPart;
+            double *const __restrict__ py = particles->getPtrMomentum( 1 ) + iPart;
+            double *const __restrict__ pz = particles->getPtrMomentum( 2 ) + iPart;
+            #pragma omp simd
+            for( unsigned int p=0; p<nPart; p++ ) {
+                const double phi   = acos( angles[2*p] );
+                const double theta = angles[2*p+1];
+                const double psm = sqrt( ( 1.0 + energies[p]) * ( 1.0 + energies[p]) - 1.0 );
+
+                px[p] = psm*cos( theta )*sin( phi );
+                py[p] = psm*sin( theta )*sin( phi );
+                pz[p] = psm*cos( phi );
             }
 
             // Trick to have non-isotropic distribution (not good)
@@ -999,12 +1092,11 @@ void ParticleCreator::createCharge( Particles * particles, Species * species,
 // ---------------------------------------------------------------------------------------------------------------------
 //! Provides a Maxwell-Juttner distribution of energies
 // ---------------------------------------------------------------------------------------------------------------------
-std::vector<double> ParticleCreator::maxwellJuttner( Species * species, unsigned int npoints, double temperature, Random * rand )
+void ParticleCreator::maxwellJuttner( Species * species, unsigned int npoints, double temperature, Random * rand, double *energies )
 {
     if( temperature==0. ) {
         ERROR( "The species " << species->species_number_ << " is initializing its momentum with the following temperature : " << temperature );
     }
-    std::vector<double> energies( npoints );
 
     // Classical case: Maxwell-Bolztmann
     if( temperature < 0.1 ) {
@@ -1066,8 +1158,6 @@ std::vector<double> ParticleCreator::maxwellJuttner( Species * species, unsigned
             energies[i] = gamma - 1.;
         }
     }
-
-    return energies;
 }
 
 // Array used in the Maxwell-Juttner sampling
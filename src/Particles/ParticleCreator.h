@@ -57,22 +57,26 @@ public:
                 Patch *patch);
     
     //! Creation of the particle positions
-    static void createPosition( std::string position_initialization,
-                              std::vector<int> regular_number_array,
+    //! `random_buffer` is a scratch array reused from one cell to the next
+    static void createPosition( const std::string &position_initialization,
+                              const std::vector<int> &regular_number_array,
                               Particles * particles,
                               Species * species,
                               unsigned int nPart,
-                              unsigned int iPart, double *indexes, Params &params, Random * rand );
+                              unsigned int iPart, double *indexes, Params &params, Random * rand,
+                              std::vector<double> &random_buffer );
     
     //! Creation of the particle momentum
-    static void createMomentum( std::string momentum_initialization,
+    //! `random_buffer` is a scratch array reused from one cell to the next
+    static void createMomentum( const std::string &momentum_initialization,
                             Particles * particles,
                             Species * species,
                             unsigned int nPart,
                             unsigned int iPart,
                             double *temp,
                             double *vel,
-                            Random * rand
+                            Random * rand,
+                            std::vector<double> &random_buffer
                             );
     
     //! Creation of the particle weight
@@ -135,10 +139,13 @@ public:
     //! Pointer toward regular number of particles array
     std::vector<int> regular_number_array_;
 
+    //! Associated particle injector (NULL for a species)
+    ParticleInjector * particle_injector_;
+
 private:
 
-    //! Provides a Maxwell-Juttner distribution of energies
-    static std::vector<double> maxwellJuttner( Species * species, unsigned int npoints, double temperature, Random * rand );
+    //! Provides a Maxwell-Juttner distribution of energies in `energies`
+    static void maxwellJuttner( Species * species, unsigned int npoints, double temperature, Random * rand, double *energies );
     //! Array used in the Maxwell-Juttner sampling (see doc)
     static const double lnInvF[1000];
     //! Array used in the Maxwell-Juttner sampling (see doc)
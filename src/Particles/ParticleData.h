@@ -154,6 +154,14 @@ public:
         }
     };
 
+    // Forbid the modification of the particles from python
+    inline void readOnly()
+    {
+        for( unsigned int i=0; i<attrs.size(); i++ ) {
+            PyArray_CLEARFLAGS( attrs[i], NPY_ARRAY_WRITEABLE );
+        }
+    };
+
     inline PyObject *get()
     {
         return particles;
@@ -312,6 +312,64 @@ void Particles::shrinkToFit(const bool compute_cell_keys)
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Reallocate a vector only if its capacity exceeds max_capacity
+// ---------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static void reduceVectorCapacity( std::vector<T> &v, std::size_t max_capacity )
+{
+    max_capacity = std::max( max_capacity, v.size() );
+    if( v.capacity() > max_capacity ) {
+        std::vector<T> reduced;
+        reduced.reserve( max_capacity );
+        reduced.assign( v.begin(), v.end() );
+        reduced.swap( v );
+    }
+}
+
+void Particles::reduceCapacity( unsigned int max_capacity )
+{
+    for( unsigned int iprop=0 ; iprop<double_prop_.size() ; iprop++ ) {
+        reduceVectorCapacity( *double_prop_[iprop], max_capacity );
+    }
+
+    for( unsigned int iprop=0 ; iprop<short_prop_.size() ; iprop++ ) {
+        reduceVectorCapacity( *short_prop_[iprop], max_capacity );
+    }
+
+    for( unsigned int iprop=0 ; iprop<uint64_prop_.size() ; iprop++ ) {
+        reduceVectorCapacity( *uint64_prop_[iprop], max_capacity );
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Copy a vector in a new array with the same capacity, first touched by the calling thread
+// ---------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static void relocateVector( std::vector<T> &v )
+{
+    std::vector<T> relocated;
+    relocated.reserve( v.capacity() );
+    relocated.assign( v.begin(), v.end() );
+    relocated.swap( v );
+}
+
+void Particles::relocateData()
+{
+    for( unsigned int iprop=0 ; iprop<double_prop_.size() ; iprop++ ) {
+        relocateVector( *double_prop_[iprop] );
+    }
+
+    for( unsigned int iprop=0 ; iprop<short_prop_.size() ; iprop++ ) {
+        relocateVector( *short_prop_[iprop] );
+    }
+
+    for( unsigned int iprop=0 ; iprop<uint64_prop_.size() ; iprop++ ) {
+        relocateVector( *uint64_prop_[iprop] );
+    }
+
+    relocateVector( cell_keys );
+}
 
 // ---------------------------------------------------------------------------------------------------------------------
 //! Reset of Particles vectors
@@ -413,12 +471,76 @@ void Particles::copyParticles( unsigned int iPart, unsigned int nPart, Particles
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Shift the bins of a vector (from the end) and scatter the new values in front of each bin
+// ---------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static void insertVectorInBins( std::vector<T> &dest, const std::vector<T> &src, const std::vector<int> &first_index,
+                                const std::vector<size_t> &shift, const std::vector<size_t> &dest_index )
+{
+    const size_t old_size = dest.size();
+    dest.resize( old_size + src.size() );
+    for( int ibin = ( int )first_index.size()-1; ibin >= 0; ibin-- ) {
+        const size_t end = ibin == ( int )first_index.size()-1 ? old_size : first_index[ibin+1];
+        std::move_backward( dest.begin() + first_index[ibin], dest.begin() + end, dest.begin() + end + shift[ibin] );
+    }
+    for( size_t i = 0; i < src.size(); i++ ) {
+        dest[dest_index[i]] = src[i];
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Insert all particles in front of their bins in dest_parts (bins given by bin_keys)
+//! Contrary to successive calls to copyParticles, the arrays are shifted only once
+// ---------------------------------------------------------------------------------------------------------------------
+void Particles::copyParticlesToBins( const vector<int> &bin_keys, Particles &dest_parts )
+{
+    const size_t nbin = dest_parts.first_index.size();
+    
+    // Number of new particles in each bin, and shift of each bin (new particles of this bin and the previous ones)
+    vector<size_t> count( nbin, 0 ), shift( nbin );
+    for( size_t i = 0; i < bin_keys.size(); i++ ) {
+        count[bin_keys[i]]++;
+    }
+    size_t total = 0;
+    for( size_t ibin = 0; ibin < nbin; ibin++ ) {
+        total += count[ibin];
+        shift[ibin] = total;
+    }
+    
+    // Destination of each new particle, keeping their order within a bin
+    vector<size_t> next( nbin ), dest_index( bin_keys.size() );
+    for( size_t ibin = 0; ibin < nbin; ibin++ ) {
+        next[ibin] = dest_parts.first_index[ibin] + shift[ibin] - count[ibin];
+    }
+    for( size_t i = 0; i < bin_keys.size(); i++ ) {
+        dest_index[i] = next[bin_keys[i]]++;
+    }
+    
+    for( unsigned int iprop=0 ; iprop<double_prop_.size() ; iprop++ ) {
+        insertVectorInBins( *dest_parts.double_prop_[iprop], *double_prop_[iprop], dest_parts.first_index, shift, dest_index );
+    }
+    
+    for( unsigned int iprop=0 ; iprop<short_prop_.size() ; iprop++ ) {
+        insertVectorInBins( *dest_parts.short_prop_[iprop], *short_prop_[iprop], dest_parts.first_index, shift, dest_index );
+    }
+    
+    for( unsigned int iprop=0 ; iprop<uint64_prop_.size() ; iprop++ ) {
+        insertVectorInBins( *dest_parts.uint64_prop_[iprop], *uint64_prop_[iprop], dest_parts.first_index, shift, dest_index );
+    }
+    
+    for( size_t ibin = 0; ibin < nbin; ibin++ ) {
+        dest_parts.first_index[ibin] += shift[ibin] - count[ibin];
+        dest_parts.last_index[ibin]  += shift[ibin];
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //! Copy particles indexed by array 'indices' to dest_id in dest_parts
 //! The array 'indices' must be sorted in increasing order
 //! cell keys not affected
 // ---------------------------------------------------------------------------------------------------------------------
-void Particles::copyParticles( vector<size_t> indices, Particles &dest_parts, int dest_id )
+void Particles::copyParticles( const vector<size_t> &indices, Particles &dest_parts, int dest_id )
 {
     const size_t transfer_size = indices.size();
     const size_t dest_new_size = dest_parts.size() + transfer_size;
@@ -458,6 +580,88 @@ void Particles::copyParticles( vector<size_t> indices, Particles &dest_parts, in
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Pack / unpack particles in a contiguous byte buffer (for MPI exchanges without derived datatypes)
+// ---------------------------------------------------------------------------------------------------------------------
+bool Particles::hasUniformCharge( short &q ) const
+{
+    const size_t npart = Charge.size();
+    if( npart == 0 ) {
+        return false;
+    }
+    q = Charge[0];
+    const short *const __restrict__ charge = Charge.data();
+    int ndiff = 0;
+    #pragma omp simd reduction(+:ndiff)
+    for( size_t ipart = 1; ipart < npart; ipart++ ) {
+        ndiff += ( charge[ipart] != q );
+    }
+    return ndiff == 0;
+}
+
+size_t Particles::packedSize() const
+{
+    // Each short property is preceded by a flag telling whether it is uniform
+    return size() * ( double_prop_.size()*sizeof( double )
+                      + short_prop_.size()*sizeof( short )
+                      + uint64_prop_.size()*sizeof( uint64_t ) )
+           + short_prop_.size()*sizeof( char );
+}
+
+size_t Particles::pack( vector<char> &buffer ) const
+{
+    const size_t npart = size();
+    if( buffer.size() < packedSize() ) {
+        buffer.resize( packedSize() );
+    }
+    char *b = buffer.data();
+    for( unsigned int iprop=0 ; iprop<double_prop_.size() ; iprop++ ) {
+        memcpy( b, double_prop_[iprop]->data(), npart*sizeof( double ) );
+        b += npart*sizeof( double );
+    }
+    for( unsigned int iprop=0 ; iprop<short_prop_.size() ; iprop++ ) {
+        const short *const v = short_prop_[iprop]->data();
+        char uniform = ( npart > 0 && std::all_of( v, v+npart, [v]( short x ) { return x == v[0]; } ) );
+        *b = uniform;
+        b += sizeof( char );
+        const size_t n = uniform ? 1 : npart;
+        memcpy( b, v, n*sizeof( short ) );
+        b += n*sizeof( short );
+    }
+    for( unsigned int iprop=0 ; iprop<uint64_prop_.size() ; iprop++ ) {
+        memcpy( b, uint64_prop_[iprop]->data(), npart*sizeof( uint64_t ) );
+        b += npart*sizeof( uint64_t );
+    }
+    return b - buffer.data();
+}
+
+void Particles::unpack( const vector<char> &buffer )
+{
+    const size_t npart = size();
+    const char *b = buffer.data();
+    for( unsigned int iprop=0 ; iprop<double_prop_.size() ; iprop++ ) {
+        memcpy( double_prop_[iprop]->data(), b, npart*sizeof( double ) );
+        b += npart*sizeof( double );
+    }
+    for( unsigned int iprop=0 ; iprop<short_prop_.size() ; iprop++ ) {
+        const char uniform = *b;
+        b += sizeof( char );
+        if( uniform ) {
+            short value;
+            memcpy( &value, b, sizeof( short ) );
+            std::fill( short_prop_[iprop]->begin(), short_prop_[iprop]->begin() + npart, value );
+            b += sizeof( short );
+        } else {
+            memcpy( short_prop_[iprop]->data(), b, npart*sizeof( short ) );
+            b += npart*sizeof( short );
+        }
+    }
+    for( unsigned int iprop=0 ; iprop<uint64_prop_.size() ; iprop++ ) {
+        memcpy( uint64_prop_[iprop]->data(), b, npart*sizeof( uint64_t ) );
+        b += npart*sizeof( uint64_t );
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //! Make a new particle at the position of another
 //! cell keys not affected
@@ -862,6 +1066,127 @@ void Particles::overwriteParticle( unsigned int part1,
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Apply a list of moves src[i] -> dest[i] property by property.
+//! The moves are applied in the order of the list so that a particle moved
+//! twice ends at the same location as with successive overwriteParticle calls.
+//! Warning: do not update first_index and last_index
+// ---------------------------------------------------------------------------------------------------------------------
+void Particles::overwriteParticles( const std::vector<unsigned int> &src,
+                                    const std::vector<unsigned int> &dest,
+                                    bool compute_cell_keys )
+{
+    const unsigned int nmoves = src.size();
+    const unsigned int *const __restrict__ isrc  = src.data();
+    const unsigned int *const __restrict__ idest = dest.data();
+
+    for( unsigned int iprop=0 ; iprop<double_prop_.size() ; iprop++ ) {
+        double *const prop = double_prop_[iprop]->data();
+        for( unsigned int imove = 0 ; imove < nmoves ; imove++ ) {
+            prop[idest[imove]] = prop[isrc[imove]];
+        }
+    }
+
+    for( unsigned int iprop=0 ; iprop<short_prop_.size() ; iprop++ ) {
+        short *const prop = short_prop_[iprop]->data();
+        for( unsigned int imove = 0 ; imove < nmoves ; imove++ ) {
+            prop[idest[imove]] = prop[isrc[imove]];
+        }
+    }
+
+    for( unsigned int iprop=0 ; iprop<uint64_prop_.size() ; iprop++ ) {
+        uint64_t *const prop = uint64_prop_[iprop]->data();
+        for( unsigned int imove = 0 ; imove < nmoves ; imove++ ) {
+            prop[idest[imove]] = prop[isrc[imove]];
+        }
+    }
+
+    if( compute_cell_keys ) {
+        int *const keys = cell_keys.data();
+        for( unsigned int imove = 0 ; imove < nmoves ; imove++ ) {
+            keys[idest[imove]] = keys[isrc[imove]];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Move contiguous runs of particles: run i moves length[i] particles from src[i] to dest[i].
+//! The runs must be ordered by increasing destination with dest[i] <= src[i] (compaction
+//! towards the front): each property is then shifted with one memmove per run.
+//! Warning: do not update first_index and last_index
+// ---------------------------------------------------------------------------------------------------------------------
+void Particles::moveParticleRuns( const std::vector<unsigned int> &src,
+                                  const std::vector<unsigned int> &dest,
+                                  const std::vector<unsigned int> &length,
+                                  bool compute_cell_keys )
+{
+    const unsigned int nruns = src.size();
+
+    for( unsigned int iprop=0 ; iprop<double_prop_.size() ; iprop++ ) {
+        double *const prop = double_prop_[iprop]->data();
+        for( unsigned int irun = 0 ; irun < nruns ; irun++ ) {
+            memmove( prop + dest[irun], prop + src[irun], length[irun]*sizeof( double ) );
+        }
+    }
+
+    for( unsigned int iprop=0 ; iprop<short_prop_.size() ; iprop++ ) {
+        short *const prop = short_prop_[iprop]->data();
+        for( unsigned int irun = 0 ; irun < nruns ; irun++ ) {
+            memmove( prop + dest[irun], prop + src[irun], length[irun]*sizeof( short ) );
+        }
+    }
+
+    for( unsigned int iprop=0 ; iprop<uint64_prop_.size() ; iprop++ ) {
+        uint64_t *const prop = uint64_prop_[iprop]->data();
+        for( unsigned int irun = 0 ; irun < nruns ; irun++ ) {
+            memmove( prop + dest[irun], prop + src[irun], length[irun]*sizeof( uint64_t ) );
+        }
+    }
+
+    if( compute_cell_keys ) {
+        int *const keys = cell_keys.data();
+        for( unsigned int irun = 0 ; irun < nruns ; irun++ ) {
+            memmove( keys + dest[irun], keys + src[irun], length[irun]*sizeof( int ) );
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Move the particles of [istart, iend[ whose mask is >= 0 to the front of the range, keeping their order.
+//! The move plan (contiguous runs of kept particles) is computed once before any particle is moved,
+//! so that `mask` may point to cell_keys.
+//! Returns the end of the kept particles. Particles beyond are left unspecified.
+// ---------------------------------------------------------------------------------------------------------------------
+unsigned int Particles::compactParticles( unsigned int istart, unsigned int iend, const int *mask, bool compute_cell_keys )
+{
+    std::vector<unsigned int> src, dest, length;
+
+    unsigned int idest = istart;
+    unsigned int ipart = istart;
+    while( ipart < iend ) {
+        // Skip the deleted particles
+        while( ipart < iend && mask[ipart] < 0 ) {
+            ipart++;
+        }
+        // Run of kept particles
+        const unsigned int run_start = ipart;
+        while( ipart < iend && mask[ipart] >= 0 ) {
+            ipart++;
+        }
+        const unsigned int run_length = ipart - run_start;
+        if( run_length > 0 && run_start != idest ) {
+            src.push_back( run_start );
+            dest.push_back( idest );
+            length.push_back( run_length );
+        }
+        idest += run_length;
+    }
+
+    moveParticleRuns( src, dest, length, compute_cell_keys );
+
+    return idest;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //! Move particle part1 into part2 memory location of dest vector, erasing part2.
 //! Warning: do not update first_index and last_index
@@ -1006,23 +1331,14 @@ void Particles::createParticles( int n_additional_particles, int pstart )
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::eraseParticlesWithMask( int istart, int iend, vector <int> & mask ) {
 
-    unsigned int idest = (unsigned int) istart;
-    unsigned int isrc = (unsigned int) istart;
-    while (isrc < (unsigned int) iend) {
-        if (mask[idest] < 0) {
-            if (mask[isrc] >= 0) {
-                overwriteParticle( isrc, idest);
-                cell_keys[idest] = cell_keys[isrc];
-                mask[idest] = 1;
-                mask[isrc] = -1;
-                idest++;
-            } else {
-                isrc++;
-            }
-        } else {
-            idest++;
-            isrc = idest;
-        }
+    const unsigned int idest = compactParticles( istart, iend, mask.data(), true );
+
+    // The mask now describes the compacted particles
+    for( unsigned int ipart = istart ; ipart < idest ; ipart++ ) {
+        mask[ipart] = 1;
+    }
+    for( unsigned int ipart = idest ; ipart < ( unsigned int ) iend ; ipart++ ) {
+        mask[ipart] = -1;
     }
 
     // At the end we resize particles
@@ -1037,22 +1353,7 @@ void Particles::eraseParticlesWithMask( int istart, int iend, vector <int> & mas
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::eraseParticlesWithMask( int istart, int iend) {
 
-    unsigned int idest = (unsigned int) istart;
-    unsigned int isrc = (unsigned int) istart;
-    while (isrc < (unsigned int) iend) {
-        if (cell_keys[idest] < 0) {
-            if (cell_keys[isrc] >= 0) {
-                overwriteParticle( isrc, idest);
-                cell_keys[idest] = cell_keys[isrc];
-                idest++;
-            } else {
-                isrc++;
-            }
-        } else {
-            idest++;
-            isrc = idest;
-        }
-    }
+    const unsigned int idest = compactParticles( istart, iend, cell_keys.data(), true );
 
     // At the end we resize particles
     resize(idest);
@@ -1103,20 +1404,26 @@ void Particles::compress(bool compute_cell_keys) {
 
     unsigned int nbin = numberOfBins();
 
-    for( unsigned int ibin = 0 ; ibin < nbin-1 ; ibin++ ) {
+    // Each bin is a run moved in one go to the end of the previous one
+    std::vector<unsigned int> src, dest, length;
+    for( unsigned int ibin = 1 ; ibin < nbin ; ibin++ ) {
 
         // Removal of the photons
-        const unsigned int nb_deleted_photon = first_index[ibin+1] - last_index[ibin];
+        const unsigned int nb_deleted_photon = first_index[ibin] - last_index[ibin-1];
 
         if( nb_deleted_photon > 0 ) {
-            eraseParticle( last_index[ibin], nb_deleted_photon, compute_cell_keys );
-
-            for( int ii=ibin+1; ii< (int) nbin; ii++ ) {
-                first_index[ii] -= nb_deleted_photon;
-                last_index[ii] -= nb_deleted_photon;
+            const unsigned int particle_number = last_index[ibin] - first_index[ibin];
+            if( particle_number > 0 ) {
+                src.push_back( first_index[ibin] );
+                dest.push_back( last_index[ibin-1] );
+                length.push_back( particle_number );
             }
+            first_index[ibin] = last_index[ibin-1];
+            last_index[ibin]  = first_index[ibin] + particle_number;
         }
     }
+    moveParticleRuns( src, dest, length, compute_cell_keys );
+
     eraseParticleTrail( last_index[nbin-1], true );
 }
 
@@ -1336,14 +1643,22 @@ void Particles::copyLeavingParticlesToBuffers( const vector<bool> copy, const ve
 
     // CPU
     
+    // List the leaving particles of each direction first, so that each buffer
+    // is resized only once and filled property by property
+    vector<vector<size_t>> indices( buffer.size() );
     for( size_t ipart = 0; ipart < size(); ipart++ ) {
         if( cell_keys[ipart] < -1 ) {
             int direction = -cell_keys[ipart] - 2;
             if( copy[direction] ) {
-                copyParticle( ipart, *buffer[direction] );
+                indices[direction].push_back( ipart );
             }
         }
     }
+    for( size_t direction = 0; direction < buffer.size(); direction++ ) {
+        if( indices[direction].size() > 0 ) {
+            copyParticles( indices[direction], *buffer[direction], buffer[direction]->size() );
+        }
+    }
     
 #endif
 }
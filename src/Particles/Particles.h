@@ -83,6 +83,14 @@ public:
     //! params [in] compute_cell_keys: if true, cell_keys is affected (default is false)
     void shrinkToFit(const bool compute_cell_keys = false);
 
+    //! Reduce the capacity of Particles vectors to max_capacity (or to their size if larger)
+    //! Vectors with a smaller capacity are not reallocated
+    void reduceCapacity( unsigned int max_capacity );
+
+    //! Copy the Particles vectors in new arrays, allocated and first touched by the calling thread,
+    //! so that their memory is placed on the NUMA domain of this thread
+    void relocateData();
+
     //! Reset Particles vectors
     //! params [in] compute_cell_keys: if true, cell_keys is affected (default is false)
     void clear(const bool compute_cell_keys = false);
@@ -144,7 +152,21 @@ public:
     //! Insert nPart particles starting at ipart to dest_id in dest_parts
     void copyParticles( unsigned int iPart, unsigned int nPart, Particles &dest_parts, int dest_id );
     //! Transfer particles indexed by array indices to dest_id in dest_parts
-    void copyParticles( std::vector<size_t> indices, Particles &dest_parts, int dest_id );
+    void copyParticles( const std::vector<size_t> &indices, Particles &dest_parts, int dest_id );
+    //! Insert all particles at the beginning of their bins (bin_keys) in dest_parts, and update its bin indices
+    //! Each array of dest_parts is reallocated and shifted only once
+    void copyParticlesToBins( const std::vector<int> &bin_keys, Particles &dest_parts );
+
+    //! True if all particles have the same charge, returned in `q` (false if there are no particles)
+    bool hasUniformCharge( short &q ) const;
+
+    //! Maximum number of bytes required to pack all particles
+    size_t packedSize() const;
+    //! Pack all particles, property by property, in a contiguous buffer (resized only if too small)
+    //! Short properties with a uniform value are stored once. Returns the number of bytes used.
+    size_t pack( std::vector<char> &buffer ) const;
+    //! Unpack a buffer filled by pack() in the current particles (already resized)
+    void unpack( const std::vector<char> &buffer );
 
     //! Make a new particle at the position of another
     void makeParticleAt( Particles &source_particles, unsigned int ipart, double w, short q=0., double px=0., double py=0., double pz=0. );
@@ -190,6 +212,20 @@ public:
     //! Warning: do not update first_index and last_index
     void overwriteParticle( unsigned int part1, Particles &dest_parts, unsigned int part2 );
 
+    //! Apply the moves src[i] -> dest[i] property by property, in the order of the list
+    //! Warning: do not update first_index and last_index
+    void overwriteParticles( const std::vector<unsigned int> &src, const std::vector<unsigned int> &dest, bool compute_cell_keys = false );
+
+    //! Move runs of length[i] particles from src[i] to dest[i] (dest[i] <= src[i], increasing dest)
+    //! with one memmove per run and per property
+    //! Warning: do not update first_index and last_index
+    void moveParticleRuns( const std::vector<unsigned int> &src, const std::vector<unsigned int> &dest,
+                           const std::vector<unsigned int> &length, bool compute_cell_keys = false );
+
+    //! Move the particles of [istart, iend[ with mask >= 0 to the front of the range, keeping their order
+    //! Returns the end of the kept particles
+    unsigned int compactParticles( unsigned int istart, unsigned int iend, const int *mask, bool compute_cell_keys = false );
+
     //! Create new particle
     void createParticle();
 
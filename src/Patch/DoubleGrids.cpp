@@ -1,6 +1,7 @@
 
 #include "DoubleGrids.h"
 
+#include <cstring>
 #include <vector>
 
 #include "Region.h"
@@ -18,6 +19,9 @@ void DoubleGrids::syncCurrentsOnRegion( VectorPatch &vecPatches, Region &region,
 {
     timers.grids.restart();
 
+    // The currents exchanged with other MPI processes are gathered in one message per MPI process
+    smpi->startBatches();
+
     // Loop / additional_patches_ ( = patches included in the local vecPatches but not in local Region, the Region of others MPI will need this data )
     //        additional_patches_ranks stores the MPI rank of the Region which owns additional_patches_
     for ( unsigned int i=0 ; i<region.additional_patches_.size() ; i++ ) {
@@ -28,38 +32,51 @@ void DoubleGrids::syncCurrentsOnRegion( VectorPatch &vecPatches, Region &region,
 
     }
 
-
     // Loop / missing_patches_ ( = patches whose data is needed by the local Region but not own by the local vecPatches )
     //        missing_patches_ranks stores the MPI rank of the vecPacthes which own missing_patches_
+    //        received in buffers ( one per patch and current ), added to the Region once all are received
+    unsigned int ncurrents = params.is_spectral ? 4 : 3;
+    vector<vector<double>> buffers( region.missing_patches_.size() * ncurrents );
     for ( unsigned int i=0 ; i<region.missing_patches_.size() ; i++ ) {
 
-        DoubleGrids::currentsOnRegionRecv( region.patch_->EMfields,
-                                           region.missing_patches_[i], region.missing_patches_ranks[i], vecPatches, params, smpi, region );
+        DoubleGrids::currentsOnRegionRecv( &buffers[i*ncurrents], region.missing_patches_ranks[i], params, smpi, region );
 
     }
 
+    smpi->exchangeBatches();
 
-    // Loop / additional_patches_ to finalize send ( currentsOnRegionSend relies on MPI_Isend )
-    for ( unsigned int i=0 ; i<region.additional_patches_.size() ; i++ ) {
+    for ( unsigned int i=0 ; i<region.missing_patches_.size() ; i++ ) {
 
-        unsigned int ipatch = region.additional_patches_[i]-vecPatches.refHindex_;
-        DoubleGrids::currentsOnRegionSendFinalize( vecPatches(ipatch), params );
+        DoubleGrids::currentsOnRegionAdd( region.patch_->EMfields, &buffers[i*ncurrents],
+                                          region.missing_patches_[i], vecPatches, params, region );
 
     }
 
     // Loop / local_patches_ ( patches own by the local vePatches whose data are used by the local Region )
-    for ( unsigned int i=0 ; i<region.local_patches_.size() ; i++ ) {
-
-        unsigned int ipatch = region.local_patches_[i]-vecPatches.refHindex_;
-        vecPatches(ipatch)->EMfields->Jx_->add( region.patch_->EMfields->Jx_, params, vecPatches(ipatch), region.patch_ );
-        vecPatches(ipatch)->EMfields->Jy_->add( region.patch_->EMfields->Jy_, params, vecPatches(ipatch), region.patch_ );
-        vecPatches(ipatch)->EMfields->Jz_->add( region.patch_->EMfields->Jz_, params, vecPatches(ipatch), region.patch_ );
-
-	if(params.is_spectral){
-            vecPatches(ipatch)->EMfields->rho_->add( region.patch_->EMfields->rho_, params, vecPatches(ipatch), region.patch_ );
-            // rho_old is save directly on the Region after the resolution of the Maxwell solver
-	}
-
+    //        neighbor patches overlap in their ghost cells : patches of the same parity in all directions
+    //        are not neighbors ( patch_size_ > 2*oversize+1 ) and are processed concurrently
+    unsigned int ncolors = 1 << params.nDim_field;
+    #pragma omp parallel
+    {
+        for ( unsigned int icolor=0 ; icolor<ncolors ; icolor++ ) {
+            #pragma omp for schedule(runtime)
+            for ( unsigned int i=0 ; i<region.local_patches_.size() ; i++ ) {
+
+                unsigned int ipatch = region.local_patches_[i]-vecPatches.refHindex_;
+                if( patchColor( vecPatches(ipatch), params ) != icolor ) {
+                    continue;
+                }
+                vecPatches(ipatch)->EMfields->Jx_->add( region.patch_->EMfields->Jx_, params, vecPatches(ipatch), region.patch_ );
+                vecPatches(ipatch)->EMfields->Jy_->add( region.patch_->EMfields->Jy_, params, vecPatches(ipatch), region.patch_ );
+                vecPatches(ipatch)->EMfields->Jz_->add( region.patch_->EMfields->Jz_, params, vecPatches(ipatch), region.patch_ );
+
+                if(params.is_spectral){
+                    vecPatches(ipatch)->EMfields->rho_->add( region.patch_->EMfields->rho_, params, vecPatches(ipatch), region.patch_ );
+                    // rho_old is save directly on the Region after the resolution of the Maxwell solver
+                }
+
+            }
+        }
     }
     timers.grids.update();
 }
@@ -68,6 +85,7 @@ void DoubleGrids::currentsOnRegionSend( ElectroMagn* localfields, unsigned int h
 {
     // isend( Fields, targeted_mpi_rank, tag, requests );
     //               tag = *5 ? 5 communications are required per patch : 3 currents + rho + rho_old
+    //               only recorded in the message to targeted_mpi_rank ( see SmileiMPI::startBatches )
     smpi->isend( localfields->Jx_, send_to_global_patch_rank, hindex*5  , patch->requests_[0] );
     smpi->isend( localfields->Jy_, send_to_global_patch_rank, hindex*5+1, patch->requests_[1] );
     smpi->isend( localfields->Jz_, send_to_global_patch_rank, hindex*5+2, patch->requests_[2] );
@@ -78,44 +96,61 @@ void DoubleGrids::currentsOnRegionSend( ElectroMagn* localfields, unsigned int h
 
 }
 
-void DoubleGrids::currentsOnRegionSendFinalize( Patch* patch, Params& params )
+void DoubleGrids::currentsOnRegionRecv( std::vector<double>* buffers, int local_patch_rank, Params &params, SmileiMPI* smpi, Region& region )
 {
-    MPI_Status status;
-    // Wait for currentsOnRegionSend (isend)
-    MPI_Wait( &(patch->requests_[0]), &status );
-    MPI_Wait( &(patch->requests_[1]), &status );
-    MPI_Wait( &(patch->requests_[2]), &status );
+    // recv( buffer, sender_mpi_rank, tag ) : buffers of the size of the currents of a patch
+    //       only recorded in the message from sender_mpi_rank ( see SmileiMPI::startBatches )
+    ElectroMagn* fake_fields = region.fake_patch->EMfields;
+
+    buffers[0].resize( fake_fields->Jx_->number_of_points_ );
+    smpi->recv( &buffers[0], local_patch_rank, 0 );
+
+    buffers[1].resize( fake_fields->Jy_->number_of_points_ );
+    smpi->recv( &buffers[1], local_patch_rank, 0 );
+
+    buffers[2].resize( fake_fields->Jz_->number_of_points_ );
+    smpi->recv( &buffers[2], local_patch_rank, 0 );
 
     if(params.is_spectral) {
-        MPI_Wait( &(patch->requests_[3]), &status );
+        buffers[3].resize( fake_fields->rho_->number_of_points_ );
+        smpi->recv( &buffers[3], local_patch_rank, 0 );
     }
+
 }
 
-void DoubleGrids::currentsOnRegionRecv( ElectroMagn* globalfields, unsigned int hindex, int local_patch_rank, VectorPatch& vecPatches, Params &params, SmileiMPI* smpi, Region& region )
+void DoubleGrids::currentsOnRegionAdd( ElectroMagn* globalfields, std::vector<double>* buffers, unsigned int hindex, VectorPatch& vecPatches, Params &params, Region& region )
 {
     // fake_patch consists in a piece of the local Region to handle naturally patches communications
     //            need to update its hindex and coordinates to put recv data at the good place in the local Region (add)
     region.fake_patch->hindex = hindex;
     region.fake_patch->Pcoordinates = vecPatches.domain_decomposition_->getDomainCoordinates( hindex );
+    ElectroMagn* fake_fields = region.fake_patch->EMfields;
 
-    // recv( Fields, sender_mpi_rank, tag );
-    //       tag = *5 ? 5 communications are required per patch : 3 currents + rho + rho_old
-    smpi->recv( region.fake_patch->EMfields->Jx_, local_patch_rank, hindex*5 );
-    region.fake_patch->EMfields->Jx_->add( globalfields->Jx_, params, region.fake_patch, region.patch_ );
+    memcpy( fake_fields->Jx_->data_, &buffers[0][0], buffers[0].size()*sizeof( double ) );
+    fake_fields->Jx_->add( globalfields->Jx_, params, region.fake_patch, region.patch_ );
 
-    smpi->recv( region.fake_patch->EMfields->Jy_, local_patch_rank, hindex*5+1 );
-    region.fake_patch->EMfields->Jy_->add( globalfields->Jy_, params, region.fake_patch, region.patch_ );
+    memcpy( fake_fields->Jy_->data_, &buffers[1][0], buffers[1].size()*sizeof( double ) );
+    fake_fields->Jy_->add( globalfields->Jy_, params, region.fake_patch, region.patch_ );
 
-    smpi->recv( region.fake_patch->EMfields->Jz_, local_patch_rank, hindex*5+2 );
-    region.fake_patch->EMfields->Jz_->add( globalfields->Jz_, params, region.fake_patch, region.patch_ );
+    memcpy( fake_fields->Jz_->data_, &buffers[2][0], buffers[2].size()*sizeof( double ) );
+    fake_fields->Jz_->add( globalfields->Jz_, params, region.fake_patch, region.patch_ );
 
     if(params.is_spectral) {
-        smpi->recv( region.fake_patch->EMfields->rho_, local_patch_rank, hindex*5+3 );
-        region.fake_patch->EMfields->rho_->add( globalfields->rho_, params, region.fake_patch, region.patch_ );
+        memcpy( fake_fields->rho_->data_, &buffers[3][0], buffers[3].size()*sizeof( double ) );
+        fake_fields->rho_->add( globalfields->rho_, params, region.fake_patch, region.patch_ );
     }
 
 }
 
+unsigned int DoubleGrids::patchColor( Patch* patch, Params &params )
+{
+    unsigned int color = 0;
+    for ( unsigned int iDim=0 ; iDim<params.nDim_field ; iDim++ ) {
+        color |= ( patch->Pcoordinates[iDim] % 2 ) << iDim;
+    }
+    return color;
+}
+
 
 // ---------------------------------------------------------------------------
 // Scatter Fields on Patches for particles interpolation or divergece cleaning
@@ -124,6 +159,9 @@ void DoubleGrids::syncFieldsOnPatches( Region &region, VectorPatch &vecPatches,
 {
     timers.grids.restart();
 
+    // The fields exchanged with other MPI processes are gathered in one message per MPI process
+    smpi->startBatches();
+
     // Loop / additional_patches_ ( within local vecPatches but not in local Region )
     //                            get data from Region of others MPI
     for ( unsigned int i=0 ; i<region.additional_patches_.size() ; i++ ) {
@@ -136,22 +174,20 @@ void DoubleGrids::syncFieldsOnPatches( Region &region, VectorPatch &vecPatches,
 
     // Loop / missing_patches_ ( within local Region but not in local vecPatches,  )
     //                         send data which do not concern local Region
+    //                         extracted in buffers ( one per patch and field ) until all are sent
+    vector<vector<double>> buffers( region.missing_patches_.size() * 6 );
     for ( unsigned int i=0 ; i<region.missing_patches_.size() ; i++ ) {
 
-        DoubleGrids::fieldsOnPatchesSend( region.patch_->EMfields,
+        DoubleGrids::fieldsOnPatchesSend( region.patch_->EMfields, &buffers[i*6],
                                           region.missing_patches_[i], region.missing_patches_ranks[i], vecPatches, params, smpi, region );
 
     }
 
-    // Loop / additional_patches_ to finalize recv ( fieldsOnPatchesRecv relies on MPI_Irecv )
-    for ( unsigned int i=0 ; i<region.additional_patches_.size() ; i++ ) {
-
-        unsigned int ipatch = region.additional_patches_[i]-vecPatches.refHindex_;
-        DoubleGrids::fieldsOnPatchesRecvFinalize( vecPatches(ipatch) );
-
-    }
+    smpi->exchangeBatches();
 
     // Loop / local_patches_ ( patches own by the local vePatches whose data are used by the local Region )
+    //        each patch only writes its own fields : patches are processed concurrently
+    #pragma omp parallel for schedule(runtime)
     for ( unsigned int i=0 ; i<region.local_patches_.size() ; i++ ) {
 
         unsigned int ipatch = region.local_patches_[i]-vecPatches.refHindex_;
@@ -170,60 +206,41 @@ void DoubleGrids::syncFieldsOnPatches( Region &region, VectorPatch &vecPatches,
 }
 
 
-void DoubleGrids::fieldsOnPatchesRecv( ElectroMagn* localfields, unsigned int hindex, int recv_from_global_patch_rank, SmileiMPI* smpi, Patch* patch )
+void DoubleGrids::fieldsOnPatchesRecv( ElectroMagn* localfields, unsigned int hindex, int recv_from_global_patch_rank, SmileiMPI* smpi, Patch* )
 {
-    // irecv( Fields, sender_mpi_rank, tag, requests );
-    //        tag = *6 ? 6 communications could be are required per patch
-    //        clarify which usage need B, B_m or both
-    smpi->irecv( localfields->Ex_, recv_from_global_patch_rank, hindex*6  , patch->requests_[0] );
-    smpi->irecv( localfields->Ey_, recv_from_global_patch_rank, hindex*6+1, patch->requests_[1] );
-    smpi->irecv( localfields->Ez_, recv_from_global_patch_rank, hindex*6+2, patch->requests_[2] );
+    // recv( Fields, sender_mpi_rank, tag );
+    //       tag = *6 ? 6 communications could be are required per patch
+    //       clarify which usage need B, B_m or both
+    //       only recorded in the message from sender_mpi_rank ( see SmileiMPI::startBatches )
+    smpi->recv( localfields->Ex_, recv_from_global_patch_rank, hindex*6   );
+    smpi->recv( localfields->Ey_, recv_from_global_patch_rank, hindex*6+1 );
+    smpi->recv( localfields->Ez_, recv_from_global_patch_rank, hindex*6+2 );
    
-    smpi->irecv( localfields->Bx_m, recv_from_global_patch_rank, hindex*6+3, patch->requests_[3] );
-    smpi->irecv( localfields->By_m, recv_from_global_patch_rank, hindex*6+4, patch->requests_[4] );
-    smpi->irecv( localfields->Bz_m, recv_from_global_patch_rank, hindex*6+5, patch->requests_[5] );
+    smpi->recv( localfields->Bx_m, recv_from_global_patch_rank, hindex*6+3 );
+    smpi->recv( localfields->By_m, recv_from_global_patch_rank, hindex*6+4 );
+    smpi->recv( localfields->Bz_m, recv_from_global_patch_rank, hindex*6+5 );
 
 }
 
-void DoubleGrids::fieldsOnPatchesRecvFinalize( Patch* patch )
-{
-    MPI_Status status;
-    // Wait for fieldsOnPatchesRecv (irecv)
-    MPI_Wait( &(patch->requests_[0]), &status );
-    MPI_Wait( &(patch->requests_[1]), &status );
-    MPI_Wait( &(patch->requests_[2]), &status );
-    MPI_Wait( &(patch->requests_[3]), &status );
-    MPI_Wait( &(patch->requests_[4]), &status );
-    MPI_Wait( &(patch->requests_[5]), &status );
-}
-
-void DoubleGrids::fieldsOnPatchesSend( ElectroMagn* globalfields, unsigned int hindex, int local_patch_rank, VectorPatch& vecPatches, Params &params, SmileiMPI* smpi, Region& region )
+void DoubleGrids::fieldsOnPatchesSend( ElectroMagn* globalfields, std::vector<double>* buffers, unsigned int hindex, int local_patch_rank, VectorPatch& vecPatches, Params &params, SmileiMPI* smpi, Region& region )
 {
     // fake_patch consists in a piece of the local Region to handle naturally patches communications
     //            need to update its hindex and coordinates to extract (get) appropriate data from the local Region data before send it
     region.fake_patch->hindex = hindex;
     region.fake_patch->Pcoordinates = vecPatches.domain_decomposition_->getDomainCoordinates( hindex );
+    ElectroMagn* fake_fields = region.fake_patch->EMfields;
 
-    // send( Fields, targeted_mpi_rank, tag );
-    //       tag = *6 ? 6 communications could be required per patch
-    //       clarify which usage need B, B_m or both
-    region.fake_patch->EMfields->Ex_->get( globalfields->Ex_, params, region.patch_, region.fake_patch );
-    smpi->send( region.fake_patch->EMfields->Ex_, local_patch_rank, hindex*6 );
-
-    region.fake_patch->EMfields->Ey_->get( globalfields->Ey_, params, region.patch_, region.fake_patch );
-    smpi->send( region.fake_patch->EMfields->Ey_, local_patch_rank, hindex*6+1 );
-
-    region.fake_patch->EMfields->Ez_->get( globalfields->Ez_, params, region.patch_, region.fake_patch );
-    smpi->send( region.fake_patch->EMfields->Ez_, local_patch_rank, hindex*6+2 );
-
-    region.fake_patch->EMfields->Bx_m->get( globalfields->Bx_m, params, region.patch_, region.fake_patch );
-    smpi->send( region.fake_patch->EMfields->Bx_m, local_patch_rank, hindex*6+3 );
-
-    region.fake_patch->EMfields->By_m->get( globalfields->By_m, params, region.patch_, region.fake_patch );
-    smpi->send( region.fake_patch->EMfields->By_m, local_patch_rank, hindex*6+4 );
-
-    region.fake_patch->EMfields->Bz_m->get( globalfields->Bz_m, params, region.patch_, region.fake_patch );
-    smpi->send( region.fake_patch->EMfields->Bz_m, local_patch_rank, hindex*6+5 );
+    // isend( buffer, targeted_mpi_rank, tag, request ) : copies of the fake_patch fields, reused for the next patch
+    //        only recorded in the message to targeted_mpi_rank ( see SmileiMPI::startBatches )
+    //        clarify which usage need B, B_m or both
+    Field* fields[6] = { fake_fields->Ex_, fake_fields->Ey_, fake_fields->Ez_, fake_fields->Bx_m, fake_fields->By_m, fake_fields->Bz_m };
+    Field* global[6] = { globalfields->Ex_, globalfields->Ey_, globalfields->Ez_, globalfields->Bx_m, globalfields->By_m, globalfields->Bz_m };
+    MPI_Request request;
+    for ( unsigned int ifield=0 ; ifield<6 ; ifield++ ) {
+        fields[ifield]->get( global[ifield], params, region.patch_, region.fake_patch );
+        buffers[ifield].assign( fields[ifield]->data_, fields[ifield]->data_ + fields[ifield]->number_of_points_ );
+        smpi->isend( &buffers[ifield], local_patch_rank, hindex*6+ifield, request );
+    }
 
 }
 
@@ -400,6 +417,8 @@ void DoubleGrids::syncBOnPatches( Region &region, VectorPatch &vecPatches, Param
     }
 
     // Loop / local_patches_ ( patches own by the local vePatches whose data are used by the local Region )
+    //        each patch only writes its own fields : patches are processed concurrently
+    #pragma omp parallel for schedule(runtime)
     for ( unsigned int i=0 ; i<region.local_patches_.size() ; i++ ) {
 
         unsigned int ipatch = region.local_patches_[i]-vecPatches.refHindex_;
@@ -490,6 +509,8 @@ void DoubleGrids::syncCurrentsOnPatches( Region &region, VectorPatch &vecPatches
     }
 
     // Loop / local_patches_ ( patches own by the local vePatches whose data are used by the local Region )
+    //        each patch only writes its own fields : patches are processed concurrently
+    #pragma omp parallel for schedule(runtime)
     for ( unsigned int i=0 ; i<region.local_patches_.size() ; i++ ) {
 
         unsigned int ipatch = region.local_patches_[i]-vecPatches.refHindex_;
@@ -2,6 +2,8 @@
 #ifndef DOUBLEGRIDS_H
 #define DOUBLEGRIDS_H
 
+#include <vector>
+
 class Region;
 class VectorPatch;
 class Patch;
@@ -17,13 +19,14 @@ public :
 
     static void syncCurrentsOnRegion( VectorPatch &vecPatches, Region &region, Params &params, SmileiMPI *smpi, Timers &timers );
     static void currentsOnRegionSend( ElectroMagn* localfields, unsigned int hindex, int send_to_global_patch_rank, SmileiMPI * smpi, Patch *patch, Params& params );
-    static void currentsOnRegionSendFinalize( Patch *patch, Params& params );
-    static void currentsOnRegionRecv( ElectroMagn* globalfields, unsigned int hindex, int local_patch_rank, VectorPatch& vecPatches, Params &params, SmileiMPI* smpi, Region& region );
+    static void currentsOnRegionRecv( std::vector<double>* buffers, int local_patch_rank, Params &params, SmileiMPI* smpi, Region& region );
+    static void currentsOnRegionAdd( ElectroMagn* globalfields, std::vector<double>* buffers, unsigned int hindex, VectorPatch& vecPatches, Params &params, Region& region );
+    //! Parity of the patch coordinates, in [0, 2^nDim_field[ : the patches of a same color do not overlap
+    static unsigned int patchColor( Patch* patch, Params &params );
 
     static void syncFieldsOnPatches( Region &region, VectorPatch &vecPatches, Params &params, SmileiMPI *smpi, Timers &timers );
     static void fieldsOnPatchesRecv( ElectroMagn* localfields, unsigned int hindex, int recv_from_global_patch_rank, SmileiMPI* smpi, Patch* patch );
-    static void fieldsOnPatchesRecvFinalize( Patch* patch );
-    static void fieldsOnPatchesSend( ElectroMagn* globalfields, unsigned int hindex, int local_patch_rank, VectorPatch& vecPatches, Params &params, SmileiMPI* smpi, Region& region );
+    static void fieldsOnPatchesSend( ElectroMagn* globalfields, std::vector<double>* buffers, unsigned int hindex, int local_patch_rank, VectorPatch& vecPatches, Params &params, SmileiMPI* smpi, Region& region );
 
     static void syncBOnPatches( Region &region, VectorPatch &vecPatches, Params &params, SmileiMPI *smpi, Timers &timers );
     static void bOnPatchesRecv( ElectroMagn* localfields, unsigned int hindex, int recv_from_global_patch_rank, SmileiMPI* smpi, Patch* patch );
@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 #include "DomainDecompositionFactory.h"
 #include "Hilbert_functions.h"
@@ -130,6 +131,9 @@ void Patch::initStep1( Params &params )
 
     // Obtain the cell_volume
     cell_volume = params.cell_volume;
+
+    // The debye length is computed in all bins at the first collisions (debye_length_squared is empty)
+    debye_length_itime = 0;
 }
 
 
@@ -252,6 +256,8 @@ void Patch::finalizeMPIenvironment( Params &params )
     for( unsigned int idiag=0; idiag<EMfields->allFields_avg.size(); idiag++ ) {
         nb_comms += EMfields->allFields_avg[idiag].size();
     }
+    // Averaged fields and currents of the sub-cycled species
+    nb_comms += EMfields->averaged_fields_.size() + EMfields->subcycled_currents_.size();
     nb_comms += EMfields->antennas.size();
 
     for( unsigned int bcId=0 ; bcId<EMfields->emBoundCond.size() ; bcId++ ) {
@@ -571,7 +577,7 @@ void Patch::exchNbrOfParticles( SmileiMPI *smpi, int ispec, Params &, int iDim,
             if( is_a_MPI_neighbor( iDim, iNeighbor ) ) {
                 int local_hindex = hindex - vecPatch->refHindex_;
                 int tag = buildtag( local_hindex, iDim+1, iNeighbor+3 );
-                MPI_Isend( &buffer.partSendSize[iDim][iNeighbor], 1, MPI_INT, MPI_neighbor_[iDim][iNeighbor], tag, MPI_COMM_WORLD, &buffer.srequest[iDim][iNeighbor] );
+                MPI_Isend( &buffer.partSendSize[iDim][iNeighbor], 1, MPI_INT, MPI_neighbor_[iDim][iNeighbor], tag, smpi->world(), &buffer.srequest[iDim][iNeighbor] );
             } else {
                 // If the destination is in the same MPI, directly set the number at destination
                 int destination_hindex = neighbor_[iDim][iNeighbor] - vecPatch->refHindex_;
@@ -585,7 +591,7 @@ void Patch::exchNbrOfParticles( SmileiMPI *smpi, int ispec, Params &, int iDim,
             if( is_a_MPI_neighbor( iDim, iOppositeNeighbor ) ) {
                 int local_hindex = neighbor_[iDim][iOppositeNeighbor] - smpi->patch_refHindexes[ MPI_neighbor_[iDim][iOppositeNeighbor] ];
                 int tag = buildtag( local_hindex, iDim+1, iNeighbor+3 );
-                MPI_Irecv( &buffer.partRecvSize[iDim][iOppositeNeighbor], 1, MPI_INT, MPI_neighbor_[iDim][iOppositeNeighbor], tag, MPI_COMM_WORLD, &buffer.rrequest[iDim][iOppositeNeighbor] );
+                MPI_Irecv( &buffer.partRecvSize[iDim][iOppositeNeighbor], 1, MPI_INT, MPI_neighbor_[iDim][iOppositeNeighbor], tag, smpi->world(), &buffer.rrequest[iDim][iOppositeNeighbor] );
             }
         }
         
@@ -667,7 +673,7 @@ void Patch::prepareParticles( SmileiMPI *smpi, int ispec, Params &params, int iD
 } // END prepareParticles(... iDim)
 
 
-void Patch::exchParticles( SmileiMPI *smpi, int ispec, Params &, int iDim, VectorPatch *vecPatch )
+void Patch::exchParticles( SmileiMPI *smpi, int ispec, Params &params, int iDim, VectorPatch *vecPatch )
 {
     SpeciesMPIbuffers &buffer = vecSpecies[ispec]->MPI_buffer_;
     
@@ -678,18 +684,33 @@ void Patch::exchParticles( SmileiMPI *smpi, int ispec, Params &, int iDim, Vecto
         if( partSend.size() != 0 && is_a_MPI_neighbor( iDim, iNeighbor ) ) {
             int local_hindex = hindex - vecPatch->refHindex_;
             int tag = buildtag( local_hindex, iDim+1, iNeighbor+3 );
-            vecSpecies[ispec]->typePartSend[( iDim*2 )+iNeighbor] = smpi->createMPIparticles( &partSend );
-            MPI_Isend( &partSend.position( 0, 0 ), 1, vecSpecies[ispec]->typePartSend[( iDim*2 )+iNeighbor], MPI_neighbor_[iDim][iNeighbor], tag, MPI_COMM_WORLD, &( buffer.srequest[iDim][iNeighbor] ) );
+            if( params.pack_exchanged_particles ) {
+                size_t packed_size = partSend.pack( buffer.packedSend[iDim][iNeighbor] );
+                MPI_Isend( buffer.packedSend[iDim][iNeighbor].data(), packed_size, MPI_BYTE, MPI_neighbor_[iDim][iNeighbor], tag, smpi->world(), &( buffer.srequest[iDim][iNeighbor] ) );
+                smpi->countSentBytes( SmileiMPI::sent_particles, packed_size );
+            } else {
+                vecSpecies[ispec]->typePartSend[( iDim*2 )+iNeighbor] = smpi->createMPIparticles( &partSend );
+                MPI_Isend( &partSend.position( 0, 0 ), 1, vecSpecies[ispec]->typePartSend[( iDim*2 )+iNeighbor], MPI_neighbor_[iDim][iNeighbor], tag, smpi->world(), &( buffer.srequest[iDim][iNeighbor] ) );
+                smpi->countSentBytes( SmileiMPI::sent_particles, partSend.size() * vecSpecies[ispec]->getParticleMemory() );
+            }
         }
         
         // Receive
         int iOppositeNeighbor = ( iNeighbor+1 )%2;
         Particles &partRecv = *buffer.partRecv[iDim][iOppositeNeighbor];
         if( partRecv.size() != 0 && is_a_MPI_neighbor( iDim, iOppositeNeighbor ) ) {
-            vecSpecies[ispec]->typePartRecv[( iDim*2 )+iNeighbor] = smpi->createMPIparticles( &partRecv );
             int local_hindex = neighbor_[iDim][iOppositeNeighbor] - smpi->patch_refHindexes[ MPI_neighbor_[iDim][iOppositeNeighbor] ];
             int tag = buildtag( local_hindex, iDim+1, iNeighbor+3 );
-            MPI_Irecv( &partRecv.position( 0, 0 ), 1, vecSpecies[ispec]->typePartRecv[( iDim*2 )+iNeighbor], MPI_neighbor_[iDim][iOppositeNeighbor], tag, MPI_COMM_WORLD, &buffer.rrequest[iDim][iOppositeNeighbor] );
+            if( params.pack_exchanged_particles ) {
+                std::vector<char> &packedRecv = buffer.packedRecv[iDim][iOppositeNeighbor];
+                if( packedRecv.size() < partRecv.packedSize() ) {
+                    packedRecv.resize( partRecv.packedSize() );
+                }
+                MPI_Irecv( packedRecv.data(), partRecv.packedSize(), MPI_BYTE, MPI_neighbor_[iDim][iOppositeNeighbor], tag, smpi->world(), &buffer.rrequest[iDim][iOppositeNeighbor] );
+            } else {
+                vecSpecies[ispec]->typePartRecv[( iDim*2 )+iNeighbor] = smpi->createMPIparticles( &partRecv );
+                MPI_Irecv( &partRecv.position( 0, 0 ), 1, vecSpecies[ispec]->typePartRecv[( iDim*2 )+iNeighbor], MPI_neighbor_[iDim][iOppositeNeighbor], tag, smpi->world(), &buffer.rrequest[iDim][iOppositeNeighbor] );
+            }
         }
         
     }
@@ -700,7 +721,7 @@ void Patch::exchParticles( SmileiMPI *smpi, int ispec, Params &, int iDim, Vecto
 // ---------------------------------------------------------------------------------------------------------------------
 // For direction iDim, wait receive of particles
 // ---------------------------------------------------------------------------------------------------------------------
-void Patch::waitExchParticles( int ispec, int iDim )
+void Patch::waitExchParticles( int ispec, int iDim, Params &params )
 {
     SpeciesMPIbuffers &buffer = vecSpecies[ispec]->MPI_buffer_;
     
@@ -715,11 +736,17 @@ void Patch::waitExchParticles( int ispec, int iDim )
         
         if( partSend.size() != 0 &&  is_a_MPI_neighbor( iDim, iNeighbor ) ) {
             MPI_Wait( &buffer.srequest[iDim][iNeighbor], &sstat[iNeighbor] );
-            MPI_Type_free( &vecSpecies[ispec]->typePartSend[( iDim*2 )+iNeighbor] );
+            if( ! params.pack_exchanged_particles ) {
+                MPI_Type_free( &vecSpecies[ispec]->typePartSend[( iDim*2 )+iNeighbor] );
+            }
         }
         if( partRecv.size() != 0 && is_a_MPI_neighbor( iDim, iOppositeNeighbor ) ) {
             MPI_Wait( &buffer.rrequest[iDim][iOppositeNeighbor], &rstat[iOppositeNeighbor] );
-            MPI_Type_free( &vecSpecies[ispec]->typePartRecv[( iDim*2 )+iNeighbor] );
+            if( params.pack_exchanged_particles ) {
+                partRecv.unpack( buffer.packedRecv[iDim][iOppositeNeighbor] );
+            } else {
+                MPI_Type_free( &vecSpecies[ispec]->typePartRecv[( iDim*2 )+iNeighbor] );
+            }
         }
     }
 }
@@ -824,20 +851,60 @@ void Patch::cleanParticlesOverhead( Params &params )
     for( unsigned int ispec=0 ; ispec<vecSpecies.size() ; ispec++ ) {
         SpeciesMPIbuffers &buffer = vecSpecies[ispec]->MPI_buffer_;
         
+        // Capacity kept, relative to the current number of particles, to avoid reallocations at the next iterations
+        const unsigned int npart = vecSpecies[ispec]->getNbrOfParticles();
+        const unsigned int buffer_capacity = params.particles_capacity_margin * npart;
+        
         for( size_t idim = 0; idim < params.nDim_field; idim++ ) {
             for( int iNeighbor=0 ; iNeighbor<nbNeighbors_ ; iNeighbor++ ) {
                 buffer.partRecv[idim][iNeighbor]->clear();
-                buffer.partRecv[idim][iNeighbor]->shrinkToFit( );
+                buffer.partRecv[idim][iNeighbor]->reduceCapacity( buffer_capacity );
                 buffer.partSend[idim][iNeighbor]->clear();
-                buffer.partSend[idim][iNeighbor]->shrinkToFit( );
+                buffer.partSend[idim][iNeighbor]->reduceCapacity( buffer_capacity );
             }
         }
         
-        vecSpecies[ispec]->particles->shrinkToFit(  );
+        // Capacity for the particles expected from ionization, radiation, pair creation and injection
+        unsigned int capacity = npart + buffer_capacity;
+        if( params.particles_forecast_length > 0 ) {
+            const unsigned int forecast = vecSpecies[ispec]->forecastImportedParticles( params.particles_forecast_length );
+            capacity = npart + std::max( buffer_capacity, forecast );
+        }
+        
+        vecSpecies[ispec]->particles->reduceCapacity( capacity );
+        if( params.particles_forecast_length > 0 ) {
+            vecSpecies[ispec]->particles->reserve( capacity );
+        }
     }
 
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// The memory of a page is placed on the NUMA domain of the thread which first writes it: the fields and particles,
+// created by the master thread, are copied by a thread of the domain which processes the patch.
+// With the spectral solvers, the magnetic fields may share their data with the time-centered ones: not copied.
+// ---------------------------------------------------------------------------------------------------------------------
+void Patch::relocateData( Params &params )
+{
+    if( ! params.is_spectral ) {
+        for( unsigned int ifield=0 ; ifield<EMfields->allFields.size() ; ifield++ ) {
+            if( EMfields->allFields[ifield] ) {
+                EMfields->allFields[ifield]->relocateData();
+            }
+        }
+        for( unsigned int ifield=0 ; ifield<EMfields->averaged_fields_.size() ; ifield++ ) {
+            EMfields->averaged_fields_[ifield]->relocateData();
+        }
+        for( unsigned int ifield=0 ; ifield<EMfields->subcycled_currents_.size() ; ifield++ ) {
+            EMfields->subcycled_currents_[ifield]->relocateData();
+        }
+    }
+
+    for( unsigned int ispec=0 ; ispec<vecSpecies.size() ; ispec++ ) {
+        vecSpecies[ispec]->particles->relocateData();
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Clear vecSpecies[]->indexes_of_particles_to_exchange, suppress particles send and manage memory
 // ---------------------------------------------------------------------------------------------------------------------
@@ -911,6 +978,13 @@ void Patch::initExchange( Field *field, int iDim, SmileiMPI *smpi, bool devPtr )
         if( field->name == "Bz" ) {
             tagp = 8;
         }
+        // Distinct from By and Bz, exchanged in the same round
+        if( field->name == "By_mBTIS3" ) {
+            tagp = 5;
+        }
+        if( field->name == "Bz_mBTIS3" ) {
+            tagp = 9;
+        }
 
         field->MPIbuff.defineTags( this, smpi, tagp );
     }
@@ -924,12 +998,13 @@ void Patch::initExchange( Field *field, int iDim, SmileiMPI *smpi, bool devPtr )
                 // Assumes a GPU compatible MPI implementation
                 MPI_Isend( sendField, field->sendFields_[iDim*2+iNeighbor]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][iNeighbor], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+                           smpi->world(), &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
             } else {
                 MPI_Isend( field->sendFields_[iDim*2+iNeighbor]->data_, field->sendFields_[iDim*2+iNeighbor]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][iNeighbor], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+                           smpi->world(), &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
             }
+            smpi->countSentBytes( SmileiMPI::sent_fields, field->sendFields_[iDim*2+iNeighbor]->size() * sizeof( double ) );
         } // END of Send
 
         if( is_a_MPI_neighbor( iDim, ( iNeighbor+1 )%2 ) ) {
@@ -939,11 +1014,11 @@ void Patch::initExchange( Field *field, int iDim, SmileiMPI *smpi, bool devPtr )
                 // Assumes a GPU compatible MPI implementation
                 MPI_Irecv( recvField, field->recvFields_[iDim*2+(iNeighbor+1)%2]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][( iNeighbor+1 )%2], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
+                           smpi->world(), &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
             } else {
                 MPI_Irecv( field->recvFields_[iDim*2+(iNeighbor+1)%2]->data_, field->recvFields_[iDim*2+(iNeighbor+1)%2]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][( iNeighbor+1 )%2], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
+                           smpi->world(), &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
             }
         } // END of Recv
     } // END for iNeighbor
@@ -955,14 +1030,31 @@ void Patch::initExchangeComplex( Field *field, int iDim, SmileiMPI *smpi )
     if( field->MPIbuff.srequest.size()==0 ) {
         field->MPIbuff.allocate( nDim_fields_ );
 
+        // The components of a mode have distinct tags, so that they can be exchanged in the same round
+        std::string component = field->name.substr( 0, field->name.find( "_mode_" ) );
         int tagp( 0 );
-        if( field->name == "Bl" ) {
+        if( component == "El" ) {
+            tagp = 1;
+        }
+        if( component == "Er" ) {
+            tagp = 2;
+        }
+        if( component == "Et" ) {
+            tagp = 3;
+        }
+        if( component == "Br_mBTIS3" ) {
+            tagp = 4;
+        }
+        if( component == "Bt_mBTIS3" ) {
+            tagp = 5;
+        }
+        if( component == "Bl" ) {
             tagp = 6;
         }
-        if( field->name == "Br" ) {
+        if( component == "Br" ) {
             tagp = 7;
         }
-        if( field->name == "Bt" ) {
+        if( component == "Bt" ) {
             tagp = 8;
         }
 
@@ -975,14 +1067,15 @@ void Patch::initExchangeComplex( Field *field, int iDim, SmileiMPI *smpi )
             int tag = field->MPIbuff.send_tags_[iDim][iNeighbor];
             MPI_Isend( static_cast<cField *>(field->sendFields_[iDim*2+iNeighbor])->cdata_, 2*field->sendFields_[iDim*2+iNeighbor]->number_of_points_,
                        MPI_DOUBLE, MPI_neighbor_[iDim][iNeighbor], tag,
-                       MPI_COMM_WORLD, &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+                       smpi->world(), &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+            smpi->countSentBytes( SmileiMPI::sent_fields, 2*field->sendFields_[iDim*2+iNeighbor]->number_of_points_ * sizeof( double ) );
         } // END of Send
 
         if( is_a_MPI_neighbor( iDim, ( iNeighbor+1 )%2 ) ) {
             int tag = field->MPIbuff.recv_tags_[iDim][iNeighbor];
             MPI_Irecv( static_cast<cField *>(field->recvFields_[iDim*2+(iNeighbor+1)%2])->cdata_, 2*field->recvFields_[iDim*2+(iNeighbor+1)%2]->number_of_points_,
                        MPI_DOUBLE, MPI_neighbor_[iDim][( iNeighbor+1 )%2], tag,
-                       MPI_COMM_WORLD, &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
+                       smpi->world(), &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
         } // END of Recv
 
     } // END for iNeighbor
@@ -1008,6 +1101,65 @@ void Patch::finalizeExchange( Field *field, int iDim )
 } // END finalizeExchange( Field* field, int iDim )
 
 
+double *Patch::fieldPlanes( Field *field, unsigned int &plane_size )
+{
+    cField *cfield = dynamic_cast<cField *>( field );
+    plane_size = ( cfield ? 2 : 1 ) * field->number_of_points_ / field->dims_[0];
+    return cfield ? reinterpret_cast<double *>( cfield->cdata_ ) : field->data_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Moving window of a region: the planes x = constant are contiguous in all fields, so the clrw planes sent to xmin
+// (after the ghost cells) and those received from xmax (at the end) of all fields are gathered in a single message
+// ---------------------------------------------------------------------------------------------------------------------
+void Patch::initShiftFields_movewin( std::vector<Field *> &fields, int clrw )
+{
+    unsigned int size = 0;
+    for( unsigned int ifield=0 ; ifield<fields.size() ; ifield++ ) {
+        unsigned int plane_size;
+        fieldPlanes( fields[ifield], plane_size );
+        size += clrw * plane_size;
+    }
+
+    movewin_requests_[0] = MPI_REQUEST_NULL;
+    movewin_requests_[1] = MPI_REQUEST_NULL;
+
+    if( MPI_neighbor_[0][0]!=MPI_PROC_NULL ) {
+        movewin_send_buffer_.resize( size );
+        unsigned int offset = 0;
+        for( unsigned int ifield=0 ; ifield<fields.size() ; ifield++ ) {
+            unsigned int plane_size;
+            double *data = fieldPlanes( fields[ifield], plane_size );
+            unsigned int ix = 2*oversize[0] + 1 + fields[ifield]->isDual_[0];
+            memcpy( &movewin_send_buffer_[offset], &data[ix*plane_size], clrw*plane_size*sizeof( double ) );
+            offset += clrw * plane_size;
+        }
+        MPI_Isend( movewin_send_buffer_.data(), size, MPI_DOUBLE, MPI_neighbor_[0][0], 0, MPI_COMM_WORLD, &movewin_requests_[0] );
+    }
+
+    if( MPI_neighbor_[0][1]!=MPI_PROC_NULL ) {
+        movewin_recv_buffer_.resize( size );
+        MPI_Irecv( movewin_recv_buffer_.data(), size, MPI_DOUBLE, MPI_neighbor_[0][1], 0, MPI_COMM_WORLD, &movewin_requests_[1] );
+    }
+}
+
+void Patch::finalizeShiftFields_movewin( std::vector<Field *> &fields, int clrw )
+{
+    MPI_Waitall( 2, movewin_requests_, MPI_STATUSES_IGNORE );
+
+    if( MPI_neighbor_[0][1]!=MPI_PROC_NULL ) {
+        unsigned int offset = 0;
+        for( unsigned int ifield=0 ; ifield<fields.size() ; ifield++ ) {
+            unsigned int plane_size;
+            double *data = fieldPlanes( fields[ifield], plane_size );
+            unsigned int ix = fields[ifield]->dims_[0] - clrw;
+            memcpy( &data[ix*plane_size], &movewin_recv_buffer_[offset], clrw*plane_size*sizeof( double ) );
+            offset += clrw * plane_size;
+        }
+    }
+}
+
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Initialize current patch sum Fields communications through MPI in direction iDim
 // Intra-MPI process communications managed by memcpy in SyncVectorPatch::sum()
@@ -1049,12 +1201,13 @@ void Patch::initSumField( Field *field, int iDim, SmileiMPI *smpi, bool devPtr )
                 // Assumes a GPU compatible MPI implementation
                 MPI_Isend( sendField, field->sendFields_[iDim*2+iNeighbor]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][iNeighbor], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+                           smpi->world(), &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
             } else {
                 MPI_Isend( field->sendFields_[iDim*2+iNeighbor]->data_, field->sendFields_[iDim*2+iNeighbor]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][iNeighbor], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+                           smpi->world(), &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
             }
+            smpi->countSentBytes( SmileiMPI::sent_fields, field->sendFields_[iDim*2+iNeighbor]->size() * sizeof( double ) );
         } // END of Send
 
         if( is_a_MPI_neighbor( iDim, ( iNeighbor+1 )%2 ) ) {
@@ -1065,11 +1218,11 @@ void Patch::initSumField( Field *field, int iDim, SmileiMPI *smpi, bool devPtr )
                 // Assumes a GPU compatible MPI implementation
                 MPI_Irecv( recvField, field->recvFields_[iDim*2+(iNeighbor+1)%2]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][( iNeighbor+1 )%2], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
+                           smpi->world(), &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
             } else {
                 MPI_Irecv( field->recvFields_[iDim*2+(iNeighbor+1)%2]->data_, field->recvFields_[iDim*2+(iNeighbor+1)%2]->size(),
                            MPI_DOUBLE, MPI_neighbor_[iDim][( iNeighbor+1 )%2], tag,
-                           MPI_COMM_WORLD, &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
+                           smpi->world(), &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
             }
         } // END of Recv
     } // END for iNeighbor
@@ -138,32 +138,49 @@ public:
 
 #endif
 
-#ifdef __DETAILED_TIMERS
-    inline void __attribute__((always_inline)) startFineTimer(unsigned int index) {
+    inline void __attribute__((always_inline)) startFineTimer( unsigned int index ) {
+#ifdef  __DETAILED_TIMERS
 #ifdef _OMPTASKS
         const int ithread = Tools::getOMPThreadNum();
         patch_tmp_timers_[index * number_of_threads_ + ithread] = MPI_Wtime();
 #else
         patch_tmp_timers_[index] = MPI_Wtime();
 #endif
-#else
-    inline void __attribute__((always_inline)) startFineTimer(unsigned int) {
 #endif
+        if( operator_sampling_ && index < sampled_operators_count ) {
+            sampled_operator_start_[index] = MPI_Wtime();
+        }
     }
     
+    inline void __attribute__((always_inline)) stopFineTimer( unsigned int index ) {
 #ifdef  __DETAILED_TIMERS
-    inline void __attribute__((always_inline)) stopFineTimer(unsigned int index) {
 #ifdef _OMPTASKS
         const int ithread = Tools::getOMPThreadNum();   
         patch_timers_[index * number_of_threads_ + ithread] += MPI_Wtime() - patch_tmp_timers_[index * number_of_threads_ + ithread];
 #else
         patch_timers_[index] += MPI_Wtime() - patch_tmp_timers_[index];
 #endif
-#else
-    inline void __attribute__((always_inline)) stopFineTimer(unsigned int) {
 #endif
+        if( operator_sampling_ && index < sampled_operators_count ) {
+            sampled_operator_times_[sampled_species_ * sampled_operators_count + index] += MPI_Wtime() - sampled_operator_start_[index];
+        }
     }
 
+    //! Number of particle operators sampled by DiagPerformances.operator_sampling_every (fine timer ids 0 to 6)
+    static const unsigned int sampled_operators_count = 7;
+
+    //! Wall time of each sampled operator of each species (species * sampled_operators_count + timer id),
+    //! accumulated over the sampled iterations since the last output of DiagPerformances
+    std::vector<double> sampled_operator_times_;
+
+    //! Number of sampled iterations accumulated in sampled_operator_times_
+    unsigned int operator_samples_ = 0;
+
+    //! True during the dynamics of a sampled iteration, for the species sampled_species_
+    bool operator_sampling_ = false;
+    unsigned int sampled_species_ = 0;
+    double sampled_operator_start_[sampled_operators_count];
+
     // Random number generator.
     Random * rand_;
     
@@ -184,13 +201,15 @@ public:
     //! effective exchange of particles
     void exchParticles( SmileiMPI *smpi, int ispec, Params &params, int iDim, VectorPatch *vecPatch );
     //! finalize exch / particles
-    void waitExchParticles( int ispec, int iDim );
+    void waitExchParticles( int ispec, int iDim, Params &params );
     //! Treat diagonalParticles
     void cornersParticles( int ispec, Params &params, int iDim );
     //! inject particles received in main data structure and particles sorting
     void importAndSortParticles( int ispec, Params &params );
     //! clean memory resizing particles structure
     void cleanParticlesOverhead( Params &params );
+    //! copy the fields and particles in new arrays, first touched by the calling thread (NUMA placement)
+    void relocateData( Params &params );
     //! delete Particles included in the index of particles to exchange. Assumes indexes are sorted.
     void cleanupSentParticles( int ispec, std::vector<int> *indexes_of_particles_to_exchange );
 
@@ -225,7 +244,12 @@ public:
     //! finalize comm / exchange fields
     virtual void finalizeExchange( Field *field, int iDim );
     
-    virtual void exchangeField_movewin ( Field* field, int clrw ) = 0;
+    //! Moving window of a region: the fields are shifted by clrw cells along x, the cells leaving the region are sent
+    //! to the region at xmin, and those entering are received from the region at xmax, for all fields in one message.
+    //! This starts the communications, so that the fields can then be shifted (shift_x) by the threads meanwhile.
+    void initShiftFields_movewin( std::vector<Field *> &fields, int clrw );
+    //! Finalize the communications and copy the received cells in the shifted fields
+    void finalizeShiftFields_movewin( std::vector<Field *> &fields, int clrw );
     
     // Create MPI_Datatype to exchange fields
     virtual void createType2( Params &params ) = 0;
@@ -438,6 +462,10 @@ public:
     
     //! The debye length, computed for collisions
     std::vector<double> debye_length_squared;
+    //! Sum of the weights of all species in each bin, when its debye length was computed
+    std::vector<double> debye_length_density;
+    //! Iteration of the last calculation of the debye length in all bins
+    int debye_length_itime;
     
     //! The patch geometrical center
     std::vector<double> center_;
@@ -448,6 +476,30 @@ public:
     
     bool is_small = true;
 
+    //! True when the particles brought by the moving window are not created yet (done at the beginning of the next iteration)
+    bool particles_pending_ = false;
+
+    //! True when no species of the patch had particles at its last dynamics: the particle operators are skipped
+    bool vacuum_ = false;
+
+    //! Wall time of the patch since its last average, and the exponential average of its iterations
+    //! (LoadBalancing.measured_load_steps), negative before the first one
+    double load_time_ = 0.;
+    double measured_load_ = -1.;
+
+    //! Fold the wall time of the last iteration in its exponential average over nsteps iterations
+    inline void averageLoadTime( unsigned int nsteps )
+    {
+        if( load_time_ > 0. ) {
+            measured_load_ = measured_load_ < 0. ? load_time_ : measured_load_ + ( load_time_ - measured_load_ ) / nsteps;
+            load_time_ = 0.;
+        }
+    }
+
+    //! NUMA domain on which the fields and particles were placed by relocateData
+    //! (Main.dynamics_scheduling = "numa_affinity"), -1 before
+    int numa_domain_ = -1;
+
     void copySpeciesBinsInLocalDensities(int ispec, int clrw, Params &params, bool diag_flag);
     void copySpeciesBinsInLocalSusceptibility(int ispec, int clrw, Params &params, bool diag_flag);
         
@@ -484,6 +536,13 @@ protected:
     std::vector<int> buffer_vecto;
     std::vector<double> buffer_scalars_particles;
     std::vector<double> buffer_scalars_fields;
+
+    //! Buffers and requests of the moving window of a region
+    std::vector<double> movewin_send_buffer_, movewin_recv_buffer_;
+    MPI_Request movewin_requests_[2];
+
+    //! Array of a field (real or complex, as doubles), and number of doubles per plane along x
+    static double *fieldPlanes( Field *field, unsigned int &plane_size );
         
 };
 
@@ -115,35 +115,3 @@ void Patch1D::cleanType()
     }
 }
 
-void Patch1D::exchangeField_movewin( Field* field, int clrw )
-{
-    std::vector<unsigned int> n_elem   = field->dims_;
-    std::vector<unsigned int> isDual = field->isDual_;
-    Field1D* f1D =  static_cast<Field1D*>(field);
-
-    int bufsize = clrw * sizeof(double) + 2 * MPI_BSEND_OVERHEAD; //Max number of doubles in the buffer. Careful, there might be MPI overhead to take into account.
-    void *b = (void *)malloc(bufsize);
-    MPI_Buffer_attach( b, bufsize);
-
-    // Loop over dimField
-    // See sumField for details
-    MPI_Status rstat;
-    MPI_Request rrequest;
-
-    if( neighbor_[0][0]!=MPI_PROC_NULL ) {
-        int istart = 2*oversize[0] + 1 + isDual[0]  ;
-        MPI_Bsend( &(f1D->data_[istart]), clrw, MPI_DOUBLE, neighbor_[0][0], 0, MPI_COMM_WORLD);
-    } // END of Send
-
-    field->shift_x(clrw);
-
-    if( MPI_neighbor_[0][1]!=MPI_PROC_NULL ) {
-        int istart = n_elem[0] - clrw;
-        MPI_Irecv( &(f1D->data_[istart]), clrw, MPI_DOUBLE, MPI_neighbor_[0][1], 0, MPI_COMM_WORLD, &rrequest );
-        MPI_Wait( &rrequest, &rstat );
-    }
-
-    MPI_Buffer_detach( &b, &bufsize);
-    free(b);
-
-} // END exchangeField
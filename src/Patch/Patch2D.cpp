@@ -153,36 +153,3 @@ void Patch2D::cleanType()
 }
 
 
-void Patch2D::exchangeField_movewin( Field* field, int clrw )
-{
-    std::vector<unsigned int> n_elem   = field->dims_;
-    std::vector<unsigned int> isDual = field->isDual_;
-    Field2D* f2D =  static_cast<Field2D*>(field);
-
-    int bufsize = clrw*n_elem[1]*sizeof(double)+ 2 * MPI_BSEND_OVERHEAD; //Max number of doubles in the buffer. Careful, there might be MPI overhead to take into account.
-    void *b=(void *)malloc(bufsize);
-    MPI_Buffer_attach( b, bufsize);
-
-    MPI_Status rstat    ;
-    MPI_Request rrequest;
-
-    if( MPI_neighbor_[0][0]!=MPI_PROC_NULL ) {
-        int ix = 2*oversize[0] + 1 + isDual[0];
-        int iy =  0 ;
-        MPI_Bsend( &(f2D->data_2D[ix][iy]), clrw*n_elem[1], MPI_DOUBLE, MPI_neighbor_[0][0], 0, MPI_COMM_WORLD);
-    } // END of Send
-
-    //Once the message is in the buffer we can safely shift the field in memory.
-    field->shift_x(clrw);
-    // and then receive the complementary field from the East.
-
-    if( MPI_neighbor_[0][1]!=MPI_PROC_NULL ) {
-        int ix = n_elem[0] - clrw  ;
-        int iy =  0 ;
-        MPI_Irecv( &(f2D->data_2D[ix][iy]), clrw*n_elem[1], MPI_DOUBLE, MPI_neighbor_[0][1], 0, MPI_COMM_WORLD, &rrequest);
-        MPI_Wait( &rrequest, &rstat);
-    }
-    MPI_Buffer_detach( &b, &bufsize);
-    free(b);
-
-} // END exchangeField_movewin
@@ -164,13 +164,14 @@ void PatchAM::initSumFieldComplex( Field *field, int iDim, SmileiMPI *smpi )
         if( is_a_MPI_neighbor( iDim, iNeighbor ) ) {
             int tag = field->MPIbuff.send_tags_[iDim][iNeighbor];
             MPI_Isend( static_cast<cField*>(field->sendFields_[iDim*2+iNeighbor])->cdata_, 2*field->sendFields_[iDim*2+iNeighbor]->number_of_points_, MPI_DOUBLE, MPI_neighbor_[iDim][iNeighbor], tag,
-                       MPI_COMM_WORLD, &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+                       smpi->world(), &( field->MPIbuff.srequest[iDim][iNeighbor] ) );
+            smpi->countSentBytes( SmileiMPI::sent_fields, 2*field->sendFields_[iDim*2+iNeighbor]->number_of_points_ * sizeof( double ) );
         } // END of Send
         
         if( is_a_MPI_neighbor( iDim, ( iNeighbor+1 )%2 ) ) {
             int tag = field->MPIbuff.recv_tags_[iDim][iNeighbor];
             MPI_Irecv( static_cast<cField*>(field->recvFields_[iDim*2+(iNeighbor+1)%2])->cdata_, 2*field->recvFields_[iDim*2+(iNeighbor+1)%2]->number_of_points_, MPI_DOUBLE, MPI_neighbor_[iDim][( iNeighbor+1 )%2], tag,
-                       MPI_COMM_WORLD, &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
+                       smpi->world(), &( field->MPIbuff.rrequest[iDim][( iNeighbor+1 )%2] ) );
 
         } // END of Recv
         
@@ -211,41 +212,6 @@ void PatchAM::cleanType()
 {
 }
 
-void PatchAM::exchangeField_movewin( Field* field, int nshift )
-{
-    std::vector<unsigned int> n_elem   = field->dims_;
-    std::vector<unsigned int> isDual = field->isDual_;
-    cField2D* f2D =  static_cast<cField2D*>(field);
-
-    int bufsize = 2*nshift*n_elem[1]*sizeof(double)+ 2 * MPI_BSEND_OVERHEAD; //Max number of doubles in the buffer. Careful, there might be MPI overhead to take into account.
-    void* b=(void *)malloc(bufsize);
-    MPI_Buffer_attach( b, bufsize);
-
-    MPI_Status rstat    ;
-    MPI_Request rrequest;
-
-    if( MPI_neighbor_[0][0]!=MPI_PROC_NULL ) {
-        int ix = 2*oversize[0] + 1 + isDual[0];
-        int iy =   0;
-        MPI_Bsend(  &( ( *f2D )( ix, iy ) ), 2*nshift*n_elem[1], MPI_DOUBLE, MPI_neighbor_[0][0], 0, MPI_COMM_WORLD);
-    } // END of Send
-
-    //Once the message is in the buffer we can safely shift the field in memory.
-    field->shift_x(nshift);
-    // and then receive the complementary field from the East.
-
-    if( MPI_neighbor_[0][1]!=MPI_PROC_NULL ) {
-        int ix = n_elem[0] - nshift;
-        int iy =   0 ;
-        MPI_Irecv(  &( ( *f2D )( ix, iy ) ), 2*nshift*n_elem[1], MPI_DOUBLE, MPI_neighbor_[0][1], 0, MPI_COMM_WORLD, &rrequest);
-        MPI_Wait( &rrequest, &rstat);
-    }
-    MPI_Buffer_detach( &b, &bufsize);
-    free(b);
-
-} // END exchangeField_movewin
-
-
 void PatchAM::computePoynting() {
     if( isBoundary( 0, 0 ) ) {
         EMfields->computePoynting( 0, 0 );
@@ -65,7 +65,6 @@ public:
     //! init comm / sum densities
     void initSumFieldComplex( Field *field, int iDim, SmileiMPI *smpi ) override final;
     
-    void exchangeField_movewin( Field* field, int clrw ) override final;
     
     // Create MPI_Datatype to exchange fields
     void createType2( Params &params ) override final;
@@ -120,6 +120,10 @@ public:
         vecPatches.setRefHindex();
         
         vecPatches.updateFieldList( smpi );
+        smpi->updateHaloComms( vecPatches );
+        if( params.fields_arena ) {
+            vecPatches.buildFieldsArena();
+        }
         
         TITLE( "Creating Diagnostics, antennas, and external fields" )
         vecPatches.createDiags( params, smpi, openPMD, radiation_tables_ );
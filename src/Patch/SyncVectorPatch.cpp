@@ -2,12 +2,15 @@
 #include "SyncVectorPatch.h"
 
 #include <vector>
+#include <map>
+#include <algorithm>
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
     #include <openacc.h>
 #endif
 #include "Params.h"
 #include "SmileiMPI.h"
 #include "VectorPatch.h"
+#include "SharedMemoryHalos.h"
 #include "gpu.h"
 
 using namespace std;
@@ -111,7 +114,9 @@ void SyncVectorPatch::finalizeExchParticlesAlongDimension( VectorPatch &vecPatch
     #pragma omp single
 #endif
     for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+        smpi->traceEvent( 0, 12 );
         vecPatches( ipatch )->endNbrOfParticles( ispec, iDim );
+        smpi->traceEvent( 1, 12 );
     }
 
     #pragma omp for schedule(runtime)
@@ -134,7 +139,9 @@ void SyncVectorPatch::finalizeExchParticlesAlongDimension( VectorPatch &vecPatch
     #pragma omp single
 #endif
     for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
-        vecPatches( ipatch )->waitExchParticles( ispec, iDim );
+        smpi->traceEvent( 0, 12 );
+        vecPatches( ipatch )->waitExchParticles( ispec, iDim, params );
+        smpi->traceEvent( 1, 12 );
     }
 
     #pragma omp for schedule(runtime)
@@ -231,6 +238,447 @@ void SyncVectorPatch::sumRhoJs( Params &, VectorPatch &vecPatches, int imode, Sm
 //         - densitiesLocalx : fields which have local neighbor along X (a same field can be adressed by both)
 //         - ... for Y and Z
 //     - These fields are identified with lists of index MPIxIdx and LocalxIdx (... for Y and Z)
+// ---------------------------------------------------------------------------------------------------------------------
+// Halo messages aggregated per MPI process: the send buffers (sendFields_) of the components of all the patches which
+// have the same remote MPI process as neighbor on the same side are packed in a single message. Both processes order
+// the boundaries by the hindex of the sending patch. The messages are held by the buffers of the first field of the
+// list, and use a dedicated communicator with one tag per field name, direction and side. With Main.shared_memory_halos,
+// the messages to the processes of the same node are written and read in place in a shared memory window instead.
+// ---------------------------------------------------------------------------------------------------------------------
+static int rankMessageTag( const std::string &name, int iDim, int side )
+{
+    static const char *names[] = { "Jx", "Jy", "Jz", "Rho", "Bx", "By", "Bz", "Ex", "Ey", "Ez", "By_mBTIS3", "Bz_mBTIS3", "Ap",
+        "Env_Ex_abs", "Env_Chi", "GradPhix", "GradPhiy", "GradPhiz", "GradPhix_m", "GradPhiy_m", "GradPhiz_m",
+        "Env_Ex_abs_mode_0", "Env_Chi_mode_0", "GradPhil_mode_0", "GradPhir_mode_0", "GradPhil_m_mode_0", "GradPhir_m_mode_0" };
+    const int nnames = sizeof( names ) / sizeof( names[0] );
+    int tagp = -1;
+    for( int i=0 ; i<nnames ; i++ ) {
+        if( name == names[i] ) {
+            tagp = i;
+        }
+    }
+    if( tagp < 0 ) {
+        ERROR( "No halo message tag for the field " << name );
+    }
+    return ( tagp*3 + iDim )*2 + side;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// With Main.neighborhood_collectives, the messages of all the sides to all the neighbor processes are instead exchanged
+// by a single MPI_Ineighbor_alltoallv in the graph communicator of SmileiMPI. All its processes take part in each
+// collective, in the same order, even with an empty list of fields (the collective is then held by vecPatches).
+// ---------------------------------------------------------------------------------------------------------------------
+static void postNeighborExchange( NeighborExchange &exchange, std::vector<RankMessage> &sends, std::vector<RankMessage> &recvs, SmileiMPI *smpi )
+{
+    const std::vector<int> &ranks = smpi->neighborRanks();
+    const unsigned int nneighbor = ranks.size();
+    for( int send=1 ; send>=0 ; send-- ) {
+        std::vector<RankMessage> &messages = send ? sends : recvs;
+        std::vector<int> &counts = send ? exchange.send_counts : exchange.recv_counts;
+        std::vector<int> &displs = send ? exchange.send_displs : exchange.recv_displs;
+        std::vector<double> &buffer = send ? exchange.send : exchange.recv;
+        counts.assign( nneighbor, 0 );
+        displs.assign( nneighbor, 0 );
+        // The messages are sorted by side then rank: side 0 comes first in the block of each neighbor
+        std::vector<unsigned int> ineighbor( messages.size() );
+        for( unsigned int imessage=0 ; imessage<messages.size() ; imessage++ ) {
+            RankMessage &message = messages[imessage];
+            ineighbor[imessage] = std::lower_bound( ranks.begin(), ranks.end(), message.rank ) - ranks.begin();
+            message.offset = counts[ineighbor[imessage]];
+            for( unsigned int i=0 ; i<message.fields.size() ; i++ ) {
+                counts[ineighbor[imessage]] += message.fields[i]->size();
+            }
+        }
+        unsigned int size = 0;
+        for( unsigned int n=0 ; n<nneighbor ; n++ ) {
+            displs[n] = size;
+            size += counts[n];
+        }
+        if( buffer.size() < std::max( size, 1u ) ) {
+            buffer.resize( std::max( size, 1u ) );
+        }
+        for( unsigned int imessage=0 ; imessage<messages.size() ; imessage++ ) {
+            RankMessage &message = messages[imessage];
+            message.offset += displs[ineighbor[imessage]];
+            if( send ) {
+                unsigned int offset = message.offset;
+                for( unsigned int i=0 ; i<message.fields.size() ; i++ ) {
+                    memcpy( &buffer[offset], message.fields[i]->data_, message.fields[i]->size()*sizeof( double ) );
+                    offset += message.fields[i]->size();
+                }
+            }
+        }
+    }
+#if MPI_VERSION >= 3
+    MPI_Ineighbor_alltoallv( &exchange.send[0], exchange.send_counts.data(), exchange.send_displs.data(), MPI_DOUBLE,
+                             &exchange.recv[0], exchange.recv_counts.data(), exchange.recv_displs.data(), MPI_DOUBLE,
+                             smpi->neighborComm(), &exchange.request );
+    for( unsigned int n=0 ; n<exchange.send_counts.size() ; n++ ) {
+        smpi->countSentBytes( SmileiMPI::sent_fields, exchange.send_counts[n] * sizeof( double ) );
+    }
+#endif
+    exchange.pending = true;
+}
+
+static void waitNeighborExchange( NeighborExchange &exchange, std::vector<RankMessage> &recvs )
+{
+    MPI_Status status;
+    MPI_Wait( &exchange.request, &status );
+    exchange.pending = false;
+    for( unsigned int imessage=0 ; imessage<recvs.size() ; imessage++ ) {
+        RankMessage &message = recvs[imessage];
+        unsigned int offset = message.offset;
+        for( unsigned int i=0 ; i<message.fields.size() ; i++ ) {
+            memcpy( message.fields[i]->data_, &exchange.recv[offset], message.fields[i]->size()*sizeof( double ) );
+            offset += message.fields[i]->size();
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// With Main.sparse_current_sums, each boundary of the MPI messages of the current sums is reduced to its slabs along
+// the direction of the exchange from the first to the last one touched by the projection (nonzero), after a header of
+// 2 doubles with this range. The boundary of a patch without particles next to this side is only its header.
+// ---------------------------------------------------------------------------------------------------------------------
+static void slabsOf( Field *field, int iDim, unsigned int &outer, unsigned int &n, unsigned int &inner )
+{
+    outer = 1;
+    inner = 1;
+    for( unsigned int d=0 ; d<field->dims_.size() ; d++ ) {
+        if( ( int )d < iDim ) {
+            outer *= field->dims_[d];
+        } else if( ( int )d > iDim ) {
+            inner *= field->dims_[d];
+        }
+    }
+    n = field->dims_[iDim];
+}
+
+static unsigned int packSparse( Field *field, int iDim, double *buffer )
+{
+    unsigned int outer, n, inner;
+    slabsOf( field, iDim, outer, n, inner );
+    const double *data = field->data_;
+    auto touched = [&]( unsigned int m ) {
+        for( unsigned int o=0 ; o<outer ; o++ ) {
+            for( unsigned int r=0 ; r<inner ; r++ ) {
+                if( data[( o*n+m )*inner+r] != 0. ) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    unsigned int first = 0, last = n;
+    while( first < n && !touched( first ) ) {
+        first++;
+    }
+    while( last > first && !touched( last-1 ) ) {
+        last--;
+    }
+    buffer[0] = first;
+    buffer[1] = last;
+    unsigned int size = 2;
+    for( unsigned int o=0 ; o<outer ; o++ ) {
+        memcpy( &buffer[size], &data[( o*n+first )*inner], ( last-first )*inner*sizeof( double ) );
+        size += ( last-first )*inner;
+    }
+    return size;
+}
+
+static unsigned int unpackSparse( Field *field, int iDim, const double *buffer )
+{
+    unsigned int outer, n, inner;
+    slabsOf( field, iDim, outer, n, inner );
+    const unsigned int first = buffer[0], last = buffer[1];
+    field->put_to( 0. );
+    unsigned int size = 2;
+    for( unsigned int o=0 ; o<outer ; o++ ) {
+        memcpy( &field->data_[( o*n+first )*inner], &buffer[size], ( last-first )*inner*sizeof( double ) );
+        size += ( last-first )*inner;
+    }
+    return size;
+}
+
+// Pack a message in its buffer and send it by MPI
+static void sendRankMessage( RankMessage &message, int tag, SmileiMPI *smpi )
+{
+    unsigned int offset = 0;
+    for( unsigned int i=0 ; i<message.fields.size() ; i++ ) {
+        if( message.sparse >= 0 ) {
+            offset += packSparse( message.fields[i], message.sparse, &message.buffer[offset] );
+        } else {
+            memcpy( &message.buffer[offset], message.fields[i]->data_, message.fields[i]->size()*sizeof( double ) );
+            offset += message.fields[i]->size();
+        }
+    }
+    MPI_Isend( message.buffer.data(), offset, MPI_DOUBLE, message.rank, tag, smpi->haloComm(), &message.request );
+    smpi->countSentBytes( SmileiMPI::sent_fields, offset * sizeof( double ) );
+}
+
+// Unpack a received message in the receive buffers of its boundaries
+static void unpackRankMessage( RankMessage &message, const double *buffer )
+{
+    unsigned int offset = 0;
+    for( unsigned int i=0 ; i<message.fields.size() ; i++ ) {
+        if( message.sparse >= 0 ) {
+            offset += unpackSparse( message.fields[i], message.sparse, &buffer[offset] );
+        } else {
+            memcpy( message.fields[i]->data_, &buffer[offset], message.fields[i]->size()*sizeof( double ) );
+            offset += message.fields[i]->size();
+        }
+    }
+}
+
+void SyncVectorPatch::initExchangePerRank( std::vector<Field *> &fields, const std::vector<int> *patchIdx, unsigned int ncomp, int iDim, VectorPatch &vecPatches, SmileiMPI *smpi,
+        bool sparse, std::vector< std::vector<unsigned int> > *deferred )
+{
+    // The deferred messages are always sent point-to-point, when their last patch is extracted
+    const bool collective = !deferred && ( smpi->neighborComm() != MPI_COMM_NULL );
+    if( fields.size() == 0 ) {
+        if( collective ) {
+            #pragma omp single
+            {
+                std::vector<RankMessage> none;
+                postNeighborExchange( vecPatches.neighborExchanges_[std::make_pair( &fields, iDim )], none, none, smpi );
+            }
+        }
+        return;
+    }
+    AsyncMPIbuffers &buff = fields[0]->MPIbuff;
+
+    // The messages, and their positions in the shared memory of the node, are set in the same order on all the processes
+    #pragma omp single
+    prepareExchangePerRank( fields, patchIdx, ncomp, iDim, vecPatches, smpi, sparse, deferred );
+
+    if( collective ) {
+        #pragma omp single
+        postNeighborExchange( buff.neighborExchange[iDim], buff.rankSend[iDim], buff.rankRecv[iDim], smpi );
+        return;
+    }
+
+    // The MPI messages are packed and sent, and their receptions posted, by all the threads
+    std::vector<RankMessage> &sends = buff.rankSend[iDim];
+    std::vector<RankMessage> &recvs = buff.rankRecv[iDim];
+    const unsigned int nsend = deferred ? 0 : sends.size();
+    const unsigned int nmessage = nsend + recvs.size();
+    const int tag = rankMessageTag( fields[0]->name, iDim, 0 );
+#ifndef _NO_MPI_TM
+    #pragma omp for schedule(dynamic)
+#else
+    #pragma omp single
+#endif
+    for( unsigned int imessage=0 ; imessage<nmessage ; imessage++ ) {
+        RankMessage &message = imessage < nsend ? sends[imessage] : recvs[imessage-nsend];
+        if( message.shared ) {
+            continue;
+        }
+        if( imessage < nsend ) {
+            sendRankMessage( message, tag + message.side, smpi );
+        } else {
+            MPI_Irecv( &message.buffer[0], message.size, MPI_DOUBLE, message.rank, tag + message.side, smpi->haloComm(), &message.request );
+        }
+    }
+}
+
+// Boundaries of the messages, and their reservation in the shared memory of the node (one thread)
+void SyncVectorPatch::prepareExchangePerRank( std::vector<Field *> &fields, const std::vector<int> *patchIdx, unsigned int ncomp, int iDim, VectorPatch &vecPatches, SmileiMPI *smpi,
+        bool sparse, std::vector< std::vector<unsigned int> > *deferred )
+{
+    const bool collective = !deferred && ( smpi->neighborComm() != MPI_COMM_NULL );
+    const unsigned int npatch = fields.size() / ncomp;
+    AsyncMPIbuffers &buff = fields[0]->MPIbuff;
+
+    // Boundaries per (side, remote process), with the hindex of the sending patch
+    typedef std::map< std::pair<int, int>, std::vector< std::pair<int, unsigned int> > > Groups;
+    Groups send_groups, recv_groups;
+    for( unsigned int ifield=0 ; ifield<npatch ; ifield++ ) {
+        Patch *patch = vecPatches( patchIdx ? ( *patchIdx )[ifield] : ifield );
+        for( int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+            if( patch->is_a_MPI_neighbor( iDim, iNeighbor ) ) {
+                send_groups[std::make_pair( iNeighbor, patch->MPI_neighbor_[iDim][iNeighbor] )].push_back( std::make_pair( patch->hindex, ifield ) );
+            }
+            const int from = ( iNeighbor+1 )%2;
+            if( patch->is_a_MPI_neighbor( iDim, from ) ) {
+                recv_groups[std::make_pair( iNeighbor, patch->MPI_neighbor_[iDim][from] )].push_back( std::make_pair( patch->neighbor_[iDim][from], ifield ) );
+            }
+        }
+    }
+
+    for( int send=1 ; send>=0 ; send-- ) {
+        Groups &groups = send ? send_groups : recv_groups;
+        std::vector<RankMessage> &messages = send ? buff.rankSend[iDim] : buff.rankRecv[iDim];
+        messages.resize( groups.size() );
+        unsigned int imessage = 0;
+        for( Groups::iterator it = groups.begin() ; it != groups.end() ; it++, imessage++ ) {
+            RankMessage &message = messages[imessage];
+            message.side = it->first.first;
+            message.rank = it->first.second;
+            const int ibuffer = iDim*2 + ( send ? message.side : ( message.side+1 )%2 );
+            std::sort( it->second.begin(), it->second.end() );
+            message.fields.clear();
+            message.sparse = -1;
+            message.shared = NULL;
+            message.request = MPI_REQUEST_NULL;
+            unsigned int size = 0;
+            for( unsigned int i=0 ; i<it->second.size() ; i++ ) {
+                if( send && deferred ) {
+                    ( *deferred )[patchIdx ? ( *patchIdx )[it->second[i].second] : it->second[i].second].push_back( imessage );
+                }
+                for( unsigned int icomp=0 ; icomp<ncomp ; icomp++ ) {
+                    Field *field = fields[icomp*npatch + it->second[i].second];
+                    Field *boundary = send ? field->sendFields_[ibuffer] : field->recvFields_[ibuffer];
+                    message.fields.push_back( boundary );
+                    size += boundary->size();
+                }
+            }
+            if( collective ) {
+                continue;
+            }
+            // Packed and unpacked in place in the shared memory of the node
+            message.halos  = deferred ? NULL : smpi->sharedHalos();
+            message.shared = message.halos ? message.halos->reserve( message.rank, send, size, message.seq ) : NULL;
+            if( message.shared ) {
+                if( send ) {
+                    unsigned int offset = 0;
+                    for( unsigned int i=0 ; i<message.fields.size() ; i++ ) {
+                        memcpy( &message.shared[offset], message.fields[i]->data_, message.fields[i]->size()*sizeof( double ) );
+                        offset += message.fields[i]->size();
+                    }
+                    message.halos->publish( message.rank );
+                }
+                continue;
+            }
+            if( sparse ) {
+                message.sparse = iDim;
+                size += 2*message.fields.size();
+            }
+            if( message.buffer.size() < size ) {
+                message.buffer.resize( size );
+            }
+            message.size = size;
+            if( send && deferred ) {
+                message.pending = it->second.size();
+            }
+        }
+    }
+}
+
+void SyncVectorPatch::finalizeExchangePerRank( std::vector<Field *> &fields, int iDim, VectorPatch &vecPatches )
+{
+    if( fields.size() == 0 ) {
+        std::map< std::pair<const std::vector<Field *> *, int>, NeighborExchange >::iterator it
+            = vecPatches.neighborExchanges_.find( std::make_pair( &fields, iDim ) );
+        if( it != vecPatches.neighborExchanges_.end() && it->second.pending ) {
+            std::vector<RankMessage> none;
+            waitNeighborExchange( it->second, none );
+        }
+        return;
+    }
+    AsyncMPIbuffers &buff = fields[0]->MPIbuff;
+    std::vector<RankMessage> &sends = buff.rankSend[iDim];
+    std::vector<RankMessage> &recvs = buff.rankRecv[iDim];
+
+    // The collective and the messages in the shared memory of the node are finalized in order by one thread
+    #pragma omp single
+    {
+        if( buff.neighborExchange[iDim].pending ) {
+            waitNeighborExchange( buff.neighborExchange[iDim], recvs );
+        } else {
+            for( unsigned int imessage=0 ; imessage<sends.size() ; imessage++ ) {
+                if( sends[imessage].shared ) {
+                    sends[imessage].halos->release( sends[imessage].rank, true, sends[imessage].seq );
+                }
+            }
+            for( unsigned int imessage=0 ; imessage<recvs.size() ; imessage++ ) {
+                RankMessage &message = recvs[imessage];
+                if( message.shared ) {
+                    message.halos->wait( message.rank, message.seq );
+                    unpackRankMessage( message, message.shared );
+                    message.halos->release( message.rank, false, message.seq );
+                }
+            }
+        }
+    }
+
+    // The MPI messages are waited for, and unpacked, by all the threads
+    const unsigned int nsend = sends.size();
+    const unsigned int nmessage = nsend + recvs.size();
+#ifndef _NO_MPI_TM
+    #pragma omp for schedule(dynamic)
+#else
+    #pragma omp single
+#endif
+    for( unsigned int imessage=0 ; imessage<nmessage ; imessage++ ) {
+        RankMessage &message = imessage < nsend ? sends[imessage] : recvs[imessage-nsend];
+        if( message.shared || message.request == MPI_REQUEST_NULL ) {
+            continue;
+        }
+        MPI_Status status;
+        MPI_Wait( &message.request, &status );
+        if( imessage >= nsend ) {
+            unpackRankMessage( message, message.buffer.data() );
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Split-phase sum of the currents along X (Main.overlap_current_sums): the messages of the patches with MPI neighbors
+// along X are sent during the dynamics, as soon as all their patches are projected. Only X can be posted early: the
+// sums along Y and Z start from the sums along X. sumAllComponents then only finalizes these messages.
+// ---------------------------------------------------------------------------------------------------------------------
+void SyncVectorPatch::initSumRhoJEarly( VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    unsigned int oversize = vecPatches( 0 )->EMfields->oversize[0];
+    unsigned int nPatchMPIx = vecPatches.MPIxIdx.size();
+    #pragma omp for schedule(static)
+    for( unsigned int ifield=0 ; ifield<nPatchMPIx ; ifield++ ) {
+        unsigned int ipatch = vecPatches.MPIxIdx[ifield];
+        for( int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+            if( vecPatches( ipatch )->is_a_MPI_neighbor( 0, iNeighbor ) ) {
+                vecPatches.densitiesMPIx[ifield             ]->create_sub_fields( 0, iNeighbor, 2*oversize+1+1 ); // +1, Jx dual in X
+                vecPatches.densitiesMPIx[ifield+nPatchMPIx  ]->create_sub_fields( 0, iNeighbor, 2*oversize+1+0 ); // +0, Jy prim in X
+                vecPatches.densitiesMPIx[ifield+2*nPatchMPIx]->create_sub_fields( 0, iNeighbor, 2*oversize+1+0 ); // +0, Jz prim in X
+            }
+        }
+    }
+    #pragma omp single
+    vecPatches.currentSumMessages_.assign( vecPatches.size(), std::vector<unsigned int>() );
+    SyncVectorPatch::initExchangePerRank( vecPatches.densitiesMPIx, &vecPatches.MPIxIdx, 3, 0, vecPatches, smpi, smpi->sparseCurrentSums(), &vecPatches.currentSumMessages_ ); // Jx, Jy, Jz
+}
+
+void SyncVectorPatch::postSumRhoJEarly( unsigned int ipatch, VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    const std::vector<unsigned int> &imessages = vecPatches.currentSumMessages_[ipatch];
+    if( imessages.empty() ) {
+        return;
+    }
+    unsigned int oversize = vecPatches( 0 )->EMfields->oversize[0];
+    unsigned int nPatchMPIx = vecPatches.MPIxIdx.size();
+    unsigned int ifield = std::lower_bound( vecPatches.MPIxIdx.begin(), vecPatches.MPIxIdx.end(), ( int )ipatch ) - vecPatches.MPIxIdx.begin();
+    for( int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+        if( vecPatches( ipatch )->is_a_MPI_neighbor( 0, iNeighbor ) ) {
+            vecPatches.densitiesMPIx[ifield             ]->extract_fields_sum( 0, iNeighbor, oversize );
+            vecPatches.densitiesMPIx[ifield+nPatchMPIx  ]->extract_fields_sum( 0, iNeighbor, oversize );
+            vecPatches.densitiesMPIx[ifield+2*nPatchMPIx]->extract_fields_sum( 0, iNeighbor, oversize );
+        }
+    }
+
+    // The thread extracting the last patch of a message sends it
+    std::vector<RankMessage> &messages = vecPatches.densitiesMPIx[0]->MPIbuff.rankSend[0];
+    for( unsigned int i=0 ; i<imessages.size() ; i++ ) {
+        RankMessage &message = messages[imessages[i]];
+        int pending;
+        #pragma omp flush
+        #pragma omp atomic capture
+        pending = --message.pending;
+        if( pending == 0 ) {
+            #pragma omp flush
+            sendRankMessage( message, rankMessageTag( vecPatches.densitiesMPIx[0]->name, 0, message.side ), smpi );
+        }
+    }
+}
+
 void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatch &vecPatches, SmileiMPI *smpi )
 {
     unsigned int h0, oversize[3], size[3];
@@ -252,14 +700,15 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
     // -----------------
     // Sum per direction :
 
-    // iDim = 0, initialize comms : Isend/Irecv
+    // iDim = 0, initialize comms : Isend/Irecv (already sent during the dynamics with initSumRhoJEarly)
     unsigned int nPatchMPIx = vecPatches.MPIxIdx.size();
+    unsigned int nPatchMPIxInit = vecPatches.currentSumsEarly_ ? 0 : nPatchMPIx;
 #ifndef _NO_MPI_TM
     #pragma omp for schedule(static)
 #else
     #pragma omp single
 #endif
-    for( unsigned int ifield=0 ; ifield<nPatchMPIx ; ifield++ ) {
+    for( unsigned int ifield=0 ; ifield<nPatchMPIxInit ; ifield++ ) {
         unsigned int ipatch = vecPatches.MPIxIdx[ifield];
         for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
             if ( vecPatches( ipatch )->is_a_MPI_neighbor( 0, iNeighbor ) ) {
@@ -283,10 +732,17 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
 // #endif
             }
         }
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIx[ifield             ], 0, smpi, true ); // Jx
         vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIx[ifield+  nPatchMPIx], 0, smpi, true ); // Jy
         vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIx[ifield+2*nPatchMPIx], 0, smpi, true ); // Jz
+#endif
     }
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    if( !vecPatches.currentSumsEarly_ ) {
+        SyncVectorPatch::initExchangePerRank( vecPatches.densitiesMPIx, &vecPatches.MPIxIdx, 3, 0, vecPatches, smpi, smpi->sparseCurrentSums() ); // Jx, Jy, Jz
+    }
+#endif
 
     // iDim = 0, local
     const int nFieldLocalx = vecPatches.densitiesLocalx.size() / 3;
@@ -346,6 +802,13 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
     }
 
     // iDim = 0, finalize (waitall)
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    #pragma omp single nowait
+    smpi->traceEvent( 0, 12 );
+    SyncVectorPatch::finalizeExchangePerRank( vecPatches.densitiesMPIx, 0, vecPatches ); // Jx, Jy, Jz
+    #pragma omp single nowait
+    smpi->traceEvent( 1, 12 );
+#endif
 #ifndef _NO_MPI_TM
     #pragma omp for schedule(static)
 #else
@@ -353,9 +816,11 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
 #endif
     for( unsigned int ifield=0 ; ifield<nPatchMPIx ; ifield++ ) {
         unsigned int ipatch = vecPatches.MPIxIdx[ifield];
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIx[ifield             ], 0 ); // Jx
         vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIx[ifield+nPatchMPIx  ], 0 ); // Jy
         vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIx[ifield+2*nPatchMPIx], 0 ); // Jz
+#endif
         for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
             if ( vecPatches( ipatch )->is_a_MPI_neighbor( 0, ( iNeighbor+1 )%2 ) ) {
 // #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -416,10 +881,15 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
 // #endif
                 }
             }
+#if defined( SMILEI_ACCELERATOR_GPU )
             vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIy[ifield             ], 1, smpi, true ); // Jx
             vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIy[ifield+nPatchMPIy  ], 1, smpi, true ); // Jy
             vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIy[ifield+2*nPatchMPIy], 1, smpi, true ); // Jz
+#endif
         }
+#if !defined( SMILEI_ACCELERATOR_GPU )
+        SyncVectorPatch::initExchangePerRank( vecPatches.densitiesMPIy, &vecPatches.MPIyIdx, 3, 1, vecPatches, smpi, smpi->sparseCurrentSums() ); // Jx, Jy, Jz
+#endif
 
         // iDim = 1,
         const int nFieldLocaly = vecPatches.densitiesLocaly.size() / 3;
@@ -484,6 +954,13 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
         }
 
         // iDim = 1, finalize (waitall)
+#if !defined( SMILEI_ACCELERATOR_GPU )
+        #pragma omp single nowait
+        smpi->traceEvent( 0, 12 );
+        SyncVectorPatch::finalizeExchangePerRank( vecPatches.densitiesMPIy, 1, vecPatches ); // Jx, Jy, Jz
+        #pragma omp single nowait
+        smpi->traceEvent( 1, 12 );
+#endif
 #ifndef _NO_MPI_TM
         #pragma omp for schedule(static)
 #else
@@ -491,9 +968,11 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
 #endif
         for( unsigned int ifield=0 ; ifield<nPatchMPIy ; ifield=ifield+1 ) {
             unsigned int ipatch = vecPatches.MPIyIdx[ifield];
+#if defined( SMILEI_ACCELERATOR_GPU )
             vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIy[ifield             ], 1 ); // Jx
             vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIy[ifield+nPatchMPIy  ], 1 ); // Jy
             vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIy[ifield+2*nPatchMPIy], 1 ); // Jz
+#endif
             for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
                 if ( vecPatches( ipatch )->is_a_MPI_neighbor( 1, ( iNeighbor+1 )%2 ) ) {
 // #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -552,10 +1031,15 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
 // #endif
                     }
                 }
+#if defined( SMILEI_ACCELERATOR_GPU )
                 vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIz[ifield             ], 2, smpi, true ); // Jx
                 vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIz[ifield+nPatchMPIz  ], 2, smpi, true ); // Jy
                 vecPatches( ipatch )->initSumField( vecPatches.densitiesMPIz[ifield+2*nPatchMPIz], 2, smpi, true ); // Jz
+#endif
             }
+#if !defined( SMILEI_ACCELERATOR_GPU )
+            SyncVectorPatch::initExchangePerRank( vecPatches.densitiesMPIz, &vecPatches.MPIzIdx, 3, 2, vecPatches, smpi, smpi->sparseCurrentSums() ); // Jx, Jy, Jz
+#endif
 
             // iDim = 2 local
             const int nFieldLocalz = vecPatches.densitiesLocalz.size() / 3;
@@ -618,6 +1102,13 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
             }
 
             // iDim = 2, complete non local sync through MPIfinalize (waitall)
+#if !defined( SMILEI_ACCELERATOR_GPU )
+            #pragma omp single nowait
+            smpi->traceEvent( 0, 12 );
+            SyncVectorPatch::finalizeExchangePerRank( vecPatches.densitiesMPIz, 2, vecPatches ); // Jx, Jy, Jz
+            #pragma omp single nowait
+            smpi->traceEvent( 1, 12 );
+#endif
 #ifndef _NO_MPI_TM
             #pragma omp for schedule(static)
 #else
@@ -625,9 +1116,11 @@ void SyncVectorPatch::sumAllComponents( std::vector<Field *> &fields, VectorPatc
 #endif
             for( unsigned int ifield=0 ; ifield<nPatchMPIz ; ifield=ifield+1 ) {
                 unsigned int ipatch = vecPatches.MPIzIdx[ifield];
+#if defined( SMILEI_ACCELERATOR_GPU )
                 vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIz[ifield             ], 2 ); // Jx
                 vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIz[ifield+nPatchMPIz  ], 2 ); // Jy
                 vecPatches( ipatch )->finalizeSumField( vecPatches.densitiesMPIz[ifield+2*nPatchMPIz], 2 ); // Jz
+#endif
                 for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
                     if ( vecPatches( ipatch )->is_a_MPI_neighbor( 2, ( iNeighbor+1 )%2 ) ) {
 // #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -729,6 +1222,33 @@ void SyncVectorPatch::exchangeB( Params &params, VectorPatch &vecPatches, Smilei
     }
 }
 
+void SyncVectorPatch::initExchangeB( Params &, VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    unsigned int nDim = vecPatches.listBx_[0]->dims_.size();
+    // Exchange Bs0 : By_ and Bz_ (dual in X)
+    SyncVectorPatch::initExchangeAllComponentsAlongX( vecPatches, smpi );
+    if( nDim > 1 ) {
+        // Exchange Bs1 : Bx_ and Bz_ (dual in Y)
+        SyncVectorPatch::initExchangeAllComponentsAlongY( vecPatches, smpi );
+    }
+    if( nDim > 2 ) {
+        // Exchange Bs2 : Bx_ and By_ (dual in Z)
+        SyncVectorPatch::initExchangeAllComponentsAlongZ( vecPatches, smpi );
+    }
+}
+
+void SyncVectorPatch::exchangeLocalB( Params &, VectorPatch &vecPatches )
+{
+    unsigned int nDim = vecPatches.listBx_[0]->dims_.size();
+    SyncVectorPatch::exchangeLocalAllComponentsAlongX( vecPatches.Bs0, vecPatches );
+    if( nDim > 1 ) {
+        SyncVectorPatch::exchangeLocalAllComponentsAlongY( vecPatches.Bs1, vecPatches );
+    }
+    if( nDim > 2 ) {
+        SyncVectorPatch::exchangeLocalAllComponentsAlongZ( vecPatches.Bs2, vecPatches );
+    }
+}
+
 void SyncVectorPatch::finalizeexchangeB( Params &params, VectorPatch &vecPatches )
 {
     // full_B_exchange is true if (Buneman BC, Lehe, Bouchard or spectral solvers)
@@ -777,32 +1297,37 @@ void SyncVectorPatch::finalizeexchangeJ( Params &, VectorPatch &vecPatches )
 }
 
 
+// The components of a mode have distinct tags (see Patch::initExchangeComplex): all their messages are sent
+// before any is waited for, in a single round. The modes share their tags and are exchanged one after the other.
+void SyncVectorPatch::exchangeAMComponents( std::vector<std::vector<Field *> *> lists, VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    for( unsigned int i=0 ; i<lists.size() ; i++ ) {
+        SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( *lists[i], vecPatches, smpi );
+    }
+    for( unsigned int i=0 ; i<lists.size() ; i++ ) {
+        SyncVectorPatch::finalizeExchangeAlongAllDirections( *lists[i], vecPatches );
+    }
+}
+
 void SyncVectorPatch::exchangeB( Params &, VectorPatch &vecPatches, int imode, SmileiMPI *smpi )
 {
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listBl_[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBl_[imode], vecPatches );
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listBr_[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBr_[imode], vecPatches );
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listBt_[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBt_[imode], vecPatches );
+    SyncVectorPatch::exchangeAMComponents( { &vecPatches.listBl_[imode], &vecPatches.listBr_[imode], &vecPatches.listBt_[imode] }, vecPatches, smpi );
 }
 
 void SyncVectorPatch::exchangeE( Params &, VectorPatch &vecPatches, int imode, SmileiMPI *smpi )
 {
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listEl_[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listEl_[imode], vecPatches );
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listEr_[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listEr_[imode], vecPatches );
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listEt_[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listEt_[imode], vecPatches );
+    SyncVectorPatch::exchangeAMComponents( { &vecPatches.listEl_[imode], &vecPatches.listEr_[imode], &vecPatches.listEt_[imode] }, vecPatches, smpi );
+}
+
+void SyncVectorPatch::exchangeEB( Params &, VectorPatch &vecPatches, int imode, SmileiMPI *smpi )
+{
+    SyncVectorPatch::exchangeAMComponents( { &vecPatches.listEl_[imode], &vecPatches.listEr_[imode], &vecPatches.listEt_[imode],
+                                             &vecPatches.listBl_[imode], &vecPatches.listBr_[imode], &vecPatches.listBt_[imode] }, vecPatches, smpi );
 }
 
 void SyncVectorPatch::exchangeBmBTIS3( Params &/*params*/, VectorPatch &vecPatches, int imode, SmileiMPI *smpi )
 {
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listBr_mBTIS3[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBr_mBTIS3[imode], vecPatches );
-    SyncVectorPatch::exchangeAlongAllDirections<complex<double>,cField>( vecPatches.listBt_mBTIS3[imode], vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBt_mBTIS3[imode], vecPatches );
+    SyncVectorPatch::exchangeAMComponents( { &vecPatches.listBr_mBTIS3[imode], &vecPatches.listBt_mBTIS3[imode] }, vecPatches, smpi );
 }
 
 // void SyncVectorPatch::finalizeexchangeB( Params &, VectorPatch &, int )
@@ -884,12 +1409,10 @@ void SyncVectorPatch::exchangeEnvEx( Params &params, VectorPatch &vecPatches, Sm
 void SyncVectorPatch::exchangeBmBTIS3( Params &/*params*/, VectorPatch &vecPatches, SmileiMPI *smpi )
 {   // exchange BmBTIS3 in Cartesian geometries
 
-    // exchange ByBTIS3 
+    // exchange ByBTIS3 and BzBTIS3 in a single round (distinct tags)
     SyncVectorPatch::exchangeAlongAllDirections<double,Field>( vecPatches.listBy_mBTIS3, vecPatches, smpi );
-    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBy_mBTIS3, vecPatches );
-
-    // exchange BzBTIS3 
     SyncVectorPatch::exchangeAlongAllDirections<double,Field>( vecPatches.listBz_mBTIS3, vecPatches, smpi );
+    SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBy_mBTIS3, vecPatches );
     SyncVectorPatch::finalizeExchangeAlongAllDirections( vecPatches.listBz_mBTIS3, vecPatches );
 }
 
@@ -1020,6 +1543,9 @@ void SyncVectorPatch::exchangeAlongAllDirections( std::vector<Field *> fields, V
     oversize[1] = vecPatches( 0 )->EMfields->oversize[1];
     oversize[2] = vecPatches( 0 )->EMfields->oversize[2];
 
+    // Real fields: one message per remote MPI process (see initExchangePerRank)
+    const bool per_rank = !dynamic_cast<cField*>( fields[0] );
+
     for( unsigned int iDim=0 ; iDim<fields[0]->dims_.size() ; iDim++ ) {
 #ifndef _NO_MPI_TM
         #pragma omp for schedule(static)
@@ -1033,11 +1559,12 @@ void SyncVectorPatch::exchangeAlongAllDirections( std::vector<Field *> fields, V
                     fields[ipatch]->extract_fields_exch( iDim, iNeighbor, oversize[iDim] );
                 }
             }
-            if ( !dynamic_cast<cField*>( fields[ipatch] ) )
-                vecPatches( ipatch )->initExchange       ( fields[ipatch], iDim, smpi );
-            else
+            if ( !per_rank )
                 vecPatches( ipatch )->initExchangeComplex( fields[ipatch], iDim, smpi );
         }
+        if( per_rank ) {
+            SyncVectorPatch::initExchangePerRank( fields, NULL, 1, iDim, vecPatches, smpi );
+        }
     } // End for iDim
 
     unsigned int nx_, ny_( 1 ), nz_( 1 ), h0, size[3], gsp[3];
@@ -1118,14 +1645,21 @@ void SyncVectorPatch::finalizeExchangeAlongAllDirections( std::vector<Field *> f
     oversize[1] = vecPatches( 0 )->EMfields->oversize[1];
     oversize[2] = vecPatches( 0 )->EMfields->oversize[2];
 
+    const bool per_rank = !dynamic_cast<cField*>( fields[0] );
+
     for( unsigned int iDim=0 ; iDim<fields[0]->dims_.size() ; iDim++ ) {
+        if( per_rank ) {
+            SyncVectorPatch::finalizeExchangePerRank( fields, iDim, vecPatches );
+        }
 #ifndef _NO_MPI_TM
         #pragma omp for schedule(static)
 #else
         #pragma omp single
 #endif
         for( unsigned int ipatch=0 ; ipatch<fields.size() ; ipatch++ ) {
-            vecPatches( ipatch )->finalizeExchange( fields[ipatch], iDim );
+            if( !per_rank ) {
+                vecPatches( ipatch )->finalizeExchange( fields[ipatch], iDim );
+            }
 
             for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
                 if ( vecPatches( ipatch )->is_a_MPI_neighbor( iDim, ( iNeighbor+1 )%2 ) ) {
@@ -1470,6 +2004,13 @@ void SyncVectorPatch::exchangeSynchronizedPerDirection( std::vector<Field *> fie
 //         - B_Localx : fields which have local neighbor along X (a same field can be adressed by both)
 //     - These fields are identified with lists of index MPIxIdx and LocalxIdx
 void SyncVectorPatch::exchangeAllComponentsAlongX( std::vector<Field *> &fields, VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    SyncVectorPatch::initExchangeAllComponentsAlongX( vecPatches, smpi );
+    SyncVectorPatch::exchangeLocalAllComponentsAlongX( fields, vecPatches );
+}
+
+// Pack and send the components which have MPI neighbors along X
+void SyncVectorPatch::initExchangeAllComponentsAlongX( VectorPatch &vecPatches, SmileiMPI *smpi )
 {
     unsigned oversize = vecPatches( 0 )->EMfields->oversize[0];
 
@@ -1498,9 +2039,20 @@ void SyncVectorPatch::exchangeAllComponentsAlongX( std::vector<Field *> &fields,
 #endif
             }
         }
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->initExchange( vecPatches.B_MPIx[ifield      ], 0, smpi, true ); // By
         vecPatches( ipatch )->initExchange( vecPatches.B_MPIx[ifield+nMPIx], 0, smpi, true ); // Bz
+#endif
     }
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    SyncVectorPatch::initExchangePerRank( vecPatches.B_MPIx, &vecPatches.MPIxIdx, 2, 0, vecPatches, smpi );
+#endif
+}
+
+// Copy the components between the patches of the MPI process along X
+void SyncVectorPatch::exchangeLocalAllComponentsAlongX( std::vector<Field *> &fields, VectorPatch &vecPatches )
+{
+    unsigned oversize = vecPatches( 0 )->EMfields->oversize[0];
 
     unsigned int h0, size;
     double *pt1, *pt2;
@@ -1569,6 +2121,9 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongX( VectorPatch &vecPatch
     unsigned oversize = vecPatches( 0 )->EMfields->oversize[0];
 
     unsigned int nMPIx = vecPatches.MPIxIdx.size();
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    SyncVectorPatch::finalizeExchangePerRank( vecPatches.B_MPIx, 0, vecPatches );
+#endif
 #ifndef _NO_MPI_TM
     #pragma omp for schedule(static)
 #else
@@ -1576,8 +2131,10 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongX( VectorPatch &vecPatch
 #endif
     for( unsigned int ifield=0 ; ifield<nMPIx ; ifield++ ) {
         unsigned int ipatch = vecPatches.MPIxIdx[ifield];
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->finalizeExchange( vecPatches.B_MPIx[ifield      ], 0 ); // By
         vecPatches( ipatch )->finalizeExchange( vecPatches.B_MPIx[ifield+nMPIx], 0 ); // Bz
+#endif
         for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
             if ( vecPatches( ipatch )->is_a_MPI_neighbor( 0, ( iNeighbor+1 )%2 ) ) {
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -1606,6 +2163,13 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongX( VectorPatch &vecPatch
 //         - B_Localy : fields which have local neighbor along Y (a same field can be adressed by both)
 //     - These fields are identified with lists of index MPIyIdx and LocalyIdx
 void SyncVectorPatch::exchangeAllComponentsAlongY( std::vector<Field *> &fields, VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    SyncVectorPatch::initExchangeAllComponentsAlongY( vecPatches, smpi );
+    SyncVectorPatch::exchangeLocalAllComponentsAlongY( fields, vecPatches );
+}
+
+// Pack and send the components which have MPI neighbors along Y
+void SyncVectorPatch::initExchangeAllComponentsAlongY( VectorPatch &vecPatches, SmileiMPI *smpi )
 {
     unsigned oversize = vecPatches( 0 )->EMfields->oversize[1];
 
@@ -1634,9 +2198,20 @@ void SyncVectorPatch::exchangeAllComponentsAlongY( std::vector<Field *> &fields,
 #endif
             }
         }
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->initExchange( vecPatches.B1_MPIy[ifield      ], 1, smpi, true ); // Bx
         vecPatches( ipatch )->initExchange( vecPatches.B1_MPIy[ifield+nMPIy], 1, smpi, true ); // Bz
+#endif
     }
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    SyncVectorPatch::initExchangePerRank( vecPatches.B1_MPIy, &vecPatches.MPIyIdx, 2, 1, vecPatches, smpi );
+#endif
+}
+
+// Copy the components between the patches of the MPI process along Y
+void SyncVectorPatch::exchangeLocalAllComponentsAlongY( std::vector<Field *> &fields, VectorPatch &vecPatches )
+{
+    unsigned oversize = vecPatches( 0 )->EMfields->oversize[1];
 
     unsigned int h0, size;
     double *pt1, *pt2;
@@ -1700,6 +2275,9 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongY( VectorPatch &vecPatch
     unsigned oversize = vecPatches( 0 )->EMfields->oversize[1];
 
     unsigned int nMPIy = vecPatches.MPIyIdx.size();
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    SyncVectorPatch::finalizeExchangePerRank( vecPatches.B1_MPIy, 1, vecPatches );
+#endif
 #ifndef _NO_MPI_TM
     #pragma omp for schedule(static)
 #else
@@ -1707,8 +2285,10 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongY( VectorPatch &vecPatch
 #endif
     for( unsigned int ifield=0 ; ifield<nMPIy ; ifield++ ) {
         unsigned int ipatch = vecPatches.MPIyIdx[ifield];
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->finalizeExchange( vecPatches.B1_MPIy[ifield      ], 1 ); // By
         vecPatches( ipatch )->finalizeExchange( vecPatches.B1_MPIy[ifield+nMPIy], 1 ); // Bz
+#endif
         for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
             if ( vecPatches( ipatch )->is_a_MPI_neighbor( 1, ( iNeighbor+1 )%2 ) ) {
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -1737,6 +2317,13 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongY( VectorPatch &vecPatch
 //         - B_Localz : fields which have local neighbor along Z (a same field can be adressed by both)
 //     - These fields are identified with lists of index MPIzIdx and LocalzIdx
 void SyncVectorPatch::exchangeAllComponentsAlongZ( std::vector<Field *> fields, VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    SyncVectorPatch::initExchangeAllComponentsAlongZ( vecPatches, smpi );
+    SyncVectorPatch::exchangeLocalAllComponentsAlongZ( fields, vecPatches );
+}
+
+// Pack and send the components which have MPI neighbors along Z
+void SyncVectorPatch::initExchangeAllComponentsAlongZ( VectorPatch &vecPatches, SmileiMPI *smpi )
 {
     unsigned oversize = vecPatches( 0 )->EMfields->oversize[2];
 
@@ -1765,9 +2352,20 @@ void SyncVectorPatch::exchangeAllComponentsAlongZ( std::vector<Field *> fields,
 #endif
             }
         }
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->initExchange( vecPatches.B2_MPIz[ifield],       2, smpi, true ); // Bx
         vecPatches( ipatch )->initExchange( vecPatches.B2_MPIz[ifield+nMPIz], 2, smpi, true ); // By
+#endif
     }
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    SyncVectorPatch::initExchangePerRank( vecPatches.B2_MPIz, &vecPatches.MPIzIdx, 2, 2, vecPatches, smpi );
+#endif
+}
+
+// Copy the components between the patches of the MPI process along Z
+void SyncVectorPatch::exchangeLocalAllComponentsAlongZ( std::vector<Field *> fields, VectorPatch &vecPatches )
+{
+    unsigned oversize = vecPatches( 0 )->EMfields->oversize[2];
 
     unsigned int h0, size;
     double *pt1, *pt2;
@@ -1828,6 +2426,9 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongZ( VectorPatch &vecPatch
     unsigned oversize = vecPatches( 0 )->EMfields->oversize[2];
 
     unsigned int nMPIz = vecPatches.MPIzIdx.size();
+#if !defined( SMILEI_ACCELERATOR_GPU )
+    SyncVectorPatch::finalizeExchangePerRank( vecPatches.B2_MPIz, 2, vecPatches );
+#endif
 #ifndef _NO_MPI_TM
     #pragma omp for schedule(static)
 #else
@@ -1835,8 +2436,10 @@ void SyncVectorPatch::finalizeExchangeAllComponentsAlongZ( VectorPatch &vecPatch
 #endif
     for( unsigned int ifield=0 ; ifield<nMPIz ; ifield++ ) {
         unsigned int ipatch = vecPatches.MPIzIdx[ifield];
+#if defined( SMILEI_ACCELERATOR_GPU )
         vecPatches( ipatch )->finalizeExchange( vecPatches.B2_MPIz[ifield      ], 2 ); // Bx
         vecPatches( ipatch )->finalizeExchange( vecPatches.B2_MPIz[ifield+nMPIz], 2 ); // By
+#endif
         for (int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++) {
             if ( vecPatches( ipatch )->is_a_MPI_neighbor( 2, ( iNeighbor+1 )%2 ) ) {
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
@@ -371,6 +371,10 @@ public :
     };
 
     static void sumAllComponents( std::vector<Field *> &fields, VectorPatch &vecPatches, SmileiMPI *smpi );
+    //! Split-phase sum of the currents along X (Main.overlap_current_sums): post the receptions before the dynamics,
+    //! then send the messages of each patch after its dynamics. sumAllComponents finalizes them
+    static void initSumRhoJEarly( VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void postSumRhoJEarly( unsigned int ipatch, VectorPatch &vecPatches, SmileiMPI *smpi );
 
     void templateGenerator();
 
@@ -379,6 +383,10 @@ public :
     static void finalizeexchangeE( Params &params, VectorPatch &vecPatches );
     static void exchangeB( Params &params, VectorPatch &vecPatches, SmileiMPI *smpi );
     static void finalizeexchangeB( Params &params, VectorPatch &vecPatches );
+    //! exchangeB in two steps (not with full_B_exchange): the MPI messages are sent first,
+    //! the copies between the patches of the process are done later
+    static void initExchangeB( Params &params, VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void exchangeLocalB( Params &params, VectorPatch &vecPatches );
     static void exchangeBmBTIS3( Params &params, VectorPatch &vecPatches, int imode, SmileiMPI *smpi );
     static void finalizeexchangeBmBTIS3( Params &params, VectorPatch &vecPatches, int imode );
     static void exchangeBmBTIS3( Params &params, VectorPatch &vecPatches, SmileiMPI *smpi );
@@ -388,6 +396,10 @@ public :
     // static void finalizeexchangeE( Params &params, VectorPatch &vecPatches, int imode );
     static void exchangeB( Params &params, VectorPatch &vecPatches, int imode, SmileiMPI *smpi );
     // static void finalizeexchangeB( Params &params, VectorPatch &vecPatches, int imode );
+    //! E and B of the mode imode in a single round of messages
+    static void exchangeEB( Params &params, VectorPatch &vecPatches, int imode, SmileiMPI *smpi );
+    //! Exchange of the lists of field components of a mode, all their messages sent before waiting for them
+    static void exchangeAMComponents( std::vector<std::vector<Field *> *> lists, VectorPatch &vecPatches, SmileiMPI *smpi );
 
     static void exchangeJ( Params &params, VectorPatch &vecPatches, SmileiMPI *smpi );
     static void finalizeexchangeJ( Params &params, VectorPatch &vecPatches );
@@ -407,6 +419,19 @@ public :
     template<typename T, typename MT> static void exchangeAlongAllDirections( std::vector<Field *> fields, VectorPatch &vecPatches, SmileiMPI *smpi );
     static void finalizeExchangeAlongAllDirections( std::vector<Field *> fields, VectorPatch &vecPatches );
 
+    //! Post the MPI messages of the boundaries of a list of fields along iDim, one per remote MPI process and side.
+    //! fields[icomp*n+ifield] is the component icomp of the patch patchIdx[ifield] (of the patch ifield if patchIdx is NULL)
+    //! With sparse, the MPI messages only carry the nonzero extent of each boundary along iDim (see packSparse).
+    //! With deferred, the messages to send are only prepared, and deferred[ipatch] lists the messages of the patch ipatch
+    static void initExchangePerRank( std::vector<Field *> &fields, const std::vector<int> *patchIdx, unsigned int ncomp, int iDim, VectorPatch &vecPatches, SmileiMPI *smpi,
+                                     bool sparse = false, std::vector< std::vector<unsigned int> > *deferred = NULL );
+    //! Wait for the messages posted by initExchangePerRank and unpack them in the receive buffers (recvFields_)
+    //! Both are called by all the threads: the MPI messages are packed and unpacked in parallel
+    static void finalizeExchangePerRank( std::vector<Field *> &fields, int iDim, VectorPatch &vecPatches );
+    //! Group the boundaries of initExchangePerRank in messages, and pack those in the shared memory of the node
+    static void prepareExchangePerRank( std::vector<Field *> &fields, const std::vector<int> *patchIdx, unsigned int ncomp, int iDim, VectorPatch &vecPatches, SmileiMPI *smpi,
+                                        bool sparse, std::vector< std::vector<unsigned int> > *deferred );
+
     template<typename T, typename MT> static void exchangeAlongAllDirectionsNoOMP( std::vector<Field *> fields, VectorPatch &vecPatches, SmileiMPI *smpi );
     static void finalizeExchangeAlongAllDirectionsNoOMP( std::vector<Field *> fields, VectorPatch &vecPatches );
 
@@ -414,10 +439,16 @@ public :
     static void exchangeSynchronizedPerDirection( std::vector<Field *> fields, VectorPatch &vecPatches, SmileiMPI *smpi );
 
     static void exchangeAllComponentsAlongX( std::vector<Field *> &fields, VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void initExchangeAllComponentsAlongX( VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void exchangeLocalAllComponentsAlongX( std::vector<Field *> &fields, VectorPatch &vecPatches );
     static void finalizeExchangeAllComponentsAlongX( VectorPatch &vecPatches );
     static void exchangeAllComponentsAlongY( std::vector<Field *> &fields, VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void initExchangeAllComponentsAlongY( VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void exchangeLocalAllComponentsAlongY( std::vector<Field *> &fields, VectorPatch &vecPatches );
     static void finalizeExchangeAllComponentsAlongY( VectorPatch &vecPatches );
     static void exchangeAllComponentsAlongZ( std::vector<Field *> fields, VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void initExchangeAllComponentsAlongZ( VectorPatch &vecPatches, SmileiMPI *smpi );
+    static void exchangeLocalAllComponentsAlongZ( std::vector<Field *> fields, VectorPatch &vecPatches );
     static void finalizeExchangeAllComponentsAlongZ( VectorPatch &vecPatches );
 
     //! Deprecated field functions
@@ -1,5 +1,6 @@
 #include "VectorPatch.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <cstdlib>
@@ -39,12 +40,28 @@ using namespace std;
 VectorPatch::VectorPatch()
 {
     domain_decomposition_ = NULL ;
+    particles_memory_peak_ = 0;
+    mpi_buffers_memory_peak_ = 0;
+    currentSumsEarly_ = false;
+    load_imbalance_ = 1.;
+    load_balancing_skipped_ = 0;
+    last_compute_time_ = 0.;
+    last_balancing_time_ = 0.;
+    balancing_cost_ = 0.;
 }
 
 
 VectorPatch::VectorPatch( Params &params )
 {
     domain_decomposition_ = DomainDecompositionFactory::create( params );
+    particles_memory_peak_ = 0;
+    mpi_buffers_memory_peak_ = 0;
+    currentSumsEarly_ = false;
+    load_imbalance_ = 1.;
+    load_balancing_skipped_ = 0;
+    last_compute_time_ = 0.;
+    last_balancing_time_ = 0.;
+    balancing_cost_ = 0.;
 }
 
 
@@ -259,6 +276,17 @@ void VectorPatch::configuration( Params &params, Timers &timers, int itime )
 
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Reseed the random generators of the patches for the iteration itime
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::reseedRandom( Params &params, unsigned int itime )
+{
+    #pragma omp for schedule(static)
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        ( *this )( ipatch )->rand_->reseed( params.random_seed, ( *this )( ipatch )->hindex, itime );
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Reconfigure all patches for the new time step
 // ---------------------------------------------------------------------------------------------------------------------
@@ -335,7 +363,17 @@ void VectorPatch::dynamics( Params &params,
     #pragma omp single
     {
         diag_flag = ( needsRhoJsNow( itime ) || params.is_spectral );
+        // The currents are summed by sumDensities only without diagnostics, if some species is projected
+        currentSumsEarly_ = false;
+        if( params.overlap_current_sums && !diag_flag ) {
+            for( unsigned int ispec=0 ; ispec<( *this )( 0 )->vecSpecies.size() ; ispec++ ) {
+                if( ( *this )( 0 )->vecSpecies[ispec]->isProj( time_dual, simWindow ) ) {
+                    currentSumsEarly_ = true;
+                }
+            }
+        }
     }
+    manageRhoJs( params );
 
     timers.particles.restart();
     ostringstream t;
@@ -354,14 +392,6 @@ void VectorPatch::dynamics( Params &params,
     }
 #endif
 
-#ifdef _PARTEVENTTRACING
-    bool diag_PartEventTracing {false};
-    if( !params.Laser_Envelope_model ) {
-        diag_PartEventTracing = smpi->diagPartEventTracing( time_dual, params.timestep);
-        if (diag_PartEventTracing) smpi->reference_time_ = MPI_Wtime();
-    }
-#endif
-
 #ifndef _OMPTASKS
     // if tasks are not activated
     dynamicsWithoutTasks( params, smpi, simWindow, RadiationTables,
@@ -374,19 +404,6 @@ void VectorPatch::dynamics( Params &params,
                           time_dual, timers, itime );
 #endif
 
-#ifdef _PARTEVENTTRACING
-    #ifdef _OMPTASKS
-    #pragma omp taskwait
-    #endif
-    if (!params.Laser_Envelope_model){
-        #pragma omp single
-        {
-        int iteration = int((time_dual-0.5*params.timestep)/params.timestep);
-        if(diag_PartEventTracing) writeParticleEventTracingOutput(params, smpi, iteration);
-        } // end single
-    } // end if Laser envelope model
-#  endif
-
     timers.particles.update( params.printNow( itime ) );
 #ifdef __DETAILED_TIMERS
     timers.interpolator.updateThreaded( *this, params.printNow( itime ) );
@@ -411,6 +428,7 @@ void VectorPatch::projectionForDiags( Params &params,
 
     #pragma omp single
     diag_flag = needsRhoJsNow( itime );
+    manageRhoJs( params );
 
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
@@ -482,8 +500,13 @@ void VectorPatch::finalizeExchParticlesAndSort( Params &params, SmileiMPI *smpi,
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
         // Particle importation for all species
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
-            if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
-                species( ipatch, ispec )->dynamicsImportParticles( time_dual, params, ( *this )( ipatch ), localDiags );
+            Species *spec = species( ipatch, ispec );
+            // Only the species with ionization, radiation or Breit-Wheeler process create particles
+            if( !spec->Ionize && !spec->Radiate && !spec->Multiphoton_Breit_Wheeler_process ) {
+                continue;
+            }
+            if( spec->isProj( time_dual, simWindow ) || diag_flag ) {
+                spec->dynamicsImportParticles( time_dual, params, ( *this )( ipatch ), localDiags );
             }
         }
     }
@@ -496,18 +519,98 @@ void VectorPatch::finalizeExchParticlesAndSort( Params &params, SmileiMPI *smpi,
 //! Perform the particles merging on all patches
 void VectorPatch::mergeParticles(Params &params, double time_dual,Timers &timers, int itime )
 {
+    // All the patches have the same species: nothing to do if none of them is merged now
+    bool merging_now = false;
+    for( unsigned int ispec=0 ; ispec<( *this )( 0 )->vecSpecies.size() ; ispec++ ) {
+        if( species( 0, ispec )->has_merging_
+            && species( 0, ispec )->merging_time_selection_->theTimeIsNow( itime ) ) {
+            merging_now = true;
+        }
+    }
+    if( ! merging_now ) {
+        return;
+    }
+
     timers.particleMerging.restart();
 
+    #pragma omp single
+    merging_cells_.resize( this->size() );
+
+    // Masks and random seeds of the cells to merge
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-        // Particle importation for all species
+        merging_cells_[ipatch].assign( ( *this )( ipatch )->vecSpecies.size(), 0 );
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
-            // Check if the particle merging is activated for this species
-            if (species( ipatch, ispec )->has_merging_) {
+            // Check if the particle merging is activated for this species (with particles in this patch)
+            if( species( ipatch, ispec )->has_merging_ && species( ipatch, ispec )->getNbrOfParticles() > 0 ) {
 
                 // Check the time selection
                 if( species( ipatch, ispec )->merging_time_selection_->theTimeIsNow( itime ) ) {
-                    species( ipatch, ispec )->mergeParticles( time_dual );
+                    merging_cells_[ipatch][ispec] = species( ipatch, ispec )->prepareMerging( time_dual );
+                }
+            }
+        }
+    }
+
+    // The cells of all the patches are grouped in chunks of about merging_chunk_particles_ particles,
+    // so that the threads share the cells of the most loaded patches
+    #pragma omp single
+    {
+        applyMergingBudget();
+
+        merging_chunks_.clear();
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            for( unsigned int ispec=0 ; ispec<merging_cells_[ipatch].size() ; ispec++ ) {
+                Particles *particles = species( ipatch, ispec )->particles;
+                unsigned int first_cell = 0;
+                int npart = 0;
+                for( unsigned int scell = 0 ; scell < merging_cells_[ipatch][ispec] ; scell++ ) {
+                    npart += particles->last_index[scell] - particles->first_index[scell];
+                    if( npart >= merging_chunk_particles_ || scell+1 == merging_cells_[ipatch][ispec] ) {
+                        merging_chunks_.push_back( { ipatch, ispec, first_cell, scell+1 } );
+                        first_cell = scell+1;
+                        npart = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    // Merging of the chunks of cells
+    #pragma omp for schedule(dynamic)
+    for( unsigned int ichunk=0 ; ichunk<merging_chunks_.size() ; ichunk++ ) {
+        const MergingChunk &chunk = merging_chunks_[ichunk];
+        species( chunk.ipatch, chunk.ispec )->mergeParticlesInCells( chunk.first_cell, chunk.last_cell );
+    }
+
+    // Removal of the merged particles
+    #pragma omp for schedule(runtime)
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        for( unsigned int ispec=0 ; ispec<merging_cells_[ipatch].size() ; ispec++ ) {
+            if( merging_cells_[ipatch][ispec] > 0 ) {
+                species( ipatch, ispec )->finalizeMerging();
+            }
+        }
+    }
+
+    timers.particleMerging.update( params.printNow( itime ) );
+
+}
+
+//! Particle splitting in the cells with few particles (measured by the merging timer)
+void VectorPatch::splitParticles( Params &params, double time_dual, Timers &timers, int itime )
+{
+    timers.particleMerging.restart();
+
+    #pragma omp for schedule(runtime)
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+            // Check if the particle splitting is activated for this species
+            if( species( ipatch, ispec )->has_splitting_ ) {
+
+                // Check the time selection
+                if( species( ipatch, ispec )->splitting_time_selection_->theTimeIsNow( itime ) ) {
+                    species( ipatch, ispec )->splitParticles( ( *this )( ipatch ), localDiags, time_dual );
                 }
             }
         }
@@ -517,6 +620,53 @@ void VectorPatch::mergeParticles(Params &params, double time_dual,Timers &timers
 
 }
 
+//! Target number of particles per cell of the species with a memory budget (`merge_memory_budget`):
+//! the largest number T such that the cells of the process, each reduced to at most T particles,
+//! fit in the budget. Only the most populated cells are merged, the others are left untouched.
+void VectorPatch::applyMergingBudget()
+{
+    for( unsigned int ispec=0 ; ispec<( *this )( 0 )->vecSpecies.size() ; ispec++ ) {
+        if( species( 0, ispec )->merge_memory_budget_ <= 0. ) {
+            continue;
+        }
+
+        // Number of particles of the cells to merge
+        std::vector<unsigned int> cell_particles;
+        double total = 0.;
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            Particles *particles = species( ipatch, ispec )->particles;
+            for( unsigned int scell = 0 ; scell < merging_cells_[ipatch][ispec] ; scell++ ) {
+                cell_particles.push_back( particles->last_index[scell] - particles->first_index[scell] );
+                total += cell_particles.back();
+            }
+        }
+        double budget = species( 0, ispec )->merge_memory_budget_ * 1024. * 1024.
+                        / ( double )species( 0, ispec )->getParticleMemory();
+        if( cell_particles.empty() || total <= budget ) {
+            continue;
+        }
+
+        // Water filling: the cells below the target keep their particles
+        std::sort( cell_particles.begin(), cell_particles.end() );
+        double target = 0.;
+        for( unsigned int icell = 0 ; icell < cell_particles.size() ; icell++ ) {
+            const double remaining_cells = cell_particles.size() - icell;
+            if( cell_particles[icell] * remaining_cells >= budget ) {
+                target = budget / remaining_cells;
+                break;
+            }
+            budget -= cell_particles[icell];
+        }
+        // Packets of at least 4 particles are merged into 2 particles
+        unsigned int cell_target = std::max( 4u, ( unsigned int )target );
+
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            Species *spec = species( ipatch, ispec );
+            spec->merging_target_ = spec->merging_target_ > 0 ? std::min( spec->merging_target_, cell_target ) : cell_target;
+        }
+    }
+}
+
 //! Clean MPI buffers and resize particle arrays to save memory
 void VectorPatch::cleanParticlesOverhead(Params &params, Timers &timers, int itime )
 {
@@ -524,8 +674,11 @@ void VectorPatch::cleanParticlesOverhead(Params &params, Timers &timers, int iti
 
     if( itime%params.every_clean_particles_overhead==0 ) {
         #pragma omp master
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->cleanParticlesOverhead( params );
+        {
+            updateParticlesMemoryPeaks();
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->cleanParticlesOverhead( params );
+            }
         }
         #pragma omp barrier
     }
@@ -785,7 +938,7 @@ void VectorPatch::injectParticlesFromBoundaries(Params &params, Timers &timers,
 }
 
 //! Computation of the total charge
-void VectorPatch::computeCharge(bool old /*=false*/)
+void VectorPatch::computeCharge( double time_dual, bool old /*=false*/ )
 {
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
@@ -795,10 +948,12 @@ void VectorPatch::computeCharge(bool old /*=false*/)
             ( *this )( ipatch )->EMfields->restartRhoJ();
         }
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+            // The charge density of frozen particles is cached by the species
+            const bool frozen = species( ipatch, ispec )->isFrozen( time_dual );
             if( ( *this )( ipatch )->vecSpecies[ispec]->vectorized_operators ) {
-                species( ipatch, ispec )->computeCharge( emfields( ipatch ), old );
+                species( ipatch, ispec )->computeCharge( emfields( ipatch ), old, frozen );
             } else {
-                species( ipatch, ispec )->Species::computeCharge( emfields( ipatch ), old );
+                species( ipatch, ispec )->Species::computeCharge( emfields( ipatch ), old, frozen );
             }
         }
     }
@@ -864,7 +1019,10 @@ void VectorPatch::sumDensities( Params &params, double time_dual, Timers &timers
                 ( *this )( ipatch )->EMfields->computeTotalRhoJOnDevice();
             }
 #else
-            ( *this )( ipatch )->EMfields->computeTotalRhoJ();
+            // The densities of the species of a vacuum patch are all zero before their synchronization
+            if( !( *this )( ipatch )->vacuum_ ) {
+                ( *this )( ipatch )->EMfields->computeTotalRhoJ();
+            }
 #endif
         }
     }
@@ -874,6 +1032,8 @@ void VectorPatch::sumDensities( Params &params, double time_dual, Timers &timers
     if( params.geometry != "AMcylindrical" ) {
         if ( (!params.multiple_decomposition)||(itime==0) )
             SyncVectorPatch::sumRhoJ( params, ( *this ), smpi ); // MPI
+        #pragma omp single
+        currentSumsEarly_ = false;
     } else {
 
         if ( (!params.multiple_decomposition)||(itime==0) )
@@ -986,15 +1146,25 @@ void VectorPatch::solveMaxwell( Params &params, SimWindow *simWindow, int itime,
 
     // Current filter in intermediate space
     if (params.currentFilter_passes.size() > 0){
-        for( unsigned int ipassfilter=0 ; ipassfilter<*std::max_element(std::begin(params.currentFilter_passes), std::end(params.currentFilter_passes)) ; ipassfilter++ ) {
+        const unsigned int npasses = *std::max_element(std::begin(params.currentFilter_passes), std::end(params.currentFilter_passes));
+        // Each pass spoils the currents in the outermost ghost cells over the half width of the kernel,
+        // so that several passes can be applied between two exchanges as long as the ghost cells are wide enough
+        const unsigned int half_width = params.currentFilter_model=="customFIR" ? ( params.currentFilter_kernelFIR.size()-1 )/2 : 1;
+        const std::vector<unsigned int> &oversize = ( *this )( 0 )->EMfields->oversize; // the regions have their own ghost cells
+        const unsigned int ghost_size = *std::min_element( oversize.begin(), oversize.end() );
+        const unsigned int passes_per_exchange = std::max( ghost_size / half_width, 1u );
+        for( unsigned int ipassfilter=0 ; ipassfilter<npasses ; ipassfilter+=passes_per_exchange ) {
+            const unsigned int end_pass = std::min( ipassfilter+passes_per_exchange, npasses );
             #pragma omp for schedule(static)
             for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
                 // Current spatial filtering
-                if (params.currentFilter_model=="binomial"){
-                    ( *this )( ipatch )->EMfields->binomialCurrentFilter(ipassfilter, params.currentFilter_passes);
-                }
-                if (params.currentFilter_model=="customFIR"){
-                    ( *this )( ipatch )->EMfields->customFIRCurrentFilter(ipassfilter, params.currentFilter_passes, params.currentFilter_kernelFIR);
+                for( unsigned int ipass=ipassfilter ; ipass<end_pass ; ipass++ ) {
+                    if (params.currentFilter_model=="binomial"){
+                        ( *this )( ipatch )->EMfields->binomialCurrentFilter(ipass, params.currentFilter_passes);
+                    }
+                    if (params.currentFilter_model=="customFIR"){
+                        ( *this )( ipatch )->EMfields->customFIRCurrentFilter(ipass, params.currentFilter_passes, params.currentFilter_kernelFIR);
+                    }
                 }
             }
             if (params.geometry != "AMcylindrical"){
@@ -1023,38 +1193,92 @@ void VectorPatch::solveMaxwell( Params &params, SimWindow *simWindow, int itime,
         }
     }
 
-    #pragma omp for schedule(static)
-    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-        if( !params.is_spectral ) {
-            // Saving magnetic fields (to compute centered fields used in the particle pusher)
-            // Stores B at time n in B_m.
-            ( *this )( ipatch )->EMfields->saveMagneticFields( params.is_spectral );
+    // Without full_B_exchange, the patches with MPI neighbors are solved first, so that
+    // the MPI messages of their halo are in flight while the other patches are solved.
+    // The copies between the patches of the MPI process are done once all patches are solved.
+    const bool overlap_exchange = !params.is_spectral && !params.full_B_exchange && params.geometry != "AMcylindrical";
+
+    if( overlap_exchange ) {
+        for( int border=1 ; border>=0 ; border-- ) {
+            #pragma omp for schedule(static)
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                if( ( *this )( ipatch )->has_an_MPI_neighbor() != ( border == 1 ) ) {
+                    continue;
+                }
+                // The solvers would leave the fields of a patch in vacuum unchanged
+                if( params.maxwell_skip_vacuum && ( *this )( ipatch )->EMfields->isVacuum() ) {
+                    continue;
+                }
+                const double load_timer = params.measured_load_steps > 0 ? MPI_Wtime() : 0.;
+                ( *this )( ipatch )->EMfields->saveMagneticFields( params.is_spectral );
+                ( *( *this )( ipatch )->EMfields->MaxwellAmpereSolver_ )( ( *this )( ipatch )->EMfields );
+                ( *( *this )( ipatch )->EMfields->MaxwellFaradaySolver_ )( ( *this )( ipatch )->EMfields );
+                if( params.measured_load_steps > 0 ) {
+                    ( *this )( ipatch )->load_time_ += MPI_Wtime() - load_timer;
+                }
+            }
+            if( border == 1 ) {
+                SyncVectorPatch::initExchangeB( params, ( *this ), smpi );
+            }
         }
-        // Computes Ex_, Ey_, Ez_ on all points.
-        // E is already synchronized because J has been synchronized before.
-        ( *( *this )( ipatch )->EMfields->MaxwellAmpereSolver_ )( ( *this )( ipatch )->EMfields );
-    }
+        timers.maxwell.update( params.printNow( itime ) );
 
-    #pragma omp for schedule(static)
-    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-        // Computes Bx_, By_, Bz_ at time n+1 on interior points.
-        ( *( *this )( ipatch )->EMfields->MaxwellFaradaySolver_ )( ( *this )( ipatch )->EMfields );
-    }
-    //Synchronize B fields between patches.
-    timers.maxwell.update( params.printNow( itime ) );
+        timers.syncField.restart();
+        SyncVectorPatch::exchangeLocalB( params, ( *this ) );
+        timers.syncField.update( params.printNow( itime ) );
+    } else {
+        #pragma omp for schedule(static)
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            // The solvers would leave the fields of a patch in vacuum unchanged
+            ( *this )( ipatch )->EMfields->vacuum_ = params.maxwell_skip_vacuum && ( *this )( ipatch )->EMfields->isVacuum();
+            if( ( *this )( ipatch )->EMfields->vacuum_ ) {
+                continue;
+            }
+            const double load_timer = params.measured_load_steps > 0 ? MPI_Wtime() : 0.;
+            if( !params.is_spectral ) {
+                // Saving magnetic fields (to compute centered fields used in the particle pusher)
+                // Stores B at time n in B_m.
+                ( *this )( ipatch )->EMfields->saveMagneticFields( params.is_spectral );
+            }
+            // Computes Ex_, Ey_, Ez_ on all points.
+            // E is already synchronized because J has been synchronized before.
+            ( *( *this )( ipatch )->EMfields->MaxwellAmpereSolver_ )( ( *this )( ipatch )->EMfields );
+            if( params.measured_load_steps > 0 ) {
+                ( *this )( ipatch )->load_time_ += MPI_Wtime() - load_timer;
+            }
+        }
 
+        #pragma omp for schedule(static)
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            // Still in vacuum after Maxwell-Ampere: E is zero, B is not changed
+            if( ( *this )( ipatch )->EMfields->vacuum_ ) {
+                continue;
+            }
+            const double load_timer = params.measured_load_steps > 0 ? MPI_Wtime() : 0.;
+            // Computes Bx_, By_, Bz_ at time n+1 on interior points.
+            ( *( *this )( ipatch )->EMfields->MaxwellFaradaySolver_ )( ( *this )( ipatch )->EMfields );
+            if( params.measured_load_steps > 0 ) {
+                ( *this )( ipatch )->load_time_ += MPI_Wtime() - load_timer;
+            }
+        }
+        //Synchronize B fields between patches.
+        timers.maxwell.update( params.printNow( itime ) );
 
-    timers.syncField.restart();
-    if( params.geometry != "AMcylindrical" ) {
-        if( params.is_spectral ) SyncVectorPatch::exchangeE( params, ( *this ), smpi );
-        SyncVectorPatch::exchangeB( params, ( *this ), smpi );
-    } else {
-        for( unsigned int imode = 0 ; imode < static_cast<ElectroMagnAM *>( patches_[0]->EMfields )->El_.size() ; imode++ ) {
-            if( params.is_spectral ) SyncVectorPatch::exchangeE( params, ( *this ), imode, smpi );
-            SyncVectorPatch::exchangeB( params, ( *this ), imode, smpi );
+        timers.syncField.restart();
+        if( params.geometry != "AMcylindrical" ) {
+            if( params.is_spectral ) SyncVectorPatch::exchangeE( params, ( *this ), smpi );
+            SyncVectorPatch::exchangeB( params, ( *this ), smpi );
+        } else {
+            for( unsigned int imode = 0 ; imode < static_cast<ElectroMagnAM *>( patches_[0]->EMfields )->El_.size() ; imode++ ) {
+                if( params.is_spectral ) {
+                    SyncVectorPatch::exchangeEB( params, ( *this ), imode, smpi );
+                } else {
+                    SyncVectorPatch::exchangeB( params, ( *this ), imode, smpi );
+                }
+            }
         }
+        timers.syncField.update( params.printNow( itime ) );
     }
-    timers.syncField.update( params.printNow( itime ) );
 
 
     if ( (params.multiple_decomposition) && ( itime!=0 ) && ( time_dual > params.time_fields_frozen ) ) { // multiple_decomposition = true -> is_spectral = true
@@ -1139,12 +1363,9 @@ void VectorPatch::solveEnvelope( Params &params, SimWindow *simWindow, int, doub
 
         #pragma omp for schedule(static)
         for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            // Compute ponderomotive potential Phi=|A|^2/2, |A| and |E| from the envelope
-            ( *this )( ipatch )->EMfields->envelope->computePhiEnvAEnvE( ( *this )( ipatch )->EMfields );
-            // Compute gradients of Phi
-            ( *this )( ipatch )->EMfields->envelope->computeGradientPhi( ( *this )( ipatch )->EMfields );
-            // Computes Phi and GradPhi at time n+1/2 using their values at timestep n+1 and n (the latter already in Phi_m and GradPhi_m)
-            ( *this )( ipatch )->EMfields->envelope->centerPhiAndGradPhi();
+            // Compute ponderomotive potential Phi=|A|^2/2, |A|, |E| and the gradients of Phi from the envelope,
+            // then Phi and GradPhi at time n+1/2 using their values at timestep n+1 and n (the latter already in Phi_m and GradPhi_m)
+            ( *this )( ipatch )->EMfields->envelope->computePhiAndGradPhi( ( *this )( ipatch )->EMfields );
         }
 
         // Exchange |Ex|, because it cannot be computed in all ghost cells like |E|
@@ -1245,19 +1466,58 @@ void VectorPatch::initAllDiags( Params &params, SmileiMPI *smpi )
 
 void VectorPatch::closeAllDiags( SmileiMPI *smpi )
 {
+    // Asynchronous reductions of the last output
+    for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
+        smpi->finalizeGlobalDiags( globalDiags[idiag] );
+    }
+
     // MPI master closes all global diags
     if( smpi->isMaster() )
         for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
             globalDiags[idiag]->closeFile();
         }
 
-    // All MPI close local diags
+    // All MPI close local diags (after writing the iterations they kept in memory)
     for( unsigned int idiag = 0 ; idiag < localDiags.size() ; idiag++ ) {
+        if( DiagnosticTrack *track = dynamic_cast<DiagnosticTrack *>( localDiags[idiag] ) ) {
+            track->writeBuffered( smpi, true );
+        }
         localDiags[idiag]->closeFile();
     }
 }
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Waits for the asynchronous writes of the fields diags if another diag writes in an HDF5 file at this iteration
+// (the HDF5 library is not called from several threads at once). Executed by a single thread.
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::waitAsynchronousFieldsWrites( unsigned int itime )
+{
+    bool hdf5_output = false;
+    for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
+        DiagnosticParticleBinningBase* binning = dynamic_cast<DiagnosticParticleBinningBase*>( globalDiags[idiag] );
+        if( binning ) {
+            hdf5_output = hdf5_output || binning->theTimeIsNow( itime );
+        } else if( ! dynamic_cast<DiagnosticScalar*>( globalDiags[idiag] ) ) {
+            hdf5_output = hdf5_output || globalDiags[idiag]->timeSelection->theTimeIsNow( itime );
+        }
+    }
+    for( unsigned int idiag = 0 ; idiag < localDiags.size() ; idiag++ ) {
+        DiagnosticFields* fields = dynamic_cast<DiagnosticFields*>( localDiags[idiag] );
+        if( fields ) {
+            hdf5_output = hdf5_output || ( ! fields->asynchronous() && fields->prepare( itime ) );
+        } else if( dynamic_cast<DiagnosticNewParticles*>( localDiags[idiag] ) ) {
+            // May write before its time selection if its buffers are full
+            hdf5_output = hdf5_output || localDiags[idiag]->prepare( itime );
+        } else {
+            hdf5_output = hdf5_output || localDiags[idiag]->timeSelection->theTimeIsNow( itime );
+        }
+    }
+    if( hdf5_output ) {
+        DiagnosticFields::waitAsynchronousWrites();
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // For all patch, Compute and Write all diags
 //   - Scalars, Probes, Phases, TrackParticles, Fields, Average fields
@@ -1340,6 +1600,12 @@ void VectorPatch::runAllDiags( Params &/*params*/, SmileiMPI *smpi, unsigned int
     }
 #endif
 
+    // The asynchronous writes of the fields diags must complete before any other HDF5 output
+    if( DiagnosticFields::anyAsynchronous() ) {
+        #pragma omp single
+        waitAsynchronousFieldsWrites( itime );
+    }
+
     // Pre-process for binning diags with auto limits
     vector<double> MPI_mins, MPI_maxs;
     for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
@@ -1438,7 +1704,11 @@ void VectorPatch::runAllDiags( Params &/*params*/, SmileiMPI *smpi, unsigned int
         diag_timers_[idiag]->restart();
 
         #pragma omp single
-        globalDiags[idiag]->theTimeIsNow_ = globalDiags[idiag]->prepare( itime );
+        {
+            // Asynchronous reductions of the previous output
+            smpi->finalizeGlobalDiags( globalDiags[idiag] );
+            globalDiags[idiag]->theTimeIsNow_ = globalDiags[idiag]->prepare( itime );
+        }
 
         if( globalDiags[idiag]->theTimeIsNow_ ) {
             // All patches run
@@ -1448,6 +1718,10 @@ void VectorPatch::runAllDiags( Params &/*params*/, SmileiMPI *smpi, unsigned int
                 globalDiags[idiag]->run( ( *this )( ipatch ), itime, simWindow );
             }
             SMILEI_PY_RESTORE_MASTER_THREAD
+            // Sum the histograms private to each thread
+            if( DiagnosticParticleBinningBase* binning = dynamic_cast<DiagnosticParticleBinningBase*>( globalDiags[idiag] ) ) {
+                binning->reduceThreads();
+            }
             // MPI procs gather the data and compute
             #pragma omp single
             smpi->computeGlobalDiags( globalDiags[idiag], itime );
@@ -1525,9 +1799,15 @@ void VectorPatch::runAllDiagsTasks( Params &, SmileiMPI *smpi, unsigned int itim
     timers.diags.restart();
     #pragma omp single
     {
+        // The asynchronous writes of the fields diags must complete before any other HDF5 output
+        if( DiagnosticFields::anyAsynchronous() ) {
+            waitAsynchronousFieldsWrites( itime );
+        }
+
         for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
 
             diag_timers_[idiag]->restartInTask();
+            smpi->finalizeGlobalDiags( globalDiags[idiag] );
             globalDiags[idiag]->theTimeIsNow_ = globalDiags[idiag]->prepare( itime );
 
             if( globalDiags[idiag]->theTimeIsNow_ ) {
@@ -1571,6 +1851,10 @@ void VectorPatch::runAllDiagsTasks( Params &, SmileiMPI *smpi, unsigned int itim
 
     for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
         if( globalDiags[idiag]->theTimeIsNow_ ) {
+            // Sum the histograms private to each thread
+            if( DiagnosticParticleBinningBase* binning = dynamic_cast<DiagnosticParticleBinningBase*>( globalDiags[idiag] ) ) {
+                binning->reduceThreads();
+            }
             // MPI procs gather the data and compute
             #pragma omp single
             {
@@ -1699,6 +1983,20 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
     // compute control parameter
     double ctrl = rnew_dot_rnew / ( double )( nx_p2_global );
 
+    // Multigrid preconditioner: the direction starts from z = M^-1 r
+    double rz = 0.;
+    if( params.poisson_multigrid ) {
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->initPoissonPreconditioner( 1. );
+        }
+        double dots[3];
+        preconditionPoisson( smpi, dots );
+        rz = dots[1];
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->update_p_preconditioned( 0. ); // p = z
+        }
+    }
+
     // ---------------------------------------------------------
     // Starting iterative loop for the conjugate gradient method
     // ---------------------------------------------------------
@@ -1733,25 +2031,35 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
 
         // compute new potential and residual
         for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_pand_r( r_dot_r, p_dot_Ap );
+            ( *this )( ipatch )->EMfields->update_pand_r( params.poisson_multigrid ? rz : r_dot_r, p_dot_Ap );
         }
 
-        // compute new residual norm
-        rnew_dot_rnew       = 0.0;
-        rnew_dot_rnew_local = 0.0;
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+        // compute new residual norm and new direction
+        if( params.poisson_multigrid ) {
+            // the residual norm is reduced with the products of the preconditioned residual
+            double dots[3];
+            preconditionPoisson( smpi, dots );
+            rnew_dot_rnew = dots[0];
+            // flexible coefficient ( r_new-r ).z_new / r.z, as the single precision preconditioner is not exactly linear
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_p_preconditioned( -dots[2]/p_dot_Ap );
+            }
+            rz = dots[1];
+        } else {
+            rnew_dot_rnew       = 0.0;
+            rnew_dot_rnew_local = 0.0;
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+            }
+            MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
+            }
         }
-        MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
         if( smpi->isMaster() ) {
             DEBUG( "new residual norm: rnew_dot_rnew = " << rnew_dot_rnew );
         }
 
-        // compute new directio
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
-        }
-
         // compute control parameter
         ctrl = rnew_dot_rnew / ( double )( nx_p2_global );
         if( smpi->isMaster() ) {
@@ -1778,6 +2086,9 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
     // Compute the electrostatic fields Ex and Ey
     // ------------------------------------------
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        if( params.poisson_multigrid ) {
+            ( *this )( ipatch )->EMfields->deletePoissonPreconditioner();
+        }
         ( *this )( ipatch )->EMfields->initE( ( *this )( ipatch ) );
     }
 
@@ -1834,11 +2145,11 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
             Ey_XmaxYmin = ( *this )( patch_YminXmax-( this->refHindex_ ) )->EMfields->getEy_XmaxYmin();
         }
 
-        MPI_Bcast( &Ex_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, MPI_COMM_WORLD );
-        MPI_Bcast( &Ey_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, smpi->world() );
+        MPI_Bcast( &Ey_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, smpi->world() );
 
-        MPI_Bcast( &Ex_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, MPI_COMM_WORLD );
-        MPI_Bcast( &Ey_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, smpi->world() );
+        MPI_Bcast( &Ey_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, smpi->world() );
 
         //This correction is always done, independantly of the periodicity. Is this correct ?
         E_Add[0] = -0.5*( Ex_XminYmax+Ex_XmaxYmin );
@@ -1867,14 +2178,14 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
             //Ex_Xmin = (*Ex1D)(index_bc_min[0]);
             Ex_Xmin = ( *this )( ( 0 )-( this->refHindex_ ) )->EMfields->getEx_Xmin();
         }
-        MPI_Bcast( &Ex_Xmin, 1, MPI_DOUBLE, rankXmin, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_Xmin, 1, MPI_DOUBLE, rankXmin, smpi->world() );
 
         unsigned int rankXmax = smpi->getSize()-1;
         if( smpi->getRank() == smpi->getSize()-1 ) {
             //Ex_Xmax = (*Ex1D)(index_bc_max[0]);
             Ex_Xmax = ( *this )( ( params.number_of_patches[0]-1 )-( this->refHindex_ ) )->EMfields->getEx_Xmax();
         }
-        MPI_Bcast( &Ex_Xmax, 1, MPI_DOUBLE, rankXmax, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_Xmax, 1, MPI_DOUBLE, rankXmax, smpi->world() );
         E_Add[0] = -0.5*( Ex_Xmin+Ex_Xmax );
 
 #ifdef _3D_LIKE_CENTERING
@@ -1919,6 +2230,30 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
 
 } // END solvePoisson
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Preconditioned residual z = M^-1 r of the Poisson solvers (multigrid on the nodes owned by each patch).
+// Each node of z is set by its owner only, the sum over the overlapping patches then synchronizes z
+// (the primal node shared by two patches is not covered by the exchange of the ghost cells)
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::preconditionPoisson( SmileiMPI *smpi, double dots[3] )
+{
+    std::vector<Field *> z( this->size() );
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        ( *this )( ipatch )->EMfields->compute_z();
+        z[ipatch] = ( *this )( ipatch )->EMfields->z_;
+    }
+    SyncVectorPatch::sum<double,Field>( z, *this, smpi );
+
+    double dots_local[3] = { 0., 0., 0. };
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        ElectroMagn *EMfields = ( *this )( ipatch )->EMfields;
+        dots_local[0] += EMfields->compute_r();
+        dots_local[1] += EMfields->compute_rz();
+        dots_local[2] += EMfields->dotPoisson( EMfields->z_, EMfields->Ap_ );
+    }
+    MPI_Allreduce( dots_local, dots, 3, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+}
+
 void VectorPatch::solvePoissonAM( Params &params, SmileiMPI *smpi )
 {
 
@@ -2184,6 +2519,15 @@ void VectorPatch::runRelativisticModule( double time_prim, Params &params, Smile
         }
     }
 
+    // The potentials kept for the warm start of the next species are not used at the other iterations
+    #pragma omp master
+    {
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->deletePoissonSolution();
+        }
+    }
+    #pragma omp barrier
+
     // Reset rho and J and return to PIC loop
     resetRhoJ();
 
@@ -2242,14 +2586,10 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
     unsigned int iteration=0;
 
     // Init & Store internal data (phi, r, p, Ap) per patch
-    double rnew_dot_rnew_local( 0. );
-    double rnew_dot_rnew( 0. );
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
         ( *this )( ipatch )->EMfields->initPoisson( ( *this )( ipatch ) );
-        rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
         ( *this )( ipatch )->EMfields->initRelativisticPoissonFields();
     }
-    MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
 
     std::vector<Field *> listBx_m(this->size());
     std::vector<Field *> listBy_m(this->size());
@@ -2291,20 +2631,64 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
         listAp[ipatch] = ( *this )( ipatch )->EMfields->Ap_ ;
     }
 
-    // unsigned int nx_p2_global = ( params.global_size_[0]+1 );
-    // //if ( Ex_[0]->dims_.size()>1 ) {
-    // if( Ex_rel_[0]->dims_.size()>1 ) {
-    //     nx_p2_global *= ( params.global_size_[1]+1 );
-    //     if( Ex_rel_[0]->dims_.size()>2 ) {
-    //         nx_p2_global *= ( params.global_size_[2]+1 );
-    //     }
-    // }
-
+    // Warm start from the potential of the previous species initialized at this iteration (bunch in several species):
+    // phi = s phi_previous, with s minimizing the error in the norm of the operator, if it reduces the residual
+    bool warm_start = ( *this )( 0 )->EMfields->phi_previous_ != NULL;
+    if( warm_start ) {
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->initPoissonGuess();
+            ( *this )( ipatch )->EMfields->compute_Ap_relativistic_Poisson( ( *this )( ipatch ), gamma_mean );
+        }
+        SyncVectorPatch::exchangeAlongAllDirectionsNoOMP<double,Field>( listAp, *this, smpi );
+        SyncVectorPatch::finalizeExchangeAlongAllDirectionsNoOMP( listAp, *this );
+    }
+    // r = b at this point: products b.b, and p.b, p.Ap, Ap.b, Ap.Ap for the warm start
+    double dots_local[5] = { 0., 0., 0., 0., 0. }, dots[5];
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        ElectroMagn *EMfields = ( *this )( ipatch )->EMfields;
+        dots_local[0] += EMfields->compute_r();
+        if( warm_start ) {
+            dots_local[1] += EMfields->dotPoisson( EMfields->p_, EMfields->r_ );
+            dots_local[2] += EMfields->compute_pAp();
+            dots_local[3] += EMfields->dotPoisson( EMfields->Ap_, EMfields->r_ );
+            dots_local[4] += EMfields->dotPoisson( EMfields->Ap_, EMfields->Ap_ );
+        }
+    }
+    MPI_Allreduce( dots_local, dots, warm_start ? 5 : 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+    double b_dot_b = dots[0];
+    double rnew_dot_rnew = b_dot_b;
+    if( warm_start ) {
+        double s = dots[2] != 0. ? dots[1] / dots[2] : 0.;
+        double r0_dot_r0 = b_dot_b - 2.*s*dots[3] + s*s*dots[4];
+        if( r0_dot_r0 < b_dot_b ) {
+            rnew_dot_rnew = r0_dot_r0;
+            MESSAGE( 1, "Warm start from the potential of the previous species, scaled by " << s
+                     << ": residual reduced by " << sqrt( r0_dot_r0 / b_dot_b ) );
+        } else {
+            s = 0.;
+        }
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->applyPoissonGuess( s );
+        }
+    }
 
     // compute control parameter
-    double norm2_source_term = sqrt( rnew_dot_rnew );
-    //double ctrl = rnew_dot_rnew / (double)(nx_p2_global);
-    double ctrl = sqrt( rnew_dot_rnew ) / norm2_source_term; // initially is equal to one
+    double norm2_source_term = sqrt( b_dot_b );
+    double ctrl = sqrt( rnew_dot_rnew ) / norm2_source_term; // initially is equal to one without warm start
+
+    // Multigrid preconditioner: the direction starts from z = M^-1 r
+    double rz = 0.;
+    if( params.poisson_multigrid ) {
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->initPoissonPreconditioner( gamma_mean );
+        }
+        double dots[3];
+        preconditionPoisson( smpi, dots );
+        rz = dots[1];
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->update_p_preconditioned( 0. ); // p = z
+        }
+    }
 
     // ---------------------------------------------------------
     // Starting iterative loop for the conjugate gradient method
@@ -2331,36 +2715,55 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
         SyncVectorPatch::finalizeExchangeAlongAllDirectionsNoOMP( listAp, *this );
 
 
-        // scalar product p.Ap
-        double p_dot_Ap       = 0.0;
-        double p_dot_Ap_local = 0.0;
+        // scalar product p.Ap, with r.Ap and Ap.Ap in the same reduction to update the residual norm (without preconditioner)
+        double dots_local[3] = { 0., 0., 0. }, dots[3];
         for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            p_dot_Ap_local += ( *this )( ipatch )->EMfields->compute_pAp();
+            ElectroMagn *EMfields = ( *this )( ipatch )->EMfields;
+            dots_local[0] += EMfields->compute_pAp();
+            if( ! params.poisson_multigrid ) {
+                dots_local[1] += EMfields->dotPoisson( EMfields->r_, EMfields->Ap_ );
+                dots_local[2] += EMfields->dotPoisson( EMfields->Ap_, EMfields->Ap_ );
+            }
         }
-        MPI_Allreduce( &p_dot_Ap_local, &p_dot_Ap, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        MPI_Allreduce( dots_local, dots, params.poisson_multigrid ? 1 : 3, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        double p_dot_Ap = dots[0];
 
 
         // compute new potential and residual
         for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_pand_r( r_dot_r, p_dot_Ap );
+            ( *this )( ipatch )->EMfields->update_pand_r( params.poisson_multigrid ? rz : r_dot_r, p_dot_Ap );
         }
 
-        // compute new residual norm
-        rnew_dot_rnew       = 0.0;
-        rnew_dot_rnew_local = 0.0;
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+        // compute new residual norm and new direction
+        if( params.poisson_multigrid ) {
+            // the residual norm is reduced with the products of the preconditioned residual
+            double pdots[3];
+            preconditionPoisson( smpi, pdots );
+            rnew_dot_rnew = pdots[0];
+            // flexible coefficient ( r_new-r ).z_new / r.z, as the single precision preconditioner is not exactly linear
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_p_preconditioned( -pdots[2]/p_dot_Ap );
+            }
+            rz = pdots[1];
+        } else {
+            // |r - alpha Ap|^2 from the products of the same reduction, computed again when it cancels or converges
+            double alpha_k = r_dot_r/p_dot_Ap;
+            rnew_dot_rnew = r_dot_r - 2.*alpha_k*dots[1] + alpha_k*alpha_k*dots[2];
+            if( rnew_dot_rnew < 1.e-4*r_dot_r || rnew_dot_rnew <= error_max*error_max*b_dot_b ) {
+                double rnew_dot_rnew_local = 0.0;
+                for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                    rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+                }
+                MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+            }
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
+            }
         }
-        MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
         if( smpi->isMaster() ) {
             DEBUG( "new residual norm: rnew_dot_rnew = " << rnew_dot_rnew );
         }
 
-        // compute new directio
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
-        }
-
         // compute control parameter
 
         ctrl = sqrt( rnew_dot_rnew )/norm2_source_term;
@@ -2395,6 +2798,10 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
     // compute E and sync
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
         // begin loop on patches
+        if( params.poisson_multigrid ) {
+            ( *this )( ipatch )->EMfields->deletePoissonPreconditioner();
+        }
+        ( *this )( ipatch )->EMfields->savePoissonSolution();
         ( *this )( ipatch )->EMfields->initE_relativistic_Poisson( ( *this )( ipatch ), gamma_mean );
     } // end loop on patches
 
@@ -2457,11 +2864,11 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
             Ey_XmaxYmin = ( *this )( patch_YminXmax-( this->refHindex_ ) )->EMfields->getEyrel_XmaxYmin();
         }
 
-        MPI_Bcast( &Ex_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, MPI_COMM_WORLD );
-        MPI_Bcast( &Ey_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, smpi->world() );
+        MPI_Bcast( &Ey_XminYmax, 1, MPI_DOUBLE, rank_XminYmax, smpi->world() );
 
-        MPI_Bcast( &Ex_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, MPI_COMM_WORLD );
-        MPI_Bcast( &Ey_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, smpi->world() );
+        MPI_Bcast( &Ey_XmaxYmin, 1, MPI_DOUBLE, rank_XmaxYmin, smpi->world() );
 
         //This correction is always done, independantly of the periodicity. Is this correct ?
         E_Add[0] = -0.5*( Ex_XminYmax+Ex_XmaxYmin );
@@ -2492,14 +2899,14 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
             //Ex_Xmin = (*Ex1D)(index_bc_min[0]);
             Ex_Xmin = ( *this )( ( 0 )-( this->refHindex_ ) )->EMfields->getExrel_Xmin();
         }
-        MPI_Bcast( &Ex_Xmin, 1, MPI_DOUBLE, rankXmin, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_Xmin, 1, MPI_DOUBLE, rankXmin, smpi->world() );
 
         unsigned int rankXmax = smpi->getSize()-1;
         if( smpi->getRank() == smpi->getSize()-1 ) {
             //Ex_Xmax = (*Ex1D)(index_bc_max[0]);
             Ex_Xmax = ( *this )( ( params.number_of_patches[0]-1 )-( this->refHindex_ ) )->EMfields->getExrel_Xmax();
         }
-        MPI_Bcast( &Ex_Xmax, 1, MPI_DOUBLE, rankXmax, MPI_COMM_WORLD );
+        MPI_Bcast( &Ex_Xmax, 1, MPI_DOUBLE, rankXmax, smpi->world() );
         E_Add[0] = -0.5*( Ex_Xmin+Ex_Xmax );
 
 #ifdef _3D_LIKE_CENTERING
@@ -2941,6 +3348,9 @@ void VectorPatch::solveRelativisticPoissonAM( Params &params, SmileiMPI *smpi, d
 void VectorPatch::loadBalance( Params &params, double time_dual, SmileiMPI *smpi, SimWindow *simWindow, unsigned int itime )
 {
 
+    // Patches are exchanged with their particles
+    simWindow->createPendingParticles( *this, params );
+
     // Compute new patch distribution
     smpi->recompute_patch_count( params, *this, time_dual );
 
@@ -2955,17 +3365,50 @@ void VectorPatch::loadBalance( Params &params, double time_dual, SmileiMPI *smpi
 
 }
 
-
 // ---------------------------------------------------------------------------------------------------------------------
-// Explicits patch movement regarding new patch distribution stored in smpi->patch_count
-//   - compute send_patch_id_
-//   - compute recv_patch_id_
-//   - create empty (not really, created like at t0) new patch in recv_patches_
+// Imbalance = max / mean of the computation times of the MPI processes since the last decision.
+// The time lost to the imbalance until the next decision is predicted equal to the one since the last decision,
+// max - mean, and the cost of a new load balancing equal to the last one.
 // ---------------------------------------------------------------------------------------------------------------------
-void VectorPatch::createPatches( Params &params, SmileiMPI *smpi, SimWindow *simWindow )
+bool VectorPatch::needsLoadBalancing( Params &params, SmileiMPI *smpi, Timers &timers )
 {
-    unsigned int n_moved( 0 );
-    recv_patches_.resize( 0 );
+    if( params.imbalance_threshold <= 0. ) {
+        return true;
+    }
+
+    double compute_time = timers.particles.getTime() + timers.maxwell.getTime() + timers.densities.getTime()
+                          + timers.collisions.getTime() + timers.envelope.getTime() + timers.particleMerging.getTime();
+    double times[2] = { compute_time - last_compute_time_, timers.loadBal.getTime() - last_balancing_time_ };
+    last_compute_time_ = compute_time;
+    last_balancing_time_ = timers.loadBal.getTime();
+
+    double max_times[2], sum_time;
+    MPI_Allreduce( times, max_times, 2, MPI_DOUBLE, MPI_MAX, smpi->world() );
+    MPI_Allreduce( times, &sum_time, 1, MPI_DOUBLE, MPI_SUM, smpi->world() );
+    if( max_times[1] > 0. ) {
+        balancing_cost_ = max_times[1];
+    }
+    double mean_time = sum_time / smpi->getSize();
+    load_imbalance_ = mean_time > 0. ? max_times[0] / mean_time : 1.;
+
+    if( load_imbalance_ > params.imbalance_threshold && max_times[0] - mean_time > balancing_cost_ ) {
+        return true;
+    }
+    load_balancing_skipped_++;
+    return false;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Explicits patch movement regarding new patch distribution stored in smpi->patch_count
+//   - compute send_patch_id_
+//   - compute recv_patch_id_
+//   - create empty (not really, created like at t0) new patch in recv_patches_
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::createPatches( Params &params, SmileiMPI *smpi, SimWindow *simWindow )
+{
+    unsigned int n_moved( 0 );
+    recv_patches_.resize( 0 );
 
     // Set Index of the 1st patch of the vector yet on current MPI rank
     // Is this really necessary ? It should be done already ...
@@ -3063,88 +3506,104 @@ void VectorPatch::exchangePatches( SmileiMPI *smpi, Params &params )
     int tag=0;
 
 
-    // Send particles
-    for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
-        // locate rank which will own send_patch_id_[ipatch]
-        // We assume patches are only exchanged with neighbours.
-        // Once all patches supposed to be sent to the left are done, we send the rest to the right.
-        // if hindex of patch to be sent      >  future hindex of the first patch owned by this process
-        if( send_patch_id_[ipatch]+refHindex_ > istart ) {
-            newMPIrank = smpi->getRank() + 1;
-            tag = tagsend_right*nrequests;
-            tagsend_right ++;
-        } else {
-            tag = tagsend_left*nrequests;
-            tagsend_left ++;
+    if( params.batched_exchange ) {
+        // Same destinations and sources as below, one message per neighbor MPI process and round
+        std::vector<Patch *> send_patches;
+        std::vector<int> send_ranks, recv_ranks;
+        for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
+            send_patches.push_back( ( *this )( send_patch_id_[ipatch] ) );
+            send_ranks.push_back( send_patch_id_[ipatch]+refHindex_ > istart ? smpi->getRank() + 1 : smpi->getRank() - 1 );
         }
-        int irequest = 0;
-        smpi->isend_species( ( *this )( send_patch_id_[ipatch] ), newMPIrank, irequest, tag, params );
-    }
+        for( unsigned int ipatch=0 ; ipatch < recv_patch_id_.size() ; ipatch++ ) {
+            recv_ranks.push_back( recv_patch_id_[ipatch] > refHindex_ ? smpi->getRank() + 1 : smpi->getRank() - 1 );
+        }
+        smpi->exchangePatchesBatched( send_patches, send_ranks, recv_patches_, recv_ranks, params );
+    } else {
 
-    for( unsigned int ipatch=0 ; ipatch < recv_patch_id_.size() ; ipatch++ ) {
-        //if  hindex of patch to be received > first hindex actually owned, that means it comes from the next MPI process and not from the previous anymore.
-        if( recv_patch_id_[ipatch] > refHindex_ ) {
-            oldMPIrank = smpi->getRank() + 1;
-            tag = tagrecv_right*nrequests;
-            tagrecv_right ++;
-        } else {
-            tag = tagrecv_left*nrequests;
-            tagrecv_left ++;
+        // Send particles
+        for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
+            // locate rank which will own send_patch_id_[ipatch]
+            // We assume patches are only exchanged with neighbours.
+            // Once all patches supposed to be sent to the left are done, we send the rest to the right.
+            // if hindex of patch to be sent      >  future hindex of the first patch owned by this process
+            if( send_patch_id_[ipatch]+refHindex_ > istart ) {
+                newMPIrank = smpi->getRank() + 1;
+                tag = tagsend_right*nrequests;
+                tagsend_right ++;
+            } else {
+                tag = tagsend_left*nrequests;
+                tagsend_left ++;
+            }
+            int irequest = 0;
+            smpi->isend_species( ( *this )( send_patch_id_[ipatch] ), newMPIrank, irequest, tag, params );
         }
-        smpi->recv_species( recv_patches_[ipatch], oldMPIrank, tag, params );
-    }
 
+        for( unsigned int ipatch=0 ; ipatch < recv_patch_id_.size() ; ipatch++ ) {
+            //if  hindex of patch to be received > first hindex actually owned, that means it comes from the next MPI process and not from the previous anymore.
+            if( recv_patch_id_[ipatch] > refHindex_ ) {
+                oldMPIrank = smpi->getRank() + 1;
+                tag = tagrecv_right*nrequests;
+                tagrecv_right ++;
+            } else {
+                tag = tagrecv_left*nrequests;
+                tagrecv_left ++;
+            }
+            smpi->recv_species( recv_patches_[ipatch], oldMPIrank, tag, params );
+        }
 
-    for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
-        smpi->waitall( ( *this )( send_patch_id_[ipatch] ) );
-    }
 
-    smpi->barrier();
+        for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
+            smpi->waitall( ( *this )( send_patch_id_[ipatch] ) );
+        }
 
+        smpi->barrier();
 
-    // Split the exchangePatches process to avoid deadlock with OpenMPI (observed with OpenMPI on Irene and Poicnare, not with IntelMPI)
-    newMPIrank = smpi->getRank() -1;
-    oldMPIrank = smpi->getRank() -1;
 
+        // Split the exchangePatches process to avoid deadlock with OpenMPI (observed with OpenMPI on Irene and Poicnare, not with IntelMPI)
+        newMPIrank = smpi->getRank() -1;
+        oldMPIrank = smpi->getRank() -1;
 
-    // Send fields
-    for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
-        // locate rank which will own send_patch_id_[ipatch]
-        // We assume patches are only exchanged with neighbours.
-        // Once all patches supposed to be sent to the left are done, we send the rest to the right.
-        // if hindex of patch to be sent      >  future hindex of the first patch owned by this process
-        if( send_patch_id_[ipatch]+refHindex_ > istart ) {
-            newMPIrank = smpi->getRank() + 1;
-            tag = tagsend_right;
-            tagsend_right ++;
-        } else {
-            tag = tagsend_left;
-            tagsend_left ++;
+
+        // Send fields
+        for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
+            // locate rank which will own send_patch_id_[ipatch]
+            // We assume patches are only exchanged with neighbours.
+            // Once all patches supposed to be sent to the left are done, we send the rest to the right.
+            // if hindex of patch to be sent      >  future hindex of the first patch owned by this process
+            if( send_patch_id_[ipatch]+refHindex_ > istart ) {
+                newMPIrank = smpi->getRank() + 1;
+                tag = tagsend_right;
+                tagsend_right ++;
+            } else {
+                tag = tagsend_left;
+                tagsend_left ++;
+            }
+            int irequest = 0;
+            smpi->isend_fields( ( *this )( send_patch_id_[ipatch] ), newMPIrank, irequest, tag*nrequests, params );
         }
-        int irequest = 0;
-        smpi->isend_fields( ( *this )( send_patch_id_[ipatch] ), newMPIrank, irequest, tag*nrequests, params );
-    }
 
-    for( unsigned int ipatch=0 ; ipatch < recv_patch_id_.size() ; ipatch++ ) {
-        //if  hindex of patch to be received > first hindex actually owned, that means it comes from the next MPI process and not from the previous anymore.
-        if( recv_patch_id_[ipatch] > refHindex_ ) {
-            oldMPIrank = smpi->getRank() + 1;
-            tag = tagrecv_right;
-            tagrecv_right ++;
-        } else {
-            tag = tagrecv_left;
-            tagrecv_left ++;
+        for( unsigned int ipatch=0 ; ipatch < recv_patch_id_.size() ; ipatch++ ) {
+            //if  hindex of patch to be received > first hindex actually owned, that means it comes from the next MPI process and not from the previous anymore.
+            if( recv_patch_id_[ipatch] > refHindex_ ) {
+                oldMPIrank = smpi->getRank() + 1;
+                tag = tagrecv_right;
+                tagrecv_right ++;
+            } else {
+                tag = tagrecv_left;
+                tagrecv_left ++;
+            }
+            int patch_tag = tag * nrequests;
+            smpi->recv_fields( recv_patches_[ipatch], oldMPIrank, patch_tag, params );
         }
-        int patch_tag = tag * nrequests;
-        smpi->recv_fields( recv_patches_[ipatch], oldMPIrank, patch_tag, params );
-    }
 
 
-    for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
-        smpi->waitall( ( *this )( send_patch_id_[ipatch] ) );
-    }
+        for( unsigned int ipatch=0 ; ipatch < send_patch_id_.size() ; ipatch++ ) {
+            smpi->waitall( ( *this )( send_patch_id_[ipatch] ) );
+        }
+
+        smpi->barrier();
 
-    smpi->barrier();
+    }
 
 
     //Delete sent patches
@@ -3205,9 +3664,49 @@ void VectorPatch::exchangePatches( SmileiMPI *smpi, Params &params )
     }
     this->setRefHindex() ;
     updateFieldList( smpi ) ;
+    smpi->updateHaloComms( *this );
+    if( params.fields_arena ) {
+        buildFieldsArena();
+    }
 
 } // END exchangePatches
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Arena of the fields (Main.fields_arena): the data of the fields of all the patches is copied in a single array,
+// patch after patch in the order of the Hilbert curve, so that neighbor patches are neighbors in memory.
+// It is rebuilt when the patches are created or exchanged by the load balancing. The fields of the patches brought by
+// the moving window, and the densities per species allocated for the diagnostics, stay outside until the next rebuild.
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::buildFieldsArena()
+{
+    std::vector<Field *> fields;
+    size_t arena_size = 0;
+    for( unsigned int ipatch=0 ; ipatch<patches_.size() ; ipatch++ ) {
+        ElectroMagn *EMfields = ( *this )( ipatch )->EMfields;
+        std::vector<Field *> patch_fields = EMfields->allFields;
+        patch_fields.insert( patch_fields.end(), EMfields->averaged_fields_.begin(), EMfields->averaged_fields_.end() );
+        patch_fields.insert( patch_fields.end(), EMfields->subcycled_currents_.begin(), EMfields->subcycled_currents_.end() );
+        for( unsigned int idiag=0 ; idiag<EMfields->allFields_avg.size() ; idiag++ ) {
+            patch_fields.insert( patch_fields.end(), EMfields->allFields_avg[idiag].begin(), EMfields->allFields_avg[idiag].end() );
+        }
+        for( unsigned int ifield=0 ; ifield<patch_fields.size() ; ifield++ ) {
+            if( patch_fields[ifield] && patch_fields[ifield]->data_ ) {
+                fields.push_back( patch_fields[ifield] );
+                arena_size += patch_fields[ifield]->number_of_points_;
+            }
+        }
+    }
+
+    // The previous arena is freed once all the fields have moved
+    std::vector<double> arena( arena_size );
+    size_t offset = 0;
+    for( unsigned int ifield=0 ; ifield<fields.size() ; ifield++ ) {
+        fields[ifield]->moveDataTo( &arena[offset] );
+        offset += fields[ifield]->number_of_points_;
+    }
+    fields_arena_.swap( arena );
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Write in a file patches communications
 //   - Send/Recv MPI rank
@@ -3588,8 +4087,8 @@ void VectorPatch::updateFieldList( SmileiMPI *smpi )
                 listBz_[ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 8 );
                 listrho_[ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 4 );
                 if (smpi->use_BTIS3){
-                    listBy_mBTIS3[ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
-                    listBz_mBTIS3[ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
+                    listBy_mBTIS3[ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 5 );
+                    listBz_mBTIS3[ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 9 );
                 }
             }
             if( patches_[0]->EMfields->envelope != NULL ) {
@@ -3618,16 +4117,17 @@ void VectorPatch::updateFieldList( SmileiMPI *smpi )
                     listJl_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
                     listJr_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
                     listJt_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
-                    listBl_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
-                    listBr_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
-                    listBt_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
+                    // Same tags as in Patch::initExchangeComplex
+                    listBl_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 6 );
+                    listBr_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 7 );
+                    listBt_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 8 );
                     if (smpi->use_BTIS3){
-                        listBr_mBTIS3[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
-                        listBt_mBTIS3[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
+                        listBr_mBTIS3[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 4 );
+                        listBt_mBTIS3[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 5 );
                     }
-                    listEl_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
-                    listEr_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
-                    listEt_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
+                    listEl_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 1 );
+                    listEr_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 2 );
+                    listEt_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 3 );
                     listrho_AM_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
                     if (static_cast<ElectroMagnAM *>( patches_[ipatch]->EMfields )->rho_old_AM_[imode])
                         listrho_old_AM_[imode][ipatch]->MPIbuff.defineTags( patches_[ipatch], smpi, 0 );
@@ -4047,10 +4547,11 @@ void VectorPatch::applyBinaryProcesses( Params &params, int itime, Timers &timer
 {
     timers.collisions.restart();
 
-    if( BinaryProcesses::debye_length_required_ ) {
+    // On GPU, the Debye length is calculated with the collisions, in each GPU bin
+    if( BinaryProcesses::debye_length_required_ && ! params.gpu_computing ) {
         #pragma omp for schedule(runtime)
         for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
-            BinaryProcesses::calculate_debye_length( params, patches_[ipatch] );
+            BinaryProcesses::calculate_debye_length( params, patches_[ipatch], itime );
         }
     }
 
@@ -4109,6 +4610,28 @@ void VectorPatch::allocateField( unsigned int ifield, Params &params )
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// The currents and densities of species are allocated only on the iterations when a diagnostic needs them
+// On GPU, they stay allocated as they are mapped on the device
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::manageRhoJs( Params &params )
+{
+    if( params.geometry == "AMcylindrical" ) {
+        return;
+    }
+    #pragma omp for schedule(static)
+    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+        if( diag_flag ) {
+            emfields( ipatch )->allocateRhoJs( params.is_pxr );
+        }
+#if !defined( SMILEI_ACCELERATOR_GPU )
+        else {
+            emfields( ipatch )->deallocateRhoJs();
+        }
+#endif
+    }
+}
+
 
 // For each patch, apply external fields
 void VectorPatch::applyExternalFields()
@@ -4122,9 +4645,12 @@ void VectorPatch::applyExternalFields()
 // For each patch, apply external fields
 void VectorPatch::applyPrescribedFields(double time)
 {
+    SMILEI_PY_SAVE_MASTER_THREAD
+    #pragma omp for schedule(dynamic)
     for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
         patches_[ipatch]->EMfields->applyPrescribedFields( ( *this )( ipatch ), time );
     }
+    SMILEI_PY_RESTORE_MASTER_THREAD
 }
 
 //! Method use to reset the real value of all fields on which we imposed an external time field
@@ -4191,6 +4717,17 @@ void VectorPatch::checkMemoryConsumption( SmileiMPI *smpi, VectorPatch *region_v
         MESSAGE( m );
     }
 
+    // Fields of the PML
+    long int pmlMem = getPMLMemory();
+    if( pmlMem > 0 ) {
+        m = combineMemoryConsumption( smpi, pmlMem, "PML" );
+        MESSAGE( m );
+    }
+
+    // MPI buffers of the exchanges (they grow during the simulation)
+    m = combineMemoryConsumption( smpi, getMPIBuffersMemory(), "MPI buffers" );
+    MESSAGE( m );
+
     // Diags memory
     vector<Diagnostic*> allDiags( 0 );
     allDiags.insert( allDiags.end(), globalDiags.begin(), globalDiags.end() );
@@ -4206,6 +4743,60 @@ void VectorPatch::checkMemoryConsumption( SmileiMPI *smpi, VectorPatch *region_v
 }
 
 
+std::size_t VectorPatch::getFieldsMemory()
+{
+    std::size_t mem = 0;
+    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+        mem += patches_[ipatch]->EMfields->getMemFootPrint();
+    }
+    return mem;
+}
+
+
+std::size_t VectorPatch::getPMLMemory()
+{
+    std::size_t mem = 0;
+    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+        for( unsigned int ibc=0 ; ibc<patches_[ipatch]->EMfields->emBoundCond.size() ; ibc++ ) {
+            if( patches_[ipatch]->EMfields->emBoundCond[ibc] ) {
+                mem += patches_[ipatch]->EMfields->emBoundCond[ibc]->getMemFootPrint();
+            }
+        }
+    }
+    return mem;
+}
+
+
+std::size_t VectorPatch::getDiagnosticsMemory()
+{
+    std::size_t mem = 0;
+    for( unsigned int idiag=0 ; idiag<globalDiags.size() ; idiag++ ) {
+        mem += globalDiags[idiag]->getMemFootPrint();
+    }
+    for( unsigned int idiag=0 ; idiag<localDiags.size() ; idiag++ ) {
+        mem += localDiags[idiag]->getMemFootPrint();
+    }
+    return mem;
+}
+
+
+std::size_t VectorPatch::getMPIBuffersMemory()
+{
+    std::size_t mem = 0;
+    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+        for( unsigned int ifield=0 ; ifield<patches_[ipatch]->EMfields->allFields.size() ; ifield++ ) {
+            if( patches_[ipatch]->EMfields->allFields[ifield] ) {
+                mem += patches_[ipatch]->EMfields->allFields[ifield]->MPIbuff.getMemFootPrint();
+            }
+        }
+        for( unsigned int ispec=0 ; ispec<patches_[ipatch]->vecSpecies.size() ; ispec++ ) {
+            mem += patches_[ipatch]->vecSpecies[ispec]->MPI_buffer_.getMemFootPrint();
+        }
+    }
+    return mem;
+}
+
+
 void VectorPatch::saveOldRho( Params &params )
 {
 
@@ -4498,11 +5089,6 @@ void VectorPatch::ponderomotiveUpdateSusceptibilityAndMomentum( Params &params,
     } // end ipatch
 #endif
 
-#  ifdef _PARTEVENTTRACING
-    bool diag_PartEventTracing = smpi->diagPartEventTracing( time_dual, params.timestep);
-    if (diag_PartEventTracing) smpi->reference_time_ = MPI_Wtime();
-#  endif
-
 
     #pragma omp single
     diag_flag = needsRhoJsNow( itime );
@@ -4536,15 +5122,10 @@ void VectorPatch::ponderomotiveUpdatePositionAndCurrents( Params &params,
 
     #pragma omp single
     diag_flag = needsRhoJsNow( itime );
+    manageRhoJs( params );
 
     timers.particles.restart();
 
-#ifdef _PARTEVENTTRACING
-    bool diag_PartEventTracing {false};
-    diag_PartEventTracing = smpi->diagPartEventTracing( time_dual, params.timestep);
-    // if (diag_PartEventTracing) smpi->reference_time_ = MPI_Wtime();
-#endif
-
 #ifdef _OMPTASKS
     #pragma omp single
     {
@@ -4563,18 +5144,6 @@ void VectorPatch::ponderomotiveUpdatePositionAndCurrents( Params &params,
                           time_dual, timers, itime );
 #endif
 
-// Write Task tracing output files
-#ifdef _PARTEVENTTRACING
-    #ifdef _OMPTASKS
-    #pragma omp taskwait
-    #endif
-    #pragma omp single
-    {
-        int iteration = int((time_dual-0.5*params.timestep)/params.timestep);
-        if(diag_PartEventTracing) writeParticleEventTracingOutput(params, smpi, iteration);
-    } // end single
-#endif
-
     timers.particles.update( params.printNow( itime ) );
 #ifdef __DETAILED_TIMERS
     timers.interp_env_old.update( *this, params.printNow( itime ) );
@@ -4949,7 +5518,7 @@ void VectorPatch::dynamicsWithoutTasks( Params &params,
                             SimWindow *simWindow,
                             RadiationTables &RadiationTables,
                             MultiphotonBreitWheelerTables &MultiphotonBreitWheelerTables,
-                            double time_dual, Timers &/*timers*/, int /*itime*/ )
+                            double time_dual, Timers &/*timers*/, int itime )
 {
 
 #ifdef _PARTEVENTTRACING
@@ -4957,66 +5526,314 @@ void VectorPatch::dynamicsWithoutTasks( Params &params,
     diag_PartEventTracing = smpi->diagPartEventTracing( time_dual, params.timestep);
 #endif
 
-    SMILEI_PY_SAVE_MASTER_THREAD
-    #pragma omp for schedule(runtime)
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->restartRhoJ();
-            for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
-                Species *spec = species( ipatch, ispec );
+    // Iteration of the push of the sub-cycled species (Species.push_every > 1)
+    const bool push_subcycled = ( params.species_push_every > 1 ) && ( itime % params.species_push_every == 0 );
 
-                if( params.keep_position_old ) {
-                    spec->particles->savePositions();
-                }
+    // Iteration where the wall time of the particle operators is sampled (DiagPerformances.operator_sampling_every)
+    const bool sample_operators = ( params.operator_sampling_every > 0 ) && ( itime % params.operator_sampling_every == 0 );
 
-                if( params.Laser_Envelope_model ) {
-                    continue;
+    // Dynamics of all the species of one patch
+    auto patchDynamics = [&]( unsigned int ipatch ) {
+        // Wall time of the patch, used as its load by the load balancing
+        double load_timer = 0.;
+        if( params.measured_load_steps > 0 ) {
+            ( *this )( ipatch )->averageLoadTime( params.measured_load_steps );
+            load_timer = MPI_Wtime();
+        }
+
+        if( sample_operators ) {
+            ( *this )( ipatch )->sampled_operator_times_.resize( ( *this )( ipatch )->vecSpecies.size() * Patch::sampled_operators_count, 0. );
+            ( *this )( ipatch )->operator_samples_++;
+            ( *this )( ipatch )->operator_sampling_ = true;
+        }
+
+        ( *this )( ipatch )->EMfields->restartRhoJ();
+
+        // Fields averaged since the last push of the sub-cycled species
+        if( params.species_push_every > 1 ) {
+            emfields( ipatch )->accumulateAveragedFields( push_subcycled );
+        }
+        if( push_subcycled ) {
+            emfields( ipatch )->resetSubcycledCurrents();
+        }
+
+        // Species without particles have nothing to interpolate, push nor project:
+        // their current and charge densities stay zero (on GPU, the counts are not known on the host)
+        ( *this )( ipatch )->vacuum_ = !params.gpu_computing;
+
+        for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+            Species *spec = species( ipatch, ispec );
+
+            if( !params.gpu_computing && spec->getNbrOfParticles() == 0 ) {
+                continue;
+            }
+            ( *this )( ipatch )->vacuum_ = false;
+            ( *this )( ipatch )->sampled_species_ = ispec;
+
+            if( params.keep_position_old ) {
+                spec->particles->savePositions();
+            }
+
+            if( params.Laser_Envelope_model ) {
+                continue;
+            }
+
+            // Sub-cycled species between two pushes: the particles do not move,
+            // only their charge density is needed by the diagnostics
+            if( !spec->isPushIteration( time_dual ) ) {
+                if( diag_flag && !spec->particles->is_test ) {
+                    double *b_rho = emfields( ipatch )->rho_s[ispec] ? &( *emfields( ipatch )->rho_s[ispec] )( 0 ) : &( *emfields( ipatch )->rho_ )( 0 );
+                    spec->projectFrozenCharge( b_rho, emfields( ipatch )->rho_->size() );
                 }
+                continue;
+            }
 
-                if( spec->isProj( time_dual, simWindow ) || diag_flag ) {
+            // Sub-cycled species at their push: interpolate the averaged fields, and deposit
+            // their current, charge-conserving over push_every iterations, in their own arrays
+            const bool averaged_fields = spec->push_every_ > 1;
+            if( averaged_fields ) {
+                emfields( ipatch )->swapAveragedFields();
+                emfields( ipatch )->swapSubcycledCurrents( ispec, diag_flag );
+            }
+
+            if( spec->isProj( time_dual, simWindow ) || diag_flag ) {
 
 #if defined( SMILEI_ACCELERATOR_GPU )
-                    if (diag_flag) {
-                        spec->Species::prepareSpeciesCurrentAndChargeOnDevice(
-                            ispec,
-                            emfields( ipatch )
-                        );
-                    }
+                if (diag_flag) {
+                    spec->Species::prepareSpeciesCurrentAndChargeOnDevice(
+                        ispec,
+                        emfields( ipatch )
+                    );
+                }
 #endif
 
-                    // Dynamics with vectorized operators
-                    if( spec->vectorized_operators ) {
-                        spec->dynamics( time_dual, ispec,
-                                        emfields( ipatch ),
-                                        params, diag_flag, partwalls( ipatch ),
-                                        ( *this )( ipatch ), smpi,
-                                        RadiationTables,
-                                        MultiphotonBreitWheelerTables );
-                    }
-                    // Dynamics with scalar operators
-                    else {
-                        if( params.vectorization_mode == "adaptive" ) {
-                            spec->scalarDynamics( time_dual, ispec,
-                                                   emfields( ipatch ),
-                                                   params, diag_flag, partwalls( ipatch ),
-                                                   ( *this )( ipatch ), smpi,
-                                                   RadiationTables,
-                                                   MultiphotonBreitWheelerTables );
-                        } else {
-                            spec->Species::dynamics( time_dual, ispec,
-                                                     emfields( ipatch ),
-                                                     params, diag_flag, partwalls( ipatch ),
-                                                     ( *this )( ipatch ), smpi,
-                                                     RadiationTables,
-                                                     MultiphotonBreitWheelerTables );
+                // Dynamics with vectorized operators
+                if( spec->vectorized_operators ) {
+                    spec->dynamics( time_dual, ispec,
+                                    emfields( ipatch ),
+                                    params, diag_flag, partwalls( ipatch ),
+                                    ( *this )( ipatch ), smpi,
+                                    RadiationTables,
+                                    MultiphotonBreitWheelerTables );
+                }
+                // Dynamics with scalar operators
+                else {
+                    if( params.vectorization_mode == "adaptive" ) {
+                        spec->scalarDynamics( time_dual, ispec,
+                                               emfields( ipatch ),
+                                               params, diag_flag, partwalls( ipatch ),
+                                               ( *this )( ipatch ), smpi,
+                                               RadiationTables,
+                                               MultiphotonBreitWheelerTables );
+                    } else {
+                        // The dynamics time per particle drives the adaptive sorting
+                        const double timer = params.adaptive_sorting ? MPI_Wtime() : 0.;
+                        spec->Species::dynamics( time_dual, ispec,
+                                                 emfields( ipatch ),
+                                                 params, diag_flag, partwalls( ipatch ),
+                                                 ( *this )( ipatch ), smpi,
+                                                 RadiationTables,
+                                                 MultiphotonBreitWheelerTables );
+                        if( params.adaptive_sorting && spec->getNbrOfParticles() > 0 ) {
+                            spec->dynamics_time_ = ( MPI_Wtime() - timer ) / spec->getNbrOfParticles();
                         }
-                    } // end if condition on vectorization
-                } // end if condition on species
-            } // end loop on species
-            //MESSAGE("species dynamics");
-        } // end loop on patches
+                    }
+                } // end if condition on vectorization
+            } // end if condition on species
+
+            if( averaged_fields ) {
+                emfields( ipatch )->swapAveragedFields();
+                emfields( ipatch )->swapSubcycledCurrents( ispec, diag_flag );
+                emfields( ipatch )->scaleSubcycledCurrents( ispec );
+                // The charge density cached between two pushes is outdated
+                spec->frozen_rho_particles_ = -1;
+            }
+        } // end loop on species
+
+        if( push_subcycled ) {
+            emfields( ipatch )->resetAveragedFields();
+        }
+
+        // The current of the sub-cycled species is spread over the iterations until their next push:
+        // it may come from particles which have left the patch since
+        if( ! emfields( ipatch )->subcycled_currents_.empty() ) {
+            emfields( ipatch )->addSubcycledCurrents( diag_flag );
+            ( *this )( ipatch )->vacuum_ = false;
+        }
+
+        ( *this )( ipatch )->operator_sampling_ = false;
+
+        if( params.measured_load_steps > 0 ) {
+            ( *this )( ipatch )->load_time_ += MPI_Wtime() - load_timer;
+        }
+
+        // The currents of the patch are complete: its messages along X can be sent
+        if( currentSumsEarly_ ) {
+            SyncVectorPatch::postSumRhoJEarly( ipatch, *this, smpi );
+        }
+    };
+
+    SMILEI_PY_SAVE_MASTER_THREAD
+    if( currentSumsEarly_ ) {
+        SyncVectorPatch::initSumRhoJEarly( *this, smpi );
+    }
+    if( params.dynamics_scheduling == "largest_first" ) {
+        // Patches sorted by decreasing cost, distributed on demand to the threads
+        orderPatchesByCost( time_dual, simWindow );
+        if( currentSumsEarly_ ) {
+            orderBoundaryPatchesFirst();
+        }
+        #pragma omp for schedule(dynamic,1)
+        for( unsigned int iorder=0 ; iorder<this->size() ; iorder++ ) {
+            patchDynamics( dynamics_order_[iorder] );
+        }
+    } else if( params.dynamics_scheduling == "numa_affinity" ) {
+        numaAffinityDynamics( params, patchDynamics );
+    } else if( currentSumsEarly_ ) {
+        // The patches with MPI neighbors along X first, for their messages to be sent as early as possible
+        #pragma omp single
+        {
+            dynamics_order_.resize( this->size() );
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                dynamics_order_[ipatch] = ipatch;
+            }
+        }
+        orderBoundaryPatchesFirst();
+        #pragma omp for schedule(runtime)
+        for( unsigned int iorder=0 ; iorder<this->size() ; iorder++ ) {
+            patchDynamics( dynamics_order_[iorder] );
+        }
+    } else {
+        #pragma omp for schedule(runtime)
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            patchDynamics( ipatch );
+        }
+    }
     SMILEI_PY_RESTORE_MASTER_THREAD
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Sort the patches by decreasing estimated cost of their dynamics (longest processing time first).
+// The cost of a species is its particle load, which accounts for the cost model of the adaptive vectorization.
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::orderPatchesByCost( double time_dual, SimWindow *simWindow )
+{
+    #pragma omp single
+    {
+        dynamics_cost_.resize( this->size() );
+        dynamics_order_.resize( this->size() );
+    }
+
+    #pragma omp for schedule(runtime)
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        double cost = 0.;
+        for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+            Species *spec = species( ipatch, ispec );
+            if( spec->isProj( time_dual, simWindow ) || diag_flag ) {
+                cost += spec->getParticleLoad();
+            }
+        }
+        dynamics_cost_[ipatch] = cost;
+        dynamics_order_[ipatch] = ipatch;
+    }
+
+    #pragma omp single
+    std::stable_sort( dynamics_order_.begin(), dynamics_order_.end(),
+        [this]( unsigned int i1, unsigned int i2 ) {
+            return dynamics_cost_[i1] > dynamics_cost_[i2];
+        } );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Dynamics with the patches bound to the NUMA domains of the threads (Main.dynamics_scheduling = "numa_affinity").
+// The threads are assumed bound close to each other (OMP_PROC_BIND=close): the thread ithread belongs to the domain
+// ithread*numa_domains/nthreads. Each domain gets a contiguous block of patches, in proportion to its threads, that its
+// threads take one by one. The first thread of a domain to process a patch copies its fields and particles, which are
+// then placed on the memory of the domain. A thread done with its domain only takes the patches of the domain with
+// the most patches left, when they exceed its number of threads: the memory of these patches is then remote.
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::numaAffinityDynamics( Params &params, const std::function<void( unsigned int )> &patchDynamics )
+{
+#ifdef _OPENMP
+    const unsigned int nthreads = omp_get_num_threads();
+    const unsigned int ithread = omp_get_thread_num();
+#else
+    const unsigned int nthreads = 1;
+    const unsigned int ithread = 0;
+#endif
+    const unsigned int ndomains = std::min( params.numa_domains, nthreads );
+    const unsigned int idomain = ( ithread * ndomains ) / nthreads;
+    // First thread of the domain d (ndomains: number of threads)
+    auto firstThread = [&]( unsigned int d ) {
+        return ( d * nthreads + ndomains - 1 ) / ndomains;
+    };
+
+    #pragma omp single
+    {
+        numa_first_patch_.resize( ndomains+1 );
+        numa_next_patch_.resize( ndomains );
+        for( unsigned int d=0 ; d<=ndomains ; d++ ) {
+            numa_first_patch_[d] = ( firstThread( d ) * this->size() ) / nthreads;
+        }
+        dynamics_order_.resize( this->size() );
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            dynamics_order_[ipatch] = ipatch;
+        }
+        for( unsigned int d=0 ; d<ndomains ; d++ ) {
+            numa_next_patch_[d] = numa_first_patch_[d];
+            // The patches with MPI neighbors along X first in each domain, for their messages to be sent early
+            if( currentSumsEarly_ ) {
+                std::stable_partition( dynamics_order_.begin()+numa_first_patch_[d], dynamics_order_.begin()+numa_first_patch_[d+1],
+                    [this]( unsigned int ipatch ) {
+                        return !currentSumMessages_[ipatch].empty();
+                    } );
+            }
+        }
+    }
+
+    unsigned int jdomain = idomain;
+    while( jdomain < ndomains ) {
+        unsigned int iorder;
+        #pragma omp atomic capture
+        iorder = numa_next_patch_[jdomain]++;
+
+        if( iorder < numa_first_patch_[jdomain+1] ) {
+            const unsigned int ipatch = dynamics_order_[iorder];
+            if( jdomain == idomain && ( *this )( ipatch )->numa_domain_ != ( int )idomain ) {
+                ( *this )( ipatch )->relocateData( params );
+                ( *this )( ipatch )->numa_domain_ = idomain;
+            }
+            patchDynamics( ipatch );
+            continue;
+        }
+
+        // No patch left in this domain: look for the domain with the most patches left per thread
+        jdomain = ndomains;
+        unsigned int largest_excess = 0;
+        for( unsigned int d=0 ; d<ndomains ; d++ ) {
+            unsigned int next;
+            #pragma omp atomic read
+            next = numa_next_patch_[d];
+            const unsigned int left = next < numa_first_patch_[d+1] ? numa_first_patch_[d+1] - next : 0;
+            const unsigned int domain_threads = firstThread( d+1 ) - firstThread( d );
+            if( left > domain_threads && left - domain_threads > largest_excess ) {
+                largest_excess = left - domain_threads;
+                jdomain = d;
+            }
+        }
+    }
+    #pragma omp barrier
+}
+
+void VectorPatch::orderBoundaryPatchesFirst()
+{
+    #pragma omp single
+    std::stable_partition( dynamics_order_.begin(), dynamics_order_.end(),
+        [this]( unsigned int ipatch ) {
+            return !currentSumMessages_[ipatch].empty();
+        } );
+}
+
 void VectorPatch::ponderomotiveUpdateSusceptibilityAndMomentumWithoutTasks( Params &params,
         SmileiMPI *smpi,
         SimWindow *simWindow,
@@ -5033,6 +5850,10 @@ void VectorPatch::ponderomotiveUpdateSusceptibilityAndMomentumWithoutTasks( Para
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
         ( *this )( ipatch )->EMfields->restartEnvChi();
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+            // Species without particles project no susceptibility (on GPU, the counts are not known on the host)
+            if( !params.gpu_computing && species( ipatch, ispec )->getNbrOfParticles() == 0 ) {
+                continue;
+            }
             if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
                 if( ( *this )( ipatch )->vecSpecies[ispec]->vectorized_operators )
                     species( ipatch, ispec )->ponderomotiveUpdateSusceptibilityAndMomentum( time_dual, 
@@ -5074,6 +5895,10 @@ void VectorPatch::ponderomotiveUpdatePositionAndCurrentsWithoutTasks( Params &pa
     #pragma omp for schedule(runtime)
         for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
             for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+                // Species without particles have nothing to push nor project
+                if( !params.gpu_computing && species( ipatch, ispec )->getNbrOfParticles() == 0 ) {
+                    continue;
+                }
                 if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
                     if( ( *this )( ipatch )->vecSpecies[ispec]->vectorized_operators ){
                         species( ipatch, ispec )->ponderomotiveUpdatePositionAndCurrents( time_dual, ispec,
@@ -5123,9 +5948,27 @@ void VectorPatch::dynamicsWithTasks( Params &params,
 
     if (!params.Laser_Envelope_model)
     {
+    // The messages of the early current sums are prepared by all the threads
+    if( currentSumsEarly_ ) {
+        SyncVectorPatch::initSumRhoJEarly( *this, smpi );
+    }
     #pragma omp single
     {
+    // With early current sums, the patches with MPI neighbors along X are created first
+    // and their messages are sent by a task as soon as their densities are reduced
+    dynamics_order_.resize( this->size() );
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        dynamics_order_[ipatch] = ipatch;
+    }
+    if( currentSumsEarly_ ) {
+        std::stable_partition( dynamics_order_.begin(), dynamics_order_.end(),
+            [this]( unsigned int ipatch ) {
+                return !currentSumMessages_[ipatch].empty();
+            } );
+    }
+
+    for( unsigned int iorder=0 ; iorder<this->size() ; iorder++ ) {
+        const unsigned int ipatch = dynamics_order_[iorder];
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             Species *spec = species( ipatch, ispec );
 
@@ -5318,6 +6161,12 @@ void VectorPatch::dynamicsWithTasks( Params &params,
         } // end if condition on species
         } // end loop on species
 
+        // The currents of the patch are complete after the reductions of all its species
+        if( currentSumsEarly_ && !currentSumMessages_[ipatch].empty() ) {
+            #pragma omp task default(shared) firstprivate(ipatch) depend(in:has_reduced_densities[ipatch])
+            SyncVectorPatch::postSumRhoJEarly( ipatch, *this, smpi );
+        }
+
     } // end loop on patches
 
     } // end omp single
@@ -2,9 +2,11 @@
 #define VECTORPATCH_H
 
 #include <vector>
+#include <map>
 #include <iostream>
 #include <cstdlib>
 #include <iomanip>
+#include <functional>
 
 #include "InterpolatorFactory.h"
 #include "ProjectorFactory.h"
@@ -103,29 +105,6 @@ public :
         return false;
     }
 
-#  ifdef _PARTEVENTTRACING  
-    // Write Output for Particle Event Tracing diagnostic - this method must be called inside a pragma omp single construct
-    void writeParticleEventTracingOutput(Params &params, SmileiMPI *smpi, int iteration){
-        int rank(0);
-        MPI_Comm_rank( MPI_COMM_WORLD, &rank );
-        for (int ithread=0; ithread<omp_get_max_threads(); ithread++){ // write a file for eacht thread
-            std::ofstream outfile;
-            std::string namefile = "particle_event_tracing_rank_"+std::to_string(rank)+"_thread_"+std::to_string(ithread)+".txt";
-            outfile.open(namefile, std::ios_base::app); // append to file
-            outfile << "Start Iteration "<<std::to_string(iteration)<<"\n";
-            for (int event_id = 0; event_id<smpi->particle_event_tracing_event_time_[ithread].size();event_id++){
-                // Write line in file with structure Time Start/End EventName
-                outfile<<std::to_string((smpi->particle_event_tracing_event_time_[ithread][event_id]))<<" "
-                       <<(smpi->particle_event_tracing_start_or_end_[ithread][event_id])<<" "
-                       <<(smpi->particle_event_tracing_event_name_[ithread][event_id])<<" \n" ;
-            } // end loop on traced events
-        outfile << "End Iteration "<<std::to_string(iteration)<<"\n";
-        smpi->particle_event_tracing_event_time_[ithread].clear();
-        smpi->particle_event_tracing_start_or_end_[ithread].clear();
-        smpi->particle_event_tracing_event_name_[ithread].clear();
-        } // end loop on threads
-    } // end writeParticleEventTracingOutput
-#endif
     // Interfaces between main programs & main PIC operators
     // -----------------------------------------------------
     
@@ -134,6 +113,9 @@ public :
     
     //! Reconfigure all patches for the new time step
     void reconfiguration( Params &params, Timers &timers, int itime );
+
+    //! Reseed the random generators of the patches for the iteration itime (Main.counter_based_random)
+    void reseedRandom( Params &params, unsigned int itime );
     
     //! Particle sorting for all patches. This is done at initialization time.
     void initialParticleSorting( Params &params );
@@ -167,6 +149,9 @@ public :
     //! Particle merging
     void mergeParticles( Params &params, double time_dual, Timers &timers, int itime );
 
+    //! Particle splitting
+    void splitParticles( Params &params, double time_dual, Timers &timers, int itime );
+
     //! Clean MPI buffers and resize particle arrays to save memory
     void cleanParticlesOverhead(Params &params, Timers &timers, int itime );
                               
@@ -174,7 +159,7 @@ public :
     void injectParticlesFromBoundaries( Params &params, Timers &timers, unsigned int itime );
                                       
     //! Computation of the total charge
-    void computeCharge(bool old = false);
+    void computeCharge( double time_dual, bool old = false );
     
     void projectionForDiags( Params &params,
                                SmileiMPI *smpi,
@@ -238,6 +223,8 @@ public :
         SimWindow *simWindow );
         
     void runAllDiagsTasks( Params &params, SmileiMPI *smpi, unsigned int itime, Timers &timers, SimWindow *simWindow );
+    //! Waits for the asynchronous fields diags if another diag writes an HDF5 file at this iteration
+    void waitAsynchronousFieldsWrites( unsigned int itime );
     void rebootDiagTimers();
     void initAllDiags( Params &params, SmileiMPI *smpi );
     void closeAllDiags( SmileiMPI *smpi );
@@ -249,6 +236,8 @@ public :
     void solvePoisson( Params &params, SmileiMPI *smpi );
     void runNonRelativisticPoissonModule( Params &params, SmileiMPI* smpi,  Timers &timers );
     void solvePoissonAM( Params &params, SmileiMPI *smpi);
+    //! Multigrid preconditioning of the residual of the Poisson solvers, dots = { r.r, r.z, z.Ap } (one reduction)
+    void preconditionPoisson( SmileiMPI *smpi, double dots[3] );
     
     //! Solve relativistic Poisson problem to initialize E and B of a relativistic bunch
     void runRelativisticModule( double time_prim, Params &params, SmileiMPI* smpi,  Timers &timers );
@@ -266,6 +255,8 @@ public :
     
     //! For all patches, allocate a field if not allocated
     void allocateField( unsigned int ifield, Params &params );
+    //! Allocate the currents and densities of species if diag_flag, free them otherwise
+    void manageRhoJs( Params &params );
     
     //! For each patch, apply external fields
     void applyExternalFields();
@@ -283,6 +274,10 @@ public :
     
     //! Wrapper of load balancing methods, including SmileiMPI::recompute_patch_count. Called from main program
     void loadBalance( Params &params, double time_dual, SmileiMPI *smpi, SimWindow *simWindow, unsigned int itime );
+    //! Decision at an iteration of the load balancing, when LoadBalancing.imbalance_threshold > 0: true when the
+    //! imbalance of the computation times since the last decision exceeds the threshold, and when the time it
+    //! wasted exceeds the time of the last load balancing
+    bool needsLoadBalancing( Params &params, SmileiMPI *smpi, Timers &timers );
     
     //! Explicits patch movement regarding new patch distribution stored in smpi->patch_count
     void createPatches( Params &params, SmileiMPI *smpi, SimWindow *simWindow );
@@ -290,6 +285,9 @@ public :
     //! Exchange patches, based on createPatches initialization
     void exchangePatches( SmileiMPI *smpi, Params &params );
     
+    //! Copy the data of the fields of all the patches in a single array, in the order of the patches
+    void buildFieldsArena();
+    
     //! Write in a file patches communications
     void outputExchanges( SmileiMPI *smpi );
     
@@ -358,6 +356,14 @@ public :
     
     std::vector<Field *> B2_localz;
     std::vector<Field *> B2_MPIz;
+
+    //! Neighborhood collectives (Main.neighborhood_collectives) of the empty lists above, per list and direction
+    std::map< std::pair<const std::vector<Field *> *, int>, NeighborExchange > neighborExchanges_;
+
+    //! The sums of the currents along X are sent during the dynamics at this iteration (Main.overlap_current_sums)
+    bool currentSumsEarly_;
+    //! Messages of the sums of the currents along X to which each patch belongs (see SyncVectorPatch::initSumRhoJEarly)
+    std::vector< std::vector<unsigned int> > currentSumMessages_;
     
     std::vector<Field *> listJx_;
     std::vector<Field *> listJy_;
@@ -422,6 +428,105 @@ public :
     //! 1st patch index of patches_ (stored for balancing op)
     int refHindex_;
     
+    //! Highest memory of the particles arrays (bytes) measured before cleaning their overhead
+    std::size_t particles_memory_peak_;
+    //! Same for each species, and highest memory of the MPI buffers measured at the outputs of DiagPerformances
+    std::vector<std::size_t> species_memory_peak_;
+    std::size_t mpi_buffers_memory_peak_;
+
+    //! Imbalance of the computation times at the last decision of the load balancing, and number of skipped balancings
+    double load_imbalance_;
+    unsigned int load_balancing_skipped_;
+    //! Computation and load balancing timers at the last decision, and time of the last load balancing (max of the processes)
+    double last_compute_time_, last_balancing_time_, balancing_cost_;
+    
+    //! Current memory of the particles arrays (bytes)
+    std::size_t getParticlesMemory()
+    {
+        std::size_t mem = 0;
+        for( unsigned int ipatch = 0 ; ipatch < this->size() ; ipatch++ ) {
+            for( unsigned int ispec = 0 ; ispec < ( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+                mem += ( *this )( ipatch )->vecSpecies[ispec]->getMemFootPrint();
+            }
+        }
+        return mem;
+    }
+    
+    //! Current memory of the particles arrays of one species (bytes)
+    std::size_t getParticlesMemory( unsigned int ispec )
+    {
+        std::size_t mem = 0;
+        for( unsigned int ipatch = 0 ; ipatch < this->size() ; ipatch++ ) {
+            mem += ( *this )( ipatch )->vecSpecies[ispec]->getMemFootPrint();
+        }
+        return mem;
+    }
+    
+    //! Update the peaks of the memory of the particles arrays, in total and per species
+    void updateParticlesMemoryPeaks()
+    {
+        particles_memory_peak_ = std::max( particles_memory_peak_, getParticlesMemory() );
+        if( this->size() == 0 ) {
+            return;
+        }
+        species_memory_peak_.resize( ( *this )( 0 )->vecSpecies.size(), 0 );
+        for( unsigned int ispec = 0 ; ispec < species_memory_peak_.size() ; ispec++ ) {
+            species_memory_peak_[ispec] = std::max( species_memory_peak_[ispec], getParticlesMemory( ispec ) );
+        }
+    }
+    
+    //! Current memory of the fields of the patches (bytes), without the PML
+    std::size_t getFieldsMemory();
+    
+    //! Current memory of the fields of the PML (bytes)
+    std::size_t getPMLMemory();
+    
+    //! Current memory of the buffers of the diagnostics (bytes)
+    std::size_t getDiagnosticsMemory();
+    
+    //! Current memory of the MPI buffers of the fields and particles exchanges (bytes)
+    std::size_t getMPIBuffersMemory();
+    
+    //! Number of particles of this process which are not frozen at this time (pushed at each iteration)
+    double getNumberOfPushedParticles( double time )
+    {
+        double n = 0.;
+        for( unsigned int ipatch = 0 ; ipatch < this->size() ; ipatch++ ) {
+            for( unsigned int ispec = 0 ; ispec < ( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+                if( time >= ( *this )( ipatch )->vecSpecies[ispec]->time_frozen_ ) {
+                    n += ( *this )( ipatch )->vecSpecies[ispec]->getNbrOfParticles();
+                }
+            }
+        }
+        return n;
+    }
+    
+    //! Fraction of the particles moved by the last sort, among the species sorted per cell
+    double getSortMovedFraction()
+    {
+        double moved = 0., total = 0.;
+        for( unsigned int ipatch = 0 ; ipatch < this->size() ; ipatch++ ) {
+            for( unsigned int ispec = 0 ; ispec < ( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+                moved += ( *this )( ipatch )->vecSpecies[ispec]->sort_moved_particles_;
+                total += ( *this )( ipatch )->vecSpecies[ispec]->sort_particles_;
+            }
+        }
+        return total > 0. ? moved / total : 0.;
+    }
+    
+    //! Particles forecast in excess and missing at the last cleaning of the particles overhead
+    void getForecastErrors( double &overshoot, double &undershoot )
+    {
+        overshoot = 0.;
+        undershoot = 0.;
+        for( unsigned int ipatch = 0 ; ipatch < this->size() ; ipatch++ ) {
+            for( unsigned int ispec = 0 ; ispec < ( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+                overshoot  += ( *this )( ipatch )->vecSpecies[ispec]->forecast_overshoot_;
+                undershoot += ( *this )( ipatch )->vecSpecies[ispec]->forecast_undershoot_;
+            }
+        }
+    }
+    
     //! Count global (MPI x patches) number of particles
     uint64_t getGlobalNumberOfParticles( SmileiMPI *smpi )
     {
@@ -547,6 +652,48 @@ private :
     double antenna_intensity_;
     
     std::vector<Timer *> diag_timers_;
+    
+    //! Patches in the processing order of the dynamics (`Main.dynamics_scheduling = "largest_first"`)
+    std::vector<unsigned int> dynamics_order_;
+    
+    //! Estimated cost of the dynamics of each patch
+    std::vector<double> dynamics_cost_;
+    
+    //! Sort the patches by decreasing cost of their dynamics into dynamics_order_
+    void orderPatchesByCost( double time_dual, SimWindow *simWindow );
+    //! Move the patches with MPI neighbors along X to the front of dynamics_order_ (Main.overlap_current_sums)
+    void orderBoundaryPatchesFirst();
+
+    //! First patch of the block of each NUMA domain in dynamics_order_, and next patch to process in each block
+    //! (`Main.dynamics_scheduling = "numa_affinity"`)
+    std::vector<unsigned int> numa_first_patch_;
+    std::vector<unsigned int> numa_next_patch_;
+
+    //! Dynamics of the patches by the threads of their NUMA domain, the others only under heavy imbalance
+    void numaAffinityDynamics( Params &params, const std::function<void( unsigned int )> &patchDynamics );
+
+    //! Data of the fields of all the patches, in the order of the patches (Main.fields_arena)
+    std::vector<double> fields_arena_;
+
+    //! Cells of a species of a patch merged by one thread
+    struct MergingChunk {
+        unsigned int ipatch;
+        unsigned int ispec;
+        unsigned int first_cell;
+        unsigned int last_cell;
+    };
+
+    //! Chunks of cells of the current merging, shared by the threads
+    std::vector<MergingChunk> merging_chunks_;
+
+    //! Number of cells to merge of each species of each patch in the current merging
+    std::vector<std::vector<unsigned int>> merging_cells_;
+
+    //! Targets of the species with a memory budget in the current merging
+    void applyMergingBudget();
+
+    //! Number of particles above which the next cells go to a new chunk
+    static const int merging_chunk_particles_ = 4096;
 };
 
 
@@ -1,6 +1,11 @@
 #include "Function.h"
 #include <complex>
 #include <cmath>
+#include <algorithm>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -112,6 +117,68 @@ std::complex<double> Function_Python4D::complexValueAt( vector<double> x_cell, d
     return v;
 }
 
+// Batches of points: the GIL is taken once for all the points
+// 1D
+void Function_Python1D::batchValuesAt( vector<vector<double>> &x, vector<double> &values )
+{
+    SMILEI_PY_ACQUIRE_GIL
+    for( unsigned int i=0; i<values.size(); i++ ) {
+        values[i] = PyTools::runPyFunction( py_profile, x[0][i] );
+    }
+    SMILEI_PY_RELEASE_GIL
+}
+void Function_Python1D::batchValuesAt( vector<vector<double>> &, double time, vector<double> &values )
+{
+    double v;
+    SMILEI_PY_ACQUIRE_GIL
+    v = PyTools::runPyFunction( py_profile, time );
+    SMILEI_PY_RELEASE_GIL
+    std::fill( values.begin(), values.end(), v );
+}
+// 2D
+void Function_Python2D::batchValuesAt( vector<vector<double>> &x, vector<double> &values )
+{
+    SMILEI_PY_ACQUIRE_GIL
+    for( unsigned int i=0; i<values.size(); i++ ) {
+        values[i] = PyTools::runPyFunction( py_profile, x[0][i], x[1][i] );
+    }
+    SMILEI_PY_RELEASE_GIL
+}
+void Function_Python2D::batchValuesAt( vector<vector<double>> &x, double time, vector<double> &values )
+{
+    SMILEI_PY_ACQUIRE_GIL
+    for( unsigned int i=0; i<values.size(); i++ ) {
+        values[i] = PyTools::runPyFunction( py_profile, x[0][i], time );
+    }
+    SMILEI_PY_RELEASE_GIL
+}
+// 3D
+void Function_Python3D::batchValuesAt( vector<vector<double>> &x, vector<double> &values )
+{
+    SMILEI_PY_ACQUIRE_GIL
+    for( unsigned int i=0; i<values.size(); i++ ) {
+        values[i] = PyTools::runPyFunction( py_profile, x[0][i], x[1][i], x[2][i] );
+    }
+    SMILEI_PY_RELEASE_GIL
+}
+void Function_Python3D::batchValuesAt( vector<vector<double>> &x, double time, vector<double> &values )
+{
+    SMILEI_PY_ACQUIRE_GIL
+    for( unsigned int i=0; i<values.size(); i++ ) {
+        values[i] = PyTools::runPyFunction( py_profile, x[0][i], x[1][i], time );
+    }
+    SMILEI_PY_RELEASE_GIL
+}
+// 4D
+void Function_Python4D::batchValuesAt( vector<vector<double>> &x, double time, vector<double> &values )
+{
+    SMILEI_PY_ACQUIRE_GIL
+    for( unsigned int i=0; i<values.size(); i++ ) {
+        values[i] = PyTools::runPyFunction( py_profile, x[0][i], x[1][i], x[2][i], time );
+    }
+    SMILEI_PY_RELEASE_GIL
+}
+
 // Special cases for locations specified in numpy arrays
 #ifdef SMILEI_USE_NUMPY
 PyArrayObject *Function_Python1D::valueAt( std::vector<PyArrayObject *> x )
@@ -216,6 +283,51 @@ PyArrayObject *Function_Python4D::complexValueAt( std::vector<PyArrayObject *> x
 #endif
 
 // Profiles from file
+Function_File::Function_File( std::string path, std::string dataset_name, H5Read *file, std::vector<double> cell_length )
+: path_( path ), dataset_name_( dataset_name ), file_( file ), cell_length_( cell_length ), mapping_( NULL ), mapping_size_( 0 ), data_( NULL )
+{
+    opened_file_count_ = new int( 1 );
+    shape_ = file_->shape( dataset_name_ );
+    
+    // Map the dataset in memory if it can be read directly from the file
+    string filename;
+    hsize_t offset;
+    if( ! file_->contiguousDoubles( dataset_name_, filename, offset ) ) {
+        return;
+    }
+    size_t npoints = 1;
+    for( auto s: shape_ ) {
+        npoints *= s;
+    }
+    size_t page = sysconf( _SC_PAGESIZE );
+    size_t start = ( offset / page ) * page;
+    int fd = open( filename.c_str(), O_RDONLY );
+    if( fd < 0 ) {
+        return;
+    }
+    mapping_size_ = offset - start + npoints * sizeof( double );
+    void *mapping = mmap( NULL, mapping_size_, PROT_READ, MAP_SHARED, fd, start );
+    close( fd );
+    if( mapping == MAP_FAILED ) {
+        mapping_size_ = 0;
+        return;
+    }
+    mapping_ = mapping;
+    data_ = reinterpret_cast<const double *>( static_cast<const char *>( mapping_ ) + ( offset - start ) );
+}
+
+Function_File::~Function_File()
+{
+    (*opened_file_count_) --;
+    if( (*opened_file_count_) == 0 ) {
+        if( mapping_ ) {
+            munmap( mapping_, mapping_size_ );
+        }
+        delete file_;
+        delete opened_file_count_;
+    }
+}
+
 double Function_File::valueAt( vector<double> x_cell )
 {
     vector<hsize_t> i_cell( x_cell.size() );
@@ -223,9 +335,16 @@ double Function_File::valueAt( vector<double> x_cell )
     for( unsigned int i=0; i<i_cell.size(); i++ ) {
         i_cell[i] = (hsize_t) round( x_cell[i] / cell_length_[i] );
     }
+    // Read directly in the mapped dataset
+    if( data_ ) {
+        size_t index = 0;
+        for( unsigned int i=0; i<i_cell.size(); i++ ) {
+            index = index * shape_[i] + i_cell[i];
+        }
+        return data_[index];
+    }
     // Define spaces in memory and in file
-    std::vector<hsize_t> shape = file_->shape( dataset_name_ );
-    H5Space filespace( shape, i_cell, n_cell );
+    H5Space filespace( shape_, i_cell, n_cell );
     H5Space memspace( n_cell );
     // Read the file portion
     double ret;
@@ -236,29 +355,103 @@ Field3D Function_File::valuesAt( vector<double> x_start, vector<double> x_end, v
 {
     vector<hsize_t> i_cell( x_start.size() );
     vector<hsize_t> n_cell( x_start.size() );
-    std::vector<hsize_t> shape = file_->shape( dataset_name_ );
     for( unsigned int i=0; i<i_cell.size(); i++ ) {
         i_cell[i] = (hsize_t) round( x_start[i] / cell_length_[i] - 0.1 );
         n_cell[i] = (hsize_t) round( x_end[i] / cell_length_[i] - 0.1 ) - i_cell[i] + 1;
         if( n_cell[i] != n[i] ) {
             ERROR( "Profile in file is asked "<<n[i]<<" points in direction "<<i<<", but calculated "<<n_cell[i] );
         }
-        if( i_cell[i] + n_cell[i] > shape[i] ) {
-            ERROR( "Profile in file has only "<<shape[i]<<" points in direction "<<i<<", but requires at least "<<(i_cell[i] + n_cell[i]) );
+        if( i_cell[i] + n_cell[i] > shape_[i] ) {
+            ERROR( "Profile in file has only "<<shape_[i]<<" points in direction "<<i<<", but requires at least "<<(i_cell[i] + n_cell[i]) );
         }
     }
-    // Define spaces in memory and in file
-    H5Space filespace( shape, i_cell, n_cell );
-    H5Space memspace( n_cell );
-    // Read the file portion
     vector<unsigned int> size( n_cell.begin(), n_cell.end() );
     size.resize( 3, 1 );
     Field3D values( size );
+    
+    // Copy the block from the mapped dataset, by contiguous lines of the last dimension
+    if( data_ ) {
+        vector<size_t> shape( shape_.begin(), shape_.end() ), start( i_cell.begin(), i_cell.end() );
+        shape.resize( 3, 1 );
+        start.resize( 3, 0 );
+        double *v = values.data();
+        for( size_t i=0; i<size[0]; i++ ) {
+            for( size_t j=0; j<size[1]; j++ ) {
+                const double *line = &data_[( ( start[0]+i )*shape[1] + start[1]+j )*shape[2] + start[2]];
+                double *out = &v[( i*size[1] + j )*size[2]];
+                #pragma omp simd
+                for( size_t k=0; k<size[2]; k++ ) {
+                    out[k] = line[k];
+                }
+            }
+        }
+        return values;
+    }
+    
+    // Define spaces in memory and in file
+    H5Space filespace( shape_, i_cell, n_cell );
+    H5Space memspace( n_cell );
+    // Read the file portion
     file_->array( dataset_name_, *values.data(), &filespace, &memspace );
     return values;
 }
 
 
+// Compiled profiles
+// The library is loaded once per process (dlopen returns the same handle for a library already loaded)
+// and is never unloaded, as the copies of the profile share the address of the function
+Function_Compiled::Function_Compiled( PyObject *py_profile, unsigned int nvariables )
+{
+    PyTools::getAttr( py_profile, "library", library_ );
+    PyTools::getAttr( py_profile, "function", function_name_ );
+    nvariables_ = nvariables;
+    if( nvariables_ < 1 || nvariables_ > 4 ) {
+        ERROR( "Compiled profile `" << function_name_ << "`: defined with unsupported number of variables (" << nvariables_ << ")" );
+    }
+    void *handle = dlopen( library_.c_str(), RTLD_NOW | RTLD_LOCAL );
+    if( ! handle ) {
+        ERROR( "Compiled profile: cannot load `" << library_ << "` (" << dlerror() << ")" );
+    }
+    function_ = dlsym( handle, function_name_.c_str() );
+    if( ! function_ ) {
+        ERROR( "Compiled profile: cannot find `" << function_name_ << "` in `" << library_ << "`" );
+    }
+}
+double Function_Compiled::call( const double *x )
+{
+    switch( nvariables_ ) {
+        case 1:
+            return reinterpret_cast<double ( * )( double )>( function_ )( x[0] );
+        case 2:
+            return reinterpret_cast<double ( * )( double, double )>( function_ )( x[0], x[1] );
+        case 3:
+            return reinterpret_cast<double ( * )( double, double, double )>( function_ )( x[0], x[1], x[2] );
+        default:
+            return reinterpret_cast<double ( * )( double, double, double, double )>( function_ )( x[0], x[1], x[2], x[3] );
+    }
+}
+double Function_Compiled::valueAt( double time )
+{
+    // Only the function of one variable may be called with the time alone
+    if( nvariables_ != 1 ) {
+        ERROR( "Compiled profile `" << function_name_ << "`: called with the time only, but defined with " << nvariables_ << " variables" );
+    }
+    return reinterpret_cast<double ( * )( double )>( function_ )( time );
+}
+double Function_Compiled::valueAt( vector<double> x_cell )
+{
+    return call( &x_cell[0] );
+}
+double Function_Compiled::valueAt( vector<double> x_cell, double time )
+{
+    double x[4];
+    for( unsigned int i = 0; i < nvariables_-1; i++ ) {
+        x[i] = x_cell[i];
+    }
+    x[nvariables_-1] = time;
+    return call( x );
+}
+
 // Constant profiles
 double Function_Constant1D::valueAt( vector<double> x_cell )
 {
@@ -52,6 +52,31 @@ public:
         return 0.; // virtual => will be redefined
     };
 
+    //! Gets the values of a N-D function at several points x[ivar][ipoint]
+    //! (the python functions override it to take the GIL once for all the points)
+    virtual void batchValuesAt( std::vector<std::vector<double>> &x, std::vector<double> &values )
+    {
+        std::vector<double> point( x.size() );
+        for( unsigned int i=0; i<values.size(); i++ ) {
+            for( unsigned int ivar=0; ivar<x.size(); ivar++ ) {
+                point[ivar] = x[ivar][i];
+            }
+            values[i] = valueAt( point );
+        }
+    };
+
+    //! Gets the values of a N-D function at several points x[ivar][ipoint] and at a given time
+    virtual void batchValuesAt( std::vector<std::vector<double>> &x, double time, std::vector<double> &values )
+    {
+        std::vector<double> point( x.size() );
+        for( unsigned int i=0; i<values.size(); i++ ) {
+            for( unsigned int ivar=0; ivar<x.size(); ivar++ ) {
+                point[ivar] = x[ivar][i];
+            }
+            values[i] = valueAt( point, time );
+        }
+    };
+
     //! Provide information about the function
     virtual std::string getInfo()
     {
@@ -103,6 +128,8 @@ public:
     double valueAt( double ); // time
     double valueAt( std::vector<double>, double ); // time (space discarded)
     double valueAt( std::vector<double> ); // space
+    void batchValuesAt( std::vector<std::vector<double>> &, std::vector<double> & ); // space, GIL taken once
+    void batchValuesAt( std::vector<std::vector<double>> &, double, std::vector<double> & ); // space + time, GIL taken once
 #ifdef SMILEI_USE_NUMPY
     PyArrayObject *valueAt( std::vector<PyArrayObject *> ); // numpy
     PyArrayObject *valueAt( std::vector<PyArrayObject *>, double ); // numpy + time
@@ -121,6 +148,8 @@ public:
     double valueAt( std::vector<double> ); // space
     std::complex<double> complexValueAt( std::vector<double>, double ); // space + time
     std::complex<double> complexValueAt( std::vector<double> ); // space
+    void batchValuesAt( std::vector<std::vector<double>> &, std::vector<double> & ); // space, GIL taken once
+    void batchValuesAt( std::vector<std::vector<double>> &, double, std::vector<double> & ); // space + time, GIL taken once
 #ifdef SMILEI_USE_NUMPY
     PyArrayObject *valueAt( std::vector<PyArrayObject *> ); // numpy
     PyArrayObject *valueAt( std::vector<PyArrayObject *>, double ); // numpy + time
@@ -138,6 +167,8 @@ public:
     double valueAt( std::vector<double>, double ); // space + time
     double valueAt( std::vector<double> ); // space
     std::complex<double> complexValueAt( std::vector<double>, double ); // space + time
+    void batchValuesAt( std::vector<std::vector<double>> &, std::vector<double> & ); // space, GIL taken once
+    void batchValuesAt( std::vector<std::vector<double>> &, double, std::vector<double> & ); // space + time, GIL taken once
 #ifdef SMILEI_USE_NUMPY
     PyArrayObject *valueAt( std::vector<PyArrayObject *> ); // numpy
     PyArrayObject *valueAt( std::vector<PyArrayObject *> , double ); // numpy + time
@@ -153,6 +184,7 @@ public:
     Function_Python4D( Function_Python4D *f ) : py_profile( f->py_profile ) {};
     double valueAt( std::vector<double>, double ); // space + time
     std::complex<double> complexValueAt( std::vector<double>, double ); // space + time
+    void batchValuesAt( std::vector<std::vector<double>> &, double, std::vector<double> & ); // space + time, GIL taken once
 #ifdef SMILEI_USE_NUMPY
     PyArrayObject *valueAt( std::vector<PyArrayObject *> , double ); // numpy + time
     PyArrayObject *complexValueAt( std::vector<PyArrayObject *>, PyArrayObject * ); // numpy
@@ -165,25 +197,15 @@ private:
 class Function_File : public Function
 {
 public:
-    Function_File( std::string path, std::string dataset_name, H5Read *file, std::vector<double> cell_length )
-    : path_( path ), dataset_name_( dataset_name ), file_( file ), cell_length_( cell_length )
-    {
-        opened_file_count_ = new int( 1 );
-    };
+    Function_File( std::string path, std::string dataset_name, H5Read *file, std::vector<double> cell_length );
     Function_File( Function_File *f )
-    :path_( f->path_ ), dataset_name_( f->dataset_name_ ), file_( f->file_ ), cell_length_( f->cell_length_ )
+    :path_( f->path_ ), dataset_name_( f->dataset_name_ ), file_( f->file_ ), cell_length_( f->cell_length_ ),
+     shape_( f->shape_ ), mapping_( f->mapping_ ), mapping_size_( f->mapping_size_ ), data_( f->data_ )
     {
         opened_file_count_ = f->opened_file_count_;
         (*opened_file_count_) ++;
     };
-    ~Function_File()
-    {
-        (*opened_file_count_) --;
-        if( (*opened_file_count_) == 0 ) {
-            delete file_;
-            delete opened_file_count_;
-        }
-    }
+    ~Function_File();
     double valueAt( std::vector<double> );
     Field3D valuesAt( std::vector<double>, std::vector<double>, std::vector<unsigned int> );
 private:
@@ -191,11 +213,47 @@ private:
     H5Read * file_;
     int * opened_file_count_;
     std::vector<double> cell_length_;
+    
+    //! Shape of the dataset
+    std::vector<hsize_t> shape_;
+    
+    //! Memory mapping of the dataset when it is a contiguous array of doubles (otherwise NULL):
+    //! the pages are only read when needed, and shared by the processes of a node
+    void *mapping_;
+    size_t mapping_size_;
+    const double *data_;
 };
 
-
 // Children classes for hard-coded functions
 
+// Compiled user function, loaded from a shared library
+class Function_Compiled : public Function
+{
+public:
+    Function_Compiled( PyObject *py_profile, unsigned int nvariables );
+    Function_Compiled( Function_Compiled *f )
+    {
+        library_       = f->library_;
+        function_name_ = f->function_name_;
+        nvariables_    = f->nvariables_;
+        function_      = f->function_;
+    };
+    double valueAt( double ); // time
+    double valueAt( std::vector<double> ); // space
+    double valueAt( std::vector<double>, double ); // space + time
+    std::string getInfo()
+    {
+        return " (function `" + function_name_ + "` of `" + library_ + "`)";
+    };
+private:
+    //! Call of the function with the arguments x
+    double call( const double *x );
+    std::string library_, function_name_;
+    unsigned int nvariables_;
+    //! Address of the function in the library (its type depends on nvariables_)
+    void *function_;
+};
+
 class Function_Constant1D : public Function
 {
 public:
@@ -148,6 +148,10 @@ Profile::Profile( PyObject *py_profile, unsigned int nvariables, string name, Pa
             } else {
                 ERROR( "Profile `"<<name<<"`: tsin2plateau() profile is only for time" );
             }
+        } else if( profileName_ == "compiled" ) {
+            
+            function_ = new Function_Compiled( py_profile, nvariables_ );
+            
         } else {
             
             ERROR( "Undefined profile "<<profileName_ );
@@ -385,6 +389,8 @@ Profile::Profile( Profile *p )
             function_ = new Function_TimePolynomial( static_cast<Function_TimePolynomial *>( p->function_ ) );
         } else if( profileName_ == "tsin2plateau" ) {
             function_ = new Function_TimeSin2Plateau( static_cast<Function_TimeSin2Plateau *>( p->function_ ) );
+        } else if( profileName_ == "compiled" ) {
+            function_ = new Function_Compiled( static_cast<Function_Compiled *>( p->function_ ) );
         }
     } else if( uses_file_ ) {
         function_ = new Function_File( static_cast<Function_File *>( p->function_ ) );
@@ -427,30 +433,38 @@ void Profile::valuesAt( std::vector<Field *> &coordinates, std::vector<double> g
         for( int idim=0; idim<ndim; idim++ ) {
             dims[idim] = ( npy_intp )( coordinates[0]->dims()[idim] );
         }
-        // Expose arrays as numpy, and evaluate
-        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-            x[ivar] = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( coordinates[ivar]->data() ) );
+        // Expose arrays as numpy, and evaluate (the arrays are handled with the GIL, as several threads may be here)
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                x[ivar] = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( coordinates[ivar]->data() ) );
+            }
+            SMILEI_PY_RELEASE_GIL
         }
         if( mode & 0b10 ) {
             values = function_->valueAt( x, time );
         } else {
             values = function_->valueAt( x );
         }
-        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-            Py_DECREF( x[ivar] );
-        }
-        // Copy array to return Field3D
-        double *arr = ( double * ) PyArray_GETPTR1( values, 0 );
-        if( mode & 0b01 ) {
-            for( unsigned int i=0; i<size; i++ ) {
-                ret( i ) += arr[i];
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                Py_DECREF( x[ivar] );
             }
-        } else {
-            for( unsigned int i=0; i<size; i++ ) {
-                ret( i ) = arr[i];
+            // Copy array to return Field3D
+            double *arr = ( double * ) PyArray_GETPTR1( values, 0 );
+            if( mode & 0b01 ) {
+                for( unsigned int i=0; i<size; i++ ) {
+                    ret( i ) += arr[i];
+                }
+            } else {
+                for( unsigned int i=0; i<size; i++ ) {
+                    ret( i ) = arr[i];
+                }
             }
+            Py_DECREF( values );
+            SMILEI_PY_RELEASE_GIL
         }
-        Py_DECREF( values );
     } else
 #endif
     // Profile read from a file
@@ -474,41 +488,70 @@ void Profile::valuesAt( std::vector<Field *> &coordinates, std::vector<double> g
             }
         }
     
-    // Otherwise, calculate profile for each point
+    // Otherwise, calculate profile for all points in one batch
     } else {
-        std::vector<double> x( nvar );
-        if( mode == 0 ) {
+        if( mode > 3 ) {
+            ERROR("valuesAt : wrong mode "<<mode);
+        }
+        std::vector<std::vector<double>> x( nvar, std::vector<double>( size ) );
+        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
             for( unsigned int i=0; i<size; i++ ) {
-                for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-                    x[ivar]=( *coordinates[ivar] )( i );
-                }
-                ret( i ) = function_->valueAt( x );
+                x[ivar][i] = ( *coordinates[ivar] )( i );
             }
-        } else if( mode == 1 ) {
+        }
+        std::vector<double> values( size );
+        if( mode & 0b10 ) {
+            function_->batchValuesAt( x, time, values );
+        } else {
+            function_->batchValuesAt( x, values );
+        }
+        if( mode & 0b01 ) {
             for( unsigned int i=0; i<size; i++ ) {
-                for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-                    x[ivar]=( *coordinates[ivar] )( i );
-                }
-                ret( i ) += function_->valueAt( x );
+                ret( i ) += values[i];
             }
-        } else if( mode == 2 ) {
+        } else {
             for( unsigned int i=0; i<size; i++ ) {
-                for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-                    x[ivar]=( *coordinates[ivar] )( i );
-                }
-                ret( i ) = function_->valueAt( x, time );
+                ret( i ) = values[i];
             }
-        } else if( mode == 3 ) {
+        }
+    }
+}
+
+//! Get the value of the profile at several locations coordinates[ivar][ipoint] and at a given time
+void Profile::valuesAt( std::vector<std::vector<double>> &coordinates, double time, std::vector<double> &ret )
+{
+#ifdef SMILEI_USE_NUMPY
+    // If numpy profile, a single call on 1D arrays
+    if( uses_numpy_ ) {
+        unsigned int nvar = coordinates.size();
+        unsigned int size = ret.size();
+        std::vector<PyArrayObject *> x( nvar );
+        npy_intp dims[1] = { ( npy_intp ) size };
+        // May be called by several threads: the arrays are handled with the GIL
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                x[ivar] = ( PyArrayObject * )PyArray_SimpleNewFromData( 1, dims, NPY_DOUBLE, ( double * )( coordinates[ivar].data() ) );
+            }
+            SMILEI_PY_RELEASE_GIL
+        }
+        PyArrayObject *values = function_->valueAt( x, time );
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                Py_DECREF( x[ivar] );
+            }
+            double *arr = ( double * ) PyArray_GETPTR1( values, 0 );
             for( unsigned int i=0; i<size; i++ ) {
-                for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-                    x[ivar]=( *coordinates[ivar] )( i );
-                }
-                ret( i ) += function_->valueAt( x, time );
+                ret[i] = arr[i];
             }
-        } else {
-            ERROR("valuesAt : wrong mode "<<mode);
+            Py_DECREF( values );
+            SMILEI_PY_RELEASE_GIL
         }
+        return;
     }
+#endif
+    function_->batchValuesAt( coordinates, time, ret );
 }
 
 //! Get/add the complex value of the profile at several locations
@@ -530,30 +573,38 @@ void Profile::complexValuesAt( std::vector<Field *> &coordinates, cField &ret, i
         for( int idim=0; idim<ndim; idim++ ) {
             dims[idim] = ( npy_intp ) coordinates[0]->dims()[idim];
         }
-        // Expose arrays as numpy, and evaluate
-        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-            x[ivar] = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( coordinates[ivar]->data() ) );
+        // Expose arrays as numpy, and evaluate (the arrays are handled with the GIL, as several threads may be here)
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                x[ivar] = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( coordinates[ivar]->data() ) );
+            }
+            SMILEI_PY_RELEASE_GIL
         }
         if( mode & 0b10 ) {
             values = function_->complexValueAt( x, time );
         } else {
             values = function_->complexValueAt( x );
         }
-        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-            Py_DECREF( x[ivar] );
-        }
-        // Copy array to return cField2D
-        std::complex<double> *arr = ( std::complex<double> * ) PyArray_GETPTR1( values, 0 );
-        if( mode & 0b01 ) {
-            for( unsigned int i=0; i<size; i++ ) {
-                ret( i ) += arr[i];
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                Py_DECREF( x[ivar] );
             }
-        } else {
-            for( unsigned int i=0; i<size; i++ ) {
-                ret( i ) = arr[i];
+            // Copy array to return cField2D
+            std::complex<double> *arr = ( std::complex<double> * ) PyArray_GETPTR1( values, 0 );
+            if( mode & 0b01 ) {
+                for( unsigned int i=0; i<size; i++ ) {
+                    ret( i ) += arr[i];
+                }
+            } else {
+                for( unsigned int i=0; i<size; i++ ) {
+                    ret( i ) = arr[i];
+                }
             }
+            Py_DECREF( values );
+            SMILEI_PY_RELEASE_GIL
         }
-        Py_DECREF( values );
     } else
 #endif
     // Profile read from a file
@@ -612,22 +663,30 @@ void Profile::complexValuesAtTimes( std::vector<Field *> &coordinates, Field *ti
         for( int idim=0; idim<ndim; idim++ ) {
             dims[idim] = ( npy_intp ) coordinates[0]->dims()[idim];
         }
-        // Expose arrays as numpy, and evaluate
-        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-            x[ivar] = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( coordinates[ivar]->data() ) );
+        // Expose arrays as numpy, and evaluate (the arrays are handled with the GIL, as several threads may be here)
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                x[ivar] = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( coordinates[ivar]->data() ) );
+            }
+            t = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( time->data() ) );
+            SMILEI_PY_RELEASE_GIL
         }
-        t = ( PyArrayObject * )PyArray_SimpleNewFromData( ndim, dims, NPY_DOUBLE, ( double * )( time->data() ) );
         PyArrayObject *values = function_->complexValueAt( x, t );
-        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
-            Py_DECREF( x[ivar] );
-        }
-        Py_DECREF( t );
-        // Copy array to return Field3D
-        std::complex<double> *arr = ( std::complex<double> * ) PyArray_GETPTR1( values, 0 );
-        for( unsigned int i=0; i<size; i++ ) {
-            ret( i ) = arr[i];
+        {
+            SMILEI_PY_ACQUIRE_GIL
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                Py_DECREF( x[ivar] );
+            }
+            Py_DECREF( t );
+            // Copy array to return Field3D
+            std::complex<double> *arr = ( std::complex<double> * ) PyArray_GETPTR1( values, 0 );
+            for( unsigned int i=0; i<size; i++ ) {
+                ret( i ) = arr[i];
+            }
+            Py_DECREF( values );
+            SMILEI_PY_RELEASE_GIL
         }
-        Py_DECREF( values );
     } else
 #endif
     // Profile read from a file
@@ -53,6 +53,10 @@ public:
     //! mode = 3 : ADD values at given time
     void valuesAt( std::vector<Field *> &coordinates, std::vector<double> global_origin, Field &ret, int mode = 0, double time = 0. );
     
+    //! Get the value of the profile at several locations coordinates[ivar][ipoint] and at a given time:
+    //! a single call to the function (numpy arrays if accepted, otherwise the GIL is taken once)
+    void valuesAt( std::vector<std::vector<double>> &coordinates, double time, std::vector<double> &ret );
+    
     //! Get/add the complex value of the profile at several locations
     //! mode = 0 : set values
     //! mode = 1 : ADD values
@@ -93,6 +97,12 @@ public:
         return profileName_;
     }
 
+    //! Whether the profile is taken from a file
+    bool usesFile()
+    {
+        return uses_file_;
+    }
+
 private:
     
     //! Name of the profile, in the case of a built-in profile
@@ -43,6 +43,9 @@ Projector3D2OrderV::Projector3D2OrderV( Params &params, Patch *patch ) : Project
     dts2           = params.timestep/2.;
     dts4           = params.timestep/4.;
 
+    float_accumulation_ = params.float_accumulation;
+    float_accumulation_check_ = params.float_accumulation_check;
+
     DEBUG( "cell_length "<< params.cell_length[0] );
 
 }
@@ -499,6 +502,152 @@ void Projector3D2OrderV::ionizationCurrentsForTasks( double *b_Jx, double *b_Jy,
 } // END Project global current densities (ionize) for tasks
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Accuracy check of Vectorization.float_accumulation (Vectorization.float_accumulation_check): the compensated
+//! single-precision currents of a cell are compared to the double precision ones. The charge conservation holds
+//! as long as the error stays at the level of the single-precision rounding of the coefficients.
+// ---------------------------------------------------------------------------------------------------------------------
+void Projector3D2OrderV::checkFloatAccumulation( const double *bJ, const float *sJ, const float *cJ )
+{
+    const int vecSize = 8;
+    double max_J = 0.;
+    double max_error = 0.;
+    for( unsigned int node=0; node<125; node++ ) {
+        double J = 0.;
+        for( int l=0; l<vecSize; l++ ) {
+            J += bJ[node*vecSize+l];
+        }
+        double fJ = 0.;
+        for( int l=0; l<float_vecSize; l++ ) {
+            fJ += ( double )sJ[node*float_vecSize+l] - ( double )cJ[node*float_vecSize+l];
+        }
+        max_J     = std::max( max_J, std::abs( J ) );
+        max_error = std::max( max_error, std::abs( J - fJ ) );
+    }
+    if( max_error > 1.e-5 * max_J ) {
+        WARNING( "Vectorization.float_accumulation: relative error of the currents " << max_error / max_J );
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Single-precision deposition of the particles of a cell (Vectorization.float_accumulation)
+//! The coefficients are computed in double by blocks of 8 particles, rounded once by roundShapes
+//! in blocks of float_vecSize particles, and the contributions of the cell are summed with a Kahan
+//! compensation. The float lanes are finally summed in the 8 lanes of the double buffers bJ.
+// ---------------------------------------------------------------------------------------------------------------------
+void Projector3D2OrderV::currentsCompensated( double *bJx, double *bJy, double *bJz, Particles &particles,
+                                              int istart, int cell_nparts, int buffer_size, int ipart_ref,
+                                              int *iold, double *deltaold )
+{
+    const int vecSize = 8;
+    const unsigned int bsize  = 5*5*5*vecSize;
+    const unsigned int fbsize = 5*5*5*float_vecSize;
+
+    double Sx0_buff_vect[32] __attribute__( ( aligned( 64 ) ) );
+    double Sy0_buff_vect[32] __attribute__( ( aligned( 64 ) ) );
+    double Sz0_buff_vect[32] __attribute__( ( aligned( 64 ) ) );
+    double DSx[40] __attribute__( ( aligned( 64 ) ) );
+    double DSy[40] __attribute__( ( aligned( 64 ) ) );
+    double DSz[40] __attribute__( ( aligned( 64 ) ) );
+    double charge_weight[8] __attribute__( ( aligned( 64 ) ) );
+
+    // Single-precision sums and compensations
+    float sJx[fbsize] __attribute__( ( aligned( 64 ) ) );
+    float sJy[fbsize] __attribute__( ( aligned( 64 ) ) );
+    float sJz[fbsize] __attribute__( ( aligned( 64 ) ) );
+    float cJx[fbsize] __attribute__( ( aligned( 64 ) ) );
+    float cJy[fbsize] __attribute__( ( aligned( 64 ) ) );
+    float cJz[fbsize] __attribute__( ( aligned( 64 ) ) );
+    float fSx0[4*float_vecSize] __attribute__( ( aligned( 64 ) ) );
+    float fSy0[4*float_vecSize] __attribute__( ( aligned( 64 ) ) );
+    float fSz0[4*float_vecSize] __attribute__( ( aligned( 64 ) ) );
+    float fDSx[5*float_vecSize] __attribute__( ( aligned( 64 ) ) );
+    float fDSy[5*float_vecSize] __attribute__( ( aligned( 64 ) ) );
+    float fDSz[5*float_vecSize] __attribute__( ( aligned( 64 ) ) );
+    float fcharge_weight[float_vecSize] __attribute__( ( aligned( 64 ) ) );
+
+    double * __restrict__ position_x = particles.getPtrPosition(0);
+    double * __restrict__ position_y = particles.getPtrPosition(1);
+    double * __restrict__ position_z = particles.getPtrPosition(2);
+    double * __restrict__ weight     = particles.getPtrWeight();
+    short  * __restrict__ charge     = particles.getPtrCharge();
+
+    #pragma omp simd
+    for( unsigned int j=0; j<fbsize; j++ ) {
+        sJx[j] = 0.f;
+        sJy[j] = 0.f;
+        sJz[j] = 0.f;
+        cJx[j] = 0.f;
+        cJy[j] = 0.f;
+        cJz[j] = 0.f;
+    }
+
+    for( int ivect=0 ; ivect < cell_nparts; ivect += float_vecSize ) {
+
+        int np_block( min( cell_nparts-ivect, float_vecSize ) );
+
+        // Double precision coefficients by halves of 8 particles, rounded in the lanes of the float block
+        for( int lane0=0 ; lane0 < np_block; lane0 += vecSize ) {
+
+            int np_computed( min( np_block-lane0, vecSize ) );
+            int istart0 = istart + ivect + lane0;
+
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                compute_distances( position_x, position_y, position_z,
+                                   buffer_size, ipart, istart0, ipart_ref, deltaold, iold,
+                                   Sx0_buff_vect, Sy0_buff_vect, Sz0_buff_vect, DSx, DSy, DSz );
+                charge_weight[ipart] = inv_cell_volume * ( double )( charge[istart0+ipart] )*weight[istart0+ipart];
+            }
+
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                roundShapes( ipart, lane0+ipart, Sx0_buff_vect, DSx, fSx0, fDSx );
+                roundShapes( ipart, lane0+ipart, Sy0_buff_vect, DSy, fSy0, fDSy );
+                roundShapes( ipart, lane0+ipart, Sz0_buff_vect, DSz, fSz0, fDSz );
+                fcharge_weight[lane0+ipart] = ( float )charge_weight[ipart];
+            }
+
+            // Reference double precision deposition
+            if( float_accumulation_check_ ) {
+                for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                    computeJ( ipart, charge_weight, DSx, DSy, DSz, Sy0_buff_vect, Sz0_buff_vect, bJx, dx_ov_dt_, 25, 5, 1 );
+                    computeJ( ipart, charge_weight, DSy, DSx, DSz, Sx0_buff_vect, Sz0_buff_vect, bJy, dy_ov_dt_, 5, 25, 1 );
+                    computeJ( ipart, charge_weight, DSz, DSx, DSy, Sx0_buff_vect, Sy0_buff_vect, bJz, dz_ov_dt_, 1, 25, 5 );
+                }
+            }
+        }
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_block; ipart++ ) {
+            computeJCompensated( ipart, fcharge_weight, fDSx, fDSy, fDSz, fSy0, fSz0, sJx, cJx, ( float )dx_ov_dt_, 25, 5, 1 );
+        }
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_block; ipart++ ) {
+            computeJCompensated( ipart, fcharge_weight, fDSy, fDSx, fDSz, fSx0, fSz0, sJy, cJy, ( float )dy_ov_dt_, 5, 25, 1 );
+        }
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_block; ipart++ ) {
+            computeJCompensated( ipart, fcharge_weight, fDSz, fDSx, fDSy, fSx0, fSy0, sJz, cJz, ( float )dz_ov_dt_, 1, 25, 5 );
+        }
+    } // END ivect
+
+    if( float_accumulation_check_ ) {
+        checkFloatAccumulation( bJx, sJx, cJx );
+        checkFloatAccumulation( bJy, sJy, cJy );
+        checkFloatAccumulation( bJz, sJz, cJz );
+    }
+
+    // Flush the compensated sums in the double buffers: float lanes l and l+8 go to the double lane l
+    #pragma omp simd
+    for( unsigned int j=0; j<bsize; j++ ) {
+        const unsigned int l = ( j/vecSize )*float_vecSize + j%vecSize;
+        bJx[j] = ( ( double )sJx[l] - ( double )cJx[l] ) + ( ( double )sJx[l+vecSize] - ( double )cJx[l+vecSize] );
+        bJy[j] = ( ( double )sJy[l] - ( double )cJy[l] ) + ( ( double )sJy[l+vecSize] - ( double )cJy[l+vecSize] );
+        bJz[j] = ( ( double )sJz[l] - ( double )cJz[l] ) + ( ( double )sJz[l+vecSize] - ( double )cJz[l+vecSize] );
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //! Project current densities : main projector vectorized
 // ---------------------------------------------------------------------------------------------------------------------
@@ -562,35 +711,67 @@ void Projector3D2OrderV::currents( double * __restrict__ Jx,
         bJz[j] = 0.;
     }
 
-    for( int ivect=0 ; ivect < cell_nparts; ivect += vecSize ) {
+#ifdef SMILEI_EXPLICIT_SIMD
+    static_assert( 8 % SimdDouble::width == 0, "the SIMD width must divide the block size" );
+    // The lanes after np_computed are deposited with a zero weight: their coefficients must be finite
+    for( unsigned int j=0; j<32; j++ ) {
+        Sx0_buff_vect[j] = 0.;
+        Sy0_buff_vect[j] = 0.;
+        Sz0_buff_vect[j] = 0.;
+    }
+    for( unsigned int j=0; j<40; j++ ) {
+        DSx[j] = 0.;
+        DSy[j] = 0.;
+        DSz[j] = 0.;
+    }
+#endif
 
-        int np_computed( min( cell_nparts-ivect, vecSize ) );
-        int istart0 = ( int )istart + ivect;
+    if( float_accumulation_ ) {
+        currentsCompensated( bJx, bJy, bJz, particles, ( int )istart, cell_nparts, ( int )buffer_size, ipart_ref, iold, deltaold );
+    } else {
+        for( int ivect=0 ; ivect < cell_nparts; ivect += vecSize ) {
 
-        #pragma omp simd
-        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-            compute_distances( position_x, position_y, position_z,
-                               (int)(buffer_size), ipart, istart0, ipart_ref, deltaold, iold,
-                               Sx0_buff_vect, Sy0_buff_vect, Sz0_buff_vect, DSx, DSy, DSz );
-            charge_weight[ipart] = inv_cell_volume * ( double )( charge[istart0+ipart] )*weight[istart0+ipart];
-        }
+            int np_computed( min( cell_nparts-ivect, vecSize ) );
+            int istart0 = ( int )istart + ivect;
 
-        #pragma omp simd
-        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-            computeJ( ipart, charge_weight, DSx, DSy, DSz, Sy0_buff_vect, Sz0_buff_vect, bJx, dx_ov_dt_, 25, 5, 1 );
-        } // END ipart (compute coeffs)
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                compute_distances( position_x, position_y, position_z,
+                                   (int)(buffer_size), ipart, istart0, ipart_ref, deltaold, iold,
+                                   Sx0_buff_vect, Sy0_buff_vect, Sz0_buff_vect, DSx, DSy, DSz );
+                charge_weight[ipart] = inv_cell_volume * ( double )( charge[istart0+ipart] )*weight[istart0+ipart];
+            }
 
-        #pragma omp simd
-        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-            computeJ( ipart, charge_weight, DSy, DSx, DSz, Sx0_buff_vect, Sz0_buff_vect, bJy, dy_ov_dt_, 5, 25, 1 );
-        } // END ipart (compute coeffs)
+#ifdef SMILEI_EXPLICIT_SIMD
+            // Explicit SIMD backend: SimdDouble::width particles per deposition
+            for( int ipart=np_computed ; ipart<vecSize; ipart++ ) {
+                charge_weight[ipart] = 0.;
+            }
 
-        #pragma omp simd
-        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
-            computeJ( ipart, charge_weight, DSz, DSx, DSy, Sx0_buff_vect, Sy0_buff_vect, bJz, dz_ov_dt_, 1, 25, 5 );
-        } // END ipart (compute coeffs)
+            for( int ipart=0 ; ipart<np_computed; ipart += SimdDouble::width ) {
+                computeJ<SimdDouble>( ipart, charge_weight, DSx, DSy, DSz, Sy0_buff_vect, Sz0_buff_vect, bJx, dx_ov_dt_, 25, 5, 1 );
+                computeJ<SimdDouble>( ipart, charge_weight, DSy, DSx, DSz, Sx0_buff_vect, Sz0_buff_vect, bJy, dy_ov_dt_, 5, 25, 1 );
+                computeJ<SimdDouble>( ipart, charge_weight, DSz, DSx, DSy, Sx0_buff_vect, Sy0_buff_vect, bJz, dz_ov_dt_, 1, 25, 5 );
+            }
+#else
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                computeJ( ipart, charge_weight, DSx, DSy, DSz, Sy0_buff_vect, Sz0_buff_vect, bJx, dx_ov_dt_, 25, 5, 1 );
+            } // END ipart (compute coeffs)
 
-    } // END ivect
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                computeJ( ipart, charge_weight, DSy, DSx, DSz, Sx0_buff_vect, Sz0_buff_vect, bJy, dy_ov_dt_, 5, 25, 1 );
+            } // END ipart (compute coeffs)
+
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                computeJ( ipart, charge_weight, DSz, DSx, DSy, Sx0_buff_vect, Sy0_buff_vect, bJz, dz_ov_dt_, 1, 25, 5 );
+            } // END ipart (compute coeffs)
+#endif
+
+        } // END ivect
+    }
 
     int iglobal0 = (ipom2-bin_shift)*nyz+jpom2*nprimz+kpom2;
 
@@ -1,8 +1,11 @@
 #ifndef PROJECTOR3D2ORDERV_H
 #define PROJECTOR3D2ORDERV_H
 
+#include <cmath>
+
 #include "Projector3D.h"
 #include "Pragma.h"
+#include "Simd.h"
 
 class Projector3D2OrderV : public Projector3D
 {
@@ -60,6 +63,48 @@ public:
 private:
     double dt, dts2, dts4;
 
+    //! Accumulate the currents of a cell in single precision (Vectorization.float_accumulation)
+    bool float_accumulation_;
+
+    //! Also run the double precision deposition to check the single-precision one (Vectorization.float_accumulation_check)
+    bool float_accumulation_check_;
+
+    //! Particles per block of the single-precision deposition: a SIMD register holds twice as many floats as doubles
+    static const int float_vecSize = 16;
+
+    //! Single-precision deposition of the particles of a cell, returned in the double buffers bJ (8 lanes)
+    void currentsCompensated( double *bJx, double *bJy, double *bJz, Particles &particles,
+                              int istart, int cell_nparts, int buffer_size, int ipart_ref,
+                              int *iold, double *deltaold );
+
+    //! Compare the single-precision currents of a cell (sum sJ, compensation cJ) to the double ones bJ
+    void checkFloatAccumulation( const double *bJ, const float *sJ, const float *cJ );
+
+    //! Rounding of a shape coefficient in [0,1] on the fixed grid 2^-24: the rounded values
+    //! and their differences are exact in single precision
+    static inline float __attribute__((always_inline)) roundShape( double s )
+    {
+        return ( float )( std::nearbyint( s * 16777216. ) * ( 1./16777216. ) );
+    }
+
+    //! Rounding of the coefficients of particle `ipart` (block of 8) in lane `lane` of the float block.
+    //! S0 and S1 = S0+DS are rounded, then DS is taken back from the rounded values: S0+DS = S1 holds
+    //! exactly in single precision, as required by the charge conservation of the Esirkepov scheme.
+    static inline void __attribute__((always_inline)) roundShapes( int ipart, int lane, const double *S0, const double *DS,
+                                                                   float *fS0, float *fDS )
+    {
+        // DS[k] pairs with S0[k-1], S0 is zero outside
+        for( int k=0 ; k<5 ; k++ ) {
+            const double s0 = ( k>0 ) ? S0[( k-1 )*8+ipart] : 0.;
+            const float fs0 = roundShape( s0 );
+            const float fs1 = roundShape( s0 + DS[k*8+ipart] );
+            fDS[k*float_vecSize+lane] = fs1 - fs0;
+            if( k>0 ) {
+                fS0[( k-1 )*float_vecSize+lane] = fs0;
+            }
+        }
+    }
+
     inline void __attribute__((always_inline)) compute_distances(  double * __restrict__ position_x,
                                                                    double * __restrict__ position_y,
                                     double * __restrict__ position_z,
@@ -290,65 +335,160 @@ private:
 
     };
 
+    //! Deposition of one current component for the lanes `ipart` of a block of 8 particles
+    //! (T is double for one particle, SimdDouble for SimdDouble::width particles)
+    template<typename T = double>
     inline void __attribute__((always_inline)) computeJ( int ipart, double *charge_weight,
                                                         double *DSx, double *DSy, double *DSz,
                                                         double *Sy0, double *Sz0, double *bJx,
                                                         double dxovdt, int nx, int ny, int nz )
     {
         //optrpt complains about the following loop but not unrolling it actually seems to give better result.
-        double crx_p = charge_weight[ipart]*dxovdt;
+        T crx_p = simdLoad<T>( charge_weight+ipart )*dxovdt;
 
         int vecSize = 8;
 
-        double sum[5];
+        T sum[5];
         sum[0] = 0.;
         UNROLL_S(4)
         for( unsigned int k=1 ; k<5 ; k++ ) {
-            sum[k] = sum[k-1]-DSx[( k-1 )*vecSize+ipart];
+            sum[k] = sum[k-1]-simdLoad<T>( DSx+( k-1 )*vecSize+ipart );
         }
 
-        double tmp( crx_p * ( one_third*DSy[ipart]*DSz[ipart] ) );
+        const T DSy0 = simdLoad<T>( DSy+ipart );
+        const T DSz0 = simdLoad<T>( DSz+ipart );
+
+        T tmp( crx_p * ( one_third*DSy0*DSz0 ) );
         UNROLL_S(4)
         for( unsigned int i=1 ; i<5 ; i++ ) {
-            bJx [( ( i )*nx )*vecSize+ipart] += sum[i]*tmp;
+            double *const b = bJx+( ( i )*nx )*vecSize+ipart;
+            simdStore( b, simdLoad<T>( b ) + sum[i]*tmp );
         }
 
         UNROLL_S(4)
         for( unsigned int k=1 ; k<5 ; k++ ) {
-            tmp = crx_p * ( 0.5*DSy[ipart]*Sz0[( k-1 )*vecSize+ipart] + one_third*DSy[ipart]*DSz[k*vecSize+ipart] );
+            tmp = crx_p * ( 0.5*DSy0*simdLoad<T>( Sz0+( k-1 )*vecSize+ipart ) + one_third*DSy0*simdLoad<T>( DSz+k*vecSize+ipart ) );
             int index( ( k*nz )*vecSize+ipart );
             UNROLL_S(4)
             for( unsigned int i=1 ; i<5 ; i++ ) {
-                bJx [ index+nx*( i )*vecSize ] += sum[i]*tmp;
+                double *const b = bJx+index+nx*( i )*vecSize;
+                simdStore( b, simdLoad<T>( b ) + sum[i]*tmp );
             }
 
         }
         UNROLL_S(4)
         for( unsigned int j=1 ; j<5 ; j++ ) {
-            tmp = crx_p * ( 0.5*DSz[ipart]*Sy0[( j-1 )*vecSize+ipart] + one_third*DSy[j*vecSize+ipart]*DSz[ipart] );
+            tmp = crx_p * ( 0.5*DSz0*simdLoad<T>( Sy0+( j-1 )*vecSize+ipart ) + one_third*simdLoad<T>( DSy+j*vecSize+ipart )*DSz0 );
             int index( ( j*ny )*vecSize+ipart );
             UNROLL_S(4)
             for( unsigned int i=1 ; i<5 ; i++ ) {
-                bJx [ index+nx*( i )*vecSize ] += sum[i]*tmp;
+                double *const b = bJx+index+nx*( i )*vecSize;
+                simdStore( b, simdLoad<T>( b ) + sum[i]*tmp );
             }
         }//i
         UNROLL_S(4)
         for( int j=1 ; j<5 ; j++ ) {
+            const T Sy0j = simdLoad<T>( Sy0+( j-1 )*vecSize+ipart );
+            const T DSyj = simdLoad<T>( DSy+j*vecSize+ipart );
             UNROLL_S(4)
             for( int k=1 ; k<5 ; k++ ) {
-                tmp = crx_p * ( Sy0[( j-1 )*vecSize+ipart]*Sz0[( k-1 )*vecSize+ipart]
-                                + 0.5*DSy[j*vecSize+ipart]*Sz0[( k-1 )*vecSize+ipart]
-                                + 0.5*DSz[k*vecSize+ipart]*Sy0[( j-1 )*vecSize+ipart]
-                                + one_third*DSy[j*vecSize+ipart]*DSz[k*vecSize+ipart] );
+                const T Sz0k = simdLoad<T>( Sz0+( k-1 )*vecSize+ipart );
+                const T DSzk = simdLoad<T>( DSz+k*vecSize+ipart );
+                tmp = crx_p * ( Sy0j*Sz0k
+                                + 0.5*DSyj*Sz0k
+                                + 0.5*DSzk*Sy0j
+                                + one_third*DSyj*DSzk );
                 int index( ( j*ny + k*nz )*vecSize+ipart );
                 UNROLL_S(4)
                 for( int i=1 ; i<5 ; i++ ) {
-                    bJx [ index+nx*( i )*vecSize ] += sum[i]*tmp;
+                    double *const b = bJx+index+nx*( i )*vecSize;
+                    simdStore( b, simdLoad<T>( b ) + sum[i]*tmp );
                 }
             }
         }//i
     }
 
+    //! Compensated (Kahan) addition of `x` to the single-precision sum `s`,
+    //! `c` keeps the opposite of the lost low-order part: the sum is s-c
+    static inline void __attribute__((always_inline)) kahanAdd( float *s, float *c, float x )
+    {
+        const float y = x - *c;
+        const float t = *s + y;
+        *c = ( t - *s ) - y;
+        *s = t;
+    }
+
+    //! Same deposition as computeJ, in single precision with a compensated summation in (bJs, bJc),
+    //! for the lane `ipart` of a block of float_vecSize particles
+    inline void __attribute__((always_inline)) computeJCompensated( int ipart, const float *charge_weight,
+                                                                   const float *DSx, const float *DSy, const float *DSz,
+                                                                   const float *Sy0, const float *Sz0, float *bJs, float *bJc,
+                                                                   float dxovdt, int nx, int ny, int nz )
+    {
+        const float crx_p = charge_weight[ipart]*dxovdt;
+        const float f_one_third = 1.f/3.f;
+
+        const int vecSize = float_vecSize;
+
+        float sum[5];
+        sum[0] = 0.f;
+        UNROLL_S(4)
+        for( unsigned int k=1 ; k<5 ; k++ ) {
+            sum[k] = sum[k-1]-DSx[( k-1 )*vecSize+ipart];
+        }
+
+        const float DSy0 = DSy[ipart];
+        const float DSz0 = DSz[ipart];
+
+        float tmp = crx_p * ( f_one_third*DSy0*DSz0 );
+        UNROLL_S(4)
+        for( unsigned int i=1 ; i<5 ; i++ ) {
+            const int b = ( ( i )*nx )*vecSize+ipart;
+            kahanAdd( bJs+b, bJc+b, sum[i]*tmp );
+        }
+
+        UNROLL_S(4)
+        for( unsigned int k=1 ; k<5 ; k++ ) {
+            tmp = crx_p * ( 0.5f*DSy0*Sz0[( k-1 )*vecSize+ipart] + f_one_third*DSy0*DSz[k*vecSize+ipart] );
+            int index( ( k*nz )*vecSize+ipart );
+            UNROLL_S(4)
+            for( unsigned int i=1 ; i<5 ; i++ ) {
+                const int b = index+nx*( i )*vecSize;
+                kahanAdd( bJs+b, bJc+b, sum[i]*tmp );
+            }
+        }
+        UNROLL_S(4)
+        for( unsigned int j=1 ; j<5 ; j++ ) {
+            tmp = crx_p * ( 0.5f*DSz0*Sy0[( j-1 )*vecSize+ipart] + f_one_third*DSy[j*vecSize+ipart]*DSz0 );
+            int index( ( j*ny )*vecSize+ipart );
+            UNROLL_S(4)
+            for( unsigned int i=1 ; i<5 ; i++ ) {
+                const int b = index+nx*( i )*vecSize;
+                kahanAdd( bJs+b, bJc+b, sum[i]*tmp );
+            }
+        }
+        UNROLL_S(4)
+        for( int j=1 ; j<5 ; j++ ) {
+            const float Sy0j = Sy0[( j-1 )*vecSize+ipart];
+            const float DSyj = DSy[j*vecSize+ipart];
+            UNROLL_S(4)
+            for( int k=1 ; k<5 ; k++ ) {
+                const float Sz0k = Sz0[( k-1 )*vecSize+ipart];
+                const float DSzk = DSz[k*vecSize+ipart];
+                tmp = crx_p * ( Sy0j*Sz0k
+                                + 0.5f*DSyj*Sz0k
+                                + 0.5f*DSzk*Sy0j
+                                + f_one_third*DSyj*DSzk );
+                int index( ( j*ny + k*nz )*vecSize+ipart );
+                UNROLL_S(4)
+                for( int i=1 ; i<5 ; i++ ) {
+                    const int b = index+nx*( i )*vecSize;
+                    kahanAdd( bJs+b, bJc+b, sum[i]*tmp );
+                }
+            }
+        }
+    }
+
 };
 
 #endif
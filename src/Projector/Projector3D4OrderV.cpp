@@ -52,6 +52,60 @@ Projector3D4OrderV::~Projector3D4OrderV()
 {
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Shape coefficients of the old position of a block of np_computed particles starting at ipart0 in the buffers.
+//! They are copied from the interpolator (shapeold, Vectorization.reuse_shape_coefficients)
+//! or computed again from deltaold. The 6th row of each direction is zeroed.
+// ---------------------------------------------------------------------------------------------------------------------
+inline void __attribute__((always_inline)) Projector3D4OrderV::oldShape( double * __restrict__ Sx0,
+                                                                         double * __restrict__ Sy0,
+                                                                         double * __restrict__ Sz0,
+                                                                         const double * __restrict__ deltaold,
+                                                                         const double * __restrict__ shapeold,
+                                                                         int ipart0, int np_computed,
+                                                                         unsigned int buffer_size )
+{
+    const int vecSize = 8;
+    double * __restrict__ S0[3] = { Sx0, Sy0, Sz0 };
+
+    if( shapeold ) {
+        UNROLL_S(3)
+        for( int idim=0 ; idim<3 ; idim++ ) {
+            UNROLL_S(5)
+            for( int inode=0 ; inode<5 ; inode++ ) {
+                const double * __restrict__ row = &shapeold[( idim*5+inode )*buffer_size + ipart0];
+                #pragma omp simd
+                for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                    S0[idim][inode*vecSize+ipart] = row[ipart];
+                }
+            }
+            #pragma omp simd
+            for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+                S0[idim][5*vecSize+ipart] = 0.;
+            }
+        }
+        return;
+    }
+
+    UNROLL_S(3)
+    for( int idim=0 ; idim<3 ; idim++ ) {
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            double delta = deltaold[idim*buffer_size + ipart0 + ipart];
+            double delta2 = delta*delta;
+            double delta3 = delta2*delta;
+            double delta4 = delta3*delta;
+
+            S0[idim][          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+            S0[idim][  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
+            S0[idim][2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
+            S0[idim][3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
+            S0[idim][4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+            S0[idim][5*vecSize+ipart] = 0.;
+        }
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //!  Project current densities & charge : diagFields timstep (not vectorized)
 // ---------------------------------------------------------------------------------------------------------------------
@@ -66,7 +120,8 @@ void Projector3D4OrderV::currentsAndDensity( double * __restrict__ Jx,
                                                 int    * __restrict__ iold,
                                                 double * __restrict__ deltaold,
                                                 unsigned int buffer_size,
-                                                int ipart_ref, int bin_shift )
+                                                int ipart_ref, int bin_shift,
+                                                double * __restrict__ shapeold )
 {
     // -------------------------------------
     // Variable declaration & initialization
@@ -112,7 +167,7 @@ void Projector3D4OrderV::currentsAndDensity( double * __restrict__ Jx,
 
     // Jx Jy Jz
 
-    currents( Jx, Jy, Jz, particles,  istart, iend, invgf, iold, deltaold, buffer_size, ipart_ref, bin_shift );
+    currents( Jx, Jy, Jz, particles,  istart, iend, invgf, iold, deltaold, buffer_size, ipart_ref, bin_shift, shapeold );
 
     // rho^(p,p,d)
 
@@ -646,7 +701,8 @@ void Projector3D4OrderV::currents( double * __restrict__ Jx,
                                    int        * __restrict__ iold,
                                    double     * __restrict__ deltaold,
                                    unsigned int buffer_size,
-                                   int ipart_ref, int /*bin_shift*/ )
+                                   int ipart_ref, int /*bin_shift*/,
+                                   double     * __restrict__ shapeold )
 {
     // -------------------------------------
     // Variable declaration & initialization
@@ -695,49 +751,12 @@ void Projector3D4OrderV::currents( double * __restrict__ Jx,
 
         int np_computed( min( cell_nparts-ivect, vecSize ) );
 
+        oldShape( Sx0_buff_vect, Sy0_buff_vect, Sz0_buff_vect, deltaold, shapeold, ivect-ipart_ref+istart, np_computed, buffer_size );
+
         #pragma omp simd
         for( int ipart=0 ; ipart<np_computed; ipart++ ) {
 
-            // locate the particle on the primal grid at former time-step & calculate coeff. S0
-            //                            X                                 //
-            double delta = deltaold[ivect+ipart-ipart_ref+istart];
-            double delta2 = delta*delta;
-            double delta3 = delta2*delta;
-            double delta4 = delta3*delta;
-
-            Sx0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sx0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sx0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sx0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sx0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sx0_buff_vect[5*vecSize+ipart] = 0.;
-
-            //                            Y                                 //
-            delta = deltaold[ivect+ipart-ipart_ref+istart+buffer_size];
-            delta2 = delta*delta;
-            delta3 = delta2*delta;
-            delta4 = delta3*delta;
-
-            Sy0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sy0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sy0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sy0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sy0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sy0_buff_vect[5*vecSize+ipart] = 0.;
-
-            //                            Z                                 //
-            delta = deltaold[ivect+ipart-ipart_ref+istart+2*buffer_size];
-            delta2 = delta*delta;
-            delta3 = delta2*delta;
-            delta4 = delta3*delta;
-
-            Sz0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sz0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sz0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sz0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sz0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sz0_buff_vect[5*vecSize+ipart] = 0.;
-
+            double delta, delta2, delta3, delta4;
 
             // locate the particle on the primal grid at current time-step & calculate coeff. S1
             //                            X                                 //
@@ -916,49 +935,12 @@ void Projector3D4OrderV::currents( double * __restrict__ Jx,
         //for (unsigned int i=0; i<200; i++)
         //    bJx[i] = 0.;
 
+        oldShape( Sx0_buff_vect, Sy0_buff_vect, Sz0_buff_vect, deltaold, shapeold, ivect-ipart_ref+istart, np_computed, buffer_size );
+
         #pragma omp simd
         for( int ipart=0 ; ipart<np_computed; ipart++ ) {
 
-            // locate the particle on the primal grid at former time-step & calculate coeff. S0
-            //                            X                                 //
-            double delta = deltaold[ivect+ipart-ipart_ref+istart];
-            double delta2 = delta*delta;
-            double delta3 = delta2*delta;
-            double delta4 = delta3*delta;
-
-            Sx0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sx0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sx0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sx0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sx0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sx0_buff_vect[5*vecSize+ipart] = 0.;
-
-            //                            Y                                 //
-            delta = deltaold[ivect+ipart-ipart_ref+istart+buffer_size];
-            delta2 = delta*delta;
-            delta3 = delta2*delta;
-            delta4 = delta3*delta;
-
-            Sy0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sy0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sy0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sy0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sy0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sy0_buff_vect[5*vecSize+ipart] = 0.;
-
-            //                            Z                                 //
-            delta = deltaold[ivect+ipart-ipart_ref+istart+2*buffer_size];
-            delta2 = delta*delta;
-            delta3 = delta2*delta;
-            delta4 = delta3*delta;
-
-            Sz0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sz0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sz0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sz0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sz0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sz0_buff_vect[5*vecSize+ipart] = 0.;
-
+            double delta, delta2, delta3, delta4;
 
             // locate the particle on the primal grid at current time-step & calculate coeff. S1
             //                            X                                 //
@@ -1121,49 +1103,12 @@ void Projector3D4OrderV::currents( double * __restrict__ Jx,
 
         int np_computed( min( cell_nparts-ivect, vecSize ) );
 
+        oldShape( Sx0_buff_vect, Sy0_buff_vect, Sz0_buff_vect, deltaold, shapeold, ivect-ipart_ref+istart, np_computed, buffer_size );
+
         #pragma omp simd
         for( int ipart=0 ; ipart<np_computed; ipart++ ) {
 
-            // locate the particle on the primal grid at former time-step & calculate coeff. S0
-            //                            X                                 //
-            double delta = deltaold[ivect+ipart-ipart_ref+istart];
-            double delta2 = delta*delta;
-            double delta3 = delta2*delta;
-            double delta4 = delta3*delta;
-
-            Sx0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sx0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sx0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sx0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sx0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sx0_buff_vect[5*vecSize+ipart] = 0.;
-
-            //                            Y                                 //
-            delta = deltaold[ivect+ipart-ipart_ref+istart+buffer_size];
-            delta2 = delta*delta;
-            delta3 = delta2*delta;
-            delta4 = delta3*delta;
-
-            Sy0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sy0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sy0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sy0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sy0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sy0_buff_vect[5*vecSize+ipart] = 0.;
-
-            //                            Z                                 //
-            delta = deltaold[ivect+ipart-ipart_ref+istart+2*buffer_size];
-            delta2 = delta*delta;
-            delta3 = delta2*delta;
-            delta4 = delta3*delta;
-
-            Sz0_buff_vect[          ipart] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sz0_buff_vect[  vecSize+ipart] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sz0_buff_vect[2*vecSize+ipart] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4  * delta4;
-            Sz0_buff_vect[3*vecSize+ipart] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4  * delta2 - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
-            Sz0_buff_vect[4*vecSize+ipart] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
-            Sz0_buff_vect[5*vecSize+ipart] = 0.;
-
+            double delta, delta2, delta3, delta4;
 
             // locate the particle on the primal grid at current time-step & calculate coeff. S1
             //                            X                                 //
@@ -1332,6 +1277,8 @@ void Projector3D4OrderV::currentsAndDensityWrapper( ElectroMagn *EMfields, Parti
     std::vector<double> *delta = &( smpi->dynamics_deltaold[ithread] );
     std::vector<double> *invgf = &( smpi->dynamics_invgf[ithread] );
     //}
+    // Shape coefficients of the old position exported by the interpolator
+    double *shapeold = smpi->dynamics_shapeold.empty() ? nullptr : smpi->dynamics_shapeold[ithread].data();
     int iold[3];
 
 
@@ -1347,7 +1294,7 @@ void Projector3D4OrderV::currentsAndDensityWrapper( ElectroMagn *EMfields, Parti
             double *b_Jx =  &( *EMfields->Jx_ )( 0 );
             double *b_Jy =  &( *EMfields->Jy_ )( 0 );
             double *b_Jz =  &( *EMfields->Jz_ )( 0 );
-            currents( b_Jx, b_Jy, b_Jz, particles,  istart, iend, invgf->data(), iold, &( *delta )[0], invgf->size(), ipart_ref );
+            currents( b_Jx, b_Jy, b_Jz, particles,  istart, iend, invgf->data(), iold, &( *delta )[0], invgf->size(), ipart_ref, 0, shapeold );
         } else {
             ERROR( "TO DO with rho" );
         }
@@ -1358,7 +1305,7 @@ void Projector3D4OrderV::currentsAndDensityWrapper( ElectroMagn *EMfields, Parti
         double *b_Jy  = EMfields->Jy_s [ispec] ? &( *EMfields->Jy_s [ispec] )( 0 ) : &( *EMfields->Jy_ )( 0 ) ;
         double *b_Jz  = EMfields->Jz_s [ispec] ? &( *EMfields->Jz_s [ispec] )( 0 ) : &( *EMfields->Jz_ )( 0 ) ;
         double *b_rho = EMfields->rho_s[ispec] ? &( *EMfields->rho_s[ispec] )( 0 ) : &( *EMfields->rho_ )( 0 ) ;
-        currentsAndDensity( b_Jx, b_Jy, b_Jz, b_rho, particles,  istart, iend, invgf->data(), iold, &( *delta )[0], invgf->size(), ipart_ref );
+        currentsAndDensity( b_Jx, b_Jy, b_Jz, b_rho, particles,  istart, iend, invgf->data(), iold, &( *delta )[0], invgf->size(), ipart_ref, 0, shapeold );
     }
 }
 
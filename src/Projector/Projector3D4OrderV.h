@@ -15,6 +15,7 @@ public:
 
     //! Project global current densities (EMfields->Jx_/Jy_/Jz_)
     //! \param buffer_size number of particles in the buffers invgf, iold, deltaold
+    //! \param shapeold shape coefficients of the old position given by the interpolator, computed from deltaold if null
     inline void __attribute__((always_inline)) currents( double    * __restrict__ Jx,
                                                          double    * __restrict__ Jy,
                                                          double    * __restrict__ Jz,
@@ -25,7 +26,8 @@ public:
                                                          int       * __restrict__ iold,
                                                          double    * __restrict__ deltaold,
                                                          unsigned int buffer_size,
-                                                         int ipart_ref = 0, int bin_shift = 0 );
+                                                         int ipart_ref = 0, int bin_shift = 0,
+                                                         double    * __restrict__ shapeold = nullptr );
 
     //! Project global current densities (EMfields->Jx_/Jy_/Jz_/rho), diagFields timestep
     inline void __attribute__((always_inline)) currentsAndDensity( double *Jx,
@@ -39,7 +41,8 @@ public:
                                                 int     * __restrict__ iold,
                                                 double  * __restrict__ deltaold,
                                                 unsigned int buffer_size,
-                                                int ipart_ref = 0, int bin_shift = 0 );
+                                                int ipart_ref = 0, int bin_shift = 0,
+                                                double  * __restrict__ shapeold = nullptr );
 
     //! Project global current charge (EMfields->rho_), frozen & diagFields timestep
     void basic( double *rhoj, Particles &particles, unsigned int ipart, unsigned int bin, int bin_shift = 0 ) override final;
@@ -59,6 +62,15 @@ public:
     void susceptibility( ElectroMagn *EMfields, Particles &particles, double species_mass, SmileiMPI *smpi, int istart, int iend,  int ithread, int icell, int ipart_ref ) override;
 
 private:
+    //! Shape coefficients of the old position of a block of particles, in the layout of the current kernels
+    inline void __attribute__((always_inline)) oldShape( double * __restrict__ Sx0,
+                                                         double * __restrict__ Sy0,
+                                                         double * __restrict__ Sz0,
+                                                         const double * __restrict__ deltaold,
+                                                         const double * __restrict__ shapeold,
+                                                         int ipart0, int np_computed,
+                                                         unsigned int buffer_size );
+
     static constexpr double dble_1_ov_384   = 1.0/384.0;
     static constexpr double dble_1_ov_48    = 1.0/48.0;
     static constexpr double dble_1_ov_16    = 1.0/16.0;
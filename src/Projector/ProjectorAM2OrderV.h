@@ -153,19 +153,21 @@ private:
             }
         }
         //mode > 0
+        // the real factors along r do not depend on the mode
+        double tmp_r[5];
+        tmp_r[0] = crl_p * ( 0.5*DSr[ipart] ) * invR_local[0] ;
+        UNROLL_S(4)
+        for ( unsigned int j=1; j<5 ; j++ ) {
+            tmp_r[j] = crl_p * ( Sr0[(j-1)*vecSize+ipart] + 0.5*DSr[j*vecSize+ipart] ) * invR_local[j];
+        }
         for (unsigned int imode=1; imode<Nmode_; imode++){ 
             C_m *= e_bar[ipart];
-            tmp = crl_p * ( 0.5*DSr[ipart] ) * invR_local[0] ;
-            UNROLL_S(4)
-            for( unsigned int i=1 ; i<5 ; i++ ) {
-                bJ [200*imode + (i*5 )*vecSize+ipart] += sum[i] * tmp * C_m;
-            }
-            UNROLL_S(4)
-            for ( unsigned int j=1; j<5 ; j++ ) {
-                tmp =  crl_p * ( Sr0[(j-1)*vecSize+ipart] + 0.5*DSr[j*vecSize+ipart] ) * invR_local[j];
+            UNROLL_S(5)
+            for ( unsigned int j=0; j<5 ; j++ ) {
+                const std::complex<double> tmp_m = tmp_r[j] * C_m;
                 UNROLL_S(4)
                 for( unsigned int i=1 ; i<5 ; i++ ) {
-                    bJ [200*imode + (i*5+j )*vecSize+ipart] += sum[i] * tmp * C_m;
+                    bJ [200*imode + (i*5+j )*vecSize+ipart] += sum[i] * tmp_m;
                 }
             }
         }
@@ -201,19 +203,21 @@ private:
         }
 
         //mode > 0
+        // the real factors along l do not depend on the mode
+        double tmp_l[5];
+        tmp_l[0] = 0.5*DSl[ipart];
+        UNROLL_S(4)
+        for ( unsigned int i=1; i<5 ; i++ ) {
+            tmp_l[i] = Sl0[(i-1)*vecSize + ipart] + 0.5*DSl[i*vecSize + ipart];
+        }
         for (unsigned int imode=1; imode<Nmode_; imode++){ 
             C_m *= e_bar[ipart];
-            tmp = 0.5*DSl[ipart];
-            UNROLL_S(4)
-            for( unsigned int j=0 ; j<4 ; j++ ) {
-                bJ [200*imode + ( j+1 )*vecSize+ipart] += sum[j] * tmp * C_m;
-            }
-            UNROLL_S(4)
-            for ( unsigned int i=1; i<5 ; i++ ) {
-                tmp = Sl0[(i-1)*vecSize + ipart] + 0.5*DSl[i*vecSize + ipart];
+            UNROLL_S(5)
+            for ( unsigned int i=0; i<5 ; i++ ) {
+                const std::complex<double> tmp_m = tmp_l[i] * C_m;
                 UNROLL_S(4)
                 for( unsigned int j=0 ; j<4 ; j++ ) {
-                    bJ [200*imode + (i*5+j+1 )*vecSize + ipart] += sum[j] * tmp * C_m;
+                    bJ [200*imode + (i*5+j+1 )*vecSize + ipart] += sum[j] * tmp_m;
                 }
             }
         }
@@ -265,15 +269,19 @@ private:
                 crt_p = charge_weight[ipart]*Icpx*e_bar * one_ov_dt * 2. * r_bar[ipart] /( double )imode ;
             }
 
+            // complex factors of the mode, common to all the nodes
+            const std::complex<double> c1 = crt_p*( e_delta-1. );
+            const std::complex<double> c0 = crt_p*( std::conj( e_delta ) - 1. );
+
             //j=0 case
             UNROLL_S(5)
             for( unsigned int i=0 ; i<5 ; i++ ) {
-                bJ [200*imode + (i*5 )*vecSize + ipart] -= crt_p*(Sr1[0]*Sl1[i]*( e_delta-1. ) );
+                bJ [200*imode + (i*5 )*vecSize + ipart] -= ( Sr1[0]*Sl1[i] ) * c1;
             }
             //i=0 case
             UNROLL_S(4)
             for( unsigned int j=1 ; j<5 ; j++ ) {
-                bJ [200*imode + (j)*vecSize + ipart] -= crt_p*(Sr1[j]*Sl1[0]*( e_delta-1. ) );
+                bJ [200*imode + (j)*vecSize + ipart] -= ( Sr1[j]*Sl1[0] ) * c1;
             }
 
 
@@ -281,7 +289,7 @@ private:
             for( unsigned int i=1 ; i<5 ; i++ ) {
                 UNROLL_S(4)
                 for ( unsigned int j=1; j<5 ; j++ ) {
-                    bJ [200*imode + (i*5+j )*vecSize + ipart] -= crt_p*(Sr1[j]*Sl1[i]*( e_delta-1. ) - Sr0_buff_vect[(j-1)*vecSize + ipart]*Sl0_buff_vect[(i-1)*vecSize + ipart]*(std::conj(e_delta) - 1.));
+                    bJ [200*imode + (i*5+j )*vecSize + ipart] -= ( Sr1[j]*Sl1[i] ) * c1 - ( Sr0_buff_vect[(j-1)*vecSize + ipart]*Sl0_buff_vect[(i-1)*vecSize + ipart] ) * c0;
                 }
             }
 
@@ -328,11 +336,12 @@ private:
                 C_m = 2. * e_bar;
             }
 
+            const std::complex<double> C_w = C_m * charge_weight[ipart];
             UNROLL_S(5)
             for( unsigned int i=0 ; i<5 ; i++ ) {
                 UNROLL_S(5)
                 for ( unsigned int j=0; j<5 ; j++ ) {
-                    brho [200*imode + (i*5+j )*vecSize + ipart] += C_m * charge_weight[ipart]*(Sr1[j]*Sl1[i]);
+                    brho [200*imode + (i*5+j )*vecSize + ipart] += ( Sr1[j]*Sl1[i] ) * C_w;
                 }
             }
        }
@@ -20,9 +20,10 @@ Pusher::Pusher( Params &params, Species *species ) :
     } else {
         one_over_mass_ = 0.;
     }
-    dt             = params.timestep;
-    dts2           = params.timestep/2.;
-    dts4           = params.timestep/4.;
+    // A sub-cycled species is pushed over push_every_ iterations at once
+    dt             = params.timestep * species->push_every_;
+    dts2           = dt/2.;
+    dts4           = dt/4.;
     
     nDim_          = params.nDim_particle;
     
@@ -31,3 +32,8 @@ Pusher::Pusher( Params &params, Species *species ) :
 Pusher::~Pusher()
 {
 }
+
+void Pusher::pushWithRadiation( Particles &, SmileiMPI *, RadiationTables &, double &, int, int, int, int )
+{
+    ERROR( "This pusher is not fused with the radiation reaction" );
+}
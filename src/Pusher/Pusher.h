@@ -5,6 +5,7 @@
 #include "Field.h"
 
 class Particles;
+class RadiationTables;
 
 
 //  --------------------------------------------------------------------------------------------------------------------
@@ -20,6 +21,12 @@ public:
     
     //! Overloading of () operator
     virtual void operator()( Particles &particles, SmileiMPI *smpi, int istart, int iend, int ithread, int ipart_buffer_offset = 0 ) = 0;
+
+    //! Push fused with the continuous radiation reaction, for the pushers that support it
+    //! \param radiation_tables tables and functions of the radiation reaction
+    //! \param radiated_energy  incremented by the energy radiated during the push
+    virtual void pushWithRadiation( Particles &particles, SmileiMPI *smpi, RadiationTables &radiation_tables, double &radiated_energy,
+                                    int istart, int iend, int ithread, int ipart_buffer_offset = 0 );
     
 protected:
     double dt, dts2, dts4;
@@ -13,7 +13,7 @@
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class PusherBorisV
 //  --------------------------------------------------------------------------------------------------------------------
-class PusherBoris : public Pusher
+class PusherBoris final : public Pusher
 {
 public:
     //! Creator for Pusher
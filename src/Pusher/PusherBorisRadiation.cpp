@@ -0,0 +1,249 @@
+#include "PusherBorisRadiation.h"
+
+#include <cmath>
+#include <iostream>
+
+#include "Particles.h"
+#include "Species.h"
+#include "Random.h"
+#include "RadiationTables.h"
+#include "RadiationTools.h"
+
+
+PusherBorisRadiation::PusherBorisRadiation( Params &params, Species *species, Random *rand )
+    : Pusher( params, species ),
+      rand_( rand )
+{
+    if( species->radiation_model_ == "ll" ) {
+        model_ = 1;
+    } else if( species->radiation_model_ == "cll" ) {
+        model_ = 2;
+    } else if( species->radiation_model_ == "niel" ) {
+        model_ = 3;
+    } else {
+        model_ = 0;
+    }
+
+    // Inverse of the normalized Schwinger electric field
+    inv_norm_E_Schwinger_ = ( params.red_planck_cst* params.reference_angular_frequency_SI )
+                            / ( params.electron_mass*params.c_vacuum_*params.c_vacuum_ );
+}
+
+PusherBorisRadiation::~PusherBorisRadiation()
+{
+}
+
+/***********************************************************************
+    Lorentz Force -- leap-frog (Boris) scheme
+***********************************************************************/
+
+void PusherBorisRadiation::operator()( Particles &particles, SmileiMPI *smpi, int istart, int iend, int ithread, int ipart_buffer_offset )
+{
+    double radiated_energy = 0;
+    pushAndRadiate<0>( particles, smpi, nullptr, radiated_energy, istart, iend, ithread, ipart_buffer_offset );
+}
+
+/***********************************************************************
+    Continuous radiation reaction, then Lorentz Force -- leap-frog (Boris) scheme
+***********************************************************************/
+
+void PusherBorisRadiation::pushWithRadiation( Particles &particles, SmileiMPI *smpi, RadiationTables &radiation_tables, double &radiated_energy,
+                                              int istart, int iend, int ithread, int ipart_buffer_offset )
+{
+    if( model_ == 1 ) {
+        pushAndRadiate<1>( particles, smpi, &radiation_tables, radiated_energy, istart, iend, ithread, ipart_buffer_offset );
+    } else if( model_ == 2 ) {
+        pushAndRadiate<2>( particles, smpi, &radiation_tables, radiated_energy, istart, iend, ithread, ipart_buffer_offset );
+    } else if( model_ == 3 ) {
+        // The random numbers are drawn sequentially, before the vectorized loop
+        random_numbers_.resize( iend-istart );
+        for( int ipart=0 ; ipart<iend-istart; ipart++ ) {
+            random_numbers_[ipart] = rand_->uniform2();
+        }
+        pushAndRadiate<3>( particles, smpi, &radiation_tables, radiated_energy, istart, iend, ithread, ipart_buffer_offset );
+    } else {
+        pushAndRadiate<0>( particles, smpi, &radiation_tables, radiated_energy, istart, iend, ithread, ipart_buffer_offset );
+    }
+}
+
+template<int model>
+void PusherBorisRadiation::pushAndRadiate( Particles &particles, SmileiMPI *smpi, RadiationTables *radiation_tables, double &radiated_energy,
+                                           int istart, int iend, int ithread, int ipart_buffer_offset )
+{
+    double *const __restrict__ position_x = particles.getPtrPosition( 0 );
+    double *const __restrict__ position_y = nDim_ > 1 ? particles.getPtrPosition( 1 ) : nullptr;
+    double *const __restrict__ position_z = nDim_ > 2 ? particles.getPtrPosition( 2 ) : nullptr;
+
+    double *const __restrict__ momentum_x = particles.getPtrMomentum( 0 );
+    double *const __restrict__ momentum_y = particles.getPtrMomentum( 1 );
+    double *const __restrict__ momentum_z = particles.getPtrMomentum( 2 );
+
+    const short *const __restrict__ charge = particles.getPtrCharge();
+    const double *const __restrict__ weight = particles.getPtrWeight();
+    double *const __restrict__ chi = model > 0 ? particles.getPtrChi() : nullptr;
+
+    double *const __restrict__ invgf = &( smpi->dynamics_invgf[ithread][0] );
+
+    const int nparts = smpi->getBufferSize( ithread );
+
+    const double *const __restrict__ Ex = &( ( smpi->dynamics_Epart[ithread] )[0*nparts] );
+    const double *const __restrict__ Ey = &( ( smpi->dynamics_Epart[ithread] )[1*nparts] );
+    const double *const __restrict__ Ez = &( ( smpi->dynamics_Epart[ithread] )[2*nparts] );
+    const double *const __restrict__ Bx = &( ( smpi->dynamics_Bpart[ithread] )[0*nparts] );
+    const double *const __restrict__ By = &( ( smpi->dynamics_Bpart[ithread] )[1*nparts] );
+    const double *const __restrict__ Bz = &( ( smpi->dynamics_Bpart[ithread] )[2*nparts] );
+
+    const double *const __restrict__ random_numbers = model == 3 ? random_numbers_.data() : nullptr;
+
+    // Radiation parameters
+    const double one_over_mass_square            = one_over_mass_*one_over_mass_;
+    const double minimum_chi_continuous          = model > 0 ? radiation_tables->getMinimumChiContinuous() : 0.;
+    const double factor_classical_radiated_power = model > 0 ? radiation_tables->getFactorClassicalRadiatedPower() : 0.;
+    const int niel_computation_method            = model == 3 ? radiation_tables->getNielHComputationMethodIndex() : 0;
+    const double sqrtdt2                         = std::sqrt( 2.*dt );
+
+    double radiated_energy_loc = 0;
+
+    #pragma omp simd reduction(+:radiated_energy_loc)
+    for( int ipart=istart ; ipart<iend; ipart++ ) {
+
+        const int ipart2 = ipart - ipart_buffer_offset;
+
+        double px = momentum_x[ipart];
+        double py = momentum_y[ipart];
+        double pz = momentum_z[ipart];
+
+        const double ex = Ex[ipart2], ey = Ey[ipart2], ez = Ez[ipart2];
+        const double bx = Bx[ipart2], by = By[ipart2], bz = Bz[ipart2];
+
+        // ________________________________________
+        // Radiation reaction
+
+        if( model > 0 ) {
+
+            const double charge_over_mass_square = ( double )( charge[ipart] )*one_over_mass_square;
+
+            // Lorentz factor and quantum parameter before the radiation
+            const double gamma = std::sqrt( 1.0 + px*px + py*py + pz*pz );
+            const double particle_chi = std::fabs( charge_over_mass_square )*inv_norm_E_Schwinger_
+                * std::sqrt( std::fabs( ( ex*px + ey*py + ez*pz ) * ( ex*px + ey*py + ez*pz )
+                                        - ( gamma*ex - by*pz + bz*py ) * ( gamma*ex - by*pz + bz*py )
+                                        - ( gamma*ey - bz*px + bx*pz ) * ( gamma*ey - bz*px + bx*pz )
+                                        - ( gamma*ez - bx*py + by*px ) * ( gamma*ez - bx*py + by*px ) ) );
+
+            // Radiated energy during the time step (relative to the momentum)
+            double rad_energy;
+            bool radiating;
+            if( model == 1 ) {
+                radiating = gamma > 1.1 && particle_chi >= minimum_chi_continuous;
+                rad_energy = radiation_tables->getClassicalRadiatedEnergy( particle_chi, dt );
+            } else if( model == 2 ) {
+                radiating = gamma > 1.1 && particle_chi >= minimum_chi_continuous;
+                rad_energy = radiation_tables->getRidgersCorrectedRadiatedEnergy( particle_chi, dt );
+            } else {
+                radiating = gamma > 1.1 && particle_chi > minimum_chi_continuous;
+                // Stochastic diffusive term: normal random number from the uniform one
+                const double r = random_numbers[ipart-istart];
+                double temp = -std::log( ( 1.0-r )*( 1.0+r ) );
+                double p;
+                if( temp < 5.000000 ) {
+                    temp = temp - 2.500000;
+                    p = +2.81022636000e-08      ;
+                    p = +3.43273939000e-07 + p*temp;
+                    p = -3.52338770000e-06 + p*temp;
+                    p = -4.39150654000e-06 + p*temp;
+                    p = +0.00021858087e+00 + p*temp;
+                    p = -0.00125372503e+00 + p*temp;
+                    p = -0.00417768164e+00 + p*temp;
+                    p = +0.24664072700e+00 + p*temp;
+                    p = +1.50140941000e+00 + p*temp;
+                } else {
+                    temp = std::sqrt( temp ) - 3.000000;
+                    p = -0.000200214257      ;
+                    p = +0.000100950558 + p*temp;
+                    p = +0.001349343220 + p*temp;
+                    p = -0.003673428440 + p*temp;
+                    p = +0.005739507730 + p*temp;
+                    p = -0.007622461300 + p*temp;
+                    p = +0.009438870470 + p*temp;
+                    p = +1.001674060000 + p*temp;
+                    p = +2.832976820000 + p*temp;
+                }
+                // h of Niel et al., evaluated above the threshold to stay in the range of the fits
+                const double chi_h = std::fmax( particle_chi, minimum_chi_continuous );
+                double h;
+                if( niel_computation_method == 0 ) {
+                    h = radiation_tables->niel_.get( chi_h );
+                } else if( niel_computation_method == 1 ) {
+                    h = RadiationTools::getHNielFitOrder5( chi_h );
+                } else if( niel_computation_method == 2 ) {
+                    h = RadiationTools::getHNielFitOrder10( chi_h );
+                } else {
+                    h = RadiationTools::getHNielFitRidgers( chi_h );
+                }
+                const double diffusion = std::sqrt( factor_classical_radiated_power*gamma*h )*r*p*sqrtdt2;
+                rad_energy = radiation_tables->getRidgersCorrectedRadiatedEnergy( particle_chi, dt ) - diffusion;
+            }
+
+            // Update of the momentum (selected, so that the discarded lanes cannot propagate a NaN)
+            const double factor = radiating ? rad_energy*gamma/( gamma*gamma-1. ) : 0.;
+            px -= factor*px;
+            py -= factor*py;
+            pz -= factor*pz;
+
+            // Radiated energy and quantum parameter after the radiation
+            const double new_gamma = std::sqrt( 1.0 + px*px + py*py + pz*pz );
+            radiated_energy_loc += weight[ipart]*( gamma - new_gamma );
+            chi[ipart] = std::fabs( charge_over_mass_square )*inv_norm_E_Schwinger_
+                * std::sqrt( std::fabs( ( ex*px + ey*py + ez*pz ) * ( ex*px + ey*py + ez*pz )
+                                        - ( new_gamma*ex - by*pz + bz*py ) * ( new_gamma*ex - by*pz + bz*py )
+                                        - ( new_gamma*ey - bz*px + bx*pz ) * ( new_gamma*ey - bz*px + bx*pz )
+                                        - ( new_gamma*ez - bx*py + by*px ) * ( new_gamma*ez - bx*py + by*px ) ) );
+        }
+
+        // ________________________________________
+        // Boris push
+
+        const double charge_over_mass_dts2 = ( double )( charge[ipart] )*one_over_mass_*dts2;
+
+        // init Half-acceleration in the electric field
+        double pxsm = charge_over_mass_dts2*ex;
+        double pysm = charge_over_mass_dts2*ey;
+        double pzsm = charge_over_mass_dts2*ez;
+
+        const double umx = px + pxsm;
+        const double umy = py + pysm;
+        const double umz = pz + pzsm;
+
+        // Rotation in the magnetic field
+        double local_invgf     = charge_over_mass_dts2 / std::sqrt( 1.0 + umx*umx + umy*umy + umz*umz );
+        const double Tx        = local_invgf * bx;
+        const double Ty        = local_invgf * by;
+        const double Tz        = local_invgf * bz;
+        const double inv_det_T = 1.0/( 1.0+Tx*Tx+Ty*Ty+Tz*Tz );
+
+        pxsm += ( ( 1.0+Tx*Tx-Ty*Ty-Tz*Tz )* umx  +      2.0*( Tx*Ty+Tz )* umy  +      2.0*( Tz*Tx-Ty )* umz )*inv_det_T;
+        pysm += ( 2.0*( Tx*Ty-Tz )* umx  + ( 1.0-Tx*Tx+Ty*Ty-Tz*Tz )* umy  +      2.0*( Ty*Tz+Tx )* umz )*inv_det_T;
+        pzsm += ( 2.0*( Tz*Tx+Ty )* umx  +      2.0*( Ty*Tz-Tx )* umy  + ( 1.0-Tx*Tx-Ty*Ty+Tz*Tz )* umz )*inv_det_T;
+
+        // finalize Half-acceleration in the electric field
+        local_invgf = 1. / std::sqrt( 1.0 + pxsm*pxsm + pysm*pysm + pzsm*pzsm );
+        invgf[ipart2] = local_invgf;
+
+        momentum_x[ipart] = pxsm;
+        momentum_y[ipart] = pysm;
+        momentum_z[ipart] = pzsm;
+
+        // Move the particle
+        local_invgf *= dt;
+        position_x[ipart] += pxsm*local_invgf;
+        if( nDim_ > 1 ) {
+            position_y[ipart] += pysm*local_invgf;
+            if( nDim_ > 2 ) {
+                position_z[ipart] += pzsm*local_invgf;
+            }
+        }
+    }
+
+    radiated_energy += radiated_energy_loc;
+}
@@ -0,0 +1,56 @@
+/*! @file PusherBorisRadiation.h
+
+ @brief PusherBorisRadiation.h  Boris pusher fused with the continuous radiation reaction
+
+ */
+
+#ifndef PUSHERBORISRADIATION_H
+#define PUSHERBORISRADIATION_H
+
+#include <vector>
+
+#include "Pusher.h"
+
+class Random;
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class PusherBorisRadiation: Boris pusher that first applies the radiation reaction of the
+//! Landau-Lifshitz, corrected Landau-Lifshitz or Niel models, in the same loop over the particles.
+//! The Lorentz factor and the quantum parameter are computed once, from the momenta and fields
+//! already loaded for the push, instead of in a separate pass of the radiation operator.
+//  --------------------------------------------------------------------------------------------------------------------
+class PusherBorisRadiation : public Pusher
+{
+public:
+    //! Creator for Pusher
+    PusherBorisRadiation( Params &params, Species *species, Random *rand );
+    ~PusherBorisRadiation();
+
+    //! Overloading of () operator: push without radiation reaction
+    void operator()( Particles &particles, SmileiMPI *smpi, int istart, int iend, int ithread, int ipart_buffer_offset = 0 ) override;
+
+    //! Radiation reaction followed by the push, in the same loop
+    void pushWithRadiation( Particles &particles, SmileiMPI *smpi, RadiationTables &radiation_tables, double &radiated_energy,
+                            int istart, int iend, int ithread, int ipart_buffer_offset = 0 ) override;
+
+private:
+
+    //! Fused loop, for the model index `model` (see model_)
+    template<int model>
+    void pushAndRadiate( Particles &particles, SmileiMPI *smpi, RadiationTables *radiation_tables, double &radiated_energy,
+                         int istart, int iend, int ithread, int ipart_buffer_offset );
+
+    //! Radiation model: 0 no radiation, 1 Landau-Lifshitz, 2 corrected Landau-Lifshitz, 3 Niel
+    int model_;
+
+    //! Inverse of the normalized Schwinger electric field
+    double inv_norm_E_Schwinger_;
+
+    //! Local random generator (Niel model)
+    Random *rand_;
+
+    //! Uniform random numbers in ]-1, 1[ of the Niel model, drawn before the fused loop
+    std::vector<double> random_numbers_;
+};
+
+#endif
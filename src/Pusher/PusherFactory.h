@@ -11,6 +11,7 @@
 
 #include "Pusher.h"
 #include "PusherBoris.h"
+#include "PusherBorisRadiation.h"
 #include "PusherBorisBTIS3.h"
 #include "PusherPonderomotiveBoris.h"
 #include "PusherPonderomotivePositionBoris.h"
@@ -37,8 +38,9 @@ public:
     //! Create appropriate pusher for the species ispec
     //! \param ispec SpeciesId
     //! \param params Parameters
+    //! \param rand Random generator of the patch (for the pushers fused with the radiation reaction)
     //  --------------------------------------------------------------------------------------------------------------------
-    static Pusher *create( Params &params, Species *species )
+    static Pusher *create( Params &params, Species *species, Random *rand = nullptr )
     {
         Pusher *Push = NULL;
         
@@ -47,7 +49,11 @@ public:
             // assign the correct Pusher to Push
             // Pusher of Boris
             if( species->pusher_name_ == "boris" ) {
+                if( species->fused_radiation_ ) {
+                    Push = new PusherBorisRadiation( params, species, rand );
+                } else {
                     Push = new PusherBoris( params, species );
+                }
             } else if( species->pusher_name_ == "ponderomotive_boris" ) {
             
                 int n_envlaser = params.Laser_Envelope_model;
@@ -15,6 +15,7 @@
 #include "Species.h"
 
 #include "Particles.h"
+#include "Simd.h"
 
 PusherHigueraCary::PusherHigueraCary( Params &params, Species *species )
     : Pusher( params, species )
@@ -53,7 +54,69 @@ void PusherHigueraCary::operator()( Particles &particles, SmileiMPI *smpi, int i
     double *const __restrict__ momentum_z = particles.getPtrMomentum(2);
 
     short *const __restrict__ charge = particles.getPtrCharge();
-    
+
+#if defined( SMILEI_EXPLICIT_SIMD )
+    // Explicit SIMD backend: SimdDouble::width particles per iteration,
+    // the lanes after iend are zeroed at load and discarded at store
+    const int width = SimdDouble::width;
+    for( int ipart=istart ; ipart<iend; ipart += width ) {
+
+        const int n      = iend - ipart;
+        const int ipart2 = ipart - ipart_buffer_offset;
+
+        const SimdDouble charge_over_mass_dts2 = SimdDouble::convertPartial( charge+ipart, n )*one_over_mass_*dts2;
+
+        // init Half-acceleration in the electric field
+        SimdDouble pxsm = charge_over_mass_dts2*SimdDouble::loadPartial( Ex+ipart2, n );
+        SimdDouble pysm = charge_over_mass_dts2*SimdDouble::loadPartial( Ey+ipart2, n );
+        SimdDouble pzsm = charge_over_mass_dts2*SimdDouble::loadPartial( Ez+ipart2, n );
+
+        const SimdDouble umx = SimdDouble::loadPartial( momentum_x+ipart, n ) + pxsm;
+        const SimdDouble umy = SimdDouble::loadPartial( momentum_y+ipart, n ) + pysm;
+        const SimdDouble umz = SimdDouble::loadPartial( momentum_z+ipart, n ) + pzsm;
+
+        // Intermediate gamma factor: only this part differs from the Boris scheme
+        const SimdDouble gfm2 = 1.0 + umx*umx + umy*umy + umz*umz;
+
+        SimdDouble Tx = charge_over_mass_dts2*SimdDouble::loadPartial( Bx+ipart2, n );
+        SimdDouble Ty = charge_over_mass_dts2*SimdDouble::loadPartial( By+ipart2, n );
+        SimdDouble Tz = charge_over_mass_dts2*SimdDouble::loadPartial( Bz+ipart2, n );
+
+        const SimdDouble beta2 = Tx*Tx + Ty*Ty + Tz*Tz;
+        const SimdDouble Tum   = Tx*umx + Ty*umy + Tz*umz;
+        const SimdDouble s     = gfm2 - beta2;
+
+        SimdDouble local_invgf = 1./sqrt( 0.5*( s + sqrt( s*s + 4.0*( beta2 + Tum*Tum ) ) ) );
+
+        // Rotation in the magnetic field
+        Tx *= local_invgf;
+        Ty *= local_invgf;
+        Tz *= local_invgf;
+        const SimdDouble inv_det_T = 1.0/( 1.0+Tx*Tx+Ty*Ty+Tz*Tz );
+
+        pxsm += ( ( 1.0+Tx*Tx-Ty*Ty-Tz*Tz )* umx  +      2.0*( Tx*Ty+Tz )* umy  +      2.0*( Tz*Tx-Ty )* umz )*inv_det_T;
+        pysm += ( 2.0*( Tx*Ty-Tz )* umx  + ( 1.0-Tx*Tx+Ty*Ty-Tz*Tz )* umy  +      2.0*( Ty*Tz+Tx )* umz )*inv_det_T;
+        pzsm += ( 2.0*( Tz*Tx+Ty )* umx  +      2.0*( Ty*Tz-Tx )* umy  + ( 1.0-Tx*Tx-Ty*Ty+Tz*Tz )* umz )*inv_det_T;
+
+        // final gamma factor, kept in register for the position update
+        local_invgf = 1. / sqrt( 1.0 + pxsm*pxsm + pysm*pysm + pzsm*pzsm );
+        local_invgf.storePartial( invgf+ipart2, n );
+
+        pxsm.storePartial( momentum_x+ipart, n );
+        pysm.storePartial( momentum_y+ipart, n );
+        pzsm.storePartial( momentum_z+ipart, n );
+
+        // Move the particle
+        local_invgf *= dt;
+        ( SimdDouble::loadPartial( position_x+ipart, n ) + pxsm*local_invgf ).storePartial( position_x+ipart, n );
+        if( nDim_ > 1 ) {
+            ( SimdDouble::loadPartial( position_y+ipart, n ) + pysm*local_invgf ).storePartial( position_y+ipart, n );
+            if( nDim_ > 2 ) {
+                ( SimdDouble::loadPartial( position_z+ipart, n ) + pzsm*local_invgf ).storePartial( position_z+ipart, n );
+            }
+        }
+    }
+#else
 #if defined( SMILEI_ACCELERATOR_GPU_OMP )
     const int istart_offset   = istart - ipart_buffer_offset;
     const int particle_number = iend - istart;
@@ -164,6 +227,7 @@ void PusherHigueraCary::operator()( Particles &particles, SmileiMPI *smpi, int i
             }
         }
     } // end ipart
+#endif
 
     // if (nDim_>1) {
     //     #pragma omp simd
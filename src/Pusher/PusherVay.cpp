@@ -15,6 +15,7 @@
 #include "Species.h"
 
 #include "Particles.h"
+#include "Simd.h"
 
 PusherVay::PusherVay( Params &params, Species *species )
     : Pusher( params, species )
@@ -52,7 +53,86 @@ void PusherVay::operator()( Particles &particles, SmileiMPI *smpi, int istart, i
     const double *const __restrict__ Bx = &( ( *Bpart )[0*nparts] );
     const double *const __restrict__ By = &( ( *Bpart )[1*nparts] );
     const double *const __restrict__ Bz = &( ( *Bpart )[2*nparts] );
-    
+
+#if defined( SMILEI_EXPLICIT_SIMD )
+    // Explicit SIMD backend: SimdDouble::width particles per iteration,
+    // the lanes after iend are zeroed at load and discarded at store
+    const int width = SimdDouble::width;
+    for( int ipart=istart ; ipart<iend; ipart += width ) {
+
+        const int n      = iend - ipart;
+        const int ipart2 = ipart - ipart_buffer_offset;
+
+        const SimdDouble charge_over_mass_dts2 = SimdDouble::convertPartial( charge+ipart, n )*one_over_mass_*dts2;
+
+        const SimdDouble px = SimdDouble::loadPartial( momentum_x+ipart, n );
+        const SimdDouble py = SimdDouble::loadPartial( momentum_y+ipart, n );
+        const SimdDouble pz = SimdDouble::loadPartial( momentum_z+ipart, n );
+
+        // ____________________________________________
+        // Part I: Computation of uprime
+
+        const SimdDouble old_invgf = 1./sqrt( 1.0 + px*px + py*py + pz*pz );
+
+        // Add Electric field
+        SimdDouble upx = px + 2.*charge_over_mass_dts2*SimdDouble::loadPartial( Ex+ipart2, n );
+        SimdDouble upy = py + 2.*charge_over_mass_dts2*SimdDouble::loadPartial( Ey+ipart2, n );
+        SimdDouble upz = pz + 2.*charge_over_mass_dts2*SimdDouble::loadPartial( Ez+ipart2, n );
+
+        // Add magnetic field
+        SimdDouble Tx = charge_over_mass_dts2*SimdDouble::loadPartial( Bx+ipart2, n );
+        SimdDouble Ty = charge_over_mass_dts2*SimdDouble::loadPartial( By+ipart2, n );
+        SimdDouble Tz = charge_over_mass_dts2*SimdDouble::loadPartial( Bz+ipart2, n );
+
+        upx += old_invgf*( py*Tz - pz*Ty );
+        upy += old_invgf*( pz*Tx - px*Tz );
+        upz += old_invgf*( px*Ty - py*Tx );
+
+        // alpha is gamma^2
+        SimdDouble alpha    = 1.0 + upx*upx + upy*upy + upz*upz;
+        const SimdDouble T2 = Tx*Tx + Ty*Ty + Tz*Tz;
+
+        // ___________________________________________
+        // Part II: Computation of Gamma^{i+1}
+
+        // s is sigma
+        SimdDouble s   = alpha - T2;
+        SimdDouble us2 = upx*Tx + upy*Ty + upz*Tz;
+        us2 = us2*us2;
+
+        // alpha becomes 1/gamma^{i+1}
+        alpha = 1.0/sqrt( 0.5*( s + sqrt( s*s + 4.0*( T2 + us2 ) ) ) );
+
+        Tx *= alpha;
+        Ty *= alpha;
+        Tz *= alpha;
+
+        s     = 1.0/( 1.0+Tx*Tx+Ty*Ty+Tz*Tz );
+        alpha = upx*Tx + upy*Ty + upz*Tz;
+
+        const SimdDouble pxsm = s*( upx + alpha*Tx + Tz*upy - Ty*upz );
+        const SimdDouble pysm = s*( upy + alpha*Ty + Tx*upz - Tz*upx );
+        const SimdDouble pzsm = s*( upz + alpha*Tz + Ty*upx - Tx*upy );
+
+        // Inverse Gamma factor, kept in register for the position update
+        SimdDouble local_invgf = 1.0 / sqrt( 1.0 + pxsm*pxsm + pysm*pysm + pzsm*pzsm );
+        local_invgf.storePartial( invgf+ipart2, n );
+
+        pxsm.storePartial( momentum_x+ipart, n );
+        pysm.storePartial( momentum_y+ipart, n );
+        pzsm.storePartial( momentum_z+ipart, n );
+
+        // Move the particle
+        local_invgf *= dt;
+        ( SimdDouble::loadPartial( position_x+ipart, n ) + pxsm*local_invgf ).storePartial( position_x+ipart, n );
+        if( nDim_ > 1 ) {
+            ( SimdDouble::loadPartial( position_y+ipart, n ) + pysm*local_invgf ).storePartial( position_y+ipart, n );
+            if( nDim_ > 2 ) {
+                ( SimdDouble::loadPartial( position_z+ipart, n ) + pzsm*local_invgf ).storePartial( position_z+ipart, n );
+            }
+        }
+    }
+#else
 #if defined( SMILEI_ACCELERATOR_GPU_OMP )
     const int istart_offset   = istart - ipart_buffer_offset;
     const int particle_number = iend - istart;
@@ -170,6 +250,7 @@ void PusherVay::operator()( Particles &particles, SmileiMPI *smpi, int istart, i
             }
         }
     } // end ipart
+#endif
 
     // if (nDim_>1) {
     //     #pragma omp simd
@@ -30,6 +30,14 @@ def _prepare_checkpoint_dir():
                 _mkdir("checkpoint", group_dir)
         else:
             _mkdir("checkpoint", checkpoint_dir)
+    # Node-local directory, created by each process
+    if Checkpoints.local_dir and (Checkpoints.dump_step>0 or Checkpoints.dump_minutes>0.):
+        try:
+            os.makedirs(Checkpoints.local_dir)
+        except:
+            pass
+        if not os.path.isdir(Checkpoints.local_dir):
+            raise Exception("ERROR in the namelist: local checkpoint "+Checkpoints.local_dir+" cannot be created")
 
 def _smilei_check():
     """Do checks over the script"""
@@ -37,7 +45,7 @@ def _smilei_check():
     # Verify classes were not overriden
     for CheckClassName in ["SmileiComponent","Species", "Laser","Collisions",
             "DiagProbe","DiagParticleBinning", "DiagScalar","DiagFields",
-            "DiagTrackParticles","DiagNewParticles","DiagPerformances",
+            "DiagTrackParticles","DiagNewParticles","DiagPerformances","DiagInSitu",
             "ExternalField","PrescribedField",
             "SmileiSingleton","Main","Checkpoints","LoadBalancing","MovingWindow",
             "RadiationReaction", "ParticleData", "MultiphotonBreitWheeler",
@@ -52,25 +60,34 @@ def _smilei_check():
     if len(Checkpoints)==1 and Checkpoints.restart_dir:
         if len(Checkpoints.restart_files) == 0 :
             Checkpoints.restart = True
-            pattern = Checkpoints.restart_dir + os.sep + "checkpoints" + os.sep
-            if Checkpoints.file_grouping:
-                pattern += "*"+ os.sep
-            pattern += "dump-*-*.h5"
-            # pick those file that match the mpi rank
-            files = filter(lambda a: smilei_mpi_rank==int(search(r'dump-[0-9]*-([0-9]*).h5$',a).groups()[-1]), glob(pattern))
-            
+            # The indexes of the complete dumps avoid searching the files of all processes
+            indexes = glob(Checkpoints.restart_dir + os.sep + "checkpoints" + os.sep + "index-*.h5")
             if Checkpoints.restart_number is not None:
-                # pick those file that match the restart_number
-                files = filter(lambda a: Checkpoints.restart_number==int(search(r'dump-([0-9]*)-[0-9]*.h5$',a).groups()[-1]), files)
-            
-            Checkpoints.restart_files = list(files)
-            
-            if len(Checkpoints.restart_files) == 0:
-                raise Exception(
-                "ERROR in the namelist: cannot find valid restart files for processor "+str(smilei_mpi_rank) +
-                "\n\t\trestart_dir = '" + Checkpoints.restart_dir +
-                "'\n\t\trestart_number = " + str(Checkpoints.restart_number) +
-                "\n\t\tmatching pattern: '" + pattern + "'" )
+                indexes = [i for i in indexes if Checkpoints.restart_number==int(search(r'index-([0-9]*).h5$',i).groups()[-1])]
+            if indexes:
+                Checkpoints.restart_from_index = True
+                Checkpoints.restart_files = indexes
+            else:
+                pattern = Checkpoints.restart_dir + os.sep + "checkpoints" + os.sep
+                if Checkpoints.file_grouping:
+                    pattern += "*"+ os.sep
+                pattern += "dump-*-*.h5"
+                # pick those file that match the mpi rank
+                files = filter(lambda a: smilei_mpi_rank==int(search(r'dump-[0-9]*-([0-9]*).h5$',a).groups()[-1]), glob(pattern))
+                
+                if Checkpoints.restart_number is not None:
+                    # pick those file that match the restart_number
+                    files = filter(lambda a: Checkpoints.restart_number==int(search(r'dump-([0-9]*)-[0-9]*.h5$',a).groups()[-1]), files)
+                
+                Checkpoints.restart_files = list(files)
+                
+                # The restart may only use the node-local dumps
+                if len(Checkpoints.restart_files) == 0 and not Checkpoints.local_dir:
+                    raise Exception(
+                    "ERROR in the namelist: cannot find valid restart files for processor "+str(smilei_mpi_rank) +
+                    "\n\t\trestart_dir = '" + Checkpoints.restart_dir +
+                    "'\n\t\trestart_number = " + str(Checkpoints.restart_number) +
+                    "\n\t\tmatching pattern: '" + pattern + "'" )
             
         else :
             raise Exception("restart_dir and restart_files are both not empty")
@@ -159,6 +176,9 @@ def _keep_python_running():
     # Verify SDMD grids
     if len(LoadBalancing)>0 and len(MultipleDecomposition)>0:
         return True
+    # Verify the in-situ diagnostics, which call a python function
+    if len(DiagInSitu)>0:
+        return True
     # Verify the tracked species that require a particle selection
     if any([d.filter for d in DiagTrackParticles]) or any([d.filter for d in DiagNewParticles]):
         return True
@@ -171,6 +171,18 @@ class Main(SmileiSingleton):
     patch_arrangement = "hilbertian"
     cluster_width = -1
     every_clean_particles_overhead = 100
+    particles_capacity_margin = 0.
+    particles_forecast_length = 0
+    pack_exchanged_particles = False
+    neighborhood_collectives = False
+    shared_memory_halos = False
+    overlap_current_sums = False
+    sparse_current_sums = False
+    topology_aware_placement = False
+    adaptive_sorting = False
+    dynamics_scheduling = "runtime"
+    numa_domains = 1
+    fields_arena = False
     timestep = None
     number_of_AM = 2
     number_of_AM_relativistic_field_initialization = 1
@@ -187,6 +199,7 @@ class Main(SmileiSingleton):
     solve_poisson = True
     poisson_max_iteration = 50000
     poisson_max_error = 1.e-14
+    poisson_solver = "CG"
 
     # Relativistic Poisson tuning
     solve_relativistic_poisson = False
@@ -198,6 +211,7 @@ class Main(SmileiSingleton):
 
     # Default fields
     maxwell_solver = 'Yee'
+    maxwell_skip_vacuum = False
     EM_boundary_conditions = [["periodic"]]
     EM_boundary_conditions_k = []
     save_magnectic_fields_for_SM = True
@@ -220,8 +234,11 @@ class Main(SmileiSingleton):
     # Default Misc
     reference_angular_frequency_SI = 0.
     print_every = None
+    telemetry_every = 0
     random_seed = None
+    counter_based_random = False
     print_expected_disk_usage = True
+    diagnostics_window = 0
 
     terminal_mode = True
 
@@ -331,6 +348,12 @@ class LoadBalancing(SmileiSingleton):
     initial_balance      = True
     cell_load            = 1.0
     frozen_particle_load = 0.1
+    vacuum_cell_load     = None
+    batched_exchange     = False
+    measured_load_steps  = 0
+    imbalance_threshold  = 0.
+    memory_cap           = 0.
+    gpu_rank_capability  = 1.
 
 class MultipleDecomposition(SmileiSingleton):
     """Multiple Decomposition parameters"""
@@ -344,6 +367,14 @@ class Vectorization(SmileiSingleton):
     mode                = "off"
     reconfigure_every   = 20
     initial_mode        = "off"
+    granularity         = "patch"
+    cost_model          = "fit"
+    calibration_period  = 0
+    cell_ordering       = "lexicographic"
+    colored_deposition  = False
+    reuse_shape_coefficients = False
+    float_accumulation  = False
+    float_accumulation_check = False
 
 
 class MovingWindow(SmileiSingleton):
@@ -353,6 +384,8 @@ class MovingWindow(SmileiSingleton):
     velocity_x = 1.
     number_of_additional_shifts = 0
     additional_shifts_time = 0.
+    lazy_particle_creation = False
+    recycle_patches = False
 
 
 class Checkpoints(SmileiSingleton):
@@ -363,10 +396,19 @@ class Checkpoints(SmileiSingleton):
     dump_step = 0
     dump_minutes = 0.
     keep_n_dumps = 2
+    incremental_dumps = 0
     dump_deflate = 0
+    compression = ""
+    compression_parameters = []
+    single_precision = []
     exit_after_dump = True
+    asynchronous = False
+    local_dir = None
+    local_dumps = 0
     file_grouping = 0
+    restart_in_memory = False
     restart_files = []
+    restart_from_index = False
 
 class CurrentFilter(SmileiSingleton):
     """Current filtering parameters"""
@@ -403,6 +445,7 @@ class Species(SmileiComponent):
     radiation_photon_species = None
     radiation_photon_sampling = 1
     radiation_photon_gamma_threshold = 2.
+    radiation_photon_merging_threshold = 0.
     radiation_max_emissions = 10
 
     # Multiphoton Breit-Wheeler parameters
@@ -420,19 +463,32 @@ class Species(SmileiComponent):
     merge_accumulation_correction = True
     merge_discretization_scale = "linear"
     merge_min_momentum = 1e-5
+    merge_target_particles_per_cell = 0
+    merge_memory_budget = 0.
+
+    # Particle splitting species Parameters
+    split_every = 0
+    split_max_particles_per_cell = 0
+    split_factor = 2
 
     time_frozen = 0.0
+    push_every = 1
     radiating = False
     relativistic_field_initialization = False
     boundary_conditions = [["periodic"]]
     ionization_model = "none"
     ionization_electrons = None
     ionization_rate = None
+    ionization_rate_table = []
+    ionization_table_field_range = []
+    ionization_table_size = 512
     atomic_number = None
     maximum_charge_state = 0
     is_test = False
     relativistic_field_initialization = False
     keep_interpolated_fields = []
+    fused_dynamics = False
+    fused_radiation = False
 
 class ParticleInjector(SmileiComponent):
     """Parameters for particle injection at boundaries"""
@@ -483,6 +539,7 @@ class LaserEnvelope(SmileiSingleton):
     Env_pml_alpha_parameters = [[0.00,0.00,1],[0.05,0.05,1],[0.05,0.05,1]]
     polarization_phi = 0.
     ellipticity = 0.
+    reuse_interpolation_coefficients = False
 
 
 class Collisions(SmileiComponent):
@@ -494,9 +551,15 @@ class Collisions(SmileiComponent):
     every = 1
     debug_every = 0
     time_frozen = 0
+    adaptive_every = 0
+    adaptive_s = 0.1
+    bin_tasks = 0
+    debye_length_every = 1
+    debye_length_tolerance = 0.
     ionizing = False
     nuclear_reaction = None
     nuclear_reaction_multiplier = 0.
+    nuclear_reaction_min_weight = 0.
 
 
 #diagnostics
@@ -522,6 +585,8 @@ class DiagParticleBinning(SmileiComponent):
     axes = []
     every = None
     flush_every = 1
+    reduction = "atomic"
+    storage = "dense"
 
 class DiagRadiationSpectrum(SmileiComponent):
     """Radiation Spectrum diagnostic"""
@@ -532,6 +597,8 @@ class DiagRadiationSpectrum(SmileiComponent):
     axes = []
     every = None
     flush_every = 1
+    reduction = "atomic"
+    storage = "dense"
 
 class DiagScreen(SmileiComponent):
     """Screen diagnostic"""
@@ -546,12 +613,16 @@ class DiagScreen(SmileiComponent):
     time_average = 1
     every = None
     flush_every = 1
+    reduction = "atomic"
+    storage = "dense"
 
 class DiagScalar(SmileiComponent):
     """Scalar diagnostic"""
     every = None
     precision = 10
     vars = []
+    asynchronous = False
+    reduction = "atomic"
 
 class DiagFields(SmileiComponent):
     """Field diagnostic"""
@@ -560,8 +631,22 @@ class DiagFields(SmileiComponent):
     fields = []
     time_average = 1
     subgrid = None
+    subgrid_average = False
+    subgrid_reduction = ""
+    subgrid_accumulation = False
+    frequencies = []
     flush_every = 1
     datatype = "double"
+    asynchronous = False
+    aggregators_per_node = 0
+    striping_factor = 0
+    striping_unit = 0
+    compression = ""
+    compression_parameters = []
+    compression_accuracy = 0.
+    backend = "hdf5"
+    adios2_engine = "BP5"
+    adios2_parameters = {}
 
 class DiagTrackParticles(SmileiComponent):
     """Track diagnostic"""
@@ -571,6 +656,12 @@ class DiagTrackParticles(SmileiComponent):
     flush_every = 1
     filter = None
     attributes = ["x", "y", "z", "px", "py", "pz", "w"]
+    compression = ""
+    compression_parameters = []
+    compression_accuracy = 0.
+    buffer_iterations = 1
+    buffer_memory = 0.
+    sorted_output = False
 
 class DiagNewParticles(SmileiComponent):
     """Track diagnostic"""
@@ -580,12 +671,24 @@ class DiagNewParticles(SmileiComponent):
     flush_every = 1
     filter = None
     attributes = ["x", "y", "z", "px", "py", "pz", "w"]
+    record_every = 1
+    buffer_size = 0
+
+class DiagInSitu(SmileiComponent):
+    """In-situ analysis diagnostic"""
+    every = 0
+    callback = None
+    fields = []
+    species = []
 
 class DiagPerformances(SmileiSingleton):
     """Performances diagnostic"""
     every = 0
     flush_every = 1
     patch_information = True
+    operator_sampling_every = 0
+    hardware_counters = []
+    memory_warning = 0.9
 
 # external fields
 class ExternalField(SmileiComponent):
@@ -598,6 +701,8 @@ class PrescribedField(SmileiComponent):
     """External Time Field"""
     field = None
     profile = None
+    space_profile = None
+    time_profile = None
 
 # external current (antenna)
 class Antenna(SmileiComponent):
@@ -630,6 +735,13 @@ class RadiationReaction(SmileiComponent):
 
     # Path to read or write the tables/databases
     table_path = ""
+    # Single precision tables with a fast logarithm, and their validation
+    compact_tables = False
+    compact_tables_validation = False
+    # Computation of the tables at initialization
+    compute_tables = False
+    table_size = [256, 256]
+    table_chi_range = [1e-4, 1e3]
 
     # Parameters for computing the tables
     Niel_computation_method = "table"
@@ -641,12 +753,88 @@ class MultiphotonBreitWheeler(SmileiComponent):
     """
     # Path the tables/databases
     table_path = ""
+    # Single precision tables with a fast logarithm, and their validation
+    compact_tables = False
+    compact_tables_validation = False
+    # Computation of the tables at initialization
+    compute_tables = False
+    table_size = [256, 256]
+    table_chi_range = [1e-2, 1e2]
 
 # Smilei-defined
 smilei_mpi_rank = 0
+smilei_gpu_build = 0
 smilei_mpi_size = 1
 smilei_omp_threads = 1
 smilei_total_cores = 1
 
 # Variable to set to False for the actual run (useful for the test mode)
 _test_mode = True
+
+
+# Broadcast of the namelist (environment variable SMILEI_NAMELIST_BROADCAST): only the master
+# executes the user namelist, then its new global variables and the state of the components are
+# pickled and broadcast to the other processes. The functions defined in the namelist (profiles)
+# are sent as compiled code, so that they are still evaluated locally by each process.
+def _smilei_snapshot_namelist():
+    global _smilei_namelist_snapshot
+    components = {k:v for k,v in globals().items() if isinstance(v, SmileiComponentType)}
+    _smilei_namelist_snapshot = (dict(globals()), {k:dict(c.__dict__) for k,c in components.items()})
+
+def _smilei_new_function(code, name, ncells):
+    import marshal, types
+    return types.FunctionType(marshal.loads(code), globals(), name, None, tuple(types.CellType() for i in range(ncells)))
+
+def _smilei_set_function_state(f, state):
+    f.__qualname__, f.__defaults__, f.__kwdefaults__, attributes, cells = state
+    f.__dict__.update(attributes)
+    for cell, value in zip(f.__closure__ or (), cells):
+        cell.cell_contents = value
+
+def _smilei_serialize_namelist():
+    global _smilei_namelist_data
+    import pickle, io, base64, importlib, marshal, sys, types
+    old_globals, old_components = _smilei_namelist_snapshot
+    class NamelistPickler(pickle.Pickler):
+        def reducer_override(self, obj):
+            if isinstance(obj, types.ModuleType):
+                return importlib.import_module, (obj.__name__,)
+            if isinstance(obj, staticmethod):
+                return staticmethod, (obj.__func__,)
+            if isinstance(obj, types.FunctionType) and obj.__module__ == "__main__" and old_globals.get(obj.__name__) is not obj:
+                cells = [c.cell_contents for c in obj.__closure__ or ()]
+                state = (obj.__qualname__, obj.__defaults__, obj.__kwdefaults__, obj.__dict__, cells)
+                return _smilei_new_function, (marshal.dumps(obj.__code__), obj.__name__, len(cells)), state, None, None, _smilei_set_function_state
+            if isinstance(obj, type) and obj.__module__ == "__main__" and old_globals.get(obj.__name__) is not obj:
+                raise pickle.PicklingError("class "+obj.__name__+" is defined in the namelist")
+            return NotImplemented
+    try:
+        if sys.version_info < (3,8):
+            raise Exception("python 3.8 or newer is required")
+        g = globals()
+        new_globals = {k:v for k,v in g.items() if not k.startswith("__") and k != "_smilei_namelist_snapshot"
+                                                    and (k not in old_globals or old_globals[k] is not v)}
+        components = {}
+        for name, old_attributes in old_components.items():
+            cls = g[name]
+            attributes = {k:v for k,v in cls.__dict__.items() if k != "_list" and (k not in old_attributes or old_attributes[k] is not v)}
+            components[name] = (attributes, cls._list)
+        data = io.BytesIO()
+        NamelistPickler(data, pickle.HIGHEST_PROTOCOL).dump((new_globals, components))
+        _smilei_namelist_data = base64.b64encode(data.getvalue()).decode("ascii")
+    except Exception as e:
+        print("Python warning: the namelist cannot be broadcast ("+str(e)+"), it is executed by all processes")
+        _smilei_namelist_data = ""
+
+def _smilei_deserialize_namelist():
+    global _smilei_namelist_data
+    import pickle, base64
+    new_globals, components = pickle.loads(base64.b64decode(_smilei_namelist_data))
+    g = globals()
+    for name, (attributes, instances) in components.items():
+        cls = g[name]
+        for k, v in attributes.items():
+            setattr(cls, k, v)
+        cls._list[:] = instances
+    g.update(new_globals)
+    del _smilei_namelist_data
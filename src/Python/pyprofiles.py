@@ -454,6 +454,19 @@ def tsin2plateau(start=0., fwhm=0., plateau=None, slope1=None, slope2=None):
     f.slope2      = slope2
     return f
 
+def compiled(library, function):
+    import ctypes
+    global Main
+    if len(Main)==0:
+        raise Exception("compiled profile has been defined before `Main()`")
+    c_function = getattr(ctypes.CDLL(library), function)
+    c_function.restype = ctypes.c_double
+    f = lambda *args: c_function(*[ctypes.c_double(a) for a in args])
+    f.profileName = "compiled"
+    f.library     = library
+    f.function    = function
+    return f
+
 
 def transformPolarization(polarization_phi, ellipticity):
     from math import pi, sqrt, sin, cos, tan, atan2
@@ -775,7 +788,7 @@ try:
     
     def LaserOffset(box_side="xmin", space_time_profile=[], offset=0., angle=0., extra_envelope=lambda *a:1.,
             fft_time_window=None, fft_time_step=None, keep_n_strongest_modes=100,
-            number_of_processes=None, file=None):
+            number_of_processes=None, file=None, cache_directory=None):
         global _N_LaserOffset
         
         file_ = file or ('LaserOffset'+str(_N_LaserOffset)+'.h5')
@@ -793,6 +806,7 @@ try:
         L._keep_n_strongest_modes = keep_n_strongest_modes
         L._angle = angle
         L._number_of_processes = number_of_processes
+        L._cache_directory = cache_directory or ""
         if file:
             if not os.path.exists(file):
                 raise Exception("File not found or not accessible: "+file)
@@ -804,7 +818,7 @@ try:
 
 except:
     
-    def LaserOffset(box_side="xmin", space_time_profile=[], offset=0., fft_time_window=None, extra_envelope=lambda *a:1., keep_n_strongest_modes=100, angle=0., number_of_processes=None, file=None):
+    def LaserOffset(box_side="xmin", space_time_profile=[], offset=0., fft_time_window=None, extra_envelope=lambda *a:1., keep_n_strongest_modes=100, angle=0., number_of_processes=None, file=None, cache_directory=None):
         L = Laser(
             box_side = box_side,
             file = "none",
@@ -0,0 +1,582 @@
+// ----------------------------------------------------------------------------
+//! \file QEDTablesComputation.cpp
+//
+//! \brief Computation of the QED tables (nonlinear inverse Compton scattering
+//! and multiphoton Breit-Wheeler) at initialization
+//
+//! \details The physics follows the external tool `smilei_tables`
+//! (tools/tables). The implementation is adapted from the following results:
+//! - Niel et al.
+//! - M. Lobet (http://www.theses.fr/2015BORD0361)
+// ----------------------------------------------------------------------------
+
+#include "QEDTablesComputation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#include "H5.h"
+
+// Search of the lower bound of the xi axes, as in the external tool:
+// minimum targeted value of xi, and maximum decrease in order of magnitude
+static const double radiation_xi_threshold = 1e-3;
+static const double radiation_xi_power = 4;
+static const double mBW_xi_threshold = 1e-9;
+static const double mBW_xi_power = 5;
+
+// Number of points of the quadratures between two consecutive values of the xi axis
+static const int xi_interval_discretization = 32;
+
+// -----------------------------------------------------------------------------
+//! Compute the rows of a table: the rows are distributed by contiguous
+//! blocks over the MPI ranks, and dynamically over the OpenMP threads.
+//! All ranks get all the rows in data.
+//! \param number_of_rows number of rows
+//! \param row_size number of values per row
+//! \param data table data of size number_of_rows*row_size
+//! \param computeRow function computing the row of index irow in its argument
+// -----------------------------------------------------------------------------
+template<typename RowFunction>
+static void computeRows( unsigned int number_of_rows, unsigned int row_size,
+                         double *data, SmileiMPI *smpi, RowFunction computeRow )
+{
+    const int number_of_ranks = smpi->getSize();
+    const int rank = smpi->getRank();
+
+    std::vector<int> first_value( number_of_ranks ), number_of_values( number_of_ranks );
+    for( int irank = 0; irank < number_of_ranks; irank++ ) {
+        const unsigned int first_row = ( ( uint64_t )irank*number_of_rows )/number_of_ranks;
+        const unsigned int last_row = ( ( uint64_t )( irank+1 )*number_of_rows )/number_of_ranks;
+        first_value[irank] = first_row*row_size;
+        number_of_values[irank] = ( last_row-first_row )*row_size;
+    }
+
+    const int first_row = first_value[rank]/row_size;
+    const int local_rows = number_of_values[rank]/row_size;
+    std::vector<double> buffer( number_of_values[rank] );
+
+    #pragma omp parallel for schedule(dynamic)
+    for( int irow = 0; irow < local_rows; irow++ ) {
+        computeRow( first_row + irow, &buffer[irow*row_size] );
+    }
+
+    MPI_Allgatherv( buffer.data(), number_of_values[rank], MPI_DOUBLE,
+                    data, &number_of_values[0], &first_value[0], MPI_DOUBLE,
+                    smpi->world() );
+}
+
+// -----------------------------------------------------------------------------
+// TABLES
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Computation of the tables of the nonlinear inverse Compton scattering
+//
+//! \param niel table h of Niel et al.
+//! \param integfochi table of the integral of the emissivity divided by photon_chi
+//! \param xi tables min_photon_chi_for_xi and xi
+//! \param size sizes of the particle and photon quantum parameter axes
+//! \param min_chi, max_chi boundaries of the particle quantum parameter axis
+//! \param smpi Object of class SmileiMPI containing MPI properties
+// -----------------------------------------------------------------------------
+void QEDTablesComputation::computeRadiationTables( Table &niel, Table &integfochi, Table2D &xi,
+                                                   std::vector<unsigned int> size,
+                                                   double min_chi, double max_chi,
+                                                   SmileiMPI *smpi )
+{
+    const double log10_min_chi = std::log10( min_chi );
+    const double delta_chi = ( std::log10( max_chi ) - log10_min_chi )/( size[0] - 1 );
+    const unsigned int size_photon_chi = size[1];
+
+    double t0 = MPI_Wtime();
+
+    // Table h of Niel et al.
+    niel.min_ = min_chi;
+    niel.max_ = max_chi;
+    niel.set_size( &size[0] );
+    niel.allocate();
+    computeRows( size[0], 1, niel.data_, smpi, [&]( int i, double *row ) {
+        const double particle_chi = std::pow( 10., i*delta_chi + log10_min_chi );
+        row[0] = computeHNiel( particle_chi, 400 );
+    } );
+    niel.compute_parameters();
+
+    // Table integfochi
+    integfochi.min_ = min_chi;
+    integfochi.max_ = max_chi;
+    integfochi.set_size( &size[0] );
+    integfochi.allocate();
+    computeRows( size[0], 1, integfochi.data_, smpi, [&]( int i, double *row ) {
+        const double particle_chi = std::pow( 10., i*delta_chi + log10_min_chi );
+        row[0] = integrateSynchrotronEmissivity( particle_chi, 1e-40*particle_chi, particle_chi, 400 );
+    } );
+    integfochi.compute_parameters();
+
+    MESSAGE( 2,"- tables `h` and `integfochi` computed in " << MPI_Wtime() - t0 << " s" );
+    t0 = MPI_Wtime();
+
+    xi.min_ = min_chi;
+    xi.max_ = max_chi;
+    xi.set_size( &size[0] );
+    xi.allocate();
+
+    // Table min_photon_chi_for_xi: the lowest photon chi for which xi is above the threshold
+    computeRows( size[0], 1, xi.axis1_min_, smpi, [&]( int i, double *row ) {
+        double log10_photon_chi = i*delta_chi + log10_min_chi;
+        const double particle_chi = std::pow( 10., log10_photon_chi );
+        const double denominator = integrateSynchrotronEmissivity( particle_chi,
+                                   0.99e-40*particle_chi, particle_chi, 200 );
+        int k = 0;
+        while( k < radiation_xi_power ) {
+            log10_photon_chi -= std::pow( 0.1, k );
+            const double photon_chi = std::pow( 10., log10_photon_chi );
+            const double numerator = integrateSynchrotronEmissivity( particle_chi,
+                                     0.99e-40*photon_chi, photon_chi, 200 );
+            const double xi_value = numerator == 0 ? 0 : numerator/denominator;
+            if( xi_value < radiation_xi_threshold ) {
+                log10_photon_chi += std::pow( 0.1, k );
+                k += 1;
+            }
+        }
+        row[0] = log10_photon_chi;
+    } );
+
+    // Table xi: the integrals are accumulated from one photon chi to the next
+    computeRows( size[0], size_photon_chi, xi.data_, smpi, [&]( int i, double *row ) {
+        const double log10_particle_chi = i*delta_chi + log10_min_chi;
+        const double log10_min_photon_chi = xi.axis1_min_[i];
+        const double delta_photon_chi = ( log10_particle_chi - log10_min_photon_chi )/( size_photon_chi - 1 );
+        const double particle_chi = std::pow( 10., log10_particle_chi );
+        const double denominator = integrateSynchrotronEmissivity( particle_chi,
+                                   1e-40*particle_chi, particle_chi, 300 );
+        double photon_chi = std::pow( 10., log10_min_photon_chi );
+        double numerator = integrateSynchrotronEmissivity( particle_chi,
+                           1e-40*photon_chi, photon_chi, 300 );
+        row[0] = std::min( 1.0, numerator/denominator );
+        for( unsigned int j = 1; j < size_photon_chi; j++ ) {
+            const double previous_photon_chi = photon_chi;
+            photon_chi = std::pow( 10., j*delta_photon_chi + log10_min_photon_chi );
+            numerator += integrateSynchrotronEmissivity( particle_chi,
+                         previous_photon_chi, photon_chi, xi_interval_discretization );
+            row[j] = std::min( 1.0, numerator/denominator );
+        }
+    } );
+    xi.compute_parameters();
+
+    MESSAGE( 2,"- tables `min_photon_chi_for_xi` and `xi` computed in " << MPI_Wtime() - t0 << " s" );
+}
+
+// -----------------------------------------------------------------------------
+//! Computation of the tables of the multiphoton Breit-Wheeler process
+//
+//! \param T table of the pair production rate
+//! \param xi tables min_particle_chi_for_xi and xi
+//! \param size sizes of the photon and particle quantum parameter axes
+//! \param min_chi, max_chi boundaries of the photon quantum parameter axis
+//! \param smpi Object of class SmileiMPI containing MPI properties
+// -----------------------------------------------------------------------------
+void QEDTablesComputation::computeMultiphotonBreitWheelerTables( Table &T, Table2D &xi,
+                                                                 std::vector<unsigned int> size,
+                                                                 double min_chi, double max_chi,
+                                                                 SmileiMPI *smpi )
+{
+    const double log10_min_chi = std::log10( min_chi );
+    const double delta_chi = ( std::log10( max_chi ) - log10_min_chi )/( size[0] - 1 );
+    const unsigned int size_particle_chi = size[1];
+
+    double t0 = MPI_Wtime();
+
+    // Table integration_dt_dchi
+    T.min_ = min_chi;
+    T.max_ = max_chi;
+    T.set_size( &size[0] );
+    T.allocate();
+    computeRows( size[0], 1, T.data_, smpi, [&]( int i, double *row ) {
+        const double photon_chi = std::pow( 10., i*delta_chi + log10_min_chi );
+        row[0] = 2.0*integrateRitusDerivative( photon_chi, 1e-50*0.5*photon_chi, 0.5*photon_chi, 200 );
+    } );
+    T.compute_parameters();
+
+    MESSAGE( 2,"- table `integration_dt_dchi` computed in " << MPI_Wtime() - t0 << " s" );
+    t0 = MPI_Wtime();
+
+    xi.min_ = min_chi;
+    xi.max_ = max_chi;
+    xi.set_size( &size[0] );
+    xi.allocate();
+
+    // Table min_particle_chi_for_xi: the lowest particle chi for which xi is above the threshold
+    computeRows( size[0], 1, xi.axis1_min_, smpi, [&]( int i, double *row ) {
+        const double photon_chi = std::pow( 10., i*delta_chi + log10_min_chi );
+        double log10_particle_chi = std::log10( 0.5*photon_chi );
+        const double denominator = integrateRitusDerivative( photon_chi,
+                                   1e-50*0.5*photon_chi, 0.5*photon_chi, 200 );
+        int k = 0;
+        while( k < mBW_xi_power ) {
+            log10_particle_chi -= std::pow( 0.1, k );
+            const double particle_chi = std::pow( 10., log10_particle_chi );
+            const double numerator = integrateRitusDerivative( photon_chi,
+                                     1e-50*particle_chi, particle_chi, 200 );
+            const double xi_value = ( numerator == 0 || denominator == 0 ) ? 0 : numerator/( 2.0*denominator );
+            if( xi_value < mBW_xi_threshold ) {
+                log10_particle_chi += std::pow( 0.1, k );
+                k += 1;
+            }
+        }
+        row[0] = log10_particle_chi;
+    } );
+
+    // Table xi: the integrals are accumulated from one particle chi to the next
+    computeRows( size[0], size_particle_chi, xi.data_, smpi, [&]( int i, double *row ) {
+        const double photon_chi = std::pow( 10., i*delta_chi + log10_min_chi );
+        const double log10_min_particle_chi = xi.axis1_min_[i];
+        const double delta_particle_chi = ( std::log10( 0.5*photon_chi ) - log10_min_particle_chi )
+                                          /( size_particle_chi - 1 );
+        const double denominator = integrateRitusDerivative( photon_chi,
+                                   1e-50*0.5*photon_chi, 0.5*photon_chi, 200 );
+        double particle_chi = std::pow( 10., log10_min_particle_chi );
+        double numerator = integrateRitusDerivative( photon_chi, 1e-50*particle_chi, particle_chi, 200 );
+        row[0] = numerator/( 2.0*denominator );
+        for( unsigned int j = 1; j < size_particle_chi; j++ ) {
+            const double previous_particle_chi = particle_chi;
+            particle_chi = std::pow( 10., j*delta_particle_chi + log10_min_particle_chi );
+            numerator += integrateRitusDerivative( photon_chi,
+                         previous_particle_chi, particle_chi, xi_interval_discretization );
+            row[j] = numerator/( 2.0*denominator );
+        }
+    } );
+    xi.compute_parameters();
+
+    MESSAGE( 2,"- tables `min_particle_chi_for_xi` and `xi` computed in " << MPI_Wtime() - t0 << " s" );
+}
+
+// -----------------------------------------------------------------------------
+//! Write the radiation tables with the datasets and attributes of the external tool.
+//! The file is first written under a temporary name, then renamed, so that
+//! simulations sharing the cache never read an incomplete file.
+// -----------------------------------------------------------------------------
+void QEDTablesComputation::writeRadiationTables( std::string file, Table &niel, Table &integfochi, Table2D &xi )
+{
+    const std::string temporary_file = file + ".tmp";
+    {
+        H5Write f( temporary_file );
+
+        H5Write h = f.vect( "h", niel.data_[0], niel.size_, H5T_NATIVE_DOUBLE );
+        h.attr( "size_particle_chi", niel.size_ );
+        h.attr( "min_particle_chi", niel.min_ );
+        h.attr( "max_particle_chi", niel.max_ );
+
+        H5Write c = f.vect( "integfochi", integfochi.data_[0], integfochi.size_, H5T_NATIVE_DOUBLE );
+        c.attr( "size_particle_chi", integfochi.size_ );
+        c.attr( "min_particle_chi", integfochi.min_ );
+        c.attr( "max_particle_chi", integfochi.max_ );
+
+        H5Write m = f.vect( "min_photon_chi_for_xi", xi.axis1_min_[0], xi.dim_size_[0], H5T_NATIVE_DOUBLE );
+        m.attr( "size_particle_chi", xi.dim_size_[0] );
+        m.attr( "min_particle_chi", xi.min_ );
+        m.attr( "max_particle_chi", xi.max_ );
+        m.attr( "power", radiation_xi_power );
+        m.attr( "threshold", radiation_xi_threshold );
+
+        H5Space space( { xi.dim_size_[0], xi.dim_size_[1] } );
+        H5Write d = f.array( "xi", xi.data_[0], &space, &space );
+        d.attr( "size_particle_chi", xi.dim_size_[0] );
+        d.attr( "size_photon_chi", xi.dim_size_[1] );
+        d.attr( "min_particle_chi", xi.min_ );
+        d.attr( "max_particle_chi", xi.max_ );
+    }
+    if( std::rename( temporary_file.c_str(), file.c_str() ) != 0 ) {
+        WARNING( "The computed radiation tables could not be stored in `" << file << "`" );
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Write the multiphoton Breit-Wheeler tables with the datasets and attributes
+//! of the external tool (see writeRadiationTables)
+// -----------------------------------------------------------------------------
+void QEDTablesComputation::writeMultiphotonBreitWheelerTables( std::string file, Table &T, Table2D &xi )
+{
+    const std::string temporary_file = file + ".tmp";
+    {
+        H5Write f( temporary_file );
+
+        H5Write t = f.vect( "integration_dt_dchi", T.data_[0], T.size_, H5T_NATIVE_DOUBLE );
+        t.attr( "size_photon_chi", T.size_ );
+        t.attr( "min_photon_chi", T.min_ );
+        t.attr( "max_photon_chi", T.max_ );
+
+        H5Write m = f.vect( "min_particle_chi_for_xi", xi.axis1_min_[0], xi.dim_size_[0], H5T_NATIVE_DOUBLE );
+        m.attr( "size_photon_chi", xi.dim_size_[0] );
+        m.attr( "min_photon_chi", xi.min_ );
+        m.attr( "max_photon_chi", xi.max_ );
+        m.attr( "power", mBW_xi_power );
+        m.attr( "threshold", mBW_xi_threshold );
+
+        H5Space space( { xi.dim_size_[0], xi.dim_size_[1] } );
+        H5Write d = f.array( "xi", xi.data_[0], &space, &space );
+        d.attr( "size_photon_chi", xi.dim_size_[0] );
+        d.attr( "size_particle_chi", xi.dim_size_[1] );
+        d.attr( "min_photon_chi", xi.min_ );
+        d.attr( "max_photon_chi", xi.max_ );
+    }
+    if( std::rename( temporary_file.c_str(), file.c_str() ) != 0 ) {
+        WARNING( "The computed multiphoton Breit-Wheeler tables could not be stored in `" << file << "`" );
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Name of the cache file: `<path>/<name>_<hash>.h5` where the hash (FNV-1a)
+//! covers all the parameters of the computation
+// -----------------------------------------------------------------------------
+std::string QEDTablesComputation::cacheFile( std::string path, std::string name,
+                                             std::vector<unsigned int> size,
+                                             double min_chi, double max_chi )
+{
+    std::ostringstream parameters;
+    parameters << std::setprecision( 17 ) << name << " " << size[0] << " " << size[1]
+               << " " << min_chi << " " << max_chi << " " << xi_interval_discretization;
+
+    uint64_t hash = 14695981039346656037ULL;
+    for( char c : parameters.str() ) {
+        hash ^= ( unsigned char )c;
+        hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream file;
+    file << ( path.empty() ? "." : path ) << "/" << name << "_"
+         << std::hex << std::setw( 16 ) << std::setfill( '0' ) << hash << ".h5";
+    return file.str();
+}
+
+// -----------------------------------------------------------------------------
+// PHYSICS
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Synchrotron emissivity of Ritus
+//
+//! \param particle_chi particle quantum parameter
+//! \param photon_chi photon quantum parameter
+// -----------------------------------------------------------------------------
+double QEDTablesComputation::computeRitusSynchrotronEmissivity( double particle_chi, double photon_chi )
+{
+    if( particle_chi <= photon_chi ) {
+        return 0.;
+    }
+    const double y = photon_chi/( 3.0*particle_chi*( particle_chi-photon_chi ) );
+    return BesselKCombination( 2.0 + 3.0*photon_chi*y, 2.0*y )
+           * 2.0*photon_chi/( 3.0*particle_chi*particle_chi );
+}
+
+// -----------------------------------------------------------------------------
+//! Integral of the synchrotron emissivity divided by photon_chi,
+//! with a Gauss-Legendre quadrature in log10(photon_chi)
+//
+//! \param particle_chi particle quantum parameter
+//! \param min_photon_chi, max_photon_chi integration boundaries
+//! \param discretization number of points of the quadrature
+// -----------------------------------------------------------------------------
+double QEDTablesComputation::integrateSynchrotronEmissivity( double particle_chi,
+                                                             double min_photon_chi, double max_photon_chi,
+                                                             int discretization )
+{
+    std::vector<double> roots( discretization ), weights( discretization );
+    GaussLegendreQuadrature( std::log10( min_photon_chi ), std::log10( max_photon_chi ),
+                             &roots[0], &weights[0], discretization, 1e-15 );
+
+    double integral = 0;
+    for( int i = 0; i < discretization; i++ ) {
+        const double photon_chi = std::pow( 10., roots[i] );
+        integral += weights[i]*computeRitusSynchrotronEmissivity( particle_chi, photon_chi );
+    }
+    return integral*std::log( 10. );
+}
+
+// -----------------------------------------------------------------------------
+//! Function h of Niel et al.
+//
+//! \param particle_chi particle quantum parameter
+//! \param discretization number of points of the quadrature
+// -----------------------------------------------------------------------------
+double QEDTablesComputation::computeHNiel( double particle_chi, int discretization )
+{
+    std::vector<double> roots( discretization ), weights( discretization );
+    GaussLegendreQuadrature( -20., std::log10( 50. ), &roots[0], &weights[0], discretization, 1e-15 );
+
+    double h = 0.;
+    for( int i = 0; i < discretization; i++ ) {
+        const double nu = std::pow( 10., roots[i] );
+        const double a = 2.0 + 3.0*nu*particle_chi;
+        h += weights[i]*nu
+             * ( 2.0*std::pow( particle_chi*nu, 3 )/std::pow( a, 3 )*BesselK( 5./3., nu )
+                 + 54.0*std::pow( particle_chi, 5 )*std::pow( nu, 4 )/std::pow( a, 5 )*BesselK( 2./3., nu ) );
+    }
+    return 9.0*std::sqrt( 3.0 )/( 4.0*M_PI )*h*std::log( 10. );
+}
+
+// -----------------------------------------------------------------------------
+//! Derivative of the pair production rate of Ritus
+//
+//! \param photon_chi photon quantum parameter
+//! \param particle_chi quantum parameter of one of the particles of the pair
+// -----------------------------------------------------------------------------
+double QEDTablesComputation::computeRitusDerivative( double photon_chi, double particle_chi )
+{
+    const double y = photon_chi/( 3.0*particle_chi*( photon_chi-particle_chi ) );
+    return -BesselKCombination( 2.0 - 3.0*photon_chi*y, 2.0*y );
+}
+
+// -----------------------------------------------------------------------------
+//! Integral of the derivative of the pair production rate of Ritus,
+//! with a Gauss-Legendre quadrature in log10(particle_chi)
+//
+//! \param photon_chi photon quantum parameter
+//! \param min_particle_chi, max_particle_chi integration boundaries
+//! \param discretization number of points of the quadrature
+// -----------------------------------------------------------------------------
+double QEDTablesComputation::integrateRitusDerivative( double photon_chi,
+                                                       double min_particle_chi, double max_particle_chi,
+                                                       int discretization )
+{
+    std::vector<double> roots( discretization ), weights( discretization );
+    GaussLegendreQuadrature( std::log10( min_particle_chi ), std::log10( max_particle_chi ),
+                             &roots[0], &weights[0], discretization, 1e-15 );
+
+    double integral = 0;
+    for( int i = 0; i < discretization; i++ ) {
+        const double particle_chi = std::pow( 10., roots[i] );
+        integral += weights[i]*computeRitusDerivative( photon_chi, particle_chi )*particle_chi;
+    }
+    return integral*std::log( 10. );
+}
+
+// -----------------------------------------------------------------------------
+// NUMERICAL TOOLS
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Roots and weights of the Gauss-Legendre quadrature
+//
+//! \param x_min, x_max integration boundaries
+//! \param roots, weights arrays of size number_of_roots
+//! \param eps accuracy of the Newton iterations on the roots
+// -----------------------------------------------------------------------------
+void QEDTablesComputation::GaussLegendreQuadrature( double x_min, double x_max, double *roots,
+                                                    double *weights, int number_of_roots, double eps )
+{
+    const int half_number_of_roots = ( number_of_roots+1 )/2;
+    const double x_average = 0.5*( x_min+x_max );
+    const double x_half_length = 0.5*( x_max-x_min );
+
+    for( int i_root = 0; i_root < half_number_of_roots; i_root++ ) {
+
+        // Initial guess, then Newton iterations on the Legendre polynomial
+        double root = std::cos( M_PI*( i_root+0.75 )/( number_of_roots+0.5 ) );
+        double root_prev;
+        double P_derivative;
+
+        do {
+            double P_curr = 1.0;
+            double P_next = root;
+            for( int order = 2; order <= number_of_roots; order++ ) {
+                const double P_prev = P_curr;
+                P_curr = P_next;
+                P_next = ( ( 2.0*order-1.0 )*root*P_curr-( order-1.0 )*P_prev )/order;
+            }
+            P_derivative = number_of_roots*( root*P_next-P_curr )/( root*root-1.0 );
+            root_prev = root;
+            root = root_prev-P_next/P_derivative;
+        } while( std::fabs( root-root_prev ) > eps );
+
+        roots[i_root] = x_average-x_half_length*root;
+        roots[number_of_roots-1-i_root] = x_average+x_half_length*root;
+
+        weights[i_root] = 2.0*x_half_length/( ( 1.0-root*root )*P_derivative*P_derivative );
+        weights[number_of_roots-1-i_root] = weights[i_root];
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Series of the modified Bessel function of the first kind I_nu(z)
+//! (nu not integer, possibly negative), or of its integral between 0 and z.
+//! Used for z below 1, where the terms decrease quickly.
+// -----------------------------------------------------------------------------
+static double BesselISeries( double nu, double z, bool integrated )
+{
+    const double q = 0.25*z*z;
+    double term = std::pow( 0.5*z, nu )/std::tgamma( nu+1. );
+    double sum = integrated ? term*z/( nu+1. ) : term;
+    for( int k = 1; k < 100; k++ ) {
+        term *= q/( k*( k+nu ) );
+        const double value = integrated ? term*z/( 2*k+nu+1. ) : term;
+        sum += value;
+        if( std::fabs( value ) <= 1e-17*std::fabs( sum ) ) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+//! Modified Bessel function of the second kind.
+//! For z < 1: K_nu(z) = pi/(2 sin(nu pi)) ( I_{-nu}(z) - I_nu(z) ).
+//! Otherwise: K_nu(z) = Int_0^infinity exp(-z cosh t) cosh(nu t) dt, with the
+//! trapezoidal rule, which converges exponentially for this integrand: with a
+//! step below 0.1 and 0.5/sqrt(z) (width of the integrand for large z), the
+//! accuracy is limited by the rounding errors.
+// -----------------------------------------------------------------------------
+double QEDTablesComputation::BesselK( double nu, double z )
+{
+    if( z < 1. ) {
+        return 0.5*M_PI/std::sin( nu*M_PI )*( BesselISeries( -nu, z, false ) - BesselISeries( nu, z, false ) );
+    }
+
+    const double h = std::min( 0.1, 0.5/std::sqrt( z ) );
+    double integral = 0.5*std::exp( -z );
+    for( int k = 1; k < 10000; k++ ) {
+        const double t = k*h;
+        const double z_cosh = z*std::cosh( t );
+        const double term = 0.5*( std::exp( nu*t - z_cosh ) + std::exp( -nu*t - z_cosh ) );
+        integral += term;
+        // Stop after the maximum of the integrand, when the terms are negligible
+        if( z*std::sinh( t ) > nu && term <= 1e-17*integral ) {
+            break;
+        }
+    }
+    return integral*h;
+}
+
+// -----------------------------------------------------------------------------
+//! c K_{2/3}(z) - Int_z^infinity K_{1/3}(y) dy.
+//! For z < 1, from the series, with Int_0^infinity K_{1/3} = pi/sqrt(3).
+//! Otherwise, as a single integral with the trapezoidal rule as in BesselK:
+//! Int_0^infinity exp(-z cosh t) ( c cosh(2t/3) - cosh(t/3)/cosh(t) ) dt
+// -----------------------------------------------------------------------------
+double QEDTablesComputation::BesselKCombination( double c, double z )
+{
+    if( z < 1. ) {
+        const double integral_K13 = M_PI/std::sqrt( 3. )
+                                    *( 1. - BesselISeries( -1./3., z, true ) + BesselISeries( 1./3., z, true ) );
+        return c*BesselK( 2./3., z ) - integral_K13;
+    }
+
+    const double h = std::min( 0.1, 0.5/std::sqrt( z ) );
+    double integral = 0.5*std::exp( -z )*( c - 1. );
+    double norm = std::fabs( integral );
+    for( int k = 1; k < 10000; k++ ) {
+        const double t = k*h;
+        const double z_cosh = z*std::cosh( t );
+        const double term = 0.5*c*( std::exp( 2./3.*t - z_cosh ) + std::exp( -2./3.*t - z_cosh ) )
+                            - std::exp( -z_cosh )*std::cosh( t/3. )/std::cosh( t );
+        integral += term;
+        norm += std::fabs( term );
+        if( z*std::sinh( t ) > 2./3. && std::fabs( term ) <= 1e-17*norm ) {
+            break;
+        }
+    }
+    return integral*h;
+}
@@ -0,0 +1,108 @@
+// ----------------------------------------------------------------------------
+//! \file QEDTablesComputation.h
+//
+//! \brief Computation of the QED tables (nonlinear inverse Compton scattering
+//! and multiphoton Breit-Wheeler) at initialization
+//
+//! \details The tables are the ones of the external tool `smilei_tables`
+//! (tools/tables). Their rows are distributed over the MPI ranks and the
+//! OpenMP threads. The Bessel functions are computed from their integral
+//! representations, so that no external library is required.
+// ----------------------------------------------------------------------------
+
+#ifndef QEDTABLESCOMPUTATION_H
+#define QEDTABLESCOMPUTATION_H
+
+#include <string>
+#include <vector>
+
+#include "SmileiMPI.h"
+#include "Table.h"
+#include "Table2D.h"
+
+//------------------------------------------------------------------------------
+//! QEDTablesComputation class: computes the QED tables, writes them
+//! in the format of the external tool and names their cache files
+//------------------------------------------------------------------------------
+class QEDTablesComputation
+{
+
+public:
+
+    // ---------------------------------------------------------------------
+    // TABLES
+    // ---------------------------------------------------------------------
+
+    //! Computation of the tables of the nonlinear inverse Compton scattering
+    //! (h of Niel et al., integfochi, min_photon_chi_for_xi and xi)
+    //! \param size sizes of the particle and photon quantum parameter axes
+    //! \param min_chi, max_chi boundaries of the particle quantum parameter axis
+    static void computeRadiationTables( Table &niel, Table &integfochi, Table2D &xi,
+                                        std::vector<unsigned int> size,
+                                        double min_chi, double max_chi,
+                                        SmileiMPI *smpi );
+
+    //! Computation of the tables of the multiphoton Breit-Wheeler process
+    //! (integration_dt_dchi, min_particle_chi_for_xi and xi)
+    //! \param size sizes of the photon and particle quantum parameter axes
+    //! \param min_chi, max_chi boundaries of the photon quantum parameter axis
+    static void computeMultiphotonBreitWheelerTables( Table &T, Table2D &xi,
+                                                      std::vector<unsigned int> size,
+                                                      double min_chi, double max_chi,
+                                                      SmileiMPI *smpi );
+
+    //! Write the radiation tables in a file that can be read as an external table
+    static void writeRadiationTables( std::string file, Table &niel, Table &integfochi, Table2D &xi );
+
+    //! Write the multiphoton Breit-Wheeler tables in a file that can be read as an external table
+    static void writeMultiphotonBreitWheelerTables( std::string file, Table &T, Table2D &xi );
+
+    //! Name of the cache file of the tables `name` computed with the given parameters:
+    //! the parameters are hashed so that other resolutions get other files
+    static std::string cacheFile( std::string path, std::string name,
+                                  std::vector<unsigned int> size,
+                                  double min_chi, double max_chi );
+
+    // ---------------------------------------------------------------------
+    // PHYSICS
+    // ---------------------------------------------------------------------
+
+    //! Synchrotron emissivity of Ritus for a particle of quantum parameter
+    //! particle_chi emitting a photon of quantum parameter photon_chi
+    static double computeRitusSynchrotronEmissivity( double particle_chi, double photon_chi );
+
+    //! Integral of the synchrotron emissivity divided by photon_chi
+    //! between min_photon_chi and max_photon_chi
+    static double integrateSynchrotronEmissivity( double particle_chi,
+                                                  double min_photon_chi, double max_photon_chi,
+                                                  int discretization );
+
+    //! Function h of Niel et al.
+    static double computeHNiel( double particle_chi, int discretization );
+
+    //! Derivative of the pair production rate of Ritus with respect to the
+    //! quantum parameter of one of the particles of the pair
+    static double computeRitusDerivative( double photon_chi, double particle_chi );
+
+    //! Integral of computeRitusDerivative between min_particle_chi and max_particle_chi
+    static double integrateRitusDerivative( double photon_chi,
+                                            double min_particle_chi, double max_particle_chi,
+                                            int discretization );
+
+    // ---------------------------------------------------------------------
+    // NUMERICAL TOOLS
+    // ---------------------------------------------------------------------
+
+    //! Roots and weights of the Gauss-Legendre quadrature between x_min and x_max
+    static void GaussLegendreQuadrature( double x_min, double x_max, double *roots,
+                                         double *weights, int number_of_roots, double eps );
+
+    //! Modified Bessel function of the second kind K_nu(z)
+    static double BesselK( double nu, double z );
+
+    //! c K_{2/3}(z) - Int_z^infinity K_{1/3}(y) dy, computed as a single integral
+    static double BesselKCombination( double c, double z );
+
+};
+
+#endif
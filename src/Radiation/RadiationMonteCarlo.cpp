@@ -36,6 +36,7 @@ RadiationMonteCarlo::RadiationMonteCarlo( Params &params, Species *species, Rand
     max_photon_emissions_             = species->radiation_max_emissions_;
     radiation_photon_gamma_threshold_ = species->radiation_photon_gamma_threshold_;
     inv_radiation_photon_sampling_    = 1. / radiation_photon_sampling_;
+    radiation_photon_merging_threshold_ = species->radiation_photon_merging_threshold_;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -170,34 +171,33 @@ void RadiationMonteCarlo::operator()(
             //          << std::endl;
 
 #else
+            // The photons are reserved by buffers of particles, see below
             nphotons = photons->size();
-            // We reserve a large number of photons
-            photons->reserve( nphotons + (iend - istart) * photon_buffer_size_per_particle );
 #endif
     } else {
         nphotons = 0;
     }
 
     // Photon position shortcut
-    double *const __restrict__ photon_position_x = photons ? photons->getPtrPosition( 0 ) : nullptr;
-    double *const __restrict__ photon_position_y = photons ? (nDim_ > 1 ? photons->getPtrPosition( 1 ) : nullptr) : nullptr;
-    double *const __restrict__ photon_position_z = photons ? (nDim_ > 2 ? photons->getPtrPosition( 2 ) : nullptr) : nullptr;
+    double * __restrict__ photon_position_x = photons ? photons->getPtrPosition( 0 ) : nullptr;
+    double * __restrict__ photon_position_y = photons ? (nDim_ > 1 ? photons->getPtrPosition( 1 ) : nullptr) : nullptr;
+    double * __restrict__ photon_position_z = photons ? (nDim_ > 2 ? photons->getPtrPosition( 2 ) : nullptr) : nullptr;
 
     // Particles Momentum shortcut
-    double *const __restrict__ photon_momentum_x = photons ? photons->getPtrMomentum(0) : nullptr;
-    double *const __restrict__ photon_momentum_y = photons ? photons->getPtrMomentum(1) : nullptr;
-    double *const __restrict__ photon_momentum_z = photons ? photons->getPtrMomentum(2) : nullptr;
+    double * __restrict__ photon_momentum_x = photons ? photons->getPtrMomentum(0) : nullptr;
+    double * __restrict__ photon_momentum_y = photons ? photons->getPtrMomentum(1) : nullptr;
+    double * __restrict__ photon_momentum_z = photons ? photons->getPtrMomentum(2) : nullptr;
 
     // Charge shortcut
-    short *const __restrict__ photon_charge = photons ? photons->getPtrCharge() : nullptr;
+    short * __restrict__ photon_charge = photons ? photons->getPtrCharge() : nullptr;
 
     // Weight shortcut
-    double *const __restrict__ photon_weight = photons ? photons->getPtrWeight() : nullptr;
+    double * __restrict__ photon_weight = photons ? photons->getPtrWeight() : nullptr;
 
     // Quantum Parameter
-    double *const __restrict__ photon_chi_array = photons ? (photons->has_quantum_parameter ? photons->getPtrChi() : nullptr) : nullptr;
+    double * __restrict__ photon_chi_array = photons ? (photons->has_quantum_parameter ? photons->getPtrChi() : nullptr) : nullptr;
 
-    double *const __restrict__ photon_tau = photons ? (photons->has_Monte_Carlo_process ? photons->getPtrTau() : nullptr) : nullptr;
+    double * __restrict__ photon_tau = photons ? (photons->has_Monte_Carlo_process ? photons->getPtrTau() : nullptr) : nullptr;
 
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
     // Cell keys as a mask
@@ -293,7 +293,93 @@ void RadiationMonteCarlo::operator()(
 
 #endif
 
+#ifndef SMILEI_ACCELERATOR_GPU_OACC
+    // Particles that need the full Monte-Carlo sub-stepping in each buffer
+    bool scalar_mc[SMILEI_RADIATION_BUFFERSIZE];
+
+    for( int ibuffer=istart ; ibuffer<iend; ibuffer+=SMILEI_RADIATION_BUFFERSIZE ) {
+
+    const int ibuffer_end = std::min( ibuffer + SMILEI_RADIATION_BUFFERSIZE, iend );
+
+    // Vectorized treatment of the particles that radiate in a single step without random numbers:
+    // - an emission in progress that does not complete during this timestep
+    // - a continuous emission
+    // - no emission at all
+    // The others (new or completed emissions) are handled afterwards, one by one,
+    // so that the random numbers are drawn in the same order as before
+    #pragma omp simd reduction( +:radiated_energy_loc )
+    for( int ipart=ibuffer ; ipart<ibuffer_end; ipart++ ) {
+
+        const double charge_over_mass_square = ( double )( charge[ipart] )*one_over_mass_square;
+
+        const double particle_gamma = std::sqrt( 1.0 + momentum_x[ipart]*momentum_x[ipart]
+                      + momentum_y[ipart]*momentum_y[ipart]
+                      + momentum_z[ipart]*momentum_z[ipart] );
+
+        const double particle_chi = Radiation::computeParticleChi( charge_over_mass_square,
+                       momentum_x[ipart], momentum_y[ipart], momentum_z[ipart],
+                       particle_gamma,
+                       Ex[ipart-ipart_ref], Ey[ipart-ipart_ref], Ez[ipart-ipart_ref],
+                       Bx[ipart-ipart_ref], By[ipart-ipart_ref], Bz[ipart-ipart_ref] );
+
+        const bool moving = particle_gamma >= 1.1;
+        const bool in_progress = tau[ipart] > epsilon_tau_;
+
+        // Discontinuous emission in progress, continued over the whole timestep
+        const double yield = radiation_tables.computePhotonProductionYieldVectorized( particle_chi, particle_gamma );
+        const double tau_end = tau[ipart] - yield*dt_;
+        const bool progress_only = moving && in_progress && tau[ipart]/yield >= dt_ && tau_end > epsilon_tau_;
+        tau[ipart] = progress_only ? tau_end : tau[ipart];
+
+        // Continuous emission
+        const bool continuous = moving && !in_progress
+                                && particle_chi <= radiation_tables.getMinimumChiDiscontinuous()
+                                && particle_chi >  radiation_tables.getMinimumChiContinuous();
+        const double cont_energy = radiation_tables.getRidgersCorrectedRadiatedEnergy( particle_chi, dt_ );
+        const double factor = continuous ? cont_energy*particle_gamma/( particle_gamma*particle_gamma-1. ) : 0.;
+        momentum_x[ipart] -= factor*momentum_x[ipart];
+        momentum_y[ipart] -= factor*momentum_y[ipart];
+        momentum_z[ipart] -= factor*momentum_z[ipart];
+        const double new_gamma = std::sqrt( 1.0 + momentum_x[ipart]*momentum_x[ipart]
+                                              + momentum_y[ipart]*momentum_y[ipart]
+                                              + momentum_z[ipart]*momentum_z[ipart] );
+        radiated_energy_loc += continuous ? weight[ipart]*( particle_gamma - new_gamma ) : 0.;
+
+        scalar_mc[ipart-ibuffer] = moving && !progress_only
+                                   && ( in_progress || particle_chi > radiation_tables.getMinimumChiDiscontinuous() );
+    }
+
+    // Photon quota of the buffer: the maximum number of photons of its remaining particles
+    // The photon buffer is kept from one call to the next and only grows geometrically
+    if( photons ) {
+        unsigned int n_scalar = 0;
+        for( int i=0 ; i<ibuffer_end-ibuffer; i++ ) {
+            n_scalar += scalar_mc[i];
+        }
+        const unsigned int quota = nphotons + n_scalar * photon_buffer_size_per_particle;
+        if( quota > photons->capacity() ) {
+            photons->reserve( std::max( quota, 2*photons->capacity() ) );
+            photon_position_x = photons->getPtrPosition( 0 );
+            photon_position_y = nDim_ > 1 ? photons->getPtrPosition( 1 ) : nullptr;
+            photon_position_z = nDim_ > 2 ? photons->getPtrPosition( 2 ) : nullptr;
+            photon_momentum_x = photons->getPtrMomentum(0);
+            photon_momentum_y = photons->getPtrMomentum(1);
+            photon_momentum_z = photons->getPtrMomentum(2);
+            photon_charge = photons->getPtrCharge();
+            photon_weight = photons->getPtrWeight();
+            photon_chi_array = photons->has_quantum_parameter ? photons->getPtrChi() : nullptr;
+            photon_tau = photons->has_Monte_Carlo_process ? photons->getPtrTau() : nullptr;
+        }
+    }
+
+    for( int ipart=ibuffer ; ipart<ibuffer_end; ipart++ ) {
+
+        if( ! scalar_mc[ipart-ibuffer] ) {
+            continue;
+        }
+#else
     for( int ipart=istart ; ipart<iend; ipart++ ) {
+#endif
 
         // charge / mass^2
         const double charge_over_mass_square = ( double )( charge[ipart] )*one_over_mass_square;
@@ -426,9 +512,43 @@ void RadiationMonteCarlo::operator()(
                     py *= new_norm_p * inv_old_norm_p;
                     pz *= new_norm_p * inv_old_norm_p;*/
 
+                    // Low-energy photon merged in the previous macro-photons of this particle:
+                    // they are collinear, at the same position and with the same weight,
+                    // so that the energy and the momentum are conserved
+                    if(          photons
+                            && ( photon_gamma >= radiation_photon_gamma_threshold_ )
+                            && ( photon_gamma < radiation_photon_merging_threshold_ )
+                            && ( i_photon_emission > 0 ) ) {
+
+#ifndef SMILEI_ACCELERATOR_GPU_OACC
+                        const int iphoton_start = nphotons - radiation_photon_sampling_;
+#else
+                        const int iphoton_start = nphotons_start
+                                  + (ipart - istart) * photon_buffer_size_per_particle
+                                  + (i_photon_emission - 1) * radiation_photon_sampling_;
+#endif
+
+                        inv_old_norm_p = 1./std::sqrt( momentum_x[ipart]*momentum_x[ipart]
+                                                  + momentum_y[ipart]*momentum_y[ipart]
+                                                  + momentum_z[ipart]*momentum_z[ipart] );
+
+                        for( auto iphoton=iphoton_start; iphoton<iphoton_start+radiation_photon_sampling_; iphoton++ ) {
+                            if( photons->has_quantum_parameter ) {
+                                // The photon quantum parameter is proportional to its energy
+                                const double previous_gamma = std::sqrt( photon_momentum_x[iphoton]*photon_momentum_x[iphoton]
+                                                                       + photon_momentum_y[iphoton]*photon_momentum_y[iphoton]
+                                                                       + photon_momentum_z[iphoton]*photon_momentum_z[iphoton] );
+                                photon_chi_array[iphoton] *= ( previous_gamma + photon_gamma ) / previous_gamma;
+                            }
+                            photon_momentum_x[iphoton] += photon_gamma*momentum_x[ipart]*inv_old_norm_p;
+                            photon_momentum_y[iphoton] += photon_gamma*momentum_y[ipart]*inv_old_norm_p;
+                            photon_momentum_z[iphoton] += photon_gamma*momentum_z[ipart]*inv_old_norm_p;
+                        }
+
+                    }
                     // Creation of macro-photons if requested
                     // Check that the photons is defined and the threshold on the energy
-                    if(          photons
+                    else if(     photons
                             && ( photon_gamma >= radiation_photon_gamma_threshold_ )
                             && ( i_photon_emission < max_photon_emissions_)) {
                                 
@@ -611,19 +731,16 @@ void RadiationMonteCarlo::operator()(
         } // end while
     } // end for
 
+#ifndef SMILEI_ACCELERATOR_GPU_OACC
+    } // end for buffers
+#endif
+
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
     } // end acc parallel
 #endif
 
     //if (photons) std::cerr << photons->deviceSize()  << std::endl;
 
-    // Remove extra space to save memory
-#ifndef SMILEI_ACCELERATOR_GPU_OACC
-    if (photons) {
-        photons->shrinkToFit( true );
-    }
-#endif
-
     // Update the patch radiated energy
     radiated_energy += radiated_energy_loc;
     //std::cerr << " " << radiated_energy << std::endl;
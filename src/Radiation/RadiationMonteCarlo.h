@@ -16,6 +16,9 @@
 #include "Radiation.h"
 #include "userFunctions.h"
 
+//! Number of particles treated together by the vectorized part of the Monte-Carlo radiation
+#define SMILEI_RADIATION_BUFFERSIZE 32
+
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
 #include <openacc.h>
 // This is wrong. Dont include nvidiaParticles, it may cause problem!
@@ -81,6 +84,10 @@ protected:
     //! This enable to limit emission of useless low-energy photons
     double radiation_photon_gamma_threshold_;
 
+    //! Threshold on the photon Lorentz factor under which the photon is merged
+    //! in the last macro-photons emitted by the same particle during the timestep
+    double radiation_photon_merging_threshold_;
+
     //! Inverse number of photons emitted per event for statisctics purposes
     double inv_radiation_photon_sampling_;
 
@@ -10,6 +10,7 @@
 
 #include "RadiationTables.h"
 #include "RadiationTablesDefault.h"
+#include "QEDTablesComputation.h"
 
 // -----------------------------------------------------------------------------
 // INITILIZATION AND DESTRUCTION
@@ -24,6 +25,11 @@ RadiationTables::RadiationTables()
     // Default parameters
     minimum_chi_continuous_ = 1e-3;
     minimum_chi_discontinuous_ = 1e-2;
+    compact_tables_ = false;
+    compact_tables_validation_ = false;
+    compute_table_ = false;
+    table_size_ = { 256, 256 };
+    table_chi_range_ = { 1e-4, 1e3 };
 }
 
 // -----------------------------------------------------------------------------
@@ -83,6 +89,23 @@ void RadiationTables::initialization( Params &params , SmileiMPI *smpi )
         if( params.has_Niel_radiation_ || params.has_MC_radiation_ ) {
             // Path to the databases
             PyTools::extract( "table_path", table_path_, "RadiationReaction"  );
+            // Compact tables and their validation
+            PyTools::extract( "compact_tables", compact_tables_, "RadiationReaction"  );
+            PyTools::extract( "compact_tables_validation", compact_tables_validation_, "RadiationReaction"  );
+            // Computation of the tables at initialization
+            PyTools::extract( "compute_tables", compute_table_, "RadiationReaction"  );
+            if( compute_table_ ) {
+                PyTools::extractV( "table_size", table_size_, "RadiationReaction" );
+                PyTools::extractV( "table_chi_range", table_chi_range_, "RadiationReaction" );
+                if( table_size_.size() != 2 || table_size_[0] < 2 || table_size_[1] < 2 ) {
+                    ERROR_NAMELIST( "The parameter `table_size` must be a list of 2 sizes above 1",
+                                    LINK_NAMELIST + std::string("#radiation-reaction") );
+                }
+                if( table_chi_range_.size() != 2 || table_chi_range_[0] <= 0. || table_chi_range_[1] <= table_chi_range_[0] ) {
+                    ERROR_NAMELIST( "The parameter `table_chi_range` must be a list of 2 increasing positive values",
+                                    LINK_NAMELIST + std::string("#radiation-reaction") );
+                }
+            }
         }
     }
 
@@ -163,13 +186,19 @@ void RadiationTables::initialization( Params &params , SmileiMPI *smpi )
 
     // We read the table only if specified
     if( params.has_MC_radiation_ || params.has_Niel_radiation_ ) {
-        if (table_path_.size() > 0) {
+        if( compute_table_ ) {
+            computeTables( params, smpi );
+        } else if (table_path_.size() > 0) {
             MESSAGE( 1,"Reading of the external database" );
+            table_file_ = table_path_ + "/radiation_tables.h5";
             readTables( params, smpi );
         } else {
             MESSAGE(1,"Default tables (stored in the code) are used:");
             RadiationTablesDefault::setDefault( niel_, integfochi_, xi_ );
         }
+        if( compact_tables_ ) {
+            compactTables( params );
+        }
     }
 
     if( params.has_MC_radiation_ ) {
@@ -210,6 +239,72 @@ void RadiationTables::initialization( Params &params , SmileiMPI *smpi )
 }
 
 
+// -----------------------------------------------------------------------------
+//! Switch the tables to their compact format (single precision data
+//! and fast logarithm). With the validation, the lookups are compared
+//! to the double precision ones on a sample of each table.
+// -----------------------------------------------------------------------------
+void RadiationTables::compactTables( Params &params )
+{
+#ifdef SMILEI_ACCELERATOR_GPU_OACC
+    ERROR_NAMELIST( "The parameter `compact_tables` is not available on GPU",
+                    LINK_NAMELIST + std::string("#radiation-reaction") );
+#endif
+
+    MESSAGE( "" );
+    MESSAGE( 1,"Compact tables are used (single precision, fast logarithm)" );
+
+    niel_.compact();
+    integfochi_.compact();
+    xi_.compact();
+
+    if( ! compact_tables_validation_ ) {
+        return;
+    }
+
+    // Relative difference with the double precision lookup
+    auto difference = []( double reference, double value ) {
+        return reference != 0. ? std::fabs( value/reference - 1. ) : std::fabs( value );
+    };
+
+    const unsigned int n = 1000;
+    double max_yield = 0., max_niel = 0., max_photon_chi = 0.;
+    for( unsigned int i=0; i<n; i++ ) {
+        if( params.has_MC_radiation_ ) {
+            const double chi = integfochi_.min_ * std::pow( integfochi_.max_/integfochi_.min_, ( i+0.5 )/n );
+            integfochi_.compact_ = false;
+            const double reference = computePhotonProductionYield( chi, 1. );
+            integfochi_.compact_ = true;
+            max_yield = std::max( max_yield, difference( reference, computePhotonProductionYield( chi, 1. ) ) );
+
+            const double xi_chi = xi_.min_ * std::pow( xi_.max_/xi_.min_, ( i+0.5 )/n );
+            for( unsigned int j=1; j<10; j++ ) {
+                xi_.compact_ = false;
+                const double reference = computeRandomPhotonChiWithInterpolation( xi_chi, 0.1*j );
+                xi_.compact_ = true;
+                max_photon_chi = std::max( max_photon_chi, difference( reference, computeRandomPhotonChiWithInterpolation( xi_chi, 0.1*j ) ) );
+            }
+        }
+        if( params.has_Niel_radiation_ ) {
+            // Strictly inside the table, as required by Table::get
+            const double chi = niel_.min_ * std::pow( niel_.max_/niel_.min_, ( i+0.5 )/n );
+            niel_.compact_ = false;
+            const double reference = niel_.get( chi );
+            niel_.compact_ = true;
+            max_niel = std::max( max_niel, difference( reference, niel_.get( chi ) ) );
+        }
+    }
+
+    MESSAGE( 1,"Validation of the compact tables (maximum relative differences):" );
+    if( params.has_MC_radiation_ ) {
+        MESSAGE( 2,"- photon production yield: " << max_yield );
+        MESSAGE( 2,"- photon quantum parameter: " << max_photon_chi );
+    }
+    if( params.has_Niel_radiation_ ) {
+        MESSAGE( 2,"- Niel h function: " << max_niel );
+    }
+}
+
 // -----------------------------------------------------------------------------
 // PHYSICAL COMPUTATION
 // -----------------------------------------------------------------------------
@@ -230,7 +325,7 @@ double RadiationTables::computePhotonProductionYield(
     double dNphdt;
 
     // Log of the particle quantum parameter particle_chi
-    const double logchipa = std::log10( particle_chi );
+    const double logchipa = integfochi_.logarithm( particle_chi );
 
     // Lower index for interpolation in the table integfochi_
     int ichipa = int( std::floor( ( logchipa-integfochi_.log10_min_ )
@@ -239,18 +334,18 @@ double RadiationTables::computePhotonProductionYield(
     // If we are not in the table...
     if( ichipa < 0 ) {
         ichipa = 0;
-        dNphdt = integfochi_.data_[ichipa];
+        dNphdt = integfochi_.value( ichipa );
     } else if( (unsigned int) ichipa >= integfochi_.size_-1 ) {
         ichipa = integfochi_.size_-2;
-        dNphdt = integfochi_.data_[ichipa];
+        dNphdt = integfochi_.value( ichipa );
     } else {
         // Upper and lower values for linear interpolation
         const double logchipam = ichipa*integfochi_.delta_ + integfochi_.log10_min_;
         const double logchipap = logchipam + integfochi_.delta_;
 
         // Interpolation
-        dNphdt = ( integfochi_.data_[ichipa+1]*std::fabs( logchipa-logchipam ) +
-                   integfochi_.data_[ichipa]*std::fabs( logchipap - logchipa ) )*integfochi_.inv_delta_;
+        dNphdt = ( integfochi_.value( ichipa+1 )*std::fabs( logchipa-logchipam ) +
+                   integfochi_.value( ichipa )*std::fabs( logchipap - logchipa ) )*integfochi_.inv_delta_;
     }
     return factor_dNph_dt_*dNphdt*particle_chi/particle_gamma;
 }
@@ -376,7 +471,7 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
 {
 
     // Log10 of particle_chi
-    const double log10_particle_chi = std::log10( particle_chi );
+    const double log10_particle_chi = xi_.logarithm( particle_chi );
 
     // ---------------------------------------
     // index of particle_chi in xi_.table
@@ -405,10 +500,10 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
 
     // If the randomly computed xi if below the first one of the row,
     // we take the first one which corresponds to the minimal photon photon_chi
-    if( xi <= xi_.data_[ichipa*xi_.dim_size_[1]] ) {
+    if( xi <= xi_.value( ichipa*xi_.dim_size_[1] ) ) {
         ichiph_1 = 0;
         ichiph_2 = 0;
-        xi = xi_.data_[ichipa*xi_.dim_size_[1]];
+        xi = xi_.value( ichipa*xi_.dim_size_[1] );
     }
     // Above the last xi of the row, the last one corresponds
     // to the maximal photon photon_chi
@@ -419,10 +514,8 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
     // }
     else {
         // Search for the corresponding index ichiph for xi
-        ichiph_1 = userFunctions::searchValuesInMonotonicArray(
-                     &xi_.data_[ichipa*xi_.dim_size_[1]], xi, xi_.dim_size_[1] );
-        ichiph_2 = userFunctions::searchValuesInMonotonicArray(
-                  &xi_.data_[(ichipa+1)*xi_.dim_size_[1]], xi, xi_.dim_size_[1] );
+        ichiph_1 = xi_.search( ichipa*xi_.dim_size_[1], xi, xi_.dim_size_[1] );
+        ichiph_2 = xi_.search( (ichipa+1)*xi_.dim_size_[1], xi, xi_.dim_size_[1] );
     }
 
     // Corresponding particle_chi for ichipa
@@ -468,14 +561,14 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
     double log10_chiphp;
     
     // Computation of the final photon_chi by interpolation
-    if( (xi_.data_[ixip_1] < 1.0) && (xi_.data_[ixip_1+1] - xi_.data_[ixip_1] > 1e-15) ) {
+    if( (xi_.value( ixip_1 ) < 1.0) && (xi_.value( ixip_1+1 ) - xi_.value( ixip_1 ) > 1e-15) ) {
 
         log10_chiphm = ichiph_1*chiph_xip_delta_1
                        + xi_.axis1_min_[ichipa];
 
         log10_chiphp = log10_chiphm + chiph_xip_delta_1;
 
-        const double d_photon_chi = ( xi - xi_.data_[ixip_1] ) / ( xi_.data_[ixip_1+1] - xi_.data_[ixip_1] );
+        const double d_photon_chi = ( xi - xi_.value( ixip_1 ) ) / ( xi_.value( ixip_1+1 ) - xi_.value( ixip_1 ) );
 
         // Chiph after linear interpolation in the logarithmic scale
         photon_chi_1 = log10_chiphm*( 1.0-d_photon_chi ) + log10_chiphp*( d_photon_chi ) ;
@@ -488,12 +581,12 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
     }
 
     // Computation of the final photon_chi by interpolation
-    if( (xi_.data_[ixip_2] < 1.0) && (xi_.data_[ixip_2+1] - xi_.data_[ixip_2] > 1e-15) ) {
+    if( (xi_.value( ixip_2 ) < 1.0) && (xi_.value( ixip_2+1 ) - xi_.value( ixip_2 ) > 1e-15) ) {
         log10_chiphm = ichiph_2*chiph_xip_delta_2
                        + xi_.axis1_min_[ichipa+1];
         log10_chiphp = log10_chiphm + chiph_xip_delta_2;
 
-        const double d_photon_chi = ( xi - xi_.data_[ixip_2] ) / ( xi_.data_[ixip_2+1] - xi_.data_[ixip_2] );
+        const double d_photon_chi = ( xi - xi_.value( ixip_2 ) ) / ( xi_.value( ixip_2+1 ) - xi_.value( ixip_2 ) );
 
         // Chiph after linear interpolation in the logarithmic scale
         photon_chi_2 = log10_chiphm*( 1.0-d_photon_chi ) + log10_chiphp*( d_photon_chi ) ;
@@ -553,7 +646,7 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
 void RadiationTables::readHTable( SmileiMPI *smpi )
 {
     
-    std::string file = table_path_ + "/radiation_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         if( smpi->isMaster() ) {
             H5Read f( file );
@@ -582,8 +675,8 @@ void RadiationTables::readHTable( SmileiMPI *smpi )
             
         }
     } else {
-        ERROR_NAMELIST("The table H could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.",
+        ERROR_NAMELIST("The table H could not be read from the file: `"
+              << table_file_<<"`. Please check that the path is correct.",
               LINK_NAMELIST + std::string("#radiation-reaction"))
     }
 
@@ -608,7 +701,7 @@ void RadiationTables::readHTable( SmileiMPI *smpi )
 // -----------------------------------------------------------------------------
 void RadiationTables::readIntegfochiTable( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/radiation_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         if( smpi->isMaster() ) {
             H5Read f( file );
@@ -639,8 +732,8 @@ void RadiationTables::readIntegfochiTable( SmileiMPI *smpi )
     }
     // Else, the table can not be found, we throw an error
     else {
-        ERROR_NAMELIST("The table `integfochi` could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.",
+        ERROR_NAMELIST("The table `integfochi` could not be read from the file: `"
+              << table_file_<<"`. Please check that the path is correct.",
               LINK_NAMELIST + std::string("#radiation-reaction"))
     }
 }
@@ -652,7 +745,7 @@ void RadiationTables::readIntegfochiTable( SmileiMPI *smpi )
 // -----------------------------------------------------------------------------
 void RadiationTables::readXiTable( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/radiation_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         if( smpi->isMaster() ) {
             H5Read f( file );
@@ -681,8 +774,8 @@ void RadiationTables::readXiTable( SmileiMPI *smpi )
     }
     // Else, the table can not be found, we throw an error
     else {
-        ERROR_NAMELIST("The table `xi` could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.",
+        ERROR_NAMELIST("The table `xi` could not be read from the file: `"
+              << table_file_<<"`. Please check that the path is correct.",
               LINK_NAMELIST + std::string("#radiation-reaction"))
     }
 }
@@ -705,3 +798,44 @@ void RadiationTables::readTables( Params &params, SmileiMPI *smpi )
         RadiationTables::readXiTable( smpi );
     }
 }
+
+// -----------------------------------------------------------------------------
+//! Compute the tables with the requested resolution, in parallel. They are
+//! stored in a cache file named after their parameters, that is read instead
+//! when the same tables are requested again.
+//
+//! \param params list of simulation parameters
+//! \param smpi MPI parameters
+// -----------------------------------------------------------------------------
+void RadiationTables::computeTables( Params &params, SmileiMPI *smpi )
+{
+    table_file_ = QEDTablesComputation::cacheFile( table_path_, "radiation_tables",
+                  table_size_, table_chi_range_[0], table_chi_range_[1] );
+
+    // The master decides for all ranks whether the cache exists
+    int cached = smpi->isMaster() && Tools::fileExists( table_file_ ) ? 1 : 0;
+    MPI_Bcast( &cached, 1, MPI_INT, 0, smpi->world() );
+
+    if( cached ) {
+        MESSAGE( 1,"Reading of the tables computed previously: " << table_file_ );
+        readTables( params, smpi );
+        return;
+    }
+
+    MESSAGE( 1,"Computation of the tables (stored in " << table_file_ << ")" );
+    QEDTablesComputation::computeRadiationTables( niel_, integfochi_, xi_, table_size_,
+                                                  table_chi_range_[0], table_chi_range_[1], smpi );
+    if( smpi->isMaster() ) {
+        QEDTablesComputation::writeRadiationTables( table_file_, niel_, integfochi_, xi_ );
+    }
+
+    // checks
+    if( params.has_Niel_radiation_ && niel_computation_method_ == "table"
+        && minimum_chi_continuous_ < niel_.min_ ) {
+        ERROR_NAMELIST( "Parameter `minimum_chi_continuous_` (="
+               << minimum_chi_continuous_ << ") is below the lower bound of `table_chi_range` (="
+               << niel_.min_ << "), the lower bound of the h table should be equal or below "
+               << "the radiation threshold on chi.",
+               LINK_NAMELIST + std::string("#radiation-reaction") )
+    }
+}
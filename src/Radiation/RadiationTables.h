@@ -64,6 +64,32 @@ public:
     double computePhotonProductionYield( const double particle_chi,
                                          const double particle_gamma);
 
+    //! Same as computePhotonProductionYield, without branches so that it
+    //! vectorizes in loops over particles (the table lookup becomes a gather)
+    //! param[in] particle_chi particle quantum parameter
+    //! param[in] particle_gamma particle Lorentz factor
+    inline double __attribute__((always_inline)) computePhotonProductionYieldVectorized( const double particle_chi,
+                                                                                        const double particle_gamma )
+    {
+        const double logchipa = std::log10( particle_chi );
+        
+        // Lower index for interpolation in the table integfochi_ (clamped before the conversion)
+        const double x = std::fmin( std::fmax( ( logchipa-integfochi_.log10_min_ )*integfochi_.inv_delta_, -1. ),
+                                    ( double )integfochi_.size_ );
+        const int ichipa = int( std::floor( x ) );
+        const bool outside = ichipa < 0 || ichipa >= ( int )integfochi_.size_-1;
+        const int i = ichipa < 0 ? 0 : ( ichipa >= ( int )integfochi_.size_-1 ? ( int )integfochi_.size_-2 : ichipa );
+        
+        // Interpolation (the first value of the interval outside of the table)
+        const double logchipam = i*integfochi_.delta_ + integfochi_.log10_min_;
+        const double logchipap = logchipam + integfochi_.delta_;
+        const double dNphdt = outside ? integfochi_.data_[i] :
+                              ( integfochi_.data_[i+1]*std::fabs( logchipa-logchipam ) +
+                                integfochi_.data_[i]*std::fabs( logchipap - logchipa ) )*integfochi_.inv_delta_;
+        
+        return factor_dNph_dt_*dNphdt*particle_chi/particle_gamma;
+    };
+
     //! Determine randomly a photon quantum parameter photon_chi
     //! for an emission process
     //! from a particle chi value (particle_chi) and
@@ -205,6 +231,11 @@ public:
     //! \param smpi Object of class SmileiMPI containing MPI properties
     void readTables( Params &params, SmileiMPI *smpi );
 
+    //! Compute the tables with the requested resolution, or read them
+    //! from the cache if they were already computed with the same parameters
+    //! \param smpi Object of class SmileiMPI containing MPI properties
+    void computeTables( Params &params, SmileiMPI *smpi );
+
     // ---------------------------------------------------------------------
     // TABLE COMMUNICATIONS
     // ---------------------------------------------------------------------
@@ -216,6 +247,10 @@ public:
 
     void needNielTables();
 
+    //! Switch the tables to their compact format and, if requested,
+    //! report the differences with the double precision lookups
+    void compactTables( Params &params );
+
     // ---------------------------------------------
     // Table h for the
     // stochastic diffusive operator of Niel et al.
@@ -254,9 +289,24 @@ private:
     //! Path to the tables
     std::string table_path_;
 
+    //! File of the tables that are read
+    std::string table_file_;
+
     //! Flag that activate the table computation
     bool compute_table_;
 
+    //! Sizes of the particle and photon chi axes of the computed tables
+    std::vector<unsigned int> table_size_;
+
+    //! Boundaries of the particle chi axis of the computed tables
+    std::vector<double> table_chi_range_;
+
+    //! True if the lookups use the compact tables (single precision, fast logarithm)
+    bool compact_tables_;
+
+    //! True if the compact tables are compared to the double precision ones at initialization
+    bool compact_tables_validation_;
+
     //! Minimum threshold above which the Monte-Carlo algorithm is working
     //! This avoids using the Monte-Carlo algorithm when particle_chi is too low
     double minimum_chi_discontinuous_;
@@ -20,6 +20,10 @@ Table::Table()
 // -----------------------------------------------------------------------------
 Table::~Table()
 {
+    if (data_float_) {
+        delete [] data_float_;
+        data_float_ = nullptr;
+    }
     if (data_) {
         //smilei::tools::gpu::HostDeviceMemoryManagement::DeviceFree( data_, size_ );
         delete [] data_;
@@ -119,6 +123,26 @@ void Table::set (std::vector<double> & input_data) {
     }
 }
 
+// -----------------------------------------------------------------------------
+//! Create the single precision copy of data_ and use it in the lookups
+// -----------------------------------------------------------------------------
+void Table::compact () {
+
+    if (!data_) {
+        ERROR("Impossible to compact Table " << name_ << " because it is not allocated.")
+    }
+
+    if (!data_float_) {
+        data_float_ = new float [size_];
+    }
+
+    for (unsigned int i = 0 ; i < size_ ; i++) {
+        data_float_[i] = ( float )data_[i];
+    }
+    
+    compact_ = true;
+}
+
 // -----------------------------------------------------------------------------
 //! Bcast data_ and metadata to all MPI processes
 // -----------------------------------------------------------------------------
@@ -244,13 +268,13 @@ void Table::bcast (SmileiMPI *smpi) {
 double Table::get (double x) {
 
     // Position in the niel_.table
-    double d = ( std::log10( x )-log10_min_ )*inv_delta_;
+    double d = ( logarithm( x )-log10_min_ )*inv_delta_;
     int index = int( std::floor( d ) );
 
     // distance for interpolation
     d = d - std::floor( d );
 
     // Linear interpolation
-    return data_[index]*( 1.-d ) + data_[index+1]*( d );
+    return value( index )*( 1.-d ) + value( index+1 )*( d );
 }
 
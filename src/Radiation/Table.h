@@ -9,11 +9,13 @@
 #define TABLE_H
 
 #include <cstring>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "Tools.h"
 #include "SmileiMPI.h"
+#include "userFunctions.h"
 
 //------------------------------------------------------------------------------
 //! Table class: manage tabulated data
@@ -54,6 +56,48 @@ public:
     //! params[in] std::vector<double> & input_data : vector to be used to initialize table data
     void set(std::vector<double> & input_data);
     
+    //! Create the single precision copy of data_ and use it in the lookups (compact table)
+    void compact();
+    
+    //! Base-2 logarithm of x > 0, from the exponent bits and a series of the mantissa
+    //! (absolute error below 1e-9, no division by the table spacing nor call to log)
+    static inline double fastLog2( double x )
+    {
+        uint64_t bits;
+        std::memcpy( &bits, &x, sizeof( double ) );
+        double exponent = ( double )( ( int )( ( bits >> 52 ) & 0x7ff ) - 1023 );
+        // Mantissa in [1, 2[, then moved to [sqrt(1/2), sqrt(2)[
+        bits = ( bits & 0x000fffffffffffffULL ) | 0x3ff0000000000000ULL;
+        double m;
+        std::memcpy( &m, &bits, sizeof( double ) );
+        const bool high = m > 1.4142135623730951;
+        m = high ? 0.5*m : m;
+        exponent += high ? 1. : 0.;
+        // log2(m) = 2/ln(2) atanh(t) with |t| < 0.172
+        const double t = ( m-1. )/( m+1. );
+        const double t2 = t*t;
+        return exponent + 2.8853900817779268*t*( 1. + t2*( 1./3. + t2*( 0.2 + t2*( 1./7. + t2*( 1./9. + t2/11. ) ) ) ) );
+    };
+    
+    //! Logarithm in base 10 used to find the position in the table: fast for compact tables
+    inline double logarithm( double x ) const
+    {
+        return compact_ ? fastLog2( x )*0.30102999566398120 : std::log10( x );
+    };
+    
+    //! Value of the table at index i, in single precision for compact tables
+    inline double value( unsigned int i ) const
+    {
+        return compact_ ? ( double )data_float_[i] : data_[i];
+    };
+    
+    //! Index of the interval containing x in the n monotonic values starting at index start
+    inline int search( unsigned int start, double x, int n ) const
+    {
+        return compact_ ? userFunctions::searchValuesInMonotonicArray( &data_float_[start], ( float )x, n )
+                        : userFunctions::searchValuesInMonotonicArray( &data_[start], x, n );
+    };
+    
     //! Return pointer to the data_ array
     inline double * __attribute__((always_inline)) data()
     {
@@ -68,6 +112,12 @@ public:
     // Main data array
     double * data_ = nullptr;
     
+    //! Single precision copy of data_ (compact table, 256x256 values fit in L2)
+    float * data_float_ = nullptr;
+    
+    //! True if the lookups use data_float_ and fastLog2
+    bool compact_ = false;
+    
     // Min values for axis 1 (only relevant if dimension_ > 1)
     double * axis1_min_ = nullptr;
     
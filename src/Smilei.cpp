@@ -37,6 +37,7 @@
 #include "DoubleGrids.h"
 #include "DoubleGridsAM.h"
 #include "Timers.h"
+#include "Telemetry.h"
 
 using namespace std;
 
@@ -150,6 +151,7 @@ int main( int argc, char *argv[] )
 
     // Create timers
     Timers timers( &smpi );
+    timers.initHardwareCounters( params );
 
     // Print in stdout MPI, OpenMP, patchs parameters
     params.print_parallelism_params( &smpi );
@@ -315,7 +317,7 @@ int main( int argc, char *argv[] )
             vecPatches.runRelativisticModule( time_prim, params, &smpi,  timers );
         }
 
-        vecPatches.computeCharge();
+        vecPatches.computeCharge( time_dual );
 
         // TODO(Etienne M): redundant work is done here. We exchange current
         // density J when in fact, only charge density Rho needs to be exchanged.
@@ -371,8 +373,7 @@ int main( int argc, char *argv[] )
                 for (unsigned int imode = 0 ; imode < params.nmodes ; imode++  ) {
                     DoubleGridsAM::syncFieldsOnRegion( vecPatches, region, params, &smpi, imode );
                     // Need to fill all ghost zones, not covered by patches ghost zones
-                    SyncVectorPatch::exchangeE( params, region.vecPatch_, imode, &smpi );
-                    SyncVectorPatch::exchangeB( params, region.vecPatch_, imode, &smpi );
+                    SyncVectorPatch::exchangeEB( params, region.vecPatch_, imode, &smpi );
                 }
             }
         }
@@ -400,8 +401,7 @@ int main( int argc, char *argv[] )
                 for (unsigned int imode = 0 ; imode < params.nmodes ; imode++  ) {
                     DoubleGridsAM::syncFieldsOnRegion( vecPatches, region, params, &smpi, imode );
                     // Need to fill all ghost zones, not covered by patches ghost zones
-                    SyncVectorPatch::exchangeE( params, region.vecPatch_, imode, &smpi );
-                    SyncVectorPatch::exchangeB( params, region.vecPatch_, imode, &smpi );
+                    SyncVectorPatch::exchangeEB( params, region.vecPatch_, imode, &smpi );
                 }
             }
         }
@@ -451,6 +451,8 @@ int main( int argc, char *argv[] )
 
     timers.reboot();
     timers.global.reboot();
+    smpi.sent_bytes_[SmileiMPI::sent_particles] = 0;
+    smpi.sent_bytes_[SmileiMPI::sent_fields] = 0;
 
     // ------------------------------------------------------------------------
     // Check expected disk usage
@@ -479,6 +481,8 @@ int main( int argc, char *argv[] )
 
     int count_dlb = 0;
 
+    Telemetry telemetry( params, &smpi, timers, checkpoint.this_run_start_step );
+
     unsigned int itime=checkpoint.this_run_start_step+1;
     while( ( itime <= params.n_time ) && ( !checkpoint.exit_asap ) ) {
         
@@ -489,10 +493,22 @@ int main( int argc, char *argv[] )
         if( params.keep_python_running_ ) {
             PyTools::setIteration( itime ); // sets python variable "Main.iteration" for users
         }
+#ifdef _PARTEVENTTRACING
+        smpi.event_tracing_now_ = smpi.diagPartEventTracing( time_dual, params.timestep );
+#endif
         
         #pragma omp parallel shared (time_dual,smpi,params, vecPatches, region, simWindow, checkpoint, itime)
         {
             
+            // Random generators keyed on the iteration
+            if( params.counter_based_random ) {
+                vecPatches.reseedRandom( params, itime );
+            }
+
+            // Particles of the patches brought by the moving window at the previous iteration,
+            // created before all the operators of this iteration
+            simWindow->createPendingParticlesInParallel( vecPatches, params );
+
             // Patch reconfiguration
             if( params.has_adaptive_vectorization && params.adaptive_vecto_time_selection->theTimeIsNow( itime ) ) {
                 vecPatches.reconfiguration( params, timers, itime );
@@ -511,7 +527,7 @@ int main( int argc, char *argv[] )
 
             // Reset global charge and currents densities to zero and computes rho old before moving particles
             if ( params.geometry == "AMcylindrical" && params.is_spectral )
-                vecPatches.computeCharge(true);
+                vecPatches.computeCharge( time_dual, true );
 
             // (1) interpolate the fields at the particle position
             // (2) move the particle
@@ -639,6 +655,9 @@ int main( int argc, char *argv[] )
             // Particle merging
             vecPatches.mergeParticles(params, time_dual,timers, itime );
 
+            // Particle splitting
+            vecPatches.splitParticles(params, time_dual,timers, itime );
+
             // Particle injection from the boundaries
             vecPatches.injectParticlesFromBoundaries(params, timers, itime );
 
@@ -653,9 +672,7 @@ int main( int argc, char *argv[] )
                     // Standard fields operations (maxwell + comms + boundary conditions) are completed
                     // apply prescribed fields can be considered if requested
                     if( vecPatches(0)->EMfields->prescribedFields.size() ) {
-                        #pragma omp master
                         vecPatches.applyPrescribedFields( time_prim );
-                        #pragma omp barrier
                     }
                 }
             }
@@ -688,7 +705,8 @@ int main( int argc, char *argv[] )
 
         } //End omp parallel region
 
-        if( params.has_load_balancing && params.load_balancing_time_selection->theTimeIsNow( itime ) ) {
+        if( params.has_load_balancing && params.load_balancing_time_selection->theTimeIsNow( itime )
+            && vecPatches.needsLoadBalancing( params, &smpi, timers ) ) {
 // #if defined( SMILEI_ACCELERATOR_GPU )
 //             ERROR( "Load balancing not tested on GPU !" );
 // #endif
@@ -737,6 +755,10 @@ int main( int argc, char *argv[] )
             }
         }
 
+        // Work of this iteration, for the throughputs of the final profile
+        timers.countWork( vecPatches.getNumberOfPushedParticles( time_dual ),
+                          time_dual > params.time_fields_frozen ? ( double )vecPatches.size() * params.n_cell_per_patch : 0. );
+
         // print message at given time-steps
         // --------------------------------
         if( params.printNow( itime ) ) {
@@ -748,10 +770,23 @@ int main( int argc, char *argv[] )
             #pragma omp barrier
         }
 
+        if( telemetry.theTimeIsNow( itime ) ) {
+            telemetry.write( itime, time_dual, vecPatches, &smpi );
+        }
+
+#ifdef _PARTEVENTTRACING
+        if( smpi.event_tracing_now_ ) {
+            smpi.writeEventTracing( itime );
+        }
+#endif
+
         itime++;
     
     }//END of the time loop
 
+    // The last checkpoint may still be written
+    checkpoint.waitDump( &smpi );
+
     smpi.barrier();
 
     // ------------------------------------------------------------------
@@ -832,6 +867,11 @@ int executeTestMode( VectorPatch &vecPatches,
         vecPatches.checkExpectedDiskUsage( smpi, params, checkpoint );
     }
 
+    SmileiMPI_test *smpi_test = dynamic_cast<SmileiMPI_test *>( smpi );
+    if( smpi_test && smpi_test->balance_report_ ) {
+        smpi_test->reportBalance( params, vecPatches );
+    }
+
     // If test mode enable, code stops here
     TITLE( "Keeping or closing the python runtime environment" );
     params.cleanup( smpi );
@@ -60,6 +60,26 @@ void AsyncMPIbuffers::defineTags( Patch *patch, SmileiMPI *smpi, int tag )
 }
 
 
+std::size_t AsyncMPIbuffers::getMemFootPrint()
+{
+    std::size_t mem = 0;
+    for( unsigned int iDim=0 ; iDim<3 ; iDim++ ) {
+        for( unsigned int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+            mem += buf[iDim][iNeighbor].capacity() * sizeof( double );
+            mem += ibuf[iDim][iNeighbor].capacity() * sizeof( complex<double> );
+        }
+        for( unsigned int imsg=0 ; imsg<rankSend[iDim].size() ; imsg++ ) {
+            mem += rankSend[iDim][imsg].buffer.capacity() * sizeof( double );
+        }
+        for( unsigned int imsg=0 ; imsg<rankRecv[iDim].size() ; imsg++ ) {
+            mem += rankRecv[iDim][imsg].buffer.capacity() * sizeof( double );
+        }
+        mem += ( neighborExchange[iDim].send.capacity() + neighborExchange[iDim].recv.capacity() ) * sizeof( double );
+    }
+    return mem;
+}
+
+
 SpeciesMPIbuffers::SpeciesMPIbuffers()
 {
 }
@@ -76,6 +96,29 @@ SpeciesMPIbuffers::~SpeciesMPIbuffers()
 }
 
 
+std::size_t SpeciesMPIbuffers::getMemFootPrint()
+{
+    std::size_t mem = AsyncMPIbuffers::getMemFootPrint();
+    for( size_t i=0 ; i<partRecv.size() ; i++ ) {
+        for( unsigned int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+            Particles *particles[2] = { partSend[i][iNeighbor], partRecv[i][iNeighbor] };
+            for( unsigned int j=0 ; j<2 ; j++ ) {
+                std::size_t particle_size = particles[j]->double_prop_.size() * sizeof( double )
+                                          + particles[j]->short_prop_.size() * sizeof( short )
+                                          + particles[j]->uint64_prop_.size() * sizeof( uint64_t );
+                mem += particle_size * particles[j]->capacity();
+            }
+        }
+    }
+    for( unsigned int iDim=0 ; iDim<3 ; iDim++ ) {
+        for( unsigned int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+            mem += packedSend[iDim][iNeighbor].capacity() + packedRecv[iDim][iNeighbor].capacity();
+        }
+    }
+    return mem;
+}
+
+
 void SpeciesMPIbuffers::allocate( Params &params, Patch *patch )
 {
     srequest.resize( params.nDim_field );
@@ -10,6 +10,42 @@
 class Field;
 class Patch;
 class SmileiMPI;
+class SharedMemoryHalos;
+
+//! Message aggregating the boundaries of several patches exchanged with one MPI process
+struct RankMessage {
+    //! Remote MPI process
+    int rank;
+    //! Side of the direction of the exchange (iNeighbor of the sending patches)
+    int side;
+    //! Send or receive buffers of the patch boundaries, in the order of the message
+    std::vector<Field *> fields;
+    //! Contiguous buffer of the message (only grows)
+    std::vector<double> buffer;
+    //! Number of doubles of the message
+    unsigned int size;
+    MPI_Request request;
+    //! Position of the message in the buffers of the neighborhood collective
+    unsigned int offset;
+    //! Position of the message in the shared memory of the node (NULL if sent by MPI), and its identifier
+    double *shared;
+    SharedMemoryHalos *halos;
+    long seq;
+    //! Number of patches of the message still to be extracted before it is sent (Main.overlap_current_sums)
+    int pending;
+    //! Direction along which each boundary is reduced to its nonzero extent (Main.sparse_current_sums), -1 if not
+    int sparse;
+};
+
+//! Neighborhood collective exchanging the messages of a list of fields along one direction with all
+//! the neighbor MPI processes: the messages to one process are contiguous, side 0 first
+struct NeighborExchange {
+    NeighborExchange() : request( MPI_REQUEST_NULL ), pending( false ) {};
+    std::vector<double> send, recv;
+    std::vector<int> send_counts, send_displs, recv_counts, recv_displs;
+    MPI_Request request;
+    bool pending;
+};
 
 class AsyncMPIbuffers
 {
@@ -21,12 +57,22 @@ public:
     
     void defineTags( Patch *patch, SmileiMPI *smpi, int tag ) ;
     
+    //! Memory allocated for the buffers (bytes)
+    std::size_t getMemFootPrint();
+    
     //! ndim vectors of 2 sent requests (1 per direction)
     std::vector< std::vector<MPI_Request> > srequest;
     //! ndim vectors of 2 received requests (1 per direction)
     std::vector< std::vector<MPI_Request> > rrequest;
     std::vector< double >  buf[3][2];
     std::vector< std::complex<double> >  ibuf[3][2];
+
+    //! Messages aggregating the boundaries of all the patches of a list of fields, per direction:
+    //! one per remote MPI process and side (held by the buffers of the first field of the list)
+    std::vector<RankMessage> rankSend[3];
+    std::vector<RankMessage> rankRecv[3];
+    //! Neighborhood collectives exchanging these messages (Main.neighborhood_collectives)
+    NeighborExchange neighborExchange[3];
     
     std::vector< std::vector<int> > send_tags_, recv_tags_;
     
@@ -40,6 +86,9 @@ public:
     
     void allocate( Params &params, Patch *patch ) ;
     
+    //! Memory allocated for the buffers, including the packets of particles (bytes)
+    std::size_t getMemFootPrint();
+    
     //! ndim vectors of 2 sent packets of particles (1 per direction)
     std::vector< std::vector<Particles* > > partRecv;
     //! ndim vectors of 2 received packets of particles (1 per direction)
@@ -50,6 +99,11 @@ public:
     //! ndim vectors of 2 numbers of particles to receive (1 per direction)
     std::vector< std::vector< unsigned int > > partRecvSize;
     
+    //! Contiguous buffers used when particles are packed for MPI (only grow)
+    std::vector<char> packedSend[3][2];
+    std::vector<char> packedRecv[3][2];
+    
+    
 };
 
 #endif
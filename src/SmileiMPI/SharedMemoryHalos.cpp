@@ -0,0 +1,203 @@
+#include "SharedMemoryHalos.h"
+
+using namespace std;
+
+SharedMemoryHalos::SharedMemoryHalos( MPI_Comm world )
+    : allocated_( false )
+{
+    MPI_Comm_split_type( world, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm_ );
+    MPI_Comm_group( world, &world_group_ );
+    MPI_Comm_group( node_comm_, &node_group_ );
+}
+
+SharedMemoryHalos::~SharedMemoryHalos()
+{
+    if( allocated_ ) {
+        MPI_Win_unlock_all( window_ );
+        MPI_Win_free( &window_ );
+    }
+    MPI_Group_free( &node_group_ );
+    MPI_Group_free( &world_group_ );
+    MPI_Comm_free( &node_comm_ );
+}
+
+int SharedMemoryHalos::nodeRank( int rank )
+{
+    int node_rank;
+    MPI_Group_translate_ranks( world_group_, 1, &rank, node_group_, &node_rank );
+    return node_rank;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Segment of each MPI process: a header of 4 counters per process of the node, then the rings of its messages
+//     - header[4*j  ] : number of messages written in the ring to the process j
+//     - header[4*j+1] : number of messages of the process j released by this process
+//     - header[4*j+2] : position of the ring to the process j after the header (in doubles)
+//     - header[4*j+3] : capacity of the ring to the process j (in doubles)
+// ---------------------------------------------------------------------------------------------------------------------
+void SharedMemoryHalos::update( const std::map<int, unsigned long> &capacity )
+{
+    if( allocated_ ) {
+        MPI_Win_unlock_all( window_ );
+        MPI_Win_free( &window_ );
+        allocated_ = false;
+    }
+    send_.clear();
+    recv_.clear();
+
+    int node_size, node_me;
+    MPI_Comm_size( node_comm_, &node_size );
+    MPI_Comm_rank( node_comm_, &node_me );
+
+    const unsigned long header_size = 4 * node_size;
+    unsigned long rings_size = 0;
+    for( std::map<int, unsigned long>::const_iterator it = capacity.begin() ; it != capacity.end() ; it++ ) {
+        rings_size += it->second;
+    }
+    long *header;
+    MPI_Win_allocate_shared( header_size*sizeof( long ) + rings_size*sizeof( double ), 1, MPI_INFO_NULL, node_comm_, &header, &window_ );
+    allocated_ = true;
+
+    for( unsigned long i=0 ; i<header_size ; i++ ) {
+        header[i] = 0;
+    }
+    unsigned long offset = 0;
+    for( std::map<int, unsigned long>::const_iterator it = capacity.begin() ; it != capacity.end() ; it++ ) {
+        const int j = nodeRank( it->first );
+        header[4*j+2] = offset;
+        header[4*j+3] = it->second;
+        offset += it->second;
+    }
+
+    // The headers of all the processes are written before they are read
+    MPI_Win_lock_all( MPI_MODE_NOCHECK, window_ );
+    MPI_Win_sync( window_ );
+    MPI_Barrier( node_comm_ );
+    MPI_Win_sync( window_ );
+
+    for( std::map<int, unsigned long>::const_iterator it = capacity.begin() ; it != capacity.end() ; it++ ) {
+        const int j = nodeRank( it->first );
+        MPI_Aint size;
+        int disp_unit;
+        long *remote;
+        MPI_Win_shared_query( window_, j, &size, &disp_unit, &remote );
+
+        Ring &send = send_[it->first];
+        send.data      = reinterpret_cast<double *>( header + header_size ) + header[4*j+2];
+        send.capacity  = header[4*j+3];
+        send.written   = &header[4*j];
+        send.released  = &remote[4*node_me+1];
+
+        Ring &recv = recv_[it->first];
+        recv.data      = reinterpret_cast<double *>( remote + header_size ) + remote[4*node_me+2];
+        recv.capacity  = remote[4*node_me+3];
+        recv.written   = &remote[4*node_me];
+        recv.released  = &header[4*j+1];
+
+        for( int send_recv=0 ; send_recv<2 ; send_recv++ ) {
+            Ring &ring = send_recv ? recv : send;
+            ring.head = 0;
+            ring.nreserved = 0;
+            ring.nreleased = 0;
+        }
+    }
+}
+
+double *SharedMemoryHalos::reserve( int rank, bool send, unsigned int size, long &seq )
+{
+    std::map<int, Ring> &rings = send ? send_ : recv_;
+    std::map<int, Ring>::iterator it = rings.find( rank );
+    if( it == rings.end() || size == 0 || size > it->second.capacity ) {
+        return NULL;
+    }
+    Ring &ring = it->second;
+    const unsigned long offset = ( ring.head + size <= ring.capacity ) ? ring.head : 0;
+
+    // The position must not overlap a message in flight
+    for( unsigned int i=0 ; i<ring.regions.size() ; i++ ) {
+        const Region &r = ring.regions[i];
+        if( r.ordinal < 0 && offset < r.offset+r.size && r.offset < offset+size ) {
+            return NULL;
+        }
+    }
+
+    // The released messages at this position must have been unpacked by the receiver
+    long needed = 0;
+    for( unsigned int i=0 ; i<ring.regions.size() ; ) {
+        const Region &r = ring.regions[i];
+        if( offset < r.offset+r.size && r.offset < offset+size ) {
+            needed = std::max( needed, r.ordinal+1 );
+            ring.regions.erase( ring.regions.begin()+i );
+        } else {
+            i++;
+        }
+    }
+    if( send && needed > 0 ) {
+        waitCounter( ring.released, needed );
+    }
+
+    Region region;
+    region.offset  = offset;
+    region.size    = size;
+    region.seq     = ring.nreserved++;
+    region.ordinal = -1;
+    ring.regions.push_back( region );
+    ring.head = offset + size;
+    seq = region.seq;
+    return ring.data + offset;
+}
+
+void SharedMemoryHalos::publish( int rank )
+{
+    Ring &ring = send_[rank];
+    MPI_Win_sync( window_ );
+    *ring.written = *ring.written + 1;
+    MPI_Win_sync( window_ );
+}
+
+void SharedMemoryHalos::wait( int rank, long seq )
+{
+    waitCounter( recv_[rank].written, seq+1 );
+}
+
+void SharedMemoryHalos::release( int rank, bool send, long seq )
+{
+    Ring &ring = send ? send_[rank] : recv_[rank];
+    for( unsigned int i=0 ; i<ring.regions.size() ; i++ ) {
+        if( ring.regions[i].seq == seq ) {
+            if( send ) {
+                ring.regions[i].ordinal = ring.nreleased++;
+            } else {
+                ring.nreleased++;
+                ring.regions.erase( ring.regions.begin()+i );
+            }
+            break;
+        }
+    }
+    if( send ) {
+        // Released positions already unpacked by the receiver are free
+        MPI_Win_sync( window_ );
+        const long released = *ring.released;
+        for( unsigned int i=0 ; i<ring.regions.size() ; ) {
+            if( ring.regions[i].ordinal >= 0 && ring.regions[i].ordinal < released ) {
+                ring.regions.erase( ring.regions.begin()+i );
+            } else {
+                i++;
+            }
+        }
+    } else {
+        MPI_Win_sync( window_ );
+        *ring.released = ring.nreleased;
+        MPI_Win_sync( window_ );
+    }
+}
+
+void SharedMemoryHalos::waitCounter( volatile long *counter, long value )
+{
+    while( true ) {
+        MPI_Win_sync( window_ );
+        if( *counter >= value ) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef SHAREDMEMORYHALOS_H
+#define SHAREDMEMORYHALOS_H
+
+#include <mpi.h>
+#include <map>
+#include <vector>
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class SharedMemoryHalos
+//
+//! Halo messages between MPI processes of the same node through an MPI-3 shared memory window
+//! (Main.shared_memory_halos). Each process owns, in its segment of the window, one ring buffer per neighbor
+//! process of the node: the sender packs the message directly in the ring, and the receiver unpacks it
+//! directly from the ring of the sender, without any MPI message.
+//!
+//! Both processes execute the same sequence of exchanges, so that they reserve the same positions in the ring
+//! without communicating them. A message which does not fit in the ring (next to the messages still in
+//! flight) is sent by MPI instead, which both processes also decide the same way. The only synchronizations
+//! are two counters per ring: the number of messages written by the sender, and the number of messages
+//! released by the receiver (which is then waited for before a released position is written again).
+//  --------------------------------------------------------------------------------------------------------------------
+class SharedMemoryHalos
+{
+
+public:
+    SharedMemoryHalos( MPI_Comm world );
+    ~SharedMemoryHalos();
+
+    //! Allocate the window, with a ring of `capacity` doubles for each neighbor MPI process of the node
+    //! (collective in the node, no message in flight)
+    void update( const std::map<int, unsigned long> &capacity );
+
+    //! Node rank of the MPI process `rank`, MPI_UNDEFINED if it is not on this node
+    int nodeRank( int rank );
+
+    //! Number of lists of fields in flight at the same time accounted in the capacity of the rings
+    static const unsigned int nlists_ = 6;
+
+    //! Position of the next message of `size` doubles to (send) or from (!send) the MPI process `rank`,
+    //! NULL if the message is sent by MPI. seq identifies the message in the next calls
+    double *reserve( int rank, bool send, unsigned int size, long &seq );
+    //! The message of the sender is written in the ring
+    void publish( int rank );
+    //! Wait for the message seq of the sender
+    void wait( int rank, long seq );
+    //! The exchange of the message seq is finalized (unpacked by the receiver)
+    void release( int rank, bool send, long seq );
+
+private:
+
+    //! Reserved position of a message in a ring, in flight until released (then `ordinal` is its release order)
+    struct Region {
+        unsigned long offset, size;
+        long seq, ordinal;
+    };
+
+    //! Positions of the messages of one ring, mirrored by the sender and the receiver
+    struct Ring {
+        double *data;
+        unsigned long capacity, head;
+        long nreserved, nreleased;
+        std::vector<Region> regions;
+        //! Counters of the ring in the window (written by the sender, released by the receiver)
+        volatile long *written, *released;
+    };
+
+    //! Rings of the messages to and from each neighbor MPI process of the node, by rank in world
+    std::map<int, Ring> send_, recv_;
+
+    MPI_Comm node_comm_;
+    MPI_Group world_group_, node_group_;
+    MPI_Win window_;
+    bool allocated_;
+
+    //! Memory barrier of the window, then wait until the counter reaches `value`
+    void waitCounter( volatile long *counter, long value );
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <iomanip>
 
 #include "Params.h"
 #include "Tools.h"
@@ -28,6 +29,7 @@
 #include "Hilbert_functions.h"
 #include "VectorPatch.h"
 #include "DomainDecomposition.h"
+#include "SharedMemoryHalos.h"
 
 #include "Diagnostic.h"
 #include "DiagnosticScalar.h"
@@ -35,6 +37,7 @@
 #include "DiagnosticScreen.h"
 #include "DiagnosticRadiationSpectrum.h"
 #include "DiagnosticProbes.h"
+#include "ExactSum.h"
 
 #include "Laser.h"
 #include "LaserEnvelope.h"
@@ -49,6 +52,7 @@ using namespace std;
 SmileiMPI::SmileiMPI( int *argc, char ***argv )
 {
     test_mode = false;
+    shapeold_rows_ = 0;
 
     // Send information on current simulation
     int mpi_provided;
@@ -73,6 +77,13 @@ SmileiMPI::SmileiMPI( int *argc, char ***argv )
     world_ = MPI_COMM_WORLD;
     MPI_Comm_size( world_, &smilei_sz );
     MPI_Comm_rank( world_, &smilei_rk );
+    MPI_Comm_dup( world_, &halo_comm_ );
+    neighborhood_collectives_ = false;
+    neighbor_comm_ = MPI_COMM_NULL;
+    shared_halos_ = NULL;
+    sparse_current_sums_ = false;
+    batching_ = false;
+    event_tracing_now_ = false;
 
     MPI_Allreduce( &number_of_cores, &global_number_of_cores, 1, MPI_INT, MPI_SUM, world_ );
 } // END SmileiMPI::SmileiMPI
@@ -86,6 +97,18 @@ SmileiMPI::~SmileiMPI()
 {
     delete[]periods_;
 
+    if( neighbor_comm_ != MPI_COMM_NULL ) {
+        MPI_Comm_free( &neighbor_comm_ );
+    }
+    delete shared_halos_;
+    if( event_tracing_file_.is_open() ) {
+        event_tracing_file_ << "\n]\n";
+        event_tracing_file_.close();
+    }
+    MPI_Comm_free( &halo_comm_ );
+    if( world_ != MPI_COMM_WORLD ) {
+        MPI_Comm_free( &world_ );
+    }
     MPI_Finalize();
 
 } // END SmileiMPI::~SmileiMPI
@@ -102,14 +125,15 @@ void SmileiMPI::bcast( string &val )
     }
     MPI_Bcast( &charSize, 1, MPI_INT, 0, world_ );
 
-    char tmp[charSize];
+    // On the heap: the broadcast namelist may be large
+    vector<char> tmp( charSize );
     if( isMaster() ) {
-        strcpy( tmp, val.c_str() );
+        strcpy( &tmp[0], val.c_str() );
     }
-    MPI_Bcast( tmp, charSize, MPI_CHAR, 0, world_ );
+    MPI_Bcast( &tmp[0], charSize, MPI_CHAR, 0, world_ );
 
     if( !isMaster() ) {
-        val=tmp;
+        val=&tmp[0];
     }
 
 } // END bcast( string )
@@ -130,10 +154,24 @@ void SmileiMPI::bcast( int &val )
 // ---------------------------------------------------------------------------------------------------------------------
 void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition )
 {
+    // The patches are distributed in the order of the ranks
+    if( params.topology_aware_placement ) {
+        placeRanksByTopology();
+    }
+
     // Initialize patch environment
     patch_count.resize( smilei_sz, 0 );
-    capabilities.resize( smilei_sz, 1 );
+    capabilities.resize( smilei_sz, 1. );
     Tcapabilities = smilei_sz;
+    // In a job mixing CPU and GPU processes, the patches are distributed according to the throughput of each process
+    if( params.gpu_rank_capability != 1. ) {
+        double capability = params.gpu_computing ? params.gpu_rank_capability : 1.;
+        MPI_Allgather( &capability, 1, MPI_DOUBLE, &capabilities[0], 1, MPI_DOUBLE, world_ );
+        Tcapabilities = 0.;
+        for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+            Tcapabilities += capabilities[rk];
+        }
+    }
 
     if( smilei_rk == 0 ) {
         remove( "patch_load.txt" ) ;
@@ -151,6 +189,22 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
     
     use_BTIS3 = params.use_BTIS3;
 
+    neighborhood_collectives_ = params.neighborhood_collectives;
+    sparse_current_sums_ = params.sparse_current_sums;
+    if( params.shared_memory_halos ) {
+        shared_halos_ = new SharedMemoryHalos( world_ );
+    }
+
+    // Shape coefficients of the old position shared by the interpolator and the projector
+    shapeold_rows_ = params.reuse_shape_coefficients ? params.nDim_field * ( params.interpolation_order+1 ) : 0;
+    if( shapeold_rows_ > 0 ) {
+#ifdef _OPENMP
+        dynamics_shapeold.resize( omp_get_max_threads() );
+#else
+        dynamics_shapeold.resize( 1 );
+#endif
+    }
+
 #ifdef _OPENMP
     dynamics_Epart.resize( omp_get_max_threads() );
     dynamics_Bpart.resize( omp_get_max_threads() );
@@ -237,6 +291,12 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
 
 #ifdef _PARTEVENTTRACING
     iter_frequency_particle_event_tracing_ = 100;
+    // The times of all processes are relative to the same start, so that their timelines can be merged
+    MPI_Barrier( world_ );
+    reference_time_ = MPI_Wtime();
+    traced_event_names_ = { "Interp", "Push", "BC", "Proj", "DensityReduction", "Ionization", "Radiation", "MultiphotonBW",
+                            "IonizReduction", "RadReduction", "MBWReduction", "VectoKeys", "MPIWait"
+                          };
     int nthreads = omp_get_max_threads();
     particle_event_tracing_event_time_.resize(nthreads);
     particle_event_tracing_start_or_end_.resize(nthreads);
@@ -266,26 +326,63 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
         // initialize vectors to zero size
         particle_event_tracing_event_time_[ithread].resize(0);          // stores time
         particle_event_tracing_start_or_end_[ithread].resize(0);        // stores start (0) or end (1)
-        particle_event_tracing_event_name_[ithread].resize(0);          // stores task type
-        // task types:
-        // -  0: Interp 
-        // -  1: Push
-        // -  2: Particle BC
-        // -  3: Proj
-        // -  4: Density Reduction (tasks subgrids)
-        // -  5: Ionization
-        // -  6: Radiation
-        // -  7: Multiphoton Breit Wheeler
-        // -  8: Ionization Reduction of new electrons
-        // -  9: Radiation Reduction of new photons
-        // - 10: Multiphoton Breit Wheeler Reduction of new electron-positron couples
-        // - 11: Computation of keys and count for vectorization
+        particle_event_tracing_event_name_[ithread].resize(0);          // stores task type (index in traced_event_names_)
     }
 #endif
 
 } // END init
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Event tracing: kinds of traced events, and timeline of the traced events in the Chrome trace format
+// (JSON array of events, opened by Perfetto or chrome://tracing), with one track per OpenMP thread
+// ---------------------------------------------------------------------------------------------------------------------
+int SmileiMPI::addTracedEvent( string name )
+{
+    traced_event_names_.push_back( name );
+    return traced_event_names_.size()-1;
+}
+
+void SmileiMPI::writeEventTracing( int iteration )
+{
+    // The array is closed at the end of the simulation, but the viewers also read the file of an interrupted run
+    if( ! event_tracing_file_.is_open() ) {
+        event_tracing_file_.open( "event_tracing_rank_"+to_string( smilei_rk )+".json" );
+        event_tracing_file_ << "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << smilei_rk
+                            << ",\"args\":{\"name\":\"MPI process " << smilei_rk << "\"}}";
+        for( unsigned int ithread=0; ithread<particle_event_tracing_event_time_.size(); ithread++ ) {
+            event_tracing_file_ << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << smilei_rk << ",\"tid\":" << ithread
+                                << ",\"args\":{\"name\":\"OpenMP thread " << ithread << "\"}}";
+        }
+        event_tracing_file_ << fixed << setprecision( 3 );
+    }
+
+    for( unsigned int ithread=0; ithread<particle_event_tracing_event_time_.size(); ithread++ ) {
+        vector<double> &time = particle_event_tracing_event_time_[ithread];
+        vector<unsigned int> &start_or_end = particle_event_tracing_start_or_end_[ithread];
+        vector<int> &name = particle_event_tracing_event_name_[ithread];
+        // The events of a thread are nested (tasks are tied): the start of each event is stacked until its end,
+        // and complete events (start and duration in microseconds) are written
+        vector<unsigned int> started;
+        for( unsigned int ievent=0; ievent<time.size(); ievent++ ) {
+            if( start_or_end[ievent] == 0 ) {
+                started.push_back( ievent );
+            } else if( ! started.empty() ) {
+                unsigned int istart = started.back();
+                started.pop_back();
+                event_tracing_file_ << ",\n{\"name\":\"" << traced_event_names_[name[istart]] << "\",\"ph\":\"X\",\"pid\":" << smilei_rk
+                                    << ",\"tid\":" << ithread << ",\"ts\":" << time[istart]*1.e6 << ",\"dur\":" << ( time[ievent]-time[istart] )*1.e6
+                                    << ",\"args\":{\"iteration\":" << iteration << "}}";
+            }
+        }
+        time.clear();
+        start_or_end.clear();
+        name.clear();
+    }
+    event_tracing_file_.flush();
+}
+
+
 // ---------------------------------------------------------------------------------------------------------------------
 //  Initialize patch distribution
 // ---------------------------------------------------------------------------------------------------------------------
@@ -310,13 +407,7 @@ void SmileiMPI::init_patch_count( Params &params, DomainDecomposition *domain_de
 
     unsigned int tot_species_number = PyTools::nComponents( "Species" );
 
-    // Define capabilities here if not default.
-    //Capabilities of devices hosting the different mpi processes. All capabilities are assumed to be equal for the moment.
-    //Compute total capability: Tcapabilities. Uncomment if cpability != 1 per MPI rank
-    //Tcapabilities = 0;
-    //for (unsigned int i = 0; i < smilei_sz; i++)
-    //    Tcapabilities += capabilities[i];
-
+    //Capabilities of devices hosting the different mpi processes, and total capability Tcapabilities, are set in init.
     //Compute target load: Tload = Total load * local capability / Total capability.
 
     // Some initialization of the box parameters
@@ -386,7 +477,7 @@ void SmileiMPI::init_patch_count( Params &params, DomainDecomposition *domain_de
     // Fourth, the arrangement of patches is balanced
 
     // Initialize loads
-    MPI_Reduce( &total_load, &Tload, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+    MPI_Reduce( &total_load, &Tload, 1, MPI_DOUBLE, MPI_SUM, 0, world_ );
     Tload /= Tcapabilities; //Target load for each mpi process.
     Tcur = Tload * capabilities[0];  //Init.
     r = 0;  //Start by finding work for rank 0.
@@ -510,6 +601,15 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
     unsigned int tot_species_number = vecpatches( 0 )->vecSpecies.size();
     cells_load = ncells_perpatch*params.cell_load ;
 
+    // The target load of each rank is proportional to its capability
+    double previous_capabilities = 0., smallest_capability = capabilities[0];
+    for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+        if( rk < smilei_rk ) {
+            previous_capabilities += capabilities[rk];
+        }
+        smallest_capability = min( smallest_capability, capabilities[rk] );
+    }
+
     Lp.resize( patch_count[smilei_rk] );
     if( smilei_rk > 0 ) {
         Lp_left.resize( patch_count[smilei_rk-1] );
@@ -520,18 +620,51 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
 
 
 
+    if( params.measured_load_steps > 0 ) {
+        // Load of each patch = average of its measured wall time.
+        // A patch not measured yet (brought by the moving window) has the mean load of the measured patches.
+        double measured_load = 0.;
+        unsigned int nmeasured = 0;
+        for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+            vecpatches( ipatch )->averageLoadTime( params.measured_load_steps );
+            if( vecpatches( ipatch )->measured_load_ >= 0. ) {
+                measured_load += vecpatches( ipatch )->measured_load_;
+                nmeasured++;
+            }
+        }
+        if( nmeasured > 0 ) {
+            measured_load /= nmeasured;
+        }
+        Tload_loc = 0.;
+        for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+            Lp[ipatch] = vecpatches( ipatch )->measured_load_ >= 0. ? vecpatches( ipatch )->measured_load_ : measured_load;
+            Tload_loc += Lp[ipatch];
+        }
+        largest_patch_loc = *max_element( Lp.begin(), Lp.end() );
+        MPI_Scan( &Tload_loc, &Tscan, 1, MPI_DOUBLE, MPI_SUM, world_ );
+        MPI_Allreduce( &Tload_loc, &Tload, 1, MPI_DOUBLE, MPI_SUM, world_ );
+        MPI_Allreduce( &largest_patch_loc, &largest_patch, 1, MPI_DOUBLE, MPI_MAX, world_ );
+        Tload /= Tcapabilities;
+        if( largest_patch >= Tload*smallest_capability ) {
+            WARNING( "Dynamic Load balancing found a patch with a measured load larger than the target load per MPI rank. Try using smaller patches or less MPI ranks." );
+        }
+        Ncur = 0;
+        recompute_tload = false;
+    }
+
     while( recompute_tload ) {
 
         Tload_loc = 0.;
         Ncur = 0; // Variation of the number of patches assigned to current rank r.
         for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
-            Lp[ipatch] =  cells_load ;
+            // Patches without particles only solve the fields
+            Lp[ipatch] = vecpatches( ipatch )->vacuum_ ? ncells_perpatch*params.vacuum_cell_load : cells_load ;
         }
 
         //Compute particle contribution to Local Loads of each Patch (Lp)
         for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
             for( unsigned int ispecies = 0; ispecies < tot_species_number; ispecies++ ) {
-                Lp[ipatch] += vecpatches( ipatch )->vecSpecies[ispecies]->getNbrOfParticles()*( 1+( params.frozen_particle_load-1 )*( time_dual < vecpatches( ipatch )->vecSpecies[ispecies]->time_frozen_ ) ) ;
+                Lp[ipatch] += vecpatches( ipatch )->vecSpecies[ispecies]->getParticleLoad()*( 1+( params.frozen_particle_load-1 )*( time_dual < vecpatches( ipatch )->vecSpecies[ispecies]->time_frozen_ ) ) ;
             }
             Tload_loc += Lp[ipatch];
         }
@@ -539,17 +672,17 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
         largest_patch_loc = *max_element( Lp.begin(), Lp.end() );
 
         //Tscan = total load carried by previous ranks and me
-        MPI_Scan( &Tload_loc, &Tscan, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        MPI_Scan( &Tload_loc, &Tscan, 1, MPI_DOUBLE, MPI_SUM, world_ );
         //Tload = total load carried by all ranks
-        MPI_Allreduce( &Tload_loc, &Tload, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        MPI_Allreduce( &Tload_loc, &Tload, 1, MPI_DOUBLE, MPI_SUM, world_ );
         //Evaluate largest patch of the simulation
-        MPI_Allreduce( &largest_patch_loc, &largest_patch, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+        MPI_Allreduce( &largest_patch_loc, &largest_patch, 1, MPI_DOUBLE, MPI_MAX, world_ );
 
         Tload /= Tcapabilities; //Target load for each mpi process.
 
         //This algorithm does not support single patches having a load larger than the target load per MPI rank.
         //If this happens, the code multiplies the cell load coefficient in order to be able to continue.
-        if( largest_patch >= Tload ) {
+        if( largest_patch >= Tload*smallest_capability ) {
             params.cell_load *= 2.;
             cells_load = ncells_perpatch*params.cell_load ;
             WARNING( "Dynamic Load balancing had to increase cell load coefficient because of an overloaded patch with respect to the target load per MPI rank. Try using smaller patches or less MPI ranks." );
@@ -560,14 +693,14 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
 
     //Communicate the detail of the load of each patch to neighbouring MPI ranks
     if( smilei_rk < smilei_sz-1 ) {
-        MPI_Isend( &( Lp[0] ), patch_count[smilei_rk], MPI_DOUBLE, smilei_rk+1, 0, MPI_COMM_WORLD, &request0 );
+        MPI_Isend( &( Lp[0] ), patch_count[smilei_rk], MPI_DOUBLE, smilei_rk+1, 0, world_, &request0 );
     }
     if( smilei_rk > 0 ) {
-        MPI_Isend( &( Lp[0] ), patch_count[smilei_rk], MPI_DOUBLE, smilei_rk-1, 1, MPI_COMM_WORLD, &request1 );
-        MPI_Recv( &( Lp_left[0] ), patch_count[smilei_rk-1], MPI_DOUBLE, smilei_rk-1, 0, MPI_COMM_WORLD, &status0 );
+        MPI_Isend( &( Lp[0] ), patch_count[smilei_rk], MPI_DOUBLE, smilei_rk-1, 1, world_, &request1 );
+        MPI_Recv( &( Lp_left[0] ), patch_count[smilei_rk-1], MPI_DOUBLE, smilei_rk-1, 0, world_, &status0 );
     }
     if( smilei_rk < smilei_sz-1 ) {
-        MPI_Recv( &( Lp_right[0] ), patch_count[smilei_rk+1], MPI_DOUBLE, smilei_rk+1, 1, MPI_COMM_WORLD, &status1 );
+        MPI_Recv( &( Lp_right[0] ), patch_count[smilei_rk+1], MPI_DOUBLE, smilei_rk+1, 1, world_, &status1 );
     }
 
 
@@ -582,7 +715,7 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
         //Tcur is now initialized as the total load currently carried by previous ranks.
         Tcur = Tscan - Tload_loc;
         //Check if my rank should start with additional patches from left neighbour.
-        target = smilei_rk*Tload; //target here points at the optimal begining for current rank
+        target = previous_capabilities*Tload; //target here points at the optimal begining for current rank
         if( Tcur > target ) {
             j = Lp_left.size()-1;
             while( abs( Tcur-target ) > abs( Tcur-Lp_left[j] - target ) && j>0 ) { //Leave at least 1 patch to my neighbour.
@@ -604,7 +737,7 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
     if( smilei_rk < smilei_sz-1 ) {
         //Tcur is now initialized as the total load carried by previous ranks + my load.
         Tcur = Tscan;
-        target = ( smilei_rk+1 )*Tload;
+        target = ( previous_capabilities+capabilities[smilei_rk] )*Tload;
 
         //Check if my rank should start with additional patches from right neighbour ...
         if( Tcur < target ) {
@@ -631,7 +764,12 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
     Ncur += patch_count[smilei_rk] ;
 
     //Ncur now has to be gathered to all as target_patch_count[smilei_rk]
-    MPI_Allgather( &Ncur, 1, MPI_INT, &patch_count[0], 1, MPI_INT, MPI_COMM_WORLD );
+    std::vector<int> old_patch_count = patch_count;
+    MPI_Allgather( &Ncur, 1, MPI_INT, &patch_count[0], 1, MPI_INT, world_ );
+
+    if( params.memory_cap > 0. ) {
+        capProcessMemory( params, vecpatches, old_patch_count );
+    }
 
     patch_refHindexes[0] = 0;
     for( int rk=1 ; rk<smilei_sz ; rk++ ) {
@@ -650,6 +788,208 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
 } // END recompute_patch_count
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Second constraint of the load balancing: the memory of the patches (particles and fields) of each MPI process
+// below LoadBalancing.memory_cap. The memory of all the patches is gathered, so that all processes correct the
+// distribution of recompute_patch_count the same way: the last (or first) patch of a process above the cap goes to
+// its neighbor with the lowest memory, if the neighbor stays below the cap. As in recompute_patch_count, the
+// boundary between two processes stays in the patches they owned, so that patches only move to a neighbor process.
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::capProcessMemory( Params &params, VectorPatch &vecpatches, std::vector<int> &old_patch_count )
+{
+    std::vector<double> memory_loc( old_patch_count[smilei_rk] );
+    for( unsigned int ipatch=0; ipatch < memory_loc.size(); ipatch++ ) {
+        memory_loc[ipatch] = vecpatches( ipatch )->EMfields->getMemFootPrint();
+        for( unsigned int ispec=0 ; ispec<vecpatches( ipatch )->vecSpecies.size(); ispec++ ) {
+            memory_loc[ipatch] += vecpatches( ipatch )->vecSpecies[ispec]->getMemFootPrint();
+        }
+    }
+    std::vector<int> displ( smilei_sz+1, 0 );
+    for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+        displ[rk+1] = displ[rk] + old_patch_count[rk];
+    }
+    std::vector<double> memory( displ[smilei_sz] );
+    MPI_Allgatherv( &memory_loc[0], memory_loc.size(), MPI_DOUBLE, &memory[0], &old_patch_count[0], &displ[0], MPI_DOUBLE, world_ );
+
+    // Boundaries: the process rk owns the patches [bound[rk], bound[rk+1])
+    std::vector<int> bound( smilei_sz+1, 0 );
+    for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+        bound[rk+1] = bound[rk] + patch_count[rk];
+    }
+    std::vector<double> process_memory( smilei_sz, 0. );
+    for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+        for( int h=bound[rk] ; h<bound[rk+1] ; h++ ) {
+            process_memory[rk] += memory[h];
+        }
+    }
+
+    const double cap = params.memory_cap * 1073741824.;
+    bool moved = true;
+    while( moved ) {
+        moved = false;
+        for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+            if( process_memory[rk] <= cap || bound[rk+1]-bound[rk] < 2 ) {
+                continue;
+            }
+            // Last patch to the next process
+            bool to_right = rk < smilei_sz-1 && bound[rk+1]-1 > displ[rk]
+                            && process_memory[rk+1] + memory[bound[rk+1]-1] <= cap;
+            // First patch to the previous process
+            bool to_left = rk > 0 && bound[rk]+1 < displ[rk+1]
+                           && process_memory[rk-1] + memory[bound[rk]] <= cap;
+            if( to_right && to_left ) {
+                to_left = process_memory[rk-1] < process_memory[rk+1];
+                to_right = !to_left;
+            }
+            if( to_right ) {
+                bound[rk+1]--;
+                process_memory[rk]   -= memory[bound[rk+1]];
+                process_memory[rk+1] += memory[bound[rk+1]];
+                moved = true;
+            } else if( to_left ) {
+                process_memory[rk]   -= memory[bound[rk]];
+                process_memory[rk-1] += memory[bound[rk]];
+                bound[rk]++;
+                moved = true;
+            }
+        }
+    }
+
+    double largest_memory = 0.;
+    for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+        patch_count[rk] = bound[rk+1] - bound[rk];
+        largest_memory = std::max( largest_memory, process_memory[rk] );
+    }
+    if( largest_memory > cap ) {
+        WARNING( "Dynamic Load balancing could not keep the memory of the patches of each MPI process below LoadBalancing.memory_cap ("
+                 << largest_memory / 1073741824. << " GB)" );
+    }
+
+} // END capProcessMemory
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// New numbering of the MPI processes: sorted by node, then by socket, then by rank in world_
+//     - the node (socket) of a process is identified by the lowest rank of the processes it holds,
+//       so that the process 0 keeps its rank
+//     - the contiguous chunks of the Hilbert curve given to consecutive ranks (init_patch_count and
+//       recompute_patch_count) are then grouped node by node
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::placeRanksByTopology()
+{
+    int location[2] = { smilei_rk, smilei_rk };
+#if MPI_VERSION >= 3
+    MPI_Comm node_comm;
+    MPI_Comm_split_type( world_, MPI_COMM_TYPE_SHARED, smilei_rk, MPI_INFO_NULL, &node_comm );
+    MPI_Bcast( &location[0], 1, MPI_INT, 0, node_comm );
+    location[1] = location[0];
+#ifdef OMPI_COMM_TYPE_SOCKET
+    MPI_Comm socket_comm;
+    MPI_Comm_split_type( node_comm, OMPI_COMM_TYPE_SOCKET, smilei_rk, MPI_INFO_NULL, &socket_comm );
+    location[1] = smilei_rk;
+    MPI_Bcast( &location[1], 1, MPI_INT, 0, socket_comm );
+    MPI_Comm_free( &socket_comm );
+#endif
+    MPI_Comm_free( &node_comm );
+#endif
+
+    std::vector<int> locations( 2*smilei_sz );
+    MPI_Allgather( location, 2, MPI_INT, &locations[0], 2, MPI_INT, world_ );
+
+    std::vector<int> order( smilei_sz );
+    for( int rk=0 ; rk<smilei_sz ; rk++ ) {
+        order[rk] = rk;
+    }
+    std::stable_sort( order.begin(), order.end(), [&locations]( int a, int b ) {
+        return locations[2*a] < locations[2*b] || ( locations[2*a] == locations[2*b] && locations[2*a+1] < locations[2*b+1] );
+    } );
+    int new_rk = 0, nmoved = 0, nnodes = 0;
+    for( int i=0 ; i<smilei_sz ; i++ ) {
+        if( order[i] == smilei_rk ) {
+            new_rk = i;
+        }
+        if( order[i] != i ) {
+            nmoved++;
+        }
+        if( locations[2*order[i]] == order[i] ) {
+            nnodes++;
+        }
+    }
+
+    MPI_Comm comm;
+    MPI_Comm_split( world_, 0, new_rk, &comm );
+    world_ = comm;
+    MPI_Comm_rank( world_, &smilei_rk );
+    MPI_Comm_free( &halo_comm_ );
+    MPI_Comm_dup( world_, &halo_comm_ );
+
+    MESSAGE( 1, "Placement of the MPI processes on " << nnodes << " node(s): " << nmoved << " process(es) renumbered" );
+} // END placeRanksByTopology
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Communicators of the halo exchanges, rebuilt after each change of the patch distribution
+// Graph communicator of the neighbor MPI processes:
+//     - the neighbors are the processes owning a patch adjacent (along one direction) to a patch of vecPatches
+//     - this relation is symmetric, the graph has the same sources and destinations, sorted by rank
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::updateHaloComms( VectorPatch &vecPatches )
+{
+    // Rings of the shared memory sized for SharedMemoryHalos::nlists_ lists of fields exchanged between the two
+    // processes, with halos of 2*oversize+2 dual cells (current sums)
+    if( shared_halos_ ) {
+        std::map<int, unsigned long> capacity;
+        for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+            Patch *patch = vecPatches( ipatch );
+            ElectroMagn *EMfields = patch->EMfields;
+            for( unsigned int iDim=0 ; iDim<patch->MPI_neighbor_.size() ; iDim++ ) {
+                unsigned long boundary = 2*EMfields->oversize[iDim]+2;
+                for( unsigned int d=0 ; d<EMfields->dimPrim.size() ; d++ ) {
+                    if( d != iDim ) {
+                        boundary *= EMfields->dimPrim[d]+1;
+                    }
+                }
+                for( int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+                    if( patch->is_a_MPI_neighbor( iDim, iNeighbor )
+                        && shared_halos_->nodeRank( patch->MPI_neighbor_[iDim][iNeighbor] ) != MPI_UNDEFINED ) {
+                        capacity[patch->MPI_neighbor_[iDim][iNeighbor]] += SharedMemoryHalos::nlists_ * boundary;
+                    }
+                }
+            }
+        }
+        shared_halos_->update( capacity );
+    }
+    if( !neighborhood_collectives_ ) {
+        return;
+    }
+
+    std::vector<int> ranks;
+    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+        Patch *patch = vecPatches( ipatch );
+        for( unsigned int iDim=0 ; iDim<patch->MPI_neighbor_.size() ; iDim++ ) {
+            for( int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+                if( patch->is_a_MPI_neighbor( iDim, iNeighbor ) ) {
+                    ranks.push_back( patch->MPI_neighbor_[iDim][iNeighbor] );
+                }
+            }
+        }
+    }
+    std::sort( ranks.begin(), ranks.end() );
+    ranks.erase( std::unique( ranks.begin(), ranks.end() ), ranks.end() );
+
+    if( neighbor_comm_ != MPI_COMM_NULL ) {
+        MPI_Comm_free( &neighbor_comm_ );
+    }
+    neighbor_ranks_ = ranks;
+#if MPI_VERSION >= 3
+    const int n = neighbor_ranks_.size();
+    MPI_Dist_graph_create_adjacent( world_, n, neighbor_ranks_.data(), MPI_UNWEIGHTED,
+                                    n, neighbor_ranks_.data(), MPI_UNWEIGHTED,
+                                    MPI_INFO_NULL, 0, &neighbor_comm_ );
+#endif
+} // END updateHaloComms
+
+
 // ----------------------------------------------------------------------
 // Returns the rank of the MPI process currently owning patch h.
 // ----------------------------------------------------------------------
@@ -759,7 +1099,7 @@ void SmileiMPI::isend_species( Patch *patch, int to, int &irequest, int tag, Par
         for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
             patch->buffer_vecto[ispec] = patch->vecSpecies[ispec]->vectorized_operators;
         }
-        MPI_Isend( &patch->buffer_vecto[0], nspec, MPI_INT, to, tag+irequest, MPI_COMM_WORLD, &patch->requests_[irequest] );
+        MPI_Isend( &patch->buffer_vecto[0], nspec, MPI_INT, to, tag+irequest, world_, &patch->requests_[irequest] );
         irequest ++;
     }
 
@@ -777,7 +1117,7 @@ void SmileiMPI::isend_species( Patch *patch, int to, int &irequest, int tag, Par
 	// 	  << std::endl;
 	
         //isend( &number_of_particles, to, tag+irequest+2*ispec+1, &(patch->requests_[irequest+2*ispec]) );
-        MPI_Isend( &patch->vecSpecies[ispec]->particles->host_nparts_, 1, MPI_INT, to, tag+irequest+2*ispec+1, MPI_COMM_WORLD, &patch->requests_[irequest+2*ispec] );
+        MPI_Isend( &patch->vecSpecies[ispec]->particles->host_nparts_, 1, MPI_INT, to, tag+irequest+2*ispec+1, world_, &patch->requests_[irequest+2*ispec] );
         if( patch->vecSpecies[ispec]->particles->host_nparts_ > 0 ) {
             patch->vecSpecies[ispec]->exchangePatch = createMPIparticles( patch->vecSpecies[ispec]->particles );
             isend( patch->vecSpecies[ispec]->particles, to, tag+irequest+2*ispec, patch->vecSpecies[ispec]->exchangePatch, patch->requests_[irequest+2*ispec+1] );
@@ -800,6 +1140,14 @@ void SmileiMPI::isend_species( Patch *patch, int to, int &irequest, int tag, Par
 #endif
 
     // Send some scalars
+    packSpeciesScalars( patch, params );
+    postIsend( &patch->buffer_scalars_particles[0], patch->buffer_scalars_particles.size(), MPI_DOUBLE, to, tag + irequest, patch->requests_[irequest] );
+    irequest ++;
+}
+
+void SmileiMPI::packSpeciesScalars( Patch *patch, Params &params )
+{
+    unsigned int nspec = patch->vecSpecies.size();
     unsigned int nscalars = 4 + ( params.has_MC_radiation_ || params.has_LL_radiation_ || params.has_Niel_radiation_ );
     patch->buffer_scalars_particles.resize( nscalars*nspec );
     for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
@@ -812,8 +1160,22 @@ void SmileiMPI::isend_species( Patch *patch, int to, int &irequest, int tag, Par
             patch->buffer_scalars_particles[i+4] = patch->vecSpecies[ispec]->nrj_radiated_; // radiated energy
         }
     }
-    MPI_Isend( &patch->buffer_scalars_particles[0], patch->buffer_scalars_particles.size(), MPI_DOUBLE, to, tag + irequest, world_, &patch->requests_[irequest] );
-    irequest ++;
+}
+
+void SmileiMPI::unpackSpeciesScalars( Patch *patch, Params &params )
+{
+    unsigned int nspec = patch->vecSpecies.size();
+    unsigned int nscalars = 4 + ( params.has_MC_radiation_ || params.has_LL_radiation_ || params.has_Niel_radiation_ );
+    for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
+        unsigned int i = ispec*nscalars;
+        patch->vecSpecies[ispec]->nrj_bc_lost   = patch->buffer_scalars_particles[i+0];
+        patch->vecSpecies[ispec]->nrj_new_part_ = patch->buffer_scalars_particles[i+1];
+        patch->vecSpecies[ispec]->nrj_mw_out    = patch->buffer_scalars_particles[i+2];
+        patch->vecSpecies[ispec]->nrj_mw_inj    = patch->buffer_scalars_particles[i+3];
+        if( params.has_MC_radiation_ || params.has_LL_radiation_ || params.has_Niel_radiation_ ) {
+            patch->vecSpecies[ispec]->nrj_radiated_ = patch->buffer_scalars_particles[i+4];
+        }
+    }
 }
 
 void SmileiMPI::isend_fields( Patch *patch, int to, int &irequest, int tag, Params &params, bool send_xmax_bc )
@@ -826,7 +1188,14 @@ void SmileiMPI::isend_fields( Patch *patch, int to, int &irequest, int tag, Para
     }
 
     // Send some scalars
-    unsigned int nscalars = 2 + 2*params.nDim_field;
+    packFieldsScalars( patch, params );
+    postIsend( &patch->buffer_scalars_fields[0], patch->buffer_scalars_fields.size(), MPI_DOUBLE, to, tag + irequest, patch->requests_[irequest] );
+    irequest ++;
+} // END isend( Patch )
+
+void SmileiMPI::packFieldsScalars( Patch *patch, Params &params )
+{
+    unsigned int nscalars = 3 + 2*params.nDim_field;
     patch->buffer_scalars_fields.resize( nscalars );
     patch->buffer_scalars_fields[0] = patch->EMfields->nrj_mw_out; // lost by moving window
     patch->buffer_scalars_fields[1] = patch->EMfields->nrj_mw_inj; // lost by moving window
@@ -835,9 +1204,20 @@ void SmileiMPI::isend_fields( Patch *patch, int to, int &irequest, int tag, Para
             patch->buffer_scalars_fields[2+i*2+jp] = patch->EMfields->poynting[jp][i];
         }
     }
-    MPI_Isend( &patch->buffer_scalars_fields[0], patch->buffer_scalars_fields.size(), MPI_DOUBLE, to, tag + irequest, world_, &patch->requests_[irequest] );
-    irequest ++;
-} // END isend( Patch )
+    patch->buffer_scalars_fields[nscalars-1] = patch->measured_load_; // measured load
+}
+
+void SmileiMPI::unpackFieldsScalars( Patch *patch, Params &params )
+{
+    patch->EMfields->nrj_mw_out =  patch->buffer_scalars_fields[0] ;
+    patch->EMfields->nrj_mw_inj =  patch->buffer_scalars_fields[1] ;
+    for( unsigned int jp=0; jp<2; jp++ ) { //directions (xmin/xmax, ymin/ymax, zmin/zmax)
+        for( unsigned int i=0 ; i<params.nDim_field ; i++ ) { //axis 0=x, 1=y, 2=z
+            patch->EMfields->poynting[jp][i] = patch->buffer_scalars_fields[2+i*2+jp];
+        }
+    }
+    patch->measured_load_ = patch->buffer_scalars_fields[2+2*params.nDim_field];
+}
 
 
 void SmileiMPI::waitall( Patch *patch )
@@ -893,7 +1273,7 @@ void SmileiMPI::recv_species( Patch *patch, int from, int &tag, Params &params )
         // Parameter vectorized_operators
         MPI_Status status;
         patch->buffer_vecto.resize( nspec );
-        MPI_Recv( &patch->buffer_vecto[0], nspec, MPI_INT, from, tag, MPI_COMM_WORLD, &status );
+        MPI_Recv( &patch->buffer_vecto[0], nspec, MPI_INT, from, tag, world_, &status );
         tag ++;
         for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
             patch->vecSpecies[ispec]->vectorized_operators = patch->buffer_vecto[ispec];
@@ -913,7 +1293,7 @@ void SmileiMPI::recv_species( Patch *patch, int from, int &tag, Params &params )
         //Receive last_index
 
         MPI_Status status;
-        MPI_Recv( &number_of_received_particles, 1, MPI_INT, from, tag+2*ispec+1, MPI_COMM_WORLD, &status );
+        MPI_Recv( &number_of_received_particles, 1, MPI_INT, from, tag+2*ispec+1, world_, &status );
 
 	// for some reasons the use of this method that should be the same as the code above trigger a deadlock
         //recv( &number_of_received_particles, from, tag+2*ispec+1 );
@@ -964,16 +1344,7 @@ void SmileiMPI::recv_species( Patch *patch, int from, int &tag, Params &params )
     MPI_Status status;
     MPI_Recv( &patch->buffer_scalars_particles[0], patch->buffer_scalars_particles.size(), MPI_DOUBLE, from, tag, world_, &status );
     tag++;
-    for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
-        unsigned int i = ispec*nscalars;
-        patch->vecSpecies[ispec]->nrj_bc_lost   = patch->buffer_scalars_particles[i+0];
-        patch->vecSpecies[ispec]->nrj_new_part_ = patch->buffer_scalars_particles[i+1];
-        patch->vecSpecies[ispec]->nrj_mw_out    = patch->buffer_scalars_particles[i+2];
-        patch->vecSpecies[ispec]->nrj_mw_inj    = patch->buffer_scalars_particles[i+3];
-        if( params.has_MC_radiation_ || params.has_LL_radiation_ || params.has_Niel_radiation_ ) {
-            patch->vecSpecies[ispec]->nrj_radiated_ = patch->buffer_scalars_particles[i+4];
-        }
-    }
+    unpackSpeciesScalars( patch, params );
 }
 
 void SmileiMPI::recv_fields( Patch *patch, int from, int &tag, Params &params, bool recv_xmin_bc )
@@ -987,32 +1358,197 @@ void SmileiMPI::recv_fields( Patch *patch, int from, int &tag, Params &params, b
     }
 
     // Receive some scalars
-    unsigned int nscalars = 2 + 2*params.nDim_field;
+    unsigned int nscalars = 3 + 2*params.nDim_field;
     patch->buffer_scalars_fields.resize( nscalars );
     MPI_Status status;
     MPI_Recv( &patch->buffer_scalars_fields[0], patch->buffer_scalars_fields.size(), MPI_DOUBLE, from, tag, world_, &status );
     tag++;
-    patch->EMfields->nrj_mw_out =  patch->buffer_scalars_fields[0] ;
-    patch->EMfields->nrj_mw_inj =  patch->buffer_scalars_fields[1] ;
-    for( unsigned int jp=0; jp<2; jp++ ) { //directions (xmin/xmax, ymin/ymax, zmin/zmax)
-        for( unsigned int i=0 ; i<params.nDim_field ; i++ ) { //axis 0=x, 1=y, 2=z
-            patch->EMfields->poynting[jp][i] = patch->buffer_scalars_fields[2+i*2+jp];
+    unpackFieldsScalars( patch, params );
+} // END recv ( Patch )
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Exchange of the patches of the load balancing in 3 rounds, each with one message per neighbor MPI process
+// (LoadBalancing.batched_exchange): the operators of the species (adaptive mixed sort), the bins of the particles
+// (which give their number), then the particles, fields and scalars. The messages are the same segments as isend( Patch )
+// and recv( Patch ), recorded by the primitives and gathered in one MPI datatype per MPI process.
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::exchangePatchesBatched( std::vector<Patch *> &send_patches, std::vector<int> &send_ranks,
+                                        std::vector<Patch *> &recv_patches, std::vector<int> &recv_ranks, Params &params )
+{
+    MPI_Request request;
+
+    if( params.vectorization_mode == "adaptive_mixed_sort" ) {
+        batching_ = true;
+        for( unsigned int i=0 ; i<send_patches.size() ; i++ ) {
+            Patch *patch = send_patches[i];
+            unsigned int nspec = patch->vecSpecies.size();
+            patch->buffer_vecto.resize( nspec );
+            for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
+                patch->buffer_vecto[ispec] = patch->vecSpecies[ispec]->vectorized_operators;
+            }
+            postIsend( &patch->buffer_vecto[0], nspec, MPI_INT, send_ranks[i], 0, request );
+        }
+        for( unsigned int i=0 ; i<recv_patches.size() ; i++ ) {
+            Patch *patch = recv_patches[i];
+            patch->buffer_vecto.resize( patch->vecSpecies.size() );
+            postRecv( &patch->buffer_vecto[0], patch->vecSpecies.size(), MPI_INT, recv_ranks[i], 0 );
+        }
+        flushBatches();
+        for( unsigned int i=0 ; i<recv_patches.size() ; i++ ) {
+            Patch *patch = recv_patches[i];
+            for( unsigned int ispec=0; ispec<patch->vecSpecies.size(); ispec++ ) {
+                patch->vecSpecies[ispec]->vectorized_operators = patch->buffer_vecto[ispec];
+                if( ! patch->buffer_vecto[ispec] ) {
+                    patch->vecSpecies[ispec]->particles->last_index.resize( 1 );
+                    patch->vecSpecies[ispec]->particles->first_index.resize( 1 );
+                }
+            }
         }
     }
-} // END recv ( Patch )
+
+    // Bins of the particles
+    batching_ = true;
+    for( unsigned int i=0 ; i<send_patches.size() ; i++ ) {
+        for( unsigned int ispec=0; ispec<send_patches[i]->vecSpecies.size(); ispec++ ) {
+            isend( &( send_patches[i]->vecSpecies[ispec]->particles->last_index ), send_ranks[i], 0, request );
+        }
+    }
+    for( unsigned int i=0 ; i<recv_patches.size() ; i++ ) {
+        for( unsigned int ispec=0; ispec<recv_patches[i]->vecSpecies.size(); ispec++ ) {
+            recv( &( recv_patches[i]->vecSpecies[ispec]->particles->last_index ), recv_ranks[i], 0 );
+        }
+    }
+    flushBatches();
+
+    // Particles, fields and scalars
+    batching_ = true;
+    for( unsigned int i=0 ; i<send_patches.size() ; i++ ) {
+        Patch *patch = send_patches[i];
+        for( unsigned int ispec=0; ispec<patch->vecSpecies.size(); ispec++ ) {
+            if( patch->vecSpecies[ispec]->getNbrOfParticles() > 0 ) {
+                patch->vecSpecies[ispec]->exchangePatch = createMPIparticles( patch->vecSpecies[ispec]->particles );
+                isend( patch->vecSpecies[ispec]->particles, send_ranks[i], 0, patch->vecSpecies[ispec]->exchangePatch, request );
+            }
+        }
+        packSpeciesScalars( patch, params );
+        postIsend( &patch->buffer_scalars_particles[0], patch->buffer_scalars_particles.size(), MPI_DOUBLE, send_ranks[i], 0, request );
+        int irequest = 0;
+        isend_fields( patch, send_ranks[i], irequest, 0, params );
+    }
+    for( unsigned int i=0 ; i<recv_patches.size() ; i++ ) {
+        Patch *patch = recv_patches[i];
+        for( unsigned int ispec=0; ispec<patch->vecSpecies.size(); ispec++ ) {
+            Particles *particles = patch->vecSpecies[ispec]->particles;
+            //Reconstruct first_index from last_index
+            memcpy( &( particles->first_index[1] ), &( particles->last_index[0] ), ( particles->last_index.size()-1 )*sizeof( int ) );
+            particles->first_index[0]=0;
+            //Prepare patch for receiving particles
+            int nbrOfPartsRecv = particles->numberOfParticles();
+            particles->initialize( nbrOfPartsRecv, params.nDim_particle, params.keep_position_old );
+            if( nbrOfPartsRecv > 0 ) {
+                batch_datatypes_.push_back( createMPIparticles( particles ) );
+                recv( particles, recv_ranks[i], 0, batch_datatypes_.back() );
+            }
+        }
+        patch->buffer_scalars_particles.resize( ( 4 + ( params.has_MC_radiation_ || params.has_LL_radiation_ || params.has_Niel_radiation_ ) ) * patch->vecSpecies.size() );
+        postRecv( &patch->buffer_scalars_particles[0], patch->buffer_scalars_particles.size(), MPI_DOUBLE, recv_ranks[i], 0 );
+        patch->EMfields->initAntennas( patch, params );
+        int tag = 0;
+        if( params.geometry != "AMcylindrical" ) {
+            recv( patch->EMfields, recv_ranks[i], tag, true );
+        } else {
+            recv( patch->EMfields, recv_ranks[i], tag, static_cast<ElectroMagnAM *>( patch->EMfields )->El_.size(), true );
+        }
+        patch->buffer_scalars_fields.resize( 3 + 2*params.nDim_field );
+        postRecv( &patch->buffer_scalars_fields[0], patch->buffer_scalars_fields.size(), MPI_DOUBLE, recv_ranks[i], 0 );
+    }
+    flushBatches();
+
+    for( unsigned int i=0 ; i<recv_patches.size() ; i++ ) {
+        unpackSpeciesScalars( recv_patches[i], params );
+        unpackFieldsScalars( recv_patches[i], params );
+    }
+    for( unsigned int i=0 ; i<send_patches.size() ; i++ ) {
+        waitall( send_patches[i] );
+    }
+}
+
+void SmileiMPI::postIsend( void *buffer, int count, MPI_Datatype type, int to, int tag, MPI_Request &request )
+{
+    if( batching_ ) {
+        recordSegment( send_batches_[to], buffer, count, type );
+        request = MPI_REQUEST_NULL;
+    } else {
+        MPI_Isend( buffer, count, type, to, tag, world_, &request );
+    }
+}
+
+void SmileiMPI::postRecv( void *buffer, int count, MPI_Datatype type, int from, int tag )
+{
+    if( batching_ ) {
+        recordSegment( recv_batches_[from], buffer, count, type );
+    } else {
+        MPI_Status status;
+        MPI_Recv( buffer, count, type, from, tag, world_, &status );
+    }
+}
+
+void SmileiMPI::recordSegment( PatchBatch &batch, void *buffer, int count, MPI_Datatype type )
+{
+    MPI_Aint address;
+    MPI_Get_address( buffer, &address );
+    batch.displacements.push_back( address );
+    batch.lengths.push_back( count );
+    batch.types.push_back( type );
+}
+
+void SmileiMPI::flushBatches()
+{
+    std::vector<MPI_Request> requests;
+    std::vector<MPI_Datatype> types;
+    for( int send_recv=0 ; send_recv<2 ; send_recv++ ) {
+        std::map<int, PatchBatch> &batches = send_recv ? send_batches_ : recv_batches_;
+        for( std::map<int, PatchBatch>::iterator it = batches.begin() ; it != batches.end() ; it++ ) {
+            PatchBatch &batch = it->second;
+            MPI_Datatype type;
+            MPI_Type_create_struct( batch.lengths.size(), &batch.lengths[0], &batch.displacements[0], &batch.types[0], &type );
+            MPI_Type_commit( &type );
+            types.push_back( type );
+            requests.push_back( MPI_REQUEST_NULL );
+            if( send_recv ) {
+                MPI_Isend( MPI_BOTTOM, 1, type, it->first, 0, world_, &requests.back() );
+            } else {
+                MPI_Irecv( MPI_BOTTOM, 1, type, it->first, 0, world_, &requests.back() );
+            }
+        }
+        batches.clear();
+    }
+    for( unsigned int i=0 ; i<batch_datatypes_.size() ; i++ ) {
+        MPI_Type_free( &batch_datatypes_[i] );
+    }
+    batch_datatypes_.clear();
+    batching_ = false;
+
+    if( ! requests.empty() ) {
+        MPI_Waitall( requests.size(), &requests[0], MPI_STATUSES_IGNORE );
+    }
+    for( unsigned int i=0 ; i<types.size() ; i++ ) {
+        MPI_Type_free( &types[i] );
+    }
+}
 
 
 void SmileiMPI::isend( Particles *particles, int to, int tag, MPI_Datatype typePartSend, MPI_Request &request )
 {
-    MPI_Isend( &( particles->position( 0, 0 ) ), 1, typePartSend, to, tag, MPI_COMM_WORLD, &request );
+    postIsend( &( particles->position( 0, 0 ) ), 1, typePartSend, to, tag, request );
 
 } // END isend( Particles )
 
 
 void SmileiMPI::recv( Particles *particles, int to, int tag, MPI_Datatype typePartRecv )
 {
-    MPI_Status status;
-    MPI_Recv( &( particles->position( 0, 0 ) ), 1, typePartRecv, to, tag, MPI_COMM_WORLD, &status );
+    postRecv( &( particles->position( 0, 0 ) ), 1, typePartRecv, to, tag );
 
 } // END recv( Particles )
 
@@ -1020,28 +1556,26 @@ void SmileiMPI::recv( Particles *particles, int to, int tag, MPI_Datatype typePa
 // Assuming vec.size() is known (number of species). Asynchronous.
 void SmileiMPI::isend( std::vector<int> *vec, int to, int tag, MPI_Request &request )
 {
-    MPI_Isend( &( ( *vec )[0] ), vec->size(), MPI_INT, to, tag, MPI_COMM_WORLD, &request );
+    postIsend( &( ( *vec )[0] ), vec->size(), MPI_INT, to, tag, request );
 
 } // End isend
 
 void SmileiMPI::recv( std::vector<int> *vec, int from, int tag )
 {
-    MPI_Status status;
-    MPI_Recv( &( ( *vec )[0] ), vec->size(), MPI_INT, from, tag, MPI_COMM_WORLD, &status );
+    postRecv( &( ( *vec )[0] ), vec->size(), MPI_INT, from, tag );
 
 } // End recv
 
 // Assuming vec.size() is known (number of species). Asynchronous.
 void SmileiMPI::isend( std::vector<double> *vec, int to, int tag, MPI_Request &request )
 {
-    MPI_Isend( &( ( *vec )[0] ), vec->size(), MPI_DOUBLE, to, tag, MPI_COMM_WORLD, &request );
+    postIsend( &( ( *vec )[0] ), vec->size(), MPI_DOUBLE, to, tag, request );
 
 } // End isend
 
 void SmileiMPI::recv( std::vector<double> *vec, int from, int tag )
 {
-    MPI_Status status;
-    MPI_Recv( &( ( *vec )[0] ), vec->size(), MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+    postRecv( &( ( *vec )[0] ), vec->size(), MPI_DOUBLE, from, tag );
 
 } // End recv
 
@@ -1283,6 +1817,15 @@ void SmileiMPI::isend( ElectroMagn *EM, int to, int &irequest, vector<MPI_Reques
         }
     }
 
+    for( Field *field: EM->averaged_fields_ ) {
+        isend( field, to, tag+irequest, requests[irequest] );
+        irequest++;
+    }
+    for( Field *field: EM->subcycled_currents_ ) {
+        isend( field, to, tag+irequest, requests[irequest] );
+        irequest++;
+    }
+
     for( unsigned int antennaId=0 ; antennaId<EM->antennas.size() ; antennaId++ ) {
         isend( EM->antennas[antennaId].field, to, tag+irequest, requests[irequest] );
         irequest++;
@@ -1318,9 +1861,9 @@ void SmileiMPI::isend( ElectroMagn *EM, int to, int &irequest, vector<MPI_Reques
 
             if( dynamic_cast<ElectroMagnBC1D_SM *>( EM->emBoundCond[bcId] ) ) {
                 ElectroMagnBC1D_SM *embc = static_cast<ElectroMagnBC1D_SM *>( EM->emBoundCond[bcId] );
-                MPI_Isend( &( embc->By_val_ ), 1, MPI_DOUBLE, to, tag+irequest, MPI_COMM_WORLD, &requests[irequest] );
+                postIsend( &( embc->By_val_ ), 1, MPI_DOUBLE, to, tag+irequest, requests[irequest] );
                 irequest++;
-                MPI_Isend( &( embc->Bz_val_ ), 1, MPI_DOUBLE, to, tag+irequest, MPI_COMM_WORLD, &requests[irequest] );
+                postIsend( &( embc->Bz_val_ ), 1, MPI_DOUBLE, to, tag+irequest, requests[irequest] );
                 irequest++;
             } else if( dynamic_cast<ElectroMagnBC2D_SM *>( EM->emBoundCond[bcId] ) ) {
                 // BCs at the x-border
@@ -1431,6 +1974,15 @@ void SmileiMPI::isend( ElectroMagn *EM, int to, int &irequest, vector<MPI_Reques
         }
     }
 
+    for( Field *field: EM->averaged_fields_ ) {
+        isend( field, to, tag+irequest, requests[irequest] );
+        irequest++;
+    }
+    for( Field *field: EM->subcycled_currents_ ) {
+        isend( field, to, tag+irequest, requests[irequest] );
+        irequest++;
+    }
+
     for( unsigned int antennaId=0 ; antennaId<EM->antennas.size() ; antennaId++ ) {
         isend( EM->antennas[antennaId].field, to, tag+irequest, requests[irequest] );
         irequest++;
@@ -1819,6 +2371,15 @@ void SmileiMPI::recv( ElectroMagn *EM, int from, int &tag, bool recv_xmin_bc )
         }
     }
 
+    for( Field *field: EM->averaged_fields_ ) {
+        recv( field, from, tag );
+        tag++;
+    }
+    for( Field *field: EM->subcycled_currents_ ) {
+        recv( field, from, tag );
+        tag++;
+    }
+
     for( int antennaId=0 ; antennaId<( int )EM->antennas.size() ; antennaId++ ) {
         recv( EM->antennas[antennaId].field, from, tag );
         tag++;
@@ -1853,10 +2414,9 @@ void SmileiMPI::recv( ElectroMagn *EM, int from, int &tag, bool recv_xmin_bc )
 
             if( dynamic_cast<ElectroMagnBC1D_SM *>( EM->emBoundCond[bcId] ) ) {
                 ElectroMagnBC1D_SM *embc = static_cast<ElectroMagnBC1D_SM *>( EM->emBoundCond[bcId] );
-                MPI_Status status;
-                MPI_Recv( &( embc->By_val_ ), 1, MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+                postRecv( &( embc->By_val_ ), 1, MPI_DOUBLE, from, tag );
                 tag++;
-                MPI_Recv( &( embc->Bz_val_ ), 1, MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+                postRecv( &( embc->Bz_val_ ), 1, MPI_DOUBLE, from, tag );
                 tag++;
             } else if( dynamic_cast<ElectroMagnBC2D_SM *>( EM->emBoundCond[bcId] ) ) {
                 // BCs at the x-border
@@ -1965,6 +2525,15 @@ void SmileiMPI::recv( ElectroMagn *EM, int from, int &tag, unsigned int nmodes,
         }
     }
 
+    for( Field *field: EM->averaged_fields_ ) {
+        recv( field, from, tag );
+        tag++;
+    }
+    for( Field *field: EM->subcycled_currents_ ) {
+        recv( field, from, tag );
+        tag++;
+    }
+
     for( int antennaId=0 ; antennaId<( int )EM->antennas.size() ; antennaId++ ) {
         recv( EM->antennas[antennaId].field, from, tag );
         tag++;
@@ -2116,7 +2685,7 @@ void SmileiMPI::recv( ElectroMagn *EM, int from, int &tag, unsigned int nmodes,
 void SmileiMPI::isend( Field *field, int to, int tag, MPI_Request &request )
 {
 
-    MPI_Isend( &( ( *field )( 0 ) ), field->size(), MPI_DOUBLE, to, tag, MPI_COMM_WORLD, &request );
+    postIsend( &( ( *field )( 0 ) ), field->size(), MPI_DOUBLE, to, tag, request );
 
 } // End isend ( Field )
 
@@ -2134,7 +2703,7 @@ void SmileiMPI::isendOnDevice( Field *field, int to, int tag, MPI_Request &reque
     //     ERROR("Field " << field->name << " not allocated on Device")
     // }
 
-    MPI_Isend( field_ptr, field->size(), MPI_DOUBLE, to, tag, MPI_COMM_WORLD, &request );
+    MPI_Isend( field_ptr, field->size(), MPI_DOUBLE, to, tag, world_, &request );
 
 } // End isend ( Field )
 #endif
@@ -2146,7 +2715,7 @@ void SmileiMPI::isend( Field *field, int to, int tag, MPI_Request &request, int
     for (unsigned int idim=1; idim < field->dims_.size(); idim++){
         data_size *= field->dims_[idim];
     }
-    MPI_Isend( &( ( *field )( 0 ) ), data_size, MPI_DOUBLE, to, tag, MPI_COMM_WORLD, &request );
+    postIsend( &( ( *field )( 0 ) ), data_size, MPI_DOUBLE, to, tag, request );
 
 } // End isend ( Field )
 
@@ -2154,7 +2723,7 @@ void SmileiMPI::isendComplex( Field *field, int to, int tag, MPI_Request &reques
 {
     cField *cf = static_cast<cField *>( field );
     //This version of isendComplex(Field) sends the whole array
-    MPI_Isend( &( ( *cf )( 0 ) ), 2*field->number_of_points_, MPI_DOUBLE, to, tag, MPI_COMM_WORLD, &request );
+    postIsend( &( ( *cf )( 0 ) ), 2*field->number_of_points_, MPI_DOUBLE, to, tag, request );
 
 }
 void SmileiMPI::isendComplex( Field *field, int to, int tag, MPI_Request &request, int x_first )
@@ -2165,21 +2734,21 @@ void SmileiMPI::isendComplex( Field *field, int to, int tag, MPI_Request &reques
         data_size *= field->dims_[idim];
     }
     //This version of isendComplex(Field) sends only the first "x_first" columns of the array
-    MPI_Isend( &( ( *cf )( 0 ) ), 2*data_size, MPI_DOUBLE, to, tag, MPI_COMM_WORLD, &request );
+    postIsend( &( ( *cf )( 0 ) ), 2*data_size, MPI_DOUBLE, to, tag, request );
 
 } // End isendComplex ( Field )
 
 void SmileiMPI::sendComplex( Field *field, int to, int tag )
 {
     cField *cf = static_cast<cField *>( field );
-    MPI_Send( &( ( *cf )( 0 ) ), 2*field->number_of_points_, MPI_DOUBLE, to, tag, MPI_COMM_WORLD );
+    MPI_Send( &( ( *cf )( 0 ) ), 2*field->number_of_points_, MPI_DOUBLE, to, tag, world_ );
 
 } // End isendComplex ( Field )
 
 
 void SmileiMPI::send(Field* field, int to, int tag)
 {
-    MPI_Send( &((*field)(0)),field->number_of_points_, MPI_DOUBLE, to, tag, MPI_COMM_WORLD );
+    MPI_Send( &((*field)(0)),field->number_of_points_, MPI_DOUBLE, to, tag, world_ );
 
 } // End isend ( Field )
 
@@ -2187,10 +2756,8 @@ void SmileiMPI::send(Field* field, int to, int tag)
 void SmileiMPI::recv( Field *field, int from, int tag )
 {
 
-    MPI_Status status;
-
     //origin shifts the reception position in the array and reduces the received buffer size.
-    MPI_Recv( &( ( *field )( 0 ) ), field->number_of_points_, MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+    postRecv( &( ( *field )( 0 ) ), field->number_of_points_, MPI_DOUBLE, from, tag );
 
 } // End recv ( Field )
 
@@ -2208,53 +2775,50 @@ void SmileiMPI::recvOnDevice( Field *field, int from, int tag )
     //     ERROR("Field " << field->name << " not allocated on Device")
     // }
 
-    MPI_Recv( field_ptr, field->size(), MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+    MPI_Recv( field_ptr, field->size(), MPI_DOUBLE, from, tag, world_, &status );
 
 } // End recv ( Field )
 #endif
 
 void SmileiMPI::recvShifted( Field *field, int from, int tag, int xshift )
 {
-    MPI_Status status;
     int data_shift = xshift;
     for (unsigned int idim=1; idim < field->dims_.size(); idim++){
         data_shift *= field->dims_[idim];
     }
     //Shifts the reception position in the array along the x dimension and reduces the received buffer size.
-    MPI_Recv( &( ( *field )( data_shift ) ), field->number_of_points_ - data_shift, MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+    postRecv( &( ( *field )( data_shift ) ), field->number_of_points_ - data_shift, MPI_DOUBLE, from, tag );
 
 } // End recv ( Field )
 
 void SmileiMPI::recvComplex( Field *field, int from, int tag )
 {
-    MPI_Status status;
     cField *cf = static_cast<cField *>( field );
-    MPI_Recv( &( ( *cf )( 0 ) ), 2*(field->number_of_points_ ), MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+    postRecv( &( ( *cf )( 0 ) ), 2*(field->number_of_points_ ), MPI_DOUBLE, from, tag );
 
 } // End recv ( Field )
 
 void SmileiMPI::recvComplexShifted( Field *field, int from, int tag, int xshift )
 {
-    MPI_Status status;
     cField *cf = static_cast<cField *>( field );
     int data_shift = xshift;
     for (unsigned int idim=1; idim < field->dims_.size(); idim++){
         data_shift *= field->dims_[idim];
     }
     //Shifts the reception position in the array along the x dimension and reduces the received buffer size.
-    MPI_Recv( &( ( *cf )( data_shift ) ), 2*(field->number_of_points_ - data_shift), MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &status );
+    postRecv( &( ( *cf )( data_shift ) ), 2*(field->number_of_points_ - data_shift), MPI_DOUBLE, from, tag );
 
 } // End recv ( Field )
 void SmileiMPI::irecvComplex( Field *field, int from, int tag, MPI_Request &request )
 {
     cField *cf = static_cast<cField *>( field );
-    MPI_Irecv( &( ( *cf )( 0 ) ), 2*field->number_of_points_, MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &request );
+    MPI_Irecv( &( ( *cf )( 0 ) ), 2*field->number_of_points_, MPI_DOUBLE, from, tag, world_, &request );
 
 } // End recv ( Field )
 
 void SmileiMPI::irecv(Field* field, int from, int tag, MPI_Request& request)
 {
-    MPI_Irecv( &((*field)(0)),2*field->number_of_points_, MPI_DOUBLE, from, tag, MPI_COMM_WORLD, &request );
+    MPI_Irecv( &((*field)(0)),2*field->number_of_points_, MPI_DOUBLE, from, tag, world_, &request );
 
 } // End recv ( Field )
 
@@ -2263,14 +2827,14 @@ void SmileiMPI::isend( ProbeParticles *probe, int to, int tag, unsigned int nDim
 {
     MPI_Request request;
     // send offset
-    MPI_Isend( &( probe->offset_in_file ), 1, MPI_INT, to, tag, MPI_COMM_WORLD, &request );
+    MPI_Isend( &( probe->offset_in_file ), 1, MPI_INT, to, tag, world_, &request );
     // send number of particles
     int nPart = probe->particles.size();
-    MPI_Isend( &nPart, 1, MPI_INT, to, tag+1, MPI_COMM_WORLD, &request );
+    MPI_Isend( &nPart, 1, MPI_INT, to, tag+1, world_, &request );
     // send particles
     if( nPart>0 )
         for( unsigned int i=0; i<nDim_particles; i++ ) {
-            MPI_Isend( &( probe->particles.Position[i][0] ), nPart, MPI_DOUBLE, to, tag+1+i, MPI_COMM_WORLD, &request );
+            MPI_Isend( &( probe->particles.Position[i][0] ), nPart, MPI_DOUBLE, to, tag+1+i, world_, &request );
         }
 
 } // End isend ( probes )
@@ -2280,16 +2844,16 @@ void SmileiMPI::recv( ProbeParticles *probe, int from, int tag, unsigned int nDi
 {
     MPI_Status status;
     // receive offset
-    MPI_Recv( &( probe->offset_in_file ), 1, MPI_INT, from, tag, MPI_COMM_WORLD, &status );
+    MPI_Recv( &( probe->offset_in_file ), 1, MPI_INT, from, tag, world_, &status );
     // receive number of particles
     int nPart;
-    MPI_Recv( &nPart, 1, MPI_INT, from, tag+1, MPI_COMM_WORLD, &status );
+    MPI_Recv( &nPart, 1, MPI_INT, from, tag+1, world_, &status );
     // Resize particles
     probe->particles.initialize( nPart, nDim_particles, false );
     // receive particles
     if( nPart>0 )
         for( unsigned int i=0; i<nDim_particles; i++ ) {
-            MPI_Recv( &( probe->particles.Position[i][0] ), nPart, MPI_DOUBLE, from, tag+1+i, MPI_COMM_WORLD, &status );
+            MPI_Recv( &( probe->particles.Position[i][0] ), nPart, MPI_DOUBLE, from, tag+1+i, world_, &status );
         }
 
 } // End recv ( probes )
@@ -2297,14 +2861,14 @@ void SmileiMPI::recv( ProbeParticles *probe, int from, int tag, unsigned int nDi
 //! Wrapper for integer MPI communication
 void SmileiMPI::isend( int *integer, int to, int tag, MPI_Request &request )
 {
-    MPI_Isend( &integer, 1, MPI_INT, to, tag, MPI_COMM_WORLD, &request );
+    MPI_Isend( &integer, 1, MPI_INT, to, tag, world_, &request );
 } // End isend ( integer )
 
 //! Wrapper for integer MPI communication
 void SmileiMPI::recv( int *integer, int from, int tag )
 {
     MPI_Status status;
-    MPI_Recv( &integer, 1, MPI_INT, from, tag, MPI_COMM_WORLD, &status );
+    MPI_Recv( &integer, 1, MPI_INT, from, tag, world_, &status );
 } // End recv ( integer )
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -2344,24 +2908,99 @@ void SmileiMPI::computeGlobalDiags( DiagnosticScalar *scalars, int itime )
         return;
     }
 
+    // Non-blocking reductions of copies of the scalars, completed by finalizeGlobalDiags
+    if( scalars->asynchronous_ ) {
+#if MPI_VERSION >= 3
+        if( scalars->exact_reduction_ ) {
+            scalars->pending_exact_SUM_ = scalars->exact_SUM_;
+            reduceExactSums( scalars->pending_exact_SUM_, &scalars->pending_requests_[0] );
+        } else {
+            scalars->pending_SUM_ = scalars->values_SUM;
+            double *d_sum = &scalars->pending_SUM_[0];
+            MPI_Ireduce( isMaster()?MPI_IN_PLACE:d_sum, d_sum, scalars->pending_SUM_.size(), MPI_DOUBLE, MPI_SUM, 0, world_, &scalars->pending_requests_[0] );
+        }
+        scalars->pending_requests_[1] = MPI_REQUEST_NULL;
+        scalars->pending_requests_[2] = MPI_REQUEST_NULL;
+        if( scalars->necessary_fieldMinMax_any ) {
+            scalars->pending_MINLOC_ = scalars->values_MINLOC;
+            val_index *d_min = &scalars->pending_MINLOC_[0];
+            MPI_Ireduce( isMaster()?MPI_IN_PLACE:d_min, d_min, scalars->pending_MINLOC_.size(), MPI_DOUBLE_INT, MPI_MINLOC, 0, world_, &scalars->pending_requests_[1] );
+            scalars->pending_MAXLOC_ = scalars->values_MAXLOC;
+            val_index *d_max = &scalars->pending_MAXLOC_[0];
+            MPI_Ireduce( isMaster()?MPI_IN_PLACE:d_max, d_max, scalars->pending_MAXLOC_.size(), MPI_DOUBLE_INT, MPI_MAXLOC, 0, world_, &scalars->pending_requests_[2] );
+        }
+        scalars->pending_timestep_ = itime;
+#endif
+        return;
+    }
+
     // Reduce all scalars that should be summed
-    int n_sum = scalars->values_SUM.size();
-    double *d_sum = &scalars->values_SUM[0];
-    MPI_Reduce( isMaster()?MPI_IN_PLACE:d_sum, d_sum, n_sum, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+    if( scalars->exact_reduction_ ) {
+        reduceExactSums( scalars->exact_SUM_ );
+        if( isMaster() ) {
+            for( unsigned int i=0; i<scalars->exact_SUM_.size(); i++ ) {
+                scalars->values_SUM[i] = scalars->exact_SUM_[i].value();
+            }
+        }
+    } else {
+        int n_sum = scalars->values_SUM.size();
+        double *d_sum = &scalars->values_SUM[0];
+        MPI_Reduce( isMaster()?MPI_IN_PLACE:d_sum, d_sum, n_sum, MPI_DOUBLE, MPI_SUM, 0, world_ );
+    }
 
     if( scalars->necessary_fieldMinMax_any ) {
         // Reduce all scalars that are a "min" and its location
         int n_min = scalars->values_MINLOC.size();
         val_index *d_min = &scalars->values_MINLOC[0];
-        MPI_Reduce( isMaster()?MPI_IN_PLACE:d_min, d_min, n_min, MPI_DOUBLE_INT, MPI_MINLOC, 0, MPI_COMM_WORLD );
+        MPI_Reduce( isMaster()?MPI_IN_PLACE:d_min, d_min, n_min, MPI_DOUBLE_INT, MPI_MINLOC, 0, world_ );
 
         // Reduce all scalars that are a "max" and its location
         int n_max = scalars->values_MAXLOC.size();
         val_index *d_max = &scalars->values_MAXLOC[0];
-        MPI_Reduce( isMaster()?MPI_IN_PLACE:d_max, d_max, n_max, MPI_DOUBLE_INT, MPI_MAXLOC, 0, MPI_COMM_WORLD );
+        MPI_Reduce( isMaster()?MPI_IN_PLACE:d_max, d_max, n_max, MPI_DOUBLE_INT, MPI_MAXLOC, 0, world_ );
     }
 
-    // Complete the computation of the scalars after all reductions
+    completeScalars( scalars, itime );
+} // END computeGlobalDiags(DiagnosticScalar& scalars ...)
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Complete the asynchronous reductions of the scalars of the previous output, and write them
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::finalizeGlobalDiags( Diagnostic *diag )
+{
+    DiagnosticScalar *scalars = dynamic_cast<DiagnosticScalar *>( diag );
+    if( !scalars || scalars->pending_timestep_ < 0 ) {
+        return;
+    }
+
+    MPI_Status status[3];
+    MPI_Waitall( 3, scalars->pending_requests_, status );
+    if( isMaster() ) {
+        if( scalars->exact_reduction_ ) {
+            for( unsigned int i=0; i<scalars->pending_exact_SUM_.size(); i++ ) {
+                scalars->values_SUM[i] = scalars->pending_exact_SUM_[i].value();
+            }
+        } else {
+            scalars->values_SUM = scalars->pending_SUM_;
+        }
+        if( scalars->necessary_fieldMinMax_any ) {
+            scalars->values_MINLOC = scalars->pending_MINLOC_;
+            scalars->values_MAXLOC = scalars->pending_MAXLOC_;
+        }
+    }
+    int itime = scalars->pending_timestep_;
+    scalars->pending_timestep_ = -1;
+    completeScalars( scalars, itime );
+    scalars->write( itime, this );
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Computation of the scalars after all reductions
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::completeScalars( DiagnosticScalar *scalars, int itime )
+{
     if( isMaster() ) {
 
         // Calculate average Z
@@ -2421,7 +3060,7 @@ void SmileiMPI::computeGlobalDiags( DiagnosticScalar *scalars, int itime )
         }
 
     }
-} // END computeGlobalDiags(DiagnosticScalar& scalars ...)
+} // END completeScalars
 
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -2430,7 +3069,17 @@ void SmileiMPI::computeGlobalDiags( DiagnosticScalar *scalars, int itime )
 void SmileiMPI::computeGlobalDiags( DiagnosticParticleBinning *diagParticles, int itime )
 {
     if( itime - diagParticles->timeSelection->previousTime() == diagParticles->time_average-1 ) {
-        MPI_Reduce( diagParticles->filename.size()?MPI_IN_PLACE:&diagParticles->data_sum[0], &diagParticles->data_sum[0], diagParticles->output_size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+        if( diagParticles->sparse_storage_ ) {
+            diagParticles->sortSparseBins();
+            reduceSparseHistogram( diagParticles->sparse_indices_, diagParticles->sparse_values_ );
+        } else if( diagParticles->reduction_ == DiagnosticParticleBinningBase::REDUCTION_EXACT ) {
+            reduceExactSums( diagParticles->exact_sum_ );
+            if( isMaster() ) {
+                diagParticles->exactSumsToData();
+            }
+        } else {
+            MPI_Reduce( diagParticles->filename.size()?MPI_IN_PLACE:&diagParticles->data_sum[0], &diagParticles->data_sum[0], diagParticles->output_size, MPI_DOUBLE, MPI_SUM, 0, world_ );
+        }
 
         if( !isMaster() ) {
             diagParticles->clear();
@@ -2444,7 +3093,12 @@ void SmileiMPI::computeGlobalDiags( DiagnosticParticleBinning *diagParticles, in
 void SmileiMPI::computeGlobalDiags( DiagnosticScreen *diagScreen, int itime )
 {
     if( diagScreen->timeSelection->theTimeIsNow( itime ) ) {
-        MPI_Reduce( diagScreen->filename.size()?MPI_IN_PLACE:&diagScreen->data_sum[0], &diagScreen->data_sum[0], diagScreen->output_size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+        if( diagScreen->sparse_storage_ ) {
+            diagScreen->sortSparseBins();
+            reduceSparseHistogram( diagScreen->sparse_indices_, diagScreen->sparse_values_ );
+        } else {
+            MPI_Reduce( diagScreen->filename.size()?MPI_IN_PLACE:&diagScreen->data_sum[0], &diagScreen->data_sum[0], diagScreen->output_size, MPI_DOUBLE, MPI_SUM, 0, world_ );
+        }
 
         if( !isMaster() ) {
             diagScreen->clear();
@@ -2458,7 +3112,17 @@ void SmileiMPI::computeGlobalDiags( DiagnosticScreen *diagScreen, int itime )
 void SmileiMPI::computeGlobalDiags(DiagnosticRadiationSpectrum* diagRad, int itime)
 {
     if (itime - diagRad->timeSelection->previousTime() == diagRad->time_average-1) {
-        MPI_Reduce( diagRad->filename.size()?MPI_IN_PLACE:&diagRad->data_sum[0], &diagRad->data_sum[0], diagRad->output_size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+        if( diagRad->sparse_storage_ ) {
+            diagRad->sortSparseBins();
+            reduceSparseHistogram( diagRad->sparse_indices_, diagRad->sparse_values_ );
+        } else if( diagRad->reduction_ == DiagnosticParticleBinningBase::REDUCTION_EXACT ) {
+            reduceExactSums( diagRad->exact_sum_ );
+            if( isMaster() ) {
+                diagRad->exactSumsToData();
+            }
+        } else {
+            MPI_Reduce( diagRad->filename.size()?MPI_IN_PLACE:&diagRad->data_sum[0], &diagRad->data_sum[0], diagRad->output_size, MPI_DOUBLE, MPI_SUM, 0, world_ );
+        }
 
         if( !isMaster() ) {
             diagRad->clear();
@@ -2466,6 +3130,79 @@ void SmileiMPI::computeGlobalDiags(DiagnosticRadiationSpectrum* diagRad, int iti
     }
 } // END computeGlobalDiags(DiagnosticRadiationSpectrum*  ...)
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Sum of exact sums on the master: their digits are carried, then summed as integers, in any order
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::reduceExactSums( vector<ExactSum> &sums, MPI_Request *request )
+{
+    static_assert( sizeof( ExactSum ) == ExactSum::size * sizeof( int64_t ), "ExactSum must only hold its digits" );
+    for( unsigned int i=0; i<sums.size(); i++ ) {
+        sums[i].normalize();
+    }
+    int64_t *d = sums.empty() ? nullptr : &sums[0].digits_[0];
+    int n = sums.size() * ExactSum::size;
+    if( request ) {
+#if MPI_VERSION >= 3
+        MPI_Ireduce( isMaster()?MPI_IN_PLACE:d, d, n, MPI_INT64_T, MPI_SUM, 0, world_, request );
+#endif
+    } else {
+        MPI_Reduce( isMaster()?MPI_IN_PLACE:d, d, n, MPI_INT64_T, MPI_SUM, 0, world_ );
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// MPI synchronization of sparse histograms: at each level of a binary tree, one process of each pair
+// sends its sorted bins to the other, which merges them with its own
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::reduceSparseHistogram( vector<unsigned int> &indices, vector<double> &values )
+{
+    vector<unsigned int> recv_indices, merged_indices;
+    vector<double> recv_values, merged_values;
+    for( int step = 1; step < smilei_sz; step *= 2 ) {
+        if( smilei_rk % ( 2*step ) == step ) {
+            int n = indices.size();
+            MPI_Send( &n, 1, MPI_INT, smilei_rk-step, 0, world_ );
+            if( n > 0 ) {
+                MPI_Send( &indices[0], n, MPI_UNSIGNED, smilei_rk-step, 1, world_ );
+                MPI_Send( &values[0], n, MPI_DOUBLE, smilei_rk-step, 2, world_ );
+            }
+            indices.clear();
+            values.clear();
+            break;
+        } else if( smilei_rk % ( 2*step ) == 0 && smilei_rk+step < smilei_sz ) {
+            int n;
+            MPI_Recv( &n, 1, MPI_INT, smilei_rk+step, 0, world_, MPI_STATUS_IGNORE );
+            if( n == 0 ) {
+                continue;
+            }
+            recv_indices.resize( n );
+            recv_values.resize( n );
+            MPI_Recv( &recv_indices[0], n, MPI_UNSIGNED, smilei_rk+step, 1, world_, MPI_STATUS_IGNORE );
+            MPI_Recv( &recv_values[0], n, MPI_DOUBLE, smilei_rk+step, 2, world_, MPI_STATUS_IGNORE );
+            // Merge the two sorted lists, summing the common bins
+            merged_indices.clear();
+            merged_values.clear();
+            merged_indices.reserve( indices.size() + n );
+            merged_values.reserve( indices.size() + n );
+            size_t i = 0, j = 0;
+            while( i < indices.size() || j < recv_indices.size() ) {
+                if( j == recv_indices.size() || ( i < indices.size() && indices[i] < recv_indices[j] ) ) {
+                    merged_indices.push_back( indices[i] );
+                    merged_values.push_back( values[i++] );
+                } else if( i == indices.size() || recv_indices[j] < indices[i] ) {
+                    merged_indices.push_back( recv_indices[j] );
+                    merged_values.push_back( recv_values[j++] );
+                } else {
+                    merged_indices.push_back( indices[i] );
+                    merged_values.push_back( values[i++] + recv_values[j++] );
+                }
+            }
+            indices.swap( merged_indices );
+            values.swap( merged_values );
+        }
+    }
+} // END reduceSparseHistogram
+
 
 // ---------------------------------------------------------------------------------------------------------------------
 // Buffer management
@@ -2492,6 +3229,13 @@ void SmileiMPI::eraseBufferParticleTrail( const int ndim, const int istart, cons
         dynamics_deltaold[ithread].erase(dynamics_deltaold[ithread].begin()+idim*np + istart,
                                       dynamics_deltaold[ithread].begin()+idim*np + np);
     }
+
+    if( dynamics_shapeold.size() > 0 ) {
+        for ( int irow=shapeold_rows_-1 ; irow>=0 ; irow-- ) {
+            dynamics_shapeold[ithread].erase(dynamics_shapeold[ithread].begin()+irow*np + istart,
+                                             dynamics_shapeold[ithread].begin()+irow*np + np);
+        }
+    }
                                   
     if( isAM ) {
         dynamics_eithetaold[ithread].erase(dynamics_eithetaold[ithread].begin() + istart,
@@ -2523,6 +3267,29 @@ void SmileiMPI::eraseBufferParticleTrail( const int ndim, const int istart, cons
     }
 }
 
+//! Memory allocated for the buffers of Species::dynamics of all threads
+std::size_t SmileiMPI::getDynamicsBuffersMemory()
+{
+    std::vector<std::vector<std::vector<double>> *> buffers = {
+        &dynamics_Epart, &dynamics_Bpart, &dynamics_invgf, &dynamics_deltaold, &dynamics_shapeold,
+        &dynamics_Bpart_yBTIS3, &dynamics_Bpart_zBTIS3, &dynamics_GradPHIpart, &dynamics_GradPHI_mpart,
+        &dynamics_PHIpart, &dynamics_PHI_mpart, &dynamics_inv_gamma_ponderomotive, &dynamics_EnvEabs_part, &dynamics_EnvExabs_part
+    };
+    std::size_t mem = 0;
+    for( unsigned int ibuffer = 0; ibuffer < buffers.size(); ibuffer++ ) {
+        for( unsigned int ithread = 0; ithread < buffers[ibuffer]->size(); ithread++ ) {
+            mem += ( *buffers[ibuffer] )[ithread].capacity() * sizeof( double );
+        }
+    }
+    for( unsigned int ithread = 0; ithread < dynamics_iold.size(); ithread++ ) {
+        mem += dynamics_iold[ithread].capacity() * sizeof( int );
+    }
+    for( unsigned int ithread = 0; ithread < dynamics_eithetaold.size(); ithread++ ) {
+        mem += dynamics_eithetaold[ithread].capacity() * sizeof( std::complex<double> );
+    }
+    return mem;
+}
+
 
 #if defined( SMILEI_ACCELERATOR_GPU_OMP ) || defined( SMILEI_ACCELERATOR_GPU_OACC )
 
@@ -4,7 +4,9 @@
 #include <mpi.h>
 
 #include <string>
+#include <map>
 #include <vector>
+#include <fstream>
 
 #include "Field.h"
 #include "Particles.h"
@@ -15,6 +17,7 @@ class Params;
 class Species;
 class VectorPatch;
 class DomainDecomposition;
+class SharedMemoryHalos;
 
 class ElectroMagn;
 class ProbeParticles;
@@ -24,6 +27,7 @@ class DiagnosticScalar;
 class DiagnosticParticleBinning;
 class DiagnosticScreen;
 class DiagnosticRadiationSpectrum;
+class ExactSum;
 
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class SmileiMPI
@@ -78,6 +82,22 @@ public:
     void isend_species( Patch *patch, int to, int &irequest, int tag, Params &params );
     void recv_species( Patch *patch, int from, int &tag, Params &params );
 
+    //! Send the patches send_patches[i] to send_ranks[i] and receive the patches recv_patches[i] from recv_ranks[i],
+    //! with one message per MPI process and round (LoadBalancing.batched_exchange)
+    void exchangePatchesBatched( std::vector<Patch *> &send_patches, std::vector<int> &send_ranks,
+                                 std::vector<Patch *> &recv_patches, std::vector<int> &recv_ranks, Params &params );
+
+    //! The following isend and recv of fields and vectors only record their segment, then exchangeBatches() sends them
+    //! with one message per MPI process and waits for them (patch/region synchronizations of MultipleDecomposition)
+    inline void startBatches()
+    {
+        batching_ = true;
+    }
+    inline void exchangeBatches()
+    {
+        flushBatches();
+    }
+
     void isend( Particles *particles, int to, int tag, MPI_Datatype datatype, MPI_Request &request );
     void recv( Particles *partictles, int from, int tag, MPI_Datatype datatype );
     void isend( std::vector<int> *vec, int to, int tag, MPI_Request &request );
@@ -148,6 +168,14 @@ public:
     void computeGlobalDiags(DiagnosticScreen*            diag, int timestep);
     // MPI synchronization of radiation spectrum diags
     void computeGlobalDiags(DiagnosticRadiationSpectrum* diag, int timestep);
+    // Sum of sparse histograms (sorted indices of the non-empty bins and their values) on the master, by a binary tree of merges
+    void reduceSparseHistogram( std::vector<unsigned int> &indices, std::vector<double> &values );
+    // Sum of exact sums on the master (non-blocking if a request is given)
+    void reduceExactSums( std::vector<ExactSum> &sums, MPI_Request *request = nullptr );
+    // Complete the asynchronous reductions of the scalars (DiagScalar.asynchronous) and write them
+    void finalizeGlobalDiags(Diagnostic*                 diag);
+    // Scalars computed by the master from the reduced scalars
+    void completeScalars(DiagnosticScalar*              diag, int timestep);
 
     // MPI basic methods
     // -----------------
@@ -179,6 +207,43 @@ public:
         return world_;
     }
 
+    //! Return the communicator of the halo messages aggregated per MPI process
+    inline MPI_Comm& haloComm()
+    {
+        return halo_comm_;
+    }
+
+    //! Renumber the MPI processes of world_ node by node, then socket by socket (Main.topology_aware_placement)
+    void placeRanksByTopology();
+
+    //! Build the graph communicator (Main.neighborhood_collectives) or the shared memory window
+    //! (Main.shared_memory_halos) of the halo exchanges, for the neighbor patches of vecPatches
+    void updateHaloComms( VectorPatch &vecPatches );
+
+    //! Return the graph communicator of the neighbor MPI processes (MPI_COMM_NULL if not used)
+    inline MPI_Comm& neighborComm()
+    {
+        return neighbor_comm_;
+    }
+
+    //! Return the neighbor MPI processes, in the order of the neighborhood collectives
+    inline const std::vector<int>& neighborRanks()
+    {
+        return neighbor_ranks_;
+    }
+
+    //! Return the halo exchanges through shared memory with the MPI processes of the node (NULL if not used)
+    inline SharedMemoryHalos *sharedHalos()
+    {
+        return shared_halos_;
+    }
+
+    //! The MPI messages of the current sums only carry the extent of the boundaries touched by the projection
+    inline bool sparseCurrentSums()
+    {
+        return sparse_current_sums_;
+    }
+
     //! Return omp_max_threads
     inline int getOMPMaxThreads()
     {
@@ -219,6 +284,11 @@ public:
     std::vector<std::vector<int>> dynamics_iold;
     //! delta_old_pos
     std::vector<std::vector<double>> dynamics_deltaold;
+    //! shape coefficients at the old position, exported by the interpolator for the projector
+    //! (Vectorization.reuse_shape_coefficients): one row of buffer size per dimension and node
+    std::vector<std::vector<double>> dynamics_shapeold;
+    //! Number of rows of dynamics_shapeold (0 if the shape coefficients are not reused)
+    unsigned int shapeold_rows_;
     //! theta old
     std::vector<std::vector<std::complex<double>>> dynamics_eithetaold;
     //! value of the By field for BTIS3
@@ -248,6 +318,9 @@ public:
     //! Erase Particles from istart ot the end in the buffers of thread ithread
     void eraseBufferParticleTrail( const int ndim, const int istart, const int ithread, bool isAM = false );
 
+    //! Memory allocated for the buffers of Species::dynamics of all threads (bytes)
+    std::size_t getDynamicsBuffersMemory();
+
 #if defined( SMILEI_ACCELERATOR_GPU_OMP ) || defined( SMILEI_ACCELERATOR_GPU_OACC )
     //! Map CPU buffers onto the GPU to at least accommodate particle_count
     //! particles. This method tries to reduce the number of
@@ -276,6 +349,9 @@ public:
         dynamics_invgf[ithread].resize( npart );
         dynamics_iold[ithread].resize( ndim_field*npart );
         dynamics_deltaold[ithread].resize( ndim_field*npart );
+        if( dynamics_shapeold.size() > 0 ) {
+            dynamics_shapeold[ithread].resize( shapeold_rows_*npart );
+        }
         if(use_BTIS3){
             dynamics_Bpart_yBTIS3[ithread].resize( npart );
             dynamics_Bpart_zBTIS3[ithread].resize( npart );
@@ -306,6 +382,9 @@ public:
         dynamics_invgf.resize( n_buffers );
         dynamics_iold.resize( n_buffers );
         dynamics_deltaold.resize( n_buffers );
+        if( shapeold_rows_ > 0 ) {
+            dynamics_shapeold.resize( n_buffers );
+        }
         if(use_BTIS3){
             dynamics_Bpart_yBTIS3.resize( n_buffers );
             dynamics_Bpart_zBTIS3.resize( n_buffers );
@@ -335,6 +414,9 @@ public:
         dynamics_invgf[buffer_id].resize( 1 );
         dynamics_iold[buffer_id].resize( 1 );
         dynamics_deltaold[buffer_id].resize( 1 );
+        if( dynamics_shapeold.size() > 0 ) {
+            dynamics_shapeold[buffer_id].resize( 1 );
+        }
         if(use_BTIS3){
             dynamics_Bpart_yBTIS3[buffer_id].resize( 1 );
             dynamics_Bpart_zBTIS3[buffer_id].resize( 1 );
@@ -393,20 +475,86 @@ public:
 
     // If particle event tracing diagnostic is activated, trace event
 #ifdef _PARTEVENTTRACING
-    void traceEventIfDiagTracing( bool, int, unsigned int, int ) {};
-#else
     void traceEventIfDiagTracing( bool diag_PartEventTracing, int thread,
                                   unsigned int event_start_or_end, int event_name )
     {
         if( diag_PartEventTracing ) trace_event( thread, (MPI_Wtime()-reference_time_), event_start_or_end, event_name );
     };
+#else
+    void traceEventIfDiagTracing( bool, int, unsigned int, int ) {};
 #endif
 
+    //! Trace an event of the calling thread if the events of the current iteration are traced
+    inline void traceEvent( unsigned int event_start_or_end, int event_name )
+    {
+        traceEventIfDiagTracing( event_tracing_now_, Tools::getOMPThreadNum(), event_start_or_end, event_name );
+    };
+
+    //! Name of each traced event: particle events (0 to 11), MPI waits (12), then the phases of the main timers
+    std::vector<std::string> traced_event_names_;
+    //! True if the events of the current iteration are traced (set at the beginning of each iteration)
+    bool event_tracing_now_;
+    //! Register a new kind of traced event and return its id
+    int addTracedEvent( std::string name );
+    //! Append the events traced by all threads to the timeline of this process, and clear them
+    //! (Chrome trace format, to be called outside of parallel regions)
+    void writeEventTracing( int iteration );
+
+    //! Bytes sent through MPI by the halo exchanges of the particles and of the fields (including the sums of densities),
+    //! for the throughputs of Timers::profile
+    enum { sent_particles = 0, sent_fields = 1 };
+    uint64_t sent_bytes_[2] = { 0, 0 };
+    inline void countSentBytes( int category, uint64_t bytes )
+    {
+        #pragma omp atomic
+        sent_bytes_[category] += bytes;
+    };
+
     bool use_BTIS3;
 
 protected:
     //! Global MPI Communicator
     MPI_Comm world_;
+    //! Timeline of the traced events of this process (file opened at the first traced iteration)
+    std::ofstream event_tracing_file_;
+
+    //! Duplicate of world_ for the halo messages aggregated per MPI process (their tags are not unique in world_)
+    MPI_Comm halo_comm_;
+    //! Halo exchanges by neighborhood collectives in neighbor_comm_, graph of the processes neighbor_ranks_
+    bool neighborhood_collectives_;
+    MPI_Comm neighbor_comm_;
+    std::vector<int> neighbor_ranks_;
+    //! Halo exchanges through shared memory in the node
+    SharedMemoryHalos *shared_halos_;
+    //! Main.sparse_current_sums
+    bool sparse_current_sums_;
+
+    //! Segments of the batched messages of a patch exchange to or from one MPI process (absolute addresses)
+    struct PatchBatch {
+        std::vector<MPI_Aint> displacements;
+        std::vector<int> lengths;
+        std::vector<MPI_Datatype> types;
+    };
+    //! When batching_, the send and receive primitives of the patches only record their segment, by MPI process
+    bool batching_;
+    std::map<int, PatchBatch> send_batches_, recv_batches_;
+    //! Particle datatypes of the recorded segments received
+    std::vector<MPI_Datatype> batch_datatypes_;
+    //! Send (MPI_Isend) or receive (MPI_Recv) a buffer, or record it when batching_
+    void postIsend( void *buffer, int count, MPI_Datatype type, int to, int tag, MPI_Request &request );
+    void postRecv( void *buffer, int count, MPI_Datatype type, int from, int tag );
+    void recordSegment( PatchBatch &batch, void *buffer, int count, MPI_Datatype type );
+    //! Exchange the recorded segments, one message per MPI process, and wait for them
+    void flushBatches();
+
+    //! Correct the patch_count of recompute_patch_count for the memory of each process to stay below LoadBalancing.memory_cap
+    void capProcessMemory( Params &params, VectorPatch &vecpatches, std::vector<int> &old_patch_count );
+
+    //! Scalars of the species and of the fields sent with a patch
+    void packSpeciesScalars( Patch *patch, Params &params );
+    void unpackSpeciesScalars( Patch *patch, Params &params );
+    void packFieldsScalars( Patch *patch, Params &params );
+    void unpackFieldsScalars( Patch *patch, Params &params );
 
     //! Number of MPI process in the current communicator
     int smilei_sz;
@@ -425,8 +573,10 @@ protected:
 
     //! For patch decomposition
     //Number of patches owned by each mpi process.
-    std::vector<int>  patch_count, capabilities, patch_refHindexes;
-    int Tcapabilities; //Default = smilei_sz (1 per MPI rank)
+    std::vector<int>  patch_count, patch_refHindexes;
+    //! Relative throughput of each mpi process (1 for CPU processes, LoadBalancing.gpu_rank_capability for GPU ones)
+    std::vector<double> capabilities;
+    double Tcapabilities; //Default = smilei_sz (1 per MPI rank)
 };
 
 
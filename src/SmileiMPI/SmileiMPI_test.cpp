@@ -2,12 +2,16 @@
 
 #include <cmath>
 #include <cstring>
+#include <algorithm>
 
 #include <iostream>
 #include <sstream>
 #include <fstream>
 
 #include "Params.h"
+#include "PeekAtSpecies.h"
+#include "DomainDecomposition.h"
+#include "VectorPatch.h"
 
 using namespace std;
 
@@ -34,6 +38,15 @@ int get_integer_argument( int *argc, char ***argv )
 SmileiMPI_test::SmileiMPI_test( int *argc, char ***argv )
 {
     test_mode = true;
+    shapeold_rows_ = 0;
+
+    // If first argument is --balance, report the estimated load balance of the intended partition
+    balance_report_ = false;
+    if( *argc > 1 && std::string( ( *argv )[1] ) == "--balance" ) {
+        balance_report_ = true;
+        ( *argv )++;
+        ( *argc )--;
+    }
 
     // If first argument is a number, interpret as the number of MPIs
     int nMPI = get_integer_argument( argc, argv );
@@ -69,6 +82,12 @@ SmileiMPI_test::SmileiMPI_test( int *argc, char ***argv )
     world_ = MPI_COMM_WORLD;
     MPI_Comm_size( world_, &smilei_sz );
     MPI_Comm_rank( world_, &smilei_rk );
+    MPI_Comm_dup( world_, &halo_comm_ );
+    neighborhood_collectives_ = false;
+    neighbor_comm_ = MPI_COMM_NULL;
+    shared_halos_ = NULL;
+    sparse_current_sums_ = false;
+    batching_ = false;
 
     if( smilei_sz > 1 ) {
         ERROR( "Test mode cannot be run with several MPI processes. Instead, indicate the MPIxOMP intended partition after the -T argument." );
@@ -164,3 +183,106 @@ void SmileiMPI_test::init_patch_count( Params &params, DomainDecomposition */*do
     }
 
 } // END init_patch_count
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Estimated load balance of the intended partition, without creating the patches:
+//     - the load of each patch is estimated from the species profiles, as for the initial balancing of the normal mode
+//     - the patches are distributed along the Hilbert curve, each process ending closest to its share of the load
+//     - the memory of a particle of each species and of the fields of a patch are measured on the first patch
+// The particles initialized from numpy arrays or files are not accounted for.
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI_test::reportBalance( Params &params, VectorPatch &vecPatches )
+{
+    TITLE( "Estimated load balance of the intended partition " << smilei_sz << "x" << smilei_omp_max_threads );
+
+    const unsigned int Npatches = params.tot_number_of_patches;
+    const unsigned int nspecies = vecPatches( 0 )->vecSpecies.size();
+    unsigned int ncells_perpatch = 1;
+    for( unsigned int i = 0; i < params.nDim_field; i++ ) {
+        ncells_perpatch *= params.patch_size_[i]+2*params.oversize[i];
+    }
+
+    vector<PeekAtSpecies *> peek( nspecies );
+    vector<double> particle_memory( nspecies ), frozen_load( nspecies, 1. );
+    for( unsigned int ispec = 0; ispec < nspecies; ispec++ ) {
+        peek[ispec] = new PeekAtSpecies( params, ispec );
+        Particles *particles = vecPatches( 0 )->vecSpecies[ispec]->particles;
+        particle_memory[ispec] = particles->double_prop_.size()*sizeof( double )
+                                 + particles->short_prop_.size()*sizeof( short )
+                                 + particles->uint64_prop_.size()*sizeof( uint64_t );
+        double time_frozen( 0. );
+        PyTools::extract( "time_frozen", time_frozen, "Species", ispec );
+        if( time_frozen > 0. ) {
+            frozen_load[ispec] = params.frozen_particle_load;
+        }
+    }
+    const double fields_memory = vecPatches( 0 )->EMfields->getMemFootPrint();
+
+    // Cumulated load and memory of the patches along the Hilbert curve
+    vector<double> load( Npatches+1, 0. ), memory( Npatches+1, 0. );
+    vector<double> x_cell( 3, 0. );
+    double largest_patch = 0.;
+    for( unsigned int hindex = 0; hindex < Npatches; hindex++ ) {
+        vector<unsigned int> Pcoordinates = vecPatches.domain_decomposition_->getDomainCoordinates( hindex );
+        for( unsigned int i=0 ; i<params.nDim_field ; i++ ) {
+            x_cell[i] = ( Pcoordinates[i]+0.5 )*params.patch_dimensions[i];
+        }
+        double patch_load = ncells_perpatch*params.cell_load;
+        double patch_memory = fields_memory;
+        for( unsigned int ispec = 0; ispec < nspecies; ispec++ ) {
+            const double npart = peek[ispec]->numberOfParticlesInPatch( x_cell );
+            patch_load += npart * frozen_load[ispec];
+            patch_memory += npart * particle_memory[ispec];
+        }
+        largest_patch = max( largest_patch, patch_load );
+        load[hindex+1] = load[hindex] + patch_load;
+        memory[hindex+1] = memory[hindex] + patch_memory;
+    }
+    for( unsigned int ispec = 0; ispec < nspecies; ispec++ ) {
+        delete peek[ispec];
+    }
+
+    // First patch of each process, balanced or with as many patches on each process
+    const double target = load[Npatches] / smilei_sz;
+    vector<unsigned int> first( smilei_sz+1, Npatches ), first_uniform( smilei_sz+1, Npatches );
+    first[0] = 0;
+    first_uniform[0] = 0;
+    for( int rk = 1; rk < smilei_sz; rk++ ) {
+        unsigned int h = lower_bound( load.begin(), load.end(), rk*target ) - load.begin();
+        if( h > 0 && rk*target - load[h-1] < load[h] - rk*target ) {
+            h--;
+        }
+        h = max( h, first[rk-1]+1 );
+        first[rk] = min( h, Npatches - ( smilei_sz-rk ) );
+        first_uniform[rk] = first_uniform[rk-1] + Npatches / smilei_sz + ( rk <= ( int )( Npatches % smilei_sz ) ? 1 : 0 );
+    }
+
+    double max_load = 0., max_load_uniform = 0., max_memory = 0.;
+    unsigned int min_patches = Npatches, max_patches = 0;
+    for( int rk = 0; rk < smilei_sz; rk++ ) {
+        max_load = max( max_load, load[first[rk+1]] - load[first[rk]] );
+        max_load_uniform = max( max_load_uniform, load[first_uniform[rk+1]] - load[first_uniform[rk]] );
+        max_memory = max( max_memory, memory[first[rk+1]] - memory[first[rk]] );
+        min_patches = min( min_patches, first[rk+1] - first[rk] );
+        max_patches = max( max_patches, first[rk+1] - first[rk] );
+    }
+
+    MESSAGE( 1, "Imbalance (max/mean load of the MPI processes): " << max_load / target
+             << " (" << max_load_uniform / target << " with as many patches on each process)" );
+    MESSAGE( 1, "Largest patch: " << largest_patch / target << " of the mean load of an MPI process" );
+    MESSAGE( 1, "Patches per MPI process: " << min_patches << " to " << max_patches
+             << ", i.e. at least " << ( double )min_patches / smilei_omp_max_threads << " per OpenMP thread" );
+    MESSAGE( 1, "Memory of the particles and fields per MPI process: " << memory[Npatches] / smilei_sz / 1073741824.
+             << " GB on average, " << max_memory / 1073741824. << " GB at most" );
+
+    if( largest_patch >= target ) {
+        WARNING( "A patch has a load larger than the mean load of an MPI process. Try using smaller patches or less MPI ranks." );
+    }
+    if( min_patches < ( unsigned int )smilei_omp_max_threads ) {
+        WARNING( "Some MPI processes have fewer patches than OpenMP threads" );
+    }
+    if( params.memory_cap > 0. && max_memory > params.memory_cap * 1073741824. ) {
+        WARNING( "Some MPI processes exceed LoadBalancing.memory_cap" );
+    }
+} // END reportBalance
@@ -27,6 +27,12 @@ public:
     void init_patch_count( Params &params, DomainDecomposition *domain_decomposition ) override;
     // Recompute the patch_count vector. Browse patches and redistribute them in order to balance the load between MPI processes.
     
+    //! Report the estimated load and memory of the intended MPI processes (argument --balance)
+    void reportBalance( Params &params, VectorPatch &vecPatches );
+    
+    //! True if the test mode reports the estimated load balance (argument --balance)
+    bool balance_report_;
+    
 };
 
 #endif
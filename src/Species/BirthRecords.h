@@ -10,7 +10,9 @@
 //! Required for DiagNewParticles
 struct BirthRecords
 {
-    BirthRecords( Particles &source_particles ) {
+    BirthRecords( Particles &source_particles, unsigned int record_every = 1, uint64_t *nrecords = nullptr ) :
+        record_every_( record_every ), nrecords_( nrecords )
+    {
         p_.initialize( 0, source_particles );
         p_.double_prop_.push_back( &birth_time_ ); // the birth time is the last property
     };
@@ -20,15 +22,43 @@ struct BirthRecords
     };
     void update( Particles &source_particles, size_t npart, double time_dual, Ionization *I ) {
         size_t prev_size = birth_time_.size();
-        birth_time_.resize( prev_size + npart, time_dual );
-        source_particles.copyParticles( 0, npart, p_, prev_size );
-        // If electrons come from ionization, then the charge is replaced by that of the ionized ions
-        if( I && I->save_ion_charge_ ) {
-            copy( I->ion_charge_.begin(), I->ion_charge_.end(), &p_.Charge[prev_size] );
-            I->ion_charge_.clear();
+        if( record_every_ > 1 ) {
+            // Only record one particle out of record_every_, continuing the count of the previous calls
+            size_t first = next_;
+            size_t nrecorded = first < npart ? ( npart - first - 1 ) / record_every_ + 1 : 0;
+            next_ = first + nrecorded * record_every_ - npart;
+            birth_time_.resize( prev_size + nrecorded, time_dual );
+            for( size_t i = first; i < npart; i += record_every_ ) {
+                source_particles.copyParticle( i, p_ );
+            }
+            if( I && I->save_ion_charge_ ) {
+                for( size_t i = first, j = prev_size; i < npart; i += record_every_, j++ ) {
+                    p_.Charge[j] = I->ion_charge_[i];
+                }
+                I->ion_charge_.clear();
+            }
+        } else {
+            birth_time_.resize( prev_size + npart, time_dual );
+            source_particles.copyParticles( 0, npart, p_, prev_size );
+            // If electrons come from ionization, then the charge is replaced by that of the ionized ions
+            if( I && I->save_ion_charge_ ) {
+                copy( I->ion_charge_.begin(), I->ion_charge_.end(), &p_.Charge[prev_size] );
+                I->ion_charge_.clear();
+            }
+        }
+        if( nrecords_ ) {
+            #pragma omp atomic
+            *nrecords_ += birth_time_.size() - prev_size;
         }
     }
     
+    //! Only one new particle out of record_every_ is recorded
+    unsigned int record_every_;
+    //! Index of the next particle to record in the following update
+    size_t next_ = 0;
+    //! Number of particles recorded by all the patches of this process since the last output (shared, may be null)
+    uint64_t *nrecords_;
+    
     std::vector<double> birth_time_;
     Particles p_;
 };
@@ -49,10 +49,27 @@ using namespace std;
 Species::Species( Params &params, Patch *patch ) :
     c_part_max_( 1 ),
     ionization_rate_( Py_None ),
+    ionization_table_size_( 512 ),
     pusher_name_( "boris" ),
     radiation_model_( "none" ),
     time_frozen_( 0 ),
+    push_every_( 1 ),
+    timestep_( params.timestep ),
     radiating_( false ),
+    fused_dynamics_( false ),
+    fused_radiation_( false ),
+    sort_moved_particles_( 0 ),
+    sort_particles_( 0 ),
+    sort_disorder_threshold_( 0.1 ),
+    sort_time_( 0. ),
+    dynamics_time_( -1. ),
+    dynamics_time_sorted_( -1. ),
+    sort_lost_time_( 0. ),
+    imported_particles_( 0 ),
+    imported_particles_forecast_( 0 ),
+    forecast_overshoot_( 0 ),
+    forecast_undershoot_( 0 ),
+    frozen_rho_particles_( -1 ),
     relativistic_field_initialization_( false ),
     iter_relativistic_initialization_( 0 ),
     ionization_model_( "none" ),
@@ -86,7 +103,16 @@ Species::Species( Params &params, Patch *patch ) :
     tracking_diagnostic( 10000 ),
     nDim_particle( params.nDim_particle ),
     nDim_field(    params.nDim_field  ),
-    merging_time_selection_( 0 )
+    merging_time_selection_( 0 ),
+    merge_target_particles_per_cell_( 0 ),
+    merge_memory_budget_( 0. ),
+    merging_target_( 0 ),
+    merged_particles_( 0 ),
+    has_splitting_( false ),
+    splitting_time_selection_( 0 ),
+    split_max_particles_per_cell_( 0 ),
+    split_factor_( 2 ),
+    split_particles_( 0 )
 {
     // &particles_sorted[0]
     particles         = ParticlesFactory::create( params, *patch );
@@ -346,7 +372,7 @@ void Species::initOperators( Params &params, Patch *patch )
     Interp = InterpolatorFactory::create( params, patch, this->vectorized_operators ); // + patchId -> idx_domain_begin (now = ref smpi)
 
     // assign the correct Pusher to Push
-    Push = PusherFactory::create( params, this );
+    Push = PusherFactory::create( params, this, patch->rand_ );
     if( params.Laser_Envelope_model ) {
         Push_ponderomotive_position = PusherFactory::create_ponderomotive_position_updater( params, this );
     }
@@ -385,7 +411,7 @@ void Species::initOperators( Params &params, Patch *patch )
     typePartRecv.resize( nDim_field*2, MPI_DATATYPE_NULL );
     exchangePatch = MPI_DATATYPE_NULL;
 
-
+    initDynamicsVariant();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -719,8 +745,7 @@ void Species::dynamics( double time_dual,
             static_cast<nvidiaParticles*>(mBW_pair_particles_[1])->deviceResize( particles->deviceSize() * Multiphoton_Breit_Wheeler_process->getPairCreationSampling(1) );
             static_cast<nvidiaParticles*>(mBW_pair_particles_[1])->resetCellKeys();
 #else
-            mBW_pair_particles_[0]->reserve(particles->numberOfParticles() * Multiphoton_Breit_Wheeler_process->getPairCreationSampling(0));
-            mBW_pair_particles_[1]->reserve(particles->numberOfParticles() * Multiphoton_Breit_Wheeler_process->getPairCreationSampling(1));
+            // On CPU, the pairs are reserved by the Breit-Wheeler operator, buffer by buffer
 #endif
 
             patch->stopFineTimer(mBW_timer_id_);
@@ -738,7 +763,9 @@ void Species::dynamics( double time_dual,
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),0,0);
 
             // Interpolate the fields at the particle position
-            Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ibin] ), &( particles->last_index[ibin] ), ithread );
+            if( gathersFields() ) {
+                Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ibin] ), &( particles->last_index[ibin] ), ithread );
+            }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),1,0);
             patch->stopFineTimer(interpolation_timer_id_);
 
@@ -755,8 +782,8 @@ void Species::dynamics( double time_dual,
 
             if( time_dual<=time_frozen_ ) continue; // Do not push frozen particles
 
-            // Radiation losses
-            if( Radiate ) {
+            // Radiation losses (applied by the pusher if fused)
+            if( Radiate && !fused_radiation_ ) {
 
                 patch->startFineTimer(5);
 
@@ -874,7 +901,11 @@ void Species::dynamics( double time_dual,
             particles->prepareInterpolatedFields( pold, start, n );
 
             // Push the particles and the photons
-            ( *Push )( *particles, smpi, 0, particles->last_index.back(), ithread );
+            if( fused_radiation_ ) {
+                Push->pushWithRadiation( *particles, smpi, RadiationTables, nrj_radiated_, 0, particles->last_index.back(), ithread );
+            } else {
+                ( *Push )( *particles, smpi, 0, particles->last_index.back(), ithread );
+            }
             //particles->testMove( particles->first_index[ibin], particles->last_index[ibin], params );
             
             // Copy interpolated fields to persistent buffers if requested
@@ -985,16 +1016,11 @@ void Species::dynamics( double time_dual,
             patch->startFineTimer(2);
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),0,3);
 
-            double *b_rho=nullptr;
-            for( unsigned int ibin = 0 ; ibin < particles->first_index.size() ; ibin ++ ) { //Loop for projection on buffer_proj
-                // TODO(Etienne M): DIAGS. The projector needs to work on valid data. Currently, in GPU mode, it'll read
-                // outdated particles data because basic() is always done on CPU. We need to pull the GPU data to the
-                // host.
-                b_rho = EMfields->rho_s[ispec] ? &( *EMfields->rho_s[ispec] )( 0 ) : &( *EMfields->rho_ )( 0 ) ;
-                for( iPart=particles->first_index[ibin] ; ( int )iPart<particles->last_index[ibin]; iPart++ ) {
-                    Proj->basic( b_rho, ( *particles ), iPart, 0 );
-                }
-            }
+            // TODO(Etienne M): DIAGS. The projector needs to work on valid data. Currently, in GPU mode, it'll read
+            // outdated particles data because basic() is always done on CPU. We need to pull the GPU data to the
+            // host.
+            double *b_rho = EMfields->rho_s[ispec] ? &( *EMfields->rho_s[ispec] )( 0 ) : &( *EMfields->rho_ )( 0 ) ;
+            projectFrozenCharge( b_rho, EMfields->rho_->size() );
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),1,3);
             patch->stopFineTimer(2);
@@ -1010,11 +1036,7 @@ void Species::dynamics( double time_dual,
             for( unsigned int imode = 0; imode<params.nmodes; imode++ ) {
                 int ifield = imode*n_species+ispec;
                 b_rho = emAM->rho_AM_s[ifield] ? &( *emAM->rho_AM_s[ifield] )( 0 ) : &( *emAM->rho_AM_[imode] )( 0 ) ;
-                for( unsigned int ibin = 0 ; ibin < particles->first_index.size() ; ibin ++ ) { //Loop for projection on buffer_proj
-                    for( int iPart=particles->first_index[ibin] ; iPart<particles->last_index[ibin]; iPart++ ) {
-                        Proj->basicForComplex( b_rho, ( *particles ), iPart, 0, imode );
-                    }
-                }
+                projectFrozenCharge( b_rho, emAM->rho_AM_[imode]->size(), imode, params.nmodes );
             }
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),1,3);
@@ -1094,7 +1116,9 @@ void Species::dynamicsTasks( double time_dual, unsigned int ispec,
 #endif
 
             // Interpolate the fields at the particle position
-            Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ibin] ), &( particles->last_index[ibin] ), buffer_id );
+            if( gathersFields() ) {
+                Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ibin] ), &( particles->last_index[ibin] ), buffer_id );
+            }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),1,0);
 
 #ifdef  __DETAILED_TIMERS
@@ -1735,13 +1759,24 @@ void Species::dynamicsImportParticles( double time_dual, Params &params, Patch *
 //   - increment the charge (projection)
 //   - used at initialisation for Poisson (and diags if required, not for now dynamics )
 // ---------------------------------------------------------------------------------------------------------------------
-void Species::computeCharge( ElectroMagn *EMfields, bool old /*=false*/ )
+void Species::computeCharge( ElectroMagn *EMfields, bool old /*=false*/, bool frozen /*=false*/ )
 {
     // -------------------------------
     // calculate the particle charge
     // -------------------------------
     if( ( !particles->is_test ) ) {
-        if( !dynamic_cast<ElectroMagnAM *>( EMfields ) ) {
+        if( frozen ) {
+            if( !dynamic_cast<ElectroMagnAM *>( EMfields ) ) {
+                projectFrozenCharge( &( *EMfields->rho_ )( 0 ), EMfields->rho_->size() );
+            } else {
+                ElectroMagnAM *emAM = static_cast<ElectroMagnAM *>( EMfields );
+                unsigned int Nmode = emAM->rho_AM_.size();
+                for( unsigned int imode=0; imode<Nmode; imode++ ) {
+                    complex<double> *b_rho = old ? &( *emAM->rho_old_AM_[imode] )( 0 ) : &( *emAM->rho_AM_[imode] )( 0 );
+                    projectFrozenCharge( b_rho, emAM->rho_AM_[imode]->size(), imode, Nmode );
+                }
+            }
+        } else if( !dynamic_cast<ElectroMagnAM *>( EMfields ) ) {
             for( unsigned int ibin = 0 ; ibin < particles->first_index.size() ; ibin ++ ) { //Loop for projection on buffer_proj
                 double *b_rho = &( *EMfields->rho_ )( 0 );
 
@@ -1764,6 +1799,71 @@ void Species::computeCharge( ElectroMagn *EMfields, bool old /*=false*/ )
     }
 }//END computeCharge
 
+// -----------------------------------------------------------------------------
+//! Project the charge density of frozen particles. The density of a species
+//! that cannot be ionized does not change while it is frozen: it is projected
+//! once in a cache, which is then only added. The cache is discarded when
+//! particles are imported or when their number changes.
+// -----------------------------------------------------------------------------
+void Species::projectFrozenCharge( double *b_rho, unsigned int size )
+{
+    if( Ionize ) {
+        for( unsigned int ibin = 0 ; ibin < particles->first_index.size() ; ibin ++ ) {
+            for( int iPart=particles->first_index[ibin] ; iPart<particles->last_index[ibin]; iPart++ ) {
+                Proj->basic( b_rho, ( *particles ), iPart, 0 );
+            }
+        }
+        return;
+    }
+
+    if( frozen_rho_particles_ != ( int )getNbrOfParticles() || frozen_rho_.size() != size ) {
+        frozen_rho_.assign( size, 0. );
+        frozen_rho_AM_.clear();
+        for( unsigned int ibin = 0 ; ibin < particles->first_index.size() ; ibin ++ ) {
+            for( int iPart=particles->first_index[ibin] ; iPart<particles->last_index[ibin]; iPart++ ) {
+                Proj->basic( frozen_rho_.data(), ( *particles ), iPart, 0 );
+            }
+        }
+        frozen_rho_particles_ = getNbrOfParticles();
+    }
+
+    const double *const __restrict__ cache = frozen_rho_.data();
+    #pragma omp simd
+    for( unsigned int i=0 ; i<size ; i++ ) {
+        b_rho[i] += cache[i];
+    }
+}
+
+void Species::projectFrozenCharge( complex<double> *b_rho, unsigned int size, unsigned int imode, unsigned int nmodes )
+{
+    if( Ionize ) {
+        for( unsigned int ibin = 0 ; ibin < particles->first_index.size() ; ibin ++ ) {
+            for( int iPart=particles->first_index[ibin] ; iPart<particles->last_index[ibin]; iPart++ ) {
+                Proj->basicForComplex( b_rho, ( *particles ), iPart, 0, imode );
+            }
+        }
+        return;
+    }
+
+    if( frozen_rho_particles_ != ( int )getNbrOfParticles() || frozen_rho_AM_.size() != nmodes*size ) {
+        frozen_rho_AM_.assign( nmodes*size, 0. );
+        frozen_rho_.clear();
+        for( unsigned int jmode=0 ; jmode<nmodes ; jmode++ ) {
+            for( unsigned int ibin = 0 ; ibin < particles->first_index.size() ; ibin ++ ) {
+                for( int iPart=particles->first_index[ibin] ; iPart<particles->last_index[ibin]; iPart++ ) {
+                    Proj->basicForComplex( &frozen_rho_AM_[jmode*size], ( *particles ), iPart, 0, jmode );
+                }
+            }
+        }
+        frozen_rho_particles_ = getNbrOfParticles();
+    }
+
+    const complex<double> *const cache = &frozen_rho_AM_[imode*size];
+    for( unsigned int i=0 ; i<size ; i++ ) {
+        b_rho[i] += cache[i];
+    }
+}
+
 
 // ---------------------------------------------------------------------------------------------------------------------
 //! Sort particles
@@ -2007,6 +2107,10 @@ void Species::sortParticles( Params &params )
 
     //particles->cell_keys.resize( particles->size() );
     particles->resizeCellKeys(particles->size());
+
+    if( params.adaptive_sorting ) {
+        adaptiveSortParticlesInBins( params );
+    }
 #endif
 }
 
@@ -2093,9 +2197,185 @@ void Species::countSortParticles( Params &params )
 
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Index of the cell of particle ipart within its bin (x-major, x clamped to the bin)
+// ---------------------------------------------------------------------------------------------------------------------
+static inline unsigned int cellInBin( Particles &particles, unsigned int ipart, unsigned int ndim,
+                                      const double *min_loc, const double *dx_inv, const int *ncells )
+{
+    unsigned int key = 0;
+    for( unsigned int idim = 0 ; idim < ndim ; idim++ ) {
+        int i = ( int )std::floor( ( particles.position( idim, ipart ) - min_loc[idim] ) * dx_inv[idim] );
+        i = std::min( std::max( i, 0 ), ncells[idim]-1 );
+        key = key * ncells[idim] + i;
+    }
+    return key;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Fraction of the particles whose cell precedes the cell of the previous particle in their bin.
+//! It is 0 when each bin is sorted by cell and reaches about 1/2 when particles are randomly ordered.
+// ---------------------------------------------------------------------------------------------------------------------
+double Species::cellDisorder( Params &params )
+{
+    const unsigned int ndim = params.nDim_field;
+    int ncells[3] = { ( int )params.cluster_width_, 1, 1 };
+    for( unsigned int idim = 1 ; idim < ndim ; idim++ ) {
+        ncells[idim] = params.patch_size_[idim];
+    }
+
+    unsigned int ndescents = 0;
+    for( unsigned int ibin = 0 ; ibin < particles->numberOfBins() ; ibin++ ) {
+        double bin_min[3] = { min_loc + ibin*cluster_width_*cell_length[0], 0., 0. };
+        for( unsigned int idim = 1 ; idim < ndim ; idim++ ) {
+            bin_min[idim] = min_loc_vec[idim];
+        }
+        unsigned int previous = 0;
+        for( int ipart = particles->first_index[ibin] ; ipart < particles->last_index[ibin] ; ipart++ ) {
+            const unsigned int key = cellInBin( *particles, ipart, ndim, bin_min, dx_inv_, ncells );
+            ndescents += ( key < previous );
+            previous = key;
+        }
+    }
+
+    const unsigned int npart = getNbrOfParticles();
+    return npart > 0 ? ( double )ndescents / ( double )npart : 0.;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Stable counting sort of the particles of each bin by cell.
+//! The bins (first_index and last_index) are not modified.
+// ---------------------------------------------------------------------------------------------------------------------
+void Species::sortParticlesInBins( Params &params )
+{
+    const unsigned int ndim = params.nDim_field;
+    int ncells[3] = { ( int )params.cluster_width_, 1, 1 };
+    for( unsigned int idim = 1 ; idim < ndim ; idim++ ) {
+        ncells[idim] = params.patch_size_[idim];
+    }
+    const unsigned int ncells_bin = ncells[0]*ncells[1]*ncells[2];
+
+    const unsigned int npart = particles->numberOfParticles();
+    std::vector<size_t> order( npart );
+    std::vector<unsigned int> keys;
+    std::vector<unsigned int> cell_count( ncells_bin+1 );
+
+    for( unsigned int ibin = 0 ; ibin < particles->numberOfBins() ; ibin++ ) {
+        const int first = particles->first_index[ibin];
+        const int last  = particles->last_index[ibin];
+        double bin_min[3] = { min_loc + ibin*cluster_width_*cell_length[0], 0., 0. };
+        for( unsigned int idim = 1 ; idim < ndim ; idim++ ) {
+            bin_min[idim] = min_loc_vec[idim];
+        }
+
+        keys.resize( last - first );
+        std::fill( cell_count.begin(), cell_count.end(), 0 );
+        for( int ipart = first ; ipart < last ; ipart++ ) {
+            keys[ipart-first] = cellInBin( *particles, ipart, ndim, bin_min, dx_inv_, ncells );
+            cell_count[keys[ipart-first]+1]++;
+        }
+        for( unsigned int icell = 1 ; icell <= ncells_bin ; icell++ ) {
+            cell_count[icell] += cell_count[icell-1];
+        }
+        for( int ipart = first ; ipart < last ; ipart++ ) {
+            order[first + cell_count[keys[ipart-first]]++] = ipart;
+        }
+    }
+
+    // Gather the particles in the new order, then copy them back
+    Particles sorted;
+    sorted.initialize( 0, *particles );
+    particles->copyParticles( order, sorted, 0 );
+    sorted.overwriteParticle( 0, *particles, 0, npart );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Sort the particles of each bin by cell when their disorder exceeds a threshold.
+//! The threshold is tuned from the measured dynamics time: the dynamics time lost since the last sort
+//! (compared to the time measured right after it) is accumulated, and the disorder at which
+//! this loss reaches the cost of a sort becomes the new threshold.
+// ---------------------------------------------------------------------------------------------------------------------
+void Species::adaptiveSortParticlesInBins( Params &params )
+{
+    const unsigned int npart = getNbrOfParticles();
+    if( npart == 0 ) {
+        return;
+    }
+
+    // Time lost by the dynamics because of the disorder
+    if( dynamics_time_ >= 0. ) {
+        if( dynamics_time_sorted_ < 0. ) {
+            dynamics_time_sorted_ = dynamics_time_;
+        }
+        sort_lost_time_ += std::max( 0., dynamics_time_ - dynamics_time_sorted_ ) * npart;
+    }
+
+    const double disorder = cellDisorder( params );
+    const bool cost_triggered = ( sort_time_ > 0. ) && ( sort_lost_time_ > sort_time_ );
+
+    if( disorder > sort_disorder_threshold_ || cost_triggered ) {
+        if( cost_triggered ) {
+            // The disorder has cost as much as a sort
+            sort_disorder_threshold_ = disorder;
+        } else if( sort_time_ > 0. && sort_lost_time_ < 0.5 * sort_time_ ) {
+            // The sort is done too early
+            sort_disorder_threshold_ = std::min( 1., 1.25 * sort_disorder_threshold_ );
+        }
+
+        const double timer = MPI_Wtime();
+        sortParticlesInBins( params );
+        sort_time_ = MPI_Wtime() - timer;
+
+        sort_lost_time_ = 0.;
+        dynamics_time_sorted_ = -1.;
+    }
+}
+
 // Move all particles from another species to this one
+// -----------------------------------------------------------------------------
+//! Forecast the number of particles imported until the next cleaning of the
+//! overhead: linear extrapolation (least squares) of the numbers imported
+//! between the last cleanings. The previous forecast is compared to the
+//! particles actually imported to measure the overshoot and undershoot.
+// -----------------------------------------------------------------------------
+unsigned int Species::forecastImportedParticles( unsigned int history_length )
+{
+    forecast_overshoot_  = imported_particles_forecast_ > imported_particles_ ? imported_particles_forecast_ - imported_particles_ : 0;
+    forecast_undershoot_ = imported_particles_ > imported_particles_forecast_ ? imported_particles_ - imported_particles_forecast_ : 0;
+
+    imported_particles_history_.push_back( imported_particles_ );
+    if( imported_particles_history_.size() > history_length ) {
+        imported_particles_history_.erase( imported_particles_history_.begin() );
+    }
+    imported_particles_ = 0;
+
+    const unsigned int n = imported_particles_history_.size();
+    double mean = 0.;
+    for( unsigned int k=0 ; k<n ; k++ ) {
+        mean += imported_particles_history_[k];
+    }
+    mean /= n;
+    double slope = 0.;
+    if( n > 1 ) {
+        const double k_mean = 0.5 * ( n-1 );
+        double covariance = 0., variance = 0.;
+        for( unsigned int k=0 ; k<n ; k++ ) {
+            covariance += ( k - k_mean ) * ( imported_particles_history_[k] - mean );
+            variance   += ( k - k_mean ) * ( k - k_mean );
+        }
+        slope = covariance / variance;
+    }
+    const double forecast = mean + slope * ( n - 0.5 * ( n-1 ) );
+    imported_particles_forecast_ = forecast > 0. ? ( unsigned int )( forecast + 0.5 ) : 0;
+
+    return imported_particles_forecast_;
+}
+
 void Species::importParticles( Params &params, Patch *patch, Particles &source_particles, vector<Diagnostic *> &localDiags, double time_dual, Ionization *I )
 {
+    imported_particles_ += source_particles.size();
+    frozen_rho_particles_ = -1;
+
 #if defined( SMILEI_ACCELERATOR_GPU_OMP ) || defined( SMILEI_ACCELERATOR_GPU_OACC )
     // ---------------------------------------------------
     // GPU version
@@ -2113,7 +2393,6 @@ void Species::importParticles( Params &params, Patch *patch, Particles &source_p
 
 
     const unsigned int npart     = source_particles.size();
-    const unsigned int nbin      = particles->numberOfBins();
     const double inv_cell_length = 1./ params.cell_length[0];
 
     // If this species is tracked, set the particle IDs
@@ -2126,65 +2405,23 @@ void Species::importParticles( Params &params, Patch *patch, Particles &source_p
         birth_records_->update( source_particles, npart, time_dual, I );
     }
     
-    // Move particles
+    // Bin of each new particle
     vector<int> src_bin_keys( npart, 0 );
     for( unsigned int i=0; i<npart; i++ ) {
-        // Copy particle to the correct bin
         src_bin_keys[i] = source_particles.position( 0, i )*inv_cell_length - ( patch->getCellStartingGlobalIndex( 0 ) + params.oversize[0] );
         src_bin_keys[i] /= params.cluster_width_;
     }
 
-    vector<int> bin_count( nbin, 0 );
-    for( unsigned int ip=0; ip < npart ; ip++ )
-        bin_count[src_bin_keys[ip]] ++;
-
-    // sort new parts par bins
-    int istart = 0;
-    int istop  = bin_count[0];
-
-    for ( int ibin = 0 ; ibin < (int)nbin ; ibin++ ) {
-        if (bin_count[ibin]!=0) {
-            for( int ip=istart; ip < istop ; ip++ ) {
-                if ( src_bin_keys[ip] == ibin )
-                    continue;
-                else { // rearrange particles
-                    int ip_swap = istop;
-                    while (( src_bin_keys[ip_swap] != ibin ) && (ip_swap<(int)npart))
-                        ip_swap++;
-                    source_particles.swapParticle(ip, ip_swap);
-                    int tmp = src_bin_keys[ip];
-                    src_bin_keys[ip] = src_bin_keys[ip_swap];
-                    src_bin_keys[ip_swap] = tmp;
-                } // rearrange particles
-            } // end loop on particles of a cell
-
-            // inject in main data structure per cell
-            source_particles.copyParticles( istart, bin_count[ibin],
-                                        *particles,
-                                        particles->first_index[ibin] );
-            particles->last_index[ibin] += bin_count[ibin];
-            for ( unsigned int idx=ibin+1 ; idx<particles->last_index.size() ; idx++ ) {
-                particles->first_index[idx] += bin_count[ibin];
-                particles->last_index[idx]  += bin_count[ibin];
-            }
-
-        }
-        // update istart/istop fot the next cell
-        istart += bin_count[ibin];
-        if ( ibin != (int)nbin-1  )
-            istop  += bin_count[ibin+1];
-        else
-            istop = npart;
-
-    } // End cell loop
-    //particles->cell_keys.resize( particles->size() );
+    // Inject all particles at once at the beginning of their bins
+    source_particles.copyParticlesToBins( src_bin_keys, *particles );
     particles->resizeCellKeys( particles->size() );
 
     // Clear all particles
     source_particles.clear();
 
-    // Put capacity to 0 to save memory
-    source_particles.shrinkToFit(true);
+    // Keep the buffer for the next timestep if it produces as many particles,
+    // but release the memory when the production decreases
+    source_particles.reduceCapacity( npart );
 
 #endif
 
@@ -2437,6 +2674,11 @@ void Species::removeTaggedParticlesPerBin(
     // Total number of bins / cells
     const int nbin = particles->numberOfBins();
 
+#ifndef SMILEI_ACCELERATOR_GPU_OACC
+    // Move plan of the particle properties, applied once after the loop over the bins
+    std::vector<unsigned int> move_src, move_dest;
+#endif
+
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
     #pragma acc parallel  \
     present(Epart[0:nparts*3],\
@@ -2480,7 +2722,8 @@ void Species::removeTaggedParticlesPerBin(
                         // The last existing photon comes to the position of
                         // the deleted photon
 #ifndef SMILEI_ACCELERATOR_GPU_OACC
-                        particles->overwriteParticle( last_photon_index, ipart, compute_cell_keys );
+                        move_src.push_back( last_photon_index );
+                        move_dest.push_back( ipart );
 #else
                         weight[ipart] = weight[last_photon_index];
                         position_x[ipart] = position_x[last_photon_index];
@@ -2542,6 +2785,8 @@ void Species::removeTaggedParticlesPerBin(
 
 #ifdef SMILEI_ACCELERATOR_GPU_OACC
     } // end parallel region
+#else
+    particles->overwriteParticles( move_src, move_dest, compute_cell_keys );
 #endif
 }
 
@@ -2720,7 +2965,9 @@ void Species::removeTaggedParticles(
 bool Species::isProj( double time_dual, SimWindow *simWindow )
 {
 
-    return time_dual > time_frozen_  || ( simWindow->isMoving( time_dual ) || Ionize ) ;
+    // Frozen particles that cannot be ionized are left untouched, even when the window moves:
+    // their charge density is only needed by the diagnostics (see projectFrozenCharge)
+    return !isFrozen( time_dual );
 
     //Recompute frozen particles density if
     //moving window is activated, actually moving at this time step, and we are not in a density slope.
@@ -2758,6 +3005,23 @@ void Species::mergeParticles( double /*time_dual*/ )
 {
 }
 
+unsigned int Species::prepareMerging( double /*time_dual*/ )
+{
+    return 0;
+}
+
+void Species::mergeParticlesInCells( unsigned int /*first_cell*/, unsigned int /*last_cell*/ )
+{
+}
+
+void Species::finalizeMerging()
+{
+}
+
+void Species::splitParticles( Patch */*patch*/, std::vector<Diagnostic *> &/*localDiags*/, double /*time_dual*/ )
+{
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // For all particles of the species reacting to laser envelope
 //   - interpolate the fields at the particle position
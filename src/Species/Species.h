@@ -82,6 +82,13 @@ public:
     //! user defined ionization rate profile
     PyObject *ionization_rate_;
 
+    //! user defined ionization rates for each charge state, versus the field magnitude (tabulated ionization)
+    std::vector<std::vector<double> > ionization_rate_table_;
+    //! range of the field magnitude of the ionization rate tables [code units]
+    std::vector<double> ionization_table_field_range_;
+    //! number of points of the ionization rate tables computed from the ADK formula
+    unsigned int ionization_table_size_;
+
     //! thermalizing temperature for thermalizing BCs [\f$m_e c^2\f$]
     std::vector<double> thermal_boundary_temperature_;
     //! mean velocity used when thermalizing BCs are used [\f$c\f$]
@@ -101,9 +108,62 @@ public:
     //! Time for which the species is frozen
     double time_frozen_;
 
+    //! Number of iterations between two pushes (sub-cycling of heavy species, 1 by default)
+    unsigned int push_every_;
+
+    //! Timestep of the simulation, to find the iterations of the push
+    double timestep_;
+
     //! logical true if particles radiate
     bool radiating_;
 
+    //! logical true if the vectorized dynamics process each cell from interpolation to projection in a row
+    bool fused_dynamics_;
+
+    //! logical true if the continuous radiation reaction is applied within the Boris pusher loop
+    bool fused_radiation_;
+
+    //! Number of particles moved by the last sort per cell
+    unsigned int sort_moved_particles_;
+
+    //! Number of particles after the last sort per cell (0 if the species is not sorted per cell)
+    unsigned int sort_particles_;
+
+    //! Adaptive in-bin sorting: disorder above which the particles of each bin are sorted by cell
+    double sort_disorder_threshold_;
+
+    //! Adaptive in-bin sorting: duration of the last in-bin sort
+    double sort_time_;
+
+    //! Adaptive in-bin sorting: time of the dynamics per particle, last measured and right after a sort (<0 if unknown)
+    double dynamics_time_;
+    double dynamics_time_sorted_;
+
+    //! Adaptive in-bin sorting: dynamics time lost since the last sort, estimated from dynamics_time_sorted_
+    double sort_lost_time_;
+
+    //! Number of particles imported (ionization, radiation, pair creation, injection) since the last cleaning of the overhead
+    unsigned int imported_particles_;
+
+    //! Numbers of particles imported between the last cleanings of the overhead, oldest first
+    std::vector<unsigned int> imported_particles_history_;
+
+    //! Number of imported particles forecast at the last cleaning of the overhead
+    unsigned int imported_particles_forecast_;
+
+    //! Particles forecast in excess / missing at the last cleaning of the overhead
+    unsigned int forecast_overshoot_;
+    unsigned int forecast_undershoot_;
+
+    //! Charge density of the frozen particles, projected once (cartesian geometries)
+    std::vector<double> frozen_rho_;
+
+    //! Charge density of the frozen particles, projected once (all modes in AM geometry)
+    std::vector<std::complex<double>> frozen_rho_AM_;
+
+    //! Number of particles when the frozen charge density was cached (-1 if no cache)
+    int frozen_rho_particles_;
+
     //! logical true if particles are relativistic and require proper electromagnetic field initialization
     bool relativistic_field_initialization_;
 
@@ -188,6 +248,9 @@ public:
     //! is not generated but directly added to the energy scalar diags
     //! This enable to limit emission of useless low-energy photons
     double radiation_photon_gamma_threshold_;
+    //! Threshold on the photon Lorentz factor under which the photon is merged
+    //! in the last macro-photons emitted by the same particle during the timestep
+    double radiation_photon_merging_threshold_;
     //! Particles object to store emitted photons by radiation at each time step
     Particles * radiated_photons_ = nullptr;
 
@@ -297,6 +360,37 @@ public:
     //! Minimum momentum value in log scale
     double merge_min_momentum_log_scale_;
 
+    //! Target number of macro-particles per cell of the budget-driven merging (0 if disabled)
+    unsigned int merge_target_particles_per_cell_;
+
+    //! Memory budget of the macro-particles of the species on each MPI process, in MB (0 if disabled)
+    double merge_memory_budget_;
+
+    //! Target number of macro-particles per cell of the current merging (0 if none)
+    unsigned int merging_target_;
+
+    //! Number of macro-particles removed by the last merging
+    unsigned int merged_particles_;
+
+    //! Flag indicating whether the particle splitting is activated
+    bool has_splitting_;
+
+    //! Time selection for the particle splitting
+    TimeSelection *splitting_time_selection_;
+
+    //! Cells with less particles than this number are split
+    unsigned int split_max_particles_per_cell_;
+
+    //! Number of particles replacing a split particle
+    unsigned int split_factor_;
+
+    //! Number of macro-particles created by the last splitting
+    unsigned int split_particles_;
+
+    //! Mask of the particles to keep and seeds of the random generators of the cells, during the merging
+    std::vector<int> merging_mask_;
+    std::vector<unsigned int> merging_seeds_;
+
     //! Local minimum of MPI domain
     double min_loc;
 
@@ -352,6 +446,9 @@ public:
     //! Initialize operators (must be separate from parameters init, because of cloning)
     void initOperators( Params &, Patch * );
 
+    //! Select the variant of the dynamics compiled for the types of the operators (called by initOperators)
+    virtual void initDynamicsVariant() {};
+
     //! Method returning the Particle list for the considered Species
     inline Particles getParticlesList() const
     {
@@ -370,6 +467,16 @@ public:
         return particles->numberOfParticles();
     }
 
+    //! Forecast the number of particles imported until the next cleaning of the overhead
+    //! from the last `history_length` cleanings, and update the forecast errors
+    unsigned int forecastImportedParticles( unsigned int history_length );
+
+    //! Load of the particles for the load balancing, in number of particles
+    virtual double getParticleLoad()
+    {
+        return getNbrOfParticles();
+    }
+
     //! Method returning the size of Particles
     inline unsigned int getParticlesSize() const
     {
@@ -478,9 +585,48 @@ public:
     //! Method performing the merging of particles
     virtual void mergeParticles( double time_dual );
 
+    //! First step of the merging: returns the number of cells to merge (0 if none)
+    virtual unsigned int prepareMerging( double time_dual );
+
+    //! Second step of the merging, for the cells first_cell to last_cell-1:
+    //! the cells of a patch may be merged by different threads
+    virtual void mergeParticlesInCells( unsigned int first_cell, unsigned int last_cell );
+
+    //! Last step of the merging: removal of the merged particles
+    virtual void finalizeMerging();
+
+    //! Method performing the splitting of the particles of the cells with few particles
+    virtual void splitParticles( Patch *patch, std::vector<Diagnostic *> &localDiags, double time_dual );
+
 
     //! Method calculating the Particle charge on the grid (projection)
-    virtual void computeCharge( ElectroMagn *EMfields, bool old=false );
+    virtual void computeCharge( ElectroMagn *EMfields, bool old=false, bool frozen=false );
+
+    //! True if the particles neither move nor change: no dynamics, exchange nor sort are needed
+    inline bool isFrozen( double time_dual ) const
+    {
+        return ( time_dual <= time_frozen_ || !isPushIteration( time_dual ) ) && !Ionize;
+    }
+
+    //! True if the fields are interpolated at the particle positions: photons move in straight lines,
+    //! and only need them for the Breit-Wheeler process or the diagnostics of the interpolated fields
+    inline bool gathersFields() const
+    {
+        return mass_ > 0 || Ionize || Multiphoton_Breit_Wheeler_process || particles->interpolated_fields_;
+    }
+
+    //! True at the iterations where the particles are pushed, i.e. every push_every_ iterations
+    //! (time_dual = (itime+0.5) timestep at the iteration itime)
+    inline bool isPushIteration( double time_dual ) const
+    {
+        return push_every_ == 1 || ( ( unsigned int )( time_dual / timestep_ ) ) % push_every_ == 0;
+    }
+
+    //! Add the charge density of the frozen particles to b_rho (`size` points), from the cache if valid
+    void projectFrozenCharge( double *b_rho, unsigned int size );
+
+    //! Add the charge density of the frozen particles to b_rho, mode `imode` of `nmodes` (AM geometry)
+    void projectFrozenCharge( std::complex<double> *b_rho, unsigned int size, unsigned int imode, unsigned int nmodes );
 
     //! Method used to inject and sort particles
     virtual void sortParticles( Params &param );
@@ -508,6 +654,15 @@ public:
     //! Counting sort method for particles
     void countSortParticles( Params &param );
 
+    //! Fraction of the particles whose cell precedes the cell of the previous particle in their bin
+    double cellDisorder( Params &params );
+
+    //! Sort the particles of each bin by cell, keeping the bins unchanged
+    void sortParticlesInBins( Params &params );
+
+    //! Sort the particles of each bin when their disorder costs more than the sort itself
+    void adaptiveSortParticlesInBins( Params &params );
+
     //!
     virtual void addSpaceForOneParticle()
     {
@@ -533,6 +688,14 @@ public:
         return nrj;
     }
 
+    //! Memory of one macro-particle (bytes)
+    inline std::size_t getParticleMemory()
+    {
+        return particles->double_prop_.size()*sizeof( double )
+               + particles->short_prop_.size()*sizeof( short )
+               + particles->uint64_prop_.size()*sizeof( uint64_t );
+    }
+
     inline std::size_t getMemFootPrint()
     {
         /*int speciesSize  = ( 2*nDim_particle + 3 + 1 )*sizeof(double) + sizeof(short);
@@ -169,12 +169,17 @@ public:
                 }
                 // Photon energy threshold
                 PyTools::extract( "radiation_photon_gamma_threshold", this_species->radiation_photon_gamma_threshold_, "Species", ispec );
+                // Photon energy threshold for merging
+                PyTools::extract( "radiation_photon_merging_threshold", this_species->radiation_photon_merging_threshold_, "Species", ispec );
                 // Output
                 MESSAGE( 3, "| Macro-photon emission activated" );
                 MESSAGE( 3, "| Emitted photon species set to `" << this_species->radiation_photon_species << "`" );
                 MESSAGE( 3, "| Number of macro-photons emitted per MC event: " << this_species->radiation_photon_sampling_ );
                 MESSAGE( 3, "| Maximum number of emissions per MC event: " << this_species->radiation_max_emissions_ );
                 MESSAGE( 3, "| Photon energy threshold for macro-photon emission: " << this_species->radiation_photon_gamma_threshold_ );
+                if( this_species->radiation_photon_merging_threshold_ > 0. ) {
+                    MESSAGE( 3, "| Photon energy threshold for merging with the previous macro-photon: " << this_species->radiation_photon_merging_threshold_ );
+                }
             // else, no emitted macro-photons
             } else {
                 MESSAGE( 3, "| Macro-photon emission not activated" );
@@ -304,6 +309,17 @@ public:
                 ERROR_NAMELIST( "For species `" << species_name << "` merge_min_momentum should be > 0",
                     LINK_NAMELIST + std::string("#particle-merging") );
             }
+            // Budget-driven merging: target number of particles per cell and memory budget
+            PyTools::extract( "merge_target_particles_per_cell", this_species->merge_target_particles_per_cell_ , "Species", ispec );
+            if( this_species->merge_target_particles_per_cell_ > 0 && this_species->merge_target_particles_per_cell_ < 4 ) {
+                ERROR_NAMELIST( "For species `" << species_name << "` merge_target_particles_per_cell must be 0 or >= 4",
+                    LINK_NAMELIST + std::string("#particle-merging") );
+            }
+            PyTools::extract( "merge_memory_budget", this_species->merge_memory_budget_ , "Species", ispec );
+            if( this_species->merge_memory_budget_ < 0 ) {
+                ERROR_NAMELIST( "For species `" << species_name << "` merge_memory_budget must be >= 0",
+                    LINK_NAMELIST + std::string("#particle-merging") );
+            }
             // We activate the merging
             this_species->has_merging_ = true;
             // Output
@@ -332,6 +348,35 @@ public:
             MESSAGE( 3, "| Minimum particle number per cell: " << std::fixed << this_species->merge_min_particles_per_cell_ );
             MESSAGE( 3, "| Minimum particle packet size: " << this_species->merge_min_packet_size_ );
             MESSAGE( 3, "| Maximum particle packet size: " << this_species->merge_max_packet_size_ );
+            if( this_species->merge_target_particles_per_cell_ > 0 ) {
+                MESSAGE( 3, "| Target particle number per cell: " << this_species->merge_target_particles_per_cell_ );
+            }
+            if( this_species->merge_memory_budget_ > 0 ) {
+                MESSAGE( 3, "| Memory budget per MPI process: " << this_species->merge_memory_budget_ << " MB" );
+            }
+        }
+
+        // Particle splitting
+        PyTools::extract( "split_max_particles_per_cell", this_species->split_max_particles_per_cell_, "Species", ispec );
+        if( this_species->split_max_particles_per_cell_ > 0 ) {
+            // get parameter "every" which describes a timestep selection
+            if( !this_species->splitting_time_selection_ ) {
+                this_species->splitting_time_selection_ = new TimeSelection(
+                    PyTools::extract_py( "split_every", "Species", ispec ), "Particle splitting"
+                );
+            }
+            PyTools::extract( "split_factor", this_species->split_factor_, "Species", ispec );
+            if( this_species->split_factor_ < 2 ) {
+                ERROR_NAMELIST( "For species `" << species_name << "` split_factor must be >= 2",
+                    LINK_NAMELIST + std::string("#particle-splitting") );
+            }
+            // We activate the splitting
+            this_species->has_splitting_ = true;
+            // Output
+            MESSAGE( 2, "> Particle splitting" );
+            MESSAGE( 3, "| Splitting time selection: " << this_species->splitting_time_selection_->info() );
+            MESSAGE( 3, "| Split cells with less than " << this_species->split_max_particles_per_cell_ << " particles" );
+            MESSAGE( 3, "| Particles per split particle: " << this_species->split_factor_ );
         }
 
         // Position initialization
@@ -771,6 +816,20 @@ public:
                         ERROR_NAMELIST("An envelope ionization model has been selected but no envelope is present",
                         LINK_NAMELIST + std::string("#laser-envelope-model"));
                     }
+                    // Optional tables of the averaged rates
+                    if( PyTools::extractV( "ionization_table_field_range", this_species->ionization_table_field_range_, "Species", ispec ) ) {
+                        if( this_species->ionization_table_field_range_.size() != 2
+                         || this_species->ionization_table_field_range_[0] <= 0.
+                         || this_species->ionization_table_field_range_[1] <= this_species->ionization_table_field_range_[0] ) {
+                            ERROR_NAMELIST( "For species '" << species_name << "': ionization_table_field_range must be [Emin, Emax] with 0 < Emin < Emax",
+                            LINK_NAMELIST + std::string("#species") );
+                        }
+                        PyTools::extract( "ionization_table_size", this_species->ionization_table_size_, "Species", ispec );
+                        if( this_species->ionization_table_size_ < 2 ) {
+                            ERROR_NAMELIST( "For species '" << species_name << "': ionization_table_size must be at least 2",
+                            LINK_NAMELIST + std::string("#species") );
+                        }
+                    }
 
                 }else if( model == "from_rate" ) {
 
@@ -795,6 +854,56 @@ public:
 #endif
                     }
 
+                } else if( model == "tabulated" ) {
+
+                    if( params.Laser_Envelope_model ) {
+                        ERROR_NAMELIST( "An envelope is present, so tunnel_envelope_averaged ionization model should be selected for species "<<species_name,
+                        LINK_NAMELIST + std::string("#laser-envelope-model") );
+                    }
+                    PyTools::extractVV( "ionization_rate_table", this_species->ionization_rate_table_, "Species", ispec );
+                    if( this_species->ionization_rate_table_.empty() ) {
+                        if( this_species->atomic_number_ == 0 ) {
+                            ERROR_NAMELIST( "For species '" << species_name << "': ionization 'tabulated' requires 'atomic_number' or 'ionization_rate_table'",
+                            LINK_NAMELIST + std::string("#species") );
+                        }
+                        PyTools::extract( "ionization_table_size", this_species->ionization_table_size_, "Species", ispec );
+                        if( this_species->ionization_table_size_ < 2 ) {
+                            ERROR_NAMELIST( "For species '" << species_name << "': ionization_table_size must be at least 2",
+                            LINK_NAMELIST + std::string("#species") );
+                        }
+                    } else {
+                        if( this_species->maximum_charge_state_ == 0 ) {
+                            this_species->maximum_charge_state_ = this_species->atomic_number_;
+                        }
+                        if( this_species->ionization_rate_table_.size() != this_species->maximum_charge_state_ ) {
+                            ERROR_NAMELIST( "For species '" << species_name << "': ionization_rate_table must have one row per charge state (maximum_charge_state = "
+                                << this_species->maximum_charge_state_ << ")",
+                            LINK_NAMELIST + std::string("#species") );
+                        }
+                        for( unsigned int Z=0; Z<this_species->ionization_rate_table_.size(); Z++ ) {
+                            if( this_species->ionization_rate_table_[Z].size() != this_species->ionization_rate_table_[0].size()
+                             || this_species->ionization_rate_table_[Z].size() < 2 ) {
+                                ERROR_NAMELIST( "For species '" << species_name << "': all rows of ionization_rate_table must have the same number of points (at least 2)",
+                                LINK_NAMELIST + std::string("#species") );
+                            }
+                        }
+                    }
+                    if( ! PyTools::extractV( "ionization_table_field_range", this_species->ionization_table_field_range_, "Species", ispec ) ) {
+                        if( ! this_species->ionization_rate_table_.empty() ) {
+                            ERROR_NAMELIST( "For species '" << species_name << "': ionization_rate_table requires ionization_table_field_range",
+                            LINK_NAMELIST + std::string("#species") );
+                        }
+                        // By default, from 1e-3 to 1e5 atomic units
+                        double EC_to_au = 3.314742578e-15 * params.reference_angular_frequency_SI;
+                        this_species->ionization_table_field_range_ = { 1e-3 / EC_to_au, 1e5 / EC_to_au };
+                    }
+                    if( this_species->ionization_table_field_range_.size() != 2
+                     || this_species->ionization_table_field_range_[0] <= 0.
+                     || this_species->ionization_table_field_range_[1] <= this_species->ionization_table_field_range_[0] ) {
+                        ERROR_NAMELIST( "For species '" << species_name << "': ionization_table_field_range must be [Emin, Emax] with 0 < Emin < Emax",
+                        LINK_NAMELIST + std::string("#species") );
+                    }
+
                 } else if( model != "none" ) {
                     ERROR_NAMELIST( "For species " << species_name << ": unknown ionization model `" << model,
                     LINK_NAMELIST + std::string("#species") );
@@ -962,6 +1071,52 @@ public:
             }
         }
 
+        // Fused interpolation, push and projection of each cell
+        PyTools::extract( "fused_dynamics", this_species->fused_dynamics_, "Species", ispec );
+        if( this_species->fused_dynamics_ ) {
+            if( params.vectorization_mode != "on" || params.gpu_computing || params.omptasks ) {
+                ERROR_NAMELIST( "For species '" << species_name << "', fused_dynamics requires Vectorization.mode = 'on' on CPU, without OpenMP tasks",
+                LINK_NAMELIST + std::string("#fused_dynamics") );
+            }
+            if( params.geometry == "AMcylindrical" ) {
+                ERROR_NAMELIST( "For species '" << species_name << "', fused_dynamics is not available in AMcylindrical geometry",
+                LINK_NAMELIST + std::string("#fused_dynamics") );
+            }
+            if( this_species->mass_ <= 0 || this_species->ionization_model_ != "none" || this_species->radiating_
+                || this_species->particles->interpolated_fields_ ) {
+                ERROR_NAMELIST( "For species '" << species_name << "', fused_dynamics is not compatible with photons, ionization, radiation or keep_interpolated_fields",
+                LINK_NAMELIST + std::string("#fused_dynamics") );
+            }
+        }
+
+        // Continuous radiation reaction applied within the pusher loop
+        PyTools::extract( "fused_radiation", this_species->fused_radiation_, "Species", ispec );
+        if( this_species->fused_radiation_ ) {
+            if( this_species->radiation_model_ != "ll" && this_species->radiation_model_ != "cll" && this_species->radiation_model_ != "niel" ) {
+                ERROR_NAMELIST( "For species '" << species_name << "', fused_radiation requires the radiation_model 'll', 'cll' or 'Niel'",
+                LINK_NAMELIST + std::string("#fused_radiation") );
+            }
+            if( this_species->pusher_name_ != "boris" ) {
+                ERROR_NAMELIST( "For species '" << species_name << "', fused_radiation requires the pusher 'boris'",
+                LINK_NAMELIST + std::string("#fused_radiation") );
+            }
+            if( params.gpu_computing || params.omptasks ) {
+                ERROR_NAMELIST( "For species '" << species_name << "', fused_radiation is not available on GPU or with OpenMP tasks",
+                LINK_NAMELIST + std::string("#fused_radiation") );
+            }
+            MESSAGE( 2, "> Radiation reaction fused with the pusher" );
+        }
+
+        // Sub-cycled push, with the fields averaged since the previous push (checked with the other species in Params)
+        PyTools::extract( "push_every", this_species->push_every_, "Species", ispec );
+        if( this_species->push_every_ > 1 ) {
+            if( this_species->mass_ <= 0 || this_species->ionization_model_ != "none" || this_species->radiating_ ) {
+                ERROR_NAMELIST( "For species '" << species_name << "', push_every > 1 is not compatible with photons, ionization or radiation",
+                LINK_NAMELIST + std::string("#push_every") );
+            }
+            MESSAGE( 2, "> Species pushed every " << this_species->push_every_ << " iterations with averaged fields" );
+        }
+
         // Extract test Species flag
         PyTools::extract( "is_test", this_species->particles->is_test, "Species", ispec );
 
@@ -1000,10 +1155,13 @@ public:
         new_species->name_                                     = species->name_;
         new_species->pusher_name_                              = species->pusher_name_;
         new_species->radiation_model_                          = species->radiation_model_;
+        new_species->fused_dynamics_                           = species->fused_dynamics_;
+        new_species->fused_radiation_                          = species->fused_radiation_;
         new_species->radiation_photon_species                  = species->radiation_photon_species;
         new_species->radiation_photon_sampling_                = species->radiation_photon_sampling_;
         new_species->radiation_max_emissions_                  = species->radiation_max_emissions_;
         new_species->radiation_photon_gamma_threshold_         = species->radiation_photon_gamma_threshold_;
+        new_species->radiation_photon_merging_threshold_       = species->radiation_photon_merging_threshold_;
         new_species->photon_species_                           = species->photon_species_;
         new_species->species_number_                           = species->species_number_;
         new_species->position_initialization_on_species_       = species->position_initialization_on_species_;
@@ -1019,6 +1177,7 @@ public:
         new_species->c_part_max_                               = species->c_part_max_;
         new_species->mass_                                     = species->mass_;
         new_species->time_frozen_                              = species->time_frozen_;
+        new_species->push_every_                               = species->push_every_;
         new_species->radiating_                                = species->radiating_;
         new_species->relativistic_field_initialization_        = species->relativistic_field_initialization_;
         new_species->iter_relativistic_initialization_         = species->iter_relativistic_initialization_;
@@ -1033,6 +1192,9 @@ public:
         if( new_species->ionization_rate_!=Py_None ) {
             Py_INCREF( new_species->ionization_rate_ );
         }
+        new_species->ionization_rate_table_                    = species->ionization_rate_table_;
+        new_species->ionization_table_field_range_             = species->ionization_table_field_range_;
+        new_species->ionization_table_size_                    = species->ionization_table_size_;
         new_species->ionization_model_                        = species->ionization_model_;
         new_species->geometry                                 = species->geometry;
         new_species->Nbins                                    = species->Nbins;
@@ -1054,6 +1216,12 @@ public:
         new_species->merge_min_particles_per_cell_            = species->merge_min_particles_per_cell_;
         new_species->merge_min_packet_size_                   = species->merge_min_packet_size_;
         new_species->merge_max_packet_size_                   = species->merge_max_packet_size_;
+        new_species->merge_target_particles_per_cell_         = species->merge_target_particles_per_cell_;
+        new_species->merge_memory_budget_                     = species->merge_memory_budget_;
+        new_species->has_splitting_                           = species->has_splitting_;
+        new_species->splitting_time_selection_                = species->splitting_time_selection_;
+        new_species->split_max_particles_per_cell_            = species->split_max_particles_per_cell_;
+        new_species->split_factor_                            = species->split_factor_;
         new_species->merge_accumulation_correction_           = species->merge_accumulation_correction_;
         new_species->merge_momentum_cell_size_[0]             = species->merge_momentum_cell_size_[0];
         new_species->merge_momentum_cell_size_[1]             = species->merge_momentum_cell_size_[1];
@@ -1103,7 +1271,7 @@ public:
         }
         
         if( species->birth_records_ ) {
-            new_species->birth_records_ = new BirthRecords( *species->particles );
+            new_species->birth_records_ = new BirthRecords( *species->particles, species->birth_records_->record_every_, species->birth_records_->nrecords_ );
         }
         
         return new_species;
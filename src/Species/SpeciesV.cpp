@@ -25,6 +25,12 @@
 #include "Projector.h"
 #include "ProjectorFactory.h"
 
+#include "Interpolator2D2OrderV.h"
+#include "Interpolator3D2OrderV.h"
+#include "Projector2D2OrderV.h"
+#include "Projector3D2OrderV.h"
+#include "PusherBoris.h"
+
 #include "SimWindow.h"
 #include "Patch.h"
 
@@ -35,6 +41,10 @@
 #include "Tools.h"
 
 #include "DiagnosticTrack.h"
+#include "Hilbert_functions.h"
+
+#include <algorithm>
+#include <typeinfo>
 
 using namespace std;
 
@@ -44,7 +54,10 @@ using namespace std;
 // input: simulation parameters & Species index
 // ---------------------------------------------------------------------------------------------------------------------
 SpeciesV::SpeciesV( Params &params, Patch *patch ) :
-    Species( params, patch )
+    Species( params, patch ),
+    Interp_scalar_( NULL ),
+    Proj_scalar_( NULL ),
+    fused_cells_( &SpeciesV::fusedCells<Interpolator, Pusher, Projector> )
 {
     initCluster( params, patch );
     npack_ = 0 ;
@@ -103,6 +116,8 @@ SpeciesV::SpeciesV( Params &params, Patch *patch ) :
 // ---------------------------------------------------------------------------------------------------------------------
 SpeciesV::~SpeciesV()
 {
+    delete Interp_scalar_;
+    delete Proj_scalar_;
 }
 
 
@@ -116,6 +131,13 @@ void SpeciesV::initCluster( Params &params, Patch *patch )
     particles->first_index.resize( ncells, 0 );
     count.resize( ncells, 0 );
 
+    if( params.cell_ordering != "lexicographic" ) {
+        initCellOrdering( params );
+    }
+    if( params.colored_deposition ) {
+        initColoredDeposition( params );
+    }
+
     //Size in each dimension of the buffers on which each bin are projected
     //In 1D the particles of a given bin can be projected on 6 different nodes at the second order (oversize = 2)
 
@@ -246,10 +268,6 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 
     const int ithread = Tools::getOMPThreadNum();
 
-#ifdef  __DETAILED_TIMERS
-    double timer;
-#endif
-
     bool diag_PartEventTracing {false};
 
 # ifdef _PARTEVENTTRACING
@@ -284,52 +302,51 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
         //Still needed for ionization
         vector<double> *Epart = &( smpi->dynamics_Epart[ithread] );
 
-        // Prepare particles buffers for multiphoton Breit-Wheeler
-        if( Multiphoton_Breit_Wheeler_process ) {
+        // The pairs of the multiphoton Breit-Wheeler process are reserved by its operator, buffer by buffer
 
-#ifdef  __DETAILED_TIMERS
-            timer = MPI_Wtime();
-#endif
 
-            mBW_pair_particles_[0]->reserve(particles->size() * Multiphoton_Breit_Wheeler_process->getPairCreationSampling(0));
-            mBW_pair_particles_[1]->reserve(particles->size() * Multiphoton_Breit_Wheeler_process->getPairCreationSampling(1));
+        for( unsigned int ipack = 0 ; ipack < npack_ ; ipack++ ) {
 
-#ifdef  __DETAILED_TIMERS
-            patch->patch_timers_[0] += MPI_Wtime() - timer;
-#endif
+            int start = particles->first_index[ipack*packsize_], stop = particles->last_index[( ipack+1 ) * packsize_-1 ], nparts_in_pack = stop - start;
+            smpi->resizeBuffers( ithread, nDim_field, nparts_in_pack, params.geometry=="AMcylindrical" );
 
-        }
+            // Fused dynamics: each cell goes through interpolation, push, boundary conditions,
+            // cell keys and projection in a row, while its particles are still in cache
+            if( fused_dynamics_ ) {
 
+                patch->startFineTimer( push_timer_id_ );
 
-        for( unsigned int ipack = 0 ; ipack < npack_ ; ipack++ ) {
+                ( this->*fused_cells_ )( ipack, ispec, EMfields, params, diag_flag, partWalls, patch, smpi, ithread, nrj_lost_per_thd[tid] );
 
-            int start = particles->first_index[ipack*packsize_], stop = particles->last_index[( ipack+1 ) * packsize_-1 ], nparts_in_pack = stop - start;
-            smpi->resizeBuffers( ithread, nDim_field, nparts_in_pack, params.geometry=="AMcylindrical" );
+                // The whole fused loop is accounted in the pusher timer
+                patch->stopFineTimer( push_timer_id_ );
 
-#ifdef  __DETAILED_TIMERS
-            timer = MPI_Wtime();
-#endif
+                for( unsigned int ithd=0 ; ithd<nrj_lost_per_thd.size() ; ithd++ ) {
+                    nrj_bc_lost += nrj_lost_per_thd[tid];
+                }
+                continue;
+            } // end fused dynamics
+
+            patch->startFineTimer( interpolation_timer_id_ );
 
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 0,0);
             // Interpolate the fields at the particle position
-            for( unsigned int scell = 0 ; scell < packsize_ ; scell++ ){
-                Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ipack*packsize_+scell] ),
-                                       &( particles->last_index[ipack*packsize_+scell] ),
-                                       ithread, scell, particles->first_index[ipack*packsize_] );
+            if( gathersFields() ) {
+                for( unsigned int scell = 0 ; scell < packsize_ ; scell++ ){
+                    cellInterpolator( ipack*packsize_+scell )->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ipack*packsize_+scell] ),
+                                           &( particles->last_index[ipack*packsize_+scell] ),
+                                           ithread, scell, particles->first_index[ipack*packsize_] );
+                }
             } // end interpolation
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,0);
 
-#ifdef  __DETAILED_TIMERS
-            patch->patch_timers_[0] += MPI_Wtime() - timer;
-#endif
+            patch->stopFineTimer( interpolation_timer_id_ );
 
 
             // Ionization
             if( Ionize ) {
-#ifdef  __DETAILED_TIMERS
-                timer = MPI_Wtime();
-#endif
+                patch->startFineTimer( ionization_timer_id_ );
 
                 smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,0,5);
                 for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
@@ -337,9 +354,7 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
                 }
                 smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,5);
 
-#ifdef  __DETAILED_TIMERS
-                patch->patch_timers_[4] += MPI_Wtime() - timer;
-#endif
+                patch->stopFineTimer( ionization_timer_id_ );
             } // end ionization
 
             if ( time_dual <= time_frozen_ ) continue;
@@ -349,11 +364,9 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
                 count[i] = 0;
             }
 
-            // Radiation losses
-            if( Radiate ) {
-#ifdef  __DETAILED_TIMERS
-                timer = MPI_Wtime();
-#endif
+            // Radiation losses (applied by the pusher if fused)
+            if( Radiate && !fused_radiation_ ) {
+                patch->startFineTimer( radiation_timer_id_ );
 
                 // for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
                 //
@@ -387,16 +400,12 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
                 }
                 smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,6);
 
-#ifdef  __DETAILED_TIMERS
-                patch->patch_timers_[5] += MPI_Wtime() - timer;
-#endif
+                patch->stopFineTimer( radiation_timer_id_ );
             } // end radiation
 
             // Multiphoton Breit-Wheeler
             if( Multiphoton_Breit_Wheeler_process ) {
-#ifdef  __DETAILED_TIMERS
-                timer = MPI_Wtime();
-#endif
+                patch->startFineTimer( mBW_timer_id_ );
 
                 // for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
                     // Pair generation process
@@ -464,14 +473,10 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 
                 smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,7);
 
-#ifdef  __DETAILED_TIMERS
-                patch->patch_timers_[6] += MPI_Wtime() - timer;
-#endif
+                patch->stopFineTimer( mBW_timer_id_ );
             } // End multiphoton Breit-Wheeler
 
-#ifdef  __DETAILED_TIMERS
-            timer = MPI_Wtime();
-#endif
+            patch->startFineTimer( push_timer_id_ );
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,0,1);
     
@@ -482,8 +487,13 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
             
             // for( unsigned int scell = 0 ; scell < packsize_ ; scell++ ){
                 // Push the particles and the photons
-            ( *Push )( *particles, smpi, start, stop,
-                       ithread, particles->first_index[ipack*packsize_] );
+            if( fused_radiation_ ) {
+                Push->pushWithRadiation( *particles, smpi, RadiationTables, nrj_radiated_, start, stop,
+                                         ithread, particles->first_index[ipack*packsize_] );
+            } else {
+                ( *Push )( *particles, smpi, start, stop,
+                           ithread, particles->first_index[ipack*packsize_] );
+            }
             
             // Copy interpolated fields to persistent buffers if requested
             if( particles->interpolated_fields_ ) {
@@ -494,10 +504,8 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 
             // }
 
-#ifdef  __DETAILED_TIMERS
-            patch->patch_timers_[1] += MPI_Wtime() - timer;
-            timer = MPI_Wtime();
-#endif
+            patch->stopFineTimer( push_timer_id_ );
+            patch->startFineTimer( cell_keys_timer_id_ );
 
             // Boundary conditions and energy lost
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,0,2);
@@ -586,32 +594,48 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,11);
             //START EXCHANGE PARTICLES OF THE CURRENT BIN ?
 
-#ifdef  __DETAILED_TIMERS
-            patch->patch_timers_[3] += MPI_Wtime() - timer;
-#endif
+            patch->stopFineTimer( cell_keys_timer_id_ );
 
             // Project currents if not a Test species and charges as well if a diag is needed.
             // Do not project if a photon
             if( ( !particles->is_test ) && ( mass_ > 0 ) ){
-#ifdef  __DETAILED_TIMERS
-                timer = MPI_Wtime();
-#endif
+                patch->startFineTimer( projection_timer_id_ );
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,0,3);
-            for( unsigned int scell = 0 ; scell < packsize_ ; scell++ )
-                Proj->currentsAndDensityWrapper(
-                    EMfields, *particles, smpi, particles->first_index[ipack*packsize_+scell],
-                    particles->last_index[ipack*packsize_+scell],
-                    ithread,
-                    diag_flag, params.is_spectral,
-                    ispec, ipack*packsize_+scell, particles->first_index[ipack*packsize_]
-                );
+            if( !colored_cells_.empty() && npack_ == 1 ) {
+                // The blocks of a color share no node: they are projected concurrently,
+                // directly in the patch fields, by the threads idle in the patch loop.
+                // The thread buffers read by the projectors remain those of ithread.
+                const int ipart_ref = particles->first_index[0];
+                for( unsigned int icolor = 0 ; icolor+1 < color_first_block_.size() ; icolor++ ) {
+                    #pragma omp taskloop grainsize(1)
+                    for( unsigned int iblock = color_first_block_[icolor] ; iblock < color_first_block_[icolor+1] ; iblock++ ) {
+                        for( unsigned int i = color_block_first_[iblock] ; i < color_block_first_[iblock+1] ; i++ ) {
+                            const unsigned int icell = colored_cells_[i];
+                            cellProjector( icell )->currentsAndDensityWrapper(
+                                EMfields, *particles, smpi, particles->first_index[icell],
+                                particles->last_index[icell],
+                                ithread,
+                                diag_flag, params.is_spectral,
+                                ispec, lexicographicCell( icell ), ipart_ref
+                            );
+                        }
+                    }
+                }
+            } else {
+                for( unsigned int scell = 0 ; scell < packsize_ ; scell++ )
+                    cellProjector( ipack*packsize_+scell )->currentsAndDensityWrapper(
+                        EMfields, *particles, smpi, particles->first_index[ipack*packsize_+scell],
+                        particles->last_index[ipack*packsize_+scell],
+                        ithread,
+                        diag_flag, params.is_spectral,
+                        ispec, lexicographicCell( ipack*packsize_+scell ), particles->first_index[ipack*packsize_]
+                    );
+            }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,3);
 
 
-#ifdef  __DETAILED_TIMERS
-            patch->patch_timers_[2] += MPI_Wtime() - timer;
-#endif
+            patch->stopFineTimer( projection_timer_id_ );
             }
             for( unsigned int ithd=0 ; ithd<nrj_lost_per_thd.size() ; ithd++ ) {
                 nrj_bc_lost += nrj_lost_per_thd[tid];
@@ -625,11 +649,7 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
             double *b_rho = EMfields->rho_s[ispec] ? &( *EMfields->rho_s[ispec] )( 0 ) : &( *EMfields->rho_ )( 0 ) ;
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,0,3);
-            for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell ++ ) { //Loop for projection on buffer_proj
-                for( iPart=particles->first_index[scell] ; ( int )iPart<particles->last_index[scell]; iPart++ ) {
-                    Proj->basic( b_rho, ( *particles ), iPart, 0 );
-                } //End loop on particles
-            }//End loop on scells
+            projectFrozenCharge( b_rho, EMfields->rho_->size() );
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,3);
 
         } else { // AM case
@@ -641,11 +661,7 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
             for( unsigned int imode = 0; imode<params.nmodes; imode++ ) {
                 int ifield = imode*n_species+ispec;
                 complex<double> *b_rho = emAM->rho_AM_s[ifield] ? &( *emAM->rho_AM_s[ifield] )( 0 ) : &( *emAM->rho_AM_[imode] )( 0 ) ;
-                for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell ++ ) { //Loop for projection on buffer_proj
-                    for( int iPart=particles->first_index[scell] ; iPart<particles->last_index[scell]; iPart++ ) {
-                        Proj->basicForComplex( b_rho, ( *particles ), iPart, 0, imode );
-                    }
-                }
+                projectFrozenCharge( b_rho, emAM->rho_AM_[imode]->size(), imode, params.nmodes );
             }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,3);
 
@@ -670,6 +686,85 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 
 }//END dynamics
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Fused dynamics of the cells of a pack: each cell goes through interpolation, push, boundary conditions, cell keys
+// and projection. The operators are called through their types InterpT, PushT and ProjT: the calls are not virtual,
+// and may be inlined, when these methods are final (Interpolator, Pusher and Projector for the generic variant)
+// ---------------------------------------------------------------------------------------------------------------------
+template<class InterpT, class PushT, class ProjT>
+void SpeciesV::fusedCells( unsigned int ipack, unsigned int ispec, ElectroMagn *EMfields, Params &params, bool diag_flag,
+                           PartWalls *partWalls, Patch *patch, SmileiMPI *smpi, int ithread, double &nrj_lost )
+{
+    InterpT *interp = static_cast<InterpT *>( Interp );
+    PushT *push = static_cast<PushT *>( Push );
+    ProjT *proj = static_cast<ProjT *>( Proj );
+
+    for( unsigned int i=0; i<count.size(); i++ ) {
+        count[i] = 0;
+    }
+
+    const int ipart_ref = particles->first_index[ipack*packsize_];
+
+    for( unsigned int scell = 0 ; scell < packsize_ ; scell++ ) {
+
+        const unsigned int icell = ipack*packsize_+scell;
+        if( particles->last_index[icell] == particles->first_index[icell] ) {
+            continue;
+        }
+
+        if( gathersFields() ) {
+            interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[icell] ),
+                                   &( particles->last_index[icell] ),
+                                   ithread, scell, ipart_ref );
+        }
+
+        ( *push )( *particles, smpi, particles->first_index[icell], particles->last_index[icell],
+                    ithread, ipart_ref );
+
+        double energy_lost = 0;
+        for( unsigned int iwall=0; iwall<partWalls->size(); iwall++ ) {
+            ( *partWalls )[iwall]->apply( this, particles->first_index[icell], particles->last_index[icell], smpi->dynamics_invgf[ithread], patch->rand_, energy_lost );
+            nrj_lost += mass_ * energy_lost;
+        }
+        partBoundCond->apply( this, particles->first_index[icell], particles->last_index[icell], smpi->dynamics_invgf[ithread], patch->rand_, energy_lost );
+        nrj_lost += mass_ * energy_lost;
+
+        computeParticleCellKeys( params,
+                                 particles,
+                                 &particles->cell_keys[0],
+                                 &count[0],
+                                 particles->first_index[icell],
+                                 particles->last_index[icell] );
+
+        if( !particles->is_test ) {
+            proj->currentsAndDensityWrapper(
+                EMfields, *particles, smpi, particles->first_index[icell],
+                particles->last_index[icell],
+                ithread,
+                diag_flag, params.is_spectral,
+                ispec, lexicographicCell( icell ), ipart_ref
+            );
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// The fused dynamics is compiled for the Boris pusher with the vectorized operators of order 2 in 2D and 3D,
+// the most common case. The other operators use the generic variant, with virtual calls.
+// ---------------------------------------------------------------------------------------------------------------------
+void SpeciesV::initDynamicsVariant()
+{
+    fused_cells_ = &SpeciesV::fusedCells<Interpolator, Pusher, Projector>;
+    if( typeid( *Push ) != typeid( PusherBoris ) ) {
+        return;
+    }
+    if( typeid( *Interp ) == typeid( Interpolator2D2OrderV ) && typeid( *Proj ) == typeid( Projector2D2OrderV ) ) {
+        fused_cells_ = &SpeciesV::fusedCells<Interpolator2D2OrderV, PusherBoris, Projector2D2OrderV>;
+    } else if( typeid( *Interp ) == typeid( Interpolator3D2OrderV ) && typeid( *Proj ) == typeid( Projector3D2OrderV ) ) {
+        fused_cells_ = &SpeciesV::fusedCells<Interpolator3D2OrderV, PusherBoris, Projector3D2OrderV>;
+    }
+}
+
 #ifdef _OMPTASKS
 void SpeciesV::dynamicsTasks( double time_dual, unsigned int ispec,
                          ElectroMagn *EMfields, Params &params, bool diag_flag,
@@ -769,10 +864,12 @@ void SpeciesV::dynamicsTasks( double time_dual, unsigned int ispec,
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),0,0);
             // Interpolate the fields at the particle position
-            for( int scell = first_cell_of_bin[ibin] ; scell <= last_cell_of_bin[ibin] ; scell++ ){
-                Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[scell] ),
-                                       &( particles->last_index[scell] ),
-                                       buffer_id, particles->first_index[0] );
+            if( gathersFields() ) {
+                for( int scell = first_cell_of_bin[ibin] ; scell <= last_cell_of_bin[ibin] ; scell++ ){
+                    Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[scell] ),
+                                           &( particles->last_index[scell] ),
+                                           buffer_id, particles->first_index[0] );
+                }
             } // end cell loop for Interpolator
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),1,0);
 
@@ -1317,12 +1414,14 @@ void SpeciesV::dynamicsTasks( double time_dual, unsigned int ispec,
 //   - increment the charge (projection)
 //   - used at initialisation for Poisson (and diags if required, not for now dynamics )
 // ---------------------------------------------------------------------------------------------------------------------
-void SpeciesV::computeCharge( ElectroMagn *EMfields, bool old /*=false*/ )
+void SpeciesV::computeCharge( ElectroMagn *EMfields, bool old /*=false*/, bool frozen /*=false*/ )
 {
     // -------------------------------
     // calculate the particle charge
     // -------------------------------
-    if( ( !particles->is_test ) ) {
+    if( frozen ) {
+        Species::computeCharge( EMfields, old, frozen );
+    } else if( ( !particles->is_test ) ) {
         if( !dynamic_cast<ElectroMagnAM *>( EMfields ) ) {
             double *b_rho=&( *EMfields->rho_ )( 0 );
             for( unsigned int iPart=particles->first_index[0] ; ( int )iPart<particles->last_index[particles->last_index.size()-1]; iPart++ ) {
@@ -1391,6 +1490,9 @@ void SpeciesV::sortParticles( Params &params )
         }
     }
 
+    // Number of particles written to a new place by the cycles of the sort
+    unsigned int nmoved = 0;
+
     // second loop convert the count array in cumulative sum
     particles->first_index[0]=0;
     for( unsigned int ic=1; ic < ncell; ic++ ) {
@@ -1442,6 +1544,7 @@ void SpeciesV::sortParticles( Params &params )
                 particles->translateParticles( cycle );
                 //Eventually copy particle from the MPI buffer into the particle vector.
                 MPI_buffer_.partRecv[idim][ineighbor]->overwriteParticle( ip, *particles, cycle[0] );
+                nmoved += cycle.size();
             }
         }
     }
@@ -1470,6 +1573,7 @@ void SpeciesV::sortParticles( Params &params )
         }
         //Last target_cell is -1, the particle must be erased:
         particles->translateParticles( cycle );
+        nmoved += cycle.size() - 1;
     }
 
     // Resize the particle vector
@@ -1501,6 +1605,7 @@ void SpeciesV::sortParticles( Params &params )
                 }
                 //swap parts
                 particles->swapParticles( cycle );
+                nmoved += cycle.size();
             }
         }
     } //end loop on cells
@@ -1509,6 +1614,9 @@ void SpeciesV::sortParticles( Params &params )
     for( unsigned int ic=1; ic < ncell; ic++ ) {
         particles->first_index[ic] = particles->last_index[ic-1];
     }
+
+    sort_moved_particles_ = nmoved;
+    sort_particles_ = particles->last_index.back();
 }
 
 // Compute particle cell_keys from istart to iend
@@ -1597,6 +1705,16 @@ void SpeciesV::computeParticleCellKeys( Params    & params,
 
     }
 
+    // Rank of the cells along the ordering curve
+    if( !cell_rank_.empty() ) {
+        const int *const __restrict__ cell_rank = cell_rank_.data();
+        for( iPart=istart; iPart < iend ; iPart++  ) {
+            if ( cell_keys[iPart] >= 0 ) {
+                cell_keys[iPart] = cell_rank[cell_keys[iPart]];
+            }
+        }
+    }
+
     for( iPart=istart; iPart < iend ; iPart++  ) {
         if ( cell_keys[iPart] >= 0 ) {
             count[cell_keys[iPart]] ++;
@@ -1604,6 +1722,108 @@ void SpeciesV::computeParticleCellKeys( Params    & params,
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Order the cells of the patch along a Hilbert or Morton curve instead of the lexicographic (x-major) order,
+//! so that consecutive cells (and thus consecutive particles) are neighbours in all directions.
+//! Non power-of-2 dimensions are embedded in the enclosing power-of-2 grid, whose curve is then restricted to the patch.
+// ---------------------------------------------------------------------------------------------------------------------
+void SpeciesV::initCellOrdering( Params &params )
+{
+    unsigned int n[3] = { 1, 1, 1 }, m[3] = { 0, 0, 0 };
+    for( unsigned int idim=0 ; idim<nDim_field ; idim++ ) {
+        n[idim] = params.patch_size_[idim]+1;
+        while( ( 1u << m[idim] ) < n[idim] ) {
+            m[idim]++;
+        }
+    }
+    const unsigned int ncells = n[0]*n[1]*n[2];
+
+    // Curve index of each lexicographic cell
+    std::vector<std::pair<unsigned int, int> > curve( ncells );
+    for( unsigned int ix=0 ; ix<n[0] ; ix++ ) {
+        for( unsigned int iy=0 ; iy<n[1] ; iy++ ) {
+            for( unsigned int iz=0 ; iz<n[2] ; iz++ ) {
+                const unsigned int ilex = ( ix*n[1] + iy )*n[2] + iz;
+                unsigned int h = 0;
+                if( params.cell_ordering == "hilbert" ) {
+                    if( nDim_field == 3 ) {
+                        h = generalhilbertindex( m[0], m[1], m[2], ix, iy, iz );
+                    } else {
+                        h = generalhilbertindex( m[0], m[1], ix, iy );
+                    }
+                } else {
+                    // Morton: interleave the bits of the indices
+                    const unsigned int idx[3] = { ix, iy, iz };
+                    unsigned int bit = 0;
+                    for( unsigned int ib=0 ; ib<std::max( m[0], std::max( m[1], m[2] ) ) ; ib++ ) {
+                        for( unsigned int idim=0 ; idim<nDim_field ; idim++ ) {
+                            if( ib < m[idim] ) {
+                                h |= ( ( idx[idim] >> ib ) & 1u ) << bit;
+                                bit++;
+                            }
+                        }
+                    }
+                }
+                curve[ilex] = std::make_pair( h, ( int )ilex );
+            }
+        }
+    }
+    std::sort( curve.begin(), curve.end() );
+
+    cell_rank_.resize( ncells );
+    cell_lexicographic_.resize( ncells );
+    for( unsigned int irank=0 ; irank<ncells ; irank++ ) {
+        cell_lexicographic_[irank] = curve[irank].second;
+        cell_rank_[curve[irank].second] = irank;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Colored deposition: the cells are split in blocks of `width` cells along each direction,
+// and the blocks are colored by the parity of their indices (2^nDim colors).
+// A particle of a cell deposits its current on interpolation_order/2+1 nodes on each side
+// of this cell, so that two blocks of the same color, separated by `width` cells,
+// never share a node when width >= interpolation_order+2.
+// ---------------------------------------------------------------------------------------------------------------------
+void SpeciesV::initColoredDeposition( Params &params )
+{
+    const unsigned int width = params.interpolation_order+2;
+
+    unsigned int n[3] = { 1, 1, 1 }, nblocks[3] = { 1, 1, 1 };
+    for( unsigned int idim=0 ; idim<nDim_field ; idim++ ) {
+        n[idim]       = params.patch_size_[idim]+1;
+        nblocks[idim] = ( n[idim] + width - 1 ) / width;
+    }
+    const unsigned int ncolors = 1u << nDim_field;
+
+    colored_cells_.clear();
+    color_block_first_.clear();
+    color_first_block_.clear();
+    for( unsigned int icolor=0 ; icolor<ncolors ; icolor++ ) {
+        color_first_block_.push_back( color_block_first_.size() );
+        for( unsigned int bx=0 ; bx<nblocks[0] ; bx++ ) {
+            for( unsigned int by=0 ; by<nblocks[1] ; by++ ) {
+                for( unsigned int bz=0 ; bz<nblocks[2] ; bz++ ) {
+                    if( ( bx%2 ) + 2*( by%2 ) + 4*( bz%2 ) != icolor ) {
+                        continue;
+                    }
+                    color_block_first_.push_back( colored_cells_.size() );
+                    for( unsigned int ix=bx*width ; ix<std::min( ( bx+1 )*width, n[0] ) ; ix++ ) {
+                        for( unsigned int iy=by*width ; iy<std::min( ( by+1 )*width, n[1] ) ; iy++ ) {
+                            for( unsigned int iz=bz*width ; iz<std::min( ( bz+1 )*width, n[2] ) ; iz++ ) {
+                                const unsigned int ilex = ( ix*n[1] + iy )*n[2] + iz;
+                                colored_cells_.push_back( cell_rank_.empty() ? ilex : cell_rank_[ilex] );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    color_first_block_.push_back( color_block_first_.size() );
+    color_block_first_.push_back( colored_cells_.size() );
+}
+
 //! Compute part_cell_keys at patch creation.
 //! This operation is normally done in the pusher to avoid additional particles pass.
 void SpeciesV::computeParticleCellKeys( Params &params )
@@ -1645,6 +1865,9 @@ void SpeciesV::importParticles( Params &params, Patch *, Particles &source_parti
 
     unsigned int npart = source_particles.size(), ncells=particles->first_index.size();
 
+    imported_particles_ += npart;
+    frozen_rho_particles_ = -1;
+
     // If this species is tracked, set the particle IDs
     if( particles->tracked ) {
         dynamic_cast<DiagnosticTrack *>( localDiags[tracking_diagnostic] )->setIDs( source_particles );
@@ -1742,13 +1965,10 @@ void SpeciesV::mergeParticles( double time_dual )
     // Only for moving particles
     if( time_dual>time_frozen_ ) {
 
-        unsigned int scell ;
         // double weight_before = 0;
         // double weight_after = 0;
         // double energy_before = 0;
         // double energy_after = 0;
-        std::vector <int> mask(particles->last_index.back(), 1);
-
         // Resize the cell_keys
         // particles->cell_keys.resize( particles->last_index.back(), 1 );
         // #pragma omp simd
@@ -1762,23 +1982,10 @@ void SpeciesV::mergeParticles( double time_dual )
         // }
 
         // For each cell, we apply independently the merging process
-        for( scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
-
-            ( *Merge )( mass_, *particles, mask, particles->first_index[scell],
-                        particles->last_index[scell], count[scell]);
-
-        }
+        mergeParticlesInCells( 0, prepareMerging( time_dual ) );
 
         // We remove empty space in an optimized manner
-        particles->eraseParticlesWithMask(0, particles->last_index.back(), mask);
-
-        // Update of first and last cell indexes
-        particles->first_index[0] = 0;
-        particles->last_index[0] = count[0];
-        for( scell = 1 ; scell < particles->first_index.size(); scell++ ) {
-            particles->first_index[scell] = particles->last_index[scell-1];
-            particles->last_index[scell] = particles->first_index[scell] + count[scell];
-        }
+        finalizeMerging();
 
         //particles->cell_keys.resize(particles->last_index.back());
 
@@ -1854,6 +2061,128 @@ void SpeciesV::mergeParticles( double time_dual )
 }
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+//! Preparation of the merging: mask of the particles and seeds of the random generators of the cells.
+//! The seeds are drawn in the order of the cells, so that the result does not depend on the threads.
+// ---------------------------------------------------------------------------------------------------------------------
+unsigned int SpeciesV::prepareMerging( double time_dual )
+{
+    // Only for moving particles
+    if( time_dual <= time_frozen_ ) {
+        return 0;
+    }
+
+    merging_mask_.assign( particles->last_index.back(), 1 );
+    merging_seeds_.resize( particles->first_index.size() );
+    for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
+        merging_seeds_[scell] = Merge->seed();
+    }
+    merged_particles_ = particles->last_index.back();
+    merging_target_ = merge_target_particles_per_cell_;
+
+    return particles->first_index.size();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Merging of the cells first_cell to last_cell-1, each with its own random generator
+// ---------------------------------------------------------------------------------------------------------------------
+void SpeciesV::mergeParticlesInCells( unsigned int first_cell, unsigned int last_cell )
+{
+    for( unsigned int scell = first_cell ; scell < last_cell ; scell++ ) {
+        Random rand( merging_seeds_[scell] );
+        ( *Merge )( mass_, *particles, merging_mask_, particles->first_index[scell],
+                    particles->last_index[scell], count[scell], &rand, merging_target_ );
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Removal of the merged particles and update of the cell indexes
+// ---------------------------------------------------------------------------------------------------------------------
+void SpeciesV::finalizeMerging()
+{
+    // We remove empty space in an optimized manner
+    particles->eraseParticlesWithMask( 0, particles->last_index.back(), merging_mask_ );
+
+    // Update of first and last cell indexes
+    particles->first_index[0] = 0;
+    particles->last_index[0] = count[0];
+    for( unsigned int scell = 1 ; scell < particles->first_index.size(); scell++ ) {
+        particles->first_index[scell] = particles->last_index[scell-1];
+        particles->last_index[scell] = particles->first_index[scell] + count[scell];
+    }
+
+    merged_particles_ -= particles->last_index.back();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Splitting of the particles of the cells with less than split_max_particles_per_cell_ particles.
+//! Each particle is replaced by split_factor_ particles with the same momentum sharing its weight,
+//! so that the charge, current and energy are conserved. The new particles stay at the position
+//! of their parent: displacing them would change the charge density without a current, and break
+//! the charge conservation of the projection. They separate through the stochastic processes.
+// ---------------------------------------------------------------------------------------------------------------------
+void SpeciesV::splitParticles( Patch */*patch*/, std::vector<Diagnostic *> &localDiags, double time_dual )
+{
+    split_particles_ = 0;
+
+    // Only for moving particles
+    if( time_dual <= time_frozen_ ) {
+        return;
+    }
+
+    const unsigned int ncells = particles->first_index.size();
+    const unsigned int nchildren = split_factor_ - 1;
+    const bool has_position_old = particles->Position_old.size() > 0;
+
+    // Number of new particles
+    unsigned int nnew = 0;
+    for( unsigned int scell = 0 ; scell < ncells ; scell++ ) {
+        const unsigned int npart = particles->last_index[scell] - particles->first_index[scell];
+        if( npart > 0 && npart < split_max_particles_per_cell_ ) {
+            nnew += npart * nchildren;
+        }
+    }
+    if( nnew == 0 ) {
+        return;
+    }
+
+    // New particles, copies of their parent, and their cell
+    Particles split_particles;
+    split_particles.initialize( 0, *particles );
+    split_particles.reserve( nnew, nDim_particle, has_position_old );
+    std::vector<int> split_cell_keys;
+    split_cell_keys.reserve( nnew );
+
+    for( unsigned int scell = 0 ; scell < ncells ; scell++ ) {
+        const unsigned int npart = particles->last_index[scell] - particles->first_index[scell];
+        if( npart == 0 || npart >= split_max_particles_per_cell_ ) {
+            continue;
+        }
+        for( int ip = particles->first_index[scell] ; ip < particles->last_index[scell] ; ip++ ) {
+            particles->weight( ip ) /= split_factor_;
+            for( unsigned int ichild = 0 ; ichild < nchildren ; ichild++ ) {
+                particles->copyParticle( ip, split_particles );
+                split_cell_keys.push_back( scell );
+            }
+        }
+    }
+
+    // If this species is tracked, set the particle IDs
+    if( particles->tracked ) {
+        dynamic_cast<DiagnosticTrack *>( localDiags[tracking_diagnostic] )->setIDs( split_particles );
+    }
+
+    // Insert the new particles at the beginning of their cells
+    split_particles.copyParticlesToBins( split_cell_keys, *particles );
+    particles->resizeCellKeys( particles->size() );
+    for( unsigned int ip = 0 ; ip < nnew ; ip++ ) {
+        count[split_cell_keys[ip]]++;
+    }
+
+    split_particles_ = nnew;
+    frozen_rho_particles_ = -1;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // For all particles of the species reacting to laser envelope
 //   - interpolate the fields at the particle position
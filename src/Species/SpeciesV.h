@@ -57,7 +57,7 @@ public:
             Patch *patch, SmileiMPI *smpi ) override;
 
     //! Method calculating the Particle charge on the grid (projection)
-    void computeCharge( ElectroMagn *EMfields, bool old=false ) override;
+    void computeCharge( ElectroMagn *EMfields, bool old=false, bool frozen=false ) override;
 
     //! Method used to sort particles
     void sortParticles( Params &params ) override;
@@ -86,6 +86,14 @@ public:
     //! Method performing the merging of particles
     virtual void mergeParticles( double time_dual )override;
 
+    //! Steps of the merging, so that the cells of a patch may be merged by different threads
+    unsigned int prepareMerging( double time_dual )override;
+    void mergeParticlesInCells( unsigned int first_cell, unsigned int last_cell )override;
+    void finalizeMerging()override;
+
+    //! Method performing the splitting of the particles of the cells with few particles
+    void splitParticles( Patch *patch, std::vector<Diagnostic *> &localDiags, double time_dual )override;
+
 #ifdef _OMPTASKS
 
     //! Method calculating the Particle dynamics (interpolation, pusher, projection) with tasks
@@ -116,13 +124,72 @@ public:
     std::vector<int> first_cell_of_bin;
     std::vector<int> last_cell_of_bin;
 
+    //! Interpolator used for the cell icell (scalar if the adaptive mode chose it for this cell)
+    inline Interpolator *cellInterpolator( unsigned int icell ) const
+    {
+        return ( Interp_scalar_ && !scalar_cells_.empty() && scalar_cells_[icell] ) ? Interp_scalar_ : Interp;
+    }
+
+    //! Projector used for the cell icell (scalar if the adaptive mode chose it for this cell)
+    inline Projector *cellProjector( unsigned int icell ) const
+    {
+        return ( Proj_scalar_ && !scalar_cells_.empty() && scalar_cells_[icell] ) ? Proj_scalar_ : Proj;
+    }
+
+    //! Lexicographic index of the cell of rank icell along the cell ordering curve
+    inline int lexicographicCell( unsigned int icell ) const
+    {
+        return cell_lexicographic_.empty() ? ( int )icell : cell_lexicographic_[icell];
+    }
+
+protected:
+
+    //! Scalar interpolator used, in adaptive mode per cell, for the cells flagged in scalar_cells_
+    Interpolator *Interp_scalar_;
+    //! Scalar projector used, in adaptive mode per cell, for the cells flagged in scalar_cells_
+    Projector *Proj_scalar_;
+    //! Cells computed with the scalar operators (empty: vectorized operators in all cells)
+    std::vector<bool> scalar_cells_;
+
 private:
 
+    //! Select fused_cells_ for the types of Interp, Push and Proj
+    void initDynamicsVariant() override;
+
+    //! Fused dynamics of the cells of a pack, with the types of the operators known at compile time
+    //! so that their calls are not virtual
+    template<class InterpT, class PushT, class ProjT>
+    void fusedCells( unsigned int ipack, unsigned int ispec, ElectroMagn *EMfields, Params &params, bool diag_flag,
+                     PartWalls *partWalls, Patch *patch, SmileiMPI *smpi, int ithread, double &nrj_lost );
+
+    //! Variant of fusedCells used by the fused dynamics (generic if the operators have no compiled variant)
+    void ( SpeciesV::*fused_cells_ )( unsigned int, unsigned int, ElectroMagn *, Params &, bool,
+                                      PartWalls *, Patch *, SmileiMPI *, int, double & );
+
     //! Number of packs of particles that divides the total number of particles
     unsigned int npack_;
     //! Size of the pack in number of particles
     unsigned int packsize_;
 
+    //! Rank along the cell ordering curve of each lexicographic cell index (empty if lexicographic)
+    std::vector<int> cell_rank_;
+    //! Lexicographic index of each rank along the cell ordering curve (empty if lexicographic)
+    std::vector<int> cell_lexicographic_;
+
+    //! Build cell_rank_ and cell_lexicographic_ from the Hilbert or Morton curve
+    void initCellOrdering( Params &params );
+
+    //! Colored deposition: ranks of the cells grouped by color, then by block (empty if not colored)
+    std::vector<unsigned int> colored_cells_;
+    //! Colored deposition: index in colored_cells_ of the first cell of each block (+ end)
+    std::vector<unsigned int> color_block_first_;
+    //! Colored deposition: index of the first block of each color (+ end)
+    std::vector<unsigned int> color_first_block_;
+
+    //! Split the cells in blocks of 2^nDim colors, such that the stencils of the
+    //! blocks of a same color never overlap
+    void initColoredDeposition( Params &params );
+
     
     
 
@@ -35,6 +35,7 @@
 #include "Tools.h"
 
 #include "DiagnosticTrack.h"
+#include "PartCompTimeCalibrated.h"
 
 using namespace std;
 
@@ -49,6 +50,7 @@ SpeciesVAdaptive::SpeciesVAdaptive( Params &params, Patch *patch ) :
     initCluster( params, patch );
     npack_ = 0 ;
     packsize_ = 0;
+    reconfiguration_count_ = 0;
 }//END SpeciesVAdaptive creator
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -58,6 +60,23 @@ SpeciesVAdaptive::~SpeciesVAdaptive()
 {
 }
 
+//! Method calculating the Particle dynamics with vectorized operators,
+//! timed for the calibration of the cost model
+void SpeciesVAdaptive::dynamics( double time_dual, unsigned int ispec,
+        ElectroMagn *EMfields, Params &params, bool diag_flag,
+        PartWalls *partWalls,
+        Patch *patch, SmileiMPI *smpi,
+        RadiationTables &RadiationTables,
+        MultiphotonBreitWheelerTables &MultiphotonBreitWheelerTables )
+{
+    const double calibration_timer = MPI_Wtime();
+
+    SpeciesV::dynamics( time_dual, ispec, EMfields, params, diag_flag, partWalls, patch, smpi,
+                        RadiationTables, MultiphotonBreitWheelerTables );
+
+    recordCost( MPI_Wtime() - calibration_timer );
+}
+
 //! Method calculating the Particle dynamics (interpolation, pusher, projection)
 //! without vectorized operators but with the cell sorting algorithm
 void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
@@ -69,10 +88,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
 {
 
     const int ithread = Tools::getOMPThreadNum();
-
-#ifdef  __DETAILED_TIMERS
-    double timer;
-#endif
+    const double calibration_timer = MPI_Wtime();
 
     bool diag_PartEventTracing {false};
 
@@ -102,19 +118,17 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             count[i] = 0;
         }
 
-#ifdef  __DETAILED_TIMERS
-        timer = MPI_Wtime();
-#endif
+        patch->startFineTimer( interpolation_timer_id_ );
 
 
         smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 0, 0);
         // Interpolate the fields at the particle position
-        Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[0] ), &( particles->last_index[particles->last_index.size()-1] ), ithread, particles->first_index[0] );
+        if( gathersFields() ) {
+            Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[0] ), &( particles->last_index[particles->last_index.size()-1] ), ithread, particles->first_index[0] );
+        }
         smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 1, 0);
 
-#ifdef  __DETAILED_TIMERS
-        patch->patch_timers_[0] += MPI_Wtime() - timer;
-#endif
+        patch->stopFineTimer( interpolation_timer_id_ );
 
         // Ionization
         if( Ionize ) {
@@ -126,13 +140,9 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
 
 
-#ifdef  __DETAILED_TIMERS
-                timer = MPI_Wtime();
-#endif
+                patch->startFineTimer( ionization_timer_id_ );
                 ( *Ionize )( particles, particles->first_index[scell], particles->last_index[scell], Epart, patch, Proj );
-#ifdef  __DETAILED_TIMERS
-                patch->patch_timers_[4] += MPI_Wtime() - timer;
-#endif
+                patch->stopFineTimer( ionization_timer_id_ );
 
             }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 1, 5);
@@ -142,15 +152,13 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
 
     if( time_dual>time_frozen_ ) { // do not radiate, compute multiphoton MBW, push, nor apply particles BC, nor project frozen particles
 
-            // Radiation losses
-            if( Radiate ) {
+            // Radiation losses (applied by the pusher if fused)
+            if( Radiate && !fused_radiation_ ) {
 
                 smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 0, 6);
                 for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
 
-#ifdef  __DETAILED_TIMERS
-                    timer = MPI_Wtime();
-#endif
+                    patch->startFineTimer( radiation_timer_id_ );
                 // Radiation process
                 ( *Radiate )( *particles,
                               radiated_photons_,
@@ -167,9 +175,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
                 //                               first_index[scell],
                 //                               last_index[scell],
                 //                               ithread );
-#ifdef  __DETAILED_TIMERS
-                    patch->patch_timers_[5] += MPI_Wtime() - timer;
-#endif
+                    patch->stopFineTimer( radiation_timer_id_ );
 
             }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 1, 6);
@@ -182,9 +188,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
 
 
-#ifdef  __DETAILED_TIMERS
-                timer = MPI_Wtime();
-#endif
+                patch->startFineTimer( mBW_timer_id_ );
                 // Pair generation process
                 // We reuse nrj_radiated_ for the pairs
                 ( *Multiphoton_Breit_Wheeler_process )( *particles,
@@ -206,17 +210,13 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
                 Multiphoton_Breit_Wheeler_process->removeDecayedPhotons(
                     *particles, smpi, scell, particles->first_index.size(), &particles->first_index[0], &particles->last_index[0], ithread );
 
-#ifdef  __DETAILED_TIMERS
-                patch->patch_timers_[6] += MPI_Wtime() - timer;
-#endif
+                patch->stopFineTimer( mBW_timer_id_ );
             }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 1, 7);
 
         } // end if Multiphoton Breit Wheeler
 
-#ifdef  __DETAILED_TIMERS
-            timer = MPI_Wtime();
-#endif
+            patch->startFineTimer( push_timer_id_ );
 
             size_t start = 0, stop = particles->last_index.back(), n = stop - start;
             vector<vector<double>> pold;
@@ -224,7 +224,11 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 0, 1);
             // Push the particles and the photons
-            ( *Push )( *particles, smpi, 0, particles->last_index.back(), ithread, 0. );
+            if( fused_radiation_ ) {
+                Push->pushWithRadiation( *particles, smpi, RadiationTables, nrj_radiated_, 0, particles->last_index.back(), ithread, 0 );
+            } else {
+                ( *Push )( *particles, smpi, 0, particles->last_index.back(), ithread, 0. );
+            }
             
             // Copy interpolated fields to persistent buffers if requested
             if( particles->interpolated_fields_ ) {
@@ -233,10 +237,8 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 1, 1);
 
-#ifdef  __DETAILED_TIMERS
-            patch->patch_timers_[1] += MPI_Wtime() - timer;
-            timer = MPI_Wtime();
-#endif
+            patch->stopFineTimer( push_timer_id_ );
+            patch->startFineTimer( cell_keys_timer_id_ );
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 0, 2);
             for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
@@ -307,17 +309,13 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread, 1, 11);
 
-#ifdef  __DETAILED_TIMERS
-            patch->patch_timers_[3] += MPI_Wtime() - timer;
-#endif
+            patch->stopFineTimer( cell_keys_timer_id_ );
 
             // Project currents if not a Test species and charges as well if a diag is needed.
             // Do not project if a photon
             if( ( !particles->is_test ) && ( mass_ > 0 ) ) {
 
-#ifdef  __DETAILED_TIMERS
-                timer = MPI_Wtime();
-#endif
+                patch->startFineTimer( projection_timer_id_ );
 
                 smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,0,3);
                 Proj->currentsAndDensityWrapper(
@@ -330,9 +328,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             );
                 smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,3);
 
-#ifdef  __DETAILED_TIMERS
-                patch->patch_timers_[2] += MPI_Wtime() - timer;
-#endif
+                patch->stopFineTimer( projection_timer_id_ );
 
             }
         } // end if moving particle
@@ -350,11 +346,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,0,3);
             double *b_rho = EMfields->rho_s[ispec] ? &( *EMfields->rho_s[ispec] )( 0 ) : &( *EMfields->rho_ )( 0 ) ;
-            for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell ++ ) { //Loop for projection on buffer_proj
-                for( iPart=particles->first_index[scell] ; ( int )iPart<particles->last_index[scell]; iPart++ ) {
-                    Proj->basic( b_rho, ( *particles ), iPart, 0 );
-                }
-            }
+            projectFrozenCharge( b_rho, EMfields->rho_->size() );
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,3);
 
         } else { // AM case
@@ -365,16 +357,14 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             for( unsigned int imode = 0; imode<params.nmodes; imode++ ) {
                 int ifield = imode*n_species+ispec;
                 complex<double> *b_rho = emAM->rho_AM_s[ifield] ? &( *emAM->rho_AM_s[ifield] )( 0 ) : &( *emAM->rho_AM_[imode] )( 0 ) ;
-                for( unsigned int scell = 0 ; scell < particles->first_index.size() ; scell ++ ) { //Loop for projection on buffer_proj
-                    for( int iPart=particles->first_index[scell] ; iPart<particles->last_index[scell]; iPart++ ) {
-                        Proj->basicForComplex( b_rho, ( *particles ), iPart, 0, imode );
-                    }
-                }
+                projectFrozenCharge( b_rho, emAM->rho_AM_[imode]->size(), imode, params.nmodes );
             }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, ithread,1,3);
         }
     }
 
+    recordCost( MPI_Wtime() - calibration_timer );
+
 }//END scalarDynamics
 
 #ifdef _OMPTASKS
@@ -480,9 +470,11 @@ void SpeciesVAdaptive::scalarDynamicsTasks( double time_dual, unsigned int ispec
 
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),0,0);
             // Interpolate the fields at the particle position
-            Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[first_cell_of_bin[ibin]] ),
-                                   &( particles->last_index[last_cell_of_bin[ibin]] ),
-                                   buffer_id, particles->first_index[0] );
+            if( gathersFields() ) {
+                Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[first_cell_of_bin[ibin]] ),
+                                       &( particles->last_index[last_cell_of_bin[ibin]] ),
+                                       buffer_id, particles->first_index[0] );
+            }
             smpi->traceEventIfDiagTracing(diag_PartEventTracing, Tools::getOMPThreadNum(),1,0);
 
 #ifdef  __DETAILED_TIMERS
@@ -1029,6 +1021,34 @@ void SpeciesVAdaptive::reconfiguration( Params &params, Patch *patch )
     float vecto_time = 0.;
     float scalar_time = 0.;
 
+    // Calibration of the cost model: half of the patches run each mode in turn,
+    // so that every density is measured in both modes
+    reconfiguration_count_++;
+    const unsigned int period = params.adaptive_calibration_period;
+    const unsigned int step = period > 0 ? reconfiguration_count_ % period : reconfiguration_count_;
+    if( calibratedCost() && step < 2 ) {
+        const bool vectorized = ( patch->Hindex() + reconfiguration_count_ ) % 2;
+        if( params.adaptive_granularity == "cell" ) {
+            if( !Interp_scalar_ ) {
+                this->reconfigure_operators( params, patch );
+            }
+            scalar_cells_.assign( count.size(), !vectorized );
+        } else if( vectorized != ( bool )this->vectorized_operators ) {
+            this->vectorized_operators = vectorized;
+            this->reconfigure_operators( params, patch );
+        }
+        return;
+    }
+
+    // Operators chosen per cell: the patch always runs the vectorized dynamics
+    if( params.adaptive_granularity == "cell" ) {
+        if( !Interp_scalar_ ) {
+            this->reconfigure_operators( params, patch );
+        }
+        configureCells( params );
+        return;
+    }
+
     //split cell into smaller sub_cells for refined sorting
     // cell = (params.patch_size_[0]+1);
     //for ( unsigned int i=1; i < params.nDim_field; i++) ncell *= (params.patch_size_[i]+1);
@@ -1086,6 +1106,12 @@ void SpeciesVAdaptive::defaultConfigure( Params &params, Patch *patch )
 {
 
     // Setup the species state regardless the number of particles per cell
+    if( params.adaptive_granularity == "cell" ) {
+        this->vectorized_operators = true;
+        scalar_cells_.assign( particles->first_index.size(), params.adaptive_default_mode == "off" );
+        this->reconfigure_operators( params, patch );
+        return;
+    }
     this->vectorized_operators = ( params.adaptive_default_mode == "on" );
 
     // Configure the species regardless the number of particles per cell
@@ -1103,6 +1129,14 @@ void SpeciesVAdaptive::configuration( Params &params, Patch *patch )
     float vecto_time = 0.;
     float scalar_time = 0.;
 
+    // Operators chosen per cell
+    if( params.adaptive_granularity == "cell" ) {
+        this->vectorized_operators = true;
+        configureCells( params );
+        this->reconfigure_operators( params, patch );
+        return;
+    }
+
     // Species with particles
     if( particles->size() > 0 ) {
 
@@ -1146,6 +1180,120 @@ void SpeciesVAdaptive::reconfigure_operators( Params &params, Patch *patch )
     //Push = PusherFactory::create(params, this);
     // Reassign the correct Projector
     Proj = ProjectorFactory::create( params, patch, this->vectorized_operators );
+
+    // The scalar operators of the cells computed in scalar mode
+    if( params.adaptive_granularity == "cell" ) {
+        delete Interp_scalar_;
+        delete Proj_scalar_;
+        Interp_scalar_ = InterpolatorFactory::create( params, patch, false );
+        Proj_scalar_   = ProjectorFactory::create( params, patch, false );
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! This function chooses, in each cell, the scalar or vectorized operators.
+//! The fitted computation times only depend on the number of particles
+//! in the cell: the choice is tabulated once per number of particles.
+// -----------------------------------------------------------------------------
+void SpeciesVAdaptive::configureCells( Params & )
+{
+    // Number of particles per cell above which the fits are constant
+    const unsigned int max_count = 256;
+
+    scalar_cells_.resize( count.size() );
+
+    // The calibrated costs change with the measurements
+    PartCompTimeCalibrated *model = calibratedCost();
+    if( model ) {
+        float vecto_time = 0.;
+        float scalar_time = 0.;
+        ( *model )( count, vecto_time, scalar_time );
+        for( unsigned int ic=0 ; ic<count.size() ; ic++ ) {
+            scalar_cells_[ic] = count[ic] > 0 && model->particleTime( count[ic], true ) > model->particleTime( count[ic], false );
+        }
+        return;
+    }
+
+    if( vectorized_count_.empty() ) {
+        vectorized_count_.resize( max_count+1 );
+        std::vector<int> cell_count( 1 );
+        for( unsigned int n=1 ; n<=max_count ; n++ ) {
+            float vecto_time = 0.;
+            float scalar_time = 0.;
+            cell_count[0] = n;
+            (*part_comp_time_)( cell_count, vecto_time, scalar_time );
+            vectorized_count_[n] = ( vecto_time <= scalar_time );
+        }
+    }
+
+    for( unsigned int ic=0 ; ic<count.size() ; ic++ ) {
+        scalar_cells_[ic] = count[ic] > 0 && !vectorized_count_[std::min( ( unsigned int )count[ic], max_count )];
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Cost model calibrated on the fly, bound to the measurements of the species
+// -----------------------------------------------------------------------------
+PartCompTimeCalibrated *SpeciesVAdaptive::calibratedCost()
+{
+    PartCompTimeCalibrated *model = dynamic_cast<PartCompTimeCalibrated *>( part_comp_time_ );
+    if( model && !model->attached() ) {
+        model->attach( species_number_ );
+    }
+    return model;
+}
+
+// -----------------------------------------------------------------------------
+//! Add the measured time of a dynamics to the calibrated cost model.
+//! Only the dynamics that use a single mode in the whole patch are recorded.
+// -----------------------------------------------------------------------------
+void SpeciesVAdaptive::recordCost( double time )
+{
+    PartCompTimeCalibrated *model = calibratedCost();
+    if( !model ) {
+        return;
+    }
+
+    bool vectorized = this->vectorized_operators;
+    if( vectorized && Interp_scalar_ && !scalar_cells_.empty() ) {
+        if( std::find( scalar_cells_.begin(), scalar_cells_.end(), !scalar_cells_[0] ) != scalar_cells_.end() ) {
+            return;
+        }
+        vectorized = !scalar_cells_[0];
+    }
+    model->record( *particles, vectorized, time );
+}
+
+// -----------------------------------------------------------------------------
+//! Load of the particles for the load balancing: the time predicted by the
+//! calibrated model, in units of the mean measured time per particle
+// -----------------------------------------------------------------------------
+double SpeciesVAdaptive::getParticleLoad()
+{
+    PartCompTimeCalibrated *model = calibratedCost();
+    const double mean_time = model ? model->meanParticleTime() : 0.;
+    if( mean_time <= 0. ) {
+        return getNbrOfParticles();
+    }
+
+    std::vector<int> bin_count( particles->first_index.size() );
+    for( unsigned int ibin=0 ; ibin<bin_count.size() ; ibin++ ) {
+        bin_count[ibin] = particles->last_index[ibin] - particles->first_index[ibin];
+    }
+    float vecto_time = 0.;
+    float scalar_time = 0.;
+    ( *model )( bin_count, vecto_time, scalar_time );
+
+    double time = this->vectorized_operators ? vecto_time : scalar_time;
+    if( this->vectorized_operators && Interp_scalar_ && scalar_cells_.size() == bin_count.size() ) {
+        time = 0.;
+        for( unsigned int ibin=0 ; ibin<bin_count.size() ; ibin++ ) {
+            if( bin_count[ibin] > 0 ) {
+                time += bin_count[ibin] * model->particleTime( bin_count[ibin], !scalar_cells_[ibin] );
+            }
+        }
+    }
+    return time / mean_time;
 }
 
 
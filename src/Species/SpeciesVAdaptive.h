@@ -6,6 +6,8 @@
 
 #include "SpeciesV.h"
 
+class PartCompTimeCalibrated;
+
 class ElectroMagn;
 class Pusher;
 class Interpolator;
@@ -26,6 +28,15 @@ public:
     //! Species destructor
     virtual ~SpeciesVAdaptive();
     
+    //! Method calculating the Particle dynamics with vectorized operators,
+    //! timed for the calibration of the cost model
+    void dynamics( double time, unsigned int ispec,
+                   ElectroMagn *EMfields,
+                   Params &params, bool diag_flag,
+                   PartWalls *partWalls, Patch *patch, SmileiMPI *smpi,
+                   RadiationTables &RadiationTables,
+                   MultiphotonBreitWheelerTables &MultiphotonBreitWheelerTables ) override;
+
     //! Method calculating the Particle dynamics (interpolation, pusher, projection)
     //! without vectorized operators but with the cell sorting algorithm
     void scalarDynamics( double time, unsigned int ispec,
@@ -47,6 +58,12 @@ public:
     
     //! This function reconfigures the species operators
     void reconfigure_operators( Params &param, Patch   *patch );
+
+    //! Choose the scalar or vectorized operators in each cell from the number of particles per cell
+    void configureCells( Params &params );
+
+    //! Load of the particles predicted by the calibrated cost model
+    double getParticleLoad() override;
     
     //void countSortParticles(Params& param);
     //void computeParticleCellKeys(Params &params);
@@ -95,6 +112,18 @@ private:
     unsigned int npack_;
     //! Size of the pack in number of particles
     unsigned int packsize_;
+
+    //! For each number of particles in a cell (up to the fit limit), true if the vectorized operators are faster
+    std::vector<bool> vectorized_count_;
+
+    //! Number of reconfigurations of the species in this patch
+    unsigned int reconfiguration_count_;
+
+    //! Cost model calibrated on the fly (NULL with the hard-coded fits)
+    PartCompTimeCalibrated *calibratedCost();
+
+    //! Add the measured time of a dynamics to the calibrated cost model
+    void recordCost( double time );
     
 };
 
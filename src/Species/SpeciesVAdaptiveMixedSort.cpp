@@ -151,6 +151,8 @@ void SpeciesVAdaptiveMixedSort::sortParticles( Params &params )
         SpeciesV::sortParticles( params );
     } else {
         Species::sortParticles( params );
+        sort_moved_particles_ = 0;
+        sort_particles_ = 0;
     }
 }
 
@@ -353,7 +355,7 @@ void SpeciesVAdaptiveMixedSort::reconfigure_operators( Params &params, Patch *pa
     // Reassign the correct Interpolator
     Interp = InterpolatorFactory::create( params, patch, this->vectorized_operators );
     // Reassign the correct Pusher to Push
-    Push = PusherFactory::create( params, this );
+    Push = PusherFactory::create( params, this, patch->rand_ );
     // Reassign the correct Ponderomotive Pusher if used
     if( Push_ponderomotive_position ) {
         Push_ponderomotive_position = PusherFactory::create_ponderomotive_position_updater( params, this );
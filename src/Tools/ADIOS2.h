@@ -0,0 +1,137 @@
+#ifndef ADIOS2_H
+#define ADIOS2_H
+
+#ifdef SMILEI_ADIOS2
+
+#include <adios2.h>
+#include <string>
+#include <vector>
+#include "H5.h"
+
+//! Location in an ADIOS2 output, with the same attribute interface as H5Write.
+//! Groups only exist through the paths of the attributes and variables ("/data/100/Ex"),
+//! as in the openPMD layout of ADIOS2 files.
+class ADIOS2Write
+{
+public:
+    ADIOS2Write( adios2::IO *io, adios2::Engine *engine, std::string path = "" )
+     : io_( io ), engine_( engine ), path_( path ) {};
+
+    ~ADIOS2Write() {};
+
+    //! Location of a group inside this one
+    ADIOS2Write group( std::string group_name )
+    {
+        return ADIOS2Write( io_, engine_, path_ + "/" + group_name );
+    }
+
+    //! Write a string as an attribute
+    void attr( std::string attribute_name, std::string attribute_value )
+    {
+        io_->DefineAttribute<std::string>( fullName( attribute_name ), attribute_value );
+    }
+
+    //! Write an unsigned int as an attribute
+    void attr( std::string attribute_name, unsigned int attribute_value )
+    {
+        io_->DefineAttribute<unsigned int>( fullName( attribute_name ), attribute_value );
+    }
+
+    //! write unsigned long int as an attribute
+    void attr( std::string attribute_name, unsigned long int attribute_value )
+    {
+        io_->DefineAttribute<unsigned long int>( fullName( attribute_name ), attribute_value );
+    }
+
+    //! write an int as an attribute
+    void attr( std::string attribute_name, int attribute_value )
+    {
+        io_->DefineAttribute<int>( fullName( attribute_name ), attribute_value );
+    }
+
+    //! write a double as an attribute
+    void attr( std::string attribute_name, double attribute_value )
+    {
+        io_->DefineAttribute<double>( fullName( attribute_name ), attribute_value );
+    }
+
+    //! write anything as an attribute (the HDF5 type is not needed)
+    template<class T>
+    void attr( std::string attribute_name, T &attribute_value, hid_t )
+    {
+        io_->DefineAttribute<T>( fullName( attribute_name ), attribute_value );
+    }
+
+    //! write a vector<unsigned int> as an attribute
+    void attr( std::string attribute_name, std::vector<unsigned int> attribute_value )
+    {
+        io_->DefineAttribute<unsigned int>( fullName( attribute_name ), attribute_value.data(), attribute_value.size() );
+    }
+
+    //! write a vector<double> as an attribute
+    void attr( std::string attribute_name, std::vector<double> attribute_value )
+    {
+        io_->DefineAttribute<double>( fullName( attribute_name ), attribute_value.data(), attribute_value.size() );
+    }
+
+    //! write a vector<string> as an attribute
+    void attr( std::string attribute_name, std::vector<std::string> attribute_value )
+    {
+        io_->DefineAttribute<std::string>( fullName( attribute_name ), attribute_value.data(), attribute_value.size() );
+    }
+
+    //! write a vector<anything> as an attribute (the HDF5 type is not needed)
+    template<class T>
+    void attr( std::string attribute_name, std::vector<T> &attribute_value, hid_t )
+    {
+        io_->DefineAttribute<T>( fullName( attribute_name ), attribute_value.data(), attribute_value.size() );
+    }
+
+    //! write a DividedString as a list of strings
+    void attr( std::string attribute_name, DividedString &attribute_value )
+    {
+        std::vector<std::string> strings( attribute_value.numstr );
+        for( unsigned int i=0; i<attribute_value.numstr; i++ ) {
+            strings[i] = attribute_value.str.substr( i * attribute_value.width, attribute_value.width );
+            strings[i] = strings[i].substr( 0, strings[i].find( '\0' ) );
+        }
+        attr( attribute_name, strings );
+    }
+
+    //! Write a multi-dimensional array of doubles from several blocks (e.g. one per patch).
+    //! The data is copied by ADIOS2 (synchronous put): the blocks may be reused afterwards.
+    ADIOS2Write array( std::string name,
+                       std::vector<size_t> shape,
+                       std::vector<std::vector<double> > &blocks,
+                       std::vector<std::vector<size_t> > &starts,
+                       std::vector<std::vector<size_t> > &counts )
+    {
+        std::string variable_name = fullName( name );
+        adios2::Variable<double> variable = io_->InquireVariable<double>( variable_name );
+        if( ! variable ) {
+            variable = io_->DefineVariable<double>( variable_name, shape, std::vector<size_t>( shape.size(), 0 ), shape );
+        }
+        for( unsigned int i=0; i<blocks.size(); i++ ) {
+            if( blocks[i].empty() ) {
+                continue;
+            }
+            variable.SetSelection( { starts[i], counts[i] } );
+            engine_->Put( variable, blocks[i].data(), adios2::Mode::Sync );
+        }
+        return ADIOS2Write( io_, engine_, variable_name );
+    }
+
+private:
+    std::string fullName( std::string name )
+    {
+        return path_ + "/" + name;
+    }
+
+    adios2::IO *io_;
+    adios2::Engine *engine_;
+    std::string path_;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef EXACTSUM_H
+#define EXACTSUM_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class ExactSum: exact sum of doubles in a fixed point accumulator covering all their exponents (a superaccumulator).
+//! Each double is split in 3 integer digits of 32 bits, added to signed 64-bit digits, so that the sum does not depend
+//! on the order of the additions: the threads may add atomically, and the processes sum the digits with MPI_SUM
+//! (after normalize), giving bitwise identical results whatever the numbers of threads and processes.
+//! Up to 2^31 values may be added between two normalizations. Infinities and NaNs are counted separately.
+//  --------------------------------------------------------------------------------------------------------------------
+class ExactSum
+{
+public:
+    //! Number of digits: the lowest bit of the smallest subnormal is the bit 0 of the digit 0,
+    //! the highest bit of the largest double is in the digit 67
+    static const unsigned int ndigits = 70;
+    //! Number of integers in an accumulator (digits, then counts of +infinity, -infinity and NaN)
+    static const unsigned int size = ndigits + 3;
+
+    ExactSum()
+    {
+        reset();
+    };
+
+    inline void reset()
+    {
+        for( unsigned int i=0; i<size; i++ ) {
+            digits_[i] = 0;
+        }
+    };
+
+    //! Adds v (only one thread at a time)
+    inline void add( double v )
+    {
+        int64_t d[3];
+        unsigned int i;
+        if( split( v, i, d ) ) {
+            digits_[i  ] += d[0];
+            digits_[i+1] += d[1];
+            digits_[i+2] += d[2];
+        } else {
+            digits_[i] += 1;
+        }
+    };
+
+    //! Adds v (may be called by several threads at the same time)
+    inline void addAtomic( double v )
+    {
+        int64_t d[3];
+        unsigned int i;
+        if( split( v, i, d ) ) {
+            #pragma omp atomic
+            digits_[i  ] += d[0];
+            #pragma omp atomic
+            digits_[i+1] += d[1];
+            #pragma omp atomic
+            digits_[i+2] += d[2];
+        } else {
+            #pragma omp atomic
+            digits_[i] += 1;
+        }
+    };
+
+    //! Carries the digits so that all of them, except the last one, are in [0, 2^32[ (same value)
+    inline void normalize()
+    {
+        for( unsigned int i=0; i<ndigits-1; i++ ) {
+            int64_t low = digits_[i] & 0xffffffffLL;
+            digits_[i+1] += ( digits_[i] - low ) / 4294967296LL;
+            digits_[i] = low;
+        }
+    };
+
+    //! Sum rounded to a double (at most one unit in the last place away from the exact sum)
+    inline double value() const
+    {
+        if( digits_[ndigits+2] > 0 || ( digits_[ndigits] > 0 && digits_[ndigits+1] > 0 ) ) {
+            return std::numeric_limits<double>::quiet_NaN();
+        } else if( digits_[ndigits] > 0 ) {
+            return std::numeric_limits<double>::infinity();
+        } else if( digits_[ndigits+1] > 0 ) {
+            return -std::numeric_limits<double>::infinity();
+        }
+        // Positive digits of the absolute value, summed from the lowest one
+        ExactSum a( *this );
+        a.normalize();
+        double sign = 1.;
+        if( a.digits_[ndigits-1] < 0 ) {
+            sign = -1.;
+            for( unsigned int i=0; i<ndigits; i++ ) {
+                a.digits_[i] = -a.digits_[i];
+            }
+            a.normalize();
+        }
+        double v = 0.;
+        for( unsigned int i=0; i<ndigits; i++ ) {
+            if( a.digits_[i] != 0 ) {
+                v += std::ldexp( ( double )a.digits_[i], 32*( int )i - bias );
+            }
+        }
+        return sign * v;
+    };
+
+    //! Digits, then the counts of +infinity, -infinity and NaN
+    int64_t digits_[size];
+
+private:
+    //! Exponent of the bit 0 of the digit 0
+    static const int bias = 1126;
+
+    //! Splits a finite v in 3 consecutive digits starting at i (false if not finite: i is then the index of its count)
+    inline static bool split( double v, unsigned int &i, int64_t d[3] )
+    {
+        if( !std::isfinite( v ) ) {
+            i = std::isnan( v ) ? ndigits+2 : ( v > 0. ? ndigits : ndigits+1 );
+            return false;
+        }
+        int e;
+        double m = std::frexp( v, &e );
+        // v = mantissa * 2^(e-53) with an integer mantissa below 2^53, whose bit 0 is the bit q of the accumulator
+        int64_t mantissa = ( int64_t )std::ldexp( std::fabs( m ), 53 );
+        int64_t sign = m < 0. ? -1 : 1;
+        unsigned int q = v == 0. ? 0 : ( unsigned int )( e - 53 + bias );
+        i = q / 32;
+        unsigned int s = q % 32;
+        // The 32 low bits and the 21 high bits are shifted separately to stay below 2^64
+        uint64_t low  = ( ( uint64_t )mantissa & 0xffffffffULL ) << s;
+        uint64_t high = ( ( ( uint64_t )mantissa >> 32 ) << s ) + ( low >> 32 );
+        d[0] = sign * ( int64_t )( low & 0xffffffffULL );
+        d[1] = sign * ( int64_t )( high & 0xffffffffULL );
+        d[2] = sign * ( int64_t )( high >> 32 );
+        return true;
+    };
+};
+
+#endif
@@ -1,13 +1,14 @@
 #include "H5.h"
 #include <iomanip>
+#include <cstring>
 
 //! Open HDF5 file + location
-H5::H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
+H5::H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info, hsize_t alignment, bool in_memory )
 {
-    init( file, access, comm, _raise );
+    init( file, access, comm, _raise, info, alignment, in_memory );
 }
 
-void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
+void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info, hsize_t alignment, bool in_memory )
 {
     
     // Analyse file string : separate file name and tree inside hdf5 file
@@ -39,7 +40,14 @@ void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
     // Open or create
     hid_t fapl = H5Pcreate( H5P_FILE_ACCESS );
     if( comm ) {
-        H5Pset_fapl_mpio( fapl, *comm, MPI_INFO_NULL );
+        H5Pset_fapl_mpio( fapl, *comm, info );
+    } else if( in_memory ) {
+        // The whole file is read at once, then accessed in memory (or, if created, never written)
+        H5Pset_fapl_core( fapl, 67108864, false );
+    }
+    // Large objects start at a multiple of the alignment (e.g. the stripe size of the file system)
+    if( alignment > 0 ) {
+        H5Pset_alignment( fapl, alignment, alignment );
     }
     if( access == H5F_ACC_RDWR ) {
         fid_ = H5Fcreate( filepath_.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl );
@@ -84,6 +92,68 @@ void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
 }
 
 
+MPI_Info H5::mpiioHints( int aggregators_per_node, int striping_factor, int striping_unit )
+{
+    if( aggregators_per_node <= 0 && striping_factor <= 0 && striping_unit <= 0 ) {
+        return MPI_INFO_NULL;
+    }
+    MPI_Info info;
+    MPI_Info_create( &info );
+    if( aggregators_per_node > 0 ) {
+        // Two-phase I/O: the pieces of all the ranks of a node are gathered on its aggregators,
+        // which write large contiguous blocks of the file
+        MPI_Info_set( info, "romio_cb_write", "enable" );
+        MPI_Info_set( info, "cb_config_list", ( "*:" + std::to_string( aggregators_per_node ) ).c_str() );
+    }
+    if( striping_factor > 0 ) {
+        MPI_Info_set( info, "striping_factor", std::to_string( striping_factor ).c_str() );
+    }
+    if( striping_unit > 0 ) {
+        MPI_Info_set( info, "striping_unit", std::to_string( striping_unit ).c_str() );
+    }
+    return info;
+}
+
+
+H5Z_filter_t H5::compressionFilter( std::string name )
+{
+#if ! H5_VERSION_GE( 1, 10, 2 )
+    ERROR( "Compression of the parallel HDF5 outputs requires HDF5 1.10.2 or newer" );
+#endif
+    H5Z_filter_t filter = H5Z_FILTER_NONE;
+    if( name == "deflate" ) {
+        filter = H5Z_FILTER_DEFLATE;
+    } else if( name == "blosc" ) {
+        filter = 32001;
+    } else if( name == "lz4" ) {
+        filter = 32004;
+    } else if( name == "zfp" ) {
+        filter = 32013;
+    } else if( name == "zstd" ) {
+        filter = 32015;
+    } else if( name == "sz" ) {
+        filter = 32017;
+    } else if( name == "sz3" ) {
+        filter = 32024;
+    } else {
+        ERROR( "Unknown HDF5 compression `" << name << "`" );
+    }
+    if( H5Zfilter_avail( filter ) <= 0 ) {
+        ERROR( "HDF5 compression `" << name << "` (filter " << filter << ") not available: install its plugin and set HDF5_PLUGIN_PATH" );
+    }
+    return filter;
+}
+
+std::vector<unsigned int> H5::zfpAccuracyParameters( double accuracy )
+{
+    // Same as H5Pset_zfp_accuracy_cdata of H5Z-ZFP: mode (3 = accuracy), unused, then the accuracy as a double
+    std::vector<unsigned int> parameters( 4, 0 );
+    parameters[0] = 3;
+    memcpy( &parameters[2], &accuracy, sizeof( double ) );
+    return parameters;
+}
+
+
 //! Location already opened
 H5::H5( hid_t id, hid_t dcr, hid_t dxpl ) : fid_( -1 ), id_( id ), dcr_( dcr ), dxpl_( dxpl )
 {
@@ -168,3 +238,13 @@ H5Space::H5Space( std::vector<hsize_t> size, std::vector<hsize_t> offset, std::v
     }
     chunk_ = chunk;
 }
+
+void H5Space::selectPoints( std::vector<hsize_t> &coordinates )
+{
+    size_t npoints = coordinates.size() / dims_.size();
+    if( npoints == 0 ) {
+        H5Sselect_none( sid_ );
+    } else {
+        H5Sselect_elements( sid_, H5S_SELECT_SET, npoints, &coordinates[0] );
+    }
+}
@@ -52,6 +52,9 @@ public:
         H5Sclose( sid_ );
     }
     
+    //! Select scattered points (the coordinates of each point one after the other)
+    void selectPoints( std::vector<hsize_t> &coordinates );
+    
     hid_t sid_;
     std::vector<hsize_t> dims_;
     std::vector<hsize_t> chunk_;
@@ -71,11 +74,24 @@ public:
     };
     
     //! Open HDF5 file + location
-    H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise );
+    H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info = MPI_INFO_NULL, hsize_t alignment = 0, bool in_memory = false );
     
     ~H5();
     
-    void init( std::string file, unsigned access, MPI_Comm * comm, bool _raise );
+    //! If in_memory (without MPI), the whole file is loaded in memory by a single large read,
+    //! or a created file stays in memory
+    void init( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info = MPI_INFO_NULL, hsize_t alignment = 0, bool in_memory = false );
+    
+    //! MPI-IO hints for the collective writes: two-phase aggregation on a few ranks per node and Lustre striping.
+    //! Returns MPI_INFO_NULL if all the arguments are 0 (defaults of the MPI library), otherwise must be freed.
+    static MPI_Info mpiioHints( int aggregators_per_node, int striping_factor, int striping_unit );
+    
+    //! HDF5 filter of a compression given by its name ("deflate", "zstd", "blosc", "lz4", "zfp", "sz", "sz3").
+    //! Errors if unknown, or if the filter plugin is not found (HDF5_PLUGIN_PATH).
+    static H5Z_filter_t compressionFilter( std::string name );
+    
+    //! Parameters of the zfp filter for an error-bounded compression (absolute accuracy)
+    static std::vector<unsigned int> zfpAccuracyParameters( double accuracy );
     
     bool valid() {
         return id_ >= 0;
@@ -97,6 +113,15 @@ public:
         return H5Aexists( id_, attribute_name.c_str() ) > 0;
     }
     
+    //! Absolute path of the location inside its file
+    std::string path()
+    {
+        ssize_t size = H5Iget_name( id_, NULL, 0 );
+        std::string name( size, '\0' );
+        H5Iget_name( id_, &name[0], size+1 );
+        return name;
+    }
+    
 protected:
     //! Constructor when location already opened
     H5( hid_t ID, hid_t dcr, hid_t dxpl );
@@ -115,6 +140,18 @@ protected:
         }
     }
     
+    //! Creation property list of a dataset that is not chunked: without the compression filters.
+    //! Must be closed if different from dcr_.
+    hid_t contiguousDcr() {
+        if( H5Pget_nfilters( dcr_ ) <= 0 ) {
+            return dcr_;
+        }
+        hid_t dcr = H5Pcopy( dcr_ );
+        H5Premove_filter( dcr, H5Z_FILTER_ALL );
+        H5Pset_fill_time( dcr, H5D_FILL_TIME_NEVER );
+        return dcr;
+    }
+    
     hid_t open( std::string name ) {
         if( H5Lexists( id_, name.c_str(), H5P_DEFAULT ) > 0 ) {
             return H5Oopen( id_, name.c_str(), H5P_DEFAULT );
@@ -128,9 +165,9 @@ protected:
 class H5Write : public H5
 {
 public:
-    //! Open HDF5 file + location
-    H5Write( std::string file, MPI_Comm * comm = NULL, bool _raise = true )
-     : H5( file, H5F_ACC_RDWR, comm, _raise ) {};
+    //! Open HDF5 file + location. If in_memory, the file is only created in memory (see image)
+    H5Write( std::string file, MPI_Comm * comm = NULL, bool _raise = true, MPI_Info info = MPI_INFO_NULL, hsize_t alignment = 0, bool in_memory = false )
+     : H5( file, H5F_ACC_RDWR, comm, _raise, info, alignment, in_memory ) {};
     
     //! Create group inside the given H5Write location
     H5Write( H5Write *loc, std::string group_name )
@@ -145,7 +182,11 @@ public:
             H5Pset_chunk( dcr_, filespace->chunk_.size(), &filespace->chunk_[0] );
         }
         if( H5Lexists( loc->id_, name.c_str(), H5P_DEFAULT ) == 0 ) {
-            id_  = H5Dcreate( loc->id_, name.c_str(), type, filespace->sid_, H5P_DEFAULT, dcr_, H5P_DEFAULT );
+            hid_t dcr = filespace->chunk_.empty() ? contiguousDcr() : dcr_;
+            id_  = H5Dcreate( loc->id_, name.c_str(), type, filespace->sid_, H5P_DEFAULT, dcr, H5P_DEFAULT );
+            if( dcr != dcr_ ) {
+                H5Pclose( dcr );
+            }
         } else {
             hid_t pid = H5Pcreate( H5P_DATASET_ACCESS );
             id_ = H5Dopen( loc->id_, name.c_str(), pid );
@@ -159,12 +200,55 @@ public:
     
     ~H5Write() {};
     
+    //! Compress all the chunked datasets created afterwards in this file with the given filter (see H5::compressionFilter).
+    //! Datasets that are not chunked stay uncompressed.
+    void setCompression( H5Z_filter_t filter, std::vector<unsigned int> parameters )
+    {
+        if( filter == H5Z_FILTER_DEFLATE ) {
+            H5Pset_shuffle( dcr_ );
+            H5Pset_deflate( dcr_, parameters.empty() ? 4 : std::min( 9u, parameters[0] ) );
+        } else {
+            // Byte shuffling also helps zstd and lz4 (blosc shuffles by itself, lossy filters must not be shuffled)
+            if( filter == 32015 || filter == 32004 ) {
+                H5Pset_shuffle( dcr_ );
+            }
+            H5Pset_filter( dcr_, filter, H5Z_FLAG_MANDATORY, parameters.size(), parameters.data() );
+        }
+        // Filters are not compatible with H5D_FILL_TIME_NEVER
+        H5Pset_fill_time( dcr_, H5D_FILL_TIME_IFSET );
+    }
+    
+    //! Value of the points never written in the datasets created afterwards in this file
+    template<class T>
+    void fillValue( T value, hid_t type )
+    {
+        H5Pset_fill_value( dcr_, type, &value );
+        H5Pset_fill_time( dcr_, H5D_FILL_TIME_IFSET );
+    }
+    
+    //! Copy of the content of the whole file, as it would be written on disk
+    void image( std::vector<char> &buffer )
+    {
+        H5Fflush( fid_, H5F_SCOPE_GLOBAL );
+        ssize_t size = H5Fget_file_image( fid_, NULL, 0 );
+        buffer.resize( size > 0 ? size : 0 );
+        if( size > 0 ) {
+            H5Fget_file_image( fid_, &buffer[0], size );
+        }
+    }
+    
     //! Make or open a group
     H5Write group( std::string group_name )
     {
         return H5Write( this, group_name );
     }
     
+    //! Link to an object of another file (a file name relative to the directory of this file)
+    void externalLink( std::string name, std::string file, std::string object_path )
+    {
+        H5Lcreate_external( file.c_str(), object_path.c_str(), id_, name.c_str(), H5P_DEFAULT, H5P_DEFAULT );
+    }
+    
     //! Write a string as an attribute
     void attr( std::string attribute_name, std::string attribute_value )
     {
@@ -308,12 +392,6 @@ public:
     {
         // create dataspace for 1D array with good number of elements
         hsize_t dim = size;
-//        if( deflate>0 ) {
-//            H5Pset_chunk( dcr_, 1, &dim );
-//            H5Pset_deflate( dcr_, std::min( 9, deflate ) );
-//        } else {
-//            H5Premove_filter( dcr_, H5Z_FILTER_DEFLATE );
-//        }
         // Select portion
         if( npoints == 0 ) {
             npoints = dim - offset;
@@ -327,7 +405,11 @@ public:
             H5Sselect_hyperslab( filespace, H5S_SELECT_SET, &o, NULL, &c, &n );
         }
         // create dataset
-        hid_t did = H5Dcreate( id_, name.c_str(), type, filespace, H5P_DEFAULT, dcr_, H5P_DEFAULT );
+        hid_t dcr = contiguousDcr();
+        hid_t did = H5Dcreate( id_, name.c_str(), type, filespace, H5P_DEFAULT, dcr, H5P_DEFAULT );
+        if( dcr != dcr_ ) {
+            H5Pclose( dcr );
+        }
         // write vector in dataset
         H5Dwrite( did, type, memspace, filespace, dxpl_, &v );
         // close all
@@ -336,6 +418,27 @@ public:
         return H5Write( did, dcr_, dxpl_ );
     }
     
+    //! Write an array converted to file_type, in chunks compressed by the filter of the file if any
+    template<class T>
+    H5Write compressedVect( std::string name, T &v, hsize_t size, hid_t type, hid_t file_type )
+    {
+        hid_t filespace = H5Screate_simple( 1, &size, NULL );
+        hid_t dcr = dcr_;
+        if( H5Pget_nfilters( dcr_ ) > 0 ) {
+            // Chunks of 1 MB at most
+            hsize_t chunk = std::min( size, ( hsize_t ) 1048576 / H5Tget_size( file_type ) );
+            dcr = H5Pcopy( dcr_ );
+            H5Pset_chunk( dcr, 1, &chunk );
+        }
+        hid_t did = H5Dcreate( id_, name.c_str(), file_type, filespace, H5P_DEFAULT, dcr, H5P_DEFAULT );
+        if( dcr != dcr_ ) {
+            H5Pclose( dcr );
+        }
+        H5Dwrite( did, type, H5S_ALL, H5S_ALL, dxpl_, &v );
+        H5Sclose( filespace );
+        return H5Write( did, dcr_, dxpl_ );
+    }
+    
     //! Create or open (not write) a dataset
     H5Write dataset( std::string name, hid_t type, H5Space *filespace )
     {
@@ -422,8 +525,8 @@ public:
     H5Read() : H5() {};
     
     //! Open HDF5 file + location
-    H5Read( std::string file, MPI_Comm * comm = NULL, bool _raise = true )
-     : H5( file, H5F_ACC_RDONLY, comm, _raise ) {};
+    H5Read( std::string file, MPI_Comm * comm = NULL, bool _raise = true, bool in_memory = false )
+     : H5( file, H5F_ACC_RDONLY, comm, _raise, MPI_INFO_NULL, 0, in_memory ) {};
     
     //! Location already opened
     H5Read( hid_t id, hid_t dcr, hid_t dxpl ) : H5( id, dcr, dxpl ) {};
@@ -665,6 +768,34 @@ public:
         return shape;
     }
     
+    //! If the dataset is stored as a contiguous and allocated array of native doubles, gives the
+    //! path of its file and the offset of its data in the file, so that it can be read directly
+    bool contiguousDoubles( std::string name, std::string &filename, hsize_t &offset )
+    {
+        bool contiguous = false;
+        if( H5Lexists( id_, name.c_str(), H5P_DEFAULT ) >0 ) {
+            hid_t did = H5Dopen( id_, name.c_str(), H5P_DEFAULT );
+            if( did >= 0 ) {
+                hid_t tid = H5Dget_type( did );
+                hid_t pid = H5Dget_create_plist( did );
+                haddr_t address = H5Dget_offset( did );
+                contiguous = H5Tequal( tid, H5T_NATIVE_DOUBLE ) > 0
+                          && H5Pget_layout( pid ) == H5D_CONTIGUOUS
+                          && address != HADDR_UNDEF;
+                if( contiguous ) {
+                    offset = address;
+                    ssize_t size = H5Fget_name( did, NULL, 0 );
+                    filename.assign( size, '\0' );
+                    H5Fget_name( did, &filename[0], size+1 );
+                }
+                H5Pclose( pid );
+                H5Tclose( tid );
+                H5Dclose( did );
+            }
+        }
+        return contiguous;
+    }
+    
     int vectSize( std::string vect_name )
     {
         std::vector<hsize_t> s = shape( vect_name );
@@ -0,0 +1,126 @@
+#include "HardwareCounters.h"
+
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Tools.h"
+
+using namespace std;
+
+HardwareCounters::HardwareCounters( vector<string> events ) :
+    events_( events )
+{
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    fd_.resize( nthreads * size(), -1 );
+
+#ifdef __linux__
+    // Type and configuration of each event
+    vector<uint32_t> type( size() );
+    vector<uint64_t> config( size() );
+    for( unsigned int i = 0; i < size(); i++ ) {
+        const uint64_t cache_read_miss = ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+        type[i] = PERF_TYPE_HARDWARE;
+        if( events_[i] == "cycles" ) {
+            config[i] = PERF_COUNT_HW_CPU_CYCLES;
+        } else if( events_[i] == "instructions" ) {
+            config[i] = PERF_COUNT_HW_INSTRUCTIONS;
+        } else if( events_[i] == "cache_references" ) {
+            config[i] = PERF_COUNT_HW_CACHE_REFERENCES;
+        } else if( events_[i] == "cache_misses" ) {
+            config[i] = PERF_COUNT_HW_CACHE_MISSES;
+        } else if( events_[i] == "branch_misses" ) {
+            config[i] = PERF_COUNT_HW_BRANCH_MISSES;
+        } else if( events_[i] == "L1D_read_misses" ) {
+            type[i] = PERF_TYPE_HW_CACHE;
+            config[i] = PERF_COUNT_HW_CACHE_L1D | cache_read_miss;
+        } else if( events_[i] == "LLC_read_misses" ) {
+            type[i] = PERF_TYPE_HW_CACHE;
+            config[i] = PERF_COUNT_HW_CACHE_LL | cache_read_miss;
+        } else if( events_[i].compare( 0, 4, "raw:" ) == 0 ) {
+            // Event code of the processor, for instance the floating point or vector instructions
+            type[i] = PERF_TYPE_RAW;
+            config[i] = stoull( events_[i].substr( 4 ), nullptr, 0 );
+        } else {
+            ERROR( "DiagPerformances.hardware_counters: unknown event `" << events_[i] << "`" );
+        }
+    }
+
+    // Each thread opens its own counters
+    #pragma omp parallel
+    {
+        int ithread = 0;
+#ifdef _OPENMP
+        ithread = omp_get_thread_num();
+#endif
+        for( unsigned int i = 0; i < size(); i++ ) {
+            struct perf_event_attr attr;
+            memset( &attr, 0, sizeof( attr ) );
+            attr.size = sizeof( attr );
+            attr.type = type[i];
+            attr.config = config[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fd_[ithread * size() + i] = syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+        }
+    }
+    for( unsigned int i = 0; i < size(); i++ ) {
+        if( fd_[i] < 0 ) {
+            WARNING( "DiagPerformances.hardware_counters: event `" << events_[i] << "` not available (see /proc/sys/kernel/perf_event_paranoid)" );
+        }
+    }
+#else
+    WARNING( "DiagPerformances.hardware_counters: only available on Linux" );
+#endif
+}
+
+HardwareCounters::~HardwareCounters()
+{
+#ifdef __linux__
+    for( unsigned int i = 0; i < fd_.size(); i++ ) {
+        if( fd_[i] >= 0 ) {
+            close( fd_[i] );
+        }
+    }
+#endif
+}
+
+void HardwareCounters::read( uint64_t *values )
+{
+    int ithread = 0;
+#ifdef _OPENMP
+    ithread = omp_get_thread_num();
+#endif
+    for( unsigned int i = 0; i < size(); i++ ) {
+        values[i] = 0;
+#ifdef __linux__
+        // Value, time enabled and time running: the value is extrapolated when the counters are multiplexed
+        uint64_t data[3];
+        const int fd = fd_[ithread * size() + i];
+        if( fd >= 0 && ::read( fd, data, sizeof( data ) ) == sizeof( data ) && data[2] > 0 ) {
+            values[i] = data[2] < data[1] ? ( uint64_t )( ( double )data[0] * data[1] / data[2] ) : data[0];
+        }
+#endif
+    }
+}
+
+string HardwareCounters::name( string event )
+{
+    string name = event;
+    if( name.compare( 0, 4, "raw:" ) == 0 ) {
+        name[3] = '_';
+    }
+    return name;
+}
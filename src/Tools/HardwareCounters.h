@@ -0,0 +1,47 @@
+#ifndef HARDWARECOUNTERS_H
+#define HARDWARECOUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class HardwareCounters: hardware events (cycles, instructions, cache misses, raw events of the processor)
+//! counted by the Linux perf_event interface for each OpenMP thread (DiagPerformances.hardware_counters).
+//! The counters of a thread are opened by this thread, so that the counters follow the OpenMP threads
+//! as long as the runtime keeps the same system threads from one parallel region to the next.
+//  --------------------------------------------------------------------------------------------------------------------
+class HardwareCounters
+{
+public:
+    //! Open the counters of the events for all the OpenMP threads (to be called outside of a parallel region)
+    HardwareCounters( std::vector<std::string> events );
+    ~HardwareCounters();
+
+    //! Read the counters of the calling thread (events not available read 0)
+    void read( uint64_t *values );
+
+    //! Number of events
+    inline unsigned int size()
+    {
+        return events_.size();
+    }
+
+    //! Number of threads whose counters are open
+    inline unsigned int numberOfThreads()
+    {
+        return size() > 0 ? fd_.size() / size() : 0;
+    }
+
+    //! Name of an event, as used in the output
+    static std::string name( std::string event );
+
+private:
+    //! Events requested in the namelist
+    std::vector<std::string> events_;
+
+    //! File descriptors of the counters of each thread (thread * size() + event), -1 if not available
+    std::vector<int> fd_;
+};
+
+#endif
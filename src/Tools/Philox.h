@@ -0,0 +1,44 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <inttypes.h>
+
+//! Counter-based random number generator Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3",
+//! SC'11): 4 random 32-bit words are a function of a 128-bit counter and a 64-bit key, without any state.
+//! Streams keyed on a particle, a cell or a patch and counted in timesteps do not depend on the order of the draws,
+//! on the threads or on the processes. Plain inline functions, usable on the host (vectorizable) and on the devices.
+namespace Philox
+{
+    //! 10 rounds of Philox4x32 applied to the counter (c0, c1, c2, c3) with the key (k0, k1)
+    inline void philox4x32( uint32_t &c0, uint32_t &c1, uint32_t &c2, uint32_t &c3, uint32_t k0, uint32_t k1 )
+    {
+        for( int round = 0; round < 10; round++ ) {
+            const uint64_t p0 = ( uint64_t )0xD2511F53u * c0;
+            const uint64_t p1 = ( uint64_t )0xCD9E8D57u * c2;
+            const uint32_t n0 = ( uint32_t )( p1 >> 32 ) ^ c1 ^ k0;
+            const uint32_t n2 = ( uint32_t )( p0 >> 32 ) ^ c3 ^ k1;
+            c1 = ( uint32_t )p1;
+            c3 = ( uint32_t )p0;
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+    }
+
+    //! First random word of the counter (c0, c1, c2, 0) and key (seed, 0)
+    inline uint32_t random32( uint32_t c0, uint32_t c1, uint32_t c2, uint32_t seed )
+    {
+        uint32_t c3 = 0;
+        philox4x32( c0, c1, c2, c3, seed, 0 );
+        return c0;
+    }
+
+    //! Uniform random number in (0, 1] of the counter (c0, c1, c2, 0) and key (seed, 0)
+    inline double uniform( uint32_t c0, uint32_t c1, uint32_t c2, uint32_t seed )
+    {
+        return ( random32( c0, c1, c2, seed ) + 1. ) * ( 1./4294967296. );
+    }
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <inttypes.h>
 #include <cmath>
 #include "userFunctions.h"
+#include "Philox.h"
 
 namespace Random_namespace // in order to use the random functions without having access to the class random
 {
@@ -46,6 +47,17 @@ public:
         }
     }
 
+    //! Reset the state as a function of (seed, stream, step) only, with the counter-based generator Philox
+    //! (Main.counter_based_random): the draws of a step then do not depend on the previous steps
+    inline void reseed( uint32_t seed, uint32_t stream, uint32_t step ) {
+        xorshift32_state = Philox::random32( stream, step, 0, seed );
+        // zero is not acceptable for xorshift
+        if( xorshift32_state==0 ) {
+            xorshift32_state = 1073741824;
+        }
+        has_spare_ = false;
+    }
+
     //! random integer
     inline uint32_t integer() {
         return xorshift32();
@@ -72,11 +84,9 @@ public:
     }
     //! Normal rand from xorshift32 generator (std deviation = 1.)
     inline double normal() {
-        static double spare;
-        static bool has_spare = false;
-        if( has_spare ) {
-            has_spare = false;
-            return spare;
+        if( has_spare_ ) {
+            has_spare_ = false;
+            return spare_;
         } else {
             double u, v, s;
             do {
@@ -85,8 +95,8 @@ public:
                 s = u*u + v*v;
             } while( s >= 1. );
             s = std::sqrt( -2. * std::log(s) / s );
-            spare = v * s;
-            has_spare = true;
+            spare_ = v * s;
+            has_spare_ = true;
             return u * s;
         }
     }
@@ -95,6 +105,10 @@ public:
     uint32_t xorshift32_state;
 
 private:
+
+    //! Second value of the last pair of normal random numbers, not returned yet
+    double spare_ = 0.;
+    bool has_spare_ = false;
     
     //! Random number generator
     inline uint32_t xorshift32()
@@ -5,17 +5,19 @@
 
 #define SMILEI_SHUFFLE_THRESHOLD 8
 
-static constexpr size_t best_prime[] = {2, 2, 5, 11, 17, 37, 67, 131, 257, 521, 1031, 2053, 4099, 8209, 16411, 32771, 65537, 131101, 262147, 524309, 1048583, 2097169, 4194319, 8388617};
-
 // A random shuffler which ensures a small memory occupancy (fixed)
-// at the cost of a reasonable loss in performance
+// at the cost of a reasonable loss in performance.
+// The generator may be a Random or a smilei::tools::gpu::Random (on the device).
 class RandomShuffle
 {
 public:
 
-    RandomShuffle( Random &rand, size_t length )
+    template<class RandomGenerator>
+    RandomShuffle( RandomGenerator &rand, size_t length )
     : length_( length ), mask_( 1 ), P_( 0 ), i_( 0 )
     {
+        // Local table, so that it is also available on the device
+        const size_t best_prime[] = {2, 2, 5, 11, 17, 37, 67, 131, 257, 521, 1031, 2053, 4099, 8209, 16411, 32771, 65537, 131101, 262147, 524309, 1048583, 2097169, 4194319, 8388617};
         
         if( length_ < SMILEI_SHUFFLE_THRESHOLD ) {
             
@@ -0,0 +1,125 @@
+// -----------------------------------------------------------------------------
+//
+//! \file ShapeFunctions.h
+//
+//! \brief Shape functions of the macro-particles, specialized at compile time
+//
+//! ShapeFunction<order> gives the weights of the `size` nodes surrounding a
+//! particle, at the normalized distance `delta` from the central node
+//! (in [-0.5, 0.5]). Only the centered (even) orders are defined: the nodes
+//! span [-half, half] around the central node. The weights are written `stride`
+//! apart, so that the vectorized operators store them by node and by particle.
+//! The interpolate functions sum these weights times a field over the stencil
+//! with compile-time bounds, so that the compiler fully unrolls the loops.
+//! A new order only requires a new specialization of ShapeFunction.
+// -----------------------------------------------------------------------------
+
+#ifndef SHAPEFUNCTIONS_H
+#define SHAPEFUNCTIONS_H
+
+template<int order>
+struct ShapeFunction;
+
+//! 2nd order: quadratic B-spline on 3 nodes
+template<>
+struct ShapeFunction<2> {
+    static constexpr int size = 3;
+    static constexpr int half = 1;
+
+    static inline void __attribute__((always_inline)) coefficients( double delta, double *coeff, int stride = 1 )
+    {
+        const double delta2 = delta*delta;
+        coeff[0]        = 0.5 * ( delta2-delta+0.25 );
+        coeff[stride]   = 0.75 - delta2;
+        coeff[2*stride] = 0.5 * ( delta2+delta+0.25 );
+    }
+};
+
+//! 4th order: quartic B-spline on 5 nodes
+template<>
+struct ShapeFunction<4> {
+    static constexpr int size = 5;
+    static constexpr int half = 2;
+
+    static inline void __attribute__((always_inline)) coefficients( double delta, double *coeff, int stride = 1 )
+    {
+        constexpr double dble_1_ov_384   = 1.0/384.0;
+        constexpr double dble_1_ov_48    = 1.0/48.0;
+        constexpr double dble_1_ov_16    = 1.0/16.0;
+        constexpr double dble_1_ov_12    = 1.0/12.0;
+        constexpr double dble_1_ov_24    = 1.0/24.0;
+        constexpr double dble_19_ov_96   = 19.0/96.0;
+        constexpr double dble_11_ov_24   = 11.0/24.0;
+        constexpr double dble_1_ov_4     = 1.0/4.0;
+        constexpr double dble_1_ov_6     = 1.0/6.0;
+        constexpr double dble_115_ov_192 = 115.0/192.0;
+        constexpr double dble_5_ov_8     = 5.0/8.0;
+
+        const double delta2 = delta*delta;
+        const double delta3 = delta2*delta;
+        const double delta4 = delta3*delta;
+        coeff[0]        = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+        coeff[stride]   = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
+        coeff[2*stride] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
+        coeff[3*stride] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
+        coeff[4*stride] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+    }
+};
+
+//! Primal and dual weights of a particle at `x` (in cell units) around the primal node `idx`
+//! of its cell, as used by the vectorized interpolators: the weights of consecutive nodes are
+//! `stride` apart (one lane per particle). `dual` is 1 when the central dual node is at
+//! idx+1/2, 0 when it is at idx-1/2. Returns the distance to the primal node.
+template<int order>
+inline double __attribute__((always_inline)) primalDualCoefficients( double x, int idx, double *primal, double *dual_coeff, int stride, int &dual )
+{
+    const double delta = x - ( double )idx;
+    dual = ( delta >= 0. );
+    ShapeFunction<order>::coefficients( delta, primal, stride );
+    ShapeFunction<order>::coefficients( delta + ( 0.5-dual ), dual_coeff, stride );
+    return delta;
+}
+
+//! Interpolation of a 1D field: `coeff` points to the weight of the central node `idx`
+template<int order, typename F>
+inline double __attribute__((always_inline)) interpolate( const double *coeff, F *f, int idx )
+{
+    constexpr int half = ShapeFunction<order>::half;
+    double interp_res( 0. );
+    for( int iloc=-half ; iloc<=half ; iloc++ ) {
+        interp_res += coeff[iloc] * ( *f )( idx+iloc );
+    }
+    return interp_res;
+}
+
+//! Interpolation of a 2D field: the coefficients point to the weights of the central node
+template<int order, typename F>
+inline double __attribute__((always_inline)) interpolate( const double *coeffx, const double *coeffy, F *f, int idx, int idy )
+{
+    constexpr int half = ShapeFunction<order>::half;
+    double interp_res( 0. );
+    for( int iloc=-half ; iloc<=half ; iloc++ ) {
+        for( int jloc=-half ; jloc<=half ; jloc++ ) {
+            interp_res += coeffx[iloc] * coeffy[jloc] * ( *f )( idx+iloc, idy+jloc );
+        }
+    }
+    return interp_res;
+}
+
+//! Interpolation of a 3D field: the coefficients point to the weights of the central node
+template<int order, typename F>
+inline double __attribute__((always_inline)) interpolate( const double *coeffx, const double *coeffy, const double *coeffz, F *f, int idx, int idy, int idz )
+{
+    constexpr int half = ShapeFunction<order>::half;
+    double interp_res( 0. );
+    for( int iloc=-half ; iloc<=half ; iloc++ ) {
+        for( int jloc=-half ; jloc<=half ; jloc++ ) {
+            for( int kloc=-half ; kloc<=half ; kloc++ ) {
+                interp_res += coeffx[iloc] * coeffy[jloc] * coeffz[kloc] * ( *f )( idx+iloc, idy+jloc, idz+kloc );
+            }
+        }
+    }
+    return interp_res;
+}
+
+#endif
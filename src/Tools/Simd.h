@@ -0,0 +1,195 @@
+// -----------------------------------------------------------------------------
+//
+//! \file Simd.h
+//
+//! \brief Thin portable wrapper over the SIMD registers of the CPU
+//
+//! When Smilei is compiled with `config=explicit_simd` (SMILEI_EXPLICIT_SIMD),
+//! SimdDouble packs SimdDouble::width doubles in a vector register, using the
+//! generic vector extensions of GCC-compatible compilers (GCC, Clang, Intel,
+//! Arm, Fujitsu in clang mode). The kernels written with it no longer depend
+//! on the auto-vectorizer of the compiler.
+//! The register size in bytes is SMILEI_SIMD_BYTES (64 by default, i.e.
+//! AVX-512 or 512-bit SVE with -msve-vector-bits=512).
+//!
+//! simdLoad / simdStore are also defined for plain doubles, so that a kernel
+//! templated on the value type serves both the scalar and the SIMD paths.
+// -----------------------------------------------------------------------------
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cmath>
+#include <cstring>
+
+//! Load one value of type T from `p`
+template<typename T>
+inline T simdLoad( const double *p );
+
+template<>
+inline double __attribute__((always_inline)) simdLoad<double>( const double *p )
+{
+    return *p;
+}
+
+//! Store one double at `p`
+inline void __attribute__((always_inline)) simdStore( double *p, double v )
+{
+    *p = v;
+}
+
+//! 1 if `a` is positive or zero, 0 otherwise
+inline double __attribute__((always_inline)) simdHeaviside( double a )
+{
+    return ( a >= 0. );
+}
+
+#ifdef SMILEI_EXPLICIT_SIMD
+
+#if defined( SMILEI_ACCELERATOR_GPU_OMP ) || defined( SMILEI_ACCELERATOR_GPU_OACC )
+#error "explicit_simd is a CPU backend and cannot be combined with GPU builds"
+#endif
+
+#ifndef SMILEI_SIMD_BYTES
+#define SMILEI_SIMD_BYTES 64
+#endif
+
+struct SimdDouble {
+
+    //! Number of doubles per register
+    static const int width = SMILEI_SIMD_BYTES / sizeof( double );
+
+    typedef double native_type __attribute__( ( vector_size( SMILEI_SIMD_BYTES ) ) );
+
+    native_type v;
+
+    SimdDouble() {}
+    SimdDouble( native_type n ) : v( n ) {}
+
+    //! Broadcast a scalar to all lanes
+    SimdDouble( double a )
+    {
+        for( int i=0 ; i<width ; i++ ) {
+            v[i] = a;
+        }
+    }
+
+    //! Load `width` contiguous doubles (no alignment required)
+    static inline SimdDouble __attribute__((always_inline)) load( const double *p )
+    {
+        SimdDouble r;
+        std::memcpy( &r.v, p, sizeof( native_type ) );
+        return r;
+    }
+
+    //! Load the `n` first lanes, the others are zeroed (tail of a loop)
+    static inline SimdDouble __attribute__((always_inline)) loadPartial( const double *p, int n )
+    {
+        if( n >= width ) {
+            return load( p );
+        }
+        SimdDouble r( 0. );
+        for( int i=0 ; i<n ; i++ ) {
+            r.v[i] = p[i];
+        }
+        return r;
+    }
+
+    //! Load and convert `n` (at most `width`) contiguous values of another type
+    template<typename U>
+    static inline SimdDouble __attribute__((always_inline)) convertPartial( const U *p, int n )
+    {
+        SimdDouble r( 0. );
+        if( n >= width ) {
+            for( int i=0 ; i<width ; i++ ) {
+                r.v[i] = ( double )p[i];
+            }
+        } else {
+            for( int i=0 ; i<n ; i++ ) {
+                r.v[i] = ( double )p[i];
+            }
+        }
+        return r;
+    }
+
+    inline void __attribute__((always_inline)) store( double *p ) const
+    {
+        std::memcpy( p, &v, sizeof( native_type ) );
+    }
+
+    //! Store the `n` first lanes only (tail of a loop)
+    inline void __attribute__((always_inline)) storePartial( double *p, int n ) const
+    {
+        if( n >= width ) {
+            store( p );
+            return;
+        }
+        for( int i=0 ; i<n ; i++ ) {
+            p[i] = v[i];
+        }
+    }
+
+    inline SimdDouble &operator+=( const SimdDouble &b )
+    {
+        v += b.v;
+        return *this;
+    }
+
+    inline SimdDouble &operator*=( const SimdDouble &b )
+    {
+        v *= b.v;
+        return *this;
+    }
+
+    friend inline SimdDouble operator+( const SimdDouble &a, const SimdDouble &b )
+    {
+        return SimdDouble( a.v + b.v );
+    }
+    friend inline SimdDouble operator-( const SimdDouble &a, const SimdDouble &b )
+    {
+        return SimdDouble( a.v - b.v );
+    }
+    friend inline SimdDouble operator*( const SimdDouble &a, const SimdDouble &b )
+    {
+        return SimdDouble( a.v * b.v );
+    }
+    friend inline SimdDouble operator/( const SimdDouble &a, const SimdDouble &b )
+    {
+        return SimdDouble( a.v / b.v );
+    }
+
+    //! Lane-wise 1 if positive or zero, 0 otherwise (mapped on a compare and blend)
+    friend inline SimdDouble simdHeaviside( const SimdDouble &a )
+    {
+        SimdDouble r;
+        for( int i=0 ; i<width ; i++ ) {
+            r.v[i] = ( a.v[i] >= 0. );
+        }
+        return r;
+    }
+
+    //! Lane-wise square root (mapped on the vector instruction by the compiler)
+    friend inline SimdDouble sqrt( const SimdDouble &a )
+    {
+        SimdDouble r;
+        for( int i=0 ; i<width ; i++ ) {
+            r.v[i] = std::sqrt( a.v[i] );
+        }
+        return r;
+    }
+};
+
+template<>
+inline SimdDouble __attribute__((always_inline)) simdLoad<SimdDouble>( const double *p )
+{
+    return SimdDouble::load( p );
+}
+
+inline void __attribute__((always_inline)) simdStore( double *p, const SimdDouble &v )
+{
+    v.store( p );
+}
+
+#endif
+
+#endif
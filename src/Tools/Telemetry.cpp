@@ -0,0 +1,111 @@
+#include "Telemetry.h"
+
+#include <iomanip>
+#include <mpi.h>
+
+#include "Params.h"
+#include "SmileiMPI.h"
+#include "Timers.h"
+#include "Tools.h"
+#include "VectorPatch.h"
+
+using namespace std;
+
+Telemetry::Telemetry( Params &params, SmileiMPI *smpi, Timers &timers, unsigned int start_itime ) :
+    every_( params.telemetry_every ),
+    last_itime_( start_itime )
+{
+    if( every_ == 0 ) {
+        return;
+    }
+
+    phase_names_  = { "particles", "maxwell", "densities", "collisions", "syncPart", "syncField", "syncDens", "diags", "movWindow", "loadBal" };
+    phase_timers_ = { &timers.particles, &timers.maxwell, &timers.densities, &timers.collisions, &timers.syncPart, &timers.syncField,
+                      &timers.syncDens, &timers.diags, &timers.movWindow, &timers.loadBal };
+    phase_is_sync_ = { false, false, false, false, true, true, true, false, false, false };
+    last_phase_times_.resize( phase_timers_.size() );
+    for( unsigned int i = 0; i < phase_timers_.size(); i++ ) {
+        last_phase_times_[i] = phase_timers_[i]->getTime();
+    }
+    start_wall_time_ = MPI_Wtime();
+    last_wall_time_ = start_wall_time_;
+    last_written_bytes_ = Tools::getWrittenBytes();
+
+    // Appended so that the restarts from checkpoints continue the same file
+    if( smpi->isMaster() ) {
+        file_.open( "telemetry.jsonl", params.restart ? ofstream::app : ofstream::trunc );
+    }
+}
+
+Telemetry::~Telemetry()
+{
+    if( file_.is_open() ) {
+        file_.close();
+    }
+}
+
+void Telemetry::write( unsigned int itime, double time_dual, VectorPatch &vecPatches, SmileiMPI *smpi )
+{
+    const unsigned int nphases = phase_timers_.size();
+    const double now = MPI_Wtime();
+
+    // Local values: time of each phase, busy time (outside of synchronizations),
+    // particles, peak memory and written bytes since the last output
+    vector<double> local( nphases + 4, 0. );
+    double busy = 0.;
+    for( unsigned int i = 0; i < nphases; i++ ) {
+        local[i] = phase_timers_[i]->getTime() - last_phase_times_[i];
+        last_phase_times_[i] = phase_timers_[i]->getTime();
+        if( !phase_is_sync_[i] ) {
+            busy += local[i];
+        }
+    }
+    local[nphases] = busy;
+    for( unsigned int ipatch = 0; ipatch < vecPatches.size(); ipatch++ ) {
+        for( unsigned int ispec = 0; ispec < vecPatches( ipatch )->vecSpecies.size(); ispec++ ) {
+            local[nphases+1] += vecPatches( ipatch )->vecSpecies[ispec]->getNbrOfParticles();
+        }
+    }
+    local[nphases+2] = Tools::getMemFootPrint( 1 );
+    uint64_t written_bytes = Tools::getWrittenBytes();
+    local[nphases+3] = written_bytes - last_written_bytes_;
+    last_written_bytes_ = written_bytes;
+
+    // Sum and maximum over the processes, and slowest process
+    vector<double> sum( local.size() ), max( local.size() );
+    MPI_Reduce( &local[0], &sum[0], local.size(), MPI_DOUBLE, MPI_SUM, 0, smpi->world() );
+    MPI_Reduce( &local[0], &max[0], local.size(), MPI_DOUBLE, MPI_MAX, 0, smpi->world() );
+    struct {
+        double value;
+        int rank;
+    } busy_local = { busy, smpi->getRank() }, slowest = { 0., 0 };
+    MPI_Reduce( &busy_local, &slowest, 1, MPI_DOUBLE_INT, MPI_MAXLOC, 0, smpi->world() );
+
+    if( smpi->isMaster() ) {
+        const double nranks = smpi->getSize();
+        const double interval = now - last_wall_time_;
+        const double steps = itime - last_itime_;
+        const double mean_busy = sum[nphases] / nranks;
+
+        file_ << setprecision( 6 )
+              << "{\"iteration\": " << itime
+              << ", \"time\": " << time_dual
+              << ", \"wall_time\": " << now - start_wall_time_
+              << ", \"time_per_iteration\": " << ( steps > 0 ? interval / steps : 0. )
+              << ", \"particles\": " << ( uint64_t )sum[nphases+1]
+              << ", \"particles_per_second\": " << ( interval > 0. ? sum[nphases+1] * steps / interval : 0. )
+              << ", \"phases\": {";
+        for( unsigned int i = 0; i < nphases; i++ ) {
+            file_ << ( i > 0 ? ", " : "" ) << "\"" << phase_names_[i] << "\": {\"mean\": " << sum[i] / nranks << ", \"max\": " << max[i] << "}";
+        }
+        file_ << "}"
+              << ", \"imbalance\": " << ( mean_busy > 0. ? max[nphases] / mean_busy : 1. )
+              << ", \"slowest_rank\": " << slowest.rank
+              << ", \"memory_peak_GB\": {\"mean\": " << sum[nphases+2] / nranks << ", \"max\": " << max[nphases+2] << "}"
+              << ", \"output_bandwidth_MBps\": " << ( interval > 0. ? sum[nphases+3] / interval * 1e-6 : 0. )
+              << "}" << endl;
+    }
+
+    last_itime_ = itime;
+    last_wall_time_ = now;
+}
@@ -0,0 +1,57 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Params;
+class SmileiMPI;
+class Timer;
+class Timers;
+class VectorPatch;
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class Telemetry: every Main.telemetry_every iterations, the master process appends to telemetry.jsonl a JSON line
+//! with the performance of the last iterations (time per iteration, particles per second, time of the main phases,
+//! load imbalance, peak memory and output bandwidth), to be followed during the run by monitoring tools.
+//! The values of all processes are aggregated with 3 reductions of a few numbers.
+//  --------------------------------------------------------------------------------------------------------------------
+class Telemetry
+{
+public:
+    Telemetry( Params &params, SmileiMPI *smpi, Timers &timers, unsigned int start_itime );
+    ~Telemetry();
+
+    //! True if the telemetry is written at this iteration
+    inline bool theTimeIsNow( unsigned int itime )
+    {
+        return every_ > 0 && itime % every_ == 0;
+    }
+
+    //! Aggregate the performance since the last output and write it (to be called by all processes, outside of parallel regions)
+    void write( unsigned int itime, double time_dual, VectorPatch &vecPatches, SmileiMPI *smpi );
+
+private:
+    //! Number of iterations between outputs (0 if disabled)
+    unsigned int every_;
+
+    //! Output file of the master process
+    std::ofstream file_;
+
+    //! Main phases of the time loop: names in the output and timers
+    std::vector<std::string> phase_names_;
+    std::vector<Timer *> phase_timers_;
+
+    //! Phases which are synchronizations (their time includes the waiting for the other processes)
+    std::vector<bool> phase_is_sync_;
+
+    //! State at the last output
+    unsigned int last_itime_;
+    double start_wall_time_, last_wall_time_;
+    std::vector<double> last_phase_times_;
+    uint64_t last_written_bytes_;
+};
+
+#endif
@@ -14,7 +14,9 @@ using namespace std;
 Timer::Timer( string name ) :
     name_( name ),
     time_acc_( 0.0 ),
-    smpi_( NULL )
+    trace_id_( -1 ),
+    smpi_( NULL ),
+    counters_( NULL )
 {
     register_timers.resize( 0, 0. );
     name_ = name;
@@ -35,8 +37,12 @@ void Timer::init( SmileiMPI *smpi )
 void Timer::update( bool store )
 {
     #pragma omp barrier
+    if( counters_ ) {
+        readCounters( false );
+    }
     #pragma omp master
     {
+        trace();
         time_acc_ +=  MPI_Wtime()-last_start_;
         last_start_ = MPI_Wtime();
         if( store )
@@ -133,6 +139,9 @@ void Timer::updateThreaded( VectorPatch &vecPatches, bool store )
 void Timer::restart()
 {
     #pragma omp barrier
+    if( counters_ ) {
+        readCounters( true );
+    }
     #pragma omp master
     {
         last_start_ = MPI_Wtime();
@@ -152,6 +161,51 @@ void Timer::reboot()
     last_start_ =  MPI_Wtime();
     time_acc_ = 0.;
     register_timers.clear();
+    fill( counts_.begin(), counts_.end(), 0 );
+}
+
+void Timer::setCounters( HardwareCounters *counters )
+{
+    counters_ = counters;
+    counts_start_.resize( counters_->numberOfThreads() * counters_->size(), 0 );
+    counts_.resize( counts_start_.size(), 0 );
+}
+
+void Timer::readCounters( bool start )
+{
+    const unsigned int n = counters_->size();
+    uint64_t *start_values = &counts_start_[Tools::getOMPThreadNum() * n];
+    if( start ) {
+        counters_->read( start_values );
+    } else {
+        uint64_t *values = &counts_[Tools::getOMPThreadNum() * n];
+        vector<uint64_t> now( n );
+        counters_->read( &now[0] );
+        // As the time, the counts restart at each update
+        for( unsigned int i = 0; i < n; i++ ) {
+            values[i] += now[i] - start_values[i];
+            start_values[i] = now[i];
+        }
+    }
+}
+
+void Timer::trace()
+{
+#ifdef _PARTEVENTTRACING
+    if( trace_id_ >= 0 && smpi_->event_tracing_now_ ) {
+        smpi_->trace_event( Tools::getOMPThreadNum(), last_start_-smpi_->reference_time_, 0, trace_id_ );
+        smpi_->trace_event( Tools::getOMPThreadNum(), MPI_Wtime()-smpi_->reference_time_, 1, trace_id_ );
+    }
+#endif
+}
+
+vector<double> Timer::getCounts()
+{
+    vector<double> counts( counters_ ? counters_->size() : 0, 0. );
+    for( unsigned int j = 0; j < counts_.size(); j++ ) {
+        counts[j % counts.size()] += counts_[j];
+    }
+    return counts;
 }
 
 void Timer::print( double tot )
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "SmileiMPI.h"
+#include "HardwareCounters.h"
 
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class Timer
@@ -47,6 +48,10 @@ public:
     {
         return time_acc_;
     }
+    //! Count the hardware events of the counters between restart and update, in all threads
+    void setCounters( HardwareCounters *counters );
+    //! Return the hardware events accumulated by all threads (one value per event of the counters)
+    std::vector<double> getCounts();
     //! Print accumulated time in stdout
     void print( double tot );
     //! name of the timer
@@ -67,6 +72,9 @@ public:
     //! Id of the associated timer in the patch timer array
     unsigned int patch_timer_id;
 #endif
+
+    //! Id of the phase of this timer in the event tracing (-1 if not traced)
+    int trace_id_;
     
 private:
     //! Last timer start
@@ -74,6 +82,15 @@ private:
     //! MPI process timer synchronized through MPI
     SmileiMPI *smpi_;
     
+    //! Hardware counters (NULL if not counted)
+    HardwareCounters *counters_;
+    //! Counters of each thread at the last restart, and events accumulated by each thread (thread * events + event)
+    std::vector<uint64_t> counts_start_, counts_;
+    //! Read the counters of the calling thread at a restart (start=true) or an update
+    void readCounters( bool start );
+    //! Trace the period since the last restart if the events of the current iteration are traced
+    void trace();
+    
 };
 
 
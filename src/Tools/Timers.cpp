@@ -4,10 +4,15 @@
 #include "Timers.h"
 
 #include "SmileiMPI.h"
+#include "Params.h"
 #include "Tools.h"
 
 using namespace std;
 
+const string Timers::counted_timer_names[Timers::counted_timers_count] = {
+    "particles", "maxwell", "densities", "collisions", "syncPart", "syncField", "syncDens"
+};
+
 Timers::Timers( SmileiMPI *smpi ) :
     global( "Global" ),           // The entire time loop
     particles( "Particles" ),     // Call dynamics + restartRhoJ(s)
@@ -49,6 +54,9 @@ Timers::Timers( SmileiMPI *smpi ) :
     sorting( "Sorting" )
 #endif
 {
+    hardware_counters_ = NULL;
+    particle_pushes_ = 0.;
+    cell_updates_ = 0.;
     timers.resize( 0 );
     timers.push_back( &global );
     timers.push_back( &particles );
@@ -109,6 +117,10 @@ Timers::Timers( SmileiMPI *smpi ) :
     for( unsigned int i=0; i<timers.size(); i++ ) {
         timers[i]->init( smpi );
     }
+    // The main timers, except the global one, are phases of the event tracing
+    for( unsigned int i=1; i<=patch_timer_id_start; i++ ) {
+        timers[i]->trace_id_ = smpi->addTracedEvent( timers[i]->name() );
+    }
     
     if( smpi->getRank()==0 && ! smpi->test_mode ) {
         remove( "profil.txt" );
@@ -121,6 +133,19 @@ Timers::Timers( SmileiMPI *smpi ) :
 
 Timers::~Timers()
 {
+    delete hardware_counters_;
+}
+
+void Timers::initHardwareCounters( Params &params )
+{
+    if( params.hardware_counters.empty() ) {
+        return;
+    }
+    hardware_counters_ = new HardwareCounters( params.hardware_counters );
+    counted_timers_ = { &particles, &maxwell, &densities, &collisions, &syncPart, &syncField, &syncDens };
+    for( unsigned int i=0; i<counted_timers_.size(); i++ ) {
+        counted_timers_[i]->setCounters( hardware_counters_ );
+    }
 }
 
 void Timers::reboot()
@@ -128,6 +153,8 @@ void Timers::reboot()
     for( unsigned int i=0; i<timers.size(); i++ ) {
         timers[i]->reboot();
     }
+    particle_pushes_ = 0.;
+    cell_updates_ = 0.;
 }
 
 //! Output the timer profile
@@ -171,11 +198,50 @@ void Timers::profile( SmileiMPI *smpi )
 #endif
         
     }
+    profileThroughputs( smpi, avg_timers );
     for( unsigned int i=0 ; i<avg_timers.size() ; i++ ) {
         delete avg_timers[i];
     }
 }
 
+//! Throughputs of the time loop, and load imbalance of the main timers
+void Timers::profileThroughputs( SmileiMPI *smpi, std::vector<Timer *> &avg_timers )
+{
+    // Particles pushed, cells updated and bytes sent by all processes
+    double local[4] = { particle_pushes_, cell_updates_, ( double )smpi->sent_bytes_[SmileiMPI::sent_particles], ( double )smpi->sent_bytes_[SmileiMPI::sent_fields] };
+    double total[4];
+    MPI_Reduce( local, total, 4, MPI_DOUBLE, MPI_SUM, 0, smpi->world() );
+    
+    if( ! smpi->isMaster() || global.getTime() <= 0. ) {
+        return;
+    }
+    
+    // Core-seconds of the time loop, and process-seconds of the synchronizations (avg_timers start at timers[1])
+    const double core_seconds = global.getTime() * smpi->getGlobalNumCores();
+    const double nprocs = smpi->getSize();
+    const double sync_part = avg_timers[8]->getTime() * nprocs;
+    const double sync_fields = ( avg_timers[9]->getTime() + avg_timers[10]->getTime() ) * nprocs;
+    
+    MESSAGE( "\n Throughputs:" );
+    MESSAGE( 1, "Particle pushes per second per core:   " << scientific << setprecision( 3 ) << total[0] / core_seconds );
+    MESSAGE( 1, "Cell updates per second per core:      " << scientific << setprecision( 3 ) << total[1] / core_seconds );
+    if( sync_part > 0. ) {
+        MESSAGE( 1, "Particles sent (MB/s of Sync Particles): " << fixed << setprecision( 1 ) << total[2] / sync_part * 1e-6 );
+    }
+    if( sync_fields > 0. ) {
+        MESSAGE( 1, "Fields sent (MB/s of Sync Fields and Sync Densities): " << fixed << setprecision( 1 ) << total[3] / sync_fields * 1e-6 );
+    }
+    
+    // Maximum over average of the main timers above 1% of the time loop
+    MESSAGE( "\n Load imbalance (max/avg over the MPI processes):" );
+    for( unsigned int i=0 ; i<patch_timer_id_start && i<avg_timers.size() ; i++ ) {
+        if( avg_timers[i]->getTime() > 0.01 * global.getTime() ) {
+            MESSAGE( 1, avg_timers[i]->name() << ": " << fixed << setprecision( 2 ) << max_times_[i] / avg_timers[i]->getTime() );
+        }
+    }
+    cout.unsetf( ios::floatfield );
+}
+
 //! Perform the required processing on the timers for output
 std::vector<Timer *> Timers::consolidate( SmileiMPI *smpi, bool final_profile )
 {
@@ -249,6 +315,7 @@ std::vector<Timer *> Timers::consolidate( SmileiMPI *smpi, bool final_profile )
                 newTimer->time_acc_ = avg;
                 newTimer->name_ = timers[itimer]->name_;
                 avg_timers.push_back( newTimer );
+                max_times_.push_back( max );
             }
         }
         
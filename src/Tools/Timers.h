@@ -7,6 +7,7 @@
 #include "Timer.h"
 
 class SmileiMPI;
+class Params;
 
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class Timers
@@ -65,14 +66,41 @@ public:
     //! Output the timer profile
     void profile( SmileiMPI *smpi );
     
+    //! Count the particles pushed and the cells updated by the solver in one iteration, for the throughputs of the profile
+    inline void countWork( double particles, double cells )
+    {
+        particle_pushes_ += particles;
+        cell_updates_ += cells;
+    }
+    
     //! Perform the required processing on the timers for output
     std::vector<Timer *> consolidate( SmileiMPI *smpi, bool final_profile = false );
     
     void reboot();
     
+    //! Open the hardware counters of DiagPerformances.hardware_counters for the main timers
+    void initHardwareCounters( Params &params );
+    
+    //! Hardware counters (NULL if none requested)
+    HardwareCounters *hardware_counters_;
+    
+    //! Timers with hardware counters, and their names in the output
+    static const unsigned int counted_timers_count = 7;
+    static const std::string counted_timer_names[counted_timers_count];
+    std::vector<Timer *> counted_timers_;
+    
 private:
     std::vector<Timer *> timers;
     
+    //! Particles pushed and cells updated by the solver in this process since the start of the time loop
+    double particle_pushes_, cell_updates_;
+    
+    //! Maximum over the processes of each timer of the final profile (master only)
+    std::vector<double> max_times_;
+    
+    //! Print the throughputs and the load imbalance of the main timers (end of profile)
+    void profileThroughputs( SmileiMPI *smpi, std::vector<Timer *> &avg_timers );
+    
 };
 
 
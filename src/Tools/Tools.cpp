@@ -70,6 +70,55 @@ double Tools::getMemFootPrint(int type_of_memory)
     return ( double )Vm/1024./1024.;
 }
 
+double Tools::getNodeMemory( int type_of_memory )
+{
+    char sbuf[4096];
+    
+    int fd = open( "/proc/meminfo", O_RDONLY, 0 );
+    if( fd < 0 ) {
+        return 0;
+    }
+    int num_read=read( fd, sbuf, ( sizeof sbuf )-1 );
+    close( fd );
+    
+    if( num_read <= 0 ) {
+        return 0;
+    }
+    sbuf[num_read] = '\0';
+    
+    const char *key = type_of_memory == 0 ? "MemTotal:" : "MemAvailable:";
+    const char *value = strstr( sbuf, key );
+    if( !value ) {
+        return 0;
+    }
+    // Values in kB
+    return ( double )strtoull( value+strlen( key ), NULL, 10 )/1024./1024.;
+}
+
+uint64_t Tools::getWrittenBytes()
+{
+    char sbuf[1024];
+    
+    int fd = open( "/proc/self/io", O_RDONLY, 0 );
+    if( fd < 0 ) {
+        return 0;
+    }
+    int num_read=read( fd, sbuf, ( sizeof sbuf )-1 );
+    close( fd );
+    
+    if( num_read <= 0 ) {
+        return 0;
+    }
+    sbuf[num_read] = '\0';
+    
+    // Characters written, including the files on parallel file systems
+    const char *wchar = strstr( sbuf, "wchar:" );
+    if( !wchar ) {
+        return 0;
+    }
+    return strtoull( wchar+6, NULL, 10 );
+}
+
 
 std::string Tools::printBytes( uint64_t nbytes )
 {
@@ -159,6 +159,10 @@ class Tools
 public:
     static void printMemFootPrint( std::string tag );
     static double getMemFootPrint(int type_of_memory);
+    //! Memory of the node (type 0) or memory available on the node (type 1) in GB, from /proc/meminfo (0 if not available)
+    static double getNodeMemory( int type_of_memory );
+    //! Bytes written by the process through write calls since its start (0 if not available)
+    static uint64_t getWrittenBytes();
 
     //! Converts a number of Bytes in a readable string in KiB, MiB, GiB or TiB
     static std::string printBytes( uint64_t nbytes );
@@ -93,6 +93,16 @@ namespace smilei {
 #endif
                 }
 
+                // Random integer
+                uint32_t integer()
+                {
+#if defined( SMILEI_ACCELERATOR_GPU_OACC )
+                    return ::curand( &a_state_ );
+#else
+                    return a_state_.integer();
+#endif
+                }
+
                 State a_state_;
             }; // end Random class definition
 
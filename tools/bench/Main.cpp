@@ -0,0 +1,252 @@
+// ---------------------------------------------------------------------------------------------------------------------
+//! Main.cpp for the tool smilei_bench
+//! Micro-benchmarks of the interpolators, pushers and projectors of Smilei, on synthetic particles
+//! in a single 3D patch. The operators are created by the same factories as in the code, so that the
+//! vectorized and scalar versions of each shape order can be compared on a new machine or compiler.
+// ---------------------------------------------------------------------------------------------------------------------
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Params.h"
+#include "SmileiMPI.h"
+#include "VectorPatch.h"
+#include "Patch.h"
+#include "PatchesFactory.h"
+#include "Species.h"
+#include "ElectroMagn.h"
+#include "Field.h"
+#include "Interpolator.h"
+#include "InterpolatorFactory.h"
+#include "Projector.h"
+#include "ProjectorFactory.h"
+#include "Pusher.h"
+#include "PusherFactory.h"
+#include "PyTools.h"
+#include "Tools.h"
+
+using namespace std;
+
+//! Values of a parameter given as `name=value1,value2,...` in the command line (default values otherwise)
+vector<string> sweptValues( int argc, char *argv[], string name, string default_values )
+{
+    string values = default_values;
+    for( int i = 1; i < argc; i++ ) {
+        string arg = argv[i];
+        if( arg.compare( 0, name.size()+1, name+"=" ) == 0 ) {
+            values = arg.substr( name.size()+1 );
+        }
+    }
+    vector<string> list;
+    stringstream stream( values );
+    string value;
+    while( getline( stream, value, ',' ) ) {
+        list.push_back( value );
+    }
+    return list;
+}
+
+//! Synthetic particles sorted as in the species: per cell for the vectorized operators, where a cell
+//! is centered on a primal node, and per cluster of `cluster_width` cells along x for the scalar operators
+void createParticles( Particles &particles, Patch *patch, Params &params, bool vectorization, unsigned int cluster_width,
+                      unsigned int ppc, double temperature, mt19937 &generator )
+{
+    uniform_real_distribution<double> uniform( 0., 1. );
+    normal_distribution<double> maxwellian( 0., sqrt( temperature ) );
+    const unsigned int nx = params.patch_size_[0], ny = params.patch_size_[1], nz = params.patch_size_[2];
+    const double shift = vectorization ? -0.5 : 0.;
+    const unsigned int ncells_per_bin = vectorization ? 1 : cluster_width*ny*nz;
+    const unsigned int nbins = nx*ny*nz / ncells_per_bin;
+
+    particles.resize( nx*ny*nz*ppc );
+    particles.first_index.resize( nbins );
+    particles.last_index.resize( nbins );
+    // Cells in the lexicographic order (x, y, z), which is also the order of the clusters along x
+    unsigned int ipart = 0;
+    for( unsigned int ibin = 0; ibin < nbins; ibin++ ) {
+        particles.first_index[ibin] = ipart;
+        for( unsigned int icell = ibin*ncells_per_bin; icell < ( ibin+1 )*ncells_per_bin; icell++ ) {
+            const unsigned int cell[3] = { icell / ( ny*nz ), ( icell / nz ) % ny, icell % nz };
+            for( unsigned int p = 0; p < ppc; p++ ) {
+                for( unsigned int idim = 0; idim < 3; idim++ ) {
+                    particles.position( idim, ipart ) = patch->getDomainLocalMin( idim )
+                                                        + ( cell[idim] + shift + uniform( generator ) ) * params.cell_length[idim];
+                    particles.momentum( idim, ipart ) = maxwellian( generator );
+                }
+                particles.weight( ipart ) = 1./ppc;
+                particles.charge( ipart ) = -1;
+                ipart++;
+            }
+        }
+        particles.last_index[ibin] = ipart;
+        // In a cluster, the particles of the different cells are not sorted
+        if( !vectorization ) {
+            for( unsigned int i = particles.last_index[ibin]-1; i > ( unsigned int )particles.first_index[ibin]; i-- ) {
+                uniform_int_distribution<unsigned int> other( particles.first_index[ibin], i );
+                particles.swapParticle( i, other( generator ) );
+            }
+        }
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    cout.setf( ios::fixed,  ios::floatfield );
+
+    SmileiMPI smpi( &argc, &argv );
+
+    if( smpi.isMaster() ) {
+        cout << " _______________________________________________________________________ \n\n"
+             << " Smilei Bench: interpolators, pushers and projectors on synthetic particles\n"
+             << " usage: smilei_bench [ppc=...] [temperature=...] [order=...] [cluster_width=...]\n"
+             << "                     [vectorization=...] [pusher=...] [patch_size=...] [repetitions=...]\n"
+             << " with comma-separated lists of values\n"
+             << " _______________________________________________________________________ " << endl;
+    }
+    if( smpi.getSize() > 1 ) {
+        ERROR( "smilei_bench runs on a single MPI process" );
+    }
+
+    vector<string> ppcs = sweptValues( argc, argv, "ppc", "8,32,128" );
+    vector<string> temperatures = sweptValues( argc, argv, "temperature", "0.0001,0.01,1" );
+    vector<string> orders = sweptValues( argc, argv, "order", "2,4" );
+    vector<string> cluster_widths = sweptValues( argc, argv, "cluster_width", "1,4,16" );
+    vector<string> vectorizations = sweptValues( argc, argv, "vectorization", "1,0" );
+    vector<string> pushers = sweptValues( argc, argv, "pusher", "boris" );
+    const unsigned int patch_size = stoi( sweptValues( argc, argv, "patch_size", "16" )[0] );
+    const unsigned int repetitions = stoi( sweptValues( argc, argv, "repetitions", "10" )[0] );
+
+    // The fields are allocated for the largest shape order
+    int max_order = 2;
+    for( unsigned int i = 0; i < orders.size(); i++ ) {
+        max_order = max( max_order, stoi( orders[i] ) );
+    }
+
+    // Namelist of a single 3D patch with a plasma species
+    ostringstream namelist;
+    namelist << "Main(geometry='3Dcartesian', interpolation_order=" << max_order << ", "
+             << "cell_length=[0.1]*3, grid_length=[" << 0.1*patch_size << "]*3, number_of_patches=[1]*3, "
+             << "timestep=0.05, simulation_time=0.05, EM_boundary_conditions=[['periodic']], print_every=1)\n"
+             << "Species(name='bench', position_initialization='random', momentum_initialization='cold', "
+             << "particles_per_cell=1, mass=1., charge=-1., number_density=1., boundary_conditions=[['periodic']])\n";
+    Params params( &smpi, vector<string>( 1, namelist.str() ) );
+
+    VectorPatch vecPatches( params );
+    smpi.init( params, vecPatches.domain_decomposition_ );
+    Patch *patch = PatchesFactory::create( params, &smpi, vecPatches.domain_decomposition_, 0 );
+    Species *species = patch->vecSpecies[0];
+    ElectroMagn *EMfields = patch->EMfields;
+
+    // Random fields, so that the pusher rotates the momenta
+    mt19937 generator( 0 );
+    uniform_real_distribution<double> field_value( -0.1, 0.1 );
+    Field *fields[6] = { EMfields->Ex_, EMfields->Ey_, EMfields->Ez_, EMfields->Bx_m, EMfields->By_m, EMfields->Bz_m };
+    for( unsigned int ifield = 0; ifield < 6; ifield++ ) {
+        for( unsigned int i = 0; i < fields[ifield]->size(); i++ ) {
+            ( *fields[ifield] )( i ) = field_value( generator );
+        }
+    }
+
+    // Estimated particle data read and written by each operator (fields excluded)
+    const unsigned int nDim = 3;
+    const unsigned int bytes_interpolator = nDim*sizeof( double ) + 6*sizeof( double ) + nDim*( sizeof( int )+sizeof( double ) );
+    const unsigned int bytes_pusher = 6*sizeof( double ) + 2*( 3+nDim )*sizeof( double ) + sizeof( short ) + sizeof( double );
+    const unsigned int bytes_projector = ( nDim+3+1 )*sizeof( double ) + sizeof( short ) + sizeof( double )
+                                         + nDim*( sizeof( int )+sizeof( double ) );
+
+    if( smpi.isMaster() ) {
+        cout << endl << " Particles per second (millions) and estimated bytes of particle data per particle" << endl << endl
+             << setw( 6 ) << "vecto" << setw( 6 ) << "order" << setw( 8 ) << "cluster" << setw( 7 ) << "ppc"
+             << setw( 13 ) << "temperature" << setw( 13 ) << "pusher"
+             << setw( 14 ) << "interpolator" << setw( 10 ) << "pusher" << setw( 11 ) << "projector" << setw( 10 ) << "total"
+             << setw( 13 ) << "bytes/part" << endl;
+    }
+
+    Particles particles;
+    particles.initialize( 0, *species->particles );
+    const int ithread = 0;
+
+    for( unsigned int ivecto = 0; ivecto < vectorizations.size(); ivecto++ ) {
+        const bool vectorization = stoi( vectorizations[ivecto] ) != 0;
+        for( unsigned int iorder = 0; iorder < orders.size(); iorder++ ) {
+            params.interpolation_order = stoi( orders[iorder] );
+            Interpolator *Interp = InterpolatorFactory::create( params, patch, vectorization );
+            Projector *Proj = ProjectorFactory::create( params, patch, vectorization );
+            // The cluster width does not change the vectorized operators, which work cell by cell
+            const unsigned int n_cluster_widths = vectorization ? 1 : cluster_widths.size();
+            for( unsigned int icw = 0; icw < n_cluster_widths; icw++ ) {
+                const unsigned int cluster_width = vectorization ? 1 : stoi( cluster_widths[icw] );
+                if( patch_size % cluster_width != 0 ) {
+                    continue;
+                }
+                for( unsigned int ipusher = 0; ipusher < pushers.size(); ipusher++ ) {
+                    species->pusher_name_ = pushers[ipusher];
+                    Pusher *Push = PusherFactory::create( params, species, patch->rand_ );
+                    for( unsigned int ippc = 0; ippc < ppcs.size(); ippc++ ) {
+                        for( unsigned int itemp = 0; itemp < temperatures.size(); itemp++ ) {
+
+                            createParticles( particles, patch, params, vectorization, cluster_width,
+                                             stoi( ppcs[ippc] ), stod( temperatures[itemp] ), generator );
+                            const unsigned int npart = particles.size();
+                            const unsigned int nbins = particles.first_index.size();
+                            smpi.resizeBuffers( ithread, nDim, npart );
+                            // Initial positions and momenta, restored before each repetition
+                            vector<vector<double>> position = particles.Position, momentum = particles.Momentum;
+
+                            double time_interpolator = 0., time_pusher = 0., time_projector = 0.;
+                            for( unsigned int irep = 0; irep < repetitions; irep++ ) {
+                                particles.Position = position;
+                                particles.Momentum = momentum;
+
+                                double t0 = MPI_Wtime();
+                                for( unsigned int ibin = 0; ibin < nbins; ibin++ ) {
+                                    Interp->fieldsWrapper( EMfields, particles, &smpi, &( particles.first_index[ibin] ),
+                                                           &( particles.last_index[ibin] ), ithread, ibin, 0 );
+                                }
+                                double t1 = MPI_Wtime();
+                                for( unsigned int ibin = 0; ibin < nbins; ibin++ ) {
+                                    ( *Push )( particles, &smpi, particles.first_index[ibin], particles.last_index[ibin], ithread, 0 );
+                                }
+                                double t2 = MPI_Wtime();
+                                for( unsigned int ibin = 0; ibin < nbins; ibin++ ) {
+                                    Proj->currentsAndDensityWrapper( EMfields, particles, &smpi, particles.first_index[ibin],
+                                                                     particles.last_index[ibin], ithread, false, false, 0,
+                                                                     vectorization ? ibin : 0, 0 );
+                                }
+                                double t3 = MPI_Wtime();
+                                time_interpolator += t1-t0;
+                                time_pusher += t2-t1;
+                                time_projector += t3-t2;
+                            }
+
+                            if( smpi.isMaster() ) {
+                                const double n = 1.e-6 * npart * repetitions;
+                                cout << setw( 6 ) << vectorization << setw( 6 ) << params.interpolation_order << setw( 8 ) << cluster_width
+                                     << setw( 7 ) << ppcs[ippc] << setw( 13 ) << temperatures[itemp] << setw( 13 ) << pushers[ipusher]
+                                     << setprecision( 2 )
+                                     << setw( 14 ) << n/time_interpolator << setw( 10 ) << n/time_pusher << setw( 11 ) << n/time_projector
+                                     << setw( 10 ) << n/( time_interpolator+time_pusher+time_projector )
+                                     << setw( 13 ) << bytes_interpolator+bytes_pusher+bytes_projector << endl;
+                            }
+                        }
+                    }
+                    delete Push;
+                }
+            }
+            delete Interp;
+            delete Proj;
+        }
+    }
+
+    delete patch;
+    PyTools::closePython();
+    return 0;
+}
@@ -0,0 +1,226 @@
+#!/usr/bin/env python
+"""
+Performance regression suite of Smilei
+
+Two commands:
+  run      Runs the benchmarks of a suite (performance_suite.json by default: namelists of
+           the `benchmarks` directory with their MPI processes, OpenMP threads and number of
+           iterations), and writes in a JSON file, for each benchmark:
+             - the time loop and the breakdown of the main timers printed by Smilei,
+             - the timers of DiagPerformances (mean and maximum over the MPI processes).
+           With --repeat N, each benchmark runs N times and the minimum of each time is kept.
+  compare  Compares a JSON file to a baseline (e.g. the results of the previous release),
+           prints the ratio of each time to the baseline, and flags the regressions:
+           times increased by more than --tolerance (5% by default), ignoring the times
+           below --min_fraction of the time loop (1% by default). Exits with status 1
+           if a regression is found.
+
+Examples:
+    python validation/performance.py run --smilei ./smilei --output perf_5.1.json
+    python validation/performance.py compare perf_5.1.json --baseline perf_5.0.json
+
+You may define the SMILEI_ROOT environment variable to use a different installation folder
+(for the `benchmarks` directory).
+"""
+
+import argparse, json, os, platform, re, shlex, shutil, subprocess, sys, time
+
+SMILEI_ROOT = os.environ.get("SMILEI_ROOT", os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+
+def namelist_overrides(steps):
+    # Fixed number of iterations, no checkpoints, and DiagPerformances at the end of the run
+    return [
+        "Main.simulation_time = %d * Main.timestep" % steps,
+        "Main.print_every = %d" % steps,
+        "Checkpoints.dump_step = 0",
+        "Checkpoints.dump_minutes = 0.",
+        "if len(DiagPerformances._list) == 0: DiagPerformances(every = %d)" % steps,
+    ]
+
+def parse_timers(stdout):
+    # Time loop and breakdown of the main timers, as printed by Timers::profile
+    match = re.search(r"Time_in_time_loop\s+([0-9.eE+-]+)", stdout)
+    if not match:
+        return None, None
+    timers = {}
+    for line in stdout[match.end():].splitlines():
+        fields = [f.strip() for f in line.split("\t") if f.strip()]
+        if len(fields) >= 3 and re.match(r"^[0-9.eE+-]+$", fields[1]):
+            timers[fields[0]] = float(fields[1])
+    return float(match.group(1)), timers
+
+def read_performances(directory):
+    # Timers of DiagPerformances at the last output (cumulative), for all the MPI processes
+    import happi
+    S = happi.Open(directory, verbose=False)
+    if not S.valid:
+        return {}
+    info = S.performanceInfo()
+    performances = {}
+    for quantity in info["quantities_uint"] + info["quantities_double"]:
+        if not quantity.startswith("timer_"):
+            continue
+        diag = S.Performances(raw=quantity)
+        data = diag.getData(timestep=diag.getAvailableTimesteps()[-1])[0]
+        performances[quantity] = dict(mean=float(sum(data))/len(data), max=float(max(data)))
+    return performances
+
+def run_benchmark(args, name, config, directory):
+    if os.path.exists(directory):
+        shutil.rmtree(directory)
+    os.makedirs(directory)
+    overrides = os.path.join(directory, "performance_overrides.py")
+    with open(overrides, "w") as f:
+        f.write("\n".join(namelist_overrides(config["steps"])) + "\n")
+
+    env = dict(os.environ)
+    env["OMP_NUM_THREADS"] = str(config["omp"])
+    command = shlex.split(args.mpirun.format(mpi=config["mpi"], omp=config["omp"])) \
+        + [os.path.abspath(args.smilei), os.path.join(SMILEI_ROOT, "benchmarks", name), os.path.abspath(overrides)]
+    with open(os.path.join(directory, "smilei.log"), "w") as log:
+        try:
+            process = subprocess.run(command, cwd=directory, env=env, stdout=subprocess.PIPE,
+                                     stderr=subprocess.STDOUT, universal_newlines=True, timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            log.write("Timeout after %g s\n" % args.timeout)
+            return None
+        log.write(process.stdout)
+    if process.returncode != 0:
+        return None
+
+    time_loop, timers = parse_timers(process.stdout)
+    if time_loop is None:
+        return None
+    version = re.search(r"Version : (\S+)", process.stdout)
+    return dict(
+        version = version.group(1) if version else "",
+        time_loop = time_loop,
+        timers = timers,
+        performances = read_performances(directory),
+    )
+
+def keep_minimum(result, other):
+    # Minimum of each time over the repetitions of a benchmark
+    result["time_loop"] = min(result["time_loop"], other["time_loop"])
+    for timer, t in other["timers"].items():
+        result["timers"][timer] = min(result["timers"].get(timer, t), t)
+    for quantity, values in other["performances"].items():
+        if quantity in result["performances"]:
+            for key in values:
+                result["performances"][quantity][key] = min(result["performances"][quantity][key], values[key])
+        else:
+            result["performances"][quantity] = values
+
+def run(args):
+    with open(args.suite) as f:
+        suite = json.load(f)
+    if args.benchmarks:
+        suite = {name: config for name, config in suite.items() if name in args.benchmarks}
+
+    results = dict(
+        machine = platform.node(),
+        date = time.strftime("%Y-%m-%d %H:%M:%S"),
+        suite = os.path.basename(args.suite),
+        benchmarks = {},
+    )
+    failed = False
+    for name in sorted(suite):
+        config = suite[name]
+        result = None
+        for irepeat in range(args.repeat):
+            start = time.time()
+            directory = os.path.join(args.directory, os.path.splitext(name)[0], "run_%d" % irepeat)
+            trial = run_benchmark(args, name, config, directory)
+            if trial is None:
+                print("%s: failed (see %s)" % (name, os.path.join(directory, "smilei.log")))
+                result = None
+                failed = True
+                break
+            print("%s: %g s in the time loop (%g s in total)" % (name, trial["time_loop"], time.time()-start))
+            sys.stdout.flush()
+            if result is None:
+                result = trial
+            else:
+                keep_minimum(result, trial)
+        if result is not None:
+            result.update(config)
+            results["version"] = result.pop("version")
+            results["benchmarks"][name] = result
+
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=4, sort_keys=True)
+    print("Results written in %s" % args.output)
+    return 2 if failed else 0
+
+def compare(args):
+    with open(args.results) as f:
+        results = json.load(f)
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    print("Comparison of %s (%s, %s) to %s (%s, %s)" % (
+        args.results, results.get("version", ""), results.get("machine", ""),
+        args.baseline, baseline.get("version", ""), baseline.get("machine", "")))
+
+    regressions = 0
+    for name in sorted(results["benchmarks"]):
+        if name not in baseline["benchmarks"]:
+            print("\n%s: not in the baseline" % name)
+            continue
+        new, old = results["benchmarks"][name], baseline["benchmarks"][name]
+        if any(new[key] != old[key] for key in ("mpi", "omp", "steps") if key in old):
+            print("\n%s: different MPI, OpenMP or iterations than the baseline, skipped" % name)
+            continue
+        print("\n%s" % name)
+        # All the times of the benchmark, with the times of the baseline
+        times = [("Time loop", new["time_loop"], old["time_loop"])]
+        times += [(timer, t, old["timers"][timer]) for timer, t in sorted(new["timers"].items()) if timer in old["timers"]]
+        for quantity, values in sorted(new["performances"].items()):
+            if quantity in old["performances"]:
+                for key in ("mean", "max"):
+                    times += [("%s (%s)" % (quantity, key), values[key], old["performances"][quantity][key])]
+        for label, t, t_old in times:
+            if t_old <= 0. or t_old < args.min_fraction * old["time_loop"]:
+                continue
+            ratio = t / t_old
+            flag = ""
+            if ratio > 1. + args.tolerance:
+                flag = "  <-- REGRESSION"
+                regressions += 1
+            elif ratio < 1. - args.tolerance:
+                flag = "  (improvement)"
+            print("  %-40s %12.4g %12.4g %8.3f%s" % (label, t, t_old, ratio, flag))
+
+    print("\n%d regression(s) above %g%%" % (regressions, 100.*args.tolerance))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Performance regression suite of Smilei")
+    commands = parser.add_subparsers(dest="command")
+
+    parser_run = commands.add_parser("run", help="run the benchmarks of the suite and write their times in a JSON file")
+    parser_run.add_argument("--smilei", default="./smilei", help="Smilei executable (default ./smilei)")
+    parser_run.add_argument("--mpirun", default="mpirun -n {mpi}", help="MPI launcher, {mpi} and {omp} are replaced (default 'mpirun -n {mpi}')")
+    parser_run.add_argument("--suite", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "performance_suite.json"),
+                            help="JSON file of the benchmarks with their mpi, omp and steps (default performance_suite.json)")
+    parser_run.add_argument("--benchmarks", nargs="*", default=None, help="run only these benchmarks of the suite")
+    parser_run.add_argument("--repeat", type=int, default=1, help="number of runs of each benchmark, keeping the minimum times (default 1)")
+    parser_run.add_argument("--timeout", type=float, default=None, help="maximum duration of a run in seconds")
+    parser_run.add_argument("--directory", default="performance", help="directory of the runs (default performance)")
+    parser_run.add_argument("--output", default="performance.json", help="JSON file of the results (default performance.json)")
+
+    parser_compare = commands.add_parser("compare", help="compare the results to a baseline and flag the regressions")
+    parser_compare.add_argument("results", help="JSON file of the results")
+    parser_compare.add_argument("--baseline", required=True, help="JSON file of the baseline results")
+    parser_compare.add_argument("--tolerance", type=float, default=0.05, help="relative increase of a time flagged as a regression (default 0.05)")
+    parser_compare.add_argument("--min_fraction", type=float, default=0.01, help="ignore the times below this fraction of the time loop (default 0.01)")
+
+    args = parser.parse_args()
+    if args.command == "run":
+        exit(run(args))
+    elif args.command == "compare":
+        exit(compare(args))
+    else:
+        parser.print_help()
+        exit(4)